@@ -0,0 +1,63 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator {
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  PW_DCHECK(alignment != 0 && (alignment & (alignment - 1)) == 0,
+            "Arena alignment must be a power of two");
+
+  const uintptr_t next = reinterpret_cast<uintptr_t>(next_);
+  const size_t padding = (alignment - (next & (alignment - 1))) &
+                         (alignment - 1);
+  if (padding > available() || size > available() - padding) {
+    return nullptr;
+  }
+
+  std::byte* const ptr = next_ + padding;
+  next_ = ptr + size;
+  return ptr;
+}
+
+bool Arena::Resize(void* ptr, size_t old_size, size_t new_size) {
+  std::byte* const begin = static_cast<std::byte*>(ptr);
+  if (ptr == nullptr || begin < begin_ || begin > next_ ||
+      static_cast<size_t>(next_ - begin) != old_size) {
+    return false;
+  }
+  if (new_size > static_cast<size_t>(end_ - begin)) {
+    return false;
+  }
+  next_ = begin + new_size;
+  return true;
+}
+
+const char* Arena::CopyString(std::string_view string) {
+  char* copy = static_cast<char*>(Allocate(string.size() + 1, alignof(char)));
+  if (copy == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(copy, string.data(), string.size());
+  copy[string.size()] = '\0';
+  return copy;
+}
+
+}  // namespace pw::allocator
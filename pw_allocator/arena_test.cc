@@ -0,0 +1,151 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+TEST(Arena, AllocatesSequentially) {
+  alignas(8) std::byte buffer[32];
+  Arena arena(buffer);
+
+  EXPECT_EQ(arena.Allocate(8, 1), &buffer[0]);
+  EXPECT_EQ(arena.Allocate(8, 1), &buffer[8]);
+  EXPECT_EQ(arena.used(), 16u);
+  EXPECT_EQ(arena.available(), 16u);
+  EXPECT_EQ(arena.capacity(), 32u);
+}
+
+TEST(Arena, AlignsAllocations) {
+  alignas(16) std::byte buffer[64];
+  Arena arena(buffer);
+
+  EXPECT_EQ(arena.Allocate(1, 1), &buffer[0]);
+  EXPECT_EQ(arena.Allocate(4, 4), &buffer[4]);
+  EXPECT_EQ(arena.Allocate(1, 16), &buffer[16]);
+  EXPECT_EQ(arena.used(), 17u);
+}
+
+TEST(Arena, FailsWhenFull) {
+  alignas(8) std::byte buffer[16];
+  Arena arena(buffer);
+
+  EXPECT_NE(arena.Allocate(12, 1), nullptr);
+  EXPECT_EQ(arena.Allocate(8, 1), nullptr);
+  // Padding counts against the remaining space.
+  EXPECT_EQ(arena.Allocate(4, 8), nullptr);
+  EXPECT_NE(arena.Allocate(4, 4), nullptr);
+  EXPECT_EQ(arena.available(), 0u);
+}
+
+TEST(Arena, ResetReleasesEverything) {
+  alignas(8) std::byte buffer[16];
+  Arena arena(buffer);
+
+  ASSERT_NE(arena.Allocate(16, 1), nullptr);
+  arena.Reset();
+  EXPECT_EQ(arena.used(), 0u);
+  EXPECT_EQ(arena.Allocate(16, 1), &buffer[0]);
+}
+
+struct Point {
+  int x;
+  int y;
+};
+
+TEST(Arena, NewConstructsObjects) {
+  alignas(8) std::byte buffer[32];
+  Arena arena(buffer);
+
+  Point* point = arena.New<Point>(Point{1, 2});
+  ASSERT_NE(point, nullptr);
+  EXPECT_EQ(point->x, 1);
+  EXPECT_EQ(point->y, 2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(point) % alignof(Point), 0u);
+}
+
+TEST(Arena, NewArrayValueInitializes) {
+  alignas(8) std::byte buffer[32];
+  std::memset(buffer, 0xff, sizeof(buffer));
+  Arena arena(buffer);
+
+  std::span<uint32_t> values = arena.NewArray<uint32_t>(4);
+  ASSERT_EQ(values.size(), 4u);
+  for (uint32_t value : values) {
+    EXPECT_EQ(value, 0u);
+  }
+
+  EXPECT_TRUE(arena.NewArray<uint32_t>(5).empty());
+  EXPECT_TRUE(arena.NewArray<uint64_t>(SIZE_MAX / 4).empty());
+}
+
+TEST(Arena, ResizeGrowsAndShrinksLastAllocation) {
+  alignas(8) std::byte buffer[32];
+  Arena arena(buffer);
+
+  void* first = arena.Allocate(8, 1);
+  void* last = arena.Allocate(8, 1);
+  ASSERT_NE(last, nullptr);
+
+  EXPECT_TRUE(arena.Resize(last, 8, 24));
+  EXPECT_EQ(arena.used(), 32u);
+  EXPECT_FALSE(arena.Resize(last, 24, 25));
+
+  EXPECT_TRUE(arena.Resize(last, 24, 4));
+  EXPECT_EQ(arena.used(), 12u);
+
+  // Only the most recent allocation can be resized.
+  EXPECT_FALSE(arena.Resize(first, 8, 16));
+  EXPECT_EQ(arena.used(), 12u);
+}
+
+TEST(Arena, CopyString) {
+  std::byte buffer[16];
+  Arena arena(buffer);
+
+  const char* copy = arena.CopyString("hello");
+  ASSERT_NE(copy, nullptr);
+  EXPECT_STREQ(copy, "hello");
+  EXPECT_EQ(arena.used(), 6u);
+
+  EXPECT_EQ(arena.CopyString("this is too long"), nullptr);
+}
+
+TEST(ArenaScope, ReleasesAllocationsMadeInScope) {
+  alignas(8) std::byte buffer[32];
+  Arena arena(buffer);
+
+  ASSERT_NE(arena.Allocate(8, 1), nullptr);
+  {
+    ArenaScope outer(arena);
+    ASSERT_NE(arena.Allocate(8, 1), nullptr);
+    {
+      ArenaScope inner(arena);
+      ASSERT_NE(arena.Allocate(8, 1), nullptr);
+      EXPECT_EQ(arena.used(), 24u);
+    }
+    EXPECT_EQ(arena.used(), 16u);
+  }
+  EXPECT_EQ(arena.used(), 8u);
+  EXPECT_EQ(arena.Allocate(8, 1), &buffer[8]);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,143 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/fixed_block_allocator.h"
+
+#include <cstring>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator {
+
+FixedBlockAllocator::FixedBlockAllocator(std::span<std::byte> region,
+                                         size_t block_size)
+    : begin_(region.data()),
+      block_size_(block_size),
+      capacity_(0),
+      available_(0),
+      free_list_(nullptr) {
+  PW_CHECK_UINT_NE(block_size, 0);
+  PW_CHECK_UINT_EQ(block_size % alignof(FreeBlock), 0);
+  PW_CHECK_UINT_EQ(reinterpret_cast<uintptr_t>(begin_) % alignof(FreeBlock),
+                   0);
+
+  capacity_ = region.size() / block_size;
+  available_ = capacity_;
+
+  // Link the blocks in address order, so that they are allocated in order.
+  for (size_t i = capacity_; i > 0; --i) {
+    FreeBlock* block = new (begin_ + (i - 1) * block_size) FreeBlock;
+    block->next = free_list_;
+    free_list_ = block;
+  }
+}
+
+void* FixedBlockAllocator::Allocate() {
+  FreeBlock* block = free_list_;
+  if (block == nullptr) {
+    return nullptr;
+  }
+  free_list_ = block->next;
+  available_ -= 1;
+  return block;
+}
+
+void FixedBlockAllocator::Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  PW_CHECK(bytes >= begin_ && bytes < begin_ + capacity_ * block_size_,
+           "Freed pointer is not from this allocator");
+  PW_DCHECK_UINT_EQ(static_cast<size_t>(bytes - begin_) % block_size_,
+                    0,
+                    "Freed pointer is not the start of a block");
+
+  FreeBlock* block = new (bytes) FreeBlock;
+  block->next = free_list_;
+  free_list_ = block;
+  available_ += 1;
+}
+
+LockFreeFixedBlockAllocator::LockFreeFixedBlockAllocator(
+    std::span<std::byte> region, size_t block_size)
+    : begin_(region.data()), block_size_(block_size), capacity_(0), head_(0) {
+  PW_CHECK_UINT_NE(block_size, 0);
+  PW_CHECK_UINT_EQ(block_size % alignof(Link), 0);
+  PW_CHECK_UINT_EQ(reinterpret_cast<uintptr_t>(begin_) % alignof(Link), 0);
+
+  capacity_ = std::min(region.size() / block_size, kMaxBlocks);
+
+  // Block i links to block i + 1; links are indices plus one.
+  for (size_t i = 0; i < capacity_; ++i) {
+    const Link next = i + 1 < capacity_ ? static_cast<Link>(i + 2) : 0;
+    std::memcpy(begin_ + i * block_size_, &next, sizeof(next));
+  }
+  head_.store(capacity_ > 0 ? 1 : 0, std::memory_order_release);
+}
+
+void* LockFreeFixedBlockAllocator::Allocate() {
+  uint32_t head = head_.load(std::memory_order_acquire);
+  while (true) {
+    const Link link = static_cast<Link>(head & kLinkMask);
+    if (link == 0) {
+      return nullptr;
+    }
+    std::byte* block = BlockAt(link);
+
+    // The block may be allocated and overwritten by another thread after head
+    // was read. In that case the tag in head_ has changed, so the exchange
+    // fails and the stale next link is discarded.
+    Link next;
+    std::memcpy(&next, block, sizeof(next));
+
+    const uint32_t new_head = ((head & ~kLinkMask) + kTagIncrement) | next;
+    if (head_.compare_exchange_weak(head,
+                                    new_head,
+                                    std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+      return block;
+    }
+  }
+}
+
+void LockFreeFixedBlockAllocator::Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  PW_CHECK(bytes >= begin_ && bytes < begin_ + capacity_ * block_size_,
+           "Freed pointer is not from this allocator");
+  const size_t offset = static_cast<size_t>(bytes - begin_);
+  PW_DCHECK_UINT_EQ(offset % block_size_,
+                    0,
+                    "Freed pointer is not the start of a block");
+  const uint32_t link = static_cast<uint32_t>(offset / block_size_ + 1);
+
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  while (true) {
+    const Link next = static_cast<Link>(head & kLinkMask);
+    std::memcpy(bytes, &next, sizeof(next));
+
+    const uint32_t new_head = ((head & ~kLinkMask) + kTagIncrement) | link;
+    if (head_.compare_exchange_weak(head,
+                                    new_head,
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+}  // namespace pw::allocator
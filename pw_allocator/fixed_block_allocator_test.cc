@@ -0,0 +1,171 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/fixed_block_allocator.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kBlockSize = 16;
+constexpr size_t kBlocks = 4;
+
+TEST(FixedBlockAllocator, AllocatesEveryBlockInOrder) {
+  alignas(void*) std::byte buf[kBlockSize * kBlocks + 3];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+
+  EXPECT_EQ(allocator.capacity(), kBlocks);
+  EXPECT_EQ(allocator.block_size(), kBlockSize);
+
+  for (size_t i = 0; i < kBlocks; ++i) {
+    EXPECT_EQ(allocator.Allocate(), &buf[i * kBlockSize]);
+  }
+  EXPECT_EQ(allocator.available(), 0u);
+  EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+TEST(FixedBlockAllocator, ReusesFreedBlock) {
+  alignas(void*) std::byte buf[kBlockSize * kBlocks];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+
+  std::array<void*, kBlocks> blocks;
+  for (void*& block : blocks) {
+    block = allocator.Allocate();
+  }
+
+  allocator.Free(blocks[2]);
+  EXPECT_EQ(allocator.available(), 1u);
+  EXPECT_EQ(allocator.Allocate(), blocks[2]);
+  EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+TEST(FixedBlockAllocator, FreeNullptrDoesNothing) {
+  alignas(void*) std::byte buf[kBlockSize * kBlocks];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+
+  allocator.Free(nullptr);
+  EXPECT_EQ(allocator.available(), kBlocks);
+}
+
+TEST(LockFreeFixedBlockAllocator, AllocatesEveryBlockInOrder) {
+  alignas(void*) std::byte buf[kBlockSize * kBlocks];
+  LockFreeFixedBlockAllocator allocator(buf, kBlockSize);
+
+  EXPECT_EQ(allocator.capacity(), kBlocks);
+
+  for (size_t i = 0; i < kBlocks; ++i) {
+    EXPECT_EQ(allocator.Allocate(), &buf[i * kBlockSize]);
+  }
+  EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+TEST(LockFreeFixedBlockAllocator, ReusesFreedBlocksLastInFirstOut) {
+  alignas(void*) std::byte buf[kBlockSize * kBlocks];
+  LockFreeFixedBlockAllocator allocator(buf, kBlockSize);
+
+  std::array<void*, kBlocks> blocks;
+  for (void*& block : blocks) {
+    block = allocator.Allocate();
+  }
+
+  allocator.Free(blocks[0]);
+  allocator.Free(blocks[3]);
+  EXPECT_EQ(allocator.Allocate(), blocks[3]);
+  EXPECT_EQ(allocator.Allocate(), blocks[0]);
+  EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+TEST(LockFreeFixedBlockAllocator, EmptyRegion) {
+  alignas(void*) std::byte buf[kBlockSize - 2];
+  LockFreeFixedBlockAllocator allocator(buf, kBlockSize);
+
+  EXPECT_EQ(allocator.capacity(), 0u);
+  EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+class Counted {
+ public:
+  Counted(int value) : value_(value) { constructed += 1; }
+  ~Counted() { destroyed += 1; }
+
+  int value() const { return value_; }
+
+  static int constructed;
+  static int destroyed;
+
+ private:
+  int value_;
+};
+
+int Counted::constructed = 0;
+int Counted::destroyed = 0;
+
+TEST(Pool, ConstructsAndDestroysObjects) {
+  Counted::constructed = 0;
+  Counted::destroyed = 0;
+  Pool<Counted, 2> pool;
+
+  Counted* first = pool.New(1);
+  Counted* second = pool.New(2);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(first->value(), 1);
+  EXPECT_EQ(second->value(), 2);
+  EXPECT_EQ(Counted::constructed, 2);
+
+  EXPECT_EQ(pool.New(3), nullptr);
+  EXPECT_EQ(Counted::constructed, 2);
+
+  pool.Delete(first);
+  EXPECT_EQ(Counted::destroyed, 1);
+
+  Counted* third = pool.New(3);
+  EXPECT_EQ(third, first);
+  EXPECT_EQ(third->value(), 3);
+
+  pool.Delete(second);
+  pool.Delete(third);
+  EXPECT_EQ(Counted::destroyed, 3);
+}
+
+TEST(Pool, AlignsObjects) {
+  struct alignas(32) Aligned {
+    uint8_t value;
+  };
+  Pool<Aligned, 3> pool;
+
+  static_assert(decltype(pool)::kBlockSize == 32);
+  for (size_t i = 0; i < pool.capacity(); ++i) {
+    Aligned* object = pool.New();
+    ASSERT_NE(object, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(object) % 32, 0u);
+  }
+}
+
+TEST(Pool, LockFree) {
+  Pool<uint64_t, 3, LockFreeFixedBlockAllocator> pool;
+
+  uint64_t* value = pool.New(uint64_t{0x0123456789abcdef});
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 0x0123456789abcdefu);
+  EXPECT_EQ(pool.allocator().capacity(), 3u);
+  pool.Delete(value);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -31,10 +31,17 @@ Status FreeList::AddChunk(std::span<std::byte> chunk) {
 
   size_t chunk_ptr = FindChunkPtrForSize(chunk.size(), false);
 
-  // Add it to the correct list.
+  // Find where to link the chunk in the correct list.
+  FreeListNode** link = &chunks_[chunk_ptr];
+  if (list_order_ == ListOrder::kAddressOrdered) {
+    while (*link != nullptr && *link < aliased.node) {
+      link = &(*link)->next;
+    }
+  }
+
   aliased.node->size = chunk.size();
-  aliased.node->next = chunks_[chunk_ptr];
-  chunks_[chunk_ptr] = aliased.node;
+  aliased.node->next = *link;
+  *link = aliased.node;
 
   return OkStatus();
 }
@@ -44,34 +51,65 @@ std::span<std::byte> FreeList::FindChunk(size_t size) const {
     return std::span<std::byte>();
   }
 
-  size_t chunk_ptr = FindChunkPtrForSize(size, true);
-
-  // Check that there's data. This catches the case where we run off the
-  // end of the array
-  if (chunks_[chunk_ptr] == nullptr) {
-    return std::span<std::byte>();
-  }
+  union {
+    FreeListNode* node;
+    std::byte* data;
+  } aliased;
+  aliased.node = nullptr;
 
-  // Now iterate up the buckets, walking each list to find a good candidate
-  for (size_t i = chunk_ptr; i < chunks_.size(); i++) {
-    union {
-      FreeListNode* node;
-      std::byte* data;
-    } aliased;
-    aliased.node = chunks_[i];
+  const size_t chunk_ptr = FindChunkPtrForSize(size, false);
 
-    while (aliased.node != nullptr) {
-      if (aliased.node->size >= size) {
+  if (fit_policy_ == FitPolicy::kGoodFit) {
+    // Every chunk in a bucket is larger than the previous bucket's size, so
+    // the first chunk of any bucket after the request's own bucket fits.
+    for (size_t i = chunk_ptr + 1; i < chunks_.size(); i++) {
+      if (chunks_[i] != nullptr) {
+        aliased.node = chunks_[i];
         return std::span<std::byte>(aliased.data, aliased.node->size);
       }
-
-      aliased.node = aliased.node->next;
+    }
+    aliased.node = FindInBucket(chunk_ptr, size, false);
+  } else {
+    // Now iterate up the buckets, walking each list to find a good candidate.
+    // Since buckets are ordered by size, the best fit is in the first bucket
+    // that has a chunk that fits.
+    const bool best_fit = fit_policy_ == FitPolicy::kBestFit;
+    for (size_t i = chunk_ptr; i < chunks_.size(); i++) {
+      aliased.node = FindInBucket(i, size, best_fit);
+      if (aliased.node != nullptr) {
+        break;
+      }
     }
   }
 
-  // If we get here, we've checked every block in every bucket. There's
+  // If no chunk was found, we've checked every block in every bucket. There's
   // nothing that can support this allocation.
-  return std::span<std::byte>();
+  if (aliased.node == nullptr) {
+    return std::span<std::byte>();
+  }
+  return std::span<std::byte>(aliased.data, aliased.node->size);
+}
+
+FreeList::FreeListNode* FreeList::FindInBucket(size_t bucket,
+                                               size_t size,
+                                               bool best_fit) const {
+  FreeListNode* found = nullptr;
+  for (FreeListNode* node = chunks_[bucket]; node != nullptr;
+       node = node->next) {
+    if (node->size < size) {
+      continue;
+    }
+    if (!best_fit) {
+      return node;
+    }
+    if (found == nullptr || node->size < found->size) {
+      found = node;
+      if (found->size == size) {
+        break;  // Nothing fits better than an exact fit.
+      }
+    }
+  }
+  return found;
 }
 
 Status FreeList::RemoveChunk(std::span<std::byte> chunk) {
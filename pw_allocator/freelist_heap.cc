@@ -14,6 +14,7 @@
 
 #include "pw_allocator/freelist_heap.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_assert/check.h"
@@ -192,6 +193,25 @@ void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(" ");
 }
 
+FreeListHeap::FreeSpaceStats FreeListHeap::GetFreeSpaceStats() const {
+  FreeSpaceStats stats = {};
+  // Block::Init places the first block at the start of the region.
+  const Block* block = reinterpret_cast<const Block*>(region_.data());
+  while (true) {
+    if (!block->Used()) {
+      stats.free_bytes += block->InnerSize();
+      stats.largest_free_block =
+          std::max(stats.largest_free_block, block->InnerSize());
+      stats.free_blocks += 1;
+    }
+    if (block->Last()) {
+      break;
+    }
+    block = block->Next();
+  }
+  return stats;
+}
+
 // TODO: Add stack tracing to locate which call to the heap operation caused
 // the corruption.
 void FreeListHeap::InvalidFreeCrash() {
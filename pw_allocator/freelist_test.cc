@@ -185,4 +185,77 @@ TEST(FreeList, CanStoreMultipleChunksPerBucket) {
   EXPECT_TRUE(chunk2.data() == data1 || chunk2.data() == data2);
 }
 
+TEST(FreeList, FirstFitReturnsFirstChunkThatFits) {
+  FreeListBuffer<SIZE> list(example_sizes);
+
+  alignas(void*) byte data[512 + 400 + 300] = {std::byte(0)};
+  std::span<byte> larger(data, 512);
+  std::span<byte> smaller(data + 512, 300);
+  std::span<byte> too_small(data + 812, 260);
+
+  // All of these chunks go in the 512 byte bucket; the last one added is first.
+  ASSERT_EQ(list.AddChunk(larger), OkStatus());
+  ASSERT_EQ(list.AddChunk(smaller), OkStatus());
+  ASSERT_EQ(list.AddChunk(too_small), OkStatus());
+
+  EXPECT_EQ(list.FindChunk(280).data(), smaller.data());
+}
+
+TEST(FreeList, BestFitReturnsSmallestChunkThatFits) {
+  FreeListBuffer<SIZE> list(example_sizes, FreeList::FitPolicy::kBestFit);
+
+  alignas(void*) byte data[512 + 400 + 300] = {std::byte(0)};
+  std::span<byte> smaller(data, 300);
+  std::span<byte> larger(data + 300, 400);
+  std::span<byte> too_small(data + 700, 260);
+
+  ASSERT_EQ(list.AddChunk(smaller), OkStatus());
+  ASSERT_EQ(list.AddChunk(larger), OkStatus());
+  ASSERT_EQ(list.AddChunk(too_small), OkStatus());
+
+  EXPECT_EQ(list.FindChunk(280).data(), smaller.data());
+  EXPECT_EQ(list.FindChunk(350).data(), larger.data());
+  EXPECT_EQ(list.FindChunk(401).size(), 0u);
+}
+
+TEST(FreeList, GoodFitPrefersLargerBucketToWalkingList) {
+  FreeListBuffer<SIZE> list(example_sizes, FreeList::FitPolicy::kGoodFit);
+
+  alignas(void*) byte data[300 + 600] = {std::byte(0)};
+  std::span<byte> same_bucket(data, 300);
+  std::span<byte> next_bucket(data + 300, 600);
+
+  ASSERT_EQ(list.AddChunk(same_bucket), OkStatus());
+  ASSERT_EQ(list.AddChunk(next_bucket), OkStatus());
+
+  // Every chunk in the 1024 byte bucket fits a 280 byte request.
+  EXPECT_EQ(list.FindChunk(280).data(), next_bucket.data());
+
+  // Falls back to the request's own bucket if no larger bucket has chunks.
+  ASSERT_EQ(list.RemoveChunk(next_bucket), OkStatus());
+  EXPECT_EQ(list.FindChunk(280).data(), same_bucket.data());
+  EXPECT_EQ(list.FindChunk(301).size(), 0u);
+}
+
+TEST(FreeList, AddressOrderedListSortsChunks) {
+  FreeListBuffer<SIZE> list(example_sizes,
+                            FreeList::FitPolicy::kFirstFit,
+                            FreeList::ListOrder::kAddressOrdered);
+
+  alignas(void*) byte data[3 * 300] = {std::byte(0)};
+  std::span<byte> first(data, 300);
+  std::span<byte> second(data + 300, 300);
+  std::span<byte> third(data + 600, 300);
+
+  ASSERT_EQ(list.AddChunk(second), OkStatus());
+  ASSERT_EQ(list.AddChunk(third), OkStatus());
+  ASSERT_EQ(list.AddChunk(first), OkStatus());
+
+  EXPECT_EQ(list.FindChunk(300).data(), first.data());
+  ASSERT_EQ(list.RemoveChunk(first), OkStatus());
+  EXPECT_EQ(list.FindChunk(300).data(), second.data());
+  ASSERT_EQ(list.RemoveChunk(second), OkStatus());
+  EXPECT_EQ(list.FindChunk(300).data(), third.data());
+}
+
 }  // namespace pw::allocator
@@ -0,0 +1,140 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/instrumented_freelist_heap.h"
+
+namespace pw::allocator {
+
+void LatencyHistogram::Record(chrono::SystemClock::duration latency) {
+  const auto ticks = latency.count();
+  if (ticks < 1) {
+    lt_1_.Increment();
+  } else if (ticks < 4) {
+    lt_4_.Increment();
+  } else if (ticks < 16) {
+    lt_16_.Increment();
+  } else if (ticks < 64) {
+    lt_64_.Increment();
+  } else if (ticks < 256) {
+    lt_256_.Increment();
+  } else if (ticks < 1024) {
+    lt_1024_.Increment();
+  } else if (ticks < 4096) {
+    lt_4096_.Increment();
+  } else {
+    ge_4096_.Increment();
+  }
+}
+
+uint32_t LatencyHistogram::bucket(size_t index) const {
+  switch (index) {
+    case 0:
+      return lt_1_.value();
+    case 1:
+      return lt_4_.value();
+    case 2:
+      return lt_16_.value();
+    case 3:
+      return lt_64_.value();
+    case 4:
+      return lt_256_.value();
+    case 5:
+      return lt_1024_.value();
+    case 6:
+      return lt_4096_.value();
+    case 7:
+      return ge_4096_.value();
+  }
+  return 0;
+}
+
+InstrumentedFreeListHeap::InstrumentedFreeListHeap(FreeListHeap& heap)
+    : heap_(heap) {
+  bytes_in_use_.Set(heap_.heap_stats().bytes_allocated);
+}
+
+void* InstrumentedFreeListHeap::Allocate(size_t size) {
+  const auto start = chrono::SystemClock::now();
+  void* ptr = heap_.Allocate(size);
+  RecordAllocation(size, ptr, start);
+  return ptr;
+}
+
+void InstrumentedFreeListHeap::Free(void* ptr) {
+  const auto start = chrono::SystemClock::now();
+  heap_.Free(ptr);
+  free_latency_.Record(chrono::SystemClock::now() - start);
+
+  free_calls_.Increment();
+  bytes_in_use_.Set(heap_.heap_stats().bytes_allocated);
+}
+
+void* InstrumentedFreeListHeap::Realloc(void* ptr, size_t size) {
+  const auto start = chrono::SystemClock::now();
+  void* new_ptr = heap_.Realloc(ptr, size);
+  if (size != 0) {
+    RecordAllocation(size, new_ptr, start);
+  } else {
+    bytes_in_use_.Set(heap_.heap_stats().bytes_allocated);
+  }
+  return new_ptr;
+}
+
+void* InstrumentedFreeListHeap::Calloc(size_t num, size_t size) {
+  const auto start = chrono::SystemClock::now();
+  void* ptr = heap_.Calloc(num, size);
+  RecordAllocation(num * size, ptr, start);
+  return ptr;
+}
+
+void InstrumentedFreeListHeap::UpdateFreeSpaceMetrics() {
+  const FreeListHeap::FreeSpaceStats stats = heap_.GetFreeSpaceStats();
+  free_bytes_.Set(stats.free_bytes);
+  largest_free_block_.Set(stats.largest_free_block);
+  free_blocks_.Set(stats.free_blocks);
+  fragmentation_.Set(stats.free_bytes == 0
+                         ? 0.0f
+                         : 1.0f - static_cast<float>(stats.largest_free_block) /
+                                      static_cast<float>(stats.free_bytes));
+}
+
+void InstrumentedFreeListHeap::RecordAllocation(
+    size_t size, void* ptr, chrono::SystemClock::time_point start) {
+  allocate_latency_.Record(chrono::SystemClock::now() - start);
+  allocate_calls_.Increment();
+
+  if (size <= 16) {
+    alloc_le_16_.Increment();
+  } else if (size <= 32) {
+    alloc_le_32_.Increment();
+  } else if (size <= 64) {
+    alloc_le_64_.Increment();
+  } else if (size <= 128) {
+    alloc_le_128_.Increment();
+  } else if (size <= 256) {
+    alloc_le_256_.Increment();
+  } else if (size <= 512) {
+    alloc_le_512_.Increment();
+  } else {
+    alloc_large_.Increment();
+  }
+
+  bytes_in_use_.Set(heap_.heap_stats().bytes_allocated);
+  if (ptr == nullptr) {
+    failed_allocations_.Increment();
+    UpdateFreeSpaceMetrics();
+  }
+}
+
+}  // namespace pw::allocator
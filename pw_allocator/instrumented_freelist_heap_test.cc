@@ -0,0 +1,182 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/instrumented_freelist_heap.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+namespace {
+
+#define METRIC_TOKEN(name) \
+  PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, name)
+
+constexpr metric::Token kAllocateCalls = METRIC_TOKEN("allocate_calls");
+constexpr metric::Token kFreeCalls = METRIC_TOKEN("free_calls");
+constexpr metric::Token kFailedAllocations =
+    METRIC_TOKEN("failed_allocations");
+constexpr metric::Token kBytesInUse = METRIC_TOKEN("bytes_in_use");
+constexpr metric::Token kAllocLe16 = METRIC_TOKEN("alloc_le_16");
+constexpr metric::Token kAllocLe128 = METRIC_TOKEN("alloc_le_128");
+constexpr metric::Token kAllocLarge = METRIC_TOKEN("alloc_large");
+constexpr metric::Token kFreeBytes = METRIC_TOKEN("free_bytes");
+constexpr metric::Token kLargestFreeBlock = METRIC_TOKEN("largest_free_block");
+constexpr metric::Token kFreeBlocks = METRIC_TOKEN("free_blocks");
+constexpr metric::Token kFragmentation = METRIC_TOKEN("fragmentation");
+
+constexpr metric::Token kAllocateLatency =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "allocate_latency");
+constexpr metric::Token kFreeLatency =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "free_latency");
+constexpr metric::Token kTestHistogram =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "test");
+
+const metric::Metric* FindMetric(metric::Group& group, metric::Token name) {
+  for (const metric::Metric& metric : group.metrics()) {
+    if (metric.name() == name) {
+      return &metric;
+    }
+  }
+  return nullptr;
+}
+
+uint32_t IntMetric(metric::Group& group, metric::Token name) {
+  const metric::Metric* metric = FindMetric(group, name);
+  return metric == nullptr ? 0xffffffffu : metric->as_int();
+}
+
+float FloatMetric(metric::Group& group, metric::Token name) {
+  const metric::Metric* metric = FindMetric(group, name);
+  return metric == nullptr ? -1.0f : metric->as_float();
+}
+
+TEST(LatencyHistogram, RecordsIntoPowerOfFourBuckets) {
+  LatencyHistogram histogram(kTestHistogram);
+  using Ticks = chrono::SystemClock::duration;
+
+  histogram.Record(Ticks(0));
+  histogram.Record(Ticks(1));
+  histogram.Record(Ticks(3));
+  histogram.Record(Ticks(4));
+  histogram.Record(Ticks(4095));
+  histogram.Record(Ticks(100000));
+
+  EXPECT_EQ(histogram.bucket(0), 1u);
+  EXPECT_EQ(histogram.bucket(1), 2u);
+  EXPECT_EQ(histogram.bucket(2), 1u);
+  EXPECT_EQ(histogram.bucket(6), 1u);
+  EXPECT_EQ(histogram.bucket(7), 1u);
+  EXPECT_EQ(histogram.group().metrics().size(), LatencyHistogram::kBuckets);
+}
+
+class InstrumentedFreeListHeapTest : public ::testing::Test {
+ protected:
+  InstrumentedFreeListHeapTest()
+      : heap_buffer_(region_), heap_(heap_buffer_.heap()) {}
+
+  alignas(Block) std::byte region_[2048] = {};
+  FreeListHeapBuffer<> heap_buffer_;
+  InstrumentedFreeListHeap heap_;
+};
+
+TEST_F(InstrumentedFreeListHeapTest, CountsAllocationsBySize) {
+  void* small = heap_.Allocate(12);
+  void* medium = heap_.Allocate(100);
+  void* large = heap_.Allocate(600);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(medium, nullptr);
+  ASSERT_NE(large, nullptr);
+
+  metric::Group& metrics = heap_.metrics();
+  EXPECT_EQ(IntMetric(metrics, kAllocateCalls), 3u);
+  EXPECT_EQ(IntMetric(metrics, kAllocLe16), 1u);
+  EXPECT_EQ(IntMetric(metrics, kAllocLe128), 1u);
+  EXPECT_EQ(IntMetric(metrics, kAllocLarge), 1u);
+  EXPECT_EQ(IntMetric(metrics, kBytesInUse), 712u);
+
+  heap_.Free(medium);
+  EXPECT_EQ(IntMetric(metrics, kFreeCalls), 1u);
+  EXPECT_EQ(IntMetric(metrics, kBytesInUse),
+            heap_buffer_.heap_stats().bytes_allocated);
+
+  heap_.Free(small);
+  heap_.Free(large);
+}
+
+TEST_F(InstrumentedFreeListHeapTest, RecordsLatencies) {
+  heap_.Free(heap_.Allocate(32));
+
+  uint32_t allocations = 0;
+  uint32_t frees = 0;
+  for (metric::Group& group : heap_.metrics().children()) {
+    uint32_t total = 0;
+    for (const metric::Metric& metric : group.metrics()) {
+      total += metric.as_int();
+    }
+    if (group.name() == kAllocateLatency) {
+      allocations = total;
+    } else if (group.name() == kFreeLatency) {
+      frees = total;
+    }
+  }
+  EXPECT_EQ(allocations, 1u);
+  EXPECT_EQ(frees, 1u);
+}
+
+TEST_F(InstrumentedFreeListHeapTest, MeasuresFragmentation) {
+  metric::Group& metrics = heap_.metrics();
+  heap_.UpdateFreeSpaceMetrics();
+  EXPECT_EQ(IntMetric(metrics, kFreeBlocks), 1u);
+  EXPECT_EQ(FloatMetric(metrics, kFragmentation), 0.0f);
+
+  void* ptrs[4];
+  for (void*& ptr : ptrs) {
+    ptr = heap_.Allocate(256);
+    ASSERT_NE(ptr, nullptr);
+  }
+  // Free alternating blocks, so the free space can't merge.
+  heap_.Free(ptrs[0]);
+  heap_.Free(ptrs[2]);
+  heap_.UpdateFreeSpaceMetrics();
+
+  const uint32_t free_bytes = IntMetric(metrics, kFreeBytes);
+  const uint32_t largest =
+      IntMetric(metrics, kLargestFreeBlock);
+  EXPECT_EQ(IntMetric(metrics, kFreeBlocks), 3u);
+  EXPECT_LT(largest, free_bytes);
+  const float expected_fragmentation =
+      1.0f - static_cast<float>(largest) / static_cast<float>(free_bytes);
+  EXPECT_EQ(FloatMetric(metrics, kFragmentation), expected_fragmentation);
+
+  heap_.Free(ptrs[1]);
+  heap_.Free(ptrs[3]);
+  heap_.UpdateFreeSpaceMetrics();
+  EXPECT_EQ(IntMetric(metrics, kFreeBlocks), 1u);
+  EXPECT_EQ(FloatMetric(metrics, kFragmentation), 0.0f);
+}
+
+TEST_F(InstrumentedFreeListHeapTest, FailedAllocationUpdatesFreeSpace) {
+  EXPECT_EQ(heap_.Allocate(4096), nullptr);
+
+  metric::Group& metrics = heap_.metrics();
+  EXPECT_EQ(IntMetric(metrics, kFailedAllocations), 1u);
+  EXPECT_EQ(IntMetric(metrics, kFreeBlocks), 1u);
+  EXPECT_GT(IntMetric(metrics, kLargestFreeBlock), 0u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
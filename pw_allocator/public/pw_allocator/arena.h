@@ -0,0 +1,129 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+
+// A monotonic (bump pointer) allocator over a fixed buffer.
+//
+// Allocate() advances a pointer through the buffer and never frees individual
+// allocations. Memory is reclaimed all at once, either with Reset() or when an
+// ArenaScope ends. This suits temporaries that share a lifetime, such as the
+// structs and strings built while handling one request.
+//
+// Resetting does not run destructors, so New() and NewArray() only accept
+// trivially destructible types.
+//
+// Arena is not thread safe.
+class Arena {
+ public:
+  explicit constexpr Arena(ByteSpan buffer)
+      : begin_(buffer.data()),
+        end_(buffer.data() + buffer.size()),
+        next_(begin_) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Returns size bytes aligned to alignment, which must be a power of two.
+  // Returns nullptr if the arena does not have enough space left.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Grows or shrinks the most recent allocation in place. Returns false, and
+  // leaves the allocation unchanged, if ptr is not the most recent allocation
+  // or the arena does not have enough space left.
+  bool Resize(void* ptr, size_t old_size, size_t new_size);
+
+  // Constructs a T in the arena. Returns nullptr if there is not enough space.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena does not run destructors");
+    void* ptr = Allocate(sizeof(T), alignof(T));
+    return ptr == nullptr ? nullptr : new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  // Value-initializes count objects of type T in the arena. Returns an empty
+  // span if there is not enough space.
+  template <typename T>
+  std::span<T> NewArray(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena does not run destructors");
+    if (count > SIZE_MAX / sizeof(T)) {
+      return {};
+    }
+    T* array = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    if (array == nullptr) {
+      return {};
+    }
+    for (size_t i = 0; i < count; ++i) {
+      new (&array[i]) T();
+    }
+    return std::span(array, count);
+  }
+
+  // Copies a string into the arena with a null terminator. Returns nullptr if
+  // there is not enough space.
+  const char* CopyString(std::string_view string);
+
+  // Releases every allocation made from the arena.
+  void Reset() { next_ = begin_; }
+
+  size_t used() const { return static_cast<size_t>(next_ - begin_); }
+  size_t available() const { return static_cast<size_t>(end_ - next_); }
+  size_t capacity() const { return static_cast<size_t>(end_ - begin_); }
+
+ private:
+  friend class ArenaScope;
+
+  std::byte* const begin_;
+  std::byte* const end_;
+  std::byte* next_;
+};
+
+// Releases everything allocated from an Arena during the scope's lifetime.
+// Scopes may be nested; each one only releases allocations made after it was
+// created.
+//
+//   void HandleRequest(const Request& request) {
+//     ArenaScope scope(request_arena);
+//     Response* response = request_arena.New<Response>();
+//     ...
+//   }  // Everything allocated above is released here.
+//
+class ArenaScope {
+ public:
+  explicit ArenaScope(Arena& arena) : arena_(arena), mark_(arena.next_) {}
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+  ~ArenaScope() { arena_.next_ = mark_; }
+
+ private:
+  Arena& arena_;
+  std::byte* const mark_;
+};
+
+}  // namespace pw::allocator
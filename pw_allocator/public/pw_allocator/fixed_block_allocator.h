@@ -0,0 +1,178 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace pw::allocator {
+
+// Allocates fixed-size blocks from a region in O(1).
+//
+// The region is divided into blocks of block_size bytes. Free blocks are kept
+// in an intrusive singly linked list: each free block holds a pointer to the
+// next one, so there is no per-block overhead and no search on allocation.
+// Blocks are never split or merged, so the region does not fragment.
+//
+// FixedBlockAllocator is not thread safe. See LockFreeFixedBlockAllocator for
+// an allocator that may be shared between threads and interrupts.
+class FixedBlockAllocator {
+ public:
+  // block_size must be a non-zero multiple of alignof(void*), and the region
+  // must be aligned to alignof(void*). Any remainder at the end of the
+  // region that does not fit a full block is unused.
+  FixedBlockAllocator(std::span<std::byte> region, size_t block_size);
+
+  FixedBlockAllocator(const FixedBlockAllocator&) = delete;
+  FixedBlockAllocator& operator=(const FixedBlockAllocator&) = delete;
+
+  // Returns a free block, or nullptr if all blocks are in use.
+  void* Allocate();
+
+  // Returns a block to the allocator. Crashes if ptr is not a block from this
+  // allocator. Freeing nullptr does nothing.
+  void Free(void* ptr);
+
+  size_t block_size() const { return block_size_; }
+
+  // Total number of blocks.
+  size_t capacity() const { return capacity_; }
+
+  // Number of blocks that are not in use.
+  size_t available() const { return available_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  std::byte* begin_;
+  size_t block_size_;
+  size_t capacity_;
+  size_t available_;
+  FreeBlock* free_list_;
+};
+
+// Allocates fixed-size blocks from a region in O(1), without locking.
+//
+// Free blocks form a lock-free stack, updated with a single compare-and-swap.
+// The stack head packs the index of the top block with a counter that changes
+// on every update, which guards against the ABA problem. Because of this
+// packing, a LockFreeFixedBlockAllocator holds at most kMaxBlocks blocks.
+//
+// Allocate() and Free() may be called concurrently from any thread or
+// interrupt. They require a lock-free 32-bit std::atomic compare-and-swap,
+// which is not available on all targets (for example, ARMv6-M).
+class LockFreeFixedBlockAllocator {
+ public:
+  static constexpr size_t kMaxBlocks = 0xffff;
+
+  // block_size must be a non-zero multiple of alignof(uint16_t). Blocks past
+  // kMaxBlocks are unused.
+  LockFreeFixedBlockAllocator(std::span<std::byte> region, size_t block_size);
+
+  LockFreeFixedBlockAllocator(const LockFreeFixedBlockAllocator&) = delete;
+  LockFreeFixedBlockAllocator& operator=(const LockFreeFixedBlockAllocator&) =
+      delete;
+
+  // Returns a free block, or nullptr if all blocks are in use.
+  void* Allocate();
+
+  // Returns a block to the allocator. Crashes if ptr is not a block from this
+  // allocator. Freeing nullptr does nothing.
+  void Free(void* ptr);
+
+  size_t block_size() const { return block_size_; }
+
+  // Total number of blocks.
+  size_t capacity() const { return capacity_; }
+
+ private:
+  // Free blocks are linked by the index of the next block plus one, stored at
+  // the start of the block. Zero marks the end of the list.
+  using Link = uint16_t;
+
+  static constexpr uint32_t kLinkMask = 0xffff;
+  static constexpr uint32_t kTagIncrement = kLinkMask + 1;
+
+  std::byte* BlockAt(Link link) const {
+    return begin_ + (static_cast<size_t>(link) - 1) * block_size_;
+  }
+
+  std::byte* begin_;
+  size_t block_size_;
+  size_t capacity_;
+  // Low 16 bits: link to the top block. High 16 bits: update counter.
+  std::atomic<uint32_t> head_;
+};
+
+// A fixed-capacity pool of objects of type T, backed by a FixedBlockAllocator
+// or LockFreeFixedBlockAllocator. New() and Delete() take constant time.
+//
+//   Pool<Message, 16> message_pool;
+//
+//   Message* message = message_pool.New(args...);
+//   ...
+//   message_pool.Delete(message);
+//
+template <typename T,
+          size_t kCapacity,
+          typename BlockAllocator = FixedBlockAllocator>
+class Pool {
+ public:
+  static_assert(kCapacity > 0);
+
+  static constexpr size_t kAlignment = std::max(alignof(T), alignof(void*));
+  static constexpr size_t kBlockSize =
+      (std::max(sizeof(T), sizeof(void*)) + kAlignment - 1) /
+      kAlignment * kAlignment;
+
+  Pool() : allocator_(storage_, kBlockSize) {}
+
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  // Constructs a T in a free block. Returns nullptr if the pool is exhausted.
+  template <typename... Args>
+  T* New(Args&&... args) {
+    void* block = allocator_.Allocate();
+    if (block == nullptr) {
+      return nullptr;
+    }
+    return new (block) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys an object created by New() and returns its block to the pool.
+  void Delete(T* object) {
+    if (object != nullptr) {
+      object->~T();
+      allocator_.Free(object);
+    }
+  }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  BlockAllocator& allocator() { return allocator_; }
+
+ private:
+  alignas(kAlignment) std::byte storage_[kBlockSize * kCapacity];
+  BlockAllocator allocator_;
+};
+
+}  // namespace pw::allocator
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <span>
 
 #include "pw_containers/vector.h"
@@ -47,6 +48,12 @@ class FreeListBuffer;
 //
 // Note that added chunks should be aligned to a 4-byte boundary.
 //
+// How FindChunk picks among the chunks that fit is set by a FitPolicy, and the
+// order of the chunks within each bucket by a ListOrder. The defaults take the
+// first fitting chunk from lists ordered by most recently added. Best fit or
+// address ordering reduce fragmentation in long-running heaps, at the cost of
+// longer searches or insertions.
+//
 // This class is split into two parts; FreeList implements all of the
 // logic, and takes in pointers for two pw::Vector instances for its storage.
 // This prevents us from having to specialise this class for every kMaxSize
@@ -54,6 +61,30 @@ class FreeListBuffer;
 // two pw::Vector instances and instantiates FreeListInternal.
 class FreeList {
  public:
+  enum class FitPolicy : uint8_t {
+    // Returns the first chunk that fits, searching buckets in size order.
+    kFirstFit,
+
+    // Returns the smallest chunk that fits. Walks every chunk in the first
+    // bucket that has one that fits.
+    kBestFit,
+
+    // Returns the first chunk of the smallest bucket whose chunks are all large
+    // enough, without walking any list. Falls back to first fit within the
+    // request's own bucket if no such bucket has chunks.
+    kGoodFit,
+  };
+
+  enum class ListOrder : uint8_t {
+    // Adds chunks to the front of their bucket, in constant time.
+    kLastInFirstOut,
+
+    // Keeps each bucket sorted by address, which walks the bucket when adding
+    // a chunk. Combined with first fit, allocations are packed towards the
+    // start of the heap, which keeps large free blocks together.
+    kAddressOrdered,
+  };
+
   // Remove copy/move ctors
   FreeList(const FreeList& other) = delete;
   FreeList(FreeList&& other) = delete;
@@ -66,11 +97,10 @@ class FreeList {
   //                 the chunk is too small to store the FreeListNode).
   Status AddChunk(std::span<std::byte> chunk);
 
-  // Finds an eligible chunk for an allocation of size `size`. Note that this
-  // will return the first allocation possible within a given bucket, it does
-  // not currently optimize for finding the smallest chunk. Returns a std::span
-  // representing the chunk. This will be "valid" on success, and will have size
-  // = 0 on failure (if there were no chunks available for that allocation).
+  // Finds an eligible chunk for an allocation of size `size`, according to the
+  // FitPolicy. Returns a std::span representing the chunk. This will be
+  // "valid" on success, and will have size = 0 on failure (if there were no
+  // chunks available for that allocation).
   std::span<std::byte> FindChunk(size_t size) const;
 
   // Remove a chunk from this freelist. Returns:
@@ -78,6 +108,9 @@ class FreeList {
   //   NOT_FOUND: The chunk could not be found in this freelist.
   Status RemoveChunk(std::span<std::byte> chunk);
 
+  FitPolicy fit_policy() const { return fit_policy_; }
+  ListOrder list_order() const { return list_order_; }
+
  private:
   // For a given size, find which index into chunks_ the node should be written
   // to.
@@ -93,11 +126,23 @@ class FreeList {
     size_t size;
   };
 
-  constexpr FreeList(Vector<FreeListNode*>& chunks, Vector<size_t>& sizes)
-      : chunks_(chunks), sizes_(sizes) {}
+  constexpr FreeList(Vector<FreeListNode*>& chunks,
+                     Vector<size_t>& sizes,
+                     FitPolicy fit_policy,
+                     ListOrder list_order)
+      : chunks_(chunks),
+        sizes_(sizes),
+        fit_policy_(fit_policy),
+        list_order_(list_order) {}
+
+  // Returns the first chunk of at least size bytes in the bucket, or the
+  // smallest one if best_fit is true. Returns nullptr if none fits.
+  FreeListNode* FindInBucket(size_t bucket, size_t size, bool best_fit) const;
 
   Vector<FreeListNode*>& chunks_;
   Vector<size_t>& sizes_;
+  FitPolicy fit_policy_;
+  ListOrder list_order_;
 };
 
 // Holder for FreeList's storage.
@@ -106,10 +151,16 @@ class FreeListBuffer : public FreeList {
  public:
   // These constructors are a little hacky because of the initialization order.
   // Because FreeList has a trivial constructor, this is safe, however.
-  explicit FreeListBuffer(std::initializer_list<size_t> sizes)
-      : FreeList(chunks_, sizes_), sizes_(sizes), chunks_(kNumBuckets + 1, 0) {}
-  explicit FreeListBuffer(std::array<size_t, kNumBuckets> sizes)
-      : FreeList(chunks_, sizes_),
+  explicit FreeListBuffer(std::initializer_list<size_t> sizes,
+                          FitPolicy fit_policy = FitPolicy::kFirstFit,
+                          ListOrder list_order = ListOrder::kLastInFirstOut)
+      : FreeList(chunks_, sizes_, fit_policy, list_order),
+        sizes_(sizes),
+        chunks_(kNumBuckets + 1, 0) {}
+  explicit FreeListBuffer(std::array<size_t, kNumBuckets> sizes,
+                          FitPolicy fit_policy = FitPolicy::kFirstFit,
+                          ListOrder list_order = ListOrder::kLastInFirstOut)
+      : FreeList(chunks_, sizes_, fit_policy, list_order),
         sizes_(sizes.begin(), sizes.end()),
         chunks_(kNumBuckets + 1, 0) {}
 
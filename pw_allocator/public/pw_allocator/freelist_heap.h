@@ -34,6 +34,14 @@ class FreeListHeap {
     size_t total_allocate_calls;
     size_t total_free_calls;
   };
+
+  // A snapshot of the heap's free space, used to measure fragmentation.
+  struct FreeSpaceStats {
+    size_t free_bytes;          // Total usable bytes in free blocks.
+    size_t largest_free_block;  // Usable bytes in the largest free block.
+    size_t free_blocks;         // Number of free blocks.
+  };
+
   FreeListHeap(std::span<std::byte> region, FreeList& freelist);
 
   void* Allocate(size_t size);
@@ -43,6 +51,12 @@ class FreeListHeap {
 
   void LogHeapStats();
 
+  const HeapStats& heap_stats() const { return heap_stats_; }
+
+  // Walks every block in the heap to summarize its free space. Takes time
+  // linear in the number of blocks.
+  FreeSpaceStats GetFreeSpaceStats() const;
+
  private:
   std::span<std::byte> BlockToSpan(Block* block) {
     return std::span<std::byte>(block->UsableSpace(), block->InnerSize());
@@ -61,8 +75,12 @@ class FreeListHeapBuffer {
   static constexpr std::array<size_t, kNumBuckets> defaultBuckets{
       16, 32, 64, 128, 256, 512};
 
-  FreeListHeapBuffer(std::span<std::byte> region)
-      : freelist_(defaultBuckets), heap_(region, freelist_) {}
+  FreeListHeapBuffer(
+      std::span<std::byte> region,
+      FreeList::FitPolicy fit_policy = FreeList::FitPolicy::kFirstFit,
+      FreeList::ListOrder list_order = FreeList::ListOrder::kLastInFirstOut)
+      : freelist_(defaultBuckets, fit_policy, list_order),
+        heap_(region, freelist_) {}
 
   void* Allocate(size_t size) { return heap_.Allocate(size); }
   void Free(void* ptr) { heap_.Free(ptr); }
@@ -75,6 +93,8 @@ class FreeListHeapBuffer {
 
   void LogHeapStats() { heap_.LogHeapStats(); }
 
+  FreeListHeap& heap() { return heap_; }
+
  private:
   FreeListBuffer<kNumBuckets> freelist_;
   FreeListHeap heap_;
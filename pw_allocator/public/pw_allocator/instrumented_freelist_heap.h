@@ -0,0 +1,122 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/freelist_heap.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+// Counts operation latencies in SystemClock ticks. Bucket 0 counts operations
+// that took less than one tick; bucket N counts those that took [4^(N-1), 4^N)
+// ticks, and the last bucket all longer operations.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBuckets = 8;
+
+  explicit LatencyHistogram(metric::Token name) : group_(name) {}
+  LatencyHistogram(metric::Token name, IntrusiveList<metric::Group>& groups)
+      : group_(name, groups) {}
+
+  void Record(chrono::SystemClock::duration latency);
+
+  uint32_t bucket(size_t index) const;
+
+  metric::Group& group() { return group_; }
+
+ private:
+  metric::Group group_;
+  PW_METRIC(group_, lt_1_, "lt_1", 0u);
+  PW_METRIC(group_, lt_4_, "lt_4", 0u);
+  PW_METRIC(group_, lt_16_, "lt_16", 0u);
+  PW_METRIC(group_, lt_64_, "lt_64", 0u);
+  PW_METRIC(group_, lt_256_, "lt_256", 0u);
+  PW_METRIC(group_, lt_1024_, "lt_1024", 0u);
+  PW_METRIC(group_, lt_4096_, "lt_4096", 0u);
+  PW_METRIC(group_, ge_4096_, "ge_4096", 0u);
+};
+
+// Wraps a FreeListHeap and exports its behavior through pw_metric:
+//
+// - allocate_latency, free_latency: LatencyHistograms of each operation.
+// - bytes_in_use: Bytes currently allocated.
+// - allocate_calls, free_calls, failed_allocations: Operation counts.
+// - alloc_le_16 ... alloc_le_512, alloc_large: Allocation counts by requested
+//   size, matching the default FreeListHeapBuffer buckets.
+// - free_bytes, largest_free_block, free_blocks, fragmentation: The heap's
+//   free space. fragmentation is 1 - largest_free_block / free_bytes; it is 0
+//   when all free space is in one block and approaches 1 as it splinters.
+//
+// The free space metrics require walking the heap, so they are only updated
+// by UpdateFreeSpaceMetrics() and when an allocation fails.
+//
+// Like FreeListHeap, InstrumentedFreeListHeap is not thread safe.
+class InstrumentedFreeListHeap {
+ public:
+  explicit InstrumentedFreeListHeap(FreeListHeap& heap);
+
+  void* Allocate(size_t size);
+  void Free(void* ptr);
+  void* Realloc(void* ptr, size_t size);
+  void* Calloc(size_t num, size_t size);
+
+  // Walks the heap and updates the free space and fragmentation metrics.
+  void UpdateFreeSpaceMetrics();
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  void RecordAllocation(size_t size,
+                        void* ptr,
+                        chrono::SystemClock::time_point start);
+
+  FreeListHeap& heap_;
+
+  PW_METRIC_GROUP(metrics_, "freelist_heap");
+
+  static constexpr metric::Token kAllocateLatencyToken =
+      PW_TOKENIZE_STRING_DOMAIN("metrics", "allocate_latency");
+  LatencyHistogram allocate_latency_{kAllocateLatencyToken,
+                                     metrics_.children()};
+
+  static constexpr metric::Token kFreeLatencyToken =
+      PW_TOKENIZE_STRING_DOMAIN("metrics", "free_latency");
+  LatencyHistogram free_latency_{kFreeLatencyToken, metrics_.children()};
+
+  PW_METRIC(metrics_, bytes_in_use_, "bytes_in_use", 0u);
+  PW_METRIC(metrics_, allocate_calls_, "allocate_calls", 0u);
+  PW_METRIC(metrics_, free_calls_, "free_calls", 0u);
+  PW_METRIC(metrics_, failed_allocations_, "failed_allocations", 0u);
+
+  PW_METRIC(metrics_, alloc_le_16_, "alloc_le_16", 0u);
+  PW_METRIC(metrics_, alloc_le_32_, "alloc_le_32", 0u);
+  PW_METRIC(metrics_, alloc_le_64_, "alloc_le_64", 0u);
+  PW_METRIC(metrics_, alloc_le_128_, "alloc_le_128", 0u);
+  PW_METRIC(metrics_, alloc_le_256_, "alloc_le_256", 0u);
+  PW_METRIC(metrics_, alloc_le_512_, "alloc_le_512", 0u);
+  PW_METRIC(metrics_, alloc_large_, "alloc_large", 0u);
+
+  PW_METRIC(metrics_, free_bytes_, "free_bytes", 0u);
+  PW_METRIC(metrics_, largest_free_block_, "largest_free_block", 0u);
+  PW_METRIC(metrics_, free_blocks_, "free_blocks", 0u);
+  PW_METRIC(metrics_, fragmentation_, "fragmentation", 0.0f);
+};
+
+}  // namespace pw::allocator
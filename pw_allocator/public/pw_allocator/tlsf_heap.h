@@ -0,0 +1,170 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_allocator/block.h"
+
+namespace pw::allocator {
+
+template <size_t kFirstLevelCount>
+class TlsfHeapBuffer;
+
+// Two-level segregated fit (TLSF) heap built on Block.
+//
+// Free blocks are kept in lists indexed by two levels: the first level is the
+// power of two range of the block size, and the second level splits that range
+// into kSecondLevelCount equal parts. Blocks smaller than kSmallBlockSize share
+// the first first-level index, split linearly. A bitmap per level records which
+// lists are non-empty.
+//
+// Both Allocate() and Free() run in constant time, independent of the number
+// of blocks in the heap:
+//
+// - Allocate() rounds the request up to the next list boundary, so that every
+//   block in a list at or above that index is large enough. Finding the
+//   smallest such non-empty list takes two bitmap lookups, and the first block
+//   in it is used.
+// - Free() merges the block with its free neighbours, unlinking them from
+//   their lists in O(1) using a doubly linked list node stored in each free
+//   block's usable space.
+//
+// Because of the node, every block has at least sizeof(void*) * 2 bytes of
+// usable space. Rounding up requests trades some internal fragmentation for
+// the bounded search.
+//
+// TlsfHeap implements the logic, while TlsfHeapBuffer provides the storage for
+// the free lists, sized by the largest block the heap must manage.
+class TlsfHeap {
+ public:
+  struct HeapStats {
+    size_t total_bytes;
+    size_t bytes_allocated;
+    size_t cumulative_allocated;
+    size_t cumulative_freed;
+    size_t total_allocate_calls;
+    size_t total_free_calls;
+  };
+
+  static constexpr size_t kSecondLevelBits = 4;
+  static constexpr size_t kSecondLevelCount = size_t{1} << kSecondLevelBits;
+
+  // Block sizes are multiples of the Block alignment, so small blocks are split
+  // into lists of one alignment unit each.
+  static constexpr size_t kAlignment = alignof(Block*);
+  static constexpr size_t kSmallBlockSize = kSecondLevelCount * kAlignment;
+
+  // Returns the largest usable block size supported with kFirstLevelCount
+  // first-level lists.
+  static constexpr size_t MaxBlockSize(size_t first_level_count) {
+    return (kSmallBlockSize << (first_level_count - 1)) - 1;
+  }
+
+  TlsfHeap(const TlsfHeap&) = delete;
+  TlsfHeap& operator=(const TlsfHeap&) = delete;
+  TlsfHeap(TlsfHeap&&) = delete;
+  TlsfHeap& operator=(TlsfHeap&&) = delete;
+
+  void* Allocate(size_t size);
+  void Free(void* ptr);
+  void* Realloc(void* ptr, size_t size);
+  void* Calloc(size_t num, size_t size);
+
+  const HeapStats& heap_stats() const { return heap_stats_; }
+
+ private:
+  template <size_t kFirstLevelCount>
+  friend class TlsfHeapBuffer;
+
+  struct FirstLevel {
+    // Bit N is set if lists[N] is non-empty.
+    uint32_t second_level_bitmap;
+    std::array<Block*, kSecondLevelCount> lists;
+  };
+
+  // Links a free block into its list. Stored at the start of its usable space.
+  struct FreeNode {
+    Block* next;
+    Block* prev;
+  };
+
+  struct Index {
+    size_t first_level;
+    size_t second_level;
+  };
+
+  explicit constexpr TlsfHeap(std::span<FirstLevel> first_levels)
+      : first_levels_(first_levels),
+        first_level_bitmap_(0),
+        max_block_size_(MaxBlockSize(first_levels.size())),
+        heap_stats_{} {}
+
+  // Creates the first block in the region and adds it to the free lists.
+  // Crashes if the region is misaligned or too large for the free lists.
+  void Init(std::span<std::byte> region);
+
+  static FreeNode& Node(Block* block) {
+    return *reinterpret_cast<FreeNode*>(block->UsableSpace());
+  }
+
+  // Returns the list that holds free blocks of this size.
+  static Index ListIndex(size_t size);
+
+  // Returns the first list whose blocks are all at least this large.
+  static Index SearchIndex(size_t size);
+
+  // Returns a free block in the first non-empty list at or after index, or
+  // nullptr if there is none. Updates index to the block's list.
+  Block* FindFreeBlock(Index& index) const;
+
+  void InsertBlock(Block* block);
+  void RemoveBlock(Block* block, Index index);
+  void RemoveBlock(Block* block) {
+    RemoveBlock(block, ListIndex(block->InnerSize()));
+  }
+
+  void InvalidFreeCrash();
+
+  std::span<std::byte> region_;
+  std::span<FirstLevel> first_levels_;
+  // Bit N is set if first_levels_[N] has any non-empty list.
+  uint32_t first_level_bitmap_;
+  size_t max_block_size_;
+  HeapStats heap_stats_;
+};
+
+// Holder for a TlsfHeap's free lists. kFirstLevelCount sets the largest block
+// the heap can manage (see TlsfHeap::MaxBlockSize); the region given to the
+// heap must fit in a single such block. The default supports 512 KiB regions on
+// 64-bit targets and 256 KiB regions on 32-bit targets.
+template <size_t kFirstLevelCount = 13>
+class TlsfHeapBuffer : public TlsfHeap {
+ public:
+  static_assert(kFirstLevelCount >= 1 && kFirstLevelCount <= 32,
+                "The first level bitmap holds up to 32 lists");
+
+  explicit TlsfHeapBuffer(std::span<std::byte> region)
+      : TlsfHeap(first_levels_) {
+    Init(region);
+  }
+
+ private:
+  std::array<FirstLevel, kFirstLevelCount> first_levels_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,277 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t FloorLog2(size_t value) {
+  return std::numeric_limits<unsigned long long>::digits - 1 -
+         __builtin_clzll(value);
+}
+
+constexpr size_t kAlignmentBits = FloorLog2(TlsfHeap::kAlignment);
+
+static_assert((size_t{1} << kAlignmentBits) == TlsfHeap::kAlignment);
+
+// Bits below the second level index for the smallest non-small block.
+constexpr size_t kFirstLevelShift =
+    TlsfHeap::kSecondLevelBits + kAlignmentBits;
+
+// Space taken by a block's header and poison bytes.
+constexpr size_t kBlockOverhead =
+    sizeof(Block) + 2 * PW_ALLOCATOR_POISON_OFFSET;
+
+// Returns a mask of the bits at or above bit.
+constexpr uint32_t BitsFrom(size_t bit) {
+  return bit >= 32 ? 0u : ~uint32_t{0} << bit;
+}
+
+}  // namespace
+
+void TlsfHeap::Init(std::span<std::byte> region) {
+  Block* block;
+  PW_CHECK_OK(Block::Init(region, &block),
+              "Failed to initialize TlsfHeap region; misaligned or too small");
+  PW_CHECK_UINT_GE(block->InnerSize(),
+                   sizeof(FreeNode),
+                   "TlsfHeap region is too small");
+  PW_CHECK_UINT_LE(block->InnerSize(),
+                   max_block_size_,
+                   "TlsfHeap region is too large for its first level count");
+
+  for (FirstLevel& first_level : first_levels_) {
+    first_level.second_level_bitmap = 0;
+    first_level.lists.fill(nullptr);
+  }
+  InsertBlock(block);
+
+  region_ = region;
+  heap_stats_.total_bytes = region.size();
+}
+
+TlsfHeap::Index TlsfHeap::ListIndex(size_t size) {
+  if (size < kSmallBlockSize) {
+    return {.first_level = 0, .second_level = size >> kAlignmentBits};
+  }
+  const size_t msb = FloorLog2(size);
+  return {.first_level = msb - kFirstLevelShift + 1,
+          .second_level = (size >> (msb - kSecondLevelBits)) ^
+                          kSecondLevelCount};
+}
+
+TlsfHeap::Index TlsfHeap::SearchIndex(size_t size) {
+  if (size >= kSmallBlockSize) {
+    // Round up to the next list boundary, so that every block in the list
+    // found is large enough.
+    size += (size_t{1} << (FloorLog2(size) - kSecondLevelBits)) - 1;
+  }
+  return ListIndex(size);
+}
+
+Block* TlsfHeap::FindFreeBlock(Index& index) const {
+  if (index.first_level >= first_levels_.size()) {
+    return nullptr;
+  }
+  uint32_t second_level_map =
+      first_levels_[index.first_level].second_level_bitmap &
+      BitsFrom(index.second_level);
+  if (second_level_map == 0) {
+    // Use the smallest list of a larger first level.
+    const uint32_t first_level_map =
+        first_level_bitmap_ & BitsFrom(index.first_level + 1);
+    if (first_level_map == 0) {
+      return nullptr;
+    }
+    index.first_level = __builtin_ctz(first_level_map);
+    second_level_map = first_levels_[index.first_level].second_level_bitmap;
+  }
+  index.second_level = __builtin_ctz(second_level_map);
+  return first_levels_[index.first_level].lists[index.second_level];
+}
+
+void TlsfHeap::InsertBlock(Block* block) {
+  const Index index = ListIndex(block->InnerSize());
+  FirstLevel& first_level = first_levels_[index.first_level];
+  Block*& head = first_level.lists[index.second_level];
+
+  Node(block) = {.next = head, .prev = nullptr};
+  if (head != nullptr) {
+    Node(head).prev = block;
+  }
+  head = block;
+
+  first_level.second_level_bitmap |= uint32_t{1} << index.second_level;
+  first_level_bitmap_ |= uint32_t{1} << index.first_level;
+}
+
+void TlsfHeap::RemoveBlock(Block* block, Index index) {
+  FirstLevel& first_level = first_levels_[index.first_level];
+  const FreeNode& node = Node(block);
+
+  if (node.prev != nullptr) {
+    Node(node.prev).next = node.next;
+  } else {
+    first_level.lists[index.second_level] = node.next;
+  }
+  if (node.next != nullptr) {
+    Node(node.next).prev = node.prev;
+  }
+
+  if (first_level.lists[index.second_level] == nullptr) {
+    first_level.second_level_bitmap &= ~(uint32_t{1} << index.second_level);
+    if (first_level.second_level_bitmap == 0) {
+      first_level_bitmap_ &= ~(uint32_t{1} << index.first_level);
+    }
+  }
+}
+
+void* TlsfHeap::Allocate(size_t size) {
+  // Every block must be able to hold a FreeNode once it is freed.
+  size = std::max(size, sizeof(FreeNode));
+  if (size > max_block_size_) {
+    return nullptr;
+  }
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+
+  Index index = SearchIndex(size);
+  Block* block = FindFreeBlock(index);
+  if (block == nullptr) {
+    return nullptr;
+  }
+  RemoveBlock(block, index);
+  block->CrashIfInvalid();
+
+  // Only split if the remainder can hold a FreeNode, so that it can be added
+  // to the free lists.
+  if (block->InnerSize() >= size + kBlockOverhead + sizeof(FreeNode)) {
+    Block* leftover;
+    if (block->Split(size, &leftover).ok()) {
+      InsertBlock(leftover);
+    }
+  }
+  block->MarkUsed();
+
+  heap_stats_.bytes_allocated += block->InnerSize();
+  heap_stats_.cumulative_allocated += block->InnerSize();
+  heap_stats_.total_allocate_calls += 1;
+
+  return block->UsableSpace();
+}
+
+void TlsfHeap::Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    InvalidFreeCrash();
+    return;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  block->CrashIfInvalid();
+  if (!block->Used()) {
+    InvalidFreeCrash();
+    return;
+  }
+
+  const size_t size_freed = block->InnerSize();
+  block->MarkFree();
+
+  Block* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    RemoveBlock(prev);
+    block->MergePrev().IgnoreError();  // Cannot fail; both blocks are free.
+    // block is now invalid; prev encompasses it.
+    block = prev;
+  }
+
+  if (!block->Last()) {
+    Block* next = block->Next();
+    if (!next->Used()) {
+      RemoveBlock(next);
+      block->MergeNext().IgnoreError();  // Cannot fail; both blocks are free.
+    }
+  }
+  InsertBlock(block);
+
+  heap_stats_.bytes_allocated -= size_freed;
+  heap_stats_.cumulative_freed += size_freed;
+  heap_stats_.total_free_calls += 1;
+}
+
+// Follows the contract of the C standard realloc() function.
+// If ptr is freed, returns nullptr.
+void* TlsfHeap::Realloc(void* ptr, size_t size) {
+  if (size == 0) {
+    Free(ptr);
+    return nullptr;
+  }
+
+  if (ptr == nullptr) {
+    return Allocate(size);
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    return nullptr;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  if (!block->Used()) {
+    return nullptr;
+  }
+  const size_t old_size = block->InnerSize();
+
+  // Blocks are not shrunk in place.
+  if (old_size >= size) {
+    return ptr;
+  }
+
+  void* new_ptr = Allocate(size);
+  // Don't invalidate ptr if the allocation fails.
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(new_ptr, ptr, old_size);
+
+  Free(ptr);
+  return new_ptr;
+}
+
+void* TlsfHeap::Calloc(size_t num, size_t size) {
+  if (size != 0 && num > std::numeric_limits<size_t>::max() / size) {
+    return nullptr;
+  }
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
+void TlsfHeap::InvalidFreeCrash() {
+  PW_DCHECK(false, "You tried to free an invalid pointer!");
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,197 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t N = 2048;
+
+TEST(TlsfHeap, CanAllocate) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  void* ptr = allocator.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr, nullptr);
+  // The first allocation comes from the start of the region.
+  EXPECT_EQ(ptr, &buf[0] + sizeof(Block) + PW_ALLOCATOR_POISON_OFFSET);
+}
+
+TEST(TlsfHeap, AllocationsDontOverlap) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  uintptr_t ptr1_start = reinterpret_cast<uintptr_t>(ptr1);
+  uintptr_t ptr1_end = ptr1_start + kAllocSize;
+  uintptr_t ptr2_start = reinterpret_cast<uintptr_t>(ptr2);
+
+  EXPECT_GT(ptr2_start, ptr1_end);
+}
+
+TEST(TlsfHeap, CanFreeAndReallocate) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  allocator.Free(ptr1);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TEST(TlsfHeap, ReturnsNullWhenAllocationTooLarge) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  EXPECT_EQ(allocator.Allocate(N), nullptr);
+  EXPECT_EQ(allocator.Allocate(TlsfHeap::MaxBlockSize(13) + 1), nullptr);
+}
+
+TEST(TlsfHeap, FreeingMergesNeighbors) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(256);
+  void* ptr2 = allocator.Allocate(256);
+  void* ptr3 = allocator.Allocate(256);
+  ASSERT_NE(ptr3, nullptr);
+
+  // Free the outer blocks first, so that freeing the middle one merges with
+  // both neighbours.
+  allocator.Free(ptr1);
+  allocator.Free(ptr3);
+  allocator.Free(ptr2);
+
+  // Only a single merged block can satisfy an allocation this large.
+  void* large = allocator.Allocate(N / 2);
+  EXPECT_EQ(large, ptr1);
+}
+
+TEST(TlsfHeap, SmallAllocationsReuseFreedBlock) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  std::array<void*, 8> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(1);
+    ASSERT_NE(ptr, nullptr);
+  }
+  allocator.Free(ptrs[3]);
+  EXPECT_EQ(allocator.Allocate(8), ptrs[3]);
+}
+
+TEST(TlsfHeap, ManyAllocationsAndFrees) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  // Allocate blocks of varying sizes until the heap is full, filling each one
+  // to catch overlaps.
+  std::array<std::byte*, 64> ptrs{};
+  std::array<size_t, 64> sizes{};
+  size_t count = 0;
+  for (; count < ptrs.size(); ++count) {
+    sizes[count] = 8 + (count * 37) % 200;
+    ptrs[count] = static_cast<std::byte*>(allocator.Allocate(sizes[count]));
+    if (ptrs[count] == nullptr) {
+      break;
+    }
+    std::memset(ptrs[count], static_cast<int>(count), sizes[count]);
+  }
+  ASSERT_GT(count, 4u);
+
+  // Free every other block, then the rest.
+  for (size_t i = 0; i < count; i += 2) {
+    allocator.Free(ptrs[i]);
+  }
+  for (size_t i = 1; i < count; i += 2) {
+    for (size_t j = 0; j < sizes[i]; ++j) {
+      ASSERT_EQ(ptrs[i][j], static_cast<std::byte>(i));
+    }
+    allocator.Free(ptrs[i]);
+  }
+
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 0u);
+  EXPECT_EQ(allocator.heap_stats().total_allocate_calls, count);
+  EXPECT_EQ(allocator.heap_stats().total_free_calls, count);
+
+  // Everything merged back into one block.
+  EXPECT_EQ(allocator.Allocate(N / 2),
+            &buf[0] + sizeof(Block) + PW_ALLOCATOR_POISON_OFFSET);
+}
+
+TEST(TlsfHeap, ReallocCopiesData) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeapBuffer allocator(buf);
+
+  auto* ptr = static_cast<uint8_t*>(allocator.Allocate(32));
+  ASSERT_NE(ptr, nullptr);
+  for (uint8_t i = 0; i < 32; ++i) {
+    ptr[i] = i;
+  }
+
+  // Growing moves the data.
+  auto* grown = static_cast<uint8_t*>(allocator.Realloc(ptr, 512));
+  ASSERT_NE(grown, nullptr);
+  for (uint8_t i = 0; i < 32; ++i) {
+    EXPECT_EQ(grown[i], i);
+  }
+
+  // Shrinking keeps the block.
+  EXPECT_EQ(allocator.Realloc(grown, 16), grown);
+  EXPECT_EQ(allocator.Realloc(grown, 0), nullptr);
+}
+
+TEST(TlsfHeap, CallocZeroesMemory) {
+  alignas(Block) std::byte buf[N];
+  std::memset(buf, 0xff, sizeof(buf));
+
+  TlsfHeapBuffer allocator(buf);
+
+  auto* ptr = static_cast<std::byte*>(allocator.Calloc(16, 4));
+  ASSERT_NE(ptr, nullptr);
+  for (size_t i = 0; i < 64; ++i) {
+    EXPECT_EQ(ptr[i], std::byte(0));
+  }
+
+  EXPECT_EQ(allocator.Calloc(SIZE_MAX / 2, 4), nullptr);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,152 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_analog/continuous_analog_input.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::analog {
+namespace {
+
+// Fake backend that fills its buffers with a counter when the test calls
+// Fill(), standing in for the DMA completion interrupt.
+class TestContinuousAnalogInput : public ContinuousAnalogInput {
+ public:
+  Limits GetLimits() const override { return {.min = 0, .max = 4095}; }
+
+  void Fill() {
+    std::span<int32_t> buffer = (fills_ % 2 == 0) ? first_ : second_;
+    for (int32_t& sample : buffer) {
+      sample = next_sample_++;
+    }
+    fills_ += 1;
+    BufferFilled();
+  }
+
+  bool hardware_running() const { return hardware_running_; }
+
+ private:
+  Status DoStart(std::span<int32_t> first,
+                 std::span<int32_t> second) override {
+    first_ = first;
+    second_ = second;
+    hardware_running_ = true;
+    return OkStatus();
+  }
+
+  Status DoStop() override {
+    hardware_running_ = false;
+    return OkStatus();
+  }
+
+  std::span<int32_t> first_;
+  std::span<int32_t> second_;
+  size_t fills_ = 0;
+  int32_t next_sample_ = 0;
+  bool hardware_running_ = false;
+};
+
+class ContinuousAnalogInputTest : public ::testing::Test {
+ protected:
+  std::array<int32_t, 4> first_ = {};
+  std::array<int32_t, 4> second_ = {};
+  TestContinuousAnalogInput input_;
+  int32_t last_first_sample_ = -1;
+  size_t callbacks_ = 0;
+};
+
+TEST_F(ContinuousAnalogInputTest, DeliversBuffersInOrder) {
+  last_first_sample_ = -4;
+  ASSERT_EQ(input_.Start(first_,
+                         second_,
+                         [this](std::span<const int32_t> samples) {
+                           ASSERT_EQ(samples.size(), 4u);
+                           EXPECT_EQ(samples.front(), last_first_sample_ + 4);
+                           last_first_sample_ = samples.front();
+                           callbacks_ += 1;
+                         }),
+            OkStatus());
+
+  for (int i = 0; i < 5; ++i) {
+    input_.Fill();
+  }
+  EXPECT_EQ(callbacks_, 5u);
+  EXPECT_EQ(input_.dropped_buffers(), 0u);
+}
+
+TEST_F(ContinuousAnalogInputTest, AlternatesBuffers) {
+  ASSERT_EQ(input_.Start(first_,
+                         second_,
+                         [this](std::span<const int32_t> samples) {
+                           const int32_t* expected =
+                               callbacks_ % 2 == 0 ? first_.data()
+                                                   : second_.data();
+                           EXPECT_EQ(samples.data(), expected);
+                           callbacks_ += 1;
+                         }),
+            OkStatus());
+
+  for (int i = 0; i < 4; ++i) {
+    input_.Fill();
+  }
+  EXPECT_EQ(callbacks_, 4u);
+}
+
+TEST_F(ContinuousAnalogInputTest, StartAndStop) {
+  EXPECT_EQ(input_.Stop(), Status::FailedPrecondition());
+
+  ASSERT_EQ(input_.Start(first_, second_, [](std::span<const int32_t>) {}),
+            OkStatus());
+  EXPECT_TRUE(input_.running());
+  EXPECT_TRUE(input_.hardware_running());
+  EXPECT_EQ(input_.Start(first_, second_, [](std::span<const int32_t>) {}),
+            Status::FailedPrecondition());
+
+  EXPECT_EQ(input_.Stop(), OkStatus());
+  EXPECT_FALSE(input_.running());
+  EXPECT_FALSE(input_.hardware_running());
+}
+
+TEST_F(ContinuousAnalogInputTest, RejectsMismatchedBuffers) {
+  std::array<int32_t, 3> small = {};
+  EXPECT_EQ(input_.Start(first_, small, [](std::span<const int32_t>) {}),
+            Status::InvalidArgument());
+  EXPECT_EQ(input_.Start({}, {}, [](std::span<const int32_t>) {}),
+            Status::InvalidArgument());
+  EXPECT_FALSE(input_.running());
+}
+
+TEST_F(ContinuousAnalogInputTest, CountsBuffersFilledDuringCallback) {
+  ASSERT_EQ(input_.Start(first_,
+                         second_,
+                         [this](std::span<const int32_t>) {
+                           callbacks_ += 1;
+                           // Simulate the next completion interrupt preempting
+                           // this callback.
+                           if (callbacks_ == 1) {
+                             input_.Fill();
+                           }
+                         }),
+            OkStatus());
+
+  input_.Fill();
+  input_.Fill();
+  EXPECT_EQ(callbacks_, 2u);
+  EXPECT_EQ(input_.dropped_buffers(), 1u);
+}
+
+}  // namespace
+}  // namespace pw::analog
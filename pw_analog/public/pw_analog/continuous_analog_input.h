@@ -0,0 +1,139 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_analog/analog_input.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::analog {
+
+// Base interface for continuously sampling one ADC channel into a pair of
+// caller-provided ping-pong buffers, typically filled by DMA.
+//
+// While the hardware fills one buffer, the other full buffer is handed to a
+// callback, so there is no per-sample call. The callback is invoked from the
+// backend's completion context, which is often an interrupt, and the buffer is
+// reused for new samples as soon as the callback returns. Callbacks should copy
+// the samples out, for example into a pw::multisink::MultiSink or a
+// pw_transfer stream, rather than doing heavy processing.
+//
+// Backends implement DoStart() and DoStop() to program the hardware, and call
+// BufferFilled() each time the buffer being filled is complete.
+class ContinuousAnalogInput {
+ public:
+  using Limits = AnalogInput::Limits;
+  using BufferCallback = Function<void(std::span<const int32_t> samples)>;
+
+  virtual ~ContinuousAnalogInput() = default;
+
+  // Starts continuous acquisition, filling `first` and then `second`
+  // repeatedly and invoking `callback` with each buffer as it fills up. The
+  // buffers must stay valid until Stop() returns.
+  //
+  // Returns:
+  //   OK: Acquisition started.
+  //   FailedPrecondition: Acquisition is already running.
+  //   InvalidArgument: The buffers are empty or differ in size.
+  //   Other statuses left up to the implementer.
+  Status Start(std::span<int32_t> first,
+               std::span<int32_t> second,
+               BufferCallback&& callback) {
+    if (running_) {
+      return Status::FailedPrecondition();
+    }
+    if (first.empty() || first.size() != second.size()) {
+      return Status::InvalidArgument();
+    }
+
+    buffers_ = {first, second};
+    filling_ = 0;
+    dropped_buffers_ = 0;
+    callback_ = std::move(callback);
+    PW_TRY(DoStart(first, second));
+    running_ = true;
+    return OkStatus();
+  }
+
+  // Stops acquisition. No callbacks are invoked after this returns, and any
+  // partially filled buffer is discarded.
+  //
+  // Returns:
+  //   OK: Acquisition stopped.
+  //   FailedPrecondition: Acquisition is not running.
+  //   Other statuses left up to the implementer.
+  Status Stop() {
+    if (!running_) {
+      return Status::FailedPrecondition();
+    }
+    const Status status = DoStop();
+    running_ = false;
+    callback_ = nullptr;
+    return status;
+  }
+
+  bool running() const { return running_; }
+
+  // The number of full buffers that were not delivered because the previous
+  // callback was still running when they completed. Reset by Start().
+  size_t dropped_buffers() const { return dropped_buffers_; }
+
+  // Returns the range of the ADC sample.
+  // These values do not change at run time.
+  virtual Limits GetLimits() const = 0;
+
+ protected:
+  // Called by the backend when the buffer being filled is full and the
+  // hardware has moved on to the other buffer. Delivers the full buffer to the
+  // callback, or counts it as dropped if a previous callback is still running,
+  // such as when a completion interrupt preempts a slow callback.
+  void BufferFilled() {
+    const size_t full = filling_;
+    filling_ ^= 1;
+
+    if (delivering_ || callback_ == nullptr) {
+      dropped_buffers_ += 1;
+      return;
+    }
+
+    delivering_ = true;
+    callback_(buffers_[full]);
+    delivering_ = false;
+  }
+
+ private:
+  // Programs the hardware to fill `first`, then `second`, continuously.
+  virtual Status DoStart(std::span<int32_t> first,
+                         std::span<int32_t> second) = 0;
+
+  // Stops the hardware. No further calls to BufferFilled() may be made after
+  // this returns.
+  virtual Status DoStop() = 0;
+
+  std::array<std::span<int32_t>, 2> buffers_;
+  size_t filling_ = 0;
+  size_t dropped_buffers_ = 0;
+  bool delivering_ = false;
+  bool running_ = false;
+  BufferCallback callback_;
+};
+
+}  // namespace pw::analog
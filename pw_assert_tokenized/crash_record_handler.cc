@@ -0,0 +1,69 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_assert_tokenized/crash_record.h"
+
+#include <cstdint>
+
+#include "pw_assert_tokenized/handler.h"
+
+namespace pw::assert_tokenized {
+namespace {
+
+PW_PLACE_IN_SECTION(PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION)
+persistent_ram::Persistent<CrashRecord> persistent_crash_record;
+
+[[noreturn]] void Record(CrashRecord::Kind kind,
+                         uint32_t token,
+                         int line_number,
+                         uint32_t value_a = 0,
+                         uint32_t value_b = 0) {
+  persistent_crash_record.emplace(
+      CrashRecord{kind, token, line_number, {value_a, value_b}});
+  pw_assert_tokenized_HandleCrashRecord();
+}
+
+}  // namespace
+
+persistent_ram::Persistent<CrashRecord>& crash_record() {
+  return persistent_crash_record;
+}
+
+}  // namespace pw::assert_tokenized
+
+using pw::assert_tokenized::CrashRecord;
+
+extern "C" void pw_assert_tokenized_HandleAssertFailure(
+    uint32_t tokenized_file_name, int line_number) {
+  pw::assert_tokenized::Record(
+      CrashRecord::Kind::kAssert, tokenized_file_name, line_number);
+}
+
+extern "C" void pw_assert_tokenized_HandleCheckFailure(
+    uint32_t tokenized_message, int line_number) {
+  pw::assert_tokenized::Record(
+      CrashRecord::Kind::kCheck, tokenized_message, line_number);
+}
+
+extern "C" void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t value_a,
+    uint32_t value_b) {
+  pw::assert_tokenized::Record(CrashRecord::Kind::kCheckWithValues,
+                               tokenized_message,
+                               line_number,
+                               value_a,
+                               value_b);
+}
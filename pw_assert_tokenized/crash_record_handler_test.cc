@@ -0,0 +1,159 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This test routes the PW_CHECK macros to the tokenized check backend and the
+// crash record handler, then verifies the contents of the crash record.
+
+#include "pw_assert_tokenized/check_tokenized.h"
+
+// This directly includes the assert facade implementation header rather than
+// going through the backend header indirection mechanism, so that the checks
+// in this file use the tokenized backend regardless of the build's backend.
+//
+// clang-format off
+#include "pw_assert/internal/check_impl.h"
+// clang-format on
+
+#include <csetjmp>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_assert_tokenized/crash_record.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::assert_tokenized {
+namespace {
+
+std::jmp_buf crash_return;
+
+}  // namespace
+}  // namespace pw::assert_tokenized
+
+// Returns to the test that triggered the failure instead of rebooting.
+extern "C" void pw_assert_tokenized_HandleCrashRecord(void) {
+  std::longjmp(pw::assert_tokenized::crash_return, 1);
+}
+
+namespace pw::assert_tokenized {
+namespace {
+
+// Runs the function and returns true if it reached the crash record handler.
+template <typename Function>
+bool Crashes(Function function) {
+  if (setjmp(crash_return) == 0) {
+    function();
+    return false;
+  }
+  return true;
+}
+
+class CrashRecordHandler : public ::testing::Test {
+ protected:
+  CrashRecordHandler() { crash_record().Invalidate(); }
+
+  ~CrashRecordHandler() { crash_record().Invalidate(); }
+
+  const CrashRecord& record() { return crash_record().value(); }
+};
+
+TEST_F(CrashRecordHandler, PassingChecks_DoNotRecord) {
+  int a = 1;
+  EXPECT_FALSE(Crashes([&] { PW_CHECK_INT_EQ(a, 1); }));
+  EXPECT_FALSE(Crashes([&] { PW_CHECK(a == 1); }));
+  EXPECT_FALSE(crash_record().has_value());
+}
+
+TEST_F(CrashRecordHandler, Check_RecordsTokenAndLine) {
+  constexpr int kLine = __LINE__ + 1;
+  ASSERT_TRUE(Crashes([] { PW_CHECK(false); }));
+
+  ASSERT_TRUE(crash_record().has_value());
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheck);
+  const uint32_t token =
+      PW_TOKENIZE_STRING("Check failure in " __FILE__ ": false, ");
+  EXPECT_EQ(record().token, token);
+  EXPECT_EQ(record().line_number, kLine);
+}
+
+TEST_F(CrashRecordHandler, IntEq_RecordsRawValues) {
+  int a = 1;
+  int b = 2;
+  constexpr int kLine = __LINE__ + 1;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_INT_EQ(a, b); }));
+
+  ASSERT_TRUE(crash_record().has_value());
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheckWithValues);
+  const uint32_t token = PW_TOKENIZE_STRING(
+      "Check failure in " __FILE__ ": a == b (0x%08x == 0x%08x), ");
+  EXPECT_EQ(record().token, token);
+  EXPECT_EQ(record().line_number, kLine);
+  EXPECT_EQ(record().values[0], 1u);
+  EXPECT_EQ(record().values[1], 2u);
+}
+
+TEST_F(CrashRecordHandler, NegativeInt_RecordsTwosComplement) {
+  int a = -1;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_INT_GE(a, 0); }));
+
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheckWithValues);
+  EXPECT_EQ(record().values[0], 0xffffffffu);
+  EXPECT_EQ(record().values[1], 0u);
+}
+
+TEST_F(CrashRecordHandler, UintWithMessage_TokenIncludesMessage) {
+  unsigned x = 10;
+  unsigned y = 3;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_UINT_LT(x, y, "Too many items"); }));
+
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheckWithValues);
+  const uint32_t token = PW_TOKENIZE_STRING(
+      "Check failure in " __FILE__ ": x < y (0x%08x < 0x%08x), Too many items");
+  EXPECT_EQ(record().token, token);
+  EXPECT_EQ(record().values[0], 10u);
+  EXPECT_EQ(record().values[1], 3u);
+}
+
+TEST_F(CrashRecordHandler, Float_RecordsBits) {
+  float a = 1.5f;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_FLOAT_EXACT_EQ(a, 2.0f); }));
+
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheckWithValues);
+  EXPECT_EQ(record().values[0], 0x3fc00000u);
+  EXPECT_EQ(record().values[1], 0x40000000u);
+}
+
+TEST_F(CrashRecordHandler, Pointer_RecordsLow32Bits) {
+  int value = 0;
+  int* a = &value;
+  int* b = nullptr;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_PTR_EQ(a, b); }));
+
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheckWithValues);
+  EXPECT_EQ(record().values[0],
+            static_cast<uint32_t>(reinterpret_cast<uintptr_t>(a)));
+  EXPECT_EQ(record().values[1], 0u);
+}
+
+TEST_F(CrashRecordHandler, SecondFailure_OverwritesRecord) {
+  int a = 1;
+  ASSERT_TRUE(Crashes([&] { PW_CHECK_INT_NE(a, 1); }));
+  ASSERT_TRUE(Crashes([] { PW_CHECK(false); }));
+
+  EXPECT_EQ(record().kind, CrashRecord::Kind::kCheck);
+  EXPECT_EQ(record().values[0], 0u);
+  EXPECT_EQ(record().values[1], 0u);
+}
+
+}  // namespace
+}  // namespace pw::assert_tokenized
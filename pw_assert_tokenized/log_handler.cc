@@ -22,6 +22,7 @@
 #include "pw_base64/base64.h"
 #include "pw_log/log.h"
 #include "pw_log_tokenized/log_tokenized.h"
+#include "pw_varint/varint.h"
 
 extern "C" void pw_assert_tokenized_HandleAssertFailure(
     uint32_t tokenized_file_name, int line_number) {
@@ -64,3 +65,28 @@ extern "C" void pw_assert_tokenized_HandleCheckFailure(
       payload, token_buffer, sizeof(token_buffer));
   PW_UNREACHABLE;
 }
+
+extern "C" void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t value_a,
+    uint32_t value_b) {
+  const uint32_t payload = _PW_LOG_TOKENIZED_LEVEL(PW_LOG_LEVEL_FATAL) |
+                           _PW_LOG_TOKENIZED_FLAGS(PW_LOG_FLAGS) |
+                           _PW_LOG_TOKENIZED_LINE(line_number);
+
+  // Encode the values as the tokenizer encodes 32-bit integer arguments.
+  std::byte message[sizeof(tokenized_message) +
+                    2 * pw::varint::kMaxVarint32SizeBytes];
+  std::memcpy(message, &tokenized_message, sizeof(tokenized_message));
+  size_t size = sizeof(tokenized_message);
+
+  for (uint32_t value : {value_a, value_b}) {
+    size += pw::varint::Encode(static_cast<int32_t>(value),
+                               std::span(message).subspan(size));
+  }
+
+  pw_tokenizer_HandleEncodedMessageWithPayload(
+      payload, reinterpret_cast<const uint8_t*>(message), size);
+  PW_UNREACHABLE;
+}
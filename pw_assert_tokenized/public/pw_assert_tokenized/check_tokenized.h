@@ -13,6 +13,13 @@
 // the License.
 #pragma once
 
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdint.h>
+#endif  // __cplusplus
+
 #include "pw_assert_tokenized/handler.h"
 #include "pw_tokenizer/tokenize.h"
 
@@ -28,13 +35,92 @@
 #define PW_HANDLE_ASSERT_FAILURE(condition_string, message, ...) \
   _PW_ASSERT_TOKENIZED_TO_HANDLER(condition_string ", " message)
 
-#define PW_HANDLE_ASSERT_BINARY_COMPARE_FAILURE(arg_a_str,         \
-                                                arg_a_val,         \
-                                                comparison_op_str, \
-                                                arg_b_str,         \
-                                                arg_b_val,         \
-                                                type_fmt,          \
-                                                message,           \
-                                                ...)               \
-  _PW_ASSERT_TOKENIZED_TO_HANDLER(                                 \
-      arg_a_str " " comparison_op_str " " arg_b_str ", " message #__VA_ARGS__)
+// Binary comparison failures capture both evaluated values as raw 32-bit
+// words. The values are passed to the handler rather than formatted, so the
+// tokenized message formats them as hex: integers and pointers appear as their
+// low 32 bits, floats as their IEEE 754 bits, and strings (from PW_CHECK_OK) as
+// 0.
+#define PW_HANDLE_ASSERT_BINARY_COMPARE_FAILURE(arg_a_str,                 \
+                                                arg_a_val,                 \
+                                                comparison_op_str,         \
+                                                arg_b_str,                 \
+                                                arg_b_val,                 \
+                                                type_fmt,                  \
+                                                message,                   \
+                                                ...)                       \
+  do {                                                                     \
+    const uint32_t token = PW_TOKENIZE_STRING(                             \
+        "Check failure in " __FILE__ ": " arg_a_str " " comparison_op_str  \
+        " " arg_b_str " (0x%08x " comparison_op_str " 0x%08x), " message   \
+        #__VA_ARGS__);                                                     \
+    pw_assert_tokenized_HandleCheckFailureWithValues(                      \
+        token,                                                             \
+        __LINE__,                                                          \
+        _PW_ASSERT_TOKENIZED_RAW_VALUE(arg_a_val),                         \
+        _PW_ASSERT_TOKENIZED_RAW_VALUE(arg_b_val));                        \
+  } while (0)
+
+// Converts an evaluated CHECK argument to a raw 32-bit value without
+// formatting it.
+#ifdef __cplusplus
+
+namespace pw::assert_tokenized::internal {
+
+constexpr uint32_t RawValue(int value) { return static_cast<uint32_t>(value); }
+constexpr uint32_t RawValue(unsigned int value) { return value; }
+constexpr uint32_t RawValue(const char*) { return 0; }
+
+inline uint32_t RawValue(const void* value) {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+}
+
+inline uint32_t RawValue(float value) {
+  static_assert(sizeof(value) == sizeof(uint32_t));
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+}  // namespace pw::assert_tokenized::internal
+
+#define _PW_ASSERT_TOKENIZED_RAW_VALUE(value) \
+  ::pw::assert_tokenized::internal::RawValue(value)
+
+#else
+
+static inline uint32_t _pw_assert_tokenized_RawInt(int value) {
+  return (uint32_t)value;
+}
+
+static inline uint32_t _pw_assert_tokenized_RawUint(unsigned int value) {
+  return value;
+}
+
+static inline uint32_t _pw_assert_tokenized_RawPointer(const void* value) {
+  return (uint32_t)(uintptr_t)value;
+}
+
+static inline uint32_t _pw_assert_tokenized_RawString(const char* value) {
+  (void)value;
+  return 0;
+}
+
+static inline uint32_t _pw_assert_tokenized_RawFloat(float value) {
+  union {
+    float value;
+    uint32_t bits;
+  } raw;
+  raw.value = value;
+  return raw.bits;
+}
+
+#define _PW_ASSERT_TOKENIZED_RAW_VALUE(value)            \
+  _Generic((value),                                      \
+      int: _pw_assert_tokenized_RawInt,                  \
+      unsigned int: _pw_assert_tokenized_RawUint,        \
+      float: _pw_assert_tokenized_RawFloat,              \
+      char*: _pw_assert_tokenized_RawString,             \
+      const char*: _pw_assert_tokenized_RawString,       \
+      default: _pw_assert_tokenized_RawPointer)(value)
+
+#endif  // __cplusplus
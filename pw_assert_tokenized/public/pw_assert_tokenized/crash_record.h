@@ -0,0 +1,63 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_persistent_ram/persistent.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_preprocessor/util.h"
+
+// The section that holds the crash record. It must not be initialized or
+// cleared on boot so that the record survives the reboot after a crash.
+#ifndef PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION
+#define PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION ".noinit"
+#endif  // PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION
+
+namespace pw::assert_tokenized {
+
+// A failed PW_ASSERT or PW_CHECK, as recorded by the crash_record_handler
+// backend. The record holds only the token, line number, and raw values that
+// were passed to the handler; nothing is formatted.
+struct CrashRecord {
+  enum class Kind : uint32_t {
+    // PW_ASSERT: token is the tokenized file name.
+    kAssert = 1,
+    // PW_CHECK: token is the tokenized message.
+    kCheck = 2,
+    // Binary comparison PW_CHECK: token is the tokenized message, which takes
+    // the two values as arguments.
+    kCheckWithValues = 3,
+  };
+
+  Kind kind;
+  uint32_t token;
+  int32_t line_number;
+  uint32_t values[2];
+};
+
+// The crash record in persistent RAM. It has a value if a PW_ASSERT or
+// PW_CHECK failed before the last reboot. Call Invalidate() once the record has
+// been reported.
+persistent_ram::Persistent<CrashRecord>& crash_record();
+
+}  // namespace pw::assert_tokenized
+
+PW_EXTERN_C_START
+
+// Called by the crash_record_handler backend after the crash record is written.
+// This must be provided by the application, and typically reboots the device.
+PW_NO_RETURN void pw_assert_tokenized_HandleCrashRecord(void);
+
+PW_EXTERN_C_END
@@ -26,4 +26,12 @@ PW_NO_RETURN void pw_assert_tokenized_HandleAssertFailure(
 PW_NO_RETURN void pw_assert_tokenized_HandleCheckFailure(
     uint32_t tokenized_message, int line_number);
 
+// Handles a failed binary comparison CHECK. The tokenized message has two
+// 0x%08x arguments, which are the raw values of the compared arguments.
+PW_NO_RETURN void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t value_a,
+    uint32_t value_b);
+
 PW_EXTERN_C_END
@@ -0,0 +1,98 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how fast the bulk and group-at-a-time implementations encode and
+// decode a buffer, and logs the results.
+
+#define PW_LOG_MODULE_NAME "BASE64"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_base64/base64.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+
+namespace {
+
+using pw::chrono::SystemClock;
+
+constexpr size_t kBinarySizeBytes = 3072;
+constexpr size_t kIterations = 256;
+
+std::array<std::byte, kBinarySizeBytes> binary;
+std::array<char, pw::base64::EncodedSize(kBinarySizeBytes)> encoded;
+std::array<std::byte, kBinarySizeBytes> decoded;
+
+// Keeps the compiler from discarding the results.
+volatile size_t result_sink;
+
+template <typename Function>
+void Run(const char* name, Function&& function) {
+  const SystemClock::time_point start = SystemClock::now();
+  for (size_t i = 0; i < kIterations; ++i) {
+    result_sink = function();
+  }
+  const SystemClock::duration elapsed = SystemClock::now() - start;
+
+  const uint64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (ns == 0u) {
+    PW_LOG_ERROR("%s: the system clock is too coarse to time one run", name);
+    return;
+  }
+
+  const uint64_t bytes = uint64_t(kBinarySizeBytes) * kIterations;
+  PW_LOG_INFO(
+      "%-16s %8u KB/s", name, static_cast<unsigned>(bytes * 1'000'000u / ns));
+}
+
+}  // namespace
+
+int main() {
+  uint64_t value = 1;
+  for (std::byte& b : binary) {
+    b = std::byte(value >> 56);
+    value = value * 6364136223846793005u + 1442695040888963407u;
+  }
+  pw_Base64Encode(binary.data(), binary.size(), encoded.data());
+
+  PW_LOG_INFO("Encoding and decoding %u B, %u times",
+              static_cast<unsigned>(kBinarySizeBytes),
+              static_cast<unsigned>(kIterations));
+
+  Run("Encode bytewise", [] {
+    _pw_Base64InternalEncodeBytewise(
+        binary.data(), binary.size(), encoded.data());
+    return encoded.size();
+  });
+  Run("Encode", [] {
+    pw_Base64Encode(binary.data(), binary.size(), encoded.data());
+    return encoded.size();
+  });
+  Run("Decode bytewise", [] {
+    return _pw_Base64InternalDecodeBytewise(
+        encoded.data(), encoded.size(), decoded.data());
+  });
+  Run("Decode", [] {
+    return pw_Base64Decode(encoded.data(), encoded.size(), decoded.data());
+  });
+  Run("IsValid", [] {
+    return size_t{pw_Base64IsValid(encoded.data(), encoded.size())};
+  });
+
+  return 0;
+}
@@ -14,6 +14,7 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -279,6 +280,72 @@ TEST(Base64, Decode_UrlSafeDecode) {
   EXPECT_STREQ("\xf9\xff\xffYo!", output);
 }
 
+// The bulk encoder and decoder handle long data in blocks, then finish the
+// rest a group at a time. Check every split against the group-at-a-time
+// implementation.
+constexpr size_t kMaxBulkTestSize = 100;
+
+std::array<std::byte, kMaxBulkTestSize> BulkTestData() {
+  std::array<std::byte, kMaxBulkTestSize> data;
+  uint8_t value = 1;
+  for (std::byte& b : data) {
+    b = std::byte{value};
+    value = static_cast<uint8_t>(value * 37 + 11);
+  }
+  return data;
+}
+
+TEST(Base64, Encode_MatchesBytewise) {
+  const auto data = BulkTestData();
+  for (size_t size = 0; size <= data.size(); ++size) {
+    char expected[EncodedSize(kMaxBulkTestSize)] = {};
+    char actual[EncodedSize(kMaxBulkTestSize)] = {};
+    _pw_Base64InternalEncodeBytewise(data.data(), size, expected);
+    Encode(std::span(data).first(size), actual);
+    EXPECT_EQ(0, std::memcmp(expected, actual, EncodedSize(size)));
+  }
+}
+
+TEST(Base64, Decode_MatchesBytewise) {
+  const auto data = BulkTestData();
+  for (size_t size = 0; size <= data.size(); ++size) {
+    char encoded[EncodedSize(kMaxBulkTestSize)];
+    const size_t encoded_size = EncodedSize(size);
+    Encode(std::span(data).first(size), encoded);
+
+    std::byte decoded[kMaxBulkTestSize + 2] = {};
+    ASSERT_EQ(size, Decode(std::string_view(encoded, encoded_size), decoded));
+    EXPECT_EQ(0, std::memcmp(data.data(), decoded, size));
+
+    // Decode the URL-safe alphabet in place.
+    for (size_t i = 0; i < encoded_size; ++i) {
+      if (encoded[i] == '+') {
+        encoded[i] = '-';
+      } else if (encoded[i] == '/') {
+        encoded[i] = '_';
+      }
+    }
+    ASSERT_EQ(size, Decode(std::string_view(encoded, encoded_size), encoded));
+    EXPECT_EQ(0, std::memcmp(data.data(), encoded, size));
+  }
+}
+
+TEST(Base64, IsValid_InvalidCharacterInLongData) {
+  char encoded[EncodedSize(kMaxBulkTestSize)];
+  Encode(BulkTestData(), encoded);
+  const std::string_view base64(encoded, sizeof(encoded));
+  ASSERT_TRUE(IsValid(base64));
+
+  for (size_t i = 0; i < sizeof(encoded); ++i) {
+    const char original = encoded[i];
+    encoded[i] = '*';
+    EXPECT_FALSE(IsValid(base64));
+    encoded[i] = static_cast<char>(0xc0);
+    EXPECT_FALSE(IsValid(base64));
+    encoded[i] = original;
+  }
+}
+
 TEST(Base64, Empty) {
   char buffer[] = "DO NOT TOUCH";
   EXPECT_EQ(0u, EncodedSize(0));
@@ -53,6 +53,16 @@ size_t pw_Base64Decode(const char* base64,
                        size_t base64_size_bytes,
                        void* output);
 
+// The group-at-a-time implementations of pw_Base64Encode and pw_Base64Decode,
+// which finish the data left over after the bulk encoder or decoder. Do not
+// call them directly.
+void _pw_Base64InternalEncodeBytewise(const void* binary_data,
+                                      const size_t binary_size_bytes,
+                                      char* output);
+size_t _pw_Base64InternalDecodeBytewise(const char* base64,
+                                        size_t base64_size_bytes,
+                                        void* output);
+
 // Returns true if the provided string is valid Base64 encoded data. Accepts
 // either the standard (+/) or URL-safe (-_) alphabets.
 //
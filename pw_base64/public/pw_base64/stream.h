@@ -0,0 +1,92 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::base64 {
+
+// Encodes the data written to it as Base64 and writes the characters to another
+// Writer. The data does not have to arrive in 3-byte groups; up to 2 bytes are
+// held until the rest of their group is written.
+//
+// Call Finish() after the last write to write the held bytes and padding. The
+// encoder can then start a new Base64 string.
+//
+// If the underlying writer fails, a write may have been partly encoded.
+class Encoder : public stream::NonSeekableWriter {
+ public:
+  constexpr Encoder(stream::Writer& writer) : writer_(writer) {}
+
+  // Encodes any held bytes, with padding, and resets the encoder.
+  Status Finish();
+
+  // Number of bytes held until the rest of their group is written.
+  size_t pending_bytes() const { return pending_size_; }
+
+ private:
+  // Data is encoded in chunks of this size, so the characters fit on the stack.
+  static constexpr size_t kChunkSizeBytes = 48;
+
+  Status DoWrite(ConstByteSpan data) override;
+
+  size_t ConservativeLimit(LimitType type) const override;
+
+  stream::Writer& writer_;
+  std::array<std::byte, 2> pending_{};
+  size_t pending_size_ = 0;
+};
+
+// Reads Base64 characters from another Reader and returns the decoded data.
+// Accepts either the standard (+/) or URL-safe (-_) alphabet.
+//
+// The characters do not have to arrive in 4-character groups. Incomplete
+// groups are held until the rest of the group arrives, and decoded bytes that
+// do not fit in a read are returned by the next one.
+//
+// Reads return DATA_LOSS if the input has an invalid character, or ends with an
+// incomplete group. Only the last group of the input may be padded.
+class Decoder : public stream::NonSeekableReader {
+ public:
+  constexpr Decoder(stream::Reader& reader) : reader_(reader) {}
+
+ private:
+  // Characters are read in chunks of this size, so they fit on the stack.
+  static constexpr size_t kChunkSizeChars = 64;
+
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  size_t ConservativeLimit(LimitType type) const override;
+
+  stream::Reader& reader_;
+
+  // The characters of an incomplete group.
+  std::array<char, 3> partial_{};
+  size_t partial_size_ = 0;
+
+  // Decoded bytes that did not fit in the last read.
+  std::array<std::byte, 2> pending_{};
+  size_t pending_size_ = 0;
+
+  // Set once a padded group is decoded, since it must be the last group.
+  bool padded_ = false;
+};
+
+}  // namespace pw::base64
@@ -0,0 +1,169 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_base64/stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+#include "pw_base64/base64.h"
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr size_t kGroupSizeBytes = 3;
+constexpr size_t kGroupSizeChars = 4;
+
+// Checks that = only appears as padding at the end of the last group.
+bool PaddingIsValid(const char* chars, size_t size) {
+  const char* padding = std::find(chars, chars + size, '=');
+  const size_t padding_size = (chars + size) - padding;
+  return padding_size <= 2u && std::all_of(padding, chars + size, [](char c) {
+           return c == '=';
+         });
+}
+
+}  // namespace
+
+Status Encoder::Finish() {
+  if (pending_size_ == 0u) {
+    return OkStatus();
+  }
+  std::array<char, kGroupSizeChars> chars;
+  pw_Base64Encode(pending_.data(), pending_size_, chars.data());
+  PW_TRY(writer_.Write(std::as_bytes(std::span(chars))));
+  pending_size_ = 0;
+  return OkStatus();
+}
+
+Status Encoder::DoWrite(ConstByteSpan data) {
+  // Complete the held group first.
+  if (pending_size_ != 0u) {
+    const size_t needed = kGroupSizeBytes - pending_size_;
+    if (data.size() < needed) {
+      std::memcpy(&pending_[pending_size_], data.data(), data.size());
+      pending_size_ += data.size();
+      return OkStatus();
+    }
+
+    std::array<std::byte, kGroupSizeBytes> group;
+    std::memcpy(group.data(), pending_.data(), pending_size_);
+    std::memcpy(&group[pending_size_], data.data(), needed);
+    std::array<char, kGroupSizeChars> chars;
+    Encode(group, chars.data());
+    PW_TRY(writer_.Write(std::as_bytes(std::span(chars))));
+    pending_size_ = 0;
+    data = data.subspan(needed);
+  }
+
+  while (data.size() >= kGroupSizeBytes) {
+    const size_t chunk_size = std::min(
+        data.size() / kGroupSizeBytes * kGroupSizeBytes, kChunkSizeBytes);
+    std::array<char, EncodedSize(kChunkSizeBytes)> chars;
+    Encode(data.first(chunk_size), chars.data());
+    PW_TRY(writer_.Write(
+        std::as_bytes(std::span(chars).first(EncodedSize(chunk_size)))));
+    data = data.subspan(chunk_size);
+  }
+
+  std::memcpy(pending_.data(), data.data(), data.size());
+  pending_size_ = data.size();
+  return OkStatus();
+}
+
+size_t Encoder::ConservativeLimit(LimitType type) const {
+  if (type != LimitType::kWrite) {
+    return 0;
+  }
+  const size_t limit = writer_.ConservativeWriteLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  const size_t bytes = limit / kGroupSizeChars * kGroupSizeBytes;
+  return bytes > pending_size_ ? bytes - pending_size_ : 0;
+}
+
+StatusWithSize Decoder::DoRead(ByteSpan dest) {
+  if (pending_size_ != 0u) {
+    const size_t size = std::min(dest.size(), pending_size_);
+    std::memcpy(dest.data(), pending_.data(), size);
+    pending_size_ -= size;
+    std::memmove(pending_.data(), &pending_[size], pending_size_);
+    return StatusWithSize(size);
+  }
+  if (dest.empty()) {
+    return StatusWithSize(0);
+  }
+
+  // Read no more groups than dest can hold, so at most 2 decoded bytes are
+  // left over.
+  std::array<char, kChunkSizeChars> chars;
+  const size_t max_chars =
+      std::min(chars.size(),
+               (dest.size() + kGroupSizeBytes - 1) / kGroupSizeBytes *
+                   kGroupSizeChars);
+  std::memcpy(chars.data(), partial_.data(), partial_size_);
+  size_t size = partial_size_;
+
+  while (size < kGroupSizeChars) {
+    const std::span<char> unread =
+        std::span(chars).subspan(size, max_chars - size);
+    Result<ByteSpan> result = reader_.Read(std::as_writable_bytes(unread));
+    if (!result.ok()) {
+      std::memcpy(partial_.data(), chars.data(), size);
+      partial_size_ = size;
+      if (result.status().IsOutOfRange() && size != 0u) {
+        return StatusWithSize::DataLoss();
+      }
+      return StatusWithSize(result.status(), 0);
+    }
+    size += result.value().size();
+  }
+
+  const size_t whole_groups = size / kGroupSizeChars * kGroupSizeChars;
+  partial_size_ = size - whole_groups;
+  std::memcpy(partial_.data(), &chars[whole_groups], partial_size_);
+
+  if (padded_ || !pw_Base64IsValid(chars.data(), whole_groups) ||
+      !PaddingIsValid(chars.data(), whole_groups)) {
+    return StatusWithSize::DataLoss();
+  }
+  padded_ = chars[whole_groups - 1] == '=';
+
+  // Decode in place, then copy out what fits.
+  const size_t decoded =
+      pw_Base64Decode(chars.data(), whole_groups, chars.data());
+  const size_t size_to_copy = std::min(decoded, dest.size());
+  std::memcpy(dest.data(), chars.data(), size_to_copy);
+  pending_size_ = decoded - size_to_copy;
+  std::memcpy(pending_.data(), &chars[size_to_copy], pending_size_);
+  return StatusWithSize(size_to_copy);
+}
+
+size_t Decoder::ConservativeLimit(LimitType type) const {
+  if (type != LimitType::kRead) {
+    return 0;
+  }
+  const size_t limit = reader_.ConservativeReadLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return (limit + partial_size_) / kGroupSizeChars * kGroupSizeBytes +
+         pending_size_;
+}
+
+}  // namespace pw::base64
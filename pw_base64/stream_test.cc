@@ -0,0 +1,165 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_base64/stream.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_base64/base64.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr std::string_view kMessage =
+    "Base64 streams encode and decode data without staging it all in memory.";
+
+ConstByteSpan MessageBytes() { return std::as_bytes(std::span(kMessage)); }
+
+std::string_view AsString(ConstByteSpan bytes) {
+  return std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                          bytes.size());
+}
+
+// Returns at most one byte per read, to split groups across reads.
+class OneByteReader : public stream::NonSeekableReader {
+ public:
+  OneByteReader(ConstByteSpan data) : data_(data) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override {
+    if (data_.empty()) {
+      return StatusWithSize::OutOfRange();
+    }
+    dest[0] = data_[0];
+    data_ = data_.subspan(1);
+    return StatusWithSize(1);
+  }
+
+  ConstByteSpan data_;
+};
+
+class Base64Stream : public ::testing::Test {
+ protected:
+  Base64Stream() {
+    Encode(MessageBytes(), expected_);
+    expected_size_ = EncodedSize(kMessage.size());
+  }
+
+  std::string_view expected() const {
+    return std::string_view(expected_, expected_size_);
+  }
+
+  char expected_[EncodedSize(kMessage.size())] = {};
+  size_t expected_size_ = 0;
+};
+
+TEST_F(Base64Stream, Encoder_WritesInPieces) {
+  for (size_t piece_size = 1; piece_size <= kMessage.size(); ++piece_size) {
+    stream::MemoryWriterBuffer<128> output;
+    Encoder encoder(output);
+
+    for (ConstByteSpan data = MessageBytes(); !data.empty();) {
+      const size_t size = std::min(piece_size, data.size());
+      ASSERT_EQ(OkStatus(), encoder.Write(data.first(size)));
+      data = data.subspan(size);
+    }
+    EXPECT_EQ(kMessage.size() % 3, encoder.pending_bytes());
+    ASSERT_EQ(OkStatus(), encoder.Finish());
+    EXPECT_EQ(0u, encoder.pending_bytes());
+    EXPECT_EQ(expected(), AsString(output.WrittenData()));
+  }
+}
+
+TEST_F(Base64Stream, Encoder_StartsNewStringAfterFinish) {
+  stream::MemoryWriterBuffer<16> output;
+  Encoder encoder(output);
+
+  ASSERT_EQ(OkStatus(), encoder.Write(std::as_bytes(std::span("hi", 2))));
+  ASSERT_EQ(OkStatus(), encoder.Finish());
+  ASSERT_EQ(OkStatus(), encoder.Write(std::as_bytes(std::span("hi", 2))));
+  ASSERT_EQ(OkStatus(), encoder.Finish());
+  EXPECT_EQ("aGk=aGk=", AsString(output.WrittenData()));
+}
+
+TEST_F(Base64Stream, Encoder_WriterFull) {
+  stream::MemoryWriterBuffer<8> output;
+  Encoder encoder(output);
+
+  EXPECT_EQ(6u, encoder.ConservativeWriteLimit());
+  EXPECT_EQ(Status::ResourceExhausted(), encoder.Write(MessageBytes()));
+}
+
+TEST_F(Base64Stream, Decoder_ReadsInPieces) {
+  for (size_t piece_size = 1; piece_size <= kMessage.size(); ++piece_size) {
+    stream::MemoryReader input(std::as_bytes(std::span(expected())));
+    Decoder decoder(input);
+
+    std::array<std::byte, 128> output;
+    size_t size = 0;
+    while (true) {
+      Result<ByteSpan> result =
+          decoder.Read(std::span(output).subspan(size, piece_size));
+      if (!result.ok()) {
+        EXPECT_EQ(Status::OutOfRange(), result.status());
+        break;
+      }
+      size += result.value().size();
+    }
+    EXPECT_EQ(kMessage, AsString(std::span(output).first(size)));
+  }
+}
+
+TEST_F(Base64Stream, Decoder_GroupsSplitAcrossReads) {
+  OneByteReader input(std::as_bytes(std::span(expected())));
+  Decoder decoder(input);
+
+  std::array<std::byte, 128> output;
+  size_t size = 0;
+  for (Result<ByteSpan> result = decoder.Read(output); result.ok();
+       result = decoder.Read(std::span(output).subspan(size))) {
+    size += result.value().size();
+  }
+  EXPECT_EQ(kMessage, AsString(std::span(output).first(size)));
+}
+
+TEST_F(Base64Stream, Decoder_UrlSafe) {
+  constexpr std::string_view kUrlSafe = "-f__WW8h";
+  stream::MemoryReader input(std::as_bytes(std::span(kUrlSafe)));
+  Decoder decoder(input);
+
+  std::array<std::byte, 8> output;
+  Result<ByteSpan> result = decoder.Read(output);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ("\xf9\xff\xffYo!", AsString(result.value()));
+}
+
+TEST_F(Base64Stream, Decoder_InvalidInput) {
+  std::array<std::byte, 16> output;
+  for (std::string_view invalid : {"aGk=aGk=", "aG=k", "aGk*", "aGk"}) {
+    stream::MemoryReader input(std::as_bytes(std::span(invalid)));
+    Decoder decoder(input);
+    Status status;
+    do {
+      status = decoder.Read(std::span(output).first(1)).status();
+    } while (status.ok());
+    EXPECT_EQ(Status::DataLoss(), status);
+  }
+}
+
+}  // namespace
+}  // namespace pw::base64
@@ -0,0 +1,231 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Generates a useful bloaty config file containing new data sources."""
+"""Joins symbol sizes with sampled program counters.
+
+Reads the symbols from an ELF file and a list of sampled program counter (PC)
+values, such as from a DWT/ITM PC sampler or `perf script -F ip` on a host, and
+reports how much flash and how many samples each function accounts for. This
+shows which functions dominate both size and CPU time, and which hot paths could
+be worth trading size for speed.
+
+The samples file contains one hexadecimal PC per line, optionally followed by a
+sample count. Blank lines and lines starting with # are ignored.
+
+    python -m pw_bloat.symbol_profile firmware.elf samples.txt
+"""
+
+import argparse
+import bisect
+import csv
+from dataclasses import dataclass
+import logging
+import sys
+from typing import BinaryIO, Dict, Iterable, List, Optional, TextIO, Tuple
+
+import pw_cli.argument_types
+from elftools.elf import elffile  # type: ignore
+
+_LOG = logging.getLogger('pw_bloat')
+
+# Samples that do not fall within any symbol are attributed to this name.
+UNKNOWN_SYMBOL = '(unknown)'
+
+
+@dataclass(frozen=True)
+class Symbol:
+    name: str
+    address: int
+    size: int
+
+    def contains(self, address: int) -> bool:
+        return self.address <= address < self.address + self.size
+
+
+@dataclass(frozen=True)
+class SymbolProfile:
+    """The size and sampled CPU usage of a symbol."""
+    name: str
+    size: int
+    samples: int
+    size_fraction: float
+    sample_fraction: float
+
+
+def read_symbols(elf: BinaryIO) -> List[Symbol]:
+    """Reads the sized function and object symbols from an ELF file."""
+    parsed_elf = elffile.ELFFile(elf)
+    symtab = parsed_elf.get_section_by_name('.symtab')
+    if symtab is None:
+        raise ValueError('The ELF file has no symbol table')
+
+    # On ARM, bit 0 of a function's address marks Thumb code.
+    thumb = parsed_elf['e_machine'] == 'EM_ARM'
+
+    symbols = []
+    for symbol in symtab.iter_symbols():
+        symbol_type = symbol['st_info']['type']
+        if symbol_type not in ('STT_FUNC', 'STT_OBJECT'):
+            continue
+        if symbol['st_size'] == 0 or not symbol.name:
+            continue
+
+        address = symbol['st_value']
+        if thumb and symbol_type == 'STT_FUNC':
+            address &= ~1
+
+        symbols.append(Symbol(symbol.name, address, symbol['st_size']))
+
+    return symbols
+
+
+def parse_samples(lines: Iterable[str]) -> Dict[int, int]:
+    """Parses PC samples into a dict of address to sample count."""
+    samples: Dict[int, int] = {}
+
+    for line_number, line in enumerate(lines, 1):
+        fields = line.split()
+        if not fields or fields[0].startswith('#'):
+            continue
+
+        try:
+            address = int(fields[0], 16)
+            count = int(fields[1]) if len(fields) > 1 else 1
+        except ValueError:
+            raise ValueError(
+                f'Invalid sample on line {line_number}: {line.strip()!r}'
+            ) from None
+
+        samples[address] = samples.get(address, 0) + count
+
+    return samples
+
+
+def _find_symbol(symbols: List[Symbol], starts: List[int],
+                 address: int) -> Optional[Symbol]:
+    index = bisect.bisect_right(starts, address) - 1
+
+    # Symbols may overlap (e.g. aliases), so check the preceding few.
+    for symbol in reversed(symbols[max(index - 3, 0):index + 1]):
+        if symbol.contains(address):
+            return symbol
+
+    return None
+
+
+def attribute(symbols: Iterable[Symbol],
+              samples: Dict[int, int]) -> List[SymbolProfile]:
+    """Attributes samples to symbols.
+
+    Returns profiles for every symbol with samples, plus UNKNOWN_SYMBOL for
+    samples outside any symbol, sorted by descending sample count.
+    """
+    sorted_symbols = sorted(symbols, key=lambda symbol: symbol.address)
+    starts = [symbol.address for symbol in sorted_symbols]
+
+    total_size = sum(symbol.size for symbol in sorted_symbols)
+    total_samples = sum(samples.values())
+
+    counts: Dict[Tuple[str, int], int] = {}
+    for address, count in samples.items():
+        symbol = _find_symbol(sorted_symbols, starts, address)
+        key = (symbol.name, symbol.size) if symbol else (UNKNOWN_SYMBOL, 0)
+        counts[key] = counts.get(key, 0) + count
+
+    profiles = [
+        SymbolProfile(name, size, count,
+                      size / total_size if total_size else 0.0,
+                      count / total_samples if total_samples else 0.0)
+        for (name, size), count in counts.items()
+    ]
+    profiles.sort(key=lambda profile: (-profile.samples, profile.name))
+    return profiles
+
+
+def write_table(profiles: Iterable[SymbolProfile], output: TextIO) -> None:
+    """Writes a human-readable table of symbol profiles."""
+    output.write(f'{"CPU":>7} {"Samples":>9} {"Flash":>7} {"Size":>8}  '
+                 'Symbol\n')
+    for profile in profiles:
+        output.write(f'{profile.sample_fraction:>7.2%} {profile.samples:>9} '
+                     f'{profile.size_fraction:>7.2%} {profile.size:>8}  '
+                     f'{profile.name}\n')
+
+
+def write_csv(profiles: Iterable[SymbolProfile], output: TextIO) -> None:
+    """Writes symbol profiles as CSV."""
+    writer = csv.writer(output)
+    writer.writerow(
+        ['symbol', 'size', 'samples', 'size_fraction', 'sample_fraction'])
+    for profile in profiles:
+        writer.writerow([
+            profile.name, profile.size, profile.samples,
+            f'{profile.size_fraction:.6f}', f'{profile.sample_fraction:.6f}'
+        ])
+
+
+def _parse_args() -> argparse.Namespace:
+    """Parses the script's arguments."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf_file',
+                        type=argparse.FileType('rb'),
+                        help='ELF file with a symbol table')
+    parser.add_argument('samples',
+                        type=argparse.FileType('r'),
+                        help='File of sampled PCs, one hex address per line')
+    parser.add_argument('-n',
+                        '--limit',
+                        type=int,
+                        default=0,
+                        help='Only report the N symbols with the most samples')
+    parser.add_argument('--csv',
+                        action='store_true',
+                        help='Write CSV instead of a table')
+    parser.add_argument('-o',
+                        '--output',
+                        type=argparse.FileType('w'),
+                        default=sys.stdout,
+                        help='Output file, default stdout')
+    parser.add_argument('-l',
+                        '--loglevel',
+                        type=pw_cli.argument_types.log_level,
+                        default=logging.INFO,
+                        help='Set the log level')
+    return parser.parse_args()
+
+
+def main() -> int:
+    """Reports the size and sampled CPU usage of each symbol."""
+    args = _parse_args()
+
+    logging.basicConfig(format='%(message)s', level=args.loglevel)
+
+    symbols = read_symbols(args.elf_file)
+    samples = parse_samples(args.samples)
+    _LOG.debug('Attributing %d samples to %d symbols', sum(samples.values()),
+               len(symbols))
+
+    profiles = attribute(symbols, samples)
+    if args.limit > 0:
+        profiles = profiles[:args.limit]
+
+    if args.csv:
+        write_csv(profiles, args.output)
+    else:
+        write_table(profiles, args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
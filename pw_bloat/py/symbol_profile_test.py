@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for joining symbol sizes with PC samples."""
+
+import io
+import unittest
+
+from pw_bloat import symbol_profile
+from pw_bloat.symbol_profile import Symbol, SymbolProfile
+
+_SYMBOLS = (
+    Symbol('main', 0x1000, 0x100),
+    Symbol('Crc32', 0x1100, 0x300),
+    Symbol('kTable', 0x2000, 0x400),
+)
+
+
+class ParseSamplesTest(unittest.TestCase):
+    """Tests parsing PC sample files."""
+    def test_addresses_and_counts(self) -> None:
+        samples = symbol_profile.parse_samples([
+            '# Comment\n',
+            '0x1004\n',
+            '1104 5\n',
+            '\n',
+            '0x1004\n',
+        ])
+        self.assertEqual(samples, {0x1004: 2, 0x1104: 5})
+
+    def test_invalid_line(self) -> None:
+        with self.assertRaises(ValueError):
+            symbol_profile.parse_samples(['0x1004 many\n'])
+
+
+class AttributeTest(unittest.TestCase):
+    """Tests attributing samples to symbols."""
+    def test_sorted_by_samples(self) -> None:
+        profiles = symbol_profile.attribute(_SYMBOLS, {
+            0x1000: 1,
+            0x10ff: 1,
+            0x1100: 6,
+            0x13ff: 2,
+        })
+        self.assertEqual(profiles, [
+            SymbolProfile('Crc32', 0x300, 8, 0x300 / 0x800, 0.8),
+            SymbolProfile('main', 0x100, 2, 0x100 / 0x800, 0.2),
+        ])
+
+    def test_unknown_addresses(self) -> None:
+        profiles = symbol_profile.attribute(_SYMBOLS, {0x1400: 1, 0x1104: 1})
+        self.assertEqual([(p.name, p.samples) for p in profiles],
+                         [('(unknown)', 1), ('Crc32', 1)])
+
+    def test_no_samples(self) -> None:
+        self.assertEqual(symbol_profile.attribute(_SYMBOLS, {}), [])
+
+    def test_csv(self) -> None:
+        output = io.StringIO()
+        symbol_profile.write_csv(
+            symbol_profile.attribute(_SYMBOLS, {0x2000: 1}), output)
+        self.assertEqual(
+            output.getvalue().splitlines(), [
+                'symbol,size,samples,size_fraction,sample_fraction',
+                'kTable,1024,1,0.500000,1.000000',
+            ])
+
+
+if __name__ == '__main__':
+    unittest.main()
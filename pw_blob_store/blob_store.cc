@@ -68,12 +68,39 @@ Status BlobStore::Init() {
 }
 
 Status BlobStore::LoadMetadata() {
+  metadata_generation_ += 1;
   write_address_ = 0;
   flash_address_ = 0;
   file_name_length_ = 0;
   valid_data_ = false;
 
   BlobMetadataHeader metadata;
+  if (!ReadMetadata(metadata).ok()) {
+    return Status::NotFound();
+  }
+
+  if (HasVerifiedMarker(metadata.v1_metadata)) {
+    PW_LOG_DEBUG("BlobStore init - Trusting previously verified blob");
+  } else if (!ValidateChecksum(metadata.v1_metadata.data_size_bytes,
+                               metadata.v1_metadata.checksum)
+                  .ok()) {
+    PW_LOG_ERROR("BlobStore init - Invalidating blob with invalid checksum");
+    Invalidate().IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return Status::DataLoss();
+  } else if (!WriteVerifiedMarker(metadata.v1_metadata).ok()) {
+    // The blob is still valid; the next Init() validates it again.
+    PW_LOG_WARN("BlobStore init - Failed to store verified marker");
+  }
+
+  write_address_ = metadata.v1_metadata.data_size_bytes;
+  flash_address_ = metadata.v1_metadata.data_size_bytes;
+  file_name_length_ = metadata.file_name_length;
+  valid_data_ = true;
+
+  return OkStatus();
+}
+
+Status BlobStore::ReadMetadata(BlobMetadataHeader& metadata) {
   metadata.reset();
 
   // For kVersion1 metadata versions, only the first member of
@@ -85,21 +112,64 @@ Status BlobStore::LoadMetadata() {
       !sws.ok() && !sws.IsResourceExhausted()) {
     return Status::NotFound();
   }
+  return OkStatus();
+}
 
-  if (!ValidateChecksum(metadata.v1_metadata.data_size_bytes,
-                        metadata.v1_metadata.checksum)
-           .ok()) {
-    PW_LOG_ERROR("BlobStore init - Invalidating blob with invalid checksum");
-    Invalidate().IgnoreError();  // TODO(pwbug/387): Handle Status properly
-    return Status::DataLoss();
+Status BlobStore::EnableVerifiedMarker(std::string_view marker_key,
+                                       uint32_t flash_generation) {
+  if (initialized_) {
+    return Status::FailedPrecondition();
   }
+  verified_marker_key_ = marker_key;
+  flash_generation_ = flash_generation;
+  return OkStatus();
+}
 
-  write_address_ = metadata.v1_metadata.data_size_bytes;
-  flash_address_ = metadata.v1_metadata.data_size_bytes;
-  file_name_length_ = metadata.file_name_length;
-  valid_data_ = true;
+bool BlobStore::HasVerifiedMarker(const internal::BlobMetadataV1& metadata) {
+  if (verified_marker_key_.empty()) {
+    return false;
+  }
 
-  return OkStatus();
+  internal::VerifiedMarker marker;
+  const StatusWithSize sws = kvs_.acquire()->Get(
+      verified_marker_key_, std::as_writable_bytes(std::span(&marker, 1)));
+  return sws.ok() && sws.size() == sizeof(marker) &&
+         marker.flash_generation == flash_generation_ &&
+         marker.v1_metadata.checksum == metadata.checksum &&
+         marker.v1_metadata.data_size_bytes == metadata.data_size_bytes;
+}
+
+Status BlobStore::WriteVerifiedMarker(
+    const internal::BlobMetadataV1& metadata) {
+  if (verified_marker_key_.empty()) {
+    return OkStatus();
+  }
+
+  const internal::VerifiedMarker marker = {
+      .v1_metadata = metadata,
+      .flash_generation = flash_generation_,
+  };
+  return kvs_.acquire()->Put(verified_marker_key_,
+                             std::as_bytes(std::span(&marker, 1)));
+}
+
+Status BlobStore::Verify() {
+  if (!initialized_ || writer_open_ || readers_open_ != 0) {
+    return Status::FailedPrecondition();
+  }
+  if (!HasData()) {
+    return Status::NotFound();
+  }
+
+  BlobMetadataHeader metadata;
+  PW_TRY(ReadMetadata(metadata));
+
+  if (!ValidateChecksum(flash_address_, metadata.v1_metadata.checksum).ok()) {
+    PW_LOG_ERROR("BlobStore verify - Invalidating blob with invalid checksum");
+    Invalidate().IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return Status::DataLoss();
+  }
+  return WriteVerifiedMarker(metadata.v1_metadata);
 }
 
 size_t BlobStore::MaxDataSizeBytes() const { return partition_.size_bytes(); }
@@ -372,6 +442,16 @@ Status BlobStore::CommitToFlash(ConstByteSpan source, size_t data_bytes) {
   }
 
   flash_erased_ = false;
+
+  if (background_eraser_ != nullptr) {
+    const Status erase_status =
+        EraseAheadTo(flash_address_ + source.size_bytes());
+    if (!erase_status.ok()) {
+      valid_data_ = false;
+      return erase_status;
+    }
+  }
+
   StatusWithSize result = partition_.Write(flash_address_, source);
   flash_address_ += data_bytes;
   if (checksum_algo_ != nullptr) {
@@ -456,7 +536,19 @@ Status BlobStore::Erase() {
     Invalidate().IgnoreError();  // TODO(pwbug/387): Handle Status properly
   }
 
-  PW_TRY(partition_.Erase());
+  // A failed background erase doesn't matter here, since the sectors are
+  // erased again below.
+  FinishBackgroundErase().IgnoreError();
+
+  if (background_eraser_ != nullptr) {
+    // Erase only the first sector now. Later sectors are erased in the
+    // background as the blob is written.
+    erased_address_ = 0;
+    PW_TRY(EraseAheadTo(partition_.sector_size_bytes()));
+  } else {
+    PW_TRY(partition_.Erase());
+    erased_address_ = partition_.size_bytes();
+  }
 
   flash_erased_ = true;
 
@@ -466,18 +558,83 @@ Status BlobStore::Erase() {
   return OkStatus();
 }
 
+Status BlobStore::EnableEraseAhead(BackgroundEraser& eraser) {
+  if (writer_open_) {
+    return Status::FailedPrecondition();
+  }
+  background_eraser_ = &eraser;
+  return OkStatus();
+}
+
+Status BlobStore::EraseAheadTo(kvs::FlashPartition::Address end_address) {
+  while (erased_address_ < end_address) {
+    if (erase_pending_) {
+      PW_TRY(FinishBackgroundErase());
+    } else {
+      PW_TRY(partition_.Erase(erased_address_, 1));
+      erased_address_ += partition_.sector_size_bytes();
+    }
+  }
+
+  // Keep the next sector erasing while this one is written.
+  if (!erase_pending_ && erased_address_ < partition_.size_bytes()) {
+    erase_pending_ =
+        background_eraser_->StartErase(partition_, erased_address_, 1).ok();
+  }
+  return OkStatus();
+}
+
+Status BlobStore::FlashEraser::StartErase(kvs::FlashPartition& partition,
+                                         kvs::FlashPartition::Address address,
+                                         size_t num_sectors) {
+  if (erase_.has_value() && erase_->in_progress()) {
+    return Status::FailedPrecondition();
+  }
+  erase_.emplace(partition);
+  return erase_->StartErase(address, num_sectors);
+}
+
+Status BlobStore::FlashEraser::WaitForErase() {
+  if (!erase_.has_value()) {
+    return Status::FailedPrecondition();
+  }
+  return erase_->Finish().status();
+}
+
+Status BlobStore::FinishBackgroundErase() {
+  if (!erase_pending_) {
+    return OkStatus();
+  }
+  erase_pending_ = false;
+  PW_TRY(background_eraser_->WaitForErase());
+  erased_address_ += partition_.sector_size_bytes();
+  return OkStatus();
+}
+
 Status BlobStore::Invalidate() {
   // Blob data is considered valid if the flash is erased. Even though
   // there are 0 bytes written, they are valid.
+  metadata_generation_ += 1;
   valid_data_ = flash_erased_;
   ResetChecksum();
   write_address_ = 0;
   flash_address_ = 0;
   file_name_length_ = 0;
 
-  Status status = kvs_.acquire()->Delete(MetadataKey());
+  Status status = OkStatus();
+  if (!verified_marker_key_.empty()) {
+    status = kvs_.acquire()->Delete(verified_marker_key_);
+    if (status.IsNotFound()) {
+      status = OkStatus();
+    }
+  }
 
-  return (status.ok() || status.IsNotFound()) ? OkStatus() : Status::Internal();
+  Status metadata_status = kvs_.acquire()->Delete(MetadataKey());
+  if (!metadata_status.IsNotFound()) {
+    status.Update(metadata_status);
+  }
+
+  return status.ok() ? OkStatus() : Status::Internal();
 }
 
 Status BlobStore::ValidateChecksum(size_t blob_size_bytes,
@@ -518,6 +675,13 @@ Status BlobStore::CalculateChecksumFromFlash(size_t bytes_to_check) {
   kvs::FlashPartition::Address address = 0;
   const kvs::FlashPartition::Address end = bytes_to_check;
 
+  // Checksum memory-mapped flash in place.
+  if (const std::byte* mapped = partition_.MappedAddress(0, bytes_to_check);
+      mapped != nullptr) {
+    checksum_algo_->Update(mapped, bytes_to_check);
+    address = end;
+  }
+
   constexpr size_t kReadBufferSizeBytes = 32;
   std::array<std::byte, kReadBufferSizeBytes> buffer;
   while (address < end) {
@@ -619,8 +783,19 @@ Status BlobStore::BlobWriter::WriteMetadata() {
   PW_DCHECK(metadata_buffer_.size_bytes() >= bytes_to_write);
 
   // Do final commit to KVS.
-  return store_.kvs_.acquire()->Put(store_.MetadataKey(),
-                                    metadata_buffer_.first(bytes_to_write));
+  PW_TRY(store_.kvs_.acquire()->Put(store_.MetadataKey(),
+                                    metadata_buffer_.first(bytes_to_write)));
+
+  // The checksum was just validated against flash. If the marker can't be
+  // stored, the next Init() validates the blob again.
+  const internal::BlobMetadataV1 verified_metadata = {
+      .checksum = calculated_checksum,
+      .data_size_bytes = static_cast<uint32_t>(store_.flash_address_),
+  };
+  if (!store_.WriteVerifiedMarker(verified_metadata).ok()) {
+    PW_LOG_WARN("Blob writer close - Failed to store verified marker");
+  }
+  return OkStatus();
 }
 
 Status BlobStore::BlobWriter::Close() {
@@ -672,6 +847,7 @@ Status BlobStore::BlobWriter::Close() {
 
   const Status status = do_close_write();
   store_.writer_open_ = false;
+  store_.metadata_generation_ += 1;
 
   if (!status.ok()) {
     store_.valid_data_ = false;
@@ -723,6 +899,29 @@ Status BlobStore::BlobReader::DoSeek(ptrdiff_t offset, Whence origin) {
   return OkStatus();
 }
 
+Result<ConstByteSpan> BlobStore::BlobReader::ReadOrMap(ByteSpan buffer) {
+  if (!open_) {
+    return Status::FailedPrecondition();
+  }
+  if (offset_ >= store_.ReadableDataBytes()) {
+    return Status::OutOfRange();
+  }
+
+  if (Result<ConstByteSpan> blob = store_.GetMemoryMappedBlob(); blob.ok()) {
+    const ConstByteSpan remaining = blob.value().subspan(offset_);
+    offset_ += remaining.size_bytes();
+    return remaining;
+  }
+
+  if (buffer.empty()) {
+    return Status::InvalidArgument();
+  }
+  const StatusWithSize result = store_.Read(offset_, buffer);
+  PW_TRY(result.status());
+  offset_ += result.size();
+  return ConstByteSpan(buffer.first(result.size()));
+}
+
 StatusWithSize BlobStore::BlobReader::DoRead(ByteSpan dest) {
   if (!open_) {
     return StatusWithSize::FailedPrecondition();
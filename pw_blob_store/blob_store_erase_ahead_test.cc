@@ -0,0 +1,217 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::blob_store {
+namespace {
+
+// Defers each erase until it is waited for, so that tests can check which
+// sectors are erased ahead of the writes.
+class DeferredEraser : public BlobStore::BackgroundEraser {
+ public:
+  Status StartErase(kvs::FlashPartition& partition,
+                    kvs::FlashPartition::Address address,
+                    size_t num_sectors) override {
+    EXPECT_EQ(partition_, nullptr);
+    if (!start_status.ok()) {
+      return start_status;
+    }
+    partition_ = &partition;
+    address_ = address;
+    num_sectors_ = num_sectors;
+    last_address = address;
+    start_count += 1;
+    return OkStatus();
+  }
+
+  Status WaitForErase() override {
+    EXPECT_NE(partition_, nullptr);
+    Status status = partition_->Erase(address_, num_sectors_);
+    partition_ = nullptr;
+    return status;
+  }
+
+  bool pending() const { return partition_ != nullptr; }
+
+  Status start_status;
+  size_t start_count = 0;
+  kvs::FlashPartition::Address last_address = 0;
+
+ private:
+  kvs::FlashPartition* partition_ = nullptr;
+  kvs::FlashPartition::Address address_ = 0;
+  size_t num_sectors_ = 0;
+};
+
+class EraseAheadTest : public ::testing::Test {
+ protected:
+  EraseAheadTest() : flash_(kFlashAlignment), partition_(&flash_) {}
+
+  void SetUp() override {
+    // Start from programmed flash, so that writes fail unless BlobStore erases
+    // each sector before writing it.
+    random::XorShiftStarRng64 rng(0x1234);
+    ASSERT_EQ(OkStatus(), rng.Get(flash_.buffer()).status());
+    ASSERT_EQ(OkStatus(), rng.Get(source_buffer_).status());
+  }
+
+  bool SectorErased(size_t sector) {
+    bool erased = false;
+    EXPECT_EQ(OkStatus(),
+              partition_.IsRegionErased(
+                  sector * kSectorSize, kSectorSize, &erased));
+    return erased;
+  }
+
+  void WriteAndVerify(BlobStore& blob) {
+    BlobStore::BlobWriter writer(blob, metadata_buffer_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+
+    ConstByteSpan source = source_buffer_;
+    while (!source.empty()) {
+      const size_t write_size = std::min(source.size_bytes(), kWriteSize);
+      ASSERT_EQ(OkStatus(), writer.Write(source.first(write_size)));
+      source = source.subspan(write_size);
+    }
+    ASSERT_EQ(OkStatus(), writer.Close());
+
+    BlobStore::BlobReader reader(blob);
+    ASSERT_EQ(OkStatus(), reader.Open());
+    Result<ConstByteSpan> result = reader.GetMemoryMappedBlob();
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(source_buffer_.size(), result.value().size_bytes());
+    EXPECT_EQ(0,
+              std::memcmp(source_buffer_.data(),
+                          result.value().data(),
+                          source_buffer_.size()));
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
+  static constexpr size_t kFlashAlignment = 16;
+  static constexpr size_t kSectorSize = 1024;
+  static constexpr size_t kSectorCount = 4;
+  static constexpr size_t kBufferSize = 256;
+  static constexpr size_t kWriteSize = 100;
+  static constexpr size_t kMetadataBufferSize =
+      BlobStore::BlobWriter::RequiredMetadataBufferSize(0);
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  DeferredEraser eraser_;
+  std::array<std::byte, kMetadataBufferSize> metadata_buffer_;
+  std::array<std::byte, kSectorSize * kSectorCount> source_buffer_;
+};
+
+TEST_F(EraseAheadTest, EraseOnlyErasesFirstSector) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "EraseFirst", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser_));
+
+  BlobStore::BlobWriter writer(blob, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Erase());
+
+  EXPECT_TRUE(SectorErased(0));
+  EXPECT_FALSE(SectorErased(1));
+  ASSERT_TRUE(eraser_.pending());
+  EXPECT_EQ(kSectorSize, eraser_.last_address);
+  EXPECT_EQ(OkStatus(), writer.Close());
+}
+
+TEST_F(EraseAheadTest, WritesEraseAhead) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "EraseAhead", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser_));
+
+  WriteAndVerify(blob);
+
+  // Every sector after the first was erased in the background.
+  EXPECT_EQ(kSectorCount - 1, eraser_.start_count);
+  EXPECT_EQ((kSectorCount - 1) * kSectorSize, eraser_.last_address);
+  EXPECT_FALSE(eraser_.pending());
+}
+
+TEST_F(EraseAheadTest, RewriteErasesAgain) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "Rewrite", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser_));
+
+  WriteAndVerify(blob);
+  WriteAndVerify(blob);
+  EXPECT_EQ(2 * (kSectorCount - 1), eraser_.start_count);
+}
+
+TEST_F(EraseAheadTest, FallsBackToSynchronousErase) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "Fallback", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser_));
+
+  eraser_.start_status = Status::ResourceExhausted();
+  WriteAndVerify(blob);
+  EXPECT_EQ(0u, eraser_.start_count);
+}
+
+TEST_F(EraseAheadTest, FlashEraser_ErasesAsynchronously) {
+  flash_.set_async_operations(true);
+  BlobStore::FlashEraser eraser;
+  BlobStoreBuffer<kBufferSize> blob(
+      "FlashAsync", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser));
+
+  WriteAndVerify(blob);
+  EXPECT_EQ(kSectorCount - 1, flash_.async_operations_started());
+}
+
+TEST_F(EraseAheadTest, FlashEraser_SynchronousFlash) {
+  BlobStore::FlashEraser eraser;
+  BlobStoreBuffer<kBufferSize> blob(
+      "FlashSync", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+  ASSERT_EQ(OkStatus(), blob.EnableEraseAhead(eraser));
+
+  WriteAndVerify(blob);
+  EXPECT_EQ(0u, flash_.async_operations_started());
+}
+
+TEST_F(EraseAheadTest, EnableWithWriterOpenFails) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "EnableOpen", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  EXPECT_EQ(Status::FailedPrecondition(), blob.EnableEraseAhead(eraser_));
+  EXPECT_EQ(OkStatus(), writer.Close());
+}
+
+}  // namespace
+}  // namespace pw::blob_store
@@ -850,5 +850,164 @@ TEST_F(BlobStoreTest, MultipleWrites) {
   WriteTestBlock();
 }
 
+TEST_F(BlobStoreTest, VerifiedMarkerSkipsInitValidation) {
+  constexpr size_t kBufferSize = 256;
+  constexpr char kMarkerKey[] = "TestBlobVerified";
+  kvs::ChecksumCrc16 checksum;
+
+  InitSourceBufferToRandom(0x5150);
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 1));
+    ASSERT_EQ(OkStatus(), blob.Init());
+    EXPECT_EQ(Status::FailedPrecondition(),
+              blob.EnableVerifiedMarker(kMarkerKey, 1));
+
+    BlobStore::BlobWriterWithBuffer writer(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  // Corrupt the blob without BlobStore knowing. Init() trusts the marker, but
+  // Verify() still catches it.
+  flash_.buffer()[10] ^= std::byte{0xff};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 1));
+  ASSERT_EQ(OkStatus(), blob.Init());
+  EXPECT_TRUE(blob.HasData());
+
+  EXPECT_EQ(Status::DataLoss(), blob.Verify());
+  EXPECT_FALSE(blob.HasData());
+  EXPECT_EQ(Status::NotFound(), blob.Verify());
+}
+
+TEST_F(BlobStoreTest, VerifiedMarkerStoredByInit) {
+  constexpr size_t kBufferSize = 256;
+  constexpr char kMarkerKey[] = "TestBlobVerified";
+  kvs::ChecksumCrc16 checksum;
+
+  // Write without the marker, so that the first Init() with it validates the
+  // blob.
+  InitSourceBufferToRandom(0x7007);
+  WriteTestBlock();
+
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 3));
+    ASSERT_EQ(OkStatus(), blob.Init());
+    EXPECT_TRUE(blob.HasData());
+    EXPECT_EQ(OkStatus(), blob.Verify());
+  }
+
+  flash_.buffer()[10] ^= std::byte{0xff};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 3));
+  ASSERT_EQ(OkStatus(), blob.Init());
+  EXPECT_TRUE(blob.HasData());
+}
+
+TEST_F(BlobStoreTest, VerifiedMarkerGenerationChangeValidates) {
+  constexpr size_t kBufferSize = 256;
+  constexpr char kMarkerKey[] = "TestBlobVerified";
+  kvs::ChecksumCrc16 checksum;
+
+  InitSourceBufferToRandom(0x600d);
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 1));
+    ASSERT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriterWithBuffer writer(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  flash_.buffer()[10] ^= std::byte{0xff};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.EnableVerifiedMarker(kMarkerKey, 2));
+  ASSERT_EQ(OkStatus(), blob.Init());
+  EXPECT_FALSE(blob.HasData());
+}
+
+TEST_F(BlobStoreTest, ReadOrMapMemoryMapped) {
+  InitSourceBufferToRandom(0x4242);
+  WriteTestBlock();
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open(100));
+
+  // The remaining blob is returned in one span that points into flash.
+  std::array<std::byte, 8> buffer;
+  Result<ConstByteSpan> chunk = reader.ReadOrMap(buffer);
+  ASSERT_EQ(OkStatus(), chunk.status());
+  EXPECT_EQ(flash_.buffer().data() + 100, chunk.value().data());
+  EXPECT_EQ(kBlobDataSize - 100, chunk.value().size_bytes());
+  VerifyFlash(chunk.value(), 100);
+
+  EXPECT_EQ(Status::OutOfRange(), reader.ReadOrMap(buffer).status());
+  EXPECT_EQ(OkStatus(), reader.Close());
+  EXPECT_EQ(Status::FailedPrecondition(), reader.ReadOrMap(buffer).status());
+}
+
+TEST_F(BlobStoreTest, ReadOrMapFallsBackToRead) {
+  // Flash that can't be accessed through the MCU's address space.
+  class UnmappedFlash
+      : public kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> {
+   public:
+    UnmappedFlash() : FakeFlashMemoryBuffer(kFlashAlignment) {}
+
+    std::byte* FlashAddressToMcuAddress(Address) const override {
+      return nullptr;
+    }
+  };
+
+  InitSourceBufferToRandom(0x2424);
+
+  UnmappedFlash flash;
+  kvs::FlashPartition partition(&flash);
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  BlobStoreBuffer<kBufferSize> blob(
+      "UnmappedBlob", partition, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_EQ(Status::InvalidArgument(), reader.ReadOrMap(ByteSpan()).status());
+
+  std::array<std::byte, 300> buffer;
+  size_t offset = 0;
+  for (Result<ConstByteSpan> chunk = reader.ReadOrMap(buffer); chunk.ok();
+       chunk = reader.ReadOrMap(buffer)) {
+    EXPECT_EQ(buffer.data(), chunk.value().data());
+    VerifyFlash(chunk.value(), offset);
+    offset += chunk.value().size_bytes();
+  }
+  EXPECT_EQ(kBlobDataSize, offset);
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
 }  // namespace
 }  // namespace pw::blob_store
@@ -14,7 +14,9 @@
 
 #include "pw_blob_store/flat_file_system_entry.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <mutex>
 #include <span>
 
@@ -23,9 +25,33 @@
 #include "pw_file/flat_file_system.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
 #include "pw_sync/virtual_basic_lockable.h"
 
 namespace pw::blob_store {
+namespace {
+
+// Maps a BlobReader::Open() error to the status the FlatFileSystemService
+// expects from an entry.
+Status ConvertOpenStatus(Status status) {
+  switch (status.code()) {
+    case OkStatus().code():
+      return OkStatus();
+    // When a BlobStore is empty, Open() reports FAILED_PRECONDITION. The
+    // FlatFileSystemService expects NOT_FOUND when a file is not present at
+    // the entry.
+    case Status::FailedPrecondition().code():
+      return Status::NotFound();
+    case Status::InvalidArgument().code():
+      return Status::OutOfRange();
+    case Status::Unavailable().code():
+      return Status::Unavailable();
+    default:
+      return Status::Internal();
+  }
+}
+
+}  // namespace
 
 Status FlatFileSystemBlobStoreEntry::Init() {
   std::lock_guard lock(blob_store_lock_);
@@ -51,34 +77,79 @@ void FlatFileSystemBlobStoreEntry::EnsureInitialized() {
   PW_DCHECK_OK(status);
 }
 
+Status FlatFileSystemBlobStoreEntry::UpdateCachedMetadata() {
+  const uint32_t generation = blob_store_.metadata_generation();
+  if (generation == cached_generation_) {
+    return OkStatus();
+  }
+
+  BlobStore::BlobReader reader(blob_store_);
+  const Status open_status = ConvertOpenStatus(reader.Open());
+  if (open_status.IsNotFound()) {
+    cached_name_status_ = Status::NotFound();
+    cached_name_size_ = 0;
+    cached_size_bytes_ = 0;
+    cached_generation_ = generation;
+    return OkStatus();
+  }
+  PW_TRY(open_status);
+
+  const StatusWithSize name = reader.GetFileName(cached_name_);
+  cached_name_status_ = name.status();
+  cached_name_size_ = name.size();
+  cached_size_bytes_ = reader.ConservativeReadLimit();
+
+  // A name that is too long to cache is read when requested. Other errors are
+  // not cached, so the next access retries.
+  if (CachedNameIsComplete() || cached_name_status_.IsResourceExhausted()) {
+    cached_generation_ = generation;
+  }
+  return OkStatus();
+}
+
 StatusWithSize FlatFileSystemBlobStoreEntry::Name(std::span<char> dest) {
   EnsureInitialized();
   std::lock_guard lock(blob_store_lock_);
-  BlobStore::BlobReader reader(blob_store_);
-  if (const Status status = reader.Open(); !status.ok()) {
-    // When a BlobStore is empty, Open() reports FAILED_PRECONDITION. The
-    // FlatFileSystemService expects NOT_FOUND when a file is not present at the
-    // entry.
-    switch (status.code()) {
-      case Status::FailedPrecondition().code():
-        return StatusWithSize(Status::NotFound(), 0);
-      case Status::Unavailable().code():
-        return StatusWithSize(Status::Unavailable(), 0);
-      default:
-        return StatusWithSize(Status::Internal(), 0);
-    }
+  PW_TRY_WITH_SIZE(UpdateCachedMetadata());
+
+  if (!CachedNameIsComplete()) {
+    BlobStore::BlobReader reader(blob_store_);
+    PW_TRY_WITH_SIZE(ConvertOpenStatus(reader.Open()));
+    return reader.GetFileName(dest);
   }
-  return reader.GetFileName(dest);
+  if (!cached_name_status_.ok()) {
+    return StatusWithSize(cached_name_status_, 0);
+  }
+
+  const size_t bytes_to_copy = std::min(dest.size(), cached_name_size_);
+  std::memcpy(dest.data(), cached_name_.data(), bytes_to_copy);
+  if (bytes_to_copy != cached_name_size_) {
+    return StatusWithSize::ResourceExhausted(bytes_to_copy);
+  }
+  return StatusWithSize(bytes_to_copy);
 }
 
 size_t FlatFileSystemBlobStoreEntry::SizeBytes() {
   EnsureInitialized();
   std::lock_guard lock(blob_store_lock_);
-  BlobStore::BlobReader reader(blob_store_);
-  if (!reader.Open().ok()) {
+  if (!UpdateCachedMetadata().ok()) {
     return 0;
   }
-  return reader.ConservativeReadLimit();
+  return cached_size_bytes_;
+}
+
+StatusWithSize FlatFileSystemBlobStoreEntry::Read(size_t offset,
+                                                  ByteSpan dest) {
+  EnsureInitialized();
+  std::lock_guard lock(blob_store_lock_);
+  BlobStore::BlobReader reader(blob_store_);
+  PW_TRY_WITH_SIZE(ConvertOpenStatus(reader.Open(offset)));
+
+  const Result<ByteSpan> result = reader.Read(dest);
+  if (!result.ok()) {
+    return StatusWithSize(result.status(), 0);
+  }
+  return StatusWithSize(result.value().size());
 }
 
 // TODO(pwbug/488): This file can be deleted even though it is read-only.
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstring>
 #include <span>
+#include <string_view>
 
 #include "gtest/gtest.h"
 #include "pw_blob_store/blob_store.h"
@@ -165,5 +166,102 @@ TEST_F(FlatFileSystemBlobStoreEntryTest, NoData) {
   EXPECT_EQ(0u, sws.size());
 }
 
+TEST_F(FlatFileSystemBlobStoreEntryTest, CachedMetadataUpdatesAfterWrite) {
+  constexpr uint32_t kExpectedFileId = 0x2;
+  constexpr FlatFileSystemBlobStoreEntry::FilePermissions kExpectedPermissions =
+      FlatFileSystemBlobStoreEntry::FilePermissions::READ;
+
+  InitSourceBufferToRandom(0x8A3B0F21);
+  WriteTestBlock("first.bin", 104);
+
+  sync::VirtualMutex blob_store_mutex;
+  FlatFileSystemBlobStoreEntry blob_store_file(
+      kExpectedFileId, kExpectedPermissions, blob_, blob_store_mutex);
+
+  std::array<char, kMaxFileNameLength> tmp_buffer = {};
+  StatusWithSize sws = blob_store_file.Name(tmp_buffer);
+  ASSERT_EQ(OkStatus(), sws.status());
+  EXPECT_EQ("first.bin", std::string_view(tmp_buffer.data(), sws.size()));
+  EXPECT_EQ(104u, blob_store_file.SizeBytes());
+
+  WriteTestBlock("second_file.bin", 520);
+
+  sws = blob_store_file.Name(tmp_buffer);
+  ASSERT_EQ(OkStatus(), sws.status());
+  EXPECT_EQ("second_file.bin",
+            std::string_view(tmp_buffer.data(), sws.size()));
+  EXPECT_EQ(520u, blob_store_file.SizeBytes());
+
+  ASSERT_EQ(OkStatus(), blob_store_file.Delete());
+  EXPECT_EQ(Status::NotFound(), blob_store_file.Name(tmp_buffer).status());
+  EXPECT_EQ(0u, blob_store_file.SizeBytes());
+}
+
+TEST_F(FlatFileSystemBlobStoreEntryTest, NameLargerThanBuffer) {
+  constexpr uint32_t kExpectedFileId = 0x3;
+  constexpr FlatFileSystemBlobStoreEntry::FilePermissions kExpectedPermissions =
+      FlatFileSystemBlobStoreEntry::FilePermissions::READ;
+
+  InitSourceBufferToRandom(0x11C0FFEE);
+  WriteTestBlock("my_file_1.bin", 104);
+
+  sync::VirtualMutex blob_store_mutex;
+  FlatFileSystemBlobStoreEntry blob_store_file(
+      kExpectedFileId, kExpectedPermissions, blob_, blob_store_mutex);
+
+  std::array<char, 4> tmp_buffer = {};
+  StatusWithSize sws = blob_store_file.Name(tmp_buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), sws.status());
+  EXPECT_EQ(tmp_buffer.size(), sws.size());
+  EXPECT_EQ("my_f", std::string_view(tmp_buffer.data(), tmp_buffer.size()));
+}
+
+TEST_F(FlatFileSystemBlobStoreEntryTest, ReadAtOffset) {
+  constexpr size_t kWrittenDataSizeBytes = 300;
+  constexpr uint32_t kExpectedFileId = 0x4;
+  constexpr FlatFileSystemBlobStoreEntry::FilePermissions kExpectedPermissions =
+      FlatFileSystemBlobStoreEntry::FilePermissions::READ;
+
+  InitSourceBufferToRandom(0x6E2D4A07);
+  WriteTestBlock("my_file_1.bin", kWrittenDataSizeBytes);
+
+  sync::VirtualMutex blob_store_mutex;
+  FlatFileSystemBlobStoreEntry blob_store_file(
+      kExpectedFileId, kExpectedPermissions, blob_, blob_store_mutex);
+
+  std::array<std::byte, 64> read_buffer = {};
+  StatusWithSize sws = blob_store_file.Read(100, read_buffer);
+  ASSERT_EQ(OkStatus(), sws.status());
+  ASSERT_EQ(read_buffer.size(), sws.size());
+  EXPECT_EQ(0,
+            std::memcmp(read_buffer.data(),
+                        source_buffer_.data() + 100,
+                        read_buffer.size()));
+
+  // Reads that reach the end of the file are truncated.
+  sws = blob_store_file.Read(kWrittenDataSizeBytes - 10, read_buffer);
+  ASSERT_EQ(OkStatus(), sws.status());
+  ASSERT_EQ(10u, sws.size());
+  EXPECT_EQ(0,
+            std::memcmp(read_buffer.data(),
+                        source_buffer_.data() + kWrittenDataSizeBytes - 10,
+                        10));
+
+  EXPECT_EQ(Status::OutOfRange(),
+            blob_store_file.Read(kWrittenDataSizeBytes, read_buffer).status());
+}
+
+TEST_F(FlatFileSystemBlobStoreEntryTest, ReadNoData) {
+  sync::VirtualMutex blob_store_mutex;
+  FlatFileSystemBlobStoreEntry blob_store_file(
+      0x5,
+      FlatFileSystemBlobStoreEntry::FilePermissions::READ,
+      blob_,
+      blob_store_mutex);
+
+  std::array<std::byte, 16> read_buffer = {};
+  EXPECT_EQ(Status::NotFound(), blob_store_file.Read(0, read_buffer).status());
+}
+
 }  // namespace
 }  // namespace pw::blob_store
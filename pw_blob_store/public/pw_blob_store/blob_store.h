@@ -14,6 +14,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <span>
 
 #include "pw_assert/assert.h"
@@ -21,6 +23,7 @@
 #include "pw_bytes/span.h"
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
+#include "pw_kvs/flash_operation.h"
 #include "pw_kvs/key_value_store.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
@@ -55,6 +58,43 @@ namespace pw::blob_store {
 //  3) BlobReader::Close().
 class BlobStore {
  public:
+  // Erases flash sectors in the background, for erase-ahead writes. See
+  // EnableEraseAhead().
+  class BackgroundEraser {
+   public:
+    virtual ~BackgroundEraser() = default;
+
+    // Starts erasing num_sectors sectors of partition at address, without
+    // waiting for the erase to finish. BlobStore has at most one erase
+    // outstanding. Returns an error if the erase could not be started, in which
+    // case BlobStore erases the sectors itself when it needs them.
+    virtual Status StartErase(kvs::FlashPartition& partition,
+                              kvs::FlashPartition::Address address,
+                              size_t num_sectors) = 0;
+
+    // Blocks until the erase begun by the last StartErase() finishes, and
+    // returns its result.
+    virtual Status WaitForErase() = 0;
+  };
+
+  // Erases with the flash's own asynchronous erase (FlashPartition::
+  // StartErase), so writes overlap with erases without a separate thread. On
+  // flash without asynchronous erases, each sector is erased when its erase is
+  // started.
+  class FlashEraser final : public BackgroundEraser {
+   public:
+    constexpr FlashEraser() = default;
+
+    Status StartErase(kvs::FlashPartition& partition,
+                      kvs::FlashPartition::Address address,
+                      size_t num_sectors) override;
+
+    Status WaitForErase() override;
+
+   private:
+    std::optional<kvs::FlashOperation> erase_;
+  };
+
   // Implement the stream::Writer and erase interface for a BlobStore. If not
   // already erased, the Write will do any needed erase.
   //
@@ -316,6 +356,28 @@ class BlobStore {
                    : Status::FailedPrecondition();
     }
 
+    // Returns the next bytes of the blob from the reader's position, and
+    // advances the reader past them. If the blob is memory mapped, returns all
+    // remaining bytes directly from flash without copying. Otherwise, reads up
+    // to buffer.size_bytes() bytes into buffer and returns them. This lets
+    // code that checks or decompresses a blob avoid copies where possible,
+    // while still working on any flash:
+    //
+    //   for (Result<ConstByteSpan> chunk = reader.ReadOrMap(buffer);
+    //        chunk.ok();
+    //        chunk = reader.ReadOrMap(buffer)) {
+    //     Process(chunk.value());
+    //   }
+    //
+    // Returns:
+    //
+    //   OK with span - The next bytes of the blob.
+    //   OUT_OF_RANGE - The whole blob has been read.
+    //   INVALID_ARGUMENT - The blob is not memory mapped and buffer is empty.
+    //   FAILED_PRECONDITION - Reader not open.
+    //
+    Result<ConstByteSpan> ReadOrMap(ByteSpan buffer);
+
    private:
     // Probable (not guaranteed) minimum number of bytes at this time that can
     // be read. Returns zero if, in the current state, Read would return status
@@ -363,9 +425,14 @@ class BlobStore {
         flash_erased_(false),
         writer_open_(false),
         readers_open_(0),
+        erase_pending_(false),
         write_address_(0),
         flash_address_(0),
-        file_name_length_(0) {}
+        erased_address_(0),
+        file_name_length_(0),
+        background_eraser_(nullptr),
+        flash_generation_(0),
+        metadata_generation_(0) {}
 
   BlobStore(const BlobStore&) = delete;
   BlobStore& operator=(const BlobStore&) = delete;
@@ -390,9 +457,62 @@ class BlobStore {
   // false -  Blob is either invalid or does not have any data bytes
   bool HasData() const { return (valid_data_ && ReadableDataBytes() > 0); }
 
+  // Returns a counter that changes whenever the blob's data, size, or file name
+  // may have changed: when the blob is loaded, invalidated, or a writer is
+  // opened or closed. Callers that cache blob metadata can compare this to the
+  // value when they cached it, rather than re-reading the metadata.
+  uint32_t metadata_generation() const { return metadata_generation_; }
+
+  // Enables erase-ahead writes. Instead of erasing the whole partition before
+  // the first write, BlobStore erases only the first sector and has eraser
+  // erase each following sector in the background while the previous one is
+  // being written. This bounds write throughput by flash program speed rather
+  // than erase plus program. eraser must outlive the BlobStore. Returns:
+  //
+  // OK - success.
+  // FAILED_PRECONDITION - A writer is open.
+  Status EnableEraseAhead(BackgroundEraser& eraser);
+
+  // Lets Init() skip reading the whole blob from flash to validate its
+  // checksum.
+  //
+  // Whenever a blob's checksum is validated against flash, BlobStore stores a
+  // marker under marker_key in the KVS recording the blob's metadata and
+  // flash_generation. Init() trusts a blob whose marker matches its metadata
+  // and the flash_generation given here. BlobStore can't detect writes to the
+  // partition made by anything else, such as a bootloader, so the user should
+  // change flash_generation whenever that may have happened to force a full
+  // validation. Verify() does a full validation on demand.
+  //
+  // marker_key must not be used for anything else in the KVS, and must outlive
+  // the BlobStore. Returns:
+  //
+  // OK - success.
+  // FAILED_PRECONDITION - Init() was already called.
+  Status EnableVerifiedMarker(std::string_view marker_key,
+                              uint32_t flash_generation);
+
+  // Reads the whole blob from flash and validates its checksum, even if it was
+  // trusted by Init(). Invalidates the blob if validation fails. Returns:
+  //
+  // OK - the blob is valid.
+  // DATA_LOSS - the checksum didn't match; the blob was invalidated.
+  // NOT_FOUND - there is no blob to verify.
+  // FAILED_PRECONDITION - Not initialized, or a reader or writer is open.
+  Status Verify();
+
  private:
   Status LoadMetadata();
 
+  Status ReadMetadata(internal::BlobMetadataHeader& metadata);
+
+  // Whether the verified marker matches the given metadata. Always false if
+  // the marker is not enabled.
+  bool HasVerifiedMarker(const internal::BlobMetadataV1& metadata);
+
+  // Stores the verified marker for the given metadata, if it is enabled.
+  Status WriteVerifiedMarker(const internal::BlobMetadataV1& metadata);
+
   // Open to do a blob write. Returns:
   //
   // OK - success.
@@ -517,6 +637,13 @@ class BlobStore {
 
   Status Erase();
 
+  // Erase-ahead writes: makes sure flash is erased up to end_address, then
+  // starts erasing the following sector in the background.
+  Status EraseAheadTo(kvs::FlashPartition::Address end_address);
+
+  // Waits for any outstanding background erase to finish.
+  Status FinishBackgroundErase();
+
   Status Invalidate();
 
   void ResetChecksum() {
@@ -577,6 +704,9 @@ class BlobStore {
   // Count of open BlobReader instances
   size_t readers_open_;
 
+  // A background erase of the sector at erased_address_ is in progress.
+  bool erase_pending_;
+
   // Current index for end of overall blob data. Represents current byte size of
   // blob data since the FlashPartition starts at address 0.
   kvs::FlashPartition::Address write_address_;
@@ -585,8 +715,25 @@ class BlobStore {
   // bytes is write_address_ - flash_address_.
   kvs::FlashPartition::Address flash_address_;
 
+  // With erase-ahead writes, flash is erased from the start of the partition
+  // up to this address.
+  kvs::FlashPartition::Address erased_address_;
+
   // Length of the stored blob's filename.
   size_t file_name_length_;
+
+  // Eraser for erase-ahead writes, or nullptr to erase the whole partition
+  // before writing.
+  BackgroundEraser* background_eraser_;
+
+  // KVS key of the verified marker, or empty if the marker is not enabled.
+  std::string_view verified_marker_key_;
+
+  // Flash generation recorded in the verified marker.
+  uint32_t flash_generation_;
+
+  // Incremented whenever the blob's readable data or metadata may change.
+  uint32_t metadata_generation_;
 };
 
 // Creates a BlobStore with the buffer of kBufferSizeBytes.
@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <span>
 
 #include "pw_blob_store/blob_store.h"
@@ -32,6 +34,10 @@ class FlatFileSystemBlobStoreEntry final
   using file::FlatFileSystemService::Entry::FilePermissions;
   using file::FlatFileSystemService::Entry::Id;
 
+  // File names up to this length are cached along with the file's size. Longer
+  // names are read from the BlobStore each time they are requested.
+  static constexpr size_t kMaxCachedFileNameLength = 32;
+
   // File IDs must be globally unique, and map to a pw_transfer TransferService
   // read/write handler ID.
   //
@@ -44,6 +50,10 @@ class FlatFileSystemBlobStoreEntry final
       : file_id_(file_id),
         permissions_(permissions),
         initialized_(false),
+        cached_generation_(0),
+        cached_name_{},
+        cached_name_size_(0),
+        cached_size_bytes_(0),
         blob_store_(blob_store),
         blob_store_lock_(blob_store_lock) {}
 
@@ -51,10 +61,15 @@ class FlatFileSystemBlobStoreEntry final
   // as this class will also lazy-init
   Status Init();
 
+  // The file's name and size are cached until the BlobStore is written,
+  // erased, or invalidated, so listing files doesn't read flash every time.
   StatusWithSize Name(std::span<char> dest) final;
 
   size_t SizeBytes() final;
 
+  // Reads the blob starting at `offset` without reading the bytes before it.
+  StatusWithSize Read(size_t offset, ByteSpan dest) final;
+
   FilePermissions Permissions() const final { return permissions_; }
 
   Status Delete() final;
@@ -66,9 +81,30 @@ class FlatFileSystemBlobStoreEntry final
   // to ensure it succeeded.
   void EnsureInitialized();
 
+  // Opens a reader to re-read the file's name and size if the BlobStore's
+  // metadata changed since they were cached. Returns NOT_FOUND if the
+  // BlobStore has no data, or the reader's Open() error otherwise.
+  Status UpdateCachedMetadata() PW_EXCLUSIVE_LOCKS_REQUIRED(blob_store_lock_);
+
+  // Returns true if the cached name is the full file name.
+  bool CachedNameIsComplete() const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(blob_store_lock_) {
+    return cached_name_status_.ok() || cached_name_status_.IsNotFound();
+  }
+
   const Id file_id_;
   const FilePermissions permissions_;
   bool initialized_ PW_GUARDED_BY(blob_store_lock_);
+
+  // BlobStore::metadata_generation() when the name and size were cached, or 0
+  // if they have not been cached.
+  uint32_t cached_generation_ PW_GUARDED_BY(blob_store_lock_);
+  Status cached_name_status_ PW_GUARDED_BY(blob_store_lock_);
+  std::array<char, kMaxCachedFileNameLength> cached_name_
+      PW_GUARDED_BY(blob_store_lock_);
+  size_t cached_name_size_ PW_GUARDED_BY(blob_store_lock_);
+  size_t cached_size_bytes_ PW_GUARDED_BY(blob_store_lock_);
+
   blob_store::BlobStore& blob_store_ PW_GUARDED_BY(blob_store_lock_);
   sync::VirtualBasicLockable& blob_store_lock_;
 };
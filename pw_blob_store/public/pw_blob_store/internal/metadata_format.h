@@ -66,6 +66,17 @@ PW_PACKED(struct) BlobMetadataHeaderV2 {
   }
 };
 
+// Records that a blob was verified against the data in flash, so that Init()
+// can skip reading the whole blob to validate it. Stored under its own KVS key,
+// separate from the metadata entry.
+PW_PACKED(struct) VerifiedMarker {
+  // Copy of the metadata of the blob that was verified.
+  BlobMetadataV1 v1_metadata;
+
+  // Flash generation provided by the user when the blob was verified.
+  uint32_t flash_generation;
+};
+
 using BlobMetadataHeader = BlobMetadataHeaderV2;
 using ChecksumValue = BlobMetadataV1::ChecksumValue;
 
@@ -0,0 +1,72 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstddef>
+
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::blob_store {
+
+// Erases BlobStore sectors on a work queue's thread, for erase-ahead writes.
+//
+//   WorkQueueEraser eraser(work_queue);
+//   blob_store.EnableEraseAhead(eraser);
+//
+// A WorkQueueEraser may only be used by one BlobStore.
+class WorkQueueEraser final : public BlobStore::BackgroundEraser {
+ public:
+  explicit WorkQueueEraser(work_queue::WorkQueue& work_queue)
+      : work_queue_(work_queue),
+        partition_(nullptr),
+        address_(0),
+        num_sectors_(0) {}
+
+  WorkQueueEraser(const WorkQueueEraser&) = delete;
+  WorkQueueEraser& operator=(const WorkQueueEraser&) = delete;
+
+  Status StartErase(kvs::FlashPartition& partition,
+                    kvs::FlashPartition::Address address,
+                    size_t num_sectors) override {
+    partition_ = &partition;
+    address_ = address;
+    num_sectors_ = num_sectors;
+    // Only capture this, so that the work item fits in the inline storage of
+    // pw::Function.
+    return work_queue_.PushWork([this] {
+      status_ = partition_->Erase(address_, num_sectors_);
+      erase_done_.release();
+    });
+  }
+
+  Status WaitForErase() override {
+    erase_done_.acquire();
+    return status_;
+  }
+
+ private:
+  work_queue::WorkQueue& work_queue_;
+  sync::ThreadNotification erase_done_;
+  kvs::FlashPartition* partition_;
+  kvs::FlashPartition::Address address_;
+  size_t num_sectors_;
+  Status status_;
+};
+
+}  // namespace pw::blob_store
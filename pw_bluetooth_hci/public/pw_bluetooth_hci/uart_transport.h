@@ -13,7 +13,9 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <bit>
+#include <cstddef>
 
 #include "pw_bluetooth_hci/packet.h"
 #include "pw_bytes/span.h"
@@ -60,4 +62,64 @@ using DecodedPacketCallback = Function<void(const Packet& packet)>;
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback);
 
+// Decodes HCI packets from a stream of HCI UART Transport Layer data, such as
+// the chunks received from a UART DMA transfer.
+//
+// Packets that are complete within a chunk are decoded in place and passed to
+// the callback without copying. Only a packet that is split across chunks is
+// copied into the decoder's buffer, where it is reassembled from the following
+// chunks. The buffer must be large enough to hold the largest expected packet,
+// including its packet indicator byte.
+class HciUartDecoder {
+ public:
+  constexpr HciUartDecoder(ByteSpan buffer)
+      : buffer_(buffer), buffered_bytes_(0) {}
+
+  HciUartDecoder(const HciUartDecoder&) = delete;
+  HciUartDecoder& operator=(const HciUartDecoder&) = delete;
+
+  // Decodes all complete packets in the data, in order, and buffers any
+  // trailing partial packet. The callback is invoked for each packet.
+  //
+  // Returns the number of bytes of data processed and a status based on:
+  // OK - All of the data was processed.
+  // DATA_LOSS - An invalid packet indicator was detected between packets.
+  //             The size includes the invalid byte. Data after it was not
+  //             processed, so the caller may resume from there once it has
+  //             regained synchronization.
+  // RESOURCE_EXHAUSTED - A partial packet was too large for the buffer, so it
+  //                      was discarded along with all of the data.
+  //                      Synchronization has been lost.
+  StatusWithSize Process(ConstByteSpan data,
+                         const DecodedPacketCallback& packet_callback);
+
+  // Discards any buffered partial packet.
+  void Clear() { buffered_bytes_ = 0; }
+
+  // The number of bytes of a partial packet that are currently buffered.
+  size_t buffered_bytes() const { return buffered_bytes_; }
+
+ private:
+  // Completes the buffered packet with bytes from the start of data. Returns
+  // the number of bytes of data used.
+  StatusWithSize ProcessBufferedPacket(
+      ConstByteSpan data, const DecodedPacketCallback& packet_callback);
+
+  // Copies a partial packet into the buffer.
+  Status BufferPartialPacket(ConstByteSpan data);
+
+  ByteSpan buffer_;
+  size_t buffered_bytes_;
+};
+
+// An HciUartDecoder with an internal buffer for reassembling packets.
+template <size_t kSizeBytes>
+class HciUartDecoderBuffer : public HciUartDecoder {
+ public:
+  HciUartDecoderBuffer() : HciUartDecoder(buffer_) {}
+
+ private:
+  std::array<std::byte, kSizeBytes> buffer_;
+};
+
 }  // namespace pw::bluetooth_hci
@@ -13,86 +13,140 @@
 // the License.
 #include "pw_bluetooth_hci/uart_transport.h"
 
+#include <algorithm>
+#include <optional>
+
 namespace pw::bluetooth_hci {
+namespace {
+
+// Invokes the callback if the packet was decoded. Returns the size of the
+// packet including its packet indicator, or 0 if it is incomplete.
+template <typename PacketType>
+size_t HandlePacket(const std::optional<PacketType>& maybe_packet,
+                    const DecodedPacketCallback& packet_callback) {
+  if (!maybe_packet.has_value()) {
+    return 0;  // Not enough data to complete this packet.
+  }
+
+  packet_callback(maybe_packet.value());
+  return 1 + maybe_packet.value().size_bytes();
+}
+
+// Decodes the packet at the start of the data, which must not be empty.
+//
+// Returns the number of bytes consumed and a status based on:
+// OK - The size is that of the packet and its indicator, or 0 if the packet is
+//      incomplete.
+// DATA_LOSS - The packet indicator is invalid. Only it was consumed.
+StatusWithSize DecodePacket(ConstByteSpan data,
+                            const DecodedPacketCallback& packet_callback) {
+  const ConstByteSpan packet = data.subspan(1);  // Skip the packet indicator.
+
+  switch (data[0]) {
+    case kUartCommandPacketIndicator:
+      return StatusWithSize(HandlePacket(
+          CommandPacket::Decode(packet, std::endian::little), packet_callback));
+    case kUartAsyncDataPacketIndicator:
+      return StatusWithSize(
+          HandlePacket(AsyncDataPacket::Decode(packet, std::endian::little),
+                       packet_callback));
+    case kUartSyncDataPacketIndicator:
+      return StatusWithSize(
+          HandlePacket(SyncDataPacket::Decode(packet, std::endian::little),
+                       packet_callback));
+    case kUartEventPacketIndicator:
+      return StatusWithSize(
+          HandlePacket(EventPacket::Decode(packet), packet_callback));
+    default:
+      // Unrecognized PacketIndicator type, we've lost synchronization!
+      return StatusWithSize::DataLoss(1);
+  }
+}
+
+}  // namespace
 
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback) {
   size_t bytes_consumed = 0;
-  while (data.size_bytes() > 0) {
-    const std::byte packet_indicator = data[0];
-    data = data.subspan(1);  // Pop off the packet indicator byte.
-    // Note that we do not yet claim the byte consumed until we know what it is,
-    // as it may be a partial HCI packet which cannot be consumed until later.
-
-    size_t packet_size_bytes = 0;
-    switch (packet_indicator) {
-      case kUartCommandPacketIndicator: {
-        const std::optional<CommandPacket> maybe_packet =
-            CommandPacket::Decode(data, std::endian::little);
-        if (!maybe_packet.has_value()) {
-          return StatusWithSize(
-              bytes_consumed);  // Not enough data to complete this packet.
-        }
-
-        const CommandPacket& packet = maybe_packet.value();
-        packet_callback(packet);
-        packet_size_bytes = packet.size_bytes();
-        break;
-      }
-
-      case kUartAsyncDataPacketIndicator: {
-        const std::optional<AsyncDataPacket> maybe_packet =
-            AsyncDataPacket::Decode(data, std::endian::little);
-        if (!maybe_packet.has_value()) {
-          return StatusWithSize(
-              bytes_consumed);  // Not enough data to complete this packet.
-        }
-
-        const AsyncDataPacket& packet = maybe_packet.value();
-        packet_callback(packet);
-        packet_size_bytes = packet.size_bytes();
-        break;
-      }
-
-      case kUartSyncDataPacketIndicator: {
-        const std::optional<SyncDataPacket> maybe_packet =
-            SyncDataPacket::Decode(data, std::endian::little);
-        if (!maybe_packet.has_value()) {
-          return StatusWithSize(
-              bytes_consumed);  // Not enough data to complete this packet.
-        }
-
-        const SyncDataPacket& packet = maybe_packet.value();
-        packet_callback(packet);
-        packet_size_bytes = packet.size_bytes();
-        break;
-      }
-
-      case kUartEventPacketIndicator: {
-        const std::optional<EventPacket> maybe_packet =
-            EventPacket::Decode(data);
-        if (!maybe_packet.has_value()) {
-          return StatusWithSize(
-              bytes_consumed);  // Not enough data to complete this packet.
-        }
-
-        const EventPacket& packet = maybe_packet.value();
-        packet_callback(packet);
-        packet_size_bytes = packet.size_bytes();
-        break;
-      }
-
-      default:
-        // Unrecognized PacketIndicator type, we've lost synchronization!
-        ++bytes_consumed;  // Consume the invalid packet indicator.
-        return StatusWithSize::DataLoss(bytes_consumed);
-    }
+  while (bytes_consumed < data.size_bytes()) {
+    const StatusWithSize result =
+        DecodePacket(data.subspan(bytes_consumed), packet_callback);
+    bytes_consumed += result.size();
 
-    data = data.subspan(packet_size_bytes);  // Pop off the HCI packet.
-    // Consume the packet indicator and the packet.
-    bytes_consumed += 1 + packet_size_bytes;
+    if (!result.ok()) {
+      return StatusWithSize::DataLoss(bytes_consumed);
+    }
+    if (result.size() == 0u) {
+      break;  // The rest of the data is a partial packet.
+    }
   }
   return StatusWithSize(bytes_consumed);
 }
 
+StatusWithSize HciUartDecoder::Process(
+    ConstByteSpan data, const DecodedPacketCallback& packet_callback) {
+  size_t bytes_processed = 0;
+
+  if (buffered_bytes_ != 0u) {
+    const StatusWithSize result = ProcessBufferedPacket(data, packet_callback);
+    if (!result.ok() || buffered_bytes_ != 0u) {
+      return result;
+    }
+    bytes_processed = result.size();
+  }
+
+  // Decode the complete packets in place.
+  const StatusWithSize result =
+      DecodeHciUartData(data.subspan(bytes_processed), packet_callback);
+  bytes_processed += result.size();
+  if (!result.ok()) {
+    return StatusWithSize::DataLoss(bytes_processed);
+  }
+
+  return StatusWithSize(BufferPartialPacket(data.subspan(bytes_processed)),
+                        data.size_bytes());
+}
+
+StatusWithSize HciUartDecoder::ProcessBufferedPacket(
+    ConstByteSpan data, const DecodedPacketCallback& packet_callback) {
+  // Copy as much as fits, since the packet's size is not known until its
+  // header is complete. Bytes past the end of the packet are decoded in place
+  // afterwards.
+  const size_t previously_buffered = buffered_bytes_;
+  const size_t bytes_to_copy = std::min(
+      data.size_bytes(), buffer_.size_bytes() - previously_buffered);
+  std::copy(data.begin(),
+            data.begin() + bytes_to_copy,
+            buffer_.begin() + previously_buffered);
+
+  // The buffered packet indicator was validated before it was buffered, so
+  // this only reports whether the packet is complete.
+  const StatusWithSize result = DecodePacket(
+      buffer_.first(previously_buffered + bytes_to_copy), packet_callback);
+
+  if (result.size() != 0u) {
+    Clear();
+    return StatusWithSize(result.size() - previously_buffered);
+  }
+
+  if (previously_buffered + bytes_to_copy == buffer_.size_bytes()) {
+    Clear();
+    return StatusWithSize::ResourceExhausted(data.size_bytes());
+  }
+
+  buffered_bytes_ += bytes_to_copy;
+  return StatusWithSize(bytes_to_copy);
+}
+
+Status HciUartDecoder::BufferPartialPacket(ConstByteSpan data) {
+  if (data.size_bytes() > buffer_.size_bytes()) {
+    Clear();
+    return Status::ResourceExhausted();
+  }
+
+  std::copy(data.begin(), data.end(), buffer_.begin());
+  buffered_bytes_ = data.size_bytes();
+  return OkStatus();
+}
+
 }  // namespace pw::bluetooth_hci
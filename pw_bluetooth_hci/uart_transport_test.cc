@@ -16,6 +16,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_bluetooth_hci/packet.h"
+#include "pw_bytes/array.h"
 #include "pw_bytes/byte_builder.h"
 #include "pw_status/status.h"
 
@@ -405,5 +406,150 @@ TEST_F(UartTransportTest, LotsOfEventPackets) {
   EXPECT_EQ(event_packet_count, expected_packet_count);
 }
 
+class HciUartDecoderTest : public UartTransportTest {
+ protected:
+  // Appends an ACL data packet with the payload to the UART buffer.
+  void AppendAsyncDataPacket(ConstByteSpan payload) {
+    uart_buffer_.push_back(kUartAsyncDataPacketIndicator);
+    std::array<std::byte, 64> packet_buffer;
+    const Result<ConstByteSpan> result =
+        AsyncDataPacket(0x123, payload).Encode(packet_buffer);
+    ASSERT_EQ(result.status(), OkStatus());
+    uart_buffer_.append(result.value());
+    ASSERT_EQ(uart_buffer_.status(), OkStatus());
+  }
+
+  // Counts the decoded packets and checks that each has kPayload.
+  DecodedPacketCallback ExpectPayload() {
+    return [this](const Packet& packet) {
+      ASSERT_EQ(packet.type(), Packet::Type::kAsyncDataPacket);
+      const ConstByteSpan data = packet.async_data_packet().data();
+      ASSERT_EQ(data.size_bytes(), kPayload.size());
+      EXPECT_TRUE(std::equal(data.begin(), data.end(), kPayload.begin()));
+      ++packet_count_;
+    };
+  }
+
+  static void FailOnPacket(const Packet&) { FAIL(); }
+
+  static constexpr auto kPayload = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8>();
+
+  HciUartDecoderBuffer<32> decoder_;
+  size_t packet_count_ = 0;
+};
+
+TEST_F(HciUartDecoderTest, CompletePackets_DecodedInPlace) {
+  AppendAsyncDataPacket(kPayload);
+  AppendAsyncDataPacket(kPayload);
+
+  const StatusWithSize result =
+      decoder_.Process(uart_buffer_, [this](const Packet& packet) {
+        // The packet references the input rather than the decoder's buffer.
+        const ConstByteSpan data = packet.async_data_packet().data();
+        EXPECT_GE(data.data(), uart_buffer_.data());
+        EXPECT_LT(data.data(), uart_buffer_.data() + uart_buffer_.size());
+        ++packet_count_;
+      });
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), uart_buffer_.size());
+  EXPECT_EQ(packet_count_, 2u);
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+}
+
+TEST_F(HciUartDecoderTest, PacketSplitAcrossChunks_Reassembled) {
+  AppendAsyncDataPacket(kPayload);
+  AppendAsyncDataPacket(kPayload);
+  AppendAsyncDataPacket(kPayload);
+  const DecodedPacketCallback callback = ExpectPayload();
+
+  // Split the data into chunks at every possible offset.
+  for (size_t split = 0; split <= uart_buffer_.size(); ++split) {
+    packet_count_ = 0;
+    const ConstByteSpan data(uart_buffer_.data(), uart_buffer_.size());
+
+    StatusWithSize result = decoder_.Process(data.first(split), callback);
+    EXPECT_EQ(result.status(), OkStatus());
+    EXPECT_EQ(result.size(), split);
+
+    result = decoder_.Process(data.subspan(split), callback);
+    EXPECT_EQ(result.status(), OkStatus());
+    EXPECT_EQ(result.size(), data.size_bytes() - split);
+
+    EXPECT_EQ(packet_count_, 3u);
+    EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+  }
+}
+
+TEST_F(HciUartDecoderTest, OneByteAtATime) {
+  AppendAsyncDataPacket(kPayload);
+  AppendAsyncDataPacket(kPayload);
+  const DecodedPacketCallback callback = ExpectPayload();
+
+  for (std::byte b : uart_buffer_) {
+    const StatusWithSize result =
+        decoder_.Process(std::span(&b, 1), callback);
+    EXPECT_EQ(result.status(), OkStatus());
+    EXPECT_EQ(result.size(), 1u);
+  }
+  EXPECT_EQ(packet_count_, 2u);
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+}
+
+TEST_F(HciUartDecoderTest, InvalidIndicatorAfterPartialPacket) {
+  AppendAsyncDataPacket(kPayload);
+  const ConstByteSpan data(uart_buffer_.data(), uart_buffer_.size());
+
+  ASSERT_EQ(OkStatus(), decoder_.Process(data.first(3), FailOnPacket).status());
+  EXPECT_EQ(decoder_.buffered_bytes(), 3u);
+
+  // Complete the packet, then follow it with an invalid indicator.
+  std::array<std::byte, 64> rest{};
+  std::copy(data.begin() + 3, data.end(), rest.begin());
+  rest[data.size_bytes() - 3] = kInvalidPacketIndicator;
+  const StatusWithSize result = decoder_.Process(
+      std::span(rest).first(data.size_bytes() - 2), ExpectPayload());
+  EXPECT_EQ(result.status(), Status::DataLoss());
+  EXPECT_EQ(result.size(), data.size_bytes() - 2);
+  EXPECT_EQ(packet_count_, 1u);
+}
+
+TEST_F(HciUartDecoderTest, PacketLargerThanBuffer_ResourceExhausted) {
+  std::array<std::byte, 40> large_payload{};
+  AppendAsyncDataPacket(large_payload);
+  const ConstByteSpan data(uart_buffer_.data(), uart_buffer_.size());
+
+  StatusWithSize result = decoder_.Process(data.first(10), FailOnPacket);
+  EXPECT_EQ(result.status(), OkStatus());
+
+  result = decoder_.Process(data.subspan(10), FailOnPacket);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), data.size_bytes() - 10);
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+}
+
+TEST_F(HciUartDecoderTest, PartialPacketLargerThanBuffer_ResourceExhausted) {
+  std::array<std::byte, 40> large_payload{};
+  AppendAsyncDataPacket(large_payload);
+  const ConstByteSpan data(uart_buffer_.data(), uart_buffer_.size());
+
+  const StatusWithSize result =
+      decoder_.Process(data.first(data.size_bytes() - 1), FailOnPacket);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+}
+
+TEST_F(HciUartDecoderTest, Clear_DiscardsPartialPacket) {
+  AppendAsyncDataPacket(kPayload);
+  const ConstByteSpan data(uart_buffer_.data(), uart_buffer_.size());
+
+  ASSERT_EQ(OkStatus(), decoder_.Process(data.first(5), FailOnPacket).status());
+  decoder_.Clear();
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+
+  const StatusWithSize result = decoder_.Process(data, ExpectPayload());
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(packet_count_, 1u);
+}
+
 }  // namespace
 }  // namespace pw::bluetooth_hci
@@ -57,6 +57,7 @@
 
 #include "pw_boot/boot.h"
 #include "pw_boot_cortex_m/boot.h"
+#include "pw_boot_cortex_m_private/config.h"
 #include "pw_preprocessor/arch.h"
 #include "pw_preprocessor/compiler.h"
 
@@ -87,6 +88,15 @@ void __libc_init_array(void);
 // (Section 6.7.8, paragraph 10 for example, which requires uninitialized static
 // values to be zero-initialized).
 void StaticMemoryInit(void) {
+#if PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT
+  pw_boot_CopyStaticMemory(
+      &_pw_static_init_ram_start,
+      &_pw_static_init_flash_start,
+      &_pw_static_init_ram_end - &_pw_static_init_ram_start);
+
+  pw_boot_ZeroStaticMemory(&_pw_zero_init_ram_start,
+                           &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+#else
   // Static-init RAM (load static values into ram, .data section init).
   memcpy(&_pw_static_init_ram_start,
          &_pw_static_init_flash_start,
@@ -96,6 +106,9 @@ void StaticMemoryInit(void) {
   memset(&_pw_zero_init_ram_start,
          0,
          &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+#endif  // PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT
+
+  // The .noinit section is intentionally left as is.
 }
 
 // WARNING: This code is run immediately upon boot, and performs initialization
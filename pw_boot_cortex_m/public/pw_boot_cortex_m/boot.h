@@ -41,6 +41,7 @@
 // In pw_boot_Entry():
 //   Initialize memory -> pw_PreMainInit() -> main()
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "pw_preprocessor/compiler.h"
@@ -75,4 +76,24 @@ extern uint8_t pw_boot_heap_high_addr;
 // can be used to set VTOR (vector table offset register) by the bootloader.
 extern uint8_t pw_boot_vector_table_addr;
 
+// pw_boot_no_init_ram_[low/high]_addr indicate the range of the .noinit
+// section, which is neither loaded nor zeroed at boot. Large buffers that are
+// always written before they are read can be placed there with
+// PW_PLACE_IN_SECTION(".noinit") to shorten boot.
+extern uint8_t pw_boot_no_init_ram_low_addr;
+extern uint8_t pw_boot_no_init_ram_high_addr;
+
+// Static memory initialization functions (platform supplied).
+//
+// If PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT is enabled, these functions
+// are called instead of memcpy() and memset() to load .data from flash and to
+// zero .bss, for example so that a platform can use DMA. The regions are 8-byte
+// aligned and their sizes are multiples of 8 bytes. Each function must finish
+// initializing its region before it returns.
+//
+// WARNING: These run before static memory is initialized, so they must not use
+// any static or global variables.
+void pw_boot_CopyStaticMemory(void* ram, const void* flash, size_t size_bytes);
+void pw_boot_ZeroStaticMemory(void* ram, size_t size_bytes);
+
 PW_EXTERN_C_END
@@ -0,0 +1,22 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Initializes static memory with the platform's pw_boot_CopyStaticMemory() and
+// pw_boot_ZeroStaticMemory() functions instead of memcpy() and memset(). This
+// allows a platform to use DMA or a tuned copy loop for large .data and .bss
+// sections.
+#ifndef PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT
+#define PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT 0
+#endif  // PW_BOOT_CORTEX_M_PLATFORM_STATIC_MEMORY_INIT
@@ -66,12 +66,15 @@ endmacro()
 #   IMPLEMENTS_FACADE - this module implements the specified facade
 #   PUBLIC_DEPS - public target_link_libraries arguments
 #   PRIVATE_DEPS - private target_link_libraries arguments
+#   TEST_DEPS - additional dependencies for the module's tests
+#   EXCLUDE_TESTS - _test.cc files that should not get an automatic test, such
+#       as tests that need backends and are declared separately
 #
 function(pw_auto_add_simple_module MODULE)
   _pw_parse_argv_strict(pw_auto_add_simple_module 1
       ""
       "IMPLEMENTS_FACADE"
-      "PUBLIC_DEPS;PRIVATE_DEPS;TEST_DEPS"
+      "PUBLIC_DEPS;PRIVATE_DEPS;TEST_DEPS;EXCLUDE_TESTS"
   )
 
   file(GLOB all_sources *.cc *.c)
@@ -110,6 +113,8 @@ function(pw_auto_add_simple_module MODULE)
       ${arg_TEST_DEPS}
     GROUPS
       ${groups}
+    EXCLUDE
+      ${arg_EXCLUDE_TESTS}
   )
 endfunction(pw_auto_add_simple_module)
 
@@ -120,16 +125,21 @@ endfunction(pw_auto_add_simple_module)
 #
 #  PRIVATE_DEPS - dependencies to apply to all tests
 #  GROUPS - groups in addition to MODULE to which to add these tests
+#  EXCLUDE - _test.cc files for which no test should be created
 #
 function(pw_auto_add_module_tests MODULE)
   _pw_parse_argv_strict(pw_auto_add_module_tests 1
       ""
       ""
-      "PRIVATE_DEPS;GROUPS"
+      "PRIVATE_DEPS;GROUPS;EXCLUDE"
   )
 
   file(GLOB cc_tests *_test.cc)
 
+  foreach(excluded IN LISTS arg_EXCLUDE)
+    list(REMOVE_ITEM cc_tests "${CMAKE_CURRENT_SOURCE_DIR}/${excluded}")
+  endforeach()
+
   foreach(test IN LISTS cc_tests)
     get_filename_component(test_name "${test}" NAME_WE)
 
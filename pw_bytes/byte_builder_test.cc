@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 
@@ -530,6 +531,55 @@ TEST(ByteBuffer, PuttingInts_MixedTypes_MixedEndian) {
   EXPECT_EQ(OkStatus(), bb.status());
 }
 
+TEST(ByteBuffer, PuttingIntArrays_kLittleEndian) {
+  ByteBuffer<12> bb;
+  constexpr std::array<uint16_t, 2> kUint16s = {0x0102, 0xFFF7};
+  constexpr std::array<int32_t, 2> kInt32s = {0x03040506, -2};
+  bb.PutUint16s(kUint16s);
+  bb.PutInt32s(kInt32s);
+
+  constexpr auto kExpected = MakeBytes(0x02,
+                                       0x01,
+                                       0xF7,
+                                       0xFF,
+                                       0x06,
+                                       0x05,
+                                       0x04,
+                                       0x03,
+                                       0xFE,
+                                       0xFF,
+                                       0xFF,
+                                       0xFF);
+  ASSERT_EQ(kExpected.size(), bb.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), bb.data(), kExpected.size()));
+  EXPECT_EQ(OkStatus(), bb.status());
+}
+
+TEST(ByteBuffer, PuttingIntArrays_kBigEndian) {
+  ByteBuffer<16> bb;
+  constexpr std::array<int16_t, 1> kInt16s = {-2};
+  constexpr std::array<uint64_t, 1> kUint64s = {0x0102030405060708};
+  bb.PutInt16s(kInt16s, std::endian::big);
+  bb.PutUint64s(kUint64s, std::endian::big);
+
+  constexpr auto kExpected =
+      MakeBytes(0xFF, 0xFE, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08);
+  ASSERT_EQ(kExpected.size(), bb.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), bb.data(), kExpected.size()));
+  EXPECT_EQ(OkStatus(), bb.status());
+}
+
+TEST(ByteBuffer, PuttingIntArrays_Exhausted) {
+  ByteBuffer<10> bb;
+  constexpr std::array<uint32_t, 2> kUint32s = {1, 2};
+  bb.PutUint32s(kUint32s);
+  EXPECT_EQ(8u, bb.size());
+
+  bb.PutUint32s(kUint32s);
+  EXPECT_EQ(8u, bb.size());
+  EXPECT_EQ(Status::ResourceExhausted(), bb.status());
+}
+
 TEST(ByteBuffer, Iterator) {
   std::array<byte, 3> buffer = MakeBytes(0x01, 0x02, 0x03);
   ByteBuffer<8> bb;
@@ -276,5 +276,64 @@ TEST(ReadInOrder, BoundsChecking_TooSmall) {
   EXPECT_EQ(0, value);
 }
 
+TEST(ConvertOrder, Span_SameOrder_DoesNothing) {
+  std::array<uint32_t, 2> values = {0x01020304, 0x05060708};
+  ConvertOrder(kNonNative, kNonNative, std::span(values));
+  EXPECT_EQ(0x01020304u, values[0]);
+  EXPECT_EQ(0x05060708u, values[1]);
+}
+
+TEST(ConvertOrder, Span_ReversesEachValue) {
+  std::array<int16_t, 3> values = {0x0102, -2, 0};
+  ConvertOrderTo(kNonNative, std::span(values));
+  EXPECT_EQ(0x0201, values[0]);
+  EXPECT_EQ(static_cast<int16_t>(0xFEFF), values[1]);
+  EXPECT_EQ(0, values[2]);
+
+  ConvertOrderFrom(kNonNative, std::span(values));
+  EXPECT_EQ(0x0102, values[0]);
+  EXPECT_EQ(-2, values[1]);
+  EXPECT_EQ(0, values[2]);
+}
+
+TEST(CopyInOrder, Span) {
+  constexpr std::array<uint16_t, 2> kValues = {0x0102, 0x0304};
+  std::array<std::byte, 5> buffer = Array<0, 0, 0, 0, 0>();
+
+  // Copy to an unaligned address.
+  CopyInOrder(std::endian::big, std::span(kValues), &buffer[1]);
+  EXPECT_EQ(buffer, (Array<0, 1, 2, 3, 4>()));
+
+  CopyInOrder(std::endian::little, std::span(kValues), &buffer[1]);
+  EXPECT_EQ(buffer, (Array<0, 2, 1, 4, 3>()));
+}
+
+TEST(ReadInOrder, Span) {
+  constexpr auto buffer = Array<99, 1, 2, 3, 4>();
+  std::array<uint16_t, 2> values = {};
+
+  // Read from an unaligned address.
+  ReadInOrder(std::endian::big, &buffer[1], std::span(values));
+  EXPECT_EQ(0x0102, values[0]);
+  EXPECT_EQ(0x0304, values[1]);
+
+  ReadInOrder(std::endian::little, &buffer[1], std::span(values));
+  EXPECT_EQ(0x0201, values[0]);
+  EXPECT_EQ(0x0403, values[1]);
+}
+
+TEST(ReadInOrder, Span_BoundsChecking) {
+  constexpr auto buffer = Array<1, 2, 3, 4, 5>();
+  std::array<uint16_t, 2> values = {};
+  EXPECT_TRUE(ReadInOrder(
+      std::endian::big, std::span(buffer).first(4), std::span(values)));
+  EXPECT_EQ(0x0102, values[0]);
+  EXPECT_EQ(0x0304, values[1]);
+
+  std::array<uint16_t, 3> too_many = {};
+  EXPECT_FALSE(ReadInOrder(std::endian::big, buffer, std::span(too_many)));
+  EXPECT_EQ(0, too_many[0]);
+}
+
 }  // namespace
 }  // namespace pw::bytes
@@ -326,6 +326,39 @@ class ByteBuilder {
     return PutUint64(static_cast<uint64_t>(value), order);
   }
 
+  // Put methods for inserting arrays of ints. Either all of the values are
+  // inserted, or none are and the status is set to RESOURCE_EXHAUSTED. The
+  // values are converted to the requested byte order in a single pass.
+  ByteBuilder& PutUint16s(std::span<const uint16_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
+  ByteBuilder& PutInt16s(std::span<const int16_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
+  ByteBuilder& PutUint32s(std::span<const uint32_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
+  ByteBuilder& PutInt32s(std::span<const int32_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
+  ByteBuilder& PutUint64s(std::span<const uint64_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
+  ByteBuilder& PutInt64s(std::span<const int64_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteAllInOrder(values, order);
+  }
+
  protected:
   // Functions to support ByteBuffer copies.
   constexpr ByteBuilder(const ByteSpan& buffer, const ByteBuilder& other)
@@ -341,6 +374,14 @@ class ByteBuilder {
   ByteBuilder& WriteInOrder(T value) {
     return append(&value, sizeof(value));
   }
+  template <typename T>
+  ByteBuilder& WriteAllInOrder(std::span<const T> values, std::endian order) {
+    std::byte* const append_destination = buffer_.data() + size_;
+    if (ResizeForAppend(values.size_bytes()) != 0u) {
+      bytes::CopyInOrder(order, values, append_destination);
+    }
+    return *this;
+  }
   size_t ResizeForAppend(size_t bytes_to_append);
 
   const ByteSpan buffer_;
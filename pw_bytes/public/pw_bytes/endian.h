@@ -132,12 +132,60 @@ constexpr T ConvertOrderFrom(std::endian from_endianness, T value) {
   return ConvertOrder(from_endianness, std::endian::native, value);
 }
 
+// Converts each value in a span from one byte order to another, in place. The
+// values are converted in a simple loop with no per-value branches, which
+// compilers can vectorize or turn into byte reverse instructions.
+template <typename T, size_t kExtent>
+constexpr void ConvertOrder(std::endian from,
+                            std::endian to,
+                            std::span<T, kExtent> values) {
+  if (from != to) {
+    for (T& value : values) {
+      value = internal::ReverseBytes(value);
+    }
+  }
+}
+
+// Converts each value in a span from native byte order to the specified byte
+// order, in place.
+template <typename T, size_t kExtent>
+constexpr void ConvertOrderTo(std::endian to_endianness,
+                              std::span<T, kExtent> values) {
+  ConvertOrder(std::endian::native, to_endianness, values);
+}
+
+// Converts each value in a span from the specified byte order to native byte
+// order, in place.
+template <typename T, size_t kExtent>
+constexpr void ConvertOrderFrom(std::endian from_endianness,
+                                std::span<T, kExtent> values) {
+  ConvertOrder(from_endianness, std::endian::native, values);
+}
+
 // Copies the value to a std::array with the specified endianness.
 template <typename T>
 constexpr auto CopyInOrder(std::endian order, T value) {
   return internal::CopyLittleEndian(ConvertOrderTo(order, value));
 }
 
+// Copies the values to a buffer with the specified endianness. The buffer need
+// not be aligned, but **MUST** be at least values.size_bytes() bytes large.
+template <typename T, size_t kExtent>
+void CopyInOrder(std::endian order,
+                 std::span<T, kExtent> values,
+                 void* buffer) {
+  if (order == std::endian::native) {
+    std::memcpy(buffer, values.data(), values.size_bytes());
+    return;
+  }
+
+  std::byte* const output = static_cast<std::byte*>(buffer);
+  for (size_t i = 0; i < values.size(); ++i) {
+    const std::remove_cv_t<T> value = internal::ReverseBytes(values[i]);
+    std::memcpy(&output[i * sizeof(value)], &value, sizeof(value));
+  }
+}
+
 // Reads a value from a buffer with the specified endianness.
 //
 // The buffer **MUST** be at least sizeof(T) bytes large! If you are not
@@ -187,4 +235,30 @@ template <typename T>
   return true;
 }
 
+// Reads values.size() values with the specified endianness from a buffer. The
+// buffer need not be aligned, but **MUST** be at least values.size_bytes()
+// bytes large.
+template <typename T, size_t kExtent>
+void ReadInOrder(std::endian order,
+                 const void* buffer,
+                 std::span<T, kExtent> values) {
+  std::memcpy(values.data(), buffer, values.size_bytes());
+  ConvertOrderFrom(order, values);
+}
+
+// Reads values.size() values with the specified endianness from the buffer,
+// with bounds checking. Returns true if successful, false if the buffer is too
+// small for all of the values.
+template <typename T, size_t kExtent>
+[[nodiscard]] bool ReadInOrder(std::endian order,
+                               ConstByteSpan buffer,
+                               std::span<T, kExtent> values) {
+  if (buffer.size() < values.size_bytes()) {
+    return false;
+  }
+
+  ReadInOrder(order, buffer.data(), values);
+  return true;
+}
+
 }  // namespace pw::bytes
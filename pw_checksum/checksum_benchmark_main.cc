@@ -0,0 +1,120 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the throughput of each CRC implementation and logs the results.
+// Build this for a device to choose the CRC implementations for a product.
+//
+// To also log bytes per cycle, define PW_CHECKSUM_BENCHMARK_CPU_HZ as the
+// frequency of the CPU the benchmark runs on.
+
+#define PW_LOG_MODULE_NAME "CRC"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum/crc32.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+
+#ifndef PW_CHECKSUM_BENCHMARK_CPU_HZ
+#define PW_CHECKSUM_BENCHMARK_CPU_HZ 0
+#endif  // PW_CHECKSUM_BENCHMARK_CPU_HZ
+
+namespace {
+
+using pw::chrono::SystemClock;
+
+constexpr size_t kBufferSizeBytes = 4096;
+constexpr size_t kIterations = 256;
+
+std::array<uint8_t, kBufferSizeBytes> buffer;
+
+// Keeps the compiler from discarding the CRC calculations.
+volatile uint32_t result_sink;
+
+template <typename Function>
+void Run(const char* name, Function&& calculate) {
+  const SystemClock::time_point start = SystemClock::now();
+  for (size_t i = 0; i < kIterations; ++i) {
+    result_sink = calculate(buffer.data(), buffer.size());
+  }
+  const SystemClock::duration elapsed = SystemClock::now() - start;
+
+  const uint64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (ns == 0u) {
+    PW_LOG_ERROR("%s: the system clock is too coarse to time one run", name);
+    return;
+  }
+
+  const uint64_t bytes = uint64_t(kBufferSizeBytes) * kIterations;
+  const uint64_t bytes_per_second = bytes * 1'000'000'000u / ns;
+
+  if constexpr (PW_CHECKSUM_BENCHMARK_CPU_HZ > 0) {
+    // Bytes per 1000 cycles, to keep integer precision.
+    const uint64_t bytes_per_kcycle =
+        bytes_per_second * 1000u / uint64_t(PW_CHECKSUM_BENCHMARK_CPU_HZ);
+    PW_LOG_INFO("%-26s %8u KB/s, %u.%03u B/cycle",
+                name,
+                static_cast<unsigned>(bytes_per_second / 1024u),
+                static_cast<unsigned>(bytes_per_kcycle / 1000u),
+                static_cast<unsigned>(bytes_per_kcycle % 1000u));
+  } else {
+    PW_LOG_INFO("%-26s %8u KB/s",
+                name,
+                static_cast<unsigned>(bytes_per_second / 1024u));
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<uint8_t>(i * 31u);
+  }
+
+  PW_LOG_INFO("Calculating CRCs of %u B, %u times",
+              static_cast<unsigned>(kBufferSizeBytes),
+              static_cast<unsigned>(kIterations));
+
+  Run("CRC-16-CCITT nibble table", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc16CcittNibbleTable(data, size, 0xFFFF);
+  });
+  Run("CRC-16-CCITT byte table", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc16CcittByteTable(data, size, 0xFFFF);
+  });
+  Run("CRC-16-CCITT slicing-by-4", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc16CcittSlicingBy4(data, size, 0xFFFF);
+  });
+
+  Run("CRC32 byte table", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc32ByteTable(
+        data, size, _PW_CHECKSUM_CRC32_INITIAL_STATE);
+  });
+  Run("CRC32 slicing-by-8", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc32SlicingBy8(
+        data, size, _PW_CHECKSUM_CRC32_INITIAL_STATE);
+  });
+#if defined(__ARM_FEATURE_CRC32)
+  Run("CRC32 ARMv8 instructions", [](const void* data, size_t size) {
+    return _pw_checksum_InternalCrc32Arm(
+        data, size, _PW_CHECKSUM_CRC32_INITIAL_STATE);
+  });
+#endif  // defined(__ARM_FEATURE_CRC32)
+
+  return 0;
+}
@@ -14,6 +14,10 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+
+#include "pw_checksum/internal/config.h"
+
 namespace pw::checksum {
 namespace {
 
@@ -52,11 +56,56 @@ constexpr uint16_t kCrc16CcittTable[256]{
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
 };
 
+// The CRC of each nibble value in the high four bits of the CRC.
+constexpr auto kNibbleTable = [] {
+  std::array<uint16_t, 16> table{};
+  for (size_t i = 0; i < table.size(); ++i) {
+    uint16_t value = static_cast<uint16_t>(i << 12);
+    for (int bit = 0; bit < 4; ++bit) {
+      value = static_cast<uint16_t>((value & 0x8000u) ? (value << 1) ^ 0x1021u
+                                                       : value << 1);
+    }
+    table[i] = value;
+  }
+  return table;
+}();
+
+// Tables for slicing-by-4. kSlicingTables[0] is the byte table, and
+// kSlicingTables[n] is the CRC of a byte followed by n zero bytes.
+constexpr auto kSlicingTables = [] {
+  std::array<std::array<uint16_t, 256>, 4> tables{};
+  for (size_t i = 0; i < 256; ++i) {
+    tables[0][i] = kCrc16CcittTable[i];
+  }
+  for (size_t n = 1; n < tables.size(); ++n) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint16_t previous = tables[n - 1][i];
+      tables[n][i] = static_cast<uint16_t>((previous << 8) ^
+                                           kCrc16CcittTable[previous >> 8]);
+    }
+  }
+  return tables;
+}();
+
 }  // namespace
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittNibbleTable(
+    const void* data, size_t size_bytes, uint16_t value) {
+  const uint8_t* const array = static_cast<const uint8_t*>(data);
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    value = static_cast<uint16_t>(
+        kNibbleTable[(value >> 12) ^ (array[i] >> 4)] ^ (value << 4));
+    value = static_cast<uint16_t>(
+        kNibbleTable[(value >> 12) ^ (array[i] & 0xfu)] ^ (value << 4));
+  }
+
+  return value;
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittByteTable(const void* data,
+                                                             size_t size_bytes,
+                                                             uint16_t value) {
   const uint8_t* const array = static_cast<const uint8_t*>(data);
 
   for (size_t i = 0; i < size_bytes; ++i) {
@@ -66,4 +115,31 @@ extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
   return value;
 }
 
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSlicingBy4(
+    const void* data, size_t size_bytes, uint16_t value) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+  const auto& t = kSlicingTables;
+
+  for (; size_bytes >= 4u; size_bytes -= 4u, array += 4) {
+    value = t[3][(value >> 8) ^ array[0]] ^ t[2][(value & 0xffu) ^ array[1]] ^
+            t[1][array[2]] ^ t[0][array[3]];
+  }
+
+  return _pw_checksum_InternalCrc16CcittByteTable(array, size_bytes, value);
+}
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+#if PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE
+  return _pw_checksum_InternalCrc16CcittNibbleTable(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE
+  return _pw_checksum_InternalCrc16CcittByteTable(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4
+  return _pw_checksum_InternalCrc16CcittSlicingBy4(data, size_bytes, value);
+#else
+#error "Unknown PW_CHECKSUM_CRC16_CCITT_IMPL"
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPL
+}
+
 }  // namespace pw::checksum
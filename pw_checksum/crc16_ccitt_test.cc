@@ -79,5 +79,40 @@ TEST(Crc16FromC, String) {
   EXPECT_EQ(CallChecksumCrc16Ccitt(kString.data(), kString.size()), kStringCrc);
 }
 
+using Crc16Function = uint16_t (*)(const void*, size_t, uint16_t);
+
+constexpr Crc16Function kImplementations[] = {
+    _pw_checksum_InternalCrc16CcittNibbleTable,
+    _pw_checksum_InternalCrc16CcittByteTable,
+    _pw_checksum_InternalCrc16CcittSlicingBy4,
+};
+
+TEST(Crc16Implementations, Buffer) {
+  for (Crc16Function function : kImplementations) {
+    EXPECT_EQ(function(kBytes, sizeof(kBytes), Crc16Ccitt::kInitialValue),
+              kBufferCrc);
+  }
+}
+
+TEST(Crc16Implementations, String) {
+  for (Crc16Function function : kImplementations) {
+    EXPECT_EQ(
+        function(kString.data(), kString.size(), Crc16Ccitt::kInitialValue),
+        kStringCrc);
+  }
+}
+
+TEST(Crc16Implementations, AllSizesAndOffsets_MatchByteTable) {
+  for (Crc16Function function : kImplementations) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      for (size_t size = 0; size + offset <= kString.size(); ++size) {
+        const char* data = kString.data() + offset;
+        ASSERT_EQ(_pw_checksum_InternalCrc16CcittByteTable(data, size, 0x1234),
+                  function(data, size, 0x1234));
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace pw::checksum
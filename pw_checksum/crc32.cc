@@ -14,6 +14,15 @@
 
 #include "pw_checksum/crc32.h"
 
+#include <array>
+#include <cstring>
+
+#include "pw_checksum/internal/config.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif  // defined(__ARM_FEATURE_CRC32)
+
 namespace pw::checksum {
 namespace {
 
@@ -62,11 +71,34 @@ constexpr uint32_t kCrc32Table[] = {
     0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
     0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
 
+// Tables for slicing-by-8. kSlicingTables[0] is the byte table, and
+// kSlicingTables[n] is the CRC of a byte followed by n zero bytes.
+constexpr auto kSlicingTables = [] {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (size_t i = 0; i < 256; ++i) {
+    tables[0][i] = kCrc32Table[i];
+  }
+  for (size_t n = 1; n < tables.size(); ++n) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint32_t previous = tables[n - 1][i];
+      tables[n][i] = (previous >> 8) ^ kCrc32Table[previous & 0xFFu];
+    }
+  }
+  return tables;
+}();
+
+// Reads a little-endian word. Compilers combine this into a single load on
+// little-endian targets.
+constexpr uint32_t ReadLittleEndian(const uint8_t* bytes) {
+  return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+         (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
 }  // namespace
 
-extern "C" uint32_t _pw_checksum_InternalCrc32(const void* data,
-                                               size_t size_bytes,
-                                               uint32_t state) {
+extern "C" uint32_t _pw_checksum_InternalCrc32ByteTable(const void* data,
+                                                        size_t size_bytes,
+                                                        uint32_t state) {
   const uint8_t* array = static_cast<const uint8_t*>(data);
 
   for (size_t i = 0; i < size_bytes; ++i) {
@@ -76,4 +108,73 @@ extern "C" uint32_t _pw_checksum_InternalCrc32(const void* data,
   return state;
 }
 
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                                         size_t size_bytes,
+                                                         uint32_t state) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+  const auto& t = kSlicingTables;
+
+  for (; size_bytes >= 8u; size_bytes -= 8u, array += 8) {
+    const uint32_t low = state ^ ReadLittleEndian(array);
+    const uint32_t high = ReadLittleEndian(array + 4);
+
+    state = t[7][low & 0xFFu] ^ t[6][(low >> 8) & 0xFFu] ^
+            t[5][(low >> 16) & 0xFFu] ^ t[4][low >> 24] ^
+            t[3][high & 0xFFu] ^ t[2][(high >> 8) & 0xFFu] ^
+            t[1][(high >> 16) & 0xFFu] ^ t[0][high >> 24];
+  }
+
+  return _pw_checksum_InternalCrc32ByteTable(array, size_bytes, state);
+}
+
+#if defined(__ARM_FEATURE_CRC32)
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Arm(const void* data,
+                                                  size_t size_bytes,
+                                                  uint32_t state) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+#if defined(__aarch64__)
+  for (; size_bytes >= sizeof(uint64_t); size_bytes -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, array, sizeof(word));
+    state = __crc32d(state, word);
+    array += sizeof(word);
+  }
+#endif  // defined(__aarch64__)
+
+  for (; size_bytes >= sizeof(uint32_t); size_bytes -= sizeof(uint32_t)) {
+    uint32_t word;
+    std::memcpy(&word, array, sizeof(word));
+    state = __crc32w(state, word);
+    array += sizeof(word);
+  }
+
+  for (; size_bytes > 0u; --size_bytes) {
+    state = __crc32b(state, *array++);
+  }
+
+  return state;
+}
+
+#endif  // defined(__ARM_FEATURE_CRC32)
+
+#if PW_CHECKSUM_CRC32_IMPL != PW_CHECKSUM_CRC32_EXTERNAL
+
+extern "C" uint32_t _pw_checksum_InternalCrc32(const void* data,
+                                               size_t size_bytes,
+                                               uint32_t state) {
+#if PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_BYTE_TABLE
+  return _pw_checksum_InternalCrc32ByteTable(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_SLICING_BY_8
+  return _pw_checksum_InternalCrc32SlicingBy8(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_ARM_CRC32
+  return _pw_checksum_InternalCrc32Arm(data, size_bytes, state);
+#else
+#error "Unknown PW_CHECKSUM_CRC32_IMPL"
+#endif  // PW_CHECKSUM_CRC32_IMPL
+}
+
+#endif  // PW_CHECKSUM_CRC32_IMPL != PW_CHECKSUM_CRC32_EXTERNAL
+
 }  // namespace pw::checksum
@@ -105,5 +105,44 @@ TEST(Crc32AppendFromC, String) {
             kStringCrc);
 }
 
+using Crc32Function = uint32_t (*)(const void*, size_t, uint32_t);
+
+constexpr Crc32Function kImplementations[] = {
+    _pw_checksum_InternalCrc32ByteTable,
+    _pw_checksum_InternalCrc32SlicingBy8,
+#if defined(__ARM_FEATURE_CRC32)
+    _pw_checksum_InternalCrc32Arm,
+#endif  // defined(__ARM_FEATURE_CRC32)
+};
+
+// Calculates a finalized CRC32 with one of the internal implementations.
+uint32_t Calculate(Crc32Function function, const void* data, size_t size) {
+  return ~function(data, size, _PW_CHECKSUM_CRC32_INITIAL_STATE);
+}
+
+TEST(Crc32Implementations, Buffer) {
+  for (Crc32Function function : kImplementations) {
+    EXPECT_EQ(Calculate(function, kBytes.data(), kBytes.size()), kBufferCrc);
+  }
+}
+
+TEST(Crc32Implementations, String) {
+  for (Crc32Function function : kImplementations) {
+    EXPECT_EQ(Calculate(function, kString.data(), kString.size()), kStringCrc);
+  }
+}
+
+TEST(Crc32Implementations, AllSizesAndOffsets_MatchByteTable) {
+  for (Crc32Function function : kImplementations) {
+    for (size_t offset = 0; offset < 8; ++offset) {
+      for (size_t size = 0; size + offset <= kString.size(); ++size) {
+        const char* data = kString.data() + offset;
+        ASSERT_EQ(Calculate(_pw_checksum_InternalCrc32ByteTable, data, size),
+                  Calculate(function, data, size));
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace pw::checksum
@@ -37,6 +37,24 @@ uint32_t _pw_checksum_InternalCrc32(const void* data,
                                     size_t size_bytes,
                                     uint32_t state);
 
+// The software CRC32 implementations, one of which is normally used by
+// _pw_checksum_InternalCrc32. Do not call them directly.
+uint32_t _pw_checksum_InternalCrc32ByteTable(const void* data,
+                                             size_t size_bytes,
+                                             uint32_t state);
+
+uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                              size_t size_bytes,
+                                              uint32_t state);
+
+#if defined(__ARM_FEATURE_CRC32)
+// CRC32 implementation with the ARMv8 CRC32 instructions. Do not call it
+// directly.
+uint32_t _pw_checksum_InternalCrc32Arm(const void* data,
+                                       size_t size_bytes,
+                                       uint32_t state);
+#endif  // defined(__ARM_FEATURE_CRC32)
+
 // Calculates the CRC32 for the provided data.
 static inline uint32_t pw_checksum_Crc32(const void* data, size_t size_bytes) {
   return ~_pw_checksum_InternalCrc32(
@@ -0,0 +1,68 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Configuration macros for the checksum module.
+#pragma once
+
+// CRC-16-CCITT implementations that may be selected with
+// PW_CHECKSUM_CRC16_CCITT_IMPL.
+//
+// Processes four bits at a time with a 32 B table.
+#define PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE 1
+
+// Processes one byte at a time with a 512 B table.
+#define PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE 2
+
+// Processes four bytes at a time with a 2 KB table.
+#define PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4 3
+
+// The CRC-16-CCITT implementation used by pw_checksum_Crc16Ccitt and
+// pw::checksum::Crc16Ccitt.
+#ifndef PW_CHECKSUM_CRC16_CCITT_IMPL
+#define PW_CHECKSUM_CRC16_CCITT_IMPL PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPL
+
+// CRC32 implementations that may be selected with PW_CHECKSUM_CRC32_IMPL.
+//
+// Processes one byte at a time with a 1 KB table.
+#define PW_CHECKSUM_CRC32_BYTE_TABLE 1
+
+// Processes eight bytes at a time with an 8 KB table. This is several times
+// faster than the byte table on processors with large enough caches.
+#define PW_CHECKSUM_CRC32_SLICING_BY_8 2
+
+// Uses the ARMv8 CRC32 instructions. Requires a target with the CRC extension,
+// which defines __ARM_FEATURE_CRC32.
+#define PW_CHECKSUM_CRC32_ARM_CRC32 3
+
+// The project provides _pw_checksum_InternalCrc32 in another library, for
+// example to use a CRC peripheral. It must update a CRC32 state as described in
+// pw_checksum/crc32.h, without the initial and final inversions.
+#define PW_CHECKSUM_CRC32_EXTERNAL 4
+
+// The CRC32 implementation used by pw_checksum_Crc32 and pw::checksum::Crc32.
+// Defaults to the ARMv8 CRC32 instructions when they are available, and the
+// byte table otherwise.
+#ifndef PW_CHECKSUM_CRC32_IMPL
+#if defined(__ARM_FEATURE_CRC32)
+#define PW_CHECKSUM_CRC32_IMPL PW_CHECKSUM_CRC32_ARM_CRC32
+#else
+#define PW_CHECKSUM_CRC32_IMPL PW_CHECKSUM_CRC32_BYTE_TABLE
+#endif  // defined(__ARM_FEATURE_CRC32)
+#endif  // PW_CHECKSUM_CRC32_IMPL
+
+#if PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_ARM_CRC32 && \
+    !defined(__ARM_FEATURE_CRC32)
+#error "PW_CHECKSUM_CRC32_ARM_CRC32 requires the ARMv8 CRC32 extension"
+#endif
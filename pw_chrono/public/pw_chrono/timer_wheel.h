@@ -0,0 +1,179 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono/system_timer.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::chrono {
+
+// The TimerWheel multiplexes many one-shot timers onto a single SystemTimer.
+// Each native RTOS timer costs memory and time in the RTOS's timer list, and
+// timers with nearby deadlines each cause their own wakeup. The TimerWheel
+// rounds every deadline up to a multiple of the slack duration, so timers
+// whose deadlines fall within the same slack window expire together with one
+// wakeup.
+//
+// Timers are kept in a hierarchical timer wheel: kLevels levels of kSlots
+// slots, where each slot of a level spans kSlots slots of the level below.
+// Scheduling and cancelling are O(1) apart from removing the timer from its
+// slot, and the SystemTimer only wakes up for slots that hold timers.
+//
+// Timers never expire early, and expire at most one slack duration late in
+// addition to the SystemTimer's own latency.
+//
+//   pw::chrono::TimerWheel wheel(pw::chrono::SystemClock::for_at_least(
+//       std::chrono::milliseconds(10)));
+//
+//   pw::chrono::TimerWheel::Timer timeout(
+//       wheel, [](pw::chrono::SystemClock::time_point) { HandleTimeout(); });
+//   timeout.InvokeAfter(pw::chrono::SystemClock::for_at_least(
+//       std::chrono::milliseconds(250)));
+//
+// The entire API is thread safe, however it is NOT always IRQ safe, just like
+// the SystemTimer.
+class TimerWheel {
+ public:
+  // Mirrors the SystemTimer API. Expiry callbacks run in the SystemTimer's
+  // expiry callback context, so they are subject to the same restrictions: keep
+  // them short, never block, and do not use APIs that are not interrupt safe.
+  class Timer : public IntrusiveList<Timer>::Item {
+   public:
+    using ExpiryCallback = SystemTimer::ExpiryCallback;
+
+    Timer(TimerWheel& wheel, ExpiryCallback&& callback)
+        : wheel_(wheel),
+          callback_(std::move(callback)),
+          deadline_(),
+          expiry_(0),
+          slot_(nullptr) {}
+
+    // Cancels the timer. Unlike the SystemTimer, this does not wait for an
+    // expiry callback that is already running; do not destroy a timer from
+    // another thread while its callback may be running.
+    ~Timer() { Cancel(); }
+
+    Timer(const Timer&) = delete;
+    Timer(Timer&&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    Timer& operator=(Timer&&) = delete;
+
+    // Invokes the expiry callback at least delay from now, rounded up to the
+    // next slack boundary. Cancels the pending expiry, if any.
+    void InvokeAfter(SystemClock::duration delay) {
+      InvokeAt(SystemClock::TimePointAfterAtLeast(delay));
+    }
+
+    // Invokes the expiry callback at or after the specified time, rounded up
+    // to the next slack boundary. Cancels the pending expiry, if any. The
+    // callback receives the requested time as its expired deadline.
+    void InvokeAt(SystemClock::time_point timestamp) {
+      wheel_.Schedule(*this, timestamp);
+    }
+
+    // Cancels the expiry callback if pending. Cancelling a timer which isn't
+    // scheduled does nothing.
+    void Cancel() { wheel_.Cancel(*this); }
+
+   private:
+    friend class TimerWheel;
+
+    TimerWheel& wheel_;
+    ExpiryCallback callback_;
+    SystemClock::time_point deadline_;
+
+    // The deadline in slack units, rounded up.
+    SystemClock::rep expiry_;
+
+    // The slot that holds this timer, or nullptr if it is not scheduled.
+    IntrusiveList<Timer>* slot_;
+  };
+
+  static constexpr int kSlotBits = 4;
+  static constexpr size_t kSlots = size_t{1} << kSlotBits;
+  static constexpr size_t kLevels = 4;
+
+  // Deadlines are rounded up to a multiple of slack. A slack of zero or less
+  // is treated as one tick, which orders timers but does not coalesce them.
+  explicit TimerWheel(SystemClock::duration slack);
+
+  // All timers must be cancelled or destroyed before the wheel.
+  ~TimerWheel() = default;
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  SystemClock::duration slack() const { return SystemClock::duration(slack_); }
+
+ private:
+  using Slot = IntrusiveList<Timer>;
+
+  static constexpr SystemClock::rep kIdle =
+      std::numeric_limits<SystemClock::rep>::max();
+
+  void Schedule(Timer& timer, SystemClock::time_point timestamp);
+  void Cancel(Timer& timer);
+
+  // SystemTimer expiry callback. Runs the expiry callbacks of all due timers
+  // and re-arms the SystemTimer for the next occupied slot.
+  void Process();
+
+  // Arms the SystemTimer for the current next_wakeup_, if it changed.
+  void UpdateSystemTimer();
+
+  void Insert(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void Remove(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Moves the timers in the slots that start at current_ down the wheel.
+  void Cascade() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns the slack unit of the first occupied slot, the next boundary at
+  // which overflow timers are moved into the wheel, or kIdle if empty.
+  SystemClock::rep NextOccupied() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const SystemClock::rep slack_;
+
+  SystemTimer system_timer_;
+
+  sync::InterruptSpinLock lock_;
+
+  // All slack units before current_ have been processed.
+  SystemClock::rep current_ PW_GUARDED_BY(lock_);
+  size_t size_ PW_GUARDED_BY(lock_);
+
+  std::array<std::array<Slot, kSlots>, kLevels> levels_ PW_GUARDED_BY(lock_);
+
+  // Timers beyond the range of the top level.
+  Slot overflow_ PW_GUARDED_BY(lock_);
+
+  // Timers that are due, whose callbacks are being run.
+  Slot expired_ PW_GUARDED_BY(lock_);
+
+  // The slack unit the SystemTimer should be armed for, and the one it is
+  // armed for, or kIdle if none.
+  SystemClock::rep next_wakeup_ PW_GUARDED_BY(lock_);
+  SystemClock::rep armed_wakeup_ PW_GUARDED_BY(lock_);
+};
+
+}  // namespace pw::chrono
@@ -0,0 +1,260 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace pw::chrono {
+namespace {
+
+constexpr SystemClock::rep kSlotMask = TimerWheel::kSlots - 1;
+
+// The number of slack units spanned by one slot of the given level.
+constexpr SystemClock::rep SlotSpan(size_t level) {
+  return SystemClock::rep{1} << (TimerWheel::kSlotBits * level);
+}
+
+constexpr SystemClock::rep kWheelSpan = SlotSpan(TimerWheel::kLevels);
+
+// Returns the level whose slots distinguish expiry from current, which is
+// the index of the highest slot-sized digit in which they differ.
+size_t LevelFor(SystemClock::rep expiry, SystemClock::rep current) {
+  auto difference = static_cast<uint64_t>(expiry ^ current);
+  size_t level = 0;
+  while (difference >= TimerWheel::kSlots) {
+    difference >>= TimerWheel::kSlotBits;
+    level += 1;
+  }
+  return level;
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(SystemClock::duration slack)
+    : slack_(std::max(slack.count(), SystemClock::rep{1})),
+      system_timer_([this](SystemClock::time_point) { Process(); }),
+      current_(0),
+      size_(0),
+      next_wakeup_(kIdle),
+      armed_wakeup_(kIdle) {}
+
+void TimerWheel::Schedule(Timer& timer, SystemClock::time_point timestamp) {
+  const SystemClock::rep now_ticks =
+      SystemClock::now().time_since_epoch().count();
+  const SystemClock::rep ticks =
+      std::max(timestamp.time_since_epoch().count(), SystemClock::rep{0});
+
+  {
+    std::lock_guard lock(lock_);
+    if (timer.slot_ != nullptr) {
+      Remove(timer);
+    }
+
+    // The wheel only advances while it holds timers. Catch up to the clock
+    // when it is empty, which keeps new timers in the lowest levels.
+    if (size_ == 0) {
+      current_ = std::max(current_, now_ticks / slack_);
+    }
+
+    timer.deadline_ = timestamp;
+    timer.expiry_ = ticks / slack_ + (ticks % slack_ != 0 ? 1 : 0);
+    Insert(timer);
+  }
+
+  UpdateSystemTimer();
+}
+
+void TimerWheel::Cancel(Timer& timer) {
+  std::lock_guard lock(lock_);
+  if (timer.slot_ != nullptr) {
+    Remove(timer);
+  }
+  // The SystemTimer is left armed. Waking up for a slot that has emptied is
+  // cheaper than finding the next occupied slot on every cancel.
+}
+
+void TimerWheel::Insert(Timer& timer) {
+  const SystemClock::rep expiry = std::max(timer.expiry_, current_);
+  const size_t level = LevelFor(expiry, current_);
+
+  SystemClock::rep wakeup;
+  if (level >= kLevels) {
+    timer.slot_ = &overflow_;
+    wakeup = (current_ / kWheelSpan + 1) * kWheelSpan;
+  } else {
+    timer.slot_ =
+        &levels_[level][(expiry >> (kSlotBits * level)) & kSlotMask];
+    wakeup = expiry & ~(SlotSpan(level) - 1);
+  }
+
+  timer.slot_->push_back(timer);
+  size_ += 1;
+  next_wakeup_ = std::min(next_wakeup_, wakeup);
+}
+
+void TimerWheel::Remove(Timer& timer) {
+  timer.slot_->remove(timer);
+  timer.slot_ = nullptr;
+  size_ -= 1;
+}
+
+void TimerWheel::Cascade() {
+  // Re-inserting a timer places it relative to current_, which moves it to a
+  // lower level. Work from the top down, since a higher level may cascade into
+  // a slot that starts at current_ on a lower level.
+  if (current_ % kWheelSpan == 0 && !overflow_.empty()) {
+    Slot overflow;
+    while (!overflow_.empty()) {
+      Timer& timer = overflow_.front();
+      overflow_.pop_front();
+      overflow.push_back(timer);
+    }
+    while (!overflow.empty()) {
+      Timer& timer = overflow.front();
+      overflow.pop_front();
+      size_ -= 1;
+      Insert(timer);
+    }
+  }
+
+  for (size_t level = kLevels - 1; level > 0; --level) {
+    if (current_ % SlotSpan(level) != 0) {
+      continue;
+    }
+    Slot& slot = levels_[level][(current_ >> (kSlotBits * level)) & kSlotMask];
+    while (!slot.empty()) {
+      Timer& timer = slot.front();
+      slot.pop_front();
+      size_ -= 1;
+      Insert(timer);
+    }
+  }
+}
+
+SystemClock::rep TimerWheel::NextOccupied() const {
+  if (size_ == 0) {
+    return kIdle;
+  }
+
+  for (SystemClock::rep slot = current_ & kSlotMask;
+       slot < static_cast<SystemClock::rep>(kSlots);
+       ++slot) {
+    if (!levels_[0][slot].empty()) {
+      return (current_ & ~kSlotMask) + slot;
+    }
+  }
+
+  // The slot that contains current_ on the upper levels has already been
+  // cascaded, so only later slots can hold timers.
+  for (size_t level = 1; level < kLevels; ++level) {
+    const int shift = kSlotBits * static_cast<int>(level);
+    for (SystemClock::rep slot = ((current_ >> shift) & kSlotMask) + 1;
+         slot < static_cast<SystemClock::rep>(kSlots);
+         ++slot) {
+      if (!levels_[level][slot].empty()) {
+        const SystemClock::rep level_start =
+            current_ & ~(SlotSpan(level + 1) - 1);
+        return level_start + (slot << shift);
+      }
+    }
+  }
+
+  return (current_ / kWheelSpan + 1) * kWheelSpan;
+}
+
+void TimerWheel::Process() {
+  const SystemClock::rep now =
+      SystemClock::now().time_since_epoch().count() / slack_;
+
+  lock_.lock();
+  armed_wakeup_ = kIdle;  // The SystemTimer fired, so it is no longer armed.
+
+  while (true) {
+    // Run the callbacks without holding the lock, so that they may schedule
+    // timers, including their own.
+    while (!expired_.empty()) {
+      Timer& timer = expired_.front();
+      expired_.pop_front();
+      timer.slot_ = nullptr;
+      size_ -= 1;
+      const SystemClock::time_point deadline = timer.deadline_;
+
+      lock_.unlock();
+      timer.callback_(deadline);
+      lock_.lock();
+    }
+
+    const SystemClock::rep next = NextOccupied();
+    if (next > now) {
+      // Nothing is due before next, so skip the wheel ahead to the clock.
+      if (current_ <= now) {
+        current_ = now + 1;
+        Cascade();
+      }
+      break;
+    }
+
+    current_ = next;
+    Cascade();
+
+    Slot& slot = levels_[0][current_ & kSlotMask];
+    while (!slot.empty()) {
+      Timer& timer = slot.front();
+      slot.pop_front();
+      expired_.push_back(timer);
+      timer.slot_ = &expired_;
+    }
+
+    current_ += 1;
+    Cascade();
+  }
+
+  next_wakeup_ = NextOccupied();
+  lock_.unlock();
+
+  UpdateSystemTimer();
+}
+
+void TimerWheel::UpdateSystemTimer() {
+  // The SystemTimer is armed without holding the lock, since it is not IRQ
+  // safe. If another thread armed it concurrently, the calls may land in
+  // either order, so check again after arming and repeat until the last
+  // armed wakeup is the one that is needed.
+  SystemClock::rep wakeup = kIdle;
+  bool armed = false;
+
+  while (true) {
+    {
+      std::lock_guard lock(lock_);
+      if (armed_wakeup_ == next_wakeup_ &&
+          (!armed || armed_wakeup_ == wakeup)) {
+        return;
+      }
+      wakeup = next_wakeup_;
+      armed_wakeup_ = wakeup;
+    }
+
+    if (wakeup == kIdle) {
+      system_timer_.Cancel();
+    } else {
+      system_timer_.InvokeAt(
+          SystemClock::time_point(SystemClock::duration(wakeup * slack_)));
+    }
+    armed = true;
+  }
+}
+
+}  // namespace pw::chrono
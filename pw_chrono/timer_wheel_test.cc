@@ -0,0 +1,230 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_sync/thread_notification.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::chrono {
+namespace {
+
+constexpr SystemClock::duration kSlack = SystemClock::for_at_least(20ms);
+constexpr SystemClock::duration kRoundedArbitraryLongDuration =
+    SystemClock::for_at_least(1s);
+
+void ShouldNotBeInvoked(SystemClock::time_point) { FAIL(); }
+
+// Returns the first slack boundary that is at least delay from now.
+SystemClock::time_point SlackBoundaryAfter(const TimerWheel& wheel,
+                                           SystemClock::duration delay) {
+  const SystemClock::rep slack = wheel.slack().count();
+  const SystemClock::rep ticks =
+      (SystemClock::now() + delay).time_since_epoch().count();
+  return SystemClock::time_point(
+      SystemClock::duration((ticks / slack + 1) * slack));
+}
+
+TEST(TimerWheel, CancelInactive) {
+  TimerWheel wheel(kSlack);
+  TimerWheel::Timer timer(wheel, ShouldNotBeInvoked);
+  timer.Cancel();
+}
+
+TEST(TimerWheel, CancelExplicitly) {
+  TimerWheel wheel(kSlack);
+  TimerWheel::Timer timer(wheel, ShouldNotBeInvoked);
+  timer.InvokeAfter(kRoundedArbitraryLongDuration);
+  timer.Cancel();
+}
+
+TEST(TimerWheel, CancelThroughDestruction) {
+  TimerWheel wheel(kSlack);
+  TimerWheel::Timer timer(wheel, ShouldNotBeInvoked);
+  timer.InvokeAfter(kRoundedArbitraryLongDuration);
+}
+
+TEST(TimerWheel, CancelThroughRescheduling) {
+  TimerWheel wheel(kSlack);
+  sync::ThreadNotification done;
+  TimerWheel::Timer timer(wheel,
+                          [&done](SystemClock::time_point) { done.release(); });
+  TimerWheel::Timer canary(wheel, ShouldNotBeInvoked);
+
+  canary.InvokeAfter(kRoundedArbitraryLongDuration);
+  timer.InvokeAfter(kRoundedArbitraryLongDuration);
+  timer.InvokeAfter(kSlack);
+  done.acquire();
+}
+
+TEST(TimerWheel, InvokeAt) {
+  struct Context {
+    SystemClock::time_point expected_deadline;
+    sync::ThreadNotification done;
+  } context;
+
+  TimerWheel wheel(kSlack);
+  TimerWheel::Timer timer(
+      wheel, [&context](SystemClock::time_point expired_deadline) {
+        EXPECT_GE(SystemClock::now(), expired_deadline);
+        EXPECT_EQ(expired_deadline, context.expected_deadline);
+        context.done.release();
+      });
+
+  context.expected_deadline = SystemClock::now() + kSlack / 2;
+  timer.InvokeAt(context.expected_deadline);
+  context.done.acquire();
+
+  // Ensure you can re-use the timer.
+  context.expected_deadline = SystemClock::now() + kSlack * 3;
+  timer.InvokeAt(context.expected_deadline);
+  context.done.acquire();
+}
+
+TEST(TimerWheel, InvokeAtPastDeadline) {
+  TimerWheel wheel(kSlack);
+  sync::ThreadNotification done;
+  TimerWheel::Timer timer(wheel,
+                          [&done](SystemClock::time_point) { done.release(); });
+
+  timer.InvokeAt(SystemClock::now() - kSlack * 2);
+  done.acquire();
+}
+
+TEST(TimerWheel, CoalescesDeadlinesWithinSlack) {
+  struct Context {
+    SystemClock::time_point boundary;
+    std::atomic<int> expired = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  TimerWheel wheel(kSlack);
+  context.boundary = SlackBoundaryAfter(wheel, kSlack);
+
+  auto callback = [&context](SystemClock::time_point) {
+    // Both timers are rounded up to the same slack boundary.
+    EXPECT_GE(SystemClock::now(), context.boundary);
+    if (context.expired.fetch_add(1) + 1 == 2) {
+      context.done.release();
+    }
+  };
+  TimerWheel::Timer early(wheel, callback);
+  TimerWheel::Timer late(wheel, callback);
+
+  early.InvokeAt(context.boundary - kSlack + SystemClock::duration(1));
+  late.InvokeAt(context.boundary);
+  context.done.acquire();
+}
+
+// Records the order in which timers expire.
+class OrderedTimer {
+ public:
+  struct Order {
+    std::atomic<int> expired = 0;
+    int expected = 0;
+    sync::ThreadNotification done;
+  };
+
+  OrderedTimer(TimerWheel& wheel, Order& order)
+      : order_(order),
+        timer_(wheel, [this](SystemClock::time_point expired_deadline) {
+          OnExpiry(expired_deadline);
+        }) {}
+
+  void InvokeAt(SystemClock::time_point deadline) {
+    deadline_ = deadline;
+    timer_.InvokeAt(deadline);
+  }
+
+  int position() const { return position_; }
+
+ private:
+  void OnExpiry(SystemClock::time_point expired_deadline) {
+    EXPECT_GE(SystemClock::now(), expired_deadline);
+    EXPECT_EQ(expired_deadline, deadline_);
+    position_ = order_.expired.fetch_add(1);
+    if (position_ + 1 == order_.expected) {
+      order_.done.release();
+    }
+  }
+
+  Order& order_;
+  SystemClock::time_point deadline_;
+  int position_ = -1;
+  TimerWheel::Timer timer_;
+};
+
+TEST(TimerWheel, ExpiresInDeadlineOrderAcrossLevels) {
+  // A short slack and spread out deadlines put the timers on several levels of
+  // the wheel, which exercises cascading.
+  TimerWheel wheel(SystemClock::for_at_least(1ms));
+  const SystemClock::time_point start = SystemClock::now();
+
+  OrderedTimer::Order order;
+  order.expected = 5;
+  std::array<OrderedTimer, 5> timers = {
+      OrderedTimer(wheel, order),
+      OrderedTimer(wheel, order),
+      OrderedTimer(wheel, order),
+      OrderedTimer(wheel, order),
+      OrderedTimer(wheel, order),
+  };
+
+  // Schedule out of order, far enough apart to expire in separate slots.
+  constexpr int kSlackUnits[] = {300, 3, 40, 150, 20};
+  for (size_t i = 0; i < timers.size(); ++i) {
+    timers[i].InvokeAt(start + wheel.slack() * kSlackUnits[i]);
+  }
+  order.done.acquire();
+
+  EXPECT_EQ(timers[1].position(), 0);
+  EXPECT_EQ(timers[4].position(), 1);
+  EXPECT_EQ(timers[2].position(), 2);
+  EXPECT_EQ(timers[3].position(), 3);
+  EXPECT_EQ(timers[0].position(), 4);
+}
+
+TEST(TimerWheel, RescheduleFromCallback) {
+  static constexpr int kPeriods = 3;
+
+  struct Context {
+    TimerWheel::Timer* timer = nullptr;
+    int count = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  TimerWheel wheel(kSlack);
+  TimerWheel::Timer timer(
+      wheel, [&context](SystemClock::time_point expired_deadline) {
+        if (++context.count == kPeriods) {
+          context.done.release();
+        } else {
+          context.timer->InvokeAt(expired_deadline + kSlack);
+        }
+      });
+  context.timer = &timer;
+
+  timer.InvokeAfter(kSlack);
+  context.done.acquire();
+  EXPECT_EQ(context.count, kPeriods);
+}
+
+}  // namespace
+}  // namespace pw::chrono
@@ -0,0 +1,145 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/fixed_hash_map.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+// Sends every key to the same slot to exercise probing and backward shifts.
+struct CollidingHash {
+  size_t operator()(int) const { return 3; }
+};
+
+TEST(FixedHashMap, Empty) {
+  FixedHashMap<int, char, 4> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.size(), 0u);
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(FixedHashMap, InsertAndFind) {
+  FixedHashMap<uint32_t, char, 4> map;
+  auto [it, inserted] = map.insert(100, 'a');
+  ASSERT_TRUE(inserted);
+  EXPECT_EQ(it->first, 100u);
+  EXPECT_EQ(it->second, 'a');
+
+  EXPECT_TRUE(map.insert(7, 'b').second);
+  EXPECT_EQ(map.size(), 2u);
+  ASSERT_NE(map.find(7), map.end());
+  EXPECT_EQ(map.find(7)->second, 'b');
+  EXPECT_FALSE(map.contains(8));
+}
+
+TEST(FixedHashMap, InsertExistingKey_DoesNotReplace) {
+  FixedHashMap<int, char, 4> map;
+  map.insert(1, 'a');
+  auto [it, inserted] = map.insert(1, 'z');
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, 'a');
+  EXPECT_EQ(map.size(), 1u);
+
+  EXPECT_EQ(map.insert_or_assign(1, 'z')->second, 'z');
+  EXPECT_EQ(map.find(1)->second, 'z');
+}
+
+TEST(FixedHashMap, Full) {
+  FixedHashMap<int, char, 2> map;
+  EXPECT_TRUE(map.insert(1, 'a').second);
+  EXPECT_TRUE(map.insert(2, 'b').second);
+  EXPECT_TRUE(map.full());
+
+  auto [it, inserted] = map.insert(3, 'c');
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it, map.end());
+  EXPECT_EQ(map.insert_or_assign(3, 'c'), map.end());
+
+  // Existing keys can still be found and assigned.
+  EXPECT_EQ(map.insert_or_assign(2, 'x')->second, 'x');
+}
+
+TEST(FixedHashMap, Erase) {
+  FixedHashMap<int, char, 4> map;
+  map.insert(1, 'a');
+  map.insert(2, 'b');
+  map.insert(3, 'c');
+
+  EXPECT_EQ(map.erase(2), 1u);
+  EXPECT_EQ(map.erase(2), 0u);
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(map.find(1)->second, 'a');
+  EXPECT_EQ(map.find(3)->second, 'c');
+
+  EXPECT_TRUE(map.insert(4, 'd').second);
+  EXPECT_TRUE(map.insert(5, 'e').second);
+  EXPECT_TRUE(map.full());
+}
+
+TEST(FixedHashMap, Collisions_EraseKeepsOtherKeysReachable) {
+  FixedHashMap<int, int, 8, HashMapOrder::kUnordered, CollidingHash> map;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(map.insert(i, i * 10).second);
+  }
+
+  EXPECT_EQ(map.erase(0), 1u);
+  EXPECT_EQ(map.erase(4), 1u);
+  for (int i : {1, 2, 3, 5, 6, 7}) {
+    ASSERT_TRUE(map.contains(i));
+    EXPECT_EQ(map.find(i)->second, i * 10);
+  }
+
+  EXPECT_TRUE(map.insert(100, 1000).second);
+  EXPECT_EQ(map.find(100)->second, 1000);
+}
+
+TEST(FixedHashMap, InsertionOrder_IsStableAcrossErase) {
+  FixedHashMap<int, char, 8, HashMapOrder::kInsertion> map;
+  for (int key : {50, 10, 40, 20, 30}) {
+    map.insert(key, static_cast<char>('a' + key / 10));
+  }
+  map.erase(10);
+  map.erase(20);
+  map.insert(60, 'f');
+
+  const int expected[] = {50, 40, 30, 60};
+  size_t i = 0;
+  for (const auto& item : map) {
+    ASSERT_LT(i, std::size(expected));
+    EXPECT_EQ(item.first, expected[i++]);
+  }
+  EXPECT_EQ(i, std::size(expected));
+  EXPECT_EQ(map.find(30)->second, 'd');
+  EXPECT_EQ(map.find(60)->second, 'f');
+}
+
+TEST(FixedHashMap, Clear) {
+  FixedHashMap<int, char, 4> map;
+  map.insert(1, 'a');
+  map.insert(2, 'b');
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_TRUE(map.insert(1, 'c').second);
+}
+
+}  // namespace
+}  // namespace pw::containers
@@ -0,0 +1,62 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_doubly_linked_list.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::intrusive_doubly_linked_list_impl {
+
+void List::Item::CheckUnlisted() const {
+  PW_CHECK(unlisted(),
+           "Items must be removed from a pw::IntrusiveDoublyLinkedList "
+           "before they are destroyed");
+}
+
+void List::insert(Item* pos, Item& item) {
+  PW_CHECK(item.unlisted(),
+           "Cannot add an item to a pw::IntrusiveDoublyLinkedList that is "
+           "already in a list");
+  item.prev_ = pos->prev_;
+  item.next_ = pos;
+  pos->prev_->next_ = &item;
+  pos->prev_ = &item;
+  size_ += 1;
+}
+
+void List::erase(Item& item) {
+  item.prev_->next_ = item.next_;
+  item.next_->prev_ = item.prev_;
+
+  // Retain the invariant that unlisted items are self-cycles.
+  item.prev_ = &item;
+  item.next_ = &item;
+  size_ -= 1;
+}
+
+void List::clear() {
+  while (!empty()) {
+    erase(*begin());
+  }
+}
+
+bool List::remove(Item& item) {
+  if (item.unlisted()) {
+    return false;
+  }
+  erase(item);
+  return true;
+}
+
+}  // namespace pw::intrusive_doubly_linked_list_impl
@@ -0,0 +1,242 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_doubly_linked_list.h"
+
+#include <array>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveDoublyLinkedList<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+
+  // Add equality comparison to ensure comparisons are done by identity rather
+  // than equality for the remove function.
+  bool operator==(const TestItem& other) const {
+    return number_ == other.number_;
+  }
+
+ private:
+  int number_;
+};
+
+// Items are declared before their lists in these tests, so that the lists are
+// destroyed, and the items removed, first.
+
+TEST(IntrusiveDoublyLinkedList, Construct_Empty) {
+  IntrusiveDoublyLinkedList<TestItem> list;
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(list.size(), 0u);
+  EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(IntrusiveDoublyLinkedList, Construct_InitializerList) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &two, &thr});
+
+  EXPECT_EQ(list.size(), 3u);
+  auto it = list.begin();
+  EXPECT_EQ(&one, &(*it++));
+  EXPECT_EQ(&two, &(*it++));
+  EXPECT_EQ(&thr, &(*it++));
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDoublyLinkedList, Construct_ObjectIterator) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  EXPECT_EQ(list.size(), 3u);
+  EXPECT_EQ(&array.front(), &list.front());
+  EXPECT_EQ(&array.back(), &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, PushFrontAndBack) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list;
+
+  list.push_back(two);
+  list.push_front(one);
+  list.push_back(thr);
+
+  EXPECT_EQ(list.size(), 3u);
+  EXPECT_EQ(&one, &list.front());
+  EXPECT_EQ(&thr, &list.back());
+
+  int expected = 1;
+  for (const TestItem& item : list) {
+    EXPECT_EQ(item.GetNumber(), expected++);
+  }
+}
+
+TEST(IntrusiveDoublyLinkedList, PopFrontAndBack) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &two, &thr});
+
+  list.pop_front();
+  EXPECT_EQ(&two, &list.front());
+  list.pop_back();
+  EXPECT_EQ(&two, &list.back());
+  EXPECT_EQ(list.size(), 1u);
+
+  list.pop_back();
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Insert) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &thr});
+
+  auto it = list.insert(std::next(list.begin()), two);
+  EXPECT_EQ(&two, &(*it));
+  EXPECT_EQ(list.size(), 3u);
+
+  int expected = 1;
+  for (const TestItem& item : list) {
+    EXPECT_EQ(item.GetNumber(), expected++);
+  }
+}
+
+TEST(IntrusiveDoublyLinkedList, Insert_AtEnd) {
+  TestItem one(1);
+  TestItem two(2);
+  IntrusiveDoublyLinkedList<TestItem> list({&one});
+
+  list.insert(list.end(), two);
+  EXPECT_EQ(&two, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, Erase) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &two, &thr});
+
+  auto it = list.erase(std::next(list.begin()));
+  EXPECT_EQ(&thr, &(*it));
+  EXPECT_EQ(list.size(), 2u);
+
+  it = list.erase(it);
+  EXPECT_EQ(list.end(), it);
+  EXPECT_EQ(&one, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, Remove) {
+  TestItem one(1);
+  TestItem two(1);  // Equal to one, but a different item.
+  TestItem thr(3);
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &two, &thr});
+
+  EXPECT_TRUE(list.remove(two));
+  EXPECT_FALSE(list.remove(two));
+  EXPECT_EQ(list.size(), 2u);
+  EXPECT_EQ(&one, &list.front());
+  EXPECT_EQ(&thr, &list.back());
+
+  // Removed items may be added again.
+  list.push_back(two);
+  EXPECT_EQ(&two, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, Remove_OnlyItem) {
+  TestItem one(1);
+  IntrusiveDoublyLinkedList<TestItem> list({&one});
+
+  EXPECT_TRUE(list.remove(one));
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(IntrusiveDoublyLinkedList, Clear) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  list.clear();
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(list.size(), 0u);
+
+  // Cleared items may be added to another list.
+  IntrusiveDoublyLinkedList<TestItem> other(array.begin(), array.end());
+  EXPECT_EQ(other.size(), 3u);
+}
+
+TEST(IntrusiveDoublyLinkedList, Destruct_RemovesItems) {
+  TestItem one(1);
+  {
+    IntrusiveDoublyLinkedList<TestItem> list({&one});
+  }
+  IntrusiveDoublyLinkedList<TestItem> list({&one});
+  EXPECT_EQ(&one, &list.front());
+}
+
+TEST(IntrusiveDoublyLinkedList, IterateBackward) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  int expected = 3;
+  for (auto it = list.rbegin(); it != list.rend(); ++it) {
+    EXPECT_EQ(it->GetNumber(), expected--);
+  }
+  EXPECT_EQ(expected, 0);
+
+  auto it = list.end();
+  EXPECT_EQ((--it)->GetNumber(), 3);
+  EXPECT_EQ((it--)->GetNumber(), 3);
+  EXPECT_EQ(it->GetNumber(), 2);
+}
+
+TEST(IntrusiveDoublyLinkedList, ConstIteration) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  const IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  int expected = 1;
+  for (auto it = list.cbegin(); it != list.cend(); ++it) {
+    EXPECT_EQ(it->GetNumber(), expected++);
+  }
+  EXPECT_EQ(list.front().GetNumber(), 1);
+  EXPECT_EQ(list.back().GetNumber(), 3);
+  EXPECT_EQ(list.crbegin()->GetNumber(), 3);
+}
+
+// Test that a list of items derived from a different Item class can be created.
+class DerivedTestItem : public TestItem {};
+
+TEST(IntrusiveDoublyLinkedList, AddItemsOfDerivedClassToList) {
+  DerivedTestItem item1;
+  TestItem item2;
+  IntrusiveDoublyLinkedList<TestItem> list;
+
+  list.push_front(item1);
+  list.push_front(item2);
+  EXPECT_EQ(list.size(), 2u);
+}
+
+}  // namespace
+}  // namespace pw
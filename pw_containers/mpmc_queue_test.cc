@@ -0,0 +1,108 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/mpmc_queue.h"
+
+#include "gtest/gtest.h"
+#include "pw_containers/blocking_mpmc_queue.h"
+
+namespace pw::containers {
+namespace {
+
+// Counts live instances to check that items are destroyed.
+struct Counted {
+  Counted(int v) : value(v) { live += 1; }
+  Counted(Counted&& other) : value(other.value) { live += 1; }
+  ~Counted() { live -= 1; }
+
+  int value;
+  static int live;
+};
+
+int Counted::live = 0;
+
+TEST(MpmcQueue, Empty) {
+  MpmcQueue<int, 4> queue;
+  EXPECT_EQ(queue.capacity(), 4u);
+  EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(MpmcQueue, PushPop_Fifo) {
+  MpmcQueue<int, 4> queue;
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_TRUE(queue.try_push(3));
+
+  EXPECT_EQ(queue.try_pop(), 1);
+  EXPECT_EQ(queue.try_pop(), 2);
+  EXPECT_EQ(queue.try_pop(), 3);
+  EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(MpmcQueue, Full) {
+  MpmcQueue<int, 2> queue;
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_FALSE(queue.try_push(3));
+
+  EXPECT_EQ(queue.try_pop(), 1);
+  EXPECT_TRUE(queue.try_push(3));
+  EXPECT_EQ(queue.try_pop(), 2);
+  EXPECT_EQ(queue.try_pop(), 3);
+}
+
+TEST(MpmcQueue, WrapsAround) {
+  MpmcQueue<int, 4> queue;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+    ASSERT_TRUE(queue.try_push(i + 1000));
+    ASSERT_EQ(queue.try_pop(), i);
+    ASSERT_EQ(queue.try_pop(), i + 1000);
+  }
+}
+
+TEST(MpmcQueue, DestroysItems) {
+  {
+    MpmcQueue<Counted, 4> queue;
+    ASSERT_TRUE(queue.try_emplace(1));
+    ASSERT_TRUE(queue.try_emplace(2));
+    ASSERT_TRUE(queue.try_emplace(3));
+    EXPECT_EQ(Counted::live, 3);
+
+    std::optional<Counted> item = queue.try_pop();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(item->value, 1);
+    EXPECT_EQ(Counted::live, 3);
+  }
+  EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(BlockingMpmcQueue, TryPopUntil_Empty_TimesOut) {
+  BlockingMpmcQueue<int, 2> queue;
+  EXPECT_FALSE(queue.try_pop_until(chrono::SystemClock::now()).has_value());
+}
+
+TEST(BlockingMpmcQueue, TryPopUntil_ReturnsItemsInOrder) {
+  BlockingMpmcQueue<int, 2> queue;
+  ASSERT_TRUE(queue.try_push(1));
+  ASSERT_TRUE(queue.try_push(2));
+
+  const auto deadline = chrono::SystemClock::now();
+  EXPECT_EQ(queue.try_pop_until(deadline), 1);
+  EXPECT_EQ(queue.try_pop_until(deadline), 2);
+  EXPECT_FALSE(queue.try_pop_until(deadline).has_value());
+}
+
+}  // namespace
+}  // namespace pw::containers
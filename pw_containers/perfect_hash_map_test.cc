@@ -0,0 +1,130 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_containers/perfect_hash_map.h"
+
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+constexpr PerfectHashMap<int, char, 5> kOddMap({{
+    {-3, 'a'},
+    {0, 'b'},
+    {1, 'c'},
+    {50, 'd'},
+    {100, 'e'},
+}});
+
+static_assert(kOddMap.find(50)->second == 'd');
+static_assert(!kOddMap.contains(2));
+
+TEST(PerfectHashMap, Size) {
+  EXPECT_EQ(kOddMap.size(), 5u);
+  EXPECT_FALSE(kOddMap.empty());
+}
+
+TEST(PerfectHashMap, Empty) {
+  constexpr PerfectHashMap<int, char, 0> kEmpty({});
+  EXPECT_TRUE(kEmpty.empty());
+  EXPECT_EQ(kEmpty.find(0), kEmpty.end());
+  EXPECT_EQ(kEmpty.begin(), kEmpty.end());
+}
+
+TEST(PerfectHashMap, Find) {
+  EXPECT_EQ(kOddMap.find(-3)->second, 'a');
+  EXPECT_EQ(kOddMap.find(0)->second, 'b');
+  EXPECT_EQ(kOddMap.find(1)->second, 'c');
+  EXPECT_EQ(kOddMap.find(50)->second, 'd');
+  EXPECT_EQ(kOddMap.find(100)->second, 'e');
+}
+
+TEST(PerfectHashMap, FindMissingKeys) {
+  for (int key : {-4, -1, 2, 3, 49, 51, 99, 101, 1000}) {
+    EXPECT_EQ(kOddMap.find(key), kOddMap.end());
+    EXPECT_FALSE(kOddMap.contains(key));
+  }
+}
+
+TEST(PerfectHashMap, IteratesInInitializationOrder) {
+  const char* expected = "abcde";
+  for (const auto& item : kOddMap) {
+    EXPECT_EQ(item.second, *expected++);
+  }
+}
+
+enum class Register : uint8_t { kStatus = 0x01, kControl = 0x10, kData = 0x7f };
+
+TEST(PerfectHashMap, EnumKeys) {
+  constexpr PerfectHashMap<Register, size_t, 3> kWidths({{
+      {Register::kStatus, 1},
+      {Register::kControl, 2},
+      {Register::kData, 4},
+  }});
+  EXPECT_EQ(kWidths.find(Register::kControl)->second, 2u);
+  EXPECT_EQ(kWidths.find(Register::kData)->second, 4u);
+  EXPECT_FALSE(kWidths.contains(static_cast<Register>(0x02)));
+}
+
+struct Fnv1aHash {
+  constexpr uint64_t operator()(std::string_view key) const {
+    uint64_t hash = 0xcbf29ce484222325u;
+    for (char c : key) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3u;
+    }
+    return hash;
+  }
+};
+
+TEST(PerfectHashMap, CustomHash) {
+  constexpr PerfectHashMap<std::string_view, int, 4, Fnv1aHash> kNames({{
+      {"one", 1},
+      {"two", 2},
+      {"three", 3},
+      {"four", 4},
+  }});
+  static_assert(kNames.find("three")->second == 3);
+  EXPECT_EQ(kNames.find("one")->second, 1);
+  EXPECT_EQ(kNames.find("four")->second, 4);
+  EXPECT_FALSE(kNames.contains("five"));
+  EXPECT_FALSE(kNames.contains(""));
+}
+
+constexpr size_t kManyKeys = 300;
+
+constexpr auto MakeItems() {
+  std::array<PerfectHashMap<uint32_t, uint32_t, kManyKeys>::value_type,
+             kManyKeys>
+      items{};
+  for (uint32_t i = 0; i < kManyKeys; ++i) {
+    items[i] = {i * 0x9e3779b9u, i};
+  }
+  return items;
+}
+
+constexpr PerfectHashMap<uint32_t, uint32_t, kManyKeys> kManyItems(
+    MakeItems());
+
+TEST(PerfectHashMap, ManyKeys) {
+  for (uint32_t i = 0; i < kManyKeys; ++i) {
+    auto it = kManyItems.find(i * 0x9e3779b9u);
+    ASSERT_NE(it, kManyItems.end());
+    EXPECT_EQ(it->second, i);
+    EXPECT_FALSE(kManyItems.contains(i * 0x9e3779b9u + 1));
+  }
+}
+
+}  // namespace
+}  // namespace pw::containers
@@ -0,0 +1,106 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/mpmc_queue.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_thread/yield.h"
+
+namespace pw::containers {
+
+// An MpmcQueue whose consumers can block until an item is available. A
+// counting semaphore tracks the number of pushed items.
+//
+// Pushing never blocks and is interrupt safe, like MpmcQueue::try_push().
+// Popping must be done from threads.
+template <typename T, size_t kCapacity>
+class BlockingMpmcQueue {
+ public:
+  static_assert(
+      kCapacity <= static_cast<size_t>(sync::CountingSemaphore::max()),
+      "The capacity must fit in the counting semaphore");
+
+  BlockingMpmcQueue() = default;
+
+  BlockingMpmcQueue(const BlockingMpmcQueue&) = delete;
+  BlockingMpmcQueue& operator=(const BlockingMpmcQueue&) = delete;
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  // Adds an item and wakes one waiting consumer. Returns false if the queue is
+  // full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    if (!queue_.try_emplace(std::forward<Args>(args)...)) {
+      return false;
+    }
+    available_.release();
+    return true;
+  }
+
+  bool try_push(const T& item) { return try_emplace(item); }
+  bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+  // Blocks until an item is available and removes it.
+  T pop() {
+    available_.acquire();
+    return Take();
+  }
+
+  // Removes an item if one is available without blocking.
+  std::optional<T> try_pop() {
+    if (!available_.try_acquire()) {
+      return std::nullopt;
+    }
+    return Take();
+  }
+
+  // Waits up to the timeout for an item and removes it.
+  std::optional<T> try_pop_for(chrono::SystemClock::duration timeout) {
+    if (!available_.try_acquire_for(timeout)) {
+      return std::nullopt;
+    }
+    return Take();
+  }
+
+  // Waits until the deadline for an item and removes it.
+  std::optional<T> try_pop_until(chrono::SystemClock::time_point deadline) {
+    if (!available_.try_acquire_until(deadline)) {
+      return std::nullopt;
+    }
+    return Take();
+  }
+
+ private:
+  // The semaphore guarantees an item was pushed, but its cell may come after
+  // one that an earlier producer is still filling. Yield until it is done.
+  T Take() {
+    while (true) {
+      if (std::optional<T> item = queue_.try_pop(); item.has_value()) {
+        return std::move(*item);
+      }
+      this_thread::yield();
+    }
+  }
+
+  MpmcQueue<T, kCapacity> queue_;
+  sync::CountingSemaphore available_;
+};
+
+}  // namespace pw::containers
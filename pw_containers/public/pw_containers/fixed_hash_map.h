@@ -0,0 +1,232 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "pw_containers/vector.h"
+
+namespace pw::containers {
+
+// Controls the iteration order of a FixedHashMap.
+enum class HashMapOrder {
+  // Items are iterated in an unspecified order. Erasing moves the last item
+  // into the erased item's place, which is O(1).
+  kUnordered,
+
+  // Items are iterated in insertion order. Erasing shifts later items down,
+  // which is O(N).
+  kInsertion,
+};
+
+// A mutable, fixed-capacity hash map that never allocates.
+//
+// Items are stored contiguously, so iteration is as fast as iterating an array.
+// Lookups use a separate open-addressing table with linear probing. The table
+// has at least twice as many slots as the map's capacity, which keeps probe
+// sequences short. Erasing uses backward-shift deletion, so the table never
+// fills up with tombstones.
+//
+//   FixedHashMap<uint32_t, Route*, 16> routes;
+//   routes.insert(address, &route);
+//   if (auto it = routes.find(address); it != routes.end()) { ... }
+//
+// Keys must not be modified through iterators.
+template <typename Key,
+          typename Value,
+          size_t kCapacity,
+          HashMapOrder kOrder = HashMapOrder::kUnordered,
+          typename Hash = std::hash<Key>>
+class FixedHashMap {
+ public:
+  struct value_type {
+    Key first;
+    Value second;
+  };
+
+  using key_type = Key;
+  using mapped_type = Value;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  static_assert(kCapacity > 0u, "FixedHashMap must have a nonzero capacity");
+
+  FixedHashMap() { slots_.fill(kEmptySlot); }
+
+  FixedHashMap(const FixedHashMap&) = delete;
+  FixedHashMap& operator=(const FixedHashMap&) = delete;
+
+  // Capacity.
+  size_type size() const { return items_.size(); }
+  [[nodiscard]] bool empty() const { return items_.empty(); }
+  [[nodiscard]] bool full() const { return items_.full(); }
+  static constexpr size_type max_size() { return kCapacity; }
+
+  // Iterators.
+  iterator begin() { return items_.begin(); }
+  const_iterator begin() const { return items_.begin(); }
+  const_iterator cbegin() const { return items_.cbegin(); }
+  iterator end() { return items_.end(); }
+  const_iterator end() const { return items_.end(); }
+  const_iterator cend() const { return items_.cend(); }
+
+  // Lookup.
+  iterator find(const key_type& key) {
+    const size_t slot = FindSlot(key);
+    return slots_[slot] == kEmptySlot ? end() : &items_[slots_[slot]];
+  }
+
+  const_iterator find(const key_type& key) const {
+    return const_cast<FixedHashMap*>(this)->find(key);
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+
+  // Modifiers.
+
+  // Inserts the item if the key is not already present. Returns an iterator to
+  // the item with the key and whether the item was inserted. Returns
+  // {end(), false} if the key is new but the map is full.
+  std::pair<iterator, bool> insert(const key_type& key,
+                                   const mapped_type& value) {
+    const size_t slot = FindSlot(key);
+    if (slots_[slot] != kEmptySlot) {
+      return {&items_[slots_[slot]], false};
+    }
+    if (full()) {
+      return {end(), false};
+    }
+    slots_[slot] = static_cast<Index>(items_.size());
+    items_.push_back(value_type{key, value});
+    return {&items_.back(), true};
+  }
+
+  // Inserts the item, or replaces the value if the key is already present.
+  // Returns end() if the key is new but the map is full.
+  iterator insert_or_assign(const key_type& key, const mapped_type& value) {
+    auto [it, inserted] = insert(key, value);
+    if (!inserted && it != end()) {
+      it->second = value;
+    }
+    return it;
+  }
+
+  // Removes the item with the key, if present. Returns the number of items
+  // removed (0 or 1). Invalidates iterators to the erased item and, for
+  // HashMapOrder::kInsertion, to all later items.
+  size_type erase(const key_type& key) {
+    const size_t slot = FindSlot(key);
+    if (slots_[slot] == kEmptySlot) {
+      return 0;
+    }
+    const Index index = slots_[slot];
+    RemoveSlot(slot);
+    RemoveItem(index);
+    return 1;
+  }
+
+  void clear() {
+    items_.clear();
+    slots_.fill(kEmptySlot);
+  }
+
+ private:
+  // Use a power of two at least twice the capacity so the load factor never
+  // exceeds 0.5 and slots can be selected with a mask.
+  static constexpr size_t TableSize() {
+    size_t size = 1;
+    while (size < 2 * kCapacity) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  static constexpr size_t kTableSize = TableSize();
+  static constexpr size_t kMask = kTableSize - 1;
+
+  // Slots store indices into items_. Use the smallest type that fits.
+  using Index = std::conditional_t<
+      (kCapacity < std::numeric_limits<uint8_t>::max()),
+      uint8_t,
+      std::conditional_t<(kCapacity < std::numeric_limits<uint16_t>::max()),
+                         uint16_t,
+                         size_t>>;
+
+  static constexpr Index kEmptySlot = std::numeric_limits<Index>::max();
+
+  static size_t HomeSlot(const key_type& key) {
+    return static_cast<size_t>(Hash{}(key)) & kMask;
+  }
+
+  // Returns the slot holding the key, or the empty slot that ends its probe
+  // sequence. There is always an empty slot since the table is never full.
+  size_t FindSlot(const key_type& key) const {
+    size_t slot = HomeSlot(key);
+    while (slots_[slot] != kEmptySlot && !(items_[slots_[slot]].first == key)) {
+      slot = (slot + 1) & kMask;
+    }
+    return slot;
+  }
+
+  // Empties a slot, then moves later entries in the same probe run back so
+  // that every key stays reachable from its home slot.
+  void RemoveSlot(size_t hole) {
+    for (size_t slot = (hole + 1) & kMask; slots_[slot] != kEmptySlot;
+         slot = (slot + 1) & kMask) {
+      const size_t home = HomeSlot(items_[slots_[slot]].first);
+      // The entry can fill the hole if its home is not in (hole, slot].
+      if (((slot - home) & kMask) >= ((slot - hole) & kMask)) {
+        slots_[hole] = slots_[slot];
+        hole = slot;
+      }
+    }
+    slots_[hole] = kEmptySlot;
+  }
+
+  // Removes items_[index], whose slot has already been removed, and updates
+  // the slots of any items that move.
+  void RemoveItem(Index index) {
+    const Index last = static_cast<Index>(items_.size() - 1);
+
+    if constexpr (kOrder == HashMapOrder::kUnordered) {
+      if (index != last) {
+        slots_[FindSlot(items_[last].first)] = index;
+        items_[index] = std::move(items_[last]);
+      }
+    } else {
+      for (Index i = index; i < last; ++i) {
+        items_[i] = std::move(items_[i + 1]);
+      }
+      for (Index& slot : slots_) {
+        if (slot != kEmptySlot && slot > index) {
+          slot -= 1;
+        }
+      }
+    }
+    items_.pop_back();
+  }
+
+  Vector<value_type, kCapacity> items_;
+  std::array<Index, kTableSize> slots_;
+};
+
+}  // namespace pw::containers
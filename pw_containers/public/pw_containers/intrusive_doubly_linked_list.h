@@ -0,0 +1,194 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_doubly_linked_list_impl.h"
+
+namespace pw {
+
+// IntrusiveDoublyLinkedList is a doubly-linked variant of IntrusiveList. Each
+// item stores pointers to both of its neighbors, and the list tracks its last
+// item and its size, so inserting or removing anywhere, push_back(), back(),
+// and size() are all O(1). The API follows std::list.
+//
+// In exchange for the O(1) size(), items must be removed from their list before
+// they are destroyed; destroying a listed item is a checked error. Destroying
+// the list removes all of its items.
+//
+// Usage:
+//
+//   class TestItem
+//      : public IntrusiveDoublyLinkedList<TestItem>::Item {}
+//
+//   IntrusiveDoublyLinkedList<TestItem> test_items;
+//
+//   auto item = TestItem();
+//   test_items.push_back(item);
+//
+//   for (auto& test_item : test_items) {
+//     // Do a thing.
+//   }
+//
+//   test_items.remove(item);
+//
+template <typename T>
+class IntrusiveDoublyLinkedList {
+ public:
+  class Item : public intrusive_doubly_linked_list_impl::List::Item {
+   public:
+    Item(const Item&) = delete;
+    Item& operator=(const Item&) = delete;
+
+   protected:
+    constexpr Item() = default;
+
+   private:
+    // GetListElementTypeFromItem is used to find the element type from an item.
+    // It is used to ensure list items inherit from the correct Item type.
+    template <typename, bool>
+    friend struct intrusive_doubly_linked_list_impl::GetListElementTypeFromItem;
+
+    using PwIntrusiveDoublyLinkedListElementType = T;
+  };
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = intrusive_doubly_linked_list_impl::Iterator<T, Item>;
+  using const_iterator =
+      intrusive_doubly_linked_list_impl::Iterator<std::add_const_t<T>,
+                                                  const Item>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr IntrusiveDoublyLinkedList() { CheckItemType(); }
+
+  // Constructs an IntrusiveDoublyLinkedList from an iterator over Items. The
+  // iterator may dereference as either Item& (e.g. from std::array<Item>) or
+  // Item* (e.g. from std::initializer_list<Item*>).
+  template <typename Iterator>
+  IntrusiveDoublyLinkedList(Iterator first, Iterator last)
+      : list_(first, last) {
+    CheckItemType();
+  }
+
+  // Constructs an IntrusiveDoublyLinkedList from a std::initializer_list of
+  // pointers to items.
+  IntrusiveDoublyLinkedList(std::initializer_list<Item*> items)
+      : IntrusiveDoublyLinkedList(items.begin(), items.end()) {}
+
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    list_.assign(first, last);
+  }
+
+  void assign(std::initializer_list<Item*> items) {
+    list_.assign(items.begin(), items.end());
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return list_.empty(); }
+
+  // Operation is O(1).
+  size_t size() const noexcept { return list_.size(); }
+
+  void push_front(T& item) { list_.insert(list_.begin(), item); }
+
+  void push_back(T& item) { list_.insert(list_.end(), item); }
+
+  // Inserts item before pos. Returns an iterator to the inserted item.
+  iterator insert(iterator pos, T& item) {
+    list_.insert(pos.item_, item);
+    return iterator(&item);
+  }
+
+  // Removes the first item in the list. The list must not be empty.
+  void pop_front() { list_.erase(*list_.begin()); }
+
+  // Removes the last item in the list. The list must not be empty.
+  void pop_back() { list_.erase(*list_.last()); }
+
+  // Removes the item at pos from the list. The item is not destructed. Returns
+  // an iterator to the following item.
+  iterator erase(iterator pos) {
+    iterator next = std::next(pos);
+    list_.erase(*pos.item_);
+    return next;
+  }
+
+  // Removes all items from the list. The items themselves are not destructed.
+  void clear() { list_.clear(); }
+
+  // Removes this specific item from the list, if it is present. Returns true
+  // if the item was removed; false if it was not in a list. The item must be in
+  // this list or in no list at all. Operation is O(1).
+  bool remove(T& item) { return list_.remove(item); }
+
+  // Reference to the first element in the list. Undefined behavior if empty().
+  T& front() { return *static_cast<T*>(list_.begin()); }
+  const T& front() const { return *static_cast<const T*>(list_.begin()); }
+
+  // Reference to the last element in the list. Undefined behavior if empty().
+  T& back() { return *static_cast<T*>(list_.last()); }
+  const T& back() const { return *static_cast<const T*>(list_.last()); }
+
+  iterator begin() noexcept {
+    return iterator(static_cast<Item*>(list_.begin()));
+  }
+  const_iterator begin() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.begin()));
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(static_cast<Item*>(list_.end())); }
+  const_iterator end() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.end()));
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveDoublyLinkedList<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    using ElementType =
+        intrusive_doubly_linked_list_impl::ElementTypeFromItem<T>;
+    static_assert(
+        std::is_base_of<ElementType, T>(),
+        "IntrusiveDoublyLinkedList items must be derived from "
+        "IntrusiveDoublyLinkedList<T>::Item, where T is the item or one of its "
+        "bases.");
+  }
+
+  intrusive_doubly_linked_list_impl::List list_;
+};
+
+}  // namespace pw
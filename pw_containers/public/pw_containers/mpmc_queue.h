@@ -0,0 +1,141 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pw::containers {
+
+// A bounded multi-producer, multi-consumer queue that does not use locks.
+//
+// This is Dmitry Vyukov's bounded MPMC queue. Each cell has a sequence number
+// that tells producers and consumers whether it is free or full for their
+// position, so each operation only needs one compare-and-swap on a shared
+// position counter. try_push() and try_pop() never block and may be called
+// from interrupts, provided the target supports lock-free std::atomic<size_t>
+// compare-and-swap.
+//
+// A consumer may briefly see the queue as empty while an earlier producer is
+// still copying its item into the queue, even though a later push finished.
+// Likewise, a producer may see the queue as full while an earlier consumer is
+// still copying an item out.
+//
+// kCapacity must be a power of two.
+template <typename T, size_t kCapacity>
+class MpmcQueue {
+ public:
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "MpmcQueue capacity must be a power of two");
+
+  MpmcQueue() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  ~MpmcQueue() {
+    while (try_pop().has_value()) {
+    }
+  }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  // Constructs an item at the back of the queue. Returns false if the queue is
+  // full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+      cell = &cells_[position & kMask];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const ptrdiff_t difference = static_cast<ptrdiff_t>(sequence - position);
+
+      if (difference == 0) {
+        // The cell is free for this position; try to claim it.
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;  // The cell still holds an item from the last lap.
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (&cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T& item) { return try_emplace(item); }
+  bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+  // Removes the item at the front of the queue, or returns std::nullopt if the
+  // queue is empty.
+  std::optional<T> try_pop() {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+      cell = &cells_[position & kMask];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const ptrdiff_t difference =
+          static_cast<ptrdiff_t>(sequence - (position + 1));
+
+      if (difference == 0) {
+        // The cell is full for this position; try to claim it.
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return std::nullopt;  // The cell has not been filled yet.
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    T* item = std::launder(reinterpret_cast<T*>(&cell->storage));
+    std::optional<T> result(std::move(*item));
+    item->~T();
+    cell->sequence.store(position + kCapacity, std::memory_order_release);
+    return result;
+  }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+  };
+
+  std::array<Cell, kCapacity> cells_;
+  std::atomic<size_t> enqueue_position_ = 0;
+  std::atomic<size_t> dequeue_position_ = 0;
+};
+
+}  // namespace pw::containers
@@ -0,0 +1,237 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "pw_assert/assert.h"
+
+namespace pw::containers {
+
+// Converts integer and enum keys to the uint64_t a PerfectHashMap hashes. The
+// map mixes the result, so custom hash functions need not be uniform, only
+// constexpr and distinct for distinct keys.
+template <typename Key>
+struct PerfectHashKey {
+  constexpr uint64_t operator()(const Key& key) const {
+    return static_cast<uint64_t>(key);
+  }
+};
+
+// A fixed-size, immutable associative array with a collision-free hash table
+// that is built when the map is constructed. Like FlatMap, it is initialized
+// with a std::array of items:
+//
+//   constexpr PerfectHashMap<uint32_t, Handler, 3> kHandlers({{
+//       {0x1234, HandleFoo},
+//       {0x5678, HandleBar},
+//       {0x9abc, HandleBaz},
+//   }});
+//
+// Lookups hash the key once, read one displacement and one slot, and compare
+// one key, regardless of the map's size. When the map is constexpr, the table
+// is built entirely at compile time.
+//
+// The table uses "hash and displace": keys are grouped into buckets by hash,
+// and each bucket stores a displacement that places all of its keys into
+// distinct, unused slots. The slot table has one entry per key rounded up to a
+// power of two, and one displacement is stored for every two keys, so the
+// overhead is a few bytes per item. Building the table takes roughly linear
+// time in the number of keys, but constexpr evaluation limits make this best
+// suited to maps of up to a few hundred items.
+//
+// Keys must be unique. Duplicate keys fail an assert, which is a compile error
+// when the map is constexpr. Items are iterated in the order they were given.
+template <typename Key,
+          typename Value,
+          size_t kSize,
+          typename Hash = PerfectHashKey<Key>>
+class PerfectHashMap {
+ public:
+  struct value_type {
+    Key first;
+    Value second;
+  };
+
+  using key_type = Key;
+  using mapped_type = Value;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using container_type = std::array<value_type, kSize>;
+  using const_iterator = typename container_type::const_iterator;
+
+  constexpr PerfectHashMap(const container_type& items)
+      : items_(items), displacements_{}, slots_{} {
+    Build();
+  }
+
+  PerfectHashMap(PerfectHashMap&) = delete;
+  PerfectHashMap& operator=(PerfectHashMap&) = delete;
+
+  // Capacity.
+  constexpr size_type size() const { return kSize; }
+  constexpr bool empty() const { return size() == 0; }
+  constexpr size_type max_size() const { return kSize; }
+
+  // Lookup.
+  constexpr bool contains(const key_type& key) const {
+    return find(key) != end();
+  }
+
+  constexpr const_iterator find(const key_type& key) const {
+    const uint64_t hash = Mix(Hash{}(key));
+    const Index index = slots_[SlotFor(hash, displacements_[BucketFor(hash)])];
+    if (index == kEmptySlot || !(items_[index].first == key)) {
+      return end();
+    }
+    return begin() + index;
+  }
+
+  // Iterators.
+  constexpr const_iterator begin() const { return cbegin(); }
+  constexpr const_iterator cbegin() const { return items_.cbegin(); }
+  constexpr const_iterator end() const { return cend(); }
+  constexpr const_iterator cend() const { return items_.cend(); }
+
+ private:
+  static constexpr size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+      result *= 2;
+    }
+    return result;
+  }
+
+  static constexpr size_t kSlotCount = RoundUpToPowerOfTwo(kSize);
+  static constexpr size_t kBucketCount = RoundUpToPowerOfTwo((kSize + 1) / 2);
+
+  // The largest displacement tried for a bucket before giving up.
+  static constexpr uint16_t kMaxDisplacement = 0xffff;
+
+  using Index = std::conditional_t<
+      (kSize < 0xff),
+      uint8_t,
+      std::conditional_t<(kSize < 0xffff), uint16_t, uint32_t>>;
+
+  static constexpr Index kEmptySlot = static_cast<Index>(kSize);
+
+  // SplitMix64 finalizer.
+  static constexpr uint64_t Mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9u;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebu;
+    return value ^ (value >> 31);
+  }
+
+  static constexpr size_t BucketFor(uint64_t hash) {
+    return static_cast<size_t>(hash) & (kBucketCount - 1);
+  }
+
+  static constexpr size_t SlotFor(uint64_t hash, uint16_t displacement) {
+    return static_cast<size_t>(Mix(hash ^ displacement)) & (kSlotCount - 1);
+  }
+
+  constexpr void Build() {
+    for (Index& slot : slots_) {
+      slot = kEmptySlot;
+    }
+    if constexpr (kSize == 0u) {
+      return;
+    } else {
+      // Group the keys into buckets with singly linked lists of item indices.
+      std::array<uint64_t, kSize> hashes{};
+      std::array<Index, kSize> next{};
+      std::array<Index, kBucketCount> heads{};
+      std::array<size_t, kBucketCount> bucket_sizes{};
+      std::array<size_t, kBucketCount> order{};
+
+      for (size_t i = 0; i < kBucketCount; ++i) {
+        heads[i] = kEmptySlot;
+        order[i] = i;
+      }
+      for (size_t i = 0; i < kSize; ++i) {
+        hashes[i] = Mix(Hash{}(items_[i].first));
+        const size_t bucket = BucketFor(hashes[i]);
+        next[i] = heads[bucket];
+        heads[bucket] = static_cast<Index>(i);
+        bucket_sizes[bucket] += 1;
+      }
+
+      // Place the largest buckets first, while the table is mostly empty.
+      for (size_t i = 1; i < kBucketCount; ++i) {
+        for (size_t j = i; j > 0 && bucket_sizes[order[j - 1]] <
+                                        bucket_sizes[order[j]];
+             --j) {
+          const size_t temp = order[j];
+          order[j] = order[j - 1];
+          order[j - 1] = temp;
+        }
+      }
+
+      for (size_t bucket : order) {
+        if (bucket_sizes[bucket] == 0u) {
+          break;
+        }
+        displacements_[bucket] = PlaceBucket(hashes, next, heads[bucket]);
+      }
+    }
+  }
+
+  // Finds a displacement that puts every item in the bucket into an unused
+  // slot, and fills those slots.
+  template <typename Hashes, typename Next>
+  constexpr uint16_t PlaceBucket(const Hashes& hashes,
+                                 const Next& next,
+                                 Index head) {
+    // Keys with identical hashes can never be separated. This catches
+    // duplicate keys as well as hash functions that are not injective.
+    for (Index i = head; i != kEmptySlot; i = next[i]) {
+      for (Index j = next[i]; j != kEmptySlot; j = next[j]) {
+        PW_ASSERT(hashes[i] != hashes[j]);
+      }
+    }
+
+    for (uint32_t displacement = 0; displacement <= kMaxDisplacement;
+         ++displacement) {
+      const uint16_t d = static_cast<uint16_t>(displacement);
+      Index placed = head;
+      for (; placed != kEmptySlot; placed = next[placed]) {
+        Index& slot = slots_[SlotFor(hashes[placed], d)];
+        if (slot != kEmptySlot) {
+          break;
+        }
+        slot = placed;
+      }
+      if (placed == kEmptySlot) {
+        return d;
+      }
+
+      // Release the slots claimed before the collision and try again.
+      for (Index i = head; i != placed; i = next[i]) {
+        slots_[SlotFor(hashes[i], d)] = kEmptySlot;
+      }
+    }
+
+    PW_ASSERT(false);  // No displacement places this bucket.
+    return 0;
+  }
+
+  container_type items_;
+  std::array<uint16_t, kBucketCount> displacements_;
+  std::array<Index, kSlotCount> slots_;
+};
+
+}  // namespace pw::containers
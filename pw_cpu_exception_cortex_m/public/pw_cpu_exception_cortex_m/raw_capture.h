@@ -0,0 +1,63 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+#include "pw_status/status.h"
+
+namespace pw::cpu_exception::cortex_m {
+
+// Fixed-layout header of a raw crash capture. It is followed in the capture
+// buffer by stack_size_bytes bytes of the main stack, starting at the stack
+// pointer.
+struct RawCaptureHeader {
+  static constexpr uint32_t kMagic = 0x43525743;  // "CWRC"
+
+  uint32_t magic;
+  uint32_t stack_low_addr;
+  uint32_t stack_high_addr;
+  uint32_t stack_pointer;
+  uint32_t stack_size_bytes;
+  pw_cpu_exception_State cpu_state;
+};
+
+// Copies the CPU state and as much of the main stack as fits into capture,
+// typically a buffer in persistent memory. This is intended to run in the
+// fault handler: it only copies memory, and leaves proto encoding to
+// SnapshotRawCapture() on a later boot.
+//
+// The main stack is only captured if it was active when the exception
+// occurred. If the stack does not fit, the bytes nearest the stack pointer are
+// kept.
+//
+// Returns:
+//   OK - The capture was written.
+//   RESOURCE_EXHAUSTED - capture is too small for RawCaptureHeader.
+Status CaptureRaw(const pw_cpu_exception_State& cpu_state,
+                  uintptr_t stack_low_addr,
+                  uintptr_t stack_high_addr,
+                  ByteSpan capture);
+
+// Returns whether capture holds a complete raw capture.
+bool HasRawCapture(ConstByteSpan capture);
+
+// Invalidates the raw capture in capture, for example once it has been
+// converted to a snapshot.
+void ClearRawCapture(ByteSpan capture);
+
+}  // namespace pw::cpu_exception::cortex_m
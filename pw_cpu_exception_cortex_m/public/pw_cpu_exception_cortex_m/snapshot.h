@@ -15,6 +15,7 @@
 
 #include <cstdint>
 
+#include "pw_bytes/span.h"
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
 #include "pw_protobuf/encoder.h"
@@ -74,4 +75,19 @@ inline Status SnapshotMainStackThread(
       stack_low_addr, stack_high_addr, encoder, thread_stack_callback);
 }
 
+// Converts a raw capture written by CaptureRaw() during an earlier boot into
+// the pw.cpu_exception.cortex_m.ArmV7mCpuState proto field and, if the main
+// stack was captured, a main stack thread. The stack bytes passed to
+// thread_stack_callback come from the capture rather than live memory.
+//
+// Returns:
+//   OK - The capture was converted.
+//   NOT_FOUND - capture does not hold a valid raw capture.
+//   Other statuses from the encoders or thread_stack_callback.
+Status SnapshotRawCapture(
+    ConstByteSpan capture,
+    SnapshotCpuStateOverlay::StreamEncoder& cpu_state_encoder,
+    thread::SnapshotThreadInfo::StreamEncoder& thread_encoder,
+    thread::ProcessThreadStackCallback& thread_stack_callback);
+
 }  // namespace pw::cpu_exception::cortex_m
@@ -0,0 +1,73 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/raw_capture.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_cpu_exception_cortex_m/util.h"
+
+namespace pw::cpu_exception::cortex_m {
+
+Status CaptureRaw(const pw_cpu_exception_State& cpu_state,
+                  uintptr_t stack_low_addr,
+                  uintptr_t stack_high_addr,
+                  ByteSpan capture) {
+  if (capture.size() < sizeof(RawCaptureHeader)) {
+    return Status::ResourceExhausted();
+  }
+
+  RawCaptureHeader header = {};
+  header.stack_low_addr = stack_low_addr;
+  header.stack_high_addr = stack_high_addr;
+  header.stack_pointer = cpu_state.extended.msp;
+  header.cpu_state = cpu_state;
+
+  const uintptr_t stack_pointer = cpu_state.extended.msp;
+  if (MainStackActive(cpu_state) && stack_pointer <= stack_high_addr) {
+    const size_t stack_size =
+        std::min(stack_high_addr - stack_pointer,
+                 capture.size() - sizeof(RawCaptureHeader));
+    std::memcpy(&capture[sizeof(RawCaptureHeader)],
+                reinterpret_cast<const void*>(stack_pointer),
+                stack_size);
+    header.stack_size_bytes = stack_size;
+  }
+
+  // Write the magic last so an interrupted capture is not mistaken for a
+  // complete one.
+  std::memcpy(capture.data(), &header, sizeof(header));
+  header.magic = RawCaptureHeader::kMagic;
+  std::memcpy(capture.data(), &header.magic, sizeof(header.magic));
+  return OkStatus();
+}
+
+bool HasRawCapture(ConstByteSpan capture) {
+  if (capture.size() < sizeof(RawCaptureHeader)) {
+    return false;
+  }
+  RawCaptureHeader header;
+  std::memcpy(&header, capture.data(), sizeof(header));
+  return header.magic == RawCaptureHeader::kMagic &&
+         header.stack_size_bytes <= capture.size() - sizeof(header);
+}
+
+void ClearRawCapture(ByteSpan capture) {
+  if (capture.size() >= sizeof(RawCaptureHeader::magic)) {
+    std::memset(capture.data(), 0, sizeof(RawCaptureHeader::magic));
+  }
+}
+
+}  // namespace pw::cpu_exception::cortex_m
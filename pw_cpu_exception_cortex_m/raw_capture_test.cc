@@ -0,0 +1,107 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/raw_capture.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+
+namespace pw::cpu_exception::cortex_m {
+namespace {
+
+// See ARMv7-M Architecture Reference Manual Section B1.5.8 for the exception
+// return values.
+constexpr uint32_t kExcReturnThreadModeMain = 0b1001;
+constexpr uint32_t kExcReturnThreadModeProcess = 0b1101;
+
+class RawCaptureTest : public ::testing::Test {
+ protected:
+  RawCaptureTest() {
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      stack_[i] = static_cast<std::byte>(i);
+    }
+    cpu_state_.extended.exc_return = kExcReturnThreadModeMain;
+    cpu_state_.extended.msp = reinterpret_cast<uintptr_t>(&stack_[8]);
+    cpu_state_.base.pc = 0x1234;
+  }
+
+  uintptr_t stack_low() const {
+    return reinterpret_cast<uintptr_t>(stack_.data());
+  }
+  uintptr_t stack_high() const { return stack_low() + stack_.size(); }
+
+  RawCaptureHeader ReadHeader() const {
+    RawCaptureHeader header;
+    std::memcpy(&header, capture_.data(), sizeof(header));
+    return header;
+  }
+
+  std::array<std::byte, 32> stack_;
+  pw_cpu_exception_State cpu_state_ = {};
+  std::array<std::byte, sizeof(RawCaptureHeader) + 64> capture_ = {};
+};
+
+TEST_F(RawCaptureTest, CapturesStateAndActiveMainStack) {
+  ASSERT_EQ(CaptureRaw(cpu_state_, stack_low(), stack_high(), capture_),
+            OkStatus());
+  ASSERT_TRUE(HasRawCapture(capture_));
+
+  const RawCaptureHeader header = ReadHeader();
+  EXPECT_EQ(header.cpu_state.base.pc, 0x1234u);
+  EXPECT_EQ(header.stack_pointer, cpu_state_.extended.msp);
+  EXPECT_EQ(header.stack_high_addr, stack_high());
+  ASSERT_EQ(header.stack_size_bytes, 24u);
+  EXPECT_EQ(std::memcmp(&capture_[sizeof(RawCaptureHeader)], &stack_[8], 24),
+            0);
+}
+
+TEST_F(RawCaptureTest, TruncatesStackToCapture) {
+  std::array<std::byte, sizeof(RawCaptureHeader) + 4> small;
+  ASSERT_EQ(CaptureRaw(cpu_state_, stack_low(), stack_high(), small),
+            OkStatus());
+  ASSERT_TRUE(HasRawCapture(small));
+
+  RawCaptureHeader header;
+  std::memcpy(&header, small.data(), sizeof(header));
+  ASSERT_EQ(header.stack_size_bytes, 4u);
+  EXPECT_EQ(small[sizeof(RawCaptureHeader)], std::byte{8});
+}
+
+TEST_F(RawCaptureTest, SkipsInactiveMainStack) {
+  cpu_state_.extended.exc_return = kExcReturnThreadModeProcess;
+  ASSERT_EQ(CaptureRaw(cpu_state_, stack_low(), stack_high(), capture_),
+            OkStatus());
+  ASSERT_TRUE(HasRawCapture(capture_));
+  EXPECT_EQ(ReadHeader().stack_size_bytes, 0u);
+}
+
+TEST_F(RawCaptureTest, CaptureTooSmall) {
+  std::array<std::byte, sizeof(RawCaptureHeader) - 1> small;
+  EXPECT_EQ(CaptureRaw(cpu_state_, stack_low(), stack_high(), small),
+            Status::ResourceExhausted());
+}
+
+TEST_F(RawCaptureTest, Clear) {
+  EXPECT_FALSE(HasRawCapture(capture_));
+  ASSERT_EQ(CaptureRaw(cpu_state_, stack_low(), stack_high(), capture_),
+            OkStatus());
+  ClearRawCapture(capture_);
+  EXPECT_FALSE(HasRawCapture(capture_));
+}
+
+}  // namespace
+}  // namespace pw::cpu_exception::cortex_m
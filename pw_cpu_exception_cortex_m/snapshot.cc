@@ -16,7 +16,10 @@
 
 #include "pw_cpu_exception_cortex_m/snapshot.h"
 
+#include <cstring>
+
 #include "pw_cpu_exception_cortex_m/proto_dump.h"
+#include "pw_cpu_exception_cortex_m/raw_capture.h"
 #include "pw_cpu_exception_cortex_m/util.h"
 #include "pw_cpu_exception_cortex_m_private/config.h"
 #include "pw_cpu_exception_cortex_m_private/cortex_m_constants.h"
@@ -24,6 +27,7 @@
 #include "pw_log/log.h"
 #include "pw_protobuf/encoder.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_thread/snapshot.h"
 #include "pw_thread_protos/thread.pwpb.h"
 
@@ -70,6 +74,42 @@ Status CaptureMainStack(
 
 }  // namespace
 
+Status SnapshotRawCapture(
+    ConstByteSpan capture,
+    SnapshotCpuStateOverlay::StreamEncoder& cpu_state_encoder,
+    thread::SnapshotThreadInfo::StreamEncoder& thread_encoder,
+    thread::ProcessThreadStackCallback& thread_stack_callback) {
+  if (!HasRawCapture(capture)) {
+    return Status::NotFound();
+  }
+  RawCaptureHeader header;
+  std::memcpy(&header, capture.data(), sizeof(header));
+
+  PW_TRY(SnapshotCpuState(header.cpu_state, cpu_state_encoder));
+  if (header.stack_size_bytes == 0u) {
+    return OkStatus();
+  }
+
+  thread::Thread::StreamEncoder encoder = thread_encoder.GetThreadsEncoder();
+  if (ActiveProcessorMode(header.cpu_state) == ProcessorMode::kHandlerMode) {
+    encoder.WriteState(thread::ThreadState::Enum::INTERRUPT_HANDLER);
+    encoder.WriteName(
+        std::as_bytes(std::span(std::string_view(kMainStackHandlerModeName))));
+  } else {
+    encoder.WriteState(thread::ThreadState::Enum::RUNNING);
+    encoder.WriteName(
+        std::as_bytes(std::span(std::string_view(kMainStackThreadModeName))));
+  }
+
+  // TODO(pwbug/422): Add support for ascending stacks.
+  encoder.WriteStackStartPointer(header.stack_high_addr);
+  encoder.WriteStackEndPointer(header.stack_low_addr);
+  encoder.WriteStackPointer(header.stack_pointer);
+  return thread_stack_callback(
+      encoder,
+      capture.subspan(sizeof(RawCaptureHeader), header.stack_size_bytes));
+}
+
 Status SnapshotCpuState(
     const pw_cpu_exception_State& cpu_state,
     SnapshotCpuStateOverlay::StreamEncoder& snapshot_encoder) {
@@ -20,22 +20,21 @@
 #include "openssl/nid.h"
 #include "pw_crypto/ecdsa.h"
 #include "pw_log/log.h"
+#include "pw_status/try.h"
 
 namespace pw::crypto::ecdsa {
 
 constexpr size_t kP256CurveOrderBytes = 32;
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
+namespace backend {
+
+Status DoPrepareP256PublicKey(NativeP256PublicKey& key,
+                              ConstByteSpan public_key) {
   const uint8_t* public_key_bytes =
       reinterpret_cast<const uint8_t*>(public_key.data());
-  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
-  const uint8_t* signature_bytes =
-      reinterpret_cast<const uint8_t*>(signature.data());
 
-  // Allocate objects needed for ECDSA verification. BoringSSL relies on
-  // dynamic allocation.
+  // Allocate objects needed for the key. BoringSSL relies on dynamic
+  // allocation.
   bssl::UniquePtr<EC_GROUP> group(
       EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1));
   if (!group) {
@@ -43,9 +42,8 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   }
 
   bssl::UniquePtr<EC_POINT> pub_key(EC_POINT_new(group.get()));
-  bssl::UniquePtr<EC_KEY> key(EC_KEY_new());
-  bssl::UniquePtr<ECDSA_SIG> sig(ECDSA_SIG_new());
-  if (!(pub_key && key && sig)) {
+  bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new());
+  if (!(pub_key && ec_key)) {
     return Status::ResourceExhausted();
   }
 
@@ -59,14 +57,30 @@ Status VerifyP256Signature(ConstByteSpan public_key,
     return Status::InvalidArgument();
   }
 
-  if (!EC_KEY_set_group(key.get(), group.get())) {
+  if (!EC_KEY_set_group(ec_key.get(), group.get())) {
     return Status::InvalidArgument();
   }
 
-  if (!EC_KEY_set_public_key(key.get(), pub_key.get())) {
+  if (!EC_KEY_set_public_key(ec_key.get(), pub_key.get())) {
     return Status::InvalidArgument();
   }
 
+  key.key = ec_key.release();
+  return OkStatus();
+}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
+  const uint8_t* signature_bytes =
+      reinterpret_cast<const uint8_t*>(signature.data());
+
+  bssl::UniquePtr<ECDSA_SIG> sig(ECDSA_SIG_new());
+  if (!sig) {
+    return Status::ResourceExhausted();
+  }
+
   // Load the signature.
   if (signature.size() != kP256CurveOrderBytes * 2) {
     PW_LOG_DEBUG("Bad signature format");
@@ -87,7 +101,7 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   }
 
   // Verify the signature.
-  if (!ECDSA_do_verify(digest_bytes, digest.size(), sig.get(), key.get())) {
+  if (!ECDSA_do_verify(digest_bytes, digest.size(), sig.get(), key.key)) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -95,4 +109,19 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
+void DoReleaseP256PublicKey(NativeP256PublicKey& key) {
+  EC_KEY_free(key.key);
+  key.key = nullptr;
+}
+
+}  // namespace backend
+
+Status VerifyP256Signature(ConstByteSpan public_key,
+                           ConstByteSpan digest,
+                           ConstByteSpan signature) {
+  PreparedP256PublicKey key;
+  PW_TRY(key.Prepare(public_key));
+  return key.Verify(digest, signature);
+}
+
 }  // namespace pw::crypto::ecdsa
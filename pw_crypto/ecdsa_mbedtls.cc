@@ -18,6 +18,7 @@
 #include "pw_crypto/ecdsa.h"
 #include "pw_function/function.h"
 #include "pw_log/log.h"
+#include "pw_status/try.h"
 
 namespace pw::crypto::ecdsa {
 
@@ -37,60 +38,65 @@ class Defer {
 
 constexpr size_t kP256CurveOrderBytes = 32;
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
-  // Use a local structure to avoid going over the default inline storage
-  // for the `cleanup` callable used below.
-  struct {
-    // The elliptic curve group.
-    mbedtls_ecp_group grp;
-    // The public key point.
-    mbedtls_ecp_point Q;
-    // The signature (r, s).
-    mbedtls_mpi r, s;
-  } ctx;
+namespace backend {
 
+Status DoPrepareP256PublicKey(NativeP256PublicKey& key,
+                              ConstByteSpan public_key) {
   const uint8_t* public_key_data =
       reinterpret_cast<const uint8_t*>(public_key.data());
-  const uint8_t* digest_data = reinterpret_cast<const uint8_t*>(digest.data());
-  const uint8_t* signature_data =
-      reinterpret_cast<const uint8_t*>(signature.data());
 
   // These init functions never fail.
-  mbedtls_ecp_group_init(&ctx.grp);
-  mbedtls_ecp_point_init(&ctx.Q);
-  mbedtls_mpi_init(&ctx.r);
-  mbedtls_mpi_init(&ctx.s);
-
-  // Auto clean up on exit.
-  Defer cleanup([&ctx](void) {
-    mbedtls_ecp_group_free(&ctx.grp);
-    mbedtls_ecp_point_free(&ctx.Q);
-    mbedtls_mpi_free(&ctx.r);
-    mbedtls_mpi_free(&ctx.s);
-  });
+  mbedtls_ecp_group_init(&key.grp);
+  mbedtls_ecp_point_init(&key.Q);
 
   // Load the curve parameters.
-  if (mbedtls_ecp_group_load(&ctx.grp, MBEDTLS_ECP_DP_SECP256R1)) {
+  if (mbedtls_ecp_group_load(&key.grp, MBEDTLS_ECP_DP_SECP256R1)) {
+    DoReleaseP256PublicKey(key);
     return Status::Internal();
   }
 
-  // Load the public key.
+  // Load the public key and make sure it is on the curve.
   if (mbedtls_ecp_point_read_binary(
-          &ctx.grp, &ctx.Q, public_key_data, public_key.size())) {
+          &key.grp, &key.Q, public_key_data, public_key.size()) ||
+      mbedtls_ecp_check_pubkey(&key.grp, &key.Q)) {
     PW_LOG_DEBUG("Bad public key format");
+    DoReleaseP256PublicKey(key);
     return Status::InvalidArgument();
   }
 
+  return OkStatus();
+}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  // The signature (r, s).
+  struct {
+    mbedtls_mpi r, s;
+  } sig;
+
+  const uint8_t* digest_data = reinterpret_cast<const uint8_t*>(digest.data());
+  const uint8_t* signature_data =
+      reinterpret_cast<const uint8_t*>(signature.data());
+
   // Load the signature.
   if (signature.size() != kP256CurveOrderBytes * 2) {
     PW_LOG_DEBUG("Bad signature format");
     return Status::InvalidArgument();
   }
 
-  if (mbedtls_mpi_read_binary(&ctx.r, signature_data, kP256CurveOrderBytes) ||
-      mbedtls_mpi_read_binary(&ctx.s,
+  // These init functions never fail.
+  mbedtls_mpi_init(&sig.r);
+  mbedtls_mpi_init(&sig.s);
+
+  // Auto clean up on exit.
+  Defer cleanup([&sig](void) {
+    mbedtls_mpi_free(&sig.r);
+    mbedtls_mpi_free(&sig.s);
+  });
+
+  if (mbedtls_mpi_read_binary(&sig.r, signature_data, kP256CurveOrderBytes) ||
+      mbedtls_mpi_read_binary(&sig.s,
                               signature_data + kP256CurveOrderBytes,
                               kP256CurveOrderBytes)) {
     return Status::Internal();
@@ -104,7 +110,7 @@ Status VerifyP256Signature(ConstByteSpan public_key,
 
   // Verify the signature.
   if (mbedtls_ecdsa_verify(
-          &ctx.grp, digest_data, digest.size(), &ctx.Q, &ctx.r, &ctx.s)) {
+          &key.grp, digest_data, digest.size(), &key.Q, &sig.r, &sig.s)) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -112,4 +118,19 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
+void DoReleaseP256PublicKey(NativeP256PublicKey& key) {
+  mbedtls_ecp_group_free(&key.grp);
+  mbedtls_ecp_point_free(&key.Q);
+}
+
+}  // namespace backend
+
+Status VerifyP256Signature(ConstByteSpan public_key,
+                           ConstByteSpan digest,
+                           ConstByteSpan signature) {
+  PreparedP256PublicKey key;
+  PW_TRY(key.Prepare(public_key));
+  return key.Verify(digest, signature);
+}
+
 }  // namespace pw::crypto::ecdsa
@@ -159,5 +159,74 @@ TEST(EcdsaP256, TamperedPubkey) {
                                   AS_BYTES(TEST_SIGNATURE)));
 }
 
+TEST(PreparedP256PublicKey, VerifiesManySignatures) {
+  PreparedP256PublicKey key;
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+  EXPECT_TRUE(key.prepared());
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+    ASSERT_EQ(Status::Unauthenticated(),
+              key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TAMPERED_SIGNATURE)));
+  }
+}
+
+TEST(PreparedP256PublicKey, MalformedPublicKey) {
+  PreparedP256PublicKey key;
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Prepare(AS_BYTES(MALFORMED_PUBKEY_MISSING_HEADER)));
+  EXPECT_FALSE(key.prepared());
+  ASSERT_EQ(Status::FailedPrecondition(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(PreparedP256PublicKey, PrepareReplacesKey) {
+  PreparedP256PublicKey key;
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_FAIL(key.Prepare(AS_BYTES(TAMPERED_PUBKEY)));
+  EXPECT_FALSE(key.prepared());
+
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(PreparedP256PublicKey, VerifyRejectsBadInputs) {
+  PreparedP256PublicKey key;
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(SHORT_SIGNATURE)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Verify(AS_BYTES(SHORT_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_EQ(Status::Unauthenticated(),
+            key.Verify(AS_BYTES(TAMPERED_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(EcdsaP256, VerifySignatures_AllValid) {
+  PreparedP256PublicKey key;
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+
+  const SignedDigest signed_digests[] = {
+      {AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)},
+      {AS_BYTES(TEST_DIGEST "extra stuff"), AS_BYTES(TEST_SIGNATURE)},
+  };
+  StatusWithSize result = VerifyP256Signatures(key, signed_digests);
+  ASSERT_OK(result.status());
+  EXPECT_EQ(result.size(), 2u);
+}
+
+TEST(EcdsaP256, VerifySignatures_ChecksAllAfterFailure) {
+  PreparedP256PublicKey key;
+  ASSERT_OK(key.Prepare(AS_BYTES(TEST_PUBKEY)));
+
+  const SignedDigest signed_digests[] = {
+      {AS_BYTES(TAMPERED_DIGEST), AS_BYTES(TEST_SIGNATURE)},
+      {AS_BYTES(TEST_DIGEST), AS_BYTES(SHORT_SIGNATURE)},
+      {AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)},
+  };
+  StatusWithSize result = VerifyP256Signatures(key, signed_digests);
+  ASSERT_EQ(Status::Unauthenticated(), result.status());
+  EXPECT_EQ(result.size(), 1u);
+}
+
 }  // namespace
 }  // namespace pw::crypto::ecdsa
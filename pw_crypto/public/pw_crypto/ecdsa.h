@@ -12,13 +12,33 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+
 #pragma once
 
+#include <span>
+
 #include "pw_bytes/span.h"
+#include "pw_crypto/ecdsa_backend.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::crypto::ecdsa {
 
+namespace backend {
+
+// Primitive operations to be implemented by backends.
+//
+// DoPrepareP256PublicKey parses and validates `public_key` into `key`. If it
+// fails, `key` holds no resources and DoReleaseP256PublicKey is not called.
+Status DoPrepareP256PublicKey(NativeP256PublicKey& key,
+                              ConstByteSpan public_key);
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature);
+void DoReleaseP256PublicKey(NativeP256PublicKey& key);
+
+}  // namespace backend
+
 // VerifyP256Signature verifies the `signature` of `digest` using `public_key`.
 //
 // `public_key` is a byte string in SEC 1 uncompressed form (0x04||X||Y), which
@@ -35,4 +55,87 @@ Status VerifyP256Signature(ConstByteSpan public_key,
                            ConstByteSpan digest,
                            ConstByteSpan signature);
 
+// PreparedP256PublicKey holds a public key that has been parsed and validated
+// once, along with any precomputation the backend keeps for it, so that it can
+// verify many signatures without redoing that work each time.
+//
+// Usage:
+//
+// PreparedP256PublicKey key;
+// if (!key.Prepare(public_key).ok()) {
+//   // Error handling.
+// }
+// if (!key.Verify(digest, signature).ok()) {
+//   // Error handling.
+// }
+class PreparedP256PublicKey {
+ public:
+  PreparedP256PublicKey() = default;
+
+  PreparedP256PublicKey(const PreparedP256PublicKey&) = delete;
+  PreparedP256PublicKey& operator=(const PreparedP256PublicKey&) = delete;
+
+  ~PreparedP256PublicKey() { Release(); }
+
+  // Parses and validates `public_key`, which has the same format as for
+  // VerifyP256Signature(), replacing any previously prepared key.
+  //
+  // Returns Status::InvalidArgument() if the key is malformed or not on the
+  // curve, in which case no key is prepared.
+  Status Prepare(ConstByteSpan public_key) {
+    Release();
+    Status status = backend::DoPrepareP256PublicKey(native_key_, public_key);
+    prepared_ = status.ok();
+    return status;
+  }
+
+  // Verifies the `signature` of `digest`. The formats and results are the same
+  // as for VerifyP256Signature(), except that Status::FailedPrecondition() is
+  // returned if no key is prepared.
+  Status Verify(ConstByteSpan digest, ConstByteSpan signature) {
+    if (!prepared_) {
+      return Status::FailedPrecondition();
+    }
+    return backend::DoVerifyP256Signature(native_key_, digest, signature);
+  }
+
+  bool prepared() const { return prepared_; }
+
+ private:
+  void Release() {
+    if (prepared_) {
+      backend::DoReleaseP256PublicKey(native_key_);
+      prepared_ = false;
+    }
+  }
+
+  backend::NativeP256PublicKey native_key_;
+  bool prepared_ = false;
+};
+
+// A digest and its signature, for verifying several at once.
+struct SignedDigest {
+  ConstByteSpan digest;
+  ConstByteSpan signature;
+};
+
+// Verifies each signature in `signed_digests` with the prepared `key`. All of
+// them are checked, even after one fails.
+//
+// Returns the number of signatures that verified, with Status::OkStatus() if
+// all of them did, or the status of the first that did not.
+inline StatusWithSize VerifyP256Signatures(
+    PreparedP256PublicKey& key, std::span<const SignedDigest> signed_digests) {
+  Status status;
+  size_t verified = 0;
+  for (const SignedDigest& signed_digest : signed_digests) {
+    Status result = key.Verify(signed_digest.digest, signed_digest.signature);
+    if (result.ok()) {
+      verified += 1;
+    }
+    status.Update(result);
+  }
+  return StatusWithSize(status, verified);
+}
+
 }  // namespace pw::crypto::ecdsa
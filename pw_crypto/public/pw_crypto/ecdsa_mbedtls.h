@@ -0,0 +1,29 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "mbedtls/ecp.h"
+
+namespace pw::crypto::ecdsa::backend {
+
+// The curve group is kept with the point, so the multiples of the generator
+// that Mbed TLS precomputes into the group on first use are reused by every
+// later verification with the same key.
+struct NativeP256PublicKey {
+  mbedtls_ecp_group grp;
+  mbedtls_ecp_point Q;
+};
+
+}  // namespace pw::crypto::ecdsa::backend
@@ -18,6 +18,7 @@
 #define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
 
 #include <cstdint>
+#include <span>
 
 #include "pw_bytes/span.h"
 #include "pw_crypto/sha256_backend.h"
@@ -26,6 +27,13 @@
 #include "pw_status/try.h"
 #include "pw_stream/stream.h"
 
+// Backends that can hash several independent messages faster than one after
+// another, e.g. by interleaving them across SIMD lanes, set this to 1 in their
+// sha256_backend.h and implement backend::DoHashMultiple().
+#ifndef PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+#define PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE 0
+#endif  // PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+
 namespace pw::crypto::sha256 {
 
 // Size in bytes of a SHA256 digest.
@@ -51,6 +59,13 @@ Status DoInit(NativeSha256Context& ctx);
 Status DoUpdate(NativeSha256Context& ctx, ConstByteSpan data);
 Status DoFinal(NativeSha256Context& ctx, ByteSpan out_digest);
 
+#if PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+// Writes the digest of messages[i] to out_digests at i * kDigestSizeBytes.
+// `out_digests` is large enough for all digests.
+Status DoHashMultiple(std::span<const ConstByteSpan> messages,
+                      ByteSpan out_digests);
+#endif  // PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+
 }  // namespace backend
 
 // Sha256 computes the SHA256 digest of potentially long, non-contiguous input
@@ -153,4 +168,26 @@ inline Status Hash(stream::Reader& reader, ByteSpan out_digest) {
   return sha256.Final(out_digest);
 }
 
+// HashMultiple calculates the SHA256 digests of several independent messages.
+// The digest of messages[i] is stored at offset i * kDigestSizeBytes of
+// `out_digests`, which must be at least messages.size() * kDigestSizeBytes
+// long. Backends may hash the messages in parallel; otherwise they are hashed
+// one after another.
+inline Status HashMultiple(std::span<const ConstByteSpan> messages,
+                           ByteSpan out_digests) {
+  if (out_digests.size() / kDigestSizeBytes < messages.size()) {
+    return Status::InvalidArgument();
+  }
+
+#if PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+  return backend::DoHashMultiple(messages, out_digests);
+#else
+  for (size_t i = 0; i < messages.size(); ++i) {
+    PW_TRY(Hash(messages[i],
+                out_digests.subspan(i * kDigestSizeBytes, kDigestSizeBytes)));
+  }
+  return OkStatus();
+#endif  // PW_CRYPTO_SHA256_BACKEND_HAS_HASH_MULTIPLE
+}
+
 }  // namespace pw::crypto::sha256
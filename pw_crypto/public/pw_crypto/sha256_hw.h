@@ -0,0 +1,68 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+
+namespace pw::crypto::sha256 {
+
+// Interface to a hardware SHA256 engine, used by the sha256_hw backend.
+//
+// The backend buffers input so that Update() is only given whole blocks. This
+// lets engines that are fed by DMA transfer the caller's data directly, without
+// copying it. Only the bytes left over at the end of the message, which are
+// fewer than a block, are passed to Finish().
+//
+// There is a single engine, which holds the state of one hashing session at a
+// time. Start() begins a new session, discarding any unfinished one, so only
+// one Sha256 instance may be in use at a time with this backend.
+class HashEngine {
+ public:
+  static constexpr size_t kBlockSizeBytes = 64;
+
+  virtual ~HashEngine() = default;
+
+  // Starts a new hashing session.
+  virtual Status Start() = 0;
+
+  // Hashes `blocks`, the size of which is a non-zero multiple of
+  // kBlockSizeBytes. `blocks` is only valid for the duration of the call, so
+  // the engine must wait for any DMA transfer reading from it to complete
+  // before returning.
+  virtual Status Update(ConstByteSpan blocks) = 0;
+
+  // Hashes `tail`, which is shorter than a block, pads the message, writes the
+  // digest to the first 32 bytes of `out_digest` and ends the session.
+  virtual Status Finish(ConstByteSpan tail, ByteSpan out_digest) = 0;
+};
+
+namespace backend {
+
+// Returns the engine used by the sha256_hw backend. Must be implemented by the
+// platform.
+HashEngine& GetHashEngine();
+
+struct NativeSha256Context {
+  HashEngine* engine;
+  // Input that does not yet fill a whole block.
+  std::array<std::byte, HashEngine::kBlockSizeBytes> buffer;
+  size_t buffered;
+};
+
+}  // namespace backend
+}  // namespace pw::crypto::sha256
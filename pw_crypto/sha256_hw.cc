@@ -0,0 +1,64 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_crypto/sha256.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::crypto::sha256::backend {
+
+Status DoInit(NativeSha256Context& ctx) {
+  ctx.engine = &GetHashEngine();
+  ctx.buffered = 0;
+  return ctx.engine->Start();
+}
+
+Status DoUpdate(NativeSha256Context& ctx, ConstByteSpan data) {
+  // Complete a partially filled block first.
+  if (ctx.buffered > 0) {
+    const size_t to_copy =
+        std::min(data.size(), HashEngine::kBlockSizeBytes - ctx.buffered);
+    std::memcpy(ctx.buffer.data() + ctx.buffered, data.data(), to_copy);
+    ctx.buffered += to_copy;
+    data = data.subspan(to_copy);
+
+    if (ctx.buffered < HashEngine::kBlockSizeBytes) {
+      return OkStatus();
+    }
+    PW_TRY(ctx.engine->Update(ctx.buffer));
+    ctx.buffered = 0;
+  }
+
+  // Hash whole blocks straight from the caller's buffer.
+  const size_t whole_blocks_size =
+      data.size() - data.size() % HashEngine::kBlockSizeBytes;
+  if (whole_blocks_size > 0) {
+    PW_TRY(ctx.engine->Update(data.first(whole_blocks_size)));
+    data = data.subspan(whole_blocks_size);
+  }
+
+  std::memcpy(ctx.buffer.data(), data.data(), data.size());
+  ctx.buffered = data.size();
+  return OkStatus();
+}
+
+Status DoFinal(NativeSha256Context& ctx, ByteSpan out_digest) {
+  return ctx.engine->Finish(std::span(ctx.buffer).first(ctx.buffered),
+                            out_digest);
+}
+
+}  // namespace pw::crypto::sha256::backend
@@ -0,0 +1,131 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_crypto/sha256.h"
+#include "pw_crypto/sha256_backend.h"
+
+namespace pw::crypto::sha256 {
+namespace {
+
+#define ASSERT_OK(expr) ASSERT_EQ(OkStatus(), expr)
+#define ASSERT_FAIL(expr) ASSERT_NE(OkStatus(), expr)
+
+// Records the data passed to it instead of hashing it. The "digest" is the
+// number of times each method was called.
+class FakeHashEngine : public HashEngine {
+ public:
+  Status Start() override {
+    size_ = 0;
+    update_calls_ = 0;
+    return start_status;
+  }
+
+  Status Update(ConstByteSpan blocks) override {
+    EXPECT_NE(blocks.size(), 0u);
+    EXPECT_EQ(blocks.size() % kBlockSizeBytes, 0u);
+    Append(blocks);
+    update_calls_ += 1;
+    return update_status;
+  }
+
+  Status Finish(ConstByteSpan tail, ByteSpan out_digest) override {
+    EXPECT_LT(tail.size(), kBlockSizeBytes);
+    Append(tail);
+    out_digest[0] = static_cast<std::byte>(update_calls_);
+    return OkStatus();
+  }
+
+  ConstByteSpan data() const { return std::span(data_).first(size_); }
+
+  Status start_status = OkStatus();
+  Status update_status = OkStatus();
+
+ private:
+  void Append(ConstByteSpan bytes) {
+    ASSERT_LE(size_ + bytes.size(), data_.size());
+    std::memcpy(data_.data() + size_, bytes.data(), bytes.size());
+    size_ += bytes.size();
+  }
+
+  std::array<std::byte, 512> data_;
+  size_t size_ = 0;
+  size_t update_calls_ = 0;
+};
+
+FakeHashEngine fake_engine;
+
+std::array<std::byte, 300> Message() {
+  std::array<std::byte, 300> message;
+  for (size_t i = 0; i < message.size(); ++i) {
+    message[i] = static_cast<std::byte>(i);
+  }
+  return message;
+}
+
+TEST(Sha256Hw, PassesWholeBlocksToEngine) {
+  const std::array<std::byte, 300> message = Message();
+  std::byte digest[kDigestSizeBytes];
+
+  // 10 + 60 fills a block; 200 holds three more, leaving 8 bytes which are
+  // completed by the next 30.
+  ASSERT_OK(Sha256()
+                .Update(std::span(message).first(10))
+                .Update(std::span(message).subspan(10, 60))
+                .Update(std::span(message).subspan(70, 200))
+                .Update(std::span(message).subspan(270))
+                .Final(digest));
+
+  EXPECT_EQ(digest[0], std::byte{3});
+  ASSERT_EQ(fake_engine.data().size(), message.size());
+  EXPECT_EQ(0, std::memcmp(fake_engine.data().data(), message.data(), 300));
+}
+
+TEST(Sha256Hw, PassesShortMessageToFinish) {
+  const std::array<std::byte, 300> message = Message();
+  std::byte digest[kDigestSizeBytes];
+
+  ASSERT_OK(Sha256().Update(std::span(message).first(63)).Final(digest));
+
+  EXPECT_EQ(digest[0], std::byte{0});
+  ASSERT_EQ(fake_engine.data().size(), 63u);
+  EXPECT_EQ(0, std::memcmp(fake_engine.data().data(), message.data(), 63));
+}
+
+TEST(Sha256Hw, HandlesEngineFailures) {
+  const std::array<std::byte, 300> message = Message();
+  std::byte digest[kDigestSizeBytes];
+
+  fake_engine.start_status = Status::Unavailable();
+  ASSERT_FAIL(Sha256().Update(message).Final(digest));
+  fake_engine.start_status = OkStatus();
+
+  fake_engine.update_status = Status::Internal();
+  ASSERT_FAIL(Sha256().Update(message).Final(digest));
+  fake_engine.update_status = OkStatus();
+
+  ASSERT_OK(Sha256().Update(message).Final(digest));
+}
+
+}  // namespace
+
+namespace backend {
+
+HashEngine& GetHashEngine() { return fake_engine; }
+
+}  // namespace backend
+}  // namespace pw::crypto::sha256
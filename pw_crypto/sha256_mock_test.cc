@@ -56,5 +56,17 @@ TEST(Sha256, HandlesBackendFinalFailures) {
   ASSERT_FAIL(Sha256().Update(AS_BYTES("blahblah")).Final(digest));
 }
 
+TEST(HashMultiple, HandlesBackendFailures) {
+  std::byte digests[2 * kDigestSizeBytes];
+  const ConstByteSpan messages[] = {AS_BYTES("blah"), AS_BYTES("blahblah")};
+
+  backend::ClearError();
+  ASSERT_OK(HashMultiple(messages, digests));
+
+  backend::InjectError(backend::ErrorKind::kUpdate);
+  ASSERT_FAIL(HashMultiple(messages, digests));
+  backend::ClearError();
+}
+
 }  // namespace
 }  // namespace pw::crypto::sha256
@@ -99,6 +99,33 @@ TEST(Hash, AcceptsLargerDigestBufferForReaderBasedAPI) {
   ASSERT_OK(Hash(reader, digest));
 }
 
+TEST(HashMultiple, ComputesCorrectDigests) {
+  std::byte digests[3 * kDigestSizeBytes];
+  const ConstByteSpan messages[] = {AS_BYTES("Hello, Pigweed!"),
+                                    ConstByteSpan(),
+                                    AS_BYTES("Hello, Pigweed!")};
+
+  ASSERT_OK(HashMultiple(messages, digests));
+  ASSERT_EQ(0,
+            std::memcmp(&digests[0 * kDigestSizeBytes],
+                        SHA256_HASH_OF_HELLO_PIGWEED,
+                        kDigestSizeBytes));
+  ASSERT_EQ(0,
+            std::memcmp(&digests[1 * kDigestSizeBytes],
+                        SHA256_HASH_OF_EMPTY_STRING,
+                        kDigestSizeBytes));
+  ASSERT_EQ(0,
+            std::memcmp(&digests[2 * kDigestSizeBytes],
+                        SHA256_HASH_OF_HELLO_PIGWEED,
+                        kDigestSizeBytes));
+}
+
+TEST(HashMultiple, DigestBufferTooSmall) {
+  std::byte digests[2 * kDigestSizeBytes - 1];
+  const ConstByteSpan messages[] = {AS_BYTES("Hello"), AS_BYTES("Pigweed")};
+  ASSERT_FAIL(HashMultiple(messages, digests));
+}
+
 TEST(Sha256, AllowsSkippedUpdate) {
   std::byte digest[kDigestSizeBytes];
 
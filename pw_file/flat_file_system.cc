@@ -37,18 +37,21 @@ namespace pw::file {
 using Entry = FlatFileSystemService::Entry;
 
 Status FlatFileSystemService::EnumerateFile(
-    Entry& entry, pw::file::ListResponse::StreamEncoder& output_encoder) {
+    Entry& entry,
+    std::string_view name_prefix,
+    pw::file::ListResponse::StreamEncoder& output_encoder) {
   StatusWithSize sws = entry.Name(file_name_buffer_);
   if (!sws.ok()) {
     return sws.status();
   }
+  const std::string_view file_name(file_name_buffer_.data(), sws.size());
+  if (file_name.substr(0, name_prefix.size()) != name_prefix) {
+    return Status::NotFound();
+  }
   {
     pw::file::Path::StreamEncoder encoder = output_encoder.GetPathsEncoder();
 
-    encoder
-        .WritePath(reinterpret_cast<const char*>(file_name_buffer_.data()),
-                   sws.size())
-        .IgnoreError();
+    encoder.WritePath(file_name.data(), file_name.size()).IgnoreError();
     encoder.WriteSizeBytes(entry.SizeBytes()).IgnoreError();
     encoder.WritePermissions(entry.Permissions()).IgnoreError();
     encoder.WriteFileId(entry.FileId()).IgnoreError();
@@ -56,12 +59,25 @@ Status FlatFileSystemService::EnumerateFile(
   return output_encoder.status();
 }
 
-void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
-  for (Entry* entry : entries_) {
+void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer,
+                                              const ListOptions& options) {
+  uint32_t listed = 0;
+  for (size_t i = options.start_index; i < entries_.size(); ++i) {
+    if (options.max_entries != 0 && listed == options.max_entries) {
+      // Tell the client where to continue the listing.
+      pw::file::ListResponse::MemoryEncoder encoder(encoding_buffer_);
+      encoder.WriteNextIndex(static_cast<uint32_t>(i)).IgnoreError();
+      writer.Finish(writer.Write(encoder))
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+      return;
+    }
+
+    Entry* entry = entries_[i];
     PW_DCHECK_NOTNULL(entry);
     // For now, don't try to pack entries.
     pw::file::ListResponse::MemoryEncoder encoder(encoding_buffer_);
-    if (Status status = EnumerateFile(*entry, encoder); !status.ok()) {
+    if (Status status = EnumerateFile(*entry, options.name_prefix, encoder);
+        !status.ok()) {
       if (status != Status::NotFound()) {
         PW_LOG_ERROR("Failed to enumerate file (id: %u) with status %d",
                      static_cast<unsigned>(entry->FileId()),
@@ -76,6 +92,7 @@ void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
           .IgnoreError();  // TODO(pwbug/387): Handle Status properly
       return;
     }
+    listed += 1;
   }
   writer.Finish(OkStatus())
       .IgnoreError();  // TODO(pwbug/387): Handle Status properly
@@ -83,45 +100,63 @@ void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
 
 void FlatFileSystemService::List(ConstByteSpan request,
                                  RawServerWriter& writer) {
+  ListOptions options;
+  std::string_view file_name_view;
+
   protobuf::Decoder decoder(request);
-  // If a file name was provided, try and find and enumerate the file.
   while (decoder.Next().ok()) {
-    if (decoder.FieldNumber() !=
-        static_cast<uint32_t>(pw::file::ListRequest::Fields::PATH)) {
-      continue;
+    Status status;
+    switch (static_cast<pw::file::ListRequest::Fields>(decoder.FieldNumber())) {
+      case pw::file::ListRequest::Fields::PATH:
+        status = decoder.ReadString(&file_name_view);
+        if (status.ok() && file_name_view.empty()) {
+          status = Status::DataLoss();
+        }
+        break;
+      case pw::file::ListRequest::Fields::START_INDEX:
+        status = decoder.ReadUint32(&options.start_index);
+        break;
+      case pw::file::ListRequest::Fields::MAX_ENTRIES:
+        status = decoder.ReadUint32(&options.max_entries);
+        break;
+      case pw::file::ListRequest::Fields::NAME_PREFIX:
+        status = decoder.ReadString(&options.name_prefix);
+        break;
+      default:
+        break;
     }
-
-    std::string_view file_name_view;
-    if (!decoder.ReadString(&file_name_view).ok() ||
-        file_name_view.length() == 0) {
+    if (!status.ok()) {
       writer.Finish(Status::DataLoss())
           .IgnoreError();  // TODO(pwbug/387): Handle Status properly
       return;
     }
+  }
 
-    // Find and enumerate the file requested.
-    Result<Entry*> result = FindFile(file_name_view);
-    if (!result.ok()) {
-      writer.Finish(result.status())
-          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-      return;
-    }
+  // If no path was provided in the ListRequest, enumerate everything that
+  // matches the paging and filtering options.
+  if (file_name_view.empty()) {
+    EnumerateAllFiles(writer, options);
+    return;
+  }
 
-    pw::file::ListResponse::MemoryEncoder encoder(encoding_buffer_);
-    Status proto_encode_status = EnumerateFile(*result.value(), encoder);
-    if (!proto_encode_status.ok()) {
-      writer.Finish(proto_encode_status)
-          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-      return;
-    }
+  // If a file name was provided, try and find and enumerate the file.
+  Result<Entry*> result = FindFile(file_name_view);
+  if (!result.ok()) {
+    writer.Finish(result.status())
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
 
-    writer.Finish(writer.Write(encoder))
+  pw::file::ListResponse::MemoryEncoder encoder(encoding_buffer_);
+  Status proto_encode_status = EnumerateFile(*result.value(), {}, encoder);
+  if (!proto_encode_status.ok()) {
+    writer.Finish(proto_encode_status)
         .IgnoreError();  // TODO(pwbug/387): Handle Status properly
     return;
   }
 
-  // If no path was provided in the ListRequest, just enumerate everything.
-  EnumerateAllFiles(writer);
+  writer.Finish(writer.Write(encoder))
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
 }
 
 void FlatFileSystemService::Delete(ConstByteSpan request,
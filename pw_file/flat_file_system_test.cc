@@ -17,6 +17,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 
@@ -66,6 +67,19 @@ class FakeFile : public FlatFileSystemService::Entry {
   uint32_t file_id_;
 };
 
+// Counts how many times the file name is read.
+class CountingFakeFile : public FakeFile {
+ public:
+  using FakeFile::FakeFile;
+
+  StatusWithSize Name(std::span<char> dest) override {
+    name_reads += 1;
+    return FakeFile::Name(dest);
+  }
+
+  size_t name_reads = 0;
+};
+
 bool EntryHasName(FlatFileSystemService::Entry* entry) {
   std::array<char, 4> expected_name;
   StatusWithSize file_name_sws = entry->Name(expected_name);
@@ -228,5 +242,143 @@ TEST(FlatFileSystem, List_FileMissingName) {
   EXPECT_EQ(2u, ValidateExpectedPaths(static_file_system, ctx.responses()));
 }
 
+// Returns the next_index of a ListResponse, if it has one.
+std::optional<uint32_t> NextIndex(ConstByteSpan response) {
+  protobuf::Decoder decoder(response);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(pw::file::ListResponse::Fields::NEXT_INDEX)) {
+      uint32_t next_index;
+      if (decoder.ReadUint32(&next_index).ok()) {
+        return next_index;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+TEST(FlatFileSystem, List_MaxEntries) {
+  std::array<FakeFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  std::array<std::byte, 16> request_buffer;
+  pw::file::ListRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WriteMaxEntries(2));
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10>, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan(request.data(), request.size()));
+
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(3u, ctx.responses().size());
+  EXPECT_EQ(std::nullopt, NextIndex(ctx.responses()[0]));
+  EXPECT_EQ(std::nullopt, NextIndex(ctx.responses()[1]));
+  EXPECT_EQ(2u, NextIndex(ctx.responses()[2]));
+}
+
+TEST(FlatFileSystem, List_StartIndex) {
+  std::array<FakeFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  std::array<std::byte, 16> request_buffer;
+  pw::file::ListRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WriteStartIndex(2));
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10>, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan(request.data(), request.size()));
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(1u,
+            ValidateExpectedPaths(std::span(static_file_system).subspan(2),
+                                  ctx.responses()));
+}
+
+TEST(FlatFileSystem, List_NamePrefix) {
+  std::array<FakeFile, 3> files{{{"SNAP_001", 372, 9},
+                                 {"tokens.csv", 808, 15038202},
+                                 {"SNAP_002", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  std::array<std::byte, 16> request_buffer;
+  pw::file::ListRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WriteNamePrefix("SNAP_"));
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10>, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan(request.data(), request.size()));
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(2u, ctx.responses().size());
+
+  std::array<FlatFileSystemService::Entry*, 2> expected{&files[0], &files[2]};
+  EXPECT_EQ(2u, ValidateExpectedPaths(expected, ctx.responses()));
+}
+
+TEST(CachedFlatFileSystemEntry, CachesUntilInvalidated) {
+  CountingFakeFile file("SNAP_001", 372, 9);
+  CachedFlatFileSystemEntry<10> cached(file);
+  std::array<char, 10> name;
+
+  ASSERT_EQ(OkStatus(), cached.Name(name).status());
+  ASSERT_EQ(OkStatus(), cached.Name(name).status());
+  EXPECT_EQ(372u, cached.SizeBytes());
+  EXPECT_EQ(9u, cached.FileId());
+  EXPECT_EQ(1u, file.name_reads);
+
+  cached.Invalidate();
+  StatusWithSize sws = cached.Name(name);
+  ASSERT_EQ(OkStatus(), sws.status());
+  EXPECT_EQ(std::string_view("SNAP_001"),
+            std::string_view(name.data(), sws.size()));
+  EXPECT_EQ(2u, file.name_reads);
+}
+
+TEST(CachedFlatFileSystemEntry, NameTooLongForDestination) {
+  CountingFakeFile file("tokens.csv", 808, 15038202);
+  CachedFlatFileSystemEntry<10> cached(file);
+  std::array<char, 4> name;
+
+  StatusWithSize sws = cached.Name(name);
+  EXPECT_EQ(Status::ResourceExhausted(), sws.status());
+  EXPECT_EQ(4u, sws.size());
+}
+
+TEST(CachedFlatFileSystemEntry, ListsThroughService) {
+  std::array<CountingFakeFile, 2> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}}};
+  std::array<CachedFlatFileSystemEntry<10>, 2> cached{
+      {CachedFlatFileSystemEntry<10>(files[0]),
+       CachedFlatFileSystemEntry<10>(files[1])}};
+  std::array<FlatFileSystemService::Entry*, 2> static_file_system{&cached[0],
+                                                                  &cached[1]};
+
+  for (int i = 0; i < 2; ++i) {
+    PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10>, List)
+    ctx(static_file_system);
+    ctx.call(ConstByteSpan());
+    EXPECT_EQ(2u, ValidateExpectedPaths(static_file_system, ctx.responses()));
+  }
+
+  EXPECT_EQ(1u, files[0].name_reads);
+  EXPECT_EQ(1u, files[1].name_reads);
+}
+
+TEST(CachedFlatFileSystemEntry, ReadIsForwarded) {
+  FakeFile file("SNAP_001", 372, 9);
+  CachedFlatFileSystemEntry<10> cached(file);
+  std::array<std::byte, 8> data;
+
+  // FakeFile doesn't support positional reads.
+  EXPECT_EQ(Status::Unimplemented(), file.Read(0, data).status());
+  EXPECT_EQ(Status::Unimplemented(), cached.Read(0, data).status());
+}
+
 }  // namespace
 }  // namespace pw::file
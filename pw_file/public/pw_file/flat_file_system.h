@@ -13,8 +13,11 @@
 // the License.
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <span>
 #include <string_view>
 
@@ -62,6 +65,20 @@ class FlatFileSystemService
     virtual size_t SizeBytes() = 0;
     virtual FilePermissions Permissions() const = 0;
 
+    // Reads up to dest.size() bytes of the file, starting at `offset`. This
+    // allows partial reads of large files without starting from the beginning.
+    // Entries that don't support positional reads need not override this.
+    //
+    // Returns:
+    //   OK - Read the returned number of bytes, which is less than dest.size()
+    //       only if the end of the file was reached.
+    //   OUT_OF_RANGE - `offset` is at or past the end of the file.
+    //   NOT_FOUND - No file is present at this entry.
+    //   UNIMPLEMENTED - This entry does not support positional reads.
+    virtual StatusWithSize Read(size_t /* offset */, ByteSpan /* dest */) {
+      return StatusWithSize::Unimplemented();
+    }
+
     // Deleting a file, if allowed, should cause the backing data store to be
     // cleared. Read-only files should also no longer enumerate (i.e. Name()
     // should return NOT_FOUND). Write-only and read/write files may still
@@ -121,12 +138,22 @@ class FlatFileSystemService
            protobuf::SizeOfFieldUint32(Path::Fields::FILE_ID);
   }
 
+  // Paging and filtering options from a ListRequest.
+  struct ListOptions {
+    uint32_t start_index = 0;
+    uint32_t max_entries = 0;  // Zero means no limit.
+    std::string_view name_prefix;
+  };
+
   Result<Entry*> FindFile(std::string_view file_name);
   Status FindAndDeleteFile(std::string_view file_name);
 
+  // Returns NOT_FOUND if the entry has no file or its name doesn't start with
+  // name_prefix.
   Status EnumerateFile(Entry& entry,
+                       std::string_view name_prefix,
                        pw::file::ListResponse::StreamEncoder& output_encoder);
-  void EnumerateAllFiles(RawServerWriter& writer);
+  void EnumerateAllFiles(RawServerWriter& writer, const ListOptions& options);
 
   const std::span<std::byte> encoding_buffer_;
   const std::span<char> file_name_buffer_;
@@ -149,4 +176,90 @@ class FlatFileSystemServiceWithBuffer : public FlatFileSystemService {
       kMaxFileNameLength, kMinGuaranteedEntriesPerResponse)];
   char file_name_buffer_[kMaxFileNameLength];
 };
+
+// Caches the name and size of another Entry, which may be slow to read (for
+// example, from flash) every time files are listed. Permissions and the file
+// ID are forwarded as-is.
+//
+// Call Invalidate() whenever the underlying file changes, such as from the
+// FinalizeWrite() of the file's pw_transfer handler. Deleting the file through
+// this entry invalidates the cache. Invalidate() may be called from a different
+// thread than the one running the FlatFileSystemService.
+template <size_t kMaxFileNameLength>
+class CachedFlatFileSystemEntry final : public FlatFileSystemService::Entry {
+ public:
+  constexpr CachedFlatFileSystemEntry(FlatFileSystemService::Entry& entry)
+      : entry_(entry),
+        generation_(1),
+        cached_generation_(0),
+        name_{},
+        name_size_(0),
+        size_bytes_(0) {}
+
+  // Discards the cached name and size. They are read again from the wrapped
+  // entry the next time they are needed.
+  void Invalidate() { generation_.fetch_add(1, std::memory_order_release); }
+
+  StatusWithSize Name(std::span<char> dest) final {
+    Refresh();
+    if (!name_status_.ok()) {
+      return StatusWithSize(name_status_, 0);
+    }
+    const size_t bytes_to_copy = std::min(dest.size(), name_size_);
+    std::memcpy(dest.data(), name_, bytes_to_copy);
+    if (bytes_to_copy != name_size_) {
+      return StatusWithSize::ResourceExhausted(bytes_to_copy);
+    }
+    return StatusWithSize(bytes_to_copy);
+  }
+
+  size_t SizeBytes() final {
+    Refresh();
+    return size_bytes_;
+  }
+
+  FilePermissions Permissions() const final { return entry_.Permissions(); }
+
+  // File contents are not cached.
+  StatusWithSize Read(size_t offset, ByteSpan dest) final {
+    return entry_.Read(offset, dest);
+  }
+
+  Status Delete() final {
+    const Status status = entry_.Delete();
+    Invalidate();
+    return status;
+  }
+
+  Id FileId() const final { return entry_.FileId(); }
+
+ private:
+  void Refresh() {
+    const uint32_t generation = generation_.load(std::memory_order_acquire);
+    if (generation == cached_generation_) {
+      return;
+    }
+
+    const StatusWithSize sws = entry_.Name(name_);
+    name_status_ = sws.status();
+    name_size_ = sws.size();
+    size_bytes_ = name_status_.ok() ? entry_.SizeBytes() : 0;
+
+    // Transient errors are not cached so the next access retries. If the entry
+    // was invalidated while it was read, generation no longer matches and the
+    // next access reads it again.
+    if (name_status_.ok() || name_status_.IsNotFound()) {
+      cached_generation_ = generation;
+    }
+  }
+
+  FlatFileSystemService::Entry& entry_;
+  std::atomic<uint32_t> generation_;
+  uint32_t cached_generation_;
+  Status name_status_;
+  char name_[kMaxFileNameLength];
+  size_t name_size_;
+  size_t size_bytes_;
+};
+
 }  // namespace pw::file
@@ -276,6 +276,96 @@ TEST(Function, MoveOnlyType) {
   EXPECT_TRUE(function(std::move(move_only)));
 }
 
+TEST(InlineFunction, SizeIsConfigurable) {
+  static_assert(sizeof(InlineFunction<void(), alignof(std::max_align_t)>) ==
+                alignof(std::max_align_t));
+  static_assert(sizeof(InlineFunction<void(), 4 * alignof(std::max_align_t)>) ==
+                4 * alignof(std::max_align_t));
+  static_assert(
+      std::is_same_v<Function<void()>,
+                     InlineFunction<void(),
+                                    function_internal::config::
+                                        kInlineCallableSize>>);
+}
+
+TEST(InlineFunction, LargerCapture) {
+  int a = 1, b = 2, c = 3, d = 4;
+  InlineFunction<int(), 6 * sizeof(void*)> sum = [&a, &b, &c, &d] {
+    return a + b + c + d;
+  };
+  EXPECT_EQ(sum(), 10);
+
+  InlineFunction<int(), 6 * sizeof(void*)> moved(std::move(sum));
+  EXPECT_EQ(moved(), 10);
+  EXPECT_TRUE(sum == nullptr);
+}
+
+// Minimal block allocator with the interface pw::Function expects, which
+// pw::allocator::FixedBlockAllocator provides.
+class TestBlockAllocator {
+ public:
+  void* Allocate() {
+    if (allocated_) {
+      return nullptr;
+    }
+    allocated_ = true;
+    return &block_;
+  }
+
+  void Free(void* ptr) {
+    EXPECT_EQ(ptr, static_cast<void*>(&block_));
+    allocated_ = false;
+  }
+
+  static constexpr size_t block_size() { return sizeof(block_); }
+
+  bool allocated() const { return allocated_; }
+
+ private:
+  std::aligned_storage_t<8 * sizeof(void*), alignof(std::max_align_t)> block_;
+  bool allocated_ = false;
+};
+
+TEST(InlineFunction, Allocator_SmallCallableIsInline) {
+  TestBlockAllocator allocator;
+  int value = 0;
+  Function<void()> set([&value] { value = 1; }, allocator);
+
+  EXPECT_FALSE(allocator.allocated());
+  set();
+  EXPECT_EQ(value, 1);
+}
+
+TEST(InlineFunction, Allocator_LargeCallableIsAllocated) {
+  TestBlockAllocator allocator;
+  int a = 1, b = 2, c = 3, d = 4;
+  {
+    Function<int()> sum([&a, &b, &c, &d] { return a + b + c + d; },
+                        allocator);
+    EXPECT_TRUE(allocator.allocated());
+    EXPECT_EQ(sum(), 10);
+
+    // Moves transfer the block without copying the callable.
+    Function<int()> moved = std::move(sum);
+    EXPECT_TRUE(allocator.allocated());
+    EXPECT_EQ(moved(), 10);
+
+    sum = std::move(moved);
+    EXPECT_EQ(sum(), 10);
+  }
+  EXPECT_FALSE(allocator.allocated());
+}
+
+TEST(InlineFunction, Allocator_AssignNullFreesBlock) {
+  TestBlockAllocator allocator;
+  int a = 1, b = 2, c = 3, d = 4;
+  Function<int()> sum([&a, &b, &c, &d] { return a + b + c + d; }, allocator);
+  EXPECT_TRUE(allocator.allocated());
+
+  sum = nullptr;
+  EXPECT_FALSE(allocator.allocated());
+}
+
 }  // namespace
 }  // namespace pw
 
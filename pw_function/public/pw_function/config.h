@@ -17,9 +17,9 @@
 
 #include <cstddef>
 
-// The maximum size of a callable that can be inlined within a function. This is
-// also the size of the Function object itself. Callables larger than this are
-// stored externally to the function.
+// The maximum size of a callable that can be inlined within a pw::Function.
+// This is also the size of the Function object itself. pw::InlineFunction
+// overrides the size for a particular use.
 //
 // This defaults to 2 pointers, which is capable of storing common callables
 // such as function pointers and simple lambdas.
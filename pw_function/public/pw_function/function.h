@@ -13,10 +13,32 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
 #include "pw_function/internal/function.h"
 
 namespace pw {
 
+// pw::InlineFunction is a pw::Function with a specific inline storage size.
+// Callables that fit are stored within the object; others must be given a
+// block allocator, as described below. Use it where the default size does not
+// fit, such as queues of many small callbacks, or a few callbacks that capture
+// more state.
+//
+// kInlineSizeBytes includes a pointer of overhead and must be a nonzero
+// multiple of the pointer size. The InlineFunction object is kInlineSizeBytes
+// rounded up to a multiple of alignof(std::max_align_t).
+//
+//   // Fits a lambda capturing up to three pointers on most platforms.
+//   pw::InlineFunction<void(), 4 * sizeof(void*)> callback;
+//
+template <typename Callable, size_t kInlineSizeBytes>
+class InlineFunction {
+  static_assert(std::is_function_v<Callable>,
+                "pw::Function may only be instantianted for a function type, "
+                "such as pw::Function<void(int)>.");
+};
+
 // pw::Function is a wrapper for an aribtrary callable object. It can be used by
 // callback-based APIs to allow callers to provide any type of callable.
 //
@@ -43,23 +65,27 @@ namespace pw {
 //     return All(items, IsEven);
 //   }
 //
+// The size of a pw::Function is set by PW_FUNCTION_INLINE_CALLABLE_SIZE. Use
+// pw::InlineFunction to choose a different size.
 template <typename Callable>
-class Function {
-  static_assert(std::is_function_v<Callable>,
-                "pw::Function may only be instantianted for a function type, "
-                "such as pw::Function<void(int)>.");
-};
+using Function =
+    InlineFunction<Callable, function_internal::config::kInlineCallableSize>;
 
 using Closure = Function<void()>;
 
-template <typename Return, typename... Args>
-class Function<Return(Args...)> {
+template <typename Return, typename... Args, size_t kInlineSizeBytes>
+class InlineFunction<Return(Args...), kInlineSizeBytes> {
  public:
-  constexpr Function() = default;
-  constexpr Function(std::nullptr_t) : Function() {}
+  static_assert(kInlineSizeBytes > 0u &&
+                    kInlineSizeBytes % alignof(void*) == 0u,
+                "pw::InlineFunction storage must be a nonzero multiple of the "
+                "pointer size");
+
+  constexpr InlineFunction() = default;
+  constexpr InlineFunction(std::nullptr_t) : InlineFunction() {}
 
   template <typename Callable>
-  Function(Callable callable) {
+  InlineFunction(Callable callable) {
     if (function_internal::IsNull(callable)) {
       holder_.InitializeNullTarget();
     } else {
@@ -67,26 +93,46 @@ class Function<Return(Args...)> {
     }
   }
 
-  Function(Function&& other) {
+  // Stores the callable inline if it fits. Otherwise, stores it in a block
+  // from the allocator, which is freed when the function is destroyed. The
+  // allocator must provide void* Allocate(), void Free(void*), and
+  // size_t block_size(), like pw::allocator::FixedBlockAllocator. Crashes if
+  // the allocator has no free block or its blocks are too small.
+  //
+  // The allocator must outlive the function. It is used without locking, so
+  // functions sharing a FixedBlockAllocator must be created and destroyed from
+  // one thread; use a LockFreeFixedBlockAllocator otherwise.
+  template <typename Callable, typename BlockAllocator>
+  InlineFunction(Callable callable, BlockAllocator& allocator) {
+    if (function_internal::IsNull(callable)) {
+      holder_.InitializeNullTarget();
+    } else if constexpr (Holder::template CanInline<Callable>()) {
+      holder_.InitializeInlineTarget(std::move(callable));
+    } else {
+      holder_.InitializeAllocatedTarget(std::move(callable), allocator);
+    }
+  }
+
+  InlineFunction(InlineFunction&& other) {
     holder_.MoveInitializeTargetFrom(other.holder_);
     other.holder_.InitializeNullTarget();
   }
 
-  Function& operator=(Function&& other) {
+  InlineFunction& operator=(InlineFunction&& other) {
     holder_.DestructTarget();
     holder_.MoveInitializeTargetFrom(other.holder_);
     other.holder_.InitializeNullTarget();
     return *this;
   }
 
-  Function& operator=(std::nullptr_t) {
+  InlineFunction& operator=(std::nullptr_t) {
     holder_.DestructTarget();
     holder_.InitializeNullTarget();
     return *this;
   }
 
   template <typename Callable>
-  Function& operator=(Callable callable) {
+  InlineFunction& operator=(Callable callable) {
     holder_.DestructTarget();
     if (function_internal::IsNull(callable)) {
       holder_.InitializeNullTarget();
@@ -96,7 +142,7 @@ class Function<Return(Args...)> {
     return *this;
   }
 
-  ~Function() { holder_.DestructTarget(); }
+  ~InlineFunction() { holder_.DestructTarget(); }
 
   template <typename... PassedArgs>
   Return operator()(PassedArgs&&... args) const {
@@ -108,9 +154,9 @@ class Function<Return(Args...)> {
  private:
   // TODO(frolv): This is temporarily private while the API is worked out.
   template <typename Callable, size_t kSizeBytes>
-  Function(Callable&& callable,
-           function_internal::FunctionStorage<kSizeBytes>& storage)
-      : Function(callable, &storage) {
+  InlineFunction(Callable&& callable,
+                 function_internal::FunctionStorage<kSizeBytes>& storage)
+      : InlineFunction(callable, &storage) {
     static_assert(sizeof(Callable) <= kSizeBytes,
                   "pw::Function callable does not fit into provided storage");
   }
@@ -119,7 +165,7 @@ class Function<Return(Args...)> {
   // Public constructors wrapping this must ensure that the memory region is
   // capable of storing the callable in terms of both size and alignment.
   template <typename Callable>
-  Function(Callable&& callable, void* storage) {
+  InlineFunction(Callable&& callable, void* storage) {
     if (function_internal::IsNull(callable)) {
       holder_.InitializeNullTarget();
     } else {
@@ -127,31 +173,30 @@ class Function<Return(Args...)> {
     }
   }
 
-  function_internal::FunctionTargetHolder<
-      function_internal::config::kInlineCallableSize,
-      Return,
-      Args...>
-      holder_;
+  using Holder = function_internal::
+      FunctionTargetHolder<kInlineSizeBytes, Return, Args...>;
+
+  Holder holder_;
 };
 
 // nullptr comparisions for functions.
-template <typename T>
-bool operator==(const Function<T>& f, std::nullptr_t) {
+template <typename T, size_t kSize>
+bool operator==(const InlineFunction<T, kSize>& f, std::nullptr_t) {
   return !static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator!=(const Function<T>& f, std::nullptr_t) {
+template <typename T, size_t kSize>
+bool operator!=(const InlineFunction<T, kSize>& f, std::nullptr_t) {
   return static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator==(std::nullptr_t, const Function<T>& f) {
+template <typename T, size_t kSize>
+bool operator==(std::nullptr_t, const InlineFunction<T, kSize>& f) {
   return !static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator!=(std::nullptr_t, const Function<T>& f) {
+template <typename T, size_t kSize>
+bool operator!=(std::nullptr_t, const InlineFunction<T, kSize>& f) {
   return static_cast<bool>(f);
 }
 
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <new>
 #include <utility>
 
@@ -183,6 +184,61 @@ class MemoryFunctionTarget final : public FunctionTarget<Return, Args...> {
   void* address_;
 };
 
+// Function target which stores a callable in a block from a block allocator,
+// such as a pw::allocator::FixedBlockAllocator. The block also records the
+// allocator so the target can return the block when it is destroyed. Only the
+// block pointer moves with the target, so this fits wherever a
+// MemoryFunctionTarget does.
+template <typename Callable,
+          typename BlockAllocator,
+          typename Return,
+          typename... Args>
+class AllocatedFunctionTarget final : public FunctionTarget<Return, Args...> {
+ public:
+  struct Block {
+    BlockAllocator* allocator;
+
+    // This must be mutable to support custom objects that implement
+    // operator() in a non-const way.
+    mutable Callable callable;
+  };
+
+  AllocatedFunctionTarget(void* address,
+                          BlockAllocator& allocator,
+                          Callable&& callable)
+      : block_(new (address) Block{&allocator, std::move(callable)}) {}
+
+  void Destroy() final {
+    // As with MemoryFunctionTarget, only the most recent target to be moved
+    // into owns the block.
+    if (block_ != nullptr) {
+      BlockAllocator* allocator = block_->allocator;
+      block_->~Block();
+      allocator->Free(block_);
+    }
+  }
+
+  AllocatedFunctionTarget(const AllocatedFunctionTarget&) = delete;
+  AllocatedFunctionTarget& operator=(const AllocatedFunctionTarget&) = delete;
+
+  AllocatedFunctionTarget(AllocatedFunctionTarget&& other)
+      : block_(other.block_) {
+    other.block_ = nullptr;
+  }
+  AllocatedFunctionTarget& operator=(AllocatedFunctionTarget&&) = delete;
+
+  Return operator()(Args... args) const final {
+    return block_->callable(std::forward<Args>(args)...);
+  }
+
+  void MoveInitializeTo(void* ptr) final {
+    new (ptr) AllocatedFunctionTarget(std::move(*this));
+  }
+
+ private:
+  Block* block_;
+};
+
 template <size_t kSizeBytes>
 using FunctionStorage =
     std::aligned_storage_t<kSizeBytes, alignof(std::max_align_t)>;
@@ -209,6 +265,13 @@ class FunctionTargetHolder {
     new (&null_function_) NullFunctionTarget;
   }
 
+  // Whether InitializeInlineTarget() accepts the callable.
+  template <typename Callable>
+  static constexpr bool CanInline() {
+    return sizeof(InlineFunctionTarget<Callable, Return, Args...>) <=
+           kSizeBytes;
+  }
+
   // Initializes an InlineFunctionTarget with the callable, failing if it is too
   // large.
   template <typename Callable>
@@ -231,6 +294,26 @@ class FunctionTargetHolder {
     new (&bits_) MemoryFunctionTarget(storage, std::move(callable));
   }
 
+  // Initializes an AllocatedFunctionTarget that stores the callable in a block
+  // from the allocator. Crashes if the allocator has no free block or its
+  // blocks cannot hold the callable.
+  template <typename Callable, typename BlockAllocator>
+  void InitializeAllocatedTarget(Callable callable, BlockAllocator& allocator) {
+    using AllocatedFunctionTarget =
+        AllocatedFunctionTarget<Callable, BlockAllocator, Return, Args...>;
+    using Block = typename AllocatedFunctionTarget::Block;
+    static_assert(
+        sizeof(AllocatedFunctionTarget) <= kSizeBytes,
+        "AllocatedFunctionTarget must fit within FunctionTargetHolder");
+
+    PW_ASSERT(sizeof(Block) <= allocator.block_size());
+    void* block = allocator.Allocate();
+    PW_ASSERT(block != nullptr);
+    PW_ASSERT(reinterpret_cast<uintptr_t>(block) % alignof(Block) == 0u);
+    new (&bits_)
+        AllocatedFunctionTarget(block, allocator, std::move(callable));
+  }
+
   void DestructTarget() { target().Destroy(); }
 
   // Initializes the function target within this callable from another target
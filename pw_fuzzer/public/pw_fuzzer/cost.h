@@ -0,0 +1,119 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Support for performance fuzzing: flagging inputs whose execution cost grows
+// faster than linearly with their size.
+//
+// A fuzz target counts the work it does for an input, such as loop iterations
+// or bytes read, with a CostTracker. Inputs that exceed a linear budget abort,
+// so libFuzzer saves them like any other crash. When fuzzing with libFuzzer on
+// Linux, the magnitude of each input's cost is also reported as extra coverage,
+// which steers the fuzzer toward increasingly expensive inputs.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "pw_log/log.h"
+
+#if defined(__clang__) && defined(__linux__)
+#define _PW_FUZZER_COST_FEEDBACK 1
+#else
+#define _PW_FUZZER_COST_FEEDBACK 0
+#endif  // defined(__clang__) && defined(__linux__)
+
+namespace pw::fuzzer {
+namespace internal {
+
+inline constexpr size_t kCostBuckets = 32;
+
+// Returns the number of bits needed to represent value, capped to fit in the
+// cost feedback counters.
+constexpr size_t CostBucket(size_t value) {
+  size_t bits = 0;
+  for (; value != 0u && bits < kCostBuckets - 1; value >>= 1) {
+    bits += 1;
+  }
+  return bits;
+}
+
+#if _PW_FUZZER_COST_FEEDBACK
+
+// libFuzzer treats the counters in this section as additional coverage and
+// clears them before each input. One set of counters records the magnitude of
+// the total cost and the other the magnitude of the cost per input byte.
+inline void RecordCostFeedback(size_t cost, size_t input_size) {
+  __attribute__((used, section("__libfuzzer_extra_counters"))) static uint8_t
+      counters[2 * kCostBuckets];
+  counters[CostBucket(cost)] = 1;
+  counters[kCostBuckets + CostBucket(cost / (input_size + 1))] = 1;
+}
+
+#else
+
+inline void RecordCostFeedback(size_t, size_t) {}
+
+#endif  // _PW_FUZZER_COST_FEEDBACK
+
+}  // namespace internal
+
+// Tracks the execution cost of processing one fuzzer input. The cost may not
+// exceed cost_per_byte * input_size + fixed_cost; exceeding it indicates
+// superlinear behavior or a stall, and aborts.
+//
+//   extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+//     pw::fuzzer::CostTracker cost(size, /*cost_per_byte=*/4);
+//     while (decoder.Next().ok()) {
+//       cost.Add();
+//     }
+//     return 0;
+//   }
+//
+class CostTracker {
+ public:
+  constexpr CostTracker(size_t input_size,
+                        size_t cost_per_byte,
+                        size_t fixed_cost = 1)
+      : input_size_(input_size),
+        budget_(cost_per_byte * input_size + fixed_cost),
+        cost_(0) {}
+
+  CostTracker(const CostTracker&) = delete;
+  CostTracker& operator=(const CostTracker&) = delete;
+
+  ~CostTracker() { internal::RecordCostFeedback(cost_, input_size_); }
+
+  // Adds to the cost of the input. Aborts as soon as the cost exceeds the
+  // budget, so that stalls are caught without waiting for a timeout.
+  void Add(size_t cost = 1) {
+    cost_ += cost;
+    if (cost_ > budget_) {
+      PW_LOG_ERROR("A %u-byte input cost more than its budget of %u",
+                   static_cast<unsigned>(input_size_),
+                   static_cast<unsigned>(budget_));
+      std::abort();
+    }
+  }
+
+  size_t cost() const { return cost_; }
+  size_t budget() const { return budget_; }
+
+ private:
+  const size_t input_size_;
+  const size_t budget_;
+  size_t cost_;
+};
+
+}  // namespace pw::fuzzer
@@ -14,10 +14,14 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
 #include "pw_log/log.h"
+#include "pw_status/try.h"
 #include "pw_varint/varint.h"
 
 using std::byte;
@@ -56,7 +60,8 @@ Result<Frame> Decoder::Process(const byte new_byte) {
     }
     case State::kFrame: {
       if (new_byte == kFlag) {
-        const Status status = CheckFrame();
+        const Status status =
+            CheckFrame(current_frame_size_, fcs_.value(), ReceivedFcs());
 
         const size_t completed_frame_size = current_frame_size_;
         Reset();
@@ -99,6 +104,69 @@ Result<Frame> Decoder::Process(const byte new_byte) {
   PW_CRASH("Bad decoder state");
 }
 
+Result<Frame> Decoder::ProcessUntilFrame(ConstByteSpan data,
+                                         size_t* bytes_processed) {
+  const byte* const begin = data.data();
+  const byte* const end = begin + data.size();
+  const byte* next = begin;
+
+  while (next != end) {
+    // Skip ahead to the next byte that changes the decoder's state.
+    if (state_ == State::kInterFrame) {
+      const byte* const flag = std::find(next, end, kFlag);
+      current_frame_size_ += flag - next;
+      next = flag;
+    } else if (state_ == State::kFrame) {
+      const byte* const special = std::find_if(next, end, NeedsEscaping);
+
+      // A frame that is entirely in data and has no escapes is returned from
+      // data directly, without copying it to the decoder's buffer.
+      if (current_frame_size_ == 0u && special != end && special != next &&
+          *special == kFlag) {
+        *bytes_processed = special + 1 - begin;
+        return ProcessInPlace(std::span(next, special));
+      }
+
+      AppendBytes(std::span(next, special));
+      next = special;
+    }
+
+    if (next == end) {
+      break;
+    }
+
+    Result<Frame> result = Process(*next++);
+    if (result.status() != Status::Unavailable()) {
+      *bytes_processed = next - begin;
+      return result;
+    }
+  }
+
+  *bytes_processed = data.size();
+  return Status::Unavailable();
+}
+
+Result<Frame> Decoder::ProcessInPlace(ConstByteSpan frame) {
+  uint32_t calculated_fcs = 0;
+  uint32_t received_fcs = 0;
+  if (frame.size() >= sizeof(received_fcs)) {
+    const size_t fcs_offset = frame.size() - sizeof(received_fcs);
+    calculated_fcs = checksum::Crc32::Calculate(frame.first(fcs_offset));
+    received_fcs = bytes::ReadInOrder<uint32_t>(std::endian::little,
+                                                &frame[fcs_offset]);
+  }
+
+  const Status status =
+      CheckFrame(frame.size(), calculated_fcs, received_fcs);
+  if (status.IsResourceExhausted()) {
+    // Provide the start of the frame in the buffer, as when it is copied, for
+    // callers that partially decode frames.
+    std::memcpy(buffer_.data(), frame.data(), max_size());
+  }
+  PW_TRY(status);
+  return Frame::Parse(frame);
+}
+
 void Decoder::AppendByte(byte new_byte) {
   if (current_frame_size_ < max_size()) {
     buffer_[current_frame_size_] = new_byte;
@@ -117,24 +185,64 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
-Status Decoder::CheckFrame() const {
+void Decoder::AppendBytes(ConstByteSpan data) {
+  // Short runs only touch the ring buffer, so append them one at a time.
+  if (data.size() < last_read_bytes_.size()) {
+    for (byte b : data) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    const size_t to_copy =
+        std::min(data.size(), max_size() - current_frame_size_);
+    std::memcpy(&buffer_[current_frame_size_], data.data(), to_copy);
+  }
+
+  // All bytes in the ring buffer are evicted by this run. When the frame has
+  // fewer bytes than the ring buffer, the oldest byte is at index 0.
+  size_t index = current_frame_size_ < last_read_bytes_.size()
+                     ? 0
+                     : last_read_bytes_index_;
+  const size_t evicted =
+      std::min(current_frame_size_, last_read_bytes_.size());
+  for (size_t i = 0; i < evicted; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  // Only the end of the run remains in the ring buffer; checksum the rest.
+  const size_t checksummed = data.size() - last_read_bytes_.size();
+  fcs_.Update(data.first(checksummed));
+  std::memcpy(last_read_bytes_.data(),
+              data.data() + checksummed,
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += data.size();
+}
+
+Status Decoder::CheckFrame(size_t frame_size,
+                           uint32_t calculated_fcs,
+                           uint32_t received_fcs) const {
   // Empty frames are not an error; repeated flag characters are okay.
-  if (current_frame_size_ == 0u) {
+  if (frame_size == 0u) {
     return Status::Unavailable();
   }
 
-  if (current_frame_size_ < Frame::kMinSizeBytes) {
+  if (frame_size < Frame::kMinSizeBytes) {
     PW_LOG_ERROR("Received %lu-byte frame; frame must be at least 6 bytes",
-                 static_cast<unsigned long>(current_frame_size_));
+                 static_cast<unsigned long>(frame_size));
     return Status::DataLoss();
   }
 
-  if (!VerifyFrameCheckSequence()) {
+  if (calculated_fcs != received_fcs) {
     PW_LOG_ERROR("Frame check sequence verification failed");
     return Status::DataLoss();
   }
 
-  if (current_frame_size_ > max_size()) {
+  if (frame_size > max_size()) {
     // Frame does not fit into the provided buffer; indicate this to the caller.
     // This may not be considered an error if the caller is doing a partial
     // decode.
@@ -144,7 +252,7 @@ Status Decoder::CheckFrame() const {
   return OkStatus();
 }
 
-bool Decoder::VerifyFrameCheckSequence() const {
+uint32_t Decoder::ReceivedFcs() const {
   // De-ring the last four bytes read, which at this point contain the FCS.
   std::array<std::byte, sizeof(uint32_t)> fcs_buffer;
   size_t index = last_read_bytes_index_;
@@ -154,9 +262,7 @@ bool Decoder::VerifyFrameCheckSequence() const {
     index = (index + 1) % last_read_bytes_.size();
   }
 
-  uint32_t actual_fcs =
-      bytes::ReadInOrder<uint32_t>(std::endian::little, fcs_buffer);
-  return actual_fcs == fcs_.value();
+  return bytes::ReadInOrder<uint32_t>(std::endian::little, fcs_buffer);
 }
 
 }  // namespace pw::hdlc
@@ -0,0 +1,39 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Performance fuzzer for pw::hdlc::Decoder. Each ProcessUntilFrame() call must
+// consume input, so the number of calls is bounded by the input size. A call
+// that makes no progress would stall the decoding loop.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_fuzzer/cost.h"
+#include "pw_hdlc/decoder.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  pw::fuzzer::CostTracker cost(size, /*cost_per_byte=*/1);
+  pw::hdlc::DecoderBuffer<64> decoder;
+
+  pw::ConstByteSpan remaining = std::as_bytes(std::span(data, size));
+  while (!remaining.empty()) {
+    size_t bytes_processed = 0;
+    decoder.ProcessUntilFrame(remaining, &bytes_processed).IgnoreError();
+    cost.Add();
+    remaining = remaining.subspan(bytes_processed);
+  }
+  return 0;
+}
@@ -16,10 +16,13 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::hdlc {
 namespace {
@@ -152,5 +155,167 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+// Encodes three frames with escapes at different positions in one buffer.
+class ProcessUntilFrame : public ::testing::Test {
+ protected:
+  static constexpr auto kPayload1 = bytes::String("hello, world");
+  static constexpr auto kPayload2 = bytes::Array<0x7e, 0x7d, 1, 2, 3, 0x7e>();
+  static constexpr auto kPayload3 =
+      bytes::String("a somewhat longer payload with a ~ in the middle");
+
+  ProcessUntilFrame() : writer_(encoded_) {
+    EXPECT_EQ(OkStatus(), WriteUIFrame(1, kPayload1, writer_));
+    EXPECT_EQ(OkStatus(), WriteUIFrame(0x7d, kPayload2, writer_));
+    EXPECT_EQ(OkStatus(), WriteUIFrame(3, kPayload3, writer_));
+  }
+
+  template <typename T>
+  static void ExpectFrame(const Result<Frame>& result,
+                          uint64_t address,
+                          const T& payload) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(address, result.value().address());
+    ASSERT_EQ(payload.size(), result.value().data().size());
+    EXPECT_EQ(0,
+              std::memcmp(payload.data(),
+                          result.value().data().data(),
+                          payload.size()));
+  }
+
+  ConstByteSpan encoded() const { return writer_.WrittenData(); }
+
+  std::array<byte, 128> encoded_;
+  stream::MemoryWriter writer_;
+};
+
+TEST_F(ProcessUntilFrame, ReturnsEachFrame) {
+  DecoderBuffer<64> decoder;
+  ConstByteSpan data = encoded();
+  size_t bytes_processed = 0;
+
+  auto result = decoder.ProcessUntilFrame(data, &bytes_processed);
+  ExpectFrame(result, 1, kPayload1);
+  data = data.subspan(bytes_processed);
+
+  result = decoder.ProcessUntilFrame(data, &bytes_processed);
+  ExpectFrame(result, 0x7d, kPayload2);
+  data = data.subspan(bytes_processed);
+
+  result = decoder.ProcessUntilFrame(data, &bytes_processed);
+  ExpectFrame(result, 3, kPayload3);
+  EXPECT_EQ(data.size(), bytes_processed);
+
+  EXPECT_EQ(Status::Unavailable(),
+            decoder.ProcessUntilFrame({}, &bytes_processed).status());
+  EXPECT_EQ(0u, bytes_processed);
+}
+
+TEST_F(ProcessUntilFrame, FramesWithoutEscapesAreNotCopied) {
+  DecoderBuffer<64> decoder;
+  ConstByteSpan data = encoded();
+  size_t bytes_processed = 0;
+
+  auto in_data = [&data](const Result<Frame>& result) {
+    const byte* frame_data = result.value().data().data();
+    return frame_data >= data.data() && frame_data < data.data() + data.size();
+  };
+
+  // The first frame has no escapes, so it references the input.
+  auto result = decoder.ProcessUntilFrame(data, &bytes_processed);
+  ExpectFrame(result, 1, kPayload1);
+  EXPECT_TRUE(in_data(result));
+  data = data.subspan(bytes_processed);
+
+  // The second frame is unescaped into the decoder's buffer.
+  result = decoder.ProcessUntilFrame(data, &bytes_processed);
+  ExpectFrame(result, 0x7d, kPayload2);
+  EXPECT_FALSE(in_data(result));
+}
+
+TEST(Decoder, ProcessUntilFrame_InPlaceFrameTooLargeForBuffer) {
+  std::array<byte, 8> buffer = {};
+  Decoder decoder(buffer);
+  size_t bytes_processed = 0;
+
+  constexpr auto kData = bytes::String(
+      "~12345678901234567890\xf2\x19\x63\x90~1234\xa3\xe0\xe3\x9b~");
+  auto result = decoder.ProcessUntilFrame(kData, &bytes_processed);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+
+  // The start of the frame is in the buffer for partial decoding.
+  constexpr auto kExpected = bytes::String("12345678");
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), buffer.data(), buffer.size()));
+
+  result = decoder.ProcessUntilFrame(std::span(kData).subspan(bytes_processed),
+                                     &bytes_processed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.value().data().size());
+}
+
+TEST_F(ProcessUntilFrame, MatchesByteAtATimeWhenSplit) {
+  // Split the data at every position to start and end runs at every offset.
+  for (size_t split = 0; split <= encoded().size(); ++split) {
+    DecoderBuffer<64> decoder;
+    size_t frames = 0;
+
+    auto check_frame = [&frames](const Result<Frame>& result) {
+      switch (frames++) {
+        case 0:
+          ExpectFrame(result, 1, kPayload1);
+          break;
+        case 1:
+          ExpectFrame(result, 0x7d, kPayload2);
+          break;
+        case 2:
+          ExpectFrame(result, 3, kPayload3);
+          break;
+        default:
+          FAIL();
+      }
+    };
+
+    decoder.Process(encoded().first(split), check_frame);
+    decoder.Process(encoded().subspan(split), check_frame);
+    EXPECT_EQ(3u, frames);
+  }
+}
+
+TEST_F(ProcessUntilFrame, TooLargeForBuffer_StaysWithinBufferBoundaries) {
+  std::array<byte, 40> buffer = bytes::Initialized<40>('?');
+  Decoder decoder(std::span(buffer.data(), 20));
+
+  Status statuses[3] = {};
+  size_t frames = 0;
+  decoder.Process(encoded(), [&](const Result<Frame>& result) {
+    ASSERT_LT(frames, 3u);
+    statuses[frames++] = result.status();
+  });
+
+  ASSERT_EQ(3u, frames);
+  EXPECT_EQ(OkStatus(), statuses[0]);
+  EXPECT_EQ(OkStatus(), statuses[1]);
+  EXPECT_EQ(Status::ResourceExhausted(), statuses[2]);
+
+  for (size_t i = 20; i < buffer.size(); ++i) {
+    ASSERT_EQ(byte{'?'}, buffer[i]);
+  }
+}
+
+TEST(Decoder, ProcessUntilFrame_ReportsInvalidFrames) {
+  DecoderBuffer<32> decoder;
+  size_t bytes_processed = 0;
+
+  // Bytes between frames, then a frame with a bad FCS.
+  constexpr auto kData = bytes::String("junk~1234abcd~");
+  auto result = decoder.ProcessUntilFrame(kData, &bytes_processed);
+  EXPECT_EQ(Status::DataLoss(), result.status());
+  EXPECT_EQ(5u, bytes_processed);
+
+  result = decoder.ProcessUntilFrame(std::span(kData).subspan(5),
+                                     &bytes_processed);
+  EXPECT_EQ(Status::DataLoss(), result.status());
+  EXPECT_EQ(kData.size() - 5, bytes_processed);
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -0,0 +1,63 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_hdlc/demultiplexer.h"
+
+namespace pw::hdlc {
+
+Status Demultiplexer::RegisterHandler(uint64_t address,
+                                      FrameHandler& handler) {
+  if (address >= handlers_.size()) {
+    return Status::InvalidArgument();
+  }
+  if (handlers_[address] != nullptr) {
+    return Status::AlreadyExists();
+  }
+  handlers_[address] = &handler;
+  return OkStatus();
+}
+
+Status Demultiplexer::UnregisterHandler(uint64_t address) {
+  if (address >= handlers_.size() || handlers_[address] == nullptr) {
+    return Status::NotFound();
+  }
+  handlers_[address] = nullptr;
+  return OkStatus();
+}
+
+Status Demultiplexer::HandleFrame(const Frame& frame) {
+  FrameHandler* handler = frame.address() < handlers_.size()
+                              ? handlers_[frame.address()]
+                              : nullptr;
+  if (handler == nullptr) {
+    handler = default_handler_;
+  }
+  if (handler == nullptr) {
+    dropped_frames_ += 1;
+    return Status::NotFound();
+  }
+  handler->HandleFrame(frame);
+  return OkStatus();
+}
+
+void Demultiplexer::Process(Decoder& decoder, ConstByteSpan data) {
+  decoder.Process(data, [this](const Result<Frame>& result) {
+    if (result.ok()) {
+      HandleFrame(result.value()).IgnoreError();  // Counted as dropped.
+    } else {
+      invalid_frames_ += 1;
+    }
+  });
+}
+
+}  // namespace pw::hdlc
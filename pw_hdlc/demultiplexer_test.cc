@@ -0,0 +1,171 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_hdlc/demultiplexer.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+// Records the last frame passed to it.
+class RecordingHandler : public FrameHandler {
+ public:
+  void HandleFrame(const Frame& frame) final {
+    frames_ += 1;
+    address_ = frame.address();
+    data_ = frame.data();
+  }
+
+  size_t frames() const { return frames_; }
+  uint64_t address() const { return address_; }
+  ConstByteSpan data() const { return data_; }
+
+ private:
+  size_t frames_ = 0;
+  uint64_t address_ = 0;
+  ConstByteSpan data_;
+};
+
+class Demux : public ::testing::Test {
+ protected:
+  static constexpr auto kPayload = bytes::String("hello");
+
+  Demux() : encoded_{}, writer_(encoded_) {}
+
+  Frame EncodeAndParse(uint64_t address) {
+    stream::MemoryWriter writer(frame_buffer_);
+    EXPECT_EQ(OkStatus(), WriteUIFrame(address, kPayload, writer));
+    size_t bytes_processed;
+    return decoder_.ProcessUntilFrame(writer.WrittenData(), &bytes_processed)
+        .value();
+  }
+
+  DemultiplexerBuffer<8> demux_;
+  RecordingHandler log_;
+  RecordingHandler rpc_;
+  DecoderBuffer<32> decoder_;
+  std::array<std::byte, 32> frame_buffer_;
+  std::array<std::byte, 128> encoded_;
+  stream::MemoryWriter writer_;
+};
+
+TEST_F(Demux, RegisterHandler) {
+  EXPECT_EQ(8u, demux_.max_addresses());
+  EXPECT_EQ(OkStatus(), demux_.RegisterHandler(0, log_));
+  EXPECT_EQ(OkStatus(), demux_.RegisterHandler(7, rpc_));
+  EXPECT_EQ(Status::AlreadyExists(), demux_.RegisterHandler(7, log_));
+  EXPECT_EQ(Status::InvalidArgument(), demux_.RegisterHandler(8, log_));
+}
+
+TEST_F(Demux, UnregisterHandler) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(3, log_));
+  EXPECT_EQ(OkStatus(), demux_.UnregisterHandler(3));
+  EXPECT_EQ(Status::NotFound(), demux_.UnregisterHandler(3));
+  EXPECT_EQ(Status::NotFound(), demux_.UnregisterHandler(100));
+
+  EXPECT_EQ(Status::NotFound(), demux_.HandleFrame(EncodeAndParse(3)));
+  EXPECT_EQ(0u, log_.frames());
+  EXPECT_EQ(OkStatus(), demux_.RegisterHandler(3, rpc_));
+}
+
+TEST_F(Demux, HandleFrame_DispatchesByAddress) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(1, log_));
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(2, rpc_));
+
+  EXPECT_EQ(OkStatus(), demux_.HandleFrame(EncodeAndParse(2)));
+  EXPECT_EQ(0u, log_.frames());
+  EXPECT_EQ(1u, rpc_.frames());
+  EXPECT_EQ(2u, rpc_.address());
+
+  EXPECT_EQ(OkStatus(), demux_.HandleFrame(EncodeAndParse(1)));
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(1u, log_.address());
+  EXPECT_EQ(0u, demux_.dropped_frames());
+}
+
+TEST_F(Demux, HandleFrame_DropsUnhandledAddresses) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(1, log_));
+
+  EXPECT_EQ(Status::NotFound(), demux_.HandleFrame(EncodeAndParse(2)));
+  EXPECT_EQ(Status::NotFound(), demux_.HandleFrame(EncodeAndParse(1000)));
+  EXPECT_EQ(0u, log_.frames());
+  EXPECT_EQ(2u, demux_.dropped_frames());
+}
+
+TEST_F(Demux, HandleFrame_DefaultHandler) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(1, log_));
+  demux_.set_default_handler(&rpc_);
+
+  EXPECT_EQ(OkStatus(), demux_.HandleFrame(EncodeAndParse(1000)));
+  EXPECT_EQ(1u, rpc_.frames());
+  EXPECT_EQ(1000u, rpc_.address());
+
+  EXPECT_EQ(OkStatus(), demux_.HandleFrame(EncodeAndParse(1)));
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(1u, rpc_.frames());
+
+  demux_.set_default_handler(nullptr);
+  EXPECT_EQ(Status::NotFound(), demux_.HandleFrame(EncodeAndParse(1000)));
+  EXPECT_EQ(1u, demux_.dropped_frames());
+}
+
+TEST_F(Demux, Process_DispatchesFramesWithoutCopying) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(1, log_));
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(5, rpc_));
+
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, kPayload, writer_));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(5, kPayload, writer_));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(6, kPayload, writer_));
+  ConstByteSpan data = writer_.WrittenData();
+
+  DecoderBuffer<32> decoder;
+  demux_.Process(decoder, data);
+
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(1u, rpc_.frames());
+  EXPECT_EQ(1u, demux_.dropped_frames());
+  EXPECT_EQ(0u, demux_.invalid_frames());
+
+  // The last frame's data references the input directly.
+  ASSERT_EQ(kPayload.size(), rpc_.data().size());
+  EXPECT_GE(rpc_.data().data(), data.data());
+  EXPECT_LT(rpc_.data().data(), data.data() + data.size());
+}
+
+TEST_F(Demux, Process_CountsInvalidFrames) {
+  ASSERT_EQ(OkStatus(), demux_.RegisterHandler(1, log_));
+
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, kPayload, writer_));
+  std::array<std::byte, 64> data;
+  ConstByteSpan encoded = writer_.WrittenData();
+  std::copy(encoded.begin(), encoded.end(), data.begin());
+  data[3] ^= std::byte{0x01};  // Corrupt the payload.
+
+  DecoderBuffer<32> decoder;
+  demux_.Process(decoder, std::span(data).first(encoded.size()));
+  demux_.Process(decoder, encoded);
+
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(1u, demux_.invalid_frames());
+  EXPECT_EQ(0u, demux_.dropped_frames());
+}
+
+}  // namespace
+}  // namespace pw::hdlc
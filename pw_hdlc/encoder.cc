@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <span>
 
@@ -29,33 +30,94 @@ using std::byte;
 namespace pw::hdlc {
 namespace internal {
 
-Status EscapeAndWrite(const byte b, stream::Writer& writer) {
-  if (b == kFlag) {
-    return writer.Write(kEscapedFlag);
+namespace {
+
+// Returns the first byte in [begin, end) that must be escaped, or end. Checks a
+// word at a time, since most data has no bytes to escape.
+const byte* FindByteToEscape(const byte* begin, const byte* end) {
+  using Word = uintptr_t;
+  constexpr Word kOnes = ~Word(0) / 0xFF;  // 0x01 in every byte
+  constexpr Word kHighBits = kOnes * 0x80;
+  constexpr Word kFlags = kOnes * static_cast<uint8_t>(kFlag);
+  constexpr Word kEscapes = kOnes * static_cast<uint8_t>(kEscape);
+
+  while (static_cast<size_t>(end - begin) >= sizeof(Word)) {
+    Word word;
+    std::memcpy(&word, begin, sizeof(word));
+
+    // A byte of word ^ kFlags or word ^ kEscapes is zero if the corresponding
+    // byte of the word is a flag or escape. (x - kOnes) & ~x & kHighBits is
+    // nonzero if and only if x has a zero byte.
+    const Word flags = word ^ kFlags;
+    const Word escapes = word ^ kEscapes;
+    if ((((flags - kOnes) & ~flags) | ((escapes - kOnes) & ~escapes)) &
+        kHighBits) {
+      break;
+    }
+    begin += sizeof(Word);
   }
-  if (b == kEscape) {
-    return writer.Write(kEscapedEscape);
+
+  return std::find_if(begin, end, NeedsEscaping);
+}
+
+// Escapes data into output, which must have room for the escaped data. Returns
+// the number of bytes written.
+size_t EscapeInto(ConstByteSpan data, byte* output) {
+  const byte* begin = data.data();
+  const byte* const end = data.data() + data.size();
+  byte* out = output;
+
+  while (begin != end) {
+    const byte* const unescaped_end = FindByteToEscape(begin, end);
+    std::memcpy(out, begin, unescaped_end - begin);
+    out += unescaped_end - begin;
+    begin = unescaped_end;
+
+    if (begin != end) {
+      *out++ = kEscape;
+      *out++ = Escape(*begin++);
+    }
   }
-  return writer.Write(b);
+
+  return out - output;
 }
 
-Status Encoder::WriteData(ConstByteSpan data) {
-  auto begin = data.begin();
-  while (true) {
-    auto end = std::find_if(begin, data.end(), NeedsEscaping);
+}  // namespace
 
-    if (Status status = writer_.Write(std::span(begin, end)); !status.ok()) {
-      return status;
+Status Encoder::WriteData(ConstByteSpan data) {
+  const byte* begin = data.data();
+  const byte* const end = data.data() + data.size();
+
+  while (begin != end) {
+    // Write the bytes that do not need escaping with a single write.
+    const byte* const unescaped_end = FindByteToEscape(begin, end);
+    if (unescaped_end != begin) {
+      if (Status status = writer_.Write(std::span(begin, unescaped_end));
+          !status.ok()) {
+        return status;
+      }
+      begin = unescaped_end;
     }
-    if (end == data.end()) {
-      fcs_.Update(data);
-      return OkStatus();
+
+    // Escape a run of consecutive bytes that need escaping in one write.
+    std::array<byte, 16> escaped;
+    size_t escaped_size = 0;
+    while (begin != end && NeedsEscaping(*begin) &&
+           escaped_size < escaped.size()) {
+      escaped[escaped_size++] = kEscape;
+      escaped[escaped_size++] = Escape(*begin++);
     }
-    if (Status status = EscapeAndWrite(*end, writer_); !status.ok()) {
-      return status;
+    if (escaped_size != 0u) {
+      if (Status status =
+              writer_.Write(std::span(escaped).first(escaped_size));
+          !status.ok()) {
+        return status;
+      }
     }
-    begin = end + 1;
   }
+
+  fcs_.Update(data);
+  return OkStatus();
 }
 
 Status Encoder::FinishFrame() {
@@ -116,4 +178,48 @@ Status WriteUIFrame(uint64_t address,
   return encoder.FinishFrame();
 }
 
+StatusWithSize WriteUIFrame(uint64_t address,
+                            ConstByteSpan payload,
+                            ByteSpan output) {
+  // MaxEncodedSize does not include the opening and closing flags.
+  if (internal::Encoder::MaxEncodedSize(address, payload) + 2 * sizeof(kFlag) >
+      output.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  std::array<byte, 16> metadata_buffer;
+  size_t metadata_size =
+      varint::Encode(address, metadata_buffer, kAddressFormat);
+  if (metadata_size == 0) {
+    return StatusWithSize::InvalidArgument();
+  }
+  metadata_buffer[metadata_size++] =
+      UFrameControl::UnnumberedInformation().data();
+  const auto metadata = std::span(metadata_buffer).first(metadata_size);
+
+  checksum::Crc32 fcs;
+  fcs.Update(metadata);
+  fcs.Update(payload);
+
+  byte* out = output.data();
+  *out++ = kFlag;
+  out += internal::EscapeInto(metadata, out);
+  out += internal::EscapeInto(payload, out);
+  out += internal::EscapeInto(
+      bytes::CopyInOrder(std::endian::little, fcs.value()), out);
+  *out++ = kFlag;
+
+  return StatusWithSize(out - output.data());
+}
+
+size_t MaxSafePayloadSize(uint64_t address, size_t frame_size) {
+  constexpr size_t kFcsMaxSize = 8;  // Worst case FCS: 0x7e7e7e7e.
+  const size_t overhead = 2 * sizeof(kFlag) + varint::EncodedSize(address) * 2 +
+                          sizeof(std::byte) /* control */ + kFcsMaxSize;
+  if (frame_size <= overhead) {
+    return 0;
+  }
+  return (frame_size - overhead) / 2;  // Every byte could be escaped.
+}
+
 }  // namespace pw::hdlc
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
@@ -192,6 +193,61 @@ TEST(WriteUnnumberedFrame, WriterError) {
             WriteUIFrame(kAddress, bytes::Array<0x01>(), writer));
 }
 
+TEST_F(WriteUnnumberedFrame, ToBuffer_MatchesWriter) {
+  constexpr auto kPayload =
+      bytes::Array<0x7E, 0x7B, 0x61, 0x62, 0x63, 0x7D, 0x7E>();
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayload, writer_));
+
+  std::array<byte, 32> output;
+  StatusWithSize result = WriteUIFrame(kAddress, kPayload, output);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(writer_.bytes_written(), result.size());
+  EXPECT_EQ(0, std::memcmp(writer_.data(), output.data(), result.size()));
+}
+
+TEST(WriteUIFrameToBuffer, EscapedAddress) {
+  std::array<byte, 32> output;
+  StatusWithSize result =
+      WriteUIFrame(0x3e, bytes::String("hello"), std::span(output));
+  ASSERT_EQ(OkStatus(), result.status());
+
+  // 0x3e encodes to 0x7d, which is escaped.
+  constexpr auto kExpected = bytes::Concat(kFlag,
+                                           kEscape,
+                                           byte{0x7d} ^ byte{0x20},
+                                           kUnnumberedControl,
+                                           bytes::String("hello"),
+                                           uint32_t{0x66754da0},
+                                           kFlag);
+  ASSERT_EQ(kExpected.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), output.data(), result.size()));
+}
+
+TEST(WriteUIFrameToBuffer, BufferTooSmall) {
+  constexpr auto kPayload = bytes::Initialized<16>(0x7e);
+  std::array<byte, 32> output;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            WriteUIFrame(kAddress, kPayload, output).status());
+}
+
+TEST(MaxSafePayloadSize, AllEscapedPayloadFits) {
+  std::array<byte, 32> output;
+  const size_t max_payload = MaxSafePayloadSize(kAddress, output.size());
+  ASSERT_EQ(9u, max_payload);
+
+  constexpr auto kPayload = bytes::Initialized<10>(0x7e);
+  const auto payload = std::span(kPayload).first(max_payload);
+  EXPECT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, output).status());
+  EXPECT_EQ(Status::ResourceExhausted(),
+            WriteUIFrame(kAddress, kPayload, output).status());
+}
+
+TEST(MaxSafePayloadSize, FrameTooSmall) {
+  EXPECT_EQ(0u, MaxSafePayloadSize(kAddress, 0));
+  EXPECT_EQ(0u, MaxSafePayloadSize(kAddress, 13));
+  EXPECT_EQ(1u, MaxSafePayloadSize(kAddress, 15));
+}
+
 }  // namespace
 
 namespace internal {
@@ -222,6 +278,85 @@ TEST(Encoder, MaxEncodedSize_PayloadWithAllEscapes) {
   EXPECT_EQ(27u, Encoder::MaxEncodedSize(kEscapeAddress, data));
 }
 
+// Records the encoded data and the number of writes.
+class CountingWriter : public stream::NonSeekableWriter {
+ public:
+  ConstByteSpan data() const { return std::span(buffer_).first(size_); }
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    if (data.size() > buffer_.size() - size_) {
+      return Status::ResourceExhausted();
+    }
+    std::memcpy(buffer_.data() + size_, data.data(), data.size());
+    size_ += data.size();
+    writes_ += 1;
+    return OkStatus();
+  }
+
+  std::array<byte, 512> buffer_;
+  size_t size_ = 0;
+  size_t writes_ = 0;
+};
+
+TEST(Encoder, WriteData_UnescapedRunIsOneWrite) {
+  constexpr auto data = bytes::Initialized<64>(0x42);
+  CountingWriter writer;
+  Encoder encoder(writer);
+
+  ASSERT_EQ(OkStatus(), encoder.WriteData(data));
+  EXPECT_EQ(1u, writer.writes());
+  ASSERT_EQ(data.size(), writer.data().size());
+  EXPECT_EQ(0, std::memcmp(data.data(), writer.data().data(), data.size()));
+}
+
+TEST(Encoder, WriteData_ConsecutiveEscapesAreOneWrite) {
+  constexpr auto data = bytes::Array<0x01, 0x7e, 0x7d, 0x7e, 0x02>();
+  constexpr auto expected =
+      bytes::Array<0x01, 0x7d, 0x5e, 0x7d, 0x5d, 0x7d, 0x5e, 0x02>();
+  CountingWriter writer;
+  Encoder encoder(writer);
+
+  ASSERT_EQ(OkStatus(), encoder.WriteData(data));
+  EXPECT_EQ(3u, writer.writes());
+  ASSERT_EQ(expected.size(), writer.data().size());
+  EXPECT_EQ(
+      0, std::memcmp(expected.data(), writer.data().data(), expected.size()));
+}
+
+TEST(Encoder, WriteData_EscapesAtEveryOffset) {
+  // Place escaped bytes at each position relative to word boundaries and check
+  // the output against a byte-at-a-time encoding.
+  for (size_t offset = 0; offset < 24; ++offset) {
+    std::array<byte, 48> data;
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<byte>(i);
+    }
+    data[offset] = kFlag;
+    data[offset + 9] = kEscape;
+    data[offset + 10] = kFlag;
+
+    std::array<byte, 2 * data.size()> expected;
+    size_t expected_size = 0;
+    for (byte b : data) {
+      if (NeedsEscaping(b)) {
+        expected[expected_size++] = kEscape;
+        expected[expected_size++] = Escape(b);
+      } else {
+        expected[expected_size++] = b;
+      }
+    }
+
+    CountingWriter writer;
+    Encoder encoder(writer);
+    ASSERT_EQ(OkStatus(), encoder.WriteData(data));
+    ASSERT_EQ(expected_size, writer.data().size());
+    EXPECT_EQ(
+        0, std::memcmp(expected.data(), writer.data().data(), expected_size));
+  }
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace pw::hdlc
@@ -95,12 +95,26 @@ class Decoder {
   //
   Result<Frame> Process(std::byte new_byte);
 
+  // Processes bytes from data until a frame completes or all of the data is
+  // processed. Runs of bytes without flags or escapes are copied and added to
+  // the frame check sequence in bulk, which is much faster than calling
+  // Process(std::byte) for each byte. Sets bytes_processed to the number of
+  // bytes consumed and returns the same statuses as Process(std::byte). Call
+  // again with the remaining data to decode the frames that follow.
+  //
+  // If a frame is entirely within data and has no escaped bytes, the returned
+  // Frame references data instead of the decoder's buffer, so it is not copied.
+  // The Frame is invalidated by the next Process call or when data changes.
+  Result<Frame> ProcessUntilFrame(ConstByteSpan data, size_t* bytes_processed);
+
   // Processes a span of data and calls the provided callback with each frame or
   // error.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      size_t bytes_processed;
+      auto result = ProcessUntilFrame(data, &bytes_processed);
+      data = data.subspan(bytes_processed);
       if (result.status() != Status::Unavailable()) {
         std::invoke(
             std::forward<F>(callback), std::forward<Args>(args)..., result);
@@ -133,9 +147,16 @@ class Decoder {
 
   void AppendByte(std::byte new_byte);
 
-  Status CheckFrame() const;
+  void AppendBytes(ConstByteSpan data);
+
+  Result<Frame> ProcessInPlace(ConstByteSpan frame);
+
+  Status CheckFrame(size_t frame_size,
+                    uint32_t calculated_fcs,
+                    uint32_t received_fcs) const;
 
-  bool VerifyFrameCheckSequence() const;
+  // Returns the FCS of the current frame, which is in last_read_bytes_.
+  uint32_t ReceivedFcs() const;
 
   const ByteSpan buffer_;
 
@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_status/status.h"
+
+namespace pw::hdlc {
+
+// Receives frames from a Demultiplexer. The Frame passed to HandleFrame
+// references either the data passed to the Demultiplexer or the Decoder's
+// buffer, so it is only valid for the duration of the call. Handlers that
+// service frames on another thread should copy the frame data into a queue,
+// such as a pw::ring_buffer::LockFreePrefixedEntryRingBuffer.
+class FrameHandler {
+ public:
+  virtual ~FrameHandler() = default;
+
+  virtual void HandleFrame(const Frame& frame) = 0;
+};
+
+// Dispatches decoded HDLC frames to handlers registered by address. Handlers
+// are stored in a table indexed directly by address, so dispatching a frame is
+// a bounds check and a virtual call; frames are never copied. Addresses must be
+// smaller than the table size.
+//
+// Registering and unregistering handlers is not synchronized with dispatch.
+// Set up the handlers before frames are processed, or synchronize externally.
+//
+// The DemultiplexerBuffer template class, defined below, allocates the table.
+class Demultiplexer {
+ public:
+  constexpr Demultiplexer(std::span<FrameHandler*> handlers)
+      : handlers_(handlers),
+        default_handler_(nullptr),
+        dropped_frames_(0),
+        invalid_frames_(0) {}
+
+  Demultiplexer(const Demultiplexer&) = delete;
+  Demultiplexer& operator=(const Demultiplexer&) = delete;
+
+  // Registers a handler for frames sent to an address. Returns:
+  //
+  //     OK - The handler was registered.
+  //     INVALID_ARGUMENT - The address does not fit in the handler table.
+  //     ALREADY_EXISTS - A handler is already registered for the address.
+  //
+  Status RegisterHandler(uint64_t address, FrameHandler& handler);
+
+  // Removes the handler for an address. Returns NOT_FOUND if no handler is
+  // registered for the address.
+  Status UnregisterHandler(uint64_t address);
+
+  // Sets a handler for frames with addresses that have no registered handler.
+  // Pass nullptr to drop these frames instead.
+  void set_default_handler(FrameHandler* handler) {
+    default_handler_ = handler;
+  }
+
+  // Passes a frame to the handler for its address, or to the default handler.
+  // Returns NOT_FOUND and counts the frame as dropped if there is no handler.
+  Status HandleFrame(const Frame& frame);
+
+  // Decodes data with the decoder and dispatches each frame. Frames that fail
+  // to decode are counted as invalid. Frames that are entirely within data are
+  // passed to their handlers without being copied.
+  void Process(Decoder& decoder, ConstByteSpan data);
+
+  // The number of frames that were dropped because no handler was registered
+  // for their address.
+  size_t dropped_frames() const { return dropped_frames_; }
+
+  // The number of frames the decoder rejected in Process.
+  size_t invalid_frames() const { return invalid_frames_; }
+
+  // The number of addresses that handlers may be registered for.
+  size_t max_addresses() const { return handlers_.size(); }
+
+ private:
+  const std::span<FrameHandler*> handlers_;
+  FrameHandler* default_handler_;
+  size_t dropped_frames_;
+  size_t invalid_frames_;
+};
+
+// DemultiplexerBuffers declare a handler table for addresses 0 through
+// kAddressCount - 1 along with a Demultiplexer.
+template <size_t kAddressCount>
+class DemultiplexerBuffer : public Demultiplexer {
+ public:
+  DemultiplexerBuffer() : Demultiplexer(handler_table_), handler_table_{} {}
+
+ private:
+  static_assert(kAddressCount > 0u);
+
+  std::array<FrameHandler*, kAddressCount> handler_table_;
+};
+
+}  // namespace pw::hdlc
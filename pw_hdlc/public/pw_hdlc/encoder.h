@@ -15,6 +15,7 @@
 
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
@@ -33,4 +34,16 @@ Status WriteUIFrame(uint64_t address,
                     ConstByteSpan payload,
                     stream::Writer& writer);
 
+// Encodes an HDLC UI-frame into the provided buffer, which avoids a write call
+// for each part of the frame. Returns the encoded size on success, or
+// RESOURCE_EXHAUSTED if the buffer may be too small for the encoded frame.
+StatusWithSize WriteUIFrame(uint64_t address,
+                            ConstByteSpan payload,
+                            ByteSpan output);
+
+// Returns the largest payload that is guaranteed to fit in a UI-frame of at
+// most frame_size bytes, flags included, even if every payload byte must be
+// escaped. Returns 0 if the frame is too small for any payload.
+size_t MaxSafePayloadSize(uint64_t address, size_t frame_size);
+
 }  // namespace pw::hdlc
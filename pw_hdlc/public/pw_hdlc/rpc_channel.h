@@ -17,6 +17,7 @@
 #include <span>
 
 #include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
 #include "pw_hdlc/encoder.h"
 #include "pw_rpc/channel.h"
 #include "pw_stream/stream.h"
@@ -36,15 +37,59 @@ class RpcChannelOutput : public rpc::ChannelOutput {
   constexpr RpcChannelOutput(stream::Writer& writer,
                              uint64_t address,
                              const char* channel_name)
-      : ChannelOutput(channel_name), writer_(writer), address_(address) {}
+      : RpcChannelOutput(writer, {}, address, channel_name) {}
+
+  // Encodes each frame into encode_buffer and sends it with a single write.
+  // Frames that may not fit in the buffer are written to the writer in pieces.
+  constexpr RpcChannelOutput(stream::Writer& writer,
+                             ByteSpan encode_buffer,
+                             uint64_t address,
+                             const char* channel_name)
+      : ChannelOutput(channel_name),
+        writer_(writer),
+        encode_buffer_(encode_buffer),
+        address_(address) {}
 
   Status Send(std::span<const std::byte> buffer) override {
+    if (!encode_buffer_.empty()) {
+      const StatusWithSize encoded =
+          hdlc::WriteUIFrame(address_, buffer, encode_buffer_);
+      if (encoded.ok()) {
+        return writer_.Write(encode_buffer_.first(encoded.size()));
+      }
+    }
     return hdlc::WriteUIFrame(address_, buffer, writer_);
   }
 
+  // If frames are encoded in a buffer, packets are limited to the largest that
+  // is sure to fit in it, so each packet is sent with a single write.
+  size_t MaximumTransmissionUnit() override {
+    if (encode_buffer_.empty()) {
+      return kUnlimited;
+    }
+    return MaxSafePayloadSize(address_, encode_buffer_.size());
+  }
+
  private:
   stream::Writer& writer_;
+  const ByteSpan encode_buffer_;
   const uint64_t address_;
 };
 
+// An RpcChannelOutput with a buffer for encoding frames, so that each frame is
+// sent with one write to the underlying writer. The buffer should be large
+// enough for the channel's largest encoded packet.
+template <size_t kEncodeBufferSizeBytes>
+class RpcChannelOutputBuffer : public RpcChannelOutput {
+ public:
+  constexpr RpcChannelOutputBuffer(stream::Writer& writer,
+                                   uint64_t address,
+                                   const char* channel_name)
+      : RpcChannelOutput(writer, encode_buffer_, address, channel_name),
+        encode_buffer_{} {}
+
+ private:
+  std::array<std::byte, kEncodeBufferSizeBytes> encode_buffer_;
+};
+
 }  // namespace pw::hdlc
@@ -23,10 +23,22 @@ namespace pw::hdlc {
 // first decode them from their wire format.
 class WirePacketParser : public router::PacketParser {
  public:
-  constexpr WirePacketParser() : address_(0) {}
+  // Whether Parse() checks each frame's FCS. Skip the check only when the link
+  // layer has already verified the frames, such as when routing frames that
+  // were received through a Decoder.
+  enum class FrameCheck {
+    kVerify,
+    kSkip,
+  };
+
+  constexpr WirePacketParser(FrameCheck frame_check = FrameCheck::kVerify)
+      : frame_check_(frame_check), address_(0) {}
 
   // Verifies and parses an HDLC frame. Packet passed in is expected to be a
   // single, complete, wire-encoded frame, starting and ending with a flag.
+  //
+  // With FrameCheck::kSkip, only the frame's address is decoded, so the rest of
+  // the frame is not examined.
   bool Parse(ConstByteSpan packet) final;
 
   std::optional<uint32_t> GetDestinationAddress() const override {
@@ -37,6 +49,11 @@ class WirePacketParser : public router::PacketParser {
   constexpr uint64_t address() const { return address_; }
 
  private:
+  // Unescapes and decodes the address field without reading the rest of the
+  // frame.
+  bool ParseAddressOnly(ConstByteSpan packet);
+
+  FrameCheck frame_check_;
   uint64_t address_;
 };
 
@@ -144,5 +144,86 @@ TEST(RpcChannelOutputBuffer, MultibyteAddress) {
       0);
 }
 
+// Counts writes to check that buffered frames are sent with one write.
+class CountingWriter : public stream::NonSeekableWriter {
+ public:
+  CountingWriter(stream::Writer& writer) : writer_(writer) {}
+
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  stream::Writer& writer_;
+  size_t writes_ = 0;
+};
+
+TEST(RpcChannelOutputBuffer, SendsFrameWithOneWrite) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+  CountingWriter writer(memory_writer);
+
+  RpcChannelOutputBuffer<32> output(writer, kAddress, "RpcChannelOutput");
+
+  constexpr auto test_data = bytes::Array<0x7D>();
+  constexpr auto expected = bytes::Concat(kFlag,
+                                          kEncodedAddress,
+                                          kControl,
+                                          byte{0x7d},
+                                          byte{0x7d} ^ byte{0x20},
+                                          uint32_t{0x4a53e205},
+                                          kFlag);
+  EXPECT_EQ(OkStatus(), output.Send(test_data));
+  EXPECT_EQ(1u, writer.writes());
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.size());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutputBuffer, FrameLargerThanBuffer) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+  CountingWriter writer(memory_writer);
+
+  RpcChannelOutputBuffer<8> output(writer, kAddress, "RpcChannelOutput");
+
+  constexpr auto expected = bytes::Concat(
+      kFlag, kEncodedAddress, kControl, 'A', uint32_t{0x653c9e82}, kFlag);
+  EXPECT_EQ(OkStatus(), output.Send(bytes::String("A")));
+  EXPECT_GT(writer.writes(), 1u);
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.size());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutput, MaximumTransmissionUnit_Unbuffered) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+  RpcChannelOutput output(memory_writer, kAddress, "RpcChannelOutput");
+
+  EXPECT_EQ(rpc::ChannelOutput::kUnlimited, output.MaximumTransmissionUnit());
+}
+
+TEST(RpcChannelOutputBuffer, MaximumTransmissionUnit_FitsInBuffer) {
+  stream::MemoryWriterBuffer<64> memory_writer;
+  CountingWriter writer(memory_writer);
+  RpcChannelOutputBuffer<32> output(writer, kAddress, "RpcChannelOutput");
+
+  const size_t mtu = output.MaximumTransmissionUnit();
+  EXPECT_EQ(MaxSafePayloadSize(kAddress, 32), mtu);
+
+  // A packet of all flag bytes is escaped to twice its size.
+  std::array<byte, 32> packet;
+  packet.fill(kFlag);
+  EXPECT_EQ(OkStatus(), output.Send(std::span(packet).first(mtu)));
+  EXPECT_EQ(1u, writer.writes());
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -14,6 +14,8 @@
 
 #include "pw_hdlc/wire_packet_parser.h"
 
+#include <array>
+
 #include "pw_bytes/endian.h"
 #include "pw_checksum/crc32.h"
 #include "pw_hdlc/decoder.h"
@@ -30,25 +32,80 @@ bool WirePacketParser::Parse(ConstByteSpan packet) {
     return false;
   }
 
+  if (frame_check_ == FrameCheck::kSkip) {
+    return ParseAddressOnly(packet);
+  }
+
   // Partially decode into a buffer with space only for the address and control
   // fields of the frame. The decoder will verify the frame's FCS field.
   std::array<std::byte, 16> buffer = {};
   Decoder decoder(buffer);
   Status status = Status::Unknown();
+  uint64_t address = 0;
 
-  decoder.Process(packet, [&status](const Result<Frame>& result) {
+  decoder.Process(packet, [&](const Result<Frame>& result) {
     status = result.status();
+    if (result.ok()) {
+      // The frame may reference the packet rather than the buffer.
+      address = result.value().address();
+    }
   });
 
-  Result<Frame> result = Frame::Parse(buffer);
-  if (!result.ok()) {
+  // RESOURCE_EXHAUSTED is expected as the buffer is too small for the packet.
+  if (status.IsResourceExhausted()) {
+    Result<Frame> result = Frame::Parse(buffer);
+    if (!result.ok()) {
+      return false;
+    }
+    address = result.value().address();
+  } else if (!status.ok()) {
     return false;
   }
 
-  address_ = result.value().address();
+  address_ = address;
+  return true;
+}
+
+bool WirePacketParser::ParseAddressOnly(ConstByteSpan packet) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> address_bytes;
+  size_t address_size = 0;
+  bool escape = false;
 
-  // RESOURCE_EXHAUSTED is expected as the buffer is too small for the packet.
-  return status.ok() || status.IsResourceExhausted();
+  // Skip the opening flag. The address ends with the first byte that has the
+  // low bit set.
+  for (std::byte b : packet.subspan(1, packet.size() - 2)) {
+    if (b == kFlag) {
+      return false;
+    }
+    if (b == kEscape) {
+      if (escape) {
+        return false;
+      }
+      escape = true;
+      continue;
+    }
+    if (escape) {
+      b = Escape(b);
+      escape = false;
+    }
+
+    address_bytes[address_size++] = b;
+    if ((b & std::byte{0x1}) != std::byte{0}) {
+      uint64_t address;
+      if (varint::Decode(std::span(address_bytes).first(address_size),
+                         &address,
+                         kAddressFormat) == 0u) {
+        return false;
+      }
+      address_ = address;
+      return true;
+    }
+    if (address_size == address_bytes.size()) {
+      return false;
+    }
+  }
+
+  return false;
 }
 
 }  // namespace pw::hdlc
@@ -146,5 +146,63 @@ TEST(WirePacketParser, Parse_EmptyPacket) {
   EXPECT_FALSE(parser.Parse({}));
 }
 
+TEST(WirePacketParser, SkipFrameCheck_IgnoresFcs) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_TRUE(parser.Parse(bytes::Concat(kFlag,
+                                         kEncodedAddress,
+                                         kControl,
+                                         bytes::String("hello"),
+                                         0x1badda7a,
+                                         kFlag)));
+  auto maybe_address = parser.GetDestinationAddress();
+  EXPECT_TRUE(maybe_address.has_value());
+  EXPECT_EQ(maybe_address.value(), kAddress);
+}
+
+TEST(WirePacketParser, SkipFrameCheck_MultibyteAddress) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_TRUE(parser.Parse(bytes::Concat(kFlag,
+                                         bytes::String("\xfe\xff"),
+                                         kControl,
+                                         bytes::String("hello"),
+                                         0x6b53b014,
+                                         kFlag)));
+  EXPECT_EQ(parser.GetDestinationAddress().value(), 0x3fffu);
+}
+
+TEST(WirePacketParser, SkipFrameCheck_EscapedAddress) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_TRUE(parser.Parse(bytes::Concat(kFlag,
+                                         kEscapedEscape,
+                                         kControl,
+                                         kEscapedEscape,
+                                         kEscapedFlag,
+                                         kEscapedFlag,
+                                         0x8ffd8fcd,
+                                         kFlag)));
+  EXPECT_EQ(parser.GetDestinationAddress().value(), 62u);
+}
+
+TEST(WirePacketParser, SkipFrameCheck_DoubleEscapeInAddress) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_FALSE(parser.Parse(bytes::Concat(kFlag,
+                                          kEscape,
+                                          kEscapedEscape,
+                                          kControl,
+                                          bytes::String("hello"),
+                                          kFlag)));
+}
+
+TEST(WirePacketParser, SkipFrameCheck_UnterminatedAddress) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_FALSE(parser.Parse(bytes::Concat(
+      kFlag, bytes::String("\x02\x04\x06\x08\x0a\x0c"), kFlag)));
+}
+
+TEST(WirePacketParser, SkipFrameCheck_EmptyPacket) {
+  WirePacketParser parser(WirePacketParser::FrameCheck::kSkip);
+  EXPECT_FALSE(parser.Parse({}));
+}
+
 }  // namespace
 }  // namespace pw::hdlc
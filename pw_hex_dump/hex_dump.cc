@@ -14,11 +14,12 @@
 
 #include "pw_hex_dump/hex_dump.h"
 
-#include <cctype>
 #include <cstddef>
+#include <cstring>
 #include <string_view>
 
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
 #include "pw_string/string_builder.h"
 #include "pw_string/type_to_string.h"
 
@@ -37,11 +38,11 @@ constexpr const std::string_view kAsciiHeader("Text");
 // Minimum number of hex characters to use when displaying dump offset.
 constexpr const size_t kMinOffsetChars = 4;
 
-char PrintableChar(std::byte b) {
-  if (std::isprint(std::to_integer<char>(b)) == 0) {
-    return '.';
-  }
-  return std::to_integer<char>(b);
+constexpr const char kHexDigits[] = "0123456789abcdef";
+
+// Matches std::isprint() in the "C" locale.
+constexpr char PrintableChar(uint8_t value) {
+  return value >= 0x20 && value < 0x7f ? static_cast<char>(value) : '.';
 }
 
 void AddGroupingByte(size_t byte_index,
@@ -166,36 +167,85 @@ Status FormattedHexDumper::DumpLine() {
     builder << kAddressSeparator;
   }
 
-  size_t bytes_in_line = std::min(source_data_.size_bytes(),
-                                  static_cast<size_t>(flags.bytes_per_line));
-  // Convert raw bytes to hex characters.
-  for (size_t i = 0; i < bytes_in_line; ++i) {
-    // Early loop termination for when bytes_remaining <
-    // bytes_per_line.
-    builder << source_data_[i];
-    AddGroupingByte(i, flags, builder);
+  const size_t bytes_per_line = flags.bytes_per_line;
+  const size_t group_every = flags.group_every;
+  const size_t bytes_in_line =
+      std::min(source_data_.size_bytes(), bytes_per_line);
+  // Pad partial lines with spaces so the ASCII column stays aligned.
+  const size_t columns = flags.show_ascii ? bytes_per_line : bytes_in_line;
+
+  // Grouping spaces follow every group_every columns, except the last column
+  // of a full line.
+  size_t grouping_spaces = 0;
+  if (group_every != 0) {
+    grouping_spaces = columns == bytes_per_line ? (columns - 1) / group_every
+                                                : columns / group_every;
   }
-  // Add padding spaces to ensure lines are aligned.
+
+  size_t line_size = builder.size() + 2 * columns + grouping_spaces;
   if (flags.show_ascii) {
-    for (size_t i = bytes_in_line;
-         i < static_cast<size_t>(flags.bytes_per_line);
-         ++i) {
-      builder.append(2, ' ');
-      AddGroupingByte(i, flags, builder);
+    line_size += kSectionSeparator.size() + bytes_in_line;
+  }
+
+  const ConstByteSpan line = source_data_.first(bytes_in_line);
+  source_data_ = source_data_.subspan(bytes_in_line);
+  current_offset_ += bytes_in_line;
+
+  if (!builder.ok() || line_size >= dest_.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  // Write the hex and ASCII columns directly to the buffer with lookup tables
+  // rather than formatting each byte.
+  char* out = dest_.data() + builder.size();
+  size_t group_remaining = group_every;
+  for (size_t i = 0; i < columns; ++i) {
+    if (i < bytes_in_line) {
+      const uint8_t value = std::to_integer<uint8_t>(line[i]);
+      out[0] = kHexDigits[value >> 4];
+      out[1] = kHexDigits[value & 0xf];
+    } else {
+      out[0] = ' ';
+      out[1] = ' ';
+    }
+    out += 2;
+
+    if (group_remaining != 0 && --group_remaining == 0) {
+      group_remaining = group_every;
+      if (i + 1 != bytes_per_line) {
+        *out++ = ' ';
+      }
     }
   }
 
-  // Interpret bytes as characters.
   if (flags.show_ascii) {
-    builder << kSectionSeparator;
-    for (size_t i = 0; i < bytes_in_line; ++i) {
-      builder << PrintableChar(source_data_[i]);
+    std::memcpy(out, kSectionSeparator.data(), kSectionSeparator.size());
+    out += kSectionSeparator.size();
+    for (std::byte b : line) {
+      *out++ = PrintableChar(std::to_integer<uint8_t>(b));
     }
   }
 
-  source_data_ = source_data_.subspan(bytes_in_line);
-  current_offset_ += bytes_in_line;
-  return builder.status();
+  *out = '\0';
+  return OkStatus();
+}
+
+Status FormattedHexDumper::DumpToWriter(ConstByteSpan data,
+                                        stream::Writer& writer) {
+  if (flags.bytes_per_line == 0) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY(BeginDump(data));
+
+  while (!source_data_.empty()) {
+    PW_TRY(DumpLine());
+
+    // Replace the null terminator with a newline to write the line at once.
+    const size_t length = std::strlen(dest_.data());
+    dest_[length] = '\n';
+    PW_TRY(writer.Write(dest_.data(), length + 1));
+  }
+  return OkStatus();
 }
 
 Status FormattedHexDumper::SetLineBuffer(std::span<char> dest) {
@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::dump {
 namespace {
@@ -403,6 +404,43 @@ TEST_F(SmallBuffer, PrefixIncreasesBufferRequirement) {
   EXPECT_STREQ(expected, dest_.data());
 }
 
+TEST_F(HexDump, DumpToWriter) {
+  constexpr std::string_view expected =
+      "Offs. 00 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f  Text\n"
+      "0000: a4 cc 32 62 9b 46 38 1a 23 1a 2a 7a bc e2 40 a0  "
+      "..2b.F8.#.*z..@.\n"
+      "0010: ff 33 e5 2b 9e 9f 6b 3c be 9b 89 3c 7e 4a 7a 48  "
+      ".3.+..k<...<~JzH\n"
+      "0020: 18                                               .\n";
+  default_flags_.show_ascii = true;
+  default_flags_.show_header = true;
+  default_flags_.prefix_mode = FormattedHexDumper::AddressMode::kOffset;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  std::array<std::byte, 512> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_EQ(dumper_.DumpToWriter(source_data, writer), OkStatus());
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(output.data()),
+                             writer.bytes_written()),
+            expected);
+}
+
+TEST_F(HexDump, DumpToWriter_Empty) {
+  std::array<std::byte, 16> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_EQ(dumper_.DumpToWriter(ConstByteSpan(source_data).first(0), writer),
+            OkStatus());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+}
+
+TEST_F(HexDump, DumpToWriter_WriterError) {
+  std::array<std::byte, 40> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_EQ(dumper_.DumpToWriter(source_data, writer),
+            Status::ResourceExhausted());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+}
+
 TEST(BadBuffer, ZeroSize) {
   char buffer[1] = {static_cast<char>(0xaf)};
   FormattedHexDumper dumper(std::span<char>(buffer, 0));
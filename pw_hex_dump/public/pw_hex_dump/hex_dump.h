@@ -19,6 +19,7 @@
 
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
+#include "pw_stream/stream.h"
 
 namespace pw::dump {
 
@@ -146,6 +147,19 @@ class FormattedHexDumper {
   //     formatting configuration.
   Status DumpLine();
 
+  // Dumps all of the provided data to a writer, formatting each line in the
+  // line buffer. Each line, including the header if enabled, ends with a
+  // newline and is written with a single Write() call.
+  //
+  // Returns:
+  //   OK - All of the data was dumped.
+  //   INVALID_ARGUMENT - The source data starts at null.
+  //   FAILED_PRECONDITION - The line buffer is too small for the current
+  //     formatting settings, or bytes_per_line is zero.
+  //   RESOURCE_EXHAUSTED - A line did not fit in the line buffer.
+  //   Any error returned by the writer.
+  Status DumpToWriter(ConstByteSpan data, stream::Writer& writer);
+
  private:
   Status ValidateBufferSize();
   Status PrintFormatHeader();
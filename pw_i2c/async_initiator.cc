@@ -0,0 +1,78 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/async_initiator.h"
+
+#include <mutex>
+
+namespace pw::i2c {
+
+void AsyncTransactionQueue::Submit(AsyncTransaction& transaction) {
+  {
+    std::lock_guard lock(lock_);
+    if (busy_) {
+      transactions_.push_back(transaction);
+      return;
+    }
+    busy_ = true;
+  }
+  Run(&transaction, nullptr, OkStatus());
+}
+
+void AsyncTransactionQueue::Run(AsyncTransaction* next,
+                                AsyncTransaction* finished,
+                                Status result) {
+  while (true) {
+    // Start the next transaction before running the callback to keep the bus
+    // busy.
+    Status start_status = OkStatus();
+    if (next != nullptr) {
+      current_ = next;
+      start_status = initiator_.StartWriteRead(
+          next->device_address_,
+          next->tx_buffer_,
+          next->rx_buffer_,
+          [this](Status current_result) {
+            AsyncTransaction* const current = current_;
+            Run(TakeNext(), current, current_result);
+          });
+    }
+
+    if (finished != nullptr) {
+      finished->callback_(result);
+    }
+
+    if (start_status.ok()) {
+      return;
+    }
+
+    // The transaction could not be started, so it is finished with the error.
+    finished = next;
+    result = start_status;
+    next = TakeNext();
+  }
+}
+
+AsyncTransaction* AsyncTransactionQueue::TakeNext() {
+  std::lock_guard lock(lock_);
+  if (transactions_.empty()) {
+    busy_ = false;
+    return nullptr;
+  }
+  AsyncTransaction& next = transactions_.front();
+  transactions_.pop_front();
+  return &next;
+}
+
+}  // namespace pw::i2c
@@ -0,0 +1,184 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/async_initiator.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::i2c {
+namespace {
+
+constexpr Address kAddress = Address::SevenBit<0x3F>();
+
+// Records the transaction in progress so the test can complete it.
+class FakeAsyncInitiator : public AsyncInitiator {
+ public:
+  // Completes the transaction in progress with the result.
+  void Complete(Status result) {
+    ASSERT_TRUE(callback_ != nullptr);
+    Callback callback = std::move(callback_);
+    callback_ = nullptr;
+    callback(result);
+  }
+
+  bool busy() const { return callback_ != nullptr; }
+  int started() const { return started_; }
+  ConstByteSpan last_tx_buffer() const { return last_tx_buffer_; }
+
+  // Fails the next attempt to start a transaction with the status.
+  void FailNextStart(Status status) { start_status_ = status; }
+
+ private:
+  Status DoStartWriteRead(Address,
+                          ConstByteSpan tx_buffer,
+                          ByteSpan,
+                          Callback&& callback) override {
+    if (!start_status_.ok()) {
+      return std::exchange(start_status_, OkStatus());
+    }
+    if (busy()) {
+      return Status::Unavailable();
+    }
+    started_ += 1;
+    last_tx_buffer_ = tx_buffer;
+    callback_ = std::move(callback);
+    return OkStatus();
+  }
+
+  Callback callback_;
+  Status start_status_;
+  int started_ = 0;
+  ConstByteSpan last_tx_buffer_;
+};
+
+TEST(AsyncInitiator, StartWrite_InvokesCallbackOnCompletion) {
+  FakeAsyncInitiator initiator;
+  std::array<std::byte, 2> tx = {};
+  Status result = Status::Unknown();
+
+  ASSERT_EQ(OkStatus(), initiator.StartWrite(kAddress, tx, [&](Status s) {
+    result = s;
+  }));
+  EXPECT_EQ(Status::Unknown(), result);
+
+  initiator.Complete(Status::Unavailable());
+  EXPECT_EQ(Status::Unavailable(), result);
+}
+
+class AsyncTransactionQueueTest : public ::testing::Test {
+ protected:
+  AsyncTransactionQueueTest()
+      : queue_(initiator_),
+        first_(kAddress, tx_1_, {}, [this](Status s) { results_[0] = s; }),
+        second_(kAddress, tx_2_, {}, [this](Status s) { results_[1] = s; }),
+        third_(kAddress, tx_3_, {}, [this](Status s) { results_[2] = s; }),
+        repeating_(kAddress, tx_1_, {}, [this](Status) {
+          // Runs three times by resubmitting itself.
+          if (++runs_ < 3) {
+            queue_.Submit(repeating_);
+          }
+        }) {
+    results_.fill(Status::Unknown());
+  }
+
+  FakeAsyncInitiator initiator_;
+  AsyncTransactionQueue queue_;
+
+  std::array<std::byte, 1> tx_1_ = {std::byte{1}};
+  std::array<std::byte, 1> tx_2_ = {std::byte{2}};
+  std::array<std::byte, 1> tx_3_ = {std::byte{3}};
+  std::array<Status, 3> results_;
+  int runs_ = 0;
+
+  AsyncTransaction first_;
+  AsyncTransaction second_;
+  AsyncTransaction third_;
+  AsyncTransaction repeating_;
+};
+
+TEST_F(AsyncTransactionQueueTest, Submit_StartsImmediatelyWhenIdle) {
+  queue_.Submit(first_);
+  EXPECT_EQ(1, initiator_.started());
+  EXPECT_EQ(tx_1_.data(), initiator_.last_tx_buffer().data());
+
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(OkStatus(), results_[0]);
+  EXPECT_FALSE(initiator_.busy());
+}
+
+TEST_F(AsyncTransactionQueueTest, Submit_RunsTransactionsInOrder) {
+  queue_.Submit(first_);
+  queue_.Submit(second_);
+  queue_.Submit(third_);
+  EXPECT_EQ(1, initiator_.started());
+
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(OkStatus(), results_[0]);
+  EXPECT_EQ(Status::Unknown(), results_[1]);
+  EXPECT_EQ(tx_2_.data(), initiator_.last_tx_buffer().data());
+
+  initiator_.Complete(Status::Unavailable());
+  EXPECT_EQ(Status::Unavailable(), results_[1]);
+  EXPECT_EQ(tx_3_.data(), initiator_.last_tx_buffer().data());
+
+  initiator_.Complete(Status::DeadlineExceeded());
+  EXPECT_EQ(Status::DeadlineExceeded(), results_[2]);
+  EXPECT_EQ(3, initiator_.started());
+  EXPECT_FALSE(initiator_.busy());
+}
+
+TEST_F(AsyncTransactionQueueTest, StartFailure_FinishesTransactionWithError) {
+  initiator_.FailNextStart(Status::FailedPrecondition());
+  queue_.Submit(first_);
+  EXPECT_EQ(Status::FailedPrecondition(), results_[0]);
+  EXPECT_FALSE(initiator_.busy());
+
+  // The queue is idle again, so the next transaction starts immediately.
+  queue_.Submit(second_);
+  EXPECT_TRUE(initiator_.busy());
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(OkStatus(), results_[1]);
+}
+
+TEST_F(AsyncTransactionQueueTest, StartFailure_StartsNextTransaction) {
+  queue_.Submit(first_);
+  queue_.Submit(second_);
+  queue_.Submit(third_);
+
+  initiator_.FailNextStart(Status::FailedPrecondition());
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(OkStatus(), results_[0]);
+  EXPECT_EQ(Status::FailedPrecondition(), results_[1]);
+  EXPECT_EQ(tx_3_.data(), initiator_.last_tx_buffer().data());
+
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(OkStatus(), results_[2]);
+}
+
+TEST_F(AsyncTransactionQueueTest, ResubmitFromCallback) {
+  queue_.Submit(repeating_);
+  queue_.Submit(second_);
+  for (int i = 0; i < 4; ++i) {
+    initiator_.Complete(OkStatus());
+  }
+
+  EXPECT_EQ(3, runs_);
+  EXPECT_EQ(OkStatus(), results_[1]);
+  EXPECT_FALSE(initiator_.busy());
+}
+
+}  // namespace
+}  // namespace pw::i2c
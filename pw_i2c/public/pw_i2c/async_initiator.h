@@ -0,0 +1,157 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_function/function.h"
+#include "pw_i2c/address.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::i2c {
+
+// Driver interface for initiating I2C transactions without blocking the calling
+// thread, typically implemented with interrupts or DMA. The transaction runs in
+// the background and a callback is invoked when it completes.
+//
+// Only one transaction may be in progress at a time. Use an
+// AsyncTransactionQueue to share an AsyncInitiator between several users.
+class AsyncInitiator {
+ public:
+  // Invoked with the result of a transaction once it has completed:
+  //
+  // Ok - Success.
+  // DeadlineExceeded - The transaction did not complete in time.
+  // Unavailable - NACK condition occurred, meaning the addressed device did
+  //   not respond or was unable to process the request.
+  //
+  // The callback may be invoked from interrupt context, so it must not block.
+  using Callback = Function<void(Status)>;
+
+  virtual ~AsyncInitiator() = default;
+
+  // Starts a write and read transaction and returns without waiting for it to
+  // complete. The signal on the bus is the same as for
+  // Initiator::WriteReadFor(). The buffers must remain valid until the callback
+  // is invoked.
+  //
+  // Returns:
+  // Ok - The transaction was started. The callback will be invoked with its
+  //   result.
+  // InvalidArgument - device_address is larger than the 10 bit address space.
+  // Unavailable - Another transaction is in progress.
+  // FailedPrecondition - The interface is not currently initialized and/or
+  //    enabled.
+  //
+  // The callback is not invoked if the transaction was not started.
+  Status StartWriteRead(Address device_address,
+                        ConstByteSpan tx_buffer,
+                        ByteSpan rx_buffer,
+                        Callback&& callback) {
+    return DoStartWriteRead(
+        device_address, tx_buffer, rx_buffer, std::move(callback));
+  }
+
+  // Starts a write only transaction. See StartWriteRead().
+  Status StartWrite(Address device_address,
+                    ConstByteSpan tx_buffer,
+                    Callback&& callback) {
+    return StartWriteRead(
+        device_address, tx_buffer, ByteSpan(), std::move(callback));
+  }
+
+  // Starts a read only transaction. See StartWriteRead().
+  Status StartRead(Address device_address,
+                   ByteSpan rx_buffer,
+                   Callback&& callback) {
+    return StartWriteRead(
+        device_address, ConstByteSpan(), rx_buffer, std::move(callback));
+  }
+
+ private:
+  virtual Status DoStartWriteRead(Address device_address,
+                                  ConstByteSpan tx_buffer,
+                                  ByteSpan rx_buffer,
+                                  Callback&& callback) = 0;
+};
+
+// A transaction to run on an AsyncTransactionQueue. The transaction and its
+// buffers must remain valid until its callback is invoked.
+class AsyncTransaction : public IntrusiveList<AsyncTransaction>::Item {
+ public:
+  AsyncTransaction(Address device_address,
+                   ConstByteSpan tx_buffer,
+                   ByteSpan rx_buffer,
+                   AsyncInitiator::Callback&& callback)
+      : device_address_(device_address),
+        tx_buffer_(tx_buffer),
+        rx_buffer_(rx_buffer),
+        callback_(std::move(callback)) {}
+
+ private:
+  friend class AsyncTransactionQueue;
+
+  const Address device_address_;
+  const ConstByteSpan tx_buffer_;
+  const ByteSpan rx_buffer_;
+  AsyncInitiator::Callback callback_;
+};
+
+// Runs transactions on an AsyncInitiator one at a time, in the order they were
+// submitted. Each transaction is started as soon as the previous one completes,
+// from the previous transaction's completion context, so the bus stays busy
+// without a thread waiting on it.
+//
+// Transactions may be submitted from any thread or from interrupt context,
+// including from a transaction's callback.
+class AsyncTransactionQueue {
+ public:
+  constexpr AsyncTransactionQueue(AsyncInitiator& initiator)
+      : initiator_(initiator), current_(nullptr), busy_(false) {}
+
+  AsyncTransactionQueue(const AsyncTransactionQueue&) = delete;
+  AsyncTransactionQueue& operator=(const AsyncTransactionQueue&) = delete;
+
+  // Queues a transaction, starting it immediately if the bus is idle. The
+  // transaction's callback is invoked with the result from the initiator,
+  // including errors from starting the transaction.
+  void Submit(AsyncTransaction& transaction) PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  // Starts the next transaction, if any, then invokes the finished
+  // transaction's callback, if any. Repeats until a transaction starts
+  // successfully or the queue is empty.
+  void Run(AsyncTransaction* next, AsyncTransaction* finished, Status result)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Removes and returns the next queued transaction, or marks the queue idle
+  // and returns nullptr if there are none.
+  AsyncTransaction* TakeNext() PW_LOCKS_EXCLUDED(lock_);
+
+  AsyncInitiator& initiator_;
+
+  // The transaction on the bus. Only one context at a time starts or completes
+  // transactions, so this does not need the lock.
+  AsyncTransaction* current_;
+
+  // The transaction that is running is removed from the list, so it may be
+  // resubmitted from its callback.
+  sync::InterruptSpinLock lock_;
+  IntrusiveList<AsyncTransaction> transactions_ PW_GUARDED_BY(lock_);
+  bool busy_ PW_GUARDED_BY(lock_);
+};
+
+}  // namespace pw::i2c
@@ -13,6 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <type_traits>
+
 #include "pw_bytes/endian.h"
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
@@ -233,7 +237,116 @@ class RegisterDevice : public Device {
   Result<uint32_t> ReadRegister32(uint32_t register_address,
                                   chrono::SystemClock::duration timeout);
 
+  // Reads a block of contiguous registers into a struct with a single burst
+  // transaction, relying on the device to auto-increment the register address.
+  // This replaces one transaction per register with one per block, such as one
+  // per sample for a sensor's data registers.
+  //
+  // The struct must consist only of RegisterType fields with no padding, for
+  // example a struct of int16_t axis values. Each field is converted from the
+  // data endianness provided by the constructor.
+  // Args:
+  //   register_address: Address of the first register in the block.
+  //   value: Struct to read the registers into.
+  //   timeout: Timeout that's used for both lock and transaction.
+  // Returns:
+  //   The same as ReadRegisters*.
+  template <typename RegisterType, typename T>
+  Status ReadRegisterStruct(uint32_t register_address,
+                            T& value,
+                            chrono::SystemClock::duration timeout);
+
+  // Writes a struct to a block of contiguous registers with a single burst
+  // transaction. The struct has the same requirements as for
+  // ReadRegisterStruct, and each field is converted to the data endianness.
+  // Args:
+  //   register_address: Address of the first register in the block.
+  //   value: Struct to write to the registers.
+  //   timeout: Timeout that's used for both lock and transaction.
+  // Returns:
+  //   The same as WriteRegisters*.
+  template <typename RegisterType, typename T>
+  Status WriteRegisterStruct(uint32_t register_address,
+                             const T& value,
+                             chrono::SystemClock::duration timeout);
+
+  // Reads a list of registers that need not be contiguous, such as the
+  // registers a sensor driver polls, with one call. Registers are read in
+  // order, each in its own transaction, and reading stops at the first error.
+  // Use ReadRegisters* instead to read contiguous registers in a single burst.
+  //
+  // Both address and data will use the same endianness provided by the
+  // constructor.
+  // Args:
+  //   register_addresses: Register addresses to read.
+  //   return_data: Area to read data to, one value per register address.
+  //   timeout: Timeout that's used for the lock and transaction of each
+  //            register.
+  // Returns:
+  //   Ok: Successful.
+  //   OutOfRange: return_data is not the same size as register_addresses.
+  //   Otherwise, the first error returned by ReadRegister*.
+  Status ReadRegisterList(std::span<const uint32_t> register_addresses,
+                          ByteSpan return_data,
+                          chrono::SystemClock::duration timeout);
+
+  Status ReadRegisterList8(std::span<const uint32_t> register_addresses,
+                           std::span<uint8_t> return_data,
+                           chrono::SystemClock::duration timeout);
+
+  Status ReadRegisterList16(std::span<const uint32_t> register_addresses,
+                            std::span<uint16_t> return_data,
+                            chrono::SystemClock::duration timeout);
+
+  Status ReadRegisterList32(std::span<const uint32_t> register_addresses,
+                            std::span<uint32_t> return_data,
+                            chrono::SystemClock::duration timeout);
+
+  // Writes a list of registers that need not be contiguous with one call.
+  // Registers are written in order, each in its own transaction, and writing
+  // stops at the first error. Use WriteRegisters* instead to write contiguous
+  // registers in a single burst.
+  //
+  // Both address and data will use the same endianness provided by the
+  // constructor.
+  // Args:
+  //   register_addresses: Register addresses to write.
+  //   register_data: Data to write, one value per register address.
+  //   timeout: Timeout that's used for the lock and transaction of each
+  //            register.
+  // Returns:
+  //   Ok: Successful.
+  //   OutOfRange: register_data is not the same size as register_addresses.
+  //   Otherwise, the first error returned by WriteRegister*.
+  Status WriteRegisterList(std::span<const uint32_t> register_addresses,
+                           ConstByteSpan register_data,
+                           chrono::SystemClock::duration timeout);
+
+  Status WriteRegisterList8(std::span<const uint32_t> register_addresses,
+                            std::span<const uint8_t> register_data,
+                            chrono::SystemClock::duration timeout);
+
+  Status WriteRegisterList16(std::span<const uint32_t> register_addresses,
+                             std::span<const uint16_t> register_data,
+                             chrono::SystemClock::duration timeout);
+
+  Status WriteRegisterList32(std::span<const uint32_t> register_addresses,
+                             std::span<const uint32_t> register_data,
+                             chrono::SystemClock::duration timeout);
+
  private:
+  template <typename RegisterType, typename T>
+  static constexpr void CheckRegisterStruct() {
+    static_assert(std::is_integral_v<RegisterType> &&
+                      (sizeof(RegisterType) == 1 || sizeof(RegisterType) == 2 ||
+                       sizeof(RegisterType) == 4),
+                  "Registers must be 8-bit, 16-bit, or 32-bit integers");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Register structs must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(RegisterType) == 0,
+                  "Register structs must contain only RegisterType fields");
+  }
+
   // Helper write registers.
   Status WriteRegisters(uint32_t register_address,
                         ConstByteSpan register_data,
@@ -241,6 +354,26 @@ class RegisterDevice : public Device {
                         ByteSpan buffer,
                         chrono::SystemClock::duration timeout);
 
+  // Helpers for the register list functions, which read or write each register
+  // with the provided single register function.
+  template <typename T>
+  Status ReadEachRegister(
+      std::span<const uint32_t> register_addresses,
+      std::span<T> return_data,
+      chrono::SystemClock::duration timeout,
+      Status (RegisterDevice::*read_registers)(uint32_t,
+                                               std::span<T>,
+                                               chrono::SystemClock::duration));
+
+  template <typename T>
+  Status WriteEachRegister(
+      std::span<const uint32_t> register_addresses,
+      std::span<const T> register_data,
+      chrono::SystemClock::duration timeout,
+      Status (RegisterDevice::*write_register)(uint32_t,
+                                               T,
+                                               chrono::SystemClock::duration));
+
   const std::endian register_address_order_;
   const std::endian data_order_;
   const RegisterAddressSize register_address_size_;
@@ -416,6 +549,158 @@ inline Result<uint32_t> RegisterDevice::ReadRegister32(
   return data[0];
 }
 
+template <typename RegisterType, typename T>
+Status RegisterDevice::ReadRegisterStruct(
+    uint32_t register_address,
+    T& value,
+    chrono::SystemClock::duration timeout) {
+  CheckRegisterStruct<RegisterType, T>();
+
+  const ByteSpan data = std::as_writable_bytes(std::span(&value, 1));
+  PW_TRY(ReadRegisters(register_address, data, timeout));
+
+  // Post process endian information.
+  if constexpr (sizeof(RegisterType) > 1) {
+    for (size_t i = 0; i < data.size(); i += sizeof(RegisterType)) {
+      const RegisterType register_value =
+          bytes::ReadInOrder<RegisterType>(data_order_, &data[i]);
+      std::memcpy(&data[i], &register_value, sizeof(register_value));
+    }
+  }
+  return pw::OkStatus();
+}
+
+template <typename RegisterType, typename T>
+Status RegisterDevice::WriteRegisterStruct(
+    uint32_t register_address,
+    const T& value,
+    chrono::SystemClock::duration timeout) {
+  CheckRegisterStruct<RegisterType, T>();
+
+  std::array<std::byte, sizeof(value) + sizeof(register_address)> byte_buffer;
+  return WriteRegisters(register_address,
+                        std::as_bytes(std::span(&value, 1)),
+                        sizeof(RegisterType),
+                        byte_buffer,
+                        timeout);
+}
+
+template <typename T>
+Status RegisterDevice::ReadEachRegister(
+    std::span<const uint32_t> register_addresses,
+    std::span<T> return_data,
+    chrono::SystemClock::duration timeout,
+    Status (RegisterDevice::*read_registers)(uint32_t,
+                                             std::span<T>,
+                                             chrono::SystemClock::duration)) {
+  if (register_addresses.size() != return_data.size()) {
+    return pw::Status::OutOfRange();
+  }
+
+  for (size_t i = 0; i < register_addresses.size(); ++i) {
+    PW_TRY((this->*read_registers)(
+        register_addresses[i], return_data.subspan(i, 1), timeout));
+  }
+  return pw::OkStatus();
+}
+
+template <typename T>
+Status RegisterDevice::WriteEachRegister(
+    std::span<const uint32_t> register_addresses,
+    std::span<const T> register_data,
+    chrono::SystemClock::duration timeout,
+    Status (RegisterDevice::*write_register)(uint32_t,
+                                             T,
+                                             chrono::SystemClock::duration)) {
+  if (register_addresses.size() != register_data.size()) {
+    return pw::Status::OutOfRange();
+  }
+
+  for (size_t i = 0; i < register_addresses.size(); ++i) {
+    PW_TRY((this->*write_register)(
+        register_addresses[i], register_data[i], timeout));
+  }
+  return pw::OkStatus();
+}
+
+inline Status RegisterDevice::ReadRegisterList(
+    std::span<const uint32_t> register_addresses,
+    ByteSpan return_data,
+    chrono::SystemClock::duration timeout) {
+  return ReadEachRegister(
+      register_addresses, return_data, timeout, &RegisterDevice::ReadRegisters);
+}
+
+inline Status RegisterDevice::ReadRegisterList8(
+    std::span<const uint32_t> register_addresses,
+    std::span<uint8_t> return_data,
+    chrono::SystemClock::duration timeout) {
+  return ReadEachRegister(register_addresses,
+                          return_data,
+                          timeout,
+                          &RegisterDevice::ReadRegisters8);
+}
+
+inline Status RegisterDevice::ReadRegisterList16(
+    std::span<const uint32_t> register_addresses,
+    std::span<uint16_t> return_data,
+    chrono::SystemClock::duration timeout) {
+  return ReadEachRegister(register_addresses,
+                          return_data,
+                          timeout,
+                          &RegisterDevice::ReadRegisters16);
+}
+
+inline Status RegisterDevice::ReadRegisterList32(
+    std::span<const uint32_t> register_addresses,
+    std::span<uint32_t> return_data,
+    chrono::SystemClock::duration timeout) {
+  return ReadEachRegister(register_addresses,
+                          return_data,
+                          timeout,
+                          &RegisterDevice::ReadRegisters32);
+}
+
+inline Status RegisterDevice::WriteRegisterList(
+    std::span<const uint32_t> register_addresses,
+    ConstByteSpan register_data,
+    chrono::SystemClock::duration timeout) {
+  return WriteEachRegister(register_addresses,
+                           register_data,
+                           timeout,
+                           &RegisterDevice::WriteRegister);
+}
+
+inline Status RegisterDevice::WriteRegisterList8(
+    std::span<const uint32_t> register_addresses,
+    std::span<const uint8_t> register_data,
+    chrono::SystemClock::duration timeout) {
+  return WriteEachRegister(register_addresses,
+                           register_data,
+                           timeout,
+                           &RegisterDevice::WriteRegister8);
+}
+
+inline Status RegisterDevice::WriteRegisterList16(
+    std::span<const uint32_t> register_addresses,
+    std::span<const uint16_t> register_data,
+    chrono::SystemClock::duration timeout) {
+  return WriteEachRegister(register_addresses,
+                           register_data,
+                           timeout,
+                           &RegisterDevice::WriteRegister16);
+}
+
+inline Status RegisterDevice::WriteRegisterList32(
+    std::span<const uint32_t> register_addresses,
+    std::span<const uint32_t> register_data,
+    chrono::SystemClock::duration timeout) {
+  return WriteEachRegister(register_addresses,
+                           register_data,
+                           timeout,
+                           &RegisterDevice::WriteRegister32);
+}
+
 }  // namespace i2c
 }  // namespace pw
 
@@ -15,6 +15,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_assert/check.h"
+#include "pw_bytes/array.h"
 #include "pw_bytes/byte_builder.h"
 
 namespace pw {
@@ -816,6 +817,230 @@ TEST(RegisterDevice, WriteRegister16with2ByteBigEndianAddress) {
   }
 }
 
+// Simulates a device with 256 byte-addressed registers. A write sets the
+// register pointer from its first byte and writes the rest starting there. A
+// read returns registers starting at the pointer.
+class RegisterMapInitiator : public Initiator {
+ public:
+  std::array<std::byte, 256>& registers() { return registers_; }
+  int transactions() const { return transactions_; }
+
+  // Fails transactions once this many have succeeded.
+  void FailAfter(int transactions) { fail_after_ = transactions; }
+
+ private:
+  Status DoWriteReadFor(Address,
+                        ConstByteSpan tx_data,
+                        ByteSpan rx_data,
+                        chrono::SystemClock::duration) override {
+    if (transactions_ == fail_after_) {
+      return Status::Unavailable();
+    }
+    transactions_ += 1;
+
+    if (!tx_data.empty()) {
+      pointer_ = static_cast<uint8_t>(tx_data[0]);
+      for (std::byte b : tx_data.subspan(1)) {
+        registers_[pointer_++] = b;
+      }
+    }
+    for (std::byte& b : rx_data) {
+      b = registers_[pointer_++];
+    }
+    return OkStatus();
+  }
+
+  std::array<std::byte, 256> registers_ = {};
+  uint8_t pointer_ = 0;
+  int transactions_ = 0;
+  int fail_after_ = -1;
+};
+
+TEST(RegisterDevice, ReadRegisterList8) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+  initiator.registers()[0x10] = std::byte{0xAA};
+  initiator.registers()[0x42] = std::byte{0xBB};
+  initiator.registers()[0x03] = std::byte{0xCC};
+
+  constexpr uint32_t kRegisters[] = {0x10, 0x42, 0x03};
+  std::array<uint8_t, 3> values = {};
+  ASSERT_EQ(OkStatus(), device.ReadRegisterList8(kRegisters, values, kTimeout));
+  EXPECT_EQ(values[0], 0xAA);
+  EXPECT_EQ(values[1], 0xBB);
+  EXPECT_EQ(values[2], 0xCC);
+  EXPECT_EQ(initiator.transactions(), 3);
+}
+
+TEST(RegisterDevice, ReadRegisterList16BigEndian) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::big,
+                        RegisterAddressSize::k1Byte);
+  initiator.registers()[0x20] = std::byte{0x12};
+  initiator.registers()[0x21] = std::byte{0x34};
+  initiator.registers()[0x08] = std::byte{0x56};
+  initiator.registers()[0x09] = std::byte{0x78};
+
+  constexpr uint32_t kRegisters[] = {0x20, 0x08};
+  std::array<uint16_t, 2> values = {};
+  ASSERT_EQ(OkStatus(),
+            device.ReadRegisterList16(kRegisters, values, kTimeout));
+  EXPECT_EQ(values[0], 0x1234);
+  EXPECT_EQ(values[1], 0x5678);
+}
+
+TEST(RegisterDevice, WriteRegisterList32LittleEndian) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  constexpr uint32_t kRegisters[] = {0x40, 0x04};
+  constexpr uint32_t kValues[] = {0x12345678, 0x9ABCDEF0};
+  ASSERT_EQ(OkStatus(),
+            device.WriteRegisterList32(kRegisters, kValues, kTimeout));
+
+  EXPECT_EQ(initiator.registers()[0x40], std::byte{0x78});
+  EXPECT_EQ(initiator.registers()[0x43], std::byte{0x12});
+  EXPECT_EQ(initiator.registers()[0x04], std::byte{0xF0});
+  EXPECT_EQ(initiator.registers()[0x07], std::byte{0x9A});
+  EXPECT_EQ(initiator.transactions(), 2);
+}
+
+TEST(RegisterDevice, WriteRegisterList) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  constexpr uint32_t kRegisters[] = {0x01, 0xF0};
+  constexpr std::byte kValues[] = {std::byte{0x11}, std::byte{0x22}};
+  ASSERT_EQ(OkStatus(),
+            device.WriteRegisterList(kRegisters, kValues, kTimeout));
+  EXPECT_EQ(initiator.registers()[0x01], std::byte{0x11});
+  EXPECT_EQ(initiator.registers()[0xF0], std::byte{0x22});
+}
+
+TEST(RegisterDevice, RegisterList_SizeMismatch) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  constexpr uint32_t kRegisters[] = {0x01, 0x02};
+  std::array<uint8_t, 1> values = {};
+  EXPECT_EQ(Status::OutOfRange(),
+            device.ReadRegisterList8(kRegisters, values, kTimeout));
+  EXPECT_EQ(Status::OutOfRange(),
+            device.WriteRegisterList8(kRegisters, values, kTimeout));
+  EXPECT_EQ(initiator.transactions(), 0);
+}
+
+TEST(RegisterDevice, RegisterList_StopsAtFirstError) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+  initiator.FailAfter(1);
+
+  constexpr uint32_t kRegisters[] = {0x01, 0x02, 0x03};
+  constexpr uint8_t kValues[] = {1, 2, 3};
+  EXPECT_EQ(Status::Unavailable(),
+            device.WriteRegisterList8(kRegisters, kValues, kTimeout));
+  EXPECT_EQ(initiator.registers()[0x01], std::byte{1});
+  EXPECT_EQ(initiator.registers()[0x02], std::byte{0});
+  EXPECT_EQ(initiator.registers()[0x03], std::byte{0});
+}
+
+struct AccelSample {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+TEST(RegisterDevice, ReadRegisterStruct_BigEndianSample) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::big,
+                        RegisterAddressSize::k1Byte);
+  constexpr auto kSampleRegisters =
+      bytes::Array<0x01, 0x02, 0xFF, 0xFE, 0x7F, 0xFF>();
+  std::copy(kSampleRegisters.begin(),
+            kSampleRegisters.end(),
+            initiator.registers().begin() + 0x28);
+
+  AccelSample sample = {};
+  ASSERT_EQ(OkStatus(),
+            device.ReadRegisterStruct<int16_t>(0x28, sample, kTimeout));
+  EXPECT_EQ(sample.x, 0x0102);
+  EXPECT_EQ(sample.y, -2);
+  EXPECT_EQ(sample.z, 0x7FFF);
+  EXPECT_EQ(initiator.transactions(), 1);
+}
+
+TEST(RegisterDevice, ReadRegisterStruct_BytesAreUnchanged) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::big,
+                        RegisterAddressSize::k1Byte);
+  initiator.registers()[0x10] = std::byte{0x12};
+  initiator.registers()[0x11] = std::byte{0x34};
+
+  std::array<uint8_t, 2> registers = {};
+  ASSERT_EQ(OkStatus(),
+            device.ReadRegisterStruct<uint8_t>(0x10, registers, kTimeout));
+  EXPECT_EQ(registers[0], 0x12);
+  EXPECT_EQ(registers[1], 0x34);
+}
+
+TEST(RegisterDevice, WriteRegisterStruct_LittleEndianSample) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  const AccelSample sample = {0x0102, -2, 0x7FFF};
+  ASSERT_EQ(OkStatus(),
+            device.WriteRegisterStruct<int16_t>(0x30, sample, kTimeout));
+
+  constexpr auto kExpected =
+      bytes::Array<0x02, 0x01, 0xFE, 0xFF, 0xFF, 0x7F>();
+  EXPECT_TRUE(std::equal(kExpected.begin(),
+                         kExpected.end(),
+                         initiator.registers().begin() + 0x30));
+  EXPECT_EQ(initiator.transactions(), 1);
+}
+
+TEST(RegisterDevice, WriteThenReadRegisterStruct_32BitRegisters) {
+  RegisterMapInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        std::endian::big,
+                        RegisterAddressSize::k1Byte);
+
+  const std::array<uint32_t, 2> written = {0x12345678, 0x9ABCDEF0};
+  ASSERT_EQ(OkStatus(),
+            device.WriteRegisterStruct<uint32_t>(0x40, written, kTimeout));
+  EXPECT_EQ(initiator.registers()[0x40], std::byte{0x12});
+
+  std::array<uint32_t, 2> read = {};
+  ASSERT_EQ(OkStatus(),
+            device.ReadRegisterStruct<uint32_t>(0x40, read, kTimeout));
+  EXPECT_EQ(read, written);
+}
+
 }  // namespace
 }  // namespace i2c
 }  // namespace pw
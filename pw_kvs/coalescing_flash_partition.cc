@@ -0,0 +1,147 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/coalescing_flash_partition.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+using std::byte;
+
+CoalescingFlashPartition::CoalescingFlashPartition(
+    std::span<byte> page_buffer,
+    FlashMemory* flash,
+    uint32_t start_sector_index,
+    uint32_t sector_count,
+    uint32_t alignment_bytes,
+    PartitionPermission permission)
+    : FlashPartition(flash,
+                     start_sector_index,
+                     sector_count,
+                     alignment_bytes,
+                     permission),
+      buffer_(page_buffer),
+      buffer_address_(0),
+      buffered_bytes_(0) {
+  const size_t page_alignment_offset =
+      buffer_.size() % FlashPartition::alignment_bytes();
+  PW_CHECK_UINT_EQ(page_alignment_offset, 0u);
+  const size_t sector_page_offset =
+      FlashPartition::sector_size_bytes() % buffer_.size();
+  PW_CHECK_UINT_EQ(sector_page_offset, 0u);
+}
+
+Status CoalescingFlashPartition::Erase(Address address, size_t num_sectors) {
+  PW_TRY(FlushIfOverlapping(address, num_sectors * sector_size_bytes()));
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+StatusWithSize CoalescingFlashPartition::Read(Address address,
+                                              std::span<byte> output) {
+  PW_TRY_WITH_SIZE(FlushIfOverlapping(address, output.size()));
+  return FlashPartition::Read(address, output);
+}
+
+const byte* CoalescingFlashPartition::MappedAddress(Address address,
+                                                   size_t size_bytes) const {
+  if (Overlaps(address, size_bytes)) {
+    return nullptr;
+  }
+  return FlashPartition::MappedAddress(address, size_bytes);
+}
+
+StatusWithSize CoalescingFlashPartition::Write(Address address,
+                                               std::span<const byte> data) {
+  // Check the write now, since buffered data is written later.
+  if (!writable()) {
+    return StatusWithSize::PermissionDenied();
+  }
+  PW_TRY_WITH_SIZE(CheckBounds(address, data.size()));
+  const size_t address_alignment_offset = address % alignment_bytes();
+  PW_CHECK_UINT_EQ(address_alignment_offset, 0u);
+  const size_t size_alignment_offset = data.size() % alignment_bytes();
+  PW_CHECK_UINT_EQ(size_alignment_offset, 0u);
+
+  if (buffered_bytes_ != 0u && address != buffer_address_ + buffered_bytes_) {
+    PW_TRY_WITH_SIZE(Flush());
+  }
+
+  size_t written = 0;
+  while (written < data.size()) {
+    const Address next_address = address + written;
+    const Address page_end =
+        (next_address / page_size_bytes() + 1) * page_size_bytes();
+    const size_t chunk_size =
+        std::min(data.size() - written, size_t(page_end - next_address));
+    const std::span<const byte> chunk = data.subspan(written, chunk_size);
+
+    // Full pages are written directly.
+    if (buffered_bytes_ == 0u && chunk_size == page_size_bytes()) {
+      StatusWithSize result = FlashPartition::Write(next_address, chunk);
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), written);
+      }
+      written += chunk_size;
+      continue;
+    }
+
+    if (buffered_bytes_ == 0u) {
+      buffer_address_ = next_address;
+    }
+    std::memcpy(buffer_.data() + buffered_bytes_, chunk.data(), chunk_size);
+    buffered_bytes_ += chunk_size;
+    written += chunk_size;
+
+    if (next_address + chunk_size == page_end) {
+      if (Status status = Flush(); !status.ok()) {
+        return StatusWithSize(status, written - chunk_size);
+      }
+    }
+  }
+
+  return StatusWithSize(written);
+}
+
+Status CoalescingFlashPartition::IsRegionErased(Address source_flash_address,
+                                                size_t length,
+                                                bool* is_erased) {
+  PW_TRY(FlushIfOverlapping(source_flash_address, length));
+  return FlashPartition::IsRegionErased(
+      source_flash_address, length, is_erased);
+}
+
+Status CoalescingFlashPartition::Flush() {
+  if (buffered_bytes_ == 0u) {
+    return OkStatus();
+  }
+
+  const size_t size = buffered_bytes_;
+  buffered_bytes_ = 0;
+  return FlashPartition::Write(buffer_address_, buffer_.first(size)).status();
+}
+
+Status CoalescingFlashPartition::FlushIfOverlapping(Address address,
+                                                    size_t length) {
+  if (Overlaps(address, length)) {
+    return Flush();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,169 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/coalescing_flash_partition.h"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kAlignment = 16;
+constexpr size_t kPageSize = 128;
+
+// A fake flash that counts the writes made to it.
+class WriteCountingFlash : public FakeFlashMemoryBuffer<512, 4> {
+ public:
+  WriteCountingFlash() : FakeFlashMemoryBuffer(kAlignment) {}
+
+  StatusWithSize Write(Address address,
+                       std::span<const byte> data) override {
+    writes_ += 1;
+    return FakeFlashMemoryBuffer::Write(address, data);
+  }
+
+  size_t writes() const { return writes_; }
+
+ private:
+  size_t writes_ = 0;
+};
+
+class CoalescingPartition : public ::testing::Test {
+ protected:
+  CoalescingPartition() : partition_(&flash_) {}
+
+  void SetUp() override { ASSERT_EQ(OkStatus(), partition_.Erase()); }
+
+  static constexpr std::array<byte, kAlignment> Fill(uint8_t value) {
+    std::array<byte, kAlignment> data{};
+    for (byte& b : data) {
+      b = byte{value};
+    }
+    return data;
+  }
+
+  WriteCountingFlash flash_;
+  CoalescingFlashPartitionBuffer<kPageSize> partition_;
+};
+
+TEST_F(CoalescingPartition, AdjacentWrites_WrittenAtEndOfPage) {
+  for (size_t i = 0; i < kPageSize / kAlignment; ++i) {
+    ASSERT_EQ(OkStatus(),
+              partition_.Write(i * kAlignment, Fill(uint8_t(i))).status());
+  }
+
+  EXPECT_EQ(1u, flash_.writes());
+  EXPECT_EQ(0u, partition_.buffered_bytes());
+}
+
+TEST_F(CoalescingPartition, Write_SplitAtPageBoundary) {
+  std::array<byte, kPageSize> data{};
+  ASSERT_EQ(OkStatus(), partition_.Write(kAlignment, data).status());
+
+  // The first page is written, and the rest of the data is buffered.
+  EXPECT_EQ(1u, flash_.writes());
+  EXPECT_EQ(kAlignment, partition_.buffered_bytes());
+}
+
+TEST_F(CoalescingPartition, Write_FullPages_WrittenDirectly) {
+  std::array<byte, 2 * kPageSize> data{};
+  ASSERT_EQ(OkStatus(), partition_.Write(0, data).status());
+
+  EXPECT_EQ(2u, flash_.writes());
+  EXPECT_EQ(0u, partition_.buffered_bytes());
+}
+
+TEST_F(CoalescingPartition, NonAdjacentWrite_FlushesBuffer) {
+  ASSERT_EQ(OkStatus(), partition_.Write(0, Fill(1)).status());
+  ASSERT_EQ(OkStatus(), partition_.Write(2 * kAlignment, Fill(2)).status());
+
+  EXPECT_EQ(1u, flash_.writes());
+  EXPECT_EQ(kAlignment, partition_.buffered_bytes());
+}
+
+TEST_F(CoalescingPartition, Read_BufferedData_FlushesBuffer) {
+  ASSERT_EQ(OkStatus(), partition_.Write(0, Fill(1)).status());
+
+  std::array<byte, kAlignment> read{};
+  ASSERT_EQ(OkStatus(), partition_.Read(0, read).status());
+  EXPECT_EQ(Fill(1), read);
+  EXPECT_EQ(1u, flash_.writes());
+}
+
+TEST_F(CoalescingPartition, Read_OtherData_KeepsBuffer) {
+  ASSERT_EQ(OkStatus(), partition_.Write(0, Fill(1)).status());
+
+  std::array<byte, kAlignment> read{};
+  ASSERT_EQ(OkStatus(), partition_.Read(kPageSize, read).status());
+  EXPECT_EQ(0u, flash_.writes());
+  EXPECT_EQ(kAlignment, partition_.buffered_bytes());
+}
+
+TEST_F(CoalescingPartition, Flush_WritesPartialPage) {
+  ASSERT_EQ(OkStatus(), partition_.Write(0, Fill(1)).status());
+  ASSERT_EQ(OkStatus(), partition_.Flush());
+
+  EXPECT_EQ(1u, flash_.writes());
+  EXPECT_EQ(0u, partition_.buffered_bytes());
+
+  bool erased = true;
+  ASSERT_EQ(OkStatus(), partition_.IsRegionErased(0, kAlignment, &erased));
+  EXPECT_FALSE(erased);
+}
+
+TEST_F(CoalescingPartition, MappedAddress_BufferedDataIsNotMapped) {
+  flash_.set_mapped_reads(true);
+  ASSERT_EQ(OkStatus(), partition_.Write(0, Fill(1)).status());
+
+  EXPECT_EQ(nullptr, partition_.MappedAddress(0, kAlignment));
+  EXPECT_EQ(flash_.buffer().data() + kPageSize,
+            partition_.MappedAddress(kPageSize, kAlignment));
+
+  ASSERT_EQ(OkStatus(), partition_.Flush());
+  EXPECT_EQ(flash_.buffer().data(), partition_.MappedAddress(0, kAlignment));
+}
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x6b2a2c51, .checksum = &checksum};
+
+TEST_F(CoalescingPartition, KeyValueStore_WritesEntryInOneProgram) {
+  KeyValueStoreBuffer<8, 4> kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  // The 16 B header, 4 B key, and 100 B value are written in two chunks, which
+  // fit in one page.
+  const size_t writes = flash_.writes();
+  ASSERT_EQ(OkStatus(), kvs.Put("key1", std::array<char, 100>{'a'}));
+  EXPECT_EQ(writes + 1, flash_.writes());
+  EXPECT_EQ(0u, partition_.buffered_bytes());
+
+  KeyValueStoreBuffer<8, 4> reloaded(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  std::array<char, 100> value{};
+  ASSERT_EQ(OkStatus(), reloaded.Get("key1", &value));
+  EXPECT_EQ('a', value[0]);
+}
+
+}  // namespace
+}  // namespace pw::kvs
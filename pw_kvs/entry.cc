@@ -17,9 +17,11 @@
 
 #include "pw_kvs/internal/entry.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 
+#include "pw_assert/check.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -35,6 +37,69 @@ constexpr size_t kWriteBufferSize =
 
 using std::byte;
 
+namespace {
+
+// Flushes an entry's writer, then any data buffered by the partition, so the
+// entry is in flash when it is verified or reported as written.
+StatusWithSize FlushEntry(AlignedWriter& writer, FlashPartition& partition) {
+  StatusWithSize result = writer.Flush();
+  PW_TRY_WITH_SIZE(result);
+  return StatusWithSize(partition.Flush(), result.size());
+}
+
+// Writes the same data at several addresses. Each write is started at every
+// address before waiting for any of them to finish. Writing stops at an address
+// once a write to it fails; the output fails only if every address has failed.
+class CopiesOutput final : public Output {
+ public:
+  CopiesOutput(FlashPartition& partition,
+               std::span<const FlashPartition::Address> addresses,
+               std::span<StatusWithSize> results)
+      : partition_(partition),
+        addresses_(addresses),
+        results_(results),
+        offset_(0) {
+    std::fill(results_.begin(), results_.end(), StatusWithSize(0));
+  }
+
+ private:
+  StatusWithSize DoWrite(std::span<const byte> data) override {
+    for (size_t i = 0; i < addresses_.size(); ++i) {
+      if (results_[i].ok()) {
+        const Status status =
+            partition_.StartWrite(addresses_[i] + offset_, data);
+        results_[i] = StatusWithSize(status, results_[i].size());
+      }
+    }
+
+    // Copies that failed to start have a non-OK result, so only the writes in
+    // progress are waited for.
+    bool any_written = false;
+    for (size_t i = 0; i < addresses_.size(); ++i) {
+      if (results_[i].ok()) {
+        const StatusWithSize result =
+            partition_.FinishWrite(addresses_[i] + offset_);
+        results_[i] =
+            StatusWithSize(result.status(), results_[i].size() + result.size());
+        any_written = any_written || result.ok();
+      }
+    }
+
+    offset_ += data.size();
+    if (!any_written) {
+      return StatusWithSize(results_[0].status(), 0);
+    }
+    return StatusWithSize(data.size());
+  }
+
+  FlashPartition& partition_;
+  const std::span<const FlashPartition::Address> addresses_;
+  const std::span<StatusWithSize> results_;
+  size_t offset_;
+};
+
+}  // namespace
+
 Status Entry::Read(FlashPartition& partition,
                    Address address,
                    const internal::EntryFormats& formats,
@@ -45,7 +110,7 @@ Status Entry::Read(FlashPartition& partition,
   if (partition.AppearsErased(std::as_bytes(std::span(&header.magic, 1)))) {
     return Status::NotFound();
   }
-  if (header.key_length_bytes > kMaxKeyLength) {
+  if ((header.key_length_bytes & kReservedFlag) != 0u) {
     return Status::DataLoss();
   }
 
@@ -73,13 +138,35 @@ Status Entry::ReadKey(FlashPartition& partition,
       .status();
 }
 
+Status Entry::ReadKey(FlashPartition& partition,
+                      Address address,
+                      size_t key_length,
+                      KeyBuffer& buffer,
+                      Key* key) {
+  if (key_length == 0u || key_length > kMaxKeyLength) {
+    return Status::DataLoss();
+  }
+
+  const Address key_address = address + sizeof(EntryHeader);
+  if (const byte* mapped = partition.MappedAddress(key_address, key_length);
+      mapped != nullptr) {
+    *key = Key(reinterpret_cast<const char*>(mapped), key_length);
+    return OkStatus();
+  }
+
+  PW_TRY(partition.Read(key_address, key_length, buffer.data()));
+  *key = Key(buffer.data(), key_length);
+  return OkStatus();
+}
+
 Entry::Entry(FlashPartition& partition,
              Address address,
              const EntryFormat& format,
              Key key,
-             std::span<const byte> value,
+             std::span<const std::span<const byte>> value_chunks,
              uint16_t value_size_bytes,
-             uint32_t transaction_id)
+             uint32_t transaction_id,
+             bool compressed)
     : Entry(&partition,
             address,
             format,
@@ -87,29 +174,124 @@ Entry::Entry(FlashPartition& partition,
              .checksum = 0,
              .alignment_units =
                  alignment_bytes_to_units(partition.alignment_bytes()),
-             .key_length_bytes = static_cast<uint8_t>(key.size()),
+             .key_length_bytes = static_cast<uint8_t>(
+                 key.size() | (compressed ? kCompressedFlag : 0u)),
              .value_size_bytes = value_size_bytes,
              .transaction_id = transaction_id}) {
   if (checksum_algo_ != nullptr) {
-    std::span<const byte> checksum = CalculateChecksum(key, value);
+    std::span<const byte> checksum = CalculateChecksum(key, value_chunks);
     std::memcpy(&header_.checksum,
                 checksum.data(),
                 std::min(checksum.size(), sizeof(header_.checksum)));
   }
 }
 
-StatusWithSize Entry::Write(Key key, std::span<const byte> value) const {
+StatusWithSize Entry::WriteChunks(
+    Key key, std::span<const std::span<const byte>> value_chunks) const {
   FlashPartition::Output flash(partition(), address_);
-  return AlignedWrite<kWriteBufferSize>(flash,
-                                        alignment_bytes(),
-                                        {std::as_bytes(std::span(&header_, 1)),
-                                         std::as_bytes(std::span(key)),
-                                         value});
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), flash);
+
+  PW_TRY_WITH_SIZE(writer.Write(&header_, sizeof(header_)));
+  PW_TRY_WITH_SIZE(writer.Write(std::as_bytes(std::span(key))));
+  for (std::span<const byte> chunk : value_chunks) {
+    PW_TRY_WITH_SIZE(writer.Write(chunk));
+  }
+  return FlushEntry(writer, partition());
+}
+
+Status Entry::WriteCopies(std::span<const Address> addresses,
+                         Key key,
+                         std::span<const byte> value,
+                         std::span<StatusWithSize> results) const {
+  PW_DCHECK_UINT_EQ(addresses.size(), results.size());
+  CopiesOutput output(partition(), addresses, results);
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), output);
+
+  PW_TRY(writer.Write(&header_, sizeof(header_)).status());
+  PW_TRY(writer.Write(std::as_bytes(std::span(key))).status());
+  PW_TRY(writer.Write(value).status());
+  PW_TRY(writer.Flush().status());
+
+  // Data buffered by the partition applies to every copy.
+  if (const Status status = partition().Flush(); !status.ok()) {
+    for (StatusWithSize& result : results) {
+      result = StatusWithSize(status, result.size());
+    }
+    return status;
+  }
+  return OkStatus();
+}
+
+StatusWithSize Entry::WriteStream(Key key, stream::Reader& reader) {
+  PW_DCHECK_UINT_LE(alignment_bytes(), kMaxFlashAlignment);
+
+  // The first alignment unit of the entry, which starts with the header, is
+  // kept here until the checksum is known. The rest is written as it is read.
+  std::array<byte, kMaxFlashAlignment> head{};
+  const std::span<byte> head_unit = std::span(head).first(alignment_bytes());
+  size_t head_bytes = sizeof(EntryHeader);
+
+  FlashPartition::Output flash(partition(), address_ + head_unit.size());
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), flash);
+
+  header_.checksum = 0;
+  if (checksum_algo_ != nullptr) {
+    checksum_algo_->Reset();
+    checksum_algo_->Update(&header_, sizeof(header_));
+  }
+
+  // Adds the next part of the key or value to the checksum and the entry.
+  auto append = [&](std::span<const byte> data) {
+    if (checksum_algo_ != nullptr) {
+      checksum_algo_->Update(data);
+    }
+    const size_t to_head = std::min(data.size(), head_unit.size() - head_bytes);
+    std::memcpy(&head_unit[head_bytes], data.data(), to_head);
+    head_bytes += to_head;
+    return writer.Write(data.subspan(to_head));
+  };
+
+  StatusWithSize result = append(std::as_bytes(std::span(key)));
+  PW_TRY_WITH_SIZE(result);
+
+  std::array<byte, 2 * kMinAlignmentBytes> buffer;
+  for (size_t remaining = value_size(); remaining > 0u;) {
+    const size_t read_size = std::min(remaining, buffer.size());
+    const Result<ByteSpan> read =
+        reader.Read(std::span(buffer).first(read_size));
+    if (!read.ok() || read.value().empty()) {
+      return StatusWithSize(read.ok() ? Status::OutOfRange() : read.status(),
+                            result.size());
+    }
+
+    result = append(read.value());
+    PW_TRY_WITH_SIZE(result);
+    remaining -= read.value().size();
+  }
+
+  if (checksum_algo_ != nullptr) {
+    AddPaddingBytesToChecksum();
+    std::span<const byte> checksum = checksum_algo_->Finish();
+    std::memcpy(&header_.checksum,
+                checksum.data(),
+                std::min(checksum.size(), sizeof(header_.checksum)));
+  }
+
+  result = writer.Flush();
+  PW_TRY_WITH_SIZE(result);
+
+  std::memcpy(head_unit.data(), &header_, sizeof(header_));
+  const StatusWithSize head_result = partition().Write(address_, head_unit);
+  if (!head_result.ok()) {
+    return StatusWithSize(head_result.status(), result.size());
+  }
+  return StatusWithSize(partition().Flush(), size());
 }
 
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
+  codec_ = new_format.codec;
   header_.magic = new_format.magic;
   header_.alignment_units =
       alignment_bytes_to_units(partition_->alignment_bytes());
@@ -138,11 +320,23 @@ StatusWithSize Entry::Copy(Address new_address) const {
   // Write only the key and value from the original entry.
   FlashPartition::Input input(partition(), address() + sizeof(EntryHeader));
   PW_TRY_WITH_SIZE(writer.Write(input, key_length() + value_size()));
-  return writer.Flush();
+  return FlushEntry(writer, partition());
 }
 
 StatusWithSize Entry::ReadValue(std::span<byte> buffer,
                                 size_t offset_bytes) const {
+  if (compressed()) {
+    if (codec_ == nullptr) {
+      return StatusWithSize::FailedPrecondition();
+    }
+    if (offset_bytes != 0u) {
+      return StatusWithSize::Unimplemented();
+    }
+    FlashPartition::Input input(partition(),
+                                address_ + sizeof(EntryHeader) + key_length());
+    return codec_->Decompress(input, value_size(), buffer);
+  }
+
   if (offset_bytes > value_size()) {
     return StatusWithSize::OutOfRange();
   }
@@ -161,6 +355,78 @@ StatusWithSize Entry::ReadValue(std::span<byte> buffer,
   return StatusWithSize(read_size);
 }
 
+StatusWithSize Entry::ReadValue(stream::Writer& writer, bool verify) const {
+  if (compressed()) {
+    return StatusWithSize::Unimplemented();
+  }
+
+  const bool calculate_checksum = verify && checksum_algo_ != nullptr;
+  if (calculate_checksum) {
+    KeyBuffer key_buffer;
+    Key key;
+    PW_TRY_WITH_SIZE(ReadKey(key_buffer, &key));
+
+    EntryHeader header_for_checksum = header_;
+    header_for_checksum.checksum = 0;
+
+    checksum_algo_->Reset();
+    checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
+    checksum_algo_->Update(std::as_bytes(std::span(key)));
+  }
+
+  const Address start = address_ + sizeof(EntryHeader) + key_length();
+  const Address end = start + value_size();
+  Address address = start;
+
+  if (const byte* mapped = partition().MappedAddress(start, value_size());
+      mapped != nullptr) {
+    if (calculate_checksum) {
+      checksum_algo_->Update(mapped, value_size());
+    }
+    PW_TRY_WITH_SIZE(writer.Write(mapped, value_size()));
+    address = end;
+  }
+
+  std::array<byte, kWriteBufferSize> buffer;
+  while (address < end) {
+    const std::span<byte> chunk =
+        std::span(buffer).first(std::min(size_t(end - address), buffer.size()));
+    if (Status status = partition().Read(address, chunk).status();
+        !status.ok()) {
+      return StatusWithSize(status, address - start);
+    }
+    if (calculate_checksum) {
+      checksum_algo_->Update(chunk);
+    }
+    if (Status status = writer.Write(chunk); !status.ok()) {
+      return StatusWithSize(status, address - start);
+    }
+    address += chunk.size();
+  }
+
+  if (verify) {
+    Status status;
+    if (checksum_algo_ == nullptr) {
+      status = header_.checksum == 0 ? OkStatus() : Status::DataLoss();
+    } else {
+      AddPaddingBytesToChecksum();
+      checksum_algo_->Finish();
+      status = checksum_algo_->Verify(checksum_bytes());
+    }
+    return StatusWithSize(status, value_size());
+  }
+  return StatusWithSize(value_size());
+}
+
+StatusWithSize Entry::ReadValueSize() const {
+  if (!compressed()) {
+    return StatusWithSize(value_size());
+  }
+  FlashPartition::Input input(partition(),
+                              address_ + sizeof(EntryHeader) + key_length());
+  return ValueCodec::ReadDecompressedSize(input);
+}
+
 Status Entry::ValueMatches(std::span<const std::byte> value) const {
   if (value_size() != value.size_bytes()) {
     return Status::NotFound();
@@ -170,6 +436,12 @@ Status Entry::ValueMatches(std::span<const std::byte> value) const {
   Address end = address + value_size();
   const std::byte* value_ptr = value.data();
 
+  if (const byte* mapped = partition_->MappedAddress(address, end - address);
+      mapped != nullptr) {
+    checksum_algo_->Update(mapped, end - address);
+    address = end;
+  }
+
   std::array<std::byte, 2 * kMinAlignmentBytes> buffer;
   while (address < end) {
     const size_t read_size = std::min(size_t(end - address), buffer.size());
@@ -190,11 +462,16 @@ Status Entry::VerifyChecksum(Key key, std::span<const byte> value) const {
   if (checksum_algo_ == nullptr) {
     return header_.checksum == 0 ? OkStatus() : Status::DataLoss();
   }
-  CalculateChecksum(key, value);
+  CalculateChecksum(key, std::span(&value, 1));
   return checksum_algo_->Verify(checksum_bytes());
 }
 
 Status Entry::VerifyChecksumInFlash() const {
+  if (const byte* mapped = partition().MappedAddress(address_, size());
+      mapped != nullptr) {
+    return VerifyChecksumInPlace(mapped);
+  }
+
   // Read the entire entry piece-by-piece into a small buffer. If the entry is
   // 32 B or less, only one read is required.
   union {
@@ -245,6 +522,32 @@ Status Entry::VerifyChecksumInFlash() const {
   return checksum_algo_->Verify(checksum_bytes());
 }
 
+Status Entry::VerifyChecksumInPlace(const byte* entry) const {
+  EntryHeader header_to_verify;
+  std::memcpy(&header_to_verify, entry, sizeof(header_to_verify));
+
+  if (header_to_verify.checksum != header_.checksum) {
+    PW_LOG_ERROR("Expected checksum 0x%08" PRIx32 ", found 0x%08" PRIx32,
+                 header_.checksum,
+                 header_to_verify.checksum);
+    return Status::DataLoss();
+  }
+
+  if (checksum_algo_ == nullptr) {
+    return header_.checksum == 0 ? OkStatus() : Status::DataLoss();
+  }
+
+  // The checksum is calculated as if the header's checksum field were 0.
+  header_to_verify.checksum = 0;
+
+  checksum_algo_->Reset();
+  checksum_algo_->Update(&header_to_verify, sizeof(header_to_verify));
+  checksum_algo_->Update(entry + sizeof(EntryHeader),
+                         size() - sizeof(EntryHeader));
+  checksum_algo_->Finish();
+  return checksum_algo_->Verify(checksum_bytes());
+}
+
 void Entry::DebugLog() const {
   PW_LOG_DEBUG("Entry [%s]: ", deleted() ? "tombstone" : "present");
   PW_LOG_DEBUG("   Address      = 0x%x", unsigned(address_));
@@ -253,12 +556,13 @@ void Entry::DebugLog() const {
   PW_LOG_DEBUG("   Checksum     = 0x%x", unsigned(header_.checksum));
   PW_LOG_DEBUG("   Key length   = 0x%x", unsigned(key_length()));
   PW_LOG_DEBUG("   Value length = 0x%x", unsigned(value_size()));
+  PW_LOG_DEBUG("   Compressed   = %s", compressed() ? "yes" : "no");
   PW_LOG_DEBUG("   Entry size   = 0x%x", unsigned(size()));
   PW_LOG_DEBUG("   Alignment    = 0x%x", unsigned(alignment_bytes()));
 }
 
 std::span<const byte> Entry::CalculateChecksum(
-    const Key key, std::span<const byte> value) const {
+    const Key key, std::span<const std::span<const byte>> value_chunks) const {
   checksum_algo_->Reset();
 
   {
@@ -267,7 +571,9 @@ std::span<const byte> Entry::CalculateChecksum(
 
     checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
     checksum_algo_->Update(std::as_bytes(std::span(key)));
-    checksum_algo_->Update(value);
+    for (std::span<const byte> chunk : value_chunks) {
+      checksum_algo_->Update(chunk);
+    }
   }
 
   AddPaddingBytesToChecksum();
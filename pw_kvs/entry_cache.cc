@@ -17,7 +17,11 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstring>
+#include <mutex>
+#include <string_view>
 
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/internal/entry.h"
@@ -30,6 +34,8 @@ namespace {
 
 constexpr FlashPartition::Address kNoAddress = FlashPartition::Address(-1);
 
+std::string_view AsStringView(Key key) { return {key.data(), key.size()}; }
+
 }  // namespace
 
 void EntryMetadata::RemoveAddress(Address address_to_remove) {
@@ -50,7 +56,7 @@ void EntryMetadata::RemoveAddress(Address address_to_remove) {
 }
 
 void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
-  *descriptor_ = descriptor;
+  descriptors_->set(index_, descriptor);
 
   addresses_[0] = address;
   for (size_t i = 1; i < addresses_.size(); ++i) {
@@ -59,79 +65,148 @@ void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
   addresses_ = addresses_.first(1);
 }
 
+void EntryCache::Reset() const {
+  descriptors_.clear();
+  std::fill(index_.slot_entries.begin(), index_.slot_entries.end(), 0);
+  sorted_entries_count_ = 0;
+}
+
+std::span<const uint16_t> EntryCache::FindPrefix(FlashPartition& partition,
+                                                 const EntryFormats& formats,
+                                                 Key prefix) const {
+  if (!indexed()) {
+    return {};
+  }
+
+  // Insert entries added since the last scan into the sorted index. Each is
+  // placed with a binary search, so an insertion reads at most O(log n) other
+  // keys from flash.
+  const std::span<uint16_t> sorted = index_.sorted_entries;
+  while (sorted_entries_count_ < descriptors_.size()) {
+    const size_t new_index = sorted_entries_count_;
+    Entry::KeyBuffer key_buffer;
+    const Key key = ReadKey(partition, formats, new_index, key_buffer);
+
+    const auto position = std::upper_bound(
+        sorted.begin(),
+        sorted.begin() + sorted_entries_count_,
+        key,
+        [&](Key new_key, uint16_t index) {
+          return CompareKey(partition, formats, index, new_key, false) > 0;
+        });
+    std::copy_backward(position,
+                       sorted.begin() + sorted_entries_count_,
+                       sorted.begin() + sorted_entries_count_ + 1);
+    *position = static_cast<uint16_t>(new_index);
+    sorted_entries_count_ += 1;
+  }
+
+  // Keys that start with the prefix are contiguous in the sorted index.
+  const std::span<const uint16_t> entries = sorted.first(sorted_entries_count_);
+  const auto first = std::partition_point(
+      entries.begin(), entries.end(), [&](uint16_t index) {
+        return CompareKey(partition, formats, index, prefix, true) < 0;
+      });
+  const auto last =
+      std::partition_point(first, entries.end(), [&](uint16_t index) {
+        return CompareKey(partition, formats, index, prefix, true) == 0;
+      });
+  return entries.subspan(first - entries.begin(), last - first);
+}
+
 StatusWithSize EntryCache::Find(FlashPartition& partition,
                                 const Sectors& sectors,
                                 const EntryFormats& formats,
                                 Key key,
-                                EntryMetadata* metadata) const {
-  const uint32_t hash = internal::Hash(key);
+                                EntryMetadata* metadata,
+                                sync::VirtualBasicLockable& verify_lock) const {
+  const uint32_t hash = Hash(key);
+  const int index = FindIndex(hash);
+
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  if (const KeyPrefix* prefix = key_prefix(index); prefix != nullptr) {
+    const size_t compare_size = std::min(key.size(), prefix->data.size());
+
+    if (prefix->key_size != key.size() ||
+        std::memcmp(prefix->data.data(), key.data(), compare_size) != 0) {
+      PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+      return StatusWithSize::AlreadyExists();
+    }
+
+    // The whole key is cached, so there is no need to read it from flash.
+    if (key.size() <= prefix->data.size()) {
+      PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+      *metadata = EntryMetadata(descriptors_, index, addresses(index));
+      return StatusWithSize(0);
+    }
+  }
+
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
+  bool key_found = false;
+  Key read_key;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  for (Address address : addresses(index)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer, &read_key);
+
+    if (read_result.ok() && hash == Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      std::lock_guard lock(verify_lock);
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_, index, addresses(index));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
-                                 Address address) const {
+                                 Address address,
+                                 Key key) const {
   // TODO(hepler): DCHECK(!full());
-  Address* first_address = ResetAddresses(descriptors_.size(), address);
+  const size_t index = descriptors_.size();
+  Address* first_address = ResetAddresses(index, address);
   descriptors_.push_back(descriptor);
-  return EntryMetadata(descriptors_.back(), std::span(first_address, 1));
+  AddToIndex(index);
+  SetKeyPrefix(index, key);
+  return EntryMetadata(descriptors_, index, std::span(first_address, 1));
 }
 
-// TODO: This method is the trigger of the O(valid_entries * all_entries) time
-// complexity for reading. At some cost to memory, this could be optimized by
-// using a hash table instead of scanning, but in practice this should be fine
-// for a small number of keys
+// TODO: Without an index, this method is the trigger of the
+// O(valid_entries * all_entries) time complexity for reading. Use an indexed
+// EntryCache for KVSs with many keys.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
-                                          size_t sector_size_bytes) const {
+                                          size_t sector_size_bytes,
+                                          Key key) const {
   // With the new key descriptor, either add it to the descriptor table or
   // overwrite an existing entry with an older version of the key.
   const int index = FindIndex(descriptor.key_hash);
@@ -141,21 +216,22 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
     if (full()) {
       return Status::ResourceExhausted();
     }
-    AddNew(descriptor, address);
+    AddNew(descriptor, address, key);
     return OkStatus();
   }
 
   // Existing entry is old; replace the existing entry with the new one.
-  if (descriptor.transaction_id > descriptors_[index].transaction_id) {
-    descriptors_[index] = descriptor;
+  if (descriptor.transaction_id > descriptors_.transaction_id(index)) {
+    descriptors_.set(index, descriptor);
     ResetAddresses(index, address);
+    SetKeyPrefix(index, key);
     return OkStatus();
   }
 
   // If the entries have a duplicate transaction ID, add the new (redundant)
   // entry to the existing descriptor.
-  if (descriptors_[index].transaction_id == descriptor.transaction_id) {
-    if (descriptors_[index].key_hash != descriptor.key_hash) {
+  if (descriptors_.transaction_id(index) == descriptor.transaction_id) {
+    if (descriptors_.key_hash(index) != descriptor.key_hash) {
       PW_LOG_ERROR("Duplicate entry for key 0x%08" PRIx32
                    " with transaction ID %" PRIu32 " has non-matching hash",
                    descriptor.key_hash,
@@ -181,24 +257,122 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
 }
 
 size_t EntryCache::present_entries() const {
-  size_t present_entries = 0;
+  const std::span<const EntryState> states = descriptors_.states();
+  return std::count(states.begin(), states.end(), EntryState::kValid);
+}
+
+int EntryCache::FindIndex(uint32_t key_hash) const {
+  if (indexed()) {
+    const size_t mask = index_.slot_entries.size() - 1;
+
+    // Descriptors are never removed individually, so the first empty slot ends
+    // the probe sequence. Slots store the descriptor index + 1; 0 is empty.
+    for (size_t slot = key_hash & mask; index_.slot_entries[slot] != 0u;
+         slot = (slot + 1) & mask) {
+      if (index_.slot_hashes[slot] == key_hash) {
+        return index_.slot_entries[slot] - 1;
+      }
+    }
+    return -1;
+  }
+
+  // Key hashes are stored contiguously, so this scan compares adjacent words.
+  const std::span<const uint32_t> hashes = descriptors_.key_hashes();
+  const auto found = std::find(hashes.begin(), hashes.end(), key_hash);
+  return found == hashes.end() ? -1 : static_cast<int>(found - hashes.begin());
+}
+
+void EntryCache::AddToIndex(size_t descriptor_index) const {
+  if (!indexed()) {
+    return;
+  }
+
+  const uint32_t key_hash = descriptors_.key_hash(descriptor_index);
+  const size_t mask = index_.slot_entries.size() - 1;
+
+  // The table has more slots than entries, so there is always an empty slot.
+  size_t slot = key_hash & mask;
+  while (index_.slot_entries[slot] != 0u) {
+    slot = (slot + 1) & mask;
+  }
 
-  for (const KeyDescriptor& descriptor : descriptors_) {
-    if (descriptor.state != EntryState::kDeleted) {
-      present_entries += 1;
+  index_.slot_hashes[slot] = key_hash;
+  index_.slot_entries[slot] = static_cast<uint16_t>(descriptor_index + 1);
+}
+
+void EntryCache::SetKeyPrefix(size_t descriptor_index, Key key) const {
+  if (index_.key_prefixes.empty()) {
+    return;
+  }
+
+  KeyPrefix& prefix = index_.key_prefixes[descriptor_index];
+  prefix.key_size = static_cast<uint8_t>(key.size());
+  std::memcpy(prefix.data.data(),
+              key.data(),
+              std::min(key.size(), prefix.data.size()));
+}
+
+int EntryCache::CompareKey(FlashPartition& partition,
+                           const EntryFormats& formats,
+                           size_t descriptor_index,
+                           Key key,
+                           bool prefix) const {
+  const std::string_view other = AsStringView(key);
+
+  if (const KeyPrefix* cached = key_prefix(descriptor_index);
+      cached != nullptr) {
+    // The number of characters of the descriptor's key to compare.
+    const size_t size =
+        prefix ? std::min<size_t>(cached->key_size, key.size())
+               : cached->key_size;
+    const size_t known_size = std::min(size, cached->data.size());
+    const std::string_view known(cached->data.data(), known_size);
+
+    if (size == known_size) {
+      return known.compare(other);  // The compared key is fully cached.
+    }
+    if (const int result = known.compare(other.substr(0, known_size));
+        result != 0) {
+      return result;
+    }
+    if (other.size() <= known_size) {
+      return 1;  // The descriptor's key is longer than the other key.
     }
   }
 
-  return present_entries;
+  Entry::KeyBuffer key_buffer;
+  std::string_view stored =
+      AsStringView(ReadKey(partition, formats, descriptor_index, key_buffer));
+  if (prefix) {
+    stored = stored.substr(0, key.size());
+  }
+  return stored.compare(other);
 }
 
-int EntryCache::FindIndex(uint32_t key_hash) const {
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == key_hash) {
-      return i;
+Key EntryCache::ReadKey(FlashPartition& partition,
+                        const EntryFormats& formats,
+                        size_t descriptor_index,
+                        Entry::KeyBuffer& buffer) const {
+  for (Address address : addresses(descriptor_index)) {
+    Entry entry;
+    if (!Entry::Read(partition, address, formats, &entry).ok()) {
+      continue;
+    }
+    if (Key key; entry.ReadKey(buffer, &key).ok()) {
+      return key;
     }
   }
-  return -1;
+  PW_LOG_WARN("Failed to read key for entry %u", unsigned(descriptor_index));
+  return Key();
+}
+
+const EntryCache::KeyPrefix* EntryCache::key_prefix(
+    size_t descriptor_index) const {
+  if (index_.key_prefixes.empty() ||
+      index_.key_prefixes[descriptor_index].key_size == 0u) {
+    return nullptr;
+  }
+  return &index_.key_prefixes[descriptor_index];
 }
 
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
@@ -31,20 +31,81 @@ class EmptyEntryCache : public ::testing::Test {
   static constexpr size_t kMaxEntries = 32;
   static constexpr size_t kRedundancy = 3;
 
-  EmptyEntryCache() : entries_(descriptors_, addresses_, kRedundancy) {}
-
-  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EmptyEntryCache(bool indexed = false)
+      : entries_(descriptors_,
+                 addresses_,
+                 kRedundancy,
+                 indexed ? EntryCache::IndexBuffer<kMaxEntries>::index(index_)
+                         : EntryCache::Index{}) {}
+
+  KeyDescriptorBuffer<kMaxEntries> descriptors_;
   EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::IndexBuffer<kMaxEntries> index_;
 
   EntryCache entries_;
 };
 
 constexpr char kTheKey[] = "The Key";
 
-constexpr KeyDescriptor kDescriptor = {.key_hash = Hash(kTheKey),
+constexpr KeyDescriptor kDescriptor = {.key_hash = LegacyHash(kTheKey),
                                        .transaction_id = 123,
                                        .state = EntryState::kValid};
 
+TEST(Hash, EveryByteAffectsWordHash) {
+  constexpr char kLongKey[] = "a/long/key/with/several/words";
+  static_assert(WordHash(kLongKey) !=
+                WordHash("a/long/key/with/several/wordz"));
+  static_assert(WordHash(kLongKey) !=
+                WordHash("b/long/key/with/several/words"));
+  static_assert(WordHash(kLongKey) != WordHash("a/long/key/with/several/word"));
+  static_assert(WordHash("abc") != WordHash(Key("abc\0", 4)));
+  static_assert(WordHash("") != WordHash(Key("\0", 1)));
+}
+
+TEST(Hash, SelectsFunction) {
+  static_assert(Hash(kTheKey, KeyHash::kLegacy) == LegacyHash(kTheKey));
+  static_assert(Hash(kTheKey, KeyHash::kWordAtATime) == WordHash(kTheKey));
+  static_assert(LegacyHash(kTheKey) != WordHash(kTheKey));
+}
+
+TEST(EntryCache, HashesKeysWithSelectedFunction) {
+  KeyDescriptorBuffer<1> descriptors;
+  EntryCache::AddressList<1, 1> addresses;
+
+  EntryCache legacy(descriptors, addresses, 1);
+  EXPECT_EQ(KeyHash::kLegacy, legacy.key_hash());
+  EXPECT_EQ(LegacyHash(kTheKey), legacy.Hash(kTheKey));
+
+  EntryCache word(descriptors, addresses, 1, {}, KeyHash::kWordAtATime);
+  EXPECT_EQ(KeyHash::kWordAtATime, word.key_hash());
+  EXPECT_EQ(WordHash(kTheKey), word.Hash(kTheKey));
+}
+
+TEST(KeyDescriptorList, StoresFieldsInSeparateArrays) {
+  static_assert(KeyDescriptorList::kBytesPerEntry < sizeof(KeyDescriptor));
+
+  KeyDescriptorBuffer<4> list;
+  EXPECT_EQ(4u, list.max_size());
+
+  list.push_back(kDescriptor);
+  list.push_back(
+      {.key_hash = 1, .transaction_id = 2, .state = EntryState::kDeleted});
+  list.set(0,
+           {.key_hash = 3, .transaction_id = 4, .state = EntryState::kValid});
+
+  ASSERT_EQ(2u, list.size());
+  EXPECT_EQ(3u, list.key_hashes()[0]);
+  EXPECT_EQ(1u, list.key_hashes()[1]);
+  EXPECT_EQ(4u, list.transaction_ids()[0]);
+  EXPECT_EQ(2u, list.transaction_ids()[1]);
+  EXPECT_EQ(EntryState::kDeleted, list.states()[1]);
+  EXPECT_EQ(1u, list[1].key_hash);
+
+  list.clear();
+  EXPECT_EQ(0u, list.size());
+  EXPECT_TRUE(list.key_hashes().empty());
+}
+
 TEST_F(EmptyEntryCache, AddNew) {
   EntryMetadata metadata = entries_.AddNew(kDescriptor, 5);
   EXPECT_EQ(kDescriptor.key_hash, metadata.hash());
@@ -246,10 +307,11 @@ constexpr EntryFormat kFormat{.magic = uint32_t(kMagic), .checksum = nullptr};
 
 class InitializedEntryCache : public EmptyEntryCache {
  protected:
-  static_assert(Hash(kCollision1) == Hash(kCollision2));
+  static_assert(LegacyHash(kCollision1) == LegacyHash(kCollision2));
 
-  InitializedEntryCache()
-      : flash_(bytes::Concat(kTheEntry,
+  InitializedEntryCache(bool indexed = false)
+      : EmptyEntryCache(indexed),
+        flash_(bytes::Concat(kTheEntry,
                              kPadding1,
                              kTheEntry,
                              kPadding1,
@@ -262,22 +324,24 @@ class InitializedEntryCache : public EmptyEntryCache {
         format_(kFormat) {
     sectors_.Reset();
     size_t address = 0;
-    auto entry = entries_.AddNew(kDescriptor, address);
+    auto entry = entries_.AddNew(kDescriptor, address, kTheKey);
 
     address += kSize1;
     entry.AddNewAddress(kSize1);
 
     address += kSize1;
-    entries_.AddNew({.key_hash = Hash(kCollision1),
+    entries_.AddNew({.key_hash = LegacyHash(kCollision1),
                      .transaction_id = 125,
                      .state = EntryState::kDeleted},
-                    address);
+                    address,
+                    kCollision1);
 
     address += kSize2;
-    entries_.AddNew({.key_hash = Hash("delorted"),
+    entries_.AddNew({.key_hash = LegacyHash("delorted"),
                      .transaction_id = 256,
                      .state = EntryState::kDeleted},
-                    address);
+                    address,
+                    "delorted");
   }
 
   void CheckForCorruptSectors(SectorDescriptor* sector1 = nullptr,
@@ -321,7 +385,7 @@ TEST_F(InitializedEntryCache, Find_PresentEntry) {
 
   ASSERT_EQ(OkStatus(), result.status());
   EXPECT_EQ(0u, result.size());
-  EXPECT_EQ(Hash(kTheKey), metadata.hash());
+  EXPECT_EQ(LegacyHash(kTheKey), metadata.hash());
   EXPECT_EQ(EntryState::kValid, metadata.state());
   CheckForCorruptSectors();
 }
@@ -338,7 +402,7 @@ TEST_F(InitializedEntryCache, Find_PresentEntryWithSingleReadError) {
 
   ASSERT_EQ(OkStatus(), result.status());
   EXPECT_EQ(1u, result.size());
-  EXPECT_EQ(Hash(kTheKey), metadata.hash());
+  EXPECT_EQ(LegacyHash(kTheKey), metadata.hash());
   EXPECT_EQ(EntryState::kValid, metadata.state());
   CheckForCorruptSectors(&sectors_.FromAddress(0));
 }
@@ -365,7 +429,7 @@ TEST_F(InitializedEntryCache, Find_DeletedEntry) {
 
   ASSERT_EQ(OkStatus(), result.status());
   EXPECT_EQ(0u, result.size());
-  EXPECT_EQ(Hash("delorted"), metadata.hash());
+  EXPECT_EQ(LegacyHash("delorted"), metadata.hash());
   EXPECT_EQ(EntryState::kDeleted, metadata.state());
   CheckForCorruptSectors();
 }
@@ -391,5 +455,118 @@ TEST_F(InitializedEntryCache, Find_Collision) {
   CheckForCorruptSectors();
 }
 
+class IndexedEntryCache : public InitializedEntryCache {
+ protected:
+  IndexedEntryCache() : InitializedEntryCache(true) {}
+};
+
+TEST_F(IndexedEntryCache, EntryCounts) {
+  EXPECT_TRUE(entries_.indexed());
+  EXPECT_EQ(3u, entries_.total_entries());
+  EXPECT_EQ(1u, entries_.present_entries());
+}
+
+TEST_F(IndexedEntryCache, Find_ShortKey_DoesNotReadFlash) {
+  flash_.InjectReadError(FlashError::Unconditional(Status::Internal(), 4));
+
+  EntryMetadata metadata;
+  StatusWithSize result =
+      entries_.Find(partition_, sectors_, format_, kTheKey, &metadata);
+
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(LegacyHash(kTheKey), metadata.hash());
+  EXPECT_EQ(2u, metadata.addresses().size());
+  CheckForCorruptSectors();
+}
+
+TEST_F(IndexedEntryCache, Find_Collision_DoesNotReadFlash) {
+  flash_.InjectReadError(FlashError::Unconditional(Status::Internal(), 4));
+
+  EntryMetadata metadata;
+  StatusWithSize result =
+      entries_.Find(partition_, sectors_, format_, kCollision2, &metadata);
+
+  EXPECT_EQ(Status::AlreadyExists(), result.status());
+  EXPECT_EQ(0u, result.size());
+  CheckForCorruptSectors();
+}
+
+TEST_F(IndexedEntryCache, Find_DeletedEntry) {
+  EntryMetadata metadata;
+  StatusWithSize result =
+      entries_.Find(partition_, sectors_, format_, "delorted", &metadata);
+
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(EntryState::kDeleted, metadata.state());
+}
+
+TEST_F(IndexedEntryCache, Find_MissingEntry) {
+  EntryMetadata metadata;
+  EXPECT_EQ(Status::NotFound(),
+            entries_.Find(partition_, sectors_, format_, "3.141", &metadata)
+                .status());
+}
+
+TEST_F(IndexedEntryCache, Find_UnknownPrefix_ReadsKeyFromFlash) {
+  entries_.Reset();
+  entries_.AddNew(kDescriptor, 0);
+
+  flash_.InjectReadError(FlashError::Unconditional(Status::Internal(), 2));
+
+  // Without a cached prefix, the key is read from flash, which fails.
+  EntryMetadata metadata;
+  StatusWithSize result =
+      entries_.Find(partition_, sectors_, format_, kTheKey, &metadata);
+  EXPECT_EQ(Status::DataLoss(), result.status());
+}
+
+TEST_F(IndexedEntryCache, Reset_ClearsIndex) {
+  entries_.Reset();
+
+  EntryMetadata metadata;
+  EXPECT_EQ(Status::NotFound(),
+            entries_.Find(partition_, sectors_, format_, kTheKey, &metadata)
+                .status());
+
+  entries_.AddNew(kDescriptor, 0, kTheKey);
+  EXPECT_EQ(OkStatus(),
+            entries_.Find(partition_, sectors_, format_, kTheKey, &metadata)
+                .status());
+}
+
+class EmptyIndexedEntryCache : public EmptyEntryCache {
+ protected:
+  EmptyIndexedEntryCache() : EmptyEntryCache(true) {}
+};
+
+TEST_F(EmptyIndexedEntryCache, AddNewOrUpdateExisting_CollidingSlots) {
+  // These hashes all map to the same slot, so each lookup walks a long probe
+  // sequence.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * 1024, 1, EntryState::kValid}, i, 1));
+  }
+  EXPECT_TRUE(entries_.full());
+
+  // Update every entry. If any lookup failed, the update would report that the
+  // cache is full.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * 1024, 2, EntryState::kValid}, 1000 + i, 1));
+  }
+
+  ASSERT_EQ(kMaxEntries, entries_.total_entries());
+  uint32_t i = 0;
+  for (const EntryMetadata& metadata : entries_) {
+    EXPECT_EQ(i * 1024, metadata.hash());
+    EXPECT_EQ(2u, metadata.transaction_id());
+    EXPECT_EQ(1000 + i, metadata.first_address());
+    i += 1;
+  }
+}
+
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -217,6 +217,23 @@ TEST(ValidEntry, Write) {
             0);
 }
 
+TEST(ValidEntry, WriteChunks_MatchesContiguousValue) {
+  FakeFlashMemoryBuffer<1024, 4> flash;
+  FlashPartition partition(&flash, 0, flash.sector_count(), 32);
+
+  const std::span<const std::byte> chunks[] = {
+      std::span(kValue1).first(2), std::span<const std::byte>(),
+      std::span(kValue1).subspan(2)};
+  Entry entry = Entry::ValidFromChunks(
+      partition, 64, kFormatWithChecksum, "key45", chunks, kTransactionId1);
+
+  auto result = entry.WriteChunks("key45", chunks);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(32u, result.size());
+  EXPECT_EQ(std::memcmp(&flash.buffer()[64], kEntry1.data(), kEntry1.size()),
+            0);
+}
+
 constexpr auto kHeader2 = bytes::String(
     "\x42\x51\x16\xad"  // magic
     "\xba\xb3\x00\x00"  // checksum (CRC16)
@@ -76,6 +76,10 @@ Status FakeFlashMemory::Erase(Address address, size_t num_sectors) {
 
   std::memset(
       &buffer_[address], int(kErasedValue), sector_size_bytes() * num_sectors);
+  ReportLatency(FlashLatencyObserver::Operation::kErase,
+                sector_size_bytes() * num_sectors,
+                num_sectors,
+                timing_.erase_per_sector);
   return OkStatus();
 }
 
@@ -88,6 +92,10 @@ StatusWithSize FakeFlashMemory::Read(Address address,
   // Check for injected read errors
   Status status = FlashError::Check(read_errors_, address, output.size());
   std::memcpy(output.data(), &buffer_[address], output.size());
+  ReportLatency(FlashLatencyObserver::Operation::kRead,
+                output.size(),
+                output.size(),
+                timing_.read_per_byte);
   return StatusWithSize(status, output.size());
 }
 
@@ -123,9 +131,58 @@ StatusWithSize FakeFlashMemory::Write(Address address,
   // Check for any injected write errors
   Status status = FlashError::Check(write_errors_, address, data.size());
   std::memcpy(&buffer_[address], data.data(), data.size());
+  ReportLatency(FlashLatencyObserver::Operation::kWrite,
+                data.size(),
+                data.size(),
+                timing_.program_per_byte);
   return StatusWithSize(status, data.size());
 }
 
+Status FakeFlashMemory::StartWrite(Address address,
+                                   std::span<const std::byte> data) {
+  if (!async_operations_) {
+    return Status::Unimplemented();
+  }
+  if (pending_ != Pending::kNone) {
+    return Status::FailedPrecondition();
+  }
+  pending_ = Pending::kWrite;
+  pending_address_ = address;
+  pending_data_ = data;
+  async_operations_started_ += 1;
+  return OkStatus();
+}
+
+StatusWithSize FakeFlashMemory::FinishWrite(Address address) {
+  if (pending_ != Pending::kWrite || pending_address_ != address) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  pending_ = Pending::kNone;
+  return Write(address, pending_data_);
+}
+
+Status FakeFlashMemory::StartErase(Address address, size_t num_sectors) {
+  if (!async_operations_) {
+    return Status::Unimplemented();
+  }
+  if (pending_ != Pending::kNone) {
+    return Status::FailedPrecondition();
+  }
+  pending_ = Pending::kErase;
+  pending_address_ = address;
+  pending_sectors_ = num_sectors;
+  async_operations_started_ += 1;
+  return OkStatus();
+}
+
+Status FakeFlashMemory::FinishErase(Address address) {
+  if (pending_ != Pending::kErase || pending_address_ != address) {
+    return Status::FailedPrecondition();
+  }
+  pending_ = Pending::kNone;
+  return Erase(address, pending_sectors_);
+}
+
 std::byte* FakeFlashMemory::FlashAddressToMcuAddress(Address address) const {
   if (address > sector_count() * sector_size_bytes()) {
     PW_LOG_ERROR(
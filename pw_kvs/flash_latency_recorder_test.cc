@@ -0,0 +1,133 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_latency_recorder.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr FlashTiming kTiming{.operation_overhead = 2us,
+                              .read_per_byte = 10ns,
+                              .program_per_byte = 8us,
+                              .erase_per_sector = 20ms};
+
+class FlashLatency : public ::testing::Test {
+ protected:
+  FlashLatency() : recorder_(clock_) { flash_.SetTiming(kTiming, recorder_); }
+
+  chrono::SimulatedSystemClock clock_;
+  FlashLatencyRecorder recorder_;
+  FakeFlashMemoryBuffer<512, 8> flash_;
+};
+
+TEST_F(FlashLatency, NoTimingByDefault) {
+  flash_.ClearTiming();
+
+  std::array<std::byte, 16> data{};
+  ASSERT_EQ(OkStatus(), flash_.Write(0, data).status());
+  ASSERT_EQ(OkStatus(), flash_.Erase(0, 1));
+
+  EXPECT_EQ(recorder_.busy_time(), 0ns);
+  EXPECT_EQ(clock_.now().time_since_epoch(), chrono::SystemClock::duration(0));
+}
+
+TEST_F(FlashLatency, Read_ChargesPerByte) {
+  std::array<std::byte, 100> data;
+  ASSERT_EQ(OkStatus(), flash_.Read(0, data).status());
+
+  EXPECT_EQ(recorder_.reads().count(), 1u);
+  EXPECT_EQ(recorder_.reads().total(), 2us + 1000ns);
+  EXPECT_GE(clock_.now().time_since_epoch(), 3us);
+}
+
+TEST_F(FlashLatency, Write_ChargesPerByte) {
+  std::array<std::byte, 16> data{};
+  ASSERT_EQ(OkStatus(), flash_.Write(0, data).status());
+
+  EXPECT_EQ(recorder_.writes().count(), 1u);
+  EXPECT_EQ(recorder_.writes().max(), 2us + 16 * 8us);
+}
+
+TEST_F(FlashLatency, Erase_ChargesPerSector) {
+  ASSERT_EQ(OkStatus(), flash_.Erase(0, 3));
+
+  EXPECT_EQ(recorder_.erases().count(), 1u);
+  EXPECT_EQ(recorder_.erases().total(), 2us + 60ms);
+  EXPECT_GE(clock_.now().time_since_epoch(), 60ms);
+}
+
+TEST_F(FlashLatency, RejectedOperationsAreNotCharged) {
+  std::array<std::byte, 16> data{};
+  ASSERT_EQ(Status::InvalidArgument(), flash_.Erase(1, 1));
+  ASSERT_EQ(Status::OutOfRange(), flash_.Write(512 * 8, data).status());
+
+  EXPECT_EQ(recorder_.busy_time(), 0ns);
+}
+
+TEST(LatencyStats, Percentile) {
+  LatencyStats stats;
+  EXPECT_EQ(stats.Percentile(50), 0ns);
+
+  for (int i = 0; i < 9; ++i) {
+    stats.Add(10us);
+  }
+  stats.Add(5ms);
+
+  EXPECT_EQ(stats.count(), 10u);
+  EXPECT_EQ(stats.min(), 10us);
+  EXPECT_EQ(stats.max(), 5ms);
+  EXPECT_EQ(stats.mean(), (90us + 5ms) / 10);
+
+  // 10 us falls in the [8, 16) us bucket.
+  EXPECT_EQ(stats.Percentile(50), 16us);
+  EXPECT_EQ(stats.Percentile(90), 16us);
+  EXPECT_EQ(stats.Percentile(100), 5ms);
+  EXPECT_EQ(stats.histogram()[4], 9u);
+}
+
+// Measures the simulated latency of KeyValueStore::Put() with realistic
+// flash timing. Garbage collection erases sectors, so the slowest writes are
+// dominated by erase time.
+TEST_F(FlashLatency, KeyValueStorePut_GarbageCollectionStalls) {
+  constexpr EntryFormat format{.magic = 0x5b9a341e, .checksum = nullptr};
+  FlashPartition partition(&flash_);
+  KeyValueStoreBuffer<16, 8> kvs(&partition, format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  recorder_.Reset();
+
+  LatencyStats put_latency;
+  std::array<std::byte, 200> value{};
+  for (int i = 0; i < 64; ++i) {
+    value[0] = std::byte(i);
+    const chrono::SystemClock::time_point start = clock_.now();
+    ASSERT_EQ(OkStatus(), kvs.Put("key", value));
+    put_latency.Add(clock_.now() - start);
+  }
+
+  EXPECT_GT(recorder_.erases().count(), 0u);
+  EXPECT_GE(put_latency.max(), kTiming.erase_per_sector);
+  EXPECT_LT(put_latency.Percentile(50), kTiming.erase_per_sector);
+}
+
+}  // namespace
+}  // namespace pw::kvs
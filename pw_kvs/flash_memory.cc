@@ -120,6 +120,24 @@ StatusWithSize FlashPartition::Read(Address address, std::span<byte> output) {
   return flash_.Read(PartitionToFlashAddress(address), output);
 }
 
+const byte* FlashPartition::MappedAddress(Address address,
+                                         size_t size_bytes) const {
+  const byte* const base = flash_.mapped_base();
+  if (base == nullptr || size_bytes == 0u ||
+      address + size_bytes > this->size_bytes()) {
+    return nullptr;
+  }
+
+  const FlashMemory::Address flash_address = PartitionToFlashAddress(address);
+
+  // Partitions that reserve space in each sector are not contiguous in flash.
+  if (PartitionToFlashAddress(address + size_bytes - 1) !=
+      flash_address + size_bytes - 1) {
+    return nullptr;
+  }
+  return base + (flash_address - flash_.start_address());
+}
+
 StatusWithSize FlashPartition::Write(Address address,
                                      std::span<const byte> data) {
   if (permission_ == PartitionPermission::kReadOnly) {
@@ -133,6 +151,31 @@ StatusWithSize FlashPartition::Write(Address address,
   return flash_.Write(PartitionToFlashAddress(address), data);
 }
 
+Status FlashPartition::StartWrite(Address address,
+                                  std::span<const byte> data) {
+  if (permission_ == PartitionPermission::kReadOnly) {
+    return Status::PermissionDenied();
+  }
+  PW_TRY(CheckBounds(address, data.size()));
+  const size_t address_alignment_offset = address % alignment_bytes();
+  PW_CHECK_UINT_EQ(address_alignment_offset, 0u);
+  const size_t size_alignment_offset = data.size() % alignment_bytes();
+  PW_CHECK_UINT_EQ(size_alignment_offset, 0u);
+  return flash_.StartWrite(PartitionToFlashAddress(address), data);
+}
+
+Status FlashPartition::StartErase(Address address, size_t num_sectors) {
+  if (permission_ == PartitionPermission::kReadOnly) {
+    return Status::PermissionDenied();
+  }
+
+  PW_TRY(CheckBounds(address, num_sectors * sector_size_bytes()));
+  const size_t address_sector_offset = address % sector_size_bytes();
+  PW_CHECK_UINT_EQ(address_sector_offset, 0u);
+
+  return flash_.StartErase(PartitionToFlashAddress(address), num_sectors);
+}
+
 Status FlashPartition::IsRegionErased(Address source_flash_address,
                                       size_t length,
                                       bool* is_erased) {
@@ -0,0 +1,76 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_operation.h"
+
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+Status FlashOperation::StartWrite(FlashPartition::Address address,
+                                  std::span<const std::byte> data) {
+  if (in_progress()) {
+    return Status::FailedPrecondition();
+  }
+
+  const Status status = partition_.StartWrite(address, data);
+  if (status.IsUnimplemented()) {
+    result_ = partition_.Write(address, data);
+    state_ = State::kDone;
+    return OkStatus();
+  }
+  PW_TRY(status);
+
+  address_ = address;
+  state_ = State::kWriting;
+  return OkStatus();
+}
+
+Status FlashOperation::StartErase(FlashPartition::Address address,
+                                  size_t num_sectors) {
+  if (in_progress()) {
+    return Status::FailedPrecondition();
+  }
+
+  const Status status = partition_.StartErase(address, num_sectors);
+  if (status.IsUnimplemented()) {
+    result_ = StatusWithSize(partition_.Erase(address, num_sectors), 0);
+    state_ = State::kDone;
+    return OkStatus();
+  }
+  PW_TRY(status);
+
+  address_ = address;
+  state_ = State::kErasing;
+  return OkStatus();
+}
+
+StatusWithSize FlashOperation::Finish() {
+  const State state = state_;
+  state_ = State::kIdle;
+
+  switch (state) {
+    case State::kWriting:
+      return partition_.FinishWrite(address_);
+    case State::kErasing:
+      return StatusWithSize(partition_.FinishErase(address_), 0);
+    case State::kDone:
+      return result_;
+    case State::kIdle:
+      break;
+  }
+  return StatusWithSize::FailedPrecondition();
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,108 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_operation.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+
+namespace pw::kvs {
+namespace {
+
+class FlashOperationTest : public ::testing::Test {
+ protected:
+  FlashOperationTest() : partition_(&flash_), operation_(partition_) {}
+
+  bool SectorErased(size_t sector) {
+    bool erased = false;
+    EXPECT_EQ(OkStatus(),
+              partition_.IsRegionErased(sector * 512, 512, &erased));
+    return erased;
+  }
+
+  FakeFlashMemoryBuffer<512, 4> flash_;
+  FlashPartition partition_;
+  FlashOperation operation_;
+};
+
+TEST_F(FlashOperationTest, Finish_NothingStarted) {
+  EXPECT_FALSE(operation_.in_progress());
+  EXPECT_EQ(Status::FailedPrecondition(), operation_.Finish().status());
+}
+
+TEST_F(FlashOperationTest, SynchronousFlash_WriteDoneWhenStarted) {
+  constexpr std::array<std::byte, 16> kData{std::byte{0x12}};
+  ASSERT_EQ(OkStatus(), operation_.StartWrite(0, kData));
+  EXPECT_TRUE(operation_.in_progress());
+  EXPECT_FALSE(operation_.asynchronous());
+  EXPECT_EQ(std::byte{0x12}, flash_.buffer()[0]);
+
+  const StatusWithSize result = operation_.Finish();
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kData.size(), result.size());
+  EXPECT_FALSE(operation_.in_progress());
+}
+
+TEST_F(FlashOperationTest, SynchronousFlash_ErrorReturnedByFinish) {
+  flash_.InjectWriteError(FlashError::Unconditional(Status::Unavailable(), 1));
+
+  constexpr std::array<std::byte, 16> kData{};
+  ASSERT_EQ(OkStatus(), operation_.StartWrite(0, kData));
+  EXPECT_EQ(Status::Unavailable(), operation_.Finish().status());
+}
+
+TEST_F(FlashOperationTest, AsynchronousFlash_EraseDoneWhenFinished) {
+  flash_.set_async_operations(true);
+  flash_.buffer()[512] = std::byte{0};
+
+  ASSERT_EQ(OkStatus(), operation_.StartErase(512, 1));
+  EXPECT_TRUE(operation_.asynchronous());
+  EXPECT_FALSE(SectorErased(1));
+
+  EXPECT_EQ(OkStatus(), operation_.Finish().status());
+  EXPECT_TRUE(SectorErased(1));
+  EXPECT_EQ(1u, flash_.async_operations_started());
+}
+
+TEST_F(FlashOperationTest, AsynchronousFlash_WriteDoneWhenFinished) {
+  flash_.set_async_operations(true);
+
+  constexpr std::array<std::byte, 16> kData{std::byte{0x34}};
+  ASSERT_EQ(OkStatus(), operation_.StartWrite(16, kData));
+  EXPECT_EQ(FakeFlashMemory::kErasedValue, flash_.buffer()[16]);
+
+  EXPECT_EQ(kData.size(), operation_.Finish().size());
+  EXPECT_EQ(std::byte{0x34}, flash_.buffer()[16]);
+}
+
+TEST_F(FlashOperationTest, OneOperationAtATime) {
+  ASSERT_EQ(OkStatus(), operation_.StartErase(0, 1));
+  EXPECT_EQ(Status::FailedPrecondition(), operation_.StartErase(512, 1));
+  EXPECT_EQ(OkStatus(), operation_.Finish().status());
+  EXPECT_EQ(OkStatus(), operation_.StartErase(512, 1));
+  EXPECT_EQ(OkStatus(), operation_.Finish().status());
+}
+
+TEST_F(FlashOperationTest, StartFailure_NotInProgress) {
+  flash_.set_async_operations(true);
+  EXPECT_EQ(Status::OutOfRange(), operation_.StartErase(512 * 4, 1));
+  EXPECT_FALSE(operation_.in_progress());
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -18,8 +18,11 @@
 #include "pw_kvs/key_value_store.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstring>
+#include <limits>
+#include <mutex>
 #include <type_traits>
 
 #include "pw_assert/check.h"
@@ -32,8 +35,66 @@ namespace {
 
 using std::byte;
 
-constexpr bool InvalidKey(Key key) {
-  return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
+// Reserved keys for the tombstones that mark the start and end of a batch.
+constexpr char kBatchStartMarker[] = "\0pw_kvs.batch_start";
+constexpr char kBatchCommitMarker[] = "\0pw_kvs.batch_commit";
+
+constexpr Key kBatchStartKey(kBatchStartMarker, sizeof(kBatchStartMarker) - 1);
+constexpr Key kBatchCommitKey(kBatchCommitMarker,
+                              sizeof(kBatchCommitMarker) - 1);
+
+// Reserved key for checkpoint entries, which are not loaded as keys.
+constexpr char kCheckpointMarker[] = "\0pw_kvs.checkpoint";
+constexpr Key kCheckpointKey(kCheckpointMarker, sizeof(kCheckpointMarker) - 1);
+
+bool InvalidKey(Key key) {
+  return key.empty() || (key.size() > internal::Entry::kMaxKeyLength) ||
+         key == kBatchStartKey || key == kBatchCommitKey ||
+         key == kCheckpointKey;
+}
+
+// The start of a checkpoint's value. The sector descriptors, key descriptors,
+// and address lists follow it in their in-memory layout, so a checkpoint is
+// only loaded by firmware that uses the same layout and configuration.
+struct CheckpointHeader {
+  uint8_t version;
+  KeyHash key_hash;
+  uint8_t sector_descriptor_size;
+  uint8_t key_descriptor_size;
+  uint8_t address_size;
+  uint8_t redundancy;
+  uint16_t sector_count;
+  uint32_t sector_size_bytes;
+  uint32_t entry_count;
+
+  bool operator==(const CheckpointHeader& other) const {
+    return std::memcmp(this, &other, sizeof(*this)) == 0;
+  }
+};
+
+static_assert(std::has_unique_object_representations_v<CheckpointHeader>);
+
+// Version 2 stores key hashes computed with the word-at-a-time internal::Hash.
+// Version 3 stores each KeyDescriptor field in a separate array.
+// Version 4 records the KeyHash used for the stored key hashes.
+constexpr uint8_t kCheckpointVersion = 4;
+
+CheckpointHeader MakeCheckpointHeader(KeyHash key_hash,
+                                      size_t sector_count,
+                                      size_t redundancy,
+                                      size_t sector_size_bytes,
+                                      size_t entry_count) {
+  return {
+      .version = kCheckpointVersion,
+      .key_hash = key_hash,
+      .sector_descriptor_size = sizeof(internal::SectorDescriptor),
+      .key_descriptor_size = internal::KeyDescriptorList::kBytesPerEntry,
+      .address_size = sizeof(FlashPartition::Address),
+      .redundancy = static_cast<uint8_t>(redundancy),
+      .sector_count = static_cast<uint16_t>(sector_count),
+      .sector_size_bytes = static_cast<uint32_t>(sector_size_bytes),
+      .entry_count = static_cast<uint32_t>(entry_count),
+  };
 }
 
 }  // namespace
@@ -44,17 +105,30 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              size_t redundancy,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
-                             Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             KeyDescriptorList& key_descriptor_list,
+                             Address* addresses,
+                             internal::EntryCache::Index index,
+                             internal::ValueCache::Storage value_cache)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      entry_cache_(key_descriptor_list,
+                   addresses,
+                   redundancy,
+                   index,
+                   options.key_hash),
+      value_cache_(value_cache),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
+      read_state_lock_(&sync::NoOpLock::Instance()),
       internal_stats_({}),
-      last_transaction_id_(0) {}
+      last_transaction_id_(0),
+      batch_in_progress_(false),
+      batch_rollback_pending_(false),
+      incremental_gc_sector_(nullptr),
+      checkpoint_sector_(nullptr),
+      checkpoint_size_bytes_(0) {}
 
 Status KeyValueStore::Init() {
   initialized_ = InitializationState::kNotInitialized;
@@ -139,87 +213,146 @@ Status KeyValueStore::Init() {
 Status KeyValueStore::InitializeMetadata() {
   const size_t sector_size_bytes = partition_.sector_size_bytes();
 
-  sectors_.Reset();
-  entry_cache_.Reset();
-
-  DBG("First pass: Read all entries from all sectors");
-  Address sector_address = 0;
-
-  size_t total_corrupt_bytes = 0;
-  size_t corrupt_entries = 0;
-  bool empty_sector_found = false;
+  size_t total_corrupt_bytes;
+  size_t corrupt_entries;
+  bool empty_sector_found;
   size_t entry_copies_missing = 0;
 
-  for (SectorDescriptor& sector : sectors_) {
-    Address entry_address = sector_address;
+  // Entries with newer transaction IDs than this are not loaded. This is
+  // lowered to roll back an interrupted batch.
+  uint32_t max_transaction_id = std::numeric_limits<uint32_t>::max();
+  batch_rollback_pending_ = false;
+  incremental_gc_sector_ = nullptr;
+  value_cache_.Reset();
+
+  // Rolling back a batch reloads all entries, so only use a checkpoint for the
+  // first pass.
+  bool use_checkpoint = options_.checkpoint;
+
+  while (true) {
+    sectors_.Reset();
+    entry_cache_.Reset();
+    checkpoint_sector_ = nullptr;
+    checkpoint_size_bytes_ = 0;
+
+    // A checkpoint sets each sector's writable bytes, so only the entries
+    // written after the checkpoint need to be read.
+    if (use_checkpoint) {
+      const Status checkpoint_status = LoadCheckpoint();
+      if (checkpoint_status.ok()) {
+        DBG("Loaded %u entries from checkpoint",
+            unsigned(entry_cache_.total_entries()));
+      } else {
+        DBG("Not using a checkpoint: %s", checkpoint_status.str());
+        sectors_.Reset();
+        entry_cache_.Reset();
+        use_checkpoint = false;
+      }
+    }
 
-    size_t sector_corrupt_bytes = 0;
+    DBG("First pass: Read all entries from all sectors");
+    Address sector_address = 0;
 
-    for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
-      DBG("Load entry: sector=%u, entry#=%d, address=%u",
-          unsigned(sector_address),
-          num_entries_in_sector,
-          unsigned(entry_address));
+    total_corrupt_bytes = 0;
+    corrupt_entries = 0;
+    empty_sector_found = false;
 
-      if (!sectors_.AddressInSector(sector, entry_address)) {
-        DBG("Fell off end of sector; moving to the next sector");
-        break;
-      }
+    for (SectorDescriptor& sector : sectors_) {
+      Address entry_address =
+          sector_address + sector_size_bytes - sector.writable_bytes();
 
-      Address next_entry_address;
-      Status status = LoadEntry(entry_address, &next_entry_address);
-      if (status.IsNotFound()) {
-        DBG("Hit un-written data in sector; moving to the next sector");
-        break;
-      } else if (!status.ok()) {
-        // The entry could not be read, indicating likely data corruption within
-        // the sector. Try to scan the remainder of the sector for other
-        // entries.
+      size_t sector_corrupt_bytes = 0;
 
-        error_detected_ = true;
-        corrupt_entries++;
+      for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
+        DBG("Load entry: sector=%u, entry#=%d, address=%u",
+            unsigned(sector_address),
+            num_entries_in_sector,
+            unsigned(entry_address));
 
-        status = ScanForEntry(sector,
-                              entry_address + Entry::kMinAlignmentBytes,
-                              &next_entry_address);
-        if (!status.ok()) {
-          // No further entries in this sector. Mark the remaining bytes in the
-          // sector as corrupt (since we can't reliably know the size of the
-          // corrupt entry).
-          sector_corrupt_bytes +=
-              sector_size_bytes - (entry_address - sector_address);
+        if (!sectors_.AddressInSector(sector, entry_address)) {
+          DBG("Fell off end of sector; moving to the next sector");
           break;
         }
 
-        sector_corrupt_bytes += next_entry_address - entry_address;
-      }
+        Address next_entry_address;
+        Status status =
+            LoadEntry(entry_address, &next_entry_address, max_transaction_id);
+        if (status.IsNotFound()) {
+          if (StreamWriteInterrupted(sector, entry_address)) {
+            WRN("Found a partially written entry at %u",
+                unsigned(entry_address));
+            error_detected_ = true;
+            corrupt_entries++;
+            sector_corrupt_bytes +=
+                sector_size_bytes - (entry_address - sector_address);
+          }
+          DBG("Hit un-written data in sector; moving to the next sector");
+          break;
+        } else if (!status.ok()) {
+          // The entry could not be read, indicating likely data corruption
+          // within the sector. Try to scan the remainder of the sector for
+          // other entries.
+
+          error_detected_ = true;
+          corrupt_entries++;
+
+          status = ScanForEntry(sector,
+                                entry_address + Entry::kMinAlignmentBytes,
+                                &next_entry_address);
+          if (!status.ok()) {
+            // No further entries in this sector. Mark the remaining bytes in
+            // the sector as corrupt (since we can't reliably know the size of
+            // the corrupt entry).
+            sector_corrupt_bytes +=
+                sector_size_bytes - (entry_address - sector_address);
+            break;
+          }
+
+          sector_corrupt_bytes += next_entry_address - entry_address;
+        }
 
-      // Entry loaded successfully; so get ready to load the next one.
-      entry_address = next_entry_address;
+        // Entry loaded successfully; so get ready to load the next one.
+        entry_address = next_entry_address;
 
-      // Update of the number of writable bytes in this sector.
-      sector.set_writable_bytes(sector_size_bytes -
-                                (entry_address - sector_address));
-    }
+        // Update of the number of writable bytes in this sector.
+        sector.set_writable_bytes(sector_size_bytes -
+                                  (entry_address - sector_address));
+      }
 
-    if (sector_corrupt_bytes > 0) {
-      // If the sector contains corrupt data, prevent any further entries from
-      // being written to it by indicating that it has no space. This should
-      // also make it a decent GC candidate. Valid keys in the sector are still
-      // readable as normal.
-      sector.mark_corrupt();
-      error_detected_ = true;
+      if (sector_corrupt_bytes > 0) {
+        // If the sector contains corrupt data, prevent any further entries
+        // from being written to it by indicating that it has no space. This
+        // should also make it a decent GC candidate. Valid keys in the sector
+        // are still readable as normal.
+        sector.mark_corrupt();
+        error_detected_ = true;
+
+        WRN("Sector %u contains %uB of corrupt data",
+            sectors_.Index(sector),
+            unsigned(sector_corrupt_bytes));
+      }
 
-      WRN("Sector %u contains %uB of corrupt data",
-          sectors_.Index(sector),
-          unsigned(sector_corrupt_bytes));
+      if (sector.Empty(sector_size_bytes)) {
+        empty_sector_found = true;
+      }
+      sector_address += sector_size_bytes;
+      total_corrupt_bytes += sector_corrupt_bytes;
     }
 
-    if (sector.Empty(sector_size_bytes)) {
-      empty_sector_found = true;
+    // If a batch was interrupted, its start marker is newer than its commit
+    // marker. All of the batch's entries are newer than its start marker, so
+    // reload the entries without them.
+    const uint32_t batch_start_id = BatchMarkerTransactionId(kBatchStartKey);
+    if (batch_rollback_pending_ ||
+        batch_start_id <= BatchMarkerTransactionId(kBatchCommitKey)) {
+      break;
     }
-    sector_address += sector_size_bytes;
-    total_corrupt_bytes += sector_corrupt_bytes;
+
+    WRN("Rolling back batch interrupted after transaction %u",
+        unsigned(batch_start_id));
+    batch_rollback_pending_ = true;
+    max_transaction_id = batch_start_id;
+    use_checkpoint = false;
   }
 
   DBG("Second pass: Count valid bytes in each sector");
@@ -270,6 +403,11 @@ Status KeyValueStore::InitializeMetadata() {
 
   sectors_.set_last_new_sector(newest_key);
 
+  if (batch_rollback_pending_) {
+    DBG("Interrupted batch must be removed from flash");
+    error_detected_ = true;
+  }
+
   if (!empty_sector_found) {
     DBG("No empty sector found");
     error_detected_ = true;
@@ -297,6 +435,92 @@ Status KeyValueStore::InitializeMetadata() {
   return OkStatus();
 }
 
+Status KeyValueStore::LoadCheckpoint() {
+  // The checkpoint is always the first entry in its sector, so only the first
+  // entry of each sector is read to find it.
+  Entry checkpoint;
+  bool found = false;
+
+  for (SectorDescriptor& sector : sectors_) {
+    Entry entry;
+    if (!Entry::Read(partition_, sectors_.BaseAddress(sector), formats_, &entry)
+             .ok()) {
+      continue;
+    }
+
+    Entry::KeyBuffer key_buffer;
+    if (Key key;
+        !entry.ReadKey(key_buffer, &key).ok() || key != kCheckpointKey) {
+      continue;
+    }
+
+    if (found) {
+      return Status::AlreadyExists();
+    }
+    PW_TRY(entry.VerifyChecksumInFlash());
+    checkpoint = entry;
+    found = true;
+  }
+
+  if (!found) {
+    return Status::NotFound();
+  }
+
+  // Reads the next part of the checkpoint's value.
+  size_t offset = 0;
+  auto read = [&](std::span<byte> buffer) {
+    const StatusWithSize result = checkpoint.ReadValue(buffer, offset);
+    offset += buffer.size();
+
+    // RESOURCE_EXHAUSTED indicates that more of the value remains.
+    if (!result.ok() && !result.IsResourceExhausted()) {
+      return result.status();
+    }
+    return result.size() == buffer.size() ? OkStatus() : Status::DataLoss();
+  };
+
+  CheckpointHeader header;
+  PW_TRY(read(std::as_writable_bytes(std::span(&header, 1))));
+
+  const CheckpointHeader expected_header =
+      MakeCheckpointHeader(entry_cache_.key_hash(),
+                           sectors_.size(),
+                           redundancy(),
+                           partition_.sector_size_bytes(),
+                           header.entry_count);
+  const size_t value_size =
+      sizeof(header) + sectors_.size() * sizeof(SectorDescriptor) +
+      header.entry_count *
+          (internal::KeyDescriptorList::kBytesPerEntry +
+           redundancy() * sizeof(Address));
+
+  if (!(header == expected_header) ||
+      header.entry_count > entry_cache_.max_entries() ||
+      checkpoint.value_size() != value_size) {
+    return Status::FailedPrecondition();
+  }
+
+  for (SectorDescriptor& sector : sectors_) {
+    SectorDescriptor saved = sector;
+    PW_TRY(read(std::as_writable_bytes(std::span(&saved, 1))));
+    sector.set_writable_bytes(saved.writable_bytes());
+  }
+
+  PW_TRY(entry_cache_.Restore(header.entry_count, read));
+
+  // Check that the entries are where the checkpoint says they are.
+  for (const EntryMetadata& metadata : entry_cache_) {
+    for (Address address : metadata.addresses()) {
+      Entry entry;
+      PW_TRY(Entry::Read(partition_, address, formats_, &entry));
+      if (entry.transaction_id() != metadata.transaction_id()) {
+        return Status::DataLoss();
+      }
+    }
+  }
+  return OkStatus();
+}
+
 KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   StorageStats stats{};
   const size_t sector_size = partition_.sector_size_bytes();
@@ -351,22 +575,44 @@ bool KeyValueStore::CheckForErrors() {
 }
 
 Status KeyValueStore::LoadEntry(Address entry_address,
-                                Address* next_entry_address) {
+                                Address* next_entry_address,
+                                uint32_t max_transaction_id) {
   Entry entry;
   PW_TRY(Entry::Read(partition_, entry_address, formats_, &entry));
 
-  // Read the key from flash & validate the entry (which reads the value).
+  // Read the key from flash & validate the entry (which reads the value). On
+  // memory-mapped flash, the key is hashed and compared in place.
   Entry::KeyBuffer key_buffer;
-  PW_TRY_ASSIGN(size_t key_length, entry.ReadKey(key_buffer));
-  const Key key(key_buffer.data(), key_length);
+  Key key;
+  PW_TRY(entry.ReadKey(key_buffer, &key));
 
   PW_TRY(entry.VerifyChecksumInFlash());
 
   // A valid entry was found, so update the next entry address before doing any
   // of the checks that happen in AddNewOrUpdateExisting.
   *next_entry_address = entry.next_address();
+
+  if (key == kCheckpointKey) {
+    // Checkpoints are not keys. Count the checkpoint as valid data, so that its
+    // sector is not garbage collected only to remove it.
+    if (checkpoint_sector_ == nullptr) {
+      checkpoint_sector_ = &sectors_.FromAddress(entry_address);
+      checkpoint_size_bytes_ = entry.size();
+      checkpoint_sector_->AddValidBytes(entry.size());
+    }
+    return OkStatus();
+  }
+
+  if (entry.transaction_id() > max_transaction_id) {
+    DBG("Skipping entry from interrupted batch; transaction %u",
+        unsigned(entry.transaction_id()));
+    return OkStatus();
+  }
   return entry_cache_.AddNewOrUpdateExisting(
-      entry.descriptor(key), entry.address(), partition_.sector_size_bytes());
+      entry.descriptor(entry_cache_.Hash(key)),
+      entry.address(),
+      partition_.sector_size_bytes(),
+      key);
 }
 
 // Scans flash memory within a sector to find a KVS entry magic.
@@ -400,23 +646,82 @@ Status KeyValueStore::ScanForEntry(const SectorDescriptor& sector,
   return Status::NotFound();
 }
 
+bool KeyValueStore::StreamWriteInterrupted(const SectorDescriptor& sector,
+                                           Address entry_address) const {
+  // A streamed entry is written after its first alignment unit, which holds
+  // the header, so check the start of the data after that unit.
+  const Address data_address =
+      entry_address +
+      AlignUp(partition_.alignment_bytes(), Entry::kMinAlignmentBytes);
+  if (!sectors_.AddressInSector(sector, data_address)) {
+    return false;
+  }
+
+  std::array<byte, Entry::kMinAlignmentBytes> data;
+  if (!partition_.Read(data_address, data).ok()) {
+    return false;
+  }
+  return !partition_.AppearsErased(data);
+}
+
 StatusWithSize KeyValueStore::Get(Key key,
                                   std::span<byte> value_buffer,
                                   size_t offset_bytes) const {
   PW_TRY_WITH_SIZE(CheckReadOperation(key));
 
+  {
+    std::lock_guard lock(*read_state_lock_);
+    if (StatusWithSize cached =
+            value_cache_.Get(key, value_buffer, offset_bytes);
+        !cached.IsNotFound()) {
+      return cached;
+    }
+  }
+
   EntryMetadata metadata;
   PW_TRY_WITH_SIZE(FindExisting(key, &metadata));
 
   return Get(key, metadata, value_buffer, offset_bytes);
 }
 
+StatusWithSize KeyValueStore::Get(Key key, stream::Writer& writer) const {
+  PW_TRY_WITH_SIZE(CheckReadOperation(key));
+
+  EntryMetadata metadata;
+  PW_TRY_WITH_SIZE(FindExisting(key, &metadata));
+
+  Entry entry;
+  PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
+  if (!options_.verify_on_read) {
+    return entry.ReadValue(writer, false);
+  }
+
+  // The checksum algorithm is shared by all readers, so hold the lock while
+  // streaming to verify the value in the same pass that reads it.
+  std::lock_guard lock(*read_state_lock_);
+  return entry.ReadValue(writer, true);
+}
+
 Status KeyValueStore::PutBytes(Key key, std::span<const byte> value) {
   PW_TRY(CheckWriteOperation(key));
   DBG("Writing key/value; key length=%u, value length=%u",
       unsigned(key.size()),
       unsigned(value.size()));
 
+  // Store the value compressed if the primary format has a codec and the value
+  // shrinks. Otherwise, store it as is.
+  bool compressed = false;
+  if (ValueCodec* codec = formats_.primary().codec; codec != nullptr) {
+    const StatusWithSize result = codec->Compress(value);
+    if (result.ok() && result.size() < value.size()) {
+      DBG("Compressed %u B value to %u B",
+          unsigned(value.size()),
+          unsigned(result.size()));
+      value = codec->buffer().first(result.size());
+      compressed = true;
+    }
+  }
+
   if (Entry::size(partition_, key, value) > partition_.sector_size_bytes()) {
     DBG("%u B value with %u B key cannot fit in one sector",
         unsigned(value.size()),
@@ -433,11 +738,49 @@ Status KeyValueStore::PutBytes(Key key, std::span<const byte> value) {
         unsigned(metadata.hash()),
         unsigned(metadata.addresses().size()),
         sectors_.Index(metadata.first_address()));
-    return WriteEntryForExistingKey(metadata, EntryState::kValid, key, value);
+    return WriteEntryForExistingKey(
+        metadata, EntryState::kValid, key, value, compressed);
+  }
+
+  if (status.IsNotFound()) {
+    return WriteEntryForNewKey(key, value, compressed);
+  }
+
+  return status;
+}
+
+Status KeyValueStore::Put(Key key, stream::Reader& reader, size_t value_size) {
+  PW_TRY(CheckWriteOperation(key));
+  DBG("Writing key/value from stream; key length=%u, value length=%u",
+      unsigned(key.size()),
+      unsigned(value_size));
+
+  if (value_size > Entry::kMaxValueSizeBytes ||
+      Entry::size(partition_, key, value_size) >
+          partition_.sector_size_bytes()) {
+    DBG("%u B value with %u B key cannot fit in one sector",
+        unsigned(value_size),
+        unsigned(key.size()));
+    return Status::InvalidArgument();
+  }
+
+  EntryMetadata metadata;
+  Status status = FindEntry(key, &metadata);
+
+  if (status.ok()) {
+    // Read the original entry to get the size for sector accounting purposes.
+    Entry entry;
+    PW_TRY(ReadEntry(metadata, entry));
+    return WriteStreamEntry(key, reader, value_size, &metadata, entry.size());
   }
 
   if (status.IsNotFound()) {
-    return WriteEntryForNewKey(key, value);
+    if (entry_cache_.full()) {
+      WRN("KVS full: trying to store a new entry, but can't. Have %u entries",
+          unsigned(entry_cache_.total_entries()));
+      return Status::ResourceExhausted();
+    }
+    return WriteStreamEntry(key, reader, value_size, nullptr, 0);
   }
 
   return status;
@@ -457,6 +800,186 @@ Status KeyValueStore::Delete(Key key) {
   return WriteEntryForExistingKey(metadata, EntryState::kDeleted, key, {});
 }
 
+Status KeyValueStore::Batch::Add(Key key,
+                                 std::span<const byte> value,
+                                 bool deleted) {
+  if (size_ == operations_.size()) {
+    return Status::ResourceExhausted();
+  }
+  operations_[size_++] = {key, value, deleted};
+  return OkStatus();
+}
+
+Status KeyValueStore::Commit(const Batch& batch) {
+  if (!initialized()) {
+    return Status::FailedPrecondition();
+  }
+  if (batch.empty()) {
+    return OkStatus();
+  }
+
+  size_t write_size;
+  PW_TRY(CheckBatch(batch, &write_size));
+  PW_TRY(ReserveSpaceForBatch(write_size));
+
+  DBG("Writing batch of %u operations, %u B",
+      unsigned(batch.size()),
+      unsigned(write_size));
+
+  // The batch's entries are written between a start marker and a commit marker.
+  // If the commit marker is not written, Init rolls back the batch.
+  batch_in_progress_ = true;
+  Status status = WriteBatchMarker(kBatchStartKey);
+
+  for (const Batch::Operation& operation : batch.operations()) {
+    if (!status.ok()) {
+      break;
+    }
+    status = operation.deleted ? Delete(operation.key)
+                               : PutBytes(operation.key, operation.value);
+  }
+
+  if (status.ok()) {
+    status = WriteBatchMarker(kBatchCommitKey);
+  }
+  batch_in_progress_ = false;
+
+  if (!status.ok()) {
+    // Reload the KVS from flash, which rolls back the batch as Init would after
+    // a reboot.
+    ERR("Failed to write batch, rolling back");
+    initialized_ = InitializationState::kNeedsMaintenance;
+    if (!Repair().ok()) {
+      ERR("Unable to complete batch rollback, KVS needs maintenance");
+    }
+  }
+  return status;
+}
+
+// Checks every operation in a batch, so that nothing is written for a batch
+// that cannot succeed. Returns the number of bytes to write for the batch,
+// including its markers and redundant copies.
+Status KeyValueStore::CheckBatch(const Batch& batch, size_t* write_size) {
+  const std::span<const Batch::Operation> operations = batch.operations();
+  size_t new_keys = 0;
+  size_t entries_size = 0;
+
+  for (size_t i = 0; i < operations.size(); ++i) {
+    const Batch::Operation& operation = operations[i];
+    PW_TRY(CheckWriteOperation(operation.key));
+
+    const size_t entry_size =
+        Entry::size(partition_, operation.key, operation.value);
+    if (entry_size > partition_.sector_size_bytes()) {
+      DBG("%u B value with %u B key cannot fit in one sector",
+          unsigned(operation.value.size()),
+          unsigned(operation.key.size()));
+      return Status::InvalidArgument();
+    }
+    entries_size += entry_size;
+
+    // If an earlier operation in the batch has the same key, this operation
+    // applies to its result rather than to the KVS.
+    const Batch::Operation* previous = nullptr;
+    for (size_t j = 0; j < i; ++j) {
+      if (operations[j].key == operation.key) {
+        previous = &operations[j];
+      }
+    }
+
+    bool exists;
+    if (previous != nullptr) {
+      exists = !previous->deleted;
+    } else {
+      EntryMetadata metadata;
+      Status status = FindEntry(operation.key, &metadata);
+      if (status.ok()) {
+        exists = metadata.state() == EntryState::kValid;
+      } else if (status.IsNotFound()) {
+        exists = false;
+        new_keys += 1;
+      } else if (status.IsAlreadyExists() && operation.deleted) {
+        exists = false;
+      } else {
+        return status;
+      }
+    }
+
+    if (operation.deleted && !exists) {
+      return Status::NotFound();
+    }
+  }
+
+  for (Key marker : {kBatchStartKey, kBatchCommitKey}) {
+    entries_size += Entry::size(partition_, marker, {});
+    if (BatchMarkerTransactionId(marker) == 0u) {
+      new_keys += 1;
+    }
+  }
+
+  if (entry_cache_.total_entries() + new_keys > entry_cache_.max_entries()) {
+    WRN("KVS full: a batch needs %u new entries, but only %u are available",
+        unsigned(new_keys),
+        unsigned(entry_cache_.max_entries() - entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+
+  *write_size = entries_size * redundancy();
+  return OkStatus();
+}
+
+// Garbage collects until the batch fits in the writable space, so that no
+// garbage collection is needed while the batch is written.
+Status KeyValueStore::ReserveSpaceForBatch(size_t write_size) {
+  size_t gc_sector_count = 0;
+
+  while (GetStorageStats().writable_bytes < write_size) {
+    if (options_.gc_on_write == GargbageCollectOnWrite::kDisabled ||
+        (options_.gc_on_write == GargbageCollectOnWrite::kOneSector &&
+         gc_sector_count > 0u) ||
+        gc_sector_count > partition_.sector_count()) {
+      WRN("Unable to find space to write %u B batch", unsigned(write_size));
+      return Status::ResourceExhausted();
+    }
+
+    Status gc_status = GarbageCollect(std::span<const Address>());
+    if (gc_status.IsNotFound()) {
+      // Not enough space, and no reclaimable bytes, this KVS is full!
+      return Status::ResourceExhausted();
+    }
+    PW_TRY(gc_status);
+    gc_sector_count++;
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteBatchMarker(Key marker) {
+  EntryMetadata metadata;
+  Status status = FindEntry(marker, &metadata);
+
+  if (status.IsNotFound()) {
+    if (entry_cache_.full()) {
+      return Status::ResourceExhausted();
+    }
+    return WriteEntry(marker, {}, EntryState::kDeleted);
+  }
+  PW_TRY(status);
+
+  // Each marker must have a new transaction ID, so unlike Delete, always write
+  // the tombstone even though the key is already deleted.
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+  return WriteEntry(marker, {}, EntryState::kDeleted, &metadata, &entry);
+}
+
+uint32_t KeyValueStore::BatchMarkerTransactionId(Key marker) const {
+  EntryMetadata metadata;
+  if (!FindEntry(marker, &metadata).ok()) {
+    return 0;
+  }
+  return metadata.transaction_id();
+}
+
 void KeyValueStore::Item::ReadKey() {
   key_buffer_.fill('\0');
 
@@ -485,9 +1008,81 @@ KeyValueStore::iterator KeyValueStore::begin() const {
   return iterator(*this, cache_iterator);
 }
 
+KeyValueStore::PrefixRange KeyValueStore::WithPrefix(Key prefix) const {
+  std::span<const uint16_t> sorted_entries;
+  {
+    // The sorted index is only updated to add entries written since the last
+    // call. Writes exclude readers, so once this returns, the index does not
+    // change while the caller reads the KVS.
+    std::lock_guard lock(*read_state_lock_);
+    sorted_entries = entry_cache_.FindPrefix(partition_, formats_, prefix);
+  }
+
+  prefix_iterator first(*this, prefix, sorted_entries, 0);
+  first.SkipNonMatching();
+  const prefix_iterator last(
+      *this, prefix, sorted_entries, first.end_position());
+  return PrefixRange(first, last);
+}
+
+KeyValueStore::prefix_iterator::prefix_iterator(
+    const KeyValueStore& kvs,
+    Key prefix,
+    std::span<const uint16_t> sorted_entries,
+    size_t position)
+    : item_(kvs, kvs.entry_cache_.end()),
+      prefix_(prefix),
+      sorted_entries_(sorted_entries),
+      position_(position) {}
+
+KeyValueStore::prefix_iterator&
+KeyValueStore::prefix_iterator::operator++() {
+  position_ += 1;
+  SkipNonMatching();
+  return *this;
+}
+
+size_t KeyValueStore::prefix_iterator::end_position() const {
+  return item_.kvs_.entry_cache_.indexed()
+             ? sorted_entries_.size()
+             : item_.kvs_.entry_cache_.total_entries();
+}
+
+void KeyValueStore::prefix_iterator::SkipNonMatching() {
+  const internal::EntryCache& entry_cache = item_.kvs_.entry_cache_;
+  const bool indexed = entry_cache.indexed();
+
+  for (; position_ < end_position(); ++position_) {
+    item_.iterator_ =
+        entry_cache.at(indexed ? sorted_entries_[position_] : position_);
+    if (item_.iterator_->state() != EntryState::kValid) {
+      continue;
+    }
+
+    // The sorted index only contains matching keys. Without it, read the key
+    // to check it.
+    if (indexed) {
+      return;
+    }
+    item_.ReadKey();
+    if (std::strncmp(item_.key(), prefix_.data(), prefix_.size()) == 0) {
+      return;
+    }
+  }
+  item_.iterator_ = entry_cache.end();
+}
+
 StatusWithSize KeyValueStore::ValueSize(Key key) const {
   PW_TRY_WITH_SIZE(CheckReadOperation(key));
 
+  {
+    std::lock_guard lock(*read_state_lock_);
+    if (StatusWithSize cached = value_cache_.ValueSize(key);
+        !cached.IsNotFound()) {
+      return cached;
+    }
+  }
+
   EntryMetadata metadata;
   PW_TRY_WITH_SIZE(FindExisting(key, &metadata));
 
@@ -505,6 +1100,7 @@ Status KeyValueStore::ReadEntry(const EntryMetadata& metadata,
     }
 
     // Found a bad address. Set the sector as corrupt.
+    std::lock_guard lock(*read_state_lock_);
     error_detected_ = true;
     sectors_.FromAddress(address).mark_corrupt();
   }
@@ -514,10 +1110,11 @@ Status KeyValueStore::ReadEntry(const EntryMetadata& metadata,
 }
 
 Status KeyValueStore::FindEntry(Key key, EntryMetadata* metadata_out) const {
-  StatusWithSize find_result =
-      entry_cache_.Find(partition_, sectors_, formats_, key, metadata_out);
+  StatusWithSize find_result = entry_cache_.Find(
+      partition_, sectors_, formats_, key, metadata_out, *read_state_lock_);
 
   if (find_result.size() > 0u) {
+    std::lock_guard lock(*read_state_lock_);
     error_detected_ = true;
   }
   return find_result.status();
@@ -545,15 +1142,28 @@ StatusWithSize KeyValueStore::Get(Key key,
 
   StatusWithSize result = entry.ReadValue(value_buffer, offset_bytes);
   if (result.ok() && options_.verify_on_read && offset_bytes == 0u) {
+    // The checksum algorithm is shared by all readers, so hold the lock while
+    // verifying. The checksum covers the value as stored, so check a
+    // compressed value in flash rather than the decompressed value.
+    std::lock_guard lock(*read_state_lock_);
     Status verify_result =
-        entry.VerifyChecksum(key, value_buffer.first(result.size()));
+        entry.compressed()
+            ? entry.VerifyChecksumInFlash()
+            : entry.VerifyChecksum(key, value_buffer.first(result.size()));
     if (!verify_result.ok()) {
       std::memset(value_buffer.data(), 0, result.size());
       return StatusWithSize(verify_result, 0);
     }
 
+    value_cache_.Add(key, value_buffer.first(result.size()));
     return StatusWithSize(verify_result, result.size());
   }
+
+  // Only complete values are cached.
+  if (result.ok() && offset_bytes == 0u) {
+    std::lock_guard lock(*read_state_lock_);
+    value_cache_.Add(key, value_buffer.first(result.size()));
+  }
   return result;
 }
 
@@ -562,6 +1172,22 @@ Status KeyValueStore::FixedSizeGet(Key key,
                                    size_t size_bytes) const {
   PW_TRY(CheckWriteOperation(key));
 
+  {
+    std::lock_guard lock(*read_state_lock_);
+    if (StatusWithSize cached = value_cache_.ValueSize(key);
+        !cached.IsNotFound()) {
+      if (cached.size() != size_bytes) {
+        DBG("Requested %u B read, but value is %u B",
+            unsigned(size_bytes),
+            unsigned(cached.size()));
+        return Status::InvalidArgument();
+      }
+      return value_cache_
+          .Get(key, std::span(static_cast<byte*>(value), size_bytes), 0)
+          .status();
+    }
+  }
+
   EntryMetadata metadata;
   PW_TRY(FindExisting(key, &metadata));
 
@@ -593,7 +1219,7 @@ StatusWithSize KeyValueStore::ValueSize(const EntryMetadata& metadata) const {
   Entry entry;
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
-  return StatusWithSize(entry.value_size());
+  return entry.ReadValueSize();
 }
 
 Status KeyValueStore::CheckWriteOperation(Key key) const {
@@ -624,43 +1250,89 @@ Status KeyValueStore::CheckReadOperation(Key key) const {
 Status KeyValueStore::WriteEntryForExistingKey(EntryMetadata& metadata,
                                                EntryState new_state,
                                                Key key,
-                                               std::span<const byte> value) {
+                                               std::span<const byte> value,
+                                               bool compressed) {
   // Read the original entry to get the size for sector accounting purposes.
   Entry entry;
   PW_TRY(ReadEntry(metadata, entry));
 
-  return WriteEntry(key, value, new_state, &metadata, &entry);
+  // If new entry and prior entry have matching value size, state, and checksum,
+  // check if the values match. Directly compare the prior and new values
+  // because the checksum can not be depended on to establish equality, it can
+  // only be depended on to establish inequality.
+  if (entry.value_size() == value.size() && metadata.state() == new_state &&
+      entry.compressed() == compressed && entry.ValueMatches(value).ok()) {
+    // The new value matches the prior value, don't need to write anything. Just
+    // keep the existing entry.
+    DBG("Write for key 0x%08x with matching value skipped",
+        unsigned(metadata.hash()));
+    return OkStatus();
+  }
+
+  return WriteEntry(key, value, new_state, &metadata, &entry, compressed);
 }
 
 Status KeyValueStore::WriteEntryForNewKey(Key key,
-                                          std::span<const byte> value) {
+                                          std::span<const byte> value,
+                                          bool compressed) {
   if (entry_cache_.full()) {
     WRN("KVS full: trying to store a new entry, but can't. Have %u entries",
         unsigned(entry_cache_.total_entries()));
     return Status::ResourceExhausted();
   }
 
-  return WriteEntry(key, value, EntryState::kValid);
+  return WriteEntry(
+      key, value, EntryState::kValid, nullptr, nullptr, compressed);
+}
+
+Status KeyValueStore::WriteStreamEntry(Key key,
+                                       stream::Reader& reader,
+                                       size_t value_size,
+                                       EntryMetadata* prior_metadata,
+                                       size_t prior_size) {
+  value_cache_.Invalidate(key);
+
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(reserved_addresses,
+                              Entry::size(partition_, key, value_size)));
+
+  // Always bump the transaction ID when creating a new entry. See CreateEntry.
+  last_transaction_id_ += 1;
+  Entry entry = Entry::ValidForStream(partition_,
+                                      reserved_addresses[0],
+                                      formats_.primary(),
+                                      key,
+                                      value_size,
+                                      last_transaction_id_);
+
+  // If the stream failed before anything was written, the sector is intact.
+  const StatusWithSize result = entry.WriteStream(key, reader);
+  if (!result.ok() && result.size() == 0u) {
+    return result.status();
+  }
+  PW_TRY(FinishAppendEntry(entry, result));
+
+  EntryMetadata new_metadata =
+      CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
+
+  // The stream can only be read once, so the other copies are copied from the
+  // first one.
+  for (size_t i = 1; i < redundancy(); ++i) {
+    SectorDescriptor& sector = sectors_.FromAddress(reserved_addresses[i]);
+    PW_TRY(CopyEntryToSector(entry, &sector, reserved_addresses[i]).status());
+    new_metadata.AddNewAddress(reserved_addresses[i]);
+  }
+  return OkStatus();
 }
 
 Status KeyValueStore::WriteEntry(Key key,
                                  std::span<const byte> value,
                                  EntryState new_state,
                                  EntryMetadata* prior_metadata,
-                                 const Entry* prior_entry) {
-  // If new entry and prior entry have matching value size, state, and checksum,
-  // check if the values match. Directly compare the prior and new values
-  // because the checksum can not be depended on to establish equality, it can
-  // only be depended on to establish inequality.
-  if (prior_entry != nullptr && prior_entry->value_size() == value.size() &&
-      prior_metadata->state() == new_state &&
-      prior_entry->ValueMatches(value).ok()) {
-    // The new value matches the prior value, don't need to write anything. Just
-    // keep the existing entry.
-    DBG("Write for key 0x%08x with matching value skipped",
-        unsigned(prior_metadata->hash()));
-    return OkStatus();
-  }
+                                 const Entry* prior_entry,
+                                 bool compressed) {
+  // The key's cached value, if any, is out of date once a new entry is written.
+  value_cache_.Invalidate(key);
 
   // List of addresses for sectors with space for this entry.
   Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
@@ -670,13 +1342,22 @@ Status KeyValueStore::WriteEntry(Key key,
   const size_t entry_size = Entry::size(partition_, key, value);
   PW_TRY(GetAddressesForWrite(reserved_addresses, entry_size));
 
+  Entry entry =
+      CreateEntry(reserved_addresses[0], key, value, new_state, compressed);
+  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
+
+  // If each copy is in a different flash bank, write them all at once.
+  const std::span<const Address> addresses(reserved_addresses, redundancy());
+  if (CanWriteCopiesConcurrently(addresses)) {
+    return WriteEntryCopies(
+        entry, addresses, key, value, prior_metadata, prior_size);
+  }
+
   // Write the entry at the first address that was found.
-  Entry entry = CreateEntry(reserved_addresses[0], key, value, new_state);
   PW_TRY(AppendEntry(entry, key, value));
 
   // After writing the first entry successfully, update the key descriptors.
   // Once a single new the entry is written, the old entries are invalidated.
-  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
   EntryMetadata new_metadata =
       CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
 
@@ -689,6 +1370,57 @@ Status KeyValueStore::WriteEntry(Key key,
   return OkStatus();
 }
 
+bool KeyValueStore::CanWriteCopiesConcurrently(
+    std::span<const Address> addresses) const {
+  if (addresses.size() < 2 || addresses.size() > kMaxConcurrentWrites) {
+    return false;
+  }
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    for (size_t j = i + 1; j < addresses.size(); ++j) {
+      if (partition_.Bank(addresses[i]) == partition_.Bank(addresses[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Writes every copy of an entry concurrently. The key descriptor is updated
+// once any copy is written, since any written copy is found when the KVS is
+// initialized. Returns the first error if any copy fails.
+Status KeyValueStore::WriteEntryCopies(Entry& entry,
+                                       std::span<const Address> addresses,
+                                       Key key,
+                                       std::span<const byte> value,
+                                       EntryMetadata* prior_metadata,
+                                       size_t prior_size) {
+  std::array<StatusWithSize, kMaxConcurrentWrites> write_results;
+  const std::span results = std::span(write_results).first(addresses.size());
+  entry.WriteCopies(addresses, key, value, results).IgnoreError();
+
+  Status status;
+  bool descriptor_updated = false;
+  EntryMetadata new_metadata;
+
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    entry.set_address(addresses[i]);
+    const Status copy_status = FinishAppendEntry(entry, results[i]);
+    if (!copy_status.ok()) {
+      status.Update(copy_status);
+      continue;
+    }
+
+    if (descriptor_updated) {
+      new_metadata.AddNewAddress(addresses[i]);
+    } else {
+      new_metadata =
+          CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
+      descriptor_updated = true;
+    }
+  }
+  return status;
+}
+
 KeyValueStore::EntryMetadata KeyValueStore::CreateOrUpdateKeyDescriptor(
     const Entry& entry,
     Key key,
@@ -696,7 +1428,8 @@ KeyValueStore::EntryMetadata KeyValueStore::CreateOrUpdateKeyDescriptor(
     size_t prior_size) {
   // If there is no prior descriptor, create a new one.
   if (prior_metadata == nullptr) {
-    return entry_cache_.AddNew(entry.descriptor(key), entry.address());
+    return entry_cache_.AddNew(
+        entry.descriptor(entry_cache_.Hash(key)), entry.address(), key);
   }
 
   return UpdateKeyDescriptor(
@@ -745,7 +1478,11 @@ Status KeyValueStore::GetSectorForWrite(
   Status result = sectors_.FindSpace(sector, entry_size, reserved_addresses);
 
   size_t gc_sector_count = 0;
-  bool do_auto_gc = options_.gc_on_write != GargbageCollectOnWrite::kDisabled;
+
+  // Garbage collection is not done while a batch is written, since it could
+  // erase entries needed to roll back the batch.
+  bool do_auto_gc = options_.gc_on_write != GargbageCollectOnWrite::kDisabled &&
+                    !batch_in_progress_;
 
   // Do garbage collection as needed, so long as policy allows.
   while (result.IsResourceExhausted() && do_auto_gc) {
@@ -796,8 +1533,13 @@ Status KeyValueStore::MarkSectorCorruptIfNotOk(Status status,
 Status KeyValueStore::AppendEntry(const Entry& entry,
                                   Key key,
                                   std::span<const byte> value) {
-  const StatusWithSize result = entry.Write(key, value);
+  return FinishAppendEntry(entry, entry.Write(key, value));
+}
 
+// Updates the entry's sector after the entry was written, or marks the sector
+// corrupt if the write or verification failed.
+Status KeyValueStore::FinishAppendEntry(const Entry& entry,
+                                        StatusWithSize result) {
   SectorDescriptor& sector = sectors_.FromAddress(entry.address());
 
   if (!result.ok()) {
@@ -923,6 +1665,10 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
     overall_status = gc_status;
   }
 
+  if (overall_status.ok() && options_.checkpoint) {
+    overall_status = WriteCheckpoint();
+  }
+
   if (overall_status.ok()) {
     INF("Full maintenance complete");
   } else {
@@ -931,6 +1677,91 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
   return overall_status;
 }
 
+Status KeyValueStore::WriteCheckpoint() {
+  // The old checkpoint must be erased first, or Init could find it once the
+  // new one is erased.
+  if (checkpoint_sector_ != nullptr || incremental_gc_sector_ != nullptr ||
+      error_detected_) {
+    DBG("Not writing a checkpoint");
+    return OkStatus();
+  }
+
+  // Init only reads the first entry in each sector to find the checkpoint, so
+  // write it to an empty sector. Another empty sector must remain for GC.
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  SectorDescriptor* sector = nullptr;
+  size_t empty_sectors = 0;
+
+  for (SectorDescriptor& candidate : sectors_) {
+    if (candidate.Empty(sector_size_bytes)) {
+      empty_sectors += 1;
+      if (sector == nullptr) {
+        sector = &candidate;
+      }
+    }
+  }
+
+  const CheckpointHeader header =
+      MakeCheckpointHeader(entry_cache_.key_hash(),
+                           sectors_.size(),
+                           redundancy(),
+                           sector_size_bytes,
+                           entry_cache_.total_entries());
+  const auto descriptors = entry_cache_.descriptor_bytes();
+  const std::span<const byte> value[] = {
+      std::as_bytes(std::span(&header, 1)),
+      std::as_bytes(std::span(sectors_.begin(), sectors_.size())),
+      descriptors[0],
+      descriptors[1],
+      descriptors[2],
+      entry_cache_.address_bytes(),
+  };
+
+  size_t value_size = 0;
+  for (std::span<const byte> chunk : value) {
+    value_size += chunk.size();
+  }
+
+  if (empty_sectors < 2 ||
+      value_size >= std::numeric_limits<uint16_t>::max() ||
+      Entry::entry_overhead() + kCheckpointKey.size() + value_size >
+          sector_size_bytes) {
+    DBG("No room for a %u B checkpoint", unsigned(value_size));
+    return OkStatus();
+  }
+
+  const Entry entry =
+      Entry::ValidFromChunks(partition_,
+                             sectors_.BaseAddress(*sector),
+                             formats_.primary(),
+                             kCheckpointKey,
+                             value,
+                             last_transaction_id_);
+  if (entry.size() > sector_size_bytes) {
+    DBG("No room for a %u B checkpoint", unsigned(entry.size()));
+    return OkStatus();
+  }
+  const StatusWithSize result = entry.WriteChunks(kCheckpointKey, value);
+  if (!result.ok()) {
+    ERR("Failed to write %u byte checkpoint", unsigned(entry.size()));
+    PW_TRY(MarkSectorCorruptIfNotOk(result.status(), sector));
+  }
+
+  if (options_.verify_on_write) {
+    PW_TRY(MarkSectorCorruptIfNotOk(entry.VerifyChecksumInFlash(), sector));
+  }
+
+  sector->RemoveWritableBytes(result.size());
+  sector->AddValidBytes(result.size());
+  checkpoint_sector_ = sector;
+  checkpoint_size_bytes_ = result.size();
+
+  DBG("Wrote checkpoint of %u entries to sector %u",
+      unsigned(entry_cache_.total_entries()),
+      sectors_.Index(sector));
+  return OkStatus();
+}
+
 Status KeyValueStore::PartialMaintenance() {
   if (initialized_ == InitializationState::kNotInitialized) {
     return Status::FailedPrecondition();
@@ -944,6 +1775,115 @@ Status KeyValueStore::PartialMaintenance() {
   return GarbageCollect(std::span<const Address>());
 }
 
+Status KeyValueStore::IncrementalGarbageCollect(size_t max_relocations) {
+  if (!initialized()) {
+    return Status::FailedPrecondition();
+  }
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  // The sector may have been garbage collected by a write since the last call.
+  if (incremental_gc_sector_ != nullptr &&
+      incremental_gc_sector_->Empty(sector_size_bytes)) {
+    incremental_gc_sector_ = nullptr;
+  }
+
+  if (incremental_gc_sector_ == nullptr) {
+    incremental_gc_sector_ = FindSectorForIncrementalGarbageCollect();
+    if (incremental_gc_sector_ == nullptr) {
+      return Status::NotFound();
+    }
+
+    // Keep new entries out of the sector while it is collected. Its remaining
+    // writable bytes are reclaimed when it is erased.
+    DBG("Incremental GC of sector %u", sectors_.Index(incremental_gc_sector_));
+    incremental_gc_sector_->set_writable_bytes(0);
+
+    if (incremental_gc_sector_ == checkpoint_sector_) {
+      incremental_gc_sector_->RemoveValidBytes(checkpoint_size_bytes_);
+      checkpoint_size_bytes_ = 0;
+    }
+  }
+
+  SectorDescriptor& sector = *incremental_gc_sector_;
+
+  if (sector.valid_bytes() == 0) {
+    sector.mark_corrupt();
+    internal_stats_.sector_erase_count++;
+    PW_TRY(partition_.Erase(sectors_.BaseAddress(sector), 1));
+    sector.set_writable_bytes(sector_size_bytes);
+
+    DBG("Incremental GC of sector %u complete", sectors_.Index(sector));
+    incremental_gc_sector_ = nullptr;
+    if (&sector == checkpoint_sector_) {
+      checkpoint_sector_ = nullptr;
+    }
+    return OkStatus();
+  }
+
+  size_t relocations = 0;
+  for (EntryMetadata& metadata : entry_cache_) {
+    for (Address& address : metadata.addresses()) {
+      if (relocations == max_relocations) {
+        return OkStatus();
+      }
+      if (!sectors_.AddressInSector(sector, address)) {
+        continue;
+      }
+
+      Entry entry;
+      PW_TRY(ReadEntry(metadata, entry));
+
+      // Unlike a regular garbage collection, the relocated entry must not use
+      // the empty sector, since writes may happen before this sector is erased.
+      // If there is no other space, collect the rest of the sector at once.
+      SectorDescriptor* new_sector;
+      if (!sectors_.FindSpace(&new_sector, entry.size(), metadata.addresses())
+               .ok()) {
+        PW_TRY(GarbageCollectSector(sector, std::span<const Address>()));
+        incremental_gc_sector_ = nullptr;
+        return OkStatus();
+      }
+
+      Address new_address = sectors_.NextWritableAddress(*new_sector);
+      PW_TRY_ASSIGN(const size_t result_size,
+                    CopyEntryToSector(entry, new_sector, new_address));
+      sector.RemoveValidBytes(result_size);
+      address = new_address;
+      relocations += 1;
+    }
+  }
+
+  if (sector.valid_bytes() != 0) {
+    ERR("Failed to relocate valid entries from sector being garbage "
+        "collected, %u valid bytes remain",
+        unsigned(sector.valid_bytes()));
+    return Status::Internal();
+  }
+  return OkStatus();
+}
+
+KeyValueStore::SectorDescriptor*
+KeyValueStore::FindSectorForIncrementalGarbageCollect() {
+  SectorDescriptor* sector =
+      sectors_.FindSectorToGarbageCollect(std::span<const Address>());
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  if (sector == nullptr || sector->RecoverableBytes(sector_size_bytes) == 0u) {
+    return nullptr;
+  }
+
+  // Relocating valid entries costs flash writes, so only do it if the KVS is
+  // running low on space.
+  if (sector->valid_bytes() != 0u &&
+      GetStorageStats().writable_bytes >= sector_size_bytes) {
+    return nullptr;
+  }
+
+  // The checkpoint's sector must be erased before any other.
+  return checkpoint_sector_ != nullptr ? checkpoint_sector_ : sector;
+}
+
 Status KeyValueStore::GarbageCollect(
     std::span<const Address> reserved_addresses) {
   DBG("Garbage Collect a single sector");
@@ -951,9 +1891,19 @@ Status KeyValueStore::GarbageCollect(
     DBG("   Avoid address %u", unsigned(address));
   }
 
-  // Step 1: Find the sector to garbage collect
-  SectorDescriptor* sector_to_gc =
-      sectors_.FindSectorToGarbageCollect(reserved_addresses);
+  // Step 1: Find the sector to garbage collect. Finish an incremental garbage
+  // collection first, since that sector no longer accepts new entries.
+  SectorDescriptor* sector_to_gc = incremental_gc_sector_;
+  for (Address address : reserved_addresses) {
+    if (sector_to_gc != nullptr &&
+        sectors_.AddressInSector(*sector_to_gc, address)) {
+      sector_to_gc = nullptr;
+    }
+  }
+
+  if (sector_to_gc == nullptr) {
+    sector_to_gc = sectors_.FindSectorToGarbageCollect(reserved_addresses);
+  }
 
   if (sector_to_gc == nullptr) {
     // Nothing to GC.
@@ -961,7 +1911,11 @@ Status KeyValueStore::GarbageCollect(
   }
 
   // Step 2: Garbage collect the selected sector.
-  return GarbageCollectSector(*sector_to_gc, reserved_addresses);
+  PW_TRY(GarbageCollectSector(*sector_to_gc, reserved_addresses));
+  if (sector_to_gc == incremental_gc_sector_) {
+    incremental_gc_sector_ = nullptr;
+  }
+  return OkStatus();
 }
 
 Status KeyValueStore::RelocateKeyAddressesInSector(
@@ -983,8 +1937,23 @@ Status KeyValueStore::RelocateKeyAddressesInSector(
 Status KeyValueStore::GarbageCollectSector(
     SectorDescriptor& sector_to_gc,
     std::span<const Address> reserved_addresses) {
+  // Erasing any sector makes the checkpoint stale, so erase its sector first.
+  if (checkpoint_sector_ != nullptr && &sector_to_gc != checkpoint_sector_) {
+    for (Address address : reserved_addresses) {
+      if (sectors_.AddressInSector(*checkpoint_sector_, address)) {
+        return Status::ResourceExhausted();
+      }
+    }
+    PW_TRY(GarbageCollectSector(*checkpoint_sector_, reserved_addresses));
+  }
+
   DBG("  Garbage Collect sector %u", sectors_.Index(sector_to_gc));
 
+  if (&sector_to_gc == checkpoint_sector_) {
+    sector_to_gc.RemoveValidBytes(checkpoint_size_bytes_);
+    checkpoint_size_bytes_ = 0;
+  }
+
   // Step 1: Move any valid entries in the GC sector to other sectors
   if (sector_to_gc.valid_bytes() != 0) {
     for (EntryMetadata& metadata : entry_cache_) {
@@ -1007,6 +1976,9 @@ Status KeyValueStore::GarbageCollectSector(
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
     sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
   }
+  if (&sector_to_gc == checkpoint_sector_) {
+    checkpoint_sector_ = nullptr;
+  }
 
   DBG("  Garbage Collect sector %u complete", sectors_.Index(sector_to_gc));
   return OkStatus();
@@ -1116,6 +2088,27 @@ Status KeyValueStore::RepairCorruptSectors() {
   return repair_status;
 }
 
+// The entries from an interrupted batch were not loaded, so they are in sectors
+// with reclaimable bytes. Garbage collect those sectors, then write a commit
+// marker so the batch is not rolled back again.
+Status KeyValueStore::FinishBatchRollback() {
+  if (!batch_rollback_pending_) {
+    return OkStatus();
+  }
+
+  DBG("   Garbage collect sectors with entries from an interrupted batch");
+  for (SectorDescriptor& sector : sectors_) {
+    if (sector.RecoverableBytes(partition_.sector_size_bytes()) > 0) {
+      PW_TRY(GarbageCollectSector(sector, std::span<const Address>()));
+    }
+  }
+
+  PW_TRY(WriteBatchMarker(kBatchCommitKey));
+  batch_rollback_pending_ = false;
+  DBG("   Interrupted batch rolled back");
+  return OkStatus();
+}
+
 Status KeyValueStore::EnsureFreeSectorExists() {
   Status repair_status = OkStatus();
   bool empty_sector_found = false;
@@ -1180,16 +2173,22 @@ Status KeyValueStore::FixErrors() {
   // Step 1: Garbage collect any sectors marked as corrupt.
   Status overall_status = RepairCorruptSectors();
 
-  // Step 2: Make sure there is at least 1 empty sector. This needs to be a
-  // seperate check of sectors from step 1, because a found empty sector might
-  // get written to by a later GC that fails and does not result in a free
+  // Step 2: Remove the entries from an interrupted batch, if there was one.
+  Status repair_status = FinishBatchRollback();
+  if (overall_status.ok()) {
+    overall_status = repair_status;
+  }
+
+  // Step 3: Make sure there is at least 1 empty sector. This needs to be a
+  // seperate check of sectors from steps 1 and 2, because a found empty sector
+  // might get written to by a later GC that fails and does not result in a free
   // sector.
-  Status repair_status = EnsureFreeSectorExists();
+  repair_status = EnsureFreeSectorExists();
   if (overall_status.ok()) {
     overall_status = repair_status;
   }
 
-  // Step 3: Make sure each stored key has the full number of redundant
+  // Step 4: Make sure each stored key has the full number of redundant
   // entries.
   repair_status = EnsureEntryRedundancy();
   if (overall_status.ok()) {
@@ -1218,7 +2217,8 @@ Status KeyValueStore::Repair() {
 KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                                                 Key key,
                                                 std::span<const byte> value,
-                                                EntryState state) {
+                                                EntryState state,
+                                                bool compressed) {
   // Always bump the transaction ID when creating a new entry.
   //
   // Burning transaction IDs prevents inconsistencies between flash and memory
@@ -1242,7 +2242,8 @@ KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                       formats_.primary(),
                       key,
                       value,
-                      last_transaction_id_);
+                      last_transaction_id_,
+                      compressed);
 }
 
 void KeyValueStore::LogDebugInfo() const {
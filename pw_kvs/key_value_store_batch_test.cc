@@ -0,0 +1,326 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kMaxUsableSectors = 4;
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x5ab3c1d0, .checksum = &checksum};
+
+// A partition that simulates losing power: after a set number of writes and
+// erases, further writes and erases report success but do nothing.
+class PowerLossPartition : public FlashPartition {
+ public:
+  static constexpr size_t kNoLimit = size_t(-1);
+
+  PowerLossPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  using FlashPartition::Erase;
+
+  void CutPowerAfter(size_t operations) {
+    operations_left_ = operations;
+    power_lost_ = false;
+  }
+
+  void RestorePower() { operations_left_ = kNoLimit; }
+
+  bool power_lost() const { return power_lost_; }
+
+  Status Erase(Address address, size_t num_sectors) override {
+    if (!Operate()) {
+      return OkStatus();
+    }
+    return FlashPartition::Erase(address, num_sectors);
+  }
+
+  StatusWithSize Write(Address address,
+                       std::span<const byte> data) override {
+    if (!Operate()) {
+      return StatusWithSize(data.size());
+    }
+    return FlashPartition::Write(address, data);
+  }
+
+ private:
+  bool Operate() {
+    if (operations_left_ == 0u) {
+      power_lost_ = true;
+      return false;
+    }
+    if (operations_left_ != kNoLimit) {
+      operations_left_ -= 1;
+    }
+    return true;
+  }
+
+  size_t operations_left_ = kNoLimit;
+  bool power_lost_ = false;
+};
+
+class KvsBatch : public ::testing::Test {
+ protected:
+  KvsBatch()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, kFormat, {.verify_on_write = false}) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  // Returns the value of a key as a string, or an empty string if the key
+  // cannot be read.
+  static std::string_view Value(const KeyValueStore& kvs,
+                                Key key,
+                                std::span<char> buffer) {
+    StatusWithSize result = kvs.Get(key, std::as_writable_bytes(buffer));
+    if (!result.ok()) {
+      return {};
+    }
+    return std::string_view(buffer.data(), result.size());
+  }
+
+  std::string_view Value(Key key) { return Value(kvs_, key, buffer_); }
+
+  FakeFlashMemoryBuffer<512, kMaxUsableSectors> flash_;
+  PowerLossPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  KeyValueStore::BatchBuffer<4> batch_;
+  std::array<char, 32> buffer_;
+};
+
+TEST_F(KvsBatch, Commit_Empty) {
+  EXPECT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EXPECT_EQ(0u, kvs_.transaction_count());
+}
+
+TEST_F(KvsBatch, Commit_PutsAndDeletes) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a", std::string_view("old a")));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b", std::string_view("old b")));
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Delete("b"));
+  ASSERT_EQ(OkStatus(), batch_.Put("c", std::string_view("new c")));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ("new a", Value("a"));
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("b").status());
+  EXPECT_EQ("new c", Value("c"));
+
+  // The batch markers are not visible.
+  EXPECT_EQ(2u, kvs_.size());
+  size_t keys = 0;
+  for (const auto& item : kvs_) {
+    EXPECT_TRUE(item.key() == std::string_view("a") ||
+                item.key() == std::string_view("c"));
+    keys += 1;
+  }
+  EXPECT_EQ(2u, keys);
+}
+
+TEST_F(KvsBatch, Commit_ValuesPersistAcrossInit) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(0xfeedbeef)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(&partition_,
+                                                               kFormat);
+  ASSERT_EQ(OkStatus(), rebooted.Init());
+  EXPECT_EQ(2u, rebooted.size());
+  EXPECT_EQ("new a", Value(rebooted, "a", buffer_));
+
+  uint32_t value = 0;
+  EXPECT_EQ(OkStatus(), rebooted.Get("b", &value));
+  EXPECT_EQ(0xfeedbeef, value);
+}
+
+TEST_F(KvsBatch, Commit_RepeatedKeyLastOperationWins) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("first")));
+  ASSERT_EQ(OkStatus(), batch_.Delete("a"));
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("last")));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ("last", Value("a"));
+}
+
+TEST_F(KvsBatch, Commit_MultipleBatches) {
+  for (char i = '0'; i < '5'; ++i) {
+    const char value[] = {'v', i};
+    batch_.clear();
+    ASSERT_EQ(OkStatus(), batch_.Put("a", value));
+    ASSERT_EQ(OkStatus(), batch_.Put("b", value));
+    ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+  }
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(&partition_,
+                                                               kFormat);
+  ASSERT_EQ(OkStatus(), rebooted.Init());
+  EXPECT_EQ("v4", Value(rebooted, "a", buffer_));
+  EXPECT_EQ("v4", Value(rebooted, "b", buffer_));
+}
+
+TEST_F(KvsBatch, Add_Full) {
+  for (size_t i = 0; i < batch_.max_size(); ++i) {
+    ASSERT_EQ(OkStatus(), batch_.Delete("a"));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), batch_.Delete("a"));
+  EXPECT_EQ(batch_.max_size(), batch_.size());
+
+  batch_.clear();
+  EXPECT_TRUE(batch_.empty());
+}
+
+TEST_F(KvsBatch, Commit_DeleteMissingKey_NothingWritten) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Delete("b"));
+
+  const uint32_t transactions = kvs_.transaction_count();
+  EXPECT_EQ(Status::NotFound(), kvs_.Commit(batch_));
+  EXPECT_EQ(transactions, kvs_.transaction_count());
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("a").status());
+}
+
+TEST_F(KvsBatch, Commit_InvalidKey_NothingWritten) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Put("", std::string_view("empty key")));
+
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Commit(batch_));
+  EXPECT_EQ(0u, kvs_.transaction_count());
+}
+
+TEST_F(KvsBatch, Commit_TooManyNewKeys_NothingWritten) {
+  // The batch markers take two entries.
+  for (size_t i = 0; i < kMaxEntries - 3; ++i) {
+    const char key[] = {'k', char('A' + i)};
+    ASSERT_EQ(OkStatus(), kvs_.Put(Key(key, 2), i));
+  }
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", std::string_view("new b")));
+
+  const uint32_t transactions = kvs_.transaction_count();
+  EXPECT_EQ(Status::ResourceExhausted(), kvs_.Commit(batch_));
+  EXPECT_EQ(transactions, kvs_.transaction_count());
+
+  batch_.clear();
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  EXPECT_EQ(OkStatus(), kvs_.Commit(batch_));
+}
+
+TEST_F(KvsBatch, MarkerKeysAreReserved) {
+  constexpr char kMarker[] = "\0pw_kvs.batch_start";
+  const Key marker(kMarker, sizeof(kMarker) - 1);
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Put(marker, 1));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Delete(marker));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.ValueSize(marker).status());
+}
+
+TEST_F(KvsBatch, Commit_WriteError_RollsBack) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a", std::string_view("old a")));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b", std::string_view("old b")));
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+  ASSERT_EQ(OkStatus(), batch_.Delete("b"));
+  ASSERT_EQ(OkStatus(), batch_.Put("c", std::string_view("new c")));
+
+  // Fail a write partway through the batch.
+  flash_.InjectWriteError(
+      FlashError::Unconditional(Status::Unavailable(), 1, 2));
+  EXPECT_EQ(Status::Unavailable(), kvs_.Commit(batch_));
+
+  EXPECT_TRUE(kvs_.initialized());
+  EXPECT_EQ("old a", Value("a"));
+  EXPECT_EQ("old b", Value("b"));
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("c").status());
+
+  // The rollback is in flash, so later writes are not rolled back on Init.
+  ASSERT_EQ(OkStatus(), kvs_.Put("d", std::string_view("new d")));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(&partition_,
+                                                               kFormat);
+  ASSERT_EQ(OkStatus(), rebooted.Init());
+  EXPECT_EQ("old a", Value(rebooted, "a", buffer_));
+  EXPECT_EQ("old b", Value(rebooted, "b", buffer_));
+  EXPECT_EQ(Status::NotFound(), rebooted.ValueSize("c").status());
+  EXPECT_EQ("new d", Value(rebooted, "d", buffer_));
+}
+
+TEST_F(KvsBatch, Init_PowerLossDuringCommit_AllOrNothing) {
+  for (size_t operations = 0; true; ++operations) {
+    partition_.RestorePower();
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+
+    ASSERT_EQ(OkStatus(), kvs_.Put("a", std::string_view("old a")));
+    ASSERT_EQ(OkStatus(), kvs_.Put("b", std::string_view("old b")));
+
+    batch_.clear();
+    ASSERT_EQ(OkStatus(), batch_.Put("a", std::string_view("new a")));
+    ASSERT_EQ(OkStatus(), batch_.Delete("b"));
+    ASSERT_EQ(OkStatus(), batch_.Put("c", std::string_view("new c")));
+
+    partition_.CutPowerAfter(operations);
+    kvs_.Commit(batch_).IgnoreError();  // Results after power loss are moot.
+    const bool power_lost = partition_.power_lost();
+    partition_.RestorePower();
+
+    // Reboot twice, with a write in between, to check that a rollback is
+    // permanent.
+    for (int reboot = 0; reboot < 2; ++reboot) {
+      KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(&partition_,
+                                                                   kFormat);
+      ASSERT_EQ(OkStatus(), rebooted.Init());
+
+      if (Value(rebooted, "a", buffer_) == "new a") {
+        EXPECT_EQ(Status::NotFound(), rebooted.ValueSize("b").status());
+        EXPECT_EQ("new c", Value(rebooted, "c", buffer_));
+      } else {
+        EXPECT_TRUE(power_lost);
+        EXPECT_EQ("old a", Value(rebooted, "a", buffer_));
+        EXPECT_EQ("old b", Value(rebooted, "b", buffer_));
+        EXPECT_EQ(Status::NotFound(), rebooted.ValueSize("c").status());
+      }
+      ASSERT_EQ(OkStatus(), rebooted.Put("d", reboot));
+    }
+
+    if (!power_lost) {
+      break;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -1121,5 +1121,56 @@ TEST_F(InitializedLazyRecoveryKvs, AddRedundancyToKvsFullOfStaleData) {
   EXPECT_EQ(stats.missing_redundant_entries_recovered, 0u);
 }
 
+// "6F" and "PfB20" collide under KeyHash::kWordAtATime, but not under the
+// legacy hash that every KVS written before KeyHash was added uses.
+static_assert(internal::WordHash("6F") == internal::WordHash("PfB20"));
+static_assert(internal::LegacyHash("6F") != internal::LegacyHash("PfB20"));
+
+class LegacyHashKvs : public ::testing::Test {
+ protected:
+  static constexpr auto kInitialContents = bytes::Concat(
+      kEntry1,
+      kEntry2,
+      MakeValidEntry(kMagic, 6, "6F", bytes::String("value5")),
+      MakeValidEntry(kMagic, 7, "PfB20", bytes::String("value6")));
+
+  LegacyHashKvs()
+      : flash_(internal::Entry::kMinAlignmentBytes), partition_(&flash_) {
+    partition_.Erase()
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    std::memcpy(flash_.buffer().data(),
+                kInitialContents.data(),
+                kInitialContents.size());
+  }
+
+  FakeFlashMemoryBuffer<512, 4> flash_;
+  FlashPartition partition_;
+};
+
+TEST_F(LegacyHashKvs, Init_DefaultOptions_ReadsEveryKey) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &partition_, default_format, kNoGcOptions);
+  static_assert(kNoGcOptions.key_hash == KeyHash::kLegacy);
+
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_FALSE(kvs.error_detected());
+  EXPECT_EQ(4u, kvs.size());
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "key1", "value1");
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "k2", "value2");
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "6F", "value5");
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "PfB20", "value6");
+}
+
+TEST_F(LegacyHashKvs, Init_DefaultOptions_KeysCanBeUpdated) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &partition_, default_format, kNoGcOptions);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  constexpr auto kNewValue = bytes::String("new");
+  ASSERT_EQ(OkStatus(), kvs.Put("6F", std::span(kNewValue)));
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "6F", "new");
+  ASSERT_KVS_CONTAINS_ENTRY(kvs, "PfB20", "value6");
+}
+
 }  // namespace
 }  // namespace pw::kvs
@@ -0,0 +1,217 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kMaxUsableSectors = 4;
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x1c3e7ca2, .checksum = &checksum};
+
+constexpr const char* kKeys[] = {
+    "key0", "key1", "key2", "key3", "key4", "key5", "key6", "key7",
+    "key8", "key9", "keyA", "keyB", "keyC", "keyD", "keyE", "keyF",
+};
+
+// A partition that counts the bytes read from it.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  StatusWithSize Read(Address address, std::span<byte> output) override {
+    bytes_read_ += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  using FlashPartition::Read;
+
+  size_t bytes_read() const { return bytes_read_; }
+  void reset_bytes_read() { bytes_read_ = 0; }
+
+ private:
+  size_t bytes_read_ = 0;
+};
+
+using Kvs = KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors>;
+
+class KvsCheckpoint : public ::testing::Test {
+ protected:
+  KvsCheckpoint()
+      : flash_(16), partition_(&flash_), kvs_(&partition_, kFormat, kOptions) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  // Puts every key with a value that starts with the provided character.
+  void PutAll(char value) {
+    for (const char* key : kKeys) {
+      std::array<char, 48> data;
+      data.fill(value);
+      ASSERT_EQ(OkStatus(), kvs_.Put(key, data));
+    }
+  }
+
+  // Returns the first character of a key's value, or '\0' if the key cannot be
+  // read.
+  static char Value(KeyValueStore& kvs, const char* key) {
+    std::array<char, 48> data{};
+    if (!kvs.Get(key, &data).ok()) {
+      return '\0';
+    }
+    return data[0];
+  }
+
+  // Initializes a new KVS from the flash and returns the bytes Init read.
+  size_t BytesReadByInit(Kvs& kvs) {
+    partition_.reset_bytes_read();
+    EXPECT_EQ(OkStatus(), kvs.Init());
+    return partition_.bytes_read();
+  }
+
+  static constexpr Options kOptions = {.checkpoint = true};
+
+  FakeFlashMemoryBuffer<1024, kMaxUsableSectors> flash_;
+  ReadCountingPartition partition_;
+  Kvs kvs_;
+};
+
+TEST_F(KvsCheckpoint, Init_WithCheckpoint_ReadsLessFlash) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  Kvs with_checkpoint(&partition_, kFormat, kOptions);
+  Kvs without_checkpoint(&partition_, kFormat);
+
+  const size_t checkpoint_bytes = BytesReadByInit(with_checkpoint);
+  EXPECT_LT(checkpoint_bytes, BytesReadByInit(without_checkpoint));
+
+  EXPECT_EQ(std::size(kKeys), with_checkpoint.size());
+  for (const char* key : kKeys) {
+    EXPECT_EQ('a', Value(with_checkpoint, key));
+  }
+}
+
+TEST_F(KvsCheckpoint, Init_ReadsEntriesWrittenAfterCheckpoint) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put("new", std::array<char, 48>{'n'}));
+  ASSERT_EQ(OkStatus(), kvs_.Put("key1", std::array<char, 48>{'b'}));
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key2"));
+
+  Kvs kvs(&partition_, kFormat, kOptions);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  EXPECT_EQ(std::size(kKeys), kvs.size());
+  EXPECT_EQ('n', Value(kvs, "new"));
+  EXPECT_EQ('a', Value(kvs, "key0"));
+  EXPECT_EQ('b', Value(kvs, "key1"));
+  EXPECT_EQ(Status::NotFound(), kvs.Get("key2", std::span<byte>()).status());
+}
+
+TEST_F(KvsCheckpoint, GarbageCollection_InvalidatesCheckpoint) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Overwrite the keys until sectors are garbage collected.
+  for (char value = 'b'; value < 'f'; ++value) {
+    PutAll(value);
+  }
+  ASSERT_GT(kvs_.GetStorageStats().sector_erase_count, 0u);
+
+  Kvs kvs(&partition_, kFormat, kOptions);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  EXPECT_EQ(std::size(kKeys), kvs.size());
+  for (const char* key : kKeys) {
+    EXPECT_EQ('e', Value(kvs, key));
+  }
+}
+
+TEST_F(KvsCheckpoint, HeavyMaintenance_ReplacesCheckpoint) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  PutAll('b');
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+
+  Kvs with_checkpoint(&partition_, kFormat, kOptions);
+  Kvs without_checkpoint(&partition_, kFormat);
+
+  EXPECT_LT(BytesReadByInit(with_checkpoint),
+            BytesReadByInit(without_checkpoint));
+  for (const char* key : kKeys) {
+    EXPECT_EQ('b', Value(with_checkpoint, key));
+  }
+}
+
+TEST_F(KvsCheckpoint, WithoutOption_CheckpointIsIgnored) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put("key0", std::array<char, 48>{'b'}));
+
+  EXPECT_EQ(std::size(kKeys), kvs.size());
+  EXPECT_EQ('b', Value(kvs, "key0"));
+  EXPECT_EQ('a', Value(kvs, "key1"));
+}
+
+TEST_F(KvsCheckpoint, DifferentKeyHash_CheckpointIsIgnored) {
+  PutAll('a');
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  Kvs with_checkpoint(
+      &partition_,
+      kFormat,
+      {.checkpoint = true, .key_hash = KeyHash::kWordAtATime});
+  Kvs without_checkpoint(
+      &partition_, kFormat, {.key_hash = KeyHash::kWordAtATime});
+
+  // The checkpoint holds legacy key hashes, so Init scans every entry instead.
+  EXPECT_GE(BytesReadByInit(with_checkpoint),
+            BytesReadByInit(without_checkpoint));
+
+  EXPECT_EQ(std::size(kKeys), with_checkpoint.size());
+  for (const char* key : kKeys) {
+    EXPECT_EQ('a', Value(with_checkpoint, key));
+  }
+}
+
+TEST_F(KvsCheckpoint, Put_CheckpointKey_IsInvalid) {
+  constexpr char kCheckpointKey[] = "\0pw_kvs.checkpoint";
+  EXPECT_EQ(Status::InvalidArgument(),
+            kvs_.Put(Key(kCheckpointKey, sizeof(kCheckpointKey) - 1), 1));
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -54,6 +54,8 @@ struct TestParameters {
   size_t partition_start_sector;
   size_t partition_sector_count;
   size_t partition_alignment;
+  bool indexed = false;
+  bool checkpoint = false;
 };
 
 enum Options {
@@ -61,6 +63,7 @@ enum Options {
   kReinit,
   kReinitWithFullGC,
   kReinitWithPartialGC,
+  kReinitWithIncrementalGC,
 };
 
 template <typename T>
@@ -85,7 +88,9 @@ class KvsTester {
                    kParams.partition_alignment),
         // For KVS magic value always use a random 32 bit integer rather than a
         // human readable 4 bytes. See pw_kvs/format.h for more information.
-        kvs_(&partition_, {.magic = 0xc857e51d, .checksum = nullptr}) {
+        kvs_(&partition_,
+             {.magic = 0xc857e51d, .checksum = nullptr},
+             {.checkpoint = kParams.checkpoint}) {
     EXPECT_EQ(OkStatus(), partition_.Erase());
     Status result = kvs_.Init();
     EXPECT_EQ(OkStatus(), result);
@@ -149,6 +154,8 @@ class KvsTester {
         GCFull();
       } else if (options == kReinitWithPartialGC && random_int() % 40 == 0) {
         GCPartial();
+      } else if (options == kReinitWithIncrementalGC && random_int() % 4 == 0) {
+        GCIncremental();
       }
     }
 
@@ -162,6 +169,7 @@ class KvsTester {
       label << ((options != kNone) ? "Reinit" : "");
       label << ((options == kReinitWithFullGC) ? "FullGC" : "");
       label << ((options == kReinitWithPartialGC) ? "PartialGC" : "");
+      label << ((options == kReinitWithIncrementalGC) ? "IncrementalGC" : "");
       label << ((kvs_.redundancy() > 1) ? "Redundant" : "");
 
       partition_.SaveStorageStats(kvs_, label.data())
@@ -346,6 +354,13 @@ class KvsTester {
     FinishOperation("GCPartial", status);
   }
 
+  void GCIncremental() {
+    StartOperation("GCIncremental");
+    Status status = kvs_.IncrementalGarbageCollect(1);
+    EXPECT_TRUE(status.ok() || status.IsNotFound());
+    FinishOperation("GCIncremental", status);
+  }
+
   // Logs that an operation started and checks that the KVS matches the map. If
   // a key is provided, that is included in the logs.
   void StartOperation(const std::string& operation,
@@ -400,7 +415,12 @@ class KvsTester {
 
   FlashPartitionWithStatsBuffer<kMaxEntries> partition_;
 
-  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, kParams.redundancy> kvs_;
+  KeyValueStoreBuffer<kMaxEntries,
+                      kMaxUsableSectors,
+                      kParams.redundancy,
+                      1,
+                      kParams.indexed>
+      kvs_;
   std::unordered_map<std::string, std::string> map_;
   std::unordered_set<std::string> deleted_;
   unsigned count_ = 0;
@@ -456,6 +476,18 @@ FakeFlashMemoryBuffer<kParams.sector_size,
                 200,                                                          \
                 123,                                                          \
                 kReinitWithPartialGC);                                        \
+  _TEST_VARIANT(name,                                                         \
+                RandomValidInputs,                                            \
+                1ReinitIncrementalGC,                                         \
+                300,                                                          \
+                6006411,                                                      \
+                kReinitWithIncrementalGC);                                    \
+  _TEST_VARIANT(name,                                                         \
+                RandomValidInputs,                                            \
+                2ReinitIncrementalGC,                                         \
+                300,                                                          \
+                123,                                                          \
+                kReinitWithIncrementalGC);                                    \
   static_assert(true, "Don't forget a semicolon!")
 
 RUN_TESTS_WITH_PARAMETERS(Basic,
@@ -476,6 +508,36 @@ RUN_TESTS_WITH_PARAMETERS(BasicRedundant,
                           .partition_sector_count = 4,
                           .partition_alignment = 16);
 
+RUN_TESTS_WITH_PARAMETERS(BasicIndexed,
+                          .sector_size = 4 * 1024,
+                          .sector_count = 4,
+                          .sector_alignment = 16,
+                          .redundancy = 1,
+                          .partition_start_sector = 0,
+                          .partition_sector_count = 4,
+                          .partition_alignment = 16,
+                          .indexed = true);
+
+RUN_TESTS_WITH_PARAMETERS(BasicCheckpoint,
+                          .sector_size = 4 * 1024,
+                          .sector_count = 4,
+                          .sector_alignment = 16,
+                          .redundancy = 1,
+                          .partition_start_sector = 0,
+                          .partition_sector_count = 4,
+                          .partition_alignment = 16,
+                          .checkpoint = true);
+
+RUN_TESTS_WITH_PARAMETERS(BasicRedundantCheckpoint,
+                          .sector_size = 4 * 1024,
+                          .sector_count = 4,
+                          .sector_alignment = 16,
+                          .redundancy = 2,
+                          .partition_start_sector = 0,
+                          .partition_sector_count = 4,
+                          .partition_alignment = 16,
+                          .checkpoint = true);
+
 RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectors,
                           .sector_size = 160,
                           .sector_count = 100,
@@ -494,6 +556,16 @@ RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectorsRedundant,
                           .partition_sector_count = 95,
                           .partition_alignment = 32);
 
+RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectorsRedundantIndexed,
+                          .sector_size = 160,
+                          .sector_count = 100,
+                          .sector_alignment = 32,
+                          .redundancy = 2,
+                          .partition_start_sector = 5,
+                          .partition_sector_count = 95,
+                          .partition_alignment = 32,
+                          .indexed = true);
+
 RUN_TESTS_WITH_PARAMETERS(OnlyTwoSectors,
                           .sector_size = 4 * 1024,
                           .sector_count = 20,
@@ -17,14 +17,13 @@
 
 #include "pw_kvs/key_value_store.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstring>
 #include <span>
-
-#if DUMP_KVS_STATE_TO_FILE
+#include <string>
 #include <vector>
-#endif  // DUMP_KVS_STATE_TO_FILE
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
@@ -36,6 +35,7 @@
 #include "pw_log/log.h"
 #include "pw_log/shorter.h"
 #include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_string/string_builder.h"
 
 namespace pw::kvs {
@@ -412,6 +412,76 @@ TEST_F(LargeEmptyInitializedKvs, FullMaintenance) {
   EXPECT_EQ(stats.reclaimable_bytes, 0u);
 }
 
+TEST_F(LargeEmptyInitializedKvs, IncrementalGarbageCollect_NothingToCollect) {
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalGarbageCollect());
+
+  // A sector with stale data is not collected while it has valid data and
+  // there is plenty of space.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(2)));
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalGarbageCollect());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().sector_erase_count);
+}
+
+TEST_F(LargeEmptyInitializedKvs, IncrementalGarbageCollect_StaleSector) {
+  std::array<std::byte, 400> value{};
+
+  // Two entries fit in a sector, so the third moves to a new sector and leaves
+  // only stale data in the first.
+  for (int i = 0; i < 3; ++i) {
+    value[0] = std::byte(i);
+    ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], value));
+  }
+
+  EXPECT_EQ(OkStatus(), kvs_.IncrementalGarbageCollect());
+  KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  EXPECT_EQ(1u, stats.sector_erase_count);
+  EXPECT_EQ(0u, stats.reclaimable_bytes);
+
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalGarbageCollect());
+}
+
+TEST(InMemoryKvs, IncrementalGarbageCollect_RelocatesInSteps) {
+  FlashWithPartitionFake<1024, 4> flash;
+  ASSERT_EQ(OkStatus(), flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+
+  // Each entry is 128 B, so eight fit in a sector. Overwriting six keys leaves
+  // two valid entries in the first sector and 256 B free in the third.
+  constexpr const char* kKeys[] = {"k0", "k1", "k2", "k3", "k4", "k5", "k6",
+                                   "k7", "k8", "k9", "kA", "kB", "kC", "kD",
+                                   "kE", "kF"};
+  std::array<char, 100> value{};
+  for (const char* key : kKeys) {
+    ASSERT_OK(kvs.Put(key, value));
+  }
+  for (size_t i = 0; i < 6; ++i) {
+    value[0] += 1;
+    ASSERT_OK(kvs.Put(kKeys[i], value));
+  }
+  ASSERT_LT(kvs.GetStorageStats().writable_bytes, 1024u);
+
+  // Each step relocates one valid entry; the sector is erased once it is empty.
+  EXPECT_OK(kvs.IncrementalGarbageCollect(1));
+  EXPECT_OK(kvs.IncrementalGarbageCollect(1));
+  EXPECT_EQ(0u, kvs.GetStorageStats().sector_erase_count);
+  EXPECT_OK(kvs.IncrementalGarbageCollect(1));
+  EXPECT_EQ(1u, kvs.GetStorageStats().sector_erase_count);
+  EXPECT_EQ(Status::NotFound(), kvs.IncrementalGarbageCollect(1));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reinit(&flash.partition,
+                                                             default_format);
+  ASSERT_OK(reinit.Init());
+  EXPECT_EQ(16u, reinit.size());
+  for (const char* key : kKeys) {
+    std::array<char, 100> read{};
+    EXPECT_OK(reinit.Get(key, &read));
+  }
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
@@ -443,4 +513,474 @@ TEST(InMemoryKvs, Put_MaxValueSize) {
   EXPECT_EQ(Status::InvalidArgument(), kvs.Put("K", big_data));
 }
 
+constexpr const char* kScanKeys[] = {"sensor/cal/gain",
+                                     "net/ip",
+                                     "sensor/cal/offset",
+                                     "sensor/rate",
+                                     "sensor/cal/bias",
+                                     "sensorX"};
+
+template <bool kIndexed>
+class PrefixScan : public ::testing::Test {
+ protected:
+  PrefixScan() : kvs_(&flash_.partition, default_format) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), flash_.partition.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+    for (const char* key : kScanKeys) {
+      ASSERT_EQ(OkStatus(), kvs_.Put(key, uint32_t(1)));
+    }
+  }
+
+  std::vector<std::string> Scan(const char* prefix) {
+    std::vector<std::string> found;
+    for (auto& item : kvs_.WithPrefix(prefix)) {
+      found.push_back(item.key());
+    }
+    return found;
+  }
+
+  FlashWithPartitionFake<512, 4> flash_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 1, 1, kIndexed> kvs_;
+};
+
+using IndexedPrefixScan = PrefixScan<true>;
+using UnindexedPrefixScan = PrefixScan<false>;
+
+TEST_F(IndexedPrefixScan, WithPrefix_ReturnsMatchesInOrder) {
+  EXPECT_EQ(Scan("sensor/cal/"),
+            (std::vector<std::string>{
+                "sensor/cal/bias", "sensor/cal/gain", "sensor/cal/offset"}));
+  EXPECT_EQ(Scan("sensor"),
+            (std::vector<std::string>{"sensor/cal/bias",
+                                      "sensor/cal/gain",
+                                      "sensor/cal/offset",
+                                      "sensor/rate",
+                                      "sensorX"}));
+  EXPECT_EQ(Scan("net/ip"), std::vector<std::string>{"net/ip"});
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_EmptyPrefix_IteratesInSortedOrder) {
+  std::vector<std::string> sorted(std::begin(kScanKeys), std::end(kScanKeys));
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(Scan(""), sorted);
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_NoMatches) {
+  EXPECT_TRUE(Scan("zzz").empty());
+  EXPECT_TRUE(Scan("sensor/cal/gain/").empty());
+  EXPECT_TRUE(Scan("a").empty());
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_SkipsDeletedKeys) {
+  ASSERT_EQ(OkStatus(), kvs_.Delete("sensor/cal/gain"));
+  EXPECT_EQ(Scan("sensor/cal/"),
+            (std::vector<std::string>{"sensor/cal/bias", "sensor/cal/offset"}));
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_IncludesNewKeys) {
+  EXPECT_EQ(3u, Scan("sensor/cal/").size());
+  ASSERT_EQ(OkStatus(), kvs_.Put("sensor/cal/a", uint32_t(2)));
+  EXPECT_EQ(Scan("sensor/cal/"),
+            (std::vector<std::string>{"sensor/cal/a",
+                                      "sensor/cal/bias",
+                                      "sensor/cal/gain",
+                                      "sensor/cal/offset"}));
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_AfterInit) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 1, 1, true> reinit(
+      &flash_.partition, default_format);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+
+  std::vector<std::string> found;
+  for (auto& item : reinit.WithPrefix("sensor/cal/")) {
+    found.push_back(item.key());
+  }
+  EXPECT_EQ(found,
+            (std::vector<std::string>{
+                "sensor/cal/bias", "sensor/cal/gain", "sensor/cal/offset"}));
+}
+
+TEST_F(IndexedPrefixScan, WithPrefix_ShortPrefix_DoesNotReadFlash) {
+  EXPECT_EQ(6u, Scan("").size());  // Sorts the keys.
+
+  flash_.memory.InjectReadError(FlashError::Unconditional(Status::Internal()));
+  size_t matches = 0;
+  const auto range = kvs_.WithPrefix("sensor/");
+  for (auto it = range.begin(); it != range.end(); ++it) {
+    matches += 1;
+  }
+  EXPECT_EQ(4u, matches);
+}
+
+TEST_F(UnindexedPrefixScan, WithPrefix_ReturnsMatches) {
+  std::vector<std::string> found = Scan("sensor/cal/");
+  std::sort(found.begin(), found.end());
+  EXPECT_EQ(found,
+            (std::vector<std::string>{
+                "sensor/cal/bias", "sensor/cal/gain", "sensor/cal/offset"}));
+  EXPECT_EQ(6u, Scan("").size());
+  EXPECT_TRUE(Scan("zzz").empty());
+}
+
+// Flash with two banks, alternating by sector, that supports asynchronous
+// writes. Started writes are applied when they are finished.
+class DualBankFlash : public FakeFlashMemoryBuffer<512, 4> {
+ public:
+  DualBankFlash() : FakeFlashMemoryBuffer(16) {}
+
+  size_t Bank(Address address) const override {
+    return (address / sector_size_bytes()) % 2;
+  }
+
+  Status StartWrite(Address address, std::span<const std::byte> data) override {
+    PendingWrite& pending = pending_[Bank(address)];
+    if (pending.in_progress) {
+      return Status::FailedPrecondition();
+    }
+    pending = {.in_progress = true, .address = address, .data = data};
+    writes_in_progress_ += 1;
+    max_writes_in_progress_ =
+        std::max(max_writes_in_progress_, writes_in_progress_);
+    return OkStatus();
+  }
+
+  StatusWithSize FinishWrite(Address address) override {
+    PendingWrite& pending = pending_[Bank(address)];
+    if (!pending.in_progress || pending.address != address) {
+      return StatusWithSize::FailedPrecondition();
+    }
+    pending.in_progress = false;
+    writes_in_progress_ -= 1;
+    return Write(pending.address, pending.data);
+  }
+
+  size_t max_writes_in_progress() const { return max_writes_in_progress_; }
+
+ private:
+  struct PendingWrite {
+    bool in_progress = false;
+    Address address = 0;
+    std::span<const std::byte> data;
+  };
+
+  std::array<PendingWrite, 2> pending_;
+  size_t writes_in_progress_ = 0;
+  size_t max_writes_in_progress_ = 0;
+};
+
+class DualBankKvs : public ::testing::Test {
+ protected:
+  DualBankKvs() : partition_(&flash_), kvs_(&partition_, default_format) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  DualBankFlash flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> kvs_;
+};
+
+TEST_F(DualBankKvs, Put_WritesCopiesConcurrently) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", std::array<char, 100>{'v'}));
+  EXPECT_EQ(2u, flash_.max_writes_in_progress());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> reinit(
+      &partition_, default_format);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+  EXPECT_EQ(kvs_.GetStorageStats().in_use_bytes,
+            reinit.GetStorageStats().in_use_bytes);
+
+  std::array<char, 100> value{};
+  ASSERT_EQ(OkStatus(), reinit.Get("key", &value));
+  EXPECT_EQ('v', value[0]);
+}
+
+TEST_F(DualBankKvs, Put_FailedCopy_OtherCopyIsUsed) {
+  flash_.InjectWriteError(FlashError::Unconditional(Status::Unavailable(), 1));
+
+  EXPECT_EQ(Status::Unavailable(),
+            kvs_.Put("key", std::array<char, 100>{'v'}));
+  EXPECT_TRUE(kvs_.error_detected());
+
+  std::array<char, 100> value{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ('v', value[0]);
+}
+
+// Fake flash that counts the bytes read from it with Read().
+class ReadCountingFlash : public FakeFlashMemoryBuffer<512, 4> {
+ public:
+  ReadCountingFlash() : FakeFlashMemoryBuffer(16) {}
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override {
+    bytes_read_ += output.size();
+    return FakeFlashMemoryBuffer::Read(address, output);
+  }
+
+  size_t bytes_read() const { return bytes_read_; }
+  void reset_bytes_read() { bytes_read_ = 0; }
+
+ private:
+  size_t bytes_read_ = 0;
+};
+
+class MappedFlashKvs : public ::testing::Test {
+ protected:
+  MappedFlashKvs() : partition_(&flash_) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition_,
+                                                            default_format);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    for (const char* key : keys) {
+      ASSERT_EQ(OkStatus(), kvs.Put(key, std::array<char, 100>{'v'}));
+    }
+  }
+
+  // Returns the number of bytes read with Read() to initialize a KVS.
+  size_t InitBytesRead() {
+    flash_.reset_bytes_read();
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition_,
+                                                            default_format);
+    EXPECT_EQ(OkStatus(), kvs.Init());
+    EXPECT_FALSE(kvs.error_detected());
+    EXPECT_EQ(keys.size(), kvs.size());
+    return flash_.bytes_read();
+  }
+
+  ReadCountingFlash flash_;
+  FlashPartition partition_;
+};
+
+TEST_F(MappedFlashKvs, Init_VerifiesEntriesInPlace) {
+  const size_t bytes_read = InitBytesRead();
+
+  flash_.set_mapped_reads(true);
+  const size_t mapped_bytes_read = InitBytesRead();
+
+  // Only the headers and erased checks are read; keys and values are hashed
+  // and checksummed in place.
+  EXPECT_LT(mapped_bytes_read + keys.size() * 100, bytes_read);
+}
+
+TEST_F(MappedFlashKvs, Get_FindsKeysInPlace) {
+  flash_.set_mapped_reads(true);
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition_,
+                                                          default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  for (const char* key : keys) {
+    std::array<char, 100> value{};
+    ASSERT_EQ(OkStatus(), kvs.Get(key, &value));
+    EXPECT_EQ('v', value[0]);
+  }
+  EXPECT_EQ(Status::NotFound(),
+            kvs.Get("missing", std::span<std::byte>()).status());
+}
+
+TEST_F(MappedFlashKvs, Init_DetectsCorruptionInPlace) {
+  // Corrupt the first entry's value, which directly follows its key.
+  const std::span<std::byte> buffer = flash_.buffer();
+  const std::string_view key = keys[0];
+  auto entry_key =
+      std::search(buffer.begin(),
+                  buffer.end(),
+                  key.begin(),
+                  key.end(),
+                  [](std::byte b, char c) { return char(b) == c; });
+  ASSERT_NE(entry_key, buffer.end());
+  entry_key[key.size()] ^= std::byte{0x01};
+  flash_.set_mapped_reads(true);
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition_,
+                                                          default_format);
+  kvs.Init().IgnoreError();
+  EXPECT_EQ(keys.size() - 1, kvs.size());
+  EXPECT_EQ(Status::NotFound(),
+            kvs.Get(keys[0], std::span<std::byte>()).status());
+}
+
+// Reader that fails after reading a number of bytes from its source.
+class FailingReader : public stream::NonSeekableReader {
+ public:
+  FailingReader(std::span<const std::byte> source, size_t fail_after)
+      : source_(source), fail_after_(fail_after) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    if (position_ >= fail_after_) {
+      return StatusWithSize::Unavailable();
+    }
+    const size_t size =
+        std::min(destination.size(), std::min(fail_after_, source_.size()) -
+                                         position_);
+    std::memcpy(destination.data(), &source_[position_], size);
+    position_ += size;
+    return StatusWithSize(size);
+  }
+
+  std::span<const std::byte> source_;
+  size_t fail_after_;
+  size_t position_ = 0;
+};
+
+class StreamKvs : public ::testing::Test {
+ protected:
+  // Use an alignment larger than the header, so the first alignment unit of
+  // an entry includes the key and part of the value.
+  StreamKvs() : flash_(64), kvs_(&flash_.partition, default_format) {
+    for (size_t i = 0; i < value_.size(); ++i) {
+      value_[i] = std::byte(i * 7);
+    }
+  }
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), flash_.partition.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  FlashWithPartitionFake<2048, 4> flash_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  std::array<std::byte, 1000> value_;
+};
+
+TEST_F(StreamKvs, Put_FromStream) {
+  stream::MemoryReader reader(value_);
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", reader, value_.size()));
+  EXPECT_EQ(value_.size(), reader.bytes_read());
+
+  std::array<std::byte, 1000> read{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("big", read).status());
+  EXPECT_EQ(0, std::memcmp(value_.data(), read.data(), read.size()));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reinit(&flash_.partition,
+                                                             default_format);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+  EXPECT_FALSE(reinit.error_detected());
+  EXPECT_EQ(value_.size(), reinit.ValueSize("big").size());
+}
+
+TEST_F(StreamKvs, Put_FromStream_ValueFitsInFirstAlignmentUnit) {
+  stream::MemoryReader reader{std::span(value_).first(10)};
+  ASSERT_EQ(OkStatus(), kvs_.Put("small", reader, 10));
+
+  std::array<std::byte, 10> read{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("small", read).status());
+  EXPECT_EQ(0, std::memcmp(value_.data(), read.data(), read.size()));
+}
+
+TEST_F(StreamKvs, Put_FromStream_OverwritesValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", uint32_t(1)));
+
+  stream::MemoryReader reader(value_);
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", reader, value_.size()));
+  EXPECT_EQ(1u, kvs_.size());
+  EXPECT_EQ(value_.size(), kvs_.ValueSize("big").size());
+}
+
+TEST_F(StreamKvs, Put_FromStream_StreamTooShort) {
+  stream::MemoryReader reader{std::span(value_).first(10)};
+  EXPECT_EQ(Status::OutOfRange(), kvs_.Put("big", reader, value_.size()));
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("big").status());
+
+  // Nothing was written to flash, so the KVS is unaffected.
+  EXPECT_FALSE(kvs_.error_detected());
+  EXPECT_EQ(OkStatus(), kvs_.Put("big", uint32_t(1)));
+}
+
+TEST_F(StreamKvs, Put_FromStream_ValueTooLarge) {
+  stream::MemoryReader reader(value_);
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Put("big", reader, 2048));
+  EXPECT_EQ(0u, reader.bytes_read());
+}
+
+TEST_F(StreamKvs, Put_FromStream_InterruptedWriteFoundByInit) {
+  FailingReader reader(value_, 500);
+  EXPECT_EQ(Status::Unavailable(), kvs_.Put("big", reader, value_.size()));
+  EXPECT_TRUE(kvs_.error_detected());
+
+  // The partial entry has no header, but its data is found by Init, which
+  // recovers the sector.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reinit(&flash_.partition,
+                                                             default_format);
+  reinit.Init().IgnoreError();
+  EXPECT_EQ(1u, reinit.GetStorageStats().corrupt_sectors_recovered);
+  EXPECT_EQ(Status::NotFound(), reinit.ValueSize("big").status());
+  EXPECT_EQ(OkStatus(), reinit.Put("big", uint32_t(1)));
+}
+
+TEST_F(StreamKvs, Get_ToStream) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", value_));
+
+  stream::MemoryWriterBuffer<1000> writer;
+  const StatusWithSize result = kvs_.Get("big", writer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(value_.size(), result.size());
+  ASSERT_EQ(value_.size(), writer.bytes_written());
+  EXPECT_EQ(0, std::memcmp(value_.data(), writer.data(), value_.size()));
+}
+
+TEST_F(StreamKvs, Get_ToStream_MappedFlash) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", value_));
+  flash_.memory.set_mapped_reads(true);
+
+  stream::MemoryWriterBuffer<1000> writer;
+  ASSERT_EQ(OkStatus(), kvs_.Get("big", writer).status());
+  EXPECT_EQ(0, std::memcmp(value_.data(), writer.data(), value_.size()));
+}
+
+TEST_F(StreamKvs, Get_ToStream_WriterTooSmall) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", value_));
+
+  stream::MemoryWriterBuffer<100> writer;
+  EXPECT_EQ(Status::ResourceExhausted(), kvs_.Get("big", writer).status());
+}
+
+TEST_F(StreamKvs, Get_ToStream_CorruptValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", value_));
+
+  const std::span<std::byte> buffer = flash_.memory.buffer();
+  auto found = std::search(
+      buffer.begin(), buffer.end(), value_.begin(), value_.begin() + 16);
+  ASSERT_NE(found, buffer.end());
+  found[500] ^= std::byte{0x01};
+
+  stream::MemoryWriterBuffer<1000> writer;
+  EXPECT_EQ(Status::DataLoss(), kvs_.Get("big", writer).status());
+}
+
+TEST_F(StreamKvs, Get_ToStream_NotFound) {
+  stream::MemoryWriterBuffer<1000> writer;
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("big", writer).status());
+  EXPECT_EQ(0u, writer.bytes_written());
+}
+
+TEST(RedundantStreamKvs, Put_FromStream_CopiesEachEntry) {
+  FlashWithPartitionFake<2048, 4> flash;
+  ASSERT_EQ(OkStatus(), flash.partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> kvs(&flash.partition,
+                                                             default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  std::array<std::byte, 500> value;
+  std::fill(value.begin(), value.end(), std::byte{0x5a});
+  stream::MemoryReader reader(value);
+  ASSERT_EQ(OkStatus(), kvs.Put("big", reader, value.size()));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> reinit(
+      &flash.partition, default_format);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+  EXPECT_FALSE(reinit.error_detected());
+  EXPECT_EQ(kvs.GetStorageStats().in_use_bytes,
+            reinit.GetStorageStats().in_use_bytes);
+  EXPECT_EQ(2 * internal::Entry::size(flash.partition, "big", value.size()),
+            reinit.GetStorageStats().in_use_bytes);
+}
+
 }  // namespace pw::kvs
@@ -0,0 +1,130 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A FlashPartition that combines adjacent writes into page-sized programs.
+//
+// Writes are copied into a buffer the size of a flash page. The buffer is
+// written to flash when it reaches the end of a page, when a write is not
+// adjacent to the buffered data, when a read, erase, or erase check overlaps
+// the buffered data, or when Flush() is called. Each program stays within one
+// page, and a KVS entry's header, key, and value are written together.
+//
+// The page size must be a multiple of the partition's alignment, and pages must
+// not cross sector boundaries. Errors from buffered writes are reported by the
+// call that writes the buffer to flash.
+class CoalescingFlashPartition : public FlashPartition {
+ public:
+  using FlashPartition::Erase;
+  using FlashPartition::Read;
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override;
+
+  StatusWithSize Write(Address address,
+                       std::span<const std::byte> data) override;
+
+  // Writes are buffered, so asynchronous writes are not supported.
+  size_t Bank(Address) const override { return 0; }
+
+  Status StartWrite(Address, std::span<const std::byte>) override {
+    return Status::Unimplemented();
+  }
+
+  // Erases must flush overlapping buffered data first, so they are not started
+  // asynchronously either.
+  Status StartErase(Address, size_t) override {
+    return Status::Unimplemented();
+  }
+
+  Status IsRegionErased(Address source_flash_address,
+                        size_t length,
+                        bool* is_erased) override;
+
+  // Buffered data is not in flash yet, so ranges that overlap it are not
+  // mapped.
+  const std::byte* MappedAddress(Address address,
+                                 size_t size_bytes) const override;
+
+  // Writes any buffered data to flash.
+  Status Flush() override;
+
+  size_t page_size_bytes() const { return buffer_.size(); }
+
+  // The number of bytes waiting to be written to flash.
+  size_t buffered_bytes() const { return buffered_bytes_; }
+
+ protected:
+  CoalescingFlashPartition(
+      std::span<std::byte> page_buffer,
+      FlashMemory* flash,
+      uint32_t start_sector_index,
+      uint32_t sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite);
+
+ private:
+  bool Overlaps(Address address, size_t length) const {
+    return buffered_bytes_ != 0u &&
+           address < buffer_address_ + buffered_bytes_ &&
+           buffer_address_ < address + length;
+  }
+
+  // Writes the buffered data to flash if it overlaps the provided range.
+  Status FlushIfOverlapping(Address address, size_t length);
+
+  std::span<std::byte> buffer_;
+  Address buffer_address_;
+  size_t buffered_bytes_;
+};
+
+template <size_t kPageSizeBytes>
+class CoalescingFlashPartitionBuffer : public CoalescingFlashPartition {
+ public:
+  CoalescingFlashPartitionBuffer(
+      FlashMemory* flash,
+      uint32_t start_sector_index,
+      uint32_t sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite)
+      : CoalescingFlashPartition(page_buffer_,
+                                 flash,
+                                 start_sector_index,
+                                 sector_count,
+                                 alignment_bytes,
+                                 permission) {}
+
+  CoalescingFlashPartitionBuffer(FlashMemory* flash)
+      : CoalescingFlashPartitionBuffer(
+            flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
+
+ private:
+  static_assert(kPageSizeBytes > 0u);
+
+  std::array<std::byte, kPageSizeBytes> page_buffer_;
+};
+
+}  // namespace pw::kvs
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <span>
@@ -75,6 +76,30 @@ class FlashError {
   size_t remaining_;
 };
 
+// Latency model for FakeFlashMemory operations. Each operation takes
+// operation_overhead plus its per-byte or per-sector cost. Read bandwidth is
+// expressed as the time to read one byte. The default model is instantaneous.
+struct FlashTiming {
+  std::chrono::nanoseconds operation_overhead{0};
+  std::chrono::nanoseconds read_per_byte{0};
+  std::chrono::nanoseconds program_per_byte{0};
+  std::chrono::nanoseconds erase_per_sector{0};
+};
+
+// Receives the simulated latency of each FakeFlashMemory operation.
+class FlashLatencyObserver {
+ public:
+  enum class Operation { kRead, kWrite, kErase };
+
+  virtual ~FlashLatencyObserver() = default;
+
+  // Called after each read, write, or erase that reached the flash. size_bytes
+  // is the number of bytes read, written, or erased.
+  virtual void OperationComplete(Operation operation,
+                                 size_t size_bytes,
+                                 std::chrono::nanoseconds latency) = 0;
+};
+
 // This uses a buffer to mimic the behaviour of flash (requires erase before
 // write, checks alignments, and is addressed in sectors). The underlying buffer
 // is not initialized.
@@ -113,14 +138,55 @@ class FakeFlashMemory : public FlashMemory {
   StatusWithSize Write(Address address,
                        std::span<const std::byte> data) override;
 
+  // Asynchronous operations are only supported after
+  // set_async_operations(true). The operation is done when it is finished.
+  Status StartWrite(Address address, std::span<const std::byte> data) override;
+
+  StatusWithSize FinishWrite(Address address) override;
+
+  Status StartErase(Address address, size_t num_sectors) override;
+
+  Status FinishErase(Address address) override;
+
   std::byte* FlashAddressToMcuAddress(Address) const override;
 
+  // Mapped reads are disabled by default, since they bypass Read() and thus
+  // injected read errors and the timing model.
+  const std::byte* mapped_base() const override {
+    return mapped_reads_ ? buffer_.data() : nullptr;
+  }
+
   // Testing API
 
   // Access the underlying buffer for testing purposes. Not part of the
   // FlashMemory API.
   std::span<std::byte> buffer() const { return buffer_; }
 
+  // Reports the latency of each subsequent operation to the observer using the
+  // provided timing model. See FlashLatencyRecorder for an observer that
+  // advances a SimulatedSystemClock.
+  void SetTiming(const FlashTiming& timing, FlashLatencyObserver& observer) {
+    timing_ = timing;
+    latency_observer_ = &observer;
+  }
+
+  // Makes StartWrite() and StartErase() defer each operation until it is
+  // finished, like flash that works in the background. One operation may be
+  // in progress at a time.
+  void set_async_operations(bool enabled) { async_operations_ = enabled; }
+
+  // The number of operations started asynchronously.
+  size_t async_operations_started() const { return async_operations_started_; }
+
+  // Exposes the buffer through mapped_base(), like memory-mapped flash.
+  void set_mapped_reads(bool enabled) { mapped_reads_ = enabled; }
+
+  // Returns to instantaneous operations.
+  void ClearTiming() {
+    timing_ = FlashTiming();
+    latency_observer_ = nullptr;
+  }
+
   bool InjectReadError(const FlashError& error) {
     if (read_errors_.full()) {
       return false;
@@ -140,9 +206,32 @@ class FakeFlashMemory : public FlashMemory {
  private:
   static inline Vector<FlashError, 0> no_errors_;
 
+  void ReportLatency(FlashLatencyObserver::Operation operation,
+                     size_t size_bytes,
+                     size_t units,
+                     std::chrono::nanoseconds per_unit) const {
+    if (latency_observer_ != nullptr) {
+      latency_observer_->OperationComplete(
+          operation, size_bytes, timing_.operation_overhead + per_unit * units);
+    }
+  }
+
   const std::span<std::byte> buffer_;
   Vector<FlashError>& read_errors_;
   Vector<FlashError>& write_errors_;
+
+  FlashTiming timing_;
+  FlashLatencyObserver* latency_observer_ = nullptr;
+  bool mapped_reads_ = false;
+
+  enum class Pending : uint8_t { kNone, kWrite, kErase };
+
+  bool async_operations_ = false;
+  Pending pending_ = Pending::kNone;
+  Address pending_address_ = 0;
+  std::span<const std::byte> pending_data_;
+  size_t pending_sectors_ = 0;
+  size_t async_operations_started_ = 0;
 };
 
 // Creates an FakeFlashMemory backed by a std::array. The array is initialized
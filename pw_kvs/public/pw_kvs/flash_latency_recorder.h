@@ -0,0 +1,146 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/simulated_system_clock.h"
+#include "pw_kvs/fake_flash_memory.h"
+
+namespace pw::kvs {
+
+// Summarizes a series of simulated latencies. Latencies are binned into a
+// log2 histogram of microseconds: bucket 0 holds latencies under 1 us and
+// bucket i holds latencies in [2^(i-1), 2^i) us.
+class LatencyStats {
+ public:
+  static constexpr size_t kBuckets = 32;
+
+  constexpr LatencyStats() = default;
+
+  void Add(std::chrono::nanoseconds latency) {
+    if (count_ == 0u || latency < min_) {
+      min_ = latency;
+    }
+    max_ = std::max(max_, latency);
+    total_ += latency;
+    count_ += 1;
+    histogram_[Bucket(latency)] += 1;
+  }
+
+  void Reset() { *this = LatencyStats(); }
+
+  size_t count() const { return count_; }
+  std::chrono::nanoseconds total() const { return total_; }
+  std::chrono::nanoseconds min() const { return min_; }
+  std::chrono::nanoseconds max() const { return max_; }
+
+  std::chrono::nanoseconds mean() const {
+    if (count_ == 0u) {
+      return std::chrono::nanoseconds(0);
+    }
+    return total_ / static_cast<int64_t>(count_);
+  }
+
+  std::span<const uint32_t, kBuckets> histogram() const { return histogram_; }
+
+  // Returns an upper bound on the given percentile (0 to 100) of latencies,
+  // derived from the histogram. The result never exceeds max().
+  std::chrono::nanoseconds Percentile(unsigned percent) const {
+    const size_t target = (count_ * std::min(percent, 100u) + 99) / 100;
+    size_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+      seen += histogram_[i];
+      if (seen >= target && seen != 0u) {
+        return std::min(max_, BucketLimit(i));
+      }
+    }
+    return max_;
+  }
+
+ private:
+  static size_t Bucket(std::chrono::nanoseconds latency) {
+    uint64_t us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    size_t bucket = 0;
+    while (us != 0u && bucket < kBuckets - 1) {
+      us >>= 1;
+      bucket += 1;
+    }
+    return bucket;
+  }
+
+  static std::chrono::nanoseconds BucketLimit(size_t bucket) {
+    return std::chrono::microseconds(uint64_t(1) << bucket);
+  }
+
+  size_t count_ = 0;
+  std::chrono::nanoseconds total_{0};
+  std::chrono::nanoseconds min_{0};
+  std::chrono::nanoseconds max_{0};
+  std::array<uint32_t, kBuckets> histogram_{};
+};
+
+// Advances a SimulatedSystemClock by the latency of each FakeFlashMemory
+// operation and keeps latency statistics per operation type. Code under test
+// that reads the clock then observes realistic device timing, including erase
+// stalls during garbage collection.
+//
+//   chrono::SimulatedSystemClock clock;
+//   FlashLatencyRecorder recorder(clock);
+//   flash.SetTiming({.program_per_byte = 10us, .erase_per_sector = 20ms},
+//                   recorder);
+//
+class FlashLatencyRecorder : public FlashLatencyObserver {
+ public:
+  explicit FlashLatencyRecorder(chrono::SimulatedSystemClock& clock)
+      : clock_(clock) {}
+
+  void OperationComplete(Operation operation,
+                         size_t,
+                         std::chrono::nanoseconds latency) override {
+    clock_.AdvanceTime(chrono::SystemClock::for_at_least(latency));
+    stats_[static_cast<size_t>(operation)].Add(latency);
+  }
+
+  const LatencyStats& reads() const { return stats(Operation::kRead); }
+  const LatencyStats& writes() const { return stats(Operation::kWrite); }
+  const LatencyStats& erases() const { return stats(Operation::kErase); }
+
+  // Total simulated time the flash has been busy.
+  std::chrono::nanoseconds busy_time() const {
+    return reads().total() + writes().total() + erases().total();
+  }
+
+  void Reset() {
+    for (LatencyStats& stats : stats_) {
+      stats.Reset();
+    }
+  }
+
+ private:
+  const LatencyStats& stats(Operation operation) const {
+    return stats_[static_cast<size_t>(operation)];
+  }
+
+  chrono::SimulatedSystemClock& clock_;
+  std::array<LatencyStats, 3> stats_;
+};
+
+}  // namespace pw::kvs
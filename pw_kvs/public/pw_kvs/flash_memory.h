@@ -106,10 +106,64 @@ class FlashMemory {
         std::span<const std::byte>(static_cast<const std::byte*>(data), len));
   }
 
+  // Flash memories with banks that can be programmed at the same time may
+  // support asynchronous writes, so that data in different banks can be
+  // written concurrently.
+  //
+  // Returns the index of the bank that contains the address. Writes to
+  // addresses in different banks may be in progress at the same time. Flash
+  // that does not support asynchronous writes has a single bank.
+  virtual size_t Bank(Address) const { return 0; }
+
+  // Starts writing bytes to flash and returns without waiting for the write to
+  // finish. At most one write may be in progress per bank. data must remain
+  // valid until FinishWrite is called for the write. Returns:
+  //
+  // OK - the write was started
+  // UNIMPLEMENTED - the flash does not support asynchronous writes
+  // INVALID_ARGUMENT - address or data size are not aligned
+  // OUT_OF_RANGE - write does not fit in the memory
+  virtual Status StartWrite(Address, std::span<const std::byte>) {
+    return Status::Unimplemented();
+  }
+
+  // Waits for the write started at the address with StartWrite to finish.
+  // Returns the result of the write, as Write would.
+  virtual StatusWithSize FinishWrite(Address) {
+    return StatusWithSize::FailedPrecondition();
+  }
+
+  // Starts erasing sectors and returns without waiting for the erase to
+  // finish, so the caller can do other work, such as computation or I/O, in
+  // the meantime. At most one erase or write may be in progress per bank.
+  // Returns:
+  //
+  // OK - the erase was started
+  // UNIMPLEMENTED - the flash does not support asynchronous erases
+  // INVALID_ARGUMENT - address is not sector aligned
+  // OUT_OF_RANGE - erase does not fit in the memory
+  virtual Status StartErase(Address, size_t /* num_sectors */) {
+    return Status::Unimplemented();
+  }
+
+  // Waits for the erase started at the address with StartErase to finish.
+  // Returns the result of the erase, as Erase would.
+  virtual Status FinishErase(Address) { return Status::FailedPrecondition(); }
+
   // Convert an Address to an MCU pointer, this can be used for memory
   // mapped reads. Return NULL if the memory is not memory mapped.
   virtual std::byte* FlashAddressToMcuAddress(Address) const { return nullptr; }
 
+  // Returns the MCU address of the first byte of flash if the whole flash is
+  // memory mapped (e.g. internal flash used for XIP), or NULL if it is not. The
+  // byte at flash address start_address() + N is at mapped_base() + N.
+  //
+  // Reading mapped memory must be equivalent to calling Read(). Return NULL if
+  // reads have side effects or if data is cached or transformed on its way
+  // from flash. The KVS uses mapped flash to compare keys and verify checksums
+  // in place instead of copying the data with Read().
+  virtual const std::byte* mapped_base() const { return nullptr; }
+
   // start_sector() is useful for FlashMemory instances where the
   // sector start is not 0. (ex.: cases where there are portions of flash
   // that should be handled independently).
@@ -275,6 +329,39 @@ class FlashPartition {
   virtual StatusWithSize Write(Address address,
                                std::span<const std::byte> data);
 
+  // Returns the flash bank that contains the address. Writes to addresses in
+  // different banks may be in progress at the same time with StartWrite.
+  // Partitions that override Write should return the same bank for every
+  // address, unless they also override StartWrite and FinishWrite.
+  virtual size_t Bank(Address address) const {
+    return flash_.Bank(PartitionToFlashAddress(address));
+  }
+
+  // Starts writing bytes to flash without waiting for the write to finish, if
+  // the flash supports it. At most one write may be in progress per bank, and
+  // data must remain valid until FinishWrite is called. Returns the same
+  // errors as Write, or UNIMPLEMENTED if the flash does not support
+  // asynchronous writes.
+  virtual Status StartWrite(Address address, std::span<const std::byte> data);
+
+  // Waits for a write started with StartWrite to finish and returns its
+  // result.
+  virtual StatusWithSize FinishWrite(Address address) {
+    return flash_.FinishWrite(PartitionToFlashAddress(address));
+  }
+
+  // Starts erasing sectors without waiting for the erase to finish, if the
+  // flash supports it. Returns the same errors as Erase, or UNIMPLEMENTED if
+  // the flash does not support asynchronous erases. FlashOperation falls back
+  // to erasing synchronously in that case.
+  virtual Status StartErase(Address address, size_t num_sectors);
+
+  // Waits for an erase started with StartErase to finish and returns its
+  // result.
+  virtual Status FinishErase(Address address) {
+    return flash_.FinishErase(PartitionToFlashAddress(address));
+  }
+
   // Check to see if chunk of flash partition is erased. Address and len need to
   // be aligned with FlashMemory. Returns:
   //
@@ -293,6 +380,13 @@ class FlashPartition {
     return IsRegionErased(0, this->size_bytes(), is_erased);
   }
 
+  // Writes any data buffered by the partition to flash. Partitions that write
+  // directly to flash have nothing to flush. Returns:
+  //
+  // OK - success.
+  // Any error from Write().
+  virtual Status Flush() { return OkStatus(); }
+
   // Checks to see if the data appears to be erased. No reads or writes occur;
   // the FlashPartition simply compares the data to
   // flash_.erased_memory_content().
@@ -312,12 +406,25 @@ class FlashPartition {
 
   size_t sector_count() const { return sector_count_; }
 
+  // Returns the number of times each sector of the partition has been erased,
+  // or an empty span if the partition does not track erases. The KVS uses
+  // these counts to spread wear when selecting sectors.
+  virtual std::span<const size_t> sector_erase_counts() const { return {}; }
+
   // Convert a FlashMemory::Address to an MCU pointer, this can be used for
   // memory mapped reads. Return NULL if the memory is not memory mapped.
   std::byte* PartitionAddressToMcuAddress(Address address) const {
     return flash_.FlashAddressToMcuAddress(PartitionToFlashAddress(address));
   }
 
+  // Returns a pointer to size_bytes of the partition starting at address if
+  // they can be read directly from memory-mapped flash, or NULL if they must be
+  // read with Read(). Returns NULL if the range is out of bounds or is not
+  // contiguous in flash. Partitions that buffer or transform data in Read()
+  // must override this to return NULL for the affected ranges.
+  virtual const std::byte* MappedAddress(Address address,
+                                         size_t size_bytes) const;
+
   // Converts an address from the partition address space to the flash address
   // space. If the partition reserves additional space in the sector, the flash
   // address space may not be contiguous, and this conversion accounts for that.
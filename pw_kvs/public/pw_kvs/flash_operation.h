@@ -0,0 +1,89 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// Tracks one asynchronous write or erase on a FlashPartition. Start an
+// operation, do other work while the flash is busy, then call Finish() to wait
+// for the result.
+//
+// If the flash cannot start the operation asynchronously, FlashOperation does
+// it synchronously when it is started and returns its result from Finish().
+// Callers need only one code path, and they overlap flash operations with
+// other work whenever the flash supports it.
+//
+//   FlashOperation erase(partition);
+//   PW_TRY(erase.StartErase(address, 1));
+//   PrepareNextChunk();  // Runs while the sector is erased.
+//   PW_TRY(erase.Finish().status());
+//
+class FlashOperation {
+ public:
+  explicit constexpr FlashOperation(FlashPartition& partition)
+      : partition_(partition),
+        address_(0),
+        state_(State::kIdle),
+        result_(StatusWithSize(0)) {}
+
+  FlashOperation(const FlashOperation&) = delete;
+  FlashOperation& operator=(const FlashOperation&) = delete;
+
+  // Starts writing data, which must remain valid until Finish() is called.
+  // Returns FAILED_PRECONDITION if an operation is already in progress, or the
+  // partition's error if the write could not be started. A write performed
+  // synchronously always starts; its errors are returned by Finish().
+  Status StartWrite(FlashPartition::Address address,
+                    std::span<const std::byte> data);
+
+  // Starts erasing sectors. Errors are reported as for StartWrite().
+  Status StartErase(FlashPartition::Address address, size_t num_sectors);
+
+  // Waits for the operation to finish and returns its result. For an erase,
+  // the size is always 0. Returns FAILED_PRECONDITION if no operation was
+  // started.
+  StatusWithSize Finish();
+
+  // True if an operation was started and Finish() has not been called.
+  bool in_progress() const { return state_ != State::kIdle; }
+
+  // True if the operation in progress is being done by the flash in the
+  // background rather than having been done when it was started.
+  bool asynchronous() const {
+    return state_ == State::kWriting || state_ == State::kErasing;
+  }
+
+ private:
+  enum class State : uint8_t {
+    kIdle,
+    kWriting,  // StartWrite succeeded
+    kErasing,  // StartErase succeeded
+    kDone,     // Done synchronously; result_ holds the result
+  };
+
+  FlashPartition& partition_;
+  FlashPartition::Address address_;
+  State state_;
+  StatusWithSize result_;
+};
+
+}  // namespace pw::kvs
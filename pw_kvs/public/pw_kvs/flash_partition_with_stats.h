@@ -42,6 +42,10 @@ class FlashPartitionWithStats : public FlashPartition {
     return std::span(sector_counters_.data(), sector_counters_.size());
   }
 
+  std::span<const size_t> sector_erase_counts() const override {
+    return std::span(sector_counters_.data(), sector_counters_.size());
+  }
+
   size_t min_erase_count() const {
     if (sector_counters_.empty()) {
       return 0;
@@ -17,6 +17,7 @@
 #include <span>
 
 #include "pw_kvs/checksum.h"
+#include "pw_kvs/value_codec.h"
 
 namespace pw {
 namespace kvs {
@@ -43,11 +44,13 @@ struct EntryHeader {
 
   // The length of the key in bytes. The key is not null terminated.
   //  6 bits, 0:5 - key length - maximum 64 characters
-  //  2 bits, 6:7 - reserved
+  //  1 bit,  6   - the value is compressed with the format's ValueCodec
+  //  1 bit,  7   - reserved
   uint8_t key_length_bytes;
 
-  // Byte length of the value; maximum of 65534. The max uint16_t value (65535
-  // or 0xFFFF) is reserved to indicate this is a tombstone (deleted) entry.
+  // Byte length of the value as stored; maximum of 65534. The max uint16_t
+  // value (65535 or 0xFFFF) is reserved to indicate this is a tombstone
+  // (deleted) entry.
   uint16_t value_size_bytes;
 
   // The transaction ID for this key. Monotonically increasing.
@@ -78,6 +81,22 @@ class EntryFormats {
 
 }  // namespace internal
 
+// The function a KVS uses to hash its keys. Entries do not store key hashes, so
+// Init() recalculates them, but keys that collide under a different function
+// than the one they were written with cannot be told apart. Init() then keeps
+// only the newer of the two, so a partition must always be opened with the same
+// KeyHash.
+enum class KeyHash : uint8_t {
+  // Hashes keys one byte at a time. Every KVS written before kWordAtATime was
+  // added uses this hash, so it is the default.
+  kLegacy = 0,
+
+  // Hashes keys four bytes at a time, which is several times faster for long
+  // keys. Only select it for partitions that have never been written with
+  // kLegacy.
+  kWordAtATime = 1,
+};
+
 // The EntryFormat defines properties of KVS entries that use a particular magic
 // number.
 struct EntryFormat {
@@ -103,6 +122,11 @@ struct EntryFormat {
   // The checksum algorithm is used to calculate checksums for KVS entries. If
   // it is null, no checksum is used.
   ChecksumAlgorithm* checksum;
+
+  // The codec used to compress values. If it is null, values are stored as
+  // is. Entries written with a codec can only be read by formats with the same
+  // codec.
+  ValueCodec* codec = nullptr;
 };
 
 }  // namespace kvs
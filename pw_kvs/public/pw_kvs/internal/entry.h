@@ -28,6 +28,7 @@
 #include "pw_kvs/internal/hash.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/key.h"
+#include "pw_stream/stream.h"
 
 namespace pw {
 namespace kvs {
@@ -39,6 +40,9 @@ class Entry {
   static constexpr size_t kMinAlignmentBytes = sizeof(EntryHeader);
   static constexpr size_t kMaxKeyLength = 0b111111;
 
+  // The largest value an entry can hold. The largest size marks a tombstone.
+  static constexpr size_t kMaxValueSizeBytes = 0xFFFE;
+
   using Address = FlashPartition::Address;
 
   // Buffer capable of holding any valid key (without a null terminator);
@@ -61,15 +65,70 @@ class Entry {
                         size_t key_length,
                         char* key);
 
-  // Creates a new Entry for a valid (non-deleted) entry.
+  // Reads a key. If the key is in memory-mapped flash, key refers to it in
+  // place; otherwise, the key is copied into the buffer.
+  static Status ReadKey(FlashPartition& partition,
+                        Address address,
+                        size_t key_length,
+                        KeyBuffer& buffer,
+                        Key* key);
+
+  // Creates a new Entry for a valid (non-deleted) entry. If `compressed` is
+  // true, the value was compressed with the format's codec.
   static Entry Valid(FlashPartition& partition,
                      Address address,
                      const EntryFormat& format,
                      Key key,
                      std::span<const std::byte> value,
-                     uint32_t transaction_id) {
-    return Entry(
-        partition, address, format, key, value, value.size(), transaction_id);
+                     uint32_t transaction_id,
+                     bool compressed = false) {
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 std::span(&value, 1),
+                 value.size(),
+                 transaction_id,
+                 compressed);
+  }
+
+  // Creates a new Entry for a valid entry whose value is the concatenation of
+  // several buffers. The total size must be less than 0xFFFF bytes.
+  static Entry ValidFromChunks(
+      FlashPartition& partition,
+      Address address,
+      const EntryFormat& format,
+      Key key,
+      std::span<const std::span<const std::byte>> value_chunks,
+      uint32_t transaction_id) {
+    size_t value_size = 0;
+    for (std::span<const std::byte> chunk : value_chunks) {
+      value_size += chunk.size();
+    }
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 value_chunks,
+                 static_cast<uint16_t>(value_size),
+                 transaction_id);
+  }
+
+  // Creates a new Entry for a value_size-byte value that is written from a
+  // stream with WriteStream. The checksum is set by WriteStream.
+  static Entry ValidForStream(FlashPartition& partition,
+                              Address address,
+                              const EntryFormat& format,
+                              Key key,
+                              size_t value_size,
+                              uint32_t transaction_id) {
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 {},
+                 static_cast<uint16_t>(value_size),
+                 transaction_id);
   }
 
   // Creates a new Entry for a tombstone entry, which marks a deleted key.
@@ -89,15 +148,40 @@ class Entry {
 
   Entry() = default;
 
-  KeyDescriptor descriptor(Key key) const { return descriptor(Hash(key)); }
-
   KeyDescriptor descriptor(uint32_t key_hash) const {
     return KeyDescriptor{key_hash,
                          transaction_id(),
                          deleted() ? EntryState::kDeleted : EntryState::kValid};
   }
 
-  StatusWithSize Write(Key key, std::span<const std::byte> value) const;
+  StatusWithSize Write(Key key, std::span<const std::byte> value) const {
+    return WriteChunks(key, std::span(&value, 1));
+  }
+
+  // Writes an entry created with ValidFromChunks.
+  StatusWithSize WriteChunks(
+      Key key, std::span<const std::span<const std::byte>> value_chunks) const;
+
+  // Writes copies of the entry at each of the addresses, ignoring the entry's
+  // own address. Each chunk of the entry is started at every address before
+  // waiting for any of them, so copies in different flash banks are written
+  // concurrently. results must have one element per address, and is set to
+  // the result of writing each copy. A copy that fails does not stop the
+  // others from being written. Returns OK if at least one copy was written.
+  Status WriteCopies(std::span<const Address> addresses,
+                     Key key,
+                     std::span<const std::byte> value,
+                     std::span<StatusWithSize> results) const;
+
+  // Writes an entry created with ValidForStream, reading its value from reader
+  // through a small buffer. The checksum is calculated as the value is read,
+  // so the start of the entry, which holds the header, is written last. Until
+  // then, the partially written entry has an erased header.
+  //
+  // Returns OUT_OF_RANGE if the reader ends before the whole value is read. The
+  // size is the number of bytes written to flash, which may be nonzero when
+  // the write fails.
+  StatusWithSize WriteStream(Key key, stream::Reader& reader);
 
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
@@ -119,9 +203,28 @@ class Entry {
         ReadKey(partition(), address_, key_length(), key.data()), key_length());
   }
 
+  // Reads the key without copying it if the partition is memory mapped. The
+  // key is only valid until the entry's sector is erased.
+  Status ReadKey(KeyBuffer& buffer, Key* key) const {
+    return ReadKey(partition(), address_, key_length(), buffer, key);
+  }
+
+  // Reads the value into a buffer. Compressed values are decompressed, which
+  // is only supported from the start of the value.
   StatusWithSize ReadValue(std::span<std::byte> buffer,
                            size_t offset_bytes = 0) const;
 
+  // Writes the value to writer through a small buffer, or directly from
+  // memory-mapped flash. If verify is true, the checksum is calculated as the
+  // value is read and checked once all of it has been written, so a corrupt
+  // value is reported with DATA_LOSS after it was written. Compressed values
+  // are not supported and return UNIMPLEMENTED.
+  StatusWithSize ReadValue(stream::Writer& writer, bool verify) const;
+
+  // Returns the size of the value as read by ReadValue. For a compressed value,
+  // this is read from flash.
+  StatusWithSize ReadValueSize() const;
+
   Status ValueMatches(std::span<const std::byte> value) const;
 
   Status VerifyChecksum(Key key, std::span<const std::byte> value) const;
@@ -132,7 +235,13 @@ class Entry {
   static size_t size(const FlashPartition& partition,
                      Key key,
                      std::span<const std::byte> value) {
-    return AlignUp(sizeof(EntryHeader) + key.size() + value.size(),
+    return size(partition, key, value.size());
+  }
+
+  static size_t size(const FlashPartition& partition,
+                     Key key,
+                     size_t value_size) {
+    return AlignUp(sizeof(EntryHeader) + key.size() + value_size,
                    std::max(partition.alignment_bytes(), kMinAlignmentBytes));
   }
 
@@ -151,10 +260,17 @@ class Entry {
   size_t size() const { return AlignUp(content_size(), alignment_bytes()); }
 
   // The length of the key in bytes. Keys are not null terminated.
-  size_t key_length() const { return header_.key_length_bytes; }
+  size_t key_length() const {
+    return header_.key_length_bytes & kMaxKeyLength;
+  }
+
+  // True if the value is stored compressed.
+  bool compressed() const {
+    return (header_.key_length_bytes & kCompressedFlag) != 0u;
+  }
 
-  // The size of the value, without padding. The size is 0 if this is a
-  // tombstone entry.
+  // The size of the value as stored, without padding. The size is 0 if this is
+  // a tombstone entry.
   size_t value_size() const {
     return deleted() ? 0u : header_.value_size_bytes;
   }
@@ -173,13 +289,18 @@ class Entry {
  private:
   static constexpr uint16_t kDeletedValueLength = 0xFFFF;
 
+  // Flags in EntryHeader::key_length_bytes, above the key length.
+  static constexpr uint8_t kCompressedFlag = 0b01000000;
+  static constexpr uint8_t kReservedFlag = 0b10000000;
+
   Entry(FlashPartition& partition,
         Address address,
         const EntryFormat& format,
         Key key,
-        std::span<const std::byte> value,
+        std::span<const std::span<const std::byte>> value_chunks,
         uint16_t value_size_bytes,
-        uint32_t transaction_id);
+        uint32_t transaction_id,
+        bool compressed = false);
 
   constexpr Entry(FlashPartition* partition,
                   Address address,
@@ -188,6 +309,7 @@ class Entry {
       : partition_(partition),
         address_(address),
         checksum_algo_(format.checksum),
+        codec_(format.codec),
         header_(header) {}
 
   FlashPartition& partition() const { return *partition_; }
@@ -204,10 +326,13 @@ class Entry {
   }
 
   std::span<const std::byte> CalculateChecksum(
-      Key key, std::span<const std::byte> value) const;
+      Key key, std::span<const std::span<const std::byte>> value_chunks) const;
 
   Status CalculateChecksumFromFlash();
 
+  // Verifies the checksum of an entry in memory-mapped flash.
+  Status VerifyChecksumInPlace(const std::byte* entry) const;
+
   // Update the checksum with 0s to pad the entry to its alignment boundary.
   void AddPaddingBytesToChecksum() const;
 
@@ -218,6 +343,7 @@ class Entry {
   FlashPartition* partition_;
   Address address_;
   ChecksumAlgorithm* checksum_algo_;
+  ValueCodec* codec_;
   EntryHeader header_;
 };
 
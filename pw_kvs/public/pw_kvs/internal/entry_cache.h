@@ -13,17 +13,22 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <span>
 #include <type_traits>
 
-#include "pw_containers/vector.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/format.h"
+#include "pw_kvs/internal/entry.h"
+#include "pw_kvs/internal/hash.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/key.h"
+#include "pw_status/status.h"
+#include "pw_sync/virtual_basic_lockable.h"
 
 namespace pw {
 namespace kvs {
@@ -37,11 +42,13 @@ class EntryMetadata {
 
   EntryMetadata() = default;
 
-  uint32_t hash() const { return descriptor_->key_hash; }
+  uint32_t hash() const { return descriptors_->key_hash(index_); }
 
-  uint32_t transaction_id() const { return descriptor_->transaction_id; }
+  uint32_t transaction_id() const {
+    return descriptors_->transaction_id(index_);
+  }
 
-  EntryState state() const { return descriptor_->state; }
+  EntryState state() const { return descriptors_->state(index_); }
 
   // The first known address of this entry.
   uint32_t first_address() const { return addresses_[0]; }
@@ -72,11 +79,13 @@ class EntryMetadata {
  private:
   friend class EntryCache;
 
-  constexpr EntryMetadata(KeyDescriptor& descriptor,
+  constexpr EntryMetadata(KeyDescriptorList& descriptors,
+                          size_t index,
                           std::span<Address> addresses)
-      : descriptor_(&descriptor), addresses_(addresses) {}
+      : descriptors_(&descriptors), index_(index), addresses_(addresses) {}
 
-  KeyDescriptor* descriptor_;
+  KeyDescriptorList* descriptors_;
+  size_t index_;
   std::span<Address> addresses_;
 };
 
@@ -94,36 +103,36 @@ class EntryCache {
         std::conditional_t<kIsConst, const EntryMetadata, EntryMetadata>;
 
     Iterator& operator++() {
-      ++metadata_.descriptor_;
+      ++metadata_.index_;
       return *this;
     }
     Iterator& operator++(int) { return operator++(); }
 
     // Updates the internal EntryMetadata object.
     value_type& operator*() const {
-      metadata_.addresses_ = entry_cache_->addresses(
-          metadata_.descriptor_ - entry_cache_->descriptors_.begin());
+      metadata_.addresses_ = entry_cache_->addresses(metadata_.index_);
       return metadata_;
     }
     value_type* operator->() const { return &operator*(); }
 
     constexpr bool operator==(const Iterator& rhs) const {
-      return metadata_.descriptor_ == rhs.metadata_.descriptor_;
+      return metadata_.index_ == rhs.metadata_.index_;
     }
     constexpr bool operator!=(const Iterator& rhs) const {
-      return metadata_.descriptor_ != rhs.metadata_.descriptor_;
+      return metadata_.index_ != rhs.metadata_.index_;
     }
 
     // Allow non-const to convert to const.
     operator Iterator<kConst>() const {
-      return {entry_cache_, metadata_.descriptor_};
+      return {entry_cache_, metadata_.index_};
     }
 
    private:
     friend class EntryCache;
 
-    constexpr Iterator(const EntryCache* entry_cache, KeyDescriptor* descriptor)
-        : entry_cache_(entry_cache), metadata_(*descriptor, {}) {}
+    constexpr Iterator(const EntryCache* entry_cache, size_t descriptor_index)
+        : entry_cache_(entry_cache),
+          metadata_(entry_cache->descriptors_, descriptor_index, {}) {}
 
     const EntryCache* entry_cache_;
 
@@ -138,21 +147,94 @@ class EntryCache {
 
   using Address = FlashPartition::Address;
 
+  // The first bytes of a key, cached in RAM so that lookups can rule out hash
+  // collisions without reading the key from flash. Keys that fit entirely in
+  // the prefix are matched without reading flash at all.
+  struct KeyPrefix {
+    static constexpr size_t kMaxSize = 7;
+
+    // Size of the full key, or 0 if the prefix is not known.
+    uint8_t key_size;
+    std::array<char, kMaxSize> data;
+  };
+
+  // Storage for an optional lookup index. Without an index, finding a key scans
+  // every KeyDescriptor. The index is an open addressing hash table over key
+  // hashes. Its hashes are stored in a dense array, separately from the
+  // descriptor indices, so probes compare consecutive words.
+  //
+  // slot_hashes and slot_entries must have the same size, which must be a power
+  // of two larger than the maximum number of entries. key_prefixes and
+  // sorted_entries must have one element per entry. sorted_entries lists
+  // descriptor indices in key order, for prefix scans.
+  struct Index {
+    std::span<uint32_t> slot_hashes;
+    std::span<uint16_t> slot_entries;
+    std::span<KeyPrefix> key_prefixes;
+    std::span<uint16_t> sorted_entries;
+  };
+
+  // Statically allocated storage for an Index. IndexBuffer<0> has no storage
+  // and disables the index.
+  template <size_t kMaxEntries>
+  class IndexBuffer {
+   public:
+    constexpr IndexBuffer()
+        : slot_hashes_{}, slot_entries_{}, prefixes_{}, sorted_entries_{} {}
+
+    // Static so that it may be used in a mem-initializer before the buffer
+    // member itself has been constructed.
+    static constexpr Index index(IndexBuffer& buffer) {
+      return {buffer.slot_hashes_,
+              buffer.slot_entries_,
+              buffer.prefixes_,
+              buffer.sorted_entries_};
+    }
+
+   private:
+    static_assert(kMaxEntries < 0xffffu,
+                  "Indexed EntryCaches support up to 65534 entries");
+
+    // Keep the table at most half full so that probe sequences stay short.
+    static constexpr size_t kSlots = [] {
+      size_t slots = 1;
+      while (slots < 2 * kMaxEntries) {
+        slots *= 2;
+      }
+      return slots;
+    }();
+
+    std::array<uint32_t, kSlots> slot_hashes_;
+    std::array<uint16_t, kSlots> slot_entries_;
+    std::array<KeyPrefix, kMaxEntries> prefixes_;
+    std::array<uint16_t, kMaxEntries> sorted_entries_;
+  };
+
   // The type to use for an address list with the specified number of entries
   // and redundancy. kRedundancy extra entries are added to make room for a
   // temporary list of entry addresses.
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
-  constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
+  constexpr EntryCache(KeyDescriptorList& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       Index index = {},
+                       KeyHash key_hash = KeyHash::kLegacy)
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        index_(index),
+        key_hash_(key_hash),
+        sorted_entries_count_(0) {}
+
+  // Hashes a key with the function selected for this cache.
+  uint32_t Hash(Key key) const { return internal::Hash(key, key_hash_); }
+
+  KeyHash key_hash() const { return key_hash_; }
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -166,22 +248,91 @@ class EntryCache {
   //                 key's hash collides with the hash for an existing
   //                 descriptor
   //
-  StatusWithSize Find(FlashPartition& partition,
-                      const Sectors& sectors,
-                      const EntryFormats& formats,
-                      Key key,
-                      EntryMetadata* metadata) const;
+  // If the EntryCache is indexed and the entry's key prefix is known, hash
+  // collisions are detected without reading flash, and keys that fit in the
+  // prefix are found without reading flash.
+  //
+  // If a key read from flash does not match, the entry's checksum is verified
+  // and its sector is marked corrupt if that fails. The checksum algorithm is
+  // shared, so verify_lock is held while doing this.
+  StatusWithSize Find(
+      FlashPartition& partition,
+      const Sectors& sectors,
+      const EntryFormats& formats,
+      Key key,
+      EntryMetadata* metadata,
+      sync::VirtualBasicLockable& verify_lock = sync::NoOpLock::Instance())
+      const;
+
+  // Finds the entries with keys that start with prefix in an indexed
+  // EntryCache. Returns their descriptor indices in key order, including
+  // tombstone entries. Entries added since the last call are first inserted
+  // into the sorted index, which reads their keys from flash; comparisons use
+  // cached key prefixes to avoid reading other keys when possible. Returns an
+  // empty span if the EntryCache is not indexed.
+  std::span<const uint16_t> FindPrefix(FlashPartition& partition,
+                                       const EntryFormats& formats,
+                                       Key prefix) const;
 
   // Adds a new descriptor to the descriptor list. The entry MUST be unique and
-  // the EntryCache must NOT be full!
-  EntryMetadata AddNew(const KeyDescriptor& descriptor, Address address) const;
+  // the EntryCache must NOT be full! If provided, the key's prefix is cached in
+  // indexed EntryCaches.
+  EntryMetadata AddNew(const KeyDescriptor& descriptor,
+                       Address address,
+                       Key key = {}) const;
 
   // Adds a new descriptor, overwrites an existing one, or adds an additional
   // redundant address to one. The sector size is included for checking that
   // redundant entries are in different sectors.
   Status AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                 Address address,
-                                size_t sector_size_bytes) const;
+                                size_t sector_size_bytes,
+                                Key key = {}) const;
+
+  // The raw KeyDescriptor fields and address lists of all entries, in the
+  // order expected by Restore. These are saved in KVS checkpoints.
+  std::array<std::span<const std::byte>, 3> descriptor_bytes() const {
+    return {std::as_bytes(descriptors_.key_hashes()),
+            std::as_bytes(descriptors_.transaction_ids()),
+            std::as_bytes(descriptors_.states())};
+  }
+  std::span<const std::byte> address_bytes() const {
+    return std::as_bytes(
+        std::span(addresses_, descriptors_.size() * redundancy_));
+  }
+
+  // Replaces the entries with entry_count entries read from saved
+  // descriptor_bytes() and address_bytes(). The read function is called once
+  // for each buffer, in order. The entry_count must not exceed max_entries().
+  // If reading fails, the EntryCache is cleared.
+  template <typename ReadFunction>
+  Status Restore(size_t entry_count, ReadFunction&& read) const {
+    Reset();
+    descriptors_.resize(entry_count);
+
+    const std::span<std::byte> buffers[] = {
+        std::as_writable_bytes(descriptors_.key_hashes()),
+        std::as_writable_bytes(descriptors_.transaction_ids()),
+        std::as_writable_bytes(descriptors_.states()),
+        std::as_writable_bytes(
+            std::span(addresses_, descriptors_.size() * redundancy_)),
+    };
+
+    Status status = OkStatus();
+    for (size_t i = 0; status.ok() && i < std::size(buffers); ++i) {
+      status = read(buffers[i]);
+    }
+    if (!status.ok()) {
+      Reset();
+      return status;
+    }
+
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+      AddToIndex(i);
+      SetKeyPrefix(i, {});
+    }
+    return OkStatus();
+  }
 
   // Returns a pointer to an array of redundancy() addresses for temporary use.
   // This is used by the KeyValueStore to track reserved addresses when finding
@@ -205,15 +356,49 @@ class EntryCache {
   // The maximum number of entries supported by this EntryCache.
   size_t max_entries() const { return descriptors_.max_size(); }
 
-  iterator begin() const { return {this, descriptors_.begin()}; }
-  const_iterator cbegin() const { return {this, descriptors_.begin()}; }
+  // True if this EntryCache has a lookup index.
+  bool indexed() const { return !index_.slot_entries.empty(); }
+
+  iterator begin() const { return {this, 0}; }
+  const_iterator cbegin() const { return {this, 0}; }
 
-  iterator end() const { return {this, descriptors_.end()}; }
-  const_iterator cend() const { return {this, descriptors_.end()}; }
+  iterator end() const { return {this, descriptors_.size()}; }
+  const_iterator cend() const { return {this, descriptors_.size()}; }
+
+  // Returns an iterator to the entry at the descriptor index.
+  const_iterator at(size_t descriptor_index) const {
+    return {this, descriptor_index};
+  }
 
  private:
   int FindIndex(uint32_t key_hash) const;
 
+  // Adds the descriptor at the specified index to the lookup index.
+  void AddToIndex(size_t descriptor_index) const;
+
+  // Caches the key's prefix for the descriptor, if the EntryCache is indexed.
+  void SetKeyPrefix(size_t descriptor_index, Key key) const;
+
+  // Returns the cached key prefix for the descriptor or nullptr if unknown.
+  const KeyPrefix* key_prefix(size_t descriptor_index) const;
+
+  // Compares the descriptor's key with key, like std::string_view::compare. If
+  // prefix is true, only the first key.size() characters of the descriptor's
+  // key are compared. Reads the descriptor's key from flash unless the cached
+  // key prefix decides the comparison.
+  int CompareKey(FlashPartition& partition,
+                 const EntryFormats& formats,
+                 size_t descriptor_index,
+                 Key key,
+                 bool prefix) const;
+
+  // Reads the descriptor's key from any of its addresses. Returns an empty key
+  // if none of them can be read.
+  Key ReadKey(FlashPartition& partition,
+              const EntryFormats& formats,
+              size_t descriptor_index,
+              Entry::KeyBuffer& buffer) const;
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -227,9 +412,22 @@ class EntryCache {
 
   Address* ResetAddresses(size_t descriptor_index, Address address) const;
 
-  Vector<KeyDescriptor>& descriptors_;
+  KeyDescriptorList& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const Index index_;
+  const KeyHash key_hash_;
+
+  // The number of descriptors, starting from the first, that are in
+  // index_.sorted_entries. Descriptors are only appended, so newer descriptors
+  // are inserted by FindPrefix.
+  mutable size_t sorted_entries_count_;
+};
+
+template <>
+class EntryCache::IndexBuffer<0> {
+ public:
+  static constexpr Index index(IndexBuffer&) { return {}; }
 };
 
 }  // namespace internal
@@ -14,19 +14,33 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
+#include "pw_kvs/format.h"
 #include "pw_kvs/key.h"
+#include "pw_preprocessor/compiler.h"
 
 namespace pw {
 namespace kvs {
 namespace internal {
 
-// The hash function used to hash keys.
-constexpr uint32_t Hash(Key string) {
+// Assembles up to four key bytes, starting at index, into a little-endian word.
+// Compilers reduce this to a single load when they can.
+constexpr uint32_t LoadKeyWord(Key key, size_t index, size_t count) {
+  uint32_t word = 0;
+  for (size_t i = 0; i < count; ++i) {
+    word |= uint32_t(static_cast<uint8_t>(key[index + i])) << (8 * i);
+  }
+  return word;
+}
+
+// The byte-at-a-time hash used by KeyHash::kLegacy.
+constexpr uint32_t LegacyHash(Key key)
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
   uint32_t hash = 0;
   uint32_t coefficient = 65599u;
 
-  for (char ch : string) {
+  for (char ch : key) {
     hash += coefficient * uint32_t(ch);
     coefficient *= 65599u;
   }
@@ -34,6 +48,41 @@ constexpr uint32_t Hash(Key string) {
   return hash;
 }
 
+// The hash used by KeyHash::kWordAtATime. Keys are hashed four bytes at a time
+// with one multiply per word, so long keys hash several times faster than with
+// LegacyHash. The final mixing step spreads all bits of the key into the low
+// bits of the hash, which select entry cache index slots.
+constexpr uint32_t WordHash(Key key)
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
+  constexpr uint32_t kMultiplier = 0x9e3779b1u;  // 2^32 / golden ratio
+
+  uint32_t hash = static_cast<uint32_t>(key.size()) * kMultiplier;
+
+  size_t index = 0;
+  for (; key.size() - index >= 4; index += 4) {
+    hash = ((hash << 5 | hash >> 27) ^ LoadKeyWord(key, index, 4)) *
+           kMultiplier;
+  }
+  if (index < key.size()) {
+    hash = ((hash << 5 | hash >> 27) ^
+            LoadKeyWord(key, index, key.size() - index)) *
+           kMultiplier;
+  }
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+// Hashes a key with the selected function. Checkpoints store key hashes along
+// with the KeyHash that produced them. Changing either function requires
+// bumping kCheckpointVersion in key_value_store.cc so that Init() ignores
+// checkpoints holding hashes from the old function.
+constexpr uint32_t Hash(Key key, KeyHash function) {
+  return function == KeyHash::kWordAtATime ? WordHash(key) : LegacyHash(key);
+}
+
 }  // namespace internal
 }  // namespace kvs
 }  // namespace pw
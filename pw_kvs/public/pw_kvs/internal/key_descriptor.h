@@ -13,7 +13,9 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 namespace pw {
 namespace kvs {
@@ -30,6 +32,96 @@ struct KeyDescriptor {
   EntryState state;  // TODO: Pack into transaction ID? or something?
 };
 
+// A list of KeyDescriptors, stored as a separate array for each field. Key
+// hashes are contiguous, so lookups compare consecutive words, and no padding
+// is stored between fields. Each entry takes kBytesPerEntry bytes, rather than
+// sizeof(KeyDescriptor).
+//
+// Like Vector<T>, the list does not own its storage; declare a
+// KeyDescriptorBuffer to allocate it.
+class KeyDescriptorList {
+ public:
+  static constexpr size_t kBytesPerEntry =
+      2 * sizeof(uint32_t) + sizeof(EntryState);
+
+  KeyDescriptorList(const KeyDescriptorList&) = delete;
+  KeyDescriptorList& operator=(const KeyDescriptorList&) = delete;
+
+  KeyDescriptor operator[](size_t index) const {
+    return {key_hashes_[index], transaction_ids_[index], states_[index]};
+  }
+
+  uint32_t key_hash(size_t index) const { return key_hashes_[index]; }
+  uint32_t transaction_id(size_t index) const {
+    return transaction_ids_[index];
+  }
+  EntryState state(size_t index) const { return states_[index]; }
+
+  // Replaces the descriptor at the index, which must be less than size().
+  void set(size_t index, const KeyDescriptor& descriptor) {
+    key_hashes_[index] = descriptor.key_hash;
+    transaction_ids_[index] = descriptor.transaction_id;
+    states_[index] = descriptor.state;
+  }
+
+  // Appends a descriptor. The list MUST NOT be full.
+  void push_back(const KeyDescriptor& descriptor) {
+    size_ += 1;
+    set(size_ - 1, descriptor);
+  }
+
+  // Changes the size without initializing any new descriptors. The size MUST
+  // NOT exceed max_size().
+  void resize(size_t new_size) { size_ = new_size; }
+
+  void clear() { size_ = 0; }
+
+  // The fields of each descriptor in the list.
+  std::span<uint32_t> key_hashes() const { return {key_hashes_, size_}; }
+  std::span<uint32_t> transaction_ids() const {
+    return {transaction_ids_, size_};
+  }
+  std::span<EntryState> states() const { return {states_, size_}; }
+
+  size_t size() const { return size_; }
+  size_t max_size() const { return max_size_; }
+  bool full() const { return size_ == max_size_; }
+
+ protected:
+  constexpr KeyDescriptorList(uint32_t* key_hashes,
+                              uint32_t* transaction_ids,
+                              EntryState* states,
+                              size_t max_size)
+      : key_hashes_(key_hashes),
+        transaction_ids_(transaction_ids),
+        states_(states),
+        max_size_(max_size),
+        size_(0) {}
+
+ private:
+  uint32_t* const key_hashes_;
+  uint32_t* const transaction_ids_;
+  EntryState* const states_;
+  const size_t max_size_;
+  size_t size_;
+};
+
+// Statically allocated storage for a KeyDescriptorList.
+template <size_t kMaxEntries>
+class KeyDescriptorBuffer : public KeyDescriptorList {
+ public:
+  constexpr KeyDescriptorBuffer()
+      : KeyDescriptorList(key_hashes_, transaction_ids_, states_, kMaxEntries),
+        key_hashes_{},
+        transaction_ids_{},
+        states_{} {}
+
+ private:
+  uint32_t key_hashes_[kMaxEntries];
+  uint32_t transaction_ids_[kMaxEntries];
+  EntryState states_[kMaxEntries];
+};
+
 }  // namespace internal
 }  // namespace kvs
 }  // namespace pw
@@ -159,6 +159,8 @@ class Sectors {
   // Finds either an existing sector with enough space that is not the sector to
   // skip, or an empty sector. Maintains the invariant that there is always at
   // least 1 empty sector. Addresses in reserved_addresses are avoided.
+  // If the partition tracks erase counts, the least erased empty sector is
+  // used.
   Status FindSpace(SectorDescriptor** found_sector,
                    size_t size,
                    std::span<const Address> reserved_addresses) {
@@ -181,6 +183,10 @@ class Sectors {
 
   // Finds a sector that is ready to be garbage collected. Returns nullptr if no
   // sectors can / need to be garbage collected.
+  //
+  // If the partition tracks erase counts, sectors are selected with a
+  // cost-benefit policy that favors sectors with more recoverable bytes, fewer
+  // valid bytes to relocate, and fewer erases.
   SectorDescriptor* FindSectorToGarbageCollect(
       std::span<const Address> reserved_addresses) const;
 
@@ -217,6 +223,18 @@ class Sectors {
 
   SectorDescriptor& WearLeveledSectorFromIndex(size_t idx) const;
 
+  // Returns the erase count of each sector, or an empty span if the partition
+  // does not track erases for all of its sectors.
+  std::span<const size_t> EraseCounts() const;
+
+  // Returns true if sector a would be a better garbage collection victim than
+  // sector b, weighing the bytes recovered against the bytes relocated and
+  // the wear on each sector.
+  bool BetterGarbageCollectionCandidate(const SectorDescriptor& a,
+                                        const SectorDescriptor& b,
+                                        std::span<const size_t> erase_counts,
+                                        size_t max_erase_count) const;
+
   Vector<SectorDescriptor>& descriptors_;
   FlashPartition& partition_;
 
@@ -0,0 +1,125 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/key.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// A small cache of recently read values, so that repeated reads of the same
+// keys do not read flash. Each slot holds one key and its value. When all slots
+// are in use, the least recently used slot is replaced.
+//
+// The cache does not know when values change; the KVS must invalidate a key
+// before writing a new entry for it.
+class ValueCache {
+ public:
+  struct Slot {
+    uint32_t key_hash;
+    uint32_t last_used;
+
+    // Size of the key, or 0 if the slot is empty.
+    uint16_t key_size;
+    uint16_t value_size;
+  };
+
+  // Storage for the cache. data holds the key and value of each slot, so its
+  // size must be a multiple of the number of slots.
+  struct Storage {
+    std::span<Slot> slots;
+    std::span<std::byte> data;
+  };
+
+  // Statically allocated storage for a ValueCache. Values are cached if their
+  // key and value together fit in kSlotSizeBytes. Buffer<0, ...> has no storage
+  // and disables the cache.
+  template <size_t kSlots, size_t kSlotSizeBytes>
+  class Buffer {
+   public:
+    constexpr Buffer() : slots_{}, data_{} {}
+
+    // Static so that it may be used in a mem-initializer before the buffer
+    // member itself has been constructed.
+    static constexpr Storage storage(Buffer& buffer) {
+      return {buffer.slots_, buffer.data_};
+    }
+
+   private:
+    static_assert(kSlotSizeBytes <= 0xffffu,
+                  "Cached values must be smaller than 64 KB");
+
+    std::array<Slot, kSlots> slots_;
+    std::array<std::byte, kSlots * kSlotSizeBytes> data_;
+  };
+
+  constexpr ValueCache(Storage storage)
+      : slots_(storage.slots),
+        data_(storage.data),
+        slot_size_(slots_.empty() ? 0 : data_.size() / slots_.size()),
+        clock_(0) {}
+
+  // Empties the cache.
+  void Reset();
+
+  // Reads a cached value, with the same results as reading the value from the
+  // entry. Returns NOT_FOUND if the key is not cached.
+  //
+  //                    OK: the value was read
+  //             NOT_FOUND: the key is not in the cache
+  //          OUT_OF_RANGE: offset_bytes is larger than the value
+  //    RESOURCE_EXHAUSTED: the buffer could not fit the rest of the value, but
+  //                        as many bytes as possible were written to it
+  //
+  StatusWithSize Get(Key key, std::span<std::byte> buffer, size_t offset_bytes);
+
+  // Returns the size of a cached value, or NOT_FOUND if it is not cached.
+  StatusWithSize ValueSize(Key key);
+
+  // Adds a key and value to the cache, replacing the least recently used slot
+  // if needed. Does nothing if they do not fit in a slot.
+  void Add(Key key, std::span<const std::byte> value);
+
+  // Removes a key from the cache, if it is present.
+  void Invalidate(Key key);
+
+  // True if the cache has any slots.
+  bool enabled() const { return !slots_.empty(); }
+
+ private:
+  // Returns the slot that holds this key, or nullptr if it is not cached.
+  Slot* Find(Key key);
+
+  std::byte* slot_data(const Slot& slot) {
+    return data_.data() + (&slot - slots_.data()) * slot_size_;
+  }
+
+  std::span<Slot> slots_;
+  std::span<std::byte> data_;
+  size_t slot_size_;
+
+  // Incremented on every access to order slots by last use.
+  uint32_t clock_;
+};
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
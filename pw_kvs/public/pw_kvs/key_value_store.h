@@ -28,13 +28,18 @@
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
+#include "pw_kvs/internal/value_cache.h"
 #include "pw_kvs/key.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/virtual_basic_lockable.h"
 
 namespace pw {
 namespace kvs {
 
+class ThreadSafeKeyValueStore;
+
 enum class GargbageCollectOnWrite {
   // Disable all automatic garbage collection on write.
   kDisabled,
@@ -78,6 +83,16 @@ struct Options {
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // Write a checkpoint of the KVS's in-memory state at the end of
+  // FullMaintenance and HeavyMaintenance, and load it in Init. Init then only
+  // reads the entries written after the checkpoint, rather than every entry in
+  // the partition.
+  bool checkpoint = false;
+
+  // The function used to hash keys. Keep kLegacy for partitions that have
+  // already been written; see KeyHash.
+  KeyHash key_hash = KeyHash::kLegacy;
 };
 
 class KeyValueStore {
@@ -133,6 +148,25 @@ class KeyValueStore {
     return FixedSizeGet(key, pointer, sizeof(T));
   }
 
+  // Writes the value of an entry to a stream, so that large values need not be
+  // read into RAM all at once. The value is read from flash through a small
+  // buffer, or written directly from memory-mapped flash. Returns the number of
+  // bytes written to the stream.
+  //
+  // If verify_on_read is set, the checksum is calculated as the value is read
+  // and checked after it is written. A corrupt value is therefore written to
+  // the stream before DATA_LOSS is returned, and callers must discard it.
+  //
+  //                    OK: the entire value was written to the stream
+  //             NOT_FOUND: the key is not present in the KVS
+  //             DATA_LOSS: found the entry, but the data was corrupted
+  //         UNIMPLEMENTED: the value is stored compressed
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: key is empty or too long
+  //
+  // Other errors from the stream are returned as is.
+  StatusWithSize Get(Key key, stream::Writer& writer) const;
+
   // Adds a key-value entry to the KVS. If the key was already present, its
   // value is overwritten.
   //
@@ -163,6 +197,20 @@ class KeyValueStore {
     return PutBytes(key, std::as_bytes(std::span<const T>(&value, 1)));
   }
 
+  // Adds a key-value entry with a value_size-byte value read from a stream. The
+  // value is written to flash as it is read, through a small buffer, with its
+  // checksum calculated on the fly. Values written from a stream are never
+  // compressed, and are always written even if they match the prior value.
+  //
+  // Returns the same errors as Put, as well as:
+  //
+  //   OUT_OF_RANGE: the stream ended before value_size bytes were read
+  //
+  // Other errors from the stream are returned as is. If the stream fails after
+  // part of the entry was written, the sector is marked corrupt, just as if the
+  // flash write had failed.
+  Status Put(Key key, stream::Reader& reader, size_t value_size);
+
   // Removes a key-value entry from the KVS.
   //
   //                    OK: the entry was successfully added or updated
@@ -174,6 +222,105 @@ class KeyValueStore {
   //
   Status Delete(Key key);
 
+  // A set of puts and deletes that are committed to the KVS together. Batches
+  // are declared as instances of KeyValueStore::BatchBuffer<kMaxOperations>.
+  //
+  // A batch references its keys and values; they are not copied. The keys and
+  // values must remain valid until the batch is committed or cleared.
+  class Batch {
+   public:
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    // Stages a put of the key and value, which may be a std::span of bytes or
+    // a trivially copyable object. Returns RESOURCE_EXHAUSTED if the batch is
+    // full. The key and value are checked when the batch is committed.
+    template <typename T,
+              typename std::enable_if_t<ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      return Add(key, std::as_bytes(internal::make_span(value)), false);
+    }
+
+    template <typename T,
+              typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      CheckThatObjectCanBePutOrGet<T>();
+      return Add(key, std::as_bytes(std::span<const T>(&value, 1)), false);
+    }
+
+    // Stages a delete of the key. Returns RESOURCE_EXHAUSTED if the batch is
+    // full.
+    Status Delete(Key key) { return Add(key, {}, true); }
+
+    // Removes all staged operations.
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    size_t max_size() const { return operations_.size(); }
+    bool empty() const { return size_ == 0u; }
+
+   protected:
+    struct Operation {
+      Key key;
+      std::span<const std::byte> value;
+      bool deleted;
+    };
+
+    constexpr Batch(std::span<Operation> operations)
+        : operations_(operations), size_(0) {}
+
+   private:
+    friend class KeyValueStore;
+
+    Status Add(Key key, std::span<const std::byte> value, bool deleted);
+
+    std::span<const Operation> operations() const {
+      return operations_.first(size_);
+    }
+
+    const std::span<Operation> operations_;
+    size_t size_;
+  };
+
+  template <size_t kMaxOperations>
+  class BatchBuffer : public Batch {
+   public:
+    constexpr BatchBuffer() : Batch(operations_) {}
+
+   private:
+    static_assert(kMaxOperations > 0u);
+
+    std::array<Operation, kMaxOperations> operations_;
+  };
+
+  // Writes all of the operations in a batch to flash, in order. Each operation
+  // behaves like a call to Put or Delete. If a key appears more than once, the
+  // last operation for the key wins.
+  //
+  // The batch is all-or-nothing. Every operation is checked before anything is
+  // written, and any garbage collection needed to make room for the batch is
+  // done up front. If the batch fails partway through or is interrupted by a
+  // reboot, the KVS is rolled back to its state before the batch; after a
+  // reboot, this happens in Init. Committing a batch of N operations writes
+  // N + 2 entries: the operations and two reserved markers, which take two of
+  // the KVS's entries the first time a batch is committed.
+  //
+  //                    OK: all operations were successfully written
+  //             NOT_FOUND: a deleted key is not present in the KVS; nothing
+  //                        was written
+  //    RESOURCE_EXHAUSTED: there is not enough space for the batch; nothing
+  //                        was written or the KVS was rolled back
+  //        ALREADY_EXISTS: a key's hash collides with a different key in the
+  //                        KVS; nothing was written
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: a key is empty or too long or a value is too large;
+  //                        nothing was written
+  //
+  // Other errors are from flash operations that failed while writing the batch.
+  // In that case, the KVS is rolled back if possible. If the rollback could not
+  // be completed, the KVS needs maintenance, which completes the rollback.
+  Status Commit(const Batch& batch);
+
   // Returns the size of the value corresponding to the key.
   //
   //                    OK: the size was returned successfully
@@ -212,10 +359,32 @@ class KeyValueStore {
   // that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  // Performs a bounded step of garbage collection. Garbage collecting a sector
+  // relocates its valid entries and erases it, which can take hundreds of
+  // milliseconds. This splits that work across calls: each call either
+  // relocates up to max_relocations entries out of the sector being collected,
+  // or erases the sector once it has no valid entries. Call this when the
+  // system is idle, such as from a pw::work_queue::WorkQueue or an idle hook,
+  // so that Put rarely needs to garbage collect.
+  //
+  // Sectors without valid entries are always collected. Sectors with valid
+  // entries are only collected while there is less than one sector of writable
+  // space, not counting the sector that is always kept free. Unlike
+  // PartialMaintenance, this does not repair errors.
+  //
+  //                    OK: a step was done; call again to continue
+  //             NOT_FOUND: no garbage collection is needed
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //
+  // Other errors are from flash operations. The KVS remains usable after an
+  // error, and later calls resume garbage collection.
+  Status IncrementalGarbageCollect(size_t max_relocations = 1);
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
   class iterator;
+  class prefix_iterator;
 
   class Item {
    public:
@@ -243,6 +412,7 @@ class KeyValueStore {
 
    private:
     friend class iterator;
+    friend class prefix_iterator;
 
     constexpr Item(const KeyValueStore& kvs,
                    const internal::EntryCache::const_iterator& item_iterator)
@@ -302,6 +472,81 @@ class KeyValueStore {
   iterator begin() const;
   iterator end() const { return iterator(*this, entry_cache_.end()); }
 
+  // Iterates over the keys that start with a prefix. See WithPrefix.
+  class prefix_iterator {
+   public:
+    prefix_iterator& operator++();
+
+    prefix_iterator operator++(int) {
+      const prefix_iterator original = *this;
+      operator++();
+      return original;
+    }
+
+    // Reads the entry's key from flash.
+    const Item& operator*() {
+      item_.ReadKey();
+      return item_;
+    }
+
+    const Item* operator->() { return &operator*(); }
+
+    constexpr bool operator==(const prefix_iterator& rhs) const {
+      return position_ == rhs.position_;
+    }
+
+    constexpr bool operator!=(const prefix_iterator& rhs) const {
+      return position_ != rhs.position_;
+    }
+
+   private:
+    friend class KeyValueStore;
+
+    prefix_iterator(const KeyValueStore& kvs,
+                    Key prefix,
+                    std::span<const uint16_t> sorted_entries,
+                    size_t position);
+
+    // Moves to the first valid entry with a matching key at or after the
+    // current position.
+    void SkipNonMatching();
+
+    size_t end_position() const;
+
+    Item item_;
+    Key prefix_;
+    std::span<const uint16_t> sorted_entries_;
+    size_t position_;
+  };
+
+  class PrefixRange {
+   public:
+    prefix_iterator begin() const { return begin_; }
+    prefix_iterator end() const { return end_; }
+
+   private:
+    friend class KeyValueStore;
+
+    PrefixRange(const prefix_iterator& begin, const prefix_iterator& end)
+        : begin_(begin), end_(end) {}
+
+    prefix_iterator begin_;
+    prefix_iterator end_;
+  };
+
+  // Returns a range of the keys that start with prefix. An empty prefix
+  // matches every key.
+  //
+  // In an indexed KVS (kIndexed is true), keys are visited in sorted order, and
+  // keys that do not match are skipped without reading them from flash. Keys
+  // added since the previous scan are first inserted into the sorted index,
+  // which reads O(log n) keys each. Otherwise, keys are visited in the same
+  // order as begin(), and every key is read from flash.
+  //
+  // The prefix must remain valid while the range is used. Adding keys to the
+  // KVS invalidates the range.
+  PrefixRange WithPrefix(Key prefix) const;
+
   // Returns the number of valid entries in the KeyValueStore.
   size_t size() const { return entry_cache_.present_entries(); }
 
@@ -350,6 +595,7 @@ class KeyValueStore {
   using Address = FlashPartition::Address;
   using Entry = internal::Entry;
   using KeyDescriptor = internal::KeyDescriptor;
+  using KeyDescriptorList = internal::KeyDescriptorList;
   using SectorDescriptor = internal::SectorDescriptor;
 
   // In the future, will be able to provide additional EntryFormats for
@@ -360,10 +606,14 @@ class KeyValueStore {
                 size_t redundancy,
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
-                Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                KeyDescriptorList& key_descriptor_list,
+                Address* addresses,
+                internal::EntryCache::Index index = {},
+                internal::ValueCache::Storage value_cache = {});
 
  private:
+  friend class ThreadSafeKeyValueStore;
+
   using EntryMetadata = internal::EntryMetadata;
   using EntryState = internal::EntryState;
 
@@ -378,7 +628,25 @@ class KeyValueStore {
   }
 
   Status InitializeMetadata();
-  Status LoadEntry(Address entry_address, Address* next_entry_address);
+
+  // Finds the checkpoint at the start of a sector and restores the entry cache
+  // and the sectors' writable bytes from it. Fails if there is not exactly one
+  // valid checkpoint or if it does not match this KVS's configuration.
+  Status LoadCheckpoint();
+
+  // Writes a checkpoint to an empty sector, if it fits and there is no
+  // checkpoint already.
+  Status WriteCheckpoint();
+
+  Status LoadEntry(Address entry_address,
+                   Address* next_entry_address,
+                   uint32_t max_transaction_id);
+  // Returns true if the space after an erased entry header was written, which
+  // happens if a write from a stream, which writes its header last, was
+  // interrupted.
+  bool StreamWriteInterrupted(const SectorDescriptor& sector,
+                              Address entry_address) const;
+
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
                       Address* next_entry_address);
@@ -426,18 +694,51 @@ class KeyValueStore {
   Status CheckWriteOperation(Key key) const;
   Status CheckReadOperation(Key key) const;
 
+  // If `compressed` is true, `value` was compressed with the primary format's
+  // codec.
   Status WriteEntryForExistingKey(EntryMetadata& metadata,
                                   EntryState new_state,
                                   Key key,
-                                  std::span<const std::byte> value);
+                                  std::span<const std::byte> value,
+                                  bool compressed = false);
+
+  Status WriteEntryForNewKey(Key key,
+                             std::span<const std::byte> value,
+                             bool compressed = false);
+
+  // Writes an entry with a value read from a stream. The first copy is written
+  // from the stream, and any others are copied from it.
+  Status WriteStreamEntry(Key key,
+                          stream::Reader& reader,
+                          size_t value_size,
+                          EntryMetadata* prior_metadata,
+                          size_t prior_size);
+
+  Status CheckBatch(const Batch& batch, size_t* write_size);
 
-  Status WriteEntryForNewKey(Key key, std::span<const std::byte> value);
+  Status ReserveSpaceForBatch(size_t write_size);
+
+  // Writes a tombstone for one of the reserved batch marker keys.
+  Status WriteBatchMarker(Key marker);
+
+  // Returns the transaction ID of a batch marker, or 0 if it is not present.
+  uint32_t BatchMarkerTransactionId(Key marker) const;
 
   Status WriteEntry(Key key,
                     std::span<const std::byte> value,
                     EntryState new_state,
                     EntryMetadata* prior_metadata = nullptr,
-                    const internal::Entry* prior_entry = nullptr);
+                    const internal::Entry* prior_entry = nullptr,
+                    bool compressed = false);
+
+  bool CanWriteCopiesConcurrently(std::span<const Address> addresses) const;
+
+  Status WriteEntryCopies(Entry& entry,
+                          std::span<const Address> addresses,
+                          Key key,
+                          std::span<const std::byte> value,
+                          EntryMetadata* prior_metadata,
+                          size_t prior_size);
 
   EntryMetadata CreateOrUpdateKeyDescriptor(const Entry& new_entry,
                                             Key key,
@@ -461,6 +762,8 @@ class KeyValueStore {
                      Key key,
                      std::span<const std::byte> value);
 
+  Status FinishAppendEntry(const Entry& entry, StatusWithSize result);
+
   StatusWithSize CopyEntryToSector(Entry& entry,
                                    SectorDescriptor* new_sector,
                                    Address new_address);
@@ -496,6 +799,9 @@ class KeyValueStore {
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               std::span<const Address> reserved_addresses);
 
+  // Selects a sector for IncrementalGarbageCollect, or returns nullptr.
+  SectorDescriptor* FindSectorForIncrementalGarbageCollect();
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -506,6 +812,8 @@ class KeyValueStore {
 
   Status RepairCorruptSectors();
 
+  Status FinishBatchRollback();
+
   Status EnsureFreeSectorExists();
 
   Status EnsureEntryRedundancy();
@@ -517,7 +825,8 @@ class KeyValueStore {
   internal::Entry CreateEntry(Address address,
                               Key key,
                               std::span<const std::byte> value,
-                              EntryState state);
+                              EntryState state,
+                              bool compressed);
 
   void LogSectors() const;
   void LogKeyDescriptor() const;
@@ -528,10 +837,17 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors. Finding a key requires scanning (or a
+  // lookup in the optional index) and verifying a match by reading the actual
+  // entry.
   internal::EntryCache entry_cache_;
 
+  // Optional cache of recently read values. Get is const, so the cache is
+  // mutable. Keys are invalidated before any new entry is written for them.
+  // Relocating entries during garbage collection does not change their values,
+  // so it does not affect the cache.
+  mutable internal::ValueCache value_cache_;
+
   Options options_;
 
   // Threshold value for when to garbage collect all stale data. Above the
@@ -558,6 +874,13 @@ class KeyValueStore {
   // make it mutable.
   mutable bool error_detected_;
 
+  // Guards the state that const functions update: the value cache, the sorted
+  // key index used by WithPrefix, error flags, and the checksum algorithms,
+  // which keep their state between calls. This is a no-op lock unless
+  // the KVS is wrapped by a ThreadSafeKeyValueStore, which lets several readers
+  // call const functions at once.
+  sync::VirtualBasicLockable* read_state_lock_;
+
   struct InternalStats {
     size_t sector_erase_count;
     size_t corrupt_sectors_recovered;
@@ -566,12 +889,46 @@ class KeyValueStore {
   InternalStats internal_stats_;
 
   uint32_t last_transaction_id_;
+
+  // Set while a batch is written. Garbage collection is disabled so prior
+  // values of the batch's keys remain in flash until the batch is complete.
+  bool batch_in_progress_;
+
+  // Set if Init found an interrupted batch. The batch's entries are not loaded,
+  // but remain in flash until FixErrors removes them.
+  bool batch_rollback_pending_;
+
+  // The sector that IncrementalGarbageCollect is collecting, if any. No entries
+  // are written to this sector until it is erased.
+  SectorDescriptor* incremental_gc_sector_;
+
+  // The sector that holds the checkpoint, if any. Init trusts the checkpoint
+  // only while no sector has been erased since it was written, so this sector
+  // is always garbage collected before any other. The checkpoint's bytes are
+  // counted as valid until its sector is collected.
+  SectorDescriptor* checkpoint_sector_;
+  size_t checkpoint_size_bytes_;
 };
 
+// Allocates storage for a KeyValueStore.
+//
+// If kIndexed is true, the KVS keeps a hash index of its keys and caches a
+// short prefix of each key in RAM. Lookups take constant time instead of
+// scanning every key, and hash collisions and short keys are resolved without
+// reading flash. This is recommended for KVSs with many keys. The index costs
+// 20 to 32 bytes of RAM per entry.
+//
+// If kCachedValues is nonzero, the KVS keeps the kCachedValues most recently
+// read values in RAM, so reading them again does not read flash. A value is
+// cached if its key and value together fit in kCachedValueSizeBytes. The cache
+// uses kCachedValues * (kCachedValueSizeBytes + 12) bytes of RAM.
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          bool kIndexed = false,
+          size_t kCachedValues = 0,
+          size_t kCachedValueSizeBytes = 64>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -600,7 +957,9 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       sectors_,
                       temp_sectors_to_skip_,
                       key_descriptors_,
-                      addresses_) {
+                      addresses_,
+                      decltype(index_)::index(index_),
+                      decltype(value_cache_)::storage(value_cache_)) {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
 
@@ -621,7 +980,7 @@ class KeyValueStoreBuffer : public KeyValueStore {
   const SectorDescriptor* temp_sectors_to_skip_[2 * kRedundancy - 1];
 
   // KeyDescriptors for use by the KVS's EntryCache.
-  Vector<KeyDescriptor, kMaxEntries> key_descriptors_;
+  internal::KeyDescriptorBuffer<kMaxEntries> key_descriptors_;
 
   // An array of addresses associated with the KeyDescriptors for use with the
   // EntryCache. To support having KeyValueStores with different redundancies,
@@ -629,6 +988,13 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Optional hash index and key prefix cache for the EntryCache.
+  internal::EntryCache::IndexBuffer<kIndexed ? kMaxEntries : 0> index_;
+
+  // Optional cache of recently read values.
+  internal::ValueCache::Buffer<kCachedValues, kCachedValueSizeBytes>
+      value_cache_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
@@ -0,0 +1,202 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <type_traits>
+
+#include "pw_kvs/key.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/shared_mutex.h"
+
+namespace pw {
+namespace kvs {
+
+// Wraps a KeyValueStore so that it can be used from multiple threads. Reads
+// hold a pw::sync::SharedMutex for shared access, so any number of threads may
+// read at once. Writes and maintenance hold it for exclusive access. The
+// entry format's checksum algorithm is shared, so readers take turns verifying
+// checksums.
+//
+// Garbage collecting a sector can take hundreds of milliseconds, and a Put
+// that has to do it would block readers for that long. Before each write, this
+// runs IncrementalGarbageCollect steps until no garbage collection is needed,
+// releasing the lock between steps. Readers then wait for at most one step or
+// one write.
+//
+// While wrapped, the KeyValueStore must only be used through this class.
+class ThreadSafeKeyValueStore {
+ public:
+  // Shared access to the KeyValueStore, for iteration and other const
+  // functions that are not wrapped here. Writers are blocked while a
+  // ReadAccess exists, so keep it short lived.
+  class ReadAccess {
+   public:
+    ReadAccess(ReadAccess&&) = default;
+    ReadAccess(const ReadAccess&) = delete;
+    ReadAccess& operator=(const ReadAccess&) = delete;
+
+    const KeyValueStore* operator->() const { return &kvs_; }
+    const KeyValueStore& operator*() const { return kvs_; }
+
+   private:
+    friend class ThreadSafeKeyValueStore;
+
+    ReadAccess(const KeyValueStore& kvs, sync::SharedMutex& mutex)
+        : lock_(mutex), kvs_(kvs) {}
+
+    std::shared_lock<sync::SharedMutex> lock_;
+    const KeyValueStore& kvs_;
+  };
+
+  explicit ThreadSafeKeyValueStore(KeyValueStore& kvs) : kvs_(kvs) {
+    kvs_.read_state_lock_ = &read_state_mutex_;
+  }
+
+  ~ThreadSafeKeyValueStore() {
+    kvs_.read_state_lock_ = &sync::NoOpLock::Instance();
+  }
+
+  ThreadSafeKeyValueStore(const ThreadSafeKeyValueStore&) = delete;
+  ThreadSafeKeyValueStore& operator=(const ThreadSafeKeyValueStore&) = delete;
+
+  // See KeyValueStore for documentation of these functions.
+  Status Init() {
+    std::lock_guard lock(mutex_);
+    return kvs_.Init();
+  }
+
+  bool initialized() const {
+    std::shared_lock lock(mutex_);
+    return kvs_.initialized();
+  }
+
+  StatusWithSize Get(Key key,
+                     std::span<std::byte> value,
+                     size_t offset_bytes = 0) const {
+    std::shared_lock lock(mutex_);
+    return kvs_.Get(key, value, offset_bytes);
+  }
+
+  template <typename Pointer,
+            typename = std::enable_if_t<std::is_pointer<Pointer>::value>>
+  Status Get(const Key& key, const Pointer& pointer) const {
+    std::shared_lock lock(mutex_);
+    return kvs_.Get(key, pointer);
+  }
+
+  StatusWithSize Get(Key key, stream::Writer& writer) const {
+    std::shared_lock lock(mutex_);
+    return kvs_.Get(key, writer);
+  }
+
+  StatusWithSize ValueSize(Key key) const {
+    std::shared_lock lock(mutex_);
+    return kvs_.ValueSize(key);
+  }
+
+  template <typename T>
+  Status Put(const Key& key, const T& value) {
+    GarbageCollectBeforeWrite();
+    std::lock_guard lock(mutex_);
+    return kvs_.Put(key, value);
+  }
+
+  Status Put(Key key, stream::Reader& reader, size_t value_size) {
+    GarbageCollectBeforeWrite();
+    std::lock_guard lock(mutex_);
+    return kvs_.Put(key, reader, value_size);
+  }
+
+  Status Delete(Key key) {
+    GarbageCollectBeforeWrite();
+    std::lock_guard lock(mutex_);
+    return kvs_.Delete(key);
+  }
+
+  Status Commit(const KeyValueStore::Batch& batch) {
+    GarbageCollectBeforeWrite();
+    std::lock_guard lock(mutex_);
+    return kvs_.Commit(batch);
+  }
+
+  Status HeavyMaintenance() {
+    std::lock_guard lock(mutex_);
+    return kvs_.HeavyMaintenance();
+  }
+
+  Status FullMaintenance() {
+    std::lock_guard lock(mutex_);
+    return kvs_.FullMaintenance();
+  }
+
+  Status PartialMaintenance() {
+    std::lock_guard lock(mutex_);
+    return kvs_.PartialMaintenance();
+  }
+
+  Status IncrementalGarbageCollect(size_t max_relocations = 1) {
+    std::lock_guard lock(mutex_);
+    return kvs_.IncrementalGarbageCollect(max_relocations);
+  }
+
+  size_t size() const {
+    std::shared_lock lock(mutex_);
+    return kvs_.size();
+  }
+
+  size_t max_size() const { return kvs_.max_size(); }
+
+  bool empty() const { return size() == 0u; }
+
+  KeyValueStore::StorageStats GetStorageStats() const {
+    std::shared_lock lock(mutex_);
+    return kvs_.GetStorageStats();
+  }
+
+  bool error_detected() const {
+    std::shared_lock lock(mutex_);
+    return kvs_.error_detected();
+  }
+
+  // Blocks until shared access is available. Use this to iterate over the KVS
+  // or call WithPrefix.
+  ReadAccess acquire_shared() const { return ReadAccess(kvs_, mutex_); }
+
+ private:
+  // Runs garbage collection one bounded step at a time until none is needed,
+  // so that the write does not garbage collect while holding the lock.
+  void GarbageCollectBeforeWrite() {
+    while (true) {
+      std::lock_guard lock(mutex_);
+      if (!kvs_.IncrementalGarbageCollect().ok()) {
+        return;
+      }
+    }
+  }
+
+  KeyValueStore& kvs_;
+  mutable sync::SharedMutex mutex_;
+  sync::VirtualMutex read_state_mutex_;
+};
+
+}  // namespace kvs
+}  // namespace pw
@@ -0,0 +1,128 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/io.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+
+// A ValueCodec compresses KVS values. A KVS compresses values when the primary
+// EntryFormat has a codec, and stores them compressed if they shrink.
+//
+// A compressed value starts with its decompressed size as a 16-bit little
+// endian integer, followed by the codec's output. Compress() writes into a
+// buffer owned by the codec, so a codec must not be shared between KVS
+// instances that are written from different threads.
+class ValueCodec {
+ public:
+  static constexpr size_t kSizePrefixBytes = sizeof(uint16_t);
+
+  // Compresses a value into the codec's buffer. Returns the size of the
+  // compressed value, including the size prefix, which is in buffer().
+  //
+  //                    OK: the value was compressed
+  //    RESOURCE_EXHAUSTED: the compressed value does not fit in the buffer
+  //      INVALID_ARGUMENT: the value is too large to compress
+  //
+  StatusWithSize Compress(std::span<const std::byte> value);
+
+  // Reads the decompressed size of a compressed value from its size prefix.
+  static StatusWithSize ReadDecompressedSize(Input& compressed_value);
+
+  // Decompresses a `compressed_size` byte compressed value read from `input`
+  // into `output`. Returns the decompressed size or one of the following:
+  //
+  //    RESOURCE_EXHAUSTED: `output` was too small; it holds the start of the
+  //                        value and the size is the number of bytes written
+  //             DATA_LOSS: the compressed value is malformed
+  //
+  StatusWithSize Decompress(Input& input,
+                            size_t compressed_size,
+                            std::span<std::byte> output);
+
+  // The buffer that Compress() writes into.
+  std::span<const std::byte> buffer() const { return buffer_; }
+
+ protected:
+  constexpr ValueCodec(std::span<std::byte> buffer) : buffer_(buffer) {}
+
+  // Protected destructor prevents deleting ValueCodecs from the base class, so
+  // that it is safe to have a non-virtual destructor.
+  ~ValueCodec() = default;
+
+ private:
+  // Compresses `value` into `output`, returning RESOURCE_EXHAUSTED if it does
+  // not fit.
+  virtual StatusWithSize DoCompress(std::span<const std::byte> value,
+                                    std::span<std::byte> output) = 0;
+
+  // Decompresses `compressed_size` bytes from `input` into `output`, with the
+  // same return values as Decompress().
+  virtual StatusWithSize DoDecompress(Input& input,
+                                      size_t compressed_size,
+                                      std::span<std::byte> output) = 0;
+
+  std::span<std::byte> buffer_;
+};
+
+// A small LZ77 codec suited to text-like values such as JSON. The output is a
+// series of tokens. A token byte below 0x80 is followed by that many plus one
+// literal bytes. Otherwise, its low seven bits plus kMinMatchBytes are the
+// length of a copy from earlier in the value, at the distance given by the next
+// two bytes (little endian).
+//
+// Compression searches the previous kWindowBytes bytes for matches and uses no
+// memory beyond the stack. Decompression copies directly into the output.
+// Instantiate an LzValueCodecBuffer to use this codec.
+class LzValueCodec : public ValueCodec {
+ public:
+  static constexpr size_t kMinMatchBytes = 4;
+  static constexpr size_t kMaxMatchBytes = 0x7f + kMinMatchBytes;
+  static constexpr size_t kMaxLiteralBytes = 0x80;
+  static constexpr size_t kWindowBytes = 512;
+
+ protected:
+  constexpr LzValueCodec(std::span<std::byte> buffer) : ValueCodec(buffer) {}
+
+  ~LzValueCodec() = default;
+
+ private:
+  StatusWithSize DoCompress(std::span<const std::byte> value,
+                            std::span<std::byte> output) final;
+
+  StatusWithSize DoDecompress(Input& input,
+                              size_t compressed_size,
+                              std::span<std::byte> output) final;
+};
+
+// An LzValueCodec with a buffer for compressing values of up to about
+// kBufferSizeBytes bytes.
+template <size_t kBufferSizeBytes>
+class LzValueCodecBuffer final : public LzValueCodec {
+ public:
+  constexpr LzValueCodecBuffer() : LzValueCodec(buffer_), buffer_{} {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+}  // namespace kvs
+}  // namespace pw
@@ -30,8 +30,16 @@
 static_assert((PW_KVS_MAX_FLASH_ALIGNMENT >= 16UL),
               "Max flash alignment is required to be at least 16");
 
+// The maximum number of redundant copies of an entry that are written
+// concurrently, if the flash has banks that can be programmed at the same time.
+#ifndef PW_KVS_MAX_CONCURRENT_WRITES
+#define PW_KVS_MAX_CONCURRENT_WRITES 2UL
+#endif  // PW_KVS_MAX_CONCURRENT_WRITES
+
 namespace pw::kvs {
 
 inline constexpr size_t kMaxFlashAlignment = PW_KVS_MAX_FLASH_ALIGNMENT;
 
+inline constexpr size_t kMaxConcurrentWrites = PW_KVS_MAX_CONCURRENT_WRITES;
+
 }  // namespace pw::kvs
@@ -17,6 +17,9 @@
 
 #include "pw_kvs/internal/sectors.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include "pw_kvs_private/config.h"
 #include "pw_log/shorter.h"
 
@@ -38,8 +41,9 @@ Status Sectors::Find(FindMode find_mode,
                      size_t size,
                      std::span<const Address> addresses_to_skip,
                      std::span<const Address> reserved_addresses) {
-  SectorDescriptor* first_empty_sector = nullptr;
+  SectorDescriptor* empty_sector = nullptr;
   bool at_least_two_empty_sectors = (find_mode == kGarbageCollect);
+  const std::span<const size_t> erase_counts = EraseCounts();
 
   // Used for the GC reclaimable bytes check
   SectorDescriptor* non_empty_least_reclaimable_sector = nullptr;
@@ -90,6 +94,8 @@ Status Sectors::Find(FindMode find_mode,
   // Tier 2 is find sectors that are empty/erased. While scanning for a partial
   // sector, keep track of the first empty sector and if a second empty sector
   // was seen. If during GC then count the second empty sector as always seen.
+  // If the partition tracks erase counts, keep track of the least erased empty
+  // sector instead, with ties going to the first one found.
   //
   // Tier 3 is during garbage collection, find sectors with enough space that
   // are not empty but have recoverable bytes. Pick the sector with the least
@@ -122,23 +128,26 @@ Status Sectors::Find(FindMode find_mode,
     }
 
     if (sector->Empty(sector_size_bytes)) {
-      if (first_empty_sector == nullptr) {
-        first_empty_sector = sector;
+      if (empty_sector == nullptr) {
+        empty_sector = sector;
       } else {
         at_least_two_empty_sectors = true;
+        if (!erase_counts.empty() &&
+            erase_counts[Index(sector)] < erase_counts[Index(empty_sector)]) {
+          empty_sector = sector;
+        }
       }
     }
   }
 
   // Tier 2 check: If the scan for a partial sector does not find a suitable
-  // sector, use the first empty sector that was found. Normally it is required
-  // to keep 1 empty sector after the sector found here, but that rule does not
+  // sector, use the empty sector that was found. Normally it is required to
+  // keep 1 empty sector after the sector found here, but that rule does not
   // apply during GC.
-  if (first_empty_sector != nullptr && at_least_two_empty_sectors) {
-    DBG("  Found a usable empty sector; returning the first found (%u)",
-        Index(first_empty_sector));
-    last_new_ = first_empty_sector;
-    *found_sector = first_empty_sector;
+  if (empty_sector != nullptr && at_least_two_empty_sectors) {
+    DBG("  Found a usable empty sector (%u)", Index(empty_sector));
+    last_new_ = empty_sector;
+    *found_sector = empty_sector;
     return OkStatus();
   }
 
@@ -162,6 +171,36 @@ SectorDescriptor& Sectors::WearLeveledSectorFromIndex(size_t idx) const {
   return descriptors_[(Index(last_new_) + 1 + idx) % descriptors_.size()];
 }
 
+std::span<const size_t> Sectors::EraseCounts() const {
+  const std::span<const size_t> erase_counts = partition_.sector_erase_counts();
+  if (erase_counts.size() != descriptors_.size()) {
+    return {};
+  }
+  return erase_counts;
+}
+
+bool Sectors::BetterGarbageCollectionCandidate(
+    const SectorDescriptor& a,
+    const SectorDescriptor& b,
+    std::span<const size_t> erase_counts,
+    size_t max_erase_count) const {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  // This follows the cost-benefit cleaning policy of log-structured file
+  // systems. The benefit of collecting a sector is the bytes it recovers,
+  // scaled by how much less it has been erased than the most erased sector.
+  // The cost is erasing the sector plus relocating its valid bytes. Compare
+  // benefit / cost by cross-multiplying to avoid division.
+  const auto benefit = [&](const SectorDescriptor& sector) {
+    return uint64_t{sector.RecoverableBytes(sector_size_bytes)} *
+           (max_erase_count - erase_counts[Index(sector)] + 1);
+  };
+  const auto cost = [&](const SectorDescriptor& sector) {
+    return uint64_t{sector_size_bytes + sector.valid_bytes()};
+  };
+  return benefit(a) * cost(b) > benefit(b) * cost(a);
+}
+
 // TODO: Consider breaking this function into smaller sub-chunks.
 SectorDescriptor* Sectors::FindSectorToGarbageCollect(
     std::span<const Address> reserved_addresses) const {
@@ -177,28 +216,52 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
   const std::span sectors_to_skip(temp_sectors_to_skip_,
                                   reserved_addresses.size());
 
+  const std::span<const size_t> erase_counts = EraseCounts();
+
   // Step 1: Try to find a sectors with stale keys and no valid keys (no
   // relocation needed). Use the first such sector found, as that will help the
   // KVS "rotate" around the partition. Initially this would select the sector
   // with the most reclaimable space, but that can cause GC sector selection to
-  // "ping-pong" between two sectors when updating large keys.
+  // "ping-pong" between two sectors when updating large keys. If the partition
+  // tracks erase counts, use the least erased such sector instead.
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
     if ((sector.valid_bytes() == 0) &&
         (sector.RecoverableBytes(sector_size_bytes) > 0) &&
         !Contains(sectors_to_skip, &sector)) {
-      sector_candidate = &sector;
-      break;
+      if (erase_counts.empty()) {
+        sector_candidate = &sector;
+        break;
+      }
+      if (sector_candidate == nullptr ||
+          erase_counts[Index(sector)] < erase_counts[Index(sector_candidate)]) {
+        sector_candidate = &sector;
+      }
     }
   }
 
   // Step 2: If step 1 yields no sectors, just find the sector with the most
-  // reclaimable bytes but no addresses to avoid.
+  // reclaimable bytes but no addresses to avoid. If the partition tracks erase
+  // counts, pick the sector with the best cost-benefit score instead.
   if (sector_candidate == nullptr) {
+    const size_t max_erase_count =
+        erase_counts.empty()
+            ? 0
+            : *std::max_element(erase_counts.begin(), erase_counts.end());
+
     for (size_t i = 0; i < descriptors_.size(); ++i) {
       SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
-      if ((sector.RecoverableBytes(sector_size_bytes) > candidate_bytes) &&
-          !Contains(sectors_to_skip, &sector)) {
+      if ((sector.RecoverableBytes(sector_size_bytes) == 0) ||
+          Contains(sectors_to_skip, &sector)) {
+        continue;
+      }
+      if (sector_candidate == nullptr ||
+          (erase_counts.empty()
+               ? sector.RecoverableBytes(sector_size_bytes) > candidate_bytes
+               : BetterGarbageCollectionCandidate(sector,
+                                                  *sector_candidate,
+                                                  erase_counts,
+                                                  max_erase_count))) {
         sector_candidate = &sector;
         candidate_bytes = sector.RecoverableBytes(sector_size_bytes);
       }
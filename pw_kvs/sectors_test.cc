@@ -79,8 +79,103 @@ TEST_F(SectorsTest, NextWritableAddress_PartiallyWrittenSector) {
   EXPECT_EQ(123u, sectors_.NextWritableAddress(*sectors_.begin()));
 }
 
-// TODO: Add tests for FindSpace, FindSpaceDuringGarbageCollection, and
-// FindSectorToGarbageCollect.
+// Partition that reports fixed erase counts for its sectors.
+class ErasesTrackedPartition : public FlashPartition {
+ public:
+  ErasesTrackedPartition(FlashMemory* flash, std::span<const size_t> counts)
+      : FlashPartition(flash), erase_counts_(counts) {}
+
+  std::span<const size_t> sector_erase_counts() const override {
+    return erase_counts_;
+  }
+
+ private:
+  std::span<const size_t> erase_counts_;
+};
+
+class WearAwareSectorsTest : public ::testing::Test {
+ protected:
+  WearAwareSectorsTest()
+      : partition_(&flash_, erase_counts_),
+        sectors_(sector_descriptors_, partition_, nullptr) {
+    sectors_.Reset();
+  }
+
+  // Writes an entry of the given size to the sector, then marks stale_bytes of
+  // the sector as stale.
+  void Fill(size_t index, size_t written_bytes, size_t stale_bytes) {
+    SectorDescriptor& sector = *(sectors_.begin() + index);
+    sector.RemoveWritableBytes(written_bytes);
+    sector.AddValidBytes(written_bytes - stale_bytes);
+  }
+
+  FakeFlashMemoryBuffer<128, 4> flash_;
+  std::array<size_t, 4> erase_counts_ = {};
+  ErasesTrackedPartition partition_;
+  Vector<SectorDescriptor, 4> sector_descriptors_;
+  Sectors sectors_;
+};
+
+TEST_F(WearAwareSectorsTest, FindSpace_UsesLeastErasedEmptySector) {
+  erase_counts_ = {5, 3, 1, 4};
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(2u, sectors_.Index(found));
+  EXPECT_EQ(found, sectors_.last_new());
+}
+
+TEST_F(WearAwareSectorsTest, FindSpace_PrefersPartiallyWrittenSector) {
+  erase_counts_ = {5, 3, 1, 4};
+  Fill(3, 32, 0);
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(3u, sectors_.Index(found));
+}
+
+TEST_F(WearAwareSectorsTest, FindSectorToGarbageCollect_LeastErasedStale) {
+  erase_counts_ = {5, 3, 1, 4};
+  Fill(0, 64, 64);
+  Fill(1, 64, 64);
+  Fill(3, 64, 64);
+
+  SectorDescriptor* sector = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, sector);
+  EXPECT_EQ(1u, sectors_.Index(sector));
+}
+
+TEST_F(WearAwareSectorsTest, FindSectorToGarbageCollect_FewerValidBytes) {
+  // Sector 0 has more recoverable bytes, but sector 1 recovers more per byte
+  // relocated.
+  Fill(0, 120, 60);
+  Fill(1, 60, 50);
+
+  SectorDescriptor* sector = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, sector);
+  EXPECT_EQ(1u, sectors_.Index(sector));
+}
+
+TEST_F(WearAwareSectorsTest, FindSectorToGarbageCollect_LessWornSector) {
+  erase_counts_ = {9, 0, 0, 0};
+  Fill(0, 120, 60);
+  Fill(1, 120, 40);
+
+  SectorDescriptor* sector = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, sector);
+  EXPECT_EQ(1u, sectors_.Index(sector));
+}
+
+TEST_F(SectorsTest, FindSectorToGarbageCollect_MostRecoverableWithoutStats) {
+  sectors_.begin()->RemoveWritableBytes(120);
+  sectors_.begin()->AddValidBytes(60);
+  (sectors_.begin() + 1)->RemoveWritableBytes(60);
+  (sectors_.begin() + 1)->AddValidBytes(10);
+
+  EXPECT_EQ(sectors_.begin(), sectors_.FindSectorToGarbageCollect({}));
+}
+
+// TODO: Add tests for FindSpaceDuringGarbageCollection.
 
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -0,0 +1,135 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_kvs/thread_safe_key_value_store.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 16;
+constexpr size_t kMaxUsableSectors = 4;
+
+ChecksumCrc16 checksum;
+
+class ThreadSafeKvs : public ::testing::Test {
+ protected:
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  ThreadSafeKvs()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, {.magic = 0x4f1d23c5, .checksum = &checksum}),
+        thread_safe_kvs_(kvs_) {
+    EXPECT_EQ(OkStatus(), thread_safe_kvs_.Init());
+  }
+
+  FakeFlashMemoryBuffer<512, kMaxUsableSectors> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  ThreadSafeKeyValueStore thread_safe_kvs_;
+};
+
+TEST_F(ThreadSafeKvs, PutGetDelete) {
+  EXPECT_TRUE(thread_safe_kvs_.empty());
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key", uint32_t(0xfeedbeef)));
+  EXPECT_EQ(1u, thread_safe_kvs_.size());
+
+  uint32_t value = 0;
+  EXPECT_EQ(OkStatus(), thread_safe_kvs_.Get("key", &value));
+  EXPECT_EQ(0xfeedbeef, value);
+  EXPECT_EQ(sizeof(value), thread_safe_kvs_.ValueSize("key").size());
+
+  std::array<std::byte, 4> buffer{};
+  StatusWithSize result = thread_safe_kvs_.Get("key", buffer, 2);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Delete("key"));
+  EXPECT_EQ(Status::NotFound(), thread_safe_kvs_.Get("key", &value));
+  EXPECT_TRUE(thread_safe_kvs_.empty());
+}
+
+TEST_F(ThreadSafeKvs, Commit) {
+  KeyValueStore::BatchBuffer<2> batch;
+  ASSERT_EQ(OkStatus(), batch.Put("a", uint8_t(1)));
+  ASSERT_EQ(OkStatus(), batch.Put("b", uint8_t(2)));
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Commit(batch));
+
+  uint8_t value = 0;
+  EXPECT_EQ(OkStatus(), thread_safe_kvs_.Get("b", &value));
+  EXPECT_EQ(2u, value);
+}
+
+TEST_F(ThreadSafeKvs, AcquireShared_AllowsMultipleReaders) {
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key_1", uint8_t(1)));
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key_2", uint8_t(2)));
+
+  ThreadSafeKeyValueStore::ReadAccess reader_1 =
+      thread_safe_kvs_.acquire_shared();
+  ThreadSafeKeyValueStore::ReadAccess reader_2 =
+      thread_safe_kvs_.acquire_shared();
+
+  size_t count = 0;
+  for (const auto& item : *reader_1) {
+    static_cast<void>(item);
+    count += 1;
+  }
+  EXPECT_EQ(2u, count);
+
+  count = 0;
+  for (const auto& item : reader_2->WithPrefix("key_")) {
+    static_cast<void>(item);
+    count += 1;
+  }
+  EXPECT_EQ(2u, count);
+
+  uint8_t value = 0;
+  EXPECT_EQ(OkStatus(), reader_1->Get("key_1", &value));
+  EXPECT_EQ(1u, value);
+}
+
+TEST_F(ThreadSafeKvs, Put_GarbageCollectsFirst) {
+  // Overwrite a key through the unwrapped KVS until sectors are filled with
+  // stale entries.
+  for (uint32_t i = 0; i < 40; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put("key", i));
+  }
+  const KeyValueStore::StorageStats before = kvs_.GetStorageStats();
+  ASSERT_GT(before.reclaimable_bytes, partition_.sector_size_bytes());
+
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key", uint32_t(40)));
+
+  const KeyValueStore::StorageStats after =
+      thread_safe_kvs_.GetStorageStats();
+  EXPECT_GT(after.sector_erase_count, before.sector_erase_count);
+  EXPECT_LT(after.reclaimable_bytes, partition_.sector_size_bytes());
+  EXPECT_EQ(Status::NotFound(), thread_safe_kvs_.IncrementalGarbageCollect());
+
+  uint32_t value = 0;
+  EXPECT_EQ(OkStatus(), thread_safe_kvs_.Get("key", &value));
+  EXPECT_EQ(40u, value);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,139 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Runs readers on several threads at once. This needs test_threads, so it is
+// instantiated per thread backend; see
+// ":stl_thread_safe_key_value_store_threaded_test".
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_kvs/checksum.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_kvs/thread_safe_key_value_store.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_threads.h"
+#include "pw_thread/thread.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 16;
+constexpr size_t kMaxUsableSectors = 4;
+constexpr int kReadsPerThread = 200;
+
+// A CRC16 that sleeps after each update, so that readers that share it without
+// synchronization reliably corrupt each other's checksums.
+class YieldingChecksum final : public ChecksumAlgorithm {
+ public:
+  YieldingChecksum()
+      : ChecksumAlgorithm(std::as_bytes(std::span<uint16_t>(&crc_, 1))) {}
+
+  void Reset() override { crc_ = checksum::Crc16Ccitt::kInitialValue; }
+
+  void Update(std::span<const std::byte> data) override {
+    crc_ = checksum::Crc16Ccitt::Calculate(data, crc_);
+    this_thread::sleep_for(
+        chrono::SystemClock::for_at_least(std::chrono::microseconds(10)));
+  }
+
+ private:
+  uint16_t crc_ = checksum::Crc16Ccitt::kInitialValue;
+};
+
+YieldingChecksum checksum;
+
+class ThreadSafeKvsThreaded : public ::testing::Test {
+ protected:
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  ThreadSafeKvsThreaded()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, {.magic = 0x3c6a91e2, .checksum = &checksum}),
+        thread_safe_kvs_(kvs_) {
+    EXPECT_EQ(OkStatus(), thread_safe_kvs_.Init());
+  }
+
+  FakeFlashMemoryBuffer<512, kMaxUsableSectors> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  ThreadSafeKeyValueStore thread_safe_kvs_;
+};
+
+// Reads a key repeatedly on a test thread, counting failed reads.
+struct Reader {
+  Reader(ThreadSafeKeyValueStore& kvs_to_read,
+         const char* key_to_read,
+         uint32_t expected_value)
+      : kvs(kvs_to_read), key(key_to_read), expected(expected_value) {}
+
+  static void Run(void* arg) {
+    Reader& reader = *static_cast<Reader*>(arg);
+    for (int i = 0; i < kReadsPerThread; ++i) {
+      uint32_t value = 0;
+      if (!reader.kvs.Get(reader.key, &value).ok() ||
+          value != reader.expected) {
+        reader.failures += 1;
+      }
+
+      std::array<std::byte, sizeof(uint32_t)> buffer{};
+      stream::MemoryWriter writer(buffer);
+      if (!reader.kvs.Get(reader.key, writer).ok()) {
+        reader.failures += 1;
+      }
+    }
+    reader.done.release();
+  }
+
+  ThreadSafeKeyValueStore& kvs;
+  const char* key;
+  uint32_t expected;
+  int failures = 0;
+  sync::ThreadNotification done;
+};
+
+TEST_F(ThreadSafeKvsThreaded, ConcurrentGets_VerifyChecksums) {
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key_0", uint32_t(0x01234567)));
+  ASSERT_EQ(OkStatus(), thread_safe_kvs_.Put("key_1", uint32_t(0x89abcdef)));
+
+  Reader reader_0(thread_safe_kvs_, "key_0", 0x01234567);
+  Reader reader_1(thread_safe_kvs_, "key_1", 0x89abcdef);
+
+  thread::Thread(thread::test::TestOptionsThread0(), Reader::Run, &reader_0)
+      .detach();
+  thread::Thread(thread::test::TestOptionsThread1(), Reader::Run, &reader_1)
+      .detach();
+
+  reader_0.done.acquire();
+  reader_1.done.acquire();
+  thread::test::WaitUntilDetachedThreadsCleanedUp();
+
+  EXPECT_EQ(0, reader_0.failures);
+  EXPECT_EQ(0, reader_1.failures);
+  EXPECT_FALSE(thread_safe_kvs_.error_detected());
+}
+
+}  // namespace
+}  // namespace pw::kvs
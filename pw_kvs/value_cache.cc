@@ -0,0 +1,116 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/internal/value_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_kvs/internal/hash.h"
+
+namespace pw::kvs::internal {
+
+void ValueCache::Reset() {
+  for (Slot& slot : slots_) {
+    slot.key_size = 0;
+  }
+  clock_ = 0;
+}
+
+StatusWithSize ValueCache::Get(Key key,
+                               std::span<std::byte> buffer,
+                               size_t offset_bytes) {
+  Slot* slot = Find(key);
+  if (slot == nullptr) {
+    return StatusWithSize::NotFound();
+  }
+  if (offset_bytes > slot->value_size) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t remaining_bytes = slot->value_size - offset_bytes;
+  const size_t read_size = std::min(buffer.size(), remaining_bytes);
+  std::memcpy(buffer.data(),
+              slot_data(*slot) + slot->key_size + offset_bytes,
+              read_size);
+
+  if (read_size != remaining_bytes) {
+    return StatusWithSize::ResourceExhausted(read_size);
+  }
+  return StatusWithSize(read_size);
+}
+
+StatusWithSize ValueCache::ValueSize(Key key) {
+  if (Slot* slot = Find(key); slot != nullptr) {
+    return StatusWithSize(slot->value_size);
+  }
+  return StatusWithSize::NotFound();
+}
+
+void ValueCache::Add(Key key, std::span<const std::byte> value) {
+  if (!enabled() || key.empty() || key.size() + value.size() > slot_size_) {
+    return;
+  }
+
+  // Replace an existing copy of the key, an empty slot, or the least recently
+  // used slot, in that order.
+  Slot* slot = Find(key);
+  if (slot == nullptr) {
+    slot = &slots_.front();
+    for (Slot& candidate : slots_) {
+      if (candidate.key_size == 0) {
+        slot = &candidate;
+        break;
+      }
+      if (candidate.last_used < slot->last_used) {
+        slot = &candidate;
+      }
+    }
+  }
+
+  // Slot hashes are never stored in flash, so they use the faster hash
+  // regardless of the KVS's KeyHash.
+  slot->key_hash = WordHash(key);
+  slot->last_used = ++clock_;
+  slot->key_size = static_cast<uint16_t>(key.size());
+  slot->value_size = static_cast<uint16_t>(value.size());
+
+  std::byte* data = slot_data(*slot);
+  std::memcpy(data, key.data(), key.size());
+  std::memcpy(data + key.size(), value.data(), value.size());
+}
+
+void ValueCache::Invalidate(Key key) {
+  if (Slot* slot = Find(key); slot != nullptr) {
+    slot->key_size = 0;
+  }
+}
+
+ValueCache::Slot* ValueCache::Find(Key key) {
+  if (!enabled() || key.empty()) {
+    return nullptr;
+  }
+
+  const uint32_t hash = WordHash(key);
+  for (Slot& slot : slots_) {
+    if (slot.key_hash == hash && slot.key_size == key.size() &&
+        std::memcmp(slot_data(slot), key.data(), key.size()) == 0) {
+      slot.last_used = ++clock_;
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace pw::kvs::internal
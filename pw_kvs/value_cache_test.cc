@@ -0,0 +1,237 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/internal/value_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+using internal::ValueCache;
+
+constexpr std::array<byte, 4> kValue1 = {byte{1}, byte{2}, byte{3}, byte{4}};
+constexpr std::array<byte, 4> kValue2 = {byte{5}, byte{6}, byte{7}, byte{8}};
+
+class EmptyValueCache : public ::testing::Test {
+ protected:
+  EmptyValueCache() : cache_(ValueCache::Buffer<2, 16>::storage(buffer_)) {}
+
+  // Two slots of 16 bytes each.
+  ValueCache::Buffer<2, 16> buffer_;
+  ValueCache cache_;
+};
+
+TEST_F(EmptyValueCache, Get_NotCached) {
+  std::array<byte, 4> value;
+  EXPECT_EQ(Status::NotFound(), cache_.Get("key", value, 0).status());
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key").status());
+}
+
+TEST_F(EmptyValueCache, Add_ThenGet) {
+  cache_.Add("key", kValue1);
+
+  std::array<byte, 4> value{};
+  StatusWithSize result = cache_.Get("key", value, 0);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kValue1.size(), result.size());
+  EXPECT_EQ(kValue1, value);
+  EXPECT_EQ(kValue1.size(), cache_.ValueSize("key").size());
+}
+
+TEST_F(EmptyValueCache, Add_ReplacesValue) {
+  cache_.Add("key", kValue1);
+  cache_.Add("key", kValue2);
+
+  std::array<byte, 4> value{};
+  EXPECT_EQ(OkStatus(), cache_.Get("key", value, 0).status());
+  EXPECT_EQ(kValue2, value);
+}
+
+TEST_F(EmptyValueCache, Add_TooLarge_NotCached) {
+  constexpr std::array<byte, 14> kLargeValue{};
+  cache_.Add("key", kLargeValue);
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key").status());
+}
+
+TEST_F(EmptyValueCache, Get_ReadsFromOffset) {
+  cache_.Add("key", kValue1);
+
+  std::array<byte, 4> value{};
+  StatusWithSize result = cache_.Get("key", value, 3);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(1u, result.size());
+  EXPECT_EQ(byte{4}, value[0]);
+
+  EXPECT_EQ(OkStatus(), cache_.Get("key", value, 4).status());
+  EXPECT_EQ(Status::OutOfRange(), cache_.Get("key", value, 5).status());
+}
+
+TEST_F(EmptyValueCache, Get_SmallBuffer_ResourceExhausted) {
+  cache_.Add("key", kValue1);
+
+  std::array<byte, 3> value{};
+  StatusWithSize result = cache_.Get("key", value, 0);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(byte{3}, value[2]);
+}
+
+TEST_F(EmptyValueCache, Add_Full_ReplacesLeastRecentlyUsed) {
+  cache_.Add("key1", kValue1);
+  cache_.Add("key2", kValue1);
+
+  // Use key1 so that key2 is the least recently used.
+  std::array<byte, 4> value;
+  ASSERT_EQ(OkStatus(), cache_.Get("key1", value, 0).status());
+
+  cache_.Add("key3", kValue2);
+  EXPECT_EQ(OkStatus(), cache_.ValueSize("key1").status());
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key2").status());
+  EXPECT_EQ(OkStatus(), cache_.ValueSize("key3").status());
+}
+
+TEST_F(EmptyValueCache, Invalidate) {
+  cache_.Add("key1", kValue1);
+  cache_.Add("key2", kValue2);
+
+  cache_.Invalidate("key1");
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key1").status());
+  EXPECT_EQ(OkStatus(), cache_.ValueSize("key2").status());
+}
+
+TEST_F(EmptyValueCache, Reset) {
+  cache_.Add("key1", kValue1);
+  cache_.Add("key2", kValue2);
+
+  cache_.Reset();
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key1").status());
+  EXPECT_EQ(Status::NotFound(), cache_.ValueSize("key2").status());
+}
+
+TEST(DisabledValueCache, Add_DoesNothing) {
+  ValueCache::Buffer<0, 16> buffer;
+  ValueCache cache(ValueCache::Buffer<0, 16>::storage(buffer));
+  EXPECT_FALSE(cache.enabled());
+
+  cache.Add("key", kValue1);
+  EXPECT_EQ(Status::NotFound(), cache.ValueSize("key").status());
+}
+
+// A partition that counts the reads made from it.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  StatusWithSize Read(Address address, std::span<byte> output) override {
+    reads_ += 1;
+    return FlashPartition::Read(address, output);
+  }
+
+  using FlashPartition::Read;
+
+  size_t reads() const { return reads_; }
+
+ private:
+  size_t reads_ = 0;
+};
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x5ca1ab1e, .checksum = &checksum};
+
+class KvsWithValueCache : public ::testing::Test {
+ protected:
+  KvsWithValueCache()
+      : flash_(16), partition_(&flash_), kvs_(&partition_, kFormat) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  FakeFlashMemoryBuffer<512, 4> flash_;
+  ReadCountingPartition partition_;
+  KeyValueStoreBuffer<8, 4, 1, 1, false, /*kCachedValues=*/2, 32> kvs_;
+};
+
+TEST_F(KvsWithValueCache, Get_Cached_DoesNotReadFlash) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  const size_t reads = partition_.reads();
+  value = 0;
+  EXPECT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(123u, value);
+  EXPECT_EQ(sizeof(value), kvs_.ValueSize("key").size());
+  EXPECT_EQ(reads, partition_.reads());
+}
+
+TEST_F(KvsWithValueCache, Put_InvalidatesCachedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(456)));
+
+  EXPECT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(456u, value);
+}
+
+TEST_F(KvsWithValueCache, Delete_InvalidatesCachedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key"));
+
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("key", &value));
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("key").status());
+}
+
+TEST_F(KvsWithValueCache, Get_WrongSize_InvalidArgument) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  uint16_t small_value = 0;
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Get("key", &small_value));
+}
+
+TEST_F(KvsWithValueCache, GarbageCollection_KeepsCachedValues) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+
+  value = 0;
+  EXPECT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(123u, value);
+}
+
+}  // namespace
+}  // namespace pw::kvs
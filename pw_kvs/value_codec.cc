@@ -0,0 +1,230 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/value_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+// Reads a compressed value from an Input a few bytes at a time, so that
+// decoding does not do a flash read per byte.
+class ByteReader {
+ public:
+  constexpr ByteReader(Input& input, size_t size)
+      : input_(input), remaining_(size), buffer_{}, position_(0), size_(0) {}
+
+  bool done() const { return position_ == size_ && remaining_ == 0u; }
+
+  // Reads the next byte. The caller must check done() first.
+  Status Next(byte& value) {
+    if (position_ == size_) {
+      const size_t read_size = std::min(remaining_, buffer_.size());
+      PW_TRY(input_.Read(std::span(buffer_).first(read_size)));
+      remaining_ -= read_size;
+      position_ = 0;
+      size_ = read_size;
+    }
+    value = buffer_[position_++];
+    return OkStatus();
+  }
+
+ private:
+  Input& input_;
+  size_t remaining_;
+  std::array<byte, 16> buffer_;
+  size_t position_;
+  size_t size_;
+};
+
+// Returns the length of the match between the bytes at `candidate` and
+// `position`, which may overlap.
+size_t MatchLength(std::span<const byte> value,
+                   size_t candidate,
+                   size_t position) {
+  const size_t max_length =
+      std::min(value.size() - position, LzValueCodec::kMaxMatchBytes);
+  size_t length = 0;
+  while (length < max_length &&
+         value[candidate + length] == value[position + length]) {
+    length += 1;
+  }
+  return length;
+}
+
+}  // namespace
+
+StatusWithSize ValueCodec::Compress(std::span<const byte> value) {
+  if (value.size() > std::numeric_limits<uint16_t>::max()) {
+    return StatusWithSize::InvalidArgument();
+  }
+  if (buffer_.size() < kSizePrefixBytes) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  buffer_[0] = byte(value.size() & 0xff);
+  buffer_[1] = byte(value.size() >> 8);
+  StatusWithSize result = DoCompress(value, buffer_.subspan(kSizePrefixBytes));
+  PW_TRY_WITH_SIZE(result);
+  return StatusWithSize(kSizePrefixBytes + result.size());
+}
+
+StatusWithSize ValueCodec::ReadDecompressedSize(Input& compressed_value) {
+  std::array<byte, kSizePrefixBytes> prefix;
+  PW_TRY_WITH_SIZE(compressed_value.Read(prefix));
+  return StatusWithSize(size_t(prefix[0]) | (size_t(prefix[1]) << 8));
+}
+
+StatusWithSize ValueCodec::Decompress(Input& input,
+                                      size_t compressed_size,
+                                      std::span<byte> output) {
+  if (compressed_size < kSizePrefixBytes) {
+    return StatusWithSize::DataLoss();
+  }
+  StatusWithSize size = ReadDecompressedSize(input);
+  PW_TRY_WITH_SIZE(size);
+
+  const size_t output_size = std::min(size.size(), output.size());
+  StatusWithSize result = DoDecompress(
+      input, compressed_size - kSizePrefixBytes, output.first(output_size));
+  if (result.ok() && result.size() != size.size()) {
+    return StatusWithSize::DataLoss();
+  }
+  if (result.IsResourceExhausted() && output_size == size.size()) {
+    // The value decompressed to more bytes than its prefix claimed.
+    return StatusWithSize::DataLoss();
+  }
+  return result;
+}
+
+StatusWithSize LzValueCodec::DoCompress(std::span<const byte> value,
+                                        std::span<byte> output) {
+  size_t written = 0;
+
+  // Writes the pending literals, kMaxLiteralBytes at a time.
+  auto write_literals = [&](size_t start, size_t end) {
+    while (start < end) {
+      const size_t count = std::min(end - start, kMaxLiteralBytes);
+      if (output.size() - written < 1 + count) {
+        return false;
+      }
+      output[written++] = byte(count - 1);
+      std::memcpy(&output[written], &value[start], count);
+      written += count;
+      start += count;
+    }
+    return true;
+  };
+
+  size_t literal_start = 0;
+  size_t position = 0;
+
+  while (position < value.size()) {
+    // Find the longest match in the window, preferring the closest one.
+    size_t best_length = 0;
+    size_t best_distance = 0;
+    const size_t window_start =
+        position > kWindowBytes ? position - kWindowBytes : 0;
+    for (size_t candidate = position; candidate-- > window_start;) {
+      const size_t length = MatchLength(value, candidate, position);
+      if (length > best_length) {
+        best_length = length;
+        best_distance = position - candidate;
+        if (length == kMaxMatchBytes) {
+          break;
+        }
+      }
+    }
+
+    if (best_length < kMinMatchBytes) {
+      position += 1;
+      continue;
+    }
+
+    if (!write_literals(literal_start, position) ||
+        output.size() - written < 3) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    output[written++] = byte(0x80 | (best_length - kMinMatchBytes));
+    output[written++] = byte(best_distance & 0xff);
+    output[written++] = byte(best_distance >> 8);
+    position += best_length;
+    literal_start = position;
+  }
+
+  if (!write_literals(literal_start, position)) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  return StatusWithSize(written);
+}
+
+StatusWithSize LzValueCodec::DoDecompress(Input& input,
+                                          size_t compressed_size,
+                                          std::span<byte> output) {
+  ByteReader reader(input, compressed_size);
+  size_t written = 0;
+
+  while (!reader.done()) {
+    byte token;
+    PW_TRY_WITH_SIZE(reader.Next(token));
+
+    if ((token & byte{0x80}) == byte{0}) {
+      const size_t count = size_t(token) + 1;
+      for (size_t i = 0; i < count; ++i) {
+        if (reader.done()) {
+          return StatusWithSize::DataLoss();
+        }
+        if (written == output.size()) {
+          return StatusWithSize::ResourceExhausted(written);
+        }
+        PW_TRY_WITH_SIZE(reader.Next(output[written]));
+        written += 1;
+      }
+      continue;
+    }
+
+    const size_t length = size_t(token & byte{0x7f}) + kMinMatchBytes;
+    byte distance_bytes[2];
+    for (byte& distance_byte : distance_bytes) {
+      if (reader.done()) {
+        return StatusWithSize::DataLoss();
+      }
+      PW_TRY_WITH_SIZE(reader.Next(distance_byte));
+    }
+    const size_t distance =
+        size_t(distance_bytes[0]) | (size_t(distance_bytes[1]) << 8);
+    if (distance == 0u || distance > written) {
+      return StatusWithSize::DataLoss();
+    }
+
+    // Copy byte by byte, since the source may overlap the destination.
+    for (size_t i = 0; i < length; ++i) {
+      if (written == output.size()) {
+        return StatusWithSize::ResourceExhausted(written);
+      }
+      output[written] = output[written - distance];
+      written += 1;
+    }
+  }
+  return StatusWithSize(written);
+}
+
+}  // namespace pw::kvs
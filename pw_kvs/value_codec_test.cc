@@ -0,0 +1,259 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/value_codec.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr std::string_view kJson =
+    R"({"sensors":[{"name":"temp","rate_hz":10,"enabled":true},)"
+    R"({"name":"humidity","rate_hz":10,"enabled":true},)"
+    R"({"name":"pressure","rate_hz":10,"enabled":false}]})";
+
+// Reads from a buffer in memory.
+class SpanInput final : public Input {
+ public:
+  constexpr SpanInput(std::span<const byte> data) : data_(data) {}
+
+ private:
+  StatusWithSize DoRead(std::span<byte> data) override {
+    const size_t size = std::min(data.size(), data_.size());
+    std::memcpy(data.data(), data_.data(), size);
+    data_ = data_.subspan(size);
+    return StatusWithSize(size);
+  }
+
+  std::span<const byte> data_;
+};
+
+class LzValueCodecTest : public ::testing::Test {
+ protected:
+  StatusWithSize Decompress(std::span<byte> output) {
+    SpanInput input(codec_.buffer().first(compressed_size_));
+    return codec_.Decompress(input, compressed_size_, output);
+  }
+
+  void Compress(std::span<const byte> value) {
+    StatusWithSize result = codec_.Compress(value);
+    ASSERT_EQ(OkStatus(), result.status());
+    compressed_size_ = result.size();
+  }
+
+  LzValueCodecBuffer<256> codec_;
+  size_t compressed_size_ = 0;
+  std::array<byte, 256> output_ = {};
+};
+
+TEST_F(LzValueCodecTest, RoundTrip_Text) {
+  Compress(std::as_bytes(std::span(kJson)));
+  EXPECT_LT(compressed_size_, kJson.size());
+
+  StatusWithSize result = Decompress(output_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kJson.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kJson.data(), output_.data(), kJson.size()));
+}
+
+TEST_F(LzValueCodecTest, RoundTrip_Repeated) {
+  std::array<byte, 200> value;
+  std::memset(value.data(), 0xa5, value.size());
+  Compress(value);
+  EXPECT_LT(compressed_size_, 16u);
+
+  StatusWithSize result = Decompress(output_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(value.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(value.data(), output_.data(), value.size()));
+}
+
+TEST_F(LzValueCodecTest, RoundTrip_Empty) {
+  Compress({});
+  EXPECT_EQ(ValueCodec::kSizePrefixBytes, compressed_size_);
+  StatusWithSize result = Decompress(output_);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST_F(LzValueCodecTest, RoundTrip_Incompressible) {
+  std::array<byte, 200> value;
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = byte(i * 167 + (i >> 3));
+  }
+  Compress(value);
+  StatusWithSize result = Decompress(output_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(value.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(value.data(), output_.data(), value.size()));
+}
+
+TEST_F(LzValueCodecTest, Compress_BufferTooSmall) {
+  LzValueCodecBuffer<16> codec;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            codec.Compress(std::as_bytes(std::span(kJson))).status());
+}
+
+TEST_F(LzValueCodecTest, ReadDecompressedSize) {
+  Compress(std::as_bytes(std::span(kJson)));
+  SpanInput input(codec_.buffer());
+  StatusWithSize result = ValueCodec::ReadDecompressedSize(input);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kJson.size(), result.size());
+}
+
+TEST_F(LzValueCodecTest, Decompress_OutputTooSmall) {
+  Compress(std::as_bytes(std::span(kJson)));
+
+  StatusWithSize result = Decompress(std::span(output_).first(20));
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(20u, result.size());
+  EXPECT_EQ(0, std::memcmp(kJson.data(), output_.data(), 20));
+}
+
+TEST_F(LzValueCodecTest, Decompress_Malformed) {
+  // A copy from before the start of the value.
+  constexpr byte kBadDistance[] = {
+      byte{8}, byte{0}, byte{0x00}, byte{'a'}, byte{0x84}, byte{2}, byte{0}};
+  SpanInput input(kBadDistance);
+  EXPECT_EQ(Status::DataLoss(),
+            codec_.Decompress(input, sizeof(kBadDistance), output_).status());
+
+  // A literal run that is cut off.
+  constexpr byte kTruncated[] = {byte{3}, byte{0}, byte{0x02}, byte{'a'}};
+  SpanInput truncated(kTruncated);
+  EXPECT_EQ(Status::DataLoss(),
+            codec_.Decompress(truncated, sizeof(kTruncated), output_).status());
+
+  // The value is shorter than its size prefix claims.
+  constexpr byte kShort[] = {byte{3}, byte{0}, byte{0x00}, byte{'a'}};
+  SpanInput short_input(kShort);
+  EXPECT_EQ(Status::DataLoss(),
+            codec_.Decompress(short_input, sizeof(kShort), output_).status());
+}
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kMaxUsableSectors = 4;
+
+ChecksumCrc16 checksum;
+LzValueCodecBuffer<512> codec;
+constexpr EntryFormat kFormat{.magic = 0x3c07a1d9, .checksum = &checksum};
+constexpr EntryFormat kCompressedFormat{
+    .magic = 0x3c07a1d9, .checksum = &checksum, .codec = &codec};
+
+class KvsCompression : public ::testing::Test {
+ protected:
+  KvsCompression()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, kCompressedFormat) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  std::string_view Value(const KeyValueStore& kvs, Key key) {
+    StatusWithSize result = kvs.Get(key, std::as_writable_bytes(std::span(buffer_)));
+    if (!result.ok()) {
+      return {};
+    }
+    return std::string_view(buffer_.data(), result.size());
+  }
+
+  FakeFlashMemoryBuffer<512, kMaxUsableSectors> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  std::array<char, 256> buffer_;
+};
+
+TEST_F(KvsCompression, Put_StoresCompressedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson));
+  const size_t compressed_bytes = kvs_.GetStorageStats().in_use_bytes;
+
+  EXPECT_EQ(kJson, Value(kvs_, "config"));
+  StatusWithSize size = kvs_.ValueSize("config");
+  EXPECT_EQ(OkStatus(), size.status());
+  EXPECT_EQ(kJson.size(), size.size());
+
+  // The same value takes more space in a KVS without a codec.
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> uncompressed(&partition_,
+                                                                   kFormat);
+  ASSERT_EQ(OkStatus(), uncompressed.Init());
+  ASSERT_EQ(OkStatus(), uncompressed.Put("config", kJson));
+  EXPECT_LT(compressed_bytes, uncompressed.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(KvsCompression, Put_ValuesPersistAcrossInit) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson));
+  ASSERT_EQ(OkStatus(), kvs_.Put("count", uint32_t(0xfeedbeef)));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(
+      &partition_, kCompressedFormat);
+  ASSERT_EQ(OkStatus(), rebooted.Init());
+  EXPECT_EQ(kJson, Value(rebooted, "config"));
+
+  uint32_t count = 0;
+  EXPECT_EQ(OkStatus(), rebooted.Get("count", &count));
+  EXPECT_EQ(0xfeedbeef, count);
+}
+
+TEST_F(KvsCompression, Put_SameValueIsNotRewritten) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson));
+  const uint32_t transactions = kvs_.transaction_count();
+
+  ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson));
+  EXPECT_EQ(transactions, kvs_.transaction_count());
+}
+
+TEST_F(KvsCompression, Get_CompressedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson));
+
+  std::array<byte, 16> small;
+  StatusWithSize result = kvs_.Get("config", small);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(small.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kJson.data(), small.data(), small.size()));
+
+  // Offset reads need the start of the value to decompress.
+  EXPECT_EQ(Status::Unimplemented(), kvs_.Get("config", small, 4).status());
+}
+
+TEST_F(KvsCompression, GarbageCollect_KeepsCompressedValues) {
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put("config", kJson.substr(i)));
+    ASSERT_EQ(OkStatus(), kvs_.Put("other", kJson.substr(20 - i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  EXPECT_EQ(kJson.substr(19), Value(kvs_, "config"));
+  EXPECT_EQ(kJson.substr(1), Value(kvs_, "other"));
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -41,9 +41,52 @@ bool IsRuleMet(const Filter::Rule& rule,
   return true;
 }
 
+static_assert(PW_LOG_LEVEL_BITMASK < 8,
+              "Filter's decision table has an entry per log level");
+
 }  // namespace
 
+void Filter::CompileRules() {
+  rules_met_by_level_ = {};
+  level_only_rules_ = 0;
+  drop_rules_ = 0;
+  checks_module_ = false;
+  checks_flags_ = false;
+
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const Rule& rule = rules_[i];
+    if (rule.action == Rule::Action::kInactive) {
+      continue;
+    }
+    checks_module_ = checks_module_ || !rule.module_equals.empty();
+    checks_flags_ = checks_flags_ || rule.any_flags_set != 0;
+    if (!compiled()) {
+      continue;
+    }
+
+    const RuleMask bit = RuleMask(1) << i;
+    for (uint32_t level = 0; level < kLogLevels; ++level) {
+      if (level >= static_cast<uint32_t>(rule.level_greater_than_or_equal)) {
+        rules_met_by_level_[level] |= bit;
+      }
+    }
+    if (rule.module_equals.empty() && rule.any_flags_set == 0) {
+      level_only_rules_ |= bit;
+    }
+    if (rule.action == Rule::Action::kDrop) {
+      drop_rules_ |= bit;
+    }
+  }
+}
+
 Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
+  // Compile the rules however far decoding got.
+  const Status status = DecodeRulesFromProto(buffer);
+  CompileRules();
+  return status;
+}
+
+Status Filter::DecodeRulesFromProto(ConstByteSpan buffer) {
   if (rules_.empty()) {
     return Status::FailedPrecondition();
   }
@@ -89,38 +132,73 @@ Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
 }
 
 bool Filter::ShouldDropLog(ConstByteSpan entry) const {
+  // Every active rule passes the level check at the highest level, so if there
+  // are none, don't bother decoding the entry.
+  if (compiled() && rules_met_by_level_[kLogLevels - 1] == 0) {
+    return false;
+  }
   if (rules_.empty()) {
     return false;
   }
 
+  // Only decode the fields that the rules check, and stop once they're found.
+  bool needs_level = true;
+  bool needs_module = checks_module_;
+  bool needs_flags = checks_flags_;
   uint32_t log_level = 0;
   ConstByteSpan log_module;
   uint32_t log_flags = 0;
   protobuf::Decoder decoder(entry);
-  while (decoder.Next().ok()) {
+  while ((needs_level || needs_module || needs_flags) && decoder.Next().ok()) {
     switch (static_cast<log::LogEntry::Fields>(decoder.FieldNumber())) {
       case log::LogEntry::Fields::LINE_LEVEL:
         if (decoder.ReadUint32(&log_level).ok()) {
           log_level &= PW_LOG_LEVEL_BITMASK;
         }
+        needs_level = false;
         break;
       case log::LogEntry::Fields::MODULE:
         decoder.ReadBytes(&log_module).IgnoreError();
+        needs_module = false;
         break;
       case log::LogEntry::Fields::FLAGS:
         decoder.ReadUint32(&log_flags).IgnoreError();
+        needs_flags = false;
         break;
       default:
         break;
     }
   }
 
+  return ShouldDropLog(log_level, log_module, log_flags);
+}
+
+bool Filter::ShouldDropLog(uint32_t level,
+                           ConstByteSpan module,
+                           uint32_t flags) const {
+  level &= PW_LOG_LEVEL_BITMASK;
+  if (compiled()) {
+    // Visit the rules that pass the level check in order. Level-only rules
+    // match right away.
+    RuleMask candidates = rules_met_by_level_[level];
+    while (candidates != 0) {
+      const int index = __builtin_ctz(candidates);
+      const RuleMask bit = RuleMask(1) << index;
+      if ((level_only_rules_ & bit) != 0 ||
+          IsRuleMet(rules_[index], level, module, flags)) {
+        return (drop_rules_ & bit) != 0;
+      }
+      candidates &= ~bit;
+    }
+    return false;
+  }
+
   // Follow the action of the first rule whose condition is met.
   for (const auto& rule : rules_) {
     if (rule.action == Filter::Rule::Action::kInactive) {
       continue;
     }
-    if (IsRuleMet(rule, log_level, log_module, log_flags)) {
+    if (IsRuleMet(rule, level, module, flags)) {
       return rule.action == Filter::Rule::Action::kDrop;
     }
   }
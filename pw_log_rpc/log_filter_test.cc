@@ -511,5 +511,81 @@ TEST(FilterTest, FilterLogsFirstRuleWins) {
   EXPECT_TRUE(filter_reverse_rules.ShouldDropLog(log_entry_info.value()));
 }
 
+TEST(FilterTest, FilterDecodedMetadata) {
+  const std::array<Filter::Rule, 2> rules{{
+      {
+          .action = Filter::Rule::Action::kKeep,
+          .level_greater_than_or_equal = log::FilterRule::Level::INFO_LEVEL,
+          .any_flags_set = kSampleFlags,
+          .module_equals{kSampleModuleLittleEndian.begin(),
+                         kSampleModuleLittleEndian.end()},
+      },
+      {
+          .action = Filter::Rule::Action::kDrop,
+          .level_greater_than_or_equal = log::FilterRule::Level::ANY_LEVEL,
+          .any_flags_set = 0,
+          .module_equals = {},
+      },
+  }};
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  const Filter filter(filter_id,
+                      const_cast<std::array<Filter::Rule, 2>&>(rules));
+
+  EXPECT_FALSE(filter.ShouldDropLog(
+      PW_LOG_LEVEL_INFO, kSampleModuleLittleEndian, kSampleFlags));
+  EXPECT_FALSE(filter.ShouldDropLog(
+      PW_LOG_LEVEL_ERROR, kSampleModuleLittleEndian, kSampleFlags));
+  EXPECT_TRUE(filter.ShouldDropLog(
+      PW_LOG_LEVEL_DEBUG, kSampleModuleLittleEndian, kSampleFlags));
+  EXPECT_TRUE(filter.ShouldDropLog(PW_LOG_LEVEL_INFO, {}, kSampleFlags));
+  EXPECT_TRUE(
+      filter.ShouldDropLog(PW_LOG_LEVEL_INFO, kSampleModuleLittleEndian, 0));
+}
+
+TEST(FilterTest, FilterLogsWithMoreRulesThanCompiled) {
+  // Only the last rule matches, past the rules the decision table can hold.
+  std::array<Filter::Rule, Filter::kMaxCompiledRules + 4> rules{};
+  for (auto& rule : rules) {
+    rule.action = Filter::Rule::Action::kKeep;
+    rule.level_greater_than_or_equal = log::FilterRule::Level::ANY_LEVEL;
+    rule.module_equals.assign(kSampleModuleLittleEndian.begin(),
+                              kSampleModuleLittleEndian.end());
+  }
+  rules.back() = {
+      .action = Filter::Rule::Action::kDrop,
+      .level_greater_than_or_equal = log::FilterRule::Level::WARN_LEVEL,
+      .any_flags_set = 0,
+      .module_equals = {},
+  };
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  const Filter filter(filter_id, rules);
+
+  EXPECT_FALSE(
+      filter.ShouldDropLog(PW_LOG_LEVEL_WARN, kSampleModuleLittleEndian, 0));
+  EXPECT_TRUE(filter.ShouldDropLog(PW_LOG_LEVEL_WARN, {}, 0));
+  EXPECT_FALSE(filter.ShouldDropLog(PW_LOG_LEVEL_INFO, {}, 0));
+}
+
+TEST(FilterTest, CompileRulesAfterDirectUpdate) {
+  std::array<Filter::Rule, 1> rules{};
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  Filter filter(filter_id, rules);
+
+  std::array<std::byte, 50> buffer;
+  const Result<ConstByteSpan> log_entry =
+      EncodeLogEntry<PW_LOG_LEVEL_INFO, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer);
+  ASSERT_EQ(log_entry.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry.value()));
+
+  rules[0].action = Filter::Rule::Action::kDrop;
+  rules[0].any_flags_set = kSampleFlags;
+  filter.CompileRules();
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry.value()));
+}
+
 }  // namespace
 }  // namespace pw::log_rpc
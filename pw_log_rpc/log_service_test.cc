@@ -311,6 +311,7 @@ TEST_F(LogServiceTest, HandleDroppedBetweenFilteredOutLogs) {
   // Set filter to drop INFO+ and keep DEBUG logs
   rules1_[0].action = Filter::Rule::Action::kDrop;
   rules1_[0].level_greater_than_or_equal = log::FilterRule::Level::INFO_LEVEL;
+  filters_[0].CompileRules();
 
   // Add log entries.
   const size_t total_entries = 5;
@@ -738,6 +739,7 @@ TEST_F(LogServiceTest, FilterLogs) {
       .any_flags_set = 0,
       .module_equals{},
   };
+  filters_[1].CompileRules();
 
   // Request logs.
   LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
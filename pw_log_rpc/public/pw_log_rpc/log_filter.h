@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <span>
 
@@ -29,6 +31,12 @@ namespace pw::log_rpc {
 
 // A Filter is a collection of rules used to check if a log entry can be kept
 // or dropped wherever the filter is placed in the log path.
+//
+// The rules are compiled into a decision table of rule bitmasks indexed by log
+// level, so that rules which only check the level are evaluated in constant
+// time. Only the rules that pass the level check and also check the module or
+// flags are evaluated one by one. Filters with more than kMaxCompiledRules
+// rules are evaluated linearly.
 class Filter {
  public:
   struct Rule {
@@ -52,9 +60,13 @@ class Filter {
     Vector<std::byte, cfg::kMaxModuleNameBytes> module_equals{};
   };
 
+  // Filters with up to this many rules use the compiled decision table.
+  static constexpr size_t kMaxCompiledRules = 32;
+
   Filter(std::span<const std::byte> id, std::span<Rule> rules) : rules_(rules) {
     PW_ASSERT(!id.empty());
     id_.assign(id.begin(), id.end());
+    CompileRules();
   }
 
   // Not copyable.
@@ -70,6 +82,18 @@ class Filter {
   // false if there are no rules, or no rules were matched.
   bool ShouldDropLog(ConstByteSpan entry) const;
 
+  // ShouldDropLog() for a log entry whose level, module, and flags were
+  // already decoded, such as from tokenized log metadata. This avoids parsing
+  // the log entry proto.
+  bool ShouldDropLog(uint32_t level,
+                     ConstByteSpan module,
+                     uint32_t flags) const;
+
+  // Rebuilds the decision table from the rules. The rules are compiled on
+  // construction and by UpdateRulesFromProto(). This must be called after the
+  // rules are modified directly through the span given to the constructor.
+  void CompileRules();
+
   // Decodes and updates the filter's rules given a buffer with a proto-encoded
   // log::Filter message. If there are more rules than this filter can hold, the
   // extra rules are discarded.
@@ -81,8 +105,29 @@ class Filter {
   Status UpdateRulesFromProto(ConstByteSpan buffer);
 
  private:
+  // Bit i of a mask stands for rules_[i].
+  using RuleMask = uint32_t;
+
+  // Log levels are 3 bits.
+  static constexpr size_t kLogLevels = 8;
+
+  bool compiled() const { return rules_.size() <= kMaxCompiledRules; }
+
+  // Decodes the rules for UpdateRulesFromProto(), without compiling them.
+  Status DecodeRulesFromProto(ConstByteSpan buffer);
+
   Vector<std::byte, cfg::kMaxFilterIdBytes> id_;
   std::span<Rule> rules_;
+
+  // Active rules whose level condition passes at each log level.
+  std::array<RuleMask, kLogLevels> rules_met_by_level_{};
+  // Rules that don't check the module or flags.
+  RuleMask level_only_rules_ = 0;
+  RuleMask drop_rules_ = 0;
+  // Whether any active rule checks the module or flags, so that
+  // ShouldDropLog() can skip decoding the fields.
+  bool checks_module_ = true;
+  bool checks_flags_ = true;
 };
 
 }  // namespace pw::log_rpc
@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <string_view>
 
@@ -28,6 +29,7 @@
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log_rpc/internal/config.h"
 #include "pw_log_rpc/log_filter.h"
+#include "pw_metric/metric.h"
 #include "pw_multisink/multisink.h"
 #include "pw_protobuf/serialized_size.h"
 #include "pw_result/result.h"
@@ -51,6 +53,15 @@ namespace pw::log_rpc {
 // to send them out ignoring the writer errors without sending a drop count.
 // Note: the error handling and drop count reporting might change in the future.
 // Log filtering is done using the rules of the Filter provided if any.
+//
+// Besides the fixed max_bundles_per_trickle and trickle_delay limits, Trickle()
+// may be rate limited with a token bucket, which allows short bursts while
+// bounding a drain's long-term bundle rate. The drain's metrics track how much
+// it sent and dropped.
+//
+// Drains that would send the same logs can share the work of reading,
+// filtering, and encoding them: a follower drain added with AddFollower()
+// sends the packets that its leader encodes.
 class RpcLogDrain : public multisink::MultiSink::Drain {
  public:
   // Dictates how to handle server writer errors.
@@ -133,6 +144,16 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
         max_bundles_per_trickle_(max_bundles_per_trickle),
         trickle_delay_(trickle_delay),
         no_writes_until_(chrono::SystemClock::now()),
+        max_packet_latency_(chrono::SystemClock::duration::zero()),
+        packet_deadline_(std::nullopt),
+        token_bucket_capacity_(0),
+        token_refill_period_(chrono::SystemClock::duration::zero()),
+        tokens_(0),
+        last_token_refill_(chrono::SystemClock::now()),
+        priority_(0),
+        leader_(nullptr),
+        followers_(nullptr),
+        next_follower_(nullptr),
         on_open_callback_(nullptr) {
     PW_ASSERT(log_entry_buffer.size_bytes() >= kMinEntryBufferSize);
   }
@@ -166,11 +187,27 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
 
   // Writes entries as dictated by this drain's rate limiting configuration.
   //
+  // If a max packet latency is set, entries are held back until there are
+  // enough to fill the encoding buffer, or until the oldest held entry has
+  // waited for the max packet latency.
+  //
   // Returns:
   //   A minimum wait duration before Trickle() will be ready to write more logs
   // If no duration is returned, this drain is caught up.
   std::optional<pw::chrono::SystemClock::duration> Trickle(
-      ByteSpan encoding_buffer) PW_LOCKS_EXCLUDED(mutex_);
+      ByteSpan encoding_buffer) PW_LOCKS_EXCLUDED(mutex_) {
+    size_t bundles_sent;
+    return Trickle(
+        encoding_buffer, std::numeric_limits<size_t>::max(), bundles_sent);
+  }
+
+  // Trickle(), but sending at most max_bundles bundles, for callers that share
+  // a budget between drains. The number of bundles sent is written to
+  // bundles_sent_out. If the drain stopped because it ran out of budget, the
+  // returned duration is zero.
+  std::optional<pw::chrono::SystemClock::duration> Trickle(
+      ByteSpan encoding_buffer, size_t max_bundles, size_t& bundles_sent_out)
+      PW_LOCKS_EXCLUDED(mutex_);
 
   // Ends RPC log stream without flushing.
   //
@@ -182,6 +219,15 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
 
   uint32_t channel_id() const { return channel_id_; }
 
+  // Checks already decoded log metadata against this drain's filter, if any.
+  // Returns true if this drain would drop the log. Used to filter logs before
+  // they are encoded and added to the MultiSink.
+  bool ShouldDropLog(uint32_t level,
+                     ConstByteSpan module,
+                     uint32_t flags) const {
+    return filter_ != nullptr && filter_->ShouldDropLog(level, module, flags);
+  }
+
   size_t max_bundles_per_trickle() const { return max_bundles_per_trickle_; }
   void set_max_bundles_per_trickle(size_t max_num_entries) {
     max_bundles_per_trickle_ = max_num_entries;
@@ -192,6 +238,56 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     trickle_delay_ = trickle_delay;
   }
 
+  // How long Trickle() may hold back entries to pack them into a fuller
+  // packet. Zero, the default, sends entries as soon as they are available.
+  chrono::SystemClock::duration max_packet_latency() const {
+    return max_packet_latency_;
+  }
+  void set_max_packet_latency(chrono::SystemClock::duration latency) {
+    max_packet_latency_ = latency;
+  }
+
+  // Rate limits Trickle() with a token bucket that holds up to capacity
+  // bundles and refills one bundle every refill_period. The bucket starts full.
+  // A capacity of zero, the default, disables the token bucket.
+  void set_token_bucket(size_t capacity,
+                        chrono::SystemClock::duration refill_period) {
+    PW_ASSERT(capacity == 0 ||
+              refill_period > chrono::SystemClock::duration::zero());
+    token_bucket_capacity_ = capacity;
+    token_refill_period_ = refill_period;
+    tokens_ = capacity;
+    last_token_refill_ = chrono::SystemClock::now();
+  }
+
+  // Sends each packet this drain encodes to the follower as well, so entries
+  // are read from the MultiSink, filtered, and encoded once for both drains.
+  // Only the LogEntry bytes are shared; each drain writes its own first entry
+  // sequence ID and keeps its own writer, error handling, and metrics.
+  //
+  // The follower must not be attached to a MultiSink. Its filter, buffer, and
+  // rate limits are not used, and calling Flush() or Trickle() on it does
+  // nothing. The leader keeps reading entries while either drain is open.
+  // Followers must be added before the drains are used, and neither drain may
+  // already be a follower or have followers of its own, respectively.
+  void AddFollower(RpcLogDrain& follower) PW_LOCKS_EXCLUDED(mutex_);
+
+  // True if this drain sends packets encoded by another drain.
+  bool is_follower() const { return leader_ != nullptr; }
+
+  // Drains with a higher priority are flushed first by RpcLogDrainThread.
+  uint8_t priority() const { return priority_; }
+  void set_priority(uint8_t priority) { priority_ = priority; }
+
+  // Metrics for this drain:
+  //   sent_bundles - LogEntries packets written to the stream.
+  //   sent_entries - Log entries in those packets.
+  //   sent_bytes - Encoded size of those packets.
+  //   dropped_entries - Entries dropped for any reason, counted when the drop
+  //     is reported to the client.
+  //   rate_limited - Trickle() calls deferred by the token bucket.
+  metric::Group& metrics() { return metrics_; }
+
   // Stores a function that is called when Open() is successful. Pass nulltpr to
   // clear it. This is useful in cases where the owner of the drain needs to be
   // notified that the drain was opened.
@@ -207,7 +303,46 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
 
   LogDrainState SendLogs(size_t max_num_bundles,
                          ByteSpan encoding_buffer,
-                         Status& encoding_status) PW_LOCKS_EXCLUDED(mutex_);
+                         Status& encoding_status,
+                         size_t& sent_bundle_count_out)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  // Adds the tokens that accumulated since the last refill to the bucket.
+  void RefillTokens(chrono::SystemClock::time_point now);
+
+  // Creates an encoded drop message on the provided buffer and adds it to the
+  // bulk log entries. Resets the drop count when successful.
+  void TryEncodeDropMessage(ByteSpan encoded_drop_message_buffer,
+                            std::string_view reason,
+                            uint32_t& drop_count,
+                            log::LogEntries::MemoryEncoder& entries_encoder)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns how long Trickle() should wait for more entries before sending a
+  // packet, or std::nullopt if a packet should be sent now.
+  std::optional<chrono::SystemClock::duration> TimeUntilPacketReady(
+      size_t packet_size_bytes, chrono::SystemClock::time_point now);
+
+  // Writes a packet with the entries_size bytes of entries at the start of
+  // encoding_buffer, followed by this drain's first entry sequence ID.
+  Status WriteEntries(ByteSpan encoding_buffer,
+                      size_t entries_size,
+                      uint32_t packed_entry_count)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Writes the encoded entries to each follower with an open writer.
+  void WriteToFollowers(ByteSpan encoding_buffer,
+                        size_t entries_size,
+                        uint32_t packed_entry_count)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Locks a follower's mutex, unless it is shared with the leader, which
+  // already holds it.
+  std::unique_lock<sync::Mutex> LockFollower(RpcLogDrain& follower)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // True if this drain or any of its followers has an open writer.
+  bool AnyWriterOpen() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   // Fills the outgoing buffer with as many entries as possible.
   LogDrainState EncodeOutgoingPacket(log::LogEntries::MemoryEncoder& encoder,
@@ -229,7 +364,24 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   size_t max_bundles_per_trickle_;
   pw::chrono::SystemClock::duration trickle_delay_;
   pw::chrono::SystemClock::time_point no_writes_until_;
+  pw::chrono::SystemClock::duration max_packet_latency_;
+  std::optional<pw::chrono::SystemClock::time_point> packet_deadline_;
+  size_t token_bucket_capacity_;
+  pw::chrono::SystemClock::duration token_refill_period_;
+  size_t tokens_;
+  pw::chrono::SystemClock::time_point last_token_refill_;
+  uint8_t priority_;
+  RpcLogDrain* leader_;
+  RpcLogDrain* followers_;      // Head of this leader's list of followers.
+  RpcLogDrain* next_follower_;  // Next follower of this drain's leader.
   pw::Function<void()> on_open_callback_;
+
+  PW_METRIC_GROUP(metrics_, "rpc_log_drain");
+  PW_METRIC(metrics_, sent_bundles_, "sent_bundles", 0u);
+  PW_METRIC(metrics_, sent_entries_, "sent_entries", 0u);
+  PW_METRIC(metrics_, sent_bytes_, "sent_bytes", 0u);
+  PW_METRIC(metrics_, dropped_entries_, "dropped_entries", 0u);
+  PW_METRIC(metrics_, rate_limited_, "rate_limited", 0u);
 };
 
 }  // namespace pw::log_rpc
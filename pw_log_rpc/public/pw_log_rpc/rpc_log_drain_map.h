@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <span>
 
+#include "pw_bytes/span.h"
 #include "pw_log_rpc/rpc_log_drain.h"
 #include "pw_result/result.h"
 #include "pw_status/status.h"
@@ -44,6 +46,21 @@ class RpcLogDrainMap {
     return Status::NotFound();
   }
 
+  // Returns true if every drain's filter drops a log with the given metadata,
+  // meaning the log does not need to be encoded or stored in the MultiSink.
+  // Drains without a filter keep all logs. Only drains in this map are
+  // considered, so this should not be used when other MultiSink drains exist.
+  bool AllDrainsDropLog(uint32_t level,
+                        ConstByteSpan module,
+                        uint32_t flags) const {
+    for (const auto& drain : drains_) {
+      if (!drain.ShouldDropLog(level, module, flags)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   const std::span<RpcLogDrain>& drains() const { return drains_; }
 
  protected:
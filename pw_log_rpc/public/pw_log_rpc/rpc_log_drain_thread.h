@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <optional>
 #include <span>
 
@@ -35,15 +37,24 @@ namespace pw::log_rpc {
 // manages multiple log streams. It is a suitable option when a minimal
 // thread count is desired but comes with the cost of individual log streams
 // blocking each other's flushing.
+//
+// On each wakeup, drains are trickled from the highest to the lowest priority,
+// sharing a budget of at most max_bundles_per_wakeup bundles. When the budget
+// runs out, the thread wakes up again right away and starts over from the
+// highest priority drain. Combined with per-drain token buckets, this keeps a
+// chatty drain from starving the others.
 class RpcLogDrainThread : public thread::ThreadCore,
                           public multisink::MultiSink::Listener {
  public:
   RpcLogDrainThread(multisink::MultiSink& multisink,
                     RpcLogDrainMap& drain_map,
-                    std::span<std::byte> encoding_buffer)
+                    std::span<std::byte> encoding_buffer,
+                    size_t max_bundles_per_wakeup =
+                        std::numeric_limits<size_t>::max())
       : drain_map_(drain_map),
         multisink_(multisink),
-        encoding_buffer_(encoding_buffer) {}
+        encoding_buffer_(encoding_buffer),
+        max_bundles_per_wakeup_(max_bundles_per_wakeup) {}
 
   void OnNewEntryAvailable() override {
     ready_to_flush_notification_.release();
@@ -52,7 +63,10 @@ class RpcLogDrainThread : public thread::ThreadCore,
   // Sequentially flushes each log stream.
   void Run() override {
     for (auto& drain : drain_map_.drains()) {
-      multisink_.AttachDrain(drain);
+      // Followers receive their logs from their leader drain.
+      if (!drain.is_follower()) {
+        multisink_.AttachDrain(drain);
+      }
       drain.set_on_open_callback(
           [this]() { this->ready_to_flush_notification_.release(); });
     }
@@ -69,13 +83,29 @@ class RpcLogDrainThread : public thread::ThreadCore,
       }
       drains_pending = false;
       min_delay = std::nullopt;
-      for (auto& drain : drain_map_.drains()) {
-        std::optional<chrono::SystemClock::duration> drain_ready_in =
-            drain.Trickle(encoding_buffer_);
-        if (drain_ready_in.has_value()) {
-          min_delay = std::min(drain_ready_in.value(),
-                               min_delay.value_or(drain_ready_in.value()));
-          drains_pending = true;
+      size_t budget = max_bundles_per_wakeup_;
+      for (int priority = NextLowerPriority(kNoPriority);
+           priority != kNoPriority;
+           priority = NextLowerPriority(priority)) {
+        for (auto& drain : drain_map_.drains()) {
+          if (drain.priority() != priority) {
+            continue;
+          }
+          if (budget == 0) {
+            // Come back right away for the drains that were skipped.
+            min_delay = chrono::SystemClock::duration::zero();
+            drains_pending = true;
+            break;
+          }
+          size_t bundles_sent = 0;
+          std::optional<chrono::SystemClock::duration> drain_ready_in =
+              drain.Trickle(encoding_buffer_, budget, bundles_sent);
+          budget -= bundles_sent;
+          if (drain_ready_in.has_value()) {
+            min_delay = std::min(drain_ready_in.value(),
+                                 min_delay.value_or(drain_ready_in.value()));
+            drains_pending = true;
+          }
         }
       }
     }
@@ -95,18 +125,38 @@ class RpcLogDrainThread : public thread::ThreadCore,
   }
 
  private:
+  static constexpr int kNoPriority = -1;
+
+  // Returns the highest drain priority below the provided priority, or
+  // kNoPriority if there is none. kNoPriority starts from the top.
+  int NextLowerPriority(int priority) {
+    int next = kNoPriority;
+    for (auto& drain : drain_map_.drains()) {
+      if (priority == kNoPriority || drain.priority() < priority) {
+        next = std::max(next, static_cast<int>(drain.priority()));
+      }
+    }
+    return next;
+  }
+
   sync::TimedThreadNotification ready_to_flush_notification_;
   RpcLogDrainMap& drain_map_;
   multisink::MultiSink& multisink_;
   std::span<std::byte> encoding_buffer_;
+  const size_t max_bundles_per_wakeup_;
 };
 
 template <size_t kEncodingBufferSizeBytes>
 class RpcLogDrainThreadWithBuffer final : public RpcLogDrainThread {
  public:
   RpcLogDrainThreadWithBuffer(multisink::MultiSink& multisink,
-                              RpcLogDrainMap& drain_map)
-      : RpcLogDrainThread(multisink, drain_map, encoding_buffer_array_) {}
+                              RpcLogDrainMap& drain_map,
+                              size_t max_bundles_per_wakeup =
+                                  std::numeric_limits<size_t>::max())
+      : RpcLogDrainThread(multisink,
+                          drain_map,
+                          encoding_buffer_array_,
+                          max_bundles_per_wakeup) {}
 
  private:
   static_assert(kEncodingBufferSizeBytes >=
@@ -14,6 +14,7 @@
 
 #include "pw_log_rpc/rpc_log_drain.h"
 
+#include <algorithm>
 #include <limits>
 #include <mutex>
 #include <optional>
@@ -29,14 +30,12 @@
 #include "pw_status/try.h"
 
 namespace pw::log_rpc {
-namespace {
-
-// Creates an encoded drop message on the provided buffer and adds it to the
-// bulk log entries. Resets the drop count when successfull.
-void TryEncodeDropMessage(ByteSpan encoded_drop_message_buffer,
-                          std::string_view reason,
-                          uint32_t& drop_count,
-                          log::LogEntries::MemoryEncoder& entries_encoder) {
+
+void RpcLogDrain::TryEncodeDropMessage(
+    ByteSpan encoded_drop_message_buffer,
+    std::string_view reason,
+    uint32_t& drop_count,
+    log::LogEntries::MemoryEncoder& entries_encoder) {
   // Encode drop count and reason, if any, in log proto.
   log::LogEntry::MemoryEncoder encoder(encoded_drop_message_buffer);
   if (!reason.empty()) {
@@ -48,16 +47,15 @@ void TryEncodeDropMessage(ByteSpan encoded_drop_message_buffer,
   }
   // Add encoded drop messsage if fits in buffer.
   ConstByteSpan drop_message(encoder);
-  if (drop_message.size() + RpcLogDrain::kLogEntriesEncodeFrameSize <
+  if (drop_message.size() + kLogEntriesEncodeFrameSize <
       entries_encoder.ConservativeWriteLimit()) {
     PW_CHECK_OK(entries_encoder.WriteBytes(
         static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES), drop_message));
+    dropped_entries_.Increment(drop_count);
     drop_count = 0;
   }
 }
 
-}  // namespace
-
 Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
   if (!writer.active()) {
     return Status::FailedPrecondition();
@@ -73,14 +71,30 @@ Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
   return OkStatus();
 }
 
+void RpcLogDrain::AddFollower(RpcLogDrain& follower) {
+  std::lock_guard lock(mutex_);
+  PW_CHECK(&follower != this);
+  PW_CHECK(leader_ == nullptr, "A follower drain cannot have followers");
+  PW_CHECK(follower.leader_ == nullptr && follower.followers_ == nullptr,
+           "The drain already follows or leads other drains");
+  follower.leader_ = this;
+  follower.next_follower_ = followers_;
+  followers_ = &follower;
+}
+
 Status RpcLogDrain::Flush(ByteSpan encoding_buffer) {
   Status status;
-  SendLogs(std::numeric_limits<size_t>::max(), encoding_buffer, status);
+  size_t sent_bundle_count;
+  SendLogs(std::numeric_limits<size_t>::max(),
+           encoding_buffer,
+           status,
+           sent_bundle_count);
   return status;
 }
 
 std::optional<chrono::SystemClock::duration> RpcLogDrain::Trickle(
-    ByteSpan encoding_buffer) {
+    ByteSpan encoding_buffer, size_t max_bundles, size_t& bundles_sent_out) {
+  bundles_sent_out = 0;
   chrono::SystemClock::time_point now = chrono::SystemClock::now();
   // Called before drain is ready to send more logs. Ignore this request and
   // remind the caller how much longer they'll need to wait.
@@ -88,27 +102,110 @@ std::optional<chrono::SystemClock::duration> RpcLogDrain::Trickle(
     return no_writes_until_ - now;
   }
 
+  const std::optional<chrono::SystemClock::duration> packet_ready_in =
+      TimeUntilPacketReady(encoding_buffer.size_bytes(), now);
+  if (packet_ready_in.has_value()) {
+    return packet_ready_in;
+  }
+
+  if (token_bucket_capacity_ != 0) {
+    RefillTokens(now);
+    if (tokens_ == 0) {
+      rate_limited_.Increment();
+      return last_token_refill_ + token_refill_period_ - now;
+    }
+  }
+
+  const size_t bundle_limit =
+      std::min({max_bundles,
+                max_bundles_per_trickle_,
+                token_bucket_capacity_ != 0
+                    ? tokens_
+                    : std::numeric_limits<size_t>::max()});
   Status encoding_status;
-  if (SendLogs(max_bundles_per_trickle_, encoding_buffer, encoding_status) ==
-      LogDrainState::kCaughtUp) {
+  const LogDrainState state = SendLogs(
+      bundle_limit, encoding_buffer, encoding_status, bundles_sent_out);
+  if (token_bucket_capacity_ != 0) {
+    tokens_ -= std::min(tokens_, bundles_sent_out);
+  }
+  if (state == LogDrainState::kCaughtUp) {
     return std::nullopt;
   }
 
+  // Report the nearest limit that stopped the drain.
+  if (token_bucket_capacity_ != 0 && tokens_ == 0) {
+    return last_token_refill_ + token_refill_period_ - now;
+  }
+  if (bundles_sent_out < max_bundles_per_trickle_) {
+    // Out of the caller's budget, or the writer failed.
+    return chrono::SystemClock::duration::zero();
+  }
   no_writes_until_ = chrono::SystemClock::TimePointAfterAtLeast(trickle_delay_);
   return trickle_delay_;
 }
 
-RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
-                                                 ByteSpan encoding_buffer,
-                                                 Status& encoding_status_out) {
+void RpcLogDrain::RefillTokens(chrono::SystemClock::time_point now) {
+  if (tokens_ >= token_bucket_capacity_) {
+    // Tokens don't accumulate while the bucket is full.
+    last_token_refill_ = now;
+    return;
+  }
+
+  const auto new_tokens = (now - last_token_refill_) / token_refill_period_;
+  if (new_tokens <= 0) {
+    return;
+  }
+  if (static_cast<size_t>(new_tokens) >= token_bucket_capacity_ - tokens_) {
+    tokens_ = token_bucket_capacity_;
+    last_token_refill_ = now;
+    return;
+  }
+  tokens_ += static_cast<size_t>(new_tokens);
+  last_token_refill_ += new_tokens * token_refill_period_;
+}
+
+std::optional<chrono::SystemClock::duration> RpcLogDrain::TimeUntilPacketReady(
+    size_t packet_size_bytes, chrono::SystemClock::time_point now) {
+  if (max_packet_latency_ == chrono::SystemClock::duration::zero()) {
+    return std::nullopt;
+  }
+
+  // The multisink's per-entry overhead is close to the LogEntries encoding
+  // overhead, so the unread size approximates the size of the packet.
+  const size_t unread_bytes = UnreadEntriesSize();
+  if (unread_bytes == 0 || unread_bytes >= packet_size_bytes) {
+    packet_deadline_.reset();
+    return std::nullopt;
+  }
+
+  // Hold a partial packet until the oldest entry in it is too old.
+  if (!packet_deadline_.has_value()) {
+    packet_deadline_ = now + max_packet_latency_;
+  }
+  if (packet_deadline_.value() > now) {
+    return packet_deadline_.value() - now;
+  }
+  packet_deadline_.reset();
+  return std::nullopt;
+}
+
+RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(
+    size_t max_num_bundles,
+    ByteSpan encoding_buffer,
+    Status& encoding_status_out,
+    size_t& sent_bundle_count_out) {
+  sent_bundle_count_out = 0;
+  if (leader_ != nullptr) {
+    return LogDrainState::kCaughtUp;  // The leader sends this drain's logs.
+  }
+
   PW_CHECK_NOTNULL(multisink_);
 
   LogDrainState log_sink_state = LogDrainState::kMoreEntriesRemaining;
   std::lock_guard lock(mutex_);
-  size_t sent_bundle_count = 0;
-  while (sent_bundle_count < max_num_bundles &&
+  while (sent_bundle_count_out < max_num_bundles &&
          log_sink_state != LogDrainState::kCaughtUp) {
-    if (!server_writer_.active()) {
+    if (!AnyWriterOpen()) {
       encoding_status_out = Status::Unavailable();
       // No reason to keep polling this drain until the writer is opened.
       return LogDrainState::kCaughtUp;
@@ -122,17 +219,19 @@ RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
       continue;
     }
 
-    encoder.WriteFirstEntrySequenceId(sequence_id_)
-        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-    sequence_id_ += packed_entry_count;
-    const Status status = server_writer_.Write(encoder);
-    sent_bundle_count++;
+    // The entries are encoded once and sent to every open drain, each with
+    // its own sequence ID.
+    const size_t entries_size = encoder.size();
+    sent_bundle_count_out++;
+    WriteToFollowers(encoding_buffer, entries_size, packed_entry_count);
 
+    if (!server_writer_.active()) {
+      continue;  // Only followers are open.
+    }
+    const Status status =
+        WriteEntries(encoding_buffer, entries_size, packed_entry_count);
     if (!status.ok() &&
         error_handling_ == LogDrainErrorHandling::kCloseStreamOnWriterError) {
-      // Only update this drop count when writer errors are not ignored.
-      drop_count_writer_error_ += packed_entry_count;
-      server_writer_.Finish().IgnoreError();
       encoding_status_out = Status::Aborted();
       return log_sink_state;
     }
@@ -140,6 +239,72 @@ RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
   return log_sink_state;
 }
 
+Status RpcLogDrain::WriteEntries(ByteSpan encoding_buffer,
+                                 size_t entries_size,
+                                 uint32_t packed_entry_count) {
+  log::LogEntries::MemoryEncoder sequence_id_encoder(
+      encoding_buffer.subspan(entries_size));
+  sequence_id_encoder.WriteFirstEntrySequenceId(sequence_id_)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  sequence_id_ += packed_entry_count;
+
+  const ConstByteSpan packet =
+      encoding_buffer.first(entries_size + sequence_id_encoder.size());
+  const Status status = server_writer_.Write(packet);
+  if (status.ok()) {
+    sent_bundles_.Increment();
+    sent_entries_.Increment(packed_entry_count);
+    sent_bytes_.Increment(packet.size());
+  } else if (error_handling_ == LogDrainErrorHandling::kIgnoreWriterErrors) {
+    // These drops are never reported to the client, so only count them here.
+    dropped_entries_.Increment(packed_entry_count);
+  }
+
+  if (!status.ok() &&
+      error_handling_ == LogDrainErrorHandling::kCloseStreamOnWriterError) {
+    // Only update this drop count when writer errors are not ignored.
+    drop_count_writer_error_ += packed_entry_count;
+    server_writer_.Finish().IgnoreError();
+  }
+  return status;
+}
+
+void RpcLogDrain::WriteToFollowers(ByteSpan encoding_buffer,
+                                   size_t entries_size,
+                                   uint32_t packed_entry_count)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  for (RpcLogDrain* follower = followers_; follower != nullptr;
+       follower = follower->next_follower_) {
+    std::unique_lock follower_lock = LockFollower(*follower);
+    if (follower->server_writer_.active()) {
+      follower->WriteEntries(encoding_buffer, entries_size, packed_entry_count)
+          .IgnoreError();  // Followers handle their own writer errors.
+    }
+  }
+}
+
+std::unique_lock<sync::Mutex> RpcLogDrain::LockFollower(RpcLogDrain& follower)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  if (&follower.mutex_ == &mutex_) {
+    return std::unique_lock(follower.mutex_, std::defer_lock);
+  }
+  return std::unique_lock(follower.mutex_);
+}
+
+bool RpcLogDrain::AnyWriterOpen() PW_NO_LOCK_SAFETY_ANALYSIS {
+  if (server_writer_.active()) {
+    return true;
+  }
+  for (RpcLogDrain* follower = followers_; follower != nullptr;
+       follower = follower->next_follower_) {
+    std::unique_lock follower_lock = LockFollower(*follower);
+    if (follower->server_writer_.active()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 RpcLogDrain::LogDrainState RpcLogDrain::EncodeOutgoingPacket(
     log::LogEntries::MemoryEncoder& encoder, uint32_t& packed_entry_count_out) {
   const size_t total_buffer_size = encoder.ConservativeWriteLimit();
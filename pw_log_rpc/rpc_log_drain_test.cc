@@ -15,13 +15,17 @@
 #include "pw_log_rpc/rpc_log_drain.h"
 
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <span>
 #include <string_view>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
 #include "pw_bytes/span.h"
+#include "pw_log/levels.h"
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log/proto_utils.h"
 #include "pw_log_rpc/log_filter.h"
@@ -29,6 +33,7 @@
 #include "pw_log_rpc/rpc_log_drain_map.h"
 #include "pw_log_rpc_private/test_utils.h"
 #include "pw_log_tokenized/metadata.h"
+#include "pw_metric/metric.h"
 #include "pw_multisink/multisink.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_protobuf/serialized_size.h"
@@ -37,6 +42,7 @@
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_status/status.h"
 #include "pw_sync/mutex.h"
+#include "pw_tokenizer/tokenize.h"
 
 namespace pw::log_rpc {
 namespace {
@@ -105,6 +111,61 @@ TEST(RpcLogDrainMap, GetDrainsByIdFromDrainMap) {
   }
 }
 
+TEST(RpcLogDrainMap, AllDrainsDropLog) {
+  sync::Mutex mutex;
+  std::array<std::array<std::byte, kBufferSize>, 2> buffers;
+  std::array<Filter::Rule, 1> drop_all_rules{{
+      {.action = Filter::Rule::Action::kDrop,
+       .level_greater_than_or_equal = log::FilterRule::Level::ANY_LEVEL,
+       .any_flags_set = 0,
+       .module_equals{}},
+  }};
+  std::array<Filter::Rule, 2> info_rules{{
+      {.action = Filter::Rule::Action::kKeep,
+       .level_greater_than_or_equal = log::FilterRule::Level::INFO_LEVEL,
+       .any_flags_set = 0,
+       .module_equals{}},
+      {.action = Filter::Rule::Action::kDrop,
+       .level_greater_than_or_equal = log::FilterRule::Level::ANY_LEVEL,
+       .any_flags_set = 0,
+       .module_equals{}},
+  }};
+  constexpr std::byte kId1[] = {std::byte{1}};
+  constexpr std::byte kId2[] = {std::byte{2}};
+  Filter drop_all_filter(kId1, drop_all_rules);
+  Filter info_filter(kId2, info_rules);
+  std::array<RpcLogDrain, 2> drains{
+      RpcLogDrain(1,
+                  buffers[0],
+                  mutex,
+                  RpcLogDrain::LogDrainErrorHandling::kCloseStreamOnWriterError,
+                  &drop_all_filter),
+      RpcLogDrain(2,
+                  buffers[1],
+                  mutex,
+                  RpcLogDrain::LogDrainErrorHandling::kCloseStreamOnWriterError,
+                  &info_filter),
+  };
+  RpcLogDrainMap drain_map(drains);
+
+  // The first drain drops everything, so only the second drain's filter decides
+  // whether the log is needed.
+  EXPECT_FALSE(drain_map.AllDrainsDropLog(PW_LOG_LEVEL_INFO, {}, 0));
+  EXPECT_FALSE(drain_map.AllDrainsDropLog(PW_LOG_LEVEL_ERROR, {}, 0));
+  EXPECT_TRUE(drain_map.AllDrainsDropLog(PW_LOG_LEVEL_DEBUG, {}, 0));
+
+  // A drain without a filter keeps every log.
+  RpcLogDrain unfiltered_drain(
+      3,
+      buffers[0],
+      mutex,
+      RpcLogDrain::LogDrainErrorHandling::kCloseStreamOnWriterError,
+      nullptr);
+  EXPECT_FALSE(unfiltered_drain.ShouldDropLog(PW_LOG_LEVEL_DEBUG, {}, 0));
+  EXPECT_FALSE(RpcLogDrainMap(std::span(&unfiltered_drain, 1))
+                   .AllDrainsDropLog(PW_LOG_LEVEL_DEBUG, {}, 0));
+}
+
 TEST(RpcLogDrain, FlushingDrainWithOpenWriter) {
   const uint32_t drain_id = 1;
   std::array<std::byte, kBufferSize> buffer;
@@ -412,6 +473,336 @@ TEST_F(TrickleTest, LimitedFlushOverflowsToNextPayload) {
   EXPECT_EQ(entries_count, 3u);
 }
 
+TEST_F(TrickleTest, PartialPayloadHeldUntilMaxLatency) {
+  AttachDrain();
+  OpenWriter();
+
+  Vector<TestLogEntry, 2> kExpectedEntries{BasicLog(":D"), BasicLog("blink")};
+  AddLogEntries(kExpectedEntries);
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_max_packet_latency(std::chrono::minutes(10));
+
+  // The entries don't fill a payload, so they are held back.
+  std::optional<chrono::SystemClock::duration> min_delay =
+      drains_[0].Trickle(channel_encode_buffer_);
+  ASSERT_EQ(min_delay.has_value(), true);
+  EXPECT_GT(min_delay.value(), std::chrono::minutes(1));
+  EXPECT_LE(min_delay.value(), std::chrono::minutes(10));
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      0u);
+
+  // Without a max latency, the entries are sent right away.
+  drains_[0].set_max_packet_latency(chrono::SystemClock::duration::zero());
+  min_delay = drains_[0].Trickle(channel_encode_buffer_);
+  EXPECT_EQ(min_delay.has_value(), false);
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 1u);
+  uint32_t drop_count = 0;
+  size_t entries_count = 0;
+  protobuf::Decoder payload_decoder(payloads[0]);
+  VerifyLogEntries(
+      payload_decoder, kExpectedEntries, 0, entries_count, drop_count);
+  EXPECT_EQ(entries_count, 2u);
+}
+
+TEST_F(TrickleTest, FullPayloadSentBeforeMaxLatency) {
+  AttachDrain();
+  OpenWriter();
+
+  Vector<TestLogEntry, 3> kFirstFlushedBundle{
+      BasicLog("Use longer logs in this test"),
+      BasicLog("My feet are cold"),
+      BasicLog("I'm hungry, what's for dinner?")};
+  Vector<TestLogEntry, 1> kHeldBundle{BasicLog("Not enough for a payload")};
+  AddLogEntries(kFirstFlushedBundle);
+  AddLogEntries(kHeldBundle);
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_max_packet_latency(std::chrono::minutes(10));
+  drains_[0].set_max_bundles_per_trickle(1);
+
+  // There are enough entries to fill a payload, so one is sent.
+  std::optional<chrono::SystemClock::duration> min_delay =
+      drains_[0].Trickle(channel_encode_buffer_);
+  EXPECT_EQ(min_delay.has_value(), true);
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 1u);
+  uint32_t drop_count = 0;
+  size_t entries_count = 0;
+  protobuf::Decoder payload_decoder(payloads[0]);
+  VerifyLogEntries(
+      payload_decoder, kFirstFlushedBundle, 0, entries_count, drop_count);
+  EXPECT_EQ(entries_count, 3u);
+
+  // The remaining entry is held until the max latency.
+  min_delay = drains_[0].Trickle(channel_encode_buffer_);
+  ASSERT_EQ(min_delay.has_value(), true);
+  EXPECT_GT(min_delay.value(), std::chrono::minutes(1));
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      1u);
+}
+
+// Returns the value of the drain's metric with the provided name token.
+uint32_t MetricValue(RpcLogDrain& drain, uint32_t name_token) {
+  for (const metric::Metric& metric : drain.metrics().metrics()) {
+    if (metric.name() == name_token) {
+      return metric.as_int();
+    }
+  }
+  return std::numeric_limits<uint32_t>::max();
+}
+
+constexpr uint32_t kSentBundlesMetric =
+    PW_TOKENIZE_STRING_MASK("metrics", 0x7fffffff, "sent_bundles");
+constexpr uint32_t kSentEntriesMetric =
+    PW_TOKENIZE_STRING_MASK("metrics", 0x7fffffff, "sent_entries");
+constexpr uint32_t kDroppedEntriesMetric =
+    PW_TOKENIZE_STRING_MASK("metrics", 0x7fffffff, "dropped_entries");
+constexpr uint32_t kRateLimitedMetric =
+    PW_TOKENIZE_STRING_MASK("metrics", 0x7fffffff, "rate_limited");
+
+TEST_F(TrickleTest, TokenBucketLimitsBundles) {
+  AttachDrain();
+  OpenWriter();
+
+  Vector<TestLogEntry, 3> kFirstFlushedBundle{
+      BasicLog("Use longer logs in this test"),
+      BasicLog("My feet are cold"),
+      BasicLog("I'm hungry, what's for dinner?")};
+  Vector<TestLogEntry, 3> kSecondFlushedBundle{
+      BasicLog("Add a few longer logs"),
+      BasicLog("Eventually the logs will"),
+      BasicLog("Overflow into another payload")};
+  AddLogEntries(kFirstFlushedBundle);
+  AddLogEntries(kSecondFlushedBundle);
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_token_bucket(1, std::chrono::minutes(10));
+
+  // The bucket allows a single bundle, then reports when the next token is
+  // available.
+  std::optional<chrono::SystemClock::duration> min_delay =
+      drains_[0].Trickle(channel_encode_buffer_);
+  ASSERT_EQ(min_delay.has_value(), true);
+  EXPECT_GT(min_delay.value(), std::chrono::minutes(1));
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      1u);
+
+  min_delay = drains_[0].Trickle(channel_encode_buffer_);
+  ASSERT_EQ(min_delay.has_value(), true);
+  EXPECT_GT(min_delay.value(), std::chrono::minutes(1));
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      1u);
+  EXPECT_EQ(MetricValue(drains_[0], kRateLimitedMetric), 1u);
+
+  // Resetting the bucket refills it.
+  drains_[0].set_token_bucket(2, std::chrono::minutes(10));
+  min_delay = drains_[0].Trickle(channel_encode_buffer_);
+  EXPECT_EQ(min_delay.has_value(), false);
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 2u);
+  uint32_t drop_count = 0;
+  size_t entries_count = 0;
+  protobuf::Decoder payload_decoder(payloads[1]);
+  VerifyLogEntries(
+      payload_decoder, kSecondFlushedBundle, 3, entries_count, drop_count);
+  EXPECT_EQ(entries_count, 3u);
+  EXPECT_EQ(MetricValue(drains_[0], kSentBundlesMetric), 2u);
+  EXPECT_EQ(MetricValue(drains_[0], kSentEntriesMetric), 6u);
+}
+
+TEST_F(TrickleTest, SharedBudgetLimitsBundles) {
+  AttachDrain();
+  OpenWriter();
+
+  Vector<TestLogEntry, 3> kFirstFlushedBundle{
+      BasicLog("Use longer logs in this test"),
+      BasicLog("My feet are cold"),
+      BasicLog("I'm hungry, what's for dinner?")};
+  Vector<TestLogEntry, 3> kSecondFlushedBundle{
+      BasicLog("Add a few longer logs"),
+      BasicLog("Eventually the logs will"),
+      BasicLog("Overflow into another payload")};
+  AddLogEntries(kFirstFlushedBundle);
+  AddLogEntries(kSecondFlushedBundle);
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+
+  // Running out of budget means the drain is ready again right away.
+  size_t bundles_sent = 0;
+  std::optional<chrono::SystemClock::duration> min_delay =
+      drains_[0].Trickle(channel_encode_buffer_, 1, bundles_sent);
+  ASSERT_EQ(min_delay.has_value(), true);
+  EXPECT_EQ(min_delay.value(), chrono::SystemClock::duration::zero());
+  EXPECT_EQ(bundles_sent, 1u);
+
+  min_delay = drains_[0].Trickle(channel_encode_buffer_, 5, bundles_sent);
+  EXPECT_EQ(min_delay.has_value(), false);
+  EXPECT_EQ(bundles_sent, 1u);
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      2u);
+}
+
+TEST_F(TrickleTest, DroppedEntriesMetric) {
+  AttachDrain();
+  OpenWriter();
+
+  multisink_.HandleDropped(3);
+  AddLogEntry(BasicLog(":D"));
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  EXPECT_EQ(drains_[0].Trickle(channel_encode_buffer_).has_value(), false);
+
+  EXPECT_EQ(MetricValue(drains_[0], kDroppedEntriesMetric), 3u);
+  EXPECT_EQ(MetricValue(drains_[0], kSentEntriesMetric), 1u);
+}
+
+class FollowerTest : public ::testing::Test {
+ protected:
+  static constexpr uint32_t kLeaderId = 1;
+  static constexpr uint32_t kFollowerId = 2;
+
+  FollowerTest()
+      : drains_{RpcLogDrain(kLeaderId,
+                            leader_buffer_,
+                            mutex_,
+                            RpcLogDrain::LogDrainErrorHandling::
+                                kCloseStreamOnWriterError,
+                            nullptr),
+                RpcLogDrain(kFollowerId,
+                            follower_buffer_,
+                            mutex_,
+                            RpcLogDrain::LogDrainErrorHandling::
+                                kCloseStreamOnWriterError,
+                            nullptr)},
+        drain_map_(drains_),
+        log_service_(drain_map_),
+        multisink_(multisink_buffer_),
+        channels_{rpc::Channel::Create<kLeaderId>(&output_),
+                  rpc::Channel::Create<kFollowerId>(&output_)},
+        server_(channels_) {
+    leader().AddFollower(follower());
+    multisink_.AttachDrain(leader());
+  }
+
+  RpcLogDrain& leader() { return drains_[0]; }
+  RpcLogDrain& follower() { return drains_[1]; }
+
+  rpc::RawServerWriter OpenWriter(uint32_t channel_id) {
+    return rpc::RawServerWriter::Open<log::pw_rpc::raw::Logs::Listen>(
+        server_, channel_id, log_service_);
+  }
+
+  void AddLogEntries(const Vector<TestLogEntry>& entries) {
+    for (const TestLogEntry& entry : entries) {
+      Result<ConstByteSpan> encoded =
+          log::EncodeTokenizedLog(entry.metadata,
+                                  entry.tokenized_data,
+                                  entry.timestamp,
+                                  entry.thread,
+                                  log_encode_buffer_);
+      ASSERT_EQ(encoded.status(), OkStatus());
+      multisink_.HandleEntry(encoded.value());
+    }
+  }
+
+  void ExpectEntries(uint32_t channel_id,
+                     const Vector<TestLogEntry>& expected_entries) {
+    rpc::PayloadsView payloads =
+        output_.payloads<log::pw_rpc::raw::Logs::Listen>(channel_id);
+    ASSERT_EQ(payloads.size(), 1u);
+
+    uint32_t drop_count = 0;
+    size_t entries_count = 0;
+    protobuf::Decoder payload_decoder(payloads[0]);
+    VerifyLogEntries(
+        payload_decoder, expected_entries, 0, entries_count, drop_count);
+    EXPECT_EQ(drop_count, 0u);
+    EXPECT_EQ(entries_count, expected_entries.size());
+  }
+
+  static TestLogEntry BasicLog(std::string_view message) {
+    return {.metadata = kSampleMetadata,
+            .timestamp = 9000,
+            .dropped = 0,
+            .tokenized_data = std::as_bytes(std::span(message)),
+            .thread = {}};
+  }
+
+  static constexpr log_tokenized::Metadata kSampleMetadata =
+      log_tokenized::Metadata::Set<PW_LOG_LEVEL_INFO, 123, 0x03, 300>();
+
+  std::array<std::byte, kBufferSize> leader_buffer_;
+  std::array<std::byte, kBufferSize> follower_buffer_;
+  std::array<std::byte, 64> log_encode_buffer_;
+  std::array<std::byte, 128> encoding_buffer_;
+  sync::Mutex mutex_;
+  std::array<RpcLogDrain, 2> drains_;
+  RpcLogDrainMap drain_map_;
+  LogService log_service_;
+  std::array<std::byte, kBufferSize * 4> multisink_buffer_;
+  multisink::MultiSink multisink_;
+  rpc::RawFakeChannelOutput<6, 512> output_;
+  std::array<rpc::Channel, 2> channels_;
+  rpc::Server server_;
+};
+
+TEST_F(FollowerTest, FollowerSendsLeaderEntries) {
+  rpc::RawServerWriter leader_writer = OpenWriter(kLeaderId);
+  rpc::RawServerWriter follower_writer = OpenWriter(kFollowerId);
+  ASSERT_EQ(leader().Open(leader_writer), OkStatus());
+  ASSERT_EQ(follower().Open(follower_writer), OkStatus());
+
+  Vector<TestLogEntry, 2> expected{BasicLog("once"), BasicLog("twice")};
+  AddLogEntries(expected);
+
+  EXPECT_TRUE(follower().is_follower());
+  EXPECT_FALSE(leader().is_follower());
+  EXPECT_EQ(follower().Flush(encoding_buffer_), OkStatus());
+  EXPECT_EQ(output_.total_packets(), 0u);
+
+  EXPECT_EQ(leader().Flush(encoding_buffer_), OkStatus());
+  ExpectEntries(kLeaderId, expected);
+  ExpectEntries(kFollowerId, expected);
+  EXPECT_EQ(MetricValue(follower(), kSentEntriesMetric), 2u);
+}
+
+TEST_F(FollowerTest, LeaderDrainsForOpenFollower) {
+  rpc::RawServerWriter follower_writer = OpenWriter(kFollowerId);
+  ASSERT_EQ(follower().Open(follower_writer), OkStatus());
+
+  Vector<TestLogEntry, 1> expected{BasicLog("solo")};
+  AddLogEntries(expected);
+
+  EXPECT_EQ(leader().Flush(encoding_buffer_), OkStatus());
+  EXPECT_TRUE(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kLeaderId).empty());
+  ExpectEntries(kFollowerId, expected);
+}
+
+TEST_F(FollowerTest, NoWritersOpen_EntriesNotConsumed) {
+  AddLogEntries(Vector<TestLogEntry, 1>{BasicLog("kept")});
+  EXPECT_EQ(leader().Flush(encoding_buffer_), Status::Unavailable());
+  EXPECT_NE(leader().UnreadEntriesSize(), 0u);
+}
+
 TEST(RpcLogDrain, OnOpenCallbackCalled) {
   // Create drain and log components.
   const uint32_t drain_id = 1;
@@ -0,0 +1,508 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_string/deferred.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pw::log_string {
+namespace {
+
+static_assert(std::is_trivially_copyable_v<DeferredLogMetadata>);
+
+// Longest conversion specification that can be captured, including the '%'.
+constexpr size_t kMaxConversionLength = 32;
+
+// How an argument is read from the va_list, based on the conversion specifier
+// and length modifier.
+enum class ArgType {
+  kNone,  // %%
+  kInt,
+  kLong,
+  kLongLong,
+  kIntMax,
+  kSize,
+  kPtrDiff,
+  kDouble,
+  kLongDouble,
+  kString,
+  kPointer,
+  kUnsupported,
+};
+
+struct Conversion {
+  size_t length;   // Length of the specification, including the '%'.
+  int star_count;  // Number of int arguments consumed by '*' width/precision.
+  bool star_precision;
+  int precision;  // Literal precision, or -1 if not specified.
+  ArgType type;
+};
+
+enum class Length {
+  kNone,
+  kChar,
+  kShort,
+  kLong,
+  kLongLong,
+  kIntMax,
+  kSize,
+  kPtrDiff,
+  kLongDouble,
+};
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+ArgType IntegerType(Length length) {
+  switch (length) {
+    case Length::kNone:
+    case Length::kChar:
+    case Length::kShort:
+      return ArgType::kInt;  // Promoted to int when passed through varargs.
+    case Length::kLong:
+      return ArgType::kLong;
+    case Length::kLongLong:
+      return ArgType::kLongLong;
+    case Length::kIntMax:
+      return ArgType::kIntMax;
+    case Length::kSize:
+      return ArgType::kSize;
+    case Length::kPtrDiff:
+      return ArgType::kPtrDiff;
+    case Length::kLongDouble:
+      break;
+  }
+  return ArgType::kUnsupported;
+}
+
+// Parses the conversion specification starting at spec, which points to '%'.
+Conversion ParseConversion(const char* spec) {
+  Conversion conversion = {.length = 0,
+                           .star_count = 0,
+                           .star_precision = false,
+                           .precision = -1,
+                           .type = ArgType::kUnsupported};
+  const char* c = spec + 1;
+
+  while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') {
+    ++c;
+  }
+
+  if (*c == '*') {
+    conversion.star_count += 1;
+    ++c;
+  } else {
+    while (IsDigit(*c)) {
+      ++c;
+    }
+  }
+
+  if (*c == '.') {
+    ++c;
+    if (*c == '*') {
+      conversion.star_count += 1;
+      conversion.star_precision = true;
+      ++c;
+    } else {
+      conversion.precision = 0;
+      while (IsDigit(*c)) {
+        conversion.precision = conversion.precision * 10 + (*c - '0');
+        ++c;
+      }
+    }
+  }
+
+  Length length = Length::kNone;
+  switch (*c) {
+    case 'h':
+      length = Length::kShort;
+      if (*++c == 'h') {
+        length = Length::kChar;
+        ++c;
+      }
+      break;
+    case 'l':
+      length = Length::kLong;
+      if (*++c == 'l') {
+        length = Length::kLongLong;
+        ++c;
+      }
+      break;
+    case 'j':
+      length = Length::kIntMax;
+      ++c;
+      break;
+    case 'z':
+      length = Length::kSize;
+      ++c;
+      break;
+    case 't':
+      length = Length::kPtrDiff;
+      ++c;
+      break;
+    case 'L':
+      length = Length::kLongDouble;
+      ++c;
+      break;
+    default:
+      break;
+  }
+
+  switch (*c) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      conversion.type = IntegerType(length);
+      break;
+    case 'c':
+      if (length == Length::kNone) {
+        conversion.type = ArgType::kInt;
+      }
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      conversion.type = length == Length::kLongDouble ? ArgType::kLongDouble
+                                                      : ArgType::kDouble;
+      break;
+    case 's':
+      if (length == Length::kNone) {
+        conversion.type = ArgType::kString;
+      }
+      break;
+    case 'p':
+      conversion.type = ArgType::kPointer;
+      break;
+    case '%':
+      conversion.type = ArgType::kNone;
+      break;
+    default:  // %n, wide characters, or an incomplete specification.
+      break;
+  }
+
+  if (*c != '\0') {
+    ++c;
+  }
+  conversion.length = static_cast<size_t>(c - spec);
+  if (conversion.length > kMaxConversionLength) {
+    conversion.type = ArgType::kUnsupported;
+  }
+  return conversion;
+}
+
+class Writer {
+ public:
+  explicit constexpr Writer(ByteSpan buffer) : buffer_(buffer), size_(0) {}
+
+  template <typename T>
+  bool Write(const T& value) {
+    return WriteBytes(&value, sizeof(value));
+  }
+
+  bool WriteBytes(const void* data, size_t size) {
+    if (size > buffer_.size() - size_) {
+      return false;
+    }
+    std::memcpy(buffer_.data() + size_, data, size);
+    size_ += size;
+    return true;
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  ByteSpan buffer_;
+  size_t size_;
+};
+
+class Reader {
+ public:
+  explicit constexpr Reader(ConstByteSpan entry)
+      : entry_(entry), position_(0) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (sizeof(value) > entry_.size() - position_) {
+      return false;
+    }
+    std::memcpy(&value, entry_.data() + position_, sizeof(value));
+    position_ += sizeof(value);
+    return true;
+  }
+
+  // Returns a pointer to a null-terminated string in the entry, or nullptr if
+  // there is no terminator.
+  const char* ReadString() {
+    const char* string =
+        reinterpret_cast<const char*>(entry_.data() + position_);
+    const void* terminator =
+        std::memchr(string, '\0', entry_.size() - position_);
+    if (terminator == nullptr) {
+      return nullptr;
+    }
+    position_ += static_cast<const char*>(terminator) - string + 1;
+    return string;
+  }
+
+ private:
+  ConstByteSpan entry_;
+  size_t position_;
+};
+
+// Copies an argument of type T from the va_list to the writer.
+template <typename T>
+bool CaptureArgument(va_list& args, Writer& writer) {
+  return writer.Write(static_cast<T>(va_arg(args, T)));
+}
+
+bool CaptureString(const char* string, int precision, Writer& writer) {
+  if (string == nullptr) {
+    string = "(null)";
+  }
+  size_t length = 0;
+  // Don't read past the precision, since the string may not be terminated.
+  while ((precision < 0 || length < static_cast<size_t>(precision)) &&
+         string[length] != '\0') {
+    length += 1;
+  }
+  return writer.WriteBytes(string, length) && writer.Write('\0');
+}
+
+template <typename T>
+void FormatValue(const char* spec,
+                 const int* stars,
+                 int star_count,
+                 T value,
+                 StringBuilder& message) {
+  if (star_count == 0) {
+    message.Format(spec, value);
+  } else if (star_count == 1) {
+    message.Format(spec, stars[0], value);
+  } else {
+    message.Format(spec, stars[0], stars[1], value);
+  }
+}
+
+// Formats one argument of type T read from the reader.
+template <typename T>
+bool FormatArgument(Reader& reader,
+                    const char* spec,
+                    const int* stars,
+                    int star_count,
+                    StringBuilder& message) {
+  T value;
+  if (!reader.Read(value)) {
+    return false;
+  }
+  FormatValue(spec, stars, star_count, value, message);
+  return true;
+}
+
+bool FormatString(Reader& reader,
+                  const char* spec,
+                  const int* stars,
+                  int star_count,
+                  StringBuilder& message) {
+  const char* value = reader.ReadString();
+  if (value == nullptr) {
+    return false;
+  }
+  FormatValue(spec, stars, star_count, value, message);
+  return true;
+}
+
+// Copies the arguments for each conversion in the format string to the writer.
+Status CaptureArguments(const char* format, va_list& args, Writer& writer) {
+  for (const char* c = std::strchr(format, '%'); c != nullptr;) {
+    const Conversion conversion = ParseConversion(c);
+    if (conversion.type == ArgType::kUnsupported) {
+      return Status::InvalidArgument();
+    }
+
+    int precision = conversion.precision;
+    bool ok = true;
+    for (int i = 0; i < conversion.star_count; ++i) {
+      const int star = va_arg(args, int);
+      ok = ok && writer.Write(star);
+      // The precision is always the last '*' argument.
+      if (conversion.star_precision && i == conversion.star_count - 1) {
+        precision = star;
+      }
+    }
+
+    switch (conversion.type) {
+      case ArgType::kInt:
+        ok = ok && CaptureArgument<int>(args, writer);
+        break;
+      case ArgType::kLong:
+        ok = ok && CaptureArgument<long>(args, writer);
+        break;
+      case ArgType::kLongLong:
+        ok = ok && CaptureArgument<long long>(args, writer);
+        break;
+      case ArgType::kIntMax:
+        ok = ok && CaptureArgument<intmax_t>(args, writer);
+        break;
+      case ArgType::kSize:
+        ok = ok && CaptureArgument<size_t>(args, writer);
+        break;
+      case ArgType::kPtrDiff:
+        ok = ok && CaptureArgument<ptrdiff_t>(args, writer);
+        break;
+      case ArgType::kDouble:
+        ok = ok && CaptureArgument<double>(args, writer);
+        break;
+      case ArgType::kLongDouble:
+        ok = ok && CaptureArgument<long double>(args, writer);
+        break;
+      case ArgType::kString:
+        ok = ok && CaptureString(va_arg(args, const char*), precision, writer);
+        break;
+      case ArgType::kPointer:
+        ok = ok && CaptureArgument<const void*>(args, writer);
+        break;
+      case ArgType::kNone:
+      case ArgType::kUnsupported:
+        break;
+    }
+    if (!ok) {
+      return Status::ResourceExhausted();
+    }
+    c = std::strchr(c + conversion.length, '%');
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+StatusWithSize EncodeDeferredLog(const DeferredLogMetadata& metadata,
+                                 const char* format,
+                                 va_list args,
+                                 ByteSpan buffer) {
+  Writer writer(buffer);
+  if (!writer.Write(metadata) || !writer.Write(format)) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  // va_list may be an array type, so copy it to pass it by reference.
+  va_list args_copy;
+  va_copy(args_copy, args);
+  const Status status = CaptureArguments(format, args_copy, writer);
+  va_end(args_copy);
+
+  if (!status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  return StatusWithSize(writer.size());
+}
+
+Result<DeferredLogMetadata> FormatDeferredLog(ConstByteSpan entry,
+                                              StringBuilder& message) {
+  Reader reader(entry);
+  DeferredLogMetadata metadata;
+  const char* format;
+  if (!reader.Read(metadata) || !reader.Read(format) || format == nullptr) {
+    return Status::DataLoss();
+  }
+
+  const char* c = format;
+  while (*c != '\0') {
+    const char* percent = std::strchr(c, '%');
+    if (percent == nullptr) {
+      message.append(c);
+      break;
+    }
+    message.append(c, static_cast<size_t>(percent - c));
+
+    const Conversion conversion = ParseConversion(percent);
+    if (conversion.type == ArgType::kUnsupported) {
+      return Status::DataLoss();
+    }
+    char spec[kMaxConversionLength + 1];
+    std::memcpy(spec, percent, conversion.length);
+    spec[conversion.length] = '\0';
+
+    int stars[2] = {};
+    for (int i = 0; i < conversion.star_count; ++i) {
+      if (!reader.Read(stars[i])) {
+        return Status::DataLoss();
+      }
+    }
+
+    bool ok = true;
+    switch (conversion.type) {
+      case ArgType::kNone:
+        message.push_back('%');
+        break;
+      case ArgType::kInt:
+        ok = FormatArgument<int>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kLong:
+        ok = FormatArgument<long>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kLongLong:
+        ok = FormatArgument<long long>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kIntMax:
+        ok = FormatArgument<intmax_t>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kSize:
+        ok = FormatArgument<size_t>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kPtrDiff:
+        ok = FormatArgument<ptrdiff_t>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kDouble:
+        ok = FormatArgument<double>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kLongDouble:
+        ok = FormatArgument<long double>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kString:
+        ok = FormatString(reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kPointer:
+        ok = FormatArgument<const void*>(
+            reader, spec, stars, conversion.star_count, message);
+        break;
+      case ArgType::kUnsupported:
+        break;
+    }
+    if (!ok) {
+      return Status::DataLoss();
+    }
+    c = percent + conversion.length;
+  }
+  return metadata;
+}
+
+}  // namespace pw::log_string
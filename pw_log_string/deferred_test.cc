@@ -0,0 +1,166 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_string/deferred.h"
+
+#include <array>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "pw_log/levels.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::log_string {
+namespace {
+
+constexpr DeferredLogMetadata kMetadata = {
+    .level = PW_LOG_LEVEL_WARN,
+    .flags = 3,
+    .module_name = "TST",
+    .file_name = "deferred_test.cc",
+    .line_number = 42,
+};
+
+std::array<std::byte, 256> buffer;
+
+PW_PRINTF_FORMAT(2, 3)
+StatusWithSize Encode(ByteSpan out, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  StatusWithSize result = EncodeDeferredLog(kMetadata, format, args, out);
+  va_end(args);
+  return result;
+}
+
+// Encodes a log, then formats it and checks that the result matches a direct
+// call to snprintf.
+#define EXPECT_DEFERRED_FORMAT(format, ...)                             \
+  do {                                                                  \
+    const StatusWithSize encoded = Encode(buffer, format, __VA_ARGS__); \
+    ASSERT_EQ(encoded.status(), OkStatus());                            \
+    StringBuffer<128> message;                                          \
+    const Result<DeferredLogMetadata> metadata = FormatDeferredLog(     \
+        std::span(buffer).first(encoded.size()), message);              \
+    ASSERT_EQ(metadata.status(), OkStatus());                           \
+    char expected[128];                                                 \
+    std::snprintf(expected, sizeof(expected), format, __VA_ARGS__);     \
+    EXPECT_STREQ(message.c_str(), expected);                            \
+  } while (0)
+
+TEST(DeferredLog, Metadata) {
+  const StatusWithSize encoded = Encode(buffer, "no arguments");
+  ASSERT_EQ(encoded.status(), OkStatus());
+
+  StringBuffer<32> message;
+  const Result<DeferredLogMetadata> metadata =
+      FormatDeferredLog(std::span(buffer).first(encoded.size()), message);
+  ASSERT_EQ(metadata.status(), OkStatus());
+  EXPECT_EQ(metadata->level, PW_LOG_LEVEL_WARN);
+  EXPECT_EQ(metadata->flags, 3u);
+  EXPECT_STREQ(metadata->module_name, "TST");
+  EXPECT_STREQ(metadata->file_name, "deferred_test.cc");
+  EXPECT_EQ(metadata->line_number, 42);
+  EXPECT_STREQ(message.c_str(), "no arguments");
+}
+
+TEST(DeferredLog, Integers) {
+  EXPECT_DEFERRED_FORMAT("%d %i %u %x %c", -1, 2, 3u, 0xabu, 'z');
+  EXPECT_DEFERRED_FORMAT("%hhd %hd %ld", 1, 2, -3l);
+  EXPECT_DEFERRED_FORMAT("%lld %llu", -123456789012ll, 123456789012ull);
+  EXPECT_DEFERRED_FORMAT(
+      "%zu %td %jd", sizeof(int), ptrdiff_t{-5}, intmax_t{6});
+  EXPECT_DEFERRED_FORMAT("100%% %05d", 7);
+}
+
+TEST(DeferredLog, FloatingPoint) {
+  EXPECT_DEFERRED_FORMAT("%f %.2e %g", 1.5, 12345.678, 0.25);
+  EXPECT_DEFERRED_FORMAT("%Lf", 2.5l);
+}
+
+TEST(DeferredLog, StarWidthAndPrecision) {
+  EXPECT_DEFERRED_FORMAT(
+      "[%*d] [%.*f] [%*.*s]", 5, 12, 1, 3.14159, 6, 2, "abc");
+}
+
+TEST(DeferredLog, StringsAreCopied) {
+  char string[] = "before";
+  const StatusWithSize encoded = Encode(buffer, "%s|%.3s", string, "abcdef");
+  ASSERT_EQ(encoded.status(), OkStatus());
+  std::strcpy(string, "after!");
+
+  StringBuffer<32> message;
+  ASSERT_EQ(
+      FormatDeferredLog(std::span(buffer).first(encoded.size()), message)
+          .status(),
+      OkStatus());
+  EXPECT_STREQ(message.c_str(), "before|abc");
+}
+
+TEST(DeferredLog, Pointer) {
+  int value = 0;
+  EXPECT_DEFERRED_FORMAT("%p", static_cast<void*>(&value));
+}
+
+TEST(DeferredLog, BufferTooSmall) {
+  std::array<std::byte, sizeof(DeferredLogMetadata)> small_buffer;
+  EXPECT_EQ(Encode(small_buffer, "hello").status(),
+            Status::ResourceExhausted());
+
+  const std::string long_string(buffer.size(), 'a');
+  EXPECT_EQ(Encode(buffer, "%s", long_string.c_str()).status(),
+            Status::ResourceExhausted());
+}
+
+TEST(DeferredLog, UnsupportedConversion) {
+  int count = 0;
+  EXPECT_EQ(Encode(buffer, "abc%n", &count).status(),
+            Status::InvalidArgument());
+  EXPECT_EQ(Encode(buffer, "%ls", L"wide").status(),
+            Status::InvalidArgument());
+}
+
+TEST(DeferredLog, TruncatedEntry) {
+  const StatusWithSize encoded = Encode(buffer, "%d %s", 1, "two");
+  ASSERT_EQ(encoded.status(), OkStatus());
+
+  StringBuffer<32> message;
+  EXPECT_EQ(
+      FormatDeferredLog(std::span(buffer).first(encoded.size() - 1), message)
+          .status(),
+      Status::DataLoss());
+  EXPECT_EQ(FormatDeferredLog(std::span(buffer).first(4), message).status(),
+            Status::DataLoss());
+}
+
+TEST(DeferredLog, MessageTruncated) {
+  const StatusWithSize encoded = Encode(buffer, "%s", "a long message");
+  ASSERT_EQ(encoded.status(), OkStatus());
+
+  StringBuffer<8> message;
+  const Result<DeferredLogMetadata> metadata =
+      FormatDeferredLog(std::span(buffer).first(encoded.size()), message);
+  EXPECT_EQ(metadata.status(), OkStatus());
+  EXPECT_EQ(message.status(), Status::ResourceExhausted());
+  EXPECT_STREQ(message.c_str(), "a long ");
+}
+
+}  // namespace
+}  // namespace pw::log_string
@@ -0,0 +1,65 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdarg>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status_with_size.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::log_string {
+
+// The attributes of a log passed to pw_log_string_HandleMessageVaList.
+struct DeferredLogMetadata {
+  int level;
+  unsigned int flags;
+  const char* module_name;
+  const char* file_name;
+  int line_number;
+};
+
+// Captures a log without formatting it, so that it can be formatted later with
+// FormatDeferredLog, for example from a low-priority thread. This is intended
+// to be called from pw_log_string_HandleMessageVaList.
+//
+// The metadata strings and the format string are stored as pointers, so they
+// must outlive the captured log. This is the case for the string literals
+// passed by the pw_log macros. Arguments are copied, including the contents of
+// %s strings. The args va_list is consumed.
+//
+// Returns the number of bytes written to buffer on success.
+//
+// Return values:
+// OK - The log was captured.
+// RESOURCE_EXHAUSTED - The buffer is too small to hold the log.
+// INVALID_ARGUMENT - The format string has an unsupported conversion (%n).
+StatusWithSize EncodeDeferredLog(const DeferredLogMetadata& metadata,
+                                 const char* format,
+                                 va_list args,
+                                 ByteSpan buffer);
+
+// Formats a log captured with EncodeDeferredLog, appending the message to the
+// provided StringBuilder. Must be called in the same program that captured it.
+// If the message does not fit, it is truncated and the StringBuilder's status
+// is set to RESOURCE_EXHAUSTED.
+//
+// Return values:
+// OK - The log's metadata. The message was written to message.
+// DATA_LOSS - The captured log is malformed.
+Result<DeferredLogMetadata> FormatDeferredLog(ConstByteSpan entry,
+                                              StringBuilder& message);
+
+}  // namespace pw::log_string
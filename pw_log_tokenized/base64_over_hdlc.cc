@@ -17,10 +17,17 @@
 
 #include "pw_log_tokenized/base64_over_hdlc.h"
 
+#include <array>
+#include <mutex>
 #include <span>
 
+#include "pw_bytes/span.h"
 #include "pw_hdlc/encoder.h"
+#include "pw_log_tokenized/metadata.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/sys_io_stream.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
 #include "pw_tokenizer/base64.h"
 #include "pw_tokenizer/tokenize_to_global_handler_with_payload.h"
 
@@ -29,11 +36,69 @@ namespace {
 
 stream::SysIoWriter writer;
 
+#if PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
+
+// Logs may come from any thread or interrupt, so frames are collected in two
+// buffers. The lock is only held to append a frame to the active buffer or to
+// swap the buffers; the full buffer is written to sys_io outside of the lock.
+sync::InterruptSpinLock buffer_lock;
+using LogBuffer =
+    std::array<std::byte, PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES>;
+std::array<LogBuffer, 2> buffers PW_GUARDED_BY(buffer_lock);
+size_t active_buffer PW_GUARDED_BY(buffer_lock) = 0;
+size_t active_buffer_size PW_GUARDED_BY(buffer_lock) = 0;
+
+// Set while the inactive buffer is written to sys_io. Only one context writes
+// out a buffer at a time, which keeps frames in order.
+bool flushing PW_GUARDED_BY(buffer_lock) = false;
+
+// HDLC-encodes a frame into the active buffer. Returns false if it does not
+// fit in the space left.
+bool AppendFrame(ConstByteSpan frame) {
+  std::lock_guard lock(buffer_lock);
+  stream::MemoryWriter buffer(buffers[active_buffer], active_buffer_size);
+  const Status status = hdlc::WriteUIFrame(
+      PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS, frame, buffer);
+  if (status.ok()) {
+    active_buffer_size = buffer.size();
+  }
+  return status.ok();
+}
+
+#endif  // PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
+
 }  // namespace
 
+Status FlushBase64OverHdlcLogs() {
+#if PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
+  ConstByteSpan data;
+  {
+    std::lock_guard lock(buffer_lock);
+    if (flushing) {
+      return Status::Unavailable();
+    }
+    if (active_buffer_size == 0u) {
+      return OkStatus();
+    }
+    data = std::span(buffers[active_buffer]).first(active_buffer_size);
+    active_buffer ^= 1;
+    active_buffer_size = 0;
+    flushing = true;
+  }
+
+  const Status status = writer.Write(data);
+
+  std::lock_guard lock(buffer_lock);
+  flushing = false;
+  return status;
+#else
+  return OkStatus();
+#endif  // PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
+}
+
 // Base64-encodes tokenized logs and writes them to pw::sys_io as HDLC frames.
 extern "C" void pw_tokenizer_HandleEncodedMessageWithPayload(
-    pw_tokenizer_Payload,  // TODO(hepler): Use the metadata for filtering.
+    pw_tokenizer_Payload payload,
     const uint8_t log_buffer[],
     size_t size_bytes) {
   // Encode the tokenized message as Base64.
@@ -42,10 +107,28 @@ extern "C" void pw_tokenizer_HandleEncodedMessageWithPayload(
       std::span(log_buffer, size_bytes), base64_buffer);
   base64_buffer[base64_bytes] = '\0';
 
+  const ConstByteSpan frame =
+      std::as_bytes(std::span(base64_buffer, base64_bytes));
+
+#if PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
+  // HDLC-encode the Base64 string into the buffer, which is written to sys_io
+  // when it fills. If the frame does not fit in an empty buffer, it is written
+  // to sys_io directly. If another context is still writing out the other
+  // buffer, the log is dropped rather than waiting for sys_io.
+  if (!AppendFrame(frame) && FlushBase64OverHdlcLogs().ok() &&
+      !AppendFrame(frame)) {
+    hdlc::WriteUIFrame(PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS, frame, writer);
+  }
+
+  if (Metadata(payload).level() >= PW_LOG_TOKENIZED_BASE64_LOG_FLUSH_LEVEL) {
+    FlushBase64OverHdlcLogs();
+  }
+#else
+  static_cast<void>(payload);  // TODO(hepler): Use the metadata for filtering.
+
   // HDLC-encode the Base64 string via a SysIoWriter.
-  hdlc::WriteUIFrame(PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS,
-                     std::as_bytes(std::span(base64_buffer, base64_bytes)),
-                     writer);
+  hdlc::WriteUIFrame(PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS, frame, writer);
+#endif  // PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES > 0
 }
 
 }  // namespace pw::log_tokenized
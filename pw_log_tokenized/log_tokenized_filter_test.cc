@@ -0,0 +1,101 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "log module name!"
+
+// Configure the module so that the test runs against known values.
+#undef PW_LOG_TOKENIZED_LEVEL_BITS
+#undef PW_LOG_TOKENIZED_MODULE_BITS
+#undef PW_LOG_TOKENIZED_FLAG_BITS
+#undef PW_LOG_TOKENIZED_LINE_BITS
+#undef PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER
+
+#define PW_LOG_TOKENIZED_LEVEL_BITS 3
+#define PW_LOG_TOKENIZED_MODULE_BITS 16
+#define PW_LOG_TOKENIZED_FLAG_BITS 2
+#define PW_LOG_TOKENIZED_LINE_BITS 11
+#define PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER 1
+
+#include "gtest/gtest.h"
+#include "pw_log_tokenized/log_tokenized.h"
+#include "pw_log_tokenized_private/test_utils.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+// Logs below this level are dropped by the producer filter.
+uint32_t min_level = 0;
+size_t filter_calls = 0;
+uintptr_t last_filtered_metadata = 0;
+
+}  // namespace
+
+extern "C" bool pw_log_tokenized_ShouldDropLog(pw_tokenizer_Payload metadata) {
+  filter_calls += 1;
+  last_filtered_metadata = metadata;
+  return Metadata(metadata).level() < min_level;
+}
+
+namespace {
+
+constexpr uintptr_t kModuleToken =
+    PW_TOKENIZER_STRING_TOKEN(PW_LOG_MODULE_NAME) &
+    ((1u << PW_LOG_TOKENIZED_MODULE_BITS) - 1);
+
+class LogTokenizedFilter : public ::testing::Test {
+ protected:
+  LogTokenizedFilter() {
+    min_level = 0;
+    filter_calls = 0;
+    last_filtered_metadata = 0;
+    last_log = {};
+  }
+};
+
+TEST_F(LogTokenizedFilter, KeptLog_IsEncoded) {
+  min_level = 3;
+  PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD(3, 1, "hello %d", 1);
+
+  EXPECT_EQ(filter_calls, 1u);
+  EXPECT_EQ(last_log.metadata, last_filtered_metadata);
+  EXPECT_EQ(last_log.arg_count, 1u);
+
+  Metadata metadata(last_filtered_metadata);
+  EXPECT_EQ(metadata.level(), 3u);
+  EXPECT_EQ(metadata.flags(), 1u);
+  EXPECT_EQ(metadata.module(), kModuleToken);
+}
+
+TEST_F(LogTokenizedFilter, DroppedLog_IsNotEncoded) {
+  min_level = 3;
+  PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD(2, 0, "hello");
+
+  EXPECT_EQ(filter_calls, 1u);
+  EXPECT_EQ(Metadata(last_filtered_metadata).level(), 2u);
+  EXPECT_EQ(last_log.format_string, nullptr);
+}
+
+TEST_F(LogTokenizedFilter, DroppedLog_ArgumentsAreNotEvaluated) {
+  min_level = 7;
+  int evaluations = 0;
+  PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD(1, 0, "%d", ++evaluations);
+  EXPECT_EQ(evaluations, 0);
+
+  PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD(7, 0, "%d", ++evaluations);
+  EXPECT_EQ(evaluations, 1);
+  EXPECT_EQ(filter_calls, 2u);
+}
+
+}  // namespace
+}  // namespace pw::log_tokenized
@@ -13,7 +13,43 @@
 // the License.
 #pragma once
 
+#include "pw_log/levels.h"
+
 // The HDLC address to which to write Base64-encoded tokenized logs.
 #ifndef PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS
 #define PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS 1
 #endif  // PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS
+
+// The size of a buffer in which Base64-encoded HDLC log frames are collected
+// before they are written to pw::sys_io. Buffering writes whole chunks of
+// several frames at a time instead of writing each frame in many small writes.
+// Two buffers of this size are allocated, so that logs can be collected in one
+// while the other is written. If 0, frames are written to pw::sys_io without
+// buffering.
+#ifndef PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES
+#define PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES 0
+#endif  // PW_LOG_TOKENIZED_BASE64_LOG_BUFFER_SIZE_BYTES
+
+// Buffered logs at or above this level are flushed immediately, so that they
+// are seen even if the device stops before the buffer is flushed.
+#ifndef PW_LOG_TOKENIZED_BASE64_LOG_FLUSH_LEVEL
+#define PW_LOG_TOKENIZED_BASE64_LOG_FLUSH_LEVEL PW_LOG_LEVEL_ERROR
+#endif  // PW_LOG_TOKENIZED_BASE64_LOG_FLUSH_LEVEL
+
+#ifdef __cplusplus
+
+#include "pw_status/status.h"
+
+namespace pw::log_tokenized {
+
+// Writes buffered log frames to pw::sys_io. Call this periodically, such as
+// from a low-priority thread or timer, so that buffered logs are not delayed
+// until the buffer fills. Does nothing if logs are not buffered.
+//
+// Returns the pw::sys_io write status, or UNAVAILABLE if another thread or
+// interrupt is already writing buffered logs.
+Status FlushBase64OverHdlcLogs();
+
+}  // namespace pw::log_tokenized
+
+#endif  // __cplusplus
@@ -80,3 +80,11 @@ static_assert((PW_LOG_TOKENIZED_LEVEL_BITS + PW_LOG_TOKENIZED_LINE_BITS +
 #define PW_LOG_TOKENIZED_ENCODE_MESSAGE \
   PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD
 #endif  // PW_LOG_TOKENIZED_ENCODE_MESSAGE
+
+// When enabled, PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD calls
+// pw_log_tokenized_ShouldDropLog with the log's metadata before encoding it.
+// Logs for which it returns true are never tokenized or passed to the handler.
+// The function must be implemented by the project (see log_tokenized.h).
+#ifndef PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER
+#define PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER 0
+#endif  // PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER
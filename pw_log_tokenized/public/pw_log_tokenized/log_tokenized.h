@@ -13,9 +13,11 @@
 // the License.
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "pw_log_tokenized/config.h"
+#include "pw_preprocessor/util.h"
 #include "pw_tokenizer/tokenize_to_global_handler_with_payload.h"
 
 // TODO(hepler): Remove this include.
@@ -47,6 +49,8 @@
 //     }
 //   }
 //
+// If PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER is set, the metadata is first
+// passed to pw_log_tokenized_ShouldDropLog. Logs it rejects are not encoded.
 #define PW_LOG_TOKENIZED_TO_GLOBAL_HANDLER_WITH_PAYLOAD(                     \
     level, flags, message, ...)                                              \
   do {                                                                       \
@@ -55,14 +59,38 @@
                                 ((1u << PW_LOG_TOKENIZED_MODULE_BITS) - 1u), \
                                 PW_LOG_MODULE_NAME);                         \
     const uintptr_t _pw_log_tokenized_level = level;                         \
-    PW_LOG_TOKENIZED_ENCODE_MESSAGE(                                         \
+    const uintptr_t _pw_log_tokenized_payload =                              \
         (_PW_LOG_TOKENIZED_LEVEL(_pw_log_tokenized_level) |                  \
          _PW_LOG_TOKENIZED_MODULE(_pw_log_tokenized_module_token) |          \
-         _PW_LOG_TOKENIZED_FLAGS(flags) | _PW_LOG_TOKENIZED_LINE(__LINE__)), \
-        PW_LOG_TOKENIZED_FORMAT_STRING(message),                             \
-        __VA_ARGS__);                                                        \
+         _PW_LOG_TOKENIZED_FLAGS(flags) | _PW_LOG_TOKENIZED_LINE(__LINE__)); \
+    if (!_PW_LOG_TOKENIZED_SHOULD_DROP(_pw_log_tokenized_payload)) {         \
+      PW_LOG_TOKENIZED_ENCODE_MESSAGE(                                       \
+          _pw_log_tokenized_payload,                                         \
+          PW_LOG_TOKENIZED_FORMAT_STRING(message),                           \
+          __VA_ARGS__);                                                      \
+    }                                                                        \
   } while (0)
 
+#if PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER
+
+PW_EXTERN_C_START
+
+// Called with the packed log metadata before a log is tokenized. Returns true
+// if no consumer wants the log, in which case it is dropped without being
+// encoded. The metadata can be read with pw::log_tokenized::Metadata.
+//
+// This function may be called from any context that logs, so it must not log
+// and should be fast.
+bool pw_log_tokenized_ShouldDropLog(pw_tokenizer_Payload metadata);
+
+PW_EXTERN_C_END
+
+#define _PW_LOG_TOKENIZED_SHOULD_DROP(payload) \
+  pw_log_tokenized_ShouldDropLog(payload)
+#else
+#define _PW_LOG_TOKENIZED_SHOULD_DROP(payload) 0
+#endif  // PW_LOG_TOKENIZED_ENABLE_PRODUCER_FILTER
+
 // If the level field is present, clamp it to the maximum value.
 #if PW_LOG_TOKENIZED_LEVEL_BITS == 0
 #define _PW_LOG_TOKENIZED_LEVEL(value) ((uintptr_t)0)
@@ -12,17 +12,158 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include "pw_malloc_freelist/freelist_malloc.h"
+
+#include <cstring>
+#include <limits>
+#include <mutex>
 #include <span>
 
+#include "pw_allocator/block.h"
 #include "pw_allocator/freelist_heap.h"
 #include "pw_malloc/malloc.h"
+#include "pw_malloc_freelist/config.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
+#include "pw_sync/interrupt_spin_lock.h"
 
 namespace {
 std::aligned_storage_t<sizeof(pw::allocator::FreeListHeapBuffer<>),
                        alignof(pw::allocator::FreeListHeapBuffer<>)>
     buf;
+
+// Guards pw_freelist_heap. An InterruptSpinLock is used since malloc may be
+// called before the scheduler starts.
+pw::sync::InterruptSpinLock heap_lock;
+
+void* HeapAllocate(size_t size) {
+  std::lock_guard lock(heap_lock);
+  return pw_freelist_heap->Allocate(size);
+}
+
+void HeapFree(void* ptr) {
+  std::lock_guard lock(heap_lock);
+  pw_freelist_heap->Free(ptr);
+}
+
+void* Realloc(void* ptr, size_t size) {
+  std::lock_guard lock(heap_lock);
+  return pw_freelist_heap->Realloc(ptr, size);
+}
+
+#if PW_MALLOC_FREELIST_THREAD_CACHE
+
+constexpr size_t kStep = PW_MALLOC_FREELIST_THREAD_CACHE_STEP;
+constexpr size_t kClassCount = PW_MALLOC_FREELIST_THREAD_CACHE_MAX_SIZE / kStep;
+constexpr size_t kDepth = PW_MALLOC_FREELIST_THREAD_CACHE_DEPTH;
+
+static_assert(kClassCount > 0,
+              "PW_MALLOC_FREELIST_THREAD_CACHE_MAX_SIZE must be at least "
+              "PW_MALLOC_FREELIST_THREAD_CACHE_STEP");
+
+// Small freed blocks held by one thread. Class N holds blocks with at least
+// (N + 1) * kStep bytes of usable space.
+//
+// ThreadCache is trivially destructible, so its storage remains valid while
+// the thread's other thread_local objects are destroyed. ThreadCacheFlusher
+// returns the cached blocks to the heap when the thread exits.
+struct ThreadCache {
+  void* blocks[kClassCount][kDepth];
+  uint8_t counts[kClassCount];
+  bool flusher_registered;
+  bool exited;
+};
+
+thread_local ThreadCache thread_cache;
+
+void FlushThreadCache() {
+  std::lock_guard lock(heap_lock);
+  for (size_t i = 0; i < kClassCount; ++i) {
+    while (thread_cache.counts[i] > 0) {
+      pw_freelist_heap->Free(thread_cache.blocks[i][--thread_cache.counts[i]]);
+    }
+  }
+}
+
+struct ThreadCacheFlusher {
+  ~ThreadCacheFlusher() {
+    FlushThreadCache();
+    // Blocks freed later during thread exit go directly to the heap.
+    thread_cache.exited = true;
+  }
+};
+
+thread_local ThreadCacheFlusher thread_cache_flusher;
+
+void RegisterThreadCacheFlusher() {
+  // Registering a thread_local destructor may allocate, so mark the flusher as
+  // registered first to avoid recursing.
+  thread_cache.flusher_registered = true;
+  static_cast<void>(&thread_cache_flusher);
+}
+
+void* Allocate(size_t size) {
+  if (size == 0 || size > kClassCount * kStep || thread_cache.exited) {
+    return HeapAllocate(size);
+  }
+
+  const size_t size_class = (size - 1) / kStep;
+  if (thread_cache.counts[size_class] > 0) {
+    return thread_cache.blocks[size_class][--thread_cache.counts[size_class]];
+  }
+  // Allocate the full class size, so the block can be reused for any request
+  // in its class once it is cached.
+  return HeapAllocate((size_class + 1) * kStep);
+}
+
+void Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (!thread_cache.exited) {
+    const size_t inner_size =
+        pw::allocator::Block::FromUsableSpace(static_cast<std::byte*>(ptr))
+            ->InnerSize();
+    // Larger blocks are returned to the heap, which bounds the cache size.
+    if (inner_size >= kStep && inner_size < (kClassCount + 1) * kStep) {
+      const size_t size_class = inner_size / kStep - 1;
+      if (thread_cache.counts[size_class] < kDepth) {
+        if (!thread_cache.flusher_registered) {
+          RegisterThreadCacheFlusher();
+        }
+        thread_cache.blocks[size_class][thread_cache.counts[size_class]++] =
+            ptr;
+        return;
+      }
+    }
+  }
+  HeapFree(ptr);
+}
+
+void* Calloc(size_t num, size_t size) {
+  if (size != 0 && num > std::numeric_limits<size_t>::max() / size) {
+    return nullptr;
+  }
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
+#else
+
+void* Allocate(size_t size) { return HeapAllocate(size); }
+
+void Free(void* ptr) { HeapFree(ptr); }
+
+void* Calloc(size_t num, size_t size) {
+  std::lock_guard lock(heap_lock);
+  return pw_freelist_heap->Calloc(num, size);
+}
+
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE
+
 }  // namespace
 pw::allocator::FreeListHeapBuffer<>* pw_freelist_heap;
 
@@ -38,35 +179,35 @@ void pw_MallocInit(uint8_t* heap_low_addr, uint8_t* heap_high_addr) {
       pw::allocator::FreeListHeapBuffer(pw_allocator_freelist_raw_heap);
 }
 
+void pw_MallocFreelistFlushThreadCache(void) {
+#if PW_MALLOC_FREELIST_THREAD_CACHE
+  FlushThreadCache();
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE
+}
+
 // Wrapper functions for malloc, free, realloc and calloc.
 // With linker options "-Wl --wrap=<function name>", linker will link
 // "__wrap_<function name>" with "<function_name>", and calling
 // "<function name>" will call "__wrap_<function name>" instead
 // Linker options are set in a config in "pw_malloc:pw_malloc_config".
-void* __wrap_malloc(size_t size) { return pw_freelist_heap->Allocate(size); }
+void* __wrap_malloc(size_t size) { return Allocate(size); }
 
-void __wrap_free(void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap_free(void* ptr) { Free(ptr); }
 
-void* __wrap_realloc(void* ptr, size_t size) {
-  return pw_freelist_heap->Realloc(ptr, size);
-}
+void* __wrap_realloc(void* ptr, size_t size) { return Realloc(ptr, size); }
 
-void* __wrap_calloc(size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
-}
+void* __wrap_calloc(size_t num, size_t size) { return Calloc(num, size); }
 
-void* __wrap__malloc_r(struct _reent*, size_t size) {
-  return pw_freelist_heap->Allocate(size);
-}
+void* __wrap__malloc_r(struct _reent*, size_t size) { return Allocate(size); }
 
-void __wrap__free_r(struct _reent*, void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap__free_r(struct _reent*, void* ptr) { Free(ptr); }
 
 void* __wrap__realloc_r(struct _reent*, void* ptr, size_t size) {
-  return pw_freelist_heap->Realloc(ptr, size);
+  return Realloc(ptr, size);
 }
 
 void* __wrap__calloc_r(struct _reent*, size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
+  return Calloc(num, size);
 }
 #if __cplusplus
 }
@@ -19,6 +19,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_allocator/freelist_heap.h"
+#include "pw_malloc_freelist/config.h"
 
 namespace pw::allocator {
 
@@ -68,4 +69,36 @@ TEST(FreeListMalloc, ReplacingMalloc) {
             kAllocSize + kReallocSize + kCallocNum * kCallocSize);
 }
 
+#if PW_MALLOC_FREELIST_THREAD_CACHE
+
+TEST(FreeListMalloc, ThreadCacheReusesSmallBlocks) {
+  constexpr size_t kSmallSize = 24;
+  const FreeListHeap::HeapStats& freelist_heap_stats =
+      pw_freelist_heap->heap_stats();
+  // Warm up the cache, since the first cached free may allocate to register
+  // the thread exit handler.
+  free(malloc(kSmallSize));
+  pw_MallocFreelistFlushThreadCache();
+  const size_t bytes_allocated = freelist_heap_stats.bytes_allocated;
+
+  void* ptr = malloc(kSmallSize);
+  ASSERT_NE(ptr, nullptr);
+  const size_t total_free_calls = freelist_heap_stats.total_free_calls;
+
+  // The block stays in the thread cache instead of returning to the heap.
+  free(ptr);
+  EXPECT_EQ(freelist_heap_stats.total_free_calls, total_free_calls);
+
+  // A request in the same size class reuses the cached block.
+  void* reused = malloc(kSmallSize - 4);
+  EXPECT_EQ(reused, ptr);
+  free(reused);
+
+  pw_MallocFreelistFlushThreadCache();
+  EXPECT_EQ(freelist_heap_stats.total_free_calls, total_free_calls + 1);
+  EXPECT_EQ(freelist_heap_stats.bytes_allocated, bytes_allocated);
+}
+
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE
+
 }  // namespace pw::allocator
@@ -0,0 +1,40 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Whether each thread keeps a cache of small freed blocks in front of the
+// shared heap. Cached blocks are reused without taking the heap lock. This
+// requires thread_local support from the toolchain.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE
+#define PW_MALLOC_FREELIST_THREAD_CACHE 0
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE
+
+// The largest allocation size, in bytes, served from the thread cache. Cached
+// blocks are sorted into size classes of PW_MALLOC_FREELIST_THREAD_CACHE_STEP
+// bytes up to this size.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_MAX_SIZE
+#define PW_MALLOC_FREELIST_THREAD_CACHE_MAX_SIZE 128
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_MAX_SIZE
+
+// The size class granularity of the thread cache, in bytes.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_STEP
+#define PW_MALLOC_FREELIST_THREAD_CACHE_STEP 16
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_STEP
+
+// The maximum number of blocks each thread caches per size class. When a class
+// is full, freed blocks go back to the shared heap. Each thread holds at most
+// this many blocks of each class, which bounds the memory held by the caches.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_DEPTH
+#define PW_MALLOC_FREELIST_THREAD_CACHE_DEPTH 8
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_DEPTH
@@ -17,3 +17,17 @@
 
 // Global variables to initialize a freelist heap.
 extern pw::allocator::FreeListHeapBuffer<>* pw_freelist_heap;
+
+#if __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns the blocks in the calling thread's cache to the shared heap. Blocks
+// are flushed automatically when a thread exits, but threads on RTOSes without
+// thread_local destructors should call this before they exit. Does nothing if
+// PW_MALLOC_FREELIST_THREAD_CACHE is disabled.
+void pw_MallocFreelistFlushThreadCache(void);
+
+#if __cplusplus
+}
+#endif  // __cplusplus
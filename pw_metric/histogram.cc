@@ -0,0 +1,110 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include <array>
+#include <cstddef>
+
+#include "pw_assert/check.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric::internal {
+namespace {
+
+// Tokenizes the name of each bucket, which is the bucket's lower bound.
+#define _PW_METRIC_HISTOGRAM_BUCKET(index, lower_bound)     \
+  constexpr Token kBucket##index = PW_TOKENIZE_STRING_MASK( \
+      "metrics", _PW_METRIC_TOKEN_MASK, "ge_" #lower_bound)
+
+_PW_METRIC_HISTOGRAM_BUCKET(0, 0);
+_PW_METRIC_HISTOGRAM_BUCKET(1, 1);
+_PW_METRIC_HISTOGRAM_BUCKET(2, 2);
+_PW_METRIC_HISTOGRAM_BUCKET(3, 4);
+_PW_METRIC_HISTOGRAM_BUCKET(4, 8);
+_PW_METRIC_HISTOGRAM_BUCKET(5, 16);
+_PW_METRIC_HISTOGRAM_BUCKET(6, 32);
+_PW_METRIC_HISTOGRAM_BUCKET(7, 64);
+_PW_METRIC_HISTOGRAM_BUCKET(8, 128);
+_PW_METRIC_HISTOGRAM_BUCKET(9, 256);
+_PW_METRIC_HISTOGRAM_BUCKET(10, 512);
+_PW_METRIC_HISTOGRAM_BUCKET(11, 1024);
+_PW_METRIC_HISTOGRAM_BUCKET(12, 2048);
+_PW_METRIC_HISTOGRAM_BUCKET(13, 4096);
+_PW_METRIC_HISTOGRAM_BUCKET(14, 8192);
+_PW_METRIC_HISTOGRAM_BUCKET(15, 16384);
+_PW_METRIC_HISTOGRAM_BUCKET(16, 32768);
+_PW_METRIC_HISTOGRAM_BUCKET(17, 65536);
+_PW_METRIC_HISTOGRAM_BUCKET(18, 131072);
+_PW_METRIC_HISTOGRAM_BUCKET(19, 262144);
+_PW_METRIC_HISTOGRAM_BUCKET(20, 524288);
+_PW_METRIC_HISTOGRAM_BUCKET(21, 1048576);
+_PW_METRIC_HISTOGRAM_BUCKET(22, 2097152);
+_PW_METRIC_HISTOGRAM_BUCKET(23, 4194304);
+_PW_METRIC_HISTOGRAM_BUCKET(24, 8388608);
+_PW_METRIC_HISTOGRAM_BUCKET(25, 16777216);
+_PW_METRIC_HISTOGRAM_BUCKET(26, 33554432);
+_PW_METRIC_HISTOGRAM_BUCKET(27, 67108864);
+_PW_METRIC_HISTOGRAM_BUCKET(28, 134217728);
+_PW_METRIC_HISTOGRAM_BUCKET(29, 268435456);
+_PW_METRIC_HISTOGRAM_BUCKET(30, 536870912);
+_PW_METRIC_HISTOGRAM_BUCKET(31, 1073741824);
+_PW_METRIC_HISTOGRAM_BUCKET(32, 2147483648);
+
+#undef _PW_METRIC_HISTOGRAM_BUCKET
+
+constexpr std::array<Token, 33> kBucketNames = {
+    kBucket0,
+    kBucket1,
+    kBucket2,
+    kBucket3,
+    kBucket4,
+    kBucket5,
+    kBucket6,
+    kBucket7,
+    kBucket8,
+    kBucket9,
+    kBucket10,
+    kBucket11,
+    kBucket12,
+    kBucket13,
+    kBucket14,
+    kBucket15,
+    kBucket16,
+    kBucket17,
+    kBucket18,
+    kBucket19,
+    kBucket20,
+    kBucket21,
+    kBucket22,
+    kBucket23,
+    kBucket24,
+    kBucket25,
+    kBucket26,
+    kBucket27,
+    kBucket28,
+    kBucket29,
+    kBucket30,
+    kBucket31,
+    kBucket32,
+};
+
+}  // namespace
+
+Token HistogramBucketName(size_t index) {
+  PW_DCHECK_UINT_LT(index, kBucketNames.size());
+  return kBucketNames[index];
+}
+
+}  // namespace pw::metric::internal
@@ -0,0 +1,121 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_metric/metric.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(Histogram, BucketIndex) {
+  using Histogram33 = Histogram<33>;
+  static_assert(Histogram33::BucketIndex(0) == 0u);
+  static_assert(Histogram33::BucketIndex(1) == 1u);
+  static_assert(Histogram33::BucketIndex(2) == 2u);
+  static_assert(Histogram33::BucketIndex(3) == 2u);
+  static_assert(Histogram33::BucketIndex(4) == 3u);
+  static_assert(Histogram33::BucketIndex(1023) == 10u);
+  static_assert(Histogram33::BucketIndex(1024) == 11u);
+  static_assert(Histogram33::BucketIndex(UINT32_MAX) == 32u);
+
+  // Large values are counted in the last bucket.
+  static_assert(Histogram<4>::BucketIndex(3) == 2u);
+  static_assert(Histogram<4>::BucketIndex(4) == 3u);
+  static_assert(Histogram<4>::BucketIndex(UINT32_MAX) == 3u);
+}
+
+TEST(Histogram, BucketLowerBound) {
+  static_assert(Histogram<33>::bucket_lower_bound(0) == 0u);
+  static_assert(Histogram<33>::bucket_lower_bound(1) == 1u);
+  static_assert(Histogram<33>::bucket_lower_bound(2) == 2u);
+  static_assert(Histogram<33>::bucket_lower_bound(11) == 1024u);
+  static_assert(Histogram<33>::bucket_lower_bound(32) == 0x8000'0000u);
+}
+
+TEST(Histogram, Record) {
+  Histogram<8> histogram(0x1234u);
+  EXPECT_EQ(histogram.name(), 0x1234u);
+  EXPECT_EQ(histogram.total_count(), 0u);
+
+  histogram.Record(0);
+  histogram.Record(5);
+  histogram.Record(6);
+  histogram.Record(1000);
+
+  EXPECT_EQ(histogram.count(0), 1u);
+  EXPECT_EQ(histogram.count(3), 2u);
+  EXPECT_EQ(histogram.count(7), 1u);
+  EXPECT_EQ(histogram.total_count(), 4u);
+}
+
+TEST(Histogram, BucketsAreGroupMetricsInOrder) {
+  Histogram<4> histogram(0x1234u);
+  histogram.Record(2);
+
+  size_t bucket = 0;
+  for (const Metric& metric : histogram.metrics()) {
+    EXPECT_TRUE(metric.is_int());
+    EXPECT_EQ(metric.name(), internal::HistogramBucketName(bucket));
+    EXPECT_EQ(metric.as_int(), bucket == 2u ? 1u : 0u);
+    ++bucket;
+  }
+  EXPECT_EQ(bucket, 4u);
+  EXPECT_TRUE(histogram.children().empty());
+}
+
+TEST(Histogram, BucketNamesAreUnique) {
+  for (size_t i = 0; i < 33; ++i) {
+    for (size_t j = i + 1; j < 33; ++j) {
+      EXPECT_NE(internal::HistogramBucketName(i),
+                internal::HistogramBucketName(j));
+    }
+  }
+}
+
+TEST(Histogram, PercentileLowerBound) {
+  Histogram<33> histogram(0x1234u);
+  EXPECT_EQ(histogram.PercentileLowerBound(99), 0u);
+
+  for (int i = 0; i < 98; ++i) {
+    histogram.Record(10);  // Bucket [8, 16)
+  }
+  histogram.Record(100);   // Bucket [64, 128)
+  histogram.Record(5000);  // Bucket [4096, 8192)
+
+  EXPECT_EQ(histogram.PercentileLowerBound(0), 8u);
+  EXPECT_EQ(histogram.PercentileLowerBound(50), 8u);
+  EXPECT_EQ(histogram.PercentileLowerBound(98), 8u);
+  EXPECT_EQ(histogram.PercentileLowerBound(99), 64u);
+  EXPECT_EQ(histogram.PercentileLowerBound(100), 4096u);
+}
+
+TEST(Histogram, FromMacro) {
+  PW_METRIC_GROUP(group, "group");
+  PW_METRIC_HISTOGRAM(group, latency, "latency", 8);
+  PW_METRIC_HISTOGRAM(standalone, "standalone", 2);
+
+  latency.Record(3);
+  standalone.Record(7);
+
+  EXPECT_EQ(&group.children().front(), &latency);
+  EXPECT_EQ(latency.count(2), 1u);
+  EXPECT_EQ(standalone.count(1), 1u);
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -15,10 +15,12 @@
 #include "pw_metric/metric.h"
 
 #include <array>
+#include <cstring>
 #include <span>
 
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
+#include "pw_metric/internal/atomic.h"
 #include "pw_tokenizer/base64.h"
 
 namespace pw::metric {
@@ -60,29 +62,44 @@ Metric::Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics)
   metrics.push_front(*this);
 }
 
+static_assert(sizeof(float) == sizeof(uint32_t),
+              "Float metrics are stored as 32-bit integers");
+
+uint32_t Metric::FloatToBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float Metric::BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 float Metric::as_float() const {
   PW_DCHECK(is_float());
-  return float_;
+  return BitsToFloat(value_.load(std::memory_order_relaxed));
 }
 
 uint32_t Metric::as_int() const {
   PW_DCHECK(is_int());
-  return uint_;
+  return value_.load(std::memory_order_relaxed);
 }
 
 void Metric::Increment(uint32_t amount) {
   PW_DCHECK(is_int());
-  uint_ += amount;
+  internal::AtomicAdd(value_, amount);
 }
 
 void Metric::SetInt(uint32_t value) {
   PW_DCHECK(is_int());
-  uint_ = value;
+  value_.store(value, std::memory_order_relaxed);
 }
 
 void Metric::SetFloat(float value) {
   PW_DCHECK(is_float());
-  float_ = value;
+  value_.store(FloatToBits(value), std::memory_order_relaxed);
 }
 
 void Metric::Dump(int level) {
@@ -0,0 +1,256 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_metric/metric_service_pwpb.h"
+
+#include <cstring>
+#include <optional>
+
+#include "pw_assert/check.h"
+#include "pw_containers/vector.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/try.h"
+
+namespace pw::metric {
+namespace {
+
+using internal::MetricField;
+using internal::MetricRequestField;
+using internal::MetricResponseField;
+
+// Returns the metric's value as raw bits, for detecting changes.
+uint32_t ValueBits(const Metric& metric) {
+  if (metric.is_int()) {
+    return metric.as_int();
+  }
+  const float value = metric.as_float();
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+struct Request {
+  uint32_t cursor = 0;
+  uint32_t max_metrics = 0;
+  std::optional<uint32_t> since_sequence;
+};
+
+Status DecodeRequest(ConstByteSpan request_buffer, Request& request) {
+  protobuf::Decoder decoder(request_buffer);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<MetricRequestField>(decoder.FieldNumber())) {
+      case MetricRequestField::kCursor:
+        PW_TRY(decoder.ReadUint32(&request.cursor));
+        break;
+      case MetricRequestField::kMaxMetrics:
+        PW_TRY(decoder.ReadUint32(&request.max_metrics));
+        break;
+      case MetricRequestField::kSinceSequence: {
+        uint32_t since_sequence;
+        PW_TRY(decoder.ReadUint32(&since_sequence));
+        request.since_sequence = since_sequence;
+        break;
+      }
+      case MetricRequestField::kMetrics:
+        // Path filtering is not supported; all metrics are returned.
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+}  // namespace
+
+// Walks the metric tree in the same order as the nanopb MetricService, giving
+// each metric a flat index. Encodes the requested metrics into as few
+// responses as the encoding buffer allows.
+class MetricService::Dump {
+ public:
+  Dump(MetricService& service,
+       const Request& request,
+       rpc::RawServerWriter& writer)
+      : service_(service),
+        writer_(writer),
+        cursor_(request.cursor),
+        max_metrics_(request.max_metrics),
+        delta_(request.since_sequence.has_value() &&
+               *request.since_sequence == service.sequence_ &&
+               !service.last_values_.empty()),
+        index_(0),
+        sent_(0),
+        done_(false) {}
+
+  Status Run() {
+    Walk(service_.metrics_);
+    Walk(service_.groups_);
+    PW_TRY(status_);
+
+    // The last response carries the cursor, if the dump is incomplete, and the
+    // sequence to use for the next delta dump.
+    service_.sequence_ += 1;
+    protobuf::StreamEncoder& encoder = Encoder();
+    if (done_) {
+      encoder.WriteUint32(static_cast<uint32_t>(MetricResponseField::kCursor),
+                          index_)
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+    encoder
+        .WriteUint32(static_cast<uint32_t>(MetricResponseField::kSequence),
+                     service_.sequence_)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return Flush();
+  }
+
+ private:
+  void Walk(const IntrusiveList<Metric>& metrics) {
+    for (const auto& metric : metrics) {
+      if (done_ || !status_.ok()) {
+        return;
+      }
+      ScopedName scoped_name(metric.name(), *this);
+      status_ = Visit(metric);
+    }
+  }
+
+  void Walk(const IntrusiveList<Group>& groups) {
+    for (const auto& group : groups) {
+      Walk(group);
+    }
+  }
+
+  void Walk(const Group& group) {
+    if (done_ || !status_.ok()) {
+      return;
+    }
+    ScopedName scoped_name(group.name(), *this);
+    Walk(group.children());
+    Walk(group.metrics());
+  }
+
+  Status Visit(const Metric& metric) {
+    const uint32_t index = index_;
+    if (index < cursor_) {
+      index_ += 1;
+      return OkStatus();
+    }
+    if (max_metrics_ != 0u && sent_ == max_metrics_) {
+      done_ = true;  // Stop here; the next request resumes at index_.
+      return OkStatus();
+    }
+    index_ += 1;
+
+    if (index < service_.last_values_.size()) {
+      const uint32_t bits = ValueBits(metric);
+      const bool changed = service_.last_values_[index] != bits;
+      service_.last_values_[index] = bits;
+      if (delta_ && !changed) {
+        return OkStatus();
+      }
+    }
+
+    if (Encoder().ConservativeWriteLimit() <
+        kMaxEncodedMetricSizeBytes + kMaxEncodedTrailerSizeBytes) {
+      PW_TRY(Flush());
+    }
+
+    sent_ += 1;
+    protobuf::StreamEncoder metric_encoder = Encoder().GetNestedEncoder(
+        static_cast<uint32_t>(MetricResponseField::kMetrics));
+    metric_encoder
+        .WritePackedFixed32(
+            static_cast<uint32_t>(MetricField::kTokenPath),
+            std::span<const uint32_t>(path_.data(), path_.size()))
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    if (metric.is_float()) {
+      metric_encoder
+          .WriteFloat(static_cast<uint32_t>(MetricField::kAsFloat),
+                      metric.as_float())
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    } else {
+      metric_encoder
+          .WriteUint32(static_cast<uint32_t>(MetricField::kAsInt),
+                       metric.as_int())
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+    return OkStatus();
+  }
+
+  protobuf::MemoryEncoder& Encoder() {
+    if (!encoder_.has_value()) {
+      encoder_.emplace(service_.encoding_buffer_);
+    }
+    return *encoder_;
+  }
+
+  Status Flush() {
+    if (!encoder_.has_value() || encoder_->size() == 0u) {
+      encoder_.reset();
+      return OkStatus();
+    }
+    PW_TRY(encoder_->status());
+    Status status = writer_.Write(*encoder_);
+    encoder_.reset();
+    return status;
+  }
+
+  // Exists to safely push/pop parent groups from the explicit stack.
+  struct ScopedName {
+    ScopedName(Token name, Dump& rhs) : dump(rhs) {
+      PW_CHECK_INT_LT(dump.path_.size(),
+                      dump.path_.capacity(),
+                      "Metrics are too deep; bump kMaxPathDepth");
+      dump.path_.push_back(name);
+    }
+    ~ScopedName() { dump.path_.pop_back(); }
+    Dump& dump;
+  };
+
+  MetricService& service_;
+  rpc::RawServerWriter& writer_;
+  const uint32_t cursor_;
+  const uint32_t max_metrics_;
+  const bool delta_;
+
+  uint32_t index_;
+  uint32_t sent_;
+  bool done_;
+  Status status_;
+
+  Vector<Token, kMaxPathDepth> path_;
+  std::optional<protobuf::MemoryEncoder> encoder_;
+};
+
+void MetricService::Get(ConstByteSpan request_buffer,
+                        rpc::RawServerWriter& writer) {
+  if (encoding_buffer_.size() < EncodingBufferSizeBytes(1)) {
+    writer.Finish(Status::ResourceExhausted())
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
+
+  Request request;
+  if (Status status = DecodeRequest(request_buffer, request); !status.ok()) {
+    writer.Finish(status)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
+
+  // Like the nanopb MetricService, this streams the requested metrics within
+  // the Get() call. Use max_metrics to bound how long each call takes.
+  writer.Finish(Dump(*this, request, writer).Run())
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+}
+
+}  // namespace pw::metric
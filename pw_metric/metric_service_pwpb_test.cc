@@ -0,0 +1,244 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_metric/metric_service_pwpb.h"
+
+#include <array>
+#include <cstring>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::metric {
+namespace {
+
+using internal::MetricRequestField;
+using internal::MetricResponseField;
+
+// Two metrics per response, with delta tracking for up to 8 metrics.
+using TestMetricService = MetricServiceWithBuffer<2, 8>;
+
+#define MetricMethodContext \
+  PW_RAW_TEST_METHOD_CONTEXT(TestMetricService, Get, 8)
+
+class EncodedRequest {
+ public:
+  EncodedRequest(std::optional<uint32_t> cursor = std::nullopt,
+                 std::optional<uint32_t> max_metrics = std::nullopt,
+                 std::optional<uint32_t> since_sequence = std::nullopt)
+      : encoder_(buffer_) {
+    if (cursor.has_value()) {
+      EXPECT_EQ(OkStatus(),
+                encoder_.WriteUint32(
+                    static_cast<uint32_t>(MetricRequestField::kCursor),
+                    *cursor));
+    }
+    if (max_metrics.has_value()) {
+      EXPECT_EQ(OkStatus(),
+                encoder_.WriteUint32(
+                    static_cast<uint32_t>(MetricRequestField::kMaxMetrics),
+                    *max_metrics));
+    }
+    if (since_sequence.has_value()) {
+      EXPECT_EQ(OkStatus(),
+                encoder_.WriteUint32(
+                    static_cast<uint32_t>(MetricRequestField::kSinceSequence),
+                    *since_sequence));
+    }
+  }
+
+  operator ConstByteSpan() const {
+    return ConstByteSpan(encoder_.data(), encoder_.size());
+  }
+
+ private:
+  std::array<std::byte, 32> buffer_ = {};
+  protobuf::MemoryEncoder encoder_;
+};
+
+// The contents of all responses to a Get() call.
+struct Dump {
+  size_t metrics = 0;
+  std::optional<uint32_t> cursor;
+  uint32_t sequence = 0;
+};
+
+template <typename Responses>
+Dump DecodeResponses(const Responses& responses) {
+  Dump dump;
+  for (const ConstByteSpan& response : responses) {
+    protobuf::Decoder decoder(response);
+    while (decoder.Next().ok()) {
+      switch (static_cast<MetricResponseField>(decoder.FieldNumber())) {
+        case MetricResponseField::kMetrics:
+          dump.metrics += 1;
+          break;
+        case MetricResponseField::kCursor: {
+          uint32_t cursor;
+          EXPECT_EQ(OkStatus(), decoder.ReadUint32(&cursor));
+          dump.cursor = cursor;
+          break;
+        }
+        case MetricResponseField::kSequence:
+          EXPECT_EQ(OkStatus(), decoder.ReadUint32(&dump.sequence));
+          break;
+      }
+    }
+  }
+  return dump;
+}
+
+TEST(MetricService, EmptyGroupAndNoMetrics) {
+  PW_METRIC_GROUP(root, "/");
+
+  MetricMethodContext context(root.metrics(), root.children());
+  context.call(EncodedRequest());
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+
+  // Only the sequence is sent.
+  ASSERT_EQ(1u, context.responses().size());
+  Dump dump = DecodeResponses(context.responses());
+  EXPECT_EQ(0u, dump.metrics);
+  EXPECT_FALSE(dump.cursor.has_value());
+  EXPECT_EQ(1u, dump.sequence);
+}
+
+TEST(MetricService, NestedGroupsWithBatches) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2.0f);
+
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, x, "x", 3u);
+  PW_METRIC(inner, y, "y", 4u);
+  PW_METRIC(inner, z, "z", 5.0f);
+  root.Add(inner);
+
+  MetricMethodContext context(root.metrics(), root.children());
+  context.call(EncodedRequest());
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+
+  // The buffer is sized for two metrics at the maximum depth, so shallower
+  // metrics pack more tightly, but not all into one response.
+  EXPECT_GT(context.responses().size(), 1u);
+  Dump dump = DecodeResponses(context.responses());
+  EXPECT_EQ(5u, dump.metrics);
+  EXPECT_FALSE(dump.cursor.has_value());
+}
+
+TEST(MetricService, TokenPathAndValue) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, x, "x", 42u);
+  root.Add(inner);
+
+  MetricMethodContext context(root.metrics(), root.children());
+  context.call(EncodedRequest());
+  ASSERT_EQ(1u, context.responses().size());
+
+  protobuf::Decoder decoder(context.responses()[0]);
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ASSERT_EQ(static_cast<uint32_t>(MetricResponseField::kMetrics),
+            decoder.FieldNumber());
+  ConstByteSpan metric;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&metric));
+
+  protobuf::Decoder metric_decoder(metric);
+  ASSERT_EQ(OkStatus(), metric_decoder.Next());
+  ConstByteSpan token_path;
+  ASSERT_EQ(OkStatus(), metric_decoder.ReadBytes(&token_path));
+  ASSERT_EQ(2 * sizeof(uint32_t), token_path.size());
+  uint32_t tokens[2];
+  std::memcpy(tokens, token_path.data(), sizeof(tokens));
+  EXPECT_EQ(inner_token, tokens[0]);
+  EXPECT_EQ(x_token, tokens[1]);
+
+  ASSERT_EQ(OkStatus(), metric_decoder.Next());
+  uint32_t value;
+  ASSERT_EQ(OkStatus(), metric_decoder.ReadUint32(&value));
+  EXPECT_EQ(42u, value);
+}
+
+TEST(MetricService, PagesThroughMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 3u);
+  PW_METRIC(root, d, "d", 4u);
+  PW_METRIC(root, e, "e", 5u);
+
+  MetricMethodContext context(root.metrics(), root.children());
+
+  context.call(EncodedRequest(std::nullopt, 3));
+  EXPECT_EQ(OkStatus(), context.status());
+  Dump dump = DecodeResponses(context.responses());
+  EXPECT_EQ(3u, dump.metrics);
+  ASSERT_TRUE(dump.cursor.has_value());
+  EXPECT_EQ(3u, *dump.cursor);
+
+  context.call(EncodedRequest(3, 3));
+  EXPECT_EQ(OkStatus(), context.status());
+  dump = DecodeResponses(context.responses());
+  EXPECT_EQ(2u, dump.metrics);
+  EXPECT_FALSE(dump.cursor.has_value());
+}
+
+TEST(MetricService, DeltaOnlySendsChangedMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 3.0f);
+
+  MetricMethodContext context(root.metrics(), root.children());
+
+  context.call(EncodedRequest());
+  Dump dump = DecodeResponses(context.responses());
+  EXPECT_EQ(3u, dump.metrics);
+
+  a.Increment();
+  c.Set(4.0f);
+
+  context.call(EncodedRequest(std::nullopt, std::nullopt, dump.sequence));
+  EXPECT_EQ(OkStatus(), context.status());
+  dump = DecodeResponses(context.responses());
+  EXPECT_EQ(2u, dump.metrics);
+
+  // Nothing changed since the last dump.
+  context.call(EncodedRequest(std::nullopt, std::nullopt, dump.sequence));
+  dump = DecodeResponses(context.responses());
+  EXPECT_EQ(0u, dump.metrics);
+}
+
+TEST(MetricService, DeltaWithStaleSequenceSendsAllMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  MetricMethodContext context(root.metrics(), root.children());
+
+  context.call(EncodedRequest());
+  Dump dump = DecodeResponses(context.responses());
+  ASSERT_EQ(2u, dump.metrics);
+
+  context.call(EncodedRequest(std::nullopt, std::nullopt, dump.sequence + 1));
+  dump = DecodeResponses(context.responses());
+  EXPECT_EQ(2u, dump.metrics);
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -14,6 +14,10 @@
 
 #include "pw_metric/metric.h"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
 
@@ -55,6 +59,20 @@ TEST(Metric, IntFromObject) {
   EXPECT_EQ(m.value(), 426u);
 }
 
+TEST(Metric, IntIncrementWraps) {
+  TypedMetric<uint32_t> m(0x1u, UINT32_MAX);
+  m.Increment(2u);
+  EXPECT_EQ(m.value(), 1u);
+}
+
+TEST(Metric, FloatKeepsExactBits) {
+  TypedMetric<float> m(0x1u, -0.0f);
+  EXPECT_TRUE(std::signbit(m.value()));
+
+  m.Set(std::numeric_limits<float>::infinity());
+  EXPECT_EQ(m.value(), std::numeric_limits<float>::infinity());
+}
+
 TEST(m, IntFromMacroLocal) {
   PW_METRIC(m, "some_metric", 14u);
   EXPECT_TRUE(m.is_int());
@@ -0,0 +1,47 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+// The size of a cache line on the target, in bytes. Each shard of a
+// ShardedCounter is aligned to this size so that shards updated from different
+// cores never share a cache line. Defaults to 64, which is the cache line size
+// of most application processors; 32 is common for microcontrollers with a
+// data cache.
+#ifndef PW_METRIC_CONFIG_CACHE_LINE_SIZE
+#define PW_METRIC_CONFIG_CACHE_LINE_SIZE 64
+#endif  // PW_METRIC_CONFIG_CACHE_LINE_SIZE
+
+// Whether the target has atomic read-modify-write instructions, which are used
+// to increment metrics. ARMv6-M (Cortex-M0 and M0+) lacks LDREX/STREX, so
+// std::atomic<uint32_t>::fetch_add needs libatomic there. Without them,
+// increments are a separate atomic load and store: metrics never tear, but
+// increments that race with each other, e.g. from a thread and an interrupt,
+// may be lost.
+#ifndef PW_METRIC_CONFIG_ATOMIC_INCREMENT
+#if defined(__arm__) && !defined(__ARM_FEATURE_LDREX)
+#define PW_METRIC_CONFIG_ATOMIC_INCREMENT 0
+#else
+#define PW_METRIC_CONFIG_ATOMIC_INCREMENT 1
+#endif  // defined(__arm__) && !defined(__ARM_FEATURE_LDREX)
+#endif  // PW_METRIC_CONFIG_ATOMIC_INCREMENT
+
+namespace pw::metric::config {
+
+inline constexpr size_t kCacheLineSize = PW_METRIC_CONFIG_CACHE_LINE_SIZE;
+
+inline constexpr bool kAtomicIncrement = PW_METRIC_CONFIG_ATOMIC_INCREMENT;
+
+}  // namespace pw::metric::config
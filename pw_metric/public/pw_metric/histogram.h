@@ -0,0 +1,175 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/arguments.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+namespace internal {
+
+// Returns the token for the name of the log2 histogram bucket at the index.
+Token HistogramBucketName(size_t index);
+
+}  // namespace internal
+
+// A histogram of uint32_t values with log2-sized buckets, e.g. for latencies.
+//
+// Bucket 0 counts zeros and bucket N counts values in [2^(N-1), 2^N). The last
+// bucket also counts every larger value, so kBuckets = 33 covers all uint32_t
+// values and fewer buckets trade range for RAM.
+//
+// A Histogram is a Group holding one uint32_t metric per bucket, named after
+// the bucket's lower bound, e.g. "ge_0", "ge_1", "ge_2", "ge_4". This makes it
+// work with Group::Dump() and the metric RPC service without any changes.
+//
+// Record() finds the bucket with a count-leading-zeros instruction on most
+// targets and atomically increments it, so it is cheap and may be called from
+// multiple threads and interrupts.
+//
+// Size: a Group plus 12 bytes per bucket on 32-bit platforms.
+template <size_t kBuckets>
+class Histogram : public Group {
+ public:
+  static_assert(kBuckets >= 2u && kBuckets <= 33u,
+                "Histograms have 2 to 33 log2 buckets");
+
+  Histogram(Token name) : Group(name), buckets_(MakeBuckets()) {
+    AddBuckets();
+  }
+
+  Histogram(Token name, IntrusiveList<Group>& groups)
+      : Group(name, groups), buckets_(MakeBuckets()) {
+    AddBuckets();
+  }
+
+  static constexpr size_t bucket_count() { return kBuckets; }
+
+  // Returns the smallest value counted by the bucket.
+  static constexpr uint32_t bucket_lower_bound(size_t bucket) {
+    return bucket == 0u ? 0u : uint32_t{1} << (bucket - 1);
+  }
+
+  // Returns the index of the bucket that counts the value.
+  static constexpr size_t BucketIndex(uint32_t value) {
+    const size_t bit_width =
+        value == 0u ? 0u : 32u - static_cast<size_t>(__builtin_clz(value));
+    return std::min(bit_width, kBuckets - 1);
+  }
+
+  // Counts one occurrence of the value.
+  void Record(uint32_t value) { buckets_[BucketIndex(value)].Increment(); }
+
+  // Returns the number of values counted by the bucket.
+  uint32_t count(size_t bucket) const { return buckets_[bucket].value(); }
+
+  // Returns the number of values recorded in all buckets.
+  uint32_t total_count() const {
+    uint32_t total = 0;
+    for (const TypedMetric<uint32_t>& bucket : buckets_) {
+      total += bucket.value();
+    }
+    return total;
+  }
+
+  // Returns the lower bound of the bucket holding the given percentile of the
+  // recorded values, e.g. 99 for the p99. This is a lower bound on the
+  // percentile: the true value is less than twice as large, unless it is in
+  // the last bucket. Returns 0 if no values were recorded.
+  uint32_t PercentileLowerBound(uint32_t percent) const {
+    const uint64_t total = total_count();
+    // The rank of the value at the percentile, rounded up.
+    const uint64_t rank = (total * std::min(percent, 100u) + 99u) / 100u;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      seen += count(bucket);
+      if (seen >= rank && seen != 0u) {
+        return bucket_lower_bound(bucket);
+      }
+    }
+    return 0u;
+  }
+
+ private:
+  using Buckets = std::array<TypedMetric<uint32_t>, kBuckets>;
+
+  static Buckets MakeBuckets() {
+    return MakeBuckets(std::make_index_sequence<kBuckets>());
+  }
+
+  template <size_t... kIndices>
+  static Buckets MakeBuckets(std::index_sequence<kIndices...>) {
+    return {{TypedMetric<uint32_t>(internal::HistogramBucketName(kIndices),
+                                   0u)...}};
+  }
+
+  // Adds the buckets from last to first, since the group's list is built by
+  // pushing to the front. This makes dumps list the buckets in order.
+  void AddBuckets() {
+    for (size_t i = kBuckets; i > 0u; --i) {
+      Add(buckets_[i - 1]);
+    }
+  }
+
+  Buckets buckets_;
+};
+
+// Define a histogram metric. Works like PW_METRIC_GROUP, with an additional
+// argument for the number of buckets.
+//
+//   PW_METRIC_HISTOGRAM(variable_name, histogram_name, buckets)
+//   PW_METRIC_HISTOGRAM(parent, variable_name, histogram_name, buckets)
+//
+// Example:
+//
+//   class FlashDriver {
+//    public:
+//     void Erase() {
+//       const auto start = SystemClock::now();
+//       ...
+//       erase_latency_us_.Record(ToMicroseconds(SystemClock::now() - start));
+//     }
+//
+//    private:
+//     PW_METRIC_GROUP(metrics_, "flash");
+//     PW_METRIC_HISTOGRAM(metrics_, erase_latency_us_, "erase_latency_us", 24);
+//   };
+//
+#define PW_METRIC_HISTOGRAM(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, , __VA_ARGS__)
+#define PW_METRIC_HISTOGRAM_STATIC(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, static, __VA_ARGS__)
+
+#define _PW_METRIC_HISTOGRAM_4(static_def, variable_name, name, buckets) \
+  static constexpr uint32_t variable_name##_token =                      \
+      PW_TOKENIZE_STRING_DOMAIN("metrics", name);                        \
+  static_def ::pw::metric::Histogram<buckets> variable_name = {          \
+      variable_name##_token}
+
+#define _PW_METRIC_HISTOGRAM_5(                                          \
+    static_def, parent, variable_name, name, buckets)                    \
+  static constexpr uint32_t variable_name##_token =                      \
+      PW_TOKENIZE_STRING_DOMAIN("metrics", name);                        \
+  static_def ::pw::metric::Histogram<buckets> variable_name = {          \
+      variable_name##_token, parent.children()}
+
+}  // namespace pw::metric
@@ -0,0 +1,34 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_metric/config.h"
+
+namespace pw::metric::internal {
+
+// Adds amount to value. See PW_METRIC_CONFIG_ATOMIC_INCREMENT for targets
+// without atomic read-modify-write instructions.
+inline void AtomicAdd(std::atomic<uint32_t>& value, uint32_t amount) {
+  if constexpr (config::kAtomicIncrement) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+  } else {
+    value.store(value.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+  }
+}
+
+}  // namespace pw::metric::internal
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <initializer_list>
 #include <limits>
 
@@ -35,7 +37,14 @@ using tokenizer::Token;
 //
 // Size: 12 bytes / 96 bits - next, name, value.
 //
-// TODO(keir): Implement Set() and Increment() using atomics.
+// The value is stored in a std::atomic<uint32_t>, so Set(), Increment(), and
+// the value accessors may be used concurrently from multiple threads and
+// interrupts without additional synchronization. On targets without atomic
+// read-modify-write instructions, such as ARMv6-M, concurrent increments may
+// be lost; see PW_METRIC_CONFIG_ATOMIC_INCREMENT. For counters that are
+// incremented at a high rate from multiple cores, see ShardedCounter in
+// pw_metric/sharded_counter.h.
+//
 // TODO(keir): Consider an alternative structure where metrics have pointers to
 // parent groups, which would enable (1) safe destruction and (2) safe static
 // initialization, but at the cost of an additional 4 bytes per metric and 4
@@ -66,10 +75,11 @@ class Metric : public IntrusiveList<Metric>::Item {
 
  protected:
   Metric(Token name, float value)
-      : name_and_type_((name & kTokenMask) | kTypeFloat), float_(value) {}
+      : name_and_type_((name & kTokenMask) | kTypeFloat),
+        value_(FloatToBits(value)) {}
 
   Metric(Token name, uint32_t value)
-      : name_and_type_((name & kTokenMask) | kTypeInt), uint_(value) {}
+      : name_and_type_((name & kTokenMask) | kTypeInt), value_(value) {}
 
   Metric(Token name, float value, IntrusiveList<Metric>& metrics);
   Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics);
@@ -88,10 +98,12 @@ class Metric : public IntrusiveList<Metric>::Item {
   // Last bit of the token is used to store int or float; 0 == int, 1 == float.
   Token name_and_type_;
 
-  union {
-    float float_;
-    uint32_t uint_;
-  };
+  static uint32_t FloatToBits(float value);
+  static float BitsToFloat(uint32_t bits);
+
+  // The uint32_t value, or the bits of the float value. Accesses use relaxed
+  // memory ordering; metrics do not synchronize other memory.
+  std::atomic<uint32_t> value_;
 
   enum : uint32_t {
     kTokenMask = _PW_METRIC_TOKEN_MASK,  // 0x7fff'ffff
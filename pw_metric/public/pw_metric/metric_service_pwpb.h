@@ -0,0 +1,151 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_metric_proto/metric_service.raw_rpc.pb.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+
+namespace pw::metric {
+namespace internal {
+
+// Field numbers from metric_service.proto. The generated pwpb header is not
+// used, since its pw::metric::Metric message class conflicts with the
+// pw::metric::Metric class.
+enum class MetricField : uint32_t {
+  kTokenPath = 1,
+  kAsFloat = 2,
+  kAsInt = 3,
+};
+
+enum class MetricRequestField : uint32_t {
+  kMetrics = 1,
+  kCursor = 2,
+  kMaxMetrics = 3,
+  kSinceSequence = 4,
+};
+
+enum class MetricResponseField : uint32_t {
+  kMetrics = 1,
+  kCursor = 2,
+  kSequence = 3,
+};
+
+}  // namespace internal
+
+// The MetricService sends the metrics from the supplied lists of metrics and
+// groups, including the subgroups, when requested by Get(). Metrics are
+// encoded directly into the RPC payloads with pw_protobuf.
+//
+// Unlike the nanopb MetricService, this service supports:
+//
+// - Paged dumps. A request's max_metrics limits how many metrics it returns,
+//   and the last response's cursor resumes the dump in the next request. This
+//   keeps a large dump from monopolizing the RPC channel.
+// - Delta dumps. If a request's since_sequence matches the sequence of the
+//   last response, only the metrics that changed since then are returned. This
+//   requires storage for the last value sent for each metric, so pass a
+//   last_values span with at least one entry per metric. Metrics beyond the
+//   span's size are always returned.
+//
+// Delta dumps assume a single client. If another client requests metrics in
+// between, the sequence no longer matches and all metrics are returned.
+class MetricService
+    : public pw_rpc::raw::MetricService::Service<MetricService> {
+ public:
+  // The deepest metric path supported, counting the metric and its groups.
+  static constexpr size_t kMaxPathDepth = 4;
+
+  // Returns the size of the encoding buffer needed to send the given number of
+  // metrics per response.
+  static constexpr size_t EncodingBufferSizeBytes(
+      size_t metrics_per_response = 1) {
+    return metrics_per_response * kMaxEncodedMetricSizeBytes +
+           kMaxEncodedTrailerSizeBytes;
+  }
+
+  MetricService(const IntrusiveList<Metric>& metrics,
+                const IntrusiveList<Group>& groups,
+                ByteSpan encoding_buffer,
+                std::span<uint32_t> last_values = {})
+      : metrics_(metrics),
+        groups_(groups),
+        encoding_buffer_(encoding_buffer),
+        last_values_(last_values),
+        sequence_(0) {}
+
+  void Get(ConstByteSpan request, rpc::RawServerWriter& response);
+
+ private:
+  class Dump;
+
+  // The largest encoded metric, with room for the nested encoder's reserved
+  // length prefix.
+  static constexpr size_t kMaxEncodedMetricSizeBytes =
+      protobuf::SizeOfDelimitedFieldWithoutValue(
+          internal::MetricResponseField::kMetrics) +
+      protobuf::SizeOfDelimitedField(
+          internal::MetricField::kTokenPath,
+          kMaxPathDepth * protobuf::kMaxSizeBytesFixed32) +
+      protobuf::SizeOfFieldUint32(internal::MetricField::kAsInt);
+
+  static constexpr size_t kMaxEncodedTrailerSizeBytes =
+      protobuf::SizeOfFieldUint32(internal::MetricResponseField::kCursor) +
+      protobuf::SizeOfFieldUint32(internal::MetricResponseField::kSequence);
+
+  const IntrusiveList<Metric>& metrics_;
+  const IntrusiveList<Group>& groups_;
+  const ByteSpan encoding_buffer_;
+  const std::span<uint32_t> last_values_;
+  uint32_t sequence_;
+};
+
+namespace internal {
+
+// The service is given its buffers when it is constructed, so their storage
+// must be constructed first.
+template <size_t kMetricsPerResponse, size_t kMaxMetrics>
+struct MetricServiceStorage {
+  static_assert(kMetricsPerResponse > 0u);
+
+  std::array<std::byte,
+             MetricService::EncodingBufferSizeBytes(kMetricsPerResponse)>
+      encoding_buffer;
+  std::array<uint32_t, kMaxMetrics> last_values;
+};
+
+}  // namespace internal
+
+// A MetricService with its own encoding buffer and delta dump storage.
+// kMaxMetrics is the number of metrics that support delta dumps.
+template <size_t kMetricsPerResponse, size_t kMaxMetrics = 0>
+class MetricServiceWithBuffer
+    : private internal::MetricServiceStorage<kMetricsPerResponse, kMaxMetrics>,
+      public MetricService {
+ public:
+  MetricServiceWithBuffer(const IntrusiveList<Metric>& metrics,
+                          const IntrusiveList<Group>& groups)
+      : MetricService(
+            metrics, groups, this->encoding_buffer, this->last_values) {}
+};
+
+}  // namespace pw::metric
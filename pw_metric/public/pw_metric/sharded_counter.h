@@ -0,0 +1,93 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_metric/config.h"
+#include "pw_metric/internal/atomic.h"
+
+namespace pw::metric {
+
+// A counter split into kShards cache-line-aligned shards, which are summed when
+// the counter is read.
+//
+// Incrementing a single metric from several cores makes the cores fight over
+// the metric's cache line, even if the metrics next to it are unrelated.
+// ShardedCounter instead gives each core its own shard, typically indexed by
+// the core number, so increments from different cores never touch the same
+// cache line. Each shard is atomic, so threads and interrupts on the same core
+// may share a shard.
+//
+// Reading value() is slower than reading a Metric, as it loads every shard.
+// Shards are read one at a time, so value() may miss increments that happen
+// while it runs.
+//
+// ShardedCounter is not a Metric. To export it, periodically copy value() into
+// a metric from a low-rate context, e.g.:
+//
+//   PW_METRIC(metrics_, packets_, "packets", 0u);
+//   ShardedCounter<kNumCores> packet_counter_;
+//
+//   void OnPacket() { packet_counter_.Increment(GetCurrentCore()); }
+//   void UpdateMetrics() { packets_.Set(packet_counter_.value()); }
+//
+template <size_t kShards>
+class ShardedCounter {
+ public:
+  static_assert(kShards > 0u, "ShardedCounter must have at least one shard");
+
+  constexpr ShardedCounter() = default;
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  static constexpr size_t shard_count() { return kShards; }
+
+  // Adds amount to the given shard. Shard indices wrap around, so any index,
+  // such as a core number or thread index, may be used.
+  void Increment(size_t shard, uint32_t amount = 1u) {
+    internal::AtomicAdd(shards_[shard % kShards].count, amount);
+  }
+
+  // Returns the sum of all shards, wrapping on overflow like a uint32_t Metric.
+  uint32_t value() const {
+    uint32_t total = 0;
+    for (const Shard& shard : shards_) {
+      total += shard.count.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  // Sets every shard to zero.
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.count.store(0u, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct alignas(config::kCacheLineSize) Shard {
+    std::atomic<uint32_t> count = 0;
+  };
+
+  static_assert(sizeof(Shard) == config::kCacheLineSize);
+
+  std::array<Shard, kShards> shards_;
+};
+
+}  // namespace pw::metric
@@ -0,0 +1,76 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/sharded_counter.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_metric/config.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(ShardedCounter, StartsAtZero) {
+  ShardedCounter<4> counter;
+  EXPECT_EQ(counter.value(), 0u);
+}
+
+TEST(ShardedCounter, SumsShards) {
+  ShardedCounter<4> counter;
+  counter.Increment(0);
+  counter.Increment(1, 10u);
+  counter.Increment(3, 100u);
+  counter.Increment(1);
+  EXPECT_EQ(counter.value(), 112u);
+}
+
+TEST(ShardedCounter, ShardIndexWrapsAround) {
+  ShardedCounter<2> counter;
+  counter.Increment(2);
+  counter.Increment(5, 2u);
+  counter.Increment(1000, 3u);
+  EXPECT_EQ(counter.value(), 6u);
+}
+
+TEST(ShardedCounter, WrapsOnOverflow) {
+  ShardedCounter<2> counter;
+  counter.Increment(0, UINT32_MAX);
+  counter.Increment(1, 2u);
+  EXPECT_EQ(counter.value(), 1u);
+}
+
+TEST(ShardedCounter, Reset) {
+  ShardedCounter<3> counter;
+  counter.Increment(0, 5u);
+  counter.Increment(2, 7u);
+  counter.Reset();
+  EXPECT_EQ(counter.value(), 0u);
+
+  counter.Increment(1);
+  EXPECT_EQ(counter.value(), 1u);
+}
+
+TEST(ShardedCounter, ShardsDoNotShareCacheLines) {
+  static_assert(sizeof(ShardedCounter<1>) == config::kCacheLineSize);
+  static_assert(sizeof(ShardedCounter<4>) == 4 * config::kCacheLineSize);
+  static_assert(alignof(ShardedCounter<4>) == config::kCacheLineSize);
+
+  ShardedCounter<2> counter;
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&counter) % config::kCacheLineSize,
+            0u);
+}
+
+}  // namespace
+}  // namespace pw::metric
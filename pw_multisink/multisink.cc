@@ -13,6 +13,7 @@
 // the License.
 #include "pw_multisink/multisink.h"
 
+#include <array>
 #include <cstring>
 
 #include "pw_assert/check.h"
@@ -29,18 +30,26 @@ namespace multisink {
 
 void MultiSink::HandleEntry(ConstByteSpan entry) {
   std::lock_guard lock(lock_);
-  const Status push_back_status = ring_buffer_.PushBack(entry, sequence_id_++);
-  PW_DCHECK_OK(push_back_status);
+  HandleEntryLocked(entry);
   NotifyListeners();
 }
 
 void MultiSink::HandleDropped(uint32_t drop_count) {
   std::lock_guard lock(lock_);
+  HandleDroppedLocked(drop_count);
+  NotifyListeners();
+}
+
+void MultiSink::HandleEntryLocked(ConstByteSpan entry) {
+  const Status push_back_status = ring_buffer_.PushBack(entry, sequence_id_++);
+  PW_DCHECK_OK(push_back_status);
+}
+
+void MultiSink::HandleDroppedLocked(uint32_t drop_count) {
   // Updating the sequence ID helps identify where the ingress drop happend when
   // a drain peeks or pops.
   sequence_id_ += drop_count;
   total_ingress_drops_ += drop_count;
-  NotifyListeners();
 }
 
 Status MultiSink::PopEntry(Drain& drain, const Drain::PeekedEntry& entry) {
@@ -67,6 +76,7 @@ Status MultiSink::PopEntry(Drain& drain, const Drain::PeekedEntry& entry) {
     // between peeking and popping.
     PW_CHECK_OK(drain.reader_.PopFront());
     drain.last_handled_sequence_id_ = next_entry_sequence_id;
+    drain.filtered_entry_count_ = 0;
   }
   return OkStatus();
 }
@@ -78,14 +88,76 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
     uint32_t& drop_count_out,
     uint32_t& ingress_drop_count_out,
     uint32_t& entry_sequence_id_out) {
+  std::lock_guard lock(lock_);
+  return PeekOrPopEntryLocked(drain,
+                              buffer,
+                              request,
+                              drop_count_out,
+                              ingress_drop_count_out,
+                              entry_sequence_id_out);
+}
+
+Result<size_t> MultiSink::PopEntries(Drain& drain,
+                                     ByteSpan buffer,
+                                     std::span<ConstByteSpan> entries_out,
+                                     uint32_t& drop_count_out,
+                                     uint32_t& ingress_drop_count_out) {
+  drop_count_out = 0;
+  ingress_drop_count_out = 0;
+  size_t entry_count = 0;
+  size_t bytes_used = 0;
+
+  std::lock_guard lock(lock_);
+  while (entry_count < entries_out.size()) {
+    const ByteSpan remaining = buffer.subspan(bytes_used);
+    SkipFilteredEntriesLocked(drain);
+
+    // Leave entries that don't fit for the next call. Only the first entry is
+    // discarded if it doesn't fit, as PopEntry() does.
+    if (entry_count > 0 &&
+        drain.reader_.FrontEntryDataSizeBytes() > remaining.size()) {
+      break;
+    }
+
+    uint32_t drop_count;
+    uint32_t ingress_drop_count;
+    uint32_t entry_sequence_id;
+    const Result<ConstByteSpan> entry = PeekOrPopEntryLocked(drain,
+                                                             remaining,
+                                                             Request::kPop,
+                                                             drop_count,
+                                                             ingress_drop_count,
+                                                             entry_sequence_id);
+    drop_count_out += drop_count;
+    ingress_drop_count_out += ingress_drop_count;
+
+    if (!entry.ok()) {
+      if (entry_count > 0 && entry.status().IsOutOfRange()) {
+        break;
+      }
+      return entry.status();
+    }
+    entries_out[entry_count++] = entry.value();
+    bytes_used += entry.value().size();
+  }
+  return entry_count;
+}
+
+Result<ConstByteSpan> MultiSink::PeekOrPopEntryLocked(
+    Drain& drain,
+    ByteSpan buffer,
+    Request request,
+    uint32_t& drop_count_out,
+    uint32_t& ingress_drop_count_out,
+    uint32_t& entry_sequence_id_out) {
   size_t bytes_read = 0;
   entry_sequence_id_out = 0;
   drop_count_out = 0;
   ingress_drop_count_out = 0;
 
-  std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
 
+  SkipFilteredEntriesLocked(drain);
   const Status peek_status = drain.reader_.PeekFrontWithPreamble(
       buffer, entry_sequence_id_out, bytes_read);
 
@@ -107,9 +179,10 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   // The drop count calculation simply computes the difference between the
   // current and last sequence IDs. Consecutive successful reads will always
   // differ by one at least, so it is subtracted out. If the read was not
-  // successful, the difference is not adjusted.
+  // successful, the difference is not adjusted. Entries skipped by the drain's
+  // filter are not drops.
   drop_count_out = entry_sequence_id_out - drain.last_handled_sequence_id_ -
-                   (peek_status.ok() ? 1 : 0);
+                   (peek_status.ok() ? 1 : 0) - drain.filtered_entry_count_;
 
   // Only report the ingress drop count when the drain catches up to where the
   // drop happened, accounting only for the drops found and no more, as
@@ -132,15 +205,37 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   if (peek_status.IsOutOfRange()) {
     // No more entries, update the drain.
     drain.last_handled_sequence_id_ = entry_sequence_id_out;
+    drain.filtered_entry_count_ = 0;
     return peek_status;
   }
   if (request == Request::kPop) {
     PW_CHECK(drain.reader_.PopFront().ok());
     drain.last_handled_sequence_id_ = entry_sequence_id_out;
+    drain.filtered_entry_count_ = 0;
   }
   return std::as_bytes(buffer.first(bytes_read));
 }
 
+void MultiSink::SkipFilteredEntriesLocked(Drain& drain) {
+  if (drain.filter_ == nullptr) {
+    return;
+  }
+  std::array<std::byte, PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES> header;
+  while (true) {
+    // Only the header is copied; a larger entry reports RESOURCE_EXHAUSTED.
+    size_t header_size = 0;
+    const Status status = drain.reader_.PeekFront(header, &header_size);
+    if (!status.ok() && !status.IsResourceExhausted()) {
+      return;  // No entries left.
+    }
+    if (drain.filter_(std::span(header).first(header_size))) {
+      return;
+    }
+    PW_CHECK_OK(drain.reader_.PopFront());
+    drain.filtered_entry_count_++;
+  }
+}
+
 void MultiSink::AttachDrain(Drain& drain) {
   std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, nullptr);
@@ -155,6 +250,7 @@ void MultiSink::AttachDrain(Drain& drain) {
   }
   drain.last_peek_sequence_id_ = drain.last_handled_sequence_id_;
   drain.last_handled_ingress_drop_count_ = 0;
+  drain.filtered_entry_count_ = 0;
 }
 
 void MultiSink::DetachDrain(Drain& drain) {
@@ -256,5 +352,30 @@ Result<ConstByteSpan> MultiSink::Drain::PopEntry(
                                     entry_sequence_id_out);
 }
 
+Result<size_t> MultiSink::Drain::PopEntries(
+    ByteSpan buffer,
+    std::span<ConstByteSpan> entries_out,
+    uint32_t& drop_count_out,
+    uint32_t& ingress_drop_count_out) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PopEntries(
+      *this, buffer, entries_out, drop_count_out, ingress_drop_count_out);
+}
+
+void MultiSink::Drain::SetEntryFilter(EntryFilter&& filter) {
+  if (multisink_ == nullptr) {
+    filter_ = std::move(filter);
+    return;
+  }
+  std::lock_guard lock(multisink_->lock_);
+  filter_ = std::move(filter);
+}
+
+size_t MultiSink::Drain::UnreadEntriesSize() {
+  PW_DCHECK_NOTNULL(multisink_);
+  std::lock_guard lock(multisink_->lock_);
+  return reader_.EntriesSize();
+}
+
 }  // namespace multisink
 }  // namespace pw
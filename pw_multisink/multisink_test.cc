@@ -127,7 +127,7 @@ class MultiSinkTest : public ::testing::Test {
     listener.ResetNotificationCount();
   }
 
-  std::byte buffer_[kBufferSize];
+  std::byte buffer_[kBufferSize] = {};
   std::byte entry_buffer_[kEntryBufferSize];
   CountingListener listeners_[kMaxListeners];
   Drain drains_[kMaxDrains];
@@ -447,6 +447,176 @@ TEST_F(MultiSinkTest, PeekReportsSlowDrainDropCount) {
       peek_result, drop_count, ingress_drop_count, message, expected_drops, 0);
 }
 
+TEST_F(MultiSinkTest, PopEntries) {
+  multisink_.AttachDrain(drains_[0]);
+
+  std::array<std::byte, 2 * sizeof(kMessage) + 1> buffer;
+  std::array<ConstByteSpan, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  EXPECT_EQ(drains_[0]
+                .PopEntries(buffer, entries, drop_count, ingress_drop_count)
+                .status(),
+            Status::OutOfRange());
+
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(2);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+
+  // Only two entries fit in the buffer; the third is left in the multisink.
+  Result<size_t> count =
+      drains_[0].PopEntries(buffer, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(count.status(), OkStatus());
+  ASSERT_EQ(count.value(), 2u);
+  ASSERT_EQ(entries[0].size(), sizeof(kMessage));
+  EXPECT_EQ(std::memcmp(entries[0].data(), kMessage, sizeof(kMessage)), 0);
+  ASSERT_EQ(entries[1].size(), sizeof(kMessageOther));
+  EXPECT_EQ(
+      std::memcmp(entries[1].data(), kMessageOther, sizeof(kMessageOther)), 0);
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 2u);
+
+  count =
+      drains_[0].PopEntries(buffer, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(count.status(), OkStatus());
+  ASSERT_EQ(count.value(), 1u);
+  EXPECT_EQ(std::memcmp(entries[0].data(), kMessage, sizeof(kMessage)), 0);
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+}
+
+TEST_F(MultiSinkTest, PopEntriesLimitedByEntryCount) {
+  multisink_.AttachDrain(drains_[0]);
+  for (int i = 0; i < 3; ++i) {
+    multisink_.HandleEntry(kMessage);
+  }
+
+  std::array<ConstByteSpan, 2> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<size_t> count = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(count.status(), OkStatus());
+  EXPECT_EQ(count.value(), 2u);
+
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+}
+
+TEST_F(MultiSinkTest, PopEntriesFirstEntryTooLarge) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessageOther);
+
+  // As with PopEntry(), an entry that can't fit in the buffer is discarded.
+  std::array<std::byte, sizeof(kMessage) - 1> buffer;
+  std::array<ConstByteSpan, 2> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  EXPECT_EQ(drains_[0]
+                .PopEntries(buffer, entries, drop_count, ingress_drop_count)
+                .status(),
+            Status::ResourceExhausted());
+
+  VerifyPopEntry(drains_[0], kMessageOther, 1u, 0u);
+}
+
+TEST_F(MultiSinkTest, UnreadEntriesSize) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  EXPECT_EQ(drains_[0].UnreadEntriesSize(), 0u);
+
+  // Each entry has a one byte sequence ID and a one byte length.
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessage);
+  EXPECT_EQ(drains_[0].UnreadEntriesSize(), 2 * (2 + sizeof(kMessage)));
+
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  EXPECT_EQ(drains_[0].UnreadEntriesSize(), 2 + sizeof(kMessage));
+  EXPECT_EQ(drains_[1].UnreadEntriesSize(), 2 * (2 + sizeof(kMessage)));
+
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  EXPECT_EQ(drains_[0].UnreadEntriesSize(), 0u);
+}
+
+TEST_F(MultiSinkTest, EntryFilterSkipsEntries) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  drains_[0].SetEntryFilter([](ConstByteSpan header) {
+    return !header.empty() && header[0] == kMessage[0];
+  });
+
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleDropped(1);
+  multisink_.HandleEntry(kMessageOther);
+
+  // Skipped entries are not drops, but ingress drops are still reported.
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 1u);
+
+  // Other drains are not affected by the filter.
+  VerifyPopEntry(drains_[1], kMessageOther, 0u, 0u);
+  VerifyPopEntry(drains_[1], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[1], kMessageOther, 0u, 0u);
+  VerifyPopEntry(drains_[1], kMessageOther, 0u, 1u);
+}
+
+TEST_F(MultiSinkTest, EntryFilterWithPeekAndPopEntries) {
+  multisink_.AttachDrain(drains_[0]);
+  drains_[0].SetEntryFilter(
+      [](ConstByteSpan header) { return header[0] == kMessage[0]; });
+
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<Drain::PeekedEntry> peek_result =
+      drains_[0].PeekEntry(entry_buffer_, drop_count, ingress_drop_count);
+  VerifyPeekResult(
+      peek_result, drop_count, ingress_drop_count, kMessage, 0u, 0u);
+  ASSERT_EQ(drains_[0].PopEntry(peek_result.value()), OkStatus());
+
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+  std::array<ConstByteSpan, 4> entries;
+  Result<size_t> count = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(count.status(), OkStatus());
+  EXPECT_EQ(count.value(), 2u);
+  EXPECT_EQ(drop_count, 0u);
+
+  // Clearing the filter reads every entry again.
+  drains_[0].SetEntryFilter(nullptr);
+  multisink_.HandleEntry(kMessageOther);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u, 0u);
+}
+
+TEST_F(MultiSinkTest, EntryFilterSeesOnlyHeader) {
+  multisink_.AttachDrain(drains_[0]);
+  size_t header_size = 0;
+  drains_[0].SetEntryFilter([&header_size](ConstByteSpan header) {
+    header_size = header.size();
+    return true;
+  });
+
+  std::array<std::byte, PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES + 8>
+      message;
+  std::memset(message.data(), 'a', message.size());
+  multisink_.HandleEntry(message);
+  VerifyPopEntry(drains_[0], message, 0u, 0u);
+  EXPECT_EQ(header_size, size_t{PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES});
+
+  multisink_.HandleEntry(kMessage);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  EXPECT_EQ(header_size, sizeof(kMessage));
+}
+
 TEST_F(MultiSinkTest, IngressDropCountOverflow) {
   multisink_.AttachDrain(drains_[0]);
 
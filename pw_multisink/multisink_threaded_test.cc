@@ -186,7 +186,7 @@ class MultiSinkTest : public ::testing::Test {
  protected:
   MultiSinkTest() : multisink_(buffer_) {}
 
-  std::byte buffer_[kBufferSize];
+  std::byte buffer_[kBufferSize] = {};
   MultiSink multisink_;
 
  private:
@@ -22,6 +22,13 @@
 #define PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE 1
 #endif  // !defined(PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE)
 
+// PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES is the number of bytes at the
+// start of each entry that a drain's entry filter can inspect. The header is
+// copied to the stack while the multisink lock is held.
+#if !defined(PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES)
+#define PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES 16
+#endif  // !defined(PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES)
+
 #if PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE
 #include "pw_sync/interrupt_spin_lock.h"
 #else  // !PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE
@@ -27,6 +27,8 @@
 namespace pw {
 namespace multisink {
 
+class StagingBuffer;
+
 // An asynchronous single-writer multi-reader queue that ensures readers can
 // poll for dropped message counts, which is useful for logging or similar
 // scenarios where readers need to be aware of the input message sequence.
@@ -60,10 +62,16 @@ class MultiSink {
       const uint32_t sequence_id_;
     };
 
+    // Decides whether the drain reads an entry, given up to the first
+    // PW_MULTISINK_CONFIG_FILTER_HEADER_SIZE_BYTES bytes of it. Returns true to
+    // read the entry, or false to skip it.
+    using EntryFilter = Function<bool(ConstByteSpan entry_header)>;
+
     constexpr Drain()
         : last_handled_sequence_id_(0),
           last_peek_sequence_id_(0),
           last_handled_ingress_drop_count_(0),
+          filtered_entry_count_(0),
           multisink_(nullptr) {}
 
     // Returns the next available entry if it exists and acquires the latest
@@ -149,6 +157,41 @@ class MultiSink {
       return result;
     }
 
+    // Pops as many entries as fit in `buffer`, up to `entries_out.size()`,
+    // while holding the multisink lock only once. The entries are copied one
+    // after another into `buffer`, and `entries_out` is set to the span of each
+    // entry. Returns the number of entries popped.
+    //
+    // The drop counts follow the same logic as `PopEntry`, added up over all
+    // of the popped entries.
+    //
+    // Example Usage:
+    //
+    //  std::array<std::byte, 256> buffer;
+    //  std::array<ConstByteSpan, 8> entries;
+    //  uint32_t drop_count, ingress_drop_count;
+    //  Result<size_t> count =
+    //      drain.PopEntries(buffer, entries, drop_count, ingress_drop_count);
+    //  for (size_t i = 0; i < count.value_or(0); ++i) {
+    //    ProcessEntry(entries[i]);
+    //  }
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - At least one entry was read from the multisink. Entries that did
+    // not fit in the remaining buffer space are left in the multisink.
+    // OUT_OF_RANGE - No entries were available.
+    // FAILED_PRECONDITION - The drain must be attached to a sink.
+    // RESOURCE_EXHAUSTED - The provided buffer was not large enough to store
+    // the first available entry, which was discarded.
+    Result<size_t> PopEntries(ByteSpan buffer,
+                              std::span<ConstByteSpan> entries_out,
+                              uint32_t& drop_count_out,
+                              uint32_t& ingress_drop_count_out)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+
     // Removes the previously peeked entry from the multisink.
     //
     // Example Usage:
@@ -197,6 +240,24 @@ class MultiSink {
                                   uint32_t& ingress_drop_count)
         PW_LOCKS_EXCLUDED(multisink_->lock_);
 
+    // Sets a filter that the multisink runs on each entry before copying it
+    // out for this drain. Entries the filter rejects are skipped in place, so
+    // they are never copied, and they are not reported as drops. Pass nullptr
+    // to read every entry again.
+    //
+    // The filter runs with the multisink lock held. It must be quick and must
+    // not use the multisink or its drains.
+    void SetEntryFilter(EntryFilter&& filter)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+
+    // Returns the size in bytes of the entries this drain has not read yet,
+    // including the multisink's per-entry overhead. New entries may arrive as
+    // soon as this returns, so it is only an estimate of how much the drain
+    // could read.
+    //
+    // Precondition: The drain must be attached to a sink.
+    size_t UnreadEntriesSize() PW_LOCKS_EXCLUDED(multisink_->lock_);
+
     // Drains are not copyable or movable.
     Drain(const Drain&) = delete;
     Drain& operator=(const Drain&) = delete;
@@ -212,6 +273,9 @@ class MultiSink {
     uint32_t last_handled_sequence_id_;
     uint32_t last_peek_sequence_id_;
     uint32_t last_handled_ingress_drop_count_;
+    // Entries skipped by `filter_` since `last_handled_sequence_id_`.
+    uint32_t filtered_entry_count_;
+    EntryFilter filter_;
     MultiSink* multisink_;
   };
 
@@ -411,7 +475,39 @@ class MultiSink {
                                        uint32_t& entry_sequence_id_out)
       PW_LOCKS_EXCLUDED(lock_);
 
+  // Pops entries from the provided drain into `buffer` under a single lock
+  // hold. See Drain::PopEntries.
+  Result<size_t> PopEntries(Drain& drain,
+                            ByteSpan buffer,
+                            std::span<ConstByteSpan> entries_out,
+                            uint32_t& drop_count_out,
+                            uint32_t& ingress_drop_count_out)
+      PW_LOCKS_EXCLUDED(lock_);
+
  private:
+  friend StagingBuffer;
+
+  // HandleEntry() and HandleDropped() for callers that already hold the lock.
+  // They do not notify listeners.
+  void HandleEntryLocked(ConstByteSpan entry)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void HandleDroppedLocked(uint32_t drop_count)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // PeekOrPopEntry() for callers that already hold the lock.
+  Result<ConstByteSpan> PeekOrPopEntryLocked(Drain& drain,
+                                             ByteSpan buffer,
+                                             Request request,
+                                             uint32_t& drop_count_out,
+                                             uint32_t& ingress_drop_count_out,
+                                             uint32_t& entry_sequence_id_out)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Pops the entries at the front of the drain that its filter rejects,
+  // without copying them out.
+  void SkipFilteredEntriesLocked(Drain& drain)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -0,0 +1,102 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_multisink/multisink.h"
+#include "pw_result/result.h"
+#include "pw_ring_buffer/lock_free_prefixed_entry_ring_buffer.h"
+
+namespace pw {
+namespace multisink {
+
+// A lock-free staging area in front of a MultiSink, for a single producer such
+// as one thread or one core. Entries written to the staging buffer are moved to
+// the multisink in batches by Flush(), which takes the multisink's lock once
+// per batch rather than once per entry. This reduces contention on the
+// multisink's lock when many threads produce entries.
+//
+// Entries from one staging buffer reach the multisink in the order they were
+// written, and are assigned sequence IDs when they are flushed. Entries that
+// are dropped because the staging buffer is full are reported to the
+// multisink's drains as ingress drops, following the entries that were staged
+// before them.
+//
+// HandleEntry() and TryReserve() may be called from one thread at a time, and
+// Flush() may be called from one thread at a time, such as the producer itself
+// or a thread that flushes all staging buffers. The two may run concurrently.
+class StagingBuffer {
+ public:
+  // The writable region of a reserved entry, which is split in two if it wraps
+  // around the end of the staging buffer.
+  using ReservedEntry =
+      ring_buffer::LockFreePrefixedEntryRingBuffer::ReservedEntry;
+
+  // Stages entries in the provided buffer before they are flushed to
+  // `multisink`.
+  StagingBuffer(MultiSink& multisink, ByteSpan buffer);
+
+  // Staging buffers are not copyable or movable.
+  StagingBuffer(const StagingBuffer&) = delete;
+  StagingBuffer& operator=(const StagingBuffer&) = delete;
+
+  // Copies an entry into the staging buffer without taking a lock. If the
+  // staging buffer does not have space for the entry, the entry is dropped.
+  void HandleEntry(ConstByteSpan entry);
+
+  // Reserves space for an entry of up to max_size_bytes, so that the producer
+  // can encode the entry directly into the staging buffer instead of into a
+  // separate buffer that HandleEntry() copies. Neither this nor Commit() takes
+  // a lock. If the staging buffer does not have space for the entry, the entry
+  // is counted as dropped and an error is returned.
+  //
+  // Call Commit() with the entry's size or CancelReservation() before staging
+  // another entry.
+  Result<ReservedEntry> TryReserve(size_t max_size_bytes);
+
+  // Stages the reserved entry with the first size_bytes of its region, which
+  // must not exceed the reserved size.
+  void Commit(size_t size_bytes);
+
+  // Discards the reserved entry without counting it as dropped.
+  void CancelReservation() { ring_buffer_.CancelReservation(); }
+
+  // Notifies the staging buffer of entries dropped before they were staged.
+  void HandleDropped(uint32_t drop_count = 1) {
+    drop_count_.fetch_add(drop_count, std::memory_order_relaxed);
+  }
+
+  // Moves all staged entries and drop counts to the multisink while holding
+  // its lock once, and notifies the multisink's listeners. `entry_buffer` is
+  // used to copy each entry; entries larger than it are counted as dropped.
+  //
+  // Precondition: If PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled, this
+  // function must not be called from an interrupt context.
+  void Flush(ByteSpan entry_buffer);
+
+  // Returns the number of bytes of entries waiting to be flushed. Producers may
+  // use this to decide when to flush.
+  size_t StagedBytes() const { return ring_buffer_.TotalUsedBytes(); }
+
+ private:
+  MultiSink& multisink_;
+  ring_buffer::LockFreePrefixedEntryRingBuffer ring_buffer_;
+  std::atomic<uint32_t> drop_count_;
+};
+
+}  // namespace multisink
+}  // namespace pw
@@ -0,0 +1,84 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multisink/staging_buffer.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw {
+namespace multisink {
+
+StagingBuffer::StagingBuffer(MultiSink& multisink, ByteSpan buffer)
+    : multisink_(multisink), drop_count_(0) {
+  PW_CHECK_OK(ring_buffer_.SetBuffer(buffer));
+}
+
+void StagingBuffer::HandleEntry(ConstByteSpan entry) {
+  if (!ring_buffer_.TryPushBack(entry).ok()) {
+    HandleDropped();
+  }
+}
+
+Result<StagingBuffer::ReservedEntry> StagingBuffer::TryReserve(
+    size_t max_size_bytes) {
+  Result<ReservedEntry> entry = ring_buffer_.TryReserve(max_size_bytes);
+  if (!entry.ok()) {
+    HandleDropped();
+  }
+  return entry;
+}
+
+void StagingBuffer::Commit(size_t size_bytes) {
+  PW_CHECK_OK(ring_buffer_.Commit(size_bytes));
+}
+
+void StagingBuffer::Flush(ByteSpan entry_buffer) {
+  std::lock_guard lock(multisink_.lock_);
+  bool handled = false;
+
+  while (true) {
+    size_t bytes_read = 0;
+    const Status peek_status =
+        ring_buffer_.PeekFront(entry_buffer, &bytes_read);
+    if (peek_status.IsOutOfRange()) {
+      break;
+    }
+
+    if (peek_status.ok()) {
+      multisink_.HandleEntryLocked(entry_buffer.first(bytes_read));
+    } else {
+      multisink_.HandleDroppedLocked(1);
+    }
+    PW_CHECK_OK(ring_buffer_.PopFront());
+    handled = true;
+  }
+
+  // Entries are dropped when the staging buffer is full, so report the drops
+  // after the entries that filled it.
+  const uint32_t drop_count =
+      drop_count_.exchange(0, std::memory_order_relaxed);
+  if (drop_count > 0) {
+    multisink_.HandleDroppedLocked(drop_count);
+    handled = true;
+  }
+
+  if (handled) {
+    multisink_.NotifyListeners();
+  }
+}
+
+}  // namespace multisink
+}  // namespace pw
@@ -0,0 +1,173 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multisink/staging_buffer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_multisink/multisink.h"
+
+namespace pw::multisink {
+namespace {
+
+class CountingListener : public MultiSink::Listener {
+ public:
+  void OnNewEntryAvailable() override { notification_count_++; }
+
+  size_t notification_count() const { return notification_count_; }
+
+  void ResetNotificationCount() { notification_count_ = 0; }
+
+ private:
+  size_t notification_count_ = 0;
+};
+
+class StagingBufferTest : public ::testing::Test {
+ protected:
+  StagingBufferTest()
+      : multisink_(multisink_buffer_), staging_(multisink_, staging_buffer_) {
+    multisink_.AttachDrain(drain_);
+    multisink_.AttachListener(listener_);
+    listener_.ResetNotificationCount();
+  }
+
+  ~StagingBufferTest() {
+    multisink_.DetachListener(listener_);
+    multisink_.DetachDrain(drain_);
+  }
+
+  // Pops the next entry and expects it to start with `first_byte`, and the
+  // ingress drop count to match.
+  void ExpectEntry(std::byte first_byte, uint32_t expected_ingress_drops) {
+    uint32_t drop_count = 0;
+    uint32_t ingress_drop_count = 0;
+    Result<ConstByteSpan> entry =
+        drain_.PopEntry(pop_buffer_, drop_count, ingress_drop_count);
+    ASSERT_EQ(entry.status(), OkStatus());
+    ASSERT_FALSE(entry.value().empty());
+    EXPECT_EQ(entry.value()[0], first_byte);
+    EXPECT_EQ(drop_count, 0u);
+    EXPECT_EQ(ingress_drop_count, expected_ingress_drops);
+  }
+
+  // Expects the drain to be empty, reporting `expected_ingress_drops` drops.
+  void ExpectEmpty(uint32_t expected_ingress_drops) {
+    uint32_t drop_count = 0;
+    uint32_t ingress_drop_count = 0;
+    Result<ConstByteSpan> entry =
+        drain_.PopEntry(pop_buffer_, drop_count, ingress_drop_count);
+    EXPECT_EQ(entry.status(), Status::OutOfRange());
+    EXPECT_EQ(ingress_drop_count, expected_ingress_drops);
+  }
+
+  std::array<std::byte, 128> multisink_buffer_ = {};
+  std::array<std::byte, 16> staging_buffer_;
+  std::array<std::byte, 8> entry_buffer_;
+  std::array<std::byte, 32> pop_buffer_;
+  MultiSink multisink_;
+  StagingBuffer staging_;
+  MultiSink::Drain drain_;
+  CountingListener listener_;
+};
+
+TEST_F(StagingBufferTest, EntriesWaitForFlush) {
+  constexpr std::byte kEntry[] = {std::byte{1}, std::byte{2}};
+  staging_.HandleEntry(kEntry);
+  EXPECT_EQ(staging_.StagedBytes(), 1u + sizeof(kEntry));
+  ExpectEmpty(0u);
+  EXPECT_EQ(listener_.notification_count(), 0u);
+
+  staging_.Flush(entry_buffer_);
+  EXPECT_EQ(staging_.StagedBytes(), 0u);
+  EXPECT_EQ(listener_.notification_count(), 1u);
+  ExpectEntry(std::byte{1}, 0u);
+  ExpectEmpty(0u);
+
+  // Flushing nothing does not notify listeners.
+  staging_.Flush(entry_buffer_);
+  EXPECT_EQ(listener_.notification_count(), 1u);
+}
+
+TEST_F(StagingBufferTest, FlushPreservesOrder) {
+  for (uint8_t i = 0; i < 4; ++i) {
+    const std::byte entry[] = {std::byte{i}, std::byte{0}};
+    staging_.HandleEntry(entry);
+  }
+
+  staging_.Flush(entry_buffer_);
+  EXPECT_EQ(listener_.notification_count(), 1u);
+  for (uint8_t i = 0; i < 4; ++i) {
+    ExpectEntry(std::byte{i}, 0u);
+  }
+  ExpectEmpty(0u);
+}
+
+TEST_F(StagingBufferTest, FullStagingBufferReportsIngressDrops) {
+  // Each entry takes 5 bytes, so three fit in the staging buffer.
+  constexpr std::byte kEntry[4] = {std::byte{7}};
+  for (int i = 0; i < 5; ++i) {
+    staging_.HandleEntry(kEntry);
+  }
+  staging_.HandleDropped(3);
+
+  staging_.Flush(entry_buffer_);
+  ExpectEntry(std::byte{7}, 0u);
+  ExpectEntry(std::byte{7}, 0u);
+  ExpectEntry(std::byte{7}, 0u);
+  ExpectEmpty(5u);
+}
+
+TEST_F(StagingBufferTest, EntryLargerThanFlushBufferIsDropped) {
+  constexpr std::byte kLargeEntry[12] = {std::byte{1}};
+  constexpr std::byte kEntry[] = {std::byte{2}};
+  staging_.HandleEntry(kLargeEntry);
+  staging_.HandleEntry(kEntry);
+
+  staging_.Flush(entry_buffer_);
+  ExpectEntry(std::byte{2}, 1u);
+  ExpectEmpty(0u);
+}
+
+TEST_F(StagingBufferTest, ReservedEntryIsEncodedInPlace) {
+  Result<StagingBuffer::ReservedEntry> entry = staging_.TryReserve(6);
+  ASSERT_EQ(entry.status(), OkStatus());
+  ASSERT_EQ(entry->size(), 6u);
+  entry->first[0] = std::byte{3};
+  entry->first[1] = std::byte{4};
+
+  // The entry is not staged until it is committed.
+  staging_.Flush(entry_buffer_);
+  ExpectEmpty(0u);
+
+  staging_.Commit(2);
+  staging_.Flush(entry_buffer_);
+  ExpectEntry(std::byte{3}, 0u);
+  ExpectEmpty(0u);
+}
+
+TEST_F(StagingBufferTest, ReserveWithoutSpaceReportsIngressDrop) {
+  EXPECT_EQ(staging_.TryReserve(staging_buffer_.size()).status(),
+            Status::OutOfRange());
+  ASSERT_EQ(staging_.TryReserve(4).status(), OkStatus());
+  staging_.CancelReservation();
+
+  staging_.Flush(entry_buffer_);
+  ExpectEmpty(1u);
+}
+
+}  // namespace
+}  // namespace pw::multisink
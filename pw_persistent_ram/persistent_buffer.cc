@@ -14,7 +14,6 @@
 #include "pw_persistent_ram/persistent_buffer.h"
 
 #include "pw_bytes/span.h"
-#include "pw_checksum/crc16_ccitt.h"
 #include "pw_status/status.h"
 
 namespace pw::persistent_ram {
@@ -33,8 +32,8 @@ Status PersistentBufferWriter::DoWrite(ConstByteSpan data) {
   std::memcpy(buffer_.data() + size_, data.data(), data.size_bytes());
 
   // Only checksum newly written data.
-  checksum_ = checksum::Crc16Ccitt::Calculate(
-      ByteSpan(buffer_.data() + size_, data.size_bytes()), checksum_);
+  update_checksum_(checksum_,
+                   ConstByteSpan(buffer_.data() + size_, data.size_bytes()));
   size_ += data.size_bytes();
 
   return OkStatus();
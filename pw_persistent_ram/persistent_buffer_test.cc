@@ -160,5 +160,36 @@ TEST_F(PersistentTest, AppendingData) {
   }
 }
 
+TEST(PersistentBuffer, Crc32Checksum) {
+  using Crc32Buffer = PersistentBuffer<64, Crc32Checksum>;
+  alignas(Crc32Buffer) std::byte storage[sizeof(Crc32Buffer)] = {};
+  constexpr std::string_view kFirst("First ");
+  constexpr std::string_view kSecond("and second write");
+
+  {  // Write in two pieces.
+    auto& persistent = *(new (storage) Crc32Buffer());
+    EXPECT_FALSE(persistent.has_value());
+
+    auto writer = persistent.GetWriter();
+    ASSERT_EQ(OkStatus(),
+              writer.Write(std::as_bytes(std::span<const char>(kFirst))));
+    ASSERT_EQ(OkStatus(),
+              writer.Write(std::as_bytes(std::span<const char>(kSecond))));
+    ASSERT_TRUE(persistent.has_value());
+
+    persistent.~PersistentBuffer();  // Emulate shutdown / global destructors.
+  }
+
+  {  // The incrementally updated checksum matches the full contents.
+    auto& persistent = *(new (storage) Crc32Buffer());
+    ASSERT_TRUE(persistent.has_value());
+    EXPECT_EQ(persistent.size(), kFirst.size() + kSecond.size());
+
+    // Corrupt a byte.
+    const_cast<std::byte*>(persistent.data())[0] ^= std::byte{1};
+    EXPECT_FALSE(persistent.has_value());
+  }
+}
+
 }  // namespace
 }  // namespace pw::persistent_ram
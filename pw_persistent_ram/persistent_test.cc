@@ -172,5 +172,31 @@ TEST_F(MutablePersistentTest, ResetObject) {
   }
 }
 
+TEST(Persistent, Crc32Checksum) {
+  using Crc32Persistent = Persistent<uint32_t, Crc32Checksum>;
+  std::aligned_storage_t<sizeof(Crc32Persistent), alignof(Crc32Persistent)>
+      buffer;
+  memset(&buffer, 0, sizeof(buffer));
+
+  {
+    auto& persistent = *(new (&buffer) Crc32Persistent());
+    EXPECT_FALSE(persistent.has_value());
+    persistent = 42u;
+    ASSERT_TRUE(persistent.has_value());
+
+    persistent.~Persistent();  // Emulate shutdown / global destructors.
+  }
+
+  {
+    auto& persistent = *(new (&buffer) Crc32Persistent());
+    ASSERT_TRUE(persistent.has_value());
+    EXPECT_EQ(42u, persistent.value());
+
+    *persistent.mutator() = 0;
+    ASSERT_TRUE(persistent.has_value());
+    EXPECT_EQ(0u, persistent.value());
+  }
+}
+
 }  // namespace
 }  // namespace pw::persistent_ram
@@ -0,0 +1,66 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Integrity checks for Persistent and PersistentBuffer.
+//
+// A checksum policy is a class with:
+//
+//   // The type of the stored checksum.
+//   using Value = ...;
+//
+//   // The checksum of no data.
+//   static constexpr Value kEmpty = ...;
+//
+//   // Returns the checksum of the previously checksummed data followed by
+//   // data, given the previous checksum.
+//   static Value Update(ConstByteSpan data, Value previous);
+//
+// Because Update() extends an existing checksum, appending to a
+// PersistentBuffer only checksums the new data. Projects can provide their own
+// policy to use a hardware CRC peripheral.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum/crc32.h"
+
+namespace pw::persistent_ram {
+
+// CRC16-CCITT. This is the default, as it has the smallest footprint in
+// persistent memory.
+struct Crc16Checksum {
+  using Value = uint16_t;
+
+  static constexpr Value kEmpty = checksum::Crc16Ccitt::kInitialValue;
+
+  static Value Update(ConstByteSpan data, Value previous) {
+    return checksum::Crc16Ccitt::Calculate(data, previous);
+  }
+};
+
+// CRC32. Stronger than CRC16 and, using pw_checksum's slicing-by-8 or ARMv8 CRC
+// instruction implementations, considerably faster for large buffers.
+struct Crc32Checksum {
+  using Value = uint32_t;
+
+  static constexpr Value kEmpty = PW_CHECKSUM_EMPTY_CRC32;
+
+  static Value Update(ConstByteSpan data, Value previous) {
+    return pw_checksum_Crc32Append(data.data(), data.size_bytes(), previous);
+  }
+};
+
+}  // namespace pw::persistent_ram
@@ -20,7 +20,7 @@
 #include <utility>
 
 #include "pw_assert/assert.h"
-#include "pw_checksum/crc16_ccitt.h"
+#include "pw_persistent_ram/checksum.h"
 #include "pw_preprocessor/compiler.h"
 
 namespace pw::persistent_ram {
@@ -40,17 +40,18 @@ PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC(ignored, "-Wuninitialized");
 PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wmaybe-uninitialized");
 
-// A simple container for holding a value T with CRC16 integrity checking.
+// A simple container for holding a value T with integrity checking.
 //
 // A Persistent is simply a value T plus integrity checking for use in a
-// persistent RAM section which is not initialized on boot.
+// persistent RAM section which is not initialized on boot. The integrity check
+// is CRC16 by default; see pw_persistent_ram/checksum.h for alternatives.
 //
 // WARNING: Unlike a DoubleBufferedPersistent, a Persistent will be lost if a
 // write/set operation is interrupted or otherwise not completed.
 //
 // TODO(pwbug/348): Consider a different integrity check implementation which
 // does not use a 512B lookup table.
-template <typename T>
+template <typename T, typename Checksum = Crc16Checksum>
 class Persistent {
  public:
   // This object provides mutable access to the underlying object of a
@@ -65,7 +66,7 @@ class Persistent {
   // in-flight modifications by a Mutator that have not yet been flushed.
   class Mutator {
    public:
-    explicit constexpr Mutator(Persistent<T>& persistent)
+    explicit constexpr Mutator(Persistent& persistent)
         : persistent_(persistent) {}
     ~Mutator() { persistent_.crc_ = persistent_.CalculateCrc(); }
 
@@ -81,7 +82,7 @@ class Persistent {
     T& operator*() { return *const_cast<T*>(&persistent_.contents_); }
 
    private:
-    Persistent<T>& persistent_;
+    Persistent& persistent_;
   };
 
   // Constructor which does nothing, meaning it never sets the value.
@@ -158,9 +159,10 @@ class Persistent {
                 "destructor, ergo only trivially destructible types are "
                 "supported.");
 
-  uint16_t CalculateCrc() const {
-    return checksum::Crc16Ccitt::Calculate(
-        std::as_bytes(std::span(const_cast<const T*>(&contents_), 1)));
+  typename Checksum::Value CalculateCrc() const {
+    return Checksum::Update(
+        std::as_bytes(std::span(const_cast<const T*>(&contents_), 1)),
+        Checksum::kEmpty);
   }
 
   // Use unions to denote that these members are never initialized by design and
@@ -171,7 +173,7 @@ class Persistent {
     volatile T contents_;
   };
   union {
-    volatile uint16_t crc_;
+    volatile typename Checksum::Value crc_;
   };
 };
 
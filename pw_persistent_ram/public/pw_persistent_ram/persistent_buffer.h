@@ -20,7 +20,7 @@
 #include <utility>
 
 #include "pw_bytes/span.h"
-#include "pw_checksum/crc16_ccitt.h"
+#include "pw_persistent_ram/checksum.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
@@ -37,13 +37,20 @@ class PersistentBufferWriter : public stream::NonSeekableWriter {
   PersistentBufferWriter() = delete;
 
  private:
-  template <size_t>
+  template <size_t, typename>
   friend class PersistentBuffer;
 
+  // Extends the checksum stored at checksum with data.
+  using ChecksumUpdate = void (*)(volatile void* checksum, ConstByteSpan data);
+
   PersistentBufferWriter(ByteSpan buffer,
                          volatile size_t& size,
-                         volatile uint16_t& checksum)
-      : buffer_(buffer), size_(size), checksum_(checksum) {}
+                         volatile void* checksum,
+                         ChecksumUpdate update_checksum)
+      : buffer_(buffer),
+        size_(size),
+        checksum_(checksum),
+        update_checksum_(update_checksum) {}
 
   // Implementation for writing data to this stream.
   Status DoWrite(ConstByteSpan data) override;
@@ -57,7 +64,8 @@ class PersistentBufferWriter : public stream::NonSeekableWriter {
 
   ByteSpan buffer_;
   volatile size_t& size_;
-  volatile uint16_t& checksum_;
+  volatile void* checksum_;
+  ChecksumUpdate update_checksum_;
 };
 
 // The PersistentBuffer class intentionally uses uninitialized memory, which
@@ -77,7 +85,12 @@ PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wmaybe-uninitialized");
 // instead, as data is validated on creation of the PersistentBufferWriter,
 // which allows access to the underlying data without needing to validate the
 // data's integrity with each call to PersistentBufferWriter functions.
-template <size_t kMaxSizeBytes>
+//
+// The integrity check is CRC16 by default. Checksum may be set to another
+// policy from pw_persistent_ram/checksum.h, such as Crc32Checksum, or to a
+// project-provided policy that uses a hardware CRC. Writes only checksum the
+// newly written data, regardless of the policy.
+template <size_t kMaxSizeBytes, typename Checksum = Crc16Checksum>
 class PersistentBuffer {
  public:
   // The default constructor intentionally does not initialize anything. This
@@ -109,7 +122,8 @@ class PersistentBuffer {
     return PersistentBufferWriter(
         ByteSpan(const_cast<std::byte*>(buffer_), kMaxSizeBytes),
         size_,
-        checksum_);
+        &checksum_,
+        UpdateChecksum);
   }
 
   size_t size() const {
@@ -123,7 +137,7 @@ class PersistentBuffer {
 
   void clear() {
     size_ = 0;
-    checksum_ = checksum::Crc16Ccitt::kInitialValue;
+    checksum_ = Checksum::kEmpty;
   }
 
   bool has_value() const {
@@ -132,13 +146,20 @@ class PersistentBuffer {
     }
 
     // Check checksum. This is more costly.
-    return checksum_ == checksum::Crc16Ccitt::Calculate(ConstByteSpan(
-                            const_cast<std::byte*>(buffer_), size_));
+    return checksum_ ==
+           Checksum::Update(
+               ConstByteSpan(const_cast<std::byte*>(buffer_), size_),
+               Checksum::kEmpty);
   }
 
  private:
+  static void UpdateChecksum(volatile void* checksum, ConstByteSpan data) {
+    auto& value = *static_cast<volatile typename Checksum::Value*>(checksum);
+    value = Checksum::Update(data, value);
+  }
+
   // None of these members are initialized by the constructor by design.
-  volatile uint16_t checksum_;
+  volatile typename Checksum::Value checksum_;
   volatile size_t size_;
   volatile std::byte buffer_[kMaxSizeBytes];
 };
@@ -0,0 +1,105 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_profiler/profiler_service.h"
+
+#include <algorithm>
+#include <array>
+
+#include "pw_profiler_proto/profiler.pwpb.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/try.h"
+
+namespace pw::profiler {
+
+void ProfilerService::Stream(ConstByteSpan, rpc::RawServerWriter& writer) {
+  // Start each stream with a fresh buffer and dropped count.
+  sampler_.Disable();
+  std::array<Sample, kMaxSamplesPerBatch> discarded;
+  while (sampler_.buffer().Pop(discarded) != 0u) {
+  }
+  sampler_.buffer().TakeDroppedCount();
+
+  writer_ = std::move(writer);
+  sampler_.Enable();
+}
+
+size_t ProfilerService::samples_per_batch() const {
+  if (encoding_buffer_.size() <= kMaxEncodedOverheadSizeBytes) {
+    return 0;
+  }
+  return std::min(kMaxSamplesPerBatch,
+                  (encoding_buffer_.size() - kMaxEncodedOverheadSizeBytes) /
+                      kMaxEncodedSampleSizeBytes);
+}
+
+Status ProfilerService::Flush() {
+  std::array<Sample, kMaxSamplesPerBatch> samples;
+
+  if (!writer_.active()) {
+    sampler_.Disable();
+    while (sampler_.buffer().Pop(samples) != 0u) {
+    }
+    return Status::FailedPrecondition();
+  }
+
+  const size_t batch_size = samples_per_batch();
+  if (batch_size == 0u) {
+    return Status::ResourceExhausted();
+  }
+
+  std::array<uint32_t, kMaxSamplesPerBatch> pcs;
+  std::array<uint32_t, kMaxSamplesPerBatch> thread_ids;
+
+  while (true) {
+    const size_t count =
+        sampler_.buffer().Pop(std::span(samples).first(batch_size));
+    const uint32_t dropped = sampler_.buffer().TakeDroppedCount();
+    if (count == 0u && dropped == 0u) {
+      return OkStatus();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      pcs[i] = samples[i].pc;
+      thread_ids[i] = samples[i].thread_id;
+    }
+
+    protobuf::MemoryEncoder encoder(encoding_buffer_);
+    encoder
+        .WritePackedFixed32(static_cast<uint32_t>(SampleBatch::Fields::PC),
+                            std::span(pcs).first(count))
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    if (sampler_.samples_thread_ids()) {
+      encoder
+          .WritePackedUint32(
+              static_cast<uint32_t>(SampleBatch::Fields::THREAD_ID),
+              std::span(thread_ids).first(count))
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+    if (dropped != 0u) {
+      encoder
+          .WriteUint32(static_cast<uint32_t>(SampleBatch::Fields::DROPPED),
+                       dropped)
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+    PW_TRY(encoder.status());
+    PW_TRY(writer_.Write(encoder));
+
+    if (count < batch_size) {
+      return OkStatus();
+    }
+  }
+}
+
+}  // namespace pw::profiler
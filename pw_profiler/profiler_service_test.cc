@@ -0,0 +1,154 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_profiler/profiler_service.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_profiler_proto/profiler.pwpb.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::profiler {
+namespace {
+
+constexpr size_t kSamplesPerBatch = 4;
+
+using TestProfilerService = ProfilerServiceWithBuffer<kSamplesPerBatch>;
+
+#define ProfilerMethodContext \
+  PW_RAW_TEST_METHOD_CONTEXT(TestProfilerService, Stream, 8)
+
+struct Batch {
+  std::vector<uint32_t> pcs;
+  std::vector<uint32_t> thread_ids;
+  uint32_t dropped = 0;
+};
+
+Batch DecodeBatch(ConstByteSpan response) {
+  Batch batch;
+  stream::MemoryReader reader(response);
+  protobuf::StreamDecoder decoder(reader);
+  while (decoder.Next().ok()) {
+    switch (static_cast<SampleBatch::Fields>(decoder.FieldNumber().value())) {
+      case SampleBatch::Fields::PC: {
+        std::array<uint32_t, kSamplesPerBatch> pcs;
+        StatusWithSize result = decoder.ReadPackedFixed32(pcs);
+        EXPECT_EQ(OkStatus(), result.status());
+        batch.pcs.assign(pcs.begin(), pcs.begin() + result.size());
+        break;
+      }
+      case SampleBatch::Fields::THREAD_ID: {
+        std::array<uint32_t, kSamplesPerBatch> thread_ids;
+        StatusWithSize result = decoder.ReadPackedUint32(thread_ids);
+        EXPECT_EQ(OkStatus(), result.status());
+        batch.thread_ids.assign(thread_ids.begin(),
+                                thread_ids.begin() + result.size());
+        break;
+      }
+      case SampleBatch::Fields::DROPPED: {
+        Result<uint32_t> dropped = decoder.ReadUint32();
+        EXPECT_EQ(OkStatus(), dropped.status());
+        batch.dropped = dropped.value_or(0);
+        break;
+      }
+    }
+  }
+  return batch;
+}
+
+uint32_t current_thread_id = 7;
+
+uint32_t CurrentThreadId() { return current_thread_id; }
+
+TEST(ProfilerService, SamplesOnlyWhileStreaming) {
+  SampleBufferWithStorage<8> buffer;
+  Sampler sampler(buffer);
+  ProfilerMethodContext context(sampler);
+
+  sampler.RecordSample(0x1000);
+  EXPECT_EQ(buffer.size(), 0u);
+  EXPECT_EQ(Status::FailedPrecondition(), context.service().Flush());
+
+  context.call({});
+  EXPECT_TRUE(sampler.enabled());
+  sampler.RecordSample(0x1000);
+  EXPECT_EQ(buffer.size(), 1u);
+}
+
+TEST(ProfilerService, FlushSendsBatches) {
+  SampleBufferWithStorage<8> buffer;
+  Sampler sampler(buffer);
+  ProfilerMethodContext context(sampler);
+  context.call({});
+
+  for (uint32_t pc = 0x1000; pc < 0x1018; pc += 4) {
+    sampler.RecordSample(pc);
+  }
+  EXPECT_EQ(OkStatus(), context.service().Flush());
+
+  ASSERT_EQ(context.responses().size(), 2u);
+  Batch first = DecodeBatch(context.responses()[0]);
+  EXPECT_EQ(first.pcs,
+            (std::vector<uint32_t>{0x1000, 0x1004, 0x1008, 0x100c}));
+  EXPECT_TRUE(first.thread_ids.empty());
+  EXPECT_EQ(first.dropped, 0u);
+
+  Batch second = DecodeBatch(context.responses()[1]);
+  EXPECT_EQ(second.pcs, (std::vector<uint32_t>{0x1010, 0x1014}));
+
+  // Nothing is sent if there are no new samples.
+  EXPECT_EQ(OkStatus(), context.service().Flush());
+  EXPECT_EQ(context.responses().size(), 2u);
+}
+
+TEST(ProfilerService, SendsThreadIds) {
+  SampleBufferWithStorage<8> buffer;
+  Sampler sampler(buffer, CurrentThreadId);
+  ProfilerMethodContext context(sampler);
+  context.call({});
+
+  current_thread_id = 7;
+  sampler.RecordSample(0x1000);
+  current_thread_id = 9;
+  sampler.RecordSample(0x2000);
+  EXPECT_EQ(OkStatus(), context.service().Flush());
+
+  ASSERT_EQ(context.responses().size(), 1u);
+  Batch batch = DecodeBatch(context.responses()[0]);
+  EXPECT_EQ(batch.pcs, (std::vector<uint32_t>{0x1000, 0x2000}));
+  EXPECT_EQ(batch.thread_ids, (std::vector<uint32_t>{7, 9}));
+}
+
+TEST(ProfilerService, ReportsDroppedSamples) {
+  SampleBufferWithStorage<2> buffer;
+  Sampler sampler(buffer);
+  ProfilerMethodContext context(sampler);
+  context.call({});
+
+  for (uint32_t pc = 0; pc < 5; ++pc) {
+    sampler.RecordSample(pc);
+  }
+  EXPECT_EQ(OkStatus(), context.service().Flush());
+
+  ASSERT_EQ(context.responses().size(), 1u);
+  Batch batch = DecodeBatch(context.responses()[0]);
+  EXPECT_EQ(batch.pcs, (std::vector<uint32_t>{0, 1}));
+  EXPECT_EQ(batch.dropped, 3u);
+}
+
+}  // namespace
+}  // namespace pw::profiler
@@ -0,0 +1,61 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Captures the interrupted program counter from a Cortex-M exception handler.
+//
+// PW_PROFILER_CORTEX_M_SAMPLING_HANDLER(handler, sample_function) defines the
+// interrupt handler `handler`, which reads the program counter from the
+// exception stack frame of the interrupted code and tail calls
+//
+//   extern "C" void sample_function(uint32_t pc);
+//
+// The sample function runs as the interrupt handler, so it must also clear the
+// timer interrupt if needed. For example:
+//
+//   PW_PROFILER_CORTEX_M_SAMPLING_HANDLER(TIM2_IRQHandler, RecordProfile)
+//
+//   extern "C" void RecordProfile(uint32_t pc) {
+//     TIM2->SR = 0;
+//     sampler.RecordSample(pc);
+//   }
+//
+// The handler only uses ARMv6-M instructions, so it works on all Cortex-M
+// cores. It does not support handlers that interrupt Secure code from the
+// Non-secure state on ARMv8-M.
+#pragma once
+
+#include <cstdint>
+
+#define PW_PROFILER_CORTEX_M_SAMPLING_HANDLER(handler, sample_function) \
+  extern "C" void sample_function(uint32_t pc);                         \
+  extern "C" __attribute__((naked)) void handler() {                    \
+    asm volatile(                                                       \
+        /* EXC_RETURN bit 2 selects the stack the frame is on. */       \
+        "  mov r0, lr                                           \n"     \
+        "  movs r1, #4                                          \n"     \
+        "  tst r0, r1                                           \n"     \
+        "  bne 1f                                               \n"     \
+        "  mrs r0, msp                                          \n"     \
+        "  b 2f                                                 \n"     \
+        "1:                                                     \n"     \
+        "  mrs r0, psp                                          \n"     \
+        "2:                                                     \n"     \
+        /* The stacked PC is the seventh word of the frame. */          \
+        "  ldr r0, [r0, #24]                                    \n"     \
+        "  ldr r1, =" #sample_function "                        \n"     \
+        "  bx r1                                                \n"     \
+        /* Keep the literal pool within range of the ldr. */            \
+        "  .ltorg                                               \n");   \
+  }                                                                     \
+  static_assert(true, "Macros must be terminated with a semicolon")
@@ -0,0 +1,97 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_profiler/sampler.h"
+#include "pw_profiler_proto/profiler.raw_rpc.pb.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/status.h"
+
+namespace pw::profiler {
+
+// Streams samples from a Sampler to a client. Opening the Stream RPC enables
+// sampling; the samples are sent in batches by Flush(), which the application
+// calls periodically from a thread. Sampling stops when the call ends. Only
+// one client may stream at a time; a new call replaces the previous one.
+class ProfilerService
+    : public pw_rpc::raw::Profiler::Service<ProfilerService> {
+ public:
+  // The maximum number of samples sent in one SampleBatch.
+  static constexpr size_t kMaxSamplesPerBatch = 32;
+
+  // Returns the size of the encoding buffer needed to send the given number of
+  // samples per batch.
+  static constexpr size_t EncodingBufferSizeBytes(
+      size_t samples_per_batch = kMaxSamplesPerBatch) {
+    return samples_per_batch * kMaxEncodedSampleSizeBytes +
+           kMaxEncodedOverheadSizeBytes;
+  }
+
+  ProfilerService(Sampler& sampler, ByteSpan encoding_buffer)
+      : sampler_(sampler), encoding_buffer_(encoding_buffer) {}
+
+  void Stream(ConstByteSpan request, rpc::RawServerWriter& writer);
+
+  // Sends the buffered samples to the streaming client. Returns
+  // FAILED_PRECONDITION if no client is streaming, in which case sampling is
+  // disabled and buffered samples are discarded. Do not call from an
+  // interrupt.
+  Status Flush();
+
+ private:
+  // A packed fixed32 PC and a varint thread ID.
+  static constexpr size_t kMaxEncodedSampleSizeBytes = 4 + 5;
+
+  // Keys and lengths of the two packed fields, and the dropped count.
+  static constexpr size_t kMaxEncodedOverheadSizeBytes = 3 * (1 + 5);
+
+  size_t samples_per_batch() const;
+
+  Sampler& sampler_;
+  ByteSpan encoding_buffer_;
+  rpc::RawServerWriter writer_;
+};
+
+namespace internal {
+
+// Storage for ProfilerServiceWithBuffer, as a base class so that it is
+// initialized before the ProfilerService.
+template <size_t kSamplesPerBatch>
+struct ProfilerServiceStorage {
+  std::array<std::byte,
+             ProfilerService::EncodingBufferSizeBytes(kSamplesPerBatch)>
+      encoding_buffer;
+};
+
+}  // namespace internal
+
+// A ProfilerService with an encoding buffer for kSamplesPerBatch samples.
+template <size_t kSamplesPerBatch = ProfilerService::kMaxSamplesPerBatch>
+class ProfilerServiceWithBuffer
+    : private internal::ProfilerServiceStorage<kSamplesPerBatch>,
+      public ProfilerService {
+ public:
+  static_assert(kSamplesPerBatch > 0u &&
+                kSamplesPerBatch <= ProfilerService::kMaxSamplesPerBatch);
+
+  ProfilerServiceWithBuffer(Sampler& sampler)
+      : ProfilerService(sampler, this->encoding_buffer) {}
+};
+
+}  // namespace pw::profiler
@@ -0,0 +1,93 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace pw::profiler {
+
+// A program counter sample, with the ID of the thread that was interrupted.
+struct Sample {
+  uint32_t pc;
+  uint32_t thread_id;
+};
+
+// A single-producer, single-consumer queue of samples. The producer, usually
+// the sampling interrupt, pushes samples and the consumer, usually a thread
+// that sends the samples to a host, pops them. Neither side blocks or takes a
+// lock, and only atomic loads and stores are used, so the buffer works on cores
+// without atomic read-modify-write instructions.
+//
+// One storage entry is kept empty to distinguish a full buffer from an empty
+// one, so the buffer holds up to storage.size() - 1 samples.
+class SampleBuffer {
+ public:
+  constexpr SampleBuffer(std::span<Sample> storage)
+      : storage_(storage), head_(0), tail_(0), dropped_(0), dropped_taken_(0) {}
+
+  SampleBuffer(const SampleBuffer&) = delete;
+  SampleBuffer& operator=(const SampleBuffer&) = delete;
+
+  // Adds a sample. Only call from the producer. If the buffer is full, drops
+  // the sample, counts it, and returns false.
+  bool Push(const Sample& sample);
+
+  // Removes up to samples.size() of the oldest samples into samples. Only call
+  // from the consumer. Returns the number of samples removed.
+  size_t Pop(std::span<Sample> samples);
+
+  // Returns the number of samples dropped since the last call. Only call from
+  // the consumer.
+  uint32_t TakeDroppedCount();
+
+  // The number of samples in the buffer. The result may be stale if called
+  // while the other side is pushing or popping.
+  size_t size() const;
+
+  size_t capacity() const {
+    return storage_.empty() ? 0 : storage_.size() - 1;
+  }
+
+ private:
+  size_t Next(size_t index) const {
+    return index + 1 == storage_.size() ? 0 : index + 1;
+  }
+
+  std::span<Sample> storage_;
+  std::atomic<size_t> head_;  // Index of the oldest sample. Set by Pop().
+  std::atomic<size_t> tail_;  // Index of the next free entry. Set by Push().
+
+  // Total samples dropped, written only by the producer, and the total at the
+  // last TakeDroppedCount(), used only by the consumer.
+  std::atomic<uint32_t> dropped_;
+  uint32_t dropped_taken_;
+};
+
+// A SampleBuffer with internal storage for kCapacity samples.
+template <size_t kCapacity>
+class SampleBufferWithStorage : public SampleBuffer {
+ public:
+  constexpr SampleBufferWithStorage() : SampleBuffer(storage_), storage_{} {}
+
+ private:
+  static_assert(kCapacity > 0u);
+
+  std::array<Sample, kCapacity + 1> storage_;
+};
+
+}  // namespace pw::profiler
@@ -0,0 +1,61 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_profiler/sample_buffer.h"
+
+namespace pw::profiler {
+
+// Records program counter samples into a SampleBuffer. Call RecordSample() from
+// a periodic timer interrupt with the interrupted program counter; see
+// pw_profiler/cortex_m.h for capturing it on Cortex-M. Samples are only
+// recorded while sampling is enabled, which the ProfilerService does while a
+// client is streaming samples.
+class Sampler {
+ public:
+  // Returns the ID of the current thread, such as a pointer to its control
+  // block. Called from the sampling interrupt.
+  using ThreadIdFunction = uint32_t (*)();
+
+  constexpr Sampler(SampleBuffer& buffer, ThreadIdFunction thread_id = nullptr)
+      : buffer_(buffer), thread_id_(thread_id), enabled_(false) {}
+
+  Sampler(const Sampler&) = delete;
+  Sampler& operator=(const Sampler&) = delete;
+
+  // Records a sample if sampling is enabled. Call from the sampling interrupt.
+  void RecordSample(uint32_t pc) {
+    if (enabled_.load(std::memory_order_relaxed)) {
+      buffer_.Push({pc, thread_id_ != nullptr ? thread_id_() : 0u});
+    }
+  }
+
+  void Enable() { enabled_.store(true, std::memory_order_relaxed); }
+  void Disable() { enabled_.store(false, std::memory_order_relaxed); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  bool samples_thread_ids() const { return thread_id_ != nullptr; }
+
+  SampleBuffer& buffer() { return buffer_; }
+
+ private:
+  SampleBuffer& buffer_;
+  const ThreadIdFunction thread_id_;
+  std::atomic<bool> enabled_;
+};
+
+}  // namespace pw::profiler
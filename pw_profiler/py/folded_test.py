@@ -0,0 +1,83 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for converting pw_profiler samples to folded stacks."""
+
+import io
+from typing import NamedTuple, Sequence
+import unittest
+
+from pw_profiler import Profile, collect, write_folded
+from pw_symbolizer import FakeSymbolizer, Symbol
+
+
+class _Batch(NamedTuple):
+    """Stands in for a decoded pw.profiler.SampleBatch."""
+    pc: Sequence[int]
+    thread_id: Sequence[int] = ()
+    dropped: int = 0
+
+
+_SYMBOLIZER = FakeSymbolizer([
+    Symbol(0x1000, 'Idle'),
+    Symbol(0x2000, 'ProcessPacket'),
+])
+
+
+class CollectTest(unittest.TestCase):
+    """Tests accumulating SampleBatch messages."""
+    def test_counts_samples_per_thread_and_pc(self):
+        profile = collect([
+            _Batch(pc=[0x1000, 0x2000, 0x2000], thread_id=[1, 2, 2]),
+            _Batch(pc=[0x2000], thread_id=[1], dropped=3),
+        ])
+        self.assertEqual(profile.samples, {
+            (1, 0x1000): 1,
+            (2, 0x2000): 2,
+            (1, 0x2000): 1,
+        })
+        self.assertEqual(profile.dropped, 3)
+
+    def test_no_thread_ids(self):
+        profile = collect([_Batch(pc=[0x1000, 0x1000])])
+        self.assertEqual(profile.samples, {(0, 0x1000): 2})
+
+    def test_mismatched_thread_ids(self):
+        with self.assertRaises(ValueError):
+            collect([_Batch(pc=[0x1000, 0x2000], thread_id=[1])])
+
+
+class WriteFoldedTest(unittest.TestCase):
+    """Tests writing folded stacks."""
+    def test_sorted_by_count(self):
+        output = io.StringIO()
+        write_folded(collect([_Batch(pc=[0x1000, 0x2000, 0x2000])]),
+                     _SYMBOLIZER, output)
+        self.assertEqual(output.getvalue(), '0;ProcessPacket 2\n0;Idle 1\n')
+
+    def test_thread_names(self):
+        output = io.StringIO()
+        write_folded(collect([_Batch(pc=[0x2000], thread_id=[7])]),
+                     _SYMBOLIZER,
+                     output,
+                     thread_names={7: 'rpc'})
+        self.assertEqual(output.getvalue(), 'rpc;ProcessPacket 1\n')
+
+    def test_unknown_pc_written_as_address(self):
+        output = io.StringIO()
+        write_folded(Profile({(0, 0xabc): 4}, 0), _SYMBOLIZER, output)
+        self.assertEqual(output.getvalue(), '0;0x00000abc 4\n')
+
+
+if __name__ == '__main__':
+    unittest.main()
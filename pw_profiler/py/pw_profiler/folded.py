@@ -0,0 +1,163 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Converts pw_profiler samples into folded stacks for flame graphs.
+
+The folded format has one line per unique stack, with frames separated by
+semicolons and followed by a sample count:
+
+  main_thread;ProcessPacket 120
+  idle;IdleLoop 4
+
+This is the input format of flamegraph.pl, speedscope, and most other flame
+graph viewers. pw_profiler samples only the interrupted PC, so each stack is
+the thread followed by the function containing the PC.
+"""
+
+import argparse
+import collections
+import logging
+import os
+from pathlib import Path
+import sys
+from typing import (Counter, Dict, Iterable, Mapping, NamedTuple, Optional,
+                    TextIO, Tuple)
+
+import serial  # type: ignore
+
+from pw_hdlc.rpc import HdlcRpcClient, default_channels
+from pw_rpc import callback_client
+from pw_symbolizer import LlvmSymbolizer, Symbolizer
+
+_LOG = logging.getLogger(__package__)
+
+_PROFILER_PROTO = Path(os.environ.get('PW_ROOT', ''), 'pw_profiler',
+                       'pw_profiler_proto', 'profiler.proto')
+
+
+class Profile(NamedTuple):
+    """Sample counts keyed by (thread ID, PC) and the total dropped count."""
+    samples: Counter[Tuple[int, int]]
+    dropped: int
+
+
+def collect(batches: Iterable) -> Profile:
+    """Accumulates pw.profiler.SampleBatch messages into a Profile.
+
+    Batches without thread IDs are attributed to thread 0.
+    """
+    samples: Counter[Tuple[int, int]] = collections.Counter()
+    dropped = 0
+
+    for batch in batches:
+        thread_ids = list(batch.thread_id)
+        if thread_ids and len(thread_ids) != len(batch.pc):
+            raise ValueError(
+                f'SampleBatch has {len(batch.pc)} PCs but {len(thread_ids)} '
+                'thread IDs')
+
+        for i, pc in enumerate(batch.pc):
+            samples[(thread_ids[i] if thread_ids else 0, pc)] += 1
+
+        dropped += batch.dropped
+
+    return Profile(samples, dropped)
+
+
+def stream_from_device(rpcs, duration_s: float) -> Profile:
+    """Streams samples from a device's pw.profiler.Profiler service.
+
+    The device samples while the stream is open. The stream is cancelled after
+    duration_s seconds.
+    """
+    profiler = rpcs.pw.profiler.Profiler  # type: ignore[attr-defined]
+    call = profiler.Stream.invoke()
+    try:
+        call.wait(timeout_s=duration_s)
+    except callback_client.RpcTimeout:
+        pass  # The stream is open-ended, so ending it by timeout is expected.
+    finally:
+        call.cancel()
+
+    return collect(call.responses)
+
+
+def write_folded(profile: Profile,
+                 symbolizer: Symbolizer,
+                 output: TextIO,
+                 thread_names: Optional[Mapping[int, str]] = None) -> None:
+    """Writes a Profile as folded stacks, sorted by descending count.
+
+    PCs that do not resolve to a function are written as hex addresses.
+    Threads without an entry in thread_names are written as their ID.
+    """
+    if thread_names is None:
+        thread_names = {}
+
+    folded: Counter[str] = collections.Counter()
+    names: Dict[int, str] = {}
+
+    for (thread_id, pc), count in profile.samples.items():
+        if pc not in names:
+            symbol = symbolizer.symbolize(pc)
+            names[pc] = symbol.name if symbol.name else f'0x{pc:08x}'
+
+        thread = thread_names.get(thread_id, str(thread_id))
+        folded[f'{thread};{names[pc]}'] += count
+
+    for stack, count in sorted(folded.items(), key=lambda x: (-x[1], x[0])):
+        output.write(f'{stack} {count}\n')
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--device',
+                        required=True,
+                        help='Serial device the pw_rpc server is attached to')
+    parser.add_argument('--baudrate', type=int, default=115200)
+    parser.add_argument('--elf',
+                        type=Path,
+                        required=True,
+                        help='Firmware ELF used to symbolize sampled PCs')
+    parser.add_argument('--duration',
+                        type=float,
+                        default=10.0,
+                        help='Seconds to sample for')
+    parser.add_argument('-o',
+                        '--output',
+                        type=argparse.FileType('w'),
+                        default=sys.stdout,
+                        help='Folded stack output file')
+    return parser.parse_args()
+
+
+def main(device: str, baudrate: int, elf: Path, duration: float,
+         output: TextIO) -> int:
+    serial_device = serial.Serial(device, baudrate, timeout=0.01)
+    client = HdlcRpcClient(lambda: serial_device.read(4096),
+                           [_PROFILER_PROTO],
+                           default_channels(serial_device.write))
+
+    profile = stream_from_device(client.rpcs(), duration)
+    if profile.dropped:
+        _LOG.warning(
+            '%d samples were dropped; lower the sampling rate or flush more '
+            'often', profile.dropped)
+
+    write_folded(profile, LlvmSymbolizer(elf), output)
+    return 0
+
+
+if __name__ == '__main__':
+    logging.basicConfig(level=logging.INFO)
+    sys.exit(main(**vars(_parse_args())))
@@ -0,0 +1,61 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_profiler/sample_buffer.h"
+
+namespace pw::profiler {
+
+bool SampleBuffer::Push(const Sample& sample) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t next = Next(tail);
+
+  if (storage_.empty() || next == head_.load(std::memory_order_acquire)) {
+    dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    return false;
+  }
+
+  storage_[tail] = sample;
+  tail_.store(next, std::memory_order_release);
+  return true;
+}
+
+size_t SampleBuffer::Pop(std::span<Sample> samples) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  const size_t tail = tail_.load(std::memory_order_acquire);
+
+  size_t count = 0;
+  for (; count < samples.size() && head != tail; ++count) {
+    samples[count] = storage_[head];
+    head = Next(head);
+  }
+
+  head_.store(head, std::memory_order_release);
+  return count;
+}
+
+uint32_t SampleBuffer::TakeDroppedCount() {
+  const uint32_t dropped = dropped_.load(std::memory_order_relaxed);
+  const uint32_t newly_dropped = dropped - dropped_taken_;
+  dropped_taken_ = dropped;
+  return newly_dropped;
+}
+
+size_t SampleBuffer::size() const {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  return tail >= head ? tail - head : storage_.size() - head + tail;
+}
+
+}  // namespace pw::profiler
@@ -0,0 +1,84 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_profiler/sample_buffer.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::profiler {
+namespace {
+
+TEST(SampleBuffer, Empty) {
+  SampleBufferWithStorage<4> buffer;
+  std::array<Sample, 4> samples;
+
+  EXPECT_EQ(buffer.capacity(), 4u);
+  EXPECT_EQ(buffer.size(), 0u);
+  EXPECT_EQ(buffer.Pop(samples), 0u);
+  EXPECT_EQ(buffer.TakeDroppedCount(), 0u);
+}
+
+TEST(SampleBuffer, PopsInOrder) {
+  SampleBufferWithStorage<4> buffer;
+  EXPECT_TRUE(buffer.Push({0x1000, 1}));
+  EXPECT_TRUE(buffer.Push({0x1004, 2}));
+  EXPECT_TRUE(buffer.Push({0x1008, 1}));
+  EXPECT_EQ(buffer.size(), 3u);
+
+  std::array<Sample, 2> samples;
+  ASSERT_EQ(buffer.Pop(samples), 2u);
+  EXPECT_EQ(samples[0].pc, 0x1000u);
+  EXPECT_EQ(samples[0].thread_id, 1u);
+  EXPECT_EQ(samples[1].pc, 0x1004u);
+  EXPECT_EQ(samples[1].thread_id, 2u);
+
+  ASSERT_EQ(buffer.Pop(samples), 1u);
+  EXPECT_EQ(samples[0].pc, 0x1008u);
+  EXPECT_EQ(buffer.size(), 0u);
+}
+
+TEST(SampleBuffer, DropsWhenFull) {
+  SampleBufferWithStorage<2> buffer;
+  EXPECT_TRUE(buffer.Push({1, 0}));
+  EXPECT_TRUE(buffer.Push({2, 0}));
+  EXPECT_FALSE(buffer.Push({3, 0}));
+  EXPECT_FALSE(buffer.Push({4, 0}));
+
+  EXPECT_EQ(buffer.TakeDroppedCount(), 2u);
+  EXPECT_EQ(buffer.TakeDroppedCount(), 0u);
+
+  std::array<Sample, 4> samples;
+  ASSERT_EQ(buffer.Pop(samples), 2u);
+  EXPECT_EQ(samples[0].pc, 1u);
+  EXPECT_EQ(samples[1].pc, 2u);
+}
+
+TEST(SampleBuffer, WrapsAround) {
+  SampleBufferWithStorage<3> buffer;
+  std::array<Sample, 2> samples;
+
+  for (uint32_t pc = 0; pc < 20; pc += 2) {
+    ASSERT_TRUE(buffer.Push({pc, 0}));
+    ASSERT_TRUE(buffer.Push({pc + 1, 0}));
+    EXPECT_EQ(buffer.size(), 2u);
+
+    ASSERT_EQ(buffer.Pop(samples), 2u);
+    EXPECT_EQ(samples[0].pc, pc);
+    EXPECT_EQ(samples[1].pc, pc + 1);
+  }
+  EXPECT_EQ(buffer.TakeDroppedCount(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::profiler
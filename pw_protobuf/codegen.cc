@@ -0,0 +1,272 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/internal/codegen.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf::internal {
+namespace {
+
+const MessageField* FindField(std::span<const MessageField> fields,
+                              uint32_t field_number) {
+  const MessageField* field = std::lower_bound(
+      fields.begin(),
+      fields.end(),
+      field_number,
+      [](const MessageField& entry, uint32_t number) {
+        return entry.field_number < number;
+      });
+  if (field == fields.end() || field->field_number != field_number) {
+    return nullptr;
+  }
+  return field;
+}
+
+// Stores an integer in a member of the given size, truncating it as needed.
+void StoreInteger(std::byte* member, size_t size, uint64_t value) {
+  if (size == sizeof(uint32_t)) {
+    const uint32_t truncated = static_cast<uint32_t>(value);
+    std::memcpy(member, &truncated, sizeof(truncated));
+  } else {
+    std::memcpy(member, &value, sizeof(value));
+  }
+}
+
+Status DecodeField(Decoder& decoder,
+                   const MessageField& field,
+                   std::byte* member) {
+  switch (field.encoding) {
+    case FieldEncoding::kVarint:
+    case FieldEncoding::kSignedVarint: {
+      uint64_t value;
+      PW_TRY(decoder.ReadUint64(&value));
+      StoreInteger(member, field.size, value);
+      return OkStatus();
+    }
+    case FieldEncoding::kZigZag: {
+      int64_t value;
+      PW_TRY(decoder.ReadSint64(&value));
+      StoreInteger(member, field.size, static_cast<uint64_t>(value));
+      return OkStatus();
+    }
+    case FieldEncoding::kBool: {
+      bool value;
+      PW_TRY(decoder.ReadBool(&value));
+      std::memcpy(member, &value, sizeof(value));
+      return OkStatus();
+    }
+    case FieldEncoding::kFixed: {
+      if (field.size == sizeof(uint32_t)) {
+        uint32_t value;
+        PW_TRY(decoder.ReadFixed32(&value));
+        std::memcpy(member, &value, sizeof(value));
+      } else {
+        uint64_t value;
+        PW_TRY(decoder.ReadFixed64(&value));
+        std::memcpy(member, &value, sizeof(value));
+      }
+      return OkStatus();
+    }
+    case FieldEncoding::kString: {
+      std::string_view value;
+      PW_TRY(decoder.ReadString(&value));
+      *reinterpret_cast<std::string_view*>(member) = value;
+      return OkStatus();
+    }
+    case FieldEncoding::kBytes: {
+      std::span<const std::byte> value;
+      PW_TRY(decoder.ReadBytes(&value));
+      *reinterpret_cast<std::span<const std::byte>*>(member) = value;
+      return OkStatus();
+    }
+  }
+  return Status::Internal();
+}
+
+// Loads an integer member of the given size. 32-bit members are sign-extended
+// if is_signed is set.
+uint64_t LoadInteger(const std::byte* member, size_t size, bool is_signed) {
+  if (size == sizeof(uint32_t)) {
+    uint32_t value;
+    std::memcpy(&value, member, sizeof(value));
+    return is_signed ? static_cast<uint64_t>(static_cast<int32_t>(value))
+                     : value;
+  }
+  uint64_t value;
+  std::memcpy(&value, member, sizeof(value));
+  return value;
+}
+
+// A field's value as it appears on the wire, after the key.
+struct WireValue {
+  WireType wire_type;
+  // The varint value, the fixed value, or the length of a delimited field.
+  uint64_t value;
+  // The contents of a delimited field.
+  const std::byte* data;
+};
+
+// Reads a member into its wire representation. Returns false if the member
+// has its default value and should not be encoded.
+bool LoadField(const MessageField& field,
+               const std::byte* member,
+               WireValue& wire) {
+  wire.data = nullptr;
+  switch (field.encoding) {
+    case FieldEncoding::kVarint:
+    case FieldEncoding::kSignedVarint:
+      wire.wire_type = WireType::kVarint;
+      wire.value = LoadInteger(member,
+                               field.size,
+                               field.encoding == FieldEncoding::kSignedVarint);
+      break;
+    case FieldEncoding::kZigZag:
+      wire.wire_type = WireType::kVarint;
+      wire.value = varint::ZigZagEncode(
+          static_cast<int64_t>(LoadInteger(member, field.size, true)));
+      break;
+    case FieldEncoding::kBool: {
+      bool value;
+      std::memcpy(&value, member, sizeof(value));
+      wire.wire_type = WireType::kVarint;
+      wire.value = value ? 1 : 0;
+      break;
+    }
+    case FieldEncoding::kFixed:
+      // Floating point fields are compared bitwise, so -0.0 is encoded.
+      wire.wire_type = field.size == sizeof(uint32_t) ? WireType::kFixed32
+                                                      : WireType::kFixed64;
+      wire.value = LoadInteger(member, field.size, false);
+      break;
+    case FieldEncoding::kString: {
+      const auto& value = *reinterpret_cast<const std::string_view*>(member);
+      wire.wire_type = WireType::kDelimited;
+      wire.value = value.size();
+      wire.data = reinterpret_cast<const std::byte*>(value.data());
+      break;
+    }
+    case FieldEncoding::kBytes: {
+      const auto& value =
+          *reinterpret_cast<const std::span<const std::byte>*>(member);
+      wire.wire_type = WireType::kDelimited;
+      wire.value = value.size();
+      wire.data = value.data();
+      break;
+    }
+  }
+  return wire.value != 0;
+}
+
+size_t WireValueSize(const WireValue& wire) {
+  switch (wire.wire_type) {
+    case WireType::kVarint:
+      return varint::EncodedSize(wire.value);
+    case WireType::kFixed64:
+      return sizeof(uint64_t);
+    case WireType::kFixed32:
+      return sizeof(uint32_t);
+    case WireType::kDelimited:
+      return varint::EncodedSize(wire.value) + wire.value;
+  }
+  return 0;
+}
+
+}  // namespace
+
+size_t EncodedMessageSize(const void* message,
+                          std::span<const MessageField> fields) {
+  const std::byte* bytes = static_cast<const std::byte*>(message);
+  size_t size = 0;
+  WireValue wire;
+  for (const MessageField& field : fields) {
+    if (LoadField(field, bytes + field.offset, wire)) {
+      FieldKey key(field.field_number, wire.wire_type);
+      size += varint::EncodedSize(key) + WireValueSize(wire);
+    }
+  }
+  return size;
+}
+
+StatusWithSize EncodeMessage(const void* message,
+                             std::span<const MessageField> fields,
+                             std::span<std::byte> output) {
+  const size_t size = EncodedMessageSize(message, fields);
+  if (size > output.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  // The output is known to be large enough, so write without bounds checks.
+  const std::byte* bytes = static_cast<const std::byte*>(message);
+  std::byte* out = output.data();
+  WireValue wire;
+  for (const MessageField& field : fields) {
+    if (!LoadField(field, bytes + field.offset, wire)) {
+      continue;
+    }
+    out += varint::internal::EncodeUnchecked(
+        FieldKey(field.field_number, wire.wire_type), out);
+    switch (wire.wire_type) {
+      case WireType::kVarint:
+        out += varint::internal::EncodeUnchecked(wire.value, out);
+        break;
+      case WireType::kFixed64:
+      case WireType::kFixed32: {
+        // Fixed fields are little-endian on the wire.
+        const size_t fixed_size = WireValueSize(wire);
+        for (size_t i = 0; i < fixed_size; ++i) {
+          *out++ = static_cast<std::byte>(wire.value >> (8 * i));
+        }
+        break;
+      }
+      case WireType::kDelimited:
+        out += varint::internal::EncodeUnchecked(wire.value, out);
+        std::memcpy(out, wire.data, wire.value);
+        out += wire.value;
+        break;
+    }
+  }
+  return StatusWithSize(size);
+}
+
+Status DecodeMessage(std::span<const std::byte> data,
+                     std::span<const MessageField> fields,
+                     void* message) {
+  Decoder decoder(data);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    const MessageField* field = FindField(fields, decoder.FieldNumber());
+    if (field == nullptr) {
+      // Next() skips fields that were not read.
+      continue;
+    }
+    // A field with an unexpected wire type means the message doesn't match the
+    // table, so treat it the same as malformed data.
+    if (!DecodeField(
+             decoder, *field, static_cast<std::byte*>(message) + field->offset)
+             .ok()) {
+      return Status::DataLoss();
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+}  // namespace pw::protobuf::internal
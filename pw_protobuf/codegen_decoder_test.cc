@@ -467,6 +467,87 @@ TEST(Codegen, ImportedEnum) {
   EXPECT_EQ(status.status(), Status::DataLoss());
 }
 
+TEST(CodegenMessage, Decode) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // pigweed.magic_number
+    0x08, 0x49,
+    // pigweed.ziggy
+    0x10, 0xdd, 0x01,
+    // pigweed.cycles
+    0x19, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    // pigweed.ratio
+    0x25, 0x00, 0x00, 0xc0, 0x3f,
+    // pigweed.error_message
+    0x2a, 0x03, 'e', 'r', 'r',
+    // pigweed.device_info
+    0x32, 0x0c,
+    // pigweed.device_info.device_name
+    0x0a, 0x03, 'p', 'w', 'd',
+    // pigweed.device_info.device_id
+    0x15, 0xef, 0xbe, 0xad, 0xde,
+    // pigweed.device_info.status
+    0x18, 0x02,
+    // pigweed.bin
+    0x40, 0x01,
+    // pigweed.id[0] (repeated, not in the struct)
+    0x52, 0x02, 0x08, 0x31,
+    // Unknown field 15
+    0x78, 0x05,
+  };
+  // clang-format on
+
+  Pigweed::Message pigweed;
+  ASSERT_EQ(OkStatus(),
+            Pigweed::Decode(std::as_bytes(std::span(proto_data)), pigweed));
+
+  EXPECT_EQ(pigweed.magic_number, 0x49u);
+  EXPECT_EQ(pigweed.ziggy, -111);
+  EXPECT_EQ(pigweed.cycles, 0x0807060504030201u);
+  EXPECT_EQ(pigweed.ratio, 1.5f);
+  EXPECT_EQ(pigweed.error_message, "err");
+  EXPECT_EQ(pigweed.bin, Pigweed::Protobuf::Binary::ZERO);
+  EXPECT_TRUE(pigweed.pigweed.empty());
+  EXPECT_TRUE(pigweed.proto.empty());
+
+  // Submessages are decoded separately, from the span in their parent.
+  DeviceInfo::Message device_info;
+  ASSERT_EQ(OkStatus(), DeviceInfo::Decode(pigweed.device_info, device_info));
+  EXPECT_EQ(device_info.device_name, "pwd");
+  EXPECT_EQ(device_info.device_id, 0xdeadbeefu);
+  EXPECT_EQ(device_info.status, DeviceInfo::DeviceStatus::FAULT);
+}
+
+TEST(CodegenMessage, DecodeLastValueWins) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // pigweed.magic_number
+    0x08, 0x01,
+    // pigweed.magic_number
+    0x08, 0x02,
+  };
+  // clang-format on
+
+  Pigweed::Message pigweed;
+  ASSERT_EQ(OkStatus(),
+            Pigweed::Decode(std::as_bytes(std::span(proto_data)), pigweed));
+  EXPECT_EQ(pigweed.magic_number, 2u);
+}
+
+TEST(CodegenMessage, DecodeInvalid) {
+  Pigweed::Message pigweed;
+
+  // pigweed.magic_number, with a delimited wire type.
+  constexpr uint8_t wrong_wire_type[] = {0x0a, 0x01, 0x00};
+  EXPECT_EQ(Status::DataLoss(),
+            Pigweed::Decode(std::as_bytes(std::span(wrong_wire_type)), pigweed));
+
+  // pigweed.magic_number, with a truncated varint.
+  constexpr uint8_t truncated[] = {0x08, 0x80};
+  EXPECT_EQ(Status::DataLoss(),
+            Pigweed::Decode(std::as_bytes(std::span(truncated)), pigweed));
+}
+
 TEST(CodegenRepeated, NonPackedScalar) {
   // clang-format off
   constexpr uint8_t proto_data[] = {
@@ -11,6 +11,8 @@
 // WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
 // License for the specific language governing permissions and limitations under
 // the License.
+#include <array>
+#include <cstring>
 #include <span>
 
 #include "gtest/gtest.h"
@@ -248,6 +250,165 @@ TEST(Codegen, RecursiveSubmessage) {
             0);
 }
 
+TEST(Codegen, SizedSubmessage) {
+  std::byte encode_buffer[16];
+  stream::MemoryWriter writer(encode_buffer);
+  // Sized submessages don't use the scratch buffer.
+  Pigweed::StreamEncoder pigweed(writer, ByteSpan());
+
+  {
+    Pigweed::Pigweed::StreamEncoder pigweed_pigweed =
+        pigweed.GetPigweedEncoder(2);
+    EXPECT_EQ(pigweed_pigweed.WriteStatus(Bool::FILE_NOT_FOUND), OkStatus());
+  }
+  ASSERT_EQ(pigweed.status(), OkStatus());
+
+  // clang-format off
+  constexpr uint8_t expected_proto[] = {
+    // pigweed.pigweed
+    0x3a, 0x02,
+    // pigweed.pigweed.status
+    0x08, 0x02,
+  };
+  // clang-format on
+
+  ASSERT_EQ(writer.bytes_written(), sizeof(expected_proto));
+  EXPECT_EQ(std::memcmp(writer.data(), expected_proto, sizeof(expected_proto)),
+            0);
+}
+
+TEST(CodegenMessage, Encode) {
+  // clang-format off
+  constexpr uint8_t device_info_proto[] = {
+    // device_info.device_name
+    0x0a, 0x03, 'p', 'w', 'd',
+    // device_info.device_id
+    0x15, 0xef, 0xbe, 0xad, 0xde,
+    // device_info.status
+    0x18, 0x02,
+  };
+  constexpr uint8_t expected_proto[] = {
+    // pigweed.magic_number
+    0x08, 0x49,
+    // pigweed.ziggy
+    0x10, 0xdd, 0x01,
+    // pigweed.cycles
+    0x19, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    // pigweed.ratio
+    0x25, 0x00, 0x00, 0xc0, 0x3f,
+    // pigweed.error_message
+    0x2a, 0x03, 'e', 'r', 'r',
+    // pigweed.device_info
+    0x32, 0x0c,
+    0x0a, 0x03, 'p', 'w', 'd',
+    0x15, 0xef, 0xbe, 0xad, 0xde,
+    0x18, 0x02,
+  };
+  // clang-format on
+
+  DeviceInfo::Message device_info;
+  device_info.device_name = "pwd";
+  device_info.device_id = 0xdeadbeef;
+  device_info.status = DeviceInfo::DeviceStatus::FAULT;
+
+  std::byte device_info_buffer[sizeof(device_info_proto)];
+  StatusWithSize result = DeviceInfo::Encode(device_info, device_info_buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), sizeof(device_info_proto));
+  EXPECT_EQ(std::memcmp(device_info_buffer,
+                        device_info_proto,
+                        sizeof(device_info_proto)),
+            0);
+
+  Pigweed::Message pigweed;
+  pigweed.magic_number = 0x49;
+  pigweed.ziggy = -111;
+  pigweed.cycles = 0x0807060504030201;
+  pigweed.ratio = 1.5;
+  pigweed.error_message = "err";
+  pigweed.device_info = std::span(device_info_buffer, result.size());
+  // Default values are not encoded.
+  pigweed.bin = Pigweed::Protobuf::Binary::ONE;
+
+  EXPECT_EQ(Pigweed::EncodedSize(pigweed), sizeof(expected_proto));
+
+  std::array<std::byte, 64> buffer;
+  result = Pigweed::Encode(pigweed, buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), sizeof(expected_proto));
+  EXPECT_EQ(std::memcmp(buffer.data(), expected_proto, sizeof(expected_proto)),
+            0);
+}
+
+TEST(CodegenMessage, EncodeDecodeRoundTrip) {
+  Pigweed::Message pigweed;
+  pigweed.magic_number = 42;
+  pigweed.ziggy = -1;
+  pigweed.error_message = "round trip";
+  pigweed.bin = Pigweed::Protobuf::Binary::ZERO;
+
+  std::array<std::byte, 32> buffer;
+  StatusWithSize result = Pigweed::Encode(pigweed, buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+
+  Pigweed::Message decoded;
+  ASSERT_EQ(OkStatus(),
+            Pigweed::Decode(std::span(buffer.data(), result.size()), decoded));
+  EXPECT_EQ(decoded.magic_number, 42u);
+  EXPECT_EQ(decoded.ziggy, -1);
+  EXPECT_EQ(decoded.error_message, "round trip");
+  EXPECT_EQ(decoded.bin, Pigweed::Protobuf::Binary::ZERO);
+}
+
+TEST(CodegenMessage, EncodeEmpty) {
+  Pigweed::Message pigweed;
+  std::array<std::byte, 1> buffer;
+  EXPECT_EQ(Pigweed::EncodedSize(pigweed), 0u);
+  StatusWithSize result = Pigweed::Encode(pigweed, std::span(buffer.data(), 0));
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST(CodegenMessage, EncodeTooSmall) {
+  Pigweed::Message pigweed;
+  pigweed.error_message = "too long";
+
+  std::array<std::byte, 4> buffer;
+  buffer.fill(std::byte{0xff});
+  EXPECT_EQ(Pigweed::Encode(pigweed, buffer).status(),
+            Status::ResourceExhausted());
+  // Nothing is written if the message doesn't fit.
+  for (std::byte b : buffer) {
+    EXPECT_EQ(b, std::byte{0xff});
+  }
+}
+
+TEST(CodegenMessage, EncodeNegativeVarint) {
+  // No test message has an int32 field, so use a table directly.
+  struct Message {
+    int32_t value;
+  };
+  constexpr internal::MessageField kFields[] = {
+      {1, 0, sizeof(int32_t), internal::FieldEncoding::kSignedVarint},
+  };
+  constexpr uint8_t expected_proto[] = {
+      0x08, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+
+  Message message = {-1};
+  std::array<std::byte, 16> buffer;
+  StatusWithSize result = internal::EncodeMessage(&message, kFields, buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), sizeof(expected_proto));
+  EXPECT_EQ(std::memcmp(buffer.data(), expected_proto, sizeof(expected_proto)),
+            0);
+
+  Message decoded = {0};
+  ASSERT_EQ(OkStatus(),
+            internal::DecodeMessage(
+                std::span(buffer.data(), result.size()), kFields, &decoded));
+  EXPECT_EQ(decoded.value, -1);
+}
+
 TEST(CodegenRepeated, NonPackedScalar) {
   std::byte encode_buffer[32];
 
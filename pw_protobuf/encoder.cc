@@ -60,6 +60,33 @@ StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number) {
   return StreamEncoder(*this, nested_buffer);
 }
 
+StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
+                                              size_t size) {
+  PW_CHECK(!nested_encoder_open());
+  PW_CHECK(ValidFieldNumber(field_number));
+
+  // Writing the key and length prefix now reserves the whole field in this
+  // encoder, including the remaining size if this is a sized encoder.
+  Status status = UpdateStatusForWrite(field_number, WireType::kDelimited, size);
+  if (status.ok()) {
+    status_.Update(
+        WriteLengthDelimitedKeyAndLengthPrefix(field_number, size, writer_));
+    status = status_;
+  }
+
+  nested_field_number_ = field_number;
+
+  // A sized encoder writes to this encoder's writer. If that is this encoder's
+  // own scratch buffer, there is no room left to share.
+  ByteSpan nested_buffer;
+  if (&writer_ != &memory_writer_) {
+    nested_buffer =
+        ByteSpan(memory_writer_.data() + memory_writer_.bytes_written(),
+                 memory_writer_.ConservativeWriteLimit());
+  }
+  return StreamEncoder(*this, nested_buffer, size, status);
+}
+
 StreamEncoder::~StreamEncoder() {
   // If this was an invalidated StreamEncoder which cannot be used, permit the
   // object to be cleanly destructed by doing nothing.
@@ -98,6 +125,15 @@ void StreamEncoder::CloseNestedMessage(StreamEncoder& nested) {
     return;
   }
 
+  // A sized submessage was written directly to writer_. Only check that it
+  // filled the size given for it.
+  if (nested.remaining_size_ != kUnsized) {
+    if (nested.remaining_size_ != 0) {
+      status_ = Status::DataLoss();
+    }
+    return;
+  }
+
   if (varint::EncodedSize(nested.memory_writer_.bytes_written()) >
       config::kMaxVarintSize) {
     status_ = Status::OutOfRange();
@@ -222,10 +258,15 @@ Status StreamEncoder::UpdateStatusForWrite(uint32_t field_number,
   status_.Update(field_size.status());
   PW_TRY(status_);
 
-  if (field_size.value() > writer_.ConservativeWriteLimit()) {
+  if (field_size.value() > writer_.ConservativeWriteLimit() ||
+      field_size.value() > remaining_size_) {
     status_ = Status::ResourceExhausted();
+    return status_;
   }
 
+  if (remaining_size_ != kUnsized) {
+    remaining_size_ -= field_size.value();
+  }
   return status_;
 }
 
@@ -18,7 +18,9 @@
 
 #include "gtest/gtest.h"
 #include "pw_bytes/span.h"
+#include "pw_status/try.h"
 #include "pw_stream/memory_stream.h"
+#include "pw_stream/null_stream.h"
 
 namespace pw::protobuf {
 namespace {
@@ -255,6 +257,156 @@ TEST(StreamEncoder, Nested) {
             0);
 }
 
+TEST(StreamEncoder, NestedSized) {
+  // Sized nested encoders write straight to the writer, so no scratch buffer
+  // is needed.
+  std::byte dest_buffer[64];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  {
+    StreamEncoder nested_proto =
+        encoder.GetNestedEncoder(kTestProtoNestedField, 0x19);
+    EXPECT_EQ(nested_proto.ConservativeWriteLimit(), 0x19u);
+    EXPECT_EQ(nested_proto.WriteString(kNestedProtoHelloField, "world"),
+              OkStatus());
+    {
+      StreamEncoder double_nested_proto =
+          nested_proto.GetNestedEncoder(kNestedProtoPairField, 0x10);
+      EXPECT_EQ(double_nested_proto.WriteString(kDoubleNestedProtoKeyField,
+                                                "version"),
+                OkStatus());
+      EXPECT_EQ(double_nested_proto.WriteString(kDoubleNestedProtoValueField,
+                                                "2.9.1"),
+                OkStatus());
+    }
+  }
+  EXPECT_EQ(encoder.WriteSint32(kTestProtoZiggyField, -13), OkStatus());
+
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // magic_number
+    0x08, 0x2a,
+    // nested header (key, size)
+    0x32, 0x19,
+    // nested.hello
+    0x0a, 0x05, 'w', 'o', 'r', 'l', 'd',
+    // nested.pair[0] header (key, size)
+    0x1a, 0x10,
+    // nested.pair[0].key
+    0x0a, 0x07, 'v', 'e', 'r', 's', 'i', 'o', 'n',
+    // nested.pair[0].value
+    0x12, 0x05, '2', '.', '9', '.', '1',
+    // ziggy
+    0x10, 0x19
+  };
+  // clang-format on
+
+  ASSERT_EQ(encoder.status(), OkStatus());
+  ConstByteSpan result = ConstByteSpan(writer.data(), writer.bytes_written());
+  EXPECT_EQ(result.size(), sizeof(encoded_proto));
+  EXPECT_EQ(std::memcmp(result.data(), encoded_proto, sizeof(encoded_proto)),
+            0);
+}
+
+Status WriteDoubleNestedProto(StreamEncoder& encoder) {
+  PW_TRY(encoder.WriteString(kDoubleNestedProtoKeyField, "device"));
+  return encoder.WriteString(kDoubleNestedProtoValueField, "left-soc");
+}
+
+TEST(StreamEncoder, NestedSizedFromDryRun) {
+  std::byte encode_buffer[32];
+  std::byte dest_buffer[64];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer, encode_buffer);
+
+  stream::CountingNullStream counter;
+  {
+    StreamEncoder dry_run(counter, ByteSpan());
+    ASSERT_EQ(WriteDoubleNestedProto(dry_run), OkStatus());
+  }
+  ASSERT_EQ(counter.bytes_written(), 0x12u);
+
+  {
+    // The size of the unsized pair is accounted for in the size given here.
+    StreamEncoder nested_proto = encoder.GetNestedEncoder(
+        kTestProtoNestedField, 2 + counter.bytes_written());
+    {
+      // A sized encoder shares its parent's scratch buffer with its children.
+      StreamEncoder double_nested_proto =
+          nested_proto.GetNestedEncoder(kNestedProtoPairField);
+      EXPECT_EQ(WriteDoubleNestedProto(double_nested_proto), OkStatus());
+    }
+  }
+
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // nested header (key, size)
+    0x32, 0x14,
+    // nested.pair[0] header (key, size)
+    0x1a, 0x12,
+    // nested.pair[0].key
+    0x0a, 0x06, 'd', 'e', 'v', 'i', 'c', 'e',
+    // nested.pair[0].value
+    0x12, 0x08, 'l', 'e', 'f', 't', '-', 's', 'o', 'c',
+  };
+  // clang-format on
+
+  ASSERT_EQ(encoder.status(), OkStatus());
+  ConstByteSpan result = ConstByteSpan(writer.data(), writer.bytes_written());
+  EXPECT_EQ(result.size(), sizeof(encoded_proto));
+  EXPECT_EQ(std::memcmp(result.data(), encoded_proto, sizeof(encoded_proto)),
+            0);
+}
+
+TEST(StreamEncoder, NestedSizedInMemoryEncoder) {
+  std::byte encode_buffer[32];
+  MemoryEncoder parent(encode_buffer);
+  {
+    StreamEncoder child = parent.GetNestedEncoder(kTestProtoNestedField, 3);
+    EXPECT_EQ(child.WriteUint32(kNestedProtoIdField, 999), OkStatus());
+  }
+  ASSERT_EQ(parent.status(), OkStatus());
+
+  constexpr uint8_t encoded_proto[] = {0x32, 0x03, 0x10, 0xe7, 0x07};
+  ASSERT_EQ(parent.size(), sizeof(encoded_proto));
+  EXPECT_EQ(std::memcmp(parent.data(), encoded_proto, sizeof(encoded_proto)),
+            0);
+}
+
+TEST(StreamEncoder, NestedSizedWriteTooLarge) {
+  std::byte encode_buffer[32];
+  MemoryEncoder parent(encode_buffer);
+  {
+    StreamEncoder child = parent.GetNestedEncoder(kTestProtoNestedField, 2);
+    EXPECT_EQ(child.WriteUint32(kNestedProtoIdField, 999),
+              Status::ResourceExhausted());
+  }
+  EXPECT_EQ(parent.status(), Status::ResourceExhausted());
+}
+
+TEST(StreamEncoder, NestedSizedUnderfilled) {
+  std::byte encode_buffer[32];
+  MemoryEncoder parent(encode_buffer);
+  {
+    StreamEncoder child = parent.GetNestedEncoder(kTestProtoNestedField, 4);
+    EXPECT_EQ(child.WriteUint32(kNestedProtoIdField, 999), OkStatus());
+  }
+  EXPECT_EQ(parent.status(), Status::DataLoss());
+}
+
+TEST(StreamEncoder, NestedSizedLargerThanParent) {
+  std::byte encode_buffer[8];
+  MemoryEncoder parent(encode_buffer);
+  {
+    StreamEncoder child = parent.GetNestedEncoder(kTestProtoNestedField, 16);
+    EXPECT_EQ(child.status(), Status::ResourceExhausted());
+  }
+  EXPECT_EQ(parent.status(), Status::ResourceExhausted());
+  EXPECT_EQ(parent.size(), 0u);
+}
+
 TEST(StreamEncoder, RepeatedField) {
   std::byte encode_buffer[32];
   MemoryEncoder encoder(encode_buffer);
@@ -307,6 +459,38 @@ TEST(StreamEncoder, PackedVarintInsufficientSpace) {
   EXPECT_EQ(encoder.status(), Status::ResourceExhausted());
 }
 
+TEST(StreamEncoder, PackedVarintSpansSeveralBatches) {
+  std::byte encode_buffer[256];
+  MemoryEncoder encoder(encode_buffer);
+
+  // repeated sint64 values = 1;
+  std::array<int64_t, 40> values;
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = (i % 2 == 0 ? 1 : -1) * (int64_t(1) << i);
+  }
+  ASSERT_EQ(OkStatus(), encoder.WritePackedSint64(1, values));
+  ASSERT_EQ(encoder.status(), OkStatus());
+
+  ConstByteSpan result(encoder);
+  ASSERT_GE(result.size(), 1u);
+  EXPECT_EQ(result[0], std::byte{0x0a});
+
+  uint64_t payload_size = 0;
+  const size_t prefix_size = varint::Decode(result.subspan(1), &payload_size);
+  ASSERT_NE(prefix_size, 0u);
+  ConstByteSpan payload = result.subspan(1 + prefix_size);
+  ASSERT_EQ(payload.size(), payload_size);
+
+  for (int64_t value : values) {
+    int64_t decoded = 0;
+    const size_t size = varint::Decode(payload, &decoded);
+    ASSERT_NE(size, 0u);
+    EXPECT_EQ(decoded, value);
+    payload = payload.subspan(size);
+  }
+  EXPECT_TRUE(payload.empty());
+}
+
 TEST(StreamEncoder, PackedVarintVector) {
   std::byte encode_buffer[32];
   MemoryEncoder encoder(encode_buffer);
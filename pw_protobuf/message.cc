@@ -14,6 +14,7 @@
 
 #include "pw_protobuf/message.h"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "pw_protobuf/serialized_size.h"
@@ -197,6 +198,55 @@ Message::iterator Message::end() {
   return iterator(reader_end.Exhaust());
 }
 
+bool Message::FindIndexedField(uint32_t field_number, Field& field) {
+  if (field_number == 0 || field_number > field_index_.size()) {
+    return false;
+  }
+
+  if (field_index_state_ == FieldIndexState::kUnbuilt) {
+    BuildFieldIndex();
+  }
+  if (field_index_state_ != FieldIndexState::kBuilt) {
+    return false;
+  }
+
+  const FieldIndexEntry& entry = field_index_[field_number - 1];
+  if (entry.start == entry.end) {
+    field = Field(Status::NotFound());
+  } else {
+    field = Field(stream::IntervalReader(
+                      reader_.source_reader(), entry.start, entry.end),
+                  field_number);
+  }
+  return true;
+}
+
+void Message::BuildFieldIndex() {
+  std::fill(field_index_.begin(), field_index_.end(), FieldIndexEntry{});
+
+  for (Field field : *this) {
+    if (!field.ok()) {
+      // Leave lookups of a malformed message to the linear scan, which reports
+      // the error.
+      field_index_state_ = FieldIndexState::kInvalid;
+      return;
+    }
+
+    const uint32_t field_number = field.field_number();
+    if (field_number == 0 || field_number > field_index_.size()) {
+      continue;
+    }
+
+    FieldIndexEntry& entry = field_index_[field_number - 1];
+    if (entry.start == entry.end) {
+      entry.start = field.field_reader().start();
+      entry.end = field.field_reader().end();
+    }
+  }
+
+  field_index_state_ = FieldIndexState::kBuilt;
+}
+
 RepeatedBytes Message::AsRepeatedBytes(uint32_t field_number) {
   return AsRepeated<Bytes>(field_number);
 }
@@ -0,0 +1,87 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Performance fuzzer for pw::protobuf::Message. Counts the reads and seeks
+// performed on the serialized message while iterating its fields and looking
+// up each indexed field number, and flags inputs whose cost grows faster than
+// linearly with their size. Field lookups through a field index must not
+// rescan the message.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_fuzzer/cost.h"
+#include "pw_protobuf/message.h"
+#include "pw_stream/memory_stream.h"
+
+namespace {
+
+// Every byte read and every call on the stream adds to the cost. The per-byte
+// budget leaves room for iterating the message, building the field index, and
+// reading each indexed field once.
+constexpr size_t kCostPerByte = 16;
+constexpr size_t kFixedCost = 256;
+
+constexpr size_t kIndexedFields = 16;
+
+class CostCountingReader : public pw::stream::SeekableReader {
+ public:
+  CostCountingReader(pw::ConstByteSpan data, pw::fuzzer::CostTracker& cost)
+      : reader_(data), cost_(cost) {}
+
+ private:
+  pw::StatusWithSize DoRead(pw::ByteSpan destination) final {
+    pw::Result<pw::ByteSpan> result = reader_.Read(destination);
+    cost_.Add(1 + (result.ok() ? result->size() : 0));
+    return pw::StatusWithSize(result.status(),
+                              result.ok() ? result->size() : 0);
+  }
+
+  pw::Status DoSeek(ptrdiff_t offset, Whence origin) final {
+    cost_.Add();
+    return reader_.Seek(offset, origin);
+  }
+
+  size_t DoTell() const final { return reader_.Tell(); }
+
+  pw::stream::MemoryReader reader_;
+  pw::fuzzer::CostTracker& cost_;
+};
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  pw::fuzzer::CostTracker cost(size, kCostPerByte, kFixedCost);
+  CostCountingReader reader(std::as_bytes(std::span(data, size)), cost);
+
+  pw::protobuf::Message message(reader, size);
+  for (pw::protobuf::Message::Field field : message) {
+    if (!field.ok()) {
+      // Lookups in a malformed message fall back to linear scans.
+      return 0;
+    }
+  }
+
+  std::array<pw::protobuf::Message::FieldIndexEntry, kIndexedFields> index;
+  message.UseFieldIndex(index);
+  for (uint32_t field_number = 1; field_number <= kIndexedFields;
+       ++field_number) {
+    message.AsUint64(field_number);
+    message.AsBytes(field_number);
+  }
+  return 0;
+}
@@ -14,6 +14,8 @@
 
 #include "pw_protobuf/message.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_stream/memory_stream.h"
 
@@ -533,6 +535,88 @@ TEST(ProtoHelper, AsMessage) {
   ASSERT_TRUE(cmp.value());
 }
 
+TEST(ProtoHelper, FieldIndex) {
+  // message Contact {
+  //   string number = 1;
+  //   uint32 age = 2;
+  //   string email = 5;
+  //   string nickname = 9;
+  // }
+  // clang-format off
+  std::uint8_t encoded_proto[] = {
+    // email = "a@b"
+    0x2a, 0x03, 'a', '@', 'b',
+    // number = "123"
+    0x0a, 0x03, '1', '2', '3',
+    // nickname = "x"
+    0x4a, 0x01, 'x',
+    // A second number = "456" is ignored.
+    0x0a, 0x03, '4', '5', '6',
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  Message message(reader, sizeof(encoded_proto));
+
+  std::array<Message::FieldIndexEntry, 5> index;
+  message.UseFieldIndex(index);
+
+  String number = message.AsString(1);
+  ASSERT_OK(number.status());
+  Result<bool> cmp = number.Equal("123");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+
+  // The index is built by the first lookup.
+  EXPECT_EQ(index[0].start, 5u);
+  EXPECT_EQ(index[0].end, 10u);
+  EXPECT_EQ(index[4].start, 0u);
+  EXPECT_EQ(index[4].end, 5u);
+  EXPECT_EQ(index[1].start, index[1].end);
+
+  String email = message.AsString(5);
+  ASSERT_OK(email.status());
+  cmp = email.Equal("a@b");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+
+  EXPECT_EQ(message.AsUint32(2).status(), Status::NotFound());
+
+  // Field numbers past the end of the index are still found.
+  String nickname = message.AsString(9);
+  ASSERT_OK(nickname.status());
+  cmp = nickname.Equal("x");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+  EXPECT_EQ(message.AsString(10).status(), Status::NotFound());
+}
+
+TEST(ProtoHelper, FieldIndexMalformedMessage) {
+  // clang-format off
+  std::uint8_t encoded_proto[] = {
+    // number = "123"
+    0x0a, 0x03, '1', '2', '3',
+    // email, with a length past the end of the message.
+    0x2a, 0x09, 'a', '@', 'b',
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  Message message(reader, sizeof(encoded_proto));
+
+  std::array<Message::FieldIndexEntry, 5> index;
+  message.UseFieldIndex(index);
+
+  // Lookups behave as without an index.
+  String number = message.AsString(1);
+  ASSERT_OK(number.status());
+  Result<bool> cmp = number.Equal("123");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+
+  EXPECT_FALSE(message.AsString(5).ok());
+}
+
 TEST(ProtoHelper, AsRepeatedMessages) {
   // message Contact {
   //   string number = 1;
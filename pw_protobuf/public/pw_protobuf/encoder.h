@@ -119,6 +119,7 @@ class StreamEncoder {
       : status_(OkStatus()),
         parent_(nullptr),
         nested_field_number_(0),
+        remaining_size_(kUnsized),
         memory_writer_(scratch_buffer),
         writer_(writer) {}
 
@@ -142,7 +143,7 @@ class StreamEncoder {
   // Precondition: Encoder has no active child encoder.
   size_t ConservativeWriteLimit() const {
     PW_ASSERT(!nested_encoder_open());
-    return writer_.ConservativeWriteLimit();
+    return std::min(writer_.ConservativeWriteLimit(), remaining_size_);
   }
 
   // Creates a nested encoder with the provided field number. Once this is
@@ -155,6 +156,29 @@ class StreamEncoder {
   //     encoder cannot be used.
   StreamEncoder GetNestedEncoder(uint32_t field_number);
 
+  // Creates a nested encoder for a submessage whose encoded size is known in
+  // advance. The key and length prefix are written immediately, and the
+  // nested encoder writes its fields straight to this encoder's writer, so the
+  // submessage is never staged in or copied out of a scratch buffer.
+  //
+  // The size may be known statically, or measured with a dry run that encodes
+  // the submessage to a pw::stream::CountingNullStream.
+  //
+  // A sized nested encoder keeps the unused part of this encoder's scratch
+  // buffer, so it may itself open nested encoders of either kind. Nested
+  // encoders of a MemoryEncoder's sized nested encoder must also be sized.
+  //
+  // The nested encoder fails with RESOURCE_EXHAUSTED if a write would exceed
+  // the declared size. If fewer bytes than declared were written when it is
+  // finalized, this encoder's status is set to DATA_LOSS, since the length
+  // prefix already written no longer matches the submessage.
+  //
+  // Precondition: Encoder has no active child encoder.
+  //
+  // Postcondition: Until the nested child encoder has been destroyed, this
+  //     encoder cannot be used.
+  StreamEncoder GetNestedEncoder(uint32_t field_number, size_t size);
+
   // Returns the current encoder's status.
   //
   // Precondition: Encoder has no active child encoder.
@@ -629,6 +653,7 @@ class StreamEncoder {
       : status_(other.status_),
         parent_(other.parent_),
         nested_field_number_(other.nested_field_number_),
+        remaining_size_(other.remaining_size_),
         memory_writer_(std::move(other.memory_writer_)),
         writer_(&other.writer_ == &other.memory_writer_ ? memory_writer_
                                                         : other.writer_) {
@@ -647,14 +672,35 @@ class StreamEncoder {
     kZigZag,
   };
 
+  // Size of the stack buffer that packed varints are encoded into before they
+  // are written to the stream.
+  static constexpr size_t kPackedVarintBufferSizeBytes = 40;
+
+  // remaining_size_ value for encoders that were not given a size up front.
+  static constexpr size_t kUnsized = stream::Stream::kUnlimited;
+
   constexpr StreamEncoder(StreamEncoder& parent, ByteSpan scratch_buffer)
       : status_(scratch_buffer.empty() ? Status::ResourceExhausted()
                                        : OkStatus()),
         parent_(&parent),
         nested_field_number_(0),
+        remaining_size_(kUnsized),
         memory_writer_(scratch_buffer),
         writer_(memory_writer_) {}
 
+  // Creates a nested encoder that writes a submessage of the given size
+  // directly to the parent's writer.
+  constexpr StreamEncoder(StreamEncoder& parent,
+                          ByteSpan scratch_buffer,
+                          size_t size,
+                          Status status)
+      : status_(status),
+        parent_(&parent),
+        nested_field_number_(0),
+        remaining_size_(size),
+        memory_writer_(scratch_buffer),
+        writer_(parent.writer_) {}
+
   bool nested_encoder_open() const { return nested_field_number_ != 0; }
 
   // CloseNestedMessage() is called on the parent encoder as part of the nested
@@ -702,17 +748,15 @@ class StreamEncoder {
                   "Packed varints must be of type bool, uint32_t, int32_t, "
                   "uint64_t, or int64_t");
 
-    size_t payload_size = 0;
-    for (T val : values) {
-      if (encode_type == VarintEncodeType::kZigZag) {
-        int64_t integer =
-            static_cast<int64_t>(static_cast<std::make_signed_t<T>>(val));
-        payload_size += varint::EncodedSize(varint::ZigZagEncode(integer));
-      } else {
-        uint64_t integer = static_cast<uint64_t>(val);
-        payload_size += varint::EncodedSize(integer);
-      }
-    }
+    // pw_varint ZigZag encodes signed integers, so view the values as signed
+    // for ZigZag encoding.
+    using Signed = std::make_signed_t<T>;
+    const std::span<Signed> signed_values(
+        reinterpret_cast<Signed*>(values.data()), values.size());
+    const bool zigzag = encode_type == VarintEncodeType::kZigZag;
+
+    const size_t payload_size = zigzag ? varint::EncodedSize(signed_values)
+                                       : varint::EncodedSize(values);
 
     if (!UpdateStatusForWrite(field_number, WireType::kDelimited, payload_size)
              .ok()) {
@@ -723,14 +767,20 @@ class StreamEncoder {
         .IgnoreError();  // TODO(pwbug/387): Handle Status properly
     WriteVarint(payload_size)
         .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-    for (T value : values) {
-      if (encode_type == VarintEncodeType::kZigZag) {
-        WriteZigzagVarint(static_cast<std::make_signed_t<T>>(value))
-            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-      } else {
-        WriteVarint(value)
-            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-      }
+
+    // Encode the values into a buffer in batches that are sure to fit, rather
+    // than writing each varint to the stream separately.
+    constexpr size_t kMaxEncodedSize = (sizeof(T) * 8 + 6) / 7;
+    constexpr size_t kBatchSize =
+        kPackedVarintBufferSizeBytes / kMaxEncodedSize;
+    std::array<std::byte, kPackedVarintBufferSizeBytes> buffer;
+
+    for (size_t i = 0; i < values.size() && status_.ok(); i += kBatchSize) {
+      const size_t count = std::min(kBatchSize, values.size() - i);
+      const size_t encoded =
+          zigzag ? varint::Encode(signed_values.subspan(i, count), buffer)
+                 : varint::Encode(values.subspan(i, count), buffer);
+      status_.Update(writer_.Write(std::span(buffer).first(encoded)));
     }
 
     return status_;
@@ -774,6 +824,10 @@ class StreamEncoder {
   // submessage. Otherwise, this is 0 to indicate no child encoder is open.
   uint32_t nested_field_number_;
 
+  // For nested encoders created with a known size, the number of bytes of that
+  // size that have not been written yet. kUnsized for all other encoders.
+  size_t remaining_size_;
+
   // This memory writer is used for staging proto submessages to the
   // scratch_buffer.
   stream::MemoryWriter memory_writer_;
@@ -0,0 +1,101 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Support for table-driven encoding and decoding of generated message structs.
+// The types in this header are used by pw_protobuf generated code and are not
+// intended to be used directly.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::protobuf::internal {
+
+// How a member of a generated message struct is encoded on the wire.
+enum class FieldEncoding : uint8_t {
+  // uint32 and uint64 fields. The value is truncated to the member's size when
+  // decoding.
+  kVarint,
+
+  // int32, int64, and enum fields. Like kVarint, but negative 32-bit values are
+  // sign-extended to 64 bits when encoding, as required by the protobuf
+  // specification.
+  kSignedVarint,
+
+  // sint32 and sint64 fields.
+  kZigZag,
+
+  kBool,
+
+  // fixed32, fixed64, sfixed32, sfixed64, float and double fields, copied
+  // bitwise into the member.
+  kFixed,
+
+  // string fields, stored as a std::string_view. Decoded views point into the
+  // encoded message.
+  kString,
+
+  // bytes and message fields, stored as a std::span<const std::byte>. Decoded
+  // spans point into the encoded message.
+  kBytes,
+};
+
+// Describes one member of a generated message struct. Generated code provides
+// a table of these for each message, sorted by field number.
+struct MessageField {
+  uint32_t field_number;
+  uint16_t offset;
+  uint8_t size;
+  FieldEncoding encoding;
+};
+
+// Decodes an encoded message into the struct at message in one pass, using the
+// struct's field table. Fields that are not in the table are skipped. Fields
+// that appear more than once keep their last value, as required for singular
+// fields by the protobuf specification.
+//
+// Returns:
+//
+//   OK - The message was decoded.
+//   DATA_LOSS - The message is malformed, or a field has the wrong wire type.
+//
+Status DecodeMessage(std::span<const std::byte> data,
+                     std::span<const MessageField> fields,
+                     void* message);
+
+// Returns the size of the struct at message when encoded. Members with their
+// default value are not encoded, as for proto3 singular fields.
+size_t EncodedMessageSize(const void* message,
+                          std::span<const MessageField> fields);
+
+// Encodes the struct at message to output. The encoded size of the message is
+// computed first, so the fields are written straight to output without staging
+// any part of the message in a scratch buffer.
+//
+// Returns:
+//
+//   OK - The message was encoded; returns the number of bytes written.
+//   RESOURCE_EXHAUSTED - output is too small for the message. Nothing was
+//       written.
+//
+StatusWithSize EncodeMessage(const void* message,
+                             std::span<const MessageField> fields,
+                             std::span<std::byte> output);
+
+}  // namespace pw::protobuf::internal
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string_view>
 
 #include "pw_assert/check.h"
@@ -328,6 +330,14 @@ class Message {
     friend class Message;
   };
 
+  // An entry in a field index; see UseFieldIndex().
+  struct FieldIndexEntry {
+    // Interval of the field, including its key, in the source reader. An empty
+    // interval means that the field is not present.
+    size_t start = 0;
+    size_t end = 0;
+  };
+
   Message() = default;
   Message(Status status) : reader_(status) {}
   Message(stream::IntervalReader reader) : reader_(reader) {}
@@ -405,6 +415,20 @@ class Message {
   iterator begin();
   iterator end();
 
+  // Makes single-field lookups, i.e. As() and every AsXXX() method except
+  // AsRepeatedXXX() and AsStringMapXXX(), use an index of field offsets stored
+  // in `storage`. Entry N holds the first occurrence of field number N + 1;
+  // field numbers greater than `storage.size()` are found with a linear scan.
+  //
+  // The index is built in a single pass over the message on the first lookup,
+  // after which lookups of indexed field numbers take constant time. `storage`
+  // must outlive this message and any copy of it made after calling this
+  // method. If the message is malformed, the index is not used.
+  void UseFieldIndex(std::span<FieldIndexEntry> storage) {
+    field_index_ = storage;
+    field_index_state_ = FieldIndexState::kUnbuilt;
+  }
+
   // Parse a field given by `field_number` as the target parser type
   // `FieldType`.
   //
@@ -414,9 +438,13 @@ class Message {
   // <field_number>.
   //
   // Since the method needs to traverse all fields, it can be inefficient if
-  // called multiple times exepcially on slow reader.
+  // called multiple times exepcially on slow reader. See UseFieldIndex().
   template <typename FieldType>
   FieldType As(uint32_t field_number) {
+    if (Field field; FindIndexedField(field_number, field)) {
+      return field.ok() ? field.As<FieldType>() : FieldType(field.status());
+    }
+
     for (Field field : *this) {
       if (field.field_number() == field_number) {
         return field.As<FieldType>();
@@ -437,7 +465,18 @@ class Message {
   }
 
  private:
+  enum class FieldIndexState : uint8_t { kUnbuilt, kBuilt, kInvalid };
+
+  // Looks up `field_number` in the field index, building it first if needed.
+  // Returns false if the field index cannot answer the lookup. Otherwise sets
+  // `field` to the field, or to a NOT_FOUND field if it is not present.
+  bool FindIndexedField(uint32_t field_number, Field& field);
+
+  void BuildFieldIndex();
+
   stream::IntervalReader reader_;
+  std::span<FieldIndexEntry> field_index_;
+  FieldIndexState field_index_state_ = FieldIndexState::kUnbuilt;
 
   // Consume the current field. If the field has already been processed, i.e.
   // by calling one of the Read..() method, nothing is done. After calling this
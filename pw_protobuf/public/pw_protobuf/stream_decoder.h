@@ -24,6 +24,7 @@
 #include "pw_protobuf/wire_format.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
 #include "pw_varint/stream.h"
 #include "pw_varint/varint.h"
@@ -45,6 +46,11 @@ namespace pw::protobuf {
 // to fit in memory. For smaller messages, prefer the MemoryDecoder, which is
 // much more efficient.
 //
+// When constructed from a stream::MemoryReader, the decoder reads the reader's
+// buffer directly instead of making a virtual Read() call for every field key
+// and varint byte. The reader itself is not advanced until the decoder is
+// destroyed, so it must not be used while the decoder is alive.
+//
 // Example usage:
 //
 //   stream::Reader& my_stream = GetProtoStream();
@@ -110,6 +116,25 @@ class StreamDecoder {
   // consume any remaining bytes when it goes out of scope.
   constexpr StreamDecoder(stream::Reader& reader, size_t length)
       : reader_(reader),
+        memory_(),
+        stream_bounds_({0, length}),
+        position_(0),
+        current_field_(kInitialFieldKey),
+        delimited_field_size_(0),
+        delimited_field_offset_(0),
+        parent_(nullptr),
+        field_consumed_(true),
+        nested_reader_open_(false),
+        status_(OkStatus()) {}
+
+  // Decodes a message in memory through the fast path described above.
+  StreamDecoder(stream::MemoryReader& reader)
+      : StreamDecoder(reader, std::numeric_limits<size_t>::max()) {}
+
+  StreamDecoder(stream::MemoryReader& reader, size_t length)
+      : reader_(reader),
+        memory_(reader.data() + reader.bytes_read(),
+                reader.ConservativeReadLimit()),
         stream_bounds_({0, length}),
         position_(0),
         current_field_(kInitialFieldKey),
@@ -511,6 +536,7 @@ class StreamDecoder {
   //     acts like a parent decoder with an active child decoder.
   constexpr StreamDecoder(StreamDecoder&& other)
       : reader_(other.reader_),
+        memory_(other.memory_),
         stream_bounds_(other.stream_bounds_),
         position_(other.position_),
         current_field_(other.current_field_),
@@ -550,6 +576,7 @@ class StreamDecoder {
                           size_t low,
                           size_t high)
       : reader_(reader),
+        memory_(parent->memory_),
         stream_bounds_({low, high}),
         position_(parent->position_),
         current_field_(kInitialFieldKey),
@@ -566,6 +593,7 @@ class StreamDecoder {
                           StreamDecoder* parent,
                           Status status)
       : reader_(reader),
+        memory_(parent->memory_),
         stream_bounds_({0, std::numeric_limits<size_t>::max()}),
         position_(0),
         current_field_(kInitialFieldKey),
@@ -578,6 +606,14 @@ class StreamDecoder {
     PW_ASSERT(!status.ok());
   }
 
+  bool reading_from_memory() const { return memory_.data() != nullptr; }
+
+  // Reads from the underlying data at position_, either directly from memory_
+  // or through reader_. These do not update position_.
+  size_t ReadLimit() const;
+  StatusWithSize ReadVarint(uint64_t* value);
+  Result<ByteSpan> ReadRaw(ByteSpan out);
+
   Status Advance(size_t end_position);
 
   void CloseBytesReader(BytesReader& reader);
@@ -695,6 +731,11 @@ class StreamDecoder {
   Status CheckOkToRead(WireType type);
 
   stream::Reader& reader_;
+
+  // The data of a MemoryReader, starting at the position of the reader when
+  // the root decoder was created. Empty if not decoding from a MemoryReader.
+  std::span<const std::byte> memory_;
+
   Bounds stream_bounds_;
   size_t position_;
 
@@ -156,18 +156,24 @@ class ProtoMethod(abc.ABC):
     def _relative_type_namespace(self, from_root: bool = False) -> str:
         """Returns relative namespace between method's scope and field type."""
         scope = self._root if from_root else self._scope
-        type_node = self._field.type_node()
-        assert type_node is not None
+        return relative_type_namespace(self._field, scope, self._root)
 
-        # If a class method is referencing its class, the namespace provided
-        # must be from the root or it will be empty.
-        if type_node == scope:
-            scope = self._root
 
-        ancestor = scope.common_ancestor(type_node)
-        namespace = type_node.cpp_namespace(ancestor)
-        assert namespace
-        return namespace
+def relative_type_namespace(field: ProtoMessageField, scope: ProtoNode,
+                            root: ProtoNode) -> str:
+    """Returns the namespace of a field's type relative to a scope."""
+    type_node = field.type_node()
+    assert type_node is not None
+
+    # If a class method is referencing its class, the namespace provided
+    # must be from the root or it will be empty.
+    if type_node == scope:
+        scope = root
+
+    ancestor = scope.common_ancestor(type_node)
+    namespace = type_node.cpp_namespace(ancestor)
+    assert namespace
+    return namespace
 
 
 class WriteMethod(ProtoMethod):
@@ -342,6 +348,18 @@ class SubMessageEncoderMethod(ProtoMethod):
         return False
 
 
+class SubMessageSizedEncoderMethod(SubMessageEncoderMethod):
+    """Method which returns a sub-message encoder for a submessage of a known
+    size, which is written directly to the parent's writer."""
+    def params(self) -> List[Tuple[str, str]]:
+        return [('size_t', 'size')]
+
+    def body(self) -> List[str]:
+        line = 'return {}::StreamEncoder(GetNestedEncoder({}, size));'.format(
+            self._relative_type_namespace(), self.field_cast())
+        return [line]
+
+
 class SubMessageDecoderMethod(ReadMethod):
     """Method which returns a sub-message decoder."""
     def name(self) -> str:
@@ -1211,7 +1229,7 @@ PROTO_FIELD_WRITE_METHODS: Dict[int, List] = {
     descriptor_pb2.FieldDescriptorProto.TYPE_STRING:
     [StringLenWriteMethod, StringWriteMethod],
     descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE:
-    [SubMessageEncoderMethod],
+    [SubMessageEncoderMethod, SubMessageSizedEncoderMethod],
     descriptor_pb2.FieldDescriptorProto.TYPE_ENUM: [EnumWriteMethod],
 }
 
@@ -1260,6 +1278,50 @@ PROTO_FIELD_READ_METHODS: Dict[int, List] = {
 }
 
 
+# C++ member types and wire encodings of the fields of generated message
+# structs. The encodings are internal::FieldEncoding values. Enum fields use the type of
+# their enum.
+STRUCT_FIELD_TYPES: Dict[int, Tuple[str, str]] = {
+    descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE: ('double', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FLOAT: ('float', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT32:
+    ('int32_t', 'kSignedVarint'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT32: ('int32_t', 'kZigZag'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED32: ('int32_t', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT64:
+    ('int64_t', 'kSignedVarint'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT64: ('int64_t', 'kZigZag'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED64: ('int64_t', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT32: ('uint32_t', 'kVarint'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED32: ('uint32_t', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT64: ('uint64_t', 'kVarint'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED64: ('uint64_t', 'kFixed'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BOOL: ('bool', 'kBool'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_STRING:
+    ('std::string_view', 'kString'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BYTES:
+    ('std::span<const std::byte>', 'kBytes'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE:
+    ('std::span<const std::byte>', 'kBytes'),
+}
+
+# Field names that must be renamed to be used as C++ identifiers.
+CPP_KEYWORDS = frozenset([
+    'alignas', 'alignof', 'and', 'and_eq', 'asm', 'auto', 'bitand', 'bitor',
+    'bool', 'break', 'case', 'catch', 'char', 'char16_t', 'char32_t', 'class',
+    'compl', 'const', 'const_cast', 'constexpr', 'continue', 'decltype',
+    'default', 'delete', 'do', 'double', 'dynamic_cast', 'else', 'enum',
+    'explicit', 'export', 'extern', 'false', 'float', 'for', 'friend', 'goto',
+    'if', 'inline', 'int', 'long', 'mutable', 'namespace', 'new', 'noexcept',
+    'not', 'not_eq', 'nullptr', 'operator', 'or', 'or_eq', 'private',
+    'protected', 'public', 'register', 'reinterpret_cast', 'return', 'short',
+    'signed', 'sizeof', 'static', 'static_assert', 'static_cast', 'struct',
+    'switch', 'template', 'this', 'thread_local', 'throw', 'true', 'try',
+    'typedef', 'typeid', 'typename', 'union', 'unsigned', 'using', 'virtual',
+    'void', 'volatile', 'wchar_t', 'while', 'xor', 'xor_eq'
+])
+
+
 def proto_field_methods(class_type: ClassType, field_type: int) -> List:
     return (PROTO_FIELD_WRITE_METHODS[field_type] if class_type.is_encoder()
             else PROTO_FIELD_READ_METHODS[field_type])
@@ -1344,6 +1406,89 @@ def generate_class_for_message(message: ProtoMessage, root: ProtoNode,
     output.write_line('};')
 
 
+def struct_member_name(field: ProtoMessageField) -> str:
+    """Returns the name of a field's member in its message struct."""
+    name = field.field_name()
+    return f'{name}_' if name in CPP_KEYWORDS else name
+
+
+def generate_struct_for_message(message: ProtoMessage, root: ProtoNode,
+                                output: OutputFile) -> None:
+    """Creates a struct, field table, and table-driven Decode() and Encode()
+    functions for a protobuf message.
+
+    Only singular fields are part of the struct. Repeated fields are skipped
+    when decoding, and can be read with the message's StreamDecoder.
+    """
+    assert message.type() == ProtoNode.Type.MESSAGE
+
+    fields = sorted((f for f in message.fields() if not f.is_repeated()),
+                    key=lambda f: f.number())
+    internal = f'{PROTOBUF_NAMESPACE}::internal'
+
+    output.write_line()
+    output.write_line(f'namespace {message.cpp_namespace(root)} {{')
+    output.write_line()
+    output.write_line('struct Message {')
+    with output.indent():
+        for field in fields:
+            if field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_ENUM:
+                member_type = relative_type_namespace(field, message, root)
+            else:
+                member_type = STRUCT_FIELD_TYPES[field.type()][0]
+            member = struct_member_name(field)
+            output.write_line(f'{member_type} {member} = {{}};')
+    output.write_line('};')
+
+    # std::span and std::string_view members may make Message
+    # non-standard-layout. offsetof is still well-defined for these types on
+    # the supported compilers, since they have no virtual bases.
+    output.write_line()
+    output.write_line('PW_MODIFY_DIAGNOSTICS_PUSH();')
+    output.write_line('PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");')
+    output.write_line(f'inline constexpr std::array<{internal}::MessageField, '
+                      f'{len(fields)}> kMessageFields = {{{{')
+    with output.indent():
+        for field in fields:
+            if field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_ENUM:
+                encoding = 'kSignedVarint'
+            else:
+                encoding = STRUCT_FIELD_TYPES[field.type()][1]
+            member = struct_member_name(field)
+            output.write_line(f'{{{field.number()}, '
+                              f'offsetof(Message, {member}), '
+                              f'sizeof(Message::{member}), '
+                              f'{internal}::FieldEncoding::{encoding}}},')
+    output.write_line('}};')
+    output.write_line('PW_MODIFY_DIAGNOSTICS_POP();')
+
+    output.write_line()
+    output.write_line('inline ::pw::Status Decode(std::span<const std::byte> '
+                      'data, Message& message) {')
+    with output.indent():
+        output.write_line(f'return {internal}::DecodeMessage('
+                          'data, kMessageFields, &message);')
+    output.write_line('}')
+
+    output.write_line()
+    output.write_line('inline size_t EncodedSize(const Message& message) {')
+    with output.indent():
+        output.write_line(f'return {internal}::EncodedMessageSize('
+                          '&message, kMessageFields);')
+    output.write_line('}')
+
+    output.write_line()
+    output.write_line('inline ::pw::StatusWithSize Encode(const Message& '
+                      'message, std::span<std::byte> output) {')
+    with output.indent():
+        output.write_line(f'return {internal}::EncodeMessage('
+                          '&message, kMessageFields, output);')
+    output.write_line('}')
+
+    output.write_line()
+    output.write_line(f'}}  // namespace {message.cpp_namespace(root)}')
+
+
 def define_not_in_class_methods(message: ProtoMessage, root: ProtoNode,
                                 output: OutputFile,
                                 class_type: ClassType) -> None:
@@ -1467,13 +1612,16 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
                       f'generated by {PLUGIN_NAME} {PLUGIN_VERSION}')
     output.write_line(f'// on {datetime.now()}')
     output.write_line('#pragma once\n')
+    output.write_line('#include <array>')
     output.write_line('#include <cstddef>')
     output.write_line('#include <cstdint>')
     output.write_line('#include <span>')
     output.write_line('#include <string_view>\n')
     output.write_line('#include "pw_assert/assert.h"')
     output.write_line('#include "pw_containers/vector.h"')
+    output.write_line('#include "pw_preprocessor/compiler.h"')
     output.write_line('#include "pw_protobuf/encoder.h"')
+    output.write_line('#include "pw_protobuf/internal/codegen.h"')
     output.write_line('#include "pw_protobuf/stream_decoder.h"')
     output.write_line('#include "pw_result/result.h"')
     output.write_line('#include "pw_status/status.h"')
@@ -1507,6 +1655,11 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
 
     generate_class_wrappers(package, ClassType.STREAMING_DECODER, output)
 
+    for node in package:
+        if node.type() == ProtoNode.Type.MESSAGE:
+            generate_struct_for_message(cast(ProtoMessage, node), package,
+                                        output)
+
     if package.cpp_namespace():
         output.write_line(f'\n}}  // namespace {package.cpp_namespace()}')
 
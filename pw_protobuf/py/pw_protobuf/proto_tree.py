@@ -299,6 +299,10 @@ class ProtoMessageField:
     def name(self) -> str:
         return self.upper_camel_case(self._field_name)
 
+    def field_name(self) -> str:
+        """Returns the field's name as written in the .proto file."""
+        return self._field_name
+
     def enum_name(self) -> str:
         return self.upper_snake_case(self._field_name)
 
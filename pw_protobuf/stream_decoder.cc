@@ -31,7 +31,7 @@ namespace pw::protobuf {
 
 Status StreamDecoder::BytesReader::DoSeek(ptrdiff_t offset, Whence origin) {
   PW_TRY(status_);
-  if (!decoder_.reader_.seekable()) {
+  if (!decoder_.reading_from_memory() && !decoder_.reader_.seekable()) {
     return Status::Unimplemented();
   }
 
@@ -62,7 +62,9 @@ Status StreamDecoder::BytesReader::DoSeek(ptrdiff_t offset, Whence origin) {
     return Status::OutOfRange();
   }
 
-  PW_TRY(decoder_.reader_.Seek(absolute_position, Whence::kBeginning));
+  if (!decoder_.reading_from_memory()) {
+    PW_TRY(decoder_.reader_.Seek(absolute_position, Whence::kBeginning));
+  }
   decoder_.position_ = absolute_position;
   return OkStatus();
 }
@@ -78,7 +80,7 @@ StatusWithSize StreamDecoder::BytesReader::DoRead(ByteSpan destination) {
     destination = destination.first(max_length);
   }
 
-  Result<ByteSpan> result = decoder_.reader_.Read(destination);
+  Result<ByteSpan> result = decoder_.ReadRaw(destination);
   if (!result.ok()) {
     return StatusWithSize(result.status(), 0);
   }
@@ -90,12 +92,61 @@ StatusWithSize StreamDecoder::BytesReader::DoRead(ByteSpan destination) {
 StreamDecoder::~StreamDecoder() {
   if (parent_ != nullptr) {
     parent_->CloseNestedDecoder(*this);
-  } else if (stream_bounds_.high < std::numeric_limits<size_t>::max()) {
+    return;
+  }
+
+  if (stream_bounds_.high < std::numeric_limits<size_t>::max()) {
     if (status_.ok()) {
       // Advance the stream to the end of the bounds.
       PW_CHECK(Advance(stream_bounds_.high).ok());
     }
   }
+
+  // A root decoder reading from memory leaves the MemoryReader untouched while
+  // decoding, so move it to where decoding ended. Decoders that were moved
+  // from look like they have a nested decoder open, and must not do this.
+  if (reading_from_memory() && !nested_reader_open_) {
+    PW_CHECK(reader_
+                 .Seek(static_cast<ptrdiff_t>(position_),
+                       stream::Stream::kCurrent)
+                 .ok());
+  }
+}
+
+size_t StreamDecoder::ReadLimit() const {
+  if (reading_from_memory()) {
+    return memory_.size() - position_;
+  }
+  return reader_.ConservativeReadLimit();
+}
+
+StatusWithSize StreamDecoder::ReadVarint(uint64_t* value) {
+  if (!reading_from_memory()) {
+    return varint::Read(reader_, value);
+  }
+  // Like varint::Read(), report both a truncated varint and one that doesn't
+  // fit in 64 bits as OUT_OF_RANGE.
+  const size_t bytes_read = varint::Decode(memory_.subspan(position_), value);
+  if (bytes_read == 0) {
+    return StatusWithSize::OutOfRange();
+  }
+  return StatusWithSize(bytes_read);
+}
+
+Result<ByteSpan> StreamDecoder::ReadRaw(ByteSpan out) {
+  if (!reading_from_memory()) {
+    return reader_.Read(out);
+  }
+  // Match the partial read behavior of MemoryReader.
+  const size_t limit = ReadLimit();
+  if (limit == 0) {
+    return Status::OutOfRange();
+  }
+  const size_t bytes_to_read = std::min(out.size(), limit);
+  if (bytes_to_read != 0) {
+    std::memcpy(out.data(), memory_.data() + position_, bytes_to_read);
+  }
+  return out.first(bytes_to_read);
 }
 
 Status StreamDecoder::Next() {
@@ -119,7 +170,7 @@ Status StreamDecoder::Next() {
 StreamDecoder::BytesReader StreamDecoder::GetBytesReader() {
   Status status = CheckOkToRead(WireType::kDelimited);
 
-  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+  if (ReadLimit() < delimited_field_size_) {
     status.Update(Status::DataLoss());
   }
 
@@ -138,7 +189,7 @@ StreamDecoder::BytesReader StreamDecoder::GetBytesReader() {
 StreamDecoder StreamDecoder::GetNestedDecoder() {
   Status status = CheckOkToRead(WireType::kDelimited);
 
-  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+  if (ReadLimit() < delimited_field_size_) {
     status.Update(Status::DataLoss());
   }
 
@@ -155,6 +206,14 @@ StreamDecoder StreamDecoder::GetNestedDecoder() {
 }
 
 Status StreamDecoder::Advance(size_t end_position) {
+  if (reading_from_memory()) {
+    if (end_position > memory_.size()) {
+      return Status::OutOfRange();
+    }
+    position_ = end_position;
+    return OkStatus();
+  }
+
   if (reader_.seekable()) {
     PW_TRY(reader_.Seek(end_position - position_, stream::Stream::kCurrent));
     position_ = end_position;
@@ -202,7 +261,7 @@ Status StreamDecoder::ReadFieldKey() {
   PW_DCHECK(field_consumed_);
 
   uint64_t varint = 0;
-  PW_TRY_ASSIGN(size_t bytes_read, varint::Read(reader_, &varint));
+  PW_TRY_ASSIGN(size_t bytes_read, ReadVarint(&varint));
   position_ += bytes_read;
 
   if (!FieldKey::IsValidKey(varint)) {
@@ -214,7 +273,7 @@ Status StreamDecoder::ReadFieldKey() {
   if (current_field_.wire_type() == WireType::kDelimited) {
     // Read the length varint of length-delimited fields immediately to simplify
     // later processing of the field.
-    PW_TRY_ASSIGN(bytes_read, varint::Read(reader_, &varint));
+    PW_TRY_ASSIGN(bytes_read, ReadVarint(&varint));
     position_ += bytes_read;
 
     if (varint > std::numeric_limits<uint32_t>::max()) {
@@ -246,7 +305,7 @@ Status StreamDecoder::SkipField() {
   switch (current_field_.wire_type()) {
     case WireType::kVarint: {
       // Consume the varint field; nothing more to skip afterward.
-      PW_TRY_ASSIGN(size_t bytes_read, varint::Read(reader_, &value));
+      PW_TRY_ASSIGN(size_t bytes_read, ReadVarint(&value));
       position_ += bytes_read;
       break;
     }
@@ -267,7 +326,7 @@ Status StreamDecoder::SkipField() {
     // Check if the stream has the field available. If not, report it as a
     // DATA_LOSS since the proto is invalid (as opposed to OUT_OF_BOUNDS if we
     // just tried to seek beyond the end).
-    if (reader_.ConservativeReadLimit() < bytes_to_skip) {
+    if (ReadLimit() < bytes_to_skip) {
       status_ = Status::DataLoss();
       return status_;
     }
@@ -296,7 +355,7 @@ Status StreamDecoder::ReadVarintField(std::span<std::byte> out,
 StatusWithSize StreamDecoder::ReadOneVarint(std::span<std::byte> out,
                                             VarintDecodeType decode_type) {
   uint64_t value;
-  StatusWithSize sws = varint::Read(reader_, &value);
+  StatusWithSize sws = ReadVarint(&value);
   if (sws.IsOutOfRange()) {
     // Out of range indicates the end of the stream. As a value is expected
     // here, report it as a data loss and terminate the decode operation.
@@ -348,12 +407,12 @@ Status StreamDecoder::ReadFixedField(std::span<std::byte> out) {
       out.size() == sizeof(uint32_t) ? WireType::kFixed32 : WireType::kFixed64;
   PW_TRY(CheckOkToRead(expected_wire_type));
 
-  if (reader_.ConservativeReadLimit() < out.size()) {
+  if (ReadLimit() < out.size()) {
     status_ = Status::DataLoss();
     return status_;
   }
 
-  PW_TRY(reader_.Read(out));
+  PW_TRY(ReadRaw(out));
   position_ += out.size();
   field_consumed_ = true;
 
@@ -369,7 +428,7 @@ StatusWithSize StreamDecoder::ReadDelimitedField(std::span<std::byte> out) {
     return StatusWithSize(status, 0);
   }
 
-  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+  if (ReadLimit() < delimited_field_size_) {
     status_ = Status::DataLoss();
     return StatusWithSize(status_, 0);
   }
@@ -381,7 +440,7 @@ StatusWithSize StreamDecoder::ReadDelimitedField(std::span<std::byte> out) {
     return StatusWithSize::ResourceExhausted();
   }
 
-  Result<ByteSpan> result = reader_.Read(out.first(delimited_field_size_));
+  Result<ByteSpan> result = ReadRaw(out.first(delimited_field_size_));
   if (!result.ok()) {
     return StatusWithSize(result.status(), 0);
   }
@@ -397,7 +456,7 @@ StatusWithSize StreamDecoder::ReadPackedFixedField(std::span<std::byte> out,
     return StatusWithSize(status, 0);
   }
 
-  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+  if (ReadLimit() < delimited_field_size_) {
     status_ = Status::DataLoss();
     return StatusWithSize(status_, 0);
   }
@@ -409,7 +468,7 @@ StatusWithSize StreamDecoder::ReadPackedFixedField(std::span<std::byte> out,
     return StatusWithSize::ResourceExhausted();
   }
 
-  Result<ByteSpan> result = reader_.Read(out.first(delimited_field_size_));
+  Result<ByteSpan> result = ReadRaw(out.first(delimited_field_size_));
   if (!result.ok()) {
     return StatusWithSize(result.status(), 0);
   }
@@ -439,7 +498,7 @@ StatusWithSize StreamDecoder::ReadPackedVarintField(
     return StatusWithSize(status, 0);
   }
 
-  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+  if (ReadLimit() < delimited_field_size_) {
     status_ = Status::DataLoss();
     return StatusWithSize(status_, 0);
   }
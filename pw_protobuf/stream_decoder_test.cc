@@ -15,6 +15,7 @@
 #include "pw_protobuf/stream_decoder.h"
 
 #include <array>
+#include <string_view>
 
 #include "gtest/gtest.h"
 #include "pw_status/status.h"
@@ -787,6 +788,96 @@ TEST(StreamDecoder, Decode_WithLength_SkipsToEnd) {
   EXPECT_EQ(reader.Tell(), 13u);
 }
 
+TEST(StreamDecoder, Decode_MemoryReader_AdvancesReaderOnDestruction) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // Not part of the protobuf; read from the reader before decoding.
+    0xff,
+    // type=int32, k=1, v=42
+    0x08, 0x2a,
+    // type=string, k=2, v="Hi"
+    0x12, 0x02, 'H', 'i',
+    // type=sint32, k=3, v=-13
+    0x18, 0x19,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  std::byte first;
+  ASSERT_EQ(reader.Read(std::span(&first, 1)).status(), OkStatus());
+
+  {
+    StreamDecoder decoder(reader);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    Result<int32_t> int32 = decoder.ReadInt32();
+    ASSERT_EQ(int32.status(), OkStatus());
+    EXPECT_EQ(int32.value(), 42);
+
+    // Skip the string.
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber().value(), 3u);
+
+    // The reader is not used while decoding from memory.
+    EXPECT_EQ(reader.Tell(), 1u);
+  }
+
+  // Decoding stopped after the key of field 3.
+  EXPECT_EQ(reader.Tell(), 8u);
+}
+
+TEST(StreamDecoder, Decode_MemoryReader_MatchesStream) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint64, k=1, v=0x123456789
+    0x08, 0x89, 0xcf, 0x95, 0x9a, 0x12,
+    // type=NestedProto, k=2
+    0x12, 0x07,
+    // type=string, k=1, v="Hello"
+    0x0a, 0x05, 'H', 'e', 'l', 'l', 'o',
+    // type=fixed32, k=3, v=0xdeadbeef
+    0x1d, 0xef, 0xbe, 0xad, 0xde,
+    // type=uint32, k=4, truncated
+    0x20, 0x80,
+  };
+  // clang-format on
+
+  stream::MemoryReader memory_reader(std::as_bytes(std::span(encoded_proto)));
+  stream::MemoryReader wrapped_reader(std::as_bytes(std::span(encoded_proto)));
+  // Decoding through a plain stream::Reader uses the regular stream path.
+  stream::Reader& stream_reader = wrapped_reader;
+
+  StreamDecoder memory_decoder(memory_reader);
+  StreamDecoder stream_decoder(stream_reader);
+
+  for (StreamDecoder* decoder : {&memory_decoder, &stream_decoder}) {
+    EXPECT_EQ(decoder->Next(), OkStatus());
+    Result<uint64_t> uint64 = decoder->ReadUint64();
+    ASSERT_EQ(uint64.status(), OkStatus());
+    EXPECT_EQ(uint64.value(), 0x123456789u);
+
+    EXPECT_EQ(decoder->Next(), OkStatus());
+    {
+      StreamDecoder nested = decoder->GetNestedDecoder();
+      EXPECT_EQ(nested.Next(), OkStatus());
+      std::array<char, 8> buffer;
+      StatusWithSize sws = nested.ReadString(buffer);
+      ASSERT_EQ(sws.status(), OkStatus());
+      EXPECT_EQ(std::string_view(buffer.data(), sws.size()), "Hello");
+      EXPECT_EQ(nested.Next(), Status::OutOfRange());
+    }
+
+    EXPECT_EQ(decoder->Next(), OkStatus());
+    Result<uint32_t> fixed32 = decoder->ReadFixed32();
+    ASSERT_EQ(fixed32.status(), OkStatus());
+    EXPECT_EQ(fixed32.value(), 0xdeadbeef);
+
+    EXPECT_EQ(decoder->Next(), OkStatus());
+    EXPECT_EQ(decoder->ReadUint32().status(), Status::DataLoss());
+  }
+}
+
 TEST(StreamDecoder, RepeatedField) {
   // clang-format off
   constexpr uint8_t encoded_proto[] = {
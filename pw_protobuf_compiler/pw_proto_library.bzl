@@ -30,7 +30,8 @@ TODO(pwbug/621): Close these gaps and start using this implementation.
 intended to orient future maintainers.)
 
 Proto code generation is carried out by the _pw_proto_library,
-_pw_raw_rpc_proto_library and _pw_nanopb_rpc_proto_library rules using aspects
+_pw_raw_rpc_proto_library, _pw_pwpb_rpc_proto_library and
+_pw_nanopb_rpc_proto_library rules using aspects
 (https://docs.bazel.build/versions/main/skylark/aspects.html). A
 _pw_proto_library has a single proto_library as a dependency, but that
 proto_library may depend on other proto_library targets; as a result, the
@@ -90,6 +91,8 @@ def pw_proto_library(name = "", deps = [], nanopb_options = None):
     "benchmark_pw_proto.pwpb": C++ library exposing the "benchmark.pwpb.h" header.
     "benchmark_pw_proto.raw_rpc": C++ library exposing the "benchmark.raw_rpc.h"
         header.
+    "benchmark_pw_proto.pwpb_rpc": C++ library exposing the
+        "benchmark.rpc.pwpb.h" header.
     "benchmark_pw_proto.nanopb": C++ library exposing the "benchmark.pb.h"
         header.
     "benchmark_pw_proto.nanopb_rpc": C++ library exposing the
@@ -114,6 +117,10 @@ def pw_proto_library(name = "", deps = [], nanopb_options = None):
         else:
             lib_deps = info["deps"]
 
+        # The rpc.pwpb.h header depends on the generated pw_protobuf code.
+        if info.get("include_pwpb_dep", False):
+            lib_deps = lib_deps + [":" + name + ".pwpb"]
+
         pw_cc_library(
             name = name + "." + plugin_name,
             hdrs = [name_pb],
@@ -247,6 +254,18 @@ _pw_raw_rpc_proto_library = rule(
     },
 )
 
+_pw_pwpb_rpc_proto_compiler_aspect = _proto_compiler_aspect("rpc.pwpb.h", "//pw_rpc/py:plugin_pwpb")
+
+_pw_pwpb_rpc_proto_library = rule(
+    implementation = _impl_pw_proto_library,
+    attrs = {
+        "deps": attr.label_list(
+            providers = [ProtoInfo],
+            aspects = [_pw_pwpb_rpc_proto_compiler_aspect],
+        ),
+    },
+)
+
 _pw_nanopb_rpc_proto_compiler_aspect = _proto_compiler_aspect("rpc.pb.h", "//pw_rpc/py:plugin_nanopb")
 
 _pw_nanopb_rpc_proto_library = rule(
@@ -277,6 +296,16 @@ PIGWEED_PLUGIN = {
         ],
         "include_nanopb_dep": False,
     },
+    "pwpb_rpc": {
+        "compiler": _pw_pwpb_rpc_proto_library,
+        "deps": [
+            "//pw_rpc",
+            "//pw_rpc/pwpb:server_api",
+            "//pw_rpc/raw:client_api",
+        ],
+        "include_nanopb_dep": False,
+        "include_pwpb_dep": True,
+    },
     "nanopb_rpc": {
         "compiler": _pw_nanopb_rpc_proto_library,
         "deps": [
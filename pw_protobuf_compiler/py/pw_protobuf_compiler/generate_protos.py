@@ -104,6 +104,15 @@ def protoc_nanopb_rpc_args(args: argparse.Namespace) -> Tuple[str, ...]:
     )
 
 
+def protoc_pwpb_rpc_args(args: argparse.Namespace) -> Tuple[str, ...]:
+    return _COMMON_FLAGS + (
+        '--plugin',
+        f'protoc-gen-custom={args.plugin_path}',
+        '--custom_out',
+        args.out_dir,
+    )
+
+
 def protoc_raw_rpc_args(args: argparse.Namespace) -> Tuple[str, ...]:
     return _COMMON_FLAGS + (
         '--plugin',
@@ -131,6 +140,7 @@ DEFAULT_PROTOC_ARGS: Dict[str, _DefaultArgsFunction] = {
     'go': protoc_go_args,
     'nanopb': protoc_nanopb_args,
     'nanopb_rpc': protoc_nanopb_rpc_args,
+    'pwpb_rpc': protoc_pwpb_rpc_args,
     'raw_rpc': protoc_raw_rpc_args,
     'python': protoc_python_args,
 }
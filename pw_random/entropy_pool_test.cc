@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_random/entropy_pool.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::random {
+namespace {
+
+TEST(EntropyPool, StartsEmpty) {
+  EntropyPoolBuffer<8> pool;
+  EXPECT_EQ(pool.available(), 0u);
+  EXPECT_EQ(pool.space(), 8u);
+  EXPECT_EQ(pool.capacity(), 8u);
+
+  uint32_t value = 0;
+  StatusWithSize result = pool.GetInt(value);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST(EntropyPool, ReturnsInjectedBytesInOrder) {
+  constexpr auto kEntropy = bytes::Array<1, 2, 3, 4, 5>();
+  EntropyPoolBuffer<8> pool;
+  pool.InjectEntropy(kEntropy);
+  EXPECT_EQ(pool.available(), 5u);
+
+  std::array<std::byte, 5> out{};
+  EXPECT_EQ(pool.Get(out).status(), OkStatus());
+  EXPECT_EQ(0, std::memcmp(out.data(), kEntropy.data(), out.size()));
+  EXPECT_EQ(pool.available(), 0u);
+}
+
+TEST(EntropyPool, PartialGet) {
+  EntropyPoolBuffer<8> pool;
+  pool.InjectEntropy(bytes::Array<0xa, 0xb>());
+
+  std::array<std::byte, 4> out{};
+  StatusWithSize result = pool.Get(out);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(out[0], std::byte{0xa});
+  EXPECT_EQ(out[1], std::byte{0xb});
+}
+
+TEST(EntropyPool, DiscardsEntropyWhenFull) {
+  EntropyPoolBuffer<4> pool;
+  pool.InjectEntropy(bytes::Array<1, 2, 3>());
+  pool.InjectEntropy(bytes::Array<4, 5, 6>());
+  EXPECT_EQ(pool.available(), 4u);
+  EXPECT_EQ(pool.space(), 0u);
+
+  std::array<std::byte, 4> out{};
+  EXPECT_EQ(pool.Get(out).status(), OkStatus());
+  EXPECT_EQ(out, (bytes::Array<1, 2, 3, 4>()));
+}
+
+TEST(EntropyPool, WrapsAround) {
+  EntropyPoolBuffer<5> pool;
+  std::array<std::byte, 3> out{};
+
+  for (uint8_t i = 0; i < 20; ++i) {
+    const std::array<std::byte, 3> in = {
+        std::byte(i), std::byte(i + 1), std::byte(i + 2)};
+    pool.InjectEntropy(in);
+    ASSERT_EQ(pool.Get(out).status(), OkStatus());
+    EXPECT_EQ(out, in);
+    EXPECT_EQ(pool.available(), 0u);
+  }
+}
+
+TEST(EntropyPool, InjectEntropyBits_CollectsWholeBytes) {
+  EntropyPoolBuffer<8> pool;
+  pool.InjectEntropyBits(0b1010, 4);
+  EXPECT_EQ(pool.available(), 0u);
+  pool.InjectEntropyBits(0b0101, 4);
+  EXPECT_EQ(pool.available(), 1u);
+
+  pool.InjectEntropyBits(0x1, 1);
+  pool.InjectEntropyBits(0x2345678, 31);  // 32 bits: 0x82345678
+  EXPECT_EQ(pool.available(), 5u);
+
+  std::array<std::byte, 5> out{};
+  EXPECT_EQ(pool.Get(out).status(), OkStatus());
+  EXPECT_EQ(out, (bytes::Array<0xa5, 0x82, 0x34, 0x56, 0x78>()));
+}
+
+TEST(EntropyPool, InjectEntropyBits_IgnoresHighBits) {
+  EntropyPoolBuffer<8> pool;
+  pool.InjectEntropyBits(0xffffff0f, 4);
+  pool.InjectEntropyBits(0xfffffff0, 4);
+
+  uint8_t value = 0;
+  EXPECT_EQ(pool.GetInt(value).status(), OkStatus());
+  EXPECT_EQ(value, 0xf0u);
+}
+
+}  // namespace
+}  // namespace pw::random
@@ -0,0 +1,162 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// A RandomGenerator that buffers entropy from a hardware random number
+// generator, so callers of Get() never wait on the peripheral. The driver
+// fills the pool in the background, such as from the TRNG's data-ready
+// interrupt or an idle task, with InjectEntropy() or InjectEntropyBits().
+// Get() copies out of the pool without blocking and returns
+// RESOURCE_EXHAUSTED with a partial size if the pool runs dry.
+//
+// The pool is a lock-free ring buffer for one producer and one consumer, which
+// may run in different threads or interrupts. Entropy injected while the pool
+// is full is discarded; space() returns how many bytes the driver can add.
+//
+// Entropy is returned as it was injected, without whitening. The quality of the
+// output is that of the hardware source. To stretch limited entropy, seed a
+// PRNG such as XorShiftStarRng64 from the pool instead.
+//
+// The EntropyPoolBuffer template class, defined below, allocates a buffer.
+class EntropyPool : public RandomGenerator {
+ public:
+  constexpr EntropyPool(ByteSpan buffer)
+      : buffer_(buffer),
+        read_index_(0),
+        write_index_(0),
+        partial_bits_(0),
+        partial_bit_count_(0) {}
+
+  EntropyPool(const EntropyPool&) = delete;
+  EntropyPool& operator=(const EntropyPool&) = delete;
+
+  // Copies buffered entropy into dest. Returns OK if dest was filled, or
+  // RESOURCE_EXHAUSTED and the number of bytes copied if the pool ran out.
+  // Only one thread may call Get() at a time.
+  StatusWithSize Get(ByteSpan dest) final {
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_acquire);
+    const size_t size = std::min(dest.size_bytes(),
+                                 Distance(read_index, write_index));
+
+    const size_t offset = read_index % buffer_.size();
+    const size_t first = std::min(size, buffer_.size() - offset);
+    std::memcpy(dest.data(), &buffer_[offset], first);
+    std::memcpy(dest.data() + first, buffer_.data(), size - first);
+
+    read_index_.store(Advance(read_index, size), std::memory_order_release);
+
+    if (size < dest.size_bytes()) {
+      return StatusWithSize::ResourceExhausted(size);
+    }
+    return StatusWithSize(size);
+  }
+
+  // Adds up to 32 bits of entropy. Bits are collected until a whole byte is
+  // available.
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    if (num_bits > 32) {
+      num_bits = 32;
+    }
+    partial_bits_ = (partial_bits_ << num_bits) |
+                    (data & ((uint64_t{1} << num_bits) - 1));
+    partial_bit_count_ += num_bits;
+
+    std::array<std::byte, sizeof(uint32_t) + 1> bytes;
+    size_t count = 0;
+    for (; partial_bit_count_ >= 8u; partial_bit_count_ -= 8) {
+      bytes[count++] =
+          static_cast<std::byte>(partial_bits_ >> (partial_bit_count_ - 8));
+    }
+    Write(std::span(bytes).first(count));
+  }
+
+  // Adds whole bytes of entropy, such as a block read from a TRNG FIFO. Bytes
+  // that do not fit in the pool are discarded.
+  void InjectEntropy(ConstByteSpan data) final { Write(data); }
+
+  // The number of bytes of entropy that Get() can currently return.
+  size_t available() const {
+    return Distance(read_index_.load(std::memory_order_acquire),
+                    write_index_.load(std::memory_order_acquire));
+  }
+
+  // The number of bytes that can be injected before the pool is full.
+  size_t space() const { return buffer_.size() - available(); }
+
+  size_t capacity() const { return buffer_.size(); }
+
+ private:
+  // Indices count up to twice the buffer size, which distinguishes a full pool
+  // from an empty one without wasting a byte.
+  size_t Distance(size_t from, size_t to) const {
+    return to >= from ? to - from : to + 2 * buffer_.size() - from;
+  }
+
+  size_t Advance(size_t index, size_t count) const {
+    index += count;
+    return index >= 2 * buffer_.size() ? index - 2 * buffer_.size() : index;
+  }
+
+  void Write(ConstByteSpan data) {
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    const size_t read_index = read_index_.load(std::memory_order_acquire);
+    const size_t size =
+        std::min(data.size_bytes(),
+                 buffer_.size() - Distance(read_index, write_index));
+
+    const size_t offset = write_index % buffer_.size();
+    const size_t first = std::min(size, buffer_.size() - offset);
+    std::memcpy(&buffer_[offset], data.data(), first);
+    std::memcpy(buffer_.data(), data.data() + first, size - first);
+
+    write_index_.store(Advance(write_index, size), std::memory_order_release);
+  }
+
+  const ByteSpan buffer_;
+  std::atomic<size_t> read_index_;
+  std::atomic<size_t> write_index_;
+
+  // Bits from InjectEntropyBits() that do not yet make up a whole byte. Only
+  // accessed by the producer.
+  uint64_t partial_bits_;
+  uint_fast8_t partial_bit_count_;
+};
+
+// EntropyPoolBuffers declare a buffer along with an EntropyPool.
+template <size_t kSizeBytes>
+class EntropyPoolBuffer : public EntropyPool {
+ public:
+  EntropyPoolBuffer() : EntropyPool(buffer_) {}
+
+ private:
+  static_assert(kSizeBytes > 0u);
+
+  std::array<std::byte, kSizeBytes> buffer_;
+};
+
+}  // namespace pw::random
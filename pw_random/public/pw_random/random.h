@@ -50,8 +50,9 @@ class RandomGenerator {
   // assumed to be stored in the least significant bits of `data`.
   virtual void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) = 0;
 
-  // Injects entropy into the pool byte-by-byte.
-  void InjectEntropy(ConstByteSpan data) {
+  // Injects entropy into the pool byte-by-byte. Implementations may override
+  // this to inject several bytes at once, but must produce the same result.
+  virtual void InjectEntropy(ConstByteSpan data) {
     for (std::byte b : data) {
       InjectEntropyBits(std::to_integer<uint32_t>(b), /*num_bits=*/8);
     }
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <span>
@@ -37,16 +38,27 @@ class XorShiftStarRng64 : public RandomGenerator {
 
   // This generator uses entropy-seeded PRNG to never exhaust its random number
   // pool.
+  //
+  // The state is kept in a local while filling the buffer. Writes through the
+  // byte pointer could alias state_, so updating the member directly would
+  // force a reload and store of the state for every word.
   StatusWithSize Get(ByteSpan dest) final {
-    const size_t bytes_written = dest.size_bytes();
-    while (!dest.empty()) {
-      uint64_t random = Regenerate();
-      size_t copy_size = std::min(dest.size_bytes(), sizeof(state_));
-      std::memcpy(dest.data(), &random, copy_size);
-      dest = dest.subspan(copy_size);
+    uint64_t state = NonzeroState();
+    std::byte* out = dest.data();
+    size_t remaining = dest.size_bytes();
+
+    for (; remaining >= sizeof(state); remaining -= sizeof(state)) {
+      const uint64_t random = Regenerate(state);
+      std::memcpy(out, &random, sizeof(random));
+      out += sizeof(random);
+    }
+    if (remaining != 0u) {
+      const uint64_t random = Regenerate(state);
+      std::memcpy(out, &random, remaining);
     }
 
-    return StatusWithSize(bytes_written);
+    state_ = state;
+    return StatusWithSize(dest.size_bytes());
   }
 
   // Entropy is injected by rotating the state by the number of entropy bits
@@ -64,22 +76,39 @@ class XorShiftStarRng64 : public RandomGenerator {
     uint64_t untouched_state = state_ >> (kNumStateBits - num_bits);
     state_ = untouched_state | (state_ << num_bits);
     // Zero-out all irrelevant bits, then XOR entropy into state.
-    uint32_t mask = (1 << num_bits) - 1;
+    const uint64_t mask = (uint64_t{1} << num_bits) - 1;
     state_ ^= (data & mask);
   }
 
+  // Injects eight bytes at a time. Rotating the state by 64 bits leaves it
+  // unchanged, so XORing a big-endian word of eight bytes into the state is
+  // identical to injecting the bytes one at a time.
+  void InjectEntropy(ConstByteSpan data) final {
+    for (; data.size_bytes() >= sizeof(state_);
+         data = data.subspan(sizeof(state_))) {
+      uint64_t word = 0;
+      for (size_t i = 0; i < sizeof(state_); ++i) {
+        word = (word << 8) | std::to_integer<uint64_t>(data[i]);
+      }
+      state_ ^= word;
+    }
+    RandomGenerator::InjectEntropy(data);
+  }
+
  private:
+  // State must be nonzero, or the algorithm will get stuck and always return
+  // zero. Generating never produces a zero state, so this is only checked
+  // once per call.
+  uint64_t NonzeroState() const {
+    return state_ == 0 ? ~uint64_t{0} : state_;
+  }
+
   // Calculate and return the next value based on the "xorshift*" algorithm
-  uint64_t Regenerate() {
-    // State must be nonzero, or the algorithm will get stuck and always return
-    // zero.
-    if (state_ == 0) {
-      state_--;
-    }
-    state_ ^= state_ >> 12;
-    state_ ^= state_ << 25;
-    state_ ^= state_ >> 27;
-    return state_ * kMultConst;
+  static uint64_t Regenerate(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * kMultConst;
   }
   uint64_t state_;
   static constexpr uint8_t kNumStateBits = sizeof(state_) * 8;
@@ -13,12 +13,15 @@
 // the License.
 #include "pw_random/xor_shift.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include "gtest/gtest.h"
+#include "pw_bytes/array.h"
 
 namespace pw::random {
 namespace {
@@ -118,5 +121,65 @@ TEST(XorShiftStarRng64, InjectEntropy) {
   EXPECT_NE(val, result1[0]);
 }
 
+// Injecting bytes in bulk must match injecting them one at a time.
+TEST(XorShiftStarRng64, InjectEntropy_MatchesBytewise) {
+  constexpr auto kEntropy = bytes::Array<0xaf,
+                                         0x9b,
+                                         0x33,
+                                         0x17,
+                                         0x02,
+                                         0xff,
+                                         0x00,
+                                         0x80,
+                                         0x5a,
+                                         0xc3,
+                                         0x7e>();
+  XorShiftStarRng64 bulk(seed1);
+  XorShiftStarRng64 bytewise(seed1);
+  bulk.InjectEntropy(kEntropy);
+  for (std::byte b : kEntropy) {
+    bytewise.InjectEntropyBits(std::to_integer<uint32_t>(b), 8);
+  }
+
+  uint64_t bulk_val = 0;
+  uint64_t bytewise_val = 0;
+  EXPECT_EQ(bulk.GetInt(bulk_val).status(), OkStatus());
+  EXPECT_EQ(bytewise.GetInt(bytewise_val).status(), OkStatus());
+  EXPECT_EQ(bulk_val, bytewise_val);
+}
+
+TEST(XorShiftStarRng64, InjectEntropyBits_32Bits) {
+  XorShiftStarRng64 rng_1(seed1);
+  XorShiftStarRng64 rng_2(seed1);
+  rng_1.InjectEntropyBits(0x12345678, 32);
+  rng_2.InjectEntropyBits(0x1234, 16);
+  rng_2.InjectEntropyBits(0x5678, 16);
+
+  uint64_t first_val = 0;
+  uint64_t second_val = 0;
+  EXPECT_EQ(rng_1.GetInt(first_val).status(), OkStatus());
+  EXPECT_EQ(rng_2.GetInt(second_val).status(), OkStatus());
+  EXPECT_EQ(first_val, second_val);
+  EXPECT_NE(first_val, result1[0]);
+}
+
+// Filling a large buffer produces the same series as individual calls,
+// including a partial word at the end.
+TEST(XorShiftStarRng64, Get_BulkMatchesSeries) {
+  XorShiftStarRng64 rng(seed1);
+  std::array<std::byte, sizeof(result1) - 3> buffer;
+  StatusWithSize result = rng.Get(buffer);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), buffer.size());
+  EXPECT_EQ(0, std::memcmp(result1, buffer.data(), buffer.size()));
+}
+
+TEST(XorShiftStarRng64, Get_ZeroSeed) {
+  XorShiftStarRng64 rng(0);
+  uint64_t val = 0;
+  EXPECT_EQ(rng.GetInt(val).status(), OkStatus());
+  EXPECT_NE(val, 0u);
+}
+
 }  // namespace
 }  // namespace pw::random
@@ -0,0 +1,299 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/lock_free_prefixed_entry_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace ring_buffer {
+
+using std::byte;
+
+Status LockFreePrefixedEntryRingBuffer::SetBuffer(std::span<byte> buffer) {
+  if ((buffer.data() == nullptr) ||  //
+      (buffer.size_bytes() == 0) ||  //
+      (buffer.size_bytes() > kMaxBufferBytes)) {
+    return Status::InvalidArgument();
+  }
+
+  buffer_ = buffer.data();
+  buffer_bytes_ = buffer.size_bytes();
+  reserved_ = false;
+
+  write_idx_.store(0, std::memory_order_relaxed);
+  read_idx_.store(0, std::memory_order_relaxed);
+  return OkStatus();
+}
+
+Status LockFreePrefixedEntryRingBuffer::TryPushBack(
+    std::span<const byte> data, uint32_t user_preamble_data) {
+  if (buffer_ == nullptr || reserved_) {
+    return Status::FailedPrecondition();
+  }
+
+  // Prepare a single buffer that can hold both the user preamble and entry
+  // length.
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t preamble_bytes =
+      EncodePreamble(user_preamble_data, data.size_bytes(), 0, preamble_buf);
+  size_t total_write_bytes = preamble_bytes + data.size_bytes();
+  if (buffer_bytes_ < total_write_bytes) {
+    return Status::OutOfRange();
+  }
+
+  // The acquire load ensures that the consumer is done reading the space that
+  // it freed before it is overwritten.
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+  if (buffer_bytes_ - UsedBytes(read_idx, write_idx) < total_write_bytes) {
+    return Status::ResourceExhausted();
+  }
+
+  RawWrite(write_idx, std::span(preamble_buf, preamble_bytes));
+  RawWrite(IncrementIndex(write_idx, preamble_bytes), data);
+
+  // Publish the entry only once all of its bytes are written.
+  write_idx_.store(IncrementIndex(write_idx, total_write_bytes),
+                   std::memory_order_release);
+  return OkStatus();
+}
+
+Result<LockFreePrefixedEntryRingBuffer::ReservedEntry>
+LockFreePrefixedEntryRingBuffer::TryReserve(size_t max_data_bytes,
+                                            uint32_t user_preamble_data) {
+  if (buffer_ == nullptr || reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (buffer_bytes_ < max_data_bytes) {
+    return Status::OutOfRange();
+  }
+
+  // The preamble is written by Commit(), once the data size is known. Its
+  // length varint is padded to the size needed for max_data_bytes, so the
+  // data's position does not depend on its final size.
+  const size_t user_preamble_bytes =
+      user_preamble_ ? varint::EncodedSize(user_preamble_data) : 0;
+  const size_t length_bytes = varint::EncodedSize(max_data_bytes);
+  const size_t preamble_bytes = user_preamble_bytes + length_bytes;
+  if (buffer_bytes_ - max_data_bytes < preamble_bytes) {
+    return Status::OutOfRange();
+  }
+
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+  if (buffer_bytes_ - UsedBytes(read_idx, write_idx) <
+      preamble_bytes + max_data_bytes) {
+    return Status::ResourceExhausted();
+  }
+
+  reserved_ = true;
+  reserved_user_preamble_ = user_preamble_data;
+  reserved_length_bytes_ = length_bytes;
+  reserved_data_bytes_ = max_data_bytes;
+
+  // Split the data region at the end of the buffer.
+  const size_t data_offset =
+      BufferOffset(IncrementIndex(write_idx, preamble_bytes));
+  const size_t first_bytes =
+      std::min(max_data_bytes, buffer_bytes_ - data_offset);
+  return ReservedEntry{
+      .first = std::span(buffer_ + data_offset, first_bytes),
+      .second = std::span(buffer_, max_data_bytes - first_bytes),
+  };
+}
+
+Status LockFreePrefixedEntryRingBuffer::Commit(size_t data_bytes) {
+  if (!reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (data_bytes > reserved_data_bytes_) {
+    return Status::InvalidArgument();
+  }
+
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t preamble_bytes = EncodePreamble(reserved_user_preamble_,
+                                               data_bytes,
+                                               reserved_length_bytes_,
+                                               preamble_buf);
+
+  // The data was already written by the producer directly after the preamble.
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  RawWrite(write_idx, std::span(preamble_buf, preamble_bytes));
+  reserved_ = false;
+
+  // Publish the entry only once all of its bytes are written.
+  write_idx_.store(IncrementIndex(write_idx, preamble_bytes + data_bytes),
+                   std::memory_order_release);
+  return OkStatus();
+}
+
+Status LockFreePrefixedEntryRingBuffer::PeekFront(
+    std::span<byte> data, size_t* bytes_read_out) const {
+  *bytes_read_out = 0;
+
+  size_t read_idx;
+  PW_TRY_ASSIGN(const EntryInfo info, FrontEntryInfo(read_idx));
+
+  const size_t bytes_to_copy = std::min(data.size_bytes(), info.data_bytes);
+  RawRead(data.data(),
+          IncrementIndex(read_idx, info.preamble_bytes),
+          bytes_to_copy);
+  *bytes_read_out = bytes_to_copy;
+
+  return bytes_to_copy == info.data_bytes ? OkStatus()
+                                          : Status::ResourceExhausted();
+}
+
+Status LockFreePrefixedEntryRingBuffer::PeekFrontPreamble(
+    uint32_t& user_preamble_out) const {
+  size_t read_idx;
+  PW_TRY_ASSIGN(const EntryInfo info, FrontEntryInfo(read_idx));
+  user_preamble_out = info.user_preamble;
+  return OkStatus();
+}
+
+Status LockFreePrefixedEntryRingBuffer::PopFront() {
+  size_t read_idx;
+  PW_TRY_ASSIGN(const EntryInfo info, FrontEntryInfo(read_idx));
+
+  // Hand the entry's space back to the producer.
+  read_idx_.store(
+      IncrementIndex(read_idx, info.preamble_bytes + info.data_bytes),
+      std::memory_order_release);
+  return OkStatus();
+}
+
+size_t LockFreePrefixedEntryRingBuffer::FrontEntryDataSizeBytes() const {
+  size_t read_idx;
+  const Result<EntryInfo> info = FrontEntryInfo(read_idx);
+  return info.ok() ? info.value().data_bytes : 0;
+}
+
+void LockFreePrefixedEntryRingBuffer::Clear() {
+  read_idx_.store(write_idx_.load(std::memory_order_acquire),
+                  std::memory_order_release);
+}
+
+Result<LockFreePrefixedEntryRingBuffer::EntryInfo>
+LockFreePrefixedEntryRingBuffer::FrontEntryInfo(size_t& read_idx_out) const {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  // The acquire load ensures that the producer's writes to the entries before
+  // the write index are visible.
+  read_idx_out = read_idx_.load(std::memory_order_relaxed);
+  const size_t used_bytes =
+      UsedBytes(read_idx_out, write_idx_.load(std::memory_order_acquire));
+  if (used_bytes == 0u) {
+    return Status::OutOfRange();
+  }
+
+  // Entry headers consists of: (optional varint preamble, varint size, data...)
+  // Only read bytes that the producer has published.
+  byte varint_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t header_bytes = std::min(sizeof(varint_buf), used_bytes);
+  RawRead(varint_buf, read_idx_out, header_bytes);
+  std::span<const byte> header(varint_buf, header_bytes);
+
+  size_t user_preamble_bytes = 0;
+  uint64_t user_preamble_data = 0;
+  if (user_preamble_) {
+    user_preamble_bytes = varint::Decode(header, &user_preamble_data);
+    PW_CHECK_UINT_NE(user_preamble_bytes, 0u);
+  }
+
+  uint64_t entry_bytes;
+  const size_t length_bytes =
+      varint::Decode(header.subspan(user_preamble_bytes), &entry_bytes);
+  PW_CHECK_UINT_NE(length_bytes, 0u);
+
+  EntryInfo info = {};
+  info.preamble_bytes = user_preamble_bytes + length_bytes;
+  info.user_preamble = static_cast<uint32_t>(user_preamble_data);
+  info.data_bytes = entry_bytes;
+  PW_CHECK_UINT_LE(info.preamble_bytes + info.data_bytes, used_bytes);
+  return info;
+}
+
+size_t LockFreePrefixedEntryRingBuffer::EncodePreamble(
+    uint32_t user_preamble_data,
+    size_t data_bytes,
+    size_t min_length_bytes,
+    std::span<byte> buffer) const {
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes = varint::Encode<uint32_t>(user_preamble_data, buffer);
+  }
+
+  std::span<byte> length = buffer.subspan(user_preamble_bytes);
+  size_t length_bytes = varint::Encode<uint32_t>(data_bytes, length);
+
+  // Pad the length with continuation bytes, which varint decoding accepts.
+  if (length_bytes < min_length_bytes) {
+    length[length_bytes - 1] |= byte{0x80};
+    for (; length_bytes < min_length_bytes - 1; ++length_bytes) {
+      length[length_bytes] = byte{0x80};
+    }
+    length[length_bytes++] = byte{0x00};
+  }
+  return user_preamble_bytes + length_bytes;
+}
+
+void LockFreePrefixedEntryRingBuffer::RawWrite(
+    size_t index, std::span<const std::byte> source) {
+  if (source.size_bytes() == 0) {
+    return;
+  }
+
+  // Write until the end of the source or the backing buffer.
+  const size_t offset = BufferOffset(index);
+  size_t bytes_until_wrap = buffer_bytes_ - offset;
+  size_t bytes_to_copy = std::min(source.size(), bytes_until_wrap);
+  memcpy(buffer_ + offset, source.data(), bytes_to_copy);
+
+  // If there wasn't space in the backing buffer, wrap to the front.
+  if (bytes_to_copy < source.size()) {
+    memcpy(
+        buffer_, source.data() + bytes_to_copy, source.size() - bytes_to_copy);
+  }
+}
+
+void LockFreePrefixedEntryRingBuffer::RawRead(byte* destination,
+                                              size_t index,
+                                              size_t length) const {
+  if (length == 0) {
+    return;
+  }
+
+  // Read the pre-wrap bytes.
+  const size_t offset = BufferOffset(index);
+  size_t bytes_until_wrap = buffer_bytes_ - offset;
+  size_t bytes_to_copy = std::min(length, bytes_until_wrap);
+  memcpy(destination, buffer_ + offset, bytes_to_copy);
+
+  // Read the post-wrap bytes, if needed.
+  if (bytes_to_copy < length) {
+    memcpy(destination + bytes_to_copy, buffer_, length - bytes_to_copy);
+  }
+}
+
+}  // namespace ring_buffer
+}  // namespace pw
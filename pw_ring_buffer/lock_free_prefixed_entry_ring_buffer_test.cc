@@ -0,0 +1,262 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/lock_free_prefixed_entry_ring_buffer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using std::byte;
+
+namespace pw {
+namespace ring_buffer {
+namespace {
+
+TEST(LockFreePrefixedEntryRingBuffer, NoBuffer) {
+  LockFreePrefixedEntryRingBuffer ring;
+
+  byte data[8] = {};
+  size_t bytes_read = 1;
+  EXPECT_EQ(ring.TryPushBack(data), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PeekFront(data, &bytes_read), Status::FailedPrecondition());
+  EXPECT_EQ(bytes_read, 0u);
+  EXPECT_EQ(ring.PopFront(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 0u);
+
+  EXPECT_EQ(ring.SetBuffer(std::span<byte>()), Status::InvalidArgument());
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, PushPeekPop) {
+  std::array<byte, 16> buffer;
+  LockFreePrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  byte read_buffer[8];
+  size_t bytes_read = 0;
+  EXPECT_EQ(ring.PeekFront(read_buffer, &bytes_read), Status::OutOfRange());
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+
+  constexpr byte kEntry[] = {byte{1}, byte{2}, byte{3}};
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 1u + sizeof(kEntry));
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntry));
+
+  ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, sizeof(kEntry));
+  EXPECT_EQ(std::memcmp(read_buffer, kEntry, sizeof(kEntry)), 0);
+
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, UserPreamble) {
+  std::array<byte, 16> buffer;
+  LockFreePrefixedEntryRingBuffer ring(/*user_preamble=*/true);
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr byte kEntry[] = {byte{0xab}};
+  ASSERT_EQ(ring.TryPushBack(kEntry, 300), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 2u + 1u + sizeof(kEntry));
+
+  uint32_t preamble = 0;
+  ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+  EXPECT_EQ(preamble, 300u);
+
+  byte read_buffer[4];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, 1u);
+  EXPECT_EQ(read_buffer[0], byte{0xab});
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, FullBufferRejectsPushes) {
+  std::array<byte, 10> buffer;
+  LockFreePrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr byte kEntry[4] = {};
+  EXPECT_EQ(ring.TryPushBack(std::span(buffer)), Status::OutOfRange());
+
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), buffer.size());
+
+  // Older entries are never dropped to make space.
+  EXPECT_EQ(ring.TryPushBack(kEntry), Status::ResourceExhausted());
+  EXPECT_EQ(ring.TryPushBack(std::span<const byte>()),
+            Status::ResourceExhausted());
+
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TryPushBack(kEntry), OkStatus());
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, SmallDestination) {
+  std::array<byte, 16> buffer;
+  LockFreePrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr byte kEntry[] = {byte{1}, byte{2}, byte{3}};
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+
+  byte read_buffer[2];
+  size_t bytes_read = 0;
+  EXPECT_EQ(ring.PeekFront(read_buffer, &bytes_read),
+            Status::ResourceExhausted());
+  ASSERT_EQ(bytes_read, 2u);
+  EXPECT_EQ(std::memcmp(read_buffer, kEntry, 2), 0);
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, EntriesWrapAroundBuffer) {
+  // An odd buffer size, so that entries wrap at every position.
+  std::array<byte, 23> buffer;
+  LockFreePrefixedEntryRingBuffer ring(/*user_preamble=*/true);
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  uint32_t next_push = 0;
+  uint32_t next_pop = 0;
+  for (int iteration = 0; iteration < 500; ++iteration) {
+    // Fill the buffer with entries of a few different sizes.
+    while (true) {
+      std::array<byte, 7> entry;
+      const size_t size = next_push % entry.size();
+      entry.fill(static_cast<byte>(next_push));
+      const Status status =
+          ring.TryPushBack(std::span(entry).first(size), next_push);
+      if (status == Status::ResourceExhausted()) {
+        break;
+      }
+      ASSERT_EQ(status, OkStatus());
+      next_push += 1;
+    }
+
+    // Drain one or two entries, checking their contents. At least two of the
+    // largest entries always fit.
+    for (int pops = 0; pops < 1 + iteration % 2; ++pops) {
+      uint32_t preamble = 0;
+      ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+      ASSERT_EQ(preamble, next_pop);
+
+      byte read_buffer[8];
+      size_t bytes_read = 0;
+      ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+      ASSERT_EQ(bytes_read, next_pop % 7);
+      for (size_t i = 0; i < bytes_read; ++i) {
+        ASSERT_EQ(read_buffer[i], static_cast<byte>(next_pop));
+      }
+
+      ASSERT_EQ(ring.PopFront(), OkStatus());
+      next_pop += 1;
+    }
+  }
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, ReserveCommit) {
+  std::array<byte, 32> buffer;
+  LockFreePrefixedEntryRingBuffer ring(/*user_preamble=*/true);
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  // Reserve more space than is used, so the length varint is padded.
+  Result<LockFreePrefixedEntryRingBuffer::ReservedEntry> entry =
+      ring.TryReserve(200, 7);
+  EXPECT_EQ(entry.status(), Status::OutOfRange());
+  entry = ring.TryReserve(20, 7);
+  ASSERT_EQ(entry.status(), OkStatus());
+  ASSERT_EQ(entry->first.size(), 20u);
+  EXPECT_TRUE(entry->second.empty());
+
+  // The entry is not visible to the consumer until it is committed.
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.TryReserve(1).status(), Status::FailedPrecondition());
+  constexpr byte kOther[] = {byte{9}};
+  EXPECT_EQ(ring.TryPushBack(kOther), Status::FailedPrecondition());
+
+  const byte kData[] = {byte{1}, byte{2}, byte{3}};
+  std::memcpy(entry->first.data(), kData, sizeof(kData));
+  EXPECT_EQ(ring.Commit(21), Status::InvalidArgument());
+  ASSERT_EQ(ring.Commit(sizeof(kData)), OkStatus());
+  EXPECT_EQ(ring.Commit(0), Status::FailedPrecondition());
+
+  uint32_t preamble = 0;
+  ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+  EXPECT_EQ(preamble, 7u);
+  byte read_buffer[8];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, sizeof(kData));
+  EXPECT_EQ(std::memcmp(read_buffer, kData, sizeof(kData)), 0);
+
+  // Cancelled reservations leave the buffer unchanged.
+  ASSERT_EQ(ring.TryReserve(4).status(), OkStatus());
+  ring.CancelReservation();
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, ReserveSplitsAtWrap) {
+  std::array<byte, 10> buffer;
+  LockFreePrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  // Move the write index near the end of the buffer.
+  constexpr byte kEntry[6] = {};
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.TryReserve(5).status(), Status::ResourceExhausted());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  // One byte of preamble, then two bytes at the end and three at the start.
+  Result<LockFreePrefixedEntryRingBuffer::ReservedEntry> entry =
+      ring.TryReserve(5);
+  ASSERT_EQ(entry.status(), OkStatus());
+  ASSERT_EQ(entry->first.size(), 2u);
+  ASSERT_EQ(entry->second.size(), 3u);
+  EXPECT_EQ(entry->size(), 5u);
+  EXPECT_EQ(entry->second.data(), buffer.data());
+
+  const byte kData[] = {byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
+  std::memcpy(entry->first.data(), kData, 2);
+  std::memcpy(entry->second.data(), kData + 2, 3);
+  ASSERT_EQ(ring.Commit(5), OkStatus());
+
+  byte read_buffer[8];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, 5u);
+  EXPECT_EQ(std::memcmp(read_buffer, kData, 5), 0);
+}
+
+TEST(LockFreePrefixedEntryRingBuffer, Clear) {
+  std::array<byte, 16> buffer;
+  LockFreePrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr byte kEntry[] = {byte{1}, byte{2}};
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+
+  ring.Clear();
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntry));
+}
+
+}  // namespace
+}  // namespace ring_buffer
+}  // namespace pw
@@ -32,9 +32,11 @@ using iterator = PrefixedEntryRingBufferMulti::iterator;
 
 void PrefixedEntryRingBufferMulti::Clear() {
   write_idx_ = 0;
+  write_entry_ = 0;
+  reserved_ = false;
   for (Reader& reader : readers_) {
     reader.read_idx_ = 0;
-    reader.entry_count_ = 0;
+    reader.read_entry_ = 0;
   }
 }
 
@@ -60,11 +62,13 @@ Status PrefixedEntryRingBufferMulti::AttachReader(Reader& reader) {
 
   if (readers_.empty()) {
     reader.read_idx_ = write_idx_;
-    reader.entry_count_ = 0;
+    reader.read_entry_ = write_entry_;
+    slowest_reader_ = &reader;
   } else {
+    // The new reader ties with the slowest reader, so the cache stays valid.
     const Reader& slowest_reader = GetSlowestReader();
     reader.read_idx_ = slowest_reader.read_idx_;
-    reader.entry_count_ = slowest_reader.entry_count_;
+    reader.read_entry_ = slowest_reader.read_entry_;
   }
 
   readers_.push_back(reader);
@@ -77,8 +81,11 @@ Status PrefixedEntryRingBufferMulti::DetachReader(Reader& reader) {
   }
   reader.buffer_ = nullptr;
   reader.read_idx_ = 0;
-  reader.entry_count_ = 0;
+  reader.read_entry_ = 0;
   readers_.remove(reader);
+  if (slowest_reader_ == &reader) {
+    slowest_reader_ = nullptr;
+  }
   return OkStatus();
 }
 
@@ -86,51 +93,138 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     std::span<const byte> data,
     uint32_t user_preamble_data,
     bool pop_front_if_needed) {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || reserved_) {
     return Status::FailedPrecondition();
   }
 
   // Prepare a single buffer that can hold both the user preamble and entry
   // length.
   byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
-  size_t user_preamble_bytes = 0;
-  if (user_preamble_) {
-    user_preamble_bytes =
-        varint::Encode<uint32_t>(user_preamble_data, preamble_buf);
-  }
-  size_t length_bytes = varint::Encode<uint32_t>(
-      data.size_bytes(), std::span(preamble_buf).subspan(user_preamble_bytes));
-  size_t total_write_bytes =
-      user_preamble_bytes + length_bytes + data.size_bytes();
+  const size_t preamble_bytes =
+      EncodePreamble(user_preamble_data, data.size_bytes(), 0, preamble_buf);
+  size_t total_write_bytes = preamble_bytes + data.size_bytes();
   if (buffer_bytes_ < total_write_bytes) {
     return Status::OutOfRange();
   }
 
+  PW_TRY(MakeSpace(total_write_bytes, pop_front_if_needed));
+
+  // Write the new entry into the ring buffer.
+  RawWrite(std::span(preamble_buf, preamble_bytes));
+  RawWrite(data);
+
+  // Readers' entry counts are relative to write_entry_.
+  write_entry_++;
+  return OkStatus();
+}
+
+Result<PrefixedEntryRingBufferMulti::ReservedEntry>
+PrefixedEntryRingBufferMulti::InternalReserve(size_t max_data_bytes,
+                                              uint32_t user_preamble_data,
+                                              bool pop_front_if_needed) {
+  if (buffer_ == nullptr || reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (buffer_bytes_ < max_data_bytes) {
+    return Status::OutOfRange();
+  }
+
+  // The preamble is written by Commit(), once the data size is known. Its
+  // length varint is padded to the size needed for max_data_bytes, so the
+  // data's position does not depend on its final size.
+  const size_t user_preamble_bytes =
+      user_preamble_ ? varint::EncodedSize(user_preamble_data) : 0;
+  const size_t length_bytes = varint::EncodedSize(max_data_bytes);
+  const size_t preamble_bytes = user_preamble_bytes + length_bytes;
+  if (buffer_bytes_ - max_data_bytes < preamble_bytes) {
+    return Status::OutOfRange();
+  }
+
+  PW_TRY(MakeSpace(preamble_bytes + max_data_bytes, pop_front_if_needed));
+
+  reserved_ = true;
+  reserved_user_preamble_ = user_preamble_data;
+  reserved_length_bytes_ = length_bytes;
+  reserved_data_bytes_ = max_data_bytes;
+
+  // Split the data region at the end of the buffer.
+  const size_t data_idx = IncrementIndex(write_idx_, preamble_bytes);
+  const size_t bytes_until_wrap = buffer_bytes_ - data_idx;
+  const size_t first_bytes = std::min(max_data_bytes, bytes_until_wrap);
+  return ReservedEntry{
+      .first = std::span(buffer_ + data_idx, first_bytes),
+      .second = std::span(buffer_, max_data_bytes - first_bytes),
+  };
+}
+
+Status PrefixedEntryRingBufferMulti::Commit(size_t data_bytes) {
+  if (!reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (data_bytes > reserved_data_bytes_) {
+    return Status::InvalidArgument();
+  }
+
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t preamble_bytes = EncodePreamble(reserved_user_preamble_,
+                                               data_bytes,
+                                               reserved_length_bytes_,
+                                               preamble_buf);
+
+  // The data was already written by the producer directly after the preamble.
+  RawWrite(std::span(preamble_buf, preamble_bytes));
+  write_idx_ = IncrementIndex(write_idx_, data_bytes);
+  reserved_ = false;
+
+  // Readers' entry counts are relative to write_entry_.
+  write_entry_++;
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::MakeSpace(size_t bytes,
+                                               bool pop_front_if_needed) {
   if (pop_front_if_needed) {
     // PushBack() case: evict items as needed.
     // Drop old entries until we have space for the new entry.
-    while (RawAvailableBytes() < total_write_bytes) {
+    while (RawAvailableBytes() < bytes) {
       InternalPopFrontAll();
     }
-  } else if (RawAvailableBytes() < total_write_bytes) {
+  } else if (RawAvailableBytes() < bytes) {
     // TryPushBack() case: don't evict items.
     return Status::ResourceExhausted();
   }
+  return OkStatus();
+}
 
-  // Write the new entry into the ring buffer.
-  RawWrite(std::span(preamble_buf, user_preamble_bytes + length_bytes));
-  RawWrite(data);
+size_t PrefixedEntryRingBufferMulti::EncodePreamble(
+    uint32_t user_preamble_data,
+    size_t data_bytes,
+    size_t min_length_bytes,
+    std::span<byte> buffer) const {
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes = varint::Encode<uint32_t>(user_preamble_data, buffer);
+  }
 
-  // Update all readers of the new count.
-  for (Reader& reader : readers_) {
-    reader.entry_count_++;
+  std::span<byte> length = buffer.subspan(user_preamble_bytes);
+  size_t length_bytes = varint::Encode<uint32_t>(data_bytes, length);
+
+  // Pad the length with continuation bytes, which varint decoding accepts.
+  if (length_bytes < min_length_bytes) {
+    length[length_bytes - 1] |= byte{0x80};
+    for (; length_bytes < min_length_bytes - 1; ++length_bytes) {
+      length[length_bytes] = byte{0x80};
+    }
+    length[length_bytes++] = byte{0x00};
   }
-  return OkStatus();
+  return user_preamble_bytes + length_bytes;
 }
 
 auto GetOutput(std::span<byte> data_out, size_t* write_index) {
   return [data_out, write_index](std::span<const byte> src) -> Status {
-    size_t copy_size = std::min(data_out.size_bytes(), src.size_bytes());
+    // Only copy into the space left after earlier chunks of a wrapped entry.
+    size_t copy_size =
+        std::min(data_out.size_bytes() - *write_index, src.size_bytes());
 
     memcpy(data_out.data() + *write_index, src.data(), copy_size);
     *write_index += copy_size;
@@ -164,7 +258,7 @@ Status PrefixedEntryRingBufferMulti::InternalPeekFrontWithPreamble(
 
 Status PrefixedEntryRingBufferMulti::InternalPeekFrontPreamble(
     const Reader& reader, uint32_t& user_preamble_out) const {
-  if (reader.entry_count_ == 0) {
+  if (reader.EntryCount() == 0) {
     return Status::OutOfRange();
   }
   // Figure out where to start reading (wrapped); accounting for preamble.
@@ -185,7 +279,7 @@ Status PrefixedEntryRingBufferMulti::InternalRead(
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
-  if (reader.entry_count_ == 0) {
+  if (reader.EntryCount() == 0) {
     return Status::OutOfRange();
   }
 
@@ -222,30 +316,42 @@ void PrefixedEntryRingBufferMulti::InternalPopFrontAll() {
   // It is expected that InternalPopFrontAll is called only when there is
   // something to pop from at least one reader. If no readers exist, or all
   // readers are caught up, this function will assert.
-  size_t entry_count = GetSlowestReader().entry_count_;
+  size_t entry_count = GetSlowestReader().EntryCount();
   PW_DCHECK_INT_NE(entry_count, 0);
-  // Otherwise, pop the readers that have the largest value.
+  // Otherwise, pop the readers that have the largest value. Find the new
+  // slowest reader in the same pass.
+  const Reader* new_slowest_reader = nullptr;
   for (Reader& reader : readers_) {
-    if (reader.entry_count_ == entry_count) {
+    if (reader.EntryCount() == entry_count) {
       reader.PopFront()
           .IgnoreError();  // TODO(pwbug/387): Handle Status properly
     }
+    if (new_slowest_reader == nullptr ||
+        reader.EntryCount() > new_slowest_reader->EntryCount()) {
+      new_slowest_reader = &reader;
+    }
   }
+  slowest_reader_ = new_slowest_reader;
 }
 
 const Reader& PrefixedEntryRingBufferMulti::GetSlowestReader() const {
   PW_DCHECK_INT_GT(readers_.size(), 0);
+  if (slowest_reader_ != nullptr) {
+    return *slowest_reader_;
+  }
+
   const Reader* slowest_reader = &(*readers_.begin());
   for (const Reader& reader : readers_) {
-    if (reader.entry_count_ > slowest_reader->entry_count_) {
+    if (reader.EntryCount() > slowest_reader->EntryCount()) {
       slowest_reader = &reader;
     }
   }
+  slowest_reader_ = slowest_reader;
   return *slowest_reader;
 }
 
 Status PrefixedEntryRingBufferMulti::Dering() {
-  if (buffer_ == nullptr || readers_.empty()) {
+  if (buffer_ == nullptr || readers_.empty() || reserved_) {
     return Status::FailedPrecondition();
   }
 
@@ -263,6 +369,10 @@ Status PrefixedEntryRingBufferMulti::InternalDering(Reader& dering_reader) {
     return Status::FailedPrecondition();
   }
 
+  // Moving the data invalidates the reserved region. The iterator derings the
+  // buffer, so this may happen from a crash context during a reservation.
+  reserved_ = false;
+
   auto buffer_span = std::span(buffer_, buffer_bytes_);
   std::rotate(buffer_span.begin(),
               buffer_span.begin() + dering_reader.read_idx_,
@@ -293,7 +403,7 @@ Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
-  if (reader.entry_count_ == 0) {
+  if (reader.EntryCount() == 0) {
     return Status::OutOfRange();
   }
 
@@ -302,13 +412,18 @@ Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   size_t entry_bytes = info.preamble_bytes + info.data_bytes;
   size_t prev_read_idx = reader.read_idx_;
   reader.read_idx_ = IncrementIndex(prev_read_idx, entry_bytes);
-  reader.entry_count_--;
+  reader.read_entry_++;
+
+  // Another reader may now be the slowest.
+  if (slowest_reader_ == &reader) {
+    slowest_reader_ = nullptr;
+  }
   return OkStatus();
 }
 
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
     const Reader& reader) const {
-  if (reader.entry_count_ == 0) {
+  if (reader.EntryCount() == 0) {
     return 0;
   }
   return FrontEntryInfo(reader).data_bytes;
@@ -316,13 +431,27 @@ size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
 
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryTotalSizeBytes(
     const Reader& reader) const {
-  if (reader.entry_count_ == 0) {
+  if (reader.EntryCount() == 0) {
     return 0;
   }
   EntryInfo info = FrontEntryInfo(reader);
   return info.preamble_bytes + info.data_bytes;
 }
 
+size_t PrefixedEntryRingBufferMulti::InternalEntriesSize(
+    const Reader& reader) const {
+  // Case: Not wrapped.
+  if (reader.read_idx_ < write_idx_) {
+    return write_idx_ - reader.read_idx_;
+  }
+  // Case: Wrapped.
+  if (reader.read_idx_ > write_idx_) {
+    return buffer_bytes_ - (reader.read_idx_ - write_idx_);
+  }
+  // Case: Matched read and write heads; empty or full.
+  return reader.EntryCount() != 0 ? buffer_bytes_ : 0;
+}
+
 PrefixedEntryRingBufferMulti::EntryInfo
 PrefixedEntryRingBufferMulti::FrontEntryInfo(const Reader& reader) const {
   Result<PrefixedEntryRingBufferMulti::EntryInfo> entry_info =
@@ -373,7 +502,8 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
     return buffer_bytes_;
   }
 
-  size_t read_idx = GetSlowestReader().read_idx_;
+  const Reader& slowest_reader = GetSlowestReader();
+  size_t read_idx = slowest_reader.read_idx_;
   // Case: Not wrapped.
   if (read_idx < write_idx_) {
     return buffer_bytes_ - (write_idx_ - read_idx);
@@ -382,13 +512,9 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
   if (read_idx > write_idx_) {
     return read_idx - write_idx_;
   }
-  // Case: Matched read and write heads; empty or full.
-  for (const Reader& reader : readers_) {
-    if (reader.read_idx_ == read_idx && reader.entry_count_ != 0) {
-      return 0;
-    }
-  }
-  return buffer_bytes_;
+  // Case: Matched read and write heads; empty or full. The buffer is full if
+  // any reader has entries, in which case the slowest reader does.
+  return slowest_reader.EntryCount() != 0 ? 0 : buffer_bytes_;
 }
 
 void PrefixedEntryRingBufferMulti::RawWrite(std::span<const std::byte> source) {
@@ -16,6 +16,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_containers/vector.h"
@@ -886,6 +887,198 @@ TEST(PrefixedEntryRingBufferMulti, IteratorBufferCorruption) {
   EXPECT_EQ(validated_entries, valid_entries);
 }
 
+TEST(PrefixedEntryRingBufferMulti, TracksSlowestReader) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[8];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast, medium, slow;
+  ASSERT_EQ(ring.AttachReader(fast), OkStatus());
+  ASSERT_EQ(ring.AttachReader(medium), OkStatus());
+  ASSERT_EQ(ring.AttachReader(slow), OkStatus());
+
+  // Each entry takes two bytes, so the buffer holds four.
+  constexpr byte kEntry[] = {byte{0}};
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  }
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  ASSERT_EQ(medium.PopFront(), OkStatus());
+
+  // The slowest reader is pushed forward for each new entry.
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  EXPECT_EQ(slow.EntryCount(), 4u);
+  EXPECT_EQ(medium.EntryCount(), 4u);
+  EXPECT_EQ(fast.EntryCount(), 3u);
+
+  // After the slow reader catches up, space freed by the others is used.
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(slow.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(ring.TryPushBack(kEntry), Status::ResourceExhausted());
+  ASSERT_EQ(medium.PopFront(), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(medium.EntryCount(), 4u);
+  EXPECT_EQ(fast.EntryCount(), 4u);
+  EXPECT_EQ(slow.EntryCount(), 1u);
+
+  // Detaching the slowest reader frees the space only it was holding.
+  EXPECT_EQ(ring.TryPushBack(kEntry), Status::ResourceExhausted());
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  ASSERT_EQ(ring.DetachReader(medium), OkStatus());
+  EXPECT_EQ(medium.EntryCount(), 0u);
+  ASSERT_EQ(ring.TryPushBack(kEntry), OkStatus());
+  EXPECT_EQ(fast.EntryCount(), 4u);
+  EXPECT_EQ(slow.EntryCount(), 2u);
+}
+
+TEST(PrefixedEntryRingBufferMulti, ReaderEntriesSize) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[8];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast, slow;
+  ASSERT_EQ(ring.AttachReader(fast), OkStatus());
+  ASSERT_EQ(ring.AttachReader(slow), OkStatus());
+  EXPECT_EQ(fast.EntriesSize(), 0u);
+
+  // Each entry takes three bytes.
+  constexpr byte kEntry[] = {byte{1}, byte{2}};
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  EXPECT_EQ(fast.EntriesSize(), 3u);
+  EXPECT_EQ(slow.EntriesSize(), 6u);
+
+  // The third entry wraps around the end of the buffer and evicts the slow
+  // reader's first entry.
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  EXPECT_EQ(fast.EntriesSize(), 6u);
+  EXPECT_EQ(slow.EntriesSize(), 6u);
+
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  ASSERT_EQ(fast.PopFront(), OkStatus());
+  EXPECT_EQ(fast.EntriesSize(), 0u);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveCommit) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[16];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Reserve more space than is used, so the length varint is padded.
+  Result<PrefixedEntryRingBuffer::ReservedEntry> entry = ring.Reserve(200, 7);
+  EXPECT_EQ(entry.status(), Status::OutOfRange());
+  entry = ring.Reserve(10, 7);
+  ASSERT_EQ(entry.status(), OkStatus());
+  ASSERT_EQ(entry->first.size(), 10u);
+  EXPECT_TRUE(entry->second.empty());
+
+  // Readers don't see the entry until it is committed.
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.PushBack(std::span(test_buffer, 1)),
+            Status::FailedPrecondition());
+  EXPECT_EQ(ring.Reserve(1).status(), Status::FailedPrecondition());
+
+  entry->first[0] = byte{0xaa};
+  entry->first[1] = byte{0xbb};
+  EXPECT_EQ(ring.Commit(11), Status::InvalidArgument());
+  ASSERT_EQ(ring.Commit(2), OkStatus());
+  EXPECT_EQ(ring.Commit(2), Status::FailedPrecondition());
+
+  ASSERT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 2u);
+  EXPECT_EQ(ring.FrontEntryTotalSizeBytes(), 1u + 1u + 2u);
+
+  byte entry_buffer[16];
+  uint32_t preamble = 0;
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFrontWithPreamble(entry_buffer, preamble, bytes_read),
+            OkStatus());
+  EXPECT_EQ(preamble, 7u);
+  ASSERT_EQ(bytes_read, 2u);
+  EXPECT_EQ(entry_buffer[0], byte{0xaa});
+  EXPECT_EQ(entry_buffer[1], byte{0xbb});
+
+  // The unused part of the reservation is released.
+  EXPECT_EQ(ring.TotalUsedBytes(), 4u);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveSplitsAtWrap) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Move the write index near the end of the buffer.
+  constexpr byte kEntry[6] = {};
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  // One byte of preamble, then two bytes at the end and three at the start.
+  Result<PrefixedEntryRingBuffer::ReservedEntry> entry = ring.TryReserve(5);
+  ASSERT_EQ(entry.status(), OkStatus());
+  ASSERT_EQ(entry->first.size(), 2u);
+  ASSERT_EQ(entry->second.size(), 3u);
+  EXPECT_EQ(entry->size(), 5u);
+  EXPECT_EQ(entry->second.data(), test_buffer);
+
+  const byte kData[] = {byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
+  std::memcpy(entry->first.data(), kData, 2);
+  std::memcpy(entry->second.data(), kData + 2, 3);
+  ASSERT_EQ(ring.Commit(5), OkStatus());
+
+  byte entry_buffer[8];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(entry_buffer, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, 5u);
+  EXPECT_EQ(std::memcmp(entry_buffer, kData, 5), 0);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontPartiallyCopiesWrappedEntry) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Move the write index near the end of the buffer, so the next entry wraps
+  // with two bytes at the end and three at the start.
+  constexpr byte kEntry[6] = {};
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  const byte kData[] = {byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+
+  // Only the first three bytes fit; the byte after them must be untouched.
+  byte entry_buffer[4] = {byte{0}, byte{0}, byte{0}, byte{0xff}};
+  size_t bytes_read = 0;
+  EXPECT_EQ(ring.PeekFront(std::span(entry_buffer).first(3), &bytes_read),
+            Status::ResourceExhausted());
+  ASSERT_EQ(bytes_read, 3u);
+  EXPECT_EQ(std::memcmp(entry_buffer, kData, 3), 0);
+  EXPECT_EQ(entry_buffer[3], byte{0xff});
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveMakesSpace) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  constexpr byte kEntry[3] = {};
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntry), OkStatus());
+
+  EXPECT_EQ(ring.TryReserve(4).status(), Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  ASSERT_EQ(ring.Reserve(4).status(), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+
+  ring.CancelReservation();
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(ring.PushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+}
+
 }  // namespace
 }  // namespace ring_buffer
 }  // namespace pw
@@ -0,0 +1,255 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace ring_buffer {
+
+// A ring buffer for arbitrary length data entries that one producer and one
+// consumer may use concurrently without a lock. Entries are stored in the same
+// format as PrefixedEntryRingBufferMulti: an optional varint user preamble, a
+// varint data size, then the data.
+//
+// The producer calls TryPushBack() or TryReserve() and Commit(), and the
+// consumer calls the Peek/Pop functions. The read and write indices are atomics
+// that only their owning side modifies, so neither side ever waits for the
+// other. This allows an interrupt handler or a high-priority thread to push
+// entries without taking a lock or disabling interrupts while a thread drains
+// them.
+//
+// Unlike PrefixedEntryRingBufferMulti, the producer never drops old entries to
+// make space, since the read index belongs to the consumer. Pushes fail when
+// the buffer is full. Multiple producers must serialize their pushes, for
+// example by only pushing from a single interrupt priority level.
+//
+// Requires atomic size_t loads and stores that are lock-free on the target.
+class LockFreePrefixedEntryRingBuffer {
+ public:
+  explicit constexpr LockFreePrefixedEntryRingBuffer(bool user_preamble = false)
+      : buffer_(nullptr),
+        buffer_bytes_(0),
+        user_preamble_(user_preamble),
+        reserved_(false),
+        reserved_user_preamble_(0),
+        reserved_length_bytes_(0),
+        reserved_data_bytes_(0),
+        write_idx_(0),
+        read_idx_(0) {}
+
+  LockFreePrefixedEntryRingBuffer(const LockFreePrefixedEntryRingBuffer&) =
+      delete;
+  LockFreePrefixedEntryRingBuffer& operator=(
+      const LockFreePrefixedEntryRingBuffer&) = delete;
+
+  // Set the raw buffer to be used by the ring buffer. Must not be called while
+  // the producer or consumer is using the ring buffer.
+  //
+  // Return values:
+  // OK - successfully set the raw buffer.
+  // INVALID_ARGUMENT - Argument was nullptr, size zero, or too large.
+  Status SetBuffer(std::span<std::byte> buffer);
+
+  // Producer API.
+
+  // Write a chunk of data to the ring buffer if there is space available.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry. It is only used if user_preamble was set at class construction
+  // time. It is varint-encoded before insertion into the buffer.
+  //
+  // Return values:
+  // OK - Data successfully written to the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized, or an entry is reserved.
+  // OUT_OF_RANGE - Size of data is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the data.
+  Status TryPushBack(std::span<const std::byte> data,
+                     uint32_t user_preamble_data = 0);
+
+  // The writable data region of an entry reserved with TryReserve(). The
+  // region is split in two if it wraps around the end of the buffer; `second`
+  // is empty otherwise.
+  struct ReservedEntry {
+    std::span<std::byte> first;
+    std::span<std::byte> second;
+
+    size_t size() const { return first.size() + second.size(); }
+  };
+
+  // Reserve space for an entry of up to max_data_bytes if there is space
+  // available, so that the producer can encode the entry's data directly into
+  // the ring buffer rather than into a separate buffer that is then copied by
+  // TryPushBack(). Neither the reservation nor Commit() takes a lock.
+  //
+  // The consumer does not see the entry until Commit() is called, and the
+  // producer may not push or reserve other entries until then.
+  //
+  // Return values:
+  // OK - The returned region may be written until Commit() is called.
+  // FAILED_PRECONDITION - Buffer not initialized, or an entry is already
+  // reserved.
+  // OUT_OF_RANGE - Size of the entry is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the entry.
+  Result<ReservedEntry> TryReserve(size_t max_data_bytes,
+                                   uint32_t user_preamble_data = 0);
+
+  // Publish the reserved entry to the consumer, with the first data_bytes of
+  // its reserved region as its data. The rest of the region is released.
+  //
+  // Return values:
+  // OK - The entry was added to the ring buffer.
+  // FAILED_PRECONDITION - No entry is reserved.
+  // INVALID_ARGUMENT - data_bytes is larger than the reserved size. The entry
+  // remains reserved.
+  Status Commit(size_t data_bytes);
+
+  // Release a reserved entry without adding it to the ring buffer.
+  void CancelReservation() { reserved_ = false; }
+
+  // Consumer API.
+
+  // Read the oldest stored data chunk of data from the ring buffer to the
+  // provided destination std::span. The number of bytes read is written to
+  // bytes_read_out.
+  //
+  // Precondition: the buffer data must not be corrupt, otherwise there will
+  // be a crash.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to read.
+  // RESOURCE_EXHAUSTED - Destination data std::span was smaller number of
+  // bytes than the data size of the data chunk being read.  Available
+  // destination bytes were filled, remaining bytes of the data chunk were
+  // ignored.
+  Status PeekFront(std::span<std::byte> data, size_t* bytes_read_out) const;
+
+  // Peek the front entry's preamble only to avoid copying data unnecessarily.
+  //
+  // Precondition: the buffer data must not be corrupt, otherwise there will
+  // be a crash.
+  Status PeekFrontPreamble(uint32_t& user_preamble_out) const;
+
+  // Pop and discard the oldest stored data chunk of data from the ring
+  // buffer, which frees its space for the producer.
+  //
+  // Precondition: the buffer data must not be corrupt, otherwise there will
+  // be a crash.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to pop.
+  Status PopFront();
+
+  // Get the size in bytes of the next chunk, not including preamble, to be
+  // read. Returns 0 if the ring buffer is empty.
+  //
+  // Precondition: the buffer data must not be corrupt, otherwise there will
+  // be a crash.
+  size_t FrontEntryDataSizeBytes() const;
+
+  // Discards all entries that have been pushed so far.
+  void Clear();
+
+  // Either side.
+
+  // Get the size in bytes of all the current entries in the ring buffer,
+  // including preamble and data chunk. The other side may change this as soon
+  // as it is returned.
+  size_t TotalUsedBytes() const {
+    return UsedBytes(read_idx_.load(std::memory_order_acquire),
+                     write_idx_.load(std::memory_order_acquire));
+  }
+
+ private:
+  struct EntryInfo {
+    size_t preamble_bytes;
+    uint32_t user_preamble;
+    size_t data_bytes;
+  };
+
+  // Get info struct with the size of the preamble and data chunk for the entry
+  // at the read index, and the read index itself.
+  //
+  // Returns:
+  // OK - EntryInfo containing the next entry metadata.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - The ring buffer is empty.
+  Result<EntryInfo> FrontEntryInfo(size_t& read_idx_out) const;
+
+  // Indices run from 0 to twice the buffer size, so that a full buffer can be
+  // told apart from an empty one without tracking the entry count.
+  size_t UsedBytes(size_t read_idx, size_t write_idx) const {
+    return write_idx >= read_idx ? write_idx - read_idx
+                                 : write_idx + 2 * buffer_bytes_ - read_idx;
+  }
+
+  size_t IncrementIndex(size_t index, size_t count) const {
+    index += count;
+    if (index >= 2 * buffer_bytes_) {
+      index -= 2 * buffer_bytes_;
+    }
+    return index;
+  }
+
+  size_t BufferOffset(size_t index) const {
+    return index >= buffer_bytes_ ? index - buffer_bytes_ : index;
+  }
+
+  // Encodes the user preamble, if enabled, and the data size into the buffer.
+  // Returns the number of bytes used. The data size is padded to
+  // min_length_bytes with non-minimal varint encoding.
+  size_t EncodePreamble(uint32_t user_preamble_data,
+                        size_t data_bytes,
+                        size_t min_length_bytes,
+                        std::span<std::byte> buffer) const;
+
+  // Copy bytes to and from the ring buffer at an index, handling wrap-around.
+  void RawWrite(size_t index, std::span<const std::byte> source);
+  void RawRead(std::byte* destination, size_t index, size_t length) const;
+
+  std::byte* buffer_;
+  size_t buffer_bytes_;
+  const bool user_preamble_;
+
+  // The entry reserved by TryReserve(), which starts at write_idx_. Only the
+  // producer uses these.
+  bool reserved_;
+  uint32_t reserved_user_preamble_;
+  size_t reserved_length_bytes_;
+  size_t reserved_data_bytes_;
+
+  // The producer owns write_idx_ and the consumer owns read_idx_. Each side
+  // publishes its index with a release store after it finishes with the data.
+  std::atomic<size_t> write_idx_;
+  std::atomic<size_t> read_idx_;
+
+  // Maximum buffer size allowed, so that indices up to twice the buffer size
+  // do not overflow.
+  static constexpr size_t kMaxBufferBytes =
+      std::numeric_limits<size_t>::max() / 2;
+};
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -61,7 +61,7 @@ class PrefixedEntryRingBufferMulti {
   // loss if they read slower than the writer.
   class Reader : public IntrusiveList<Reader>::Item {
    public:
-    constexpr Reader() : buffer_(nullptr), read_idx_(0), entry_count_(0) {}
+    constexpr Reader() : buffer_(nullptr), read_idx_(0), read_entry_(0) {}
 
     // TODO(pwbug/344): Add locking to the internal functions. Who owns the
     // lock? This class? Does this class need a lock if it's not a multi-reader?
@@ -151,7 +151,15 @@ class PrefixedEntryRingBufferMulti {
     //
     // Return value:
     // Entry count.
-    size_t EntryCount() const { return entry_count_; }
+    size_t EntryCount() const {
+      return buffer_ == nullptr ? 0 : buffer_->write_entry_ - read_entry_;
+    }
+
+    // Get the size in bytes of all the entries this reader has not read yet,
+    // including their preambles.
+    size_t EntriesSize() const {
+      return buffer_ == nullptr ? 0 : buffer_->InternalEntriesSize(*this);
+    }
 
    private:
     friend PrefixedEntryRingBufferMulti;
@@ -160,15 +168,19 @@ class PrefixedEntryRingBufferMulti {
     // at specific positions. Readers constructed through this interface cannot
     // be attached/detached from the multisink.
     constexpr Reader(Reader& reader)
-        : Reader(reader.buffer_, reader.read_idx_, reader.entry_count_) {}
+        : Reader(reader.buffer_, reader.read_idx_, reader.read_entry_) {}
     constexpr Reader(PrefixedEntryRingBufferMulti* buffer,
                      size_t read_idx,
-                     size_t entry_count)
-        : buffer_(buffer), read_idx_(read_idx), entry_count_(entry_count) {}
+                     size_t read_entry)
+        : buffer_(buffer), read_idx_(read_idx), read_entry_(read_entry) {}
 
     PrefixedEntryRingBufferMulti* buffer_;
     size_t read_idx_;
-    size_t entry_count_;
+
+    // The number of entries pushed to the buffer before the entry at
+    // read_idx_. The entry count is the difference from the buffer's
+    // write_entry_, so pushes do not need to update every reader.
+    size_t read_entry_;
   };
 
   // An entry returned by the iterator containing the byte span of the entry
@@ -188,7 +200,7 @@ class PrefixedEntryRingBufferMulti {
     iterator(Reader& reader)
         : ring_buffer_(reader.buffer_),
           read_idx_(0),
-          entry_count_(reader.entry_count_) {
+          entry_count_(reader.EntryCount()) {
       Status dering_result = ring_buffer_->InternalDering(reader);
       PW_DASSERT(dering_result.ok());
     }
@@ -254,7 +266,13 @@ class PrefixedEntryRingBufferMulti {
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        user_preamble_(user_preamble) {}
+        write_entry_(0),
+        user_preamble_(user_preamble),
+        reserved_(false),
+        reserved_user_preamble_(0),
+        reserved_length_bytes_(0),
+        reserved_data_bytes_(0),
+        slowest_reader_(nullptr) {}
 
   // Set the raw buffer to be used by the ring buffer.
   //
@@ -348,6 +366,68 @@ class PrefixedEntryRingBufferMulti {
     return TryPushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // The writable data region of an entry reserved with Reserve(). The region
+  // is split in two if it wraps around the end of the buffer; `second` is
+  // empty otherwise.
+  struct ReservedEntry {
+    std::span<std::byte> first;
+    std::span<std::byte> second;
+
+    size_t size() const { return first.size() + second.size(); }
+  };
+
+  // Reserve space for an entry of up to max_data_bytes, so that a producer can
+  // encode the entry's data directly into the ring buffer rather than into a
+  // separate buffer that is then copied by PushBack(). If available space is
+  // less than the size of the entry then silently pop and discard oldest
+  // stored data chunks until space is available.
+  //
+  // The entry is added by Commit(). Until then, readers do not see the entry,
+  // and no other entries may be pushed or reserved. Dering() fails while an
+  // entry is reserved, and iterating over the buffer cancels the reservation.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry. It is only used if user_preamble was set at class construction
+  // time.
+  //
+  // Return values:
+  // OK - The returned region may be written until Commit() is called.
+  // FAILED_PRECONDITION - Buffer not initialized, or an entry is already
+  // reserved.
+  // OUT_OF_RANGE - Size of the entry is greater than buffer size.
+  Result<ReservedEntry> Reserve(size_t max_data_bytes,
+                                uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_data_bytes, user_preamble_data, true);
+  }
+
+  // Reserve space for an entry of up to max_data_bytes if there is space
+  // available. See Reserve().
+  //
+  // Return values:
+  // OK - The returned region may be written until Commit() is called.
+  // FAILED_PRECONDITION - Buffer not initialized, or an entry is already
+  // reserved.
+  // OUT_OF_RANGE - Size of the entry is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the entry
+  // without popping off existing elements.
+  Result<ReservedEntry> TryReserve(size_t max_data_bytes,
+                                   uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_data_bytes, user_preamble_data, false);
+  }
+
+  // Add the reserved entry to the ring buffer, with the first data_bytes of
+  // its reserved region as its data. The rest of the region is released.
+  //
+  // Return values:
+  // OK - The entry was added to the ring buffer.
+  // FAILED_PRECONDITION - No entry is reserved.
+  // INVALID_ARGUMENT - data_bytes is larger than the reserved size. The entry
+  // remains reserved.
+  Status Commit(size_t data_bytes);
+
+  // Release a reserved entry without adding it to the ring buffer.
+  void CancelReservation() { reserved_ = false; }
+
   // Get the size in bytes of all the current entries in the ring buffer,
   // including preamble and data chunk.
   size_t TotalUsedBytes() const { return buffer_bytes_ - RawAvailableBytes(); }
@@ -359,7 +439,7 @@ class PrefixedEntryRingBufferMulti {
   //
   // Return values:
   // OK - Buffer data successfully deringed.
-  // FAILED_PRECONDITION - Buffer not initialized.
+  // FAILED_PRECONDITION - Buffer not initialized, or an entry is reserved.
   Status Dering();
 
  private:
@@ -411,6 +491,9 @@ class PrefixedEntryRingBufferMulti {
   // chunk, to be read.
   size_t InternalFrontEntryTotalSizeBytes(const Reader& reader) const;
 
+  // Get the size in bytes of the entries the reader has not read yet.
+  size_t InternalEntriesSize(const Reader& reader) const;
+
   // Internal version of Read used by all the public interface versions. T
   // should be of type ReadOutput.
   template <typename T>
@@ -441,6 +524,25 @@ class PrefixedEntryRingBufferMulti {
                           uint32_t user_preamble_data,
                           bool pop_front_if_needed);
 
+  // Reserve implementation, which optionally discards front elements to fit
+  // the reserved element.
+  Result<ReservedEntry> InternalReserve(size_t max_data_bytes,
+                                        uint32_t user_preamble_data,
+                                        bool pop_front_if_needed);
+
+  // Pops entries from all readers until there are at least `bytes` bytes
+  // available, or returns RESOURCE_EXHAUSTED if pop_front_if_needed is false
+  // and there is not enough space.
+  Status MakeSpace(size_t bytes, bool pop_front_if_needed);
+
+  // Encodes the user preamble, if enabled, and the data size into the buffer.
+  // Returns the number of bytes used. The data size is padded to
+  // min_length_bytes with non-minimal varint encoding.
+  size_t EncodePreamble(uint32_t user_preamble_data,
+                        size_t data_bytes,
+                        size_t min_length_bytes,
+                        std::span<std::byte> buffer) const;
+
   // Internal function to pop all of the slowest readers. This function may pop
   // multiple readers if multiple are slow.
   //
@@ -449,7 +551,8 @@ class PrefixedEntryRingBufferMulti {
   // corrupted.
   void InternalPopFrontAll();
 
-  // Returns a the slowest reader in the list.
+  // Returns a the slowest reader in the list. The slowest reader is cached,
+  // and only found again after it pops an entry or is detached.
   //
   // Precondition: This function requires that at least one reader is attached.
   const Reader& GetSlowestReader() const;
@@ -495,11 +598,25 @@ class PrefixedEntryRingBufferMulti {
   size_t buffer_bytes_;
 
   size_t write_idx_;
+
+  // The number of entries pushed since the buffer was cleared. This wraps
+  // around, which is fine since only differences from it are used.
+  size_t write_entry_;
+
   const bool user_preamble_;
 
+  // The entry reserved by Reserve(), which starts at write_idx_.
+  bool reserved_;
+  uint32_t reserved_user_preamble_;
+  size_t reserved_length_bytes_;
+  size_t reserved_data_bytes_;
+
   // List of attached readers.
   IntrusiveList<Reader> readers_;
 
+  // The reader with the most entries, or nullptr if it must be found again.
+  mutable const Reader* slowest_reader_;
+
   // Maximum bufer size allowed. Restricted to this to allow index aliasing to
   // not overflow.
   static constexpr size_t kMaxBufferBytes =
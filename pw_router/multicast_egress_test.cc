@@ -0,0 +1,145 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/multicast_egress.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_router/static_router.h"
+
+namespace pw::router {
+namespace {
+
+class TestParser : public PacketParser {
+ public:
+  bool Parse(ConstByteSpan packet) final {
+    address_ = packet.empty() ? std::nullopt
+                              : std::optional(static_cast<uint32_t>(packet[0]));
+    return true;
+  }
+
+  std::optional<uint32_t> GetDestinationAddress() const final {
+    return address_;
+  }
+
+ private:
+  std::optional<uint32_t> address_;
+};
+
+// An egress that holds on to shared packets, as if transmitting them later.
+class HoldingEgress : public Egress {
+ public:
+  HoldingEgress(Status status = OkStatus()) : status_(status), sends_(0) {}
+
+  Status SendPacket(ConstByteSpan packet, const PacketParser&) final {
+    last_data_ = packet;
+    sends_ += 1;
+    return status_;
+  }
+
+  Status SendSharedPacket(SharedPacket packet, const PacketParser&) final {
+    last_data_ = packet.data();
+    held_ = std::move(packet);
+    sends_ += 1;
+    return status_;
+  }
+
+  // Completes the transmit of the held packet.
+  void Release() { held_.reset(); }
+
+  ConstByteSpan last_data() const { return last_data_; }
+  int sends() const { return sends_; }
+
+ private:
+  Status status_;
+  int sends_;
+  ConstByteSpan last_data_;
+  SharedPacket held_;
+};
+
+constexpr std::byte kPacket[] = {std::byte{1}, std::byte{0xab}};
+
+TEST(MulticastEgress, SendPacket_SendsToEachEgress) {
+  HoldingEgress a, b;
+  std::array<Egress*, 2> egresses = {&a, &b};
+  MulticastEgress multicast(egresses);
+  TestParser parser;
+
+  EXPECT_EQ(OkStatus(), multicast.SendPacket(kPacket, parser));
+  EXPECT_EQ(a.last_data().data(), kPacket);
+  EXPECT_EQ(b.last_data().data(), kPacket);
+}
+
+TEST(MulticastEgress, SendSharedPacket_SharesBufferWithoutCopies) {
+  SharedPacketPoolWithBuffer<1, 8> pool;
+  HoldingEgress a, b, c;
+  std::array<Egress*, 3> egresses = {&a, &b, &c};
+  MulticastEgress multicast(egresses);
+  TestParser parser;
+
+  SharedPacket packet = pool.Store(kPacket);
+  const std::byte* const data = packet.data().data();
+  EXPECT_EQ(OkStatus(), multicast.SendSharedPacket(std::move(packet), parser));
+
+  EXPECT_EQ(a.last_data().data(), data);
+  EXPECT_EQ(b.last_data().data(), data);
+  EXPECT_EQ(c.last_data().data(), data);
+
+  // The buffer is released when the last egress finishes with it.
+  a.Release();
+  c.Release();
+  EXPECT_FALSE(pool.Store(kPacket));
+  b.Release();
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+TEST(MulticastEgress, SendsToAllAndReturnsFirstError) {
+  HoldingEgress a, b(Status::Unavailable()), c(Status::ResourceExhausted());
+  std::array<Egress*, 3> egresses = {&a, &b, &c};
+  MulticastEgress multicast(egresses);
+  TestParser parser;
+
+  EXPECT_EQ(Status::Unavailable(), multicast.SendPacket(kPacket, parser));
+  EXPECT_EQ(a.sends(), 1);
+  EXPECT_EQ(b.sends(), 1);
+  EXPECT_EQ(c.sends(), 1);
+}
+
+TEST(MulticastEgress, StaticRouter_RoutesSharedPacket) {
+  SharedPacketPoolWithBuffer<1, 8> pool;
+  HoldingEgress a, b;
+  std::array<Egress*, 2> egresses = {&a, &b};
+  MulticastEgress multicast(egresses);
+  HoldingEgress other;
+  const StaticRouter::Route routes[] = {{1, multicast}, {2, other}};
+  StaticRouter router(routes);
+  TestParser parser;
+
+  SharedPacket packet = pool.Store(kPacket);
+  const std::byte* const data = packet.data().data();
+  EXPECT_EQ(OkStatus(), router.RoutePacket(std::move(packet), parser));
+  EXPECT_EQ(a.last_data().data(), data);
+  EXPECT_EQ(b.last_data().data(), data);
+  EXPECT_EQ(other.sends(), 0);
+
+  a.Release();
+  b.Release();
+  packet = pool.Store(std::array{std::byte{3}});
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(std::move(packet), parser));
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+}  // namespace
+}  // namespace pw::router
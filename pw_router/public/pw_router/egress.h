@@ -18,6 +18,7 @@
 
 #include "pw_bytes/span.h"
 #include "pw_router/packet_parser.h"
+#include "pw_router/shared_packet.h"
 #include "pw_status/status.h"
 
 namespace pw::router {
@@ -34,6 +35,18 @@ class Egress {
   // TODO(frolv): Document possible return values.
   virtual Status SendPacket(ConstByteSpan packet,
                             const PacketParser& parser) = 0;
+
+  // Sends a packet stored in a SharedPacketPool. An egress that transmits
+  // asynchronously can override this to keep the SharedPacket until the
+  // transmit completes instead of copying the data, so that sending a packet
+  // through several egresses does not copy it for each one. The parser is only
+  // valid during this call.
+  //
+  // By default, calls SendPacket() with the packet's data.
+  virtual Status SendSharedPacket(SharedPacket packet,
+                                  const PacketParser& parser) {
+    return SendPacket(packet.data(), parser);
+  }
 };
 
 }  // namespace pw::router
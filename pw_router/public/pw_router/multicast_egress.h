@@ -0,0 +1,54 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <span>
+
+#include "pw_router/egress.h"
+
+namespace pw::router {
+
+// Router egress that sends each packet through several egresses, for routes
+// that broadcast or mirror packets. Shared packets are passed to every egress
+// by reference, so their data is not copied for each one.
+//
+// Every egress is sent the packet, even if an earlier one fails. Returns OK if
+// all of them accepted the packet, or the first error otherwise.
+class MulticastEgress final : public Egress {
+ public:
+  constexpr MulticastEgress(std::span<Egress* const> egresses)
+      : egresses_(egresses) {}
+
+  Status SendPacket(ConstByteSpan packet, const PacketParser& parser) final {
+    Status result;
+    for (Egress* egress : egresses_) {
+      result.Update(egress->SendPacket(packet, parser));
+    }
+    return result;
+  }
+
+  Status SendSharedPacket(SharedPacket packet,
+                          const PacketParser& parser) final {
+    Status result;
+    for (Egress* egress : egresses_) {
+      result.Update(egress->SendSharedPacket(packet, parser));
+    }
+    return result;
+  }
+
+ private:
+  std::span<Egress* const> egresses_;
+};
+
+}  // namespace pw::router
@@ -0,0 +1,154 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+
+namespace pw::router {
+namespace internal {
+
+// A packet buffer in a SharedPacketPool. The buffer is free when it has no
+// references.
+struct SharedPacketBuffer {
+  std::atomic<uint32_t> references;
+  std::byte* data;
+  size_t size;
+};
+
+}  // namespace internal
+
+// A reference to a packet stored in a SharedPacketPool. Copying a SharedPacket
+// adds a reference to the packet rather than copying its data, so the same
+// packet can be passed to several egresses. The packet's buffer returns to the
+// pool when its last reference is destroyed.
+//
+// Each SharedPacket object must only be used from one thread at a time, but
+// copies that refer to the same packet may be used and destroyed from any
+// thread or interrupt.
+class SharedPacket {
+ public:
+  // Creates an empty SharedPacket that refers to no packet.
+  constexpr SharedPacket() : buffer_(nullptr) {}
+
+  SharedPacket(const SharedPacket& other) : buffer_(other.buffer_) {
+    AddReference();
+  }
+
+  SharedPacket& operator=(const SharedPacket& other) {
+    if (buffer_ != other.buffer_) {
+      reset();
+      buffer_ = other.buffer_;
+      AddReference();
+    }
+    return *this;
+  }
+
+  SharedPacket(SharedPacket&& other) : buffer_(other.buffer_) {
+    other.buffer_ = nullptr;
+  }
+
+  SharedPacket& operator=(SharedPacket&& other) {
+    if (this != &other) {
+      reset();
+      buffer_ = other.buffer_;
+      other.buffer_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~SharedPacket() { reset(); }
+
+  // True if this refers to a packet.
+  explicit operator bool() const { return buffer_ != nullptr; }
+
+  // The packet's data. Empty if this refers to no packet.
+  ConstByteSpan data() const {
+    return buffer_ == nullptr ? ConstByteSpan()
+                              : ConstByteSpan(buffer_->data, buffer_->size);
+  }
+
+  // Drops this reference to the packet, releasing the packet's buffer if this
+  // was the last reference.
+  void reset();
+
+ private:
+  friend class SharedPacketPool;
+
+  explicit SharedPacket(internal::SharedPacketBuffer* buffer)
+      : buffer_(buffer) {}
+
+  void AddReference() {
+    if (buffer_ != nullptr) {
+      buffer_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  internal::SharedPacketBuffer* buffer_;
+};
+
+// A fixed set of equally sized buffers for SharedPackets. Allocating and
+// releasing buffers does not lock, so both may be done from any thread or
+// interrupt.
+class SharedPacketPool {
+ public:
+  // Divides storage evenly between the buffers. Any remainder is unused.
+  SharedPacketPool(std::span<internal::SharedPacketBuffer> buffers,
+                   ByteSpan storage);
+
+  SharedPacketPool(const SharedPacketPool&) = delete;
+  SharedPacketPool& operator=(const SharedPacketPool&) = delete;
+
+  // The largest packet a buffer can hold.
+  size_t max_packet_size() const { return max_packet_size_; }
+
+  // Copies a packet into a free buffer. This is the only copy of the packet's
+  // data that the router makes. Returns an empty SharedPacket if the packet is
+  // too large or all buffers are in use.
+  SharedPacket Store(ConstByteSpan packet);
+
+ private:
+  std::span<internal::SharedPacketBuffer> buffers_;
+  size_t max_packet_size_;
+};
+
+namespace internal {
+
+// The pool sets up its buffers when it is constructed, so their storage must be
+// constructed first.
+template <size_t kPackets, size_t kMaxPacketSizeBytes>
+struct SharedPacketPoolStorage {
+  std::array<SharedPacketBuffer, kPackets> buffers;
+  std::array<std::byte, kPackets * kMaxPacketSizeBytes> storage;
+};
+
+}  // namespace internal
+
+// A SharedPacketPool with storage for kPackets packets of up to
+// kMaxPacketSizeBytes each.
+template <size_t kPackets, size_t kMaxPacketSizeBytes>
+class SharedPacketPoolWithBuffer
+    : private internal::SharedPacketPoolStorage<kPackets, kMaxPacketSizeBytes>,
+      public SharedPacketPool {
+ public:
+  SharedPacketPoolWithBuffer()
+      : SharedPacketPool(this->buffers, this->storage) {}
+};
+
+}  // namespace pw::router
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <span>
 
 #include "pw_bytes/span.h"
@@ -20,11 +22,17 @@
 #include "pw_router/egress.h"
 #include "pw_router/packet_parser.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::router {
 
 // A packet router with a static routing table.
 //
+// Routes are found with a binary search if they are sorted by address, or a
+// linear search if they are not, so list routes in order of address when there
+// are many of them. The most recently used route is checked first, so a run of
+// packets to the same address is routed in constant time.
+//
 // Thread-safety:
 //   Internal packet parsing and calls to the provided PacketParser are
 //   synchronized. Synchronization at the egress level must be implemented by
@@ -38,7 +46,15 @@ class StaticRouter {
     Egress& egress;
   };
 
-  StaticRouter(std::span<const Route> routes) : routes_(routes) {}
+  StaticRouter(std::span<const Route> routes)
+      : routes_(routes),
+        routes_sorted_(std::is_sorted(
+            routes.begin(),
+            routes.end(),
+            [](const Route& lhs, const Route& rhs) {
+              return lhs.address < rhs.address;
+            })),
+        last_route_(nullptr) {}
 
   StaticRouter(const StaticRouter&) = delete;
   StaticRouter(StaticRouter&&) = delete;
@@ -62,8 +78,35 @@ class StaticRouter {
   //
   Status RoutePacket(ConstByteSpan packet, PacketParser& parser);
 
+  // Routes a packet stored in a SharedPacketPool. The egress is passed a
+  // reference to the packet, so it may hold on to the packet without copying
+  // it. Returns the same errors as the function above.
+  Status RoutePacket(SharedPacket packet, PacketParser& parser);
+
+  // Routes a batch of packets, such as the frames found in one DMA transfer.
+  // Each packet is routed as if by RoutePacket(); a failed packet does not stop
+  // the rest of the batch. Returns OK if every packet was sent, or the first
+  // error encountered. The size is the number of packets sent successfully.
+  StatusWithSize RoutePackets(std::span<const ConstByteSpan> packets,
+                              PacketParser& parser);
+
  private:
+  // Parses the packet and finds its route. Sets route and returns OK, or
+  // returns DATA_LOSS or NOT_FOUND.
+  Status FindRouteForPacket(ConstByteSpan packet,
+                            PacketParser& parser,
+                            const Route*& route);
+
+  // Returns the route for the address, or nullptr if there is none.
+  const Route* FindRoute(uint32_t address);
+
   const std::span<const Route> routes_;
+  const bool routes_sorted_;
+
+  // The most recently used route. Checking it is only a shortcut, so relaxed
+  // atomic accesses are enough to share it between threads.
+  std::atomic<const Route*> last_route_;
+
   PW_METRIC_GROUP(metrics_, "static_router");
   PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
   PW_METRIC(metrics_, route_errors_, "route_errors", 0u);
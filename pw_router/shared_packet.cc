@@ -0,0 +1,61 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/shared_packet.h"
+
+#include <cstring>
+
+namespace pw::router {
+
+void SharedPacket::reset() {
+  if (buffer_ == nullptr) {
+    return;
+  }
+
+  // Releasing the last reference makes the buffer available to Store(). The
+  // release ordering keeps this reference's reads of the data before that.
+  buffer_->references.fetch_sub(1, std::memory_order_release);
+  buffer_ = nullptr;
+}
+
+SharedPacketPool::SharedPacketPool(
+    std::span<internal::SharedPacketBuffer> buffers, ByteSpan storage)
+    : buffers_(buffers),
+      max_packet_size_(buffers.empty() ? 0 : storage.size() / buffers.size()) {
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    buffers_[i].references.store(0, std::memory_order_relaxed);
+    buffers_[i].data = storage.data() + i * max_packet_size_;
+    buffers_[i].size = 0;
+  }
+}
+
+SharedPacket SharedPacketPool::Store(ConstByteSpan packet) {
+  if (packet.size() > max_packet_size_) {
+    return SharedPacket();
+  }
+
+  for (internal::SharedPacketBuffer& buffer : buffers_) {
+    uint32_t free = 0;
+    if (buffer.references.compare_exchange_strong(
+            free, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      std::memcpy(buffer.data, packet.data(), packet.size());
+      buffer.size = packet.size();
+      return SharedPacket(&buffer);
+    }
+  }
+
+  return SharedPacket();  // All buffers are in use.
+}
+
+}  // namespace pw::router
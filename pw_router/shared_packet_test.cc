@@ -0,0 +1,121 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/shared_packet.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::router {
+namespace {
+
+constexpr std::byte kPacket[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+
+bool HasPacketData(const SharedPacket& packet) {
+  return packet.data().size() == sizeof(kPacket) &&
+         std::memcmp(packet.data().data(), kPacket, sizeof(kPacket)) == 0;
+}
+
+TEST(SharedPacket, DefaultConstructed_IsEmpty) {
+  SharedPacket packet;
+  EXPECT_FALSE(packet);
+  EXPECT_TRUE(packet.data().empty());
+}
+
+TEST(SharedPacketPool, MaxPacketSize) {
+  SharedPacketPoolWithBuffer<3, 16> pool;
+  EXPECT_EQ(pool.max_packet_size(), 16u);
+}
+
+TEST(SharedPacketPool, Store_CopiesPacket) {
+  SharedPacketPoolWithBuffer<1, 8> pool;
+  SharedPacket packet = pool.Store(kPacket);
+  ASSERT_TRUE(packet);
+  EXPECT_TRUE(HasPacketData(packet));
+  EXPECT_NE(packet.data().data(), kPacket);
+}
+
+TEST(SharedPacketPool, Store_TooLarge) {
+  SharedPacketPoolWithBuffer<2, 2> pool;
+  EXPECT_FALSE(pool.Store(kPacket));
+}
+
+TEST(SharedPacketPool, Store_AllBuffersInUse) {
+  SharedPacketPoolWithBuffer<2, 4> pool;
+  SharedPacket first = pool.Store(kPacket);
+  SharedPacket second = pool.Store(kPacket);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  EXPECT_NE(first.data().data(), second.data().data());
+  EXPECT_FALSE(pool.Store(kPacket));
+}
+
+TEST(SharedPacketPool, Copies_ShareBufferUntilLastReleased) {
+  SharedPacketPoolWithBuffer<1, 4> pool;
+  SharedPacket packet = pool.Store(kPacket);
+  SharedPacket copy_1 = packet;
+  SharedPacket copy_2;
+  copy_2 = copy_1;
+
+  EXPECT_EQ(copy_1.data().data(), packet.data().data());
+  EXPECT_EQ(copy_2.data().data(), packet.data().data());
+
+  packet.reset();
+  EXPECT_FALSE(packet);
+  copy_1.reset();
+  EXPECT_FALSE(pool.Store(kPacket));
+  EXPECT_TRUE(HasPacketData(copy_2));
+
+  copy_2.reset();
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+TEST(SharedPacketPool, Move_TransfersReference) {
+  SharedPacketPoolWithBuffer<1, 4> pool;
+  SharedPacket packet = pool.Store(kPacket);
+  SharedPacket moved(std::move(packet));
+  EXPECT_TRUE(HasPacketData(moved));
+
+  SharedPacket assigned;
+  assigned = std::move(moved);
+  EXPECT_TRUE(HasPacketData(assigned));
+  EXPECT_FALSE(pool.Store(kPacket));
+
+  assigned = SharedPacket();
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+TEST(SharedPacketPool, Destructor_ReleasesBuffer) {
+  SharedPacketPoolWithBuffer<1, 4> pool;
+  {
+    SharedPacket packet = pool.Store(kPacket);
+    SharedPacket copy = packet;
+    EXPECT_FALSE(pool.Store(kPacket));
+  }
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+TEST(SharedPacketPool, SelfAssignment_KeepsReference) {
+  SharedPacketPoolWithBuffer<1, 4> pool;
+  SharedPacket packet = pool.Store(kPacket);
+  SharedPacket& same = packet;
+  packet = same;
+  EXPECT_TRUE(HasPacketData(packet));
+  packet.reset();
+  EXPECT_TRUE(pool.Store(kPacket));
+}
+
+}  // namespace
+}  // namespace pw::router
@@ -15,10 +15,57 @@
 #include "pw_router/static_router.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace pw::router {
 
 Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
+  const Route* route;
+  if (Status status = FindRouteForPacket(packet, parser, route); !status.ok()) {
+    return status;
+  }
+
+  if (Status status = route->egress.SendPacket(packet, parser); !status.ok()) {
+    egress_errors_.Increment();
+    return Status::Unavailable();
+  }
+
+  return OkStatus();
+}
+
+Status StaticRouter::RoutePacket(SharedPacket packet, PacketParser& parser) {
+  const Route* route;
+  if (Status status = FindRouteForPacket(packet.data(), parser, route);
+      !status.ok()) {
+    return status;
+  }
+
+  if (Status status = route->egress.SendSharedPacket(std::move(packet), parser);
+      !status.ok()) {
+    egress_errors_.Increment();
+    return Status::Unavailable();
+  }
+
+  return OkStatus();
+}
+
+StatusWithSize StaticRouter::RoutePackets(
+    std::span<const ConstByteSpan> packets, PacketParser& parser) {
+  Status status;
+  size_t routed = 0;
+  for (ConstByteSpan packet : packets) {
+    const Status packet_status = RoutePacket(packet, parser);
+    if (packet_status.ok()) {
+      routed += 1;
+    }
+    status.Update(packet_status);
+  }
+  return StatusWithSize(status, routed);
+}
+
+Status StaticRouter::FindRouteForPacket(ConstByteSpan packet,
+                                        PacketParser& parser,
+                                        const Route*& route) {
   if (!parser.Parse(packet)) {
     parser_errors_.Increment();
     return Status::DataLoss();
@@ -30,20 +77,42 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
     return Status::DataLoss();
   }
 
-  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
-    return r.address == *maybe_address;
-  });
-  if (route == routes_.end()) {
+  route = FindRoute(*maybe_address);
+  if (route == nullptr) {
     route_errors_.Increment();
     return Status::NotFound();
   }
 
-  if (Status status = route->egress.SendPacket(packet, parser); !status.ok()) {
-    egress_errors_.Increment();
-    return Status::Unavailable();
+  return OkStatus();
+}
+
+const StaticRouter::Route* StaticRouter::FindRoute(uint32_t address) {
+  const Route* route = last_route_.load(std::memory_order_relaxed);
+  if (route != nullptr && route->address == address) {
+    return route;
   }
 
-  return OkStatus();
+  if (routes_sorted_) {
+    route = std::lower_bound(routes_.data(),
+                             routes_.data() + routes_.size(),
+                             address,
+                             [](const Route& r, uint32_t value) {
+                               return r.address < value;
+                             });
+  } else {
+    route = std::find_if(routes_.data(),
+                         routes_.data() + routes_.size(),
+                         [address](const Route& r) {
+                           return r.address == address;
+                         });
+  }
+
+  if (route == routes_.data() + routes_.size() || route->address != address) {
+    return nullptr;
+  }
+
+  last_route_.store(route, std::memory_order_relaxed);
+  return route;
 }
 
 }  // namespace pw::router
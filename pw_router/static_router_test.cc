@@ -147,5 +147,127 @@ TEST(StaticRouter, RoutePacket_TracksNumberOfDrops) {
   EXPECT_EQ(router.dropped_packets(), 3u);
 }
 
+// Records the destination address of the last packet sent through it.
+class AddressEgress : public Egress {
+ public:
+  constexpr AddressEgress() : last_address_(0) {}
+
+  uint32_t last_address() const { return last_address_; }
+
+  Status SendPacket(ConstByteSpan, const PacketParser& parser) final {
+    last_address_ = *parser.GetDestinationAddress();
+    return OkStatus();
+  }
+
+ private:
+  uint32_t last_address_;
+};
+
+TEST(StaticRouter, RoutePacket_ManySortedRoutes) {
+  AddressEgress even;
+  AddressEgress odd;
+  StaticRouter::Route routes[] = {
+      {0, even}, {3, odd}, {4, even}, {9, odd}, {10, even}, {0xffffffff, odd}};
+  StaticRouter router(routes);
+  BasicPacketParser parser;
+
+  for (const StaticRouter::Route& route : routes) {
+    ASSERT_EQ(router.RoutePacket(BasicPacket(route.address, 0).data(), parser),
+              OkStatus());
+    EXPECT_EQ(static_cast<AddressEgress&>(route.egress).last_address(),
+              route.address);
+  }
+
+  for (uint32_t address : {1u, 2u, 5u, 11u, 0xfffffffeu}) {
+    EXPECT_EQ(router.RoutePacket(BasicPacket(address, 0).data(), parser),
+              Status::NotFound());
+  }
+}
+
+TEST(StaticRouter, RoutePacket_UnsortedRoutes) {
+  AddressEgress first;
+  AddressEgress second;
+  StaticRouter::Route routes[] = {
+      {20, first}, {5, second}, {7, first}, {1, second}};
+  StaticRouter router(routes);
+  BasicPacketParser parser;
+
+  for (const StaticRouter::Route& route : routes) {
+    ASSERT_EQ(router.RoutePacket(BasicPacket(route.address, 0).data(), parser),
+              OkStatus());
+    EXPECT_EQ(static_cast<AddressEgress&>(route.egress).last_address(),
+              route.address);
+  }
+
+  EXPECT_EQ(router.RoutePacket(BasicPacket(6, 0).data(), parser),
+            Status::NotFound());
+}
+
+TEST(StaticRouter, RoutePacket_RepeatedAddressUsesSameRoute) {
+  AddressEgress egress;
+  StaticRouter::Route routes[] = {{1, egress}, {2, egress}};
+  StaticRouter router(routes);
+  BasicPacketParser parser;
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(router.RoutePacket(BasicPacket(2, 0).data(), parser), OkStatus());
+    EXPECT_EQ(egress.last_address(), 2u);
+    EXPECT_EQ(router.RoutePacket(BasicPacket(42, 0).data(), parser),
+              Status::NotFound());
+  }
+  EXPECT_EQ(router.dropped_packets(), 3u);
+}
+
+TEST(StaticRouter, RoutePackets_RoutesAllPackets) {
+  AddressEgress first;
+  AddressEgress second;
+  StaticRouter::Route routes[] = {{1, first}, {2, second}};
+  StaticRouter router(routes);
+  BasicPacketParser parser;
+
+  const BasicPacket packet_1(1, 0);
+  const BasicPacket packet_2(2, 0);
+  const ConstByteSpan packets[] = {
+      packet_1.data(), packet_2.data(), packet_1.data()};
+
+  StatusWithSize result = router.RoutePackets(packets, parser);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_EQ(first.last_address(), 1u);
+  EXPECT_EQ(second.last_address(), 2u);
+}
+
+TEST(StaticRouter, RoutePackets_ContinuesAfterErrors) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}, {2, BadEgress}};
+  StaticRouter router(routes);
+
+  BasicPacket bad_magic(1, 0xdddd);
+  bad_magic.magic = 0x1badda7a;
+  const BasicPacket good(1, 0xdddd);
+  const BasicPacket bad_route(42, 0xdddd);
+  const BasicPacket bad_egress(2, 0xdddd);
+  const ConstByteSpan packets[] = {good.data(),
+                                   bad_route.data(),
+                                   bad_magic.data(),
+                                   good.data(),
+                                   bad_egress.data()};
+
+  StatusWithSize result = router.RoutePackets(packets, parser);
+  EXPECT_EQ(result.status(), Status::NotFound());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(router.dropped_packets(), 3u);
+}
+
+TEST(StaticRouter, RoutePackets_Empty) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}};
+  StaticRouter router(routes);
+
+  StatusWithSize result = router.RoutePackets({}, parser);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 0u);
+}
+
 }  // namespace
 }  // namespace pw::router
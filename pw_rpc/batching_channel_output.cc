@@ -0,0 +1,83 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::rpc {
+
+size_t BatchingChannelOutput::capacity() {
+  return std::min(buffer_.size(), output_.MaximumTransmissionUnit());
+}
+
+size_t BatchingChannelOutput::MaximumTransmissionUnit() {
+  const size_t batch_capacity = capacity();
+
+  // Reserve space for the largest length prefix a packet could need.
+  const size_t prefix_size = varint::EncodedSize(batch_capacity);
+  return batch_capacity > prefix_size ? batch_capacity - prefix_size : 0;
+}
+
+Status BatchingChannelOutput::Send(std::span<const std::byte> packet) {
+  const size_t prefix_size = varint::EncodedSize(packet.size());
+  const size_t entry_size = prefix_size + packet.size();
+
+  if (entry_size > capacity()) {
+    return Status::ResourceExhausted();
+  }
+
+  // If the packet doesn't fit in the current batch, send the batch first.
+  if (entry_size > capacity() - size_) {
+    if (Status status = FlushLocked(); !status.ok()) {
+      return status;
+    }
+  }
+
+  if (packets_ == 0u) {
+    first_packet_time_ = clock_.now();
+  }
+
+  varint::Encode(packet.size(), buffer_.subspan(size_, prefix_size));
+  std::memcpy(buffer_.subspan(size_ + prefix_size).data(),
+              packet.data(),
+              packet.size());
+  size_ += entry_size;
+  packets_ += 1;
+
+  if (size_ >= policy_.max_bytes || packets_ >= policy_.max_packets ||
+      clock_.now() - first_packet_time_ >= policy_.max_delay) {
+    return FlushLocked();
+  }
+  return OkStatus();
+}
+
+Status BatchingChannelOutput::Flush() {
+  internal::LockGuard lock(internal::rpc_lock());
+  return FlushLocked();
+}
+
+Status BatchingChannelOutput::FlushLocked() {
+  if (packets_ == 0u) {
+    return OkStatus();
+  }
+
+  const size_t batch_size = size_;
+  size_ = 0;
+  packets_ = 0;
+  return output_.Send(buffer_.first(batch_size));
+}
+
+}  // namespace pw::rpc
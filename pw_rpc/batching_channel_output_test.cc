@@ -0,0 +1,221 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_chrono/simulated_system_clock.h"
+#include "pw_containers/vector.h"
+
+namespace pw::rpc {
+namespace {
+
+using std::byte;
+
+constexpr auto kOne = bytes::Array<1>();
+constexpr auto kTwo = bytes::Array<2, 2>();
+constexpr auto kThree = bytes::Array<3, 3, 3>();
+
+// Records the size of each Send() call and the most recent batch.
+class RecordingOutput : public ChannelOutput {
+ public:
+  RecordingOutput(size_t mtu = kUnlimited)
+      : ChannelOutput("RecordingOutput"), mtu_(mtu) {}
+
+  size_t MaximumTransmissionUnit() override { return mtu_; }
+
+  Status Send(std::span<const byte> buffer) override {
+    std::memcpy(last_.data(), buffer.data(), buffer.size());
+    sends_.push_back(buffer.size());
+    return status_;
+  }
+
+  std::span<const byte> last() const {
+    return std::span(last_).first(sends_.back());
+  }
+
+  const Vector<size_t>& sends() const { return sends_; }
+
+  void set_status(Status status) { status_ = status; }
+
+ private:
+  size_t mtu_;
+  Status status_;
+  std::array<byte, 64> last_ = {};
+  Vector<size_t, 16> sends_;
+};
+
+class BatchingChannelOutputTest : public ::testing::Test {
+ protected:
+  Status Send(BatchingChannelOutput& batching, std::span<const byte> packet)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    internal::LockGuard lock(internal::rpc_lock());
+    return batching.Send(packet);
+  }
+
+  RecordingOutput output_;
+  std::array<byte, 32> buffer_ = {};
+};
+
+TEST_F(BatchingChannelOutputTest, UsesOutputName) {
+  BatchingChannelOutput batching(output_, buffer_);
+  EXPECT_STREQ(batching.name(), "RecordingOutput");
+}
+
+TEST_F(BatchingChannelOutputTest, Send_BuffersUntilFlush) {
+  BatchingChannelOutput batching(output_, buffer_);
+
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kTwo));
+  EXPECT_EQ(OkStatus(), Send(batching, kThree));
+  EXPECT_TRUE(output_.sends().empty());
+
+  EXPECT_EQ(OkStatus(), batching.Flush());
+  ASSERT_EQ(output_.sends().size(), 1u);
+  EXPECT_EQ(output_.sends()[0], 9u);
+
+  constexpr auto kExpected = bytes::Array<1, 1, 2, 2, 2, 3, 3, 3, 3>();
+  ASSERT_EQ(output_.last().size(), kExpected.size());
+  EXPECT_EQ(std::memcmp(output_.last().data(), kExpected.data(), 9), 0);
+}
+
+TEST_F(BatchingChannelOutputTest, Flush_Empty_SendsNothing) {
+  BatchingChannelOutput batching(output_, buffer_);
+
+  EXPECT_EQ(OkStatus(), batching.Flush());
+  EXPECT_TRUE(output_.sends().empty());
+}
+
+TEST_F(BatchingChannelOutputTest, Send_FlushesWhenBatchIsFull) {
+  std::array<byte, 7> small_buffer;
+  BatchingChannelOutput batching(output_, small_buffer);
+
+  EXPECT_EQ(OkStatus(), Send(batching, kTwo));    // 3 bytes
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));    // 5 bytes
+  EXPECT_EQ(OkStatus(), Send(batching, kThree));  // Doesn't fit; flush first.
+
+  ASSERT_EQ(output_.sends().size(), 1u);
+  EXPECT_EQ(output_.sends()[0], 5u);
+
+  EXPECT_EQ(OkStatus(), batching.Flush());
+  ASSERT_EQ(output_.sends().size(), 2u);
+  EXPECT_EQ(output_.sends()[1], 4u);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_BatchLimitedByMtu) {
+  RecordingOutput small_mtu_output(4);
+  BatchingChannelOutput batching(small_mtu_output, buffer_);
+
+  EXPECT_EQ(batching.MaximumTransmissionUnit(), 3u);
+
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+
+  ASSERT_EQ(small_mtu_output.sends().size(), 1u);
+  EXPECT_EQ(small_mtu_output.sends()[0], 4u);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_PacketTooLarge_ResourceExhausted) {
+  std::array<byte, 3> small_buffer;
+  BatchingChannelOutput batching(output_, small_buffer);
+
+  EXPECT_EQ(Status::ResourceExhausted(), Send(batching, kThree));
+  EXPECT_EQ(OkStatus(), Send(batching, kTwo));
+}
+
+TEST_F(BatchingChannelOutputTest, Send_FlushesAtMaxBytes) {
+  BatchingChannelOutput batching(output_, buffer_, {.max_bytes = 5});
+
+  EXPECT_EQ(OkStatus(), Send(batching, kTwo));
+  EXPECT_TRUE(output_.sends().empty());
+  EXPECT_EQ(OkStatus(), Send(batching, kTwo));
+  ASSERT_EQ(output_.sends().size(), 1u);
+  EXPECT_EQ(output_.sends()[0], 6u);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_FlushesAtMaxPackets) {
+  BatchingChannelOutput batching(output_, buffer_, {.max_packets = 2});
+
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+
+  ASSERT_EQ(output_.sends().size(), 2u);
+  EXPECT_EQ(output_.sends()[0], 4u);
+  EXPECT_EQ(output_.sends()[1], 4u);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_FlushesAfterMaxDelay) {
+  chrono::SimulatedSystemClock clock;
+  BatchingChannelOutput batching(
+      output_,
+      buffer_,
+      {.max_delay = chrono::SystemClock::for_at_least(std::chrono::seconds(1))},
+      clock);
+
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  clock.AdvanceTime(chrono::SystemClock::for_at_least(std::chrono::seconds(1)));
+  EXPECT_TRUE(output_.sends().empty());
+
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  ASSERT_EQ(output_.sends().size(), 1u);
+  EXPECT_EQ(output_.sends()[0], 4u);
+
+  // The deadline restarts with the next batch.
+  EXPECT_EQ(OkStatus(), Send(batching, kOne));
+  EXPECT_EQ(output_.sends().size(), 1u);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_ReturnsOutputStatusOnFlush) {
+  BatchingChannelOutput batching(output_, buffer_, {.max_packets = 1});
+  output_.set_status(Status::Unavailable());
+
+  EXPECT_EQ(Status::Unavailable(), Send(batching, kOne));
+}
+
+TEST(ForEachBatchedPacket, SplitsBatch) {
+  constexpr auto kBatch = bytes::Array<1, 1, 0, 2, 2, 2>();
+
+  std::array<size_t, 3> sizes = {};
+  size_t count = 0;
+  EXPECT_EQ(OkStatus(),
+            ForEachBatchedPacket(kBatch, [&](std::span<const byte> packet) {
+              sizes[count++] = packet.size();
+            }));
+
+  ASSERT_EQ(count, 3u);
+  EXPECT_EQ(sizes[0], 1u);
+  EXPECT_EQ(sizes[1], 0u);
+  EXPECT_EQ(sizes[2], 2u);
+}
+
+TEST(ForEachBatchedPacket, Truncated_DataLoss) {
+  constexpr auto kBatch = bytes::Array<1, 1, 3, 2, 2>();
+
+  size_t count = 0;
+  EXPECT_EQ(Status::DataLoss(),
+            ForEachBatchedPacket(kBatch,
+                                 [&](std::span<const byte>) { count += 1; }));
+  EXPECT_EQ(count, 1u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -74,6 +74,9 @@ void Call::MoveFrom(Call& other) {
   type_ = other.type_;
   call_type_ = other.call_type_;
   client_stream_state_ = other.client_stream_state_;
+#if PW_RPC_FLOW_CONTROL
+  credit_ = other.credit_;
+#endif  // PW_RPC_FLOW_CONTROL
 
   on_error_ = std::move(other.on_error_);
   on_next_ = std::move(other.on_next_);
@@ -107,11 +110,81 @@ Status Call::CloseAndSendFinalPacketLocked(PacketType type,
 }
 
 Status Call::WriteLocked(ConstByteSpan payload) {
+#if PW_RPC_FLOW_CONTROL
+  if (call_type_ == kServerCall) {
+    if (credit_ == 0u) {
+      return Status::ResourceExhausted();
+    }
+
+    const Status status = SendPacket(PacketType::SERVER_STREAM, payload);
+    if (status.ok() && credit_ != kUnlimitedCredit) {
+      credit_ -= 1;
+    }
+    return status;
+  }
+#endif  // PW_RPC_FLOW_CONTROL
+
   return SendPacket(call_type_ == kServerCall ? PacketType::SERVER_STREAM
                                               : PacketType::CLIENT_STREAM,
                     payload);
 }
 
+ByteSpan Call::PayloadBufferLocked() {
+  if (!active_locked()) {
+    return GetPayloadBuffer();
+  }
+
+  Channel* channel = endpoint_->GetInternalChannel(channel_id_);
+  return channel != nullptr ? channel->PayloadBuffer() : GetPayloadBuffer();
+}
+
+size_t Call::MaxWritePayloadSizeLocked() {
+  if (!active_locked()) {
+    return 0;
+  }
+
+  Channel* channel = endpoint_->GetInternalChannel(channel_id_);
+  if (channel == nullptr) {
+    return 0;
+  }
+  return MakePacket(call_type_ == kServerCall ? PacketType::SERVER_STREAM
+                                              : PacketType::CLIENT_STREAM,
+                    {})
+      .MaxPayloadSize(channel->MaxPacketSizeBytes());
+}
+
+#if PW_RPC_FLOW_CONTROL
+
+void Call::HandleCredit(uint32_t credit) {
+  if (credit_ == kUnlimitedCredit) {
+    credit_ = 0;  // The first credit packet enables flow control.
+  }
+
+  // Saturate below kUnlimitedCredit so the call remains flow controlled.
+  if (credit >= kUnlimitedCredit - credit_) {
+    credit_ = kUnlimitedCredit - 1;
+  } else {
+    credit_ += credit;
+  }
+}
+
+Status Call::SendCreditLocked(uint32_t credit) {
+  if (!active_locked()) {
+    return Status::FailedPrecondition();
+  }
+
+  Channel* channel = endpoint_->GetInternalChannel(channel_id_);
+  if (channel == nullptr) {
+    return Status::Unavailable();
+  }
+
+  Packet packet = MakePacket(PacketType::CLIENT_FLOW_CONTROL, {});
+  packet.set_credit(credit);
+  return channel->Send(packet);
+}
+
+#endif  // PW_RPC_FLOW_CONTROL
+
 void Call::UnregisterAndMarkClosed() {
   if (active_locked()) {
     endpoint().UnregisterCall(*this);
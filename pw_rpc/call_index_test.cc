@@ -0,0 +1,190 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/call_index.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/test_method.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+
+namespace pw::rpc {
+
+class TestService : public Service {
+ public:
+  constexpr TestService(uint32_t id) : Service(id, method) {}
+
+  static constexpr internal::TestMethodUnion method = internal::TestMethod(8);
+};
+
+namespace internal {
+namespace {
+
+using test::FakeServerWriter;
+
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 8;
+constexpr size_t kCalls = 8;
+
+class CallIndexTest : public ::testing::Test {
+ protected:
+  CallIndexTest()
+      : server_(std::span<rpc::Channel>()),
+        service_(kServiceId),
+        calls_{MakeCall(1),
+               MakeCall(2),
+               MakeCall(3),
+               MakeCall(4),
+               MakeCall(5),
+               MakeCall(6),
+               MakeCall(7),
+               MakeCall(8)} {}
+
+  // Each call uses a different channel ID, so they have unique keys.
+  FakeServerWriter MakeCall(uint32_t channel_id, uint32_t call_id = 0) {
+    return FakeServerWriter(CallContext(
+        server_, channel_id, service_, TestService::method.method(), call_id));
+  }
+
+  Call& call(size_t index) { return calls_[index].as_server_call(); }
+
+  Server server_;
+  TestService service_;
+  std::array<FakeServerWriter, kCalls> calls_;
+};
+
+TEST_F(CallIndexTest, Find_Empty_ReturnsNull) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<4> index;
+  EXPECT_EQ(index.Find(1, kServiceId, kMethodId), nullptr);
+  EXPECT_EQ(index.size(), 0u);
+}
+
+TEST_F(CallIndexTest, Add_FindsEachCall) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<kCalls> index;
+
+  for (size_t i = 0; i < kCalls; ++i) {
+    ASSERT_TRUE(index.Add(call(i)));
+  }
+  EXPECT_EQ(index.size(), kCalls);
+
+  for (size_t i = 0; i < kCalls; ++i) {
+    EXPECT_EQ(index.Find(static_cast<uint32_t>(i + 1), kServiceId, kMethodId),
+              &call(i));
+  }
+
+  EXPECT_EQ(index.Find(kCalls + 1, kServiceId, kMethodId), nullptr);
+  EXPECT_EQ(index.Find(1, kServiceId + 1, kMethodId), nullptr);
+  EXPECT_EQ(index.Find(1, kServiceId, kMethodId + 1), nullptr);
+}
+
+TEST_F(CallIndexTest, Add_Full_ReturnsFalse) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<2> index;
+
+  EXPECT_TRUE(index.Add(call(0)));
+  EXPECT_TRUE(index.Add(call(1)));
+  EXPECT_FALSE(index.Add(call(2)));
+
+  EXPECT_EQ(index.Find(3, kServiceId, kMethodId), nullptr);
+}
+
+TEST_F(CallIndexTest, Remove_OnlyRemovesThatCall) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<kCalls> index;
+
+  for (size_t i = 0; i < kCalls; ++i) {
+    ASSERT_TRUE(index.Add(call(i)));
+  }
+
+  // Remove every other call, then check that the rest remain reachable.
+  for (size_t i = 0; i < kCalls; i += 2) {
+    EXPECT_TRUE(index.Remove(call(i)));
+    EXPECT_FALSE(index.Remove(call(i)));
+  }
+  EXPECT_EQ(index.size(), kCalls / 2);
+
+  for (size_t i = 0; i < kCalls; ++i) {
+    Call* found =
+        index.Find(static_cast<uint32_t>(i + 1), kServiceId, kMethodId);
+    EXPECT_EQ(found, i % 2 == 0 ? nullptr : &call(i));
+  }
+}
+
+TEST_F(CallIndexTest, Remove_SlotsAreReused) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<2> index;
+
+  for (int round = 0; round < 10; ++round) {
+    ASSERT_TRUE(index.Add(call(0)));
+    ASSERT_TRUE(index.Add(call(1)));
+    ASSERT_TRUE(index.Remove(call(0)));
+    ASSERT_TRUE(index.Remove(call(1)));
+  }
+  EXPECT_EQ(index.size(), 0u);
+}
+
+TEST_F(CallIndexTest, ZeroCapacity_NeverIndexes) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<0> index;
+
+  EXPECT_FALSE(index.Add(call(0)));
+  EXPECT_FALSE(index.Remove(call(0)));
+  EXPECT_EQ(index.Find(1, kServiceId, kMethodId), nullptr);
+}
+
+TEST_F(CallIndexTest, FindIndexedCall_IndexFull) PW_NO_LOCK_SAFETY_ANALYSIS {
+  // Register the calls with different servers so that starting the newer call
+  // doesn't cancel the older one.
+  Server other_server((std::span<rpc::Channel>()));
+  FakeServerWriter older(CallContext(
+      other_server, 1, service_, TestService::method.method(), 100));
+  FakeServerWriter newer = MakeCall(1, 200);
+
+  // The index only has room for the older call.
+  CallIndex<1> index;
+  ASSERT_TRUE(index.Add(older.as_server_call()));
+  ASSERT_FALSE(index.Add(newer.as_server_call()));
+
+  std::array<std::reference_wrapper<Call>, 2> calls{newer.as_server_call(),
+                                                    older.as_server_call()};
+
+  EXPECT_EQ(FindIndexedCall(index, 1, calls, 1, kServiceId, kMethodId, 100),
+            &older.as_server_call());
+  EXPECT_EQ(FindIndexedCall(index, 1, calls, 1, kServiceId, kMethodId, 200),
+            &newer.as_server_call());
+
+  // Without a matching call ID, the newest call is found, even though only the
+  // older call is indexed.
+  EXPECT_EQ(FindIndexedCall(index, 1, calls, 1, kServiceId, kMethodId, 300),
+            &newer.as_server_call());
+  EXPECT_EQ(FindIndexedCall(index, 1, calls, 2, kServiceId, kMethodId, 300),
+            nullptr);
+}
+
+TEST_F(CallIndexTest, FindIndexedCall_AllIndexed) PW_NO_LOCK_SAFETY_ANALYSIS {
+  CallIndex<kCalls> index;
+  ASSERT_TRUE(index.Add(call(0)));
+
+  // The list is not searched when every call is indexed.
+  std::array<std::reference_wrapper<Call>, 1> calls{call(1)};
+  EXPECT_EQ(FindIndexedCall(index, 0, calls, 1, kServiceId, kMethodId, 0),
+            &call(0));
+  EXPECT_EQ(FindIndexedCall(index, 0, calls, 2, kServiceId, kMethodId, 0),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace pw::rpc
@@ -18,6 +18,8 @@
 #include "pw_rpc/internal/channel.h"
 // clang-format on
 
+#include <algorithm>
+
 #include "pw_log/log.h"
 #include "pw_rpc/internal/config.h"
 
@@ -38,9 +40,26 @@ ByteSpan GetPayloadBuffer() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
 }
 
 Status Channel::Send(const Packet& packet) {
-  Result encoded = packet.Encode(encoding_buffer);
+  ChannelOutput& out = output();
+
+  // Zero-copy outputs provide a buffer in which to encode the packet.
+  // Otherwise, use the output's encoding buffer, if it has one.
+  ByteSpan buffer = out.AcquireBuffer();
+  const bool acquired = !buffer.empty();
+
+  if (!acquired) {
+    buffer = out.encoding_buffer().empty() ? ByteSpan(encoding_buffer)
+                                           : out.encoding_buffer();
+  }
+
+  Result encoded = packet.Encode(buffer);
 
   if (!encoded.ok()) {
+    if (acquired) {
+      // Release the buffer without sending anything.
+      out.SendAndReleaseBuffer({}).IgnoreError();
+    }
+
     PW_LOG_ERROR(
         "Failed to encode RPC packet type %u to channel %u buffer, status %u",
         static_cast<unsigned>(packet.type()),
@@ -49,7 +68,8 @@ Status Channel::Send(const Packet& packet) {
     return Status::Internal();
   }
 
-  Status sent = output().Send(encoded.value());
+  Status sent = acquired ? out.SendAndReleaseBuffer(encoded.value())
+                         : out.Send(encoded.value());
 
   if (!sent.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
@@ -61,4 +81,23 @@ Status Channel::Send(const Packet& packet) {
   return OkStatus();
 }
 
+ByteSpan Channel::PayloadBuffer() {
+  const ByteSpan buffer = output().encoding_buffer();
+  if (buffer.empty()) {
+    return GetPayloadBuffer();
+  }
+  if (buffer.size() <= Packet::kMinEncodedSizeWithoutPayload) {
+    return ByteSpan();
+  }
+  return buffer.subspan(Packet::kMinEncodedSizeWithoutPayload);
+}
+
+size_t Channel::MaxPacketSizeBytes() {
+  ChannelOutput& out = output();
+  const size_t buffer_size = out.encoding_buffer().empty()
+                                 ? encoding_buffer.size()
+                                 : out.encoding_buffer().size();
+  return std::min(buffer_size, out.MaximumTransmissionUnit());
+}
+
 }  // namespace pw::rpc::internal
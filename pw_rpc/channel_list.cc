@@ -17,9 +17,15 @@
 namespace pw::rpc::internal {
 
 const Channel* ChannelList::Get(uint32_t channel_id) const {
-  for (const Channel& channel : channels_) {
-    if (channel.id() == channel_id) {
-      return &channel;
+  const size_t cached = cache_.Lookup(channel_id);
+  if (cached < channels_.size() && channels_[cached].id() == channel_id) {
+    return &channels_[cached];
+  }
+
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    if (channels_[i].id() == channel_id) {
+      cache_.Store(channel_id, i);
+      return &channels_[i];
     }
   }
   return nullptr;
@@ -14,7 +14,14 @@
 
 #include "pw_rpc/channel.h"
 
+#include <algorithm>
+#include <array>
+
 #include "gtest/gtest.h"
+#include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/test_utils.h"
 
@@ -54,5 +61,237 @@ TEST(Channel, TestPacket_ReservedSizeMatchesMinEncodedSizeBytes) {
   EXPECT_EQ(kReservedSize, kTestPacket.MinEncodedSizeBytes());
 }
 
+class BufferedOutput : public ChannelOutput {
+ public:
+  BufferedOutput(std::span<std::byte> buffer)
+      : ChannelOutput("BufferedOutput", buffer), buffer_(buffer) {}
+
+  Status Send(std::span<const std::byte> packet) override {
+    sent_from_own_buffer_ = packet.data() >= buffer_.data() &&
+                            packet.data() + packet.size() <=
+                                buffer_.data() + buffer_.size();
+    return OkStatus();
+  }
+
+  bool sent_from_own_buffer() const { return sent_from_own_buffer_; }
+
+ private:
+  std::span<std::byte> buffer_;
+  bool sent_from_own_buffer_ = false;
+};
+
+TEST(Channel, Send_OutputWithEncodingBuffer_EncodesInOutputBuffer) {
+  std::array<std::byte, 32> buffer;
+  BufferedOutput output(buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(OkStatus(), channel.Send(kTestPacket));
+  EXPECT_TRUE(output.sent_from_own_buffer());
+}
+
+TEST(Channel, Send_OutputEncodingBufferTooSmall_ReturnsInternal) {
+  std::array<std::byte, 4> buffer;
+  BufferedOutput output(buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(Status::Internal(), channel.Send(kTestPacket));
+  EXPECT_FALSE(output.sent_from_own_buffer());
+}
+
+TEST(Channel, PayloadBuffer_OutputWithEncodingBuffer_UsesOutputBuffer) {
+  std::array<std::byte, 64> buffer;
+  BufferedOutput output(buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  ByteSpan payload_buffer = channel.PayloadBuffer();
+  EXPECT_EQ(payload_buffer.data(),
+            buffer.data() + Packet::kMinEncodedSizeWithoutPayload);
+  EXPECT_EQ(payload_buffer.size(),
+            buffer.size() - Packet::kMinEncodedSizeWithoutPayload);
+}
+
+TEST(Channel, PayloadBuffer_OutputWithoutEncodingBuffer_UsesSharedBuffer) {
+  class NoBufferOutput : public ChannelOutput {
+   public:
+    NoBufferOutput() : ChannelOutput("NoBufferOutput") {}
+    Status Send(std::span<const std::byte>) override { return OkStatus(); }
+  } output;
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(channel.PayloadBuffer().data(), GetPayloadBuffer().data());
+  EXPECT_EQ(channel.PayloadBuffer().size(),
+            cfg::kEncodingBufferSizeBytes -
+                Packet::kMinEncodedSizeWithoutPayload);
+}
+
+TEST(Channel, Send_PayloadInOutputBuffer_LargerThanSharedBuffer) {
+  std::array<std::byte, cfg::kEncodingBufferSizeBytes + 64> buffer;
+  BufferedOutput output(buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  ByteSpan payload =
+      channel.PayloadBuffer().first(cfg::kEncodingBufferSizeBytes + 16);
+  std::fill(payload.begin(), payload.end(), std::byte{0xab});
+
+  EXPECT_EQ(OkStatus(),
+            channel.Send(Packet(PacketType::SERVER_STREAM, 1, 42, 100, 0,
+                                payload)));
+  EXPECT_TRUE(output.sent_from_own_buffer());
+}
+
+class MtuOutput : public ChannelOutput {
+ public:
+  MtuOutput(size_t mtu) : ChannelOutput("MtuOutput"), mtu_(mtu) {}
+
+  Status Send(std::span<const std::byte>) override { return OkStatus(); }
+
+  size_t MaximumTransmissionUnit() override { return mtu_; }
+
+ private:
+  size_t mtu_;
+};
+
+TEST(Channel, MaxPacketSizeBytes_SharedBuffer) {
+  MtuOutput output(ChannelOutput::kUnlimited);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(channel.MaxPacketSizeBytes(), cfg::kEncodingBufferSizeBytes);
+}
+
+TEST(Channel, MaxPacketSizeBytes_OutputEncodingBuffer) {
+  std::array<std::byte, 32> buffer;
+  BufferedOutput output(buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(channel.MaxPacketSizeBytes(), 32u);
+}
+
+TEST(Channel, MaxPacketSizeBytes_LimitedByMtu) {
+  MtuOutput output(40);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(channel.MaxPacketSizeBytes(), 40u);
+}
+
+class ZeroCopyOutput : public ChannelOutput {
+ public:
+  ZeroCopyOutput(std::span<std::byte> transport_buffer)
+      : ChannelOutput("ZeroCopyOutput"), transport_buffer_(transport_buffer) {}
+
+  Status Send(std::span<const std::byte>) override {
+    send_calls_ += 1;
+    return OkStatus();
+  }
+
+  std::span<std::byte> AcquireBuffer() override {
+    acquired_ = true;
+    return transport_buffer_;
+  }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> packet) override {
+    acquired_ = false;
+    last_packet_ = packet;
+    return OkStatus();
+  }
+
+  bool acquired() const { return acquired_; }
+  int send_calls() const { return send_calls_; }
+  std::span<const std::byte> last_packet() const { return last_packet_; }
+
+ private:
+  std::span<std::byte> transport_buffer_;
+  std::span<const std::byte> last_packet_;
+  bool acquired_ = false;
+  int send_calls_ = 0;
+};
+
+TEST(Channel, Send_ZeroCopyOutput_EncodesInAcquiredBuffer) {
+  std::array<std::byte, 32> transport_buffer;
+  ZeroCopyOutput output(transport_buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(OkStatus(), channel.Send(kTestPacket));
+
+  EXPECT_FALSE(output.acquired());
+  EXPECT_EQ(output.send_calls(), 0);
+  EXPECT_EQ(output.last_packet().data(), transport_buffer.data());
+
+  Result<Packet> packet = Packet::FromBuffer(output.last_packet());
+  ASSERT_EQ(OkStatus(), packet.status());
+  EXPECT_EQ(packet->service_id(), kTestPacket.service_id());
+  EXPECT_EQ(packet->method_id(), kTestPacket.method_id());
+}
+
+TEST(Channel, Send_ZeroCopyOutputBufferTooSmall_ReleasesBuffer) {
+  std::array<std::byte, 4> transport_buffer;
+  ZeroCopyOutput output(transport_buffer);
+  Channel channel(1, &output);
+
+  LockGuard lock(rpc_lock());
+  EXPECT_EQ(Status::Internal(), channel.Send(kTestPacket));
+
+  EXPECT_FALSE(output.acquired());
+  EXPECT_EQ(output.send_calls(), 0);
+  EXPECT_TRUE(output.last_packet().empty());
+}
+
+TEST(ChannelCache, StoresIndexByChannelId) {
+  ChannelCache<4> cache;
+  EXPECT_EQ(ChannelCache<4>::kMissing, cache.Lookup(1));
+
+  cache.Store(1, 0);
+  cache.Store(2, 7);
+  EXPECT_EQ(0u, cache.Lookup(1));
+  EXPECT_EQ(7u, cache.Lookup(2));
+
+  // Channel IDs that map to the same entry replace each other.
+  cache.Store(5, 3);
+  EXPECT_EQ(3u, cache.Lookup(1));
+  EXPECT_EQ(3u, cache.Lookup(5));
+}
+
+TEST(ChannelCache, ZeroSizeNeverStores) {
+  ChannelCache<0> cache;
+  cache.Store(1, 0);
+  EXPECT_EQ(ChannelCache<0>::kMissing, cache.Lookup(1));
+}
+
+TEST(ChannelList, Get_FindsChannelsAfterChanges) {
+  MtuOutput output(ChannelOutput::kUnlimited);
+  std::array<rpc::Channel, 3> channels{rpc::Channel::Create<1>(&output),
+                                       rpc::Channel::Create<2>(&output),
+                                       rpc::Channel()};
+  ChannelList list(
+      std::span(static_cast<Channel*>(channels.data()), channels.size()));
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_NE(nullptr, list.Get(1));
+    EXPECT_EQ(1u, list.Get(1)->id());
+    ASSERT_NE(nullptr, list.Get(2));
+    EXPECT_EQ(2u, list.Get(2)->id());
+  }
+
+  ASSERT_EQ(OkStatus(), list.Remove(1));
+  EXPECT_EQ(nullptr, list.Get(1));
+  ASSERT_NE(nullptr, list.Get(2));
+  EXPECT_EQ(2u, list.Get(2)->id());
+
+  ASSERT_EQ(OkStatus(), list.Add(3, output));
+  ASSERT_NE(nullptr, list.Get(3));
+  EXPECT_EQ(3u, list.Get(3)->id());
+  ASSERT_EQ(OkStatus(), list.Add(1, output));
+  ASSERT_NE(nullptr, list.Get(1));
+  EXPECT_EQ(1u, list.Get(1)->id());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -23,6 +23,14 @@
 
 namespace pw::rpc::internal {
 
+namespace {
+
+bool IsUnary(const Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+  return !call.has_client_stream() && !call.has_server_stream();
+}
+
+}  // namespace
+
 RpcLock& rpc_lock() {
   static RpcLock lock;
   return lock;
@@ -61,11 +69,19 @@ Result<Packet> Endpoint::ProcessPacket(std::span<const std::byte> data,
 }
 
 void Endpoint::RegisterCall(Call& call) {
-  Call* const existing_call = FindCallById(
-      call.channel_id_locked(), call.service_id(), call.method_id());
+  Call* const existing_call = FindCallById(call.channel_id_locked(),
+                                           call.service_id(),
+                                           call.method_id(),
+                                           call.id());
 
   RegisterUniqueCall(call);
 
+  // Pipelined unary calls to the same method are told apart by call ID.
+  if (existing_call != nullptr && pipeline_unary_calls_ &&
+      IsUnary(call) && IsUnary(*existing_call)) {
+    return;
+  }
+
   if (existing_call != nullptr) {
     // TODO(pwbug/597): Ensure call object is locked when calling callback. For
     //     on_error, could potentially move the callback and call it after the
@@ -77,14 +93,15 @@ void Endpoint::RegisterCall(Call& call) {
 
 Call* Endpoint::FindCallById(uint32_t channel_id,
                              uint32_t service_id,
-                             uint32_t method_id) {
-  for (Call& call : calls_) {
-    if (channel_id == call.channel_id_locked() &&
-        service_id == call.service_id() && method_id == call.method_id()) {
-      return &call;
-    }
-  }
-  return nullptr;
+                             uint32_t method_id,
+                             uint32_t call_id) {
+  return FindIndexedCall(call_index_,
+                         unindexed_calls_,
+                         calls_,
+                         channel_id,
+                         service_id,
+                         method_id,
+                         call_id);
 }
 
 Status Endpoint::CloseChannel(uint32_t channel_id) {
@@ -102,6 +119,7 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
 
   while (current != calls_.end()) {
     if (channel_id == current->channel_id_locked()) {
+      RemoveFromCallIndex(*current);
       current->HandleChannelClose();
       current = calls_.erase_after(previous);  // previous stays the same
     } else {
@@ -83,6 +83,7 @@ Status FakeChannelOutput::HandlePacket(std::span<const std::byte> buffer) {
     case PacketType::DEPRECATED_CANCEL:
     case PacketType::SERVER_STREAM:
     case PacketType::CLIENT_STREAM_END:
+    case PacketType::CLIENT_FLOW_CONTROL:
       return OkStatus();
   }
   PW_CRASH("Unhandled PacketType %d", static_cast<int>(result.value().type()));
@@ -0,0 +1,208 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/loopback_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "pw_rpc/benchmark.raw_rpc.pb.h"
+#include "pw_status/try.h"
+
+namespace pw::rpc {
+namespace {
+
+using Benchmark = pw_rpc::raw::Benchmark;
+
+// Returns the sample at the given percentile. Reorders the samples.
+chrono::SystemClock::duration Percentile(
+    std::span<chrono::SystemClock::duration> samples, size_t percentile) {
+  if (samples.empty()) {
+    return chrono::SystemClock::duration(0);
+  }
+  const size_t index = (samples.size() - 1) * percentile / 100;
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+}  // namespace
+
+uint64_t BenchmarkResult::packets_per_second() const {
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(total_time).count();
+  if (nanoseconds <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(packets) * 1'000'000'000u /
+         static_cast<uint64_t>(nanoseconds);
+}
+
+Status LoopbackBenchmark::LoopbackOutput::Send(ConstByteSpan packet) {
+  if (count_ == kQueueDepth || packet.size() > kMaxPacketSizeBytes) {
+    return Status::ResourceExhausted();
+  }
+
+  QueuedPacket& entry = queue_[(head_ + count_) % kQueueDepth];
+  std::memcpy(entry.data.data(), packet.data(), packet.size());
+  entry.size = packet.size();
+  count_ += 1;
+
+  packets_ += 1;
+  bytes_ += packet.size();
+  return OkStatus();
+}
+
+ConstByteSpan LoopbackBenchmark::LoopbackOutput::Pop(ByteSpan buffer) {
+  if (count_ == 0u) {
+    return ConstByteSpan();
+  }
+
+  const QueuedPacket& entry = queue_[head_];
+  std::memcpy(buffer.data(), entry.data.data(), entry.size);
+  head_ = (head_ + 1) % kQueueDepth;
+  count_ -= 1;
+  return buffer.first(entry.size);
+}
+
+LoopbackBenchmark::LoopbackBenchmark(chrono::VirtualSystemClock& clock)
+    : clock_(clock),
+      client_output_("loopback client"),
+      server_output_("loopback server"),
+      client_channels_{Channel::Create<kChannelId>(&client_output_)},
+      server_channels_{Channel::Create<kChannelId>(&server_output_)},
+      client_(client_channels_),
+      server_(server_channels_) {
+  server_.RegisterService(service_);
+}
+
+Status LoopbackBenchmark::Pump() {
+  // Copy each packet out of its queue before processing it, since processing
+  // a packet may queue more packets.
+  while (true) {
+    if (ConstByteSpan packet = client_output_.Pop(packet_buffer_);
+        !packet.empty()) {
+      PW_TRY(server_.ProcessPacket(packet));
+    } else if (packet = server_output_.Pop(packet_buffer_); !packet.empty()) {
+      PW_TRY(client_.ProcessPacket(packet));
+    } else {
+      return OkStatus();
+    }
+  }
+}
+
+void LoopbackBenchmark::StartRun() {
+  client_output_.ResetCounters();
+  server_output_.ResetCounters();
+  sample_count_ = 0;
+  total_time_ = chrono::SystemClock::duration(0);
+  responses_ = 0;
+  rpc_status_ = OkStatus();
+}
+
+void LoopbackBenchmark::RecordLatency(chrono::SystemClock::duration latency) {
+  samples_[sample_count_ % samples_.size()] = latency;
+  sample_count_ += 1;
+  total_time_ += latency;
+}
+
+void LoopbackBenchmark::FinishRun(size_t round_trips,
+                                  BenchmarkResult& result) {
+  const std::span samples =
+      std::span(samples_).first(std::min(sample_count_, samples_.size()));
+
+  result.round_trips = round_trips;
+  result.packets = client_output_.packets() + server_output_.packets();
+  result.bytes_sent = client_output_.bytes() + server_output_.bytes();
+  result.total_time = total_time_;
+  result.p50_latency = Percentile(samples, 50);
+  result.p99_latency = Percentile(samples, 99);
+}
+
+Status LoopbackBenchmark::RunUnary(size_t payload_size,
+                                   size_t iterations,
+                                   BenchmarkResult& result) {
+  if (payload_size > payload_.size()) {
+    return Status::InvalidArgument();
+  }
+
+  const ConstByteSpan payload = std::span(payload_).first(payload_size);
+  Benchmark::Client service_client(client_, kChannelId);
+  StartRun();
+
+  for (size_t i = 0; i < iterations; ++i) {
+    const chrono::SystemClock::time_point start = clock_.now();
+
+    RawUnaryReceiver call = service_client.UnaryEcho(
+        payload,
+        [this](ConstByteSpan, Status status) {
+          responses_ += 1;
+          rpc_status_.Update(status);
+        },
+        [this](Status status) { rpc_status_.Update(status); });
+    PW_TRY(Pump());
+
+    RecordLatency(clock_.now() - start);
+
+    PW_TRY(rpc_status_);
+    if (responses_ != i + 1) {
+      return Status::Unknown();
+    }
+  }
+
+  FinishRun(iterations, result);
+  return OkStatus();
+}
+
+Status LoopbackBenchmark::RunBidirectional(size_t payload_size,
+                                           size_t iterations,
+                                           BenchmarkResult& result) {
+  if (payload_size > payload_.size()) {
+    return Status::InvalidArgument();
+  }
+
+  const ConstByteSpan payload = std::span(payload_).first(payload_size);
+  Benchmark::Client service_client(client_, kChannelId);
+
+  RawClientReaderWriter call = service_client.BidirectionalEcho(
+      [this](ConstByteSpan) { responses_ += 1; },
+      [this](Status status) { rpc_status_.Update(status); },
+      [this](Status status) { rpc_status_.Update(status); });
+  PW_TRY(Pump());
+
+  // Only measure the streamed packets, not the ones that open and close the
+  // call.
+  StartRun();
+
+  for (size_t i = 0; i < iterations; ++i) {
+    const chrono::SystemClock::time_point start = clock_.now();
+
+    PW_TRY(call.Write(payload));
+    PW_TRY(Pump());
+
+    RecordLatency(clock_.now() - start);
+
+    PW_TRY(rpc_status_);
+    if (responses_ != i + 1) {
+      return Status::Unknown();
+    }
+  }
+
+  FinishRun(iterations, result);
+
+  PW_TRY(call.Cancel());
+  return Pump();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,81 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Runs the loopback RPC benchmarks at several payload sizes and logs the
+// results. Build this for host or for a device to compare RPC dispatch
+// performance between changes.
+
+#include "pw_rpc/internal/log_config.h"
+// PW_LOG_* macros must be first.
+
+#include <chrono>
+#include <cstddef>
+
+#include "pw_log/log.h"
+#include "pw_rpc/loopback_benchmark.h"
+
+namespace {
+
+constexpr size_t kIterations = 1000;
+
+// UnaryEcho responses are limited to 32 bytes by the BenchmarkService.
+constexpr size_t kUnaryPayloadSizes[] = {0, 8, 32};
+constexpr size_t kStreamPayloadSizes[] = {0, 8, 32, 128, 256};
+
+unsigned Microseconds(pw::chrono::SystemClock::duration duration) {
+  return static_cast<unsigned>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+void LogResult(const char* rpc,
+               size_t payload_size,
+               pw::Status status,
+               const pw::rpc::BenchmarkResult& result) {
+  if (!status.ok()) {
+    PW_LOG_ERROR("%s with %u B payloads failed: %s",
+                 rpc,
+                 static_cast<unsigned>(payload_size),
+                 status.str());
+    return;
+  }
+
+  PW_LOG_INFO(
+      "%s %4u B: %7u packets/s, p50 %5u us, p99 %5u us, %4u B sent/round trip",
+      rpc,
+      static_cast<unsigned>(payload_size),
+      static_cast<unsigned>(result.packets_per_second()),
+      Microseconds(result.p50_latency),
+      Microseconds(result.p99_latency),
+      static_cast<unsigned>(result.bytes_per_round_trip()));
+}
+
+}  // namespace
+
+int main() {
+  static pw::rpc::LoopbackBenchmark benchmark;
+  pw::rpc::BenchmarkResult result = {};
+
+  for (size_t payload_size : kUnaryPayloadSizes) {
+    pw::Status status = benchmark.RunUnary(payload_size, kIterations, result);
+    LogResult("UnaryEcho", payload_size, status, result);
+  }
+
+  for (size_t payload_size : kStreamPayloadSizes) {
+    pw::Status status =
+        benchmark.RunBidirectional(payload_size, kIterations, result);
+    LogResult("BidirectionalEcho", payload_size, status, result);
+  }
+
+  return 0;
+}
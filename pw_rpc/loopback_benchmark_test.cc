@@ -0,0 +1,102 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/loopback_benchmark.h"
+
+#include "gtest/gtest.h"
+#include "pw_chrono/simulated_system_clock.h"
+
+namespace pw::rpc {
+namespace {
+
+TEST(LoopbackBenchmark, RunUnary_CountsPacketsAndBytes) {
+  LoopbackBenchmark benchmark;
+  BenchmarkResult result = {};
+
+  ASSERT_EQ(OkStatus(), benchmark.RunUnary(16, 10, result));
+
+  EXPECT_EQ(result.round_trips, 10u);
+  EXPECT_EQ(result.packets, 20u);  // One request and one response per call.
+  EXPECT_GT(result.bytes_per_round_trip(), 2u * 16u);
+  EXPECT_LE(result.p50_latency, result.p99_latency);
+}
+
+TEST(LoopbackBenchmark, RunUnary_ResponseTooLarge_Fails) {
+  LoopbackBenchmark benchmark;
+  BenchmarkResult result = {};
+
+  EXPECT_EQ(Status::ResourceExhausted(), benchmark.RunUnary(33, 1, result));
+}
+
+TEST(LoopbackBenchmark, RunBidirectional_CountsStreamPacketsOnly) {
+  LoopbackBenchmark benchmark;
+  BenchmarkResult result = {};
+
+  ASSERT_EQ(OkStatus(), benchmark.RunBidirectional(128, 10, result));
+
+  EXPECT_EQ(result.round_trips, 10u);
+  EXPECT_EQ(result.packets, 20u);
+  EXPECT_GT(result.bytes_per_round_trip(), 2u * 128u);
+}
+
+TEST(LoopbackBenchmark, Run_RepeatedRunsAreIndependent) {
+  LoopbackBenchmark benchmark;
+  BenchmarkResult first = {};
+  BenchmarkResult second = {};
+
+  ASSERT_EQ(OkStatus(), benchmark.RunBidirectional(8, 5, first));
+  ASSERT_EQ(OkStatus(), benchmark.RunBidirectional(8, 5, second));
+  ASSERT_EQ(OkStatus(), benchmark.RunUnary(8, 5, second));
+
+  EXPECT_EQ(first.packets, 10u);
+  EXPECT_EQ(second.packets, 10u);
+}
+
+TEST(LoopbackBenchmark, Run_PayloadTooLarge_InvalidArgument) {
+  LoopbackBenchmark benchmark;
+  BenchmarkResult result = {};
+
+  EXPECT_EQ(Status::InvalidArgument(),
+            benchmark.RunUnary(LoopbackBenchmark::kMaxPayloadSizeBytes + 1,
+                               1,
+                               result));
+  EXPECT_EQ(Status::InvalidArgument(),
+            benchmark.RunBidirectional(
+                LoopbackBenchmark::kMaxPayloadSizeBytes + 1, 1, result));
+}
+
+TEST(LoopbackBenchmark, Latency_UsesProvidedClock) {
+  chrono::SimulatedSystemClock clock;
+  LoopbackBenchmark benchmark(clock);
+  BenchmarkResult result = {};
+
+  ASSERT_EQ(OkStatus(), benchmark.RunUnary(0, 3, result));
+
+  // The simulated clock never advances, so no time elapses.
+  EXPECT_EQ(result.total_time.count(), 0);
+  EXPECT_EQ(result.p99_latency.count(), 0);
+  EXPECT_EQ(result.packets_per_second(), 0u);
+}
+
+TEST(BenchmarkResult, PacketsPerSecond) {
+  BenchmarkResult result = {};
+  result.packets = 500;
+  result.total_time = std::chrono::duration_cast<chrono::SystemClock::duration>(
+      std::chrono::milliseconds(250));
+
+  EXPECT_EQ(result.packets_per_second(), 2000u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
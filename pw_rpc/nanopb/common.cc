@@ -43,9 +43,11 @@ struct NanopbTraits<bool(pb_istream_t*, FieldsType, void*)> {
 
 using Fields = typename NanopbTraits<decltype(pb_decode)>::Fields;
 
-Result<ByteSpan> EncodeToPayloadBuffer(const void* payload, NanopbSerde serde)
+Result<ByteSpan> EncodeToPayloadBuffer(Call& call,
+                                       const void* payload,
+                                       NanopbSerde serde)
     PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-  ByteSpan payload_buffer = GetPayloadBuffer();
+  ByteSpan payload_buffer = call.PayloadBufferLocked();
   StatusWithSize result = serde.Encode(payload, payload_buffer);
   if (!result.ok()) {
     return result.status();
@@ -104,7 +106,7 @@ void NanopbSendInitialRequest(ClientCall& call,
                               const void* payload) {
   PW_DCHECK(call.active_locked());
 
-  Result<ByteSpan> result = EncodeToPayloadBuffer(payload, serde);
+  Result<ByteSpan> result = EncodeToPayloadBuffer(call, payload, serde);
 
   if (result.ok()) {
     call.SendInitialClientRequest(*result);
@@ -119,7 +121,7 @@ Status NanopbSendStream(Call& call, const void* payload, NanopbSerde serde) {
     return Status::FailedPrecondition();
   }
 
-  Result<ByteSpan> result = EncodeToPayloadBuffer(payload, serde);
+  Result<ByteSpan> result = EncodeToPayloadBuffer(call, payload, serde);
 
   PW_TRY(result.status());
   return call.WriteLocked(*result);
@@ -134,7 +136,7 @@ Status SendFinalResponse(NanopbServerCall& call,
   }
 
   Result<ByteSpan> result =
-      EncodeToPayloadBuffer(payload, call.serde().response());
+      EncodeToPayloadBuffer(call, payload, call.serde().response());
   if (!result.ok()) {
     return call.CloseAndSendServerErrorLocked(Status::Internal());
   }
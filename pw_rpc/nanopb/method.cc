@@ -31,6 +31,12 @@ void NanopbMethod::CallSynchronousUnary(const CallContext& context,
                                         const Packet& request,
                                         void* request_struct,
                                         void* response_struct) const {
+  if (response_struct == nullptr) {
+    SendServerError(context, request, Status::ResourceExhausted());
+    rpc_lock().unlock();
+    return;
+  }
+
   if (!DecodeRequest(context, request, request_struct)) {
     rpc_lock().unlock();
     return;
@@ -60,19 +66,32 @@ void NanopbMethod::CallUnaryRequest(const CallContext& context,
 bool NanopbMethod::DecodeRequest(const CallContext& context,
                                  const Packet& request,
                                  void* proto_struct) const {
+  if (proto_struct == nullptr) {
+    SendServerError(context, request, Status::ResourceExhausted());
+    PW_LOG_WARN("No Nanopb request arena space for request on channel %u",
+                unsigned(context.channel_id()));
+    return false;
+  }
+
   if (serde_.DecodeRequest(request.payload(), proto_struct)) {
     return true;
   }
 
+  SendServerError(context, request, Status::DataLoss());
+  PW_LOG_WARN("Nanopb failed to decode request payload from channel %u",
+              unsigned(context.channel_id()));
+  return false;
+}
+
+void NanopbMethod::SendServerError(const CallContext& context,
+                                   const Packet& request,
+                                   Status status) {
   // The channel is known to exist. It was found when the request was processed
   // and the lock has been held since, so GetInternalChannel cannot fail.
   static_cast<internal::Channel*>(
       context.server().GetInternalChannel(context.channel_id()))
-      ->Send(Packet::ServerError(request, Status::DataLoss()))
+      ->Send(Packet::ServerError(request, status))
       .IgnoreError();
-  PW_LOG_WARN("Nanopb failed to decode request payload from channel %u",
-              unsigned(context.channel_id()));
-  return false;
 }
 
 }  // namespace internal
@@ -0,0 +1,37 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// System header for Nanopb builds that decode pointer-backed fields into the
+// pw_rpc Nanopb request arena. Nanopb includes this file in place of the C
+// standard headers when PB_SYSTEM_HEADER is set to it, which the
+// pw_rpc/nanopb:arena_decoding config does.
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pw_preprocessor/util.h"
+
+PW_EXTERN_C_START
+
+void* pw_rpc_nanopb_ArenaRealloc(void* ptr, size_t size);
+void pw_rpc_nanopb_ArenaFree(void* ptr);
+
+PW_EXTERN_C_END
+
+#define pb_realloc(ptr, size) pw_rpc_nanopb_ArenaRealloc(ptr, size)
+#define pb_free(ptr) pw_rpc_nanopb_ArenaFree(ptr)
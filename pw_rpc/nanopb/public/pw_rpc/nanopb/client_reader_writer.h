@@ -245,6 +245,7 @@ class NanopbClientReaderWriter
 
   using internal::Call::Cancel;
   using internal::Call::CloseClientStream;
+  using internal::Call::GrantCredit;
 
   // Functions for setting RPC event callbacks.
   using internal::Call::set_on_error;
@@ -290,6 +291,7 @@ class NanopbClientReader
   using internal::StreamResponseClientCall::set_on_completed;
 
   using internal::Call::Cancel;
+  using internal::Call::GrantCredit;
 
  private:
   friend class internal::NanopbStreamResponseClientCall<Response>;
@@ -25,6 +25,7 @@
 #include "pw_rpc/internal/method.h"
 #include "pw_rpc/method_type.h"
 #include "pw_rpc/nanopb/internal/common.h"
+#include "pw_rpc/nanopb/request_arena.h"
 #include "pw_rpc/nanopb/server_reader_writer.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
@@ -332,20 +333,35 @@ class NanopbMethod : public Method {
   // Invoker function for synchronous unary RPCs. Allocates request and response
   // structs by size, with maximum alignment, to avoid generating unnecessary
   // copies of this function for each request/response type.
+  //
+  // The structs are allocated from the request arena if
+  // PW_RPC_NANOPB_ARENA_DECODING is enabled. Any arena memory used for the
+  // call, including pointer fields in the request, is released on return.
   template <size_t kRequestSize, size_t kResponseSize>
   static void SynchronousUnaryInvoker(const CallContext& context,
                                       const Packet& request)
       PW_UNLOCK_FUNCTION(rpc_lock()) {
-    _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
-    std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
-        request_struct{};
-    _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
-    std::aligned_storage_t<kResponseSize, alignof(std::max_align_t)>
-        response_struct{};
-
-    static_cast<const NanopbMethod&>(context.method())
-        .CallSynchronousUnary(
-            context, request, &request_struct, &response_struct);
+    NanopbRequestArenaScope arena;
+
+    if constexpr (cfg::kNanopbArenaDecodingEnabled<>) {
+      void* request_struct = arena.AllocateStruct(kRequestSize);
+      void* response_struct = arena.AllocateStruct(kResponseSize);
+
+      static_cast<const NanopbMethod&>(context.method())
+          .CallSynchronousUnary(
+              context, request, request_struct, response_struct);
+    } else {
+      _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
+      std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
+          request_struct{};
+      _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
+      std::aligned_storage_t<kResponseSize, alignof(std::max_align_t)>
+          response_struct{};
+
+      static_cast<const NanopbMethod&>(context.method())
+          .CallSynchronousUnary(
+              context, request, &request_struct, &response_struct);
+    }
   }
 
   // Invoker function for asynchronous unary RPCs. Allocates space for a request
@@ -355,13 +371,23 @@ class NanopbMethod : public Method {
   static void AsynchronousUnaryInvoker(const CallContext& context,
                                        const Packet& request)
       PW_UNLOCK_FUNCTION(rpc_lock()) {
-    _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
-    std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
-        request_struct{};
-
-    static_cast<const NanopbMethod&>(context.method())
-        .CallUnaryRequest(
-            context, MethodType::kUnary, request, &request_struct);
+    NanopbRequestArenaScope arena;
+
+    if constexpr (cfg::kNanopbArenaDecodingEnabled<>) {
+      static_cast<const NanopbMethod&>(context.method())
+          .CallUnaryRequest(context,
+                            MethodType::kUnary,
+                            request,
+                            arena.AllocateStruct(kRequestSize));
+    } else {
+      _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
+      std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
+          request_struct{};
+
+      static_cast<const NanopbMethod&>(context.method())
+          .CallUnaryRequest(
+              context, MethodType::kUnary, request, &request_struct);
+    }
   }
 
   // Invoker function for server streaming RPCs. Allocates space for a request
@@ -371,13 +397,23 @@ class NanopbMethod : public Method {
   static void ServerStreamingInvoker(const CallContext& context,
                                      const Packet& request)
       PW_UNLOCK_FUNCTION(rpc_lock()) {
-    _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
-    std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
-        request_struct{};
-
-    static_cast<const NanopbMethod&>(context.method())
-        .CallUnaryRequest(
-            context, MethodType::kServerStreaming, request, &request_struct);
+    NanopbRequestArenaScope arena;
+
+    if constexpr (cfg::kNanopbArenaDecodingEnabled<>) {
+      static_cast<const NanopbMethod&>(context.method())
+          .CallUnaryRequest(context,
+                            MethodType::kServerStreaming,
+                            request,
+                            arena.AllocateStruct(kRequestSize));
+    } else {
+      _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
+      std::aligned_storage_t<kRequestSize, alignof(std::max_align_t)>
+          request_struct{};
+
+      static_cast<const NanopbMethod&>(context.method())
+          .CallUnaryRequest(
+              context, MethodType::kServerStreaming, request, &request_struct);
+    }
   }
 
   // Invoker function for client streaming RPCs.
@@ -404,12 +440,19 @@ class NanopbMethod : public Method {
   }
 
   // Decodes a request protobuf with Nanopb to the provided buffer. Sends an
-  // error packet if the request failed to decode.
+  // error packet if the request failed to decode or if proto_struct is null,
+  // which happens when the request arena could not allocate it.
   bool DecodeRequest(const CallContext& context,
                      const Packet& request,
                      void* proto_struct) const
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Sends a SERVER_ERROR packet in response to a request.
+  static void SendServerError(const CallContext& context,
+                              const Packet& request,
+                              Status status)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Stores the user-defined RPC in a generic wrapper.
   Function function_;
 
@@ -0,0 +1,66 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "pw_allocator/arena.h"
+
+namespace pw::rpc {
+
+// Sets the arena used while decoding Nanopb RPC requests, or clears it if arena
+// is nullptr.
+//
+// If PW_RPC_NANOPB_ARENA_DECODING is enabled, request and response structs for
+// unary and server streaming RPCs are allocated from this arena instead of the
+// stack. If Nanopb is built with the pw_rpc/nanopb:arena_decoding config,
+// pointer-backed repeated and bytes fields in requests are also allocated from
+// it, so large messages need neither big fixed-size arrays nor field callbacks.
+//
+// Everything allocated while handling a request is released when the RPC
+// function or on_next callback returns, so the request struct must not be
+// referenced afterwards. The arena is shared by all calls, so packets must be
+// processed by one thread at a time.
+void SetNanopbRequestArena(allocator::Arena* arena);
+
+namespace internal {
+
+// Releases everything allocated from the request arena during its lifetime.
+// The Nanopb allocation hooks only allocate while a scope is active, so pointer
+// fields in messages decoded outside of request handling (e.g. client
+// responses) fail to decode instead of leaking arena memory.
+class NanopbRequestArenaScope {
+ public:
+  NanopbRequestArenaScope();
+  ~NanopbRequestArenaScope();
+
+  NanopbRequestArenaScope(const NanopbRequestArenaScope&) = delete;
+  NanopbRequestArenaScope& operator=(const NanopbRequestArenaScope&) = delete;
+
+  // Allocates a zero-initialized, maximally aligned struct. Returns nullptr if
+  // no arena is set or there is not enough space.
+  void* AllocateStruct(size_t size);
+
+ private:
+  std::optional<allocator::ArenaScope> scope_;
+};
+
+// Allocation hooks for Nanopb's pb_realloc and pb_free.
+void* NanopbArenaReallocate(void* ptr, size_t size);
+void NanopbArenaFree(void* ptr);
+
+}  // namespace internal
+}  // namespace pw::rpc
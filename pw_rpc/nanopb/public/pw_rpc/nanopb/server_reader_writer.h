@@ -24,6 +24,7 @@
 #include "pw_rpc/internal/method_lookup.h"
 #include "pw_rpc/internal/server_call.h"
 #include "pw_rpc/nanopb/internal/common.h"
+#include "pw_rpc/nanopb/request_arena.h"
 #include "pw_rpc/server.h"
 
 namespace pw::rpc {
@@ -118,6 +119,9 @@ class BaseNanopbServerReader : public NanopbServerCall {
 
     internal::Call::set_on_next_locked([this](ConstByteSpan payload) {
       if (nanopb_on_next_) {
+        // Pointer fields are allocated from the request arena, if one is set,
+        // and released once on_next returns.
+        NanopbRequestArenaScope arena;
         Request request_struct{};
         if (DecodeRequest(payload, &request_struct)) {
           nanopb_on_next_(request_struct);
@@ -0,0 +1,109 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/nanopb/request_arena.h"
+
+#include <cstring>
+#include <new>
+
+#include "pw_rpc/nanopb/arena_system_header.h"
+
+namespace pw::rpc {
+namespace internal {
+namespace {
+
+allocator::Arena* request_arena = nullptr;
+size_t active_scopes = 0;
+
+// Nanopb's pb_realloc does not pass the old size, so each pointer field
+// allocation is prefixed with a header that records it.
+struct alignas(std::max_align_t) AllocationHeader {
+  size_t size;
+};
+
+}  // namespace
+
+NanopbRequestArenaScope::NanopbRequestArenaScope() {
+  if (request_arena != nullptr) {
+    scope_.emplace(*request_arena);
+  }
+  active_scopes += 1;
+}
+
+NanopbRequestArenaScope::~NanopbRequestArenaScope() { active_scopes -= 1; }
+
+void* NanopbRequestArenaScope::AllocateStruct(size_t size) {
+  if (!scope_.has_value()) {
+    return nullptr;
+  }
+  void* ptr = request_arena->Allocate(size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, size);
+  }
+  return ptr;
+}
+
+void* NanopbArenaReallocate(void* ptr, size_t size) {
+  if (active_scopes == 0u || request_arena == nullptr) {
+    return nullptr;
+  }
+
+  size_t old_size = 0;
+  if (ptr != nullptr) {
+    AllocationHeader& header = static_cast<AllocationHeader*>(ptr)[-1];
+    old_size = header.size;
+
+    // Nanopb grows repeated fields one element at a time. Growing the most
+    // recent allocation in place keeps that from copying the field each time.
+    if (request_arena->Resize(ptr, old_size, size)) {
+      header.size = size;
+      return ptr;
+    }
+    if (size <= old_size) {
+      return ptr;
+    }
+  }
+
+  void* block = request_arena->Allocate(sizeof(AllocationHeader) + size);
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  AllocationHeader* header = new (block) AllocationHeader{size};
+  void* new_ptr = header + 1;
+  if (ptr != nullptr) {
+    std::memcpy(new_ptr, ptr, old_size);
+  }
+  return new_ptr;
+}
+
+void NanopbArenaFree(void*) {
+  // Arena memory is released all at once when the request scope ends.
+}
+
+}  // namespace internal
+
+void SetNanopbRequestArena(allocator::Arena* arena) {
+  internal::request_arena = arena;
+}
+
+}  // namespace pw::rpc
+
+extern "C" void* pw_rpc_nanopb_ArenaRealloc(void* ptr, size_t size) {
+  return pw::rpc::internal::NanopbArenaReallocate(ptr, size);
+}
+
+extern "C" void pw_rpc_nanopb_ArenaFree(void* ptr) {
+  pw::rpc::internal::NanopbArenaFree(ptr);
+}
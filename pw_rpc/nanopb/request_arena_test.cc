@@ -0,0 +1,100 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/nanopb/request_arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+class NanopbRequestArena : public ::testing::Test {
+ protected:
+  NanopbRequestArena() : arena_(buffer_) { SetNanopbRequestArena(&arena_); }
+  ~NanopbRequestArena() override { SetNanopbRequestArena(nullptr); }
+
+  std::byte buffer_[256] = {};
+  allocator::Arena arena_;
+};
+
+TEST_F(NanopbRequestArena, AllocateStruct_ZeroInitialized) {
+  std::memset(buffer_, 0xa5, sizeof(buffer_));
+
+  NanopbRequestArenaScope scope;
+  auto* value = static_cast<uint32_t*>(scope.AllocateStruct(sizeof(uint32_t)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 0u);
+}
+
+TEST_F(NanopbRequestArena, AllocateStruct_NoArena) {
+  SetNanopbRequestArena(nullptr);
+
+  NanopbRequestArenaScope scope;
+  EXPECT_EQ(scope.AllocateStruct(4), nullptr);
+  EXPECT_EQ(NanopbArenaReallocate(nullptr, 4), nullptr);
+}
+
+TEST_F(NanopbRequestArena, Reallocate_FailsOutsideOfScope) {
+  EXPECT_EQ(NanopbArenaReallocate(nullptr, 4), nullptr);
+}
+
+TEST_F(NanopbRequestArena, Reallocate_GrowsLastAllocationInPlace) {
+  NanopbRequestArenaScope scope;
+  auto* data = static_cast<uint8_t*>(NanopbArenaReallocate(nullptr, 2));
+  ASSERT_NE(data, nullptr);
+  data[0] = 1;
+  data[1] = 2;
+
+  EXPECT_EQ(NanopbArenaReallocate(data, 3), data);
+  EXPECT_EQ(data[0], 1);
+  EXPECT_EQ(data[1], 2);
+}
+
+TEST_F(NanopbRequestArena, Reallocate_CopiesEarlierAllocations) {
+  NanopbRequestArenaScope scope;
+  auto* first = static_cast<uint8_t*>(NanopbArenaReallocate(nullptr, 2));
+  ASSERT_NE(first, nullptr);
+  first[0] = 1;
+  first[1] = 2;
+  ASSERT_NE(NanopbArenaReallocate(nullptr, 2), nullptr);
+
+  auto* moved = static_cast<uint8_t*>(NanopbArenaReallocate(first, 4));
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(moved, first);
+  EXPECT_EQ(moved[0], 1);
+  EXPECT_EQ(moved[1], 2);
+}
+
+TEST_F(NanopbRequestArena, Scope_ReleasesAllocations) {
+  void* first;
+  {
+    NanopbRequestArenaScope scope;
+    first = scope.AllocateStruct(64);
+    ASSERT_NE(first, nullptr);
+  }
+
+  NanopbRequestArenaScope scope;
+  EXPECT_EQ(scope.AllocateStruct(64), first);
+}
+
+TEST_F(NanopbRequestArena, Reallocate_OutOfSpace) {
+  NanopbRequestArenaScope scope;
+  EXPECT_EQ(NanopbArenaReallocate(nullptr, sizeof(buffer_)), nullptr);
+}
+
+}  // namespace
+}  // namespace pw::rpc::internal
@@ -14,65 +14,212 @@
 
 #include "pw_rpc/internal/packet.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "pw_bytes/endian.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
+namespace {
 
-Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
-  Packet packet;
+using protobuf::FieldKey;
+using protobuf::WireType;
+
+// The RpcPacket field numbers are all below 16, so every key fits in a single
+// byte. Precomputing them lets the common packet layout be encoded and decoded
+// without going through the generic protobuf encoder and decoder.
+constexpr uint8_t Key(RpcPacket::Fields field, WireType wire_type) {
+  return static_cast<uint8_t>(
+      FieldKey(static_cast<uint32_t>(field), wire_type));
+}
+
+constexpr uint8_t kTypeKey = Key(RpcPacket::Fields::TYPE, WireType::kVarint);
+constexpr uint8_t kChannelIdKey =
+    Key(RpcPacket::Fields::CHANNEL_ID, WireType::kVarint);
+constexpr uint8_t kServiceIdKey =
+    Key(RpcPacket::Fields::SERVICE_ID, WireType::kFixed32);
+constexpr uint8_t kMethodIdKey =
+    Key(RpcPacket::Fields::METHOD_ID, WireType::kFixed32);
+constexpr uint8_t kPayloadKey =
+    Key(RpcPacket::Fields::PAYLOAD, WireType::kDelimited);
+constexpr uint8_t kStatusKey =
+    Key(RpcPacket::Fields::STATUS, WireType::kVarint);
+constexpr uint8_t kCallIdKey =
+    Key(RpcPacket::Fields::CALL_ID, WireType::kVarint);
+constexpr uint8_t kCreditKey =
+    Key(RpcPacket::Fields::CREDIT, WireType::kVarint);
+
+static_assert(static_cast<uint32_t>(RpcPacket::Fields::CREDIT) < 16,
+              "RpcPacket keys must fit in one byte for the fixed-layout codec");
+
+// Decodes a packet in a single pass over the buffer. Returns false if the data
+// contains anything other than well-formed, known RpcPacket fields, in which
+// case the packet must be decoded with the generic protobuf decoder.
+bool DecodeFixedLayout(ConstByteSpan data, Packet& packet) {
+  const std::byte* pos = data.data();
+  const std::byte* const end = pos + data.size();
+
+  while (pos != end) {
+    const uint8_t key = static_cast<uint8_t>(*pos++);
+
+    if (key == kServiceIdKey || key == kMethodIdKey) {
+      if (end - pos < static_cast<ptrdiff_t>(sizeof(uint32_t))) {
+        return false;
+      }
+      const uint32_t id =
+          bytes::ReadInOrder<uint32_t>(std::endian::little, pos);
+      pos += sizeof(uint32_t);
+
+      if (key == kServiceIdKey) {
+        packet.set_service_id(id);
+      } else {
+        packet.set_method_id(id);
+      }
+      continue;
+    }
+
+    uint64_t value;
+    const size_t varint_size =
+        varint::Decode(ConstByteSpan(pos, static_cast<size_t>(end - pos)),
+                       &value);
+    if (varint_size == 0u) {
+      return false;
+    }
+    pos += varint_size;
+
+    if (key == kPayloadKey) {
+      if (value > static_cast<uint64_t>(end - pos)) {
+        return false;
+      }
+      packet.set_payload(ConstByteSpan(pos, static_cast<size_t>(value)));
+      pos += value;
+      continue;
+    }
+
+    if (value > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+    const uint32_t value32 = static_cast<uint32_t>(value);
+
+    switch (key) {
+      case kTypeKey:
+        packet.set_type(static_cast<PacketType>(value32));
+        break;
+      case kChannelIdKey:
+        packet.set_channel_id(value32);
+        break;
+      case kStatusKey:
+        packet.set_status(static_cast<Status::Code>(value32));
+        break;
+      case kCallIdKey:
+        packet.set_call_id(value32);
+        break;
+      case kCreditKey:
+        packet.set_credit(value32);
+        break;
+      default:
+        return false;  // Unknown field or unexpected wire type.
+    }
+  }
+
+  return true;
+}
+
+// Decodes a packet with the generic protobuf decoder. Unknown fields are
+// skipped.
+Status DecodeGeneric(ConstByteSpan data, Packet& packet) {
   Status status;
   protobuf::Decoder decoder(data);
 
   while ((status = decoder.Next()).ok()) {
     RpcPacket::Fields field =
         static_cast<RpcPacket::Fields>(decoder.FieldNumber());
+    uint32_t value = 0;
 
+    // A decode error in any of the reads below will propagate from Next() and
+    // terminate the loop.
     switch (field) {
-      case RpcPacket::Fields::TYPE: {
-        uint32_t value;
-        // A decode error will propagate from Next() and terminate the loop.
+      case RpcPacket::Fields::TYPE:
         decoder.ReadUint32(&value).IgnoreError();
         packet.set_type(static_cast<PacketType>(value));
         break;
-      }
 
       case RpcPacket::Fields::CHANNEL_ID:
-        // A decode error will propagate from Next() and terminate the loop.
-        decoder.ReadUint32(&packet.channel_id_).IgnoreError();
+        decoder.ReadUint32(&value).IgnoreError();
+        packet.set_channel_id(value);
         break;
 
       case RpcPacket::Fields::SERVICE_ID:
-        // A decode error will propagate from Next() and terminate the loop.
-        decoder.ReadFixed32(&packet.service_id_).IgnoreError();
+        decoder.ReadFixed32(&value).IgnoreError();
+        packet.set_service_id(value);
         break;
 
       case RpcPacket::Fields::METHOD_ID:
-        // A decode error will propagate from Next() and terminate the loop.
-        decoder.ReadFixed32(&packet.method_id_).IgnoreError();
+        decoder.ReadFixed32(&value).IgnoreError();
+        packet.set_method_id(value);
         break;
 
-      case RpcPacket::Fields::PAYLOAD:
-        // A decode error will propagate from Next() and terminate the loop.
-        decoder.ReadBytes(&packet.payload_).IgnoreError();
+      case RpcPacket::Fields::PAYLOAD: {
+        ConstByteSpan payload;
+        decoder.ReadBytes(&payload).IgnoreError();
+        packet.set_payload(payload);
         break;
+      }
 
-      case RpcPacket::Fields::STATUS: {
-        uint32_t value;
-        // A decode error will propagate from Next() and terminate the loop.
+      case RpcPacket::Fields::STATUS:
         decoder.ReadUint32(&value).IgnoreError();
         packet.set_status(static_cast<Status::Code>(value));
         break;
-      }
 
       case RpcPacket::Fields::CALL_ID:
-        // A decode error will propagate from Next() and terminate the loop.
-        decoder.ReadUint32(&packet.call_id_).IgnoreError();
+        decoder.ReadUint32(&value).IgnoreError();
+        packet.set_call_id(value);
+        break;
+
+      case RpcPacket::Fields::CREDIT:
+        decoder.ReadUint32(&value).IgnoreError();
+        packet.set_credit(value);
         break;
     }
   }
 
-  if (status.IsDataLoss()) {
-    return status;
+  return status;
+}
+
+std::byte* WriteVarintField(std::byte* pos, uint8_t key, uint32_t value) {
+  *pos++ = static_cast<std::byte>(key);
+  return pos +
+         varint::Encode(value, ByteSpan(pos, varint::kMaxVarint32SizeBytes));
+}
+
+std::byte* WriteFixed32Field(std::byte* pos, uint8_t key, uint32_t value) {
+  *pos++ = static_cast<std::byte>(key);
+  const auto encoded = bytes::CopyInOrder(std::endian::little, value);
+  std::memcpy(pos, encoded.data(), encoded.size());
+  return pos + encoded.size();
+}
+
+constexpr size_t VarintFieldSize(uint32_t value) {
+  return 1 + varint::EncodedSize(value);
+}
+
+}  // namespace
+
+Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
+  Packet packet;
+
+  // Nearly all packets contain only the fixed set of RpcPacket fields, so try
+  // the single-pass decoder first and fall back to the generic decoder, which
+  // handles unknown fields and reports malformed data, only if that fails.
+  if (!DecodeFixedLayout(data, packet)) {
+    packet = Packet();
+    if (Status status = DecodeGeneric(data, packet); status.IsDataLoss()) {
+      return status;
+    }
   }
 
   // TODO(pwbug/512): CANCEL is equivalent to CLIENT_ERROR with status
@@ -85,32 +232,85 @@ Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
 }
 
 Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
-  RpcPacket::MemoryEncoder rpc_packet(buffer);
+  // The header always uses the same small set of fields, so encode them
+  // directly with precomputed keys instead of through RpcPacket::MemoryEncoder.
+  // The output is byte-for-byte identical to the generic encoder's.
+  const size_t payload_field_size =
+      payload_.empty()
+          ? 0
+          : VarintFieldSize(static_cast<uint32_t>(payload_.size())) +
+                payload_.size();
+
+  const size_t encoded_size = payload_field_size + EncodedHeaderSize();
 
-  // The payload is encoded first, as it may share the encode buffer.
+  if (encoded_size > buffer.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  std::byte* pos = buffer.data();
+
+  // The payload is encoded first, as it may share the encode buffer. Move it
+  // into place before writing its key and length so that they cannot
+  // overwrite it.
   if (!payload_.empty()) {
-    rpc_packet.WritePayload(payload_).IgnoreError();
+    const size_t prefix_size = payload_field_size - payload_.size();
+    std::memmove(pos + prefix_size, payload_.data(), payload_.size());
+    WriteVarintField(pos, kPayloadKey, static_cast<uint32_t>(payload_.size()));
+    pos += payload_field_size;
   }
 
-  rpc_packet.WriteType(type_).IgnoreError();
-  rpc_packet.WriteChannelId(channel_id_).IgnoreError();
-  rpc_packet.WriteServiceId(service_id_).IgnoreError();
-  rpc_packet.WriteMethodId(method_id_).IgnoreError();
+  pos = WriteVarintField(pos, kTypeKey, static_cast<uint32_t>(type_));
+  pos = WriteVarintField(pos, kChannelIdKey, channel_id_);
+  pos = WriteFixed32Field(pos, kServiceIdKey, service_id_);
+  pos = WriteFixed32Field(pos, kMethodIdKey, method_id_);
+
+  if (status_.code() != 0) {
+    pos = WriteVarintField(pos, kStatusKey, status_.code());
+  }
+  if (call_id_ != 0) {
+    pos = WriteVarintField(pos, kCallIdKey, call_id_);
+  }
+  if (credit_ != 0) {
+    pos = WriteVarintField(pos, kCreditKey, credit_);
+  }
+
+  return ConstByteSpan(buffer.data(), static_cast<size_t>(pos - buffer.data()));
+}
+
+size_t Packet::EncodedHeaderSize() const {
+  size_t encoded_size = VarintFieldSize(static_cast<uint32_t>(type_)) +
+                        VarintFieldSize(channel_id_) +
+                        2 * (1 + sizeof(uint32_t));  // service_id, method_id
 
   // Status code 0 is OK. In protobufs, 0 is the default int value, so skip
   // encoding it to save two bytes in the output.
   if (status_.code() != 0) {
-    rpc_packet.WriteStatus(status_.code()).IgnoreError();
+    encoded_size += VarintFieldSize(status_.code());
   }
-
   if (call_id_ != 0) {
-    rpc_packet.WriteCallId(call_id_).IgnoreError();
+    encoded_size += VarintFieldSize(call_id_);
+  }
+  if (credit_ != 0) {
+    encoded_size += VarintFieldSize(credit_);
+  }
+  return encoded_size;
+}
+
+size_t Packet::MaxPayloadSize(size_t packet_size_bytes) const {
+  const size_t header_size = EncodedHeaderSize();
+  if (packet_size_bytes <= header_size + 1) {
+    return 0;  // A payload needs at least its key and length.
   }
 
-  if (rpc_packet.status().ok()) {
-    return ConstByteSpan(rpc_packet);
+  // The payload's length prefix grows with the payload, so shrink the payload
+  // until it and its prefix fit.
+  const size_t available = packet_size_bytes - header_size;
+  size_t payload_size = std::min<size_t>(available - 2, UINT32_MAX);
+  while (VarintFieldSize(static_cast<uint32_t>(payload_size)) + payload_size >
+         available) {
+    payload_size -= 1;
   }
-  return rpc_packet.status();
+  return payload_size;
 }
 
 size_t Packet::MinEncodedSizeBytes() const {
@@ -115,6 +115,59 @@ TEST(Packet, Decode_InvalidPacket) {
   EXPECT_EQ(Status::DataLoss(), Packet::FromBuffer(bad_data).status());
 }
 
+TEST(Packet, Decode_UnknownFieldIsSkipped) {
+  std::array<byte, kEncoded.size() + 2> encoded{};
+  std::memcpy(encoded.data(), kEncoded.data(), kEncoded.size());
+  encoded[kEncoded.size()] =
+      byte(uint32_t(FieldKey(15, protobuf::WireType::kVarint)));
+  encoded[kEncoded.size() + 1] = byte{0x7f};
+
+  auto result = Packet::FromBuffer(encoded);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(PacketType::RESPONSE, result.value().type());
+  EXPECT_EQ(1u, result.value().channel_id());
+  EXPECT_EQ(42u, result.value().service_id());
+  EXPECT_EQ(100u, result.value().method_id());
+  EXPECT_EQ(7u, result.value().call_id());
+  EXPECT_EQ(kPayload.size(), result.value().payload().size());
+}
+
+TEST(Packet, Decode_TruncatedPayload) {
+  constexpr auto kTruncated = bytes::Array<
+      uint32_t(FieldKey(5, protobuf::WireType::kDelimited)), 0x04, 0x82>();
+  EXPECT_EQ(Status::DataLoss(), Packet::FromBuffer(kTruncated).status());
+}
+
+TEST(Packet, Encode_PayloadSharesBuffer) {
+  byte buffer[64] = {};
+  const size_t offset = Packet::kMinEncodedSizeWithoutPayload;
+  std::memcpy(&buffer[offset], kPayload.data(), kPayload.size());
+
+  Packet packet(PacketType::RESPONSE,
+                1,
+                42,
+                100,
+                7,
+                std::span(&buffer[offset], kPayload.size()));
+
+  auto result = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kEncoded.size(), result.value().size());
+  EXPECT_EQ(std::memcmp(kEncoded.data(), buffer, kEncoded.size()), 0);
+}
+
+TEST(Packet, Encode_ExactFit) {
+  byte buffer[kEncoded.size()];
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, kPayload);
+
+  auto result = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kEncoded.size(), result.value().size());
+
+  byte small_buffer[kEncoded.size() - 1];
+  EXPECT_EQ(Status::ResourceExhausted(), packet.Encode(small_buffer).status());
+}
+
 TEST(Packet, EncodeDecode) {
   constexpr byte payload[]{byte(0x00), byte(0x01), byte(0x02), byte(0x03)};
 
@@ -148,6 +201,35 @@ TEST(Packet, EncodeDecode) {
   EXPECT_EQ(decoded.status(), Status::Unavailable());
 }
 
+TEST(Packet, EncodeDecode_Credit) {
+  Packet packet(PacketType::CLIENT_FLOW_CONTROL, 12, 0xdeadbeef, 0x03a82921);
+  packet.set_credit(300);
+
+  byte buffer[128];
+  Result result = packet.Encode(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+
+  auto decode_result = Packet::FromBuffer(result.value());
+  ASSERT_TRUE(decode_result.ok());
+  EXPECT_EQ(decode_result.value().type(), PacketType::CLIENT_FLOW_CONTROL);
+  EXPECT_EQ(decode_result.value().credit(), 300u);
+}
+
+TEST(Packet, Encode_ZeroCreditIsOmitted) {
+  byte with_credit[128];
+  byte without_credit[128];
+
+  Packet packet(PacketType::SERVER_STREAM, 1, 42, 100);
+  Result<ConstByteSpan> encoded = packet.Encode(without_credit);
+  ASSERT_EQ(encoded.status(), OkStatus());
+  const size_t size_without_credit = encoded.value().size();
+
+  packet.set_credit(1);
+  encoded = packet.Encode(with_credit);
+  ASSERT_EQ(encoded.status(), OkStatus());
+  EXPECT_EQ(encoded.value().size(), size_without_credit + 2);
+}
+
 constexpr size_t kReservedSize = 2 /* type */ + 2 /* channel */ +
                                  5 /* service */ + 5 /* method */ +
                                  2 /* payload key */ + 2 /* status */;
@@ -163,5 +245,36 @@ TEST(Packet, PayloadUsableSpace_LargerVarints) {
       Packet(PacketType::RESPONSE, 17000, 200, 200).MinEncodedSizeBytes());
 }
 
+TEST(Packet, MaxPayloadSize_FillsPacketExactly) {
+  std::array<std::byte, 400> payload{};
+  std::array<std::byte, 400> buffer;
+
+  Packet packet(PacketType::SERVER_STREAM, 17000, 200, 200, 99);
+  for (size_t packet_size : {21u, 30u, 100u, 148u, 149u, 150u, 400u}) {
+    const size_t max_payload = packet.MaxPayloadSize(packet_size);
+    ASSERT_GT(max_payload, 0u);
+
+    packet.set_payload(std::span(payload).first(max_payload));
+    Result<ConstByteSpan> encoded =
+        packet.Encode(std::span(buffer).first(packet_size));
+    ASSERT_EQ(encoded.status(), OkStatus());
+    EXPECT_GE(encoded.value().size(), packet_size - 1);
+
+    packet.set_payload(std::span(payload).first(max_payload + 1));
+    EXPECT_EQ(packet.Encode(std::span(buffer).first(packet_size)).status(),
+              Status::ResourceExhausted());
+  }
+}
+
+TEST(Packet, MaxPayloadSize_NoRoomForPayload) {
+  Packet packet(PacketType::SERVER_STREAM, 1, 42, 100);
+  std::array<std::byte, 32> buffer;
+  const size_t header_size = packet.Encode(buffer).value().size();
+
+  EXPECT_EQ(packet.MaxPayloadSize(0), 0u);
+  EXPECT_EQ(packet.MaxPayloadSize(header_size), 0u);
+  EXPECT_EQ(packet.MaxPayloadSize(header_size + 3), 1u);
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -0,0 +1,143 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_status/status.h"
+#include "pw_varint/varint.h"
+
+namespace pw::rpc {
+
+// A ChannelOutput that coalesces packets into batches, which it sends to
+// another ChannelOutput with a single Send() call. Each packet in a batch is
+// prefixed with its varint-encoded length. The receiver splits batches with
+// ForEachBatchedPacket() and processes each packet as usual.
+//
+// Batching amortizes per-send transport overhead, such as framing or DMA
+// setup, across many small packets. This is useful for server streams that
+// write many small payloads, like logs or metrics. Since a batch is delayed
+// until it is flushed, batching increases latency; channels that carry
+// latency-sensitive RPCs should not be batched.
+//
+// A batch is flushed to the underlying output when:
+//
+//   - the next packet would not fit in the batch, which is limited by the
+//     batch buffer size and the underlying output's MTU,
+//   - the batch reaches FlushPolicy::max_bytes or FlushPolicy::max_packets,
+//   - a packet is sent and FlushPolicy::max_delay has passed since the first
+//     packet in the batch was sent, or
+//   - Flush() is called.
+//
+// The max_delay deadline is only checked when packets are sent. To bound the
+// latency of the final packets in a stream, call Flush() periodically, for
+// example from a pw::chrono::SystemTimer.
+class BatchingChannelOutput : public ChannelOutput {
+ public:
+  struct FlushPolicy {
+    // Flush once the batch contains at least this many bytes.
+    size_t max_bytes = kUnlimited;
+
+    // Flush once the batch contains this many packets.
+    size_t max_packets = kUnlimited;
+
+    // Flush when a packet is sent this long after the first packet in the
+    // batch.
+    chrono::SystemClock::duration max_delay =
+        chrono::SystemClock::duration::max();
+  };
+
+  // Batches packets in batch_buffer and sends them to output. The buffer must
+  // outlive the BatchingChannelOutput.
+  BatchingChannelOutput(
+      ChannelOutput& output,
+      std::span<std::byte> batch_buffer,
+      const FlushPolicy& policy,
+      chrono::VirtualSystemClock& clock =
+          chrono::VirtualSystemClock::RealClock())
+      : ChannelOutput(output.name()),
+        output_(output),
+        buffer_(batch_buffer),
+        policy_(policy),
+        clock_(clock),
+        size_(0),
+        packets_(0) {}
+
+  BatchingChannelOutput(ChannelOutput& output,
+                        std::span<std::byte> batch_buffer)
+      : BatchingChannelOutput(output, batch_buffer, FlushPolicy{}) {}
+
+  // Returns the largest packet that fits in an empty batch.
+  size_t MaximumTransmissionUnit() override;
+
+  // Adds the packet to the current batch, flushing the batch if required by the
+  // flush policy. Returns RESOURCE_EXHAUSTED if the packet would not fit in an
+  // empty batch, or the underlying output's status if a batch was flushed.
+  Status Send(std::span<const std::byte> packet) override
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  // Sends the current batch, if any, to the underlying output. Returns the
+  // underlying output's status, or OK if the batch was empty.
+  //
+  // This function acquires the RPC lock, so it must NOT be called from within
+  // a ChannelOutput::Send() implementation.
+  Status Flush() PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+ private:
+  size_t capacity();
+
+  Status FlushLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  ChannelOutput& output_;
+  const std::span<std::byte> buffer_;
+  const FlushPolicy policy_;
+  chrono::VirtualSystemClock& clock_;
+
+  size_t size_ PW_GUARDED_BY(internal::rpc_lock());
+  size_t packets_ PW_GUARDED_BY(internal::rpc_lock());
+  chrono::SystemClock::time_point first_packet_time_
+      PW_GUARDED_BY(internal::rpc_lock());
+};
+
+// Calls function(std::span<const std::byte> packet) for each packet in a batch
+// from a BatchingChannelOutput. Returns DATA_LOSS if the batch is malformed;
+// packets before the malformed data are still passed to the function.
+//
+//   ForEachBatchedPacket(batch, [&](std::span<const std::byte> packet) {
+//     server.ProcessPacket(packet, output).IgnoreError();
+//   });
+//
+template <typename Function>
+Status ForEachBatchedPacket(std::span<const std::byte> batch,
+                            Function&& function) {
+  while (!batch.empty()) {
+    uint64_t packet_size;
+    const size_t prefix_size = varint::Decode(batch, &packet_size);
+
+    if (prefix_size == 0u || packet_size > batch.size() - prefix_size) {
+      return Status::DataLoss();
+    }
+
+    function(batch.subspan(prefix_size, static_cast<size_t>(packet_size)));
+    batch = batch.subspan(prefix_size + static_cast<size_t>(packet_size));
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,87 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Fixed set of reusable client call objects, such as RawUnaryReceiver or
+// NanopbUnaryReceiver, for keeping many calls in flight without allocating or
+// naming a call object for each one. A call occupies its slot until it
+// completes, fails, or is cancelled; the slot is then reused by a later call.
+//
+// To pipeline many unary calls to the same method, enable pipelining with
+// Client::set_pipeline_unary_calls. Otherwise, each new call cancels the
+// previous call to that method.
+//
+// CallPool is not thread safe. Calls must be started from one thread.
+template <typename CallType, size_t kCapacity>
+class CallPool {
+ public:
+  constexpr CallPool() = default;
+
+  CallPool(const CallPool&) = delete;
+  CallPool& operator=(const CallPool&) = delete;
+
+  // Starts a call by invoking start_call, which returns a CallType, and keeps
+  // the call in a free slot. For example:
+  //
+  //   pool.Start([&] {
+  //     return MyService::Method(client, channel_id, request, on_completed);
+  //   });
+  //
+  // Returns RESOURCE_EXHAUSTED without invoking start_call if every slot holds
+  // an active call.
+  template <typename StartCallFunction>
+  Status Start(StartCallFunction&& start_call) {
+    for (CallType& call : calls_) {
+      if (!call.active()) {
+        call = std::forward<StartCallFunction>(start_call)();
+        return OkStatus();
+      }
+    }
+    return Status::ResourceExhausted();
+  }
+
+  // Cancels every active call in the pool.
+  void CancelAll() {
+    for (CallType& call : calls_) {
+      call.Cancel().IgnoreError();  // Fails for inactive calls.
+    }
+  }
+
+  // Returns the number of calls that are still pending.
+  size_t active_calls() const {
+    size_t count = 0;
+    for (const CallType& call : calls_) {
+      if (call.active()) {
+        count += 1;
+      }
+    }
+    return count;
+  }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+ private:
+  std::array<CallType, kCapacity> calls_;
+};
+
+}  // namespace pw::rpc
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <span>
@@ -31,13 +32,31 @@ class ChannelOutput {
   static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
 
   // Creates a channel output with the provided name. The name is used for
-  // logging only.
-  constexpr ChannelOutput(const char* name) : name_(name) {}
+  // logging only. Packets for this output are encoded in pw_rpc's shared
+  // encoding buffer, which is PW_RPC_ENCODING_BUFFER_SIZE_BYTES long.
+  constexpr ChannelOutput(const char* name) : ChannelOutput(name, {}) {}
+
+  // Creates a channel output that has its own encoding buffer. Packets for this
+  // output are encoded in this buffer instead of pw_rpc's shared encoding
+  // buffer, so channels that use different outputs do not share encoding
+  // memory. This allows sizing each output's buffer to its MTU.
+  //
+  // The buffer must outlive the ChannelOutput. It is only accessed while the
+  // RPC system's internal lock is held.
+  constexpr ChannelOutput(const char* name,
+                          std::span<std::byte> encoding_buffer)
+      : name_(name), encoding_buffer_(encoding_buffer) {}
 
   virtual ~ChannelOutput() = default;
 
   constexpr const char* name() const { return name_; }
 
+  // Returns this output's encoding buffer, or an empty span if the output uses
+  // pw_rpc's shared encoding buffer.
+  constexpr std::span<std::byte> encoding_buffer() const {
+    return encoding_buffer_;
+  }
+
   // Returns the maximum transmission unit that this ChannelOutput supports. If
   // the ChannelOutput imposes no limit on the MTU, this function returns
   // ChannelOutput::kUnlimited.
@@ -65,8 +84,39 @@ class ChannelOutput {
   virtual Status Send(std::span<const std::byte> buffer)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
 
+  // Zero-copy transports may override AcquireBuffer() and
+  // SendAndReleaseBuffer() to have pw_rpc encode packets directly in transport
+  // memory, such as a DMA descriptor, instead of copying them from an encoding
+  // buffer in Send().
+  //
+  // AcquireBuffer() returns a buffer in which to encode the next packet. If it
+  // returns an empty span, which the default implementation does, the packet
+  // is encoded in the encoding buffer and passed to Send() instead.
+  //
+  // The same restrictions that apply to Send() apply to these functions: the
+  // RPC system's internal lock is held and no pw_rpc APIs may be called.
+  virtual std::span<std::byte> AcquireBuffer()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    return {};
+  }
+
+  // Sends the packet encoded in the buffer from AcquireBuffer() and releases
+  // the buffer. The packet is a subspan at the start of the acquired buffer. If
+  // the packet could not be encoded, packet is empty; the buffer must be
+  // released without sending anything. Returns a status with the same meaning
+  // as Send()'s.
+  //
+  // Every non-empty AcquireBuffer() call is followed by exactly one
+  // SendAndReleaseBuffer() call before the RPC lock is released.
+  virtual Status SendAndReleaseBuffer(std::span<const std::byte> packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    static_cast<void>(packet);
+    return Status::Unimplemented();
+  }
+
  private:
   const char* name_;
+  std::span<std::byte> encoding_buffer_;
 };
 
 class Channel {
@@ -42,6 +42,21 @@ class Client : public internal::Endpoint {
   Status ProcessPacket(ConstByteSpan data)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Allows multiple unary calls to the same method to be pending at once. By
+  // default, starting a call cancels any pending call to the same method. With
+  // pipelining enabled, unary calls are only told apart by their call IDs, so
+  // many requests may be in flight before the first response arrives.
+  //
+  // The server must respond to each request, which is the case for
+  // synchronous unary methods. Asynchronous unary methods on a pw_rpc server
+  // still replace their pending call, so earlier pipelined requests to them
+  // are never answered.
+  void set_pipeline_unary_calls(bool enabled)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
+    internal::LockGuard lock(internal::rpc_lock());
+    set_pipeline_unary_calls_locked(enabled);
+  }
+
  private:
   // Remove these internal::Endpoint functions from the public interface.
   using Endpoint::active_call_count;
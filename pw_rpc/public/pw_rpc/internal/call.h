@@ -15,6 +15,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <span>
 #include <utility>
 
@@ -22,6 +23,7 @@
 #include "pw_function/function.h"
 #include "pw_rpc/internal/call_context.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/method.h"
 #include "pw_rpc/internal/packet.h"
@@ -130,6 +132,20 @@ class Call : public IntrusiveList<Call>::Item {
   Status WriteLocked(ConstByteSpan payload)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Returns a buffer in which to encode a payload for this call. Payloads are
+  // encoded in the encoding buffer of the call's channel output, if it has one,
+  // so they are not limited by the shared encoding buffer.
+  ByteSpan PayloadBufferLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Returns the largest payload Write() can send in one packet on this call's
+  // channel, or 0 if the call is inactive or its channel is gone.
+  size_t MaxWritePayloadSize() PW_LOCKS_EXCLUDED(rpc_lock()) {
+    LockGuard lock(rpc_lock());
+    return MaxWritePayloadSizeLocked();
+  }
+
+  size_t MaxWritePayloadSizeLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Sends the initial request for a client call. If the request fails, the call
   // is closed.
   void SendInitialClientRequest(ConstByteSpan payload)
@@ -158,6 +174,20 @@ class Call : public IntrusiveList<Call>::Item {
     }
   }
 
+#if PW_RPC_FLOW_CONTROL
+  static constexpr uint32_t kUnlimitedCredit = UINT32_MAX;
+
+  // Adds credit from a CLIENT_FLOW_CONTROL packet. The first credit packet
+  // enables flow control for the call's server stream.
+  void HandleCredit(uint32_t credit) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Remaining server stream packets the call may send, or kUnlimitedCredit if
+  // the client has not enabled flow control.
+  uint32_t credit() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return credit_;
+  }
+#endif  // PW_RPC_FLOW_CONTROL
+
   // Handles an error condition for the call. This closes the call and calls the
   // on_error callback, if set.
   void HandleError(Status status) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -281,6 +311,26 @@ class Call : public IntrusiveList<Call>::Item {
         PacketType::CLIENT_ERROR, {}, Status::Cancelled());
   }
 
+  // Grants the server credit to send the specified number of additional server
+  // stream packets. For client calls only. The first grant enables flow control
+  // for the call; granting 0 credit pauses the stream until more is granted.
+  //
+  // GrantCredit is templated so that it can be conditionally disabled with a
+  // helpful static_assert message.
+  template <typename UnusedType = void>
+  Status GrantCredit([[maybe_unused]] uint32_t credit)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    static_assert(cfg::kFlowControlEnabled<UnusedType>,
+                  "Flow control is disabled, so GrantCredit cannot be called. "
+                  "To enable flow control, set PW_RPC_FLOW_CONTROL to 1.");
+#if PW_RPC_FLOW_CONTROL
+    LockGuard lock(rpc_lock());
+    return SendCreditLocked(credit);
+#else
+    return Status::Unimplemented();
+#endif  // PW_RPC_FLOW_CONTROL
+  }
+
   // Unregisters the RPC from the endpoint & marks as closed. The call may be
   // active or inactive when this is called.
   void UnregisterAndMarkClosed() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
@@ -335,6 +385,11 @@ class Call : public IntrusiveList<Call>::Item {
                                        Status status)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+#if PW_RPC_FLOW_CONTROL
+  Status SendCreditLocked(uint32_t credit)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+#endif  // PW_RPC_FLOW_CONTROL
+
   internal::Endpoint* endpoint_ PW_GUARDED_BY(rpc_lock());
   uint32_t channel_id_ PW_GUARDED_BY(rpc_lock());
   uint32_t id_ PW_GUARDED_BY(rpc_lock());
@@ -349,6 +404,10 @@ class Call : public IntrusiveList<Call>::Item {
     kClientStreamActive,
   } client_stream_state_ PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_FLOW_CONTROL
+  uint32_t credit_ PW_GUARDED_BY(rpc_lock()) = kUnlimitedCredit;
+#endif  // PW_RPC_FLOW_CONTROL
+
   // Called when the RPC is terminated due to an error.
   Function<void(Status error)> on_error_;
 
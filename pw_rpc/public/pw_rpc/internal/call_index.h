@@ -0,0 +1,224 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/lock.h"
+
+namespace pw::rpc::internal {
+
+// Fixed-capacity hash index of calls, keyed on channel, service, and method ID.
+// An Endpoint uses this to find the call for an incoming packet in constant
+// time, rather than by walking its list of calls.
+//
+// The index is an open addressing hash table with linear probing. It has one
+// more slot than its capacity, so every probe sequence ends at an empty slot.
+// Removed entries are backward-shifted, so lookups never skip tombstones.
+// Multiple calls with the same key may be indexed at once; Find() returns the
+// most recently added one.
+template <size_t kCapacity>
+class CallIndex {
+ public:
+  constexpr CallIndex() = default;
+
+  // Adds a call to the index. Returns false if the index is full.
+  bool Add(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (size_ == kCapacity) {
+      return false;
+    }
+
+    // Newer calls shadow older calls with the same key, so shift any entries
+    // for this key forward and insert the new call in front of them.
+    Call* to_insert = &call;
+    for (size_t i = HomeSlot(call); to_insert != nullptr; i = Next(i)) {
+      Call* const displaced = slots_[i];
+      if (displaced != nullptr && !SameKey(*displaced, call)) {
+        continue;
+      }
+      slots_[i] = to_insert;
+      to_insert = displaced;
+    }
+
+    size_ += 1;
+    return true;
+  }
+
+  // Removes a call from the index. The call's IDs must not have changed since
+  // it was added. Returns false if the call is not in the index.
+  bool Remove(const Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    for (size_t i = HomeSlot(call); slots_[i] != nullptr; i = Next(i)) {
+      if (slots_[i] == &call) {
+        BackwardShift(i);
+        size_ -= 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns the most recently added call with these IDs or nullptr.
+  Call* Find(uint32_t channel_id, uint32_t service_id, uint32_t method_id) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (size_ == 0) {
+      return nullptr;
+    }
+
+    for (size_t i = Slot(channel_id, service_id, method_id);
+         slots_[i] != nullptr;
+         i = Next(i)) {
+      Call& call = *slots_[i];
+      if (call.channel_id_locked() == channel_id &&
+          call.service_id() == service_id && call.method_id() == method_id) {
+        return &call;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns the call with these IDs and call ID. If no call has the call ID,
+  // returns the most recently added call with these IDs or nullptr.
+  Call* Find(uint32_t channel_id,
+             uint32_t service_id,
+             uint32_t method_id,
+             uint32_t call_id) const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (size_ == 0) {
+      return nullptr;
+    }
+
+    Call* newest = nullptr;
+    for (size_t i = Slot(channel_id, service_id, method_id);
+         slots_[i] != nullptr;
+         i = Next(i)) {
+      Call& call = *slots_[i];
+      if (call.channel_id_locked() == channel_id &&
+          call.service_id() == service_id && call.method_id() == method_id) {
+        if (call.id() == call_id) {
+          return &call;
+        }
+        if (newest == nullptr) {
+          newest = &call;
+        }
+      }
+    }
+    return newest;
+  }
+
+  constexpr size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kSlots = kCapacity + 1;
+
+  static constexpr size_t Slot(uint32_t channel_id,
+                               uint32_t service_id,
+                               uint32_t method_id) {
+    // Service and method IDs are already hashes, so a cheap mix is enough.
+    uint32_t hash = service_id ^ (method_id * 0x9e3779b1u) ^
+                    (channel_id * 0x85ebca6bu);
+    hash ^= hash >> 16;
+    return hash % kSlots;
+  }
+
+  static size_t HomeSlot(const Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return Slot(call.channel_id_locked(), call.service_id(), call.method_id());
+  }
+
+  static constexpr size_t Next(size_t slot) { return (slot + 1) % kSlots; }
+
+  static bool SameKey(const Call& lhs, const Call& rhs)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return lhs.channel_id_locked() == rhs.channel_id_locked() &&
+           lhs.service_id() == rhs.service_id() &&
+           lhs.method_id() == rhs.method_id();
+  }
+
+  // Empties a slot, then moves later entries in its probe sequence back so
+  // that every entry stays reachable from its home slot.
+  void BackwardShift(size_t empty) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    slots_[empty] = nullptr;
+
+    for (size_t i = Next(empty); slots_[i] != nullptr; i = Next(i)) {
+      const size_t home = HomeSlot(*slots_[i]);
+
+      // The entry may move to the empty slot if the empty slot is cyclically
+      // between the entry's home slot and its current slot.
+      const bool movable = empty <= i ? (home <= empty || home > i)
+                                      : (home <= empty && home > i);
+      if (movable) {
+        slots_[empty] = slots_[i];
+        slots_[i] = nullptr;
+        empty = i;
+      }
+    }
+  }
+
+  std::array<Call*, kSlots> slots_ = {};
+  size_t size_ = 0;
+};
+
+// The call index is disabled entirely if its capacity is 0.
+template <>
+class CallIndex<0> {
+ public:
+  constexpr CallIndex() = default;
+
+  constexpr bool Add(Call&) { return false; }
+  constexpr bool Remove(const Call&) { return false; }
+  constexpr Call* Find(uint32_t, uint32_t, uint32_t) const { return nullptr; }
+  constexpr Call* Find(uint32_t, uint32_t, uint32_t, uint32_t) const {
+    return nullptr;
+  }
+  constexpr size_t size() const { return 0; }
+};
+
+// Finds the call with these IDs in calls, which holds every active call ordered
+// newest first. If no call has the call ID, returns the newest call with these
+// IDs, or nullptr if there is none.
+//
+// The index is only used if it holds every call (unindexed_calls is 0).
+// Otherwise, a newer call with these IDs may be missing from the index, so
+// calls is searched instead.
+template <size_t kCapacity, typename CallList>
+Call* FindIndexedCall(const CallIndex<kCapacity>& index,
+                      size_t unindexed_calls,
+                      CallList& calls,
+                      uint32_t channel_id,
+                      uint32_t service_id,
+                      uint32_t method_id,
+                      uint32_t call_id)
+    PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+  if (unindexed_calls == 0u) {
+    return index.Find(channel_id, service_id, method_id, call_id);
+  }
+
+  Call* newest = nullptr;
+  for (Call& call : calls) {
+    if (channel_id == call.channel_id_locked() &&
+        service_id == call.service_id() && method_id == call.method_id()) {
+      if (call.id() == call_id) {
+        return &call;
+      }
+      if (newest == nullptr) {
+        newest = &call;
+      }
+    }
+  }
+  return newest;
+}
+
+}  // namespace pw::rpc::internal
@@ -24,7 +24,7 @@
 
 namespace pw::rpc::internal {
 
-// Returns a portion of the encoding buffer that may be used to encode an
+// Returns a portion of the shared encoding buffer that may be used to encode an
 // outgoing payload.
 ByteSpan GetPayloadBuffer() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
@@ -42,6 +42,15 @@ class Channel : public rpc::Channel {
   using rpc::Channel::set_channel_id;
 
   Status Send(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Returns the size of the largest packet this channel can send: the smaller
+  // of the buffer packets are encoded in and the output's MTU.
+  size_t MaxPacketSizeBytes() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Returns a portion of the buffer this channel's packets are encoded in that
+  // may be used to encode an outgoing payload: the output's encoding buffer, or
+  // the shared encoding buffer if the output has none.
+  ByteSpan PayloadBuffer() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 };
 
 }  // namespace pw::rpc::internal
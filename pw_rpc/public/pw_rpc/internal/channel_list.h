@@ -13,6 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <span>
 #include <vector>
 
@@ -27,6 +31,45 @@ namespace pw::rpc::internal {
 #define _PW_RPC_CONSTEXPR constexpr
 #endif  // PW_RPC_DYNAMIC_ALLOCATION && !defined(__cpp_lib_constexpr_vector)
 
+// Remembers where channels with recently used IDs are in a ChannelList, in a
+// table indexed by channel ID modulo its size. Entries are not updated when
+// channels move or change IDs, so the ChannelList checks each entry before
+// using it.
+template <size_t kSize>
+class ChannelCache {
+ public:
+  static constexpr size_t kMissing = std::numeric_limits<size_t>::max();
+
+  constexpr ChannelCache() = default;
+
+  // Returns the index stored for this channel ID, or kMissing.
+  size_t Lookup(uint32_t channel_id) const {
+    const uint16_t entry = entries_[channel_id % kSize];
+    return entry == 0u ? kMissing : entry - 1u;
+  }
+
+  void Store(uint32_t channel_id, size_t index) {
+    if (index < std::numeric_limits<uint16_t>::max()) {
+      entries_[channel_id % kSize] = static_cast<uint16_t>(index + 1);
+    }
+  }
+
+ private:
+  // Indices are stored plus one, so that 0 marks an empty entry.
+  std::array<uint16_t, kSize> entries_{};
+};
+
+template <>
+class ChannelCache<0> {
+ public:
+  static constexpr size_t kMissing = std::numeric_limits<size_t>::max();
+
+  constexpr ChannelCache() = default;
+
+  constexpr size_t Lookup(uint32_t) const { return kMissing; }
+  constexpr void Store(uint32_t, size_t) {}
+};
+
 class ChannelList {
  public:
   _PW_RPC_CONSTEXPR ChannelList(std::span<Channel> channels)
@@ -34,7 +77,8 @@ class ChannelList {
 
   // Returns the first channel with the matching ID or nullptr if none match.
   // Except for Channel::kUnassignedChannelId, there should be no duplicate
-  // channels.
+  // channels. If PW_RPC_CHANNEL_CACHE_SIZE is nonzero, channels that were
+  // recently found are usually found again without searching the list.
   const Channel* Get(uint32_t channel_id) const;
 
   Channel* Get(uint32_t channel_id) {
@@ -64,6 +108,9 @@ class ChannelList {
 #else
   std::span<Channel> channels_;
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
+
+ private:
+  mutable ChannelCache<cfg::kChannelCacheSize> cache_;
 };
 
 }  // namespace pw::rpc::internal
@@ -29,6 +29,18 @@
 #define PW_RPC_CLIENT_STREAM_END_CALLBACK 0
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
 
+// Server streams normally send packets as fast as the server writes them. If
+// flow control is enabled, a client may limit the packets a server stream
+// sends by granting it credit in CLIENT_FLOW_CONTROL packets. Once a call
+// receives credit, each server stream packet consumes one credit, and writes
+// fail with RESOURCE_EXHAUSTED while the call has none. Calls that never
+// receive credit are not limited.
+//
+// This option adds a 32-bit credit counter to every call object.
+#ifndef PW_RPC_FLOW_CONTROL
+#define PW_RPC_FLOW_CONTROL 0
+#endif  // PW_RPC_FLOW_CONTROL
+
 // The Nanopb-based pw_rpc implementation allocates memory to use for Nanopb
 // structs for the request and response protobufs. The template function that
 // allocates these structs rounds struct sizes up to this value so that
@@ -43,6 +55,18 @@
 #define PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE 64
 #endif  // PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 
+// If enabled, the Nanopb-based pw_rpc implementation allocates the request and
+// response structs for unary and server streaming RPCs from the arena set with
+// pw::rpc::SetNanopbRequestArena instead of on the stack or globally. This
+// keeps large messages out of the invoking thread's stack frame. Requests fail
+// with RESOURCE_EXHAUSTED if no arena is set or it does not have enough space.
+//
+// The arena is shared by all calls, so the server must only process packets
+// from one thread at a time when this is enabled.
+#ifndef PW_RPC_NANOPB_ARENA_DECODING
+#define PW_RPC_NANOPB_ARENA_DECODING 0
+#endif  // PW_RPC_NANOPB_ARENA_DECODING
+
 // Enable global synchronization for RPC calls. If this is set, a backend must
 // be configured for pw_sync:mutex.
 #ifndef PW_RPC_USE_GLOBAL_MUTEX
@@ -82,6 +106,40 @@ static_assert(false,
 #define PW_RPC_ENCODING_BUFFER_SIZE_BYTES 512
 #endif  // PW_RPC_ENCODING_BUFFER_SIZE_BYTES
 
+// The number of services a pw_rpc server indexes by service ID. Indexed
+// services are found with a binary search, rather than by walking the list of
+// registered services, so lookup cost stays flat as services are added. Each
+// index entry costs one pointer in every Server object.
+//
+// Services registered beyond this count still work, but are found with a
+// linear search. Set this to 0 to disable the index.
+#ifndef PW_RPC_SERVICE_INDEX_SIZE
+#define PW_RPC_SERVICE_INDEX_SIZE 0
+#endif  // PW_RPC_SERVICE_INDEX_SIZE
+
+// The number of active calls a pw_rpc endpoint indexes in a hash table keyed on
+// channel, service, and method ID. Incoming packets for indexed calls are
+// matched to their call in constant time, rather than by walking the list of
+// active calls. Each index entry costs one pointer in every Endpoint (Server or
+// Client) object, plus one extra pointer.
+//
+// Calls beyond this count still work, but are found with a linear search. Set
+// this to 0 to disable the index.
+#ifndef PW_RPC_CALL_INDEX_SIZE
+#define PW_RPC_CALL_INDEX_SIZE 0
+#endif  // PW_RPC_CALL_INDEX_SIZE
+
+// The number of entries in the table a pw_rpc endpoint uses to remember where
+// channels are in its channel list, indexed by channel ID modulo this size.
+// Channels are found through the table in constant time, rather than by walking
+// the channel list, unless another recently used channel ID maps to the same
+// entry. Each entry costs two bytes in every Server and Client object.
+//
+// Set this to 0 to disable the table.
+#ifndef PW_RPC_CHANNEL_CACHE_SIZE
+#define PW_RPC_CHANNEL_CACHE_SIZE 0
+#endif  // PW_RPC_CHANNEL_CACHE_SIZE
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_RPC_CONFIG_LOG_LEVEL
 #define PW_RPC_CONFIG_LOG_LEVEL PW_LOG_LEVEL_INFO
@@ -98,18 +156,34 @@ template <typename...>
 constexpr std::bool_constant<PW_RPC_CLIENT_STREAM_END_CALLBACK>
     kClientStreamEndCallbackEnabled;
 
+template <typename...>
+constexpr std::bool_constant<PW_RPC_FLOW_CONTROL> kFlowControlEnabled;
+
 template <typename...>
 constexpr std::bool_constant<PW_RPC_DYNAMIC_ALLOCATION>
     kDynamicAllocationEnabled;
 
+template <typename...>
+constexpr std::bool_constant<PW_RPC_NANOPB_ARENA_DECODING>
+    kNanopbArenaDecodingEnabled;
+
 inline constexpr size_t kNanopbStructMinBufferSize =
     PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE;
 
 inline constexpr size_t kEncodingBufferSizeBytes =
     PW_RPC_ENCODING_BUFFER_SIZE_BYTES;
 
+inline constexpr size_t kServiceIndexSize = PW_RPC_SERVICE_INDEX_SIZE;
+
+inline constexpr size_t kCallIndexSize = PW_RPC_CALL_INDEX_SIZE;
+
+inline constexpr size_t kChannelCacheSize = PW_RPC_CHANNEL_CACHE_SIZE;
+
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 #undef PW_RPC_ENCODING_BUFFER_SIZE_BYTES
+#undef PW_RPC_SERVICE_INDEX_SIZE
+#undef PW_RPC_CALL_INDEX_SIZE
+#undef PW_RPC_CHANNEL_CACHE_SIZE
 
 }  // namespace pw::rpc::cfg
 
@@ -18,8 +18,10 @@
 #include "pw_containers/intrusive_list.h"
 #include "pw_result/result.h"
 #include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/call_index.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_sync/lock_annotations.h"
@@ -85,10 +87,21 @@ class Endpoint {
       PW_LOCKS_EXCLUDED(rpc_lock());
 
   // Finds a call object for an ongoing call associated with this packet, if
-  // any. Returns nullptr if no matching call exists.
+  // any. If several calls to the packet's method are pending, the call with
+  // the packet's call ID is preferred. Returns nullptr if no matching call
+  // exists.
   Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return FindCallById(
-        packet.channel_id(), packet.service_id(), packet.method_id());
+    return FindCallById(packet.channel_id(),
+                        packet.service_id(),
+                        packet.method_id(),
+                        packet.call_id());
+  }
+
+  // If enabled, starting a unary client call does not cancel other pending
+  // unary calls to the same method. Responses are matched to calls by call ID.
+  void set_pipeline_unary_calls_locked(bool enabled)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    pipeline_unary_calls_ = enabled;
   }
 
  private:
@@ -104,30 +117,50 @@ class Endpoint {
   }
 
   // Adds a call to the internal call registry. If a matching call already
-  // exists, it is cancelled locally (on_error called, no packet sent).
+  // exists, it is cancelled locally (on_error called, no packet sent), unless
+  // both are pipelined unary calls.
   void RegisterCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   // Registers a call that is known to be unique. The calls list is NOT checked
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     calls_.push_front(call);
+    if (!call_index_.Add(call)) {
+      unindexed_calls_ += 1;
+    }
   }
 
-  // Removes the provided call from the call registry.
+  // Removes the provided call from the call registry. This must be called
+  // before the call's channel ID is cleared.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    RemoveFromCallIndex(call);
     calls_.remove(call);
   }
 
+  void RemoveFromCallIndex(const Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (!call_index_.Remove(call)) {
+      unindexed_calls_ -= 1;
+    }
+  }
+
   Call* FindCallById(uint32_t channel_id,
                      uint32_t service_id,
-                     uint32_t method_id)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+                     uint32_t method_id,
+                     uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   ChannelList channels_ PW_GUARDED_BY(rpc_lock());
   IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
 
+  // Index of calls_ for fast lookups. Calls that did not fit in the index are
+  // only found by searching calls_.
+  CallIndex<cfg::kCallIndexSize> call_index_ PW_GUARDED_BY(rpc_lock());
+  size_t unindexed_calls_ PW_GUARDED_BY(rpc_lock()) = 0;
+
   uint32_t next_call_id_ PW_GUARDED_BY(rpc_lock());
+
+  bool pipeline_unary_calls_ PW_GUARDED_BY(rpc_lock()) = false;
 };
 
 }  // namespace pw::rpc::internal
@@ -41,6 +41,13 @@ class MethodLookup {
     return method;
   }
 
+  template <typename Service, uint32_t kMethodId>
+  static constexpr const auto& GetPwpbMethod() {
+    const auto& method = GetMethodUnion<Service, kMethodId>().pwpb_method();
+    static_assert(method.id() == kMethodId, "Incorrect method implementation");
+    return method;
+  }
+
  private:
   template <typename Service, uint32_t kMethodId>
   static constexpr const auto& GetMethodUnion() {
@@ -97,7 +97,8 @@ class Packet {
         method_id_(method_id),
         call_id_(call_id),
         payload_(payload),
-        status_(status) {}
+        status_(status),
+        credit_(0) {}
 
   // Encodes the packet into its wire format. Returns the encoded size.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
@@ -110,6 +111,11 @@ class Packet {
   // encoded since 0 is the default value.
   size_t MinEncodedSizeBytes() const;
 
+  // Returns the largest payload that this packet, with its other fields as
+  // they are, can carry when encoded in at most packet_size_bytes. Returns 0 if
+  // not even an empty payload fits.
+  size_t MaxPayloadSize(size_t packet_size_bytes) const;
+
   enum Destination : bool { kServer, kClient };
 
   constexpr Destination destination() const {
@@ -123,6 +129,7 @@ class Packet {
   constexpr uint32_t call_id() const { return call_id_; }
   constexpr const ConstByteSpan& payload() const { return payload_; }
   constexpr const Status& status() const { return status_; }
+  constexpr uint32_t credit() const { return credit_; }
 
   constexpr void set_type(PacketType type) { type_ = type; }
   constexpr void set_channel_id(uint32_t channel_id) {
@@ -135,8 +142,12 @@ class Packet {
   constexpr void set_call_id(uint32_t call_id) { call_id_ = call_id; }
   constexpr void set_payload(ConstByteSpan payload) { payload_ = payload; }
   constexpr void set_status(Status status) { status_ = status; }
+  constexpr void set_credit(uint32_t credit) { credit_ = credit; }
 
  private:
+  // Encoded size of every field except the payload.
+  size_t EncodedHeaderSize() const;
+
   PacketType type_;
   uint32_t channel_id_;
   uint32_t service_id_;
@@ -144,6 +155,7 @@ class Packet {
   uint32_t call_id_;
   ConstByteSpan payload_;
   Status status_;
+  uint32_t credit_;
 };
 
 }  // namespace pw::rpc::internal
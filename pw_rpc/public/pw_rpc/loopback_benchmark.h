@@ -0,0 +1,164 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/client.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Results from one LoopbackBenchmark run.
+struct BenchmarkResult {
+  // Number of round trips: unary calls or bidirectional stream echoes.
+  size_t round_trips;
+
+  // Packets sent by the client and the server.
+  size_t packets;
+
+  // Bytes passed to ChannelOutput::Send() by the client and the server. Each of
+  // these bytes was encoded and copied into the transport once.
+  size_t bytes_sent;
+
+  // Total time spent in round trips and the 50th and 99th percentile round
+  // trip latencies.
+  chrono::SystemClock::duration total_time;
+  chrono::SystemClock::duration p50_latency;
+  chrono::SystemClock::duration p99_latency;
+
+  // Packets processed per second, or 0 if no time elapsed.
+  uint64_t packets_per_second() const;
+
+  // Average bytes sent per round trip.
+  size_t bytes_per_round_trip() const {
+    return round_trips == 0u ? 0u : bytes_sent / round_trips;
+  }
+};
+
+// Runs the pw.rpc.Benchmark service's RPCs between a client and a server in the
+// same process. Packets are passed between them through in-memory queues, so
+// the results measure pw_rpc's encoding and dispatch path without any
+// transport overhead. This runs on host and on device, and is suitable for
+// catching regressions in the core RPC code.
+//
+// A LoopbackBenchmark owns its client, server, and channels, and must only be
+// used from one thread. To benchmark a real transport, register a
+// BenchmarkService with the device's server and drive it from the host.
+class LoopbackBenchmark {
+ public:
+  // Largest payload that can be echoed. UnaryEcho is further limited by the
+  // BenchmarkService's response buffer.
+  static constexpr size_t kMaxPayloadSizeBytes = 256;
+
+  // Latency percentiles are computed from the most recent round trips.
+  static constexpr size_t kMaxLatencySamples = 128;
+
+  LoopbackBenchmark(chrono::VirtualSystemClock& clock =
+                        chrono::VirtualSystemClock::RealClock());
+
+  LoopbackBenchmark(const LoopbackBenchmark&) = delete;
+  LoopbackBenchmark& operator=(const LoopbackBenchmark&) = delete;
+
+  // Makes the specified number of UnaryEcho calls with a payload of the given
+  // size. Returns INVALID_ARGUMENT if the payload is too large, or the status
+  // of the first call that failed.
+  Status RunUnary(size_t payload_size,
+                  size_t iterations,
+                  BenchmarkResult& result);
+
+  // Opens a BidirectionalEcho call and echoes a payload of the given size the
+  // specified number of times. Returns INVALID_ARGUMENT if the payload is too
+  // large, or the status of the first operation that failed.
+  Status RunBidirectional(size_t payload_size,
+                          size_t iterations,
+                          BenchmarkResult& result);
+
+ private:
+  static constexpr uint32_t kChannelId = 1;
+  static constexpr size_t kMaxPacketSizeBytes = cfg::kEncodingBufferSizeBytes;
+
+  // ChannelOutput that queues packets sent to it.
+  class LoopbackOutput : public ChannelOutput {
+   public:
+    constexpr LoopbackOutput(const char* name) : ChannelOutput(name) {}
+
+    Status Send(ConstByteSpan packet) override;
+
+    // Moves the oldest packet into the provided buffer. Returns the packet, or
+    // an empty span if the queue is empty.
+    ConstByteSpan Pop(ByteSpan buffer);
+
+    void ResetCounters() {
+      packets_ = 0;
+      bytes_ = 0;
+    }
+
+    size_t packets() const { return packets_; }
+    size_t bytes() const { return bytes_; }
+
+   private:
+    static constexpr size_t kQueueDepth = 2;
+
+    struct QueuedPacket {
+      std::array<std::byte, kMaxPacketSizeBytes> data;
+      size_t size;
+    };
+
+    std::array<QueuedPacket, kQueueDepth> queue_ = {};
+    size_t head_ = 0;
+    size_t count_ = 0;
+
+    size_t packets_ = 0;
+    size_t bytes_ = 0;
+  };
+
+  // Delivers queued packets until both queues are empty.
+  Status Pump();
+
+  void StartRun();
+  void RecordLatency(chrono::SystemClock::duration latency);
+  void FinishRun(size_t round_trips, BenchmarkResult& result);
+
+  chrono::VirtualSystemClock& clock_;
+
+  LoopbackOutput client_output_;
+  LoopbackOutput server_output_;
+  std::array<Channel, 1> client_channels_;
+  std::array<Channel, 1> server_channels_;
+  Client client_;
+  Server server_;
+  BenchmarkService service_;
+
+  std::array<std::byte, kMaxPayloadSizeBytes> payload_ = {};
+  std::array<std::byte, kMaxPacketSizeBytes> packet_buffer_ = {};
+
+  std::array<chrono::SystemClock::duration, kMaxLatencySamples> samples_ = {};
+  size_t sample_count_ = 0;
+  chrono::SystemClock::duration total_time_{};
+
+  // Set by RPC callbacks.
+  size_t responses_ = 0;
+  Status rpc_status_;
+};
+
+}  // namespace pw::rpc
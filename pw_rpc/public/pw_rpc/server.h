@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <span>
 #include <tuple>
@@ -20,6 +21,7 @@
 #include "pw_containers/intrusive_list.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/endpoint.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/method.h"
@@ -45,11 +47,11 @@ class Server : public internal::Endpoint {
   void RegisterService(Service& service, OtherServices&... services)
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::LockGuard lock(internal::rpc_lock());
-    services_.push_front(service);  // Register the first service
+    AddService(service);  // Register the first service
 
     // Register any additional services by expanding the parameter pack. This
     // is a fold expression of the comma operator.
-    (services_.push_front(services), ...);
+    (AddService(services), ...);
   }
 
   // Processes an RPC packet. The packet may contain an RPC request or a control
@@ -92,6 +94,15 @@ class Server : public internal::Endpoint {
   template <typename>
   friend class NanopbUnaryResponder;
 
+  template <typename, typename>
+  friend class PwpbServerReaderWriter;
+  template <typename>
+  friend class PwpbServerWriter;
+  template <typename, typename>
+  friend class PwpbServerReader;
+  template <typename>
+  friend class PwpbUnaryResponder;
+
   // Creates a call context for a particular RPC. Unlike the CallContext
   // constructor, this function checks the type of RPC at compile time.
   template <auto kMethod,
@@ -132,6 +143,15 @@ class Server : public internal::Endpoint {
   Status ProcessPacket(ConstByteSpan packet_data, ChannelOutput* interface)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Adds a service to the list of services and, if there is room, the service
+  // ID index.
+  void AddService(Service& service)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  // Finds a registered service by ID. Returns nullptr if there is no match.
+  Service* FindService(uint32_t service_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   std::tuple<Service*, const internal::Method*> FindMethod(
       const internal::Packet& packet)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
@@ -146,6 +166,12 @@ class Server : public internal::Endpoint {
   using Endpoint::GetInternalChannel;
 
   IntrusiveList<Service> services_ PW_GUARDED_BY(internal::rpc_lock());
+
+  // Registered services, sorted by ID. If the index fills up, services that do
+  // not fit are only in the services_ list.
+  std::array<Service*, cfg::kServiceIndexSize> service_index_
+      PW_GUARDED_BY(internal::rpc_lock()) = {};
+  size_t indexed_services_ PW_GUARDED_BY(internal::rpc_lock()) = 0;
 };
 
 }  // namespace pw::rpc
@@ -0,0 +1,190 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::rpc {
+namespace internal {
+
+// A queue of packets that a worker thread passes to Server::ProcessPacket.
+class DispatchWorker : public thread::ThreadCore {
+ public:
+  // Copies a packet into the queue. Returns RESOURCE_EXHAUSTED if the queue is
+  // full or the packet is too large.
+  Status Push(ConstByteSpan packet, ChannelOutput* interface)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  // Makes Run() return after processing the current packet, if any. Packets
+  // that are still queued are dropped.
+  void Stop() PW_LOCKS_EXCLUDED(mutex_);
+
+  void set_server(Server& server) { server_ = &server; }
+
+ protected:
+  struct Entry {
+    size_t size;
+    ChannelOutput* interface;
+  };
+
+  DispatchWorker(ByteSpan storage,
+                 std::span<Entry> entries,
+                 size_t max_packet_size_bytes)
+      : server_(nullptr),
+        storage_(storage),
+        entries_(entries),
+        max_packet_size_bytes_(max_packet_size_bytes),
+        head_(0),
+        count_(0),
+        stop_(false) {}
+
+ private:
+  void Run() override PW_LOCKS_EXCLUDED(mutex_);
+
+  ByteSpan slot(size_t index) {
+    return storage_.subspan(index * max_packet_size_bytes_,
+                            max_packet_size_bytes_);
+  }
+
+  Server* server_;
+  const ByteSpan storage_;
+  const std::span<Entry> entries_;
+  const size_t max_packet_size_bytes_;
+
+  sync::Mutex mutex_;
+  sync::CountingSemaphore ready_;
+
+  // The entry at head_ stays in the queue until it has been processed, so its
+  // slot is not overwritten by Push() while the server reads it.
+  size_t head_ PW_GUARDED_BY(mutex_);
+  size_t count_ PW_GUARDED_BY(mutex_);
+  bool stop_ PW_GUARDED_BY(mutex_);
+};
+
+template <size_t kQueueDepth, size_t kMaxPacketSizeBytes>
+class DispatchWorkerWithStorage : public DispatchWorker {
+ public:
+  DispatchWorkerWithStorage()
+      : DispatchWorker(storage_, entries_, kMaxPacketSizeBytes) {}
+
+ private:
+  std::array<std::byte, kQueueDepth * kMaxPacketSizeBytes> storage_;
+  std::array<Entry, kQueueDepth> entries_;
+};
+
+// Decodes a packet's IDs and selects the worker for it. All packets for a call
+// go to the same worker. Returns DATA_LOSS if the packet cannot be decoded.
+Status SelectDispatchWorker(ConstByteSpan packet,
+                            size_t workers,
+                            size_t& worker);
+
+}  // namespace internal
+
+// Passes incoming packets to a pool of worker threads, which process them with
+// Server::ProcessPacket. The thread that receives packets, such as a transport
+// thread, is not blocked by slow RPC handlers, and handlers for different calls
+// may run at the same time.
+//
+// Packets for the same call (channel, service, and method) are always handled
+// by the same worker, in the order they were received. Packets for different
+// calls have no ordering guarantees.
+//
+// Each worker is a pw::thread::ThreadCore that must be started on its own
+// thread. ServerDispatcher requires PW_RPC_USE_GLOBAL_MUTEX to be enabled,
+// since the server is accessed from multiple threads.
+//
+//   pw::rpc::ServerDispatcher<2, 4> dispatcher(server);
+//
+//   pw::thread::Thread worker_0(options_0, dispatcher.worker(0));
+//   pw::thread::Thread worker_1(options_1, dispatcher.worker(1));
+//
+//   // In the transport thread:
+//   dispatcher.ProcessPacket(packet, output);
+//
+template <size_t kWorkers,
+          size_t kQueueDepth,
+          size_t kMaxPacketSizeBytes = cfg::kEncodingBufferSizeBytes>
+class ServerDispatcher {
+ public:
+  static_assert(kWorkers > 0u, "A ServerDispatcher needs at least one worker");
+  static_assert(kQueueDepth > 0u, "Worker queues must hold at least 1 packet");
+
+  ServerDispatcher(Server& server) {
+    for (internal::DispatchWorker& worker : workers_) {
+      worker.set_server(server);
+    }
+  }
+
+  ServerDispatcher(const ServerDispatcher&) = delete;
+  ServerDispatcher& operator=(const ServerDispatcher&) = delete;
+
+  // Queues a packet for processing by a worker. The packet is copied, so the
+  // buffer may be reused as soon as this returns. Returns:
+  //
+  //   OK - the packet was queued
+  //   DATA_LOSS - the packet could not be decoded
+  //   RESOURCE_EXHAUSTED - the packet is too large or the worker's queue is
+  //       full; the packet was dropped
+  //
+  Status ProcessPacket(ConstByteSpan packet) {
+    return Dispatch(packet, nullptr);
+  }
+
+  // Queues a packet, which the server processes with an interface to use for
+  // sending error responses if the packet's channel is unavailable.
+  Status ProcessPacket(ConstByteSpan packet, ChannelOutput& interface) {
+    return Dispatch(packet, &interface);
+  }
+
+  // Returns a worker to start on a thread.
+  thread::ThreadCore& worker(size_t index) { return workers_[index]; }
+
+  // Stops all workers. Each worker's Run() returns after it finishes its
+  // current packet.
+  void Stop() {
+    for (internal::DispatchWorker& worker : workers_) {
+      worker.Stop();
+    }
+  }
+
+  static constexpr size_t workers() { return kWorkers; }
+
+ private:
+  Status Dispatch(ConstByteSpan packet, ChannelOutput* interface) {
+    size_t index;
+    PW_TRY(internal::SelectDispatchWorker(packet, kWorkers, index));
+    return workers_[index].Push(packet, interface);
+  }
+
+  std::array<internal::DispatchWorkerWithStorage<kQueueDepth,
+                                                 kMaxPacketSizeBytes>,
+             kWorkers>
+      workers_;
+};
+
+}  // namespace pw::rpc
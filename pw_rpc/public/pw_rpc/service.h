@@ -13,10 +13,13 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <span>
 
+#include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_rpc/internal/method.h"
@@ -30,6 +33,10 @@ namespace pw::rpc {
 // Services store a span of concrete method implementation classes. To support
 // different Method implementations, Service stores a base MethodUnion* and the
 // size of the concrete MethodUnion object.
+//
+// The methods must be sorted by method ID so they can be found with a binary
+// search. Generated services always sort their method tables; hand-written
+// tables are checked with PW_DASSERT when the Service is constructed.
 class Service : public IntrusiveList<Service>::Item {
  public:
   Service(const Service&) = delete;
@@ -52,6 +59,7 @@ class Service : public IntrusiveList<Service>::Item {
     PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
     static_assert(kMethodCount <= std::numeric_limits<uint16_t>::max());
     PW_MODIFY_DIAGNOSTICS_POP();
+    PW_DASSERT(MethodsAreSorted(methods));
   }
 
   // For use by tests with only one method.
@@ -63,7 +71,21 @@ class Service : public IntrusiveList<Service>::Item {
   friend class Server;
   friend class ServiceTestHelper;
 
+  // True if the method IDs are in strictly increasing order, as required by
+  // FindMethod().
+  template <typename T, size_t kMethodCount>
+  static constexpr bool MethodsAreSorted(
+      const std::array<T, kMethodCount>& methods) {
+    for (size_t i = 1; i < kMethodCount; ++i) {
+      if (methods[i - 1].method().id() >= methods[i].method().id()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // Finds the method with the provided method_id. Returns nullptr if no match.
+  // This is O(log n) in the number of methods.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
   const uint32_t id_;
@@ -35,6 +35,7 @@ class Writer : private internal::Call {
   using internal::Call::active;
   using internal::Call::channel_id;
 
+  using internal::Call::MaxWritePayloadSize;
   using internal::Call::Write;
 
  private:
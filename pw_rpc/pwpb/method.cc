@@ -0,0 +1,38 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/pwpb/internal/method.h"
+
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc::internal {
+
+void PwpbMethod::AsynchronousUnaryInvoker(const CallContext& context,
+                                          const Packet& request) {
+  PwpbServerCall responder(context, MethodType::kUnary);
+  rpc_lock().unlock();
+  static_cast<const PwpbMethod&>(context.method())
+      .function_.unary_request(context.service(), request.payload(), responder);
+}
+
+void PwpbMethod::ServerStreamingInvoker(const CallContext& context,
+                                        const Packet& request) {
+  PwpbServerCall server_writer(context, MethodType::kServerStreaming);
+  rpc_lock().unlock();
+  static_cast<const PwpbMethod&>(context.method())
+      .function_.unary_request(
+          context.service(), request.payload(), server_writer);
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,392 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/pwpb/internal/method.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/method_impl_tester.h"
+#include "pw_rpc/internal/test_utils.h"
+#include "pw_rpc/pwpb/internal/method_union.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_test_protos/test.pwpb.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+namespace TestRequest = ::pw::rpc::test::TestRequest;
+namespace TestResponse = ::pw::rpc::test::TestResponse;
+namespace TestStreamResponse = ::pw::rpc::test::TestStreamResponse;
+
+using Request = TestRequest::StreamDecoder;
+using Response = TestResponse::MemoryEncoder;
+using StreamResponse = TestStreamResponse::MemoryEncoder;
+
+// Create a fake service for use with the MethodImplTester.
+class TestPwpbService final : public Service {
+ public:
+  // Unary signatures
+
+  void Unary(Request&, PwpbUnaryResponder<Response>&) {}
+
+  static void StaticUnary(Request&, PwpbUnaryResponder<Response>&) {}
+
+  void AsyncUnary(Request&, PwpbUnaryResponder<Response>&) {}
+
+  static void StaticAsyncUnary(Request&, PwpbUnaryResponder<Response>&) {}
+
+  Status UnaryWrongArg(Request&, Request&) { return OkStatus(); }
+
+  // Server streaming signatures
+
+  void ServerStreaming(Request&, PwpbServerWriter<Response>&) {}
+
+  static void StaticServerStreaming(Request&, PwpbServerWriter<Response>&) {}
+
+  static void StaticUnaryVoidReturn(Request&, Response&) {}
+
+  Status ServerStreamingBadReturn(Request&, PwpbServerWriter<Response>&) {
+    return Status();
+  }
+
+  static void StaticServerStreamingMissingArg(PwpbServerWriter<Response>&) {}
+
+  // Client streaming signatures
+
+  void ClientStreaming(PwpbServerReader<Request, Response>&) {}
+
+  static void StaticClientStreaming(PwpbServerReader<Request, Response>&) {}
+
+  int ClientStreamingBadReturn(PwpbServerReader<Request, Response>&) {
+    return 0;
+  }
+
+  static void StaticClientStreamingMissingArg() {}
+
+  // Bidirectional streaming signatures
+
+  void BidirectionalStreaming(PwpbServerReaderWriter<Request, Response>&) {}
+
+  static void StaticBidirectionalStreaming(
+      PwpbServerReaderWriter<Request, Response>&) {}
+
+  int BidirectionalStreamingBadReturn(
+      PwpbServerReaderWriter<Request, Response>&) {
+    return 0;
+  }
+
+  static void StaticBidirectionalStreamingMissingArg() {}
+};
+
+static_assert(MethodImplTests<PwpbMethod, TestPwpbService>().Pass(
+    MatchesTypes<Request, Response>()));
+
+template <typename Impl>
+class FakeServiceBase : public Service {
+ public:
+  FakeServiceBase(uint32_t id) : Service(id, kMethods) {}
+
+  static constexpr std::array<PwpbMethodUnion, 4> kMethods = {
+      PwpbMethod::AsynchronousUnary<&Impl::AddFive>(10u),
+      PwpbMethod::ServerStreaming<&Impl::StartStream>(11u),
+      PwpbMethod::ClientStreaming<&Impl::ClientStream>(12u),
+      PwpbMethod::BidirectionalStreaming<&Impl::BidirectionalStream>(13u),
+  };
+};
+
+struct DecodedRequest {
+  int64_t integer = 0;
+  uint32_t status_code = 0;
+};
+
+Status DecodeRequest(Request& request, DecodedRequest& decoded) {
+  Status status;
+  while ((status = request.Next()).ok()) {
+    Result<TestRequest::Fields> field = request.Field();
+    PW_TRY(field.status());
+
+    switch (field.value()) {
+      case TestRequest::Fields::INTEGER: {
+        Result<int64_t> integer = request.ReadInteger();
+        PW_TRY(integer.status());
+        decoded.integer = integer.value();
+        break;
+      }
+      case TestRequest::Fields::STATUS_CODE: {
+        Result<uint32_t> status_code = request.ReadStatusCode();
+        PW_TRY(status_code.status());
+        decoded.status_code = status_code.value();
+        break;
+      }
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+class FakeService : public FakeServiceBase<FakeService> {
+ public:
+  FakeService(uint32_t id) : FakeServiceBase(id) {}
+
+  void AddFive(Request& request, PwpbUnaryResponder<Response>& responder) {
+    last_decode_status = DecodeRequest(request, last_request);
+    last_responder = std::move(responder);
+  }
+
+  void StartStream(Request& request, PwpbServerWriter<StreamResponse>& writer) {
+    last_decode_status = DecodeRequest(request, last_request);
+    last_writer = std::move(writer);
+  }
+
+  void ClientStream(PwpbServerReader<Request, Response>& reader) {
+    last_reader = std::move(reader);
+  }
+
+  void BidirectionalStream(
+      PwpbServerReaderWriter<Request, StreamResponse>& reader_writer) {
+    last_reader_writer = std::move(reader_writer);
+  }
+
+  Status last_decode_status;
+  DecodedRequest last_request;
+
+  PwpbUnaryResponder<Response> last_responder;
+  PwpbServerWriter<StreamResponse> last_writer;
+  PwpbServerReader<Request, Response> last_reader;
+  PwpbServerReaderWriter<Request, StreamResponse> last_reader_writer;
+};
+
+constexpr const PwpbMethod& kAsyncUnary =
+    std::get<0>(FakeServiceBase<FakeService>::kMethods).pwpb_method();
+constexpr const PwpbMethod& kServerStream =
+    std::get<1>(FakeServiceBase<FakeService>::kMethods).pwpb_method();
+constexpr const PwpbMethod& kClientStream =
+    std::get<2>(FakeServiceBase<FakeService>::kMethods).pwpb_method();
+constexpr const PwpbMethod& kBidirectionalStream =
+    std::get<3>(FakeServiceBase<FakeService>::kMethods).pwpb_method();
+
+// Encodes a TestRequest into the provided buffer.
+ConstByteSpan EncodeRequest(ByteSpan buffer,
+                            int64_t integer,
+                            uint32_t status_code) {
+  TestRequest::MemoryEncoder request(buffer);
+  EXPECT_EQ(OkStatus(), request.WriteInteger(integer));
+  EXPECT_EQ(OkStatus(), request.WriteStatusCode(status_code));
+  EXPECT_EQ(OkStatus(), request.status());
+  return buffer.first(request.size());
+}
+
+int32_t DecodeValue(ConstByteSpan payload) {
+  protobuf::Decoder decoder(payload);
+  EXPECT_EQ(OkStatus(), decoder.Next());
+  int32_t value = 0;
+  EXPECT_EQ(OkStatus(), decoder.ReadInt32(&value));
+  return value;
+}
+
+TEST(PwpbMethod, AsyncUnaryRpc_DecodesRequestFromPayload) {
+  std::array<std::byte, 16> buffer;
+  ServerContextForTest<FakeService> context(kAsyncUnary);
+  rpc_lock().lock();
+  kAsyncUnary.Invoke(context.get(),
+                     context.request(EncodeRequest(buffer, 456, 7)));
+
+  EXPECT_EQ(OkStatus(), context.service().last_decode_status);
+  EXPECT_EQ(456, context.service().last_request.integer);
+  EXPECT_EQ(7u, context.service().last_request.status_code);
+  EXPECT_EQ(0u, context.output().total_packets());
+}
+
+TEST(PwpbMethod, AsyncUnaryRpc_MalformedRequest_ReportedByDecoder) {
+  // A varint key with no value.
+  constexpr std::array<std::byte, 1> kTruncated = {std::byte{0x08}};
+
+  ServerContextForTest<FakeService> context(kAsyncUnary);
+  rpc_lock().lock();
+  kAsyncUnary.Invoke(context.get(), context.request(kTruncated));
+
+  EXPECT_EQ(Status::DataLoss(), context.service().last_decode_status);
+}
+
+TEST(PwpbUnaryResponder, Finish_EncodesResponse) {
+  ServerContextForTest<FakeService> context(kAsyncUnary);
+  rpc_lock().lock();
+  kAsyncUnary.Invoke(context.get(), context.request({}));
+
+  const int32_t value = 461;
+  ASSERT_EQ(OkStatus(),
+            context.service().last_responder.Finish(
+                [&value](Response& response) {
+                  return response.WriteValue(value);
+                },
+                Status::Unauthenticated()));
+
+  const Packet& packet = context.output().last_packet();
+  EXPECT_EQ(PacketType::RESPONSE, packet.type());
+  EXPECT_EQ(Status::Unauthenticated(), packet.status());
+  EXPECT_EQ(kAsyncUnary.id(), packet.method_id());
+  EXPECT_EQ(461, DecodeValue(packet.payload()));
+  EXPECT_FALSE(context.service().last_responder.active());
+}
+
+TEST(PwpbUnaryResponder, Finish_EncodeFails_SendsInternalError) {
+  ServerContextForTest<FakeService> context(kAsyncUnary);
+  rpc_lock().lock();
+  kAsyncUnary.Invoke(context.get(), context.request({}));
+
+  ASSERT_EQ(OkStatus(),
+            context.service().last_responder.Finish(
+                [](Response&) { return Status::InvalidArgument(); }));
+
+  const Packet& packet = context.output().last_packet();
+  EXPECT_EQ(PacketType::SERVER_ERROR, packet.type());
+  EXPECT_EQ(Status::Internal(), packet.status());
+}
+
+TEST(PwpbUnaryResponder, Finish_Closed_ReturnsFailedPrecondition) {
+  ServerContextForTest<FakeService> context(kAsyncUnary);
+  rpc_lock().lock();
+  kAsyncUnary.Invoke(context.get(), context.request({}));
+
+  auto encode = [](Response& response) { return response.WriteValue(1); };
+  ASSERT_EQ(OkStatus(), context.service().last_responder.Finish(encode));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            context.service().last_responder.Finish(encode));
+}
+
+TEST(PwpbServerWriter, Write_EncodesEachResponse) {
+  std::array<std::byte, 16> buffer;
+  ServerContextForTest<FakeService> context(kServerStream);
+  rpc_lock().lock();
+  kServerStream.Invoke(context.get(),
+                       context.request(EncodeRequest(buffer, 777, 2)));
+
+  EXPECT_EQ(777, context.service().last_request.integer);
+  EXPECT_EQ(0u, context.output().total_packets());
+
+  for (uint32_t i = 1; i <= 3; ++i) {
+    ASSERT_EQ(OkStatus(),
+              context.service().last_writer.Write(
+                  [&i](StreamResponse& response) {
+                    return response.WriteNumber(i);
+                  }));
+
+    const Packet& packet = context.output().last_packet();
+    EXPECT_EQ(PacketType::SERVER_STREAM, packet.type());
+
+    protobuf::Decoder decoder(packet.payload());
+    ASSERT_EQ(OkStatus(), decoder.Next());
+    EXPECT_EQ(static_cast<uint32_t>(TestStreamResponse::Fields::NUMBER),
+              decoder.FieldNumber());
+    uint32_t number = 0;
+    EXPECT_EQ(OkStatus(), decoder.ReadUint32(&number));
+    EXPECT_EQ(i, number);
+  }
+
+  EXPECT_EQ(3u, context.output().total_packets());
+  EXPECT_EQ(OkStatus(), context.service().last_writer.Finish());
+}
+
+TEST(PwpbServerWriter, Write_TooLargeForEncodingBuffer_ReturnsInternal) {
+  ServerContextForTest<FakeService> context(kServerStream);
+  rpc_lock().lock();
+  kServerStream.Invoke(context.get(), context.request({}));
+
+  // A kEncodingBufferSizeBytes chunk will never fit in the encoding buffer.
+  static constexpr std::array<std::byte, cfg::kEncodingBufferSizeBytes>
+      kBigData = {};
+  EXPECT_EQ(Status::Internal(),
+            context.service().last_writer.Write(
+                [](StreamResponse& response) {
+                  return response.WriteChunk(kBigData);
+                }));
+  EXPECT_TRUE(context.service().last_writer.active());
+}
+
+TEST(PwpbServerWriter, Write_Closed_ReturnsFailedPrecondition) {
+  ServerContextForTest<FakeService> context(kServerStream);
+  rpc_lock().lock();
+  kServerStream.Invoke(context.get(), context.request({}));
+
+  EXPECT_EQ(OkStatus(), context.service().last_writer.Finish());
+  EXPECT_EQ(Status::FailedPrecondition(),
+            context.service().last_writer.Write(
+                [](StreamResponse& response) {
+                  return response.WriteNumber(1);
+                }));
+}
+
+TEST(PwpbServerReader, HandlesRequests) {
+  ServerContextForTest<FakeService> context(kClientStream);
+  rpc_lock().lock();
+  kClientStream.Invoke(context.get(), context.request({}));
+
+  DecodedRequest decoded;
+  context.service().last_reader.set_on_next([&decoded](Request& request) {
+    EXPECT_EQ(OkStatus(), DecodeRequest(request, decoded));
+  });
+
+  std::array<std::byte, 16> request_buffer;
+  std::array<std::byte, 128> encoded_packet = {};
+  auto encoded =
+      context.client_stream(EncodeRequest(request_buffer, -5, 3))
+          .Encode(encoded_packet);
+  ASSERT_EQ(OkStatus(), encoded.status());
+  ASSERT_EQ(OkStatus(),
+            context.server().ProcessPacket(*encoded, context.output()));
+
+  EXPECT_EQ(-5, decoded.integer);
+  EXPECT_EQ(3u, decoded.status_code);
+
+  ASSERT_EQ(OkStatus(),
+            context.service().last_reader.Finish(
+                [](Response& response) { return response.WriteValue(9); }));
+  EXPECT_EQ(9, DecodeValue(context.output().last_packet().payload()));
+}
+
+TEST(PwpbServerReaderWriter, OnNextSurvivesMove) {
+  ServerContextForTest<FakeService> context(kBidirectionalStream);
+  rpc_lock().lock();
+  kBidirectionalStream.Invoke(context.get(), context.request({}));
+
+  DecodedRequest decoded;
+  context.service().last_reader_writer.set_on_next(
+      [&decoded](Request& request) {
+        EXPECT_EQ(OkStatus(), DecodeRequest(request, decoded));
+      });
+
+  PwpbServerReaderWriter<Request, StreamResponse> moved =
+      std::move(context.service().last_reader_writer);
+
+  std::array<std::byte, 16> request_buffer;
+  std::array<std::byte, 128> encoded_packet = {};
+  auto encoded =
+      context.client_stream(EncodeRequest(request_buffer, 42, 0))
+          .Encode(encoded_packet);
+  ASSERT_EQ(OkStatus(), encoded.status());
+  ASSERT_EQ(OkStatus(),
+            context.server().ProcessPacket(*encoded, context.output()));
+  EXPECT_EQ(42, decoded.integer);
+
+  EXPECT_EQ(OkStatus(), moved.Write([](StreamResponse& response) {
+    return response.WriteNumber(5);
+  }));
+  EXPECT_EQ(PacketType::SERVER_STREAM,
+            context.output().last_packet().type());
+}
+
+}  // namespace
+}  // namespace pw::rpc::internal
@@ -0,0 +1,271 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <type_traits>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/method.h"
+#include "pw_rpc/method_type.h"
+#include "pw_rpc/pwpb/server_reader_writer.h"
+#include "pw_rpc/service.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::rpc::internal {
+
+class PwpbMethod;
+class Packet;
+
+// Expected function signatures for user-implemented RPC functions. Request is
+// the request message's generated StreamDecoder class and Response is the
+// response message's generated MemoryEncoder class.
+template <typename Request, typename Response>
+using PwpbAsynchronousUnary = void(Request&, PwpbUnaryResponder<Response>&);
+
+template <typename Request, typename Response>
+using PwpbServerStreaming = void(Request&, PwpbServerWriter<Response>&);
+
+template <typename Request, typename Response>
+using PwpbClientStreaming = void(PwpbServerReader<Request, Response>&);
+
+template <typename Request, typename Response>
+using PwpbBidirectionalStreaming =
+    void(PwpbServerReaderWriter<Request, Response>&);
+
+// MethodTraits specialization for a static asynchronous unary method.
+template <typename Req, typename Resp>
+struct MethodTraits<PwpbAsynchronousUnary<Req, Resp>*> {
+  using Implementation = PwpbMethod;
+  using Request = Req;
+  using Response = Resp;
+
+  static constexpr MethodType kType = MethodType::kUnary;
+  static constexpr bool kSynchronous = false;
+
+  static constexpr bool kServerStreaming = false;
+  static constexpr bool kClientStreaming = false;
+};
+
+// MethodTraits specialization for an asynchronous unary method.
+template <typename T, typename Req, typename Resp>
+struct MethodTraits<PwpbAsynchronousUnary<Req, Resp>(T::*)>
+    : MethodTraits<PwpbAsynchronousUnary<Req, Resp>*> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static server streaming method.
+template <typename Req, typename Resp>
+struct MethodTraits<PwpbServerStreaming<Req, Resp>*> {
+  using Implementation = PwpbMethod;
+  using Request = Req;
+  using Response = Resp;
+
+  static constexpr MethodType kType = MethodType::kServerStreaming;
+  static constexpr bool kServerStreaming = true;
+  static constexpr bool kClientStreaming = false;
+};
+
+// MethodTraits specialization for a server streaming method.
+template <typename T, typename Req, typename Resp>
+struct MethodTraits<PwpbServerStreaming<Req, Resp>(T::*)>
+    : MethodTraits<PwpbServerStreaming<Req, Resp>*> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static client streaming method.
+template <typename Req, typename Resp>
+struct MethodTraits<PwpbClientStreaming<Req, Resp>*> {
+  using Implementation = PwpbMethod;
+  using Request = Req;
+  using Response = Resp;
+
+  static constexpr MethodType kType = MethodType::kClientStreaming;
+  static constexpr bool kServerStreaming = false;
+  static constexpr bool kClientStreaming = true;
+};
+
+// MethodTraits specialization for a client streaming method.
+template <typename T, typename Req, typename Resp>
+struct MethodTraits<PwpbClientStreaming<Req, Resp>(T::*)>
+    : MethodTraits<PwpbClientStreaming<Req, Resp>*> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static bidirectional streaming method.
+template <typename Req, typename Resp>
+struct MethodTraits<PwpbBidirectionalStreaming<Req, Resp>*> {
+  using Implementation = PwpbMethod;
+  using Request = Req;
+  using Response = Resp;
+
+  static constexpr MethodType kType = MethodType::kBidirectionalStreaming;
+  static constexpr bool kServerStreaming = true;
+  static constexpr bool kClientStreaming = true;
+};
+
+// MethodTraits specialization for a bidirectional streaming method.
+template <typename T, typename Req, typename Resp>
+struct MethodTraits<PwpbBidirectionalStreaming<Req, Resp>(T::*)>
+    : MethodTraits<PwpbBidirectionalStreaming<Req, Resp>*> {
+  using Service = T;
+};
+
+// The PwpbMethod class invokes user-defined service methods that use the
+// pw_protobuf generated message classes. Requests are not copied into a struct
+// before the method is called. Instead, the method receives the message's
+// StreamDecoder, which reads fields lazily from the request packet's payload.
+// Responses are encoded with the message's MemoryEncoder directly into the
+// pw_rpc payload buffer.
+//
+// Synchronous unary methods are not supported, since their response would have
+// to be staged somewhere while the method runs. Unary methods use a
+// PwpbUnaryResponder instead.
+class PwpbMethod : public Method {
+ public:
+  template <auto kMethod, typename RequestType, typename ResponseType>
+  static constexpr bool matches() {
+    return std::is_same_v<MethodImplementation<kMethod>, PwpbMethod> &&
+           std::is_same_v<RequestType, Request<kMethod>> &&
+           std::is_same_v<ResponseType, Response<kMethod>>;
+  }
+
+  // Creates a PwpbMethod for an asynchronous unary RPC.
+  template <auto kMethod>
+  static constexpr PwpbMethod AsynchronousUnary(uint32_t id) {
+    // Define a wrapper around the user-defined function that takes the request
+    // payload and a PwpbServerCall instead of the templated types. The wrapper
+    // constructs the request decoder on the stack; it is only a few words.
+    constexpr UnaryRequestFunction wrapper =
+        [](Service& service, ConstByteSpan payload, PwpbServerCall& call) {
+          stream::MemoryReader reader(payload);
+          Request<kMethod> request(reader);
+          return CallMethodImplFunction<kMethod>(
+              service,
+              request,
+              static_cast<PwpbUnaryResponder<Response<kMethod>>&>(call));
+        };
+    return PwpbMethod(
+        id, AsynchronousUnaryInvoker, Function{.unary_request = wrapper});
+  }
+
+  // Creates a PwpbMethod for a server-streaming RPC.
+  template <auto kMethod>
+  static constexpr PwpbMethod ServerStreaming(uint32_t id) {
+    constexpr UnaryRequestFunction wrapper =
+        [](Service& service, ConstByteSpan payload, PwpbServerCall& call) {
+          stream::MemoryReader reader(payload);
+          Request<kMethod> request(reader);
+          return CallMethodImplFunction<kMethod>(
+              service,
+              request,
+              static_cast<PwpbServerWriter<Response<kMethod>>&>(call));
+        };
+    return PwpbMethod(
+        id, ServerStreamingInvoker, Function{.unary_request = wrapper});
+  }
+
+  // Creates a PwpbMethod for a client-streaming RPC.
+  template <auto kMethod>
+  static constexpr PwpbMethod ClientStreaming(uint32_t id) {
+    constexpr StreamRequestFunction wrapper = [](Service& service,
+                                                 PwpbServerCall& reader) {
+      return CallMethodImplFunction<kMethod>(
+          service,
+          static_cast<PwpbServerReader<Request<kMethod>, Response<kMethod>>&>(
+              reader));
+    };
+    return PwpbMethod(id,
+                      ClientStreamingInvoker<Request<kMethod>>,
+                      Function{.stream_request = wrapper});
+  }
+
+  // Creates a PwpbMethod for a bidirectional-streaming RPC.
+  template <auto kMethod>
+  static constexpr PwpbMethod BidirectionalStreaming(uint32_t id) {
+    constexpr StreamRequestFunction wrapper =
+        [](Service& service, PwpbServerCall& reader_writer) {
+          return CallMethodImplFunction<kMethod>(
+              service,
+              static_cast<PwpbServerReaderWriter<Request<kMethod>,
+                                                 Response<kMethod>>&>(
+                  reader_writer));
+        };
+    return PwpbMethod(id,
+                      BidirectionalStreamingInvoker<Request<kMethod>>,
+                      Function{.stream_request = wrapper});
+  }
+
+  // Represents an invalid method. Used to reduce error message verbosity.
+  static constexpr PwpbMethod Invalid() { return {0, InvalidInvoker, {}}; }
+
+ private:
+  // Generic function signature for asynchronous unary and server streaming
+  // RPCs. The request is passed as its encoded payload.
+  using UnaryRequestFunction = void (*)(Service&,
+                                        ConstByteSpan request,
+                                        PwpbServerCall& writer);
+
+  // Generic function signature for client and bidirectional streaming RPCs.
+  using StreamRequestFunction = void (*)(Service&,
+                                         PwpbServerCall& reader_writer);
+
+  // The Function union stores a pointer to a generic version of the
+  // user-defined RPC function. Using a union instead of void* avoids
+  // reinterpret_cast, which keeps this class fully constexpr.
+  union Function {
+    UnaryRequestFunction unary_request;
+    StreamRequestFunction stream_request;
+  };
+
+  constexpr PwpbMethod(uint32_t id, Invoker invoker, Function function)
+      : Method(id, invoker), function_(function) {}
+
+  static void AsynchronousUnaryInvoker(const CallContext& context,
+                                       const Packet& request)
+      PW_UNLOCK_FUNCTION(rpc_lock());
+
+  static void ServerStreamingInvoker(const CallContext& context,
+                                     const Packet& request)
+      PW_UNLOCK_FUNCTION(rpc_lock());
+
+  // Invoker function for client streaming RPCs.
+  template <typename Request>
+  static void ClientStreamingInvoker(const CallContext& context, const Packet&)
+      PW_UNLOCK_FUNCTION(rpc_lock()) {
+    BasePwpbServerReader<Request> reader(context,
+                                         MethodType::kClientStreaming);
+    rpc_lock().unlock();
+    static_cast<const PwpbMethod&>(context.method())
+        .function_.stream_request(context.service(), reader);
+  }
+
+  // Invoker function for bidirectional streaming RPCs.
+  template <typename Request>
+  static void BidirectionalStreamingInvoker(const CallContext& context,
+                                            const Packet&)
+      PW_UNLOCK_FUNCTION(rpc_lock()) {
+    BasePwpbServerReader<Request> reader_writer(
+        context, MethodType::kBidirectionalStreaming);
+    rpc_lock().unlock();
+    static_cast<const PwpbMethod&>(context.method())
+        .function_.stream_request(context.service(), reader_writer);
+  }
+
+  // Stores the user-defined RPC in a generic wrapper.
+  Function function_;
+};
+
+}  // namespace pw::rpc::internal
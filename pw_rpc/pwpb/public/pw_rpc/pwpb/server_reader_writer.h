@@ -0,0 +1,413 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file defines the ServerReaderWriter, ServerReader, ServerWriter, and
+// UnaryResponder classes for the pw_protobuf RPC interface. Requests are
+// decoded lazily with the message's generated StreamDecoder, and responses are
+// encoded directly into the pw_rpc payload buffer with its MemoryEncoder, so no
+// intermediate message structs are allocated.
+#pragma once
+
+#include <utility>
+
+#include "pw_bytes/span.h"
+#include "pw_function/function.h"
+#include "pw_result/result.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/method_info.h"
+#include "pw_rpc/internal/method_lookup.h"
+#include "pw_rpc/internal/server_call.h"
+#include "pw_rpc/server.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::rpc {
+namespace internal {
+
+// Forward declarations for internal classes needed in friend statements.
+class PwpbMethod;
+
+namespace test {
+
+template <typename, typename, uint32_t>
+class InvocationContext;
+
+}  // namespace test
+
+// Encodes a message into the call's payload buffer by calling encode with a
+// MemoryEncoder for the message. Returns the encoded payload.
+template <typename Encoder, typename EncodeFunction>
+Result<ConstByteSpan> EncodeToPayloadBuffer(Call& call, EncodeFunction& encode)
+    PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+  Encoder encoder(call.PayloadBufferLocked());
+  PW_TRY(encode(encoder));
+  PW_TRY(encoder.status());
+  return ConstByteSpan(encoder.data(), encoder.size());
+}
+
+// Base class for the pw_protobuf server call classes. Responses are encoded by
+// a user-provided function, which is called with a Response::MemoryEncoder
+// that writes directly into the pw_rpc payload buffer.
+//
+// The encode function is called while rpc_lock() is held, since the payload
+// buffer may be shared by all calls. It must only encode the message and must
+// not call into pw_rpc.
+class PwpbServerCall : public internal::ServerCall {
+ public:
+  constexpr PwpbServerCall() = default;
+
+  PwpbServerCall(const CallContext& context, MethodType type)
+      : internal::ServerCall(context, type) {}
+
+ protected:
+  PwpbServerCall(PwpbServerCall&&) = default;
+  PwpbServerCall& operator=(PwpbServerCall&&) = default;
+
+  template <typename Encoder, typename EncodeFunction>
+  Status EncodeAndSendServerStream(EncodeFunction& encode)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    LockGuard lock(rpc_lock());
+    if (!active_locked()) {
+      return Status::FailedPrecondition();
+    }
+
+    Result<ConstByteSpan> payload =
+        EncodeToPayloadBuffer<Encoder>(*this, encode);
+    if (!payload.ok()) {
+      return Status::Internal();
+    }
+    return WriteLocked(*payload);
+  }
+
+  template <typename Encoder, typename EncodeFunction>
+  Status EncodeAndSendResponse(EncodeFunction& encode, Status status)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    LockGuard lock(rpc_lock());
+    if (!active_locked()) {
+      return Status::FailedPrecondition();
+    }
+
+    Result<ConstByteSpan> payload =
+        EncodeToPayloadBuffer<Encoder>(*this, encode);
+    if (!payload.ok()) {
+      return CloseAndSendServerErrorLocked(Status::Internal());
+    }
+    return CloseAndSendResponseLocked(*payload, status);
+  }
+};
+
+// The BasePwpbServerReader serves as the base for the ServerReader and
+// ServerReaderWriter classes. It adds a callback templated on the request
+// decoder type, which is constructed over each incoming payload.
+template <typename Request>
+class BasePwpbServerReader : public PwpbServerCall {
+ public:
+  BasePwpbServerReader(const internal::CallContext& context, MethodType type)
+      : PwpbServerCall(context, type) {}
+
+ protected:
+  constexpr BasePwpbServerReader() = default;
+
+  BasePwpbServerReader(BasePwpbServerReader&& other)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    *this = std::move(other);
+  }
+
+  BasePwpbServerReader& operator=(BasePwpbServerReader&& other)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    internal::LockGuard lock(internal::rpc_lock());
+    MoveServerCallFrom(other);
+    set_on_next_locked(std::move(other.pwpb_on_next_));
+    return *this;
+  }
+
+  void set_on_next(Function<void(Request& request)>&& on_next)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    internal::LockGuard lock(internal::rpc_lock());
+    set_on_next_locked(std::move(on_next));
+  }
+
+ private:
+  void set_on_next_locked(Function<void(Request& request)>&& on_next)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    pwpb_on_next_ = std::move(on_next);
+
+    internal::Call::set_on_next_locked([this](ConstByteSpan payload) {
+      if (pwpb_on_next_) {
+        stream::MemoryReader reader(payload);
+        Request request(reader);
+        pwpb_on_next_(request);
+      }
+    });
+  }
+
+  Function<void(Request&)> pwpb_on_next_;
+};
+
+}  // namespace internal
+
+// The PwpbServerReaderWriter is used to send and receive messages in a
+// pw_protobuf bidirectional streaming RPC. Request is the request message's
+// StreamDecoder class and Response is the response message's MemoryEncoder
+// class.
+//
+// These classes use private inheritance to hide the internal::Call API while
+// allow direct use of its public and protected functions.
+template <typename Request, typename Response>
+class PwpbServerReaderWriter
+    : private internal::BasePwpbServerReader<Request> {
+ public:
+  // Creates a PwpbServerReaderWriter that is ready to send responses for a
+  // particular RPC. This can be used for testing or to send responses to an RPC
+  // that has not been started by a client.
+  template <auto kMethod, typename ServiceImpl>
+  [[nodiscard]] static PwpbServerReaderWriter Open(Server& server,
+                                                   uint32_t channel_id,
+                                                   ServiceImpl& service) {
+    using Info = internal::MethodInfo<kMethod>;
+    static_assert(std::is_same_v<Request, typename Info::Request>,
+                  "The request type of a PwpbServerReaderWriter must match "
+                  "the method.");
+    static_assert(std::is_same_v<Response, typename Info::Response>,
+                  "The response type of a PwpbServerReaderWriter must match "
+                  "the method.");
+    internal::LockGuard lock(internal::rpc_lock());
+    return {server.OpenContext<kMethod, MethodType::kBidirectionalStreaming>(
+        channel_id,
+        service,
+        internal::MethodLookup::GetPwpbMethod<ServiceImpl,
+                                              Info::kMethodId>())};
+  }
+
+  constexpr PwpbServerReaderWriter() = default;
+
+  PwpbServerReaderWriter(PwpbServerReaderWriter&&) = default;
+  PwpbServerReaderWriter& operator=(PwpbServerReaderWriter&&) = default;
+
+  using internal::Call::active;
+  using internal::Call::channel_id;
+
+  // Encodes and sends a response. encode is called with a Response& and must
+  // return a Status. Returns the following Status codes:
+  //
+  //   OK - the response was successfully sent
+  //   FAILED_PRECONDITION - the writer is closed
+  //   INTERNAL - the response could not be encoded into the payload buffer
+  //   other errors - the ChannelOutput failed to send the packet; the error
+  //       codes are determined by the ChannelOutput implementation
+  //
+  template <typename EncodeFunction>
+  Status Write(EncodeFunction&& encode) {
+    return internal::PwpbServerCall::EncodeAndSendServerStream<Response>(
+        encode);
+  }
+
+  Status Finish(Status status = OkStatus()) {
+    return internal::Call::CloseAndSendResponse(status);
+  }
+
+  // Functions for setting RPC event callbacks.
+  using internal::Call::set_on_error;
+  using internal::ServerCall::set_on_client_stream_end;
+  using internal::BasePwpbServerReader<Request>::set_on_next;
+
+ private:
+  friend class internal::PwpbMethod;
+
+  template <typename, typename, uint32_t>
+  friend class internal::test::InvocationContext;
+
+  PwpbServerReaderWriter(const internal::CallContext& context)
+      : internal::BasePwpbServerReader<Request>(
+            context, MethodType::kBidirectionalStreaming) {}
+};
+
+// The PwpbServerReader is used to receive messages and send a response in a
+// pw_protobuf client streaming RPC.
+template <typename Request, typename Response>
+class PwpbServerReader : private internal::BasePwpbServerReader<Request> {
+ public:
+  // Creates a PwpbServerReader that is ready to send a response to a particular
+  // RPC. This can be used for testing or to finish an RPC that has not been
+  // started by the client.
+  template <auto kMethod, typename ServiceImpl>
+  [[nodiscard]] static PwpbServerReader Open(Server& server,
+                                             uint32_t channel_id,
+                                             ServiceImpl& service) {
+    using Info = internal::MethodInfo<kMethod>;
+    static_assert(
+        std::is_same_v<Request, typename Info::Request>,
+        "The request type of a PwpbServerReader must match the method.");
+    static_assert(
+        std::is_same_v<Response, typename Info::Response>,
+        "The response type of a PwpbServerReader must match the method.");
+    internal::LockGuard lock(internal::rpc_lock());
+    return {server.OpenContext<kMethod, MethodType::kClientStreaming>(
+        channel_id,
+        service,
+        internal::MethodLookup::GetPwpbMethod<ServiceImpl,
+                                              Info::kMethodId>())};
+  }
+
+  // Allow default construction so that users can declare a variable into which
+  // to move PwpbServerReaders from RPC calls.
+  constexpr PwpbServerReader() = default;
+
+  PwpbServerReader(PwpbServerReader&&) = default;
+  PwpbServerReader& operator=(PwpbServerReader&&) = default;
+
+  using internal::Call::active;
+  using internal::Call::channel_id;
+
+  // Functions for setting RPC event callbacks.
+  using internal::Call::set_on_error;
+  using internal::ServerCall::set_on_client_stream_end;
+  using internal::BasePwpbServerReader<Request>::set_on_next;
+
+  // Encodes the response with encode and finishes the RPC. Returns the same
+  // Status codes as PwpbServerReaderWriter::Write.
+  template <typename EncodeFunction>
+  Status Finish(EncodeFunction&& encode, Status status = OkStatus()) {
+    return internal::PwpbServerCall::EncodeAndSendResponse<Response>(encode,
+                                                                     status);
+  }
+
+ private:
+  friend class internal::PwpbMethod;
+
+  template <typename, typename, uint32_t>
+  friend class internal::test::InvocationContext;
+
+  PwpbServerReader(const internal::CallContext& context)
+      : internal::BasePwpbServerReader<Request>(
+            context, MethodType::kClientStreaming) {}
+};
+
+// The PwpbServerWriter is used to send responses in a pw_protobuf server
+// streaming RPC.
+template <typename Response>
+class PwpbServerWriter : private internal::PwpbServerCall {
+ public:
+  // Creates a PwpbServerWriter that is ready to send responses for a particular
+  // RPC. This can be used for testing or to send responses to an RPC that has
+  // not been started by a client.
+  template <auto kMethod, typename ServiceImpl>
+  [[nodiscard]] static PwpbServerWriter Open(Server& server,
+                                             uint32_t channel_id,
+                                             ServiceImpl& service) {
+    using Info = internal::MethodInfo<kMethod>;
+    static_assert(
+        std::is_same_v<Response, typename Info::Response>,
+        "The response type of a PwpbServerWriter must match the method.");
+    internal::LockGuard lock(internal::rpc_lock());
+    return {server.OpenContext<kMethod, MethodType::kServerStreaming>(
+        channel_id,
+        service,
+        internal::MethodLookup::GetPwpbMethod<ServiceImpl,
+                                              Info::kMethodId>())};
+  }
+
+  // Allow default construction so that users can declare a variable into which
+  // to move ServerWriters from RPC calls.
+  constexpr PwpbServerWriter() = default;
+
+  PwpbServerWriter(PwpbServerWriter&&) = default;
+  PwpbServerWriter& operator=(PwpbServerWriter&&) = default;
+
+  using internal::Call::active;
+  using internal::Call::channel_id;
+
+  // Encodes and sends a response. Returns the same Status codes as
+  // PwpbServerReaderWriter::Write.
+  template <typename EncodeFunction>
+  Status Write(EncodeFunction&& encode) {
+    return internal::PwpbServerCall::EncodeAndSendServerStream<Response>(
+        encode);
+  }
+
+  Status Finish(Status status = OkStatus()) {
+    return internal::Call::CloseAndSendResponse(status);
+  }
+
+  using internal::Call::set_on_error;
+  using internal::ServerCall::set_on_client_stream_end;
+
+ private:
+  friend class internal::PwpbMethod;
+
+  template <typename, typename, uint32_t>
+  friend class internal::test::InvocationContext;
+
+  PwpbServerWriter(const internal::CallContext& context)
+      : internal::PwpbServerCall(context, MethodType::kServerStreaming) {}
+};
+
+// The PwpbUnaryResponder is used to send the response in a pw_protobuf
+// asynchronous unary RPC.
+template <typename Response>
+class PwpbUnaryResponder : private internal::PwpbServerCall {
+ public:
+  // Creates a PwpbUnaryResponder that is ready to send a response for a
+  // particular RPC. This can be used for testing or to send responses to an RPC
+  // that has not been started by a client.
+  template <auto kMethod, typename ServiceImpl>
+  [[nodiscard]] static PwpbUnaryResponder Open(Server& server,
+                                               uint32_t channel_id,
+                                               ServiceImpl& service) {
+    using Info = internal::MethodInfo<kMethod>;
+    static_assert(
+        std::is_same_v<Response, typename Info::Response>,
+        "The response type of a PwpbUnaryResponder must match the method.");
+    internal::LockGuard lock(internal::rpc_lock());
+    return {server.OpenContext<kMethod, MethodType::kUnary>(
+        channel_id,
+        service,
+        internal::MethodLookup::GetPwpbMethod<ServiceImpl,
+                                              Info::kMethodId>())};
+  }
+
+  // Allow default construction so that users can declare a variable into which
+  // to move UnaryResponders from RPC calls.
+  constexpr PwpbUnaryResponder() = default;
+
+  PwpbUnaryResponder(PwpbUnaryResponder&&) = default;
+  PwpbUnaryResponder& operator=(PwpbUnaryResponder&&) = default;
+
+  using internal::Call::active;
+  using internal::Call::channel_id;
+
+  // Encodes the response with encode and finishes the RPC. Returns the same
+  // Status codes as PwpbServerReaderWriter::Write.
+  template <typename EncodeFunction>
+  Status Finish(EncodeFunction&& encode, Status status = OkStatus()) {
+    return internal::PwpbServerCall::EncodeAndSendResponse<Response>(encode,
+                                                                     status);
+  }
+
+  using internal::Call::set_on_error;
+  using internal::ServerCall::set_on_client_stream_end;
+
+ private:
+  friend class internal::PwpbMethod;
+
+  template <typename, typename, uint32_t>
+  friend class internal::test::InvocationContext;
+
+  PwpbUnaryResponder(const internal::CallContext& context)
+      : internal::PwpbServerCall(context, MethodType::kUnary) {}
+};
+
+}  // namespace pw::rpc
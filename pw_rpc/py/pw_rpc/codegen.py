@@ -16,7 +16,7 @@
 import abc
 from datetime import datetime
 import os
-from typing import cast, Any, Iterable, Union
+from typing import cast, Any, Iterable, List, Union
 
 from pw_protobuf.output_file import OutputFile
 from pw_protobuf.proto_tree import ProtoNode, ProtoService, ProtoServiceMethod
@@ -47,6 +47,11 @@ def get_id(item: Union[ProtoService, ProtoServiceMethod]) -> str:
     return f'0x{ids.calculate(name):08x}'
 
 
+def _methods_sorted_by_id(service: ProtoService) -> List[ProtoServiceMethod]:
+    """Returns the service's methods sorted by ID, as pw::rpc::Service needs."""
+    return sorted(service.methods(), key=lambda m: ids.calculate(m.name()))
+
+
 def client_call_type(method: ProtoServiceMethod, prefix: str) -> str:
     """Returns Client ReaderWriter/Reader/Writer/Recevier for the call."""
     if method.type() is ProtoServiceMethod.Type.UNARY:
@@ -318,8 +323,9 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
                  f'{RPC_NAMESPACE}::internal::{gen.method_union_name()},'
                  f' {len(service.methods())}> kPwRpcMethods = {{')
 
+        # Methods are sorted by ID so the server can binary search for them.
         with gen.indent(4):
-            for method in service.methods():
+            for method in _methods_sorted_by_id(service):
                 gen.method_descriptor(method)
 
         gen.line('};\n')
@@ -335,8 +341,9 @@ def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
     gen.line('static constexpr std::array<uint32_t, '
              f'{len(service.methods())}> kPwRpcMethodIds = {{')
 
+    # The IDs must be in the same order as the kPwRpcMethods table.
     with gen.indent(4):
-        for method in service.methods():
+        for method in _methods_sorted_by_id(service):
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
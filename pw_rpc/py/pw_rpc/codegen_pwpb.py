@@ -0,0 +1,146 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""This module generates the code for pw_protobuf-based pw_rpc services."""
+
+import os
+from typing import Iterable
+
+from pw_protobuf.output_file import OutputFile
+from pw_protobuf.proto_tree import ProtoNode, ProtoServiceMethod
+from pw_protobuf.proto_tree import build_node_tree
+from pw_rpc import codegen
+from pw_rpc.codegen import get_id, RPC_NAMESPACE
+from pw_rpc.codegen_raw import RawCodeGenerator
+
+PWPB_H_EXTENSION = '.pwpb.h'
+
+
+def _proto_filename_to_pwpb_header(proto_file: str) -> str:
+    """Returns the generated pw_protobuf header name for a .proto file."""
+    return os.path.splitext(proto_file)[0] + PWPB_H_EXTENSION
+
+
+def _proto_filename_to_generated_header(proto_file: str) -> str:
+    """Returns the generated C++ RPC header name for a .proto file."""
+    filename = os.path.splitext(proto_file)[0]
+    return f'{filename}.rpc{PWPB_H_EXTENSION}'
+
+
+def _decoder(message: ProtoNode) -> str:
+    """Returns the pw_protobuf StreamDecoder class for a message."""
+    return f'::{message.cpp_namespace()}::StreamDecoder'
+
+
+def _encoder(message: ProtoNode) -> str:
+    """Returns the pw_protobuf MemoryEncoder class for a message."""
+    return f'::{message.cpp_namespace()}::MemoryEncoder'
+
+
+class PwpbCodeGenerator(RawCodeGenerator):
+    """Generates an RPC service using the pw_protobuf API.
+
+    Service methods receive the request message's StreamDecoder, which decodes
+    fields lazily from the request payload, and encode responses with the
+    response message's MemoryEncoder. Clients use the raw client API, since
+    requests and responses are already encoded and decoded in place.
+    """
+    def name(self) -> str:
+        return 'pwpb'
+
+    def method_union_name(self) -> str:
+        return 'PwpbMethodUnion'
+
+    def includes(self, proto_file_name: str) -> Iterable[str]:
+        yield '#include "pw_rpc/pwpb/internal/method_union.h"'
+        yield '#include "pw_rpc/pwpb/server_reader_writer.h"'
+        yield '#include "pw_rpc/raw/client_reader_writer.h"'
+
+        # Include the corresponding pw_protobuf header file for this proto
+        # file, in which the file's message classes are generated.
+        yield f'#include "{_proto_filename_to_pwpb_header(proto_file_name)}"'
+
+    def service_aliases(self) -> None:
+        self.line('template <typename Response>')
+        self.line('using UnaryResponder = '
+                  f'{RPC_NAMESPACE}::PwpbUnaryResponder<Response>;')
+        self.line('template <typename Response>')
+        self.line('using ServerWriter = '
+                  f'{RPC_NAMESPACE}::PwpbServerWriter<Response>;')
+        self.line('template <typename Request, typename Response>')
+        self.line('using ServerReader = '
+                  f'{RPC_NAMESPACE}::PwpbServerReader<Request, Response>;')
+        self.line('template <typename Request, typename Response>')
+        self.line(
+            'using ServerReaderWriter = '
+            f'{RPC_NAMESPACE}::PwpbServerReaderWriter<Request, Response>;')
+
+    def method_descriptor(self, method: ProtoServiceMethod) -> None:
+        self.line(f'{RPC_NAMESPACE}::internal::'
+                  f'GetPwpbOrRawMethodFor<&Implementation::{method.name()}, '
+                  f'{method.type().cc_enum()}, '
+                  f'{_decoder(method.request_type())}, '
+                  f'{_encoder(method.response_type())}>(')
+        self.line(f'    {get_id(method)}),  // Hash of "{method.name()}"')
+
+    def method_info_specialization(self, method: ProtoServiceMethod) -> None:
+        self.line()
+        self.line(f'using Request = {_decoder(method.request_type())};')
+        self.line(f'using Response = {_encoder(method.response_type())};')
+
+
+class StubGenerator(codegen.StubGenerator):
+    """Generates pw_protobuf RPC stubs."""
+    def unary_signature(self, method: ProtoServiceMethod, prefix: str) -> str:
+        return (f'void {prefix}{method.name()}('
+                f'{_decoder(method.request_type())}& request, '
+                f'UnaryResponder<{_encoder(method.response_type())}>& '
+                'responder)')
+
+    def unary_stub(self, method: ProtoServiceMethod,
+                   output: OutputFile) -> None:
+        output.write_line(codegen.STUB_REQUEST_TODO)
+        output.write_line('static_cast<void>(request);')
+        output.write_line(codegen.STUB_RESPONSE_TODO)
+        output.write_line('static_cast<void>(responder);')
+
+    def server_streaming_signature(self, method: ProtoServiceMethod,
+                                   prefix: str) -> str:
+        return (f'void {prefix}{method.name()}('
+                f'{_decoder(method.request_type())}& request, '
+                f'ServerWriter<{_encoder(method.response_type())}>& writer)')
+
+    def client_streaming_signature(self, method: ProtoServiceMethod,
+                                   prefix: str) -> str:
+        return (f'void {prefix}{method.name()}('
+                f'ServerReader<{_decoder(method.request_type())}, '
+                f'{_encoder(method.response_type())}>& reader)')
+
+    def bidirectional_streaming_signature(self, method: ProtoServiceMethod,
+                                          prefix: str) -> str:
+        return (f'void {prefix}{method.name()}('
+                f'ServerReaderWriter<{_decoder(method.request_type())}, '
+                f'{_encoder(method.response_type())}>& reader_writer)')
+
+
+def process_proto_file(proto_file) -> Iterable[OutputFile]:
+    """Generates code for a single .proto file."""
+
+    _, package_root = build_node_tree(proto_file)
+    output_filename = _proto_filename_to_generated_header(proto_file.name)
+    generator = PwpbCodeGenerator(output_filename)
+    codegen.generate_package(proto_file, package_root, generator)
+
+    codegen.package_stubs(package_root, generator, StubGenerator())
+
+    return [generator.output]
@@ -286,6 +286,34 @@ TEST(RawClientWriter, WithClientStream_OutOfScope_SendsClientStreamEnd) {
             1u);
 }
 
+#if PW_RPC_FLOW_CONTROL
+
+TEST(RawClientReader, GrantCredit_SendsFlowControlPacket) {
+  RawClientTestContext ctx;
+  RawClientReader call = TestService::TestServerStreamRpc(ctx.client(),
+                                                          ctx.channel().id(),
+                                                          {},
+                                                          FailIfOnNextCalled,
+                                                          FailIfCalled,
+                                                          FailIfCalled);
+
+  ASSERT_EQ(OkStatus(), call.GrantCredit(5));
+
+  ASSERT_EQ(ctx.output().total_packets(), 2u);
+  const internal::Packet& packet =
+      static_cast<internal::test::FakeChannelOutput&>(ctx.output())
+          .last_packet();
+  EXPECT_EQ(packet.type(), internal::PacketType::CLIENT_FLOW_CONTROL);
+  EXPECT_EQ(packet.credit(), 5u);
+}
+
+TEST(RawClientReader, GrantCredit_Closed) {
+  RawClientReader call;
+  EXPECT_EQ(Status::FailedPrecondition(), call.GrantCredit(1));
+}
+
+#endif  // PW_RPC_FLOW_CONTROL
+
 constexpr const char kWriterData[] = "20X6";
 
 void WriteAsWriter(Writer& writer) {
@@ -14,11 +14,15 @@
 
 #include "pw_rpc/client.h"
 
+#include <array>
+#include <cstring>
 #include <optional>
 
 #include "gtest/gtest.h"
+#include "pw_rpc/call_pool.h"
 #include "pw_rpc/internal/client_call.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/raw/client_reader_writer.h"
 #include "pw_rpc/raw/client_testing.h"
 
 namespace pw::rpc {
@@ -177,6 +181,186 @@ TEST(Client, ProcessPacket_ReturnsInvalidArgumentOnServerPacket) {
   EXPECT_EQ(context.client().ProcessPacket(*result), Status::InvalidArgument());
 }
 
+// Sends a unary response for a specific call, since FakeServer always responds
+// to the most recent call.
+template <typename Context>
+void SendUnaryResponse(Context& context, uint32_t call_id, const char* text) {
+  std::byte encoded[64];
+  Result<ConstByteSpan> result =
+      internal::Packet(internal::PacketType::RESPONSE,
+                       context.channel().id(),
+                       internal::MethodInfo<UnaryMethod>::kServiceId,
+                       internal::MethodInfo<UnaryMethod>::kMethodId,
+                       call_id,
+                       std::as_bytes(std::span(text, std::strlen(text) + 1)))
+          .Encode(encoded);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(context.client().ProcessPacket(*result), OkStatus());
+}
+
+// Records the call IDs of packets sent by the client.
+class CallIds {
+ public:
+  template <typename Context>
+  CallIds(Context& context) {
+    context.output().set_on_send([this](ConstByteSpan buffer, Status) {
+      if (count_ < ids_.size()) {
+        ids_[count_++] = internal::Packet::FromBuffer(buffer)->call_id();
+      }
+    });
+  }
+
+  uint32_t operator[](size_t index) const { return ids_[index]; }
+
+ private:
+  std::array<uint32_t, 8> ids_{};
+  size_t count_ = 0;
+};
+
+TEST(Client, UnaryCall_CancelsPendingCallToSameMethod) {
+  RawClientTestContext context;
+  TestUnaryCall call_1 = MakeCall<UnaryMethod, TestUnaryCall>(context);
+  TestUnaryCall call_2 = MakeCall<UnaryMethod, TestUnaryCall>(context);
+
+  EXPECT_EQ(call_1.error, Status::Cancelled());
+  EXPECT_FALSE(call_2.error.has_value());
+}
+
+TEST(Client, PipelinedUnaryCalls_ReceiveTheirOwnResponses) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+  CallIds call_ids(context);
+
+  TestUnaryCall call_1 = MakeCall<UnaryMethod, TestUnaryCall>(context);
+  internal::rpc_lock().lock();
+  call_1.SendInitialClientRequest({});
+  TestUnaryCall call_2 = MakeCall<UnaryMethod, TestUnaryCall>(context);
+  internal::rpc_lock().lock();
+  call_2.SendInitialClientRequest({});
+  TestUnaryCall call_3 = MakeCall<UnaryMethod, TestUnaryCall>(context);
+  internal::rpc_lock().lock();
+  call_3.SendInitialClientRequest({});
+
+  ASSERT_EQ(context.output().total_packets(), 3u);
+  EXPECT_FALSE(call_1.error.has_value());
+  EXPECT_FALSE(call_2.error.has_value());
+
+  // Respond out of order. The payload is only valid until the next response.
+  SendUnaryResponse(context, call_ids[1], "two");
+  ASSERT_EQ(call_2.completed, OkStatus());
+  EXPECT_STREQ(call_2.payload, "two");
+
+  SendUnaryResponse(context, call_ids[2], "three");
+  ASSERT_EQ(call_3.completed, OkStatus());
+  EXPECT_STREQ(call_3.payload, "three");
+
+  EXPECT_FALSE(call_1.completed.has_value());
+  SendUnaryResponse(context, call_ids[0], "one");
+  ASSERT_EQ(call_1.completed, OkStatus());
+  EXPECT_STREQ(call_1.payload, "one");
+}
+
+TEST(Client, PipelinedUnaryCalls_ResponseForUnknownCallIdIsDropped) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+  CallIds call_ids(context);
+
+  TestUnaryCall call = MakeCall<UnaryMethod, TestUnaryCall>(context);
+  internal::rpc_lock().lock();
+  call.SendInitialClientRequest({});
+
+  SendUnaryResponse(context, call_ids[0] + 1, "?");
+  EXPECT_FALSE(call.completed.has_value());
+}
+
+TEST(Client, PipelinedUnaryCalls_StreamingCallsStillReplaced) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+
+  auto call_1 = MakeCall<BidirectionalStreamMethod, TestStreamCall>(context);
+  auto call_2 = MakeCall<BidirectionalStreamMethod, TestStreamCall>(context);
+
+  EXPECT_EQ(call_1.error, Status::Cancelled());
+  EXPECT_FALSE(call_2.error.has_value());
+}
+
+RawUnaryReceiver StartUnaryCall(RawClientTestContext<>& context,
+                                int& completed_count) {
+  return internal::UnaryResponseClientCall::Start<RawUnaryReceiver>(
+      context.client(),
+      context.channel().id(),
+      internal::MethodInfo<UnaryMethod>::kServiceId,
+      internal::MethodInfo<UnaryMethod>::kMethodId,
+      [&completed_count](ConstByteSpan, Status) { completed_count += 1; },
+      nullptr,
+      {});
+}
+
+TEST(CallPool, Start_FillsFreeSlots) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+  CallPool<RawUnaryReceiver, 2> pool;
+  int completed = 0;
+
+  EXPECT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+  EXPECT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+  EXPECT_EQ(pool.active_calls(), 2u);
+
+  bool started = false;
+  EXPECT_EQ(pool.Start([&] {
+    started = true;
+    return StartUnaryCall(context, completed);
+  }),
+            Status::ResourceExhausted());
+  EXPECT_FALSE(started);
+  EXPECT_EQ(context.output().total_packets(), 2u);
+}
+
+TEST(CallPool, Start_ReusesCompletedSlots) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+  CallIds call_ids(context);
+  CallPool<RawUnaryReceiver, 2> pool;
+  int completed = 0;
+
+  ASSERT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+  ASSERT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+
+  SendUnaryResponse(context, call_ids[0], "done");
+  EXPECT_EQ(completed, 1);
+  EXPECT_EQ(pool.active_calls(), 1u);
+
+  EXPECT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+  EXPECT_EQ(pool.active_calls(), 2u);
+
+  SendUnaryResponse(context, call_ids[1], "done");
+  SendUnaryResponse(context, call_ids[2], "done");
+  EXPECT_EQ(completed, 3);
+  EXPECT_EQ(pool.active_calls(), 0u);
+}
+
+TEST(CallPool, CancelAll) {
+  RawClientTestContext context;
+  context.client().set_pipeline_unary_calls(true);
+  CallPool<RawUnaryReceiver, 3> pool;
+  int completed = 0;
+
+  ASSERT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+  ASSERT_EQ(pool.Start([&] { return StartUnaryCall(context, completed); }),
+            OkStatus());
+
+  pool.CancelAll();
+  EXPECT_EQ(pool.active_calls(), 0u);
+  EXPECT_EQ(context.output().total_packets(), 4u);  // 2 requests, 2 cancels
+  EXPECT_EQ(completed, 0);
+}
+
 const Channel* GetChannel(internal::Endpoint& endpoint, uint32_t id) {
   internal::LockGuard lock(internal::rpc_lock());
   return endpoint.GetInternalChannel(id);
@@ -46,12 +46,18 @@ class RawClientReaderWriter : private internal::StreamResponseClientCall {
   // Sends a stream request packet with the given raw payload.
   using internal::Call::Write;
 
+  // Returns the largest payload that Write() can send in one packet.
+  using internal::Call::MaxWritePayloadSize;
+
   // Notifies the server that no further client stream messages will be sent.
   using internal::Call::CloseClientStream;
 
   // Cancels this RPC.
   using internal::Call::Cancel;
 
+  // Grants the server credit for more responses. Requires PW_RPC_FLOW_CONTROL.
+  using internal::Call::GrantCredit;
+
   // Allow use as a generic RPC Writer.
   using internal::Call::operator Writer&;
   using internal::Call::operator const Writer&;
@@ -84,6 +90,7 @@ class RawClientReader : private internal::StreamResponseClientCall {
   using internal::StreamResponseClientCall::set_on_next;
 
   using internal::Call::Cancel;
+  using internal::Call::GrantCredit;
 
  private:
   friend class internal::StreamResponseClientCall;
@@ -115,6 +122,7 @@ class RawClientWriter : private internal::UnaryResponseClientCall {
 
   using internal::Call::Cancel;
   using internal::Call::CloseClientStream;
+  using internal::Call::MaxWritePayloadSize;
   using internal::Call::Write;
 
   // Allow use as a generic RPC Writer.
@@ -78,6 +78,9 @@ class RawServerReaderWriter : private internal::ServerCall {
   // Sends a response packet with the given raw payload.
   using internal::Call::Write;
 
+  // Returns the largest payload that Write() can send in one packet.
+  using internal::Call::MaxWritePayloadSize;
+
   Status Finish(Status status = OkStatus()) {
     return CloseAndSendResponse(status);
   }
@@ -176,6 +179,7 @@ class RawServerWriter : private RawServerReaderWriter {
   using RawServerReaderWriter::set_on_error;
 
   using RawServerReaderWriter::Finish;
+  using RawServerReaderWriter::MaxWritePayloadSize;
   using RawServerReaderWriter::Write;
 
   // Allow use as a generic RPC Writer.
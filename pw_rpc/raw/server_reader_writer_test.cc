@@ -15,6 +15,7 @@
 #include "pw_rpc/raw/server_reader_writer.h"
 
 #include "gtest/gtest.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/raw/fake_channel_output.h"
 #include "pw_rpc/service.h"
@@ -130,6 +131,20 @@ TEST(RawServerWriter, Closed) {
   call.set_on_error([](Status) {});
 }
 
+TEST(RawServerWriter, MaxWritePayloadSize) {
+  ReaderWriterTestContext ctx;
+  RawServerWriter call =
+      RawServerWriter::Open<TestService::TestServerStreamRpc>(
+          ctx.server, ctx.channel.id(), ctx.service);
+
+  const size_t max_payload = call.MaxWritePayloadSize();
+  ASSERT_GT(max_payload, 0u);
+  EXPECT_LT(max_payload, cfg::kEncodingBufferSizeBytes);
+
+  ASSERT_EQ(OkStatus(), call.Finish(OkStatus()));
+  EXPECT_EQ(call.MaxWritePayloadSize(), 0u);
+}
+
 TEST(RawServerReader, Closed) {
   ReaderWriterTestContext ctx;
   RawServerReader call =
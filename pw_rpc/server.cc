@@ -30,6 +30,10 @@ namespace {
 using internal::Packet;
 using internal::PacketType;
 
+bool ServiceIdLessThan(const Service* service, uint32_t id) {
+  return service->id() < id;
+}
+
 }  // namespace
 
 Status Server::ProcessPacket(ConstByteSpan packet_data,
@@ -101,6 +105,17 @@ Status Server::ProcessPacket(ConstByteSpan packet_data,
     case PacketType::CLIENT_STREAM_END:
       HandleClientStreamPacket(packet, *channel, call);
       break;
+#if PW_RPC_FLOW_CONTROL
+    case PacketType::CLIENT_FLOW_CONTROL:
+      // Credit for calls that are not pending or have no server stream is
+      // ignored, since the client may have sent it before the call ended.
+      if (call != nullptr && call->id() == packet.call_id() &&
+          call->has_server_stream()) {
+        call->HandleCredit(packet.credit());
+      }
+      internal::rpc_lock().unlock();
+      break;
+#endif  // PW_RPC_FLOW_CONTROL
     default:
       internal::rpc_lock().unlock();
       PW_LOG_WARN("pw_rpc server unable to handle packet of type %u",
@@ -110,18 +125,51 @@ Status Server::ProcessPacket(ConstByteSpan packet_data,
   return OkStatus();  // OK since the packet was handled
 }
 
+void Server::AddService(Service& service) {
+  services_.push_front(service);
+
+  if (indexed_services_ == service_index_.size()) {
+    return;  // The index is full; this service is only in the list.
+  }
+
+  const auto end = service_index_.begin() + indexed_services_;
+  const auto position = std::lower_bound(
+      service_index_.begin(), end, service.id(), ServiceIdLessThan);
+  std::move_backward(position, end, end + 1);
+  *position = &service;
+  indexed_services_ += 1;
+}
+
+Service* Server::FindService(uint32_t service_id) {
+  const auto end = service_index_.begin() + indexed_services_;
+  const auto indexed = std::lower_bound(
+      service_index_.begin(), end, service_id, ServiceIdLessThan);
+
+  if (indexed != end && (*indexed)->id() == service_id) {
+    return *indexed;
+  }
+
+  // If every service fit in the index, the service is not registered.
+  if (indexed_services_ < service_index_.size()) {
+    return nullptr;
+  }
+
+  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
+    return s.id() == service_id;
+  });
+  return service == services_.end() ? nullptr : &(*service);
+}
+
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     const internal::Packet& packet) {
   // Packets always include service and method IDs.
-  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
-    return s.id() == packet.service_id();
-  });
+  Service* const service = FindService(packet.service_id());
 
-  if (service == services_.end()) {
+  if (service == nullptr) {
     return {};
   }
 
-  return {&(*service), service->FindMethod(packet.method_id())};
+  return {service, service->FindMethod(packet.method_id())};
 }
 
 void Server::HandleClientStreamPacket(const internal::Packet& packet,
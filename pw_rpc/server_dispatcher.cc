@@ -0,0 +1,98 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/server_dispatcher.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc::internal {
+
+Status SelectDispatchWorker(ConstByteSpan packet,
+                            size_t workers,
+                            size_t& worker) {
+  Result<Packet> result = Packet::FromBuffer(packet);
+  if (!result.ok()) {
+    return Status::DataLoss();
+  }
+
+  // Service and method IDs are already hashes, so a cheap mix is enough.
+  uint32_t hash = result->service_id() ^ (result->method_id() * 0x9e3779b1u) ^
+                  (result->channel_id() * 0x85ebca6bu);
+  hash ^= hash >> 16;
+  worker = hash % workers;
+  return OkStatus();
+}
+
+Status DispatchWorker::Push(ConstByteSpan packet, ChannelOutput* interface) {
+  if (packet.size() > max_packet_size_bytes_) {
+    return Status::ResourceExhausted();
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    if (count_ == entries_.size()) {
+      return Status::ResourceExhausted();
+    }
+
+    const size_t index = (head_ + count_) % entries_.size();
+    std::memcpy(slot(index).data(), packet.data(), packet.size());
+    entries_[index] = {.size = packet.size(), .interface = interface};
+    count_ += 1;
+  }
+
+  ready_.release();
+  return OkStatus();
+}
+
+void DispatchWorker::Stop() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  ready_.release();
+}
+
+void DispatchWorker::Run() {
+  while (true) {
+    ready_.acquire();
+
+    size_t index;
+    Entry entry;
+    {
+      std::lock_guard lock(mutex_);
+      if (stop_) {
+        return;
+      }
+      index = head_;
+      entry = entries_[index];
+    }
+
+    // Errors are logged by the server.
+    const ConstByteSpan packet = slot(index).first(entry.size);
+    if (entry.interface != nullptr) {
+      server_->ProcessPacket(packet, *entry.interface).IgnoreError();
+    } else {
+      server_->ProcessPacket(packet).IgnoreError();
+    }
+
+    std::lock_guard lock(mutex_);
+    head_ = (head_ + 1) % entries_.size();
+    count_ -= 1;
+  }
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,197 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/server_dispatcher.h"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+
+constexpr uint32_t kServiceId = internal::Hash("pw.rpc.Benchmark");
+constexpr uint32_t kUnaryEcho = internal::Hash("UnaryEcho");
+
+// TODO(frolv): Have a generic way to obtain a thread for testing on any system.
+const thread::Options& WorkerOptions() {
+  static thread::stl::Options options;
+  return options;
+}
+
+// Records the first payload byte of each response, per channel.
+class RecordingOutput : public ChannelOutput {
+ public:
+  RecordingOutput() : ChannelOutput("RecordingOutput") {}
+
+  Status Send(ConstByteSpan buffer) override {
+    Result<Packet> packet = Packet::FromBuffer(buffer);
+    EXPECT_EQ(OkStatus(), packet.status());
+    if (packet.ok() && !packet->payload().empty()) {
+      std::lock_guard lock(mutex_);
+      responses_[packet->channel_id()].push_back(
+          static_cast<uint8_t>(packet->payload()[0]));
+    }
+    sent_.release();
+    return OkStatus();
+  }
+
+  void WaitForPackets(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_TRUE(sent_.try_acquire_for(std::chrono::seconds(10)));
+    }
+  }
+
+  Vector<uint8_t, 16> responses(uint32_t channel_id) {
+    std::lock_guard lock(mutex_);
+    return responses_[channel_id];
+  }
+
+ private:
+  sync::CountingSemaphore sent_;
+  sync::Mutex mutex_;
+  std::array<Vector<uint8_t, 16>, 3> responses_;
+};
+
+class ServerDispatcherTest : public ::testing::Test {
+ protected:
+  ServerDispatcherTest()
+      : channels_{Channel::Create<1>(&output_), Channel::Create<2>(&output_)},
+        server_(channels_) {
+    server_.RegisterService(service_);
+  }
+
+  ConstByteSpan Request(uint32_t channel_id, uint8_t sequence) {
+    payload_[0] = std::byte{sequence};
+    const Packet packet(PacketType::REQUEST,
+                        channel_id,
+                        kServiceId,
+                        kUnaryEcho,
+                        sequence,
+                        payload_);
+    Result<ConstByteSpan> encoded = packet.Encode(request_buffer_);
+    EXPECT_EQ(OkStatus(), encoded.status());
+    return encoded.value_or(ConstByteSpan());
+  }
+
+  RecordingOutput output_;
+  std::array<Channel, 2> channels_;
+  Server server_;
+  BenchmarkService service_;
+
+  std::array<std::byte, 1> payload_ = {};
+  std::array<std::byte, 64> request_buffer_ = {};
+};
+
+TEST_F(ServerDispatcherTest, ProcessPacket_MalformedPacket_DataLoss) {
+  ServerDispatcher<1, 2, 64> dispatcher(server_);
+  constexpr std::byte kGarbage[] = {std::byte{0xff}, std::byte{0xff}};
+
+  EXPECT_EQ(Status::DataLoss(), dispatcher.ProcessPacket(kGarbage));
+}
+
+TEST_F(ServerDispatcherTest, ProcessPacket_QueueFull_ResourceExhausted) {
+  ServerDispatcher<1, 2, 64> dispatcher(server_);
+
+  // No worker is running, so packets stay queued.
+  EXPECT_EQ(OkStatus(), dispatcher.ProcessPacket(Request(1, 0)));
+  EXPECT_EQ(OkStatus(), dispatcher.ProcessPacket(Request(1, 1)));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            dispatcher.ProcessPacket(Request(1, 2)));
+}
+
+TEST_F(ServerDispatcherTest, ProcessPacket_PacketTooLarge_ResourceExhausted) {
+  ServerDispatcher<1, 2, 8> dispatcher(server_);
+
+  EXPECT_EQ(Status::ResourceExhausted(),
+            dispatcher.ProcessPacket(Request(1, 0)));
+}
+
+TEST_F(ServerDispatcherTest, Worker_ProcessesPacketsInOrder) {
+  ServerDispatcher<1, 4, 64> dispatcher(server_);
+  thread::Thread worker(WorkerOptions(), dispatcher.worker(0));
+
+  for (uint8_t i = 0; i < 10; ++i) {
+    while (dispatcher.ProcessPacket(Request(1, i)).IsResourceExhausted()) {
+      // Retry until the worker makes room in its queue.
+    }
+  }
+  output_.WaitForPackets(10);
+
+  dispatcher.Stop();
+  worker.join();
+
+  const Vector<uint8_t, 16> responses = output_.responses(1);
+  ASSERT_EQ(responses.size(), 10u);
+  for (uint8_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(responses[i], i);
+  }
+}
+
+TEST_F(ServerDispatcherTest, Stop_WithoutPackets_WorkerReturns) {
+  ServerDispatcher<2, 1, 64> dispatcher(server_);
+  thread::Thread worker_0(WorkerOptions(), dispatcher.worker(0));
+  thread::Thread worker_1(WorkerOptions(), dispatcher.worker(1));
+
+  dispatcher.Stop();
+  worker_0.join();
+  worker_1.join();
+}
+
+#if PW_RPC_USE_GLOBAL_MUTEX
+
+TEST_F(ServerDispatcherTest, MultipleWorkers_PreserveOrderPerCall) {
+  ServerDispatcher<2, 4, 64> dispatcher(server_);
+  thread::Thread worker_0(WorkerOptions(), dispatcher.worker(0));
+  thread::Thread worker_1(WorkerOptions(), dispatcher.worker(1));
+
+  for (uint8_t i = 0; i < 10; ++i) {
+    for (uint32_t channel_id : {1u, 2u}) {
+      while (dispatcher.ProcessPacket(Request(channel_id, i))
+                 .IsResourceExhausted()) {
+      }
+    }
+  }
+  output_.WaitForPackets(20);
+
+  dispatcher.Stop();
+  worker_0.join();
+  worker_1.join();
+
+  for (uint32_t channel_id : {1u, 2u}) {
+    const Vector<uint8_t, 16> responses = output_.responses(channel_id);
+    ASSERT_EQ(responses.size(), 10u);
+    for (uint8_t i = 0; i < 10; ++i) {
+      EXPECT_EQ(responses[i], i);
+    }
+  }
+}
+
+#endif  // PW_RPC_USE_GLOBAL_MUTEX
+
+}  // namespace
+}  // namespace pw::rpc
@@ -36,17 +36,25 @@ using internal::PacketType;
 using internal::TestMethod;
 using internal::TestMethodUnion;
 
-class TestService : public Service {
- public:
-  TestService(uint32_t service_id)
-      : Service(service_id, methods_),
-        methods_{
+// Holds the methods in a base class so they are initialized before the Service
+// constructor checks that they are sorted.
+class TestServiceMethods {
+ protected:
+  TestServiceMethods()
+      : test_methods_{
             TestMethod(100, MethodType::kBidirectionalStreaming),
             TestMethod(200),
         } {}
 
+  std::array<TestMethodUnion, 2> test_methods_;
+};
+
+class TestService : private TestServiceMethods, public Service {
+ public:
+  TestService(uint32_t service_id) : Service(service_id, test_methods_) {}
+
   const TestMethod& method(uint32_t id) {
-    for (TestMethodUnion& method : methods_) {
+    for (TestMethodUnion& method : test_methods_) {
       if (method.method().id() == id) {
         return method.test_method();
       }
@@ -54,9 +62,6 @@ class TestService : public Service {
 
     PW_CRASH("Invalid method ID %u", static_cast<unsigned>(id));
   }
-
- private:
-  std::array<TestMethodUnion, 2> methods_;
 };
 
 class EmptyService : public Service {
@@ -533,5 +538,80 @@ TEST_F(ServerStreamingMethod, ClientStreamEnd_InvalidArgumentError) {
   EXPECT_EQ(packet.status(), Status::InvalidArgument());
 }
 
+#if PW_RPC_FLOW_CONTROL
+
+class FlowControlledMethod : public ServerStreamingMethod {
+ protected:
+  // Cancel the call so that it does not send a RESPONSE when it is destroyed,
+  // since output_ only stores two packets.
+  ~FlowControlledMethod() {
+    server_.ProcessPacket(EncodeCancel(), output_).IgnoreError();
+  }
+
+  ConstByteSpan EncodeCredit(uint32_t credit, uint32_t call_id = 0) {
+    Packet packet(PacketType::CLIENT_FLOW_CONTROL, 1, 42, 100, call_id);
+    packet.set_credit(credit);
+    return packet.Encode(credit_buffer_).value_or(ConstByteSpan());
+  }
+
+ private:
+  byte credit_buffer_[32];
+};
+
+TEST_F(FlowControlledMethod, NoCredit_WritesAreUnlimited) {
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(output_.total_packets(), 2u);
+}
+
+TEST_F(FlowControlledMethod, Credit_LimitsWrites) {
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(1), output_));
+
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write({}));
+  EXPECT_EQ(output_.total_packets(), 1u);
+  EXPECT_TRUE(responder_.active());
+}
+
+TEST_F(FlowControlledMethod, ZeroCredit_PausesStream) {
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(0), output_));
+
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write({}));
+  EXPECT_EQ(output_.total_packets(), 0u);
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(2), output_));
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write({}));
+}
+
+TEST_F(FlowControlledMethod, Credit_Accumulates) {
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(1), output_));
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(1), output_));
+
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write({}));
+}
+
+TEST_F(FlowControlledMethod, Credit_Saturates) {
+  ASSERT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeCredit(UINT32_MAX), output_));
+  ASSERT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeCredit(UINT32_MAX), output_));
+
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+}
+
+TEST_F(FlowControlledMethod, CreditForOtherCall_Ignored) {
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(0, 7), output_));
+
+  EXPECT_EQ(OkStatus(), responder_.Write({}));
+  EXPECT_EQ(output_.total_packets(), 1u);
+}
+
+#endif  // PW_RPC_FLOW_CONTROL
+
 }  // namespace
 }  // namespace pw::rpc
@@ -20,17 +20,26 @@
 namespace pw::rpc {
 
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
-  const internal::MethodUnion* method_impl = methods_;
-
-  for (size_t i = 0; i < method_count_; ++i) {
-    const internal::Method* method = &method_impl->method();
-    if (method->id() == method_id) {
+  // Methods are sorted by ID, so binary search the method table. The table is
+  // an array of MethodUnions of size method_size_, so index it by byte offset.
+  const auto raw = reinterpret_cast<const std::byte*>(methods_);
+  size_t low = 0;
+  size_t high = method_count_;
+
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const internal::Method* method =
+        &reinterpret_cast<const internal::MethodUnion*>(
+             raw + middle * method_size_)
+             ->method();
+
+    if (method->id() < method_id) {
+      low = middle + 1;
+    } else if (method->id() > method_id) {
+      high = middle;
+    } else {
       return method;
     }
-
-    const auto raw = reinterpret_cast<const std::byte*>(method_impl);
-    method_impl =
-        reinterpret_cast<const internal::MethodUnion*>(raw + method_size_);
   }
 
   return nullptr;
@@ -24,6 +24,12 @@ class ServiceTestHelper {
   static const internal::Method* FindMethod(Service& service, uint32_t id) {
     return service.FindMethod(id);
   }
+
+  template <typename T, size_t kMethodCount>
+  static constexpr bool MethodsAreSorted(
+      const std::array<T, kMethodCount>& methods) {
+    return Service::MethodsAreSorted(methods);
+  }
 };
 
 namespace {
@@ -80,6 +86,40 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class ManyMethodsTestService : public Service {
+ public:
+  constexpr ManyMethodsTestService() : Service(0xabcd, kMethods) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 8> kMethods = {
+      ServiceTestMethod(2, 'a'),
+      ServiceTestMethod(3, 'b'),
+      ServiceTestMethod(5, 'c'),
+      ServiceTestMethod(7, 'd'),
+      ServiceTestMethod(11, 'e'),
+      ServiceTestMethod(13, 'f'),
+      ServiceTestMethod(17, 'g'),
+      ServiceTestMethod(0xffffffff, 'h'),
+  };
+};
+
+TEST(Service, ManyMethods_FindMethod_FindsEveryMethod) {
+  ManyMethodsTestService service;
+  for (const ServiceTestMethodUnion& method : ManyMethodsTestService::kMethods) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, method.method().id()),
+              &method.method());
+  }
+}
+
+TEST(Service, ManyMethods_FindMethod_NotPresent) {
+  ManyMethodsTestService service;
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 1), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 4), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 12), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 18), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0xfffffffe), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
@@ -93,5 +133,25 @@ TEST(Service, NoMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 789), nullptr);
 }
 
+TEST(Service, MethodsAreSorted) {
+  EXPECT_TRUE(ServiceTestHelper::MethodsAreSorted(TestService::kMethods));
+  EXPECT_TRUE(
+      ServiceTestHelper::MethodsAreSorted(ManyMethodsTestService::kMethods));
+  EXPECT_TRUE(ServiceTestHelper::MethodsAreSorted(EmptyTestService::kMethods));
+
+  constexpr std::array<ServiceTestMethodUnion, 3> kUnsorted = {
+      ServiceTestMethod(123, 'a'),
+      ServiceTestMethod(789, 'b'),
+      ServiceTestMethod(456, 'c'),
+  };
+  EXPECT_FALSE(ServiceTestHelper::MethodsAreSorted(kUnsorted));
+
+  constexpr std::array<ServiceTestMethodUnion, 2> kDuplicate = {
+      ServiceTestMethod(123, 'a'),
+      ServiceTestMethod(123, 'b'),
+  };
+  EXPECT_FALSE(ServiceTestHelper::MethodsAreSorted(kDuplicate));
+}
+
 }  // namespace
 }  // namespace pw::rpc
@@ -0,0 +1,94 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_blob_store/blob_store.h"
+#include "pw_persistent_ram/persistent_buffer.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_transfer/handler.h"
+
+namespace pw::snapshot {
+
+// Serves a snapshot stored in a PersistentBuffer through pw_transfer.
+//
+// The snapshot is read in place, one chunk at a time, so no copy of it is
+// needed. The reader is seekable, which lets an interrupted transfer resume
+// from the last offset the receiver acknowledged rather than starting over.
+// Compression is handled by the transfer thread; see
+// pw::transfer::TransferThread::set_codec().
+//
+// If clear_after_read is true, the buffer is cleared once the snapshot has
+// been transferred successfully, making room for the next one.
+template <size_t kMaxSizeBytes,
+          typename Checksum = persistent_ram::Crc16Checksum>
+class PersistentBufferTransferHandler : public transfer::ReadOnlyHandler {
+ public:
+  PersistentBufferTransferHandler(
+      uint32_t transfer_id,
+      persistent_ram::PersistentBuffer<kMaxSizeBytes, Checksum>& buffer,
+      bool clear_after_read = false)
+      : transfer::ReadOnlyHandler(transfer_id),
+        buffer_(buffer),
+        reader_(ConstByteSpan()),
+        clear_after_read_(clear_after_read) {}
+
+  // Returns FAILED_PRECONDITION if the buffer does not hold a valid snapshot.
+  Status PrepareRead() final {
+    if (!buffer_.has_value()) {
+      return Status::FailedPrecondition();
+    }
+    reader_ =
+        stream::MemoryReader(ConstByteSpan(buffer_.data(), buffer_.size()));
+    set_reader(reader_);
+    return OkStatus();
+  }
+
+  void FinalizeRead(Status status) final {
+    if (status.ok() && clear_after_read_) {
+      buffer_.clear();
+    }
+  }
+
+ private:
+  persistent_ram::PersistentBuffer<kMaxSizeBytes, Checksum>& buffer_;
+  stream::MemoryReader reader_;
+  const bool clear_after_read_;
+};
+
+// Serves a snapshot stored in a BlobStore through pw_transfer.
+//
+// The blob is opened for the duration of the transfer and read from flash
+// directly. Like PersistentBufferTransferHandler, transfers can resume from an
+// offset since BlobStore::BlobReader is seekable.
+class BlobStoreTransferHandler : public transfer::ReadOnlyHandler {
+ public:
+  BlobStoreTransferHandler(uint32_t transfer_id, blob_store::BlobStore& store)
+      : transfer::ReadOnlyHandler(transfer_id), reader_(store) {}
+
+  // Returns FAILED_PRECONDITION if the blob store does not hold a valid
+  // snapshot, or UNAVAILABLE if the blob is being written.
+  Status PrepareRead() final;
+
+  void FinalizeRead(Status status) final;
+
+ private:
+  blob_store::BlobStore::BlobReader reader_;
+};
+
+}  // namespace pw::snapshot
@@ -0,0 +1,38 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/transfer_handler.h"
+
+namespace pw::snapshot {
+
+Status BlobStoreTransferHandler::PrepareRead() {
+  // A transfer that is restarted from the beginning re-opens the blob.
+  if (reader_.IsOpen()) {
+    reader_.Close().IgnoreError();
+  }
+
+  if (Status status = reader_.Open(); !status.ok()) {
+    return status;
+  }
+  set_reader(reader_);
+  return OkStatus();
+}
+
+void BlobStoreTransferHandler::FinalizeRead(Status) {
+  if (reader_.IsOpen()) {
+    reader_.Close().IgnoreError();
+  }
+}
+
+}  // namespace pw::snapshot
@@ -0,0 +1,148 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/transfer_handler.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_persistent_ram/persistent_buffer.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kTransferId = 7;
+constexpr std::array<std::byte, 4> kSnapshot = {
+    std::byte{0x0a}, std::byte{0x02}, std::byte{0x08}, std::byte{0x01}};
+
+class PersistentBufferTransferHandlerTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBufferSize = 64;
+  using Buffer = persistent_ram::PersistentBuffer<kBufferSize>;
+
+  PersistentBufferTransferHandlerTest() : buffer_(*(new (storage_) Buffer())) {
+    std::memset(storage_, 0, sizeof(storage_));
+  }
+
+  void WriteSnapshot() {
+    auto writer = buffer_.GetWriter();
+    ASSERT_EQ(OkStatus(), writer.Write(kSnapshot));
+  }
+
+  alignas(Buffer) std::byte storage_[sizeof(Buffer)];
+  Buffer& buffer_;
+};
+
+TEST_F(PersistentBufferTransferHandlerTest, PrepareRead_EmptyBuffer) {
+  PersistentBufferTransferHandler handler(kTransferId, buffer_);
+  EXPECT_EQ(handler.id(), kTransferId);
+  EXPECT_EQ(Status::FailedPrecondition(), handler.PrepareRead());
+}
+
+TEST_F(PersistentBufferTransferHandlerTest, PrepareRead_ValidSnapshot) {
+  WriteSnapshot();
+  PersistentBufferTransferHandler handler(kTransferId, buffer_);
+  EXPECT_EQ(OkStatus(), handler.PrepareRead());
+  EXPECT_EQ(Status::PermissionDenied(), handler.PrepareWrite());
+}
+
+TEST_F(PersistentBufferTransferHandlerTest, FinalizeRead_KeepsByDefault) {
+  WriteSnapshot();
+  PersistentBufferTransferHandler handler(kTransferId, buffer_);
+  ASSERT_EQ(OkStatus(), handler.PrepareRead());
+  handler.FinalizeRead(OkStatus());
+  EXPECT_TRUE(buffer_.has_value());
+}
+
+TEST_F(PersistentBufferTransferHandlerTest, FinalizeRead_ClearsOnSuccess) {
+  WriteSnapshot();
+  PersistentBufferTransferHandler handler(kTransferId, buffer_, true);
+
+  ASSERT_EQ(OkStatus(), handler.PrepareRead());
+  handler.FinalizeRead(Status::DataLoss());
+  EXPECT_TRUE(buffer_.has_value());
+
+  ASSERT_EQ(OkStatus(), handler.PrepareRead());
+  handler.FinalizeRead(OkStatus());
+  EXPECT_FALSE(buffer_.has_value());
+  EXPECT_EQ(Status::FailedPrecondition(), handler.PrepareRead());
+}
+
+class BlobStoreTransferHandlerTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kSectorSize = 512;
+  static constexpr size_t kSectorCount = 2;
+  static constexpr size_t kBufferSize = 64;
+
+  BlobStoreTransferHandlerTest()
+      : flash_(16),
+        partition_(&flash_),
+        blob_("Snapshot", partition_, &checksum_, kvs::TestKvs(), kBufferSize) {
+  }
+
+  void SetUp() override { ASSERT_EQ(OkStatus(), blob_.Init()); }
+
+  void WriteSnapshot() {
+    blob_store::BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(kSnapshot));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  blob_store::BlobStoreBuffer<kBufferSize> blob_;
+  std::array<std::byte,
+             blob_store::BlobStore::BlobWriter::RequiredMetadataBufferSize(0)>
+      metadata_buffer_;
+};
+
+TEST_F(BlobStoreTransferHandlerTest, PrepareRead_EmptyBlob) {
+  BlobStoreTransferHandler handler(kTransferId, blob_);
+  EXPECT_EQ(Status::FailedPrecondition(), handler.PrepareRead());
+}
+
+TEST_F(BlobStoreTransferHandlerTest, PrepareRead_OpensUntilFinalized) {
+  WriteSnapshot();
+  BlobStoreTransferHandler handler(kTransferId, blob_);
+  ASSERT_EQ(OkStatus(), handler.PrepareRead());
+
+  // The blob cannot be rewritten while the transfer is reading it.
+  blob_store::BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+  EXPECT_EQ(Status::Unavailable(), writer.Open());
+
+  handler.FinalizeRead(OkStatus());
+  EXPECT_EQ(OkStatus(), writer.Open());
+  EXPECT_EQ(OkStatus(), writer.Close());
+}
+
+TEST_F(BlobStoreTransferHandlerTest, PrepareRead_Restart) {
+  WriteSnapshot();
+  BlobStoreTransferHandler handler(kTransferId, blob_);
+  ASSERT_EQ(OkStatus(), handler.PrepareRead());
+  EXPECT_EQ(OkStatus(), handler.PrepareRead());
+  handler.FinalizeRead(Status::Cancelled());
+}
+
+}  // namespace
+}  // namespace pw::snapshot
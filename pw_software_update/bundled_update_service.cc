@@ -21,6 +21,7 @@
 
 #include "pw_log/log.h"
 #include "pw_result/result.h"
+#include "pw_software_update/delta_reader.h"
 #include "pw_software_update/bundled_update_service.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/update_bundle.pwpb.h"
@@ -376,9 +377,7 @@ void BundledUpdateService::DoApply() {
       return;
     }
 
-    const size_t bundle_offset = file_reader.start();
-    if (const Status status = backend_.ApplyTargetFile(
-            file_name_view, file_reader, bundle_offset);
+    if (const Status status = ApplyTargetFile(file_name_view, file_reader);
         !status.ok()) {
       SET_ERROR(pw_software_update_BundledUpdateResult_Enum_APPLY_FAILED,
                 "Failed to apply target file: %d",
@@ -416,6 +415,26 @@ void BundledUpdateService::DoApply() {
   Finish(pw_software_update_BundledUpdateResult_Enum_SUCCESS);
 }
 
+Status BundledUpdateService::ApplyTargetFile(std::string_view file_name,
+                                             stream::IntervalReader& payload) {
+  const size_t bundle_offset = payload.start();
+  Result<uint64_t> delta_target_size = bundle_.GetDeltaTargetSize(file_name);
+  if (delta_target_size.status().IsNotFound()) {
+    return backend_.ApplyTargetFile(file_name, payload, bundle_offset);
+  }
+  PW_TRY(delta_target_size.status());
+
+  // The payload is a delta patch, which was verified against the installed
+  // target along with the rest of the bundle.
+  Result<stream::SeekableReader*> installed =
+      backend_.GetInstalledTargetReader(file_name);
+  PW_TRY(installed.status());
+  DeltaReader target_reader(payload,
+                            *installed.value(),
+                            static_cast<size_t>(delta_target_size.value()));
+  return backend_.ApplyTargetFile(file_name, target_reader, bundle_offset);
+}
+
 Status BundledUpdateService::Abort(const pw_protobuf_Empty&,
                                    BundledUpdateStatus& response) {
   std::lock_guard lock(mutex_);
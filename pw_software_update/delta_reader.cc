@@ -0,0 +1,135 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_reader.h"
+
+#include <algorithm>
+#include <array>
+
+#include "pw_status/try.h"
+#include "pw_varint/stream.h"
+
+namespace pw::software_update {
+namespace {
+
+// Base bytes are read through a small stack buffer to add them to the diff.
+constexpr size_t kBaseChunkSizeBytes = 32;
+
+}  // namespace
+
+StatusWithSize DeltaReader::DoRead(ByteSpan destination) {
+  PW_TRY_WITH_SIZE(status_);
+  if (output_remaining_ == 0u) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  destination = destination.first(
+      std::min<size_t>(destination.size(), output_remaining_));
+  size_t bytes_read = 0;
+
+  while (bytes_read < destination.size()) {
+    if (diff_remaining_ == 0u && extra_remaining_ == 0u) {
+      status_ = ReadControl();
+    } else if (diff_remaining_ != 0u) {
+      const size_t size =
+          std::min(destination.size() - bytes_read, diff_remaining_);
+      status_ = ReadDiff(destination.subspan(bytes_read, size));
+      diff_remaining_ -= size;
+      bytes_read += size;
+    } else {
+      const size_t size =
+          std::min(destination.size() - bytes_read, extra_remaining_);
+      status_ = ReadPatch(destination.subspan(bytes_read, size));
+      extra_remaining_ -= size;
+      bytes_read += size;
+    }
+
+    if (!status_.ok()) {
+      return StatusWithSize(status_, 0);
+    }
+
+    // The seek applies once the record's diff and extra bytes are output.
+    if (diff_remaining_ == 0u && extra_remaining_ == 0u) {
+      if (seek_ < 0 && static_cast<uint64_t>(-seek_) > base_offset_) {
+        status_ = Status::DataLoss();
+        return StatusWithSize(status_, 0);
+      }
+      base_offset_ += seek_;
+      seek_ = 0;
+    }
+  }
+
+  output_remaining_ -= bytes_read;
+  return StatusWithSize(bytes_read);
+}
+
+Status DeltaReader::ReadControl() {
+  uint64_t diff_length;
+  uint64_t extra_length;
+  if (!varint::Read(patch_, &diff_length).ok() ||
+      !varint::Read(patch_, &extra_length).ok() ||
+      !varint::Read(patch_, &seek_).ok()) {
+    return Status::DataLoss();
+  }
+
+  // A record must output something and may not output more than the target.
+  if (diff_length + extra_length == 0u ||
+      diff_length > output_remaining_ ||
+      extra_length > output_remaining_ - diff_length) {
+    return Status::DataLoss();
+  }
+
+  diff_remaining_ = diff_length;
+  extra_remaining_ = extra_length;
+  return OkStatus();
+}
+
+Status DeltaReader::ReadDiff(ByteSpan destination) {
+  PW_TRY(ReadPatch(destination));
+
+  if (!base_.Seek(base_offset_).ok()) {
+    return Status::DataLoss();
+  }
+
+  std::array<std::byte, kBaseChunkSizeBytes> base_chunk;
+  while (!destination.empty()) {
+    const size_t size = std::min(destination.size(), base_chunk.size());
+    Result<ByteSpan> base_bytes = base_.Read(std::span(base_chunk).first(size));
+    if (!base_bytes.ok() || base_bytes.value().size() != size) {
+      return Status::DataLoss();
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      destination[i] = static_cast<std::byte>(
+          std::to_integer<uint8_t>(destination[i]) +
+          std::to_integer<uint8_t>(base_chunk[i]));
+    }
+    base_offset_ += size;
+    destination = destination.subspan(size);
+  }
+  return OkStatus();
+}
+
+Status DeltaReader::ReadPatch(ByteSpan destination) {
+  while (!destination.empty()) {
+    Result<ByteSpan> result = patch_.Read(destination);
+    if (!result.ok()) {
+      return Status::DataLoss();
+    }
+    destination = destination.subspan(result.value().size());
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::software_update
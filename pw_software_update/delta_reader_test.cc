@@ -0,0 +1,179 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_reader.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::software_update {
+namespace {
+
+// Builds a delta patch one record at a time.
+class PatchBuilder {
+ public:
+  PatchBuilder& Record(std::string_view diff,
+                       std::string_view extra,
+                       int64_t seek) {
+    Varint(static_cast<uint64_t>(diff.size()));
+    Varint(static_cast<uint64_t>(extra.size()));
+    Varint(seek);
+    Bytes(diff);
+    Bytes(extra);
+    return *this;
+  }
+
+  ConstByteSpan data() const { return std::span(buffer_).first(size_); }
+
+ private:
+  template <typename T>
+  void Varint(T value) {
+    size_ += varint::Encode(value, std::span(buffer_).subspan(size_));
+  }
+
+  void Bytes(std::string_view bytes) {
+    std::memcpy(buffer_.data() + size_, bytes.data(), bytes.size());
+    size_ += bytes.size();
+  }
+
+  std::array<std::byte, 128> buffer_;
+  size_t size_ = 0;
+};
+
+constexpr std::string_view kBase = "0123456789";
+
+class DeltaReaderTest : public ::testing::Test {
+ protected:
+  DeltaReaderTest() : base_(std::as_bytes(std::span(kBase))) {}
+
+  // Reads the whole output of a patch, `chunk_size` bytes at a time.
+  Status Apply(const PatchBuilder& patch,
+               size_t output_size,
+               size_t chunk_size = sizeof(output_)) {
+    stream::MemoryReader patch_reader(patch.data());
+    DeltaReader reader(patch_reader, base_, output_size);
+
+    output_size_ = 0;
+    while (output_size_ < output_size) {
+      Result<ByteSpan> result = reader.Read(
+          std::span(output_).subspan(output_size_).first(chunk_size));
+      if (!result.ok()) {
+        return result.status();
+      }
+      output_size_ += result.value().size();
+    }
+    EXPECT_EQ(reader.output_remaining(), 0u);
+    EXPECT_EQ(reader.Read(output_).status(), Status::OutOfRange());
+    return OkStatus();
+  }
+
+  std::string_view output() const {
+    return std::string_view(reinterpret_cast<const char*>(output_.data()),
+                            output_size_);
+  }
+
+  stream::MemoryReader base_;
+  std::array<std::byte, 64> output_;
+  size_t output_size_ = 0;
+};
+
+TEST_F(DeltaReaderTest, ExtraBytesOnly) {
+  PatchBuilder patch;
+  patch.Record("", "hello", 0).Record("", " world", 0);
+
+  ASSERT_EQ(OkStatus(), Apply(patch, 11));
+  EXPECT_EQ(output(), "hello world");
+}
+
+TEST_F(DeltaReaderTest, ZeroDiffCopiesBase) {
+  PatchBuilder patch;
+  patch.Record(std::string_view("\0\0\0\0\0\0\0\0\0\0", 10), "", 0);
+
+  ASSERT_EQ(OkStatus(), Apply(patch, 10));
+  EXPECT_EQ(output(), kBase);
+}
+
+TEST_F(DeltaReaderTest, DiffAddsToBase) {
+  PatchBuilder patch;
+  patch.Record("\x01\x01\xff", "", 0);
+
+  ASSERT_EQ(OkStatus(), Apply(patch, 3));
+  EXPECT_EQ(output(), "12" "1");
+}
+
+TEST_F(DeltaReaderTest, SeeksMoveThroughBase) {
+  PatchBuilder patch;
+  patch.Record(std::string_view("\0\0", 2), "ab", 5)    // 01, then skip to 7
+      .Record(std::string_view("\0\0\0", 3), "", -8)  // 789, then back to 2
+      .Record(std::string_view("\0", 1), "!", 0);     // 2
+
+  ASSERT_EQ(OkStatus(), Apply(patch, 9));
+  EXPECT_EQ(output(), "01ab7892!");
+}
+
+TEST_F(DeltaReaderTest, ReadInSmallChunks) {
+  PatchBuilder patch;
+  patch.Record(std::string_view("\0\0\0\0", 4), "xyz", 2)
+      .Record("\x01\x01\x01", "", 0);
+
+  ASSERT_EQ(OkStatus(), Apply(patch, 10, 1));
+  EXPECT_EQ(output(), "0123xyz789");
+  ASSERT_EQ(OkStatus(), Apply(patch, 10, 3));
+  EXPECT_EQ(output(), "0123xyz789");
+}
+
+TEST_F(DeltaReaderTest, TruncatedPatch) {
+  PatchBuilder patch;
+  patch.Record("", "abc", 0);
+
+  EXPECT_EQ(Status::DataLoss(), Apply(patch, 4));
+}
+
+TEST_F(DeltaReaderTest, RecordLargerThanOutput) {
+  PatchBuilder patch;
+  patch.Record("", "abcd", 0);
+
+  EXPECT_EQ(Status::DataLoss(), Apply(patch, 3));
+}
+
+TEST_F(DeltaReaderTest, DiffPastEndOfBase) {
+  PatchBuilder patch;
+  patch.Record("", "a", 8).Record(std::string_view("\0\0\0", 3), "", 0);
+
+  EXPECT_EQ(Status::DataLoss(), Apply(patch, 4));
+}
+
+TEST_F(DeltaReaderTest, SeekBeforeStartOfBase) {
+  PatchBuilder patch;
+  patch.Record(std::string_view("\0", 1), "", -2).Record("", "a", 0);
+
+  EXPECT_EQ(Status::DataLoss(), Apply(patch, 2));
+}
+
+TEST_F(DeltaReaderTest, EmptyOutput) {
+  PatchBuilder patch;
+  stream::MemoryReader patch_reader(patch.data());
+  DeltaReader reader(patch_reader, base_, 0);
+
+  EXPECT_EQ(reader.ConservativeReadLimit(), 0u);
+  EXPECT_EQ(reader.Read(output_).status(), Status::OutOfRange());
+}
+
+}  // namespace
+}  // namespace pw::software_update
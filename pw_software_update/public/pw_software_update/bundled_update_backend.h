@@ -90,6 +90,17 @@ class BundledUpdateBackend {
                                  stream::Reader& target_payload,
                                  size_t update_bundle_offset) = 0;
 
+  // Get a reader for the version of a target file that is currently installed
+  // on the device. This is needed for targets whose payload in the bundle is
+  // a delta patch, which is applied against the installed target both when
+  // the bundle is verified and when the reconstructed target is passed to
+  // ApplyTargetFile(). The installed target MUST NOT change in between, so
+  // delta targets must be applied to a staging area rather than in place.
+  virtual Result<stream::SeekableReader*> GetInstalledTargetReader(
+      [[maybe_unused]] std::string_view target_file_name) {
+    return Status::Unimplemented();
+  }
+
   // Backend to probe the device manifest and prepare a ready-to-go reader
   // for it. See the comments to `GetCurrentManfestReader()` for more context.
   virtual Status BeforeManifestRead() {
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <string_view>
+
 #include "pw_software_update/bundled_update.rpc.pb.h"
 #include "pw_software_update/bundled_update_backend.h"
 #include "pw_software_update/update_bundle_accessor.h"
@@ -102,6 +104,11 @@ class BundledUpdateService
 
   void DoVerify() PW_LOCKS_EXCLUDED(status_mutex_);
   void DoApply() PW_LOCKS_EXCLUDED(status_mutex_);
+  // Passes a target's payload to the backend, reconstructing the target first
+  // if the payload is a delta patch.
+  Status ApplyTargetFile(std::string_view file_name,
+                         stream::IntervalReader& payload)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void Finish(_pw_software_update_BundledUpdateResult_Enum result)
       PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_) PW_LOCKS_EXCLUDED(status_mutex_);
   bool IsFinished() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_)
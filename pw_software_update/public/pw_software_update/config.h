@@ -26,6 +26,14 @@
 // The maximum allowed length of a target name.
 #define MAX_TARGET_NAME_LENGTH 32
 
+// The number of manifest targets to index by name while verifying a bundle's
+// payloads. Each indexed target takes up to 25 bytes of stack. Targets past
+// this limit are still verified, but each one takes a scan over the manifest or
+// the bundle's payloads.
+#ifndef PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS
+#define PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS 16
+#endif  // PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS
+
 // The maximum allowed payload size in bytes. This is used to mitigate DoS
 // attacks.
 #ifndef PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE
@@ -0,0 +1,88 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// DeltaReader reconstructs a target from a delta patch and the version of the
+// target that is currently installed (the base), producing the output as it is
+// read. Only a few bytes of stack are used, so the output can be hashed or
+// written to a staging slot straight from the patch in the bundle.
+//
+// The patch uses the bsdiff control scheme without its compression. It is a
+// sequence of records, each of which is
+//
+//   diff_length   varint
+//   extra_length  varint
+//   seek          ZigZag varint
+//   diff          diff_length bytes
+//   extra         extra_length bytes
+//
+// A record outputs diff_length bytes, each the sum (mod 256) of a diff byte
+// and the base byte at the current base offset, which advances past them.
+// It then outputs the extra bytes as they are, and moves the base offset by
+// seek. The base offset starts at 0.
+//
+// The base must not be modified while the reader is in use, so the output
+// cannot be written over the base.
+class DeltaReader final : public stream::NonSeekableReader {
+ public:
+  // patch - The delta patch, e.g. a target payload in the update bundle.
+  // base - The installed target that the patch was created against.
+  // output_size - The size of the reconstructed target.
+  constexpr DeltaReader(stream::Reader& patch,
+                        stream::SeekableReader& base,
+                        size_t output_size)
+      : patch_(patch), base_(base), output_remaining_(output_size) {}
+
+  // Number of bytes of the output that have not been read yet.
+  size_t output_remaining() const { return output_remaining_; }
+
+ private:
+  // Reads the reconstructed target. Returns DATA_LOSS if the patch is
+  // malformed, ends early, or refers to bytes beyond the end of the base.
+  // Errors are sticky.
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kRead ? output_remaining_ : 0;
+  }
+
+  Status ReadControl();
+  Status ReadDiff(ByteSpan destination);
+  Status ReadPatch(ByteSpan destination);
+
+  stream::Reader& patch_;
+  stream::SeekableReader& base_;
+  size_t output_remaining_;
+
+  // The state of the current record.
+  size_t diff_remaining_ = 0;
+  size_t extra_remaining_ = 0;
+  int64_t seek_ = 0;
+  uint64_t base_offset_ = 0;
+
+  Status status_;
+};
+
+}  // namespace pw::software_update
@@ -80,6 +80,10 @@ class UpdateBundleAccessor {
   //    stripped of any target payloads that the device already have. For those
   //    personalized-out targets, verification relies on the cached manifest of
   //    a previous successful update to verify target length and hash.
+  // 6. Supports delta payloads, which are patches against the target
+  //    installed on the device (see delta_reader.h). The target is
+  //    reconstructed from the patch and the installed target, obtained from
+  //    the backend, and its length and hash are verified.
   //
   // Returns:
   // OK - Bundle was successfully opened and verified.
@@ -109,6 +113,14 @@ class UpdateBundleAccessor {
   stream::IntervalReader GetTargetPayload(std::string_view target_name);
   stream::IntervalReader GetTargetPayload(protobuf::String target_name);
 
+  // Returns the size of a target whose payload is a delta patch, once the
+  // bundle has passed verification. Such a target is applied by reading it
+  // through a DeltaReader over the payload and the installed target.
+  //
+  // Returns:
+  // NOT_FOUND - The target's payload is not a delta patch.
+  Result<uint64_t> GetDeltaTargetSize(std::string_view target_name);
+
   // Exposes "manifest" information from the incoming update bundle once it has
   // passed verification.
   ManifestAccessor GetManifest();
@@ -187,23 +199,27 @@ class UpdateBundleAccessor {
 
   // Verify all targets referenced in the manifest (Targets metadata) has a
   // payload blob either within the bundle or on-device, in both cases
-  // measuring up to the length and hash recorded in the manifest.
+  // measuring up to the length and hash recorded in the manifest. Payloads in
+  // the bundle are read once, in the order they are stored, and matched to
+  // their targets through an index of the manifest's target names.
   Status VerifyTargetsPayloads();
 
-  // Verify a target specified by name measures up to the expected length and
-  // SHA256 hash. Additionally call the backend to perform any product-specific
-  // validations.
-  Status VerifyTargetPayload(ManifestAccessor manifest,
-                             std::string_view name,
-                             protobuf::Uint64 expected_length,
-                             protobuf::Bytes expected_sha256);
-
   // For a target the payload of which is included in the bundle, verify
   // it measures up to the expected length and sha256 hash.
   Status VerifyInBundleTargetPayload(protobuf::Uint64 expected_length,
                                      protobuf::Bytes expected_sha256,
                                      stream::IntervalReader payload_reader);
 
+  // For a target the payload of which is a delta patch in the bundle, verify
+  // the patch has the expected length, and the target reconstructed from it
+  // and the installed target measures up to the expected length and sha256
+  // hash.
+  Status VerifyInBundleDeltaTargetPayload(std::string_view name,
+                                          protobuf::Uint64 expected_length,
+                                          protobuf::Bytes expected_sha256,
+                                          uint64_t patch_length,
+                                          stream::IntervalReader patch_reader);
+
   // For a target with no corresponding payload in the bundle, verify
   // its on-device payload bytes measures up to the expected length and sha256
   // hash.
@@ -365,6 +365,41 @@ def main() -> int:
         personalized_out_bundle.target_payloads.pop(file_name)
         personalized_out_bundles.append(personalized_out_bundle)
 
+    # Generates bundles that test how payloads are matched to targets. Payloads
+    # are not signed, so they are changed after the bundle is signed. A map
+    # cannot hold duplicate keys, so duplicate payloads are appended to the
+    # serialized bundle as separate map entries.
+    # 1. Duplicate the payload for file 0 with the same content.
+    # 2. Duplicate the payload for file 0 with different content, which must
+    #    fail verification even though the other copy is valid.
+    # 3. Add a payload that is not listed in the manifest, which is ignored.
+    # 4. Add a payload with a name longer than any target name, which is also
+    #    ignored.
+    first_file_name, first_file_payload = next(iter(TARGET_FILES.items()))
+    prod_bundle_with_prod_root = test_bundle.generate_prod_signed_bundle(
+        None, prod_signed_root)
+    duplicate_payload_bundle = (
+        prod_bundle_with_prod_root.SerializeToString() + UpdateBundle(
+            target_payloads={
+                first_file_name: first_file_payload
+            }).SerializeToString())
+    mismatched_duplicate_payload_bundle = (
+        prod_bundle_with_prod_root.SerializeToString() + UpdateBundle(
+            target_payloads={
+                first_file_name: b'x' * len(first_file_payload)
+            }).SerializeToString())
+    unlisted_payload_bundle = test_bundle.generate_prod_signed_bundle(
+        None, prod_signed_root)
+    unlisted_payload_bundle.target_payloads['unlisted'] = b'unlisted content'
+    long_payload_name_bundle = test_bundle.generate_prod_signed_bundle(
+        None, prod_signed_root)
+    long_payload_name_bundle.target_payloads['x' * 64] = b'long name content'
+
+    # Generates a device manifest without file 0, so that the target cannot be
+    # personalized out.
+    manifest_without_file0 = test_bundle.generate_manifest()
+    del manifest_without_file0.targets_metadata['targets'].target_files[0]
+
     with open(args.output_header, 'w') as header:
         header.write(HEADER)
         header.write(
@@ -426,6 +461,23 @@ def main() -> int:
                 proto_array_declaration(
                     personalized_out_bundle,
                     f'kTestBundlePersonalizedOutFile{idx}'))
+        header.write(
+            byte_array_declaration(duplicate_payload_bundle,
+                                   'kTestBundleDuplicatePayloadFile0'))
+        header.write(
+            byte_array_declaration(
+                mismatched_duplicate_payload_bundle,
+                'kTestBundleMismatchedDuplicatePayloadFile0'))
+        header.write(
+            proto_array_declaration(unlisted_payload_bundle,
+                                    'kTestBundleUnlistedPayload'))
+        header.write(
+            proto_array_declaration(long_payload_name_bundle,
+                                    'kTestBundleLongPayloadName'))
+        header.write(
+            proto_array_declaration(manifest_without_file0,
+                                    'kTestBundleManifestWithoutFile0'))
+
     subprocess.run([
         'clang-format',
         '-i',
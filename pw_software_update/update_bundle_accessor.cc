@@ -14,7 +14,10 @@
 
 #include "pw_software_update/update_bundle_accessor.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <string_view>
 
@@ -24,6 +27,7 @@
 #include "pw_protobuf/message.h"
 #include "pw_result/result.h"
 #include "pw_software_update/config.h"
+#include "pw_software_update/delta_reader.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/update_bundle.pwpb.h"
 #include "pw_stream/interval_reader.h"
@@ -246,6 +250,162 @@ Result<std::string_view> ReadProtoString(protobuf::String str,
   return std::string_view(buffer.data(), res.value().size());
 }
 
+// Reads the name of a `TargetFile` from the manifest.
+Result<std::string_view> ReadTargetName(protobuf::Message target_file,
+                                        std::span<char> buffer) {
+  protobuf::String name = target_file.AsString(
+      static_cast<uint32_t>(TargetFile::Fields::FILE_NAME));
+  PW_TRY(name.status());
+  return ReadProtoString(name, buffer);
+}
+
+// Hashes target names for TargetIndex with 32-bit FNV-1a.
+constexpr uint32_t HashTargetName(std::string_view name) {
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+// An index of the targets in a manifest, sorted by name hash. Only the first
+// PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS targets are indexed; complete() is
+// false if the manifest has more.
+class TargetIndex {
+ public:
+  // Indexes the targets in a single pass over the manifest.
+  Status Build(protobuf::RepeatedMessages target_files) {
+    for (protobuf::Message target_file : target_files) {
+      PW_TRY(target_file.status());
+      if (size_ == entries_.size()) {
+        complete_ = false;
+        break;
+      }
+
+      char name_buf[MAX_TARGET_NAME_LENGTH] = {0};
+      Result<std::string_view> name = ReadTargetName(target_file, name_buf);
+      PW_TRY(name.status());
+
+      stream::IntervalReader reader = target_file.ToBytes().GetBytesReader();
+      PW_TRY(reader.status());
+      source_ = &reader.source_reader();
+      entries_[size_] = {.name_hash = HashTargetName(name.value()),
+                         .position = static_cast<uint16_t>(size_),
+                         .start = reader.start(),
+                         .end = reader.end()};
+      size_ += 1;
+    }
+
+    // Targets with the same name stay in manifest order, so that the first is
+    // found, as with ManifestAccessor::GetTargetFile().
+    std::stable_sort(entries_.begin(),
+                     entries_.begin() + size_,
+                     [](const Entry& lhs, const Entry& rhs) {
+                       return lhs.name_hash < rhs.name_hash;
+                     });
+    return OkStatus();
+  }
+
+  // Returns the first indexed target with the given name, or NOT_FOUND, and
+  // records that every target with that name has a payload in the bundle.
+  protobuf::Message FindAndMarkPayload(std::string_view name) {
+    const uint32_t hash = HashTargetName(name);
+    const auto end = entries_.begin() + size_;
+    auto entry = std::lower_bound(
+        entries_.begin(), end, hash, [](const Entry& lhs, uint32_t rhs) {
+          return lhs.name_hash < rhs;
+        });
+
+    protobuf::Message found = Status::NotFound();
+    for (; entry != end && entry->name_hash == hash; ++entry) {
+      protobuf::Message target_file(
+          stream::IntervalReader(*source_, entry->start, entry->end));
+      char name_buf[MAX_TARGET_NAME_LENGTH] = {0};
+      Result<std::string_view> target_name =
+          ReadTargetName(target_file, name_buf);
+      PW_TRY(target_name.status());
+
+      if (target_name.value() == name) {
+        has_payload_[entry->position] = true;
+        if (!found.ok()) {
+          found = target_file;
+        }
+      }
+    }
+    return found;
+  }
+
+  // True if every target in the manifest is indexed.
+  bool complete() const { return complete_; }
+
+  // The number of indexed targets. These are the first targets in the
+  // manifest.
+  size_t size() const { return size_; }
+
+  // Whether a payload was found for the indexed target at the given position
+  // in the manifest.
+  bool has_payload(size_t position) const { return has_payload_[position]; }
+
+ private:
+  struct Entry {
+    uint32_t name_hash;
+    uint16_t position;  // Position of the target in the manifest.
+    size_t start;       // Interval of the TargetFile message in the bundle.
+    size_t end;
+  };
+
+  std::array<Entry, PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS> entries_ = {};
+  std::array<bool, PW_SOFTWARE_UPDATE_MAX_INDEXED_TARGETS> has_payload_ = {};
+  size_t size_ = 0;
+  bool complete_ = true;
+  stream::SeekableReader* source_ = nullptr;
+};
+
+// Gets the length and SHA256 hash of a `TargetFile` from the manifest.
+Status GetTargetLengthAndSha256(protobuf::Message target_file,
+                                protobuf::Uint64& length,
+                                protobuf::Bytes& sha256) {
+  length =
+      target_file.AsUint64(static_cast<uint32_t>(TargetFile::Fields::LENGTH));
+  PW_TRY(length.status());
+  if (length.value() > PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE) {
+    PW_LOG_ERROR("Target payload too large. Maximum supported is %llu bytes.",
+                 PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE);
+    return Status::OutOfRange();
+  }
+
+  sha256 = Status::NotFound();
+  protobuf::RepeatedMessages hashes = target_file.AsRepeatedMessages(
+      static_cast<uint32_t>(TargetFile::Fields::HASHES));
+  for (protobuf::Message hash : hashes) {
+    protobuf::Uint32 hash_function =
+        hash.AsUint32(static_cast<uint32_t>(Hash::Fields::FUNCTION));
+    PW_TRY(hash_function.status());
+
+    if (hash_function.value() == static_cast<uint32_t>(HashFunction::SHA256)) {
+      sha256 = hash.AsBytes(static_cast<uint32_t>(Hash::Fields::HASH));
+      break;
+    }
+  }
+  return sha256.status();
+}
+
+// Gets the length of the delta patch of a `TargetFile` from the manifest.
+// Returns NOT_FOUND if the target's payload is not a delta patch.
+Result<uint64_t> GetDeltaPatchLength(protobuf::Message target_file) {
+  protobuf::Message delta_patch = target_file.AsMessage(
+      static_cast<uint32_t>(TargetFile::Fields::DELTA_PATCH));
+  PW_TRY(delta_patch.status());
+
+  protobuf::Uint64 patch_length = delta_patch.AsUint64(
+      static_cast<uint32_t>(DeltaPatch::Fields::PATCH_LENGTH));
+  if (patch_length.status().IsNotFound()) {
+    return 0u;  // Default values are not encoded.
+  }
+  PW_TRY(patch_length.status());
+  return patch_length.value();
+}
+
 }  // namespace
 
 Status UpdateBundleAccessor::OpenAndVerify() {
@@ -268,7 +428,7 @@ Result<uint64_t> UpdateBundleAccessor::GetTotalPayloadSize() {
       static_cast<uint32_t>(UpdateBundle::Fields::TARGET_PAYLOADS));
   PW_TRY(bundled_payloads.status());
 
-  uint64_t total_bytes;
+  uint64_t total_bytes = 0;
   std::array<std::byte, MAX_TARGET_NAME_LENGTH> name_buffer = {};
   for (protobuf::Message target : manifested_targets) {
     protobuf::String target_name =
@@ -290,6 +450,17 @@ Result<uint64_t> UpdateBundleAccessor::GetTotalPayloadSize() {
     if (!bundled_payloads[name_view].ok()) {
       continue;
     }
+
+    // Delta targets are applied from the patch in the bundle.
+    Result<uint64_t> patch_length = GetDeltaPatchLength(target);
+    if (patch_length.ok()) {
+      total_bytes += patch_length.value();
+      continue;
+    }
+    if (!patch_length.status().IsNotFound()) {
+      return patch_length.status();
+    }
+
     protobuf::Uint64 target_length =
         target.AsUint64(static_cast<uint32_t>(TargetFile::Fields::LENGTH));
     PW_TRY(target_length.status());
@@ -625,78 +796,88 @@ Status UpdateBundleAccessor::VerifyTargetsPayloads() {
   ManifestAccessor bundle_manifest = ManifestAccessor::FromBundle(bundle_);
   PW_TRY(bundle_manifest.status());
 
-  // Target file descriptors (pathname, length, hash, etc.) listed in the bundle
-  // manifest.
+  // Index the manifest's targets by name, so that each payload is matched to
+  // its target without rescanning the manifest.
   protobuf::RepeatedMessages target_files = bundle_manifest.GetTargetFiles();
   PW_TRY(target_files.status());
+  TargetIndex targets;
+  PW_TRY(targets.Build(target_files));
+
+  // Verify the payloads included in the bundle in the order they are stored,
+  // so that they are hashed in a single forward pass over the bundle rather
+  // than looked up one by one in manifest order.
+  protobuf::StringToBytesMap payloads_map = bundle_.AsStringToBytesMap(
+      static_cast<uint32_t>(UpdateBundle::Fields::TARGET_PAYLOADS));
+  for (protobuf::StringToBytesMapEntry payload : payloads_map) {
+    PW_TRY(payload.status());
 
-  // Verify length and SHA256 hash for each file listed in the manifest.
-  for (protobuf::Message target_file : target_files) {
-    // Extract target file name in the form of a `std::string_view`.
-    protobuf::String name_proto = target_file.AsString(
-        static_cast<uint32_t>(TargetFile::Fields::FILE_NAME));
-    PW_TRY(name_proto.status());
     char name_buf[MAX_TARGET_NAME_LENGTH] = {0};
-    Result<std::string_view> target_name =
-        ReadProtoString(name_proto, name_buf);
-    PW_TRY(target_name.status());
+    Result<std::string_view> payload_name =
+        ReadProtoString(payload.Key(), name_buf);
+    if (payload_name.status().IsResourceExhausted()) {
+      continue;  // Too long to be the name of any target in the manifest.
+    }
+    PW_TRY(payload_name.status());
 
-    // Get target length.
-    protobuf::Uint64 target_length =
-        target_file.AsUint64(static_cast<uint32_t>(TargetFile::Fields::LENGTH));
-    PW_TRY(target_length.status());
-    if (target_length.value() > PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE) {
-      PW_LOG_ERROR("Target payload too large. Maximum supported is %llu bytes.",
-                   PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE);
-      return Status::OutOfRange();
+    protobuf::Message target_file =
+        targets.FindAndMarkPayload(payload_name.value());
+    if (target_file.status().IsNotFound() && !targets.complete()) {
+      target_file = bundle_manifest.GetTargetFile(payload_name.value());
     }
+    if (target_file.status().IsNotFound()) {
+      continue;  // Payloads not listed in the manifest are never applied.
+    }
+    PW_TRY(target_file.status());
 
-    // Get target SHA256 hash.
+    protobuf::Uint64 target_length = Status::NotFound();
     protobuf::Bytes target_sha256 = Status::NotFound();
-    protobuf::RepeatedMessages hashes = target_file.AsRepeatedMessages(
-        static_cast<uint32_t>(TargetFile::Fields::HASHES));
-    for (protobuf::Message hash : hashes) {
-      protobuf::Uint32 hash_function =
-          hash.AsUint32(static_cast<uint32_t>(Hash::Fields::FUNCTION));
-      PW_TRY(hash_function.status());
-
-      if (hash_function.value() ==
-          static_cast<uint32_t>(HashFunction::SHA256)) {
-        target_sha256 = hash.AsBytes(static_cast<uint32_t>(Hash::Fields::HASH));
-        break;
-      }
+    PW_TRY(GetTargetLengthAndSha256(target_file, target_length, target_sha256));
+
+    // Every payload with a listed name is verified, including any duplicates,
+    // so that it does not matter which one is later used.
+    Result<uint64_t> patch_length = GetDeltaPatchLength(target_file);
+    if (patch_length.ok()) {
+      PW_TRY(VerifyInBundleDeltaTargetPayload(payload_name.value(),
+                                              target_length,
+                                              target_sha256,
+                                              patch_length.value(),
+                                              payload.Value().GetBytesReader()));
+    } else if (patch_length.status().IsNotFound()) {
+      PW_TRY(VerifyInBundleTargetPayload(
+          target_length, target_sha256, payload.Value().GetBytesReader()));
+    } else {
+      return patch_length.status();
     }
-    PW_TRY(target_sha256.status());
-
-    PW_TRY(VerifyTargetPayload(
-        bundle_manifest, target_name.value(), target_length, target_sha256));
-  }  // for each target file in manifest.
+  }
 
-  return OkStatus();
-}
+  // Verify the targets listed in the manifest that have no payload in the
+  // bundle. Targets that did not fit in the index are looked up by name.
+  size_t position = 0;
+  for (protobuf::Message target_file : target_files) {
+    char name_buf[MAX_TARGET_NAME_LENGTH] = {0};
+    Result<std::string_view> target_name =
+        ReadTargetName(target_file, name_buf);
+    PW_TRY(target_name.status());
 
-Status UpdateBundleAccessor::VerifyTargetPayload(
-    ManifestAccessor manifest,
-    std::string_view target_name,
-    protobuf::Uint64 expected_length,
-    protobuf::Bytes expected_sha256) {
-  protobuf::StringToBytesMap payloads_map = bundle_.AsStringToBytesMap(
-      static_cast<uint32_t>(UpdateBundle::Fields::TARGET_PAYLOADS));
-  stream::IntervalReader payload_reader =
-      payloads_map[target_name].GetBytesReader();
+    const bool has_payload =
+        position < targets.size()
+            ? targets.has_payload(position)
+            : payloads_map[target_name.value()].GetBytesReader().ok();
+    position += 1;
+    if (has_payload) {
+      continue;  // Verified above.
+    }
 
-  Status status;
-  if (payload_reader.ok()) {
-    status = VerifyInBundleTargetPayload(
-        expected_length, expected_sha256, payload_reader);
-  } else {
-    status = VerifyOutOfBundleTargetPayload(
-        target_name, expected_length, expected_sha256);
-  }
+    protobuf::Uint64 target_length = Status::NotFound();
+    protobuf::Bytes target_sha256 = Status::NotFound();
+    PW_TRY(GetTargetLengthAndSha256(target_file, target_length, target_sha256));
+    PW_TRY(VerifyOutOfBundleTargetPayload(
+        target_name.value(), target_length, target_sha256));
+  }  // for each target file in manifest.
 
   // TODO(alizhang): Notify backend to do additional checks by calling
   // backend_.VerifyTargetFile(...).
-  return status;
+  return OkStatus();
 }
 
 // TODO(alizhang): Add unit tests for all failure conditions.
@@ -790,6 +971,61 @@ Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
   return OkStatus();
 }
 
+Status UpdateBundleAccessor::VerifyInBundleDeltaTargetPayload(
+    std::string_view name,
+    protobuf::Uint64 expected_length,
+    protobuf::Bytes expected_sha256,
+    uint64_t patch_length,
+    stream::IntervalReader patch_reader) {
+  if (patch_reader.interval_size() != patch_length) {
+    PW_LOG_ERROR("Wrong delta patch length. Expected: %llu, actual: %llu",
+                 patch_length,
+                 static_cast<uint64_t>(patch_reader.interval_size()));
+    return Status::Unauthenticated();
+  }
+
+  Result<stream::SeekableReader*> installed =
+      backend_.GetInstalledTargetReader(name);
+  if (!installed.ok()) {
+    PW_LOG_ERROR(
+        "Can't verify delta target because the installed target is not "
+        "available.");
+    return Status::Unauthenticated();
+  }
+
+  // The reconstructed target has exactly the expected length, or fails to
+  // read.
+  DeltaReader target_reader(patch_reader,
+                            *installed.value(),
+                            static_cast<size_t>(expected_length.value()));
+  std::byte actual_sha256[crypto::sha256::kDigestSizeBytes] = {};
+  if (!crypto::sha256::Hash(target_reader, actual_sha256).ok()) {
+    PW_LOG_ERROR("Failed to reconstruct delta target.");
+    return Status::Unauthenticated();
+  }
+
+  Result<bool> hash_equal = expected_sha256.Equal(actual_sha256);
+  PW_TRY(hash_equal.status());
+  if (!hash_equal.value()) {
+    PW_LOG_ERROR("Wrong delta target sha256 hash.");
+    return Status::Unauthenticated();
+  }
+
+  return OkStatus();
+}
+
+Result<uint64_t> UpdateBundleAccessor::GetDeltaTargetSize(
+    std::string_view target_name) {
+  protobuf::Message target_file = GetManifest().GetTargetFile(target_name);
+  PW_TRY(target_file.status());
+  PW_TRY(GetDeltaPatchLength(target_file).status());
+
+  protobuf::Uint64 length =
+      target_file.AsUint64(static_cast<uint32_t>(TargetFile::Fields::LENGTH));
+  PW_TRY(length.status());
+  return length.value();
+}
+
 ManifestAccessor UpdateBundleAccessor::GetManifest() {
   if (!bundle_verified_) {
     PW_LOG_DEBUG("Bundled has not passed verification yet");
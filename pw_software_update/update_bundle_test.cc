@@ -507,6 +507,67 @@ TEST_F(UpdateBundleTest, OpenAndVerifySucceedsWithPersonalizedOutFile1) {
   ASSERT_OK(update_bundle.OpenAndVerify());
 }
 
+TEST_F(UpdateBundleTest, PersonalizationVerificationFailsWithoutDeviceTarget) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  // `kTestBundleManifestWithoutFile0` is auto generated by
+  // pw_software_update/py/pw_software_update/generate_test_bundle.py.
+  // File 0 is removed from the device manifest, so its payload cannot be
+  // personalized out of the bundle.
+  backend().SetCurrentManifest(kTestBundleManifestWithoutFile0);
+  StageTestBundle(kTestBundlePersonalizedOutFile0);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+
+  ASSERT_FAIL(update_bundle.OpenAndVerify());
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifySucceedsWithDuplicatePayload) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  // `kTestBundleDuplicatePayloadFile0` is auto generated by
+  // pw_software_update/py/pw_software_update/generate_test_bundle.py.
+  // The payload for file 0 appears twice, with the same content.
+  StageTestBundle(kTestBundleDuplicatePayloadFile0);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+
+  ASSERT_OK(update_bundle.OpenAndVerify());
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifyFailsOnMismatchedDuplicatePayload) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  // `kTestBundleMismatchedDuplicatePayloadFile0` is auto generated by
+  // pw_software_update/py/pw_software_update/generate_test_bundle.py.
+  // The payload for file 0 appears twice. Only the first copy matches the
+  // targets metadata.
+  StageTestBundle(kTestBundleMismatchedDuplicatePayloadFile0);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+  CheckOpenAndVerifyFail(update_bundle, true);
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifyIgnoresUnlistedPayload) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  // `kTestBundleUnlistedPayload` is auto generated by
+  // pw_software_update/py/pw_software_update/generate_test_bundle.py.
+  // The bundle has a payload that is not in the targets metadata.
+  StageTestBundle(kTestBundleUnlistedPayload);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+
+  ASSERT_OK(update_bundle.OpenAndVerify());
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifyIgnoresPayloadWithLongName) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  // `kTestBundleLongPayloadName` is auto generated by
+  // pw_software_update/py/pw_software_update/generate_test_bundle.py.
+  // The bundle has a payload with a name longer than MAX_TARGET_NAME_LENGTH.
+  StageTestBundle(kTestBundleLongPayloadName);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+
+  ASSERT_OK(update_bundle.OpenAndVerify());
+}
+
 TEST_F(UpdateBundleTest,
        PersonalizationVerificationFailsWithoutDeviceManifest) {
   backend().SetTrustedRoot(kDevSignedRoot);
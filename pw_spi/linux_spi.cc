@@ -14,6 +14,9 @@
 
 #include "pw_spi/linux_spi.h"
 
+#include <array>
+#include <cstring>
+
 #include <fcntl.h>
 #include <linux/spi/spidev.h>
 #include <linux/types.h>
@@ -109,6 +112,54 @@ Status LinuxInitiator::WriteRead(ConstByteSpan write_buffer,
   return OkStatus();
 }
 
+Status LinuxInitiator::WriteReadSegments(std::span<const Segment> segments,
+                                         ChipSelector& /*selector*/) {
+  PW_TRY(LazyInit());
+
+  if (segments.size() > kMaxSegments) {
+    return Status::ResourceExhausted();
+  }
+
+  // Each segment writes then reads, as in WriteRead(), so it needs up to two
+  // transfers. Setting cs_change on a segment's final transfer deselects the
+  // chip before the next transfer.
+  std::array<spi_ioc_transfer, 2 * kMaxSegments> transactions;
+  memset(transactions.data(), 0, sizeof(transactions));
+  size_t count = 0;
+
+  for (const Segment& segment : segments) {
+    if (!segment.write_buffer.empty()) {
+      transactions[count].tx_buf =
+          reinterpret_cast<uintptr_t>(segment.write_buffer.data());
+      transactions[count].len = segment.write_buffer.size();
+      count += 1;
+    }
+    if (!segment.read_buffer.empty()) {
+      transactions[count].rx_buf =
+          reinterpret_cast<uintptr_t>(segment.read_buffer.data());
+      transactions[count].len = segment.read_buffer.size();
+      count += 1;
+    }
+    if (segment.deselect_after && count > 0) {
+      transactions[count - 1].cs_change = 1;
+    }
+  }
+
+  if (count == 0) {
+    return OkStatus();
+  }
+
+  // cs_change on the final transfer would leave the chip selected.
+  transactions[count - 1].cs_change = 0;
+
+  if (ioctl(fd_, SPI_IOC_MESSAGE(count), transactions.data()) < 0) {
+    PW_LOG_ERROR("Unable to perform SPI transfer");
+    return Status::Unknown();
+  }
+
+  return OkStatus();
+}
+
 Status LinuxChipSelector::SetActive(bool /*active*/) {
   // Note: For Linux' SPI userspace support, chip-select control is not exposed
   // directly to the user.  This limits our ability to use the SPI HAL to do
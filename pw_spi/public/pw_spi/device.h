@@ -15,6 +15,7 @@
 #pragma once
 
 #include <optional>
+#include <span>
 
 #include "pw_bytes/span.h"
 #include "pw_spi/chip_selector.h"
@@ -81,6 +82,23 @@ class Device {
         .WriteRead(write_buffer, read_buffer);
   }
 
+  // Perform a list of read/write transfers with the SPI peripheral as one
+  // composite operation, with chip select toggled between segments as each
+  // segment requests. The whole list is handed to the Initiator at once, so
+  // backends may submit it as a single operation, such as one multi-message
+  // ioctl() on Linux or chained DMA descriptors on a microcontroller.
+  // This call will configure the bus for the transfers.
+  //
+  // Note: This call will block in the event that other clients
+  // are currently performing transactions using the same SPI Initiator.
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  Status WriteReadSegments(std::span<const Segment> segments) {
+    sync::BorrowedPointer<Initiator> initiator = initiator_.acquire();
+    PW_TRY(initiator->Configure(config_));
+    return initiator->WriteReadSegments(segments, selector_);
+  }
+
   // RAII Object providing exclusive access to the SPI device.  Enables
   // thread-safe Read()/Write()/WriteRead() operations, as well as composite
   // operations consisting of multiple, uninterrupted transfers, with
@@ -15,11 +15,14 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <type_traits>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
+#include "pw_spi/chip_selector.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 
 namespace pw::spi {
 
@@ -71,6 +74,19 @@ struct Config {
 static_assert(sizeof(Config) == sizeof(uint32_t),
               "Ensure that the config struct fits in 32-bits");
 
+// One write/read transfer in a list of transfers performed together with
+// Initiator::WriteReadSegments(). The buffers behave as for
+// Initiator::WriteRead().
+struct Segment {
+  ConstByteSpan write_buffer;
+  ByteSpan read_buffer;
+
+  // Whether to deactivate chip select after this segment, so it is toggled
+  // before the next segment. Chip select is always deactivated after the last
+  // segment.
+  bool deselect_after = false;
+};
+
 // The Inititor class provides an abstract interface used to configure and
 // transmit data using a SPI bus.
 class Initiator {
@@ -96,6 +112,45 @@ class Initiator {
   // failure.
   virtual Status WriteRead(ConstByteSpan write_buffer,
                            ByteSpan read_buffer) = 0;
+
+  // Perform a list of read/write transfers as one composite operation, using
+  // `selector` to activate chip select before the first segment and to toggle
+  // it between segments as each segment requests. Processing stops at the
+  // first failed segment, and chip select is deactivated afterwards.
+  //
+  // The default implementation performs one WriteRead() per segment.
+  // Initiators that can queue several transfers at once, such as with a single
+  // ioctl() or chained DMA descriptors, should override this to submit the
+  // whole list together.
+  //
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  virtual Status WriteReadSegments(std::span<const Segment> segments,
+                                   ChipSelector& selector) {
+    Status status;
+    bool active = false;
+    for (const Segment& segment : segments) {
+      if (!active) {
+        PW_TRY(selector.Activate());
+        active = true;
+      }
+
+      status = WriteRead(segment.write_buffer, segment.read_buffer);
+      if (!status.ok()) {
+        break;
+      }
+
+      if (segment.deselect_after) {
+        PW_TRY(selector.Deactivate());
+        active = false;
+      }
+    }
+
+    if (active) {
+      status.Update(selector.Deactivate());
+    }
+    return status;
+  }
 };
 
 }  // namespace pw::spi
@@ -39,6 +39,15 @@ class LinuxInitiator : public Initiator {
   Status Configure(const Config& config) override;
   Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) override;
 
+  // Performs all of the segments with a single SPI_IOC_MESSAGE ioctl(). The
+  // kernel controls chip select, so the selector is not used. Returns
+  // RESOURCE_EXHAUSTED if there are more than kMaxSegments segments.
+  Status WriteReadSegments(std::span<const Segment> segments,
+                           ChipSelector& selector) override;
+
+  // The maximum number of segments in one WriteReadSegments() call.
+  static constexpr size_t kMaxSegments = 16;
+
  private:
   Status LazyInit();
 
@@ -71,5 +71,107 @@ TEST_F(SpiTestDevice, CompilationSucceeds) {
   EXPECT_TRUE(true);
 }
 
+// Records chip select changes and transfers as characters in a shared log:
+// 'A' for activate, 'D' for deactivate, and 'T' for a WriteRead() transfer.
+class EventLog {
+ public:
+  void Add(char event) {
+    if (size_ < events_.size() - 1) {
+      events_[size_++] = event;
+    }
+  }
+
+  const char* events() const { return events_.data(); }
+
+ private:
+  std::array<char, 32> events_ = {};
+  size_t size_ = 0;
+};
+
+class RecordingInitiator : public Initiator {
+ public:
+  explicit RecordingInitiator(EventLog& log) : log_(log) {}
+
+  void set_fail_transfer(size_t index) { fail_transfer_ = index; }
+
+  Status Configure(const Config& /* config */) override { return OkStatus(); }
+
+  Status WriteRead(ConstByteSpan /* write_buffer */,
+                   ByteSpan /* read_buffer */) override {
+    log_.Add('T');
+    if (transfers_++ == fail_transfer_) {
+      return Status::Unavailable();
+    }
+    return OkStatus();
+  }
+
+ private:
+  EventLog& log_;
+  size_t transfers_ = 0;
+  std::optional<size_t> fail_transfer_;
+};
+
+class RecordingChipSelector : public ChipSelector {
+ public:
+  explicit RecordingChipSelector(EventLog& log) : log_(log) {}
+
+  Status SetActive(bool active) override {
+    log_.Add(active ? 'A' : 'D');
+    return OkStatus();
+  }
+
+ private:
+  EventLog& log_;
+};
+
+class SpiSegmentsTest : public ::testing::Test {
+ protected:
+  SpiSegmentsTest()
+      : initiator_(log_),
+        chip_selector_(log_),
+        borrowable_initiator_(initiator_, initiator_lock_),
+        device_(borrowable_initiator_, kConfig, chip_selector_) {}
+
+  EventLog log_;
+  RecordingInitiator initiator_;
+  RecordingChipSelector chip_selector_;
+  sync::VirtualMutex initiator_lock_;
+  sync::Borrowable<Initiator> borrowable_initiator_;
+  Device device_;
+};
+
+TEST_F(SpiSegmentsTest, HoldsChipSelectAcrossSegments) {
+  std::array<std::byte, 2> command = {};
+  std::array<std::byte, 4> response = {};
+  const Segment segments[] = {{command, {}}, {{}, response}};
+
+  EXPECT_EQ(device_.WriteReadSegments(segments), OkStatus());
+  EXPECT_STREQ(log_.events(), "ATTD");
+}
+
+TEST_F(SpiSegmentsTest, DeselectsBetweenSegments) {
+  std::array<std::byte, 2> command = {};
+  std::array<std::byte, 4> response = {};
+  const Segment segments[] = {
+      {command, {}, true}, {command, {}}, {{}, response, true}};
+
+  EXPECT_EQ(device_.WriteReadSegments(segments), OkStatus());
+  EXPECT_STREQ(log_.events(), "ATDATTD");
+}
+
+TEST_F(SpiSegmentsTest, StopsAtFirstFailure) {
+  std::array<std::byte, 2> command = {};
+  const Segment segments[] = {{command, {}}, {command, {}}, {command, {}}};
+
+  initiator_.set_fail_transfer(1);
+  EXPECT_EQ(device_.WriteReadSegments(segments), Status::Unavailable());
+  EXPECT_STREQ(log_.events(), "ATTD");
+}
+
+TEST_F(SpiSegmentsTest, EmptyListDoesNotSelect) {
+  EXPECT_EQ(device_.WriteReadSegments({}), OkStatus());
+  EXPECT_STREQ(log_.events(), "");
+}
+
 }  // namespace
 }  // namespace pw::spi
@@ -0,0 +1,102 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+Status BufferedWriter::Flush() {
+  if (size_ == 0) {
+    return OkStatus();
+  }
+  PW_TRY(writer_.Write(buffer_.first(size_)));
+  size_ = 0;
+  return OkStatus();
+}
+
+Status BufferedWriter::DoWrite(ConstByteSpan data) {
+  if (data.size() > buffer_.size() - size_) {
+    PW_TRY(Flush());
+  }
+
+  // Large writes go straight to the underlying writer to avoid a copy.
+  if (data.size() >= buffer_.size()) {
+    return writer_.Write(data);
+  }
+
+  if (!data.empty()) {
+    std::memcpy(buffer_.data() + size_, data.data(), data.size());
+    size_ += data.size();
+  }
+
+  if (size_ >= flush_threshold_) {
+    // The data is already accepted; a failed flush leaves it buffered.
+    Flush().IgnoreError();
+  }
+  return OkStatus();
+}
+
+size_t BufferedWriter::ConservativeLimit(LimitType type) const {
+  if (type != LimitType::kWrite) {
+    return 0;
+  }
+  const size_t limit = writer_.ConservativeWriteLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return limit > size_ ? limit - size_ : 0;
+}
+
+StatusWithSize BufferedReader::DoRead(ByteSpan dest) {
+  if (position_ == end_) {
+    if (dest.size() >= buffer_.size()) {
+      Result<ByteSpan> result = reader_.Read(dest);
+      return result.ok() ? StatusWithSize(result.value().size())
+                         : StatusWithSize(result.status(), 0);
+    }
+
+    Result<ByteSpan> result = reader_.Read(buffer_);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    position_ = 0;
+    end_ = result.value().size();
+  }
+
+  const size_t bytes_to_read = std::min(dest.size(), end_ - position_);
+  if (bytes_to_read != 0) {
+    std::memcpy(dest.data(), buffer_.data() + position_, bytes_to_read);
+    position_ += bytes_to_read;
+  }
+  return StatusWithSize(bytes_to_read);
+}
+
+size_t BufferedReader::ConservativeLimit(LimitType type) const {
+  if (type != LimitType::kRead) {
+    return 0;
+  }
+  const size_t limit = reader_.ConservativeReadLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return limit + buffered_bytes();
+}
+
+}  // namespace pw::stream
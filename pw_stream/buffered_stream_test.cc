@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+// Counts calls so tests can check how often the underlying stream is hit.
+class CountingWriter : public NonSeekableWriter {
+ public:
+  CountingWriter(ByteSpan dest) : writer_(dest) {}
+
+  size_t writes() const { return writes_; }
+  size_t bytes_written() const { return writer_.bytes_written(); }
+  const std::byte* data() const { return writer_.data(); }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+TEST(BufferedWriter, CollectsSmallWrites) {
+  std::array<std::byte, 32> output = {};
+  CountingWriter sink(output);
+  BufferedWriterBuffer<8> writer(sink);
+
+  for (char c : std::string_view("abcde")) {
+    ASSERT_EQ(OkStatus(), writer.Write(std::byte(c)));
+  }
+  EXPECT_EQ(sink.writes(), 0u);
+  EXPECT_EQ(writer.buffered_bytes(), 5u);
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(sink.writes(), 1u);
+  EXPECT_EQ(writer.buffered_bytes(), 0u);
+  ASSERT_EQ(sink.bytes_written(), 5u);
+  EXPECT_EQ(std::memcmp(sink.data(), "abcde", 5), 0);
+}
+
+TEST(BufferedWriter, FlushesWhenFull) {
+  std::array<std::byte, 32> output = {};
+  CountingWriter sink(output);
+  BufferedWriterBuffer<4> writer(sink);
+
+  ASSERT_EQ(OkStatus(), writer.Write("abc", 3));
+  ASSERT_EQ(OkStatus(), writer.Write("def", 3));
+  EXPECT_EQ(sink.writes(), 1u);
+  EXPECT_EQ(sink.bytes_written(), 3u);
+  EXPECT_EQ(writer.buffered_bytes(), 3u);
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(std::memcmp(sink.data(), "abcdef", 6), 0);
+}
+
+TEST(BufferedWriter, FlushesAtThreshold) {
+  std::array<std::byte, 32> output = {};
+  CountingWriter sink(output);
+  BufferedWriterBuffer<8> writer(sink, 4);
+
+  ASSERT_EQ(OkStatus(), writer.Write("abc", 3));
+  EXPECT_EQ(sink.writes(), 0u);
+  ASSERT_EQ(OkStatus(), writer.Write("d", 1));
+  EXPECT_EQ(sink.writes(), 1u);
+  EXPECT_EQ(writer.buffered_bytes(), 0u);
+  EXPECT_EQ(sink.bytes_written(), 4u);
+}
+
+TEST(BufferedWriter, LargeWriteBypassesBuffer) {
+  std::array<std::byte, 32> output = {};
+  CountingWriter sink(output);
+  BufferedWriterBuffer<4> writer(sink);
+
+  ASSERT_EQ(OkStatus(), writer.Write("a", 1));
+  ASSERT_EQ(OkStatus(), writer.Write("bcdefgh", 7));
+  EXPECT_EQ(sink.writes(), 2u);
+  EXPECT_EQ(writer.buffered_bytes(), 0u);
+  EXPECT_EQ(std::memcmp(sink.data(), "abcdefgh", 8), 0);
+}
+
+TEST(BufferedWriter, FailedFlushKeepsData) {
+  std::array<std::byte, 2> output = {};
+  MemoryWriter sink(output);
+  BufferedWriterBuffer<8> writer(sink);
+
+  ASSERT_EQ(OkStatus(), writer.Write("abc", 3));
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 0u);
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Flush());
+  EXPECT_EQ(writer.buffered_bytes(), 3u);
+}
+
+TEST(BufferedReader, ServesSmallReadsFromBuffer) {
+  constexpr std::string_view kData = "0123456789";
+  MemoryReader source(std::as_bytes(std::span(kData)));
+  BufferedReaderBuffer<4> reader(source);
+
+  char buffer[3] = {};
+  ASSERT_EQ(OkStatus(), reader.Read(buffer, 2).status());
+  EXPECT_EQ(source.bytes_read(), 4u);
+  EXPECT_EQ(reader.buffered_bytes(), 2u);
+  EXPECT_EQ(reader.ConservativeReadLimit(), 8u);
+  EXPECT_EQ(std::memcmp(buffer, "01", 2), 0);
+
+  Result<ByteSpan> result = reader.Read(buffer, 3);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.value().size(), 2u);
+  EXPECT_EQ(std::memcmp(buffer, "23", 2), 0);
+  EXPECT_EQ(source.bytes_read(), 4u);
+}
+
+TEST(BufferedReader, LargeReadBypassesBuffer) {
+  constexpr std::string_view kData = "0123456789";
+  MemoryReader source(std::as_bytes(std::span(kData)));
+  BufferedReaderBuffer<4> reader(source);
+
+  char buffer[8] = {};
+  Result<ByteSpan> result = reader.Read(buffer, sizeof(buffer));
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.value().size(), 8u);
+  EXPECT_EQ(reader.buffered_bytes(), 0u);
+
+  result = reader.Read(buffer, sizeof(buffer));
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.value().size(), 2u);
+  EXPECT_EQ(std::memcmp(buffer, "89", 2), 0);
+
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer, 1).status());
+}
+
+}  // namespace
+}  // namespace pw::stream
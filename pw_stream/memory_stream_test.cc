@@ -134,6 +134,34 @@ TEST_F(MemoryWriterTest, EmptyData) {
   EXPECT_EQ(memory_writer.bytes_written(), 0u);
 }
 
+TEST_F(MemoryWriterTest, WriteV) {
+  constexpr std::byte kHeader[] = {std::byte{0x7e}, std::byte{0x01}};
+  constexpr std::byte kPayload[] = {std::byte{0xaa}, std::byte{0xbb}};
+  constexpr std::byte kTrailer[] = {std::byte{0x7e}};
+  const ConstByteSpan buffers[] = {kHeader, {}, kPayload, kTrailer};
+
+  MemoryWriter memory_writer(memory_buffer_);
+  ASSERT_EQ(memory_writer.WriteV(buffers), OkStatus());
+
+  constexpr std::byte kExpected[] = {std::byte{0x7e},
+                                     std::byte{0x01},
+                                     std::byte{0xaa},
+                                     std::byte{0xbb},
+                                     std::byte{0x7e}};
+  ASSERT_EQ(memory_writer.bytes_written(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(memory_writer.data(), kExpected, sizeof(kExpected)), 0);
+}
+
+TEST_F(MemoryWriterTest, WriteV_ExceedsLimit_WritesNothing) {
+  constexpr std::byte kHeader[] = {std::byte{0x7e}};
+  std::array<std::byte, kSinkBufferSize> payload = {};
+  const ConstByteSpan buffers[] = {kHeader, payload};
+
+  MemoryWriter memory_writer(memory_buffer_);
+  EXPECT_EQ(memory_writer.WriteV(buffers), Status::ResourceExhausted());
+  EXPECT_EQ(memory_writer.bytes_written(), 0u);
+}
+
 TEST_F(MemoryWriterTest, ValidateContents_SingleByteWrites) {
   MemoryWriter memory_writer(memory_buffer_);
   EXPECT_TRUE(memory_writer.Write(std::byte{0x01}).ok());
@@ -332,6 +360,40 @@ TEST(MemoryReader, MultipleReads) {
   }
 }
 
+TEST(MemoryReader, ReadV) {
+  constexpr std::string_view data = "0123456789";
+  MemoryReader reader(std::as_bytes(std::span(data)));
+
+  std::array<std::byte, 2> header;
+  std::array<std::byte, 3> payload;
+  const ByteSpan buffers[] = {header, payload};
+
+  StatusWithSize result = reader.ReadV(buffers);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 5u);
+  EXPECT_EQ(header[1], std::byte{'1'});
+  EXPECT_EQ(payload[0], std::byte{'2'});
+  EXPECT_EQ(payload[2], std::byte{'4'});
+  EXPECT_EQ(reader.ConservativeReadLimit(), 5u);
+}
+
+TEST(MemoryReader, ReadV_ShortRead) {
+  constexpr std::string_view data = "012";
+  MemoryReader reader(std::as_bytes(std::span(data)));
+
+  std::array<std::byte, 2> first;
+  std::array<std::byte, 2> second;
+  std::array<std::byte, 2> third;
+  const ByteSpan buffers[] = {first, second, third};
+
+  StatusWithSize result = reader.ReadV(buffers);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_EQ(second[0], std::byte{'2'});
+
+  EXPECT_EQ(reader.ReadV(buffers).status(), Status::OutOfRange());
+}
+
 TEST(MemoryReader, Seek) {
   constexpr std::string_view data = "0123456789";
   MemoryReader reader(std::as_bytes(std::span(data)));
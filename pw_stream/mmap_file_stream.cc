@@ -0,0 +1,77 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::stream {
+
+MmapFileReader::MmapFileReader(const char* path) {
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) == 0) {
+    const size_t size = static_cast<size_t>(file_info.st_size);
+
+    // mmap() rejects zero-length mappings, so empty files map to an empty span.
+    if (size == 0u) {
+      is_open_ = true;
+    } else if (void* mapped =
+                   mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+               mapped != MAP_FAILED) {
+      data_ = ConstByteSpan(static_cast<const std::byte*>(mapped), size);
+      is_open_ = true;
+    }
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+}
+
+void MmapFileReader::Close() {
+  if (!data_.empty()) {
+    munmap(const_cast<std::byte*>(data_.data()), data_.size());
+  }
+  data_ = ConstByteSpan();
+  position_ = 0;
+  is_open_ = false;
+}
+
+StatusWithSize MmapFileReader::DoRead(ByteSpan dest) {
+  if (!is_open_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (position_ == data_.size()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t bytes_to_read = std::min(dest.size(), data_.size() - position_);
+  if (bytes_to_read != 0u) {
+    std::memcpy(dest.data(), data_.data() + position_, bytes_to_read);
+    position_ += bytes_to_read;
+  }
+  return StatusWithSize(bytes_to_read);
+}
+
+}  // namespace pw::stream
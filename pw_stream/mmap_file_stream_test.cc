@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr std::string_view kContents = "0123456789abcdef";
+
+// Creates a temporary file with the given contents, which is removed when the
+// test finishes.
+class TempFile {
+ public:
+  TempFile(std::string_view contents) {
+    const int fd = mkstemp(path_);
+    EXPECT_GE(fd, 0);
+    if (fd >= 0) {
+      EXPECT_EQ(write(fd, contents.data(), contents.size()),
+                static_cast<ssize_t>(contents.size()));
+      close(fd);
+    }
+  }
+
+  ~TempFile() { unlink(path_); }
+
+  const char* path() const { return path_; }
+
+ private:
+  char path_[32] = "/tmp/pw_mmap_file_test_XXXXXX";
+};
+
+std::string_view AsString(ConstByteSpan data) {
+  return std::string_view(reinterpret_cast<const char*>(data.data()),
+                          data.size());
+}
+
+TEST(MmapFileReader, RegularFile_MapsContents) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(AsString(reader.data()), kContents);
+  EXPECT_EQ(reader.ConservativeReadLimit(), kContents.size());
+}
+
+TEST(MmapFileReader, Read_AdvancesUntilEnd) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  std::array<std::byte, 10> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(AsString(result.value()), "0123456789");
+  EXPECT_EQ(reader.Tell(), 10u);
+  EXPECT_EQ(reader.ConservativeReadLimit(), 6u);
+
+  result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(AsString(result.value()), "abcdef");
+
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+}
+
+TEST(MmapFileReader, Seek_ChangesReadPosition) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  std::array<std::byte, 4> buffer;
+  ASSERT_EQ(OkStatus(), reader.Seek(10));
+  EXPECT_EQ(AsString(reader.Read(buffer).value()), "abcd");
+
+  ASSERT_EQ(OkStatus(), reader.Seek(-2, Stream::kEnd));
+  EXPECT_EQ(AsString(reader.Read(buffer).value()), "ef");
+
+  ASSERT_EQ(OkStatus(), reader.Seek(0));
+  ASSERT_EQ(OkStatus(), reader.Seek(3, Stream::kCurrent));
+  EXPECT_EQ(AsString(reader.Read(buffer).value()), "3456");
+}
+
+TEST(MmapFileReader, Seek_OutOfBounds_KeepsPosition) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  ASSERT_EQ(OkStatus(), reader.Seek(5));
+  EXPECT_EQ(Status::OutOfRange(), reader.Seek(1, Stream::kEnd));
+  EXPECT_EQ(Status::OutOfRange(), reader.Seek(-1));
+  EXPECT_EQ(reader.Tell(), 5u);
+}
+
+TEST(MmapFileReader, Data_IndependentOfReadPosition) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  ASSERT_EQ(OkStatus(), reader.Seek(8));
+  EXPECT_EQ(AsString(reader.data()), kContents);
+}
+
+TEST(MmapFileReader, EmptyFile_OpenWithEmptyData) {
+  TempFile file("");
+  MmapFileReader reader(file.path());
+
+  EXPECT_TRUE(reader.is_open());
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+}
+
+TEST(MmapFileReader, MissingFile_NotOpen) {
+  MmapFileReader reader("/nonexistent/pw_mmap_file_test");
+
+  EXPECT_FALSE(reader.is_open());
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Read(buffer).status());
+}
+
+TEST(MmapFileReader, Close_ClearsData) {
+  TempFile file(kContents);
+  MmapFileReader reader(file.path());
+
+  reader.Close();
+  EXPECT_FALSE(reader.is_open());
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Read(buffer).status());
+}
+
+}  // namespace
+}  // namespace pw::stream
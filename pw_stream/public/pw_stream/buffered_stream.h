@@ -0,0 +1,110 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// Collects small writes in a buffer and passes them to another Writer in
+// larger chunks. The buffer is written out when it reaches the flush threshold
+// (a high-water mark, which defaults to the buffer size), when a write does
+// not fit in the remaining space, or when Flush() is called. Writes at least
+// as large as the buffer bypass it.
+//
+// Data is NOT flushed on destruction; call Flush() when done writing.
+class BufferedWriter : public NonSeekableWriter {
+ public:
+  constexpr BufferedWriter(Writer& writer, ByteSpan buffer)
+      : BufferedWriter(writer, buffer, buffer.size()) {}
+
+  // Precondition: flush_threshold must be between 1 and the buffer size.
+  constexpr BufferedWriter(Writer& writer,
+                           ByteSpan buffer,
+                           size_t flush_threshold)
+      : writer_(writer),
+        buffer_(buffer),
+        flush_threshold_(flush_threshold) {
+    PW_ASSERT(flush_threshold_ > 0u && flush_threshold_ <= buffer_.size());
+  }
+
+  // Writes all buffered data to the underlying Writer. If this fails, the data
+  // stays buffered.
+  Status Flush();
+
+  // Number of bytes waiting to be flushed.
+  size_t buffered_bytes() const { return size_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override;
+
+  // The buffered bytes still count against the underlying writer's limit.
+  size_t ConservativeLimit(LimitType type) const override;
+
+  Writer& writer_;
+  ByteSpan buffer_;
+  size_t flush_threshold_;
+  size_t size_ = 0;
+};
+
+template <size_t kBufferSize>
+class BufferedWriterBuffer final : public BufferedWriter {
+ public:
+  constexpr BufferedWriterBuffer(Writer& writer,
+                                 size_t flush_threshold = kBufferSize)
+      : BufferedWriter(writer, buffer_, flush_threshold) {}
+
+ private:
+  std::array<std::byte, kBufferSize> buffer_;
+};
+
+// Reads from another Reader in buffer-sized chunks and serves smaller reads
+// from the buffer. Reads at least as large as the buffer bypass it when the
+// buffer is empty.
+class BufferedReader : public NonSeekableReader {
+ public:
+  constexpr BufferedReader(Reader& reader, ByteSpan buffer)
+      : reader_(reader), buffer_(buffer) {}
+
+  // Number of bytes read from the underlying Reader but not yet returned.
+  size_t buffered_bytes() const { return end_ - position_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  size_t ConservativeLimit(LimitType type) const override;
+
+  Reader& reader_;
+  ByteSpan buffer_;
+  size_t position_ = 0;
+  size_t end_ = 0;
+};
+
+template <size_t kBufferSize>
+class BufferedReaderBuffer final : public BufferedReader {
+ public:
+  constexpr BufferedReaderBuffer(Reader& reader)
+      : BufferedReader(reader, buffer_) {}
+
+ private:
+  std::array<std::byte, kBufferSize> buffer_;
+};
+
+}  // namespace pw::stream
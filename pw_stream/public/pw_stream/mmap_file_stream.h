@@ -0,0 +1,63 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_stream/seek.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// Maps a file into memory with mmap() and reads it with the Reader interface.
+// The whole file is also available as one contiguous span through data(), so
+// parsers such as TokenDatabase::Create() can use it without copying.
+//
+// If the file cannot be opened or mapped, is_open() is false and Read()
+// returns FAILED_PRECONDITION.
+class MmapFileReader final : public SeekableReader {
+ public:
+  MmapFileReader(const char* path);
+
+  MmapFileReader(const MmapFileReader&) = delete;
+  MmapFileReader& operator=(const MmapFileReader&) = delete;
+
+  ~MmapFileReader() { Close(); }
+
+  // Unmaps the file. data() is empty afterwards.
+  void Close();
+
+  bool is_open() const { return is_open_; }
+
+  // The full contents of the file, regardless of the read position.
+  ConstByteSpan data() const { return data_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return CalculateSeek(offset, origin, data_.size(), position_);
+  }
+
+  size_t DoTell() const override { return position_; }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? data_.size() - position_ : 0;
+  }
+
+  ConstByteSpan data_;
+  size_t position_ = 0;
+  bool is_open_ = false;
+};
+
+}  // namespace pw::stream
@@ -41,4 +41,22 @@ class NullStream final : public SeekableReaderWriter {
   Status DoSeek(ptrdiff_t, Whence) final { return OkStatus(); }
 };
 
+// Stream that drops written data like NullStream, but counts how many bytes
+// were written. This can be used to measure the size of encoded data without
+// buffering it.
+class CountingNullStream final : public NonSeekableWriter {
+ public:
+  constexpr CountingNullStream() : bytes_written_(0) {}
+
+  size_t bytes_written() const { return bytes_written_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) final {
+    bytes_written_ += data.size();
+    return OkStatus();
+  }
+
+  size_t bytes_written_;
+};
+
 }  // namespace pw::stream
@@ -0,0 +1,112 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <poll.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_stream/socket_stream.h"
+
+namespace pw::stream {
+
+// Serves many SocketStream connections from a single thread. Poll() waits for
+// activity with poll(), accepts new connections, and passes data from readable
+// connections to a handler. The handler typically feeds an HDLC decoder and
+// pw_rpc server, using the connection as the response Writer.
+//
+// Use SocketDispatcherBuffer to declare a dispatcher with its storage.
+class SocketDispatcher {
+ public:
+  // Called with each chunk of data received on a connection.
+  using DataHandler =
+      Function<void(SocketStream& connection, ConstByteSpan data)>;
+
+  SocketDispatcher(const SocketDispatcher&) = delete;
+  SocketDispatcher& operator=(const SocketDispatcher&) = delete;
+
+  ~SocketDispatcher() { Close(); }
+
+  // Listens on the port for connections. Does not block. If port is 0, the OS
+  // picks a free port, which port() returns.
+  //
+  // Returns:
+  //
+  //   OK - The dispatcher is listening.
+  //   FAILED_PRECONDITION - The dispatcher is already listening.
+  //   UNKNOWN - The listening socket could not be set up.
+  //
+  Status Listen(uint16_t port);
+
+  // The port the dispatcher is listening on, or 0 if it is not listening.
+  uint16_t port() const { return listen_fd_ == kInvalidFd ? 0 : port_; }
+
+  // Waits up to timeout_ms for activity, or forever if timeout_ms is negative.
+  // Accepts pending connections, reads once from each readable connection, and
+  // closes connections that the peer closed or that failed. If all
+  // connections are in use, new connections are refused.
+  //
+  // Returns:
+  //
+  //   OK - Any activity was handled, or the timeout expired.
+  //   FAILED_PRECONDITION - Listen() has not succeeded.
+  //   UNKNOWN - poll() failed.
+  //
+  Status Poll(int timeout_ms);
+
+  // Closes the listening socket and all connections.
+  void Close();
+
+  // Number of open connections.
+  size_t active_connections() const;
+
+ protected:
+  // poll_fds must have one more entry than connections, for the listener.
+  SocketDispatcher(std::span<SocketStream> connections,
+                   std::span<pollfd> poll_fds,
+                   ByteSpan read_buffer,
+                   DataHandler&& handler);
+
+ private:
+  static constexpr int kInvalidFd = -1;
+
+  void Accept();
+
+  std::span<SocketStream> connections_;
+  std::span<pollfd> poll_fds_;
+  ByteSpan read_buffer_;
+  DataHandler handler_;
+  int listen_fd_ = kInvalidFd;
+  uint16_t port_ = 0;
+};
+
+template <size_t kMaxConnections, size_t kReadBufferSize = 256>
+class SocketDispatcherBuffer final : public SocketDispatcher {
+ public:
+  SocketDispatcherBuffer(DataHandler&& handler)
+      : SocketDispatcher(
+            connections_, poll_fds_, read_buffer_, std::move(handler)) {}
+
+ private:
+  std::array<SocketStream, kMaxConnections> connections_;
+  std::array<pollfd, kMaxConnections + 1> poll_fds_;
+  std::array<std::byte, kReadBufferSize> read_buffer_;
+};
+
+}  // namespace pw::stream
@@ -38,13 +38,30 @@ class SocketStream : public NonSeekableReaderWriter {
   // Close the socket stream and release all resources
   void Close();
 
+  // Switches the connection between blocking and non-blocking mode. In
+  // non-blocking mode, Read() returns RESOURCE_EXHAUSTED when no data is
+  // available and Write() returns RESOURCE_EXHAUSTED if nothing could be sent.
+  Status SetBlocking(bool blocking);
+
+  // True if the stream has a connection.
+  bool is_open() const { return conn_fd_ != kInvalidFd; }
+
  private:
+  friend class SocketDispatcher;
+
   static constexpr int kInvalidFd = -1;
 
+  // Maximum number of buffers passed to a single writev()/readv() call.
+  static constexpr size_t kMaxIoVectors = 16;
+
   Status DoWrite(std::span<const std::byte> data) override;
 
+  Status DoWriteV(std::span<const ConstByteSpan> data) override;
+
   StatusWithSize DoRead(ByteSpan dest) override;
 
+  StatusWithSize DoReadV(std::span<const ByteSpan> dest) override;
+
   uint16_t listen_port_ = 0;
   int socket_fd_ = kInvalidFd;
   int conn_fd_ = kInvalidFd;
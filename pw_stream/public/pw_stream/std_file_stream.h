@@ -43,6 +43,7 @@ class StdFileWriter final : public stream::SeekableWriter {
 
  private:
   Status DoWrite(ConstByteSpan data) override;
+  Status DoWriteV(std::span<const ConstByteSpan> data) override;
   Status DoSeek(ptrdiff_t offset, Whence origin) override;
 
   std::ofstream stream_;
@@ -110,6 +110,22 @@ class Stream {
     return Read(std::span(static_cast<std::byte*>(dest), size_bytes));
   }
 
+  // Reads data from this stream into a sequence of buffers (scatter read). The
+  // buffers are filled in order; a buffer is only started once the previous
+  // one is full. Streams backed by a file descriptor may implement this with a
+  // single readv() call.
+  //
+  // Derived classes should NOT try to override ReadV(). Instead, override
+  // DoReadV() if the stream can do better than one Read() per buffer.
+  //
+  // Returns:
+  //
+  //   OK - Between 1 and the total size of the buffers were read. Returns the
+  //       total number of bytes read.
+  //   Other statuses are the same as for Read(). No bytes were read.
+  //
+  StatusWithSize ReadV(std::span<const ByteSpan> dest) { return DoReadV(dest); }
+
   // Writes data to this stream. Data is not guaranteed to be fully written out
   // to final resting place on Write return.
   //
@@ -148,6 +164,18 @@ class Stream {
   }
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  // Writes a sequence of buffers to this stream, in order (gather write). This
+  // lets callers emit a header, payload, and trailer without first copying
+  // them into one buffer. Streams backed by a file descriptor may implement
+  // this with a single writev() call.
+  //
+  // Derived classes should NOT try to override WriteV(). Instead, override
+  // DoWriteV() if the stream can do better than one Write() per buffer.
+  //
+  // Returns the same statuses as Write(). Unlike Write(), a failed WriteV() may
+  // have written some of the buffers.
+  Status WriteV(std::span<const ConstByteSpan> data) { return DoWriteV(data); }
+
   // Changes the current position in the stream for both reading and writing, if
   // supported.
   //
@@ -248,6 +276,47 @@ class Stream {
 
   virtual Status DoWrite(ConstByteSpan data) = 0;
 
+  // The default ReadV() reads into each buffer with DoRead(), stopping at the
+  // first short read or error.
+  virtual StatusWithSize DoReadV(std::span<const ByteSpan> destination) {
+    size_t total_read = 0;
+    for (ByteSpan buffer : destination) {
+      if (buffer.empty()) {
+        continue;
+      }
+      StatusWithSize result = DoRead(buffer);
+      if (!result.ok()) {
+        return total_read == 0 ? result : StatusWithSize(total_read);
+      }
+      total_read += result.size();
+      if (result.size() < buffer.size()) {
+        break;
+      }
+    }
+    return StatusWithSize(total_read);
+  }
+
+  // The default WriteV() checks the total size against ConservativeWriteLimit()
+  // and then writes each buffer with DoWrite().
+  virtual Status DoWriteV(std::span<const ConstByteSpan> data) {
+    size_t total_size = 0;
+    for (ConstByteSpan buffer : data) {
+      total_size += buffer.size();
+    }
+    if (total_size > ConservativeWriteLimit()) {
+      return Status::ResourceExhausted();
+    }
+    for (ConstByteSpan buffer : data) {
+      if (buffer.empty()) {
+        continue;
+      }
+      if (Status status = DoWrite(buffer); !status.ok()) {
+        return status;
+      }
+    }
+    return OkStatus();
+  }
+
   virtual Status DoSeek(ptrdiff_t offset, Whence origin) = 0;
 
   virtual size_t DoTell() const { return kUnknownPosition; }
@@ -286,8 +355,12 @@ class Reader : public Stream {
       : Stream(true, false, seekability) {}
 
   using Stream::Write;
+  using Stream::WriteV;
 
   Status DoWrite(ConstByteSpan) final { return Status::Unimplemented(); }
+  Status DoWriteV(std::span<const ConstByteSpan>) final {
+    return Status::Unimplemented();
+  }
 };
 
 // A Reader that supports at least relative seeking within some range of the
@@ -371,10 +444,14 @@ class Writer : public Stream {
       : Stream(false, true, seekability) {}
 
   using Stream::Read;
+  using Stream::ReadV;
 
   StatusWithSize DoRead(ByteSpan) final {
     return StatusWithSize::Unimplemented();
   }
+  StatusWithSize DoReadV(std::span<const ByteSpan>) final {
+    return StatusWithSize::Unimplemented();
+  }
 };
 
 // A Writer that supports at least relative seeking within some range of the
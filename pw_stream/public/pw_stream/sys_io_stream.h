@@ -32,8 +32,10 @@ class SysIoWriter : public NonSeekableWriter {
 
 class SysIoReader : public NonSeekableReader {
  private:
+  // Returns as soon as any bytes are available rather than waiting to fill
+  // dest, which lets backends that buffer input return it in bulk.
   StatusWithSize DoRead(ByteSpan dest) override {
-    return pw::sys_io::ReadBytes(dest);
+    return pw::sys_io::ReadAvailableBytes(dest);
   }
 };
 
@@ -0,0 +1,184 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/socket_dispatcher.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+#include "pw_result/result.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr int kListenBacklog = 8;
+
+}  // namespace
+
+SocketDispatcher::SocketDispatcher(std::span<SocketStream> connections,
+                                   std::span<pollfd> poll_fds,
+                                   ByteSpan read_buffer,
+                                   DataHandler&& handler)
+    : connections_(connections),
+      poll_fds_(poll_fds),
+      read_buffer_(read_buffer),
+      handler_(std::move(handler)) {
+  PW_CHECK_UINT_EQ(poll_fds_.size(), connections_.size() + 1);
+  PW_CHECK(!read_buffer_.empty());
+}
+
+Status SocketDispatcher::Listen(uint16_t port) {
+  if (listen_fd_ != kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ == kInvalidFd) {
+    PW_LOG_ERROR("Failed to create socket: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  // The listener is non-blocking so that accept() cannot hang if a client
+  // disconnects between poll() and accept().
+  const int flags = fcntl(listen_fd_, F_GETFL, 0);
+  if (flags < 0 || fcntl(listen_fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+    PW_LOG_ERROR("Failed to make the listening socket non-blocking: %s",
+                 std::strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = kInvalidFd;
+    return Status::Unknown();
+  }
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = INADDR_ANY;
+
+  // See SocketStream::Serve() for why SO_REUSEADDR is set.
+  constexpr int value = 1;
+  if (setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(int)) <
+      0) {
+    PW_LOG_WARN("Failed to set SO_REUSEADDR: %s", std::strerror(errno));
+  }
+
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd_, kListenBacklog) < 0) {
+    PW_LOG_ERROR(
+        "Failed to listen on port %hu: %s", port, std::strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = kInvalidFd;
+    return Status::Unknown();
+  }
+
+  // Record the bound port, which the OS chose if port was 0.
+  socklen_t addr_len = sizeof(addr);
+  if (getsockname(
+          listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) < 0) {
+    PW_LOG_ERROR("Failed to get the listening port: %s", std::strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = kInvalidFd;
+    return Status::Unknown();
+  }
+  port_ = ntohs(addr.sin_port);
+  return OkStatus();
+}
+
+Status SocketDispatcher::Poll(int timeout_ms) {
+  if (listen_fd_ == kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  // Entry 0 is the listener; entry i + 1 is connections_[i]. poll() ignores
+  // negative file descriptors, so closed connections keep their slot.
+  poll_fds_[0] = {.fd = listen_fd_, .events = POLLIN, .revents = 0};
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    poll_fds_[i + 1] = {
+        .fd = connections_[i].conn_fd_, .events = POLLIN, .revents = 0};
+  }
+
+  const int ready = poll(poll_fds_.data(), poll_fds_.size(), timeout_ms);
+  if (ready < 0) {
+    if (errno == EINTR) {
+      return OkStatus();
+    }
+    PW_LOG_ERROR("poll() failed: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    if ((poll_fds_[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+      continue;
+    }
+
+    SocketStream& connection = connections_[i];
+    Result<ByteSpan> data = connection.Read(read_buffer_);
+    if (data.ok()) {
+      handler_(connection, data.value());
+    } else if (!data.status().IsResourceExhausted()) {
+      connection.Close();
+    }
+  }
+
+  if ((poll_fds_[0].revents & POLLIN) != 0) {
+    Accept();
+  }
+  return OkStatus();
+}
+
+void SocketDispatcher::Accept() {
+  const int fd = accept(listen_fd_, nullptr, nullptr);
+  if (fd < 0) {
+    return;  // The client may have given up before it was accepted.
+  }
+
+  for (SocketStream& connection : connections_) {
+    if (!connection.is_open()) {
+      connection.conn_fd_ = fd;
+      // Some platforms pass O_NONBLOCK on from the listener. Reads only happen
+      // after poll(), so connections stay blocking for simple writes.
+      connection.SetBlocking(true).IgnoreError();
+      return;
+    }
+  }
+
+  PW_LOG_WARN("Refusing connection; all %u connections are in use",
+              static_cast<unsigned>(connections_.size()));
+  close(fd);
+}
+
+void SocketDispatcher::Close() {
+  for (SocketStream& connection : connections_) {
+    connection.Close();
+  }
+  if (listen_fd_ != kInvalidFd) {
+    close(listen_fd_);
+    listen_fd_ = kInvalidFd;
+  }
+}
+
+size_t SocketDispatcher::active_connections() const {
+  size_t count = 0;
+  for (const SocketStream& connection : connections_) {
+    count += connection.is_open() ? 1 : 0;
+  }
+  return count;
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,170 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/socket_dispatcher.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/socket_stream.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr int kTimeoutMs = 1000;
+
+constexpr auto kData = bytes::String("hello");
+
+// Connects clients to a dispatcher on a loopback port. The dispatcher records
+// the data it receives and echoes it back on the same connection.
+class SocketDispatcherTest : public ::testing::Test {
+ protected:
+  SocketDispatcherTest()
+      : dispatcher_([this](SocketStream& connection, ConstByteSpan data) {
+          std::memcpy(&received_[received_size_], data.data(), data.size());
+          received_size_ += data.size();
+          handler_calls_ += 1;
+          EXPECT_EQ(OkStatus(), connection.Write(data));
+        }) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), dispatcher_.Listen(0));
+    ASSERT_NE(dispatcher_.port(), 0u);
+  }
+
+  Status Connect(SocketStream& client) {
+    return client.Connect("localhost", dispatcher_.port());
+  }
+
+  std::string_view received() const {
+    return std::string_view(reinterpret_cast<const char*>(received_.data()),
+                            received_size_);
+  }
+
+  SocketDispatcherBuffer<2> dispatcher_;
+  std::array<std::byte, 64> received_ = {};
+  size_t received_size_ = 0;
+  int handler_calls_ = 0;
+};
+
+TEST_F(SocketDispatcherTest, Listen_AlreadyListening_FailedPrecondition) {
+  EXPECT_EQ(Status::FailedPrecondition(), dispatcher_.Listen(0));
+}
+
+TEST_F(SocketDispatcherTest, Close_ClearsPort) {
+  dispatcher_.Close();
+  EXPECT_EQ(dispatcher_.port(), 0u);
+  EXPECT_EQ(Status::FailedPrecondition(), dispatcher_.Poll(0));
+}
+
+TEST_F(SocketDispatcherTest, Poll_NoActivity_TimesOut) {
+  EXPECT_EQ(OkStatus(), dispatcher_.Poll(0));
+  EXPECT_EQ(dispatcher_.active_connections(), 0u);
+}
+
+TEST_F(SocketDispatcherTest, Poll_AcceptsConnection) {
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+
+  EXPECT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  EXPECT_EQ(dispatcher_.active_connections(), 1u);
+}
+
+TEST_F(SocketDispatcherTest, Poll_DeliversDataToHandler) {
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+
+  ASSERT_EQ(OkStatus(), client.Write(kData));
+  while (received_size_ < kData.size()) {
+    ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  }
+  EXPECT_EQ(received(), "hello");
+
+  // The handler echoes the data back over the connection.
+  std::array<std::byte, 16> buffer;
+  size_t echoed = 0;
+  while (echoed < kData.size()) {
+    Result<ByteSpan> result = client.Read(std::span(buffer).subspan(echoed));
+    ASSERT_EQ(OkStatus(), result.status());
+    echoed += result.value().size();
+  }
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(SocketDispatcherTest, Poll_PeerClosed_ClosesConnection) {
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  ASSERT_EQ(dispatcher_.active_connections(), 1u);
+
+  client.Close();
+  EXPECT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  EXPECT_EQ(dispatcher_.active_connections(), 0u);
+  EXPECT_EQ(handler_calls_, 0);
+}
+
+TEST_F(SocketDispatcherTest, Poll_AllConnectionsInUse_RefusesConnection) {
+  std::array<SocketStream, 3> clients;
+  for (SocketStream& client : clients) {
+    ASSERT_EQ(OkStatus(), Connect(client));
+    ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  }
+  EXPECT_EQ(dispatcher_.active_connections(), 2u);
+
+  // The refused client sees the dispatcher close the connection.
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::OutOfRange(), clients[2].Read(buffer).status());
+
+  // Closing a connection frees its slot for the next client.
+  clients[0].Close();
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  ASSERT_EQ(dispatcher_.active_connections(), 1u);
+
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+  EXPECT_EQ(dispatcher_.active_connections(), 2u);
+}
+
+TEST_F(SocketDispatcherTest, SocketStreamRead_NonBlockingNoData_Exhausted) {
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+
+  ASSERT_EQ(OkStatus(), client.SetBlocking(false));
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::ResourceExhausted(), client.Read(buffer).status());
+}
+
+TEST_F(SocketDispatcherTest, SocketStreamRead_PeerClosed_OutOfRange) {
+  SocketStream client;
+  ASSERT_EQ(OkStatus(), Connect(client));
+  ASSERT_EQ(OkStatus(), dispatcher_.Poll(kTimeoutMs));
+
+  dispatcher_.Close();
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::OutOfRange(), client.Read(buffer).status());
+}
+
+TEST(SocketStream, SetBlocking_NotConnected_FailedPrecondition) {
+  SocketStream stream;
+  EXPECT_EQ(Status::FailedPrecondition(), stream.SetBlocking(false));
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -15,8 +15,13 @@
 #include "pw_stream/socket_stream.h"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstring>
 
 #include "pw_log/log.h"
@@ -27,6 +32,21 @@ namespace {
 constexpr uint32_t kMaxConcurrentUser = 1;
 constexpr const char* kLocalhostAddress = "127.0.0.1";
 
+// Converts the return value of recv() or readv() to a StatusWithSize. Reading
+// zero bytes into a non-empty buffer means the peer closed the connection.
+StatusWithSize RecvResult(ssize_t bytes_rcvd, size_t requested) {
+  if (bytes_rcvd < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    return StatusWithSize::Unknown();
+  }
+  if (bytes_rcvd == 0 && requested != 0u) {
+    return StatusWithSize::OutOfRange();
+  }
+  return StatusWithSize(bytes_rcvd);
+}
+
 }  // namespace
 
 // Listen to the port and return after a client is connected
@@ -115,21 +135,77 @@ void SocketStream::Close() {
   }
 }
 
+Status SocketStream::SetBlocking(bool blocking) {
+  if (conn_fd_ == kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  int flags = fcntl(conn_fd_, F_GETFL, 0);
+  if (flags < 0) {
+    return Status::Unknown();
+  }
+  flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+  if (fcntl(conn_fd_, F_SETFL, flags) < 0) {
+    PW_LOG_ERROR("Failed to set socket blocking mode: %s",
+                 std::strerror(errno));
+    return Status::Unknown();
+  }
+  return OkStatus();
+}
+
 Status SocketStream::DoWrite(std::span<const std::byte> data) {
   ssize_t bytes_sent = send(conn_fd_, data.data(), data.size_bytes(), 0);
 
+  if (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return Status::ResourceExhausted();
+  }
   if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != data.size()) {
     return Status::Unknown();
   }
   return OkStatus();
 }
 
+// Buffers are sent kMaxIoVectors at a time, so most frames take one syscall.
+Status SocketStream::DoWriteV(std::span<const ConstByteSpan> data) {
+  std::array<iovec, kMaxIoVectors> iov;
+
+  while (!data.empty()) {
+    const size_t count = std::min(data.size(), iov.size());
+    size_t expected = 0;
+    for (size_t i = 0; i < count; ++i) {
+      iov[i].iov_base = const_cast<std::byte*>(data[i].data());
+      iov[i].iov_len = data[i].size_bytes();
+      expected += data[i].size_bytes();
+    }
+
+    ssize_t bytes_sent = writev(conn_fd_, iov.data(), count);
+    if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != expected) {
+      return Status::Unknown();
+    }
+    data = data.subspan(count);
+  }
+  return OkStatus();
+}
+
 StatusWithSize SocketStream::DoRead(ByteSpan dest) {
   ssize_t bytes_rcvd = recv(conn_fd_, dest.data(), dest.size_bytes(), 0);
-  if (bytes_rcvd < 0) {
-    return StatusWithSize::Unknown();
+  return RecvResult(bytes_rcvd, dest.size_bytes());
+}
+
+// Like recv(), readv() returns whatever is available, so only the first
+// kMaxIoVectors buffers are filled.
+StatusWithSize SocketStream::DoReadV(std::span<const ByteSpan> dest) {
+  std::array<iovec, kMaxIoVectors> iov;
+  const size_t count = std::min(dest.size(), iov.size());
+  size_t requested = 0;
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = dest[i].data();
+    iov[i].iov_len = dest[i].size_bytes();
+    requested += dest[i].size_bytes();
   }
-  return StatusWithSize(bytes_rcvd);
+
+  ssize_t bytes_rcvd = readv(conn_fd_, iov.data(), count);
+  return RecvResult(bytes_rcvd, requested);
 }
 
 };  // namespace pw::stream
@@ -63,6 +63,24 @@ Status StdFileWriter::DoWrite(ConstByteSpan data) {
   return Status::Unknown();
 }
 
+// All buffers are copied into the ofstream's buffer before checking for
+// errors once, instead of dispatching to DoWrite() for each buffer.
+Status StdFileWriter::DoWriteV(std::span<const ConstByteSpan> data) {
+  if (stream_.eof()) {
+    return Status::OutOfRange();
+  }
+
+  for (ConstByteSpan buffer : data) {
+    stream_.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+  }
+
+  if (stream_) {
+    return OkStatus();
+  }
+
+  return Status::Unknown();
+}
+
 Status StdFileWriter::DoSeek(ptrdiff_t offset, Whence origin) {
   if (!stream_.seekp(offset, WhenceToSeekDir(origin))) {
     return Status::Unknown();
@@ -215,5 +215,16 @@ TEST(NullStream, DefaultTell) {
   EXPECT_EQ(stream.Tell(), Stream::kUnknownPosition);
 }
 
+TEST(CountingNullStream, CountsBytesWritten) {
+  CountingNullStream stream;
+  EXPECT_EQ(stream.bytes_written(), 0u);
+  EXPECT_EQ(stream.ConservativeWriteLimit(), Stream::kUnlimited);
+
+  constexpr std::byte kData[5] = {};
+  EXPECT_EQ(OkStatus(), stream.Write(kData));
+  EXPECT_EQ(OkStatus(), stream.Write(std::span(kData, 2)));
+  EXPECT_EQ(stream.bytes_written(), 7u);
+}
+
 }  // namespace
 }  // namespace pw::stream
@@ -0,0 +1,140 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_string/format_string.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_string/type_to_string.h"
+#include "pw_string/util.h"
+
+namespace pw::string::internal {
+namespace {
+
+// Large enough for any number, including a float with kMaxFloatPrecision.
+constexpr size_t kNumberBufferSize = 64;
+
+}  // namespace
+
+void FormatWriter::Append(std::string_view text) {
+  // Leave room for the null terminator.
+  const size_t available = buffer_.empty() ? 0 : buffer_.size() - 1 - size_;
+  const size_t copied = std::min(text.size(), available);
+  std::memcpy(buffer_.data() + size_, text.data(), copied);
+  size_ += copied;
+
+  if (copied != text.size()) {
+    status_ = Status::ResourceExhausted();
+  }
+}
+
+void FormatWriter::AppendFill(char fill, size_t count) {
+  const size_t available = buffer_.empty() ? 0 : buffer_.size() - 1 - size_;
+  const size_t filled = std::min(count, available);
+  std::memset(buffer_.data() + size_, fill, filled);
+  size_ += filled;
+
+  if (filled != count) {
+    status_ = Status::ResourceExhausted();
+  }
+}
+
+void FormatWriter::AppendPadded(std::string_view text, FormatSpec spec) {
+  const size_t padding =
+      text.size() < spec.width ? spec.width - text.size() : 0;
+
+  if (spec.left_align) {
+    Append(text);
+    AppendFill(' ', padding);
+    return;
+  }
+
+  if (spec.zero_pad) {
+    // Zeroes go after the sign.
+    if (!text.empty() && text[0] == '-') {
+      Append("-");
+      text.remove_prefix(1);
+    }
+    AppendFill('0', padding);
+  } else {
+    AppendFill(' ', padding);
+  }
+  Append(text);
+}
+
+void FormatWriter::AppendSigned(int64_t value, FormatSpec spec) {
+  char number[kNumberBufferSize];
+  AppendPadded({number, IntToString(value, number).size()}, spec);
+}
+
+void FormatWriter::AppendUnsigned(uint64_t value, FormatSpec spec) {
+  char number[kNumberBufferSize];
+  if (spec.conversion == 'u') {
+    AppendPadded({number, IntToString(value, number).size()}, spec);
+    return;
+  }
+
+  const size_t size = IntToHexString(value, number).size();
+  if (spec.conversion == 'X') {
+    for (size_t i = 0; i < size; ++i) {
+      if (number[i] >= 'a') {
+        number[i] = static_cast<char>(number[i] - 'a' + 'A');
+      }
+    }
+  }
+  AppendPadded({number, size}, spec);
+}
+
+void FormatWriter::AppendFloat(float value, FormatSpec spec) {
+  char number[kNumberBufferSize];
+  const uint_fast8_t precision =
+      spec.precision < 0 ? 6 : static_cast<uint_fast8_t>(spec.precision);
+  AppendPadded({number, FloatToString(value, number, precision).size()}, spec);
+}
+
+void FormatWriter::AppendChar(char value, FormatSpec spec) {
+  AppendPadded({&value, 1}, spec);
+}
+
+void FormatWriter::AppendString(const char* value, FormatSpec spec) {
+  if (value == nullptr) {
+    AppendString(kNullPointerString, spec);
+    return;
+  }
+  const size_t max_length =
+      spec.precision < 0 ? buffer_.size() : static_cast<size_t>(spec.precision);
+  AppendPadded(ClampedCString(value, max_length), spec);
+}
+
+void FormatWriter::AppendString(std::string_view value, FormatSpec spec) {
+  if (spec.precision >= 0) {
+    value = value.substr(0, static_cast<size_t>(spec.precision));
+  }
+  AppendPadded(value, spec);
+}
+
+void FormatWriter::AppendPointer(const void* value, FormatSpec spec) {
+  char number[kNumberBufferSize];
+  AppendPadded({number, PointerToString(value, number).size()}, spec);
+}
+
+StatusWithSize FormatWriter::Finish() {
+  if (buffer_.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  buffer_[size_] = '\0';
+  return StatusWithSize(status_, size_);
+}
+
+}  // namespace pw::string::internal
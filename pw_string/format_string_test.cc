@@ -0,0 +1,178 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_string/format_string.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_string/format.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::string {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+// Checks that a FormatString and snprintf write the same output.
+#define EXPECT_MATCHES_SNPRINTF(format_string, ...)                         \
+  do {                                                                      \
+    char buffer[64];                                                        \
+    char printf_buffer[64];                                                 \
+    const int written = std::snprintf(                                      \
+        printf_buffer, sizeof(printf_buffer), format_string, __VA_ARGS__);  \
+    const StatusWithSize result =                                           \
+        Format(buffer, PW_FORMAT_STRING(format_string), __VA_ARGS__);       \
+    EXPECT_EQ(OkStatus(), result.status());                                 \
+    EXPECT_EQ(static_cast<size_t>(written), result.size());                 \
+    EXPECT_STREQ(printf_buffer, buffer);                                    \
+  } while (0)
+
+TEST(FormatString, NoArguments) {
+  char buffer[16];
+  auto result = Format(buffer, PW_FORMAT_STRING("Hello"));
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("Hello", buffer);
+}
+
+TEST(FormatString, EmptyFormat) {
+  char buffer[4] = "abc";
+  auto result = Format(buffer, PW_FORMAT_STRING(""));
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_STREQ("", buffer);
+}
+
+TEST(FormatString, Percent) {
+  char buffer[16];
+  EXPECT_EQ(5u, Format(buffer, PW_FORMAT_STRING("%%%d%%%%"), 12).size());
+  EXPECT_STREQ("%12%%", buffer);
+}
+
+TEST(FormatString, Integers_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%d", 0);
+  EXPECT_MATCHES_SNPRINTF("%d %i", -12345, 678);
+  EXPECT_MATCHES_SNPRINTF("%u", 4000000000u);
+  EXPECT_MATCHES_SNPRINTF("%lld", -9223372036854775807ll);
+  EXPECT_MATCHES_SNPRINTF("%llu", 18446744073709551615ull);
+  EXPECT_MATCHES_SNPRINTF("%x %X", 0xabcdefu, 0xabcdefu);
+  EXPECT_MATCHES_SNPRINTF("%zu items", sizeof(int));
+  EXPECT_MATCHES_SNPRINTF("%hhu", static_cast<unsigned char>(200));
+}
+
+TEST(FormatString, NegativeAsUnsigned_MatchesSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%u %x", -1, -2);
+}
+
+TEST(FormatString, WidthAndFlags_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("[%5d]", 42);
+  EXPECT_MATCHES_SNPRINTF("[%-5d]", 42);
+  EXPECT_MATCHES_SNPRINTF("[%05d]", -42);
+  EXPECT_MATCHES_SNPRINTF("[%08x]", 0xbeefu);
+  EXPECT_MATCHES_SNPRINTF("[%2d]", 12345);
+  EXPECT_MATCHES_SNPRINTF("[%-8s|%8s]", "ab", "cd");
+  EXPECT_MATCHES_SNPRINTF("[%3c]", 'z');
+}
+
+TEST(FormatString, Floats_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%f", 3.5);
+  EXPECT_MATCHES_SNPRINTF("%.2f V", 3.14159f);
+  EXPECT_MATCHES_SNPRINTF("%.0f", -2.5);
+  EXPECT_MATCHES_SNPRINTF("[%10.3f]", -1.0625);
+  EXPECT_MATCHES_SNPRINTF("[%-10.1f]", 100.25);
+  EXPECT_MATCHES_SNPRINTF("[%08.2f]", -5.5);
+}
+
+TEST(FormatString, Strings_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%s", "hello");
+  EXPECT_MATCHES_SNPRINTF("%.3s", "hello");
+  EXPECT_MATCHES_SNPRINTF("<%s> <%c>", "", 'x');
+}
+
+TEST(FormatString, StringView) {
+  char buffer[16];
+  EXPECT_EQ(4u, Format(buffer, PW_FORMAT_STRING("%.4s"), "abcdef"sv).size());
+  EXPECT_STREQ("abcd", buffer);
+}
+
+TEST(FormatString, NullString) {
+  char buffer[16];
+  const char* string = nullptr;
+  EXPECT_EQ(6u, Format(buffer, PW_FORMAT_STRING("%s"), string).size());
+  EXPECT_STREQ("(null)", buffer);
+}
+
+TEST(FormatString, Pointer) {
+  char buffer[32];
+  int value;
+  char expected[32];
+  PointerToString(&value, expected);
+  Format(buffer, PW_FORMAT_STRING("%p"), &value);
+  EXPECT_STREQ(expected, buffer);
+
+  Format(buffer, PW_FORMAT_STRING("%p"), nullptr);
+  EXPECT_STREQ("(null)", buffer);
+}
+
+enum class Color : uint8_t { kRed = 200 };
+
+TEST(FormatString, Enum) {
+  char buffer[16];
+  Format(buffer, PW_FORMAT_STRING("%u %x"), Color::kRed, Color::kRed);
+  EXPECT_STREQ("200 c8", buffer);
+}
+
+TEST(FormatString, ExhaustBuffer_Truncates) {
+  char buffer[8];
+  auto result =
+      Format(buffer, PW_FORMAT_STRING("%s=%d"), "temperature", 12345);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(7u, result.size());
+  EXPECT_STREQ("tempera", buffer);
+}
+
+TEST(FormatString, ExhaustBuffer_InArgument) {
+  char buffer[8];
+  auto result = Format(buffer, PW_FORMAT_STRING("n=%d"), 123456789);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(7u, result.size());
+  EXPECT_STREQ("n=12345", buffer);
+}
+
+TEST(FormatString, EmptyBuffer) {
+  auto result = Format(std::span<char>(), PW_FORMAT_STRING("%d"), 1);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(FormatString, StringBuilder) {
+  StringBuffer<32> sb;
+  sb << '<';
+  EXPECT_TRUE(sb.Format(PW_FORMAT_STRING("%s:%04u"), "id", 7u).ok());
+  sb << '>';
+  EXPECT_STREQ("<id:0007>", sb.data());
+}
+
+TEST(FormatString, StringBuilder_ExhaustBuffer) {
+  StringBuffer<6> sb;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            sb.Format(PW_FORMAT_STRING("%d%d"), 123, 456).status());
+  EXPECT_STREQ("12345", sb.data());
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+}
+
+}  // namespace
+}  // namespace pw::string
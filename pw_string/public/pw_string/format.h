@@ -26,6 +26,7 @@
 
 #include "pw_preprocessor/compiler.h"
 #include "pw_status/status_with_size.h"
+#include "pw_string/format_string.h"
 
 namespace pw::string {
 
@@ -49,4 +50,18 @@ StatusWithSize FormatVaList(std::span<char> buffer,
                             const char* format,
                             va_list args);
 
+// Writes a format string that was parsed at compile time with PW_FORMAT_STRING.
+// The return value is the same as above, but mistakes in the format string or
+// arguments fail the build instead of returning INVALID_ARGUMENT. This does not
+// call std::vsnprintf. See "pw_string/format_string.h" for details.
+//
+//   pw::string::Format(buffer, PW_FORMAT_STRING("%d items"), count);
+//
+template <typename Source, typename... Args>
+StatusWithSize Format(std::span<char> buffer,
+                      FormatString<Source> format,
+                      const Args&... args) {
+  return format.Write(buffer, args...);
+}
+
 }  // namespace pw::string
@@ -0,0 +1,367 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// This provides compile-time parsed printf-style format strings. Wrap a string
+// literal in PW_FORMAT_STRING to parse and check it while compiling:
+//
+//   pw::string::Format(buffer, PW_FORMAT_STRING("%s: %5.2f V"), name, volts);
+//
+//   pw::StringBuffer<32> sb;
+//   sb.Format(PW_FORMAT_STRING("[%08x]"), address);
+//
+// Mistakes in the format string, the wrong number of arguments, and argument
+// types that do not match their conversions fail the build. At run time, only
+// the arguments are converted, and std::snprintf is never called.
+//
+// Supported conversions are %d, %i, %u, %x, %X, %f, %c, %s, %p, and %%. The -
+// and 0 flags and a width up to 255 are supported. The precision is supported
+// for %f, where it is limited to kMaxFloatPrecision, and for %s. Length
+// modifiers such as l, ll, and z are accepted and ignored, since the argument
+// types are known. Integer conversions use the argument's own type, and %f
+// arguments are converted to float.
+//
+// The output differs from std::snprintf in a few ways:
+//
+//   - %p writes pointers like PointerToString: lowercase hex without 0x, or
+//     "(null)".
+//   - %f writes NaN as "NaN", like FloatToString.
+//   - If the output does not fit, as much as fits is written and the status
+//     is RESOURCE_EXHAUSTED. An argument may be cut off partway.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+// Creates a pw::string::FormatString from a string literal. The format string
+// is parsed and checked at compile time.
+#define PW_FORMAT_STRING(format_string)                        \
+  [] {                                                         \
+    struct PwFormatStringSource {                              \
+      static constexpr std::string_view value() {              \
+        return format_string;                                  \
+      }                                                        \
+    };                                                         \
+    return ::pw::string::FormatString<PwFormatStringSource>(); \
+  }()
+
+namespace pw::string {
+namespace internal {
+
+// One printf-style conversion, such as %-8s or %.3f.
+struct FormatSpec {
+  char conversion = '\0';  // '\0' if there is no conversion
+  bool left_align = false;
+  bool zero_pad = false;
+  uint8_t width = 0;
+  int16_t precision = -1;  // -1 if no precision was given
+};
+
+// Literal text followed by an optional conversion.
+struct FormatSegment {
+  std::string_view text;
+  FormatSpec spec;
+};
+
+// Calling one of these functions while parsing a format string fails the
+// build, since they are not constexpr. The compiler's error message includes
+// the function's name, which describes the problem.
+void FormatStringError_IncompleteConversion();
+void FormatStringError_UnsupportedConversion();
+void FormatStringError_UnsupportedFlag();
+void FormatStringError_WidthOrPrecisionTooLarge();
+void FormatStringError_PrecisionNotSupportedForConversion();
+void FormatStringError_ZeroPadNotSupportedForConversion();
+
+constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+
+// Parses a number starting at format[index]. Advances index past it.
+constexpr int ParseNumber(std::string_view format, size_t& index, int max) {
+  int value = 0;
+  for (; index < format.size() && IsDigit(format[index]); ++index) {
+    value = value * 10 + (format[index] - '0');
+    if (value > max) {
+      FormatStringError_WidthOrPrecisionTooLarge();
+    }
+  }
+  return value;
+}
+
+// Parses the conversion after the % at format[index]. Advances index past it.
+constexpr FormatSpec ParseConversion(std::string_view format, size_t& index) {
+  FormatSpec spec;
+  index += 1;  // Skip the %.
+
+  for (; index < format.size(); ++index) {
+    if (format[index] == '-') {
+      spec.left_align = true;
+    } else if (format[index] == '0') {
+      spec.zero_pad = true;
+    } else if (format[index] == '+' || format[index] == ' ' ||
+               format[index] == '#' || format[index] == '\'') {
+      FormatStringError_UnsupportedFlag();
+    } else {
+      break;
+    }
+  }
+
+  spec.width = static_cast<uint8_t>(ParseNumber(format, index, UINT8_MAX));
+
+  if (index < format.size() && format[index] == '.') {
+    index += 1;
+    spec.precision = static_cast<int16_t>(ParseNumber(format, index, 255));
+  }
+
+  // Skip length modifiers.
+  while (index < format.size() &&
+         std::string_view("hljztL").find(format[index]) !=
+             std::string_view::npos) {
+    index += 1;
+  }
+
+  if (index == format.size()) {
+    FormatStringError_IncompleteConversion();
+  }
+
+  spec.conversion = format[index++];
+  switch (spec.conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'f':
+    case 'c':
+    case 's':
+    case 'p':
+      break;
+    default:
+      FormatStringError_UnsupportedConversion();
+  }
+
+  if (spec.precision >= 0 && spec.conversion != 'f' &&
+      spec.conversion != 's') {
+    FormatStringError_PrecisionNotSupportedForConversion();
+  }
+  if (spec.zero_pad && (spec.conversion == 'c' || spec.conversion == 's' ||
+                        spec.conversion == 'p')) {
+    FormatStringError_ZeroPadNotSupportedForConversion();
+  }
+  return spec;
+}
+
+// Splits a format string into segments and passes each one to the callback.
+// The last segment has no conversion. A %% ends a segment with a literal %.
+template <typename Callback>
+constexpr void ParseFormat(std::string_view format, Callback&& callback) {
+  size_t start = 0;
+  size_t index = 0;
+  while (index < format.size()) {
+    if (format[index] != '%') {
+      index += 1;
+    } else if (index + 1 < format.size() && format[index + 1] == '%') {
+      callback(format.substr(start, index + 1 - start), FormatSpec{});
+      index += 2;
+      start = index;
+    } else {
+      const std::string_view text = format.substr(start, index - start);
+      callback(text, ParseConversion(format, index));
+      start = index;
+    }
+  }
+  callback(format.substr(start), FormatSpec{});
+}
+
+struct FormatCounts {
+  size_t segments;
+  size_t arguments;
+};
+
+constexpr FormatCounts CountFormat(std::string_view format) {
+  FormatCounts counts{0, 0};
+  ParseFormat(format, [&counts](std::string_view, FormatSpec spec) {
+    counts.segments += 1;
+    counts.arguments += spec.conversion != '\0' ? 1 : 0;
+  });
+  return counts;
+}
+
+// A parsed format string. argument_segments holds the index of each
+// argument's segment.
+template <size_t kSegments, size_t kArguments>
+struct ParsedFormat {
+  FormatSegment segments[kSegments];
+  size_t argument_segments[kArguments + 1];  // + 1 to avoid a 0-size array
+};
+
+template <size_t kSegments, size_t kArguments>
+constexpr ParsedFormat<kSegments, kArguments> Parse(std::string_view format) {
+  ParsedFormat<kSegments, kArguments> parsed{};
+  size_t segment = 0;
+  size_t argument = 0;
+  ParseFormat(format, [&](std::string_view text, FormatSpec spec) {
+    if (spec.conversion != '\0') {
+      parsed.argument_segments[argument++] = segment;
+    }
+    parsed.segments[segment++] = FormatSegment{text, spec};
+  });
+  return parsed;
+}
+
+// Writes the converted arguments to a buffer. The conversion functions are not
+// templated, so each call site only adds the calls themselves.
+class FormatWriter {
+ public:
+  constexpr FormatWriter(std::span<char> buffer)
+      : buffer_(buffer), size_(0), status_(OkStatus()) {}
+
+  void Append(std::string_view text);
+
+  void AppendSigned(int64_t value, FormatSpec spec);
+  void AppendUnsigned(uint64_t value, FormatSpec spec);
+  void AppendFloat(float value, FormatSpec spec);
+  void AppendChar(char value, FormatSpec spec);
+  void AppendString(const char* value, FormatSpec spec);
+  void AppendString(std::string_view value, FormatSpec spec);
+  void AppendPointer(const void* value, FormatSpec spec);
+
+  // Null terminates the output and returns its size and status.
+  StatusWithSize Finish();
+
+ private:
+  void AppendFill(char fill, size_t count);
+
+  // Appends text, padded to the spec's width.
+  void AppendPadded(std::string_view text, FormatSpec spec);
+
+  std::span<char> buffer_;
+  size_t size_;
+  Status status_;
+};
+
+template <typename T>
+constexpr bool kIsInteger =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>;
+
+template <typename T>
+constexpr auto AsInteger(T value) {
+  if constexpr (std::is_enum_v<T>) {
+    return static_cast<std::underlying_type_t<T>>(value);
+  } else {
+    return value;
+  }
+}
+
+template <char kConversion, typename T>
+void FormatArgument(FormatWriter& writer, const T& value, FormatSpec spec) {
+  if constexpr (kConversion == 'd' || kConversion == 'i') {
+    static_assert(kIsInteger<T>, "%d and %i require an integer argument");
+    using Integer = decltype(AsInteger(value));
+    writer.AppendSigned(
+        static_cast<std::make_signed_t<Integer>>(AsInteger(value)), spec);
+  } else if constexpr (kConversion == 'u' || kConversion == 'x' ||
+                       kConversion == 'X') {
+    static_assert(kIsInteger<T>, "%u, %x, and %X require an integer argument");
+    using Integer = decltype(AsInteger(value));
+    writer.AppendUnsigned(
+        static_cast<std::make_unsigned_t<Integer>>(AsInteger(value)), spec);
+  } else if constexpr (kConversion == 'f') {
+    static_assert(std::is_floating_point_v<T>,
+                  "%f requires a floating point argument");
+    writer.AppendFloat(static_cast<float>(value), spec);
+  } else if constexpr (kConversion == 'c') {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                  "%c requires a character argument");
+    writer.AppendChar(static_cast<char>(value), spec);
+  } else if constexpr (kConversion == 's') {
+    if constexpr (std::is_convertible_v<const T&, const char*>) {
+      writer.AppendString(static_cast<const char*>(value), spec);
+    } else {
+      static_assert(std::is_convertible_v<const T&, std::string_view>,
+                    "%s requires a string argument");
+      writer.AppendString(std::string_view(value), spec);
+    }
+  } else {
+    static_assert(std::is_pointer_v<T> || std::is_null_pointer_v<T>,
+                  "%p requires a pointer argument");
+    writer.AppendPointer(value, spec);
+  }
+}
+
+}  // namespace internal
+
+// A format string that was parsed at compile time. Create FormatStrings with
+// the PW_FORMAT_STRING macro. Source is a class with a constexpr static
+// value() function that returns the format string.
+template <typename Source>
+class FormatString {
+ public:
+  constexpr FormatString() = default;
+
+  // Writes the formatted arguments to the buffer, which is always null
+  // terminated unless it is empty.
+  template <typename... Args>
+  static StatusWithSize Write(std::span<char> buffer, const Args&... args) {
+    static_assert(sizeof...(Args) == kCounts.arguments,
+                  "The number of arguments must match the format string");
+    internal::FormatWriter writer(buffer);
+    WriteArguments(writer, std::index_sequence_for<Args...>(), args...);
+    return writer.Finish();
+  }
+
+ private:
+  static constexpr internal::FormatCounts kCounts =
+      internal::CountFormat(Source::value());
+
+  static constexpr auto kFormat =
+      internal::Parse<kCounts.segments, kCounts.arguments>(Source::value());
+
+  // Writes the text before the argument, then the argument.
+  template <size_t kIndex, typename T>
+  static void WriteArgument(internal::FormatWriter& writer, const T& value) {
+    constexpr size_t kFirst =
+        kIndex == 0 ? 0 : kFormat.argument_segments[kIndex - 1] + 1;
+    for (size_t i = kFirst; i < kFormat.argument_segments[kIndex]; ++i) {
+      writer.Append(kFormat.segments[i].text);
+    }
+    constexpr internal::FormatSegment kSegment =
+        kFormat.segments[kFormat.argument_segments[kIndex]];
+    writer.Append(kSegment.text);
+    internal::FormatArgument<kSegment.spec.conversion>(
+        writer, value, kSegment.spec);
+  }
+
+  template <size_t... kIndices, typename... Args>
+  static void WriteArguments(internal::FormatWriter& writer,
+                             std::index_sequence<kIndices...>,
+                             const Args&... args) {
+    (WriteArgument<kIndices>(writer, args), ...);
+
+    constexpr size_t kFirst =
+        kCounts.arguments == 0
+            ? 0
+            : kFormat.argument_segments[kCounts.arguments - 1] + 1;
+    for (size_t i = kFirst; i < kCounts.segments; ++i) {
+      writer.Append(kFormat.segments[i].text);
+    }
+  }
+};
+
+}  // namespace pw::string
@@ -25,6 +25,7 @@
 #include "pw_preprocessor/compiler.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_string/format_string.h"
 #include "pw_string/to_string.h"
 
 namespace pw {
@@ -228,6 +229,32 @@ class StringBuilder {
   // Internally, calls string::Format, which calls std::vsnprintf.
   StringBuilder& FormatVaList(const char* format, va_list args);
 
+  // Appends a format string that was parsed at compile time with
+  // PW_FORMAT_STRING. Mistakes in the format string or arguments fail the
+  // build, and std::vsnprintf is not called. If the formatted string does not
+  // fit, the results are truncated and the status is set to RESOURCE_EXHAUSTED.
+  //
+  //   sb.Format(PW_FORMAT_STRING("%s=%u"), name, value);
+  //
+  template <typename Source, typename... Args>
+  StringBuilder& Format(string::FormatString<Source> format,
+                        const Args&... args) {
+    HandleStatusWithSize(format.Write(buffer_.subspan(size_), args...));
+    return *this;
+  }
+
+  // Appends a float with the given number of digits after the decimal point,
+  // like Format("%.*f", precision, value). Uses string::FloatToString instead
+  // of std::vsnprintf, which is several times faster and does not require
+  // libc's printf. The precision is clamped to string::kMaxFloatPrecision.
+  // Unlike Format, the number is never truncated; if it does not fit, nothing
+  // is appended and the status is set to RESOURCE_EXHAUSTED.
+  StringBuilder& FormatFloat(float value, uint_fast8_t precision = 6) {
+    HandleStatusWithSize(
+        string::FloatToString(value, buffer_.subspan(size_), precision));
+    return *this;
+  }
+
   // Sets the StringBuilder's size. This function only truncates; if
   // new_size > size(), it sets status to OUT_OF_RANGE and does nothing.
   void resize(size_t new_size);
@@ -98,6 +98,28 @@ StatusWithSize IntToHexString(uint64_t value,
 //
 StatusWithSize FloatAsIntToString(float value, std::span<char> buffer);
 
+// The maximum number of digits FloatToString writes after the decimal point.
+inline constexpr uint_fast8_t kMaxFloatPrecision = 9;
+
+// Writes a floating point number with a fixed number of digits after the
+// decimal point, like std::snprintf's "%.*f", but without calling snprintf.
+// The output is exact and correctly rounded. Precisions larger than
+// kMaxFloatPrecision are clamped to kMaxFloatPrecision. Infinity and NaN are
+// written as with FloatAsIntToString.
+//
+// Numbers are never truncated; if the entire number does not fit, only a null
+// terminator is written and the status is RESOURCE_EXHAUSTED.
+//
+// Examples:
+//
+//   FloatToString(1.25, buffer, 1)     -> writes "1.2" to the buffer
+//   FloatToString(-4.9, buffer, 3)     -> writes "-4.900" to the buffer
+//   FloatToString(3.5e20, buffer, 0)   -> writes "350000000000000000000"
+//
+StatusWithSize FloatToString(float value,
+                             std::span<char> buffer,
+                             uint_fast8_t precision = 6);
+
 // Writes a bool as "true" or "false". Semantics match CopyEntireString.
 StatusWithSize BoolToString(bool value, std::span<char> buffer);
 
@@ -301,6 +301,22 @@ TEST(StringBuilder, Format_ExhaustBuffer) {
   EXPECT_EQ(Status::ResourceExhausted(), sb.status());
 }
 
+TEST(StringBuilder, FormatFloat) {
+  StringBuffer<32> sb;
+  sb << "t=";
+  EXPECT_TRUE(sb.FormatFloat(-21.0625f, 3).ok());
+  sb << " v=";
+  EXPECT_TRUE(sb.FormatFloat(3.3f).ok());
+  EXPECT_STREQ("t=-21.062 v=3.300000", sb.data());
+}
+
+TEST(StringBuilder, FormatFloat_ExhaustBuffer_AppendsNothing) {
+  StringBuffer<6> sb;
+  sb << "x=";
+  EXPECT_EQ(Status::ResourceExhausted(), sb.FormatFloat(1.5f, 2).status());
+  EXPECT_STREQ("x=", sb.data());
+}
+
 TEST(StringBuilder, StreamOutput_MultipleTypes) {
   constexpr const char* kExpected = "This is -1true example\n of this";
   constexpr const char* kExample = "example";
@@ -14,6 +14,8 @@
 
 #include "pw_string/type_to_string.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -47,6 +49,18 @@ constexpr std::array<uint64_t, 20> kPowersOf10{
     10000000000000000000ull,  // 10^19
 };
 
+// The decimal digits of 0 through 99. Writing two digits per division halves
+// the number of divisions, which are slow on many microcontrollers.
+constexpr char kDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+constexpr uint32_t kMaxUint32PowerOf10 = 1'000'000'000;
+constexpr uint_fast8_t kMaxUint32PowerOf10Exponent = 9;
+
 StatusWithSize HandleExhaustedBuffer(std::span<char> buffer) {
   if (!buffer.empty()) {
     buffer[0] = '\0';
@@ -54,6 +68,75 @@ StatusWithSize HandleExhaustedBuffer(std::span<char> buffer) {
   return StatusWithSize::ResourceExhausted();
 }
 
+// Writes exactly digit_count digits of value, with leading 0s, ending just
+// before end.
+void WriteDigits(uint32_t value, char* end, uint_fast8_t digit_count) {
+  for (; digit_count >= 2u; digit_count -= 2u) {
+    const char* pair = &kDigitPairs[2 * (value % 100)];
+    *--end = pair[1];
+    *--end = pair[0];
+    value /= 100;
+  }
+  if (digit_count != 0u) {
+    *--end = static_cast<char>('0' + value % 10);
+  }
+}
+
+// Writes "inf" or "NaN", with a leading - if the sign bit is set.
+StatusWithSize InfOrNanToString(float value, std::span<char> buffer) {
+  if (const size_t written = 3 + std::signbit(value); written < buffer.size()) {
+    char* out = buffer.data();
+    if (std::signbit(value)) {
+      *out++ = '-';
+    }
+    std::memcpy(out, std::isnan(value) ? "NaN" : "inf", sizeof("NaN"));
+    return StatusWithSize(written);
+  }
+
+  return HandleExhaustedBuffer(buffer);
+}
+
+// Writes the integer part of a float too large to scale into a uint64_t. These
+// floats are whole numbers up to 2^128, so shift the 24-bit mantissa into a
+// 128-bit integer and print it in 9-digit chunks. Returns the digit count.
+size_t LargeFloatToDigits(float value, char* out) {
+  int exponent;
+  const float fraction = std::frexp(value, &exponent);
+  const uint64_t mantissa = static_cast<uint64_t>(std::ldexp(fraction, 24));
+  const int shift = exponent - 24;
+
+  std::array<uint32_t, 4> words{};  // Least significant word first.
+  const uint64_t shifted = mantissa << (shift % 32);
+  words[shift / 32] = static_cast<uint32_t>(shifted);
+  if (shift / 32 + 1 < static_cast<int>(words.size())) {
+    words[shift / 32 + 1] = static_cast<uint32_t>(shifted >> 32);
+  }
+
+  // 2^128 has 39 digits, which fit in 5 chunks.
+  std::array<uint32_t, 5> chunks;
+  size_t chunk_count = 0;
+  while (std::any_of(
+      words.begin(), words.end(), [](uint32_t word) { return word != 0u; })) {
+    uint64_t remainder = 0;
+    for (size_t i = words.size(); i > 0; --i) {
+      remainder = remainder << 32 | words[i - 1];
+      words[i - 1] = static_cast<uint32_t>(remainder / kMaxUint32PowerOf10);
+      remainder %= kMaxUint32PowerOf10;
+    }
+    chunks[chunk_count++] = static_cast<uint32_t>(remainder);
+  }
+
+  const uint_fast8_t leading_digits = DecimalDigitCount(chunks[--chunk_count]);
+  size_t written = leading_digits;
+  WriteDigits(chunks[chunk_count], out + written, leading_digits);
+  while (chunk_count > 0u) {
+    written += kMaxUint32PowerOf10Exponent;
+    WriteDigits(
+        chunks[--chunk_count], out + written, kMaxUint32PowerOf10Exponent);
+  }
+  return written;
+}
+
 }  // namespace
 
 uint_fast8_t DecimalDigitCount(uint64_t integer) {
@@ -73,10 +156,6 @@ uint_fast8_t DecimalDigitCount(uint64_t integer) {
 // think std::to_chars will be faster, so I kept this implementation for now.
 template <>
 StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
-  constexpr uint32_t base = 10;
-  constexpr uint32_t max_uint32_base_power = 1'000'000'000;
-  constexpr uint_fast8_t max_uint32_base_power_exponent = 9;
-
   const uint_fast8_t total_digits = DecimalDigitCount(value);
 
   if (total_digits >= buffer.size()) {
@@ -85,28 +164,17 @@ StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
 
   buffer[total_digits] = '\0';
 
+  // 64-bit division is slow on 32-bit platforms, so print large numbers in
+  // 32-bit chunks to minimize the number of 64-bit divisions.
   uint_fast8_t remaining = total_digits;
-  while (remaining > 0u) {
-    uint32_t lower_digits;     // the value of the lower digits to write
-    uint_fast8_t digit_count;  // the number of lower digits to write
-
-    // 64-bit division is slow on 32-bit platforms, so print large numbers in
-    // 32-bit chunks to minimize the number of 64-bit divisions.
-    if (value <= std::numeric_limits<uint32_t>::max()) {
-      lower_digits = value;
-      digit_count = remaining;
-    } else {
-      lower_digits = value % max_uint32_base_power;
-      digit_count = max_uint32_base_power_exponent;
-      value /= max_uint32_base_power;
-    }
-
-    // Write the specified number of digits, with leading 0s.
-    for (uint_fast8_t i = 0; i < digit_count; ++i) {
-      buffer[--remaining] = lower_digits % base + '0';
-      lower_digits /= base;
-    }
+  while (value > std::numeric_limits<uint32_t>::max()) {
+    remaining -= kMaxUint32PowerOf10Exponent;
+    WriteDigits(value % kMaxUint32PowerOf10,
+                &buffer[remaining + kMaxUint32PowerOf10Exponent],
+                kMaxUint32PowerOf10Exponent);
+    value /= kMaxUint32PowerOf10;
   }
+  WriteDigits(static_cast<uint32_t>(value), &buffer[remaining], remaining);
   return StatusWithSize(total_digits);
 }
 
@@ -158,16 +226,55 @@ StatusWithSize FloatAsIntToString(float value, std::span<char> buffer) {
   }
 
   // Otherwise, print inf or NaN, if they fit.
-  if (const size_t written = 3 + std::signbit(value); written < buffer.size()) {
-    char* out = buffer.data();
-    if (std::signbit(value)) {
-      *out++ = '-';
-    }
-    std::memcpy(out, std::isnan(value) ? "NaN" : "inf", sizeof("NaN"));
-    return StatusWithSize(written);
+  return InfOrNanToString(value, buffer);
+}
+
+StatusWithSize FloatToString(float value,
+                             std::span<char> buffer,
+                             uint_fast8_t precision) {
+  if (!std::isfinite(value)) {
+    return InfOrNanToString(value, buffer);
   }
 
-  return HandleExhaustedBuffer(buffer);
+  precision = std::min(precision, kMaxFloatPrecision);
+  const uint32_t scale =
+      precision == 0u ? 1u : static_cast<uint32_t>(kPowersOf10[precision]);
+
+  // A float's 24-bit mantissa times 5^9 fits in a double's 53-bit mantissa, so
+  // scaling by the power of 10 is exact and rounding matches printf's "%.*f".
+  const double scaled = std::abs(static_cast<double>(value)) * scale;
+
+  // Sign, up to 39 integer digits, the decimal point, and the fraction.
+  std::array<char, 1 + 39 + 1 + kMaxFloatPrecision> digits;
+  char* out = digits.data();
+  if (std::signbit(value)) {
+    *out++ = '-';
+  }
+
+  uint32_t fraction = 0;
+  if (scaled < 18446744073709551616.0) {  // 2^64
+    const uint64_t rounded = static_cast<uint64_t>(std::nearbyint(scaled));
+    fraction = rounded % scale;
+    out += IntToString<uint64_t>(rounded / scale,
+                                 std::span(out, digits.end()))
+               .size();
+  } else {
+    out += LargeFloatToDigits(std::abs(value), out);
+  }
+
+  if (precision != 0u) {
+    *out++ = '.';
+    out += precision;
+    WriteDigits(fraction, out, precision);
+  }
+
+  const size_t written = out - digits.data();
+  if (written >= buffer.size()) {
+    return HandleExhaustedBuffer(buffer);
+  }
+  std::memcpy(buffer.data(), digits.data(), written);
+  buffer[written] = '\0';
+  return StatusWithSize(written);
 }
 
 StatusWithSize BoolToString(bool value, std::span<char> buffer) {
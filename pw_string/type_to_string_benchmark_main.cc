@@ -0,0 +1,101 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how fast IntToString and FloatToString write numbers compared to
+// std::snprintf, and logs the results.
+
+#define PW_LOG_MODULE_NAME "STRING"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_string/type_to_string.h"
+
+namespace {
+
+using pw::chrono::SystemClock;
+
+constexpr size_t kValueCount = 1024;
+constexpr size_t kIterations = 64;
+
+std::array<uint32_t, kValueCount> integers;
+std::array<float, kValueCount> floats;
+std::array<char, 32> buffer;
+
+// Keeps the compiler from discarding the results.
+volatile size_t result_sink;
+
+template <typename Function>
+void Run(const char* name, Function&& function) {
+  const SystemClock::time_point start = SystemClock::now();
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < kValueCount; ++j) {
+      result_sink = function(j);
+    }
+  }
+  const SystemClock::duration elapsed = SystemClock::now() - start;
+
+  const uint64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (ns == 0u) {
+    PW_LOG_ERROR("%s: the system clock is too coarse to time one run", name);
+    return;
+  }
+
+  const uint64_t count = uint64_t(kValueCount) * kIterations;
+  PW_LOG_INFO("%-24s %8u ns per 1000 values",
+              name,
+              static_cast<unsigned>(ns * 1000u / count));
+}
+
+}  // namespace
+
+int main() {
+  uint32_t value = 1;
+  for (size_t i = 0; i < kValueCount; ++i) {
+    value = value * 1664525u + 1013904223u;
+    integers[i] = value >> (i % 32);
+    floats[i] = static_cast<float>(static_cast<int32_t>(value)) / 4096.f;
+  }
+
+  PW_LOG_INFO("Writing %u values, %u times",
+              static_cast<unsigned>(kValueCount),
+              static_cast<unsigned>(kIterations));
+
+  Run("snprintf %u", [](size_t i) {
+    return std::snprintf(buffer.data(),
+                         buffer.size(),
+                         "%u",
+                         static_cast<unsigned>(integers[i]));
+  });
+  Run("IntToString", [](size_t i) {
+    return pw::string::IntToString(integers[i], buffer).size();
+  });
+  Run("snprintf %.3f", [](size_t i) {
+    return std::snprintf(buffer.data(),
+                         buffer.size(),
+                         "%.3f",
+                         static_cast<double>(floats[i]));
+  });
+  Run("FloatToString", [](size_t i) {
+    return pw::string::FloatToString(floats[i], buffer, 3).size();
+  });
+
+  return 0;
+}
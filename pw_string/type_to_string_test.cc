@@ -15,6 +15,7 @@
 #include "pw_string/type_to_string.h"
 
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <limits>
 #include <string_view>
@@ -255,6 +256,21 @@ TEST(IntToString, SignedSweep) {
   }
 }
 
+TEST(IntToString, LargeValues_MatchSnprintf) {
+  uint64_t value = 1;
+  for (int i = 0; i < 1000; ++i) {
+    char buffer[21];
+    char printf_buffer[21];
+    std::snprintf(printf_buffer,
+                  sizeof(printf_buffer),
+                  "%llu",
+                  static_cast<unsigned long long>(value));
+    ASSERT_TRUE(IntToString(value, buffer).ok());
+    ASSERT_STREQ(printf_buffer, buffer);
+    value = value * 6364136223846793005u + 1442695040888963407u;
+  }
+}
+
 TEST(IntToString, UnsignedSweep) {
   for (unsigned i = 0; i <= 1002u; ++i) {
     char buffer[5];
@@ -407,6 +423,100 @@ TEST_F(FloatAsIntToStringTest, TooSmall_NaN_NullTerminates) {
   EXPECT_STREQ("", buffer_);
 }
 
+class FloatToStringTest : public TestWithBuffer {
+ protected:
+  // Checks that FloatToString matches snprintf's "%.*f" for the value.
+  static void ExpectMatchesSnprintf(float value, uint_fast8_t precision) {
+    char buffer[64];
+    char printf_buffer[64];
+    const int written = std::snprintf(printf_buffer,
+                                      sizeof(printf_buffer),
+                                      "%.*f",
+                                      static_cast<int>(precision),
+                                      static_cast<double>(value));
+    const StatusWithSize result = FloatToString(value, buffer, precision);
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(static_cast<size_t>(written), result.size());
+    ASSERT_STREQ(printf_buffer, buffer);
+  }
+};
+
+TEST_F(FloatToStringTest, DefaultPrecision) {
+  EXPECT_EQ(8u, FloatToString(3.25f, buffer_).size());
+  EXPECT_STREQ("3.250000", buffer_);
+}
+
+TEST_F(FloatToStringTest, ZeroPrecision_NoDecimalPoint) {
+  EXPECT_EQ(2u, FloatToString(-7.f, buffer_, 0).size());
+  EXPECT_STREQ("-7", buffer_);
+}
+
+TEST_F(FloatToStringTest, NegativeZero_KeepsSign) {
+  EXPECT_EQ(5u, FloatToString(-0.f, buffer_, 2).size());
+  EXPECT_STREQ("-0.00", buffer_);
+}
+
+TEST_F(FloatToStringTest, Tie_RoundsToEven) {
+  EXPECT_EQ(3u, FloatToString(1.25f, buffer_, 1).size());
+  EXPECT_STREQ("1.2", buffer_);
+  EXPECT_EQ(3u, FloatToString(1.75f, buffer_, 1).size());
+  EXPECT_STREQ("1.8", buffer_);
+}
+
+TEST_F(FloatToStringTest, PrecisionIsClamped) {
+  EXPECT_EQ(11u, FloatToString(0.5f, buffer_, 20).size());
+  EXPECT_STREQ("0.500000000", buffer_);
+}
+
+TEST_F(FloatToStringTest, InfinityAndNan) {
+  EXPECT_EQ(4u, FloatToString(-INFINITY, buffer_).size());
+  EXPECT_STREQ("-inf", buffer_);
+  EXPECT_EQ(3u, FloatToString(NAN, buffer_).size());
+  EXPECT_STREQ("NaN", buffer_);
+}
+
+TEST_F(FloatToStringTest, TooSmall_NullTerminates) {
+  auto result = FloatToString(12.5f, std::span(buffer_, 4), 1);
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_STREQ("", buffer_);
+}
+
+TEST_F(FloatToStringTest, FitsExactly) {
+  auto result = FloatToString(12.5f, std::span(buffer_, 5), 1);
+  EXPECT_EQ(4u, result.size());
+  EXPECT_TRUE(result.ok());
+  EXPECT_STREQ("12.5", buffer_);
+}
+
+TEST_F(FloatToStringTest, Extremes_MatchSnprintf) {
+  for (float value : {std::numeric_limits<float>::max(),
+                      std::numeric_limits<float>::lowest(),
+                      std::numeric_limits<float>::min(),
+                      std::numeric_limits<float>::denorm_min(),
+                      1.8446744e19f,
+                      4294967296.f,
+                      16777217.f}) {
+    for (uint_fast8_t precision = 0; precision <= kMaxFloatPrecision;
+         ++precision) {
+      ExpectMatchesSnprintf(value, precision);
+    }
+  }
+}
+
+TEST_F(FloatToStringTest, Sweep_MatchesSnprintf) {
+  uint32_t bits = 1;
+  for (int i = 0; i < 5000; ++i) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    bits = bits * 1664525u + 1013904223u;
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    ExpectMatchesSnprintf(value, i % (kMaxFloatPrecision + 1));
+  }
+}
+
 class CopyStringOrNullTest : public TestWithBuffer {};
 
 using namespace std::literals::string_view_literals;
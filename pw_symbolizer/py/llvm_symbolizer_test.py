@@ -40,6 +40,16 @@ class TestSymbolizer(unittest.TestCase):
                 self.assertEqual(result.file, _CPP_TEST_FILE_NAME)
                 self.assertEqual(result.line, expected_symbol['Line'])
 
+    def _test_batch_symbolization_results(self, expected_symbols,
+                                          symbolizer):
+        addresses = [symbol['Address'] for symbol in expected_symbols]
+        results = symbolizer.symbolize_all(addresses + addresses)
+        self.assertEqual(len(results), 2 * len(expected_symbols))
+
+        for i, expected_symbol in enumerate(expected_symbols * 2):
+            self.assertEqual(results[i].name, expected_symbol['Expected'])
+            self.assertEqual(results[i].address, expected_symbol['Address'])
+
     def test_symbolization(self):
         """Tests that the symbolizer can symbolize addresses properly."""
         with tempfile.TemporaryDirectory() as exe_dir:
@@ -76,6 +86,20 @@ class TestSymbolizer(unittest.TestCase):
             symbolizer = pw_symbolizer.LlvmSymbolizer(exe_file)
             self._test_symbolization_results(expected_symbols, symbolizer)
 
+            symbolizer = pw_symbolizer.LlvmSymbolizer(exe_file)
+            self._test_batch_symbolization_results(expected_symbols,
+                                                   symbolizer)
+
+            # Symbols are reloaded from the cache for the same build.
+            cache_dir = Path(exe_dir) / 'cache'
+            symbolizer = pw_symbolizer.LlvmSymbolizer(exe_file,
+                                                      cache_dir=cache_dir)
+            self._test_batch_symbolization_results(expected_symbols,
+                                                   symbolizer)
+            symbolizer = pw_symbolizer.LlvmSymbolizer(exe_file,
+                                                      cache_dir=cache_dir)
+            self._test_symbolization_results(expected_symbols, symbolizer)
+
             # Test backwards compatibility with older versions of
             # llvm-symbolizer.
             symbolizer = pw_symbolizer.LlvmSymbolizer(exe_file,
@@ -17,16 +17,30 @@ import shutil
 import subprocess
 import threading
 import json
-from typing import Optional, Tuple
+from typing import Dict, Iterable, List, Optional, Tuple
 from pathlib import Path
 from pw_symbolizer import symbolizer
 
+# The number of addresses sent to llvm-symbolizer before reading any of the
+# results. Writing too many at once could fill the output pipe and deadlock.
+_BATCH_SIZE = 128
+
 
 class LlvmSymbolizer(symbolizer.Symbolizer):
-    """A symbolizer that wraps llvm-symbolizer."""
-    def __init__(self, binary: Optional[Path] = None, force_legacy=False):
+    """A symbolizer that wraps llvm-symbolizer.
+
+    Symbolized addresses are cached. If cache_dir is provided, the cache is
+    also saved to a file in that directory named after the binary's GNU build
+    ID, and is reused by later LlvmSymbolizers for the same build.
+    """
+    def __init__(self,
+                 binary: Optional[Path] = None,
+                 force_legacy=False,
+                 cache_dir: Optional[Path] = None):
         # Lets destructor return cleanly if the binary is not found.
         self._symbolizer = None
+        self._cache: Dict[int, symbolizer.Symbol] = {}
+        self._cache_file: Optional[Path] = None
         if shutil.which('llvm-symbolizer') is None:
             raise FileNotFoundError(
                 'llvm-symbolizer not installed. Run bootstrap, or download '
@@ -59,10 +73,48 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
 
             self._lock: threading.Lock = threading.Lock()
 
+            if cache_dir is not None:
+                self._load_cache(binary, cache_dir)
+
     def __del__(self):
         if self._symbolizer:
             self._symbolizer.terminate()
 
+    def _load_cache(self, binary: Path, cache_dir: Path) -> None:
+        """Loads the persistent cache for the binary's build, if any."""
+        # pylint: disable=import-outside-toplevel
+        from pw_build_info import build_id
+
+        with binary.open('rb') as elf_file:
+            binary_build_id = build_id.read_build_id(elf_file)
+
+        # Without a build ID, there's no way to tell if a cache is stale.
+        if binary_build_id is None:
+            return
+
+        self._cache_file = cache_dir / f'{binary_build_id.hex()}.json'
+        if not self._cache_file.exists():
+            return
+
+        with self._cache_file.open() as cache:
+            for address, (name, file, line) in json.load(cache).items():
+                self._cache[int(address, 16)] = symbolizer.Symbol(
+                    int(address, 16), name, file, line)
+
+    def _save_cache(self) -> None:
+        """Writes the cache to its file, replacing any previous cache."""
+        assert self._cache_file is not None
+        self._cache_file.parent.mkdir(parents=True, exist_ok=True)
+
+        temp_file = self._cache_file.with_suffix('.tmp')
+        with temp_file.open('w') as cache:
+            json.dump(
+                {
+                    f'0x{address:08X}': (sym.name, sym.file, sym.line)
+                    for address, sym in self._cache.items()
+                }, cache)
+        temp_file.replace(self._cache_file)
+
     @staticmethod
     def _is_json_compatibile() -> bool:
         """Checks llvm-symbolizer to ensure compatibility"""
@@ -132,23 +184,56 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
 
     def symbolize(self, address: int) -> symbolizer.Symbol:
         """Symbolizes an address using the loaded ELF file."""
+        return self.symbolize_all((address, ))[0]
+
+    def symbolize_all(self,
+                      addresses: Iterable[int]) -> List[symbolizer.Symbol]:
+        """Symbolizes addresses using the loaded ELF file.
+
+        Each unique address that is not already cached is sent to
+        llvm-symbolizer once, in batches, rather than waiting for each result
+        before sending the next address.
+        """
+        address_list = list(addresses)
         if not self._symbolizer:
-            return symbolizer.Symbol(address=address, name='', file='', line=0)
+            return [
+                symbolizer.Symbol(address=address, name='', file='', line=0)
+                for address in address_list
+            ]
 
         with self._lock:
-            if self._symbolizer.returncode is not None:
-                raise ValueError('llvm-symbolizer closed unexpectedly')
+            unknown = list(
+                dict.fromkeys(address for address in address_list
+                              if address not in self._cache))
 
-            stdin = self._symbolizer.stdin
-            stdout = self._symbolizer.stdout
+            for start in range(0, len(unknown), _BATCH_SIZE):
+                self._symbolize_batch(unknown[start:start + _BATCH_SIZE])
 
-            assert stdin is not None
-            assert stdout is not None
+            if unknown and self._cache_file is not None:
+                self._save_cache()
 
-            stdin.write(f'0x{address:08X}\n'.encode())
-            stdin.flush()
+            return [self._cache[address] for address in address_list]
 
-            if self._json_mode:
-                return LlvmSymbolizer._read_json_symbol(address, stdout)
+    def _symbolize_batch(self, addresses: List[int]) -> None:
+        """Sends addresses to llvm-symbolizer and caches the results."""
+        assert self._symbolizer is not None
+        if self._symbolizer.returncode is not None:
+            raise ValueError('llvm-symbolizer closed unexpectedly')
+
+        stdin = self._symbolizer.stdin
+        stdout = self._symbolizer.stdout
+
+        assert stdin is not None
+        assert stdout is not None
 
-            return LlvmSymbolizer._read_llvm_symbol(address, stdout)
+        stdin.write(''.join(f'0x{address:08X}\n'
+                            for address in addresses).encode())
+        stdin.flush()
+
+        # llvm-symbolizer answers in the order the addresses were sent.
+        for address in addresses:
+            if self._json_mode:
+                symbol = LlvmSymbolizer._read_json_symbol(address, stdout)
+            else:
+                symbol = LlvmSymbolizer._read_llvm_symbol(address, stdout)
+            self._cache[address] = symbol
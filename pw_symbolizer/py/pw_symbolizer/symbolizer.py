@@ -14,7 +14,7 @@
 """Utilities for address symbolization."""
 
 import abc
-from typing import Iterable, List
+from typing import Dict, Iterable, List
 from dataclasses import dataclass
 
 
@@ -55,6 +55,20 @@ class Symbolizer(abc.ABC):
     def symbolize(self, address: int) -> Symbol:
         """Symbolizes an address using a loaded binary or symbol database."""
 
+    def symbolize_all(self, addresses: Iterable[int]) -> List[Symbol]:
+        """Symbolizes a sequence of addresses, in order.
+
+        Each unique address is only symbolized once. Implementations may
+        override this to resolve all of the unique addresses in a single pass.
+        """
+        address_list = list(addresses)
+        symbols: Dict[int, Symbol] = {}
+        for address in address_list:
+            if address not in symbols:
+                symbols[address] = self.symbolize(address)
+
+        return [symbols[address] for address in address_list]
+
     def dump_stack_trace(self,
                          addresses,
                          most_recent_first: bool = True) -> str:
@@ -69,10 +83,10 @@ class Symbolizer(abc.ABC):
         stack_trace: List[str] = []
         stack_trace.append(f'Stack Trace (most recent call {order}):')
 
-        max_width = len(str(len(addresses)))
-        for i, address in enumerate(addresses):
+        symbols = self.symbolize_all(addresses)
+        max_width = len(str(len(symbols)))
+        for i, symbol in enumerate(symbols):
             depth = i + 1
-            symbol = self.symbolize(address)
 
             if symbol.name:
                 sym_desc = f'{symbol.name} (0x{symbol.address:08X})'
@@ -80,6 +80,33 @@ class TestFakeSymbolizer(unittest.TestCase):
         self.assertEqual(symbol.file, 'source/globals.cc')
         self.assertEqual(symbol.line, 21)
 
+    def test_symbolize_all(self):
+        known_symbols = (
+            pw_symbolizer.Symbol(0x404, 'do_a_flip(int n)', 'source/tricks.cc',
+                                 1403),
+            pw_symbolizer.Symbol(0x808, 'land_it()', 'source/tricks.cc', 1410),
+        )
+
+        class CountingSymbolizer(pw_symbolizer.FakeSymbolizer):
+            def __init__(self):
+                super().__init__(known_symbols)
+                self.lookups = 0
+
+            def symbolize(self, address: int) -> pw_symbolizer.Symbol:
+                self.lookups += 1
+                return super().symbolize(address)
+
+        symbolizer = CountingSymbolizer()
+        symbols = symbolizer.symbolize_all(
+            iter((0x404, 0x808, 0x404, 0x111, 0x404)))
+
+        self.assertEqual([sym.address for sym in symbols],
+                         [0x404, 0x808, 0x404, 0x111, 0x404])
+        self.assertEqual(symbols[0].name, 'do_a_flip(int n)')
+        self.assertEqual(symbols[1].name, 'land_it()')
+        self.assertEqual(symbols[3].name, '')
+        self.assertEqual(symbolizer.lookups, 3)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,41 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/adaptive_mutex.h"
+
+#include "pw_sync/yield_core.h"
+
+namespace pw::sync {
+
+void AdaptiveMutex::lock() {
+  if (mutex_.try_lock()) {
+    return;
+  }
+
+  // The metrics are updated after acquiring the mutex, which guards them.
+  for (uint32_t i = 0; i < spin_count_; ++i) {
+    PW_SYNC_YIELD_CORE_FOR_SMT();
+    if (mutex_.try_lock()) {
+      contended_.Increment();
+      spin_acquired_.Increment();
+      return;
+    }
+  }
+
+  mutex_.lock();
+  contended_.Increment();
+  blocked_.Increment();
+}
+
+}  // namespace pw::sync
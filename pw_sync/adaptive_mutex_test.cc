@@ -0,0 +1,82 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/adaptive_mutex.h"
+
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+namespace pw::sync {
+namespace {
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(AdaptiveMutex, LockUnlock) {
+  AdaptiveMutex mutex;
+  mutex.lock();
+  mutex.unlock();
+}
+
+AdaptiveMutex static_mutex;
+TEST(AdaptiveMutex, LockUnlockStatic) {
+  static_mutex.lock();
+  static_mutex.unlock();
+}
+
+TEST(AdaptiveMutex, TryLockUnlock) {
+  AdaptiveMutex mutex;
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+}
+
+TEST(AdaptiveMutex, LockGuard) {
+  AdaptiveMutex mutex;
+  {
+    std::lock_guard lock(mutex);
+  }
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(AdaptiveMutex, SpinCount) {
+  AdaptiveMutex default_mutex;
+  EXPECT_EQ(default_mutex.spin_count(), AdaptiveMutex::kDefaultSpinCount);
+
+  AdaptiveMutex block_immediately(0);
+  EXPECT_EQ(block_immediately.spin_count(), 0u);
+  block_immediately.lock();
+  block_immediately.unlock();
+}
+
+TEST(AdaptiveMutex, UncontendedLockIsNotCounted) {
+  AdaptiveMutex mutex;
+  for (int i = 0; i < 3; ++i) {
+    mutex.lock();
+    mutex.unlock();
+  }
+
+  size_t metric_count = 0;
+  for (const metric::Metric& metric : mutex.metrics().metrics()) {
+    EXPECT_EQ(metric.as_int(), 0u);
+    metric_count += 1;
+  }
+  EXPECT_EQ(metric_count, 3u);
+}
+
+}  // namespace
+}  // namespace pw::sync
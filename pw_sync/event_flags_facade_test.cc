@@ -0,0 +1,164 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/event_flags.h"
+
+using pw::chrono::SystemClock;
+using namespace std::chrono_literals;
+
+namespace pw::sync {
+namespace {
+
+// We can't control the SystemClock's period configuration, so just in case
+// duration cannot be accurately expressed in integer ticks, round the
+// duration up.
+constexpr SystemClock::duration kRoundedArbitraryDuration =
+    SystemClock::for_at_least(42ms);
+
+constexpr EventFlags::Flags kRx = 1u << 0;
+constexpr EventFlags::Flags kTx = 1u << 1;
+constexpr EventFlags::Flags kStop = 1u << 23;
+
+TEST(EventFlags, EmptyInitialState) {
+  EventFlags flags;
+  EXPECT_EQ(flags.get(), 0u);
+  EXPECT_EQ(flags.try_wait_any_for(kRx | kTx, SystemClock::duration::zero()),
+            0u);
+}
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(EventFlags, SetAndClear) {
+  EventFlags flags;
+  flags.set(kRx);
+  flags.set(kStop);
+  EXPECT_EQ(flags.get(), kRx | kStop);
+  flags.clear(kRx);
+  EXPECT_EQ(flags.get(), kStop);
+}
+
+TEST(EventFlags, WaitAnyReturnsAndClearsSetFlags) {
+  EventFlags flags;
+  flags.set(kRx | kStop);
+  EXPECT_EQ(flags.wait_any(kRx | kTx), kRx);
+  // Only the flags that were waited for are cleared.
+  EXPECT_EQ(flags.get(), kStop);
+}
+
+TEST(EventFlags, WaitAllReturnsAndClearsSetFlags) {
+  EventFlags flags;
+  flags.set(kRx | kTx | kStop);
+  EXPECT_EQ(flags.wait_all(kRx | kTx), kRx | kTx);
+  EXPECT_EQ(flags.get(), kStop);
+}
+
+EventFlags static_flags;
+TEST(EventFlags, WaitAnyStatic) {
+  EXPECT_EQ(static_flags.get(), 0u);
+  static_flags.set(kTx);
+  EXPECT_EQ(static_flags.wait_any(kTx), kTx);
+  EXPECT_EQ(static_flags.get(), 0u);
+}
+
+TEST(EventFlags, TryWaitAnyForSet) {
+  EventFlags flags;
+  flags.set(kTx);
+
+  // Ensure it doesn't block and succeeds when a flag is set.
+  SystemClock::time_point before = SystemClock::now();
+  EXPECT_EQ(flags.try_wait_any_for(kRx | kTx, kRoundedArbitraryDuration), kTx);
+  SystemClock::duration time_elapsed = SystemClock::now() - before;
+  EXPECT_LT(time_elapsed, kRoundedArbitraryDuration);
+  EXPECT_EQ(flags.get(), 0u);
+}
+
+TEST(EventFlags, TryWaitAnyForNotSetPositiveTimeout) {
+  EventFlags flags;
+  flags.set(kStop);
+
+  // Ensure it blocks and fails when none of the flags are set.
+  SystemClock::time_point before = SystemClock::now();
+  EXPECT_EQ(flags.try_wait_any_for(kRx | kTx, kRoundedArbitraryDuration), 0u);
+  SystemClock::duration time_elapsed = SystemClock::now() - before;
+  EXPECT_GE(time_elapsed, kRoundedArbitraryDuration);
+  EXPECT_EQ(flags.get(), kStop);
+}
+
+TEST(EventFlags, TryWaitAllForPartiallySetZeroLengthTimeout) {
+  EventFlags flags;
+  flags.set(kRx);
+
+  // Ensure it doesn't block when a zero length duration is used, and that the
+  // flags which were set are left alone.
+  SystemClock::time_point before = SystemClock::now();
+  EXPECT_EQ(flags.try_wait_all_for(kRx | kTx, SystemClock::duration::zero()),
+            0u);
+  SystemClock::duration time_elapsed = SystemClock::now() - before;
+  EXPECT_LT(time_elapsed, kRoundedArbitraryDuration);
+  EXPECT_EQ(flags.get(), kRx);
+}
+
+TEST(EventFlags, TryWaitAllForPartiallySetNegativeTimeout) {
+  EventFlags flags;
+  flags.set(kRx);
+
+  // Ensure it doesn't block when a negative duration is used.
+  SystemClock::time_point before = SystemClock::now();
+  EXPECT_EQ(flags.try_wait_all_for(kRx | kTx, -kRoundedArbitraryDuration), 0u);
+  SystemClock::duration time_elapsed = SystemClock::now() - before;
+  EXPECT_LT(time_elapsed, kRoundedArbitraryDuration);
+  EXPECT_EQ(flags.get(), kRx);
+}
+
+TEST(EventFlags, TryWaitAllUntilSet) {
+  EventFlags flags;
+  flags.set(kRx | kTx);
+
+  // Ensure it doesn't block and succeeds when all of the flags are set.
+  SystemClock::time_point deadline =
+      SystemClock::now() + kRoundedArbitraryDuration;
+  EXPECT_EQ(flags.try_wait_all_until(kRx | kTx, deadline), kRx | kTx);
+  EXPECT_LT(SystemClock::now(), deadline);
+}
+
+TEST(EventFlags, TryWaitAllUntilPartiallySetFutureDeadline) {
+  EventFlags flags;
+  flags.set(kTx);
+
+  // Ensure it blocks and fails when only some of the flags are set.
+  SystemClock::time_point deadline =
+      SystemClock::now() + kRoundedArbitraryDuration;
+  EXPECT_EQ(flags.try_wait_all_until(kRx | kTx, deadline), 0u);
+  EXPECT_GE(SystemClock::now(), deadline);
+  EXPECT_EQ(flags.get(), kTx);
+}
+
+TEST(EventFlags, TryWaitAnyUntilNotSetPastDeadline) {
+  EventFlags flags;
+
+  // Ensure it doesn't block when a timestamp in the past is used.
+  SystemClock::time_point deadline =
+      SystemClock::now() + kRoundedArbitraryDuration;
+  EXPECT_EQ(flags.try_wait_any_until(
+                kRx, SystemClock::now() - kRoundedArbitraryDuration),
+            0u);
+  EXPECT_LT(SystemClock::now(), deadline);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,87 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/backends/portable_shared_mutex_native.h"
+
+#include <mutex>
+
+namespace pw::sync::backend {
+
+PortableSharedMutex::PortableSharedMutex() : readers_(0) {
+  room_empty_.release();
+}
+
+// A writer keeps the turnstile locked until it unlocks, which the thread
+// safety analysis cannot follow across functions.
+void PortableSharedMutex::lock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  turnstile_.lock();
+  room_empty_.acquire();
+}
+
+bool PortableSharedMutex::try_lock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  if (!turnstile_.try_lock()) {
+    return false;
+  }
+  if (!room_empty_.try_acquire()) {
+    turnstile_.unlock();
+    return false;
+  }
+  return true;
+}
+
+void PortableSharedMutex::unlock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  room_empty_.release();
+  turnstile_.unlock();
+}
+
+void PortableSharedMutex::lock_shared() {
+  // Wait behind any writer that is waiting for or holding the lock.
+  turnstile_.lock();
+  turnstile_.unlock();
+
+  std::lock_guard lock(readers_lock_);
+  if (readers_ == 0u) {
+    room_empty_.acquire();
+  }
+  readers_ += 1;
+}
+
+bool PortableSharedMutex::try_lock_shared() {
+  if (!turnstile_.try_lock()) {
+    return false;
+  }
+  turnstile_.unlock();
+
+  // The first reader holds readers_lock_ while it waits for a writer to leave,
+  // so don't block on it.
+  if (!readers_lock_.try_lock()) {
+    return false;
+  }
+  const bool acquired = readers_ != 0u || room_empty_.try_acquire();
+  if (acquired) {
+    readers_ += 1;
+  }
+  readers_lock_.unlock();
+  return acquired;
+}
+
+void PortableSharedMutex::unlock_shared() {
+  std::lock_guard lock(readers_lock_);
+  readers_ -= 1;
+  if (readers_ == 0u) {
+    room_empty_.release();
+  }
+}
+
+}  // namespace pw::sync::backend
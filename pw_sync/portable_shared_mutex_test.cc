@@ -0,0 +1,69 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "gtest/gtest.h"
+#include "pw_sync/backends/portable_shared_mutex_native.h"
+
+namespace pw::sync::backend {
+namespace {
+
+// Unlike SharedMutex in general, PortableSharedMutex lets a thread hold the
+// lock more than once in shared mode, so its states can be tested from a single
+// thread.
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(PortableSharedMutex, LockExcludesEverything) {
+  PortableSharedMutex mutex;
+  mutex.lock();
+  EXPECT_FALSE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_shared());
+  mutex.unlock();
+
+  EXPECT_TRUE(mutex.try_lock_shared());
+  mutex.unlock_shared();
+}
+
+TEST(PortableSharedMutex, ReadersShare) {
+  PortableSharedMutex mutex;
+  mutex.lock_shared();
+  EXPECT_TRUE(mutex.try_lock_shared());
+  mutex.lock_shared();
+  EXPECT_FALSE(mutex.try_lock());
+
+  mutex.unlock_shared();
+  mutex.unlock_shared();
+  EXPECT_FALSE(mutex.try_lock());
+
+  mutex.unlock_shared();
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(PortableSharedMutex, FailedTryLockLeavesMutexUsable) {
+  PortableSharedMutex mutex;
+  mutex.lock_shared();
+  EXPECT_FALSE(mutex.try_lock());
+
+  // The failed try_lock() must not have left new readers waiting.
+  EXPECT_TRUE(mutex.try_lock_shared());
+  mutex.unlock_shared();
+  mutex.unlock_shared();
+
+  mutex.lock();
+  mutex.unlock();
+}
+
+}  // namespace
+}  // namespace pw::sync::backend
@@ -0,0 +1,132 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/profiled_lock.h"
+
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync {
+namespace {
+
+// A lock that is only held when told to, so contention can be simulated from
+// a single thread.
+class FakeLock {
+ public:
+  void lock() {
+    lock_calls += 1;
+    locked = true;
+  }
+
+  bool try_lock() {
+    if (locked) {
+      return false;
+    }
+    locked = true;
+    return true;
+  }
+
+  void unlock() { locked = false; }
+
+  bool locked = false;
+  int lock_calls = 0;
+};
+
+constexpr metric::Token kName =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "test_lock");
+
+constexpr metric::Token kAcquired =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "acquired");
+constexpr metric::Token kContended =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "contended");
+constexpr metric::Token kTotalWait =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "total_wait_us");
+constexpr metric::Token kMaxWait =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "max_wait_us");
+
+template <typename Lock>
+uint32_t MetricValue(ProfiledLock<Lock>& lock, metric::Token token) {
+  // Metric names drop the token's most significant bit.
+  for (const metric::Metric& metric : lock.metrics().metrics()) {
+    if (metric.name() == (token & 0x7fff'ffffu)) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+TEST(ProfiledLock, NamesGroup) {
+  ProfiledLock<FakeLock> lock(kName);
+  EXPECT_EQ(lock.metrics().name(), kName);
+}
+
+TEST(ProfiledLock, CountsAcquisitions) {
+  ProfiledLock<FakeLock> lock(kName);
+  lock.lock();
+  lock.unlock();
+  ASSERT_TRUE(lock.try_lock());
+  lock.unlock();
+
+  EXPECT_EQ(MetricValue(lock, kAcquired), 2u);
+  EXPECT_EQ(MetricValue(lock, kContended), 0u);
+  EXPECT_EQ(MetricValue(lock, kTotalWait), 0u);
+  EXPECT_EQ(MetricValue(lock, kMaxWait), 0u);
+}
+
+TEST(ProfiledLock, FailedTryLockIsNotCounted) {
+  ProfiledLock<FakeLock> lock(kName);
+  lock.lock_object().locked = true;
+  EXPECT_FALSE(lock.try_lock());
+
+  EXPECT_EQ(MetricValue(lock, kAcquired), 0u);
+  EXPECT_EQ(MetricValue(lock, kContended), 0u);
+}
+
+TEST(ProfiledLock, CountsContention) {
+  ProfiledLock<FakeLock> lock(kName);
+
+  // The fake lock is held, so lock() has to wait for it.
+  lock.lock_object().locked = true;
+  lock.lock();
+  lock.unlock();
+
+  EXPECT_EQ(lock.lock_object().lock_calls, 1);
+  EXPECT_EQ(MetricValue(lock, kAcquired), 1u);
+  EXPECT_EQ(MetricValue(lock, kContended), 1u);
+  EXPECT_LE(MetricValue(lock, kMaxWait),
+            MetricValue(lock, kTotalWait));
+}
+
+TEST(ProfiledLock, Mutex) {
+  ProfiledLock<Mutex> lock(kName);
+  {
+    std::lock_guard guard(lock);
+  }
+  EXPECT_EQ(MetricValue(lock, kAcquired), 1u);
+}
+
+TEST(ProfiledLock, InterruptSpinLock) {
+  ProfiledLock<InterruptSpinLock> lock(kName);
+  {
+    std::lock_guard guard(lock);
+  }
+  EXPECT_EQ(MetricValue(lock, kAcquired), 1u);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,96 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync {
+
+// The AdaptiveMutex is a Mutex that spins for a short time before blocking.
+//
+// Blocking on a contended mutex costs two context switches. If the holder only
+// keeps the lock for a short time and runs on another core, it is cheaper to
+// spin until the lock is released. After spin_count failed attempts, lock()
+// blocks on the underlying Mutex like a regular Mutex.
+//
+// Spinning does not help on single-core targets, where the holder cannot run
+// while this thread spins. Use a regular Mutex there.
+//
+// Contention is counted in metrics(), which can be added to a parent group:
+//
+//   contended     - lock() calls that found the mutex already held.
+//   spin_acquired - contended lock() calls that acquired the mutex by spinning.
+//   blocked       - contended lock() calls that blocked on the mutex.
+//
+// This is thread safe, but NOT IRQ safe.
+class PW_LOCKABLE("pw::sync::AdaptiveMutex") AdaptiveMutex {
+ public:
+  static constexpr uint32_t kDefaultSpinCount = 100;
+
+  explicit AdaptiveMutex(uint32_t spin_count = kDefaultSpinCount)
+      : spin_count_(spin_count) {}
+
+  AdaptiveMutex(const AdaptiveMutex&) = delete;
+  AdaptiveMutex(AdaptiveMutex&&) = delete;
+  AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+  AdaptiveMutex& operator=(AdaptiveMutex&&) = delete;
+
+  // Locks the mutex, spinning and then blocking indefinitely. Failures are
+  // fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS;
+
+  // Attempts to lock the mutex without spinning or blocking.
+  // Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    return mutex_.try_lock();
+  }
+
+  // Unlocks the mutex. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held by this thread.
+  void unlock() PW_UNLOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    mutex_.unlock();
+  }
+
+  uint32_t spin_count() const { return spin_count_; }
+
+  // The metrics are only updated while the mutex is held. Read them while
+  // holding the mutex for consistent values.
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  Mutex mutex_;
+  const uint32_t spin_count_;
+
+  PW_METRIC_GROUP(metrics_, "pw::sync::AdaptiveMutex");
+  PW_METRIC(metrics_, contended_, "contended", 0u);
+  PW_METRIC(metrics_, spin_acquired_, "spin_acquired", 0u);
+  PW_METRIC(metrics_, blocked_, "blocked", 0u);
+};
+
+}  // namespace pw::sync
@@ -0,0 +1,60 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_sync/binary_semaphore.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync::backend {
+
+// A reader-writer lock built on the Mutex and BinarySemaphore facades, for
+// RTOSes without a native one.
+//
+// Writers are preferred: a waiting writer holds the turnstile, and readers
+// must pass through the turnstile, so new readers queue behind the writer
+// instead of starving it.
+class PortableSharedMutex {
+ public:
+  PortableSharedMutex();
+  PortableSharedMutex(const PortableSharedMutex&) = delete;
+  PortableSharedMutex& operator=(const PortableSharedMutex&) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+ private:
+  // Held by a writer from when it starts waiting until it unlocks.
+  Mutex turnstile_;
+
+  Mutex readers_lock_;
+  size_t readers_ PW_GUARDED_BY(readers_lock_);
+
+  // Available when no reader or writer holds the lock. It is a semaphore
+  // rather than a mutex because the last reader to unlock releases it, which
+  // need not be the reader that acquired it.
+  BinarySemaphore room_empty_;
+};
+
+using NativeSharedMutex = PortableSharedMutex;
+using NativeSharedMutexHandle = PortableSharedMutex&;
+
+}  // namespace pw::sync::backend
@@ -0,0 +1,115 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync_backend/event_flags_native.h"
+
+namespace pw::sync {
+
+// EventFlags is a set of flags that threads can wait on, so that one thread can
+// block on many event sources at once. Producers set flags, and a waiter
+// blocks until any or all of the flags it waits for are set.
+//
+// A successful wait clears the flags it waited for and returns those that were
+// set, so each event is consumed once. Each flag should have a single waiter:
+// when several threads wait for the same flag, whether one or all of them are
+// woken depends on the backend.
+//
+// Only the flags in kAllFlags may be used, since some RTOSes reserve the upper
+// bits of their event groups.
+//
+// The entire API is thread safe but only a subset is IRQ safe.
+//
+// WARNING: In order to support global statically constructed EventFlags, the
+// user and/or backend MUST ensure that any initialization required in your
+// environment is done prior to the creation and/or initialization of the native
+// synchronization primitives (e.g. kernel initialization).
+class EventFlags {
+ public:
+  using native_handle_type = backend::NativeEventFlagsHandle;
+  using Flags = uint32_t;
+
+  static constexpr Flags kAllFlags = 0x00FF'FFFF;
+
+  EventFlags();
+  ~EventFlags();
+  EventFlags(const EventFlags&) = delete;
+  EventFlags(EventFlags&&) = delete;
+  EventFlags& operator=(const EventFlags&) = delete;
+  EventFlags& operator=(EventFlags&&) = delete;
+
+  // Sets the flags, waking any waiters whose wait is now satisfied.
+  // This is thread and IRQ safe.
+  //
+  // Precondition: flags is a subset of kAllFlags.
+  void set(Flags flags);
+
+  // Clears the flags without waking any waiters.
+  // This is thread and IRQ safe.
+  //
+  // Precondition: flags is a subset of kAllFlags.
+  void clear(Flags flags);
+
+  // Returns the flags that are currently set.
+  // This is thread and IRQ safe.
+  Flags get();
+
+  // Blocks until at least one of the flags is set. Clears and returns the
+  // flags that were set.
+  // This is thread safe, but not IRQ safe.
+  //
+  // Precondition: flags is a non-empty subset of kAllFlags.
+  Flags wait_any(Flags flags);
+
+  // Blocks until all of the flags are set, then clears and returns them.
+  // This is thread safe, but not IRQ safe.
+  //
+  // Precondition: flags is a non-empty subset of kAllFlags.
+  Flags wait_all(Flags flags);
+
+  // Like wait_any(), but blocks until the timeout has elapsed at most. Returns
+  // 0 if no flag was set in time.
+  // This is thread safe, but not IRQ safe.
+  Flags try_wait_any_for(Flags flags, chrono::SystemClock::duration timeout);
+
+  // Like wait_any(), but blocks until the deadline at most. Returns 0 if no
+  // flag was set in time.
+  // This is thread safe, but not IRQ safe.
+  Flags try_wait_any_until(Flags flags,
+                           chrono::SystemClock::time_point deadline);
+
+  // Like wait_all(), but blocks until the timeout has elapsed at most. Returns
+  // 0, and clears nothing, if the flags were not all set in time.
+  // This is thread safe, but not IRQ safe.
+  Flags try_wait_all_for(Flags flags, chrono::SystemClock::duration timeout);
+
+  // Like wait_all(), but blocks until the deadline at most. Returns 0, and
+  // clears nothing, if the flags were not all set in time.
+  // This is thread safe, but not IRQ safe.
+  Flags try_wait_all_until(Flags flags,
+                           chrono::SystemClock::time_point deadline);
+
+  native_handle_type native_handle();
+
+ private:
+  // This may be a wrapper around a native type with additional members.
+  backend::NativeEventFlags native_type_;
+};
+
+}  // namespace pw::sync
+
+#include "pw_sync_backend/event_flags_inline.h"
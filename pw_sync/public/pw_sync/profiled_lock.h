@@ -0,0 +1,132 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::sync {
+
+// ProfiledLock wraps a lock, such as a Mutex or InterruptSpinLock, and records
+// how it is used in a pw_metric group:
+//
+//   acquired      - times the lock was acquired.
+//   contended     - lock() calls that found the lock already held.
+//   total_wait_us - total time contended lock() calls waited, in microseconds.
+//   max_wait_us   - longest time a lock() call waited, in microseconds.
+//   max_hold_us   - longest time the lock was held, in microseconds.
+//
+// The group is named with a token, so each instance can be found in a metrics
+// dump:
+//
+//   pw::sync::ProfiledLock<pw::sync::Mutex> buffer_lock(
+//       PW_TOKENIZE_STRING_DOMAIN("metrics", "buffer_lock"));
+//   parent_group.Add(buffer_lock.metrics());
+//
+// Profiling is opt-in per instance: declare a lock as a ProfiledLock to find
+// out whether it is worth optimizing, and switch back once done. It costs two
+// SystemClock::now() calls per acquisition, plus two more when contended.
+//
+// The metrics are only updated while the lock is held, so they are as thread
+// and IRQ safe as the wrapped lock. Timed and shared locking are not
+// instrumented; use lock_object() to reach them.
+template <typename Lock>
+class PW_LOCKABLE("pw::sync::ProfiledLock") ProfiledLock {
+ public:
+  explicit ProfiledLock(metric::Token name) : metrics_(name) {}
+
+  ProfiledLock(const ProfiledLock&) = delete;
+  ProfiledLock(ProfiledLock&&) = delete;
+  ProfiledLock& operator=(const ProfiledLock&) = delete;
+  ProfiledLock& operator=(ProfiledLock&&) = delete;
+
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (lock_.try_lock()) {
+      Acquired(chrono::SystemClock::now());
+      return;
+    }
+
+    const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+    lock_.lock();
+    const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+
+    const uint32_t wait_us = ToMicroseconds(now - start);
+    contended_.Increment();
+    total_wait_us_.Set(SaturatingAdd(total_wait_us_.value(), wait_us));
+    max_wait_us_.Set(std::max(max_wait_us_.value(), wait_us));
+    Acquired(now);
+  }
+
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (!lock_.try_lock()) {
+      return false;
+    }
+    Acquired(chrono::SystemClock::now());
+    return true;
+  }
+
+  void unlock() PW_UNLOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    const uint32_t hold_us =
+        ToMicroseconds(chrono::SystemClock::now() - acquired_at_);
+    max_hold_us_.Set(std::max(max_hold_us_.value(), hold_us));
+    lock_.unlock();
+  }
+
+  // The wrapped lock. Locking it directly bypasses the metrics.
+  Lock& lock_object() { return lock_; }
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  static uint32_t ToMicroseconds(chrono::SystemClock::duration duration) {
+    const auto us =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (us <= 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(us) > std::numeric_limits<uint32_t>::max()
+               ? std::numeric_limits<uint32_t>::max()
+               : static_cast<uint32_t>(us);
+  }
+
+  static uint32_t SaturatingAdd(uint32_t a, uint32_t b) {
+    return b > std::numeric_limits<uint32_t>::max() - a
+               ? std::numeric_limits<uint32_t>::max()
+               : a + b;
+  }
+
+  void Acquired(chrono::SystemClock::time_point now) {
+    acquired_.Increment();
+    acquired_at_ = now;
+  }
+
+  Lock lock_;
+  chrono::SystemClock::time_point acquired_at_;
+
+  metric::Group metrics_;
+  PW_METRIC(metrics_, acquired_, "acquired", 0u);
+  PW_METRIC(metrics_, contended_, "contended", 0u);
+  PW_METRIC(metrics_, total_wait_us_, "total_wait_us", 0u);
+  PW_METRIC(metrics_, max_wait_us_, "max_wait_us", 0u);
+  PW_METRIC(metrics_, max_hold_us_, "max_hold_us", 0u);
+};
+
+}  // namespace pw::sync
@@ -0,0 +1,100 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync_backend/shared_mutex_native.h"
+
+namespace pw::sync {
+
+// The SharedMutex is a synchronization primitive that can be used to protect
+// shared data from being simultaneously accessed by multiple threads. Unlike
+// the Mutex, it has two levels of access: shared access, which many readers
+// may hold at once, and exclusive access, which only one writer may hold and
+// which excludes all readers. Use it for read-mostly data where readers would
+// otherwise serialize on a Mutex.
+//
+// Its API is like C++17's std::shared_mutex, so it works with std::lock_guard,
+// std::unique_lock, and std::shared_lock. It is non-recursive: a thread must
+// not lock it, in either mode, while already holding it.
+//
+// Whether readers or writers are preferred depends on the backend. Backends
+// should not let a steady stream of readers starve writers indefinitely.
+//
+// This is thread safe, but NOT IRQ safe.
+class PW_LOCKABLE("pw::sync::SharedMutex") SharedMutex {
+ public:
+  using native_handle_type = backend::NativeSharedMutexHandle;
+
+  SharedMutex();
+  ~SharedMutex();
+  SharedMutex(const SharedMutex&) = delete;
+  SharedMutex(SharedMutex&&) = delete;
+  SharedMutex& operator=(const SharedMutex&) = delete;
+  SharedMutex& operator=(SharedMutex&&) = delete;
+
+  // Locks the mutex for exclusive access, blocking indefinitely. Failures are
+  // fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION();
+
+  // Attempts to lock the mutex for exclusive access in a non-blocking manner.
+  // Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true);
+
+  // Releases exclusive access. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held exclusively by this thread.
+  void unlock() PW_UNLOCK_FUNCTION();
+
+  // Locks the mutex for shared access, blocking indefinitely. Failures are
+  // fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  void lock_shared() PW_SHARED_LOCK_FUNCTION();
+
+  // Attempts to lock the mutex for shared access in a non-blocking manner.
+  // Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  bool try_lock_shared() PW_SHARED_TRYLOCK_FUNCTION(true);
+
+  // Releases shared access. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held for shared access by this thread.
+  void unlock_shared() PW_UNLOCK_FUNCTION();
+
+  native_handle_type native_handle();
+
+ private:
+  // This may be a wrapper around a native type with additional members.
+  backend::NativeSharedMutex native_type_;
+};
+
+}  // namespace pw::sync
+
+#include "pw_sync_backend/shared_mutex_inline.h"
@@ -0,0 +1,80 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <mutex>
+#include <shared_mutex>
+
+#include "gtest/gtest.h"
+#include "pw_sync/shared_mutex.h"
+
+namespace pw::sync {
+namespace {
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(SharedMutex, LockUnlock) {
+  SharedMutex mutex;
+  mutex.lock();
+  // TODO(pwbug/291): Ensure it fails to lock when already held.
+  // EXPECT_FALSE(mutex.try_lock_shared());
+  mutex.unlock();
+}
+
+SharedMutex static_mutex;
+TEST(SharedMutex, LockUnlockStatic) {
+  static_mutex.lock();
+  static_mutex.unlock();
+}
+
+TEST(SharedMutex, TryLockUnlock) {
+  SharedMutex mutex;
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+}
+
+TEST(SharedMutex, LockSharedUnlockShared) {
+  SharedMutex mutex;
+  mutex.lock_shared();
+  // TODO(pwbug/291): Ensure it fails to lock exclusively when shared.
+  // EXPECT_FALSE(mutex.try_lock());
+  mutex.unlock_shared();
+}
+
+TEST(SharedMutex, TryLockSharedUnlockShared) {
+  SharedMutex mutex;
+  const bool locked = mutex.try_lock_shared();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock_shared();
+  }
+}
+
+TEST(SharedMutex, StandardLocks) {
+  SharedMutex mutex;
+  {
+    std::shared_lock lock(mutex);
+    EXPECT_TRUE(lock.owns_lock());
+  }
+  {
+    std::lock_guard lock(mutex);
+  }
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,189 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/event_flags.h"
+
+#include "FreeRTOS.h"
+#include "event_groups.h"
+#include "pw_assert/check.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono_freertos/system_clock_constants.h"
+#include "pw_interrupt/context.h"
+
+using pw::chrono::SystemClock;
+
+namespace pw::sync {
+namespace {
+
+static_assert(configSUPPORT_STATIC_ALLOCATION != 0,
+              "FreeRTOS static allocations are required for this backend.");
+
+// FreeRTOS reserves the upper byte of the event bits for its own use, so only
+// 32 bit ticks leave room for all of kAllFlags.
+static_assert(sizeof(EventBits_t) >= sizeof(uint32_t),
+              "EventFlags requires 32 bit FreeRTOS ticks.");
+
+using Flags = EventFlags::Flags;
+
+void CheckWaitFlags(Flags flags) {
+  // Enforce the pw::sync::EventFlags IRQ contract.
+  PW_DCHECK(!interrupt::InInterruptContext());
+  PW_DCHECK_UINT_NE(flags, 0u);
+  PW_DCHECK_UINT_EQ(flags & ~EventFlags::kAllFlags, 0u);
+}
+
+// Waits once for up to the given number of ticks, clearing the flags on
+// success. Returns the flags that were waited for and set, or 0 on timeout.
+Flags WaitBits(EventGroupHandle_t handle,
+               Flags flags,
+               bool wait_for_all,
+               TickType_t ticks) {
+  // The returned value holds the bits as they were before being cleared, or
+  // when the wait timed out.
+  const Flags set = static_cast<Flags>(
+      xEventGroupWaitBits(handle,
+                          static_cast<EventBits_t>(flags),
+                          pdTRUE,  // Clear the flags on exit.
+                          wait_for_all ? pdTRUE : pdFALSE,
+                          ticks)) &
+                    flags;
+  if (wait_for_all) {
+    return set == flags ? set : 0;
+  }
+  return set;
+}
+
+Flags Wait(EventGroupHandle_t handle, Flags flags, bool wait_for_all) {
+#if INCLUDE_vTaskSuspend == 1  // This means portMAX_DELAY is indefinite.
+  const Flags set = WaitBits(handle, flags, wait_for_all, portMAX_DELAY);
+  PW_DCHECK_UINT_NE(set, 0u);
+  return set;
+#else
+  // In case we need to block for longer than the FreeRTOS delay can represent
+  // repeatedly wait until success.
+  while (true) {
+    const Flags set =
+        WaitBits(handle,
+                 flags,
+                 wait_for_all,
+                 static_cast<TickType_t>(chrono::freertos::kMaxTimeout.count()));
+    if (set != 0) {
+      return set;
+    }
+  }
+#endif  // INCLUDE_vTaskSuspend
+}
+
+Flags TryWaitFor(EventGroupHandle_t handle,
+                 Flags flags,
+                 bool wait_for_all,
+                 SystemClock::duration timeout) {
+  // Use a non-blocking wait for negative and zero length durations.
+  if (timeout <= SystemClock::duration::zero()) {
+    return WaitBits(handle, flags, wait_for_all, 0);
+  }
+
+  // In case the timeout is too long for us to express through the native
+  // FreeRTOS API, we repeatedly wait with shorter durations. Note that on a
+  // tick based kernel we cannot tell how far along we are on the current tick,
+  // ergo we add one whole tick to the final duration. However, this also means
+  // that the loop must ensure that timeout + 1 is less than the max timeout.
+  constexpr SystemClock::duration kMaxTimeoutMinusOne =
+      pw::chrono::freertos::kMaxTimeout - SystemClock::duration(1);
+  while (timeout > kMaxTimeoutMinusOne) {
+    const Flags set =
+        WaitBits(handle,
+                 flags,
+                 wait_for_all,
+                 static_cast<TickType_t>(kMaxTimeoutMinusOne.count()));
+    if (set != 0) {
+      return set;
+    }
+    timeout -= kMaxTimeoutMinusOne;
+  }
+  // On a tick based kernel we cannot tell how far along we are on the current
+  // tick, ergo we add one whole tick to the final duration.
+  return WaitBits(handle,
+                  flags,
+                  wait_for_all,
+                  static_cast<TickType_t>(timeout.count() + 1));
+}
+
+}  // namespace
+
+void EventFlags::set(Flags flags) {
+  PW_DCHECK_UINT_EQ(flags & ~kAllFlags, 0u);
+  const EventGroupHandle_t handle =
+      reinterpret_cast<EventGroupHandle_t>(&native_type_);
+  if (interrupt::InInterruptContext()) {
+    // Setting bits may unblock several tasks, so FreeRTOS defers this to the
+    // timer daemon task. This requires configUSE_TIMERS and
+    // INCLUDE_xTimerPendFunctionCall.
+    BaseType_t woke_higher_task = pdFALSE;
+    const BaseType_t result = xEventGroupSetBitsFromISR(
+        handle, static_cast<EventBits_t>(flags), &woke_higher_task);
+    PW_CHECK_INT_EQ(result, pdPASS, "Timer command queue is full");
+    portYIELD_FROM_ISR(woke_higher_task);
+  } else {  // Task context
+    xEventGroupSetBits(handle, static_cast<EventBits_t>(flags));
+  }
+}
+
+void EventFlags::clear(Flags flags) {
+  PW_DCHECK_UINT_EQ(flags & ~kAllFlags, 0u);
+  const EventGroupHandle_t handle =
+      reinterpret_cast<EventGroupHandle_t>(&native_type_);
+  if (interrupt::InInterruptContext()) {
+    // Like set, this is deferred to the timer daemon task.
+    const BaseType_t result =
+        xEventGroupClearBitsFromISR(handle, static_cast<EventBits_t>(flags));
+    PW_CHECK_INT_EQ(result, pdPASS, "Timer command queue is full");
+  } else {  // Task context
+    xEventGroupClearBits(handle, static_cast<EventBits_t>(flags));
+  }
+}
+
+EventFlags::Flags EventFlags::wait_any(Flags flags) {
+  CheckWaitFlags(flags);
+  return Wait(reinterpret_cast<EventGroupHandle_t>(&native_type_),
+              flags,
+              /*wait_for_all=*/false);
+}
+
+EventFlags::Flags EventFlags::wait_all(Flags flags) {
+  CheckWaitFlags(flags);
+  return Wait(reinterpret_cast<EventGroupHandle_t>(&native_type_),
+              flags,
+              /*wait_for_all=*/true);
+}
+
+EventFlags::Flags EventFlags::try_wait_any_for(Flags flags,
+                                               SystemClock::duration timeout) {
+  CheckWaitFlags(flags);
+  return TryWaitFor(reinterpret_cast<EventGroupHandle_t>(&native_type_),
+                    flags,
+                    /*wait_for_all=*/false,
+                    timeout);
+}
+
+EventFlags::Flags EventFlags::try_wait_all_for(Flags flags,
+                                               SystemClock::duration timeout) {
+  CheckWaitFlags(flags);
+  return TryWaitFor(reinterpret_cast<EventGroupHandle_t>(&native_type_),
+                    flags,
+                    /*wait_for_all=*/true,
+                    timeout);
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,63 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "FreeRTOS.h"
+#include "event_groups.h"
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_interrupt/context.h"
+#include "pw_sync/event_flags.h"
+
+namespace pw::sync {
+
+inline EventFlags::EventFlags() : native_type_() {
+  const EventGroupHandle_t handle = xEventGroupCreateStatic(&native_type_);
+  // This should never fail since the pointer provided was not null and it
+  // should return a pointer to the StaticEventGroup_t.
+  PW_DASSERT(handle == reinterpret_cast<EventGroupHandle_t>(&native_type_));
+}
+
+inline EventFlags::~EventFlags() {
+  vEventGroupDelete(reinterpret_cast<EventGroupHandle_t>(&native_type_));
+}
+
+inline EventFlags::Flags EventFlags::get() {
+  if (interrupt::InInterruptContext()) {
+    return static_cast<Flags>(xEventGroupGetBitsFromISR(
+        reinterpret_cast<EventGroupHandle_t>(&native_type_)));
+  }
+  return static_cast<Flags>(
+      xEventGroupGetBits(reinterpret_cast<EventGroupHandle_t>(&native_type_)));
+}
+
+inline EventFlags::Flags EventFlags::try_wait_any_until(
+    Flags flags, chrono::SystemClock::time_point deadline) {
+  // Note that if this deadline is in the future, it will get rounded up by
+  // one whole tick due to how try_wait_any_for is implemented.
+  return try_wait_any_for(flags, deadline - chrono::SystemClock::now());
+}
+
+inline EventFlags::Flags EventFlags::try_wait_all_until(
+    Flags flags, chrono::SystemClock::time_point deadline) {
+  // Note that if this deadline is in the future, it will get rounded up by
+  // one whole tick due to how try_wait_all_for is implemented.
+  return try_wait_all_for(flags, deadline - chrono::SystemClock::now());
+}
+
+inline EventFlags::native_handle_type EventFlags::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,100 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/event_flags.h"
+
+#include "pw_assert/check.h"
+
+using pw::chrono::SystemClock;
+
+namespace pw::sync {
+namespace {
+
+using Flags = EventFlags::Flags;
+
+bool AnySet(Flags current, Flags flags) { return (current & flags) != 0u; }
+
+bool AllSet(Flags current, Flags flags) { return (current & flags) == flags; }
+
+void CheckWaitFlags(Flags flags) {
+  PW_DCHECK_UINT_NE(flags, 0u);
+  PW_DCHECK_UINT_EQ(flags & ~EventFlags::kAllFlags, 0u);
+}
+
+// Clears and returns the flags that are set. The mutex must be held.
+Flags Consume(backend::NativeEventFlags& native, Flags flags) {
+  const Flags consumed = native.flags & flags;
+  native.flags &= ~consumed;
+  return consumed;
+}
+
+}  // namespace
+
+void EventFlags::set(Flags flags) {
+  PW_DCHECK_UINT_EQ(flags & ~kAllFlags, 0u);
+  std::lock_guard lock(native_type_.mutex);
+  native_type_.flags |= flags;
+  native_type_.condition.notify_all();
+}
+
+void EventFlags::clear(Flags flags) {
+  PW_DCHECK_UINT_EQ(flags & ~kAllFlags, 0u);
+  std::lock_guard lock(native_type_.mutex);
+  native_type_.flags &= ~flags;
+}
+
+EventFlags::Flags EventFlags::get() {
+  std::lock_guard lock(native_type_.mutex);
+  return native_type_.flags;
+}
+
+EventFlags::Flags EventFlags::wait_any(Flags flags) {
+  CheckWaitFlags(flags);
+  std::unique_lock lock(native_type_.mutex);
+  native_type_.condition.wait(
+      lock, [&] { return AnySet(native_type_.flags, flags); });
+  return Consume(native_type_, flags);
+}
+
+EventFlags::Flags EventFlags::wait_all(Flags flags) {
+  CheckWaitFlags(flags);
+  std::unique_lock lock(native_type_.mutex);
+  native_type_.condition.wait(
+      lock, [&] { return AllSet(native_type_.flags, flags); });
+  return Consume(native_type_, flags);
+}
+
+EventFlags::Flags EventFlags::try_wait_any_until(
+    Flags flags, SystemClock::time_point deadline) {
+  CheckWaitFlags(flags);
+  std::unique_lock lock(native_type_.mutex);
+  if (!native_type_.condition.wait_until(
+          lock, deadline, [&] { return AnySet(native_type_.flags, flags); })) {
+    return 0;
+  }
+  return Consume(native_type_, flags);
+}
+
+EventFlags::Flags EventFlags::try_wait_all_until(
+    Flags flags, SystemClock::time_point deadline) {
+  CheckWaitFlags(flags);
+  std::unique_lock lock(native_type_.mutex);
+  if (!native_type_.condition.wait_until(
+          lock, deadline, [&] { return AllSet(native_type_.flags, flags); })) {
+    return 0;
+  }
+  return Consume(native_type_, flags);
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,44 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/event_flags.h"
+
+namespace pw::sync {
+
+inline EventFlags::EventFlags()
+    : native_type_{.mutex = {}, .condition = {}, .flags = 0} {}
+
+inline EventFlags::~EventFlags() {}
+
+// As with BinarySemaphore, the timeouts are converted to deadlines so that
+// spurious condition variable wakeups do not extend the effective deadline.
+inline EventFlags::Flags EventFlags::try_wait_any_for(
+    Flags flags, chrono::SystemClock::duration timeout) {
+  return try_wait_any_until(
+      flags, chrono::SystemClock::TimePointAfterAtLeast(timeout));
+}
+
+inline EventFlags::Flags EventFlags::try_wait_all_for(
+    Flags flags, chrono::SystemClock::duration timeout) {
+  return try_wait_all_until(
+      flags, chrono::SystemClock::TimePointAfterAtLeast(timeout));
+}
+
+inline EventFlags::native_handle_type EventFlags::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,112 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/event_flags.h"
+
+#include "pw_assert/check.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono_threadx/system_clock_constants.h"
+#include "pw_interrupt/context.h"
+#include "tx_api.h"
+
+using pw::chrono::SystemClock;
+
+namespace pw::sync {
+namespace {
+
+using Flags = EventFlags::Flags;
+
+void CheckWaitFlags(Flags flags) {
+  // Enforce the pw::sync::EventFlags IRQ contract.
+  PW_DCHECK(!interrupt::InInterruptContext());
+  PW_DCHECK_UINT_NE(flags, 0u);
+  PW_DCHECK_UINT_EQ(flags & ~EventFlags::kAllFlags, 0u);
+}
+
+// Waits once for up to the given number of ticks, clearing the flags on
+// success. Returns the flags that were waited for and set, or 0 on timeout.
+Flags GetFlags(TX_EVENT_FLAGS_GROUP& group,
+               Flags flags,
+               bool wait_for_all,
+               ULONG wait_option) {
+  const UINT get_option = wait_for_all ? TX_AND_CLEAR : TX_OR_CLEAR;
+  ULONG actual = 0;
+  const UINT result = tx_event_flags_get(
+      &group, static_cast<ULONG>(flags), get_option, &actual, wait_option);
+  if (result == TX_NO_EVENTS) {
+    return 0;  // We timed out.
+  }
+  PW_CHECK_UINT_EQ(TX_SUCCESS, result);
+  // The actual flags are those that were set before being cleared.
+  return static_cast<Flags>(actual) & flags;
+}
+
+Flags TryGetFlagsFor(TX_EVENT_FLAGS_GROUP& group,
+                     Flags flags,
+                     bool wait_for_all,
+                     SystemClock::duration timeout) {
+  // Use a non-blocking get for negative and zero length durations.
+  if (timeout <= SystemClock::duration::zero()) {
+    return GetFlags(group, flags, wait_for_all, TX_NO_WAIT);
+  }
+
+  // In case the timeout is too long for us to express through the native
+  // ThreadX API, we repeatedly wait with shorter durations. Note that on a tick
+  // based kernel we cannot tell how far along we are on the current tick, ergo
+  // we add one whole tick to the final duration. However, this also means that
+  // the loop must ensure that timeout + 1 is less than the max timeout.
+  constexpr SystemClock::duration kMaxTimeoutMinusOne =
+      pw::chrono::threadx::kMaxTimeout - SystemClock::duration(1);
+  while (timeout > kMaxTimeoutMinusOne) {
+    const Flags set =
+        GetFlags(group,
+                 flags,
+                 wait_for_all,
+                 static_cast<ULONG>(kMaxTimeoutMinusOne.count()));
+    if (set != 0) {
+      return set;
+    }
+    timeout -= kMaxTimeoutMinusOne;
+  }
+  // On a tick based kernel we cannot tell how far along we are on the current
+  // tick, ergo we add one whole tick to the final duration.
+  return GetFlags(
+      group, flags, wait_for_all, static_cast<ULONG>(timeout.count() + 1));
+}
+
+}  // namespace
+
+EventFlags::Flags EventFlags::wait_any(Flags flags) {
+  CheckWaitFlags(flags);
+  return GetFlags(native_type_, flags, /*wait_for_all=*/false, TX_WAIT_FOREVER);
+}
+
+EventFlags::Flags EventFlags::wait_all(Flags flags) {
+  CheckWaitFlags(flags);
+  return GetFlags(native_type_, flags, /*wait_for_all=*/true, TX_WAIT_FOREVER);
+}
+
+EventFlags::Flags EventFlags::try_wait_any_for(Flags flags,
+                                               SystemClock::duration timeout) {
+  CheckWaitFlags(flags);
+  return TryGetFlagsFor(native_type_, flags, /*wait_for_all=*/false, timeout);
+}
+
+EventFlags::Flags EventFlags::try_wait_all_for(Flags flags,
+                                               SystemClock::duration timeout) {
+  CheckWaitFlags(flags);
+  return TryGetFlagsFor(native_type_, flags, /*wait_for_all=*/true, timeout);
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,80 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/event_flags.h"
+#include "tx_api.h"
+
+namespace pw::sync {
+namespace backend {
+
+inline constexpr char kEventFlagsName[] = "pw::EventFlags";
+
+}  // namespace backend
+
+inline EventFlags::EventFlags() : native_type_() {
+  PW_ASSERT(tx_event_flags_create(&native_type_,
+                                  const_cast<char*>(backend::kEventFlagsName)) ==
+            TX_SUCCESS);
+}
+
+inline EventFlags::~EventFlags() {
+  PW_ASSERT(tx_event_flags_delete(&native_type_) == TX_SUCCESS);
+}
+
+inline void EventFlags::set(Flags flags) {
+  PW_DASSERT((flags & ~kAllFlags) == 0u);
+  PW_ASSERT(tx_event_flags_set(
+                &native_type_, static_cast<ULONG>(flags), TX_OR) == TX_SUCCESS);
+}
+
+inline void EventFlags::clear(Flags flags) {
+  PW_DASSERT((flags & ~kAllFlags) == 0u);
+  PW_ASSERT(tx_event_flags_set(&native_type_,
+                               ~static_cast<ULONG>(flags),
+                               TX_AND) == TX_SUCCESS);
+}
+
+inline EventFlags::Flags EventFlags::get() {
+  ULONG current = 0;
+  PW_ASSERT(tx_event_flags_info_get(&native_type_,
+                                    TX_NULL,
+                                    &current,
+                                    TX_NULL,
+                                    TX_NULL,
+                                    TX_NULL) == TX_SUCCESS);
+  return static_cast<Flags>(current);
+}
+
+inline EventFlags::Flags EventFlags::try_wait_any_until(
+    Flags flags, chrono::SystemClock::time_point deadline) {
+  // Note that if this deadline is in the future, it will get rounded up by
+  // one whole tick due to how try_wait_any_for is implemented.
+  return try_wait_any_for(flags, deadline - chrono::SystemClock::now());
+}
+
+inline EventFlags::Flags EventFlags::try_wait_all_until(
+    Flags flags, chrono::SystemClock::time_point deadline) {
+  // Note that if this deadline is in the future, it will get rounded up by
+  // one whole tick due to how try_wait_all_for is implemented.
+  return try_wait_all_for(flags, deadline - chrono::SystemClock::now());
+}
+
+inline EventFlags::native_handle_type EventFlags::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
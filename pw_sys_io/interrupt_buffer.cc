@@ -0,0 +1,136 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sys_io/interrupt_buffer.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace pw::sys_io {
+namespace internal {
+
+size_t ByteRingBuffer::Push(ConstByteSpan data) {
+  const size_t count = std::min(data.size(), storage_.size() - size_);
+  for (size_t i = 0; i < count; ++i) {
+    storage_[(head_ + size_ + i) % storage_.size()] = data[i];
+  }
+  size_ += count;
+  return count;
+}
+
+size_t ByteRingBuffer::Pop(ByteSpan dest) {
+  const size_t count = std::min(dest.size(), size_);
+  for (size_t i = 0; i < count; ++i) {
+    dest[i] = storage_[(head_ + i) % storage_.size()];
+  }
+  Discard(count);
+  return count;
+}
+
+ConstByteSpan ByteRingBuffer::Contiguous() const {
+  return ConstByteSpan(storage_).subspan(
+      head_, std::min(size_, storage_.size() - head_));
+}
+
+void ByteRingBuffer::Discard(size_t count) {
+  count = std::min(count, size_);
+  if (count == 0u) {
+    return;
+  }
+  head_ = (head_ + count) % storage_.size();
+  size_ -= count;
+}
+
+}  // namespace internal
+
+size_t InterruptRxBuffer::Push(ConstByteSpan data) {
+  size_t stored;
+  {
+    std::lock_guard lock(lock_);
+    stored = ring_.Push(data);
+    dropped_bytes_ += data.size() - stored;
+  }
+  if (stored != 0u) {
+    data_available_.release();
+  }
+  return stored;
+}
+
+StatusWithSize InterruptRxBuffer::ReadAvailable(ByteSpan dest) {
+  if (dest.empty()) {
+    return StatusWithSize(0);
+  }
+  while (true) {
+    {
+      std::lock_guard lock(lock_);
+      if (const size_t read = ring_.Pop(dest); read != 0u) {
+        return StatusWithSize(read);
+      }
+    }
+    data_available_.acquire();
+  }
+}
+
+StatusWithSize InterruptRxBuffer::TryRead(ByteSpan dest) {
+  std::lock_guard lock(lock_);
+  if (ring_.empty()) {
+    return StatusWithSize::Unavailable();
+  }
+  return StatusWithSize(ring_.Pop(dest));
+}
+
+size_t InterruptRxBuffer::dropped_bytes() const {
+  std::lock_guard lock(lock_);
+  return dropped_bytes_;
+}
+
+StatusWithSize InterruptTxBuffer::Write(ConstByteSpan data) {
+  size_t written = 0;
+  while (true) {
+    {
+      std::lock_guard lock(lock_);
+      written += ring_.Push(data.subspan(written));
+      if (!transmitting_ && !ring_.empty()) {
+        transmitting_ = true;
+        StartTransmit();
+      }
+    }
+    if (written == data.size()) {
+      return StatusWithSize(written);
+    }
+    space_available_.acquire();
+  }
+}
+
+ConstByteSpan InterruptTxBuffer::PendingTransmit() {
+  std::lock_guard lock(lock_);
+  if (ring_.empty()) {
+    if (transmitting_) {
+      transmitting_ = false;
+      StopTransmit();
+    }
+    return ConstByteSpan();
+  }
+  return ring_.Contiguous();
+}
+
+void InterruptTxBuffer::TransmitComplete(size_t count) {
+  {
+    std::lock_guard lock(lock_);
+    ring_.Discard(count);
+  }
+  space_available_.release();
+}
+
+}  // namespace pw::sys_io
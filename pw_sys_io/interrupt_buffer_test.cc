@@ -0,0 +1,148 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sys_io/interrupt_buffer.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::sys_io {
+namespace {
+
+TEST(InterruptRxBuffer, ReadsPushedBytes) {
+  std::array<std::byte, 8> storage;
+  InterruptRxBuffer rx(storage);
+
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  EXPECT_EQ(rx.Push(kData), 3u);
+
+  std::array<std::byte, 8> dest = {};
+  StatusWithSize result = rx.ReadAvailable(dest);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 3u);
+  EXPECT_EQ(std::memcmp(dest.data(), kData, sizeof(kData)), 0);
+}
+
+TEST(InterruptRxBuffer, ReadsInPiecesAcrossWraparound) {
+  std::array<std::byte, 4> storage;
+  InterruptRxBuffer rx(storage);
+  std::array<std::byte, 3> dest = {};
+
+  constexpr std::byte kFirst[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  ASSERT_EQ(rx.Push(kFirst), 3u);
+  ASSERT_EQ(rx.ReadAvailable(dest).size(), 3u);
+
+  // Wraps around the end of storage.
+  constexpr std::byte kSecond[] = {std::byte{4}, std::byte{5}, std::byte{6}};
+  ASSERT_EQ(rx.Push(kSecond), 3u);
+
+  StatusWithSize result = rx.ReadAvailable(std::span(dest).first(2));
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(dest[0], std::byte{4});
+  EXPECT_EQ(dest[1], std::byte{5});
+
+  result = rx.ReadAvailable(dest);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(dest[0], std::byte{6});
+}
+
+TEST(InterruptRxBuffer, CountsDroppedBytes) {
+  std::array<std::byte, 2> storage;
+  InterruptRxBuffer rx(storage);
+
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  EXPECT_EQ(rx.Push(kData), 2u);
+  EXPECT_EQ(rx.Push(kData), 0u);
+  EXPECT_EQ(rx.dropped_bytes(), 4u);
+}
+
+TEST(InterruptRxBuffer, TryReadWhenEmpty) {
+  std::array<std::byte, 4> storage;
+  InterruptRxBuffer rx(storage);
+  std::array<std::byte, 4> dest;
+
+  EXPECT_EQ(rx.TryRead(dest).status(), Status::Unavailable());
+
+  constexpr std::byte kData[] = {std::byte{7}};
+  rx.Push(kData);
+  StatusWithSize result = rx.TryRead(dest);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 1u);
+  EXPECT_EQ(rx.TryRead(dest).status(), Status::Unavailable());
+}
+
+class TestTxBuffer : public InterruptTxBuffer {
+ public:
+  TestTxBuffer() : InterruptTxBuffer(storage_) {}
+
+  int starts() const { return starts_; }
+  int stops() const { return stops_; }
+
+ private:
+  void StartTransmit() override { starts_ += 1; }
+  void StopTransmit() override { stops_ += 1; }
+
+  std::array<std::byte, 4> storage_;
+  int starts_ = 0;
+  int stops_ = 0;
+};
+
+TEST(InterruptTxBuffer, StartsAndStopsTransmitter) {
+  TestTxBuffer tx;
+
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}};
+  ASSERT_EQ(tx.Write(kData).size(), 2u);
+  EXPECT_EQ(tx.starts(), 1);
+
+  // Writing while transmitting does not restart the transmitter.
+  ASSERT_EQ(tx.Write(kData).size(), 2u);
+  EXPECT_EQ(tx.starts(), 1);
+
+  ConstByteSpan pending = tx.PendingTransmit();
+  ASSERT_EQ(pending.size(), 4u);
+  EXPECT_EQ(pending[0], std::byte{1});
+  EXPECT_EQ(pending[3], std::byte{2});
+  tx.TransmitComplete(pending.size());
+
+  EXPECT_TRUE(tx.PendingTransmit().empty());
+  EXPECT_EQ(tx.stops(), 1);
+
+  ASSERT_EQ(tx.Write(kData).size(), 2u);
+  EXPECT_EQ(tx.starts(), 2);
+}
+
+TEST(InterruptTxBuffer, PendingIsContiguous) {
+  TestTxBuffer tx;
+
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  ASSERT_EQ(tx.Write(kData).size(), 3u);
+  tx.TransmitComplete(tx.PendingTransmit().size());
+
+  // Wraps around the end of storage, so it is sent in two runs.
+  ASSERT_EQ(tx.Write(kData).size(), 3u);
+  ConstByteSpan pending = tx.PendingTransmit();
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0], std::byte{1});
+  tx.TransmitComplete(1);
+
+  pending = tx.PendingTransmit();
+  ASSERT_EQ(pending.size(), 2u);
+  EXPECT_EQ(pending[0], std::byte{2});
+  EXPECT_EQ(pending[1], std::byte{3});
+}
+
+}  // namespace
+}  // namespace pw::sys_io
@@ -0,0 +1,142 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+// Buffers for interrupt- or DMA-driven pw_sys_io backends.
+//
+// The pw_sys_io functions are blocking calls made from threads. A backend that
+// moves data with interrupts or DMA can use these buffers to implement them:
+// the interrupt handler exchanges data with the buffer, and the thread side
+// blocks on a notification instead of polling the peripheral.
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+
+namespace pw::sys_io {
+namespace internal {
+
+// Fixed-capacity byte FIFO over caller-provided storage. Not thread safe.
+class ByteRingBuffer {
+ public:
+  explicit constexpr ByteRingBuffer(ByteSpan storage) : storage_(storage) {}
+
+  // Appends as many bytes from data as fit. Returns the number appended.
+  size_t Push(ConstByteSpan data);
+
+  // Removes up to dest.size() bytes into dest. Returns the number removed.
+  size_t Pop(ByteSpan dest);
+
+  // The longest run of queued bytes that is contiguous in storage.
+  ConstByteSpan Contiguous() const;
+
+  // Removes up to count bytes without copying them.
+  void Discard(size_t count);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0u; }
+
+ private:
+  ByteSpan storage_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace internal
+
+// Receive buffer filled from an interrupt handler and read by threads.
+class InterruptRxBuffer {
+ public:
+  explicit InterruptRxBuffer(ByteSpan storage) : ring_(storage) {}
+
+  InterruptRxBuffer(const InterruptRxBuffer&) = delete;
+  InterruptRxBuffer& operator=(const InterruptRxBuffer&) = delete;
+
+  // Stores received bytes and wakes a blocked reader. Bytes that do not fit
+  // are dropped and counted in dropped_bytes(). Safe to call from interrupts.
+  //
+  // Returns the number of bytes stored.
+  size_t Push(ConstByteSpan data) PW_LOCKS_EXCLUDED(lock_);
+
+  // Blocks until at least one byte is available, then reads as many buffered
+  // bytes as fit in dest without blocking again.
+  //
+  // Returns OkStatus() with the number of bytes read, which is only zero if
+  // dest is empty.
+  StatusWithSize ReadAvailable(ByteSpan dest) PW_LOCKS_EXCLUDED(lock_);
+
+  // Reads as many buffered bytes as fit in dest without blocking.
+  //
+  // Returns OkStatus() with the number of bytes read, or Unavailable() if no
+  // bytes are buffered.
+  StatusWithSize TryRead(ByteSpan dest) PW_LOCKS_EXCLUDED(lock_);
+
+  // Bytes dropped because the buffer was full.
+  size_t dropped_bytes() const PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  mutable sync::InterruptSpinLock lock_;
+  sync::ThreadNotification data_available_;
+  internal::ByteRingBuffer ring_ PW_GUARDED_BY(lock_);
+  size_t dropped_bytes_ PW_GUARDED_BY(lock_) = 0;
+};
+
+// Transmit buffer written by threads and drained by an interrupt handler or
+// DMA. Backends derive from it and implement StartTransmit() and
+// StopTransmit() to enable and disable their transmit interrupt or DMA.
+class InterruptTxBuffer {
+ public:
+  InterruptTxBuffer(const InterruptTxBuffer&) = delete;
+  InterruptTxBuffer& operator=(const InterruptTxBuffer&) = delete;
+
+  virtual ~InterruptTxBuffer() = default;
+
+  // Queues data for transmission, starting the transmitter if it is idle.
+  // Blocks while the buffer is full until all of data is queued.
+  //
+  // Returns OkStatus() with the number of bytes queued.
+  StatusWithSize Write(ConstByteSpan data) PW_LOCKS_EXCLUDED(lock_);
+
+  // Interrupt side: returns the next contiguous run of bytes to send, which
+  // stays queued until TransmitComplete() is called. If nothing is queued,
+  // calls StopTransmit() and returns an empty span.
+  ConstByteSpan PendingTransmit() PW_LOCKS_EXCLUDED(lock_);
+
+  // Interrupt side: removes count sent bytes from the buffer and wakes a
+  // blocked writer.
+  void TransmitComplete(size_t count) PW_LOCKS_EXCLUDED(lock_);
+
+ protected:
+  explicit InterruptTxBuffer(ByteSpan storage) : ring_(storage) {}
+
+ private:
+  // Called with an interrupt spin lock held when data is queued while the
+  // transmitter is idle, and when the queue runs empty. Implementations must
+  // only enable or disable the transmit interrupt or DMA; they must not block
+  // or call back into this buffer.
+  virtual void StartTransmit() = 0;
+  virtual void StopTransmit() = 0;
+
+  sync::InterruptSpinLock lock_;
+  sync::ThreadNotification space_available_;
+  internal::ByteRingBuffer ring_ PW_GUARDED_BY(lock_);
+  bool transmitting_ PW_GUARDED_BY(lock_) = false;
+};
+
+}  // namespace pw::sys_io
@@ -98,6 +98,22 @@ StatusWithSize WriteLine(const std::string_view& s);
 // destination span are returned as part of the StatusWithSize.
 StatusWithSize ReadBytes(std::span<std::byte> dest);
 
+// Read at least one byte, and then any further bytes that are already
+// available, into a byte std::span from the sys io backend.
+// Implemented by: Facade
+//
+// This function is implemented by this facade using ReadByte() for the first
+// byte and TryReadByte() for the rest, stopping once TryReadByte() reports that
+// no more bytes are available. Backends that buffer received data, such as
+// with interrupts or DMA, can instead provide this function along with
+// ReadBytes() and WriteBytes() to copy all of the buffered bytes at once.
+// Unlike ReadBytes(), this only blocks until the first byte arrives.
+//
+// Return status is OkStatus() if at least one byte was read, or if the
+// destination span is empty. In all cases, the number of bytes successfully
+// read to the destination span are returned as part of the StatusWithSize.
+StatusWithSize ReadAvailableBytes(std::span<std::byte> dest);
+
 // Write std::span of bytes out the sys io backend using WriteByte().
 // Implemented by: Facade
 //
@@ -26,6 +26,28 @@ StatusWithSize ReadBytes(std::span<std::byte> dest) {
   return StatusWithSize(dest.size_bytes());
 }
 
+StatusWithSize ReadAvailableBytes(std::span<std::byte> dest) {
+  if (dest.empty()) {
+    return StatusWithSize(0);
+  }
+
+  Status result = ReadByte(&dest[0]);
+  if (!result.ok()) {
+    return StatusWithSize(result, 0);
+  }
+
+  for (size_t i = 1; i < dest.size_bytes(); ++i) {
+    result = TryReadByte(&dest[i]);
+    if (result.IsUnavailable() || result.IsUnimplemented()) {
+      return StatusWithSize(i);
+    }
+    if (!result.ok()) {
+      return StatusWithSize(result, i);
+    }
+  }
+  return StatusWithSize(dest.size_bytes());
+}
+
 StatusWithSize WriteBytes(std::span<const std::byte> src) {
   for (size_t i = 0; i < src.size_bytes(); ++i) {
     Status result = WriteByte(src[i]);
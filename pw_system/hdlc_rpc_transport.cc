@@ -0,0 +1,44 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_system/hdlc_rpc_transport.h"
+
+#include "pw_log/log.h"
+#include "pw_rpc/server.h"
+#include "pw_system/rpc_server.h"
+
+namespace pw::system {
+
+Status HdlcRpcTransport::Open() {
+  return GetRpcServer().OpenChannel(channel_id_, output_);
+}
+
+void HdlcRpcTransport::Run() {
+  PW_LOG_INFO("Running RPC server on channel %u",
+              static_cast<unsigned>(channel_id_));
+  while (true) {
+    Result<ByteSpan> read = reader_.Read(read_buffer_);
+    if (read.ok()) {
+      decoder_.Process(read.value(), &HdlcRpcTransport::ProcessFrame, this);
+    }
+  }
+}
+
+void HdlcRpcTransport::ProcessFrame(const Result<hdlc::Frame>& result) {
+  if (result.ok() && result.value().address() == hdlc_address_) {
+    GetRpcServer().ProcessPacket(result.value().data(), output_);
+  }
+}
+
+}  // namespace pw::system
@@ -36,6 +36,16 @@
 #define PW_SYSTEM_MAX_TRANSMISSION_UNIT 512
 #endif  // PW_SYSTEM_MAX_TRANSMISSION_UNIT
 
+// PW_SYSTEM_RPC_RX_BUFFER_SIZE is the size of the buffer the RPC server reads
+// incoming data into. Frames that arrive entirely within one read and have no
+// escaped bytes are decoded in place from this buffer, without being copied to
+// the HDLC decoder's frame buffer.
+//
+// Defaults to PW_SYSTEM_MAX_TRANSMISSION_UNIT.
+#ifndef PW_SYSTEM_RPC_RX_BUFFER_SIZE
+#define PW_SYSTEM_RPC_RX_BUFFER_SIZE PW_SYSTEM_MAX_TRANSMISSION_UNIT
+#endif  // PW_SYSTEM_RPC_RX_BUFFER_SIZE
+
 // PW_SYSTEM_DEFAULT_CHANNEL_ID RPC channel ID to host.
 //
 // Defaults to 1.
@@ -43,6 +53,15 @@
 #define PW_SYSTEM_DEFAULT_CHANNEL_ID 1
 #endif  // PW_SYSTEM_DEFAULT_CHANNEL_ID
 
+// PW_SYSTEM_EXTRA_RPC_CHANNELS is the number of unassigned RPC channels
+// reserved for additional transports, each opened with
+// pw::system::HdlcRpcTransport::Open().
+//
+// Defaults to 0.
+#ifndef PW_SYSTEM_EXTRA_RPC_CHANNELS
+#define PW_SYSTEM_EXTRA_RPC_CHANNELS 0
+#endif  // PW_SYSTEM_EXTRA_RPC_CHANNELS
+
 // PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS RPC HDLC default address.
 //
 // Defaults to 82.
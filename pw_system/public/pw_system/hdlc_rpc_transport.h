@@ -0,0 +1,110 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/rpc_channel.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_system/config.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::system {
+
+// Serves the pw_system RPC server over an HDLC-framed stream on one RPC
+// channel. Run() continuously reads from the stream and dispatches the frames
+// sent to this transport's HDLC address.
+//
+// The primary transport serves kDefaultRpcChannelId over the pw_system I/O
+// streams. Additional transports, such as a USB CDC or socket link, are each
+// served by another HdlcRpcTransport on its own thread and channel, so heavy
+// traffic such as transfers can move to a faster link while logs stay on the
+// default channel.
+class HdlcRpcTransport : public thread::ThreadCore {
+ public:
+  HdlcRpcTransport(stream::Reader& reader,
+                   stream::Writer& writer,
+                   uint32_t channel_id,
+                   uint64_t hdlc_address,
+                   const char* channel_name,
+                   ByteSpan frame_buffer,
+                   ByteSpan read_buffer)
+      : reader_(reader),
+        output_(writer, hdlc_address, channel_name),
+        decoder_(frame_buffer),
+        read_buffer_(read_buffer),
+        channel_id_(channel_id),
+        hdlc_address_(hdlc_address) {}
+
+  HdlcRpcTransport(const HdlcRpcTransport&) = delete;
+  HdlcRpcTransport& operator=(const HdlcRpcTransport&) = delete;
+
+  // Opens this transport's channel on the pw_system RPC server. Call this
+  // before starting the transport's thread. Each additional transport uses one
+  // of the PW_SYSTEM_EXTRA_RPC_CHANNELS unassigned channels.
+  //
+  // Returns:
+  //   OK: The channel was opened.
+  //   ALREADY_EXISTS: Another channel already uses this channel ID.
+  //   RESOURCE_EXHAUSTED: No unassigned channels are available.
+  Status Open();
+
+  uint32_t channel_id() const { return channel_id_; }
+
+  hdlc::RpcChannelOutput& output() { return output_; }
+
+ private:
+  void Run() override;
+
+  void ProcessFrame(const Result<hdlc::Frame>& result);
+
+  stream::Reader& reader_;
+  hdlc::RpcChannelOutput output_;
+  hdlc::Decoder decoder_;
+  const ByteSpan read_buffer_;
+  const uint32_t channel_id_;
+  const uint64_t hdlc_address_;
+};
+
+// An HdlcRpcTransport that declares its own frame and read buffers.
+template <size_t kReadBufferSize = PW_SYSTEM_RPC_RX_BUFFER_SIZE,
+          size_t kFrameBufferSize = PW_SYSTEM_MAX_TRANSMISSION_UNIT>
+class HdlcRpcTransportWithBuffers : public HdlcRpcTransport {
+ public:
+  HdlcRpcTransportWithBuffers(stream::Reader& reader,
+                              stream::Writer& writer,
+                              uint32_t channel_id,
+                              uint64_t hdlc_address,
+                              const char* channel_name)
+      : HdlcRpcTransport(reader,
+                         writer,
+                         channel_id,
+                         hdlc_address,
+                         channel_name,
+                         frame_buffer_,
+                         read_buffer_) {}
+
+ private:
+  std::array<std::byte, kFrameBufferSize> frame_buffer_;
+  std::array<std::byte, kReadBufferSize> read_buffer_;
+};
+
+}  // namespace pw::system
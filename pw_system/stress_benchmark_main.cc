@@ -0,0 +1,686 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Runs log producers, RPC streams, and transfers at the same time on host to
+// measure how they contend with each other:
+//
+//   - Log producers write entries to a MultiSink, which one drain reads.
+//   - Each RPC stream echoes payloads through BidirectionalEcho on its own
+//     ClientServer. All of them share the global RPC mutex.
+//   - Transfers read from a TransferService on another ClientServer. One
+//     transfer thread handles every transfer's client and server side.
+//
+// Each workload first runs alone, then all of them run together. For the
+// combined run, logs each workload's throughput and tail latency. Time spent
+// waiting for locks is estimated from the calls that take them,
+// MultiSink::HandleEntry and RawClientReaderWriter::Write: on average, the
+// calls take longer in the combined run than alone by about the time they
+// waited.
+//
+//   stress_benchmark [LOG_PRODUCERS [RPC_STREAMS [TRANSFERS]]]
+
+#define PW_LOG_MODULE_NAME "STRESS"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_multisink/multisink.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/benchmark.raw_rpc.pb.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/client_server.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/thread_core.h"
+#include "pw_thread/yield.h"
+#include "pw_thread_stl/options.h"
+#include "pw_transfer/client.h"
+#include "pw_transfer/handler.h"
+#include "pw_transfer/transfer.h"
+#include "pw_transfer/transfer_thread.h"
+
+namespace pw::system {
+namespace {
+
+static_assert(PW_RPC_USE_GLOBAL_MUTEX,
+              "The stress benchmark calls pw_rpc from several threads, so it "
+              "requires PW_RPC_USE_GLOBAL_MUTEX");
+
+using Clock = std::chrono::steady_clock;
+using pw_rpc::raw::Benchmark;
+using namespace std::chrono_literals;
+
+constexpr uint32_t kChannelId = 1;
+
+constexpr size_t kLogsPerProducer = 20000;
+constexpr size_t kLogEntrySizeBytes = 32;
+constexpr size_t kMultiSinkBufferSizeBytes = 8192;
+
+constexpr size_t kEchoesPerStream = 2000;
+constexpr size_t kEchoPayloadSizeBytes = 32;
+constexpr auto kEchoTimeout = 1s;
+
+constexpr size_t kMaxTransfers = 4;
+constexpr size_t kReadsPerTransfer = 8;
+constexpr size_t kTransferSizeBytes = 8192;
+constexpr size_t kChunkBufferSizeBytes = 1024;
+constexpr uint32_t kMaxPendingBytes = 4096;
+constexpr auto kChunkTimeout = 250ms;
+constexpr auto kTransferTimeout = 30s;
+
+std::array<std::byte, kTransferSizeBytes> source_data;
+
+struct Workloads {
+  size_t log_producers;
+  size_t rpc_streams;
+  size_t transfers;
+};
+
+// Durations of one kind of operation.
+class Latencies {
+ public:
+  void Reserve(size_t count) { samples_.reserve(count); }
+
+  void Record(Clock::duration duration) { samples_.push_back(duration); }
+
+  void Add(const Latencies& other) {
+    samples_.insert(
+        samples_.end(), other.samples_.begin(), other.samples_.end());
+  }
+
+  size_t count() const { return samples_.size(); }
+
+  Clock::duration Mean() const {
+    if (samples_.empty()) {
+      return {};
+    }
+    Clock::duration total{};
+    for (Clock::duration sample : samples_) {
+      total += sample;
+    }
+    return total / samples_.size();
+  }
+
+  // Returns the sample at the given percentile, from 0 to 100. Reorders the
+  // samples.
+  Clock::duration Percentile(size_t percent) {
+    if (samples_.empty()) {
+      return {};
+    }
+    const auto nth =
+        samples_.begin() +
+        std::min(samples_.size() - 1, samples_.size() * percent / 100);
+    std::nth_element(samples_.begin(), nth, samples_.end());
+    return *nth;
+  }
+
+ private:
+  std::vector<Clock::duration> samples_;
+};
+
+unsigned Nanoseconds(Clock::duration duration) {
+  return static_cast<unsigned>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+unsigned Microseconds(Clock::duration duration) {
+  return static_cast<unsigned>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+// Runs thread cores on threads, which are joined together.
+class Threads {
+ public:
+  void Start(thread::ThreadCore& core) {
+    threads_.emplace_back(options_, core);
+  }
+
+  void JoinAll() {
+    for (thread::Thread& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+  }
+
+ private:
+  thread::stl::Options options_;
+  std::deque<thread::Thread> threads_;  // Threads are not movable.
+};
+
+// Writes entries to a MultiSink and times each write.
+class LogProducer final : public thread::ThreadCore {
+ public:
+  LogProducer(multisink::MultiSink& sink, size_t id) : sink_(sink), id_(id) {
+    calls_.Reserve(kLogsPerProducer);
+  }
+
+  Latencies& calls() { return calls_; }
+
+ private:
+  void Run() override {
+    std::array<std::byte, kLogEntrySizeBytes> entry;
+    entry.fill(static_cast<std::byte>(id_));
+
+    for (size_t i = 0; i < kLogsPerProducer; ++i) {
+      const Clock::time_point start = Clock::now();
+      sink_.HandleEntry(entry);
+      calls_.Record(Clock::now() - start);
+    }
+  }
+
+  multisink::MultiSink& sink_;
+  const size_t id_;
+  Latencies calls_;
+};
+
+// Reads entries from a MultiSink as fast as it can until stopped.
+class LogDrain final : public thread::ThreadCore {
+ public:
+  LogDrain(multisink::MultiSink& sink)
+      : sink_(sink), stopped_(false), entries_(0), dropped_(0) {
+    sink_.AttachDrain(drain_);
+  }
+
+  ~LogDrain() { sink_.DetachDrain(drain_); }
+
+  // Stops the drain once it has read every entry. Entries must no longer be
+  // added to the MultiSink.
+  void Stop() { stopped_ = true; }
+
+  size_t entries() const { return entries_; }
+  size_t dropped() const { return dropped_; }
+
+ private:
+  void Run() override {
+    std::array<std::byte, 512> buffer;
+    std::array<ConstByteSpan, 16> entries;
+
+    while (true) {
+      // Stop only if the MultiSink was empty after the drain was stopped.
+      const bool stopping = stopped_;
+
+      uint32_t drop_count = 0;
+      uint32_t ingress_drop_count = 0;
+      const Result<size_t> count =
+          drain_.PopEntries(buffer, entries, drop_count, ingress_drop_count);
+      dropped_ += drop_count + ingress_drop_count;
+
+      if (count.ok()) {
+        entries_ += count.value();
+      } else if (stopping) {
+        return;
+      } else {
+        this_thread::yield();
+      }
+    }
+  }
+
+  multisink::MultiSink& sink_;
+  multisink::MultiSink::Drain drain_;
+  std::atomic<bool> stopped_;
+  size_t entries_;
+  size_t dropped_;
+};
+
+// Passes packets sent on a channel back to a ClientServer from its own thread.
+// Packets are copied and queued, so a packet is never processed from within
+// the call that sent another one.
+class LoopbackQueue final : public rpc::ChannelOutput,
+                            public thread::ThreadCore {
+ public:
+  LoopbackQueue(const char* name)
+      : rpc::ChannelOutput(name), destination_(nullptr), stopped_(false) {}
+
+  void set_destination(rpc::ClientServer& destination) {
+    destination_ = &destination;
+  }
+
+  Status Send(ConstByteSpan packet) override {
+    std::lock_guard lock(mutex_);
+    packets_.emplace_back(packet.begin(), packet.end());
+    ready_.notify_one();
+    return OkStatus();
+  }
+
+  void Stop() {
+    std::lock_guard lock(mutex_);
+    stopped_ = true;
+    ready_.notify_one();
+  }
+
+ private:
+  void Run() override {
+    std::unique_lock lock(mutex_);
+    while (!stopped_) {
+      if (packets_.empty()) {
+        ready_.wait(lock);
+        continue;
+      }
+
+      std::vector<std::byte> packet = std::move(packets_.front());
+      packets_.pop_front();
+
+      lock.unlock();
+      destination_->ProcessPacket(std::as_bytes(std::span(packet)))
+          .IgnoreError();
+      lock.lock();
+    }
+  }
+
+  rpc::ClientServer* destination_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::vector<std::byte>> packets_;
+  bool stopped_;
+};
+
+// Echoes payloads through BidirectionalEcho on its own ClientServer, one at a
+// time, and times each Write() call and round trip.
+class EchoStream final : public thread::ThreadCore {
+ public:
+  EchoStream()
+      : queue_("echo"),
+        channels_{rpc::Channel::Create<kChannelId>(&queue_)},
+        client_server_(channels_),
+        failures_(0) {
+    client_server_.server().RegisterService(service_);
+    queue_.set_destination(client_server_);
+    writes_.Reserve(kEchoesPerStream);
+    round_trips_.Reserve(kEchoesPerStream);
+  }
+
+  LoopbackQueue& queue() { return queue_; }
+
+  Latencies& writes() { return writes_; }
+  Latencies& round_trips() { return round_trips_; }
+  size_t failures() const { return failures_; }
+
+ private:
+  void Run() override {
+    Benchmark::Client client(client_server_.client(), kChannelId);
+    rpc::RawClientReaderWriter call = client.BidirectionalEcho(
+        [this](ConstByteSpan) { echoed_.release(); },
+        [](Status) {},
+        [](Status status) {
+          PW_LOG_ERROR("BidirectionalEcho failed with %s", status.str());
+        });
+
+    const std::array<std::byte, kEchoPayloadSizeBytes> payload = {};
+    for (size_t i = 0; i < kEchoesPerStream; ++i) {
+      const Clock::time_point start = Clock::now();
+      const Status status = call.Write(payload);
+      const Clock::time_point written = Clock::now();
+
+      if (!status.ok() ||
+          !echoed_.try_acquire_for(
+              chrono::SystemClock::for_at_least(kEchoTimeout))) {
+        failures_ += 1;
+        break;
+      }
+      writes_.Record(written - start);
+      round_trips_.Record(Clock::now() - start);
+    }
+
+    call.Cancel().IgnoreError();
+  }
+
+  LoopbackQueue queue_;
+  rpc::Channel channels_[1];
+  rpc::ClientServer client_server_;
+  rpc::BenchmarkService service_;
+
+  sync::BinarySemaphore echoed_;
+  Latencies writes_;
+  Latencies round_trips_;
+  size_t failures_;
+};
+
+// A transfer client and service on one ClientServer. One transfer thread
+// handles both.
+class TransferLink {
+ public:
+  TransferLink()
+      : queue_("transfer"),
+        channels_{rpc::Channel::Create<kChannelId>(&queue_)},
+        client_server_(channels_),
+        transfer_thread_(chunk_buffer_, encode_buffer_),
+        service_(transfer_thread_,
+                 kMaxPendingBytes,
+                 chrono::SystemClock::for_at_least(kChunkTimeout)),
+        client_(client_server_.client(),
+                kChannelId,
+                transfer_thread_,
+                kMaxPendingBytes) {
+    client_server_.server().RegisterService(service_);
+    queue_.set_destination(client_server_);
+  }
+
+  void Start(Threads& threads) {
+    threads.Start(queue_);
+    threads.Start(transfer_thread_);
+  }
+
+  void Stop() {
+    transfer_thread_.Terminate();
+    queue_.Stop();
+  }
+
+  transfer::TransferService& service() { return service_; }
+  transfer::Client& client() { return client_; }
+
+ private:
+  LoopbackQueue queue_;
+  rpc::Channel channels_[1];
+  rpc::ClientServer client_server_;
+
+  std::array<std::byte, kChunkBufferSizeBytes> chunk_buffer_;
+  std::array<std::byte, kChunkBufferSizeBytes> encode_buffer_;
+  transfer::Thread<kMaxTransfers, kMaxTransfers> transfer_thread_;
+
+  transfer::TransferService service_;
+  transfer::Client client_;
+};
+
+// Reads source_data from a TransferLink's service several times in a row, and
+// times each transfer.
+class TransferWorker final : public thread::ThreadCore {
+ public:
+  TransferWorker(TransferLink& link, uint32_t transfer_id)
+      : link_(link),
+        transfer_id_(transfer_id),
+        handler_(transfer_id, source_data),
+        destination_data_{},
+        destination_(destination_data_),
+        failures_(0) {}
+
+  Latencies& transfers() { return transfers_; }
+  size_t failures() const { return failures_; }
+
+ private:
+  void Run() override {
+    link_.service().RegisterHandler(handler_);
+
+    for (size_t i = 0; i < kReadsPerTransfer; ++i) {
+      destination_.Seek(0).IgnoreError();
+
+      const Clock::time_point start = Clock::now();
+      const Status started = link_.client().Read(
+          transfer_id_,
+          destination_,
+          [this](Status status) {
+            status_ = status;
+            completed_.release();
+          },
+          chrono::SystemClock::for_at_least(kChunkTimeout));
+      if (!started.ok()) {
+        failures_ += 1;
+        continue;
+      }
+
+      if (!completed_.try_acquire_for(
+              chrono::SystemClock::for_at_least(kTransferTimeout))) {
+        PW_LOG_ERROR("Transfer %u timed out", static_cast<unsigned>(i));
+        failures_ += 1;
+        break;  // The transfer may still be running, so stop here.
+      }
+
+      if (!status_.ok() || destination_.bytes_written() != kTransferSizeBytes ||
+          !std::equal(source_data.begin(),
+                      source_data.end(),
+                      destination_data_.begin())) {
+        failures_ += 1;
+        continue;
+      }
+      transfers_.Record(Clock::now() - start);
+    }
+
+    link_.service().UnregisterHandler(handler_);
+  }
+
+  TransferLink& link_;
+  const uint32_t transfer_id_;
+  transfer::MemoryMappedReadHandler handler_;
+
+  std::array<std::byte, kTransferSizeBytes> destination_data_;
+  stream::MemoryWriter destination_;
+
+  Status status_;
+  sync::BinarySemaphore completed_;
+  Latencies transfers_;
+  size_t failures_;
+};
+
+struct Results {
+  Clock::duration elapsed{};
+
+  Latencies log_calls;
+  size_t logs_drained = 0;
+  size_t logs_dropped = 0;
+
+  Latencies echo_writes;
+  Latencies echo_round_trips;
+  size_t echo_failures = 0;
+
+  Latencies transfers;
+  size_t transfer_failures = 0;
+};
+
+Results Run(const Workloads& workloads) {
+  std::vector<std::byte> sink_buffer(kMultiSinkBufferSizeBytes);
+  multisink::MultiSink sink(sink_buffer);
+  LogDrain drain(sink);
+
+  std::vector<std::unique_ptr<LogProducer>> producers;
+  for (size_t i = 0; i < workloads.log_producers; ++i) {
+    producers.push_back(std::make_unique<LogProducer>(sink, i));
+  }
+
+  std::vector<std::unique_ptr<EchoStream>> streams;
+  for (size_t i = 0; i < workloads.rpc_streams; ++i) {
+    streams.push_back(std::make_unique<EchoStream>());
+  }
+
+  std::unique_ptr<TransferLink> link;
+  std::vector<std::unique_ptr<TransferWorker>> workers;
+  if (workloads.transfers > 0u) {
+    link = std::make_unique<TransferLink>();
+  }
+  for (size_t i = 0; i < workloads.transfers; ++i) {
+    workers.push_back(
+        std::make_unique<TransferWorker>(*link, static_cast<uint32_t>(i + 1)));
+  }
+
+  // Start the threads that service the workloads, then the workloads.
+  Threads service_threads;
+  if (!producers.empty()) {
+    service_threads.Start(drain);
+  }
+  for (auto& stream : streams) {
+    service_threads.Start(stream->queue());
+  }
+  if (link != nullptr) {
+    link->Start(service_threads);
+  }
+
+  Threads workload_threads;
+  const Clock::time_point start = Clock::now();
+  for (auto& producer : producers) {
+    workload_threads.Start(*producer);
+  }
+  for (auto& stream : streams) {
+    workload_threads.Start(*stream);
+  }
+  for (auto& worker : workers) {
+    workload_threads.Start(*worker);
+  }
+  workload_threads.JoinAll();
+
+  Results results;
+  results.elapsed = Clock::now() - start;
+
+  drain.Stop();
+  for (auto& stream : streams) {
+    stream->queue().Stop();
+  }
+  if (link != nullptr) {
+    link->Stop();
+  }
+  service_threads.JoinAll();
+
+  for (auto& producer : producers) {
+    results.log_calls.Add(producer->calls());
+  }
+  results.logs_drained = drain.entries();
+  results.logs_dropped = drain.dropped();
+
+  for (auto& stream : streams) {
+    results.echo_writes.Add(stream->writes());
+    results.echo_round_trips.Add(stream->round_trips());
+    results.echo_failures += stream->failures();
+  }
+
+  for (auto& worker : workers) {
+    results.transfers.Add(worker->transfers());
+    results.transfer_failures += worker->failures();
+  }
+  return results;
+}
+
+unsigned PerSecond(size_t count, Clock::duration elapsed) {
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                      .count();
+  return us <= 0 ? 0u
+                 : static_cast<unsigned>(uint64_t(count) * 1'000'000u /
+                                         static_cast<uint64_t>(us));
+}
+
+// Logs a workload's call time, together and alone, and the difference, which
+// is roughly the time spent waiting for locks.
+void LogCallTime(const char* call,
+                 const Latencies& together,
+                 const Latencies& alone) {
+  const Clock::duration mean = together.Mean();
+  const Clock::duration mean_alone = alone.Mean();
+  PW_LOG_INFO("  %s: mean %u ns, %u ns alone, ~%u ns waiting",
+              call,
+              Nanoseconds(mean),
+              Nanoseconds(mean_alone),
+              mean > mean_alone ? Nanoseconds(mean - mean_alone) : 0u);
+}
+
+void Report(const Workloads& workloads,
+            Results& together,
+            const Results& logs_alone,
+            const Results& rpc_alone,
+            const Results& transfers_alone) {
+  PW_LOG_INFO(
+      "%u log producers, %u RPC streams, and %u transfers took %u ms",
+      static_cast<unsigned>(workloads.log_producers),
+      static_cast<unsigned>(workloads.rpc_streams),
+      static_cast<unsigned>(workloads.transfers),
+      static_cast<unsigned>(Microseconds(together.elapsed) / 1000));
+
+  if (workloads.log_producers > 0u) {
+    PW_LOG_INFO(
+        "Logs: %u entries/s, %u drained, %u dropped; "
+        "HandleEntry p50 %u ns, p99 %u ns, max %u us",
+        PerSecond(together.log_calls.count(), together.elapsed),
+        static_cast<unsigned>(together.logs_drained),
+        static_cast<unsigned>(together.logs_dropped),
+        Nanoseconds(together.log_calls.Percentile(50)),
+        Nanoseconds(together.log_calls.Percentile(99)),
+        Microseconds(together.log_calls.Percentile(100)));
+    LogCallTime("HandleEntry", together.log_calls, logs_alone.log_calls);
+  }
+
+  if (workloads.rpc_streams > 0u) {
+    PW_LOG_INFO(
+        "RPC: %u echoes/s, %u failed; round trip p50 %u us, p99 %u us, "
+        "max %u us",
+        PerSecond(together.echo_round_trips.count(), together.elapsed),
+        static_cast<unsigned>(together.echo_failures),
+        Microseconds(together.echo_round_trips.Percentile(50)),
+        Microseconds(together.echo_round_trips.Percentile(99)),
+        Microseconds(together.echo_round_trips.Percentile(100)));
+    LogCallTime("Write", together.echo_writes, rpc_alone.echo_writes);
+  }
+
+  if (workloads.transfers > 0u) {
+    PW_LOG_INFO(
+        "Transfers: %u B/s, %u failed; %u B transfer p50 %u ms, max %u ms, "
+        "%u ms alone",
+        PerSecond(together.transfers.count() * kTransferSizeBytes,
+                  together.elapsed),
+        static_cast<unsigned>(together.transfer_failures),
+        static_cast<unsigned>(kTransferSizeBytes),
+        Microseconds(together.transfers.Percentile(50)) / 1000,
+        Microseconds(together.transfers.Percentile(100)) / 1000,
+        Microseconds(transfers_alone.transfers.Mean()) / 1000);
+  }
+}
+
+}  // namespace
+}  // namespace pw::system
+
+int main(int argc, char* argv[]) {
+  using namespace pw::system;
+
+  Workloads workloads = {4, 4, 2};
+  size_t* const counts[] = {&workloads.log_producers,
+                            &workloads.rpc_streams,
+                            &workloads.transfers};
+  for (int i = 1; i < argc && i <= 3; ++i) {
+    *counts[i - 1] = std::strtoul(argv[i], nullptr, 0);
+  }
+  if (workloads.transfers > kMaxTransfers) {
+    PW_LOG_WARN("Limiting transfers to %u",
+                static_cast<unsigned>(kMaxTransfers));
+    workloads.transfers = kMaxTransfers;
+  }
+
+  for (size_t i = 0; i < source_data.size(); ++i) {
+    source_data[i] = static_cast<std::byte>(i * 7);
+  }
+
+  // Run one of each workload alone to compare with the combined run.
+  const Results logs_alone = Run({std::min<size_t>(workloads.log_producers, 1),
+                                  0,
+                                  0});
+  const Results rpc_alone = Run({0,
+                                 std::min<size_t>(workloads.rpc_streams, 1),
+                                 0});
+  const Results transfers_alone =
+      Run({0, 0, std::min<size_t>(workloads.transfers, 1)});
+
+  Results together = Run(workloads);
+  Report(workloads, together, logs_alone, rpc_alone, transfers_alone);
+  return 0;
+}
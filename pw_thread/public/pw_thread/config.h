@@ -13,7 +13,22 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_CONFIG_LOG_LEVEL
 #define PW_THREAD_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
 #endif  // PW_THREAD_CONFIG_LOG_LEVEL
+
+// The number of bytes of each thread's name that the ThreadStatsService copies
+// and reports. Longer names are truncated.
+#ifndef PW_THREAD_CONFIG_STATS_MAX_NAME_SIZE
+#define PW_THREAD_CONFIG_STATS_MAX_NAME_SIZE 16
+#endif  // PW_THREAD_CONFIG_STATS_MAX_NAME_SIZE
+
+namespace pw::thread::config {
+
+inline constexpr size_t kStatsMaxNameSize =
+    PW_THREAD_CONFIG_STATS_MAX_NAME_SIZE;
+
+}  // namespace pw::thread::config
@@ -19,6 +19,7 @@
 #include "pw_function/function.h"
 #include "pw_protobuf/encoder.h"
 #include "pw_status/status.h"
+#include "pw_thread/thread_info.h"
 #include "pw_thread_protos/thread.pwpb.h"
 
 namespace pw::thread {
@@ -50,4 +51,19 @@ Status SnapshotStack(const StackContext& stack,
                      Thread::StreamEncoder& encoder,
                      const ProcessThreadStackCallback& thread_stack_callback);
 
+// Writes the statistics in the provided ThreadInfo to the provided Thread
+// encoder. Fields that are not set in the ThreadInfo are not written.
+//
+// Captures the following proto fields, if available:
+//   pw.thread.Thread:
+//     name
+//     stack_start_pointer
+//     stack_end_pointer
+//     stack_pointer_est_peak
+//     cpu_usage_hundredths
+//     cpu_time
+//     context_switches
+Status EncodeThreadInfo(const ThreadInfo& thread_info,
+                        Thread::StreamEncoder& encoder);
+
 }  // namespace pw::thread
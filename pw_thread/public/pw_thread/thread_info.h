@@ -0,0 +1,50 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace pw::thread {
+
+// Statistics for a single thread, as reported by pw::thread::ForEachThread().
+// Each backend fills in the fields its RTOS can provide and leaves the rest
+// empty.
+struct ThreadInfo {
+  // The thread's name, which may be tokenized. This points into the thread's
+  // control block, so it is only valid within the ForEachThread() callback.
+  std::span<const std::byte> thread_name;
+
+  // The lowest and highest addresses of the thread's stack.
+  std::optional<uintptr_t> stack_low_addr;
+  std::optional<uintptr_t> stack_high_addr;
+
+  // The estimated furthest address the stack pointer has reached, i.e. the
+  // stack's high-water mark.
+  std::optional<uintptr_t> stack_peak_addr;
+
+  // The time the thread has spent running, in units of the RTOS's run time
+  // counter.
+  std::optional<uint64_t> cpu_time;
+
+  // The thread's share of the total run time, in hundredths of a percent.
+  std::optional<uint32_t> cpu_usage_hundredths;
+
+  // The number of times the scheduler has switched to the thread.
+  std::optional<uint64_t> context_switches;
+};
+
+}  // namespace pw::thread
@@ -0,0 +1,41 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_thread/thread_info.h"
+
+namespace pw::thread {
+
+// A callback that is executed for each thread when using ForEachThread(). The
+// callback should return true if thread iteration should continue. When this
+// callback returns false, ForEachThread() will cease iteration of threads and
+// return an `Aborted` error code.
+using ThreadCallback = Function<bool(const ThreadInfo&)>;
+
+// Iterates through all threads that haven't been deleted, calling the provided
+// callback with each thread's statistics.
+//
+// Backends stop the scheduler while iterating, so the callback must not block
+// and should be kept short, e.g. copy the information it needs and process it
+// after ForEachThread() returns.
+//
+// Returns:
+//   FailedPrecondition - The scheduler has not yet been initialized.
+//   Aborted - The callback requested an early-termination of thread iteration.
+//   OkStatus - Successfully iterated over all threads.
+Status ForEachThread(const ThreadCallback& cb);
+
+}  // namespace pw::thread
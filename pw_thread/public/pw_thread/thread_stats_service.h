@@ -0,0 +1,70 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/status.h"
+#include "pw_thread/config.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread_protos/thread_stats_service.raw_rpc.pb.h"
+
+namespace pw::thread {
+
+// The ThreadStatsService reports each thread's stack usage, CPU time, and
+// context switch count, as provided by the pw::thread::ForEachThread() backend,
+// so CPU hogs and stacks close to overflowing can be found on deployed devices.
+//
+// The statistics are copied out while the scheduler is stopped and are streamed
+// afterwards, so the service needs room for one entry per thread. Use
+// ThreadStatsServiceBuffer to allocate it.
+class ThreadStatsService
+    : public pw_rpc::raw::ThreadStats::Service<ThreadStatsService> {
+ public:
+  struct Entry {
+    ThreadInfo info;
+    std::array<std::byte, config::kStatsMaxNameSize> name;
+  };
+
+  ThreadStatsService(std::span<Entry> entries) : entries_(entries) {}
+
+  // Streams one SnapshotThreadInfo message per thread. Finishes with
+  // ResourceExhausted if there are more threads than entries, after streaming
+  // the threads that fit, or NotFound if a name was requested and no thread has
+  // it.
+  void GetThreadStats(ConstByteSpan request, rpc::RawServerWriter& writer);
+
+ private:
+  // Copies the thread's statistics into the next entry. Returns false if there
+  // are no entries left.
+  bool AddEntry(const ThreadInfo& thread_info);
+
+  std::span<Entry> entries_;
+  size_t entry_count_ = 0;
+};
+
+template <size_t kMaxThreads>
+class ThreadStatsServiceBuffer : public ThreadStatsService {
+ public:
+  ThreadStatsServiceBuffer() : ThreadStatsService(entries_) {}
+
+ private:
+  std::array<Entry, kMaxThreads> entries_;
+};
+
+}  // namespace pw::thread
@@ -24,6 +24,7 @@
 #include "pw_protobuf/encoder.h"
 #include "pw_status/status.h"
 #include "pw_thread/config.h"
+#include "pw_thread/thread_info.h"
 #include "pw_thread_protos/thread.pwpb.h"
 
 namespace pw::thread {
@@ -78,4 +79,31 @@ Status SnapshotStack(const StackContext& stack,
                     stack.stack_high_addr - stack.stack_pointer));
 }
 
+Status EncodeThreadInfo(const ThreadInfo& thread_info,
+                        Thread::StreamEncoder& encoder) {
+  if (!thread_info.thread_name.empty()) {
+    encoder.WriteName(thread_info.thread_name);
+  }
+  // TODO(pwbug/422): Add support for ascending stacks.
+  if (thread_info.stack_high_addr.has_value()) {
+    encoder.WriteStackStartPointer(thread_info.stack_high_addr.value());
+  }
+  if (thread_info.stack_low_addr.has_value()) {
+    encoder.WriteStackEndPointer(thread_info.stack_low_addr.value());
+  }
+  if (thread_info.stack_peak_addr.has_value()) {
+    encoder.WriteStackPointerEstPeak(thread_info.stack_peak_addr.value());
+  }
+  if (thread_info.cpu_usage_hundredths.has_value()) {
+    encoder.WriteCpuUsageHundredths(thread_info.cpu_usage_hundredths.value());
+  }
+  if (thread_info.cpu_time.has_value()) {
+    encoder.WriteCpuTime(thread_info.cpu_time.value());
+  }
+  if (thread_info.context_switches.has_value()) {
+    encoder.WriteContextSwitches(thread_info.context_switches.value());
+  }
+  return encoder.status();
+}
+
 }  // namespace pw::thread
@@ -0,0 +1,131 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/snapshot.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/span.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread_protos/thread.pwpb.h"
+
+namespace pw::thread {
+namespace {
+
+constexpr std::string_view kThreadName = "log_drain";
+
+Status EncodeThread(const ThreadInfo& thread_info, ByteSpan buffer,
+                    ConstByteSpan& thread) {
+  SnapshotThreadInfo::MemoryEncoder encoder(buffer);
+  {
+    Thread::StreamEncoder thread_encoder = encoder.GetThreadsEncoder();
+    PW_TRY(EncodeThreadInfo(thread_info, thread_encoder));
+  }
+  PW_TRY(encoder.status());
+
+  protobuf::Decoder decoder(encoder);
+  PW_TRY(decoder.Next());
+  EXPECT_EQ(decoder.FieldNumber(),
+            static_cast<uint32_t>(SnapshotThreadInfo::Fields::THREADS));
+  return decoder.ReadBytes(&thread);
+}
+
+TEST(EncodeThreadInfo, EmptyInfoEncodesNothing) {
+  std::array<std::byte, 64> buffer;
+  ConstByteSpan thread;
+  ASSERT_EQ(OkStatus(), EncodeThread(ThreadInfo{}, buffer, thread));
+  EXPECT_TRUE(thread.empty());
+}
+
+TEST(EncodeThreadInfo, EncodesAllFields) {
+  ThreadInfo thread_info;
+  thread_info.thread_name = std::as_bytes(std::span(kThreadName));
+  thread_info.stack_low_addr = 0x1000;
+  thread_info.stack_high_addr = 0x2000;
+  thread_info.stack_peak_addr = 0x1400;
+  thread_info.cpu_time = 123456;
+  thread_info.cpu_usage_hundredths = 1250;
+  thread_info.context_switches = 42;
+
+  std::array<std::byte, 128> buffer;
+  ConstByteSpan thread;
+  ASSERT_EQ(OkStatus(), EncodeThread(thread_info, buffer, thread));
+
+  protobuf::Decoder decoder(thread);
+  size_t fields = 0;
+  while (decoder.Next().ok()) {
+    ++fields;
+    uint64_t value = 0;
+    switch (static_cast<Thread::Fields>(decoder.FieldNumber())) {
+      case Thread::Fields::NAME: {
+        std::string_view name;
+        ASSERT_EQ(OkStatus(), decoder.ReadString(&name));
+        EXPECT_EQ(name, kThreadName);
+        break;
+      }
+      case Thread::Fields::STACK_START_POINTER:
+        ASSERT_EQ(OkStatus(), decoder.ReadUint64(&value));
+        EXPECT_EQ(value, 0x2000u);
+        break;
+      case Thread::Fields::STACK_END_POINTER:
+        ASSERT_EQ(OkStatus(), decoder.ReadUint64(&value));
+        EXPECT_EQ(value, 0x1000u);
+        break;
+      case Thread::Fields::STACK_POINTER_EST_PEAK:
+        ASSERT_EQ(OkStatus(), decoder.ReadUint64(&value));
+        EXPECT_EQ(value, 0x1400u);
+        break;
+      case Thread::Fields::CPU_TIME:
+        ASSERT_EQ(OkStatus(), decoder.ReadUint64(&value));
+        EXPECT_EQ(value, 123456u);
+        break;
+      case Thread::Fields::CPU_USAGE_HUNDREDTHS: {
+        uint32_t usage = 0;
+        ASSERT_EQ(OkStatus(), decoder.ReadUint32(&usage));
+        EXPECT_EQ(usage, 1250u);
+        break;
+      }
+      case Thread::Fields::CONTEXT_SWITCHES:
+        ASSERT_EQ(OkStatus(), decoder.ReadUint64(&value));
+        EXPECT_EQ(value, 42u);
+        break;
+      default:
+        ADD_FAILURE();
+    }
+  }
+  EXPECT_EQ(fields, 7u);
+}
+
+TEST(EncodeThreadInfo, OnlyEncodesSetFields) {
+  ThreadInfo thread_info;
+  thread_info.context_switches = 7;
+
+  std::array<std::byte, 64> buffer;
+  ConstByteSpan thread;
+  ASSERT_EQ(OkStatus(), EncodeThread(thread_info, buffer, thread));
+
+  protobuf::Decoder decoder(thread);
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(decoder.FieldNumber(),
+            static_cast<uint32_t>(Thread::Fields::CONTEXT_SWITCHES));
+  EXPECT_EQ(Status::OutOfRange(), decoder.Next());
+}
+
+}  // namespace
+}  // namespace pw::thread
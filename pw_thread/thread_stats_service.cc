@@ -0,0 +1,140 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_LEVEL PW_THREAD_CONFIG_LOG_LEVEL
+
+#include "pw_thread/thread_stats_service.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "pw_log/log.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_thread/config.h"
+#include "pw_thread/snapshot.h"
+#include "pw_thread/thread_iteration.h"
+#include "pw_thread_protos/thread.pwpb.h"
+#include "pw_thread_protos/thread_stats_service.pwpb.h"
+
+namespace pw::thread {
+namespace {
+
+// Room for the name and every other Thread field, each of which is at most a
+// one byte key and a ten byte varint.
+constexpr size_t kThreadEncodeBufferSize = config::kStatsMaxNameSize + 16 * 11;
+
+}  // namespace
+
+bool ThreadStatsService::AddEntry(const ThreadInfo& thread_info) {
+  if (entry_count_ == entries_.size()) {
+    return false;
+  }
+  Entry& entry = entries_[entry_count_++];
+  entry.info = thread_info;
+
+  // The name points into the thread's control block, so copy it.
+  const size_t name_size =
+      std::min(thread_info.thread_name.size(), entry.name.size());
+  std::copy_n(thread_info.thread_name.begin(), name_size, entry.name.begin());
+  entry.info.thread_name = std::span(entry.name).first(name_size);
+  return true;
+}
+
+void ThreadStatsService::GetThreadStats(ConstByteSpan request,
+                                        rpc::RawServerWriter& writer) {
+  struct {
+    ThreadStatsService* service;
+    std::optional<ConstByteSpan> name;
+    bool out_of_entries;
+  } ctx;
+  ctx.service = this;
+  ctx.out_of_entries = false;
+
+  protobuf::Decoder decoder(request);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    if (static_cast<ThreadStatsRequest::Fields>(decoder.FieldNumber()) ==
+        ThreadStatsRequest::Fields::NAME) {
+      ConstByteSpan name;
+      if (!decoder.ReadBytes(&name).ok()) {
+        break;
+      }
+      ctx.name = name;
+    }
+  }
+  if (status != Status::OutOfRange()) {
+    writer.Finish(Status::InvalidArgument())
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
+
+  // Only copy the statistics while iterating, as the scheduler is stopped.
+  entry_count_ = 0;
+  const Status iteration_status =
+      ForEachThread([&ctx](const ThreadInfo& thread_info) -> bool {
+        if (ctx.name.has_value() &&
+            !std::equal(thread_info.thread_name.begin(),
+                        thread_info.thread_name.end(),
+                        ctx.name->begin(),
+                        ctx.name->end())) {
+          return true;
+        }
+        if (!ctx.service->AddEntry(thread_info)) {
+          ctx.out_of_entries = true;
+          return false;
+        }
+        return true;
+      });
+  if (!iteration_status.ok() && !ctx.out_of_entries) {
+    PW_LOG_ERROR("Failed to iterate threads: %d",
+                 static_cast<int>(iteration_status.code()));
+    writer.Finish(iteration_status)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
+
+  std::array<std::byte, kThreadEncodeBufferSize> buffer;
+  for (const Entry& entry : entries_.first(entry_count_)) {
+    SnapshotThreadInfo::MemoryEncoder encoder(buffer);
+    {
+      Thread::StreamEncoder thread_encoder = encoder.GetThreadsEncoder();
+      EncodeThreadInfo(entry.info, thread_encoder)
+          .IgnoreError();  // The status is checked through the parent encoder.
+    }
+    if (!encoder.status().ok()) {
+      writer.Finish(encoder.status())
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+      return;
+    }
+    if (const Status write_status = writer.Write(encoder);
+        !write_status.ok()) {
+      // The call was closed by the client or the channel failed.
+      return;
+    }
+  }
+
+  if (ctx.out_of_entries) {
+    PW_LOG_WARN("Only reported the first %u threads",
+                static_cast<unsigned>(entries_.size()));
+    status = Status::ResourceExhausted();
+  } else if (ctx.name.has_value() && entry_count_ == 0) {
+    status = Status::NotFound();
+  } else {
+    status = OkStatus();
+  }
+  writer.Finish(status)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,72 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_iteration.h"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "RTOS.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread_embos/util.h"
+
+namespace pw::thread {
+namespace {
+
+ThreadInfo GetThreadInfo(const OS_TASK& thread) {
+  ThreadInfo thread_info;
+
+#if OS_TRACKNAME
+  thread_info.thread_name =
+      std::as_bytes(std::span(std::string_view(thread.Name)));
+#endif  // OS_TRACKNAME
+
+#if OS_CHECKSTACK || OS_SUPPORT_MPU
+  const uintptr_t stack_low_addr =
+      reinterpret_cast<uintptr_t>(thread.pStackBot);
+  const uintptr_t stack_high_addr = stack_low_addr + thread.StackSize;
+  thread_info.stack_low_addr = stack_low_addr;
+  thread_info.stack_high_addr = stack_high_addr;
+  thread_info.stack_peak_addr = stack_high_addr - OS_GetStackUsed(&thread);
+#endif  // OS_CHECKSTACK || OS_SUPPORT_MPU
+
+#if OS_SUPPORT_PROFILE
+  thread_info.cpu_time = OS_STAT_GetTaskExecTime(&thread);
+#endif  // OS_SUPPORT_PROFILE
+
+#if OS_SUPPORT_STAT
+  thread_info.context_switches = OS_STAT_GetNumActivations(&thread);
+#endif  // OS_SUPPORT_STAT
+
+  return thread_info;
+}
+
+}  // namespace
+
+Status ForEachThread(const ThreadCallback& cb) {
+  // Prevent task switches so that tasks cannot be created or terminated while
+  // the task list is walked.
+  OS_EnterRegion();
+  const Status status =
+      embos::ForEachThread([&cb](const OS_TASK& thread) -> bool {
+        return cb(GetThreadInfo(thread));
+      });
+  OS_LeaveRegion();
+  return status;
+}
+
+}  // namespace pw::thread
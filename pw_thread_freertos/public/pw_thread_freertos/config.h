@@ -63,6 +63,17 @@
 #define PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY (configMAX_PRIORITIES - 1)
 #endif  // PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY
 
+// Whether core affinity options are available. By default this is enabled
+// when the FreeRTOS SMP kernel is used with configUSE_CORE_AFFINITY.
+#ifndef PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+#if defined(configUSE_CORE_AFFINITY) && defined(configNUMBER_OF_CORES) && \
+    configUSE_CORE_AFFINITY == 1 && configNUMBER_OF_CORES > 1
+#define PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED 1
+#else
+#define PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED 0
+#endif  // configUSE_CORE_AFFINITY == 1 && configNUMBER_OF_CORES > 1
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL
 #define PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
@@ -77,5 +88,9 @@ inline constexpr UBaseType_t kDefaultPriority =
     PW_THREAD_FREERTOS_CONFIG_DEFAULT_PRIORITY;
 inline constexpr UBaseType_t kMaximumPriority =
     PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY;
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+inline constexpr UBaseType_t kAllCoresMask =
+    (UBaseType_t{1} << configNUMBER_OF_CORES) - 1;
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
 
 }  // namespace pw::thread::freertos::config
@@ -40,6 +40,13 @@ namespace pw::thread::freertos {
 //         .set_static_context(static_example_thread_context),
 //     example_thread_function);
 //
+//   // On SMP targets, keeps the thread on core 1.
+//   pw::thread::Thread pinned_example_thread(
+//     pw::thread::freertos::Options()
+//         .set_name("pinned_example_thread")
+//         .set_core_affinity(1 << 1),
+//     example_thread_function);
+//
 class Options : public thread::Options {
  public:
   constexpr Options() = default;
@@ -68,6 +75,19 @@ class Options : public thread::Options {
     return *this;
   }
 
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  // Sets the cores the FreeRTOS task may run on, where bit N allows core N. By
+  // default the task may run on any core (tskNO_AFFINITY).
+  //
+  // Precondition: At least one of the configNUMBER_OF_CORES cores must be
+  // allowed.
+  constexpr Options& set_core_affinity(UBaseType_t core_mask) {
+    PW_DASSERT((core_mask & config::kAllCoresMask) != 0);
+    core_affinity_ = core_mask;
+    return *this;
+  }
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+
 #if PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
   // Set the stack size of dynamic thread allocations.
   //
@@ -94,6 +114,9 @@ class Options : public thread::Options {
 
   const char* name() const { return name_; }
   UBaseType_t priority() const { return priority_; }
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  UBaseType_t core_affinity() const { return core_affinity_; }
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
 #if PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
   size_t stack_size_words() const { return stack_size_words_; }
 #endif  // PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
@@ -101,6 +124,9 @@ class Options : public thread::Options {
 
   const char* name_ = kDefaultName;
   UBaseType_t priority_ = config::kDefaultPriority;
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  UBaseType_t core_affinity_ = tskNO_AFFINITY;
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
 #if PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
   size_t stack_size_words_ = config::kDefaultStackSizeWords;
 #endif  // PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
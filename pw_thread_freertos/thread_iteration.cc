@@ -0,0 +1,91 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_iteration.h"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "FreeRTOS.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread_freertos/freertos_tsktcb.h"
+#include "pw_thread_freertos/util.h"
+#include "task.h"
+
+namespace pw::thread {
+namespace {
+
+// TODO(pwbug/422): Update this once we add support for ascending stacks.
+static_assert(portSTACK_GROWTH < 0, "Ascending stacks are not yet supported");
+
+ThreadInfo GetThreadInfo(TaskHandle_t thread) {
+  const tskTCB& tcb = *reinterpret_cast<tskTCB*>(thread);
+  ThreadInfo thread_info;
+
+  thread_info.thread_name =
+      std::as_bytes(std::span(std::string_view(tcb.pcTaskName)));
+
+  const uintptr_t stack_low_addr = reinterpret_cast<uintptr_t>(tcb.pxStack);
+  thread_info.stack_low_addr = stack_low_addr;
+#if configRECORD_STACK_HIGH_ADDRESS == 1
+  thread_info.stack_high_addr = reinterpret_cast<uintptr_t>(tcb.pxEndOfStack);
+#endif  // configRECORD_STACK_HIGH_ADDRESS == 1
+
+#if INCLUDE_uxTaskGetStackHighWaterMark == 1
+  // The high-water mark is the least free stack space the thread has had, in
+  // words. On a descending stack the free space is at the bottom.
+  thread_info.stack_peak_addr =
+      stack_low_addr +
+      sizeof(StackType_t) * uxTaskGetStackHighWaterMark(thread);
+#endif  // INCLUDE_uxTaskGetStackHighWaterMark == 1
+
+#if configGENERATE_RUN_TIME_STATS == 1
+  const uint64_t cpu_time = tcb.ulRunTimeCounter;
+  thread_info.cpu_time = cpu_time;
+
+#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+  uint64_t total_run_time;
+  portALT_GET_RUN_TIME_COUNTER_VALUE(total_run_time);
+#else
+  const uint64_t total_run_time = portGET_RUN_TIME_COUNTER_VALUE();
+#endif  // portALT_GET_RUN_TIME_COUNTER_VALUE
+  if (total_run_time != 0u) {
+    thread_info.cpu_usage_hundredths =
+        static_cast<uint32_t>(cpu_time * 10000u / total_run_time);
+  }
+#endif  // configGENERATE_RUN_TIME_STATS == 1
+
+  // FreeRTOS does not count context switches per task.
+  return thread_info;
+}
+
+}  // namespace
+
+Status ForEachThread(const ThreadCallback& cb) {
+  // Suspending the scheduler keeps the task lists stable. Interrupts that
+  // unblock tasks while the scheduler is suspended only add them to the
+  // pending ready list, which is not iterated.
+  vTaskSuspendAll();
+  const Status status = freertos::ForEachThread(
+      [&cb](TaskHandle_t thread, eTaskState) -> bool {
+        return cb(GetThreadInfo(thread));
+      });
+  xTaskResumeAll();
+  return status;
+}
+
+}  // namespace pw::thread
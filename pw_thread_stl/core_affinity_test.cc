@@ -0,0 +1,91 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "gtest/gtest.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif  // defined(__linux__)
+
+namespace pw::thread::stl {
+namespace {
+
+#if defined(__linux__)
+
+struct AffinityCheck {
+  sync::BinarySemaphore affinity_set;
+  cpu_set_t cpu_set;
+  int result = -1;
+};
+
+void GetAffinity(void* arg) {
+  AffinityCheck& check = *static_cast<AffinityCheck*>(arg);
+  // Wait until the creating thread has applied the options.
+  check.affinity_set.acquire();
+  check.result = pthread_getaffinity_np(
+      pthread_self(), sizeof(check.cpu_set), &check.cpu_set);
+}
+
+// Returns the first core this process may run on.
+int FirstAllowedCore() {
+  cpu_set_t cpu_set;
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    return -1;
+  }
+  for (int core = 0; core < 64; ++core) {
+    if (CPU_ISSET(core, &cpu_set)) {
+      return core;
+    }
+  }
+  return -1;
+}
+
+TEST(CoreAffinity, RestrictsThreadToCore) {
+  const int core = FirstAllowedCore();
+  ASSERT_GE(core, 0);
+
+  AffinityCheck check;
+  Thread thread(Options().set_core_affinity(uint64_t{1} << core),
+                GetAffinity,
+                &check);
+  check.affinity_set.release();
+  thread.join();
+
+  ASSERT_EQ(check.result, 0);
+  EXPECT_EQ(CPU_COUNT(&check.cpu_set), 1);
+  EXPECT_TRUE(CPU_ISSET(core, &check.cpu_set));
+}
+
+TEST(CoreAffinity, DefaultKeepsProcessAffinity) {
+  cpu_set_t process_cpu_set;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(process_cpu_set), &process_cpu_set),
+            0);
+
+  AffinityCheck check;
+  Thread thread(Options(), GetAffinity, &check);
+  check.affinity_set.release();
+  thread.join();
+
+  ASSERT_EQ(check.result, 0);
+  EXPECT_TRUE(CPU_EQUAL(&check.cpu_set, &process_cpu_set));
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace
+}  // namespace pw::thread::stl
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_thread/thread.h"
 
 namespace pw::thread::stl {
@@ -21,6 +23,41 @@ namespace pw::thread::stl {
 // Instead, users are expected to start the thread and after dynamically adjust
 // the thread's attributes using std::thread::native_handle based on the native
 // threading APIs.
-class Options : public thread::Options {};
+//
+// The core affinity is the exception, as it is commonly needed to keep
+// threads from migrating between cores. It is applied through the native
+// threading API right after the thread starts.
+//
+// Example usage:
+//
+//   // Only allow the thread to run on core 1.
+//   pw::thread::Thread example_thread(
+//     pw::thread::stl::Options().set_core_affinity(1 << 1),
+//     example_thread_function);
+//
+class Options : public thread::Options {
+ public:
+  constexpr Options() = default;
+  constexpr Options(const Options&) = default;
+  constexpr Options(Options&& other) = default;
+
+  // Sets the cores the thread may run on, where bit N allows core N. By
+  // default, or with a mask of 0, the thread may run on any core.
+  //
+  // This is only supported on Linux, it is ignored on other hosts.
+  constexpr Options& set_core_affinity(uint64_t core_mask) {
+    core_affinity_ = core_mask;
+    return *this;
+  }
+
+ private:
+  friend thread::Thread;
+
+  static constexpr uint64_t kAnyCore = 0;
+
+  uint64_t core_affinity() const { return core_affinity_; }
+
+  uint64_t core_affinity_ = kAnyCore;
+};
 
 }  // namespace pw::thread::stl
@@ -18,8 +18,8 @@
 
 namespace pw::thread::test {
 
-// The STL doesn't offer any options so the default constructed options are used
-// directly.
+// The tests don't need any of the STL options so the default constructed
+// options are used directly.
 
 const Options& TestOptionsThread0() {
   static constexpr stl::Options thread_0_options;
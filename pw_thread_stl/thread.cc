@@ -0,0 +1,54 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread.h"
+
+#include <thread>
+
+#include "pw_thread_stl/options.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif  // defined(__linux__)
+
+namespace pw::thread {
+
+Thread::Thread(const thread::Options& facade_options,
+               ThreadRoutine entry,
+               void* arg) {
+  native_type_ = std::thread(entry, arg);
+
+  // Cast the generic facade options to the backend specific option of which
+  // only one type can exist at compile time.
+  const auto& options = static_cast<const stl::Options&>(facade_options);
+  if (options.core_affinity() == stl::Options::kAnyCore) {
+    return;
+  }
+
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int core = 0; core < 64 && core < CPU_SETSIZE; ++core) {
+    if ((options.core_affinity() >> core) & 1u) {
+      CPU_SET(core, &cpu_set);
+    }
+  }
+  // This is best effort, e.g. the requested cores may not exist.
+  pthread_setaffinity_np(
+      native_type_.native_handle(), sizeof(cpu_set), &cpu_set);
+#endif  // defined(__linux__)
+}
+
+}  // namespace pw::thread
@@ -66,6 +66,16 @@
   PW_THREAD_THREADX_CONFIG_MIN_PRIORITY
 #endif  // PW_THREAD_THREADX_CONFIG_DEFAULT_PRIORITY
 
+// Whether core affinity options are available. By default this is enabled
+// when ThreadX SMP is used.
+#ifndef PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+#ifdef TX_THREAD_SMP_MAX_CORES
+#define PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED 1
+#else
+#define PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED 0
+#endif  // TX_THREAD_SMP_MAX_CORES
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_THREADX_CONFIG_LOG_LEVEL
 #define PW_THREAD_THREADX_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
@@ -84,5 +94,9 @@ inline constexpr UINT kDefaultPriority =
     PW_THREAD_THREADX_CONFIG_DEFAULT_PRIORITY;
 inline constexpr ULONG kDefaultTimeSliceInterval =
     PW_THREAD_THREADX_CONFIG_DEFAULT_TIME_SLICE_INTERVAL;
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+inline constexpr ULONG kAllCoresMask =
+    (ULONG{1} << TX_THREAD_SMP_MAX_CORES) - 1;
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
 
 }  // namespace pw::thread::threadx::config
@@ -44,6 +44,14 @@ namespace pw::thread::threadx {
 //         .set_context(example_thread_context),
 //     example_thread_function);
 //
+//   // On SMP targets, keeps the thread on core 1.
+//   pw::thread::Thread pinned_example_thread(
+//     pw::thread::threadx::Options()
+//         .set_name("pinned_example_thread")
+//         .set_core_affinity(1 << 1)
+//         .set_context(example_thread_context),
+//     example_thread_function);
+//
 class Options : public thread::Options {
  public:
   constexpr Options() = default;
@@ -110,6 +118,20 @@ class Options : public thread::Options {
     return *this;
   }
 
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  // Sets the cores the ThreadX thread may run on, where bit N allows core N.
+  // By default the thread may run on any core. The other cores are excluded
+  // with tx_thread_smp_core_exclude before the thread starts.
+  //
+  // Precondition: At least one of the TX_THREAD_SMP_MAX_CORES cores must be
+  // allowed.
+  constexpr Options& set_core_affinity(ULONG core_mask) {
+    PW_DASSERT((core_mask & config::kAllCoresMask) != 0);
+    core_affinity_ = core_mask;
+    return *this;
+  }
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+
   // Set the pre-allocated context (all memory needed to run a thread). Note
   // that this is required for this thread creation backend! The Context can
   // either be constructed with an externally provided std::span<ULONG> stack
@@ -131,6 +153,9 @@ class Options : public thread::Options {
     return possible_preemption_threshold_.value_or(priority_);
   }
   ULONG time_slice_interval() const { return time_slice_interval_; }
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  ULONG core_affinity() const { return core_affinity_; }
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
   Context* context() const { return context_; }
 
   const char* name_ = kDefaultName;
@@ -139,6 +164,9 @@ class Options : public thread::Options {
   // have to be based on the selected priority.
   std::optional<UINT> possible_preemption_threshold_ = std::nullopt;
   ULONG time_slice_interval_ = config::kDefaultTimeSliceInterval;
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  ULONG core_affinity_ = config::kAllCoresMask;
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
   Context* context_ = nullptr;
 };
 
@@ -0,0 +1,77 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_iteration.h"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread_threadx/util.h"
+#include "tx_api.h"
+#include "tx_thread.h"
+
+namespace pw::thread {
+namespace {
+
+ThreadInfo GetThreadInfo(const TX_THREAD& thread) {
+  ThreadInfo thread_info;
+
+  thread_info.thread_name =
+      std::as_bytes(std::span(std::string_view(thread.tx_thread_name)));
+
+  // When ThreadX is built with stack checking enabled, the lowest-addressed
+  // ULONG is reserved for a watermark, matching the snapshot stack bounds.
+  thread_info.stack_low_addr =
+      reinterpret_cast<uintptr_t>(thread.tx_thread_stack_start) +
+      sizeof(ULONG);
+  thread_info.stack_high_addr =
+      reinterpret_cast<uintptr_t>(thread.tx_thread_stack_end);
+#ifdef TX_ENABLE_STACK_CHECKING
+  thread_info.stack_peak_addr =
+      reinterpret_cast<uintptr_t>(thread.tx_thread_stack_highest_ptr);
+#endif  // TX_ENABLE_STACK_CHECKING
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+  thread_info.cpu_time =
+      static_cast<uint64_t>(thread.tx_thread_execution_time_total);
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+
+  // ThreadX counts how many times each thread has been scheduled.
+  thread_info.context_switches = thread.tx_thread_run_count;
+  return thread_info;
+}
+
+}  // namespace
+
+Status ForEachThread(const ThreadCallback& cb) {
+  if (_tx_thread_created_ptr == TX_NULL) {
+    return Status::FailedPrecondition();
+  }
+
+  // Disable interrupts so that threads cannot be created, deleted, or
+  // scheduled while the created thread list is walked.
+  const UINT saved_posture = tx_interrupt_control(TX_INT_DISABLE);
+  const Status status = threadx::ForEachThread(
+      [&cb](const TX_THREAD& thread) -> bool {
+        return cb(GetThreadInfo(thread));
+      });
+  tx_interrupt_control(saved_posture);
+  return status;
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,40 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/kvs_session_store.h"
+
+namespace pw::tls_client {
+
+StatusWithSize KvsSessionStore::Load(ByteSpan dest) {
+  // Session state is only usable in full, so check the size before reading.
+  const StatusWithSize size = kvs_.ValueSize(key_);
+  if (!size.ok()) {
+    return size;
+  }
+  if (size.size() > dest.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  return kvs_.Get(key_, dest);
+}
+
+Status KvsSessionStore::Save(ConstByteSpan session) {
+  return kvs_.Put(key_, session);
+}
+
+Status KvsSessionStore::Clear() {
+  const Status status = kvs_.Delete(key_);
+  return status.IsNotFound() ? OkStatus() : status;
+}
+
+}  // namespace pw::tls_client
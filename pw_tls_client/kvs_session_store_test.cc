@@ -0,0 +1,83 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/kvs_session_store.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+
+namespace pw::tls_client {
+namespace {
+
+constexpr kvs::EntryFormat kFormat{.magic = 0x7d3c2f61, .checksum = nullptr};
+
+class KvsSessionStoreTest : public ::testing::Test {
+ protected:
+  KvsSessionStoreTest()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, kFormat),
+        store_(kvs_, "tls_session") {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  kvs::FakeFlashMemoryBuffer<512, 4> flash_;
+  kvs::FlashPartition partition_;
+  kvs::KeyValueStoreBuffer<4, 4> kvs_;
+  KvsSessionStore store_;
+};
+
+constexpr std::array<std::byte, 4> kSession = {
+    std::byte{0x01}, std::byte{0x02}, std::byte{0x03}, std::byte{0x04}};
+
+TEST_F(KvsSessionStoreTest, Load_NothingSaved) {
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::NotFound(), store_.Load(buffer).status());
+}
+
+TEST_F(KvsSessionStoreTest, SaveAndLoad) {
+  ASSERT_EQ(OkStatus(), store_.Save(kSession));
+
+  std::array<std::byte, 16> buffer;
+  const StatusWithSize result = store_.Load(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kSession.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kSession.data(), buffer.data(), kSession.size()));
+}
+
+TEST_F(KvsSessionStoreTest, Load_BufferTooSmall) {
+  ASSERT_EQ(OkStatus(), store_.Save(kSession));
+
+  std::array<std::byte, 2> buffer;
+  EXPECT_EQ(Status::ResourceExhausted(), store_.Load(buffer).status());
+}
+
+TEST_F(KvsSessionStoreTest, Clear) {
+  ASSERT_EQ(OkStatus(), store_.Save(kSession));
+  ASSERT_EQ(OkStatus(), store_.Clear());
+
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::NotFound(), store_.Load(buffer).status());
+  EXPECT_EQ(OkStatus(), store_.Clear());
+}
+
+}  // namespace
+}  // namespace pw::tls_client
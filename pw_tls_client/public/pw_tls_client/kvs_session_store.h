@@ -0,0 +1,41 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <string_view>
+
+#include "pw_kvs/key_value_store.h"
+#include "pw_tls_client/session_store.h"
+
+namespace pw::tls_client {
+
+// Persists TLS session state in a key-value store entry, so that sessions can
+// be resumed after a reboot. Each server should use its own key.
+class KvsSessionStore final : public SessionStore {
+ public:
+  // The memory backing key must outlive the KvsSessionStore.
+  constexpr KvsSessionStore(kvs::KeyValueStore& kvs, std::string_view key)
+      : kvs_(kvs), key_(key) {}
+
+  StatusWithSize Load(ByteSpan dest) override;
+  Status Save(ConstByteSpan session) override;
+  Status Clear() override;
+
+ private:
+  kvs::KeyValueStore& kvs_;
+  std::string_view key_;
+};
+
+}  // namespace pw::tls_client
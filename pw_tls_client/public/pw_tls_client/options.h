@@ -20,6 +20,7 @@
 #include "pw_assert/check.h"
 #include "pw_stream/stream.h"
 #include "pw_string/util.h"
+#include "pw_tls_client/session_store.h"
 
 namespace pw::tls_client {
 
@@ -47,13 +48,26 @@ class SessionOptions {
     return *this;
   }
 
+  // Sets where session state is saved so that later sessions with the same
+  // server can be resumed with an abbreviated handshake, which skips the
+  // expensive key exchange. The backend loads saved state when the Session is
+  // created and saves new state once a handshake completes. The store must
+  // outlive the Session.
+  constexpr SessionOptions& set_session_store(SessionStore& session_store) {
+    session_store_ = &session_store;
+    return *this;
+  }
+
   constexpr pw::stream::ReaderWriter* transport() const { return transport_; }
 
+  constexpr SessionStore* session_store() const { return session_store_; }
+
   constexpr std::string_view server_name() const { return server_name_; }
 
  private:
   std::string_view server_name_;
   pw::stream::ReaderWriter* transport_ = nullptr;
+  SessionStore* session_store_ = nullptr;
 
   // TODO(zyecheng): Expand the list as necessary to cover aspects such as
   // certificate verification/revocation check policies.
@@ -0,0 +1,47 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::tls_client {
+
+// SessionStore persists the state a TLS backend needs to resume a session,
+// such as a session ticket or ID and its master secret, so that reconnecting
+// to a server skips the full handshake. The saved state is opaque and specific
+// to the backend. It is secret and must be stored where only the device can
+// read it.
+class SessionStore {
+ public:
+  virtual ~SessionStore() = default;
+
+  // Loads saved session state into dest. Returns the size of the state, or:
+  //
+  //            NOT_FOUND: no session state is saved
+  //   RESOURCE_EXHAUSTED: dest is too small for the saved state
+  //
+  virtual StatusWithSize Load(ByteSpan dest) = 0;
+
+  // Saves session state, replacing any saved before.
+  virtual Status Save(ConstByteSpan session) = 0;
+
+  // Removes saved session state, such as after the server rejects it. Returns
+  // OK if no state is saved.
+  virtual Status Clear() = 0;
+};
+
+}  // namespace pw::tls_client
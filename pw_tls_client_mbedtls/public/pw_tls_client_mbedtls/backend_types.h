@@ -28,6 +28,11 @@ class SessionImplementation {
   SessionImplementation(SessionOptions options);
   ~SessionImplementation();
   Status Setup();
+
+  // Saves the established session to the session store, if one is set, so
+  // that a later Session can resume it. Called once a handshake completes.
+  Status SaveSession();
+
   void SetTlsStatus(TLSStatus status) { tls_status_ = status; }
   TLSStatus GetTlsStatus() { return tls_status_; }
 
@@ -35,7 +40,15 @@ class SessionImplementation {
   // the status returned by entropy source pw::tls_client::GetRandomBytes();
   static void SetEntropySourceStatus(Status status);
 
+  // The largest serialized session that is saved or restored. A session with a
+  // ticket fits, but one that keeps the peer's certificate may not.
+  static constexpr size_t kMaxSavedSessionBytes = 512;
+
  private:
+  // Restores a saved session, if any, so that the handshake tries to resume
+  // it. Saved state that cannot be restored is cleared.
+  void RestoreSession();
+
   // mbedtls entropy
   mbedtls_entropy_context entropy_ctx_;
   mbedtls_ctr_drbg_context drbg_ctx_;
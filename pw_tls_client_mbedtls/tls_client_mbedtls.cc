@@ -12,6 +12,10 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+#include <span>
+
+#include "mbedtls/platform_util.h"
 #include "mbedtls/ssl.h"
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
@@ -147,6 +151,13 @@ Status SessionImplementation::Setup() {
 
   // TODO(pwbug/398): Add logic for loading trust anchors.
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+  // Ask the server for a session ticket so the session can be resumed without
+  // the server keeping any state. The API does not fail.
+  mbedtls_ssl_conf_session_tickets(&ssl_config_,
+                                   MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif  // defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+
   // Load configuration to SSL.
   ret = mbedtls_ssl_setup(&ssl_ctx_, &ssl_config_);
   if (ret) {
@@ -163,9 +174,72 @@ Status SessionImplementation::Setup() {
     return Status::Internal();
   }
 
+  RestoreSession();
   return OkStatus();
 }
 
+void SessionImplementation::RestoreSession() {
+  SessionStore* store = session_options_.session_store();
+  if (store == nullptr) {
+    return;
+  }
+
+  std::array<unsigned char, kMaxSavedSessionBytes> buffer;
+  const StatusWithSize loaded =
+      store->Load(std::as_writable_bytes(std::span(buffer)));
+  if (loaded.IsNotFound()) {
+    return;
+  }
+
+  int ret = -1;
+  if (loaded.ok()) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    ret = mbedtls_ssl_session_load(&session, buffer.data(), loaded.size());
+    if (!ret) {
+      ret = mbedtls_ssl_set_session(&ssl_ctx_, &session);
+    }
+    mbedtls_ssl_session_free(&session);
+  }
+  mbedtls_platform_zeroize(buffer.data(), buffer.size());
+
+  // Fall back to a full handshake rather than failing.
+  if (ret) {
+    PW_LOG_DEBUG("Discarding saved session that cannot be restored");
+    store->Clear().IgnoreError();
+  }
+}
+
+Status SessionImplementation::SaveSession() {
+  SessionStore* store = session_options_.session_store();
+  if (store == nullptr) {
+    return OkStatus();
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  std::array<unsigned char, kMaxSavedSessionBytes> buffer;
+  size_t size = 0;
+
+  int ret = mbedtls_ssl_get_session(&ssl_ctx_, &session);
+  if (!ret) {
+    ret = mbedtls_ssl_session_save(
+        &session, buffer.data(), buffer.size(), &size);
+  }
+  mbedtls_ssl_session_free(&session);
+
+  Status status;
+  if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+    status = Status::ResourceExhausted();
+  } else if (ret) {
+    status = Status::Internal();
+  } else {
+    status = store->Save(std::as_bytes(std::span(buffer).first(size)));
+  }
+  mbedtls_platform_zeroize(buffer.data(), buffer.size());
+  return status;
+}
+
 }  // namespace backend
 
 Session::Session(const SessionOptions& options) : session_impl_(options) {}
@@ -198,7 +272,8 @@ Result<Session*> Session::Create(const SessionOptions& options) {
 }
 
 Status Session::Open() {
-  // TODO(pwbug/398): To implement
+  // TODO(pwbug/398): To implement. Once the handshake completes, call
+  // session_impl_.SaveSession() so the next Session can resume it.
   return Status::Unimplemented();
 }
 
@@ -12,11 +12,41 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "pw_stream/null_stream.h"
 #include "pw_tls_client/session.h"
+#include "pw_tls_client/session_store.h"
 
 namespace pw::tls_client {
+namespace {
+
+// Session store holding state that is not a valid serialized session.
+class InvalidSessionStore : public SessionStore {
+ public:
+  StatusWithSize Load(ByteSpan dest) override {
+    if (!has_session_) {
+      return StatusWithSize::NotFound();
+    }
+    std::fill(dest.begin(), dest.begin() + 8, std::byte{0xab});
+    return StatusWithSize(8);
+  }
+
+  Status Save(ConstByteSpan) override { return OkStatus(); }
+
+  Status Clear() override {
+    has_session_ = false;
+    return OkStatus();
+  }
+
+  bool has_session() const { return has_session_; }
+
+ private:
+  bool has_session_ = true;
+};
+
+}  // namespace
 
 TEST(TLSClientMbedTLS, CreateSucceed) {
   auto options = SessionOptions().set_transport(stream::NullStream::Instance());
@@ -31,6 +61,16 @@ TEST(TLSClientMbedTLS, CreateFailOnMissingTransport) {
   ASSERT_NE(res.status(), OkStatus());
 }
 
+TEST(TLSClientMbedTLS, CreateDiscardsInvalidSavedSession) {
+  InvalidSessionStore store;
+  auto options = SessionOptions()
+                     .set_transport(stream::NullStream::Instance())
+                     .set_session_store(store);
+  auto res = Session::Create(options);
+  ASSERT_EQ(res.status(), OkStatus());
+  EXPECT_FALSE(store.has_session());
+}
+
 TEST(TLSClientMbedTLS, EntropySourceFail) {
   backend::SessionImplementation::SetEntropySourceStatus(Status::Internal());
   auto options = SessionOptions().set_transport(stream::NullStream::Instance());
@@ -15,7 +15,9 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <algorithm>
+#include <cstring>
 
+#include "pw_base64/base64.h"
 #include "pw_tokenizer/internal/decode.h"
 
 namespace pw::tokenizer {
@@ -65,19 +67,39 @@ bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
   return lhs.second > rhs.second;
 }
 
+// Formats each entry's string with the arguments.
+std::vector<DecodingResult> FormatEntries(
+    std::span<const TokenizedStringEntry> entries,
+    std::span<const uint8_t> arguments) {
+  std::vector<DecodingResult> results;
+  for (const auto& [format, date_removed] : entries) {
+    results.emplace_back(format.Format(arguments), date_removed);
+  }
+  return results;
+}
+
+// Reads the little-endian token from the start of an encoded message.
+uint32_t ReadToken(std::span<const uint8_t> encoded) {
+  return encoded[3] << 24 | encoded[2] << 16 | encoded[1] << 8 | encoded[0];
+}
+
+// True for the characters of standard Base64, excluding padding.
+constexpr bool IsBase64Character(char c) {
+  return ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') ||
+         ('0' <= c && c <= '9') || c == '+' || c == '/';
+}
+
 }  // namespace
 
 DetokenizedString::DetokenizedString(
     uint32_t token,
     const std::span<const TokenizedStringEntry>& entries,
     const std::span<const uint8_t>& arguments)
-    : token_(token), has_token_(true) {
-  std::vector<DecodingResult> results;
-
-  for (const auto& [format, date_removed] : entries) {
-    results.push_back(DecodingResult{format.Format(arguments), date_removed});
-  }
+    : DetokenizedString(token, FormatEntries(entries, arguments)) {}
 
+DetokenizedString::DetokenizedString(uint32_t token,
+                                     std::vector<DecodingResult>&& results)
+    : token_(token), has_token_(true) {
   std::sort(results.begin(), results.end(), IsBetterResult);
 
   for (auto& result : results) {
@@ -98,8 +120,36 @@ std::string DetokenizedString::BestStringWithErrors() const {
 }
 
 Detokenizer::Detokenizer(const TokenDatabase& database) {
+  auto index = std::make_shared<Index>();
+  index->entries.reserve(database.size());
+
   for (const auto& entry : database) {
-    database_[entry.token].emplace_back(entry.string, entry.date_removed);
+    index->entries.push_back({entry.token,
+                              entry.date_removed,
+                              static_cast<uint32_t>(index->strings.size())});
+    index->strings.insert(index->strings.end(),
+                          entry.string,
+                          entry.string + std::strlen(entry.string) + 1);
+  }
+
+  // Databases are sorted by token, but sort in case one is not. A stable sort
+  // keeps colliding entries in database order.
+  std::stable_sort(index->entries.begin(),
+                   index->entries.end(),
+                   [](const IndexEntry& lhs, const IndexEntry& rhs) {
+                     return lhs.token < rhs.token;
+                   });
+
+  index->format_strings =
+      std::make_unique<std::atomic<const FormatString*>[]>(
+          index->entries.size());
+
+  index_ = std::move(index);
+}
+
+Detokenizer::Index::~Index() {
+  for (size_t i = 0; i < entries.size(); ++i) {
+    delete format_strings[i].load(std::memory_order_relaxed);
   }
 }
 
@@ -110,16 +160,163 @@ DetokenizedString Detokenizer::Detokenize(
     return DetokenizedString();
   }
 
-  const uint32_t token =
-      encoded[3] << 24 | encoded[2] << 16 | encoded[1] << 8 | encoded[0];
+  const uint32_t token = ReadToken(encoded);
+
+  std::vector<DecodingResult> results;
+  for (const IndexEntry& entry : Find(token)) {
+    results.emplace_back(
+        GetFormatString(entry).Format(encoded.subspan(sizeof(token))),
+        entry.date_removed);
+  }
+
+  return DetokenizedString(token, std::move(results));
+}
+
+void Detokenizer::DetokenizeBatch(
+    std::span<const std::span<const uint8_t>> messages,
+    DetokenizedBatch& batch) const {
+  batch.buffer_.clear();
+  batch.ends_.clear();
+  batch.ends_.reserve(messages.size());
+
+  for (const std::span<const uint8_t>& message : messages) {
+    AppendBestStringWithErrors(message, batch.buffer_);
+    batch.ends_.push_back(batch.buffer_.size());
+  }
+}
+
+std::span<const Detokenizer::IndexEntry> Detokenizer::Find(
+    uint32_t token) const {
+  struct ByToken {
+    bool operator()(const IndexEntry& entry, uint32_t value) const {
+      return entry.token < value;
+    }
+    bool operator()(uint32_t value, const IndexEntry& entry) const {
+      return value < entry.token;
+    }
+  };
+
+  const auto [first, last] = std::equal_range(
+      index_->entries.begin(), index_->entries.end(), token, ByToken());
+  return std::span(index_->entries)
+      .subspan(first - index_->entries.begin(), last - first);
+}
+
+const FormatString& Detokenizer::GetFormatString(
+    const IndexEntry& entry) const {
+  std::atomic<const FormatString*>& cached =
+      index_->format_strings[&entry - index_->entries.data()];
+
+  const FormatString* format = cached.load(std::memory_order_acquire);
+  if (format == nullptr) {
+    // If another thread parses the string first, use its FormatString.
+    auto parsed = std::make_unique<const FormatString>(
+        &index_->strings[entry.string_offset]);
+    if (cached.compare_exchange_strong(format,
+                                       parsed.get(),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+      format = parsed.release();
+    }
+  }
+  return *format;
+}
+
+void Detokenizer::AppendBestStringWithErrors(std::span<const uint8_t> encoded,
+                                             std::string& output) const {
+  if (encoded.size() >= sizeof(uint32_t)) {
+    const std::span<const IndexEntry> entries = Find(ReadToken(encoded));
 
-  const auto result = database_.find(token);
+    // Without a collision, there are no results to rank, so format directly.
+    if (entries.size() == 1u) {
+      output.append(GetFormatString(entries[0])
+                        .Format(encoded.subspan(sizeof(uint32_t)))
+                        .value_with_errors());
+      return;
+    }
+  }
+
+  output.append(Detokenize(encoded).BestStringWithErrors());
+}
+
+void StreamingBase64Detokenizer::Write(std::string_view chunk,
+                                       std::string& output) {
+  for (char c : chunk) {
+    if (in_message_) {
+      if (AddToMessage(c)) {
+        continue;
+      }
+      FinishMessage();
+    }
+
+    if (c == prefix_) {
+      in_message_ = true;
+      continue;
+    }
+
+    line_.push_back(c);
+
+    if (c == '\n') {
+      output.append(line_);
+      line_.clear();
+    }
+  }
+}
+
+void StreamingBase64Detokenizer::Flush(std::string& output) {
+  if (in_message_) {
+    FinishMessage();
+  }
+  output.append(line_);
+  line_.clear();
+}
+
+bool StreamingBase64Detokenizer::AddToMessage(char c) {
+  if (c == '=') {
+    // Padding may only fill the last one or two characters of a group of four.
+    if (message_.size() % 4 < 2) {
+      return false;
+    }
+    message_.push_back(c);
+    if (message_.size() % 4 == 0) {
+      FinishMessage();
+    }
+    return true;
+  }
+
+  if (!IsBase64Character(c) || (!message_.empty() && message_.back() == '=')) {
+    return false;
+  }
+
+  message_.push_back(c);
+  return true;
+}
+
+void StreamingBase64Detokenizer::FinishMessage() {
+  // Only complete groups of four characters are part of the message. Any
+  // characters after them are plain text.
+  const size_t message_size = message_.size() - message_.size() % 4;
+  const std::string_view base64 =
+      std::string_view(message_).substr(0, message_size);
+
+  decoded_.resize(base64::MaxDecodedSize(base64.size()));
+  const size_t decoded_size = base64::Decode(base64, decoded_);
+
+  const DetokenizedString result =
+      decoded_size == 0u ? DetokenizedString()
+                         : detokenizer_.Detokenize(decoded_.data(),
+                                                   decoded_size);
+
+  if (result.matches().empty()) {
+    line_.push_back(prefix_);
+    line_.append(base64);
+  } else {
+    line_.append(result.BestString());
+  }
 
-  return DetokenizedString(token,
-                           result == database_.end()
-                               ? std::span<TokenizedStringEntry>()
-                               : std::span(result->second),
-                           encoded.subspan(sizeof(token)));
+  line_.append(std::string_view(message_).substr(message_size));
+  message_.clear();
+  in_message_ = false;
 }
 
 }  // namespace pw::tokenizer
@@ -14,6 +14,10 @@
 
 #include "pw_tokenizer/detokenize.h"
 
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -97,6 +101,61 @@ TEST_F(Detokenize, BestStringWithErrors_UnknownToken_ErrorMessage) {
             ERR("unknown token fedcba98"));
 }
 
+TEST(Detokenizer, DoesNotReferenceDatabaseAfterConstruction) {
+  auto data = std::make_unique<std::array<char, sizeof(kBasicData)>>();
+  std::memcpy(data->data(), kBasicData, sizeof(kBasicData));
+
+  Detokenizer detok(TokenDatabase::Create(*data));
+  std::memset(data->data(), 0, data->size());
+  data.reset();
+
+  EXPECT_EQ(detok.Detokenize("\5\0\0\0"sv).BestString(), "TWO");
+}
+
+TEST(Detokenizer, CopyDetokenizes) {
+  Detokenizer copy = Detokenizer(TokenDatabase::Create<kBasicData>());
+  Detokenizer detok(copy);
+
+  EXPECT_EQ(copy.Detokenize("\1\0\0\0"sv).BestString(), "One");
+  EXPECT_EQ(detok.Detokenize("\xff\xee\xee\xdd"sv).BestString(), "FOUR");
+}
+
+std::span<const uint8_t> Encoded(std::string_view data) {
+  return std::span(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+TEST_F(Detokenize, Batch) {
+  const std::array<std::span<const uint8_t>, 4> messages = {
+      Encoded("\1\0\0\0"sv),
+      Encoded("\2\0\0\0"sv),
+      Encoded("\1\0"sv),
+      Encoded("\xff\xee\xee\xdd"sv),
+  };
+
+  DetokenizedBatch batch;
+  detok_.DetokenizeBatch(messages, batch);
+
+  ASSERT_EQ(batch.size(), 4u);
+  EXPECT_EQ(batch[0], "One");
+  EXPECT_EQ(batch[1], ERR("unknown token 00000002"));
+  EXPECT_EQ(batch[2], ERR("missing token"));
+  EXPECT_EQ(batch[3], "FOUR");
+}
+
+TEST_F(Detokenize, Batch_ReusedBatchIsReplaced) {
+  DetokenizedBatch batch;
+  const std::array<std::span<const uint8_t>, 2> first = {
+      Encoded("\1\0\0\0"sv), Encoded("\5\0\0\0"sv)};
+  detok_.DetokenizeBatch(first, batch);
+  EXPECT_EQ(batch.buffer(), "OneTWO");
+
+  const std::array<std::span<const uint8_t>, 1> second = {
+      Encoded("\xff\0\0\0"sv)};
+  detok_.DetokenizeBatch(second, batch);
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0], "333");
+}
+
 alignas(TokenDatabase::RawEntry) constexpr char kDataWithArguments[] =
     "TOKENS\0\0"
     "\x09\x00\x00\x00"
@@ -164,6 +223,12 @@ TEST_F(DetokenizeWithArgs, Successful) {
   }
 }
 
+TEST_F(DetokenizeWithArgs, SameTokenWithDifferentArguments) {
+  // The second message reuses the format string parsed for the first.
+  EXPECT_EQ(detok_.Detokenize("\xDD\xDD\xDD\xDD\x02"sv).BestString(), "1!");
+  EXPECT_EQ(detok_.Detokenize("\xDD\xDD\xDD\xDD\x04"sv).BestString(), "2!");
+}
+
 TEST_F(DetokenizeWithArgs, ExtraDataError) {
   auto error = detok_.Detokenize("\x00\x00\x00\x00MORE data"sv);
   EXPECT_FALSE(error.ok());
@@ -177,6 +242,73 @@ TEST_F(DetokenizeWithArgs, MissingArgumentError) {
   EXPECT_EQ(error.BestStringWithErrors(),
             "Use the force, " ERR("%s MISSING") ".");
 }
+class StreamingBase64 : public Detokenize {
+ protected:
+  StreamingBase64() : stream_(detok_) {}
+
+  // Writes each chunk and returns the output.
+  template <typename... Chunks>
+  std::string Write(Chunks... chunks) {
+    std::string output;
+    (stream_.Write(chunks, output), ...);
+    return output;
+  }
+
+  std::string Flush() {
+    std::string output;
+    stream_.Flush(output);
+    return output;
+  }
+
+  StreamingBase64Detokenizer stream_;
+};
+
+TEST_F(StreamingBase64, DetokenizesMessagesInLine) {
+  EXPECT_EQ(Write("Hi $AQAAAA== and $BQAAAA==!\n"), "Hi One and TWO!\n");
+}
+
+TEST_F(StreamingBase64, OutputsLinesWhenComplete) {
+  EXPECT_EQ(Write("first $AQAA", "AA=", "=\nsec"), "first One\n");
+  EXPECT_EQ(Write("ond\n$/wAAAA==\n"), "second\n333\n");
+  EXPECT_EQ(Flush(), "");
+}
+
+TEST_F(StreamingBase64, OneCharacterAtATime) {
+  constexpr std::string_view kText = "a$BQAAAA==b\n$/+7u3Q==\nc";
+  std::string output;
+  for (char c : kText) {
+    stream_.Write(std::string_view(&c, 1), output);
+  }
+  stream_.Flush(output);
+  EXPECT_EQ(output, "aTWOb\nFOUR\nc");
+}
+
+TEST_F(StreamingBase64, AdjacentMessages) {
+  EXPECT_EQ(Write("$AQAAAA==$BQAAAA==$AQAAAA==\n"), "OneTWOOne\n");
+}
+
+TEST_F(StreamingBase64, UnknownToken_LeftAsIs) {
+  EXPECT_EQ(Write("$AAAAAA== $AgAAAA==\n"), "$AAAAAA== $AgAAAA==\n");
+}
+
+TEST_F(StreamingBase64, IncompleteMessage_LeftAsIs) {
+  EXPECT_EQ(Write("$ $AQ $AQAAAA $AQAAA=A\n"), "$ $AQ $AQAAAA $AQAAA=A\n");
+}
+
+TEST_F(StreamingBase64, Flush_FinishesMessageAndLine) {
+  EXPECT_EQ(Write("end: $AQAAAA=="), "");
+  EXPECT_EQ(Flush(), "end: One");
+  EXPECT_EQ(Write("$BQAAAA=="), "");
+  EXPECT_EQ(Flush(), "TWO");
+}
+
+TEST_F(StreamingBase64, CustomPrefix) {
+  StreamingBase64Detokenizer stream(detok_, '#');
+  std::string output;
+  stream.Write("$AQAAAA== #AQAAAA==\n", output);
+  EXPECT_EQ(output, "$AQAAAA== One\n");
+}
+
 
 TEST_F(DetokenizeWithArgs, DecodingError) {
   auto error = detok_.Detokenize("\x0E\x0F\x00\x01\xFF"sv);
@@ -280,6 +412,18 @@ TEST_F(DetokenizeWithCollisions, Collision_PreferStillPresentString) {
   }
 }
 
+TEST_F(DetokenizeWithCollisions, Collision_Batch) {
+  const std::array<std::span<const uint8_t>, 2> messages = {
+      Encoded("\0\0\0\0\x01"sv), Encoded("\0\0\0\0\4Hey!\x04"sv)};
+
+  DetokenizedBatch batch;
+  detok_.DetokenizeBatch(messages, batch);
+
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[0], "One arg -1");
+  EXPECT_EQ(batch[1], "Two args Hey! 2");
+}
+
 TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   auto result = detok_.Detokenize("\0\0\0\0"sv);
   EXPECT_EQ(result.matches().size(), 7u);
@@ -32,26 +32,74 @@ enum class ArgType : uint8_t {
   kString = PW_TOKENIZER_ARG_TYPE_STRING,
 };
 
-size_t EncodeInt(int value, const std::span<std::byte>& output) {
-  return varint::Encode(value, std::as_writable_bytes(output));
-}
+constexpr size_t kMaxStringLength = internal::kMaxEncodedStringSizeBytes;
 
-size_t EncodeInt64(int64_t value, const std::span<std::byte>& output) {
-  return varint::Encode(value, std::as_writable_bytes(output));
-}
+// Strings are at most kMaxStringLength - 1 bytes, so status bytes with all
+// length bits set never occur for plain strings. They mark string table
+// arguments instead:
+//
+//   0x7F, index          a reference to the string at the table index
+//   0xFF, index, string  a string to store at the table index
+//
+// The index is a varint. The string is encoded as usual, with a status byte.
+constexpr std::byte kStringTableReference = std::byte(0x7F);
+constexpr std::byte kStringTableDefinition = std::byte(0xFF);
 
-size_t EncodeFloat(float value, const std::span<std::byte>& output) {
-  if (output.size() < sizeof(value)) {
-    return 0;
+}  // namespace
+
+size_t StringTable::Encode(const char* string, std::span<std::byte> output)
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
+  if (string == nullptr) {
+    string = "NULL";
+  }
+
+  // Find the string's length and its 65599 hash, as in pw_tokenizer/hash.h.
+  // Strings that would be truncated are always sent in full.
+  uint32_t hash = 0;
+  uint32_t coefficient = 65599u;
+  size_t length = 0;
+  for (; string[length] != '\0'; ++length) {
+    if (length == kMaxStringLength - 1) {
+      return internal::EncodeString(string, output);
+    }
+    hash += coefficient * static_cast<uint8_t>(string[length]);
+    coefficient *= 65599u;
+  }
+  hash += length;
+
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.string == string && entry.length == length &&
+        entry.hash == hash) {
+      if (output.empty()) {
+        return 0;
+      }
+      output[0] = kStringTableReference;
+      const size_t index_bytes =
+          varint::EncodeLittleEndianBase128(i, output.subspan(1));
+      return index_bytes == 0u ? 0 : 1 + index_bytes;
+    }
+  }
+
+  const size_t index = next_;
+  const size_t definition_bytes = 1 + varint::EncodedSize(index) + 1 + length;
+  if (entries_.empty() || output.size() < definition_bytes) {
+    return internal::EncodeString(string, output);
   }
-  std::memcpy(output.data(), &value, sizeof(value));
-  return sizeof(value);
+
+  output[0] = kStringTableDefinition;
+  const size_t index_bytes =
+      varint::EncodeLittleEndianBase128(index, output.subspan(1));
+  internal::EncodeString(string, output.subspan(1 + index_bytes));
+
+  entries_[index] = Entry{string, hash, static_cast<uint8_t>(length)};
+  next_ = (next_ + 1) % entries_.size();
+  return definition_bytes;
 }
 
-size_t EncodeString(const char* string, const std::span<std::byte>& output) {
-  // The top bit of the status byte indicates if the string was truncated.
-  static constexpr size_t kMaxStringLength = 0x7Fu;
+namespace internal {
 
+size_t EncodeString(const char* string, std::span<std::byte> output) {
   if (output.empty()) {  // At least one byte is needed for the status/size.
     return 0;
   }
@@ -82,11 +130,10 @@ size_t EncodeString(const char* string, const std::span<std::byte>& output) {
   return bytes_to_copy + 1;  // include the status byte in the total
 }
 
-}  // namespace
-
 size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
-                  std::span<std::byte> output) {
+                  std::span<std::byte> output,
+                  StringTable* string_table) {
   size_t arg_count = types & PW_TOKENIZER_TYPE_COUNT_MASK;
   types >>= PW_TOKENIZER_TYPE_COUNT_SIZE_BITS;
 
@@ -107,7 +154,10 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
             EncodeFloat(static_cast<float>(va_arg(args, double)), output);
         break;
       case ArgType::kString:
-        argument_bytes = EncodeString(va_arg(args, const char*), output);
+        argument_bytes =
+            string_table == nullptr
+                ? EncodeString(va_arg(args, const char*), output)
+                : string_table->Encode(va_arg(args, const char*), output);
         break;
     }
 
@@ -126,5 +176,20 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
   return encoded_bytes;
 }
 
+}  // namespace internal
+
+size_t EncodeArgs(pw_tokenizer_ArgTypes types,
+                  va_list args,
+                  std::span<std::byte> output) {
+  return internal::EncodeArgs(types, args, output, nullptr);
+}
+
+size_t EncodeArgs(pw_tokenizer_ArgTypes types,
+                  va_list args,
+                  std::span<std::byte> output,
+                  StringTable& string_table) {
+  return internal::EncodeArgs(types, args, output, &string_table);
+}
+
 }  // namespace tokenizer
 }  // namespace pw
@@ -0,0 +1,260 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_tokenizer/encode_args.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::tokenizer {
+namespace {
+
+// Encodes the arguments with the test's string table and returns the size.
+#define ENCODE(...) \
+  EncodeTo(output_, PW_TOKENIZER_ARG_TYPES(__VA_ARGS__), __VA_ARGS__)
+
+class StringTableTest : public ::testing::Test {
+ protected:
+  size_t EncodeTo(std::span<std::byte> output,
+                  pw_tokenizer_ArgTypes types,
+                  ...) {
+    va_list args;
+    va_start(args, types);
+    const size_t size = EncodeArgs(types, args, output, table_);
+    va_end(args);
+    return size;
+  }
+
+  // Checks that the first bytes of the output match the expected bytes.
+  template <size_t kSize>
+  void ExpectOutput(const char (&expected)[kSize]) {
+    EXPECT_EQ(0, std::memcmp(expected, output_.data(), kSize - 1));
+  }
+
+  StringTableWithBuffer<2> table_;
+  std::array<std::byte, 32> output_;
+};
+
+const char kThread[] = "main";
+const char kFile[] = "file.cc";
+const char kOther[] = "other";
+
+TEST_F(StringTableTest, FirstUse_DefinesEntry) {
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ExpectOutput("\xff\x00\x04main");
+}
+
+TEST_F(StringTableTest, RepeatedString_SendsReference) {
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ASSERT_EQ(2u, ENCODE(kThread));
+  ExpectOutput("\x7f\x00");
+}
+
+TEST_F(StringTableTest, RepeatedInOneMessage_SendsReference) {
+  ASSERT_EQ(20u, ENCODE(kThread, 3, kThread, kFile));
+  ExpectOutput("\xff\x00\x04main\x06\x7f\x00");
+}
+
+TEST_F(StringTableTest, Full_ReplacesOldestEntry) {
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ASSERT_EQ(10u, ENCODE(kFile));
+  ExpectOutput("\xff\x01\x07" "file.cc");
+  ASSERT_EQ(8u, ENCODE(kOther));
+  ExpectOutput("\xff\x00\x05other");
+
+  ASSERT_EQ(2u, ENCODE(kFile));
+  ExpectOutput("\x7f\x01");
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ExpectOutput("\xff\x01\x04main");
+}
+
+TEST_F(StringTableTest, SameContentsDifferentAddress_DefinesEntry) {
+  char copy[sizeof(kThread)];
+  std::memcpy(copy, kThread, sizeof(kThread));
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ASSERT_EQ(7u, ENCODE(static_cast<const char*>(copy)));
+  ExpectOutput("\xff\x01\x04main");
+}
+
+TEST_F(StringTableTest, ChangedContents_DefinesEntry) {
+  char buffer[] = "abc";
+  ASSERT_EQ(6u, ENCODE(static_cast<const char*>(buffer)));
+  buffer[1] = 'x';
+  ASSERT_EQ(6u, ENCODE(static_cast<const char*>(buffer)));
+  ExpectOutput("\xff\x01\x03" "axc");
+}
+
+TEST_F(StringTableTest, Reset_DefinesEntryAgain) {
+  ASSERT_EQ(7u, ENCODE(kThread));
+  table_.Reset();
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ExpectOutput("\xff\x00\x04main");
+}
+
+TEST_F(StringTableTest, DefinitionDoesNotFit_SendsStringWithoutDefining) {
+  std::array<std::byte, 5> small;
+  ASSERT_EQ(5u, EncodeTo(small, PW_TOKENIZER_ARG_TYPES(kThread), kThread));
+  EXPECT_EQ(std::byte{4}, small[0]);
+
+  // The string was not stored, so it is defined the next time.
+  ASSERT_EQ(7u, ENCODE(kThread));
+  ExpectOutput("\xff\x00\x04main");
+}
+
+TEST_F(StringTableTest, LongString_SendsStringWithoutDefining) {
+  char long_string[200];
+  std::memset(long_string, 'a', sizeof(long_string) - 1);
+  long_string[sizeof(long_string) - 1] = '\0';
+  const char* arg = long_string;
+  std::array<std::byte, 256> output;
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(127u, EncodeTo(output, PW_TOKENIZER_ARG_TYPES(arg), arg));
+    EXPECT_EQ(std::byte{0xfe}, output[0]);  // 126 bytes, truncated
+  }
+}
+
+void EncodeMessage(size_t& size,
+                   StringTable& table,
+                   pw_tokenizer_ArgTypes types,
+                   ...) {
+  va_list args;
+  va_start(args, types);
+  EncodedMessage message(0x12345678, types, args, table);
+  va_end(args);
+  size = message.size();
+}
+
+TEST_F(StringTableTest, EncodedMessage) {
+  size_t size;
+  EncodeMessage(size, table_, PW_TOKENIZER_ARG_TYPES(kThread), kThread);
+  EXPECT_EQ(4u + 7u, size);
+  EncodeMessage(size, table_, PW_TOKENIZER_ARG_TYPES(kThread), kThread);
+  EXPECT_EQ(4u + 2u, size);
+}
+
+// Encodes the arguments with the va_list version of EncodeArgs.
+size_t EncodeVarargs(std::span<std::byte> output,
+                     pw_tokenizer_ArgTypes types,
+                     ...) {
+  va_list args;
+  va_start(args, types);
+  const size_t size = EncodeArgs(types, args, output);
+  va_end(args);
+  return size;
+}
+
+// Checks that the template and va_list versions of EncodeArgs match.
+#define EXPECT_ENCODES_SAME(buffer_size, ...)                            \
+  do {                                                                   \
+    std::array<std::byte, buffer_size> expected{};                       \
+    std::array<std::byte, buffer_size> actual{};                         \
+    const size_t expected_size = EncodeVarargs(                          \
+        expected, PW_TOKENIZER_ARG_TYPES(__VA_ARGS__), __VA_ARGS__);     \
+    EXPECT_EQ(expected_size, EncodeArgs(actual, __VA_ARGS__));           \
+    EXPECT_EQ(expected, actual);                                         \
+  } while (0)
+
+enum Color : uint8_t { kRed = 1, kGreen = 200 };
+
+TEST(EncodeArgsTemplate, NoArgs) {
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(0u, EncodeArgs(buffer));
+  static_assert(MaxEncodedArgsSizeBytes<>() == 0u);
+}
+
+TEST(EncodeArgsTemplate, Integers) {
+  EXPECT_ENCODES_SAME(32, 0, -1, 1, INT32_MIN, INT32_MAX);
+  EXPECT_ENCODES_SAME(32, 'c', true, int16_t{-300}, uint8_t{255}, kGreen);
+  EXPECT_ENCODES_SAME(32, 0u, UINT32_MAX, INT64_MIN, UINT64_MAX, -2ll);
+}
+
+TEST(EncodeArgsTemplate, Pointers) {
+  int value = 0;
+  EXPECT_ENCODES_SAME(32, &value, static_cast<void*>(nullptr), nullptr);
+}
+
+TEST(EncodeArgsTemplate, FloatingPoint) {
+  EXPECT_ENCODES_SAME(32, 1.5f, -0.0, 3.25, 1e30);
+}
+
+TEST(EncodeArgsTemplate, Strings) {
+  char buffer[] = "mutable";
+  const char* null_string = nullptr;
+  EXPECT_ENCODES_SAME(64, "literal", buffer, kThread, null_string, "");
+}
+
+TEST(EncodeArgsTemplate, Mixed) {
+  EXPECT_ENCODES_SAME(64, kThread, 42, 2.5f, kRed, 1ll << 40, "end");
+}
+
+TEST(EncodeArgsTemplate, BufferTooSmall) {
+  for (size_t size = 0; size < 16; ++size) {
+    std::array<std::byte, 16> expected{};
+    std::array<std::byte, 16> actual{};
+    const size_t expected_size =
+        EncodeVarargs(std::span(expected).first(size),
+                      PW_TOKENIZER_ARG_TYPES(1000, "hello", 1.0f),
+                      1000,
+                      "hello",
+                      1.0f);
+    EXPECT_EQ(expected_size,
+              EncodeArgs(std::span(actual).first(size), 1000, "hello", 1.0f));
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+TEST(EncodeArgsTemplate, MaxEncodedArgsSizeBytes) {
+  static_assert(MaxEncodedArgsSizeBytes<int>() == 5u);
+  static_assert(MaxEncodedArgsSizeBytes<uint64_t>() == 10u);
+  static_assert(MaxEncodedArgsSizeBytes<double, float>() == 8u);
+  static_assert(MaxEncodedArgsSizeBytes<const char*>() == 127u);
+  static_assert(MaxEncodedArgsSizeBytes<char, int64_t, float>() == 19u);
+
+  std::array<std::byte, MaxEncodedArgsSizeBytes<int, int64_t, float>()>
+      buffer;
+  EXPECT_EQ(buffer.size(), EncodeArgs(buffer, INT32_MIN, INT64_MIN, 1.0f));
+}
+
+TEST(EncodeArgsTemplate, ToBuffer_MatchesVarargsVersion) {
+  std::array<std::byte, 32> expected{};
+  std::array<std::byte, 32> actual{};
+  size_t expected_size = expected.size();
+  size_t actual_size = actual.size();
+
+  _pw_tokenizer_ToBuffer(expected.data(),
+                         &expected_size,
+                         0x12345678,
+                         PW_TOKENIZER_ARG_TYPES(-1, kFile, 0.5),
+                         -1,
+                         kFile,
+                         0.5);
+  internal::ToBuffer(actual.data(), &actual_size, 0x12345678, -1, kFile, 0.5);
+
+  EXPECT_EQ(expected_size, actual_size);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(EncodeArgsTemplate, ToBuffer_TooSmallForToken) {
+  std::array<std::byte, 3> buffer{};
+  size_t size = buffer.size();
+  internal::ToBuffer(buffer.data(), &size, 0x12345678, 1);
+  EXPECT_EQ(0u, size);
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
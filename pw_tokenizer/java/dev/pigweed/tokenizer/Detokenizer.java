@@ -70,6 +70,11 @@ public class Detokenizer {
     return result.toString();
   }
 
+  /** Returns the handle to the C++ detokenizer, for use by StreamingDetokenizer. */
+  long nativeHandle() {
+    return handle;
+  }
+
   /** Deletes memory allocated in C++ when this class is garbage collected. */
   @Override
   protected void finalize() {
@@ -0,0 +1,61 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+package dev.pigweed.tokenizer;
+
+/**
+ * Detokenizes prefixed Base64 messages ($ followed by Base64) in text that arrives in chunks, such
+ * as a UART capture. Only the current line is buffered. Each line is returned as soon as its
+ * newline arrives, with recognized tokenized messages replaced. This wraps the C++
+ * StreamingBase64Detokenizer class.
+ */
+public class StreamingDetokenizer {
+  // The handle to the C++ streaming detokenizer instance.
+  private final long handle;
+
+  /**
+   * Creates a streaming detokenizer that uses the detokenizer's database. The C++ object shares the
+   * database, so the detokenizer does not need to outlive this object.
+   */
+  public StreamingDetokenizer(Detokenizer detokenizer) {
+    handle = newNativeStreamingDetokenizer(detokenizer.nativeHandle());
+  }
+
+  /** Processes a chunk of text. Returns the lines it completes, including their newlines. */
+  public String write(byte[] chunk) {
+    return writeNative(handle, chunk);
+  }
+
+  /** Returns the rest of the current line, without a newline. Call at the end of the text. */
+  public String flush() {
+    return flushNative(handle);
+  }
+
+  /** Deletes memory allocated in C++ when this class is garbage collected. */
+  @Override
+  protected void finalize() {
+    deleteNativeStreamingDetokenizer(handle);
+  }
+
+  private static native long newNativeStreamingDetokenizer(long detokenizerHandle);
+
+  /** Deletes the object with the provided handle, which MUST be valid. */
+  private static native void deleteNativeStreamingDetokenizer(long handle);
+
+  // These are non-static so this object has a reference held while they run, which prevents
+  // finalize from running before they finish.
+  private native String writeNative(long handle, byte[] chunk);
+
+  private native String flushNative(long handle);
+}
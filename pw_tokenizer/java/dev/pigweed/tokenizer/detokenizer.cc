@@ -13,13 +13,16 @@
 // the License.
 
 // This file provides a Java Native Interface (JNI) version of the Detokenizer
-// class. This facilitates using the tokenizer library from Java or other JVM
-// languages. A corresponding Java class is provided in Detokenizer.java.
+// and StreamingBase64Detokenizer classes. This facilitates using the tokenizer
+// library from Java or other JVM languages. Corresponding Java classes are
+// provided in Detokenizer.java and StreamingDetokenizer.java.
 
 #include <jni.h>
 
 #include <cstring>
 #include <span>
+#include <string>
+#include <string_view>
 
 #include "pw_preprocessor/concat.h"
 #include "pw_tokenizer/detokenize.h"
@@ -28,20 +31,25 @@
 #define DETOKENIZER_METHOD(method) \
   JNICALL PW_CONCAT(Java_dev_pigweed_tokenizer_, Detokenizer_, method)
 
+#define STREAMING_DETOKENIZER_METHOD(method) \
+  JNICALL PW_CONCAT(Java_dev_pigweed_tokenizer_, StreamingDetokenizer_, method)
+
 namespace pw::tokenizer {
 namespace {
 
-Detokenizer* HandleToPointer(jlong handle) {
-  Detokenizer* detokenizer = nullptr;
-  std::memcpy(&detokenizer, &handle, sizeof(detokenizer));
-  static_assert(sizeof(detokenizer) <= sizeof(handle));
-  return detokenizer;
+template <typename T = Detokenizer>
+T* HandleToPointer(jlong handle) {
+  T* pointer = nullptr;
+  std::memcpy(&pointer, &handle, sizeof(pointer));
+  static_assert(sizeof(pointer) <= sizeof(handle));
+  return pointer;
 }
 
-jlong PointerToHandle(Detokenizer* detokenizer) {
+template <typename T>
+jlong PointerToHandle(T* pointer) {
   jlong handle = 0;
-  std::memcpy(&handle, &detokenizer, sizeof(detokenizer));
-  static_assert(sizeof(handle) >= sizeof(detokenizer));
+  std::memcpy(&handle, &pointer, sizeof(pointer));
+  static_assert(sizeof(handle) >= sizeof(pointer));
   return handle;
 }
 
@@ -87,6 +95,40 @@ JNIEXPORT jstring DETOKENIZER_METHOD(detokenizeNative)(JNIEnv* env,
              : env->NewStringUTF(result.BestString().c_str());
 }
 
+JNIEXPORT jlong STREAMING_DETOKENIZER_METHOD(newNativeStreamingDetokenizer)(
+    JNIEnv*, jclass, jlong detokenizer_handle) {
+  return PointerToHandle(
+      new StreamingBase64Detokenizer(*HandleToPointer(detokenizer_handle)));
+}
+
+JNIEXPORT void STREAMING_DETOKENIZER_METHOD(deleteNativeStreamingDetokenizer)(
+    JNIEnv*, jclass, jlong handle) {
+  delete HandleToPointer<StreamingBase64Detokenizer>(handle);
+}
+
+JNIEXPORT jstring STREAMING_DETOKENIZER_METHOD(writeNative)(JNIEnv* env,
+                                                            jobject,
+                                                            jlong handle,
+                                                            jbyteArray array) {
+  jbyte* const data = env->GetByteArrayElements(array, nullptr);
+  const jsize size = env->GetArrayLength(array);
+
+  std::string lines;
+  HandleToPointer<StreamingBase64Detokenizer>(handle)->Write(
+      std::string_view(reinterpret_cast<const char*>(data), size), lines);
+
+  env->ReleaseByteArrayElements(array, data, JNI_ABORT);
+  return env->NewStringUTF(lines.c_str());
+}
+
+JNIEXPORT jstring STREAMING_DETOKENIZER_METHOD(flushNative)(JNIEnv* env,
+                                                            jobject,
+                                                            jlong handle) {
+  std::string line;
+  HandleToPointer<StreamingBase64Detokenizer>(handle)->Flush(line);
+  return env->NewStringUTF(line.c_str());
+}
+
 }  // extern "C"
 
 }  // namespace pw::tokenizer
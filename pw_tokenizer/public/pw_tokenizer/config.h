@@ -66,3 +66,12 @@ static_assert(PW_TOKENIZER_CFG_ARG_TYPES_SIZE_BYTES == 4 ||
 #ifndef PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
 #define PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES 52
 #endif  // PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
+
+// In C++, encode the arguments for PW_TOKENIZE_TO_BUFFER with a function
+// generated for each combination of argument types instead of with a va_list.
+// This avoids the va_list and the run-time type checks, which makes encoding
+// faster, but each combination of argument types used adds code. This has no
+// effect on C code or on the other tokenization macros.
+#ifndef PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES
+#define PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES 0
+#endif  // PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES
@@ -24,11 +24,13 @@
 //
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -65,13 +67,51 @@ class DetokenizedString {
   std::string BestStringWithErrors() const;
 
  private:
+  friend class Detokenizer;
+
+  // Constructs a DetokenizedString from the results of formatting each of the
+  // token's strings, paired with the date the string was removed.
+  DetokenizedString(
+      uint32_t token,
+      std::vector<std::pair<DecodedFormatString, uint32_t>>&& results);
+
   uint32_t token_;
   bool has_token_;
   std::vector<DecodedFormatString> matches_;
 };
 
+// The detokenized strings for a batch of encoded messages, which are stored in
+// a single buffer. Reusing a DetokenizedBatch for each batch reuses its memory.
+class DetokenizedBatch {
+ public:
+  DetokenizedBatch() = default;
+
+  // The number of messages in the batch.
+  size_t size() const { return ends_.size(); }
+  bool empty() const { return ends_.empty(); }
+
+  // Returns the string for the message at index, which is valid until the
+  // DetokenizedBatch is reused or destroyed.
+  std::string_view operator[](size_t index) const {
+    const size_t begin = index == 0u ? 0u : ends_[index - 1];
+    return std::string_view(buffer_).substr(begin, ends_[index] - begin);
+  }
+
+  // All of the strings in the batch, one after another.
+  const std::string& buffer() const { return buffer_; }
+
+ private:
+  friend class Detokenizer;
+
+  std::string buffer_;
+  std::vector<size_t> ends_;  // The end of each message's string in buffer_.
+};
+
 // Decodes and detokenizes strings from a TokenDatabase. This class builds a
-// hash table from the TokenDatabase to give O(1) token lookups.
+// compact index of the TokenDatabase, sorted by token, to give O(log n) token
+// lookups. The index is a few allocations regardless of the database size.
+// Each format string is parsed the first time its token is detokenized and
+// kept for later messages. Copies of a Detokenizer share the same index.
 class Detokenizer {
  public:
   // Constructs a detokenizer from a TokenDatabase. The TokenDatabase is not
@@ -91,8 +131,92 @@ class Detokenizer {
         std::span(static_cast<const uint8_t*>(encoded), size_bytes));
   }
 
+  // Detokenizes a batch of encoded messages into batch, replacing its previous
+  // contents. Each message's string is its BestStringWithErrors(). Messages
+  // without token collisions are formatted without the intermediate results
+  // that a DetokenizedString stores.
+  //
+  // Detokenizing does not modify the Detokenizer, so separate batches may be
+  // detokenized in parallel from multiple threads.
+  void DetokenizeBatch(std::span<const std::span<const uint8_t>> messages,
+                       DetokenizedBatch& batch) const;
+
+ private:
+  struct IndexEntry {
+    uint32_t token;
+    uint32_t date_removed;
+    uint32_t string_offset;  // Offset of the entry's string in strings.
+  };
+
+  struct Index {
+    ~Index();
+
+    std::vector<IndexEntry> entries;  // Sorted by token.
+    std::vector<char> strings;        // Null-terminated strings.
+
+    // The parsed format string for each entry, or null until it is first used.
+    std::unique_ptr<std::atomic<const FormatString*>[]> format_strings;
+  };
+
+  // Returns the entries for the token, in database order.
+  std::span<const IndexEntry> Find(uint32_t token) const;
+
+  // Returns the parsed format string for an entry, parsing it on first use.
+  // Safe to call from multiple threads.
+  const FormatString& GetFormatString(const IndexEntry& entry) const;
+
+  // Appends the BestStringWithErrors() for an encoded message to output.
+  void AppendBestStringWithErrors(std::span<const uint8_t> encoded,
+                                  std::string& output) const;
+
+  std::shared_ptr<const Index> index_;
+};
+
+// Detokenizes prefixed Base64 messages (see pw_tokenizer/base64.h) in text that
+// arrives in chunks, such as a UART capture. Text is processed as it is
+// written, and only the current line is buffered. Each line is output as soon
+// as its newline arrives, with every message that detokenized replaced by its
+// string. Messages that do not detokenize are left as they are.
+//
+//   StreamingBase64Detokenizer stream(detokenizer);
+//   std::string lines;
+//   while (ReadChunk(chunk)) {
+//     lines.clear();
+//     stream.Write(chunk, lines);
+//     std::cout << lines;
+//   }
+//   lines.clear();
+//   stream.Flush(lines);
+//
+class StreamingBase64Detokenizer {
+ public:
+  // The prefix must match PW_TOKENIZER_BASE64_PREFIX, which is '$' by default.
+  explicit StreamingBase64Detokenizer(const Detokenizer& detokenizer,
+                                      char prefix = '$')
+      : detokenizer_(detokenizer), prefix_(prefix), in_message_(false) {}
+
+  // Processes a chunk of text. Appends each line that the chunk completes,
+  // including its newline, to output.
+  void Write(std::string_view chunk, std::string& output);
+
+  // Appends the rest of the current line, which has no newline, to output.
+  // Call this at the end of the text.
+  void Flush(std::string& output);
+
  private:
-  std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+  // Adds a character to the current message. Returns false if the character is
+  // not part of the message.
+  bool AddToMessage(char c);
+
+  // Detokenizes the current message and appends the result to the line.
+  void FinishMessage();
+
+  Detokenizer detokenizer_;
+  char prefix_;
+  bool in_message_;
+  std::string message_;  // Base64 characters after the prefix.
+  std::string line_;     // The current line, up to the current message.
+  std::vector<std::byte> decoded_;
 };
 
 }  // namespace pw::tokenizer
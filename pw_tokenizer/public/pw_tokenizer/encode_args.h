@@ -13,18 +13,104 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstdarg>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <span>
 
 #include "pw_tokenizer/config.h"
 #include "pw_tokenizer/internal/argument_types.h"
+#include "pw_tokenizer/internal/encode_args.h"
 #include "pw_tokenizer/tokenize.h"
 
 namespace pw {
 namespace tokenizer {
 
+class StringTable;
+
+namespace internal {
+
+// Encodes arguments, using the string table if it is not null.
+size_t EncodeArgs(pw_tokenizer_ArgTypes types,
+                  va_list args,
+                  std::span<std::byte> output,
+                  StringTable* string_table);
+
+}  // namespace internal
+
+// Remembers the %s arguments sent earlier in a session, so that repeated
+// strings, such as thread names or file paths, are sent in full once and then
+// referred to by a small index.
+//
+// Each entry holds a string's address, length, and hash. A string that matches
+// an entry is encoded as a reference to it. Other strings are encoded with an
+// index to store them at, which the detokenizer records. Entries are replaced
+// in round-robin order once the table is full. Truncated strings are always
+// sent in full.
+//
+// The detokenizer must see every message encoded with the table, in order. Use
+// a string table only with reliable, ordered transports. Call Reset() and reset
+// the detokenizer's string table whenever a session starts, such as when a
+// host connects.
+//
+// StringTable is not thread safe. Encode and send messages that use the same
+// table while holding a lock, so that they are also sent in order.
+class StringTable {
+ public:
+  struct Entry {
+    const char* string;
+    uint32_t hash;
+    uint8_t length;
+  };
+
+  constexpr StringTable(std::span<Entry> entries)
+      : entries_(entries), next_(0) {}
+
+  StringTable(const StringTable&) = delete;
+  StringTable& operator=(const StringTable&) = delete;
+
+  // Forgets all strings.
+  void Reset() {
+    for (Entry& entry : entries_) {
+      entry = Entry{nullptr, 0, 0};
+    }
+    next_ = 0;
+  }
+
+ private:
+  friend size_t internal::EncodeArgs(pw_tokenizer_ArgTypes types,
+                                     va_list args,
+                                     std::span<std::byte> output,
+                                     StringTable* string_table);
+
+  // Encodes a string argument as a reference to an entry, as a new entry, or,
+  // if it is truncated or does not fit as a new entry, in full.
+  size_t Encode(const char* string, std::span<std::byte> output);
+
+  std::span<Entry> entries_;
+  size_t next_;
+};
+
+namespace internal {
+
+// The table's entries must be constructed before the table refers to them.
+template <size_t kEntries>
+struct StringTableStorage {
+  std::array<StringTable::Entry, kEntries> entries{};
+};
+
+}  // namespace internal
+
+// A StringTable with storage for kEntries strings.
+template <size_t kEntries>
+class StringTableWithBuffer : private internal::StringTableStorage<kEntries>,
+                              public StringTable {
+ public:
+  constexpr StringTableWithBuffer() : StringTable(this->entries) {}
+};
+
 // Encodes a tokenized string's arguments to a buffer. The
 // pw_tokenizer_ArgTypes parameter specifies the argument types, in place of a
 // format string.
@@ -34,6 +120,35 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
                   std::span<std::byte> output);
 
+// Encodes arguments like the function above, but sends string arguments that
+// are in the StringTable as references to it.
+size_t EncodeArgs(pw_tokenizer_ArgTypes types,
+                  va_list args,
+                  std::span<std::byte> output,
+                  StringTable& string_table);
+
+// Encodes arguments like the functions above, but selects each argument's
+// encoding from its type at compile time instead of from a va_list and
+// pw_tokenizer_ArgTypes at run time. A separate encoding function is generated
+// for each combination of argument types, so this is faster than the va_list
+// version but may increase code size.
+//
+//   std::array<std::byte, MaxEncodedArgsSizeBytes<int, float>()> buffer;
+//   size_t size = EncodeArgs(buffer, count, temperature);
+//
+template <typename... Args>
+size_t EncodeArgs(std::span<std::byte> output, Args... args) {
+  return internal::EncodeArgsTo(output, args...);
+}
+
+// The largest number of bytes that arguments of these types encode to. Strings
+// count as their longest encoding (127 bytes), since longer strings are
+// truncated.
+template <typename... ArgTypes>
+constexpr size_t MaxEncodedArgsSizeBytes() {
+  return internal::MaxEncodedSizeBytes<ArgTypes...>();
+}
+
 // Encodes a tokenized message to a fixed size buffer. The size of the buffer is
 // determined by the PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES config macro.
 //
@@ -69,6 +184,18 @@ class EncodedMessage {
         types, args, std::span<std::byte>(data_).subspan(sizeof(token)));
   }
 
+  // Encodes a tokenized message, using a StringTable for string arguments.
+  EncodedMessage(pw_tokenizer_Token token,
+                 pw_tokenizer_ArgTypes types,
+                 va_list args,
+                 StringTable& string_table) {
+    std::memcpy(data_, &token, sizeof(token));
+    args_size_ = EncodeArgs(types,
+                            args,
+                            std::span<std::byte>(data_).subspan(sizeof(token)),
+                            string_table);
+  }
+
   // The binary-encoded tokenized message.
   const std::byte* data() const { return data_; }
 
@@ -0,0 +1,163 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This header provides the argument encoders shared by the va_list and
+// template versions of EncodeArgs.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "pw_tokenizer/internal/argument_types.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace tokenizer {
+namespace internal {
+
+// The largest encoded string argument: a status byte and up to 126 characters.
+// The top bit of the status byte indicates if the string was truncated.
+constexpr size_t kMaxEncodedStringSizeBytes = 0x7F;
+
+// Each encoder returns the number of bytes written, or 0 if the argument does
+// not fit in the output.
+inline size_t EncodeInt(int value, std::span<std::byte> output) {
+  return varint::Encode(value, output);
+}
+
+inline size_t EncodeInt64(int64_t value, std::span<std::byte> output) {
+  return varint::Encode(value, output);
+}
+
+inline size_t EncodeFloat(float value, std::span<std::byte> output) {
+  if (output.size() < sizeof(value)) {
+    return 0;
+  }
+  std::memcpy(output.data(), &value, sizeof(value));
+  return sizeof(value);
+}
+
+size_t EncodeString(const char* string, std::span<std::byte> output);
+
+// Converts an argument to the integer type that varargs would pass it as.
+template <typename Int, typename T>
+constexpr Int ToInteger(T value) {
+  return static_cast<Int>(value);
+}
+
+template <typename Int, typename T>
+Int ToInteger(T* value) {
+  return static_cast<Int>(reinterpret_cast<uintptr_t>(value));
+}
+
+template <typename Int>
+constexpr Int ToInteger(std::nullptr_t) {
+  return 0;
+}
+
+// Encodes one argument of the given PW_TOKENIZER_ARG_TYPE.
+template <pw_tokenizer_ArgTypes kType>
+struct ArgEncoder;
+
+template <>
+struct ArgEncoder<PW_TOKENIZER_ARG_TYPE_INT> {
+  static constexpr size_t kMaxSizeBytes = varint::kMaxVarint32SizeBytes;
+
+  template <typename T>
+  static size_t Encode(T value, std::span<std::byte> output) {
+    return EncodeInt(ToInteger<int>(value), output);
+  }
+};
+
+template <>
+struct ArgEncoder<PW_TOKENIZER_ARG_TYPE_INT64> {
+  static constexpr size_t kMaxSizeBytes = varint::kMaxVarint64SizeBytes;
+
+  template <typename T>
+  static size_t Encode(T value, std::span<std::byte> output) {
+    return EncodeInt64(ToInteger<int64_t>(value), output);
+  }
+};
+
+template <>
+struct ArgEncoder<PW_TOKENIZER_ARG_TYPE_DOUBLE> {
+  static constexpr size_t kMaxSizeBytes = sizeof(float);
+
+  template <typename T>
+  static size_t Encode(T value, std::span<std::byte> output) {
+    return EncodeFloat(static_cast<float>(value), output);
+  }
+};
+
+template <>
+struct ArgEncoder<PW_TOKENIZER_ARG_TYPE_STRING> {
+  static constexpr size_t kMaxSizeBytes = kMaxEncodedStringSizeBytes;
+
+  static size_t Encode(const char* value, std::span<std::byte> output) {
+    return EncodeString(value, output);
+  }
+};
+
+template <typename T>
+using ArgEncoderFor = ArgEncoder<VarargsType<T>()>;
+
+template <typename... ArgTypes>
+constexpr size_t MaxEncodedSizeBytes() {
+  const size_t sizes[] = {0u, ArgEncoderFor<ArgTypes>::kMaxSizeBytes...};
+  size_t total = 0;
+  for (size_t size : sizes) {
+    total += size;
+  }
+  return total;
+}
+
+inline size_t EncodeArgsTo(std::span<std::byte>) { return 0; }
+
+// Encodes each argument with the encoder for its type, so no type information
+// is checked at run time. Stops at the first argument that does not fit.
+template <typename Arg, typename... Args>
+size_t EncodeArgsTo(std::span<std::byte> output, Arg arg, Args... args) {
+  const size_t arg_bytes = ArgEncoderFor<Arg>::Encode(arg, output);
+  if (arg_bytes == 0u) {
+    return 0;
+  }
+  return arg_bytes + EncodeArgsTo(output.subspan(arg_bytes), args...);
+}
+
+// Template version of _pw_tokenizer_ToBuffer, used by PW_TOKENIZE_TO_BUFFER
+// when PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES is enabled.
+template <typename... Args>
+void ToBuffer(void* buffer,
+              size_t* buffer_size_bytes,
+              uint32_t token,
+              Args... args) {
+  if (*buffer_size_bytes < sizeof(token)) {
+    *buffer_size_bytes = 0;
+    return;
+  }
+
+  std::memcpy(buffer, &token, sizeof(token));
+  *buffer_size_bytes =
+      sizeof(token) +
+      EncodeArgsTo(
+          std::span<std::byte>(static_cast<std::byte*>(buffer) + sizeof(token),
+                               *buffer_size_bytes - sizeof(token)),
+          args...);
+}
+
+}  // namespace internal
+}  // namespace tokenizer
+}  // namespace pw
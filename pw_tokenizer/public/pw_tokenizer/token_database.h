@@ -48,9 +48,9 @@ namespace pw::tokenizer {
 // Entries are sorted by token. A string table with a null-terminated string for
 // each entry in order follows the entries.
 //
-// Entries are accessed by iterating over the database. A O(n) Find function is
-// also provided. In typical use, a TokenDatabase is preprocessed by a
-// Detokenizer into a std::unordered_map.
+// Entries are accessed by iterating over the database. A Find function is also
+// provided. In typical use, a TokenDatabase is preprocessed by a Detokenizer
+// into a sorted index.
 class TokenDatabase {
  public:
   // Internal struct that describes how the underlying binary token database
@@ -196,7 +196,10 @@ class TokenDatabase {
   // Creates a database with no data. ok() returns false.
   constexpr TokenDatabase() : begin_{.data = nullptr}, end_{.data = nullptr} {}
 
-  // Returns all entries associated with this token. This is a O(n) operation.
+  // Returns all entries associated with this token. The entries are binary
+  // searched, so finding that a token is not present is O(log n). If the token
+  // is present, its string is located by skipping the strings before it, which
+  // is O(n) in the size of the string table.
   Entries Find(uint32_t token) const;
 
   // Returns the total number of entries (unique token-string pairs).
@@ -30,9 +30,14 @@
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/concat.h"
 #include "pw_preprocessor/util.h"
+#include "pw_tokenizer/config.h"
 #include "pw_tokenizer/internal/argument_types.h"
 #include "pw_tokenizer/internal/tokenize_string.h"
 
+#if PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES && defined(__cplusplus)
+#include "pw_tokenizer/internal/encode_args.h"
+#endif  // PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES && defined(__cplusplus)
+
 // The type of the token used in place of a format string. Also available as
 // pw::tokenizer::Token.
 typedef uint32_t pw_tokenizer_Token;
@@ -119,13 +124,29 @@ typedef uint32_t pw_tokenizer_Token;
     domain, mask, buffer, buffer_size_pointer, format, ...)       \
   do {                                                            \
     PW_TOKENIZE_FORMAT_STRING(domain, mask, format, __VA_ARGS__); \
-    _pw_tokenizer_ToBuffer(buffer,                                \
-                           buffer_size_pointer,                   \
-                           _pw_tokenizer_token,                   \
-                           PW_TOKENIZER_ARG_TYPES(__VA_ARGS__)    \
-                               PW_COMMA_ARGS(__VA_ARGS__));       \
+    _PW_TOKENIZER_TO_BUFFER(buffer,                               \
+                            buffer_size_pointer,                  \
+                            _pw_tokenizer_token,                  \
+                            __VA_ARGS__);                         \
   } while (0)
 
+#if PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES && defined(__cplusplus)
+
+#define _PW_TOKENIZER_TO_BUFFER(buffer, buffer_size_pointer, token, ...) \
+  ::pw::tokenizer::internal::ToBuffer(                                   \
+      buffer, buffer_size_pointer, token PW_COMMA_ARGS(__VA_ARGS__))
+
+#else
+
+#define _PW_TOKENIZER_TO_BUFFER(buffer, buffer_size_pointer, token, ...) \
+  _pw_tokenizer_ToBuffer(buffer,                                         \
+                         buffer_size_pointer,                            \
+                         token,                                          \
+                         PW_TOKENIZER_ARG_TYPES(__VA_ARGS__)             \
+                             PW_COMMA_ARGS(__VA_ARGS__))
+
+#endif  // PW_TOKENIZER_CFG_ENCODE_ARGS_WITH_TEMPLATES && defined(__cplusplus)
+
 // Encodes a tokenized string and arguments to a buffer on the stack. The
 // provided callback is called with the encoded data. The size of the
 // stack-allocated argument encoding buffer is set with the
@@ -68,6 +68,38 @@ class TestDecodeTokenized(unittest.TestCase):
                          '0x00000001<[%d ERROR]><[%d SKIPPED]>')
 
 
+class TestStringTable(unittest.TestCase):
+    """Tests decoding string arguments that use a string table."""
+    def test_definition_is_recorded_but_table_is_unchanged(self):
+        table = {1: 'old'}
+        args, remaining = decode.FormatString('%s!').decode(
+            b'\xff\x01\x04main', table)
+        self.assertEqual(remaining, b'')
+        self.assertEqual(args[0].value, 'main')
+        self.assertEqual(args[0].string_table_entry, (1, 'main'))
+        self.assertEqual(table, {1: 'old'})
+
+    def test_reference(self):
+        result = decode.FormatString('[%s]').format(b'\x7f\x01', False,
+                                                    {1: 'main'})
+        self.assertEqual(result.value, '[main]')
+        self.assertIsNone(result.args[0].string_table_entry)
+
+    def test_reference_to_definition_in_same_message(self):
+        result = decode.FormatString('%s %d %s').format(
+            b'\xff\x00\x02hi\x06\x7f\x00', False, {})
+        self.assertEqual(result.value, 'hi 3 hi')
+
+    def test_unknown_reference_is_an_error(self):
+        self.assertEqual(
+            decode.FormatString('%s').format(b'\x7f\x05', True, {}).value,
+            error('%s ERROR'))
+
+    def test_unterminated_index_is_an_error(self):
+        args, _ = decode.FormatString('%s').decode(b'\xff\x80', {})
+        self.assertFalse(args[0].ok())
+
+
 class TestIntegerDecoding(unittest.TestCase):
     """Test decoding variable-length integers."""
     def test_decode_generated_data(self):
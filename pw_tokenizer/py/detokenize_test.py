@@ -312,6 +312,45 @@ class DetokenizeTest(unittest.TestCase):
                          frozenset(detok.database.token_to_entries.keys()))
 
 
+class DetokenizeWithStringTable(unittest.TestCase):
+    """Tests string arguments that refer to a string table."""
+    def setUp(self):
+        super().setUp()
+        self.detok = detokenize.Detokenizer(
+            tokens.Database([
+                tokens.TokenizedStringEntry(1, '[%s] %s'),
+                tokens.TokenizedStringEntry(2, '%s'),
+                tokens.TokenizedStringEntry(2, '%d'),
+            ]))
+
+    def test_definitions_are_remembered(self):
+        self.assertEqual(
+            str(
+                self.detok.detokenize(
+                    b'\1\0\0\0\xff\x00\x04main\xff\x01\x02hi')),
+            '[main] hi')
+        self.assertEqual(
+            str(self.detok.detokenize(b'\1\0\0\0\x7f\x01\x7f\x00')),
+            '[hi] main')
+        self.assertEqual(self.detok.string_table, {0: 'main', 1: 'hi'})
+
+    def test_definition_replaces_entry(self):
+        self.detok.detokenize(b'\2\0\0\0\xff\x00\x01a')
+        self.detok.detokenize(b'\2\0\0\0\xff\x00\x01b')
+        self.assertEqual(str(self.detok.detokenize(b'\2\0\0\0\x7f\x00')),
+                         'b')
+
+    def test_failed_message_does_not_define_entries(self):
+        result = self.detok.detokenize(b'\1\0\0\0\xff\x00\x04main\x7f\x09')
+        self.assertFalse(result.ok())
+        self.assertEqual(self.detok.string_table, {})
+
+    def test_reset(self):
+        self.detok.detokenize(b'\2\0\0\0\xff\x00\x01a')
+        self.detok.reset_string_table()
+        self.assertFalse(self.detok.detokenize(b'\2\0\0\0\x7f\x00').ok())
+
+
 class DetokenizeWithCollisions(unittest.TestCase):
     """Tests collision resolution."""
     def setUp(self):
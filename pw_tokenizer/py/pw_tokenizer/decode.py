@@ -18,11 +18,22 @@ format a string with encoded arguments. The FormatString class may also be used.
 
 Missing, truncated, or otherwise corrupted arguments are handled and displayed
 in the resulting string with an error message.
+
+String arguments may refer to a string table, which maps indices to strings
+sent earlier in a session. See pw::tokenizer::StringTable in encode_args.h.
 """
 
+import collections
 import re
 import struct
-from typing import Iterable, List, NamedTuple, Match, Sequence, Tuple
+from typing import (Iterable, List, MutableMapping, NamedTuple, Match,
+                    Optional, Sequence, Tuple)
+
+# Status bytes that mark string table arguments instead of plain strings.
+STRING_TABLE_REFERENCE = 0x7f  # followed by a varint index
+STRING_TABLE_DEFINITION = 0xff  # followed by a varint index and a string
+
+StringTable = MutableMapping[int, str]
 
 
 def zigzag_decode(value: int) -> int:
@@ -32,6 +43,18 @@ def zigzag_decode(value: int) -> int:
     return (value >> 1) ^ (~0)
 
 
+def _decode_varint(encoded: bytes) -> Optional[Tuple[int, int]]:
+    """Returns an unsigned varint's value and size, or None if unterminated."""
+    value = 0
+
+    for i, byte in enumerate(encoded[:10]):
+        value |= (byte & 0x7f) << (7 * i)
+        if not byte & 0x80:
+            return value, i + 1
+
+    return None
+
+
 class FormatSpec:
     """Represents a format specifier parsed from a printf-style string."""
 
@@ -84,13 +107,25 @@ class FormatSpec:
                 self._REMAP_TYPE.get(self.type, self.type)
             ])
 
-    def decode(self, encoded_arg: bytes) -> 'DecodedArg':
-        """Decodes the provided data according to this format specifier."""
+    def decode(self,
+               encoded_arg: bytes,
+               string_table: Optional[StringTable] = None) -> 'DecodedArg':
+        """Decodes the provided data according to this format specifier.
+
+        If a string_table is provided, string arguments may refer to it, and
+        strings that define entries are added to it.
+        """
         if self.type == '%':  # literal %
             return DecodedArg(self, (),
                               b'')  # Use () as the value for % formatting.
 
         if self.type == 's':  # string
+            if (string_table is not None and encoded_arg
+                    and encoded_arg[0] in (STRING_TABLE_REFERENCE,
+                                           STRING_TABLE_DEFINITION)):
+                return self._decode_string_table_arg(encoded_arg,
+                                                     string_table)
+
             return self._decode_string(encoded_arg)
 
         if self.type == 'c':  # character
@@ -178,6 +213,34 @@ class FormatSpec:
 
         return DecodedArg(self, decoded, raw_data, status)
 
+    def _decode_string_table_arg(self, encoded: bytes,
+                                 string_table: StringTable) -> 'DecodedArg':
+        """Decodes a string table reference or definition."""
+        varint = _decode_varint(encoded[1:])
+        if varint is None:
+            return DecodedArg(self, None, encoded, DecodedArg.DECODE_ERROR,
+                              'Unterminated string table index')
+
+        index, index_size = varint
+        header = encoded[:1 + index_size]
+
+        if encoded[0] == STRING_TABLE_REFERENCE:
+            if index not in string_table:
+                return DecodedArg(
+                    self, None, header, DecodedArg.DECODE_ERROR,
+                    'Unknown string table index {}'.format(index))
+
+            return DecodedArg(self, string_table[index], header)
+
+        arg = self._decode_string(encoded[len(header):])
+        arg.raw_data = header + arg.raw_data
+
+        if arg.ok():
+            string_table[index] = arg.value
+            arg.string_table_entry = (index, arg.value)
+
+        return arg
+
     def _decode_char(self, encoded: bytes) -> 'DecodedArg':
         """Reads an integer from the data, then converts it to a string."""
         arg = self._decode_signed_integer(encoded)
@@ -231,6 +294,9 @@ class DecodedArg:
         self._status = status
         self.error = error
 
+        # The (index, string) that this argument added to the string table.
+        self.string_table_entry: Optional[Tuple[int, str]] = None
+
     def ok(self) -> bool:
         """The argument was decoded without errors."""
         return self.status == self.OK or self.status == self.TRUNCATED
@@ -321,22 +387,33 @@ class FormatString:
 
         return segments
 
-    def decode(self, encoded: bytes) -> Tuple[Sequence[DecodedArg], bytes]:
+    def decode(
+        self,
+        encoded: bytes,
+        string_table: Optional[StringTable] = None
+    ) -> Tuple[Sequence[DecodedArg], bytes]:
         """Decodes arguments according to the format string.
 
         Args:
           encoded: bytes; the encoded arguments
+          string_table: strings that string arguments may refer to; this is
+              not modified, but entries defined by the arguments are recorded
+              in each DecodedArg's string_table_entry
 
         Returns:
           tuple with the decoded arguments and any unparsed data
         """
         decoded_args = []
 
+        # Collect new entries separately so later arguments can refer to them.
+        if string_table is not None:
+            string_table = collections.ChainMap({}, string_table)
+
         fatal_error = False
         index = 0
 
         for spec in self.specifiers:
-            arg = spec.decode(encoded[index:])
+            arg = spec.decode(encoded[index:], string_table)
 
             if fatal_error:
                 # After an error is encountered, continue to attempt to parse
@@ -353,19 +430,21 @@ class FormatString:
 
     def format(self,
                encoded_args: bytes,
-               show_errors: bool = False) -> FormattedString:
+               show_errors: bool = False,
+               string_table: Optional[StringTable] = None) -> FormattedString:
         """Decodes arguments and formats the string with them.
 
         Args:
           encoded_args: the arguments to decode and format the string with
           show_errors: if True, an error message is used in place of the %
               conversion specifier when an argument fails to decode
+          string_table: strings that string arguments may refer to
 
         Returns:
           tuple with the formatted string, decoded arguments, and remaining data
         """
         # Insert formatted arguments in place of each format specifier.
-        args, remaining = self.decode(encoded_args)
+        args, remaining = self.decode(encoded_args, string_table)
 
         if show_errors:
             self._segments[1::2] = (arg.format() for arg in args)
@@ -69,7 +69,8 @@ class DetokenizedString:
                  token: Optional[int],
                  format_string_entries: Iterable[tuple],
                  encoded_message: bytes,
-                 show_errors: bool = False):
+                 show_errors: bool = False,
+                 string_table: Optional[decode.StringTable] = None):
         self.token = token
         self.encoded_message = encoded_message
         self._show_errors = show_errors
@@ -81,7 +82,7 @@ class DetokenizedString:
 
         for entry, fmt in format_string_entries:
             result = fmt.format(encoded_message[ENCODED_TOKEN.size:],
-                                show_errors)
+                                show_errors, string_table)
 
             # Sort competing entries so the most likely matches appear first.
             # Decoded strings are prioritized by whether they
@@ -184,6 +185,10 @@ class Detokenizer:
         """
         self.show_errors = show_errors
 
+        # Strings that the device sent earlier in the session. See
+        # pw::tokenizer::StringTable.
+        self.string_table: Dict[int, str] = {}
+
         # Cache FormatStrings for faster lookup & formatting.
         self._cache: Dict[int, List[_TokenizedFormatString]] = {}
 
@@ -212,8 +217,21 @@ class Detokenizer:
                                      self.show_errors)
 
         token, = ENCODED_TOKEN.unpack_from(encoded_message)
-        return DetokenizedString(token, self.lookup(token), encoded_message,
-                                 self.show_errors)
+        result = DetokenizedString(token, self.lookup(token), encoded_message,
+                                   self.show_errors, self.string_table)
+
+        # Only keep strings defined by a message that decoded successfully.
+        if result.successes:
+            for arg in result.successes[0].args:
+                if arg.string_table_entry is not None:
+                    index, value = arg.string_table_entry
+                    self.string_table[index] = value
+
+        return result
+
+    def reset_string_table(self) -> None:
+        """Forgets the string table; call when the device resets its table."""
+        self.string_table.clear()
 
     def detokenize_base64(self,
                           data: AnyStr,
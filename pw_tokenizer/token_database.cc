@@ -14,6 +14,9 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace pw::tokenizer {
 
 TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
@@ -25,17 +28,30 @@ TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
 }
 
 TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
-  Iterator first = begin();
-  while (first != end() && token > first->token) {
-    ++first;
+  // Entries are sorted by token, so binary search them without touching the
+  // string table. Lookups for tokens that are not present end here.
+  const RawEntry* const first = std::lower_bound(
+      begin_.entry, end_.entry, token, [](const RawEntry& entry, uint32_t t) {
+        return entry.token < t;
+      });
+
+  if (first == end_.entry || first->token != token) {
+    return Entries(end(), end());
+  }
+
+  // Strings are stored in entry order. Skip one string for each earlier entry.
+  const char* string = end_.data;
+  for (const RawEntry* entry = begin_.entry; entry != first; ++entry) {
+    string += std::strlen(string) + 1;
   }
 
-  Iterator last = first;
+  const Iterator found(first, string);
+  Iterator last = found;
   while (last != end() && token == last->token) {
     ++last;
   }
 
-  return Entries(first, last);
+  return Entries(found, last);
 }
 
 }  // namespace pw::tokenizer
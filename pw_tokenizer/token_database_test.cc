@@ -14,6 +14,7 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <array>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -238,6 +239,57 @@ TEST(TokenDatabase, MultipleEntriesWithSameToken) {
   }
 }
 
+// Database with 100 entries for the even tokens 0 to 198. Each entry's string
+// is its token in decimal.
+alignas(TokenDatabase::RawEntry) constexpr auto kLargeData = [] {
+  constexpr size_t kEntries = 100;
+  std::array<char, 16 + 8 * kEntries + 4 * kEntries> data{};
+  constexpr char kHeader[] = "TOKENS\0\0\x64\0\0\0\0\0\0\0";
+  for (size_t i = 0; i < 16; ++i) {
+    data[i] = kHeader[i];
+  }
+
+  size_t string = 16 + 8 * kEntries;
+  for (size_t i = 0; i < kEntries; ++i) {
+    const uint32_t token = 2 * i;
+    data[16 + 8 * i] = static_cast<char>(token);
+    for (size_t j = 4; j < 8; ++j) {
+      data[16 + 8 * i + j] = '\xff';
+    }
+
+    if (token >= 100) {
+      data[string++] = static_cast<char>('0' + token / 100);
+    }
+    if (token >= 10) {
+      data[string++] = static_cast<char>('0' + token / 10 % 10);
+    }
+    data[string++] = static_cast<char>('0' + token % 10);
+    data[string++] = '\0';
+  }
+  return data;
+}();
+
+constexpr TokenDatabase kLarge = TokenDatabase::Create<kLargeData>();
+static_assert(kLarge.size() == 100u);
+
+TEST(TokenDatabase, Find_EveryEntryInLargeDatabase) {
+  for (uint32_t token = 0; token < 200; token += 2) {
+    TokenDatabase::Entries match = kLarge.Find(token);
+    ASSERT_EQ(match.size(), 1u);
+    EXPECT_EQ(match[0].token, token);
+    EXPECT_EQ(match[0].date_removed, 0xFFFFFFFFu);
+    EXPECT_EQ(std::to_string(token), match[0].string);
+  }
+}
+
+TEST(TokenDatabase, Find_MissingFromLargeDatabase) {
+  for (uint32_t token = 1; token < 200; token += 2) {
+    EXPECT_TRUE(kLarge.Find(token).empty());
+  }
+  EXPECT_TRUE(kLarge.Find(200).empty());
+  EXPECT_TRUE(kLarge.Find(0xFFFFFFFFu).empty());
+}
+
 TEST(TokenDatabase, Empty) {
   constexpr TokenDatabase empty_db = TokenDatabase::Create<kEmptyData>();
   static_assert(empty_db.size() == 0u);
@@ -36,6 +36,8 @@ pw_set_backend(pw_sync.counting_semaphore
                pw_sync_stl.counting_semaphore_backend)
 pw_set_backend(pw_sync.mutex pw_sync_stl.mutex_backend)
 pw_set_backend(pw_sync.timed_mutex pw_sync_stl.timed_mutex_backend)
+pw_set_backend(pw_sync.shared_mutex pw_sync_stl.shared_mutex_backend)
+pw_set_backend(pw_sync.event_flags pw_sync_stl.event_flags_backend)
 pw_set_backend(pw_sync.thread_notification
                pw_sync.binary_semaphore_thread_notification_backend)
 pw_set_backend(pw_sync.timed_thread_notification
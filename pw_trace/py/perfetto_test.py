@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the Perfetto trace writer."""
+
+import io
+import unittest
+
+from pw_trace import perfetto, trace
+
+
+def _decode_varint(data: bytes, idx: int):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[idx]
+        idx += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, idx
+
+
+def _decode(data: bytes) -> dict:
+    """Decodes a message to {field: [values]}, without nested messages."""
+    fields: dict = {}
+    idx = 0
+    while idx < len(data):
+        key, idx = _decode_varint(data, idx)
+        if key & 7 == 0:
+            value, idx = _decode_varint(data, idx)
+        elif key & 7 == 1:
+            value = data[idx:idx + 8]
+            idx += 8
+        else:
+            size, idx = _decode_varint(data, idx)
+            value = data[idx:idx + size]
+            idx += size
+        fields.setdefault(key >> 3, []).append(value)
+    return fields
+
+
+def _packets(events) -> list:
+    output = io.BytesIO()
+    perfetto.write_perfetto_trace(events, output)
+    return [_decode(packet) for packet in _decode(output.getvalue())[1]]
+
+
+class TestPerfettoTraceWriter(unittest.TestCase):
+    """Tests writing events as Perfetto trace packets."""
+    def test_instant_event(self):
+        packets = _packets([
+            trace.TraceEvent(trace.TraceType.INSTANTANEOUS, "module",
+                             "label", 10)
+        ])
+        self.assertEqual(2, len(packets))
+
+        track = _decode(packets[0][60][0])
+        self.assertEqual([1], track[1])
+        self.assertEqual([b'module'], track[2])
+
+        self.assertEqual([10000], packets[1][8])
+        event = _decode(packets[1][11][0])
+        self.assertEqual([3], event[9])
+        self.assertEqual([1], event[11])
+        self.assertEqual([b'label'], event[23])
+
+    def test_duration_events_share_a_child_track(self):
+        packets = _packets([
+            trace.TraceEvent(trace.TraceType.DURATION_START, "m", "L", 1),
+            trace.TraceEvent(trace.TraceType.DURATION_END, "m", "L", 2),
+        ])
+        # The module's track, the label's track, then the two events.
+        self.assertEqual(4, len(packets))
+        label_track = _decode(packets[1][60][0])
+        self.assertEqual([b'L'], label_track[2])
+        self.assertEqual([1], label_track[5])
+
+        begin = _decode(packets[2][11][0])
+        end = _decode(packets[3][11][0])
+        self.assertEqual([1], begin[9])
+        self.assertEqual([2], end[9])
+        self.assertEqual(label_track[1], begin[11])
+        self.assertEqual(label_track[1], end[11])
+
+    def test_async_events_use_a_track_per_id(self):
+        packets = _packets([
+            trace.TraceEvent(trace.TraceType.ASYNC_START, "m", "L", 1, "G",
+                             1),
+            trace.TraceEvent(trace.TraceType.ASYNC_START, "m", "L", 2, "G",
+                             2),
+        ])
+        events = [_decode(p[11][0]) for p in packets if 11 in p]
+        self.assertEqual(2, len(events))
+        self.assertNotEqual(events[0][11], events[1][11])
+        self.assertEqual([b'm'], events[0][22])
+
+    def test_counter_event(self):
+        packets = _packets([
+            trace.TraceEvent(trace.TraceType.INSTANTANEOUS,
+                             "module",
+                             "counter",
+                             10,
+                             has_data=True,
+                             data_fmt="@pw_arg_counter",
+                             data=(5).to_bytes(4, byteorder="little"))
+        ])
+        counter_track = _decode(packets[-2][60][0])
+        self.assertEqual([b'counter'], counter_track[2])
+        self.assertIn(8, counter_track)
+
+        event = _decode(packets[-1][11][0])
+        self.assertEqual([4], event[9])
+        self.assertEqual(counter_track[1], event[11])
+        self.assertEqual([5], event[30])
+
+    def test_struct_data_is_annotated(self):
+        packets = _packets([
+            trace.TraceEvent(trace.TraceType.INSTANTANEOUS,
+                             "module",
+                             "label",
+                             10,
+                             has_data=True,
+                             data_fmt="@pw_py_struct_fmt:H",
+                             data=(7).to_bytes(2, byteorder="little"))
+        ])
+        event = _decode(packets[-1][11][0])
+        annotation = _decode(event[4][0])
+        self.assertEqual([b'data_0'], annotation[10])
+        self.assertEqual([7], annotation[4])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -19,7 +19,8 @@ Trace module which creates trace files from a list of trace events.
 This is a work in progress, future work will look to add:
     - Config options to customize output.
     - A method of providing custom data formatters.
-    - Perfetto support.
+
+See perfetto.py for writing Perfetto traces.
 """
 from enum import Enum
 import json
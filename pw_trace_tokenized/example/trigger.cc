@@ -52,34 +52,29 @@ constexpr uint32_t kTriggerEndTraceRef = PW_TRACE_REF(PW_TRACE_TYPE_ASYNC_END,
 
 }  // namespace
 
-pw_trace_TraceEventReturnFlags TraceEventCallback(
-    void* /* user_data */,
-    uint32_t trace_ref,
-    pw_trace_EventType /* event_type */,
-    const char* /* module */,
-    uint32_t trace_id,
-    uint8_t /* flags */) {
-  if (trace_ref == kTriggerStartTraceRef && trace_id == kTriggerId) {
-    PW_LOG_INFO("Trace capture started!");
-    PW_TRACE_SET_ENABLED(true);
-  }
-  if (trace_ref == kTriggerEndTraceRef && trace_id == kTriggerId) {
-    PW_LOG_INFO("Trace capture ended!");
-    return PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING;
-  }
-  return 0;
-}
-
 int main(int argc, char** argv) {  // Take filename as arg
   if (argc != 2) {
     PW_LOG_ERROR("Expected output file name as argument.\n");
     return -1;
   }
 
-  // Register trigger callback
-  pw::trace::Callbacks::Instance()
-      .RegisterEventCallback(TraceEventCallback,
-                             pw::trace::CallbacksImpl::kCallOnEveryEvent)
+  // Register trigger filters, which start tracing on the start event and stop
+  // it after the end event. Filters are checked on every event, even while
+  // tracing is disabled, but only cost a bitmap lookup for other events.
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+  callbacks
+      .RegisterEventFilter(kTriggerStartTraceRef,
+                           true,
+                           kTriggerId,
+                           PW_TRACE_EVENT_RETURN_FLAGS_ENABLE_BEFORE_PROCESSING,
+                           pw::trace::CallbacksImpl::kCallOnEveryEvent)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  callbacks
+      .RegisterEventFilter(kTriggerEndTraceRef,
+                           true,
+                           kTriggerId,
+                           PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING,
+                           pw::trace::CallbacksImpl::kCallOnEveryEvent)
       .IgnoreError();  // TODO(pwbug/387): Handle Status properly
 
   // Ensure tracing is off at start, the trigger will turn it on.
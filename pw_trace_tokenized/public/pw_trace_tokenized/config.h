@@ -84,6 +84,19 @@ static_assert(
 #define PW_TRACE_CONFIG_MAX_SINKS 2
 #endif  // PW_TRACE_CONFIG_MAX_SINKS
 
+// PW_TRACE_CONFIG_MAX_EVENT_FILTERS is the maximum number of event filters
+// which can be registered at a time.
+#ifndef PW_TRACE_CONFIG_MAX_EVENT_FILTERS
+#define PW_TRACE_CONFIG_MAX_EVENT_FILTERS 4
+#endif  // PW_TRACE_CONFIG_MAX_EVENT_FILTERS
+
+// PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS is the number of bits in the bitmaps
+// of trace tokens which have event filters. Events whose token's bit is clear
+// skip the filter table. Must be a multiple of 32.
+#ifndef PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS
+#define PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS 64
+#endif  // PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS
+
 // --- Config options for locks ---
 
 // PW_TRACE_LOCK  Is is also called when registering and unregistering callbacks
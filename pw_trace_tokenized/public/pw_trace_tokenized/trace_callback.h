@@ -36,6 +36,10 @@ PW_EXTERN_C_START
 //    skip this sample.
 //    - PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING can be set true to
 //      disable tracing after this sample.
+//    - PW_TRACE_EVENT_RETURN_FLAGS_ENABLE_BEFORE_PROCESSING can be set true to
+//      enable tracing before this sample is processed. This only has an effect
+//      when returned for an event while tracing is disabled, so it is only
+//      useful from callbacks that are called on every event.
 //
 // When registering the callback the parameter 'called_on_every_event' is used
 // to indicate if the callback should be called even when tracing is disabled.
@@ -59,7 +63,8 @@ typedef enum {
 enum {
   PW_TRACE_EVENT_RETURN_FLAGS_NONE = 0,
   PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT = 1 << 0,
-  PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING = 1 << 1
+  PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING = 1 << 1,
+  PW_TRACE_EVENT_RETURN_FLAGS_ENABLE_BEFORE_PROCESSING = 1 << 2
 };
 typedef uint32_t pw_trace_TraceEventReturnFlags;
 
@@ -82,6 +87,29 @@ pw_Status pw_trace_RegisterEventCallback(
 // more events.
 pw_Status pw_trace_UnregisterEventCallback(pw_trace_EventCallbackHandle handle);
 
+// An event filter applies return flags to every event with a specific trace
+// reference (see PW_TRACE_REF), as if an event callback had returned them. If
+// match_trace_id is true, only events with the provided trace_id match. Filters
+// are checked with a bitmap lookup on the trace reference, so unlike event
+// callbacks, they add almost no cost to events which they do not match.
+//
+// called_on_every_event has the same meaning as for event callbacks. Returns
+// INVALID_ARGUMENT if flags is PW_TRACE_EVENT_RETURN_FLAGS_NONE, and
+// RESOURCE_EXHAUSTED if PW_TRACE_CONFIG_MAX_EVENT_FILTERS filters are
+// registered.
+typedef size_t pw_trace_EventFilterHandle;
+pw_Status pw_trace_RegisterEventFilter(
+    uint32_t trace_ref,
+    bool match_trace_id,
+    uint32_t trace_id,
+    pw_trace_TraceEventReturnFlags flags,
+    pw_trace_ShouldCallOnEveryEvent called_on_every_event,
+    pw_trace_EventFilterHandle* handle);
+
+// pw_trace_UnregisterEventFilter removes a filter registered with
+// pw_trace_RegisterEventFilter.
+pw_Status pw_trace_UnregisterEventFilter(pw_trace_EventFilterHandle handle);
+
 // pw_trace_Sink* is called after the trace event is encoded.
 // Trace will internally handle locking, so every Start event will have a
 // matching End event before another sequence is started.
@@ -148,6 +176,15 @@ class CallbacksImpl {
     EventCallback callback;
     CallOnEveryEvent called_on_every_event;
   };
+  using EventFilterHandle = pw_trace_EventFilterHandle;
+  struct EventFilter {
+    uint32_t trace_ref;
+    uint32_t trace_id;
+    bool match_trace_id;
+    // Flags applied to matching events; NONE marks an unused filter.
+    pw_trace_TraceEventReturnFlags flags;
+    CallOnEveryEvent called_on_every_event;
+  };
 
   pw::Status RegisterSink(SinkStartBlock start_func,
                           SinkAddBytes add_bytes_func,
@@ -178,11 +215,61 @@ class CallbacksImpl {
   size_t GetCalledOnEveryEventCount() const {
     return called_on_every_event_count_;
   }
+  size_t GetEventCallbackCount() const { return event_callback_count_; }
+  size_t GetSinkCount() const { return sink_count_; }
+
+  // Filters which match a trace reference, and optionally a trace ID. See
+  // pw_trace_RegisterEventFilter.
+  pw::Status RegisterEventFilter(
+      uint32_t trace_ref,
+      pw_trace_TraceEventReturnFlags flags,
+      CallOnEveryEvent called_on_every_event = kCallOnlyWhenEnabled,
+      EventFilterHandle* handle = nullptr) {
+    return RegisterEventFilter(
+        trace_ref, false, 0, flags, called_on_every_event, handle);
+  }
+  pw::Status RegisterEventFilter(uint32_t trace_ref,
+                                 bool match_trace_id,
+                                 uint32_t trace_id,
+                                 pw_trace_TraceEventReturnFlags flags,
+                                 CallOnEveryEvent called_on_every_event,
+                                 EventFilterHandle* handle = nullptr);
+  pw::Status UnregisterEventFilter(EventFilterHandle handle);
+  pw::Status UnregisterAllEventFilters();
+  // Returns the combined flags of all matching filters.
+  pw_trace_TraceEventReturnFlags ApplyEventFilters(
+      CallOnEveryEvent called_on_every_event,
+      uint32_t trace_ref,
+      uint32_t trace_id) const;
+  size_t GetCalledOnEveryEventFilterCount() const {
+    return called_on_every_event_filter_count_;
+  }
+  size_t GetEventFilterCount() const { return event_filter_count_; }
 
  private:
+  static constexpr size_t kFilterBitmapBits =
+      PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS;
+  static_assert(kFilterBitmapBits > 0u && kFilterBitmapBits % 32u == 0u,
+                "PW_TRACE_CONFIG_EVENT_FILTER_BITMAP_BITS must be a nonzero "
+                "multiple of 32");
+
+  // Sets the bits for every registered filter's trace reference.
+  void RebuildEventFilterBitmaps();
+
   EventCallbacks event_callbacks_[PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS];
   SinkCallbacks sink_callbacks_[PW_TRACE_CONFIG_MAX_SINKS];
+  EventFilter event_filters_[PW_TRACE_CONFIG_MAX_EVENT_FILTERS] = {};
+  // One bitmap for each CallOnEveryEvent value. A filter's trace reference sets
+  // bit trace_ref % kFilterBitmapBits, so most events that match no filter are
+  // rejected with a single bit test.
+  uint32_t filter_bitmaps_[2][kFilterBitmapBits / 32] = {};
   size_t called_on_every_event_count_ = 0;
+  // Counts of registered callbacks, filters, and sinks, so events can skip the
+  // callback, filter, and sink tables entirely when nothing is registered.
+  size_t event_callback_count_ = 0;
+  size_t called_on_every_event_filter_count_ = 0;
+  size_t event_filter_count_ = 0;
+  size_t sink_count_ = 0;
 
   bool IsSinkFree(pw_trace_SinkHandle handle) {
     return sink_callbacks_[handle].start_block == nullptr &&
@@ -0,0 +1,152 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides a columnar capture format for tokenized trace events.
+//
+// A raw tokenized trace is a series of size-prefixed events, each holding a
+// token, a varint time delta, and an optional payload. Storing each of these in
+// its own column lets the host read tokens and timestamps without touching the
+// payloads, and compresses much better than interleaved events.
+//
+// The capture layout is:
+//
+//   magic            "PWTC"
+//   version          1 byte (kColumnarTraceVersion)
+//   ticks_per_second varint
+//   event_count      varint
+//   tokens           event_count little-endian uint32_t tokens
+//   deltas           varint length in bytes, then one varint per event
+//   payload_sizes    varint length in bytes, then one varint per event
+//   payloads         varint length in bytes, then the concatenated payloads
+//
+// A payload is everything in the event after the time delta: the trace ID, if
+// the event has one, followed by the event's data.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace trace {
+
+inline constexpr char kColumnarTraceMagic[] = {'P', 'W', 'T', 'C'};
+inline constexpr uint8_t kColumnarTraceVersion = 1;
+
+struct ColumnarTraceEvent {
+  uint32_t token;
+  // The sum of the time deltas up to and including this event, in ticks.
+  uint64_t timestamp;
+  ConstByteSpan payload;
+};
+
+// Reads the events from a columnar trace capture. The reader does not copy the
+// capture, which must outlive it.
+class ColumnarTraceReader {
+ public:
+  class iterator {
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = ColumnarTraceEvent;
+    using pointer = const ColumnarTraceEvent*;
+    using reference = const ColumnarTraceEvent&;
+    using iterator_category = std::forward_iterator_tag;
+
+    constexpr iterator() : reader_(nullptr), index_(0), event_{} {}
+
+    iterator& operator++();
+
+    iterator operator++(int) {
+      iterator original = *this;
+      operator++();
+      return original;
+    }
+
+    reference operator*() const { return event_; }
+    pointer operator->() const { return &event_; }
+
+    bool operator==(const iterator& rhs) const { return index_ == rhs.index_; }
+    bool operator!=(const iterator& rhs) const { return index_ != rhs.index_; }
+
+   private:
+    friend class ColumnarTraceReader;
+
+    iterator(const ColumnarTraceReader& reader, size_t index);
+
+    void Read();
+
+    const ColumnarTraceReader* reader_;
+    size_t index_;
+    size_t delta_offset_ = 0;
+    size_t size_offset_ = 0;
+    size_t payload_offset_ = 0;
+    ColumnarTraceEvent event_;
+  };
+
+  // Parses the capture's header and checks that its columns are consistent, so
+  // iterating never reads out of bounds.
+  //
+  // Returns:
+  // OK - the capture is valid.
+  // DATA_LOSS - the capture is truncated or its columns are inconsistent.
+  // UNIMPLEMENTED - the capture is from an unsupported format version.
+  static Result<ColumnarTraceReader> Create(ConstByteSpan capture);
+
+  uint32_t ticks_per_second() const { return ticks_per_second_; }
+
+  size_t size() const { return event_count_; }
+  bool empty() const { return event_count_ == 0u; }
+
+  iterator begin() const { return iterator(*this, 0); }
+  iterator end() const { return iterator(*this, event_count_); }
+
+ private:
+  constexpr ColumnarTraceReader() = default;
+
+  uint32_t ticks_per_second_ = 0;
+  size_t event_count_ = 0;
+  ConstByteSpan tokens_;
+  ConstByteSpan deltas_;
+  ConstByteSpan payload_sizes_;
+  ConstByteSpan payloads_;
+};
+
+// Returns the number of bytes WriteColumnarTrace() needs for a raw trace.
+//
+// The raw trace is a series of events, each prefixed with its size in one byte,
+// as written by the trace buffer and trace_to_file examples.
+//
+// Returns:
+// OK - the size of the columnar capture.
+// DATA_LOSS - the raw trace has a truncated or malformed event.
+Result<size_t> ColumnarTraceSize(ConstByteSpan raw_trace,
+                                 uint32_t ticks_per_second);
+
+// Converts a raw trace to the columnar capture format.
+//
+// Returns:
+// OK - the number of bytes written to capture.
+// DATA_LOSS - the raw trace has a truncated or malformed event.
+// RESOURCE_EXHAUSTED - capture is too small; see ColumnarTraceSize().
+Result<size_t> WriteColumnarTrace(ConstByteSpan raw_trace,
+                                  uint32_t ticks_per_second,
+                                  ByteSpan capture);
+
+}  // namespace trace
+}  // namespace pw
@@ -0,0 +1,78 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides a trace sink which forwards encoded trace events to a
+// pw::multisink::MultiSink, so they can be streamed by one or more drains.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_multisink/multisink.h"
+#include "pw_status/status.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/trace_callback.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+
+// Registers as a trace sink and writes each encoded trace event to the
+// MultiSink as one entry. Events larger than
+// PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES are counted as dropped in the MultiSink.
+class MultiSinkTraceSink {
+ public:
+  constexpr MultiSinkTraceSink(multisink::MultiSink& multisink)
+      : multisink_(multisink),
+        handle_(0),
+        registered_(false),
+        block_size_(0),
+        block_idx_(0),
+        current_block_{} {}
+
+  MultiSinkTraceSink(const MultiSinkTraceSink&) = delete;
+  MultiSinkTraceSink& operator=(const MultiSinkTraceSink&) = delete;
+
+  ~MultiSinkTraceSink() { Unregister().IgnoreError(); }
+
+  // Starts forwarding trace events to the MultiSink.
+  //
+  // Returns:
+  // OK - the sink was registered.
+  // ALREADY_EXISTS - the sink is already registered.
+  // RESOURCE_EXHAUSTED - PW_TRACE_CONFIG_MAX_SINKS sinks are registered.
+  Status Register();
+
+  // Stops forwarding trace events. Does nothing if the sink is not registered.
+  Status Unregister();
+
+ private:
+  static void StartBlock(void* user_data, size_t size);
+  static void AddBytes(void* user_data, const void* bytes, size_t size);
+  static void EndBlock(void* user_data);
+
+  multisink::MultiSink& multisink_;
+  CallbacksImpl::SinkHandle handle_;
+  bool registered_;
+
+  // Trace sinks are called with the trace lock held, so the block being
+  // assembled does not need its own lock.
+  size_t block_size_;
+  size_t block_idx_;
+  std::byte current_block_[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
+};
+
+}  // namespace trace
+}  // namespace pw
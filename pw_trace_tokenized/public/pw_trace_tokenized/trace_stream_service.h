@@ -0,0 +1,112 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides an RPC service which streams trace events to a client as
+// they are recorded, rather than dumping the trace buffer in bulk.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_multisink/multisink.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_trace_protos/trace_rpc.pwpb.h"
+#include "pw_trace_protos/trace_rpc.raw_rpc.pb.h"
+
+namespace pw {
+namespace trace {
+
+// TraceStreamDrain reads encoded trace events from a MultiSink, such as one fed
+// by a MultiSinkTraceSink, and sends them over an RPC stream. Each Flush()
+// packs as many events as fit in the encoding buffer into a TraceEntries
+// message, and repeats until the MultiSink is empty.
+//
+// Events are only removed from the MultiSink once they are packed, so a drain
+// that stops flushing applies backpressure: the MultiSink keeps the unsent
+// events until it overwrites them. Events that are lost, because the drain fell
+// behind, an event was too large, or a write failed, are counted and reported
+// in the next message's drop_count.
+//
+// Flush() must be called regularly, for example from a thread woken by a
+// MultiSink::Listener or a timer; the flush period bounds the streaming
+// latency.
+class TraceStreamDrain : public multisink::MultiSink::Drain {
+ public:
+  // The encoding buffer overhead for a message with a single entry.
+  static constexpr size_t kMaxMessageOverheadBytes =
+      protobuf::SizeOfDelimitedFieldWithoutValue(
+          TraceEntries::Fields::ENTRIES) +
+      protobuf::SizeOfFieldUint32(TraceEntries::Fields::DROP_COUNT);
+
+  // The entry buffer must fit the largest encoded trace event; larger events
+  // are dropped.
+  TraceStreamDrain(ByteSpan entry_buffer)
+      : entry_buffer_(entry_buffer), drop_count_(0) {}
+
+  TraceStreamDrain(const TraceStreamDrain&) = delete;
+  TraceStreamDrain& operator=(const TraceStreamDrain&) = delete;
+
+  // Starts streaming to the writer.
+  //
+  // Returns:
+  // OK - the stream is open.
+  // FAILED_PRECONDITION - the writer is not active.
+  // ALREADY_EXISTS - a stream is already open.
+  Status Open(rpc::RawServerWriter& writer) PW_LOCKS_EXCLUDED(mutex_);
+
+  // Finishes the open stream, if any.
+  Status Close() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Sends all available trace events.
+  //
+  // Precondition: the drain must be attached to a MultiSink.
+  //
+  // Returns:
+  // OK - all available events were sent.
+  // FAILED_PRECONDITION - no stream is open.
+  // Any other status - the writer failed. Unsent events remain in the
+  //     MultiSink.
+  Status Flush(ByteSpan encoding_buffer) PW_LOCKS_EXCLUDED(mutex_);
+
+  // The number of dropped events not yet reported to the client.
+  uint32_t pending_drop_count() PW_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  sync::Mutex mutex_;
+  rpc::RawServerWriter writer_ PW_GUARDED_BY(mutex_);
+  const ByteSpan entry_buffer_;
+  uint32_t drop_count_ PW_GUARDED_BY(mutex_);
+};
+
+// Opens a TraceStreamDrain for clients that call Listen. The drain supports one
+// stream at a time.
+class TraceStreamService final
+    : public pw_rpc::raw::TraceStreamService::Service<TraceStreamService> {
+ public:
+  TraceStreamService(TraceStreamDrain& drain) : drain_(drain) {}
+
+  void Listen(ConstByteSpan request, rpc::RawServerWriter& writer);
+
+ private:
+  TraceStreamDrain& drain_;
+};
+
+}  // namespace trace
+}  // namespace pw
@@ -28,6 +28,13 @@
 #endif  // __cplusplus
 #endif  // PW_TRACE_GET_TIME_DELTA
 
+#ifdef __cplusplus
+#include <atomic>
+#include <span>
+
+#include "pw_ring_buffer/lock_free_prefixed_entry_ring_buffer.h"
+#endif  // __cplusplus
+
 #include "pw_status/status.h"
 #include "pw_tokenizer/tokenize.h"
 #include "pw_trace_tokenized/config.h"
@@ -134,14 +141,85 @@ class TokenizedTraceImpl {
                         const void* data_buffer,
                         size_t data_size);
 
+  // Returns the index of the context buffer for the code that is currently
+  // running, or a negative value if its events are handled directly.
+  using CurrentContextFunction = int (*)();
+
+  // Sets one buffer per execution context that traces without taking the trace
+  // lock, such as each core or each interrupt priority level. Events traced
+  // from context i are timestamped and pushed to buffers[i] without a lock;
+  // they are handled when MergeContextBuffers() is called, or when a thread
+  // next handles an event. Since a context buffer has a single producer, code
+  // that can preempt a context must not share its buffer.
+  //
+  // Must not be called while events are being traced. Pass an empty span to
+  // stop capturing events into context buffers.
+  void SetContextBuffers(
+      std::span<ring_buffer::LockFreePrefixedEntryRingBuffer> buffers,
+      CurrentContextFunction current_context) {
+    context_buffers_ = buffers;
+    current_context_ = current_context;
+  }
+
+  // Handles the events in the context buffers, oldest first across all of the
+  // buffers. Takes the trace lock, so must be called from a thread, for example
+  // periodically from a low-priority thread. Returns the number of events
+  // handled.
+  size_t MergeContextBuffers();
+
+  // The number of events dropped because their context buffer was full or
+  // their data was larger than PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES.
+  uint32_t context_events_dropped() const {
+    return context_events_dropped_.load(std::memory_order_relaxed);
+  }
+
  private:
   using TraceQueue = internal::TraceQueue<PW_TRACE_QUEUE_SIZE_EVENTS>;
+
+  // The start of each entry in a context buffer. The event's data follows.
+  struct ContextEventHeader {
+    PW_TRACE_TIME_TYPE trace_time;
+    uint32_t trace_token;
+    uint32_t trace_id;
+    const char* module;
+    EventType event_type;
+    uint8_t flags;
+  };
+
   PW_TRACE_TIME_TYPE last_trace_time_ = 0;
   bool enabled_ = false;
   TraceQueue event_queue_;
+  std::span<ring_buffer::LockFreePrefixedEntryRingBuffer> context_buffers_;
+  CurrentContextFunction current_context_ = nullptr;
+  std::atomic<uint32_t> context_events_dropped_ = 0;
 
   void HandleNextItemInQueue(
       const volatile TraceQueue::QueueEventBlock* event_block);
+
+  // Pushes an event to the current context's buffer. Returns false if the
+  // current context does not have a buffer.
+  bool CaptureContextEvent(uint32_t trace_token,
+                           EventType event_type,
+                           const char* module,
+                           uint32_t trace_id,
+                           uint8_t flags,
+                           const void* data_buffer,
+                           size_t data_size);
+
+  // Handles the events in the context buffers. Must be called with the trace
+  // lock held.
+  size_t HandleContextEvents();
+
+  // Calls the event callbacks, then encodes the event and sends it to the
+  // sinks. Must be called with the trace lock held.
+  void HandleEvent(PW_TRACE_TIME_TYPE trace_time,
+                   uint32_t trace_token,
+                   EventType event_type,
+                   const char* module,
+                   uint32_t trace_id,
+                   uint8_t flags,
+                   const std::byte* data_buffer,
+                   size_t data_size);
 };
 
 // A singleton object of the TokenizedTraceImpl class which can be used to
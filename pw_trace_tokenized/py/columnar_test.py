@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the columnar trace capture format."""
+
+import unittest
+
+from pw_trace_tokenized import columnar
+
+# Matches kRawTrace and kCapture in trace_columns_test.cc.
+RAW_TRACE = bytes([
+    6, 0x44, 0x33, 0x22, 0x11, 0x05, 0xAA,
+    6, 0x04, 0x03, 0x02, 0x01, 0x80, 0x01,
+    5, 0x0D, 0x0C, 0x0B, 0x0A, 0x00,
+])  # yapf: disable
+
+CAPTURE = b'PWTC' + bytes([
+    1, 0xE8, 0x07, 3,
+    0x44, 0x33, 0x22, 0x11,
+    0x04, 0x03, 0x02, 0x01,
+    0x0D, 0x0C, 0x0B, 0x0A,
+    4, 0x05, 0x80, 0x01, 0x00,
+    3, 1, 0, 0,
+    1, 0xAA,
+])  # yapf: disable
+
+EVENTS = [
+    columnar.RawEvent(0x11223344, 5, b'\xaa'),
+    columnar.RawEvent(0x01020304, 133, b''),
+    columnar.RawEvent(0x0A0B0C0D, 133, b''),
+]
+
+
+class TestColumnarCapture(unittest.TestCase):
+    """Tests converting between binary traces and columnar captures."""
+    def test_iter_raw_events(self):
+        self.assertEqual(EVENTS, list(columnar.iter_raw_events(RAW_TRACE)))
+
+    def test_iter_raw_events_stops_at_truncated_event(self):
+        self.assertEqual(EVENTS[:2],
+                         list(columnar.iter_raw_events(RAW_TRACE[:-1])))
+
+    def test_encode(self):
+        self.assertEqual(CAPTURE, columnar.encode_capture(EVENTS, 1000))
+
+    def test_decode(self):
+        capture = columnar.Capture(CAPTURE)
+        self.assertEqual(1000, capture.ticks_per_second)
+        self.assertEqual(3, len(capture))
+        self.assertEqual([event.token for event in EVENTS],
+                         list(capture.tokens))
+        self.assertEqual(EVENTS, list(capture))
+
+    def test_decode_empty(self):
+        capture = columnar.Capture(columnar.encode_capture([], 1000))
+        self.assertEqual(0, len(capture))
+        self.assertEqual([], list(capture))
+
+    def test_decode_invalid(self):
+        with self.assertRaises(ValueError):
+            columnar.Capture(RAW_TRACE)
+        with self.assertRaises(ValueError):
+            columnar.Capture(b'PWTC\x02' + CAPTURE[5:])
+        with self.assertRaises(ValueError):
+            columnar.Capture(CAPTURE[:-1])
+
+
+if __name__ == '__main__':
+    unittest.main()
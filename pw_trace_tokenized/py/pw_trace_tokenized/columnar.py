@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""
+Converts binary trace files to the columnar capture format.
+
+The columnar format stores the tokens, time deltas, and payloads of the events
+in separate columns. It is smaller than the raw trace once compressed, and its
+tokens and timestamps can be read without parsing every event. The layout is
+described in pw_trace_tokenized/trace_columns.h, which has a C++ reader.
+
+Example usage:
+python -m pw_trace_tokenized.columnar -i trace.bin -o trace.pwtc -t 1000
+"""
+
+import argparse
+import array
+import logging
+import sys
+from typing import Iterator, List, NamedTuple
+
+_LOG = logging.getLogger('pw_trace_tokenizer')
+
+MAGIC = b'PWTC'
+VERSION = 1
+
+_TOKEN_SIZE = 4
+
+
+class RawEvent(NamedTuple):
+    token: int
+    # The sum of the time deltas up to and including this event, in ticks.
+    timestamp: int
+    # The trace ID, if the event has one, followed by the event's data.
+    payload: bytes
+
+
+def _encode_varint(value: int) -> bytes:
+    encoded = bytearray()
+    while value >= 0x80:
+        encoded.append((value & 0x7f) | 0x80)
+        value >>= 7
+    encoded.append(value)
+    return bytes(encoded)
+
+
+def _decode_varint(data: bytes, idx: int):
+    """Returns the varint at idx and the index after it."""
+    value = 0
+    shift = 0
+    while idx < len(data) and shift < 64:
+        byte = data[idx]
+        idx += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, idx
+        shift += 7
+    raise ValueError('truncated varint')
+
+
+def iter_raw_events(raw_trace_data: bytes) -> Iterator[RawEvent]:
+    """Yields the events in a binary trace of size-prefixed events."""
+    timestamp = 0
+    idx = 0
+    while idx < len(raw_trace_data):
+        size = raw_trace_data[idx]
+        if size <= _TOKEN_SIZE or idx + 1 + size > len(raw_trace_data):
+            _LOG.error("incomplete file")
+            return
+
+        block = raw_trace_data[idx + 1:idx + 1 + size]
+        idx += 1 + size
+        token = int.from_bytes(block[:_TOKEN_SIZE], 'little')
+        try:
+            delta, payload_idx = _decode_varint(block, _TOKEN_SIZE)
+        except ValueError:
+            _LOG.error("invalid time delta")
+            return
+        timestamp += delta
+        yield RawEvent(token, timestamp, block[payload_idx:])
+
+
+def encode_capture(events: List[RawEvent], ticks_per_second: int) -> bytes:
+    """Encodes events as a columnar capture."""
+    tokens = array.array('I', (event.token for event in events))
+    if sys.byteorder != 'little':
+        tokens.byteswap()
+
+    deltas = bytearray()
+    payload_sizes = bytearray()
+    last_timestamp = 0
+    for event in events:
+        deltas += _encode_varint(event.timestamp - last_timestamp)
+        payload_sizes += _encode_varint(len(event.payload))
+        last_timestamp = event.timestamp
+    payloads = b''.join(event.payload for event in events)
+
+    return b''.join([
+        MAGIC,
+        bytes([VERSION]),
+        _encode_varint(ticks_per_second),
+        _encode_varint(len(events)),
+        tokens.tobytes(),
+        _encode_varint(len(deltas)),
+        deltas,
+        _encode_varint(len(payload_sizes)),
+        payload_sizes,
+        _encode_varint(len(payloads)),
+        payloads,
+    ])
+
+
+def is_capture(data: bytes) -> bool:
+    return data.startswith(MAGIC)
+
+
+class Capture:
+    """A columnar trace capture.
+
+    The tokens are read eagerly, since they are used to filter and look up
+    events. Timestamps and payloads are decoded as the events are iterated.
+    """
+    def __init__(self, data: bytes):
+        if not is_capture(data):
+            raise ValueError('not a columnar trace capture')
+        if len(data) <= len(MAGIC) or data[len(MAGIC)] != VERSION:
+            raise ValueError('unsupported columnar trace version')
+
+        idx = len(MAGIC) + 1
+        self.ticks_per_second, idx = _decode_varint(data, idx)
+        event_count, idx = _decode_varint(data, idx)
+
+        tokens_end = idx + event_count * _TOKEN_SIZE
+        if tokens_end > len(data):
+            raise ValueError('truncated token column')
+        self.tokens = array.array('I', data[idx:tokens_end])
+        if sys.byteorder != 'little':
+            self.tokens.byteswap()
+        idx = tokens_end
+
+        self._deltas, idx = self._column(data, idx)
+        self._payload_sizes, idx = self._column(data, idx)
+        self._payloads, idx = self._column(data, idx)
+        if idx != len(data):
+            raise ValueError('unexpected data after the payload column')
+
+    @staticmethod
+    def _column(data: bytes, idx: int):
+        size, idx = _decode_varint(data, idx)
+        if idx + size > len(data):
+            raise ValueError('truncated column')
+        return memoryview(data)[idx:idx + size], idx + size
+
+    def __len__(self) -> int:
+        return len(self.tokens)
+
+    def __iter__(self) -> Iterator[RawEvent]:
+        timestamp = 0
+        delta_idx = 0
+        size_idx = 0
+        payload_idx = 0
+        for token in self.tokens:
+            delta, delta_idx = _decode_varint(self._deltas, delta_idx)
+            size, size_idx = _decode_varint(self._payload_sizes, size_idx)
+            timestamp += delta
+            payload = bytes(self._payloads[payload_idx:payload_idx + size])
+            if len(payload) != size:
+                raise ValueError('truncated payload column')
+            payload_idx += size
+            yield RawEvent(token, timestamp, payload)
+
+
+def _parse_args():
+    """Parse and return command line arguments."""
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        '-i',
+        '--input',
+        dest='input_file',
+        required=True,
+        help='The binary trace input file, generated using trace_to_file.h.')
+    parser.add_argument('-o',
+                        '--output',
+                        dest='output_file',
+                        required=True,
+                        help='The columnar capture to write.')
+    parser.add_argument(
+        '-t',
+        '--ticks_per_second',
+        type=int,
+        dest='ticks_per_second',
+        default=1000,
+        help=('The clock rate of the trace events (Default 1000).'))
+    return parser.parse_args()
+
+
+def _main(args):
+    with open(args.input_file, 'rb') as input_file:
+        events = list(iter_raw_events(input_file.read()))
+    with open(args.output_file, 'wb') as output_file:
+        output_file.write(encode_capture(events, args.ticks_per_second))
+
+
+if __name__ == '__main__':
+    _main(_parse_args())
@@ -13,12 +13,14 @@
 # License for the specific language governing permissions and limitations under
 # the License.
 """
-Generates json trace files viewable using chrome://tracing from binary
-trace files.
+Generates json trace files viewable using chrome://tracing, or Perfetto traces
+viewable using ui.perfetto.dev, from binary trace files or columnar captures.
 
 Example usage:
 python pw_trace_tokenized/py/trace_tokenized.py -i trace.bin -o trace.json
 out/pw_strict_host_clang_debug/obj/pw_trace_tokenized/bin/trace_tokenized_example_basic
+python pw_trace_tokenized/py/trace_tokenized.py -i trace.pwtc -o trace.pftrace
+--format perfetto out/pw_strict_host_clang_debug/obj/pw_trace_tokenized/bin/trace_tokenized_example_basic
 """  # pylint: disable=line-too-long
 # pylint: enable=line-too-long
 
@@ -27,8 +29,10 @@ import argparse
 import logging
 import struct
 import sys
+from typing import Iterable, Iterator
 from pw_tokenizer import database, tokens
-from pw_trace import trace
+from pw_trace import perfetto, trace
+from pw_trace_tokenized import columnar
 
 _LOG = logging.getLogger('pw_trace_tokenizer')
 
@@ -108,63 +112,65 @@ def create_trace_event(token_string, timestamp_us, trace_id, data):
                             data=data if has_data(token_string) else b'')
 
 
-def parse_trace_event(buffer, db, last_time, ticks_per_second):
-    """Parse a single trace event from bytes"""
-    us_per_tick = 1000000 / ticks_per_second
-    idx = 0
-    # Read token
-    token = struct.unpack('I', buffer[idx:idx + 4])[0]
-    idx += 4
-
-    # Decode token
+def decode_trace_event(db, token, timestamp_us, payload):
+    """Decodes a trace event from its token, timestamp, and payload."""
     if len(db.token_to_entries[token]) == 0:
         _LOG.error("token not found: %08x", token)
         return None
 
     token_string = str(db.token_to_entries[token][0])
-
-    # Read time
-    time_delta, time_bytes = varint_decode(buffer[idx:])
-    timestamp_us = last_time + us_per_tick * time_delta
-    idx += time_bytes
+    idx = 0
 
     # Trace ID
     trace_id = None
-    if has_trace_id(token_string) and idx < len(buffer):
-        trace_id, trace_id_bytes = varint_decode(buffer[idx:])
+    if has_trace_id(token_string) and idx < len(payload):
+        trace_id, trace_id_bytes = varint_decode(payload[idx:])
         idx += trace_id_bytes
 
     # Data
     data = None
-    if has_data(token_string) and idx < len(buffer):
-        data = buffer[idx:]
+    if has_data(token_string) and idx < len(payload):
+        data = payload[idx:]
 
     # Create trace event
     return create_trace_event(token_string, timestamp_us, trace_id, data)
 
 
-def get_trace_events(databases, raw_trace_data, ticks_per_second):
-    """Handles the decoding traces."""
-
-    db = tokens.Database.merged(*databases)
-    last_timestamp = 0
-    events = []
+def parse_trace_event(buffer, db, last_time, ticks_per_second):
+    """Parse a single trace event from bytes"""
+    us_per_tick = 1000000 / ticks_per_second
     idx = 0
+    # Read token
+    token = struct.unpack('I', buffer[idx:idx + 4])[0]
+    idx += 4
+
+    # Read time
+    time_delta, time_bytes = varint_decode(buffer[idx:])
+    timestamp_us = last_time + us_per_tick * time_delta
+    idx += time_bytes
 
-    while idx + 1 < len(raw_trace_data):
-        # Read size
-        size = int(raw_trace_data[idx])
-        if idx + size > len(raw_trace_data):
-            _LOG.error("incomplete file")
-            break
+    return decode_trace_event(db, token, timestamp_us, buffer[idx:])
 
-        event = parse_trace_event(raw_trace_data[idx + 1:idx + 1 + size], db,
-                                  last_timestamp, ticks_per_second)
+
+def iter_trace_events(databases, raw_events: Iterable[columnar.RawEvent],
+                      ticks_per_second) -> Iterator[trace.TraceEvent]:
+    """Decodes events from a binary trace or columnar capture as they are
+    read, so they can be written without holding the whole trace in memory."""
+    db = tokens.Database.merged(*databases)
+    us_per_tick = 1000000 / ticks_per_second
+    for raw_event in raw_events:
+        event = decode_trace_event(db, raw_event.token,
+                                   us_per_tick * raw_event.timestamp,
+                                   raw_event.payload)
         if event:
-            last_timestamp = event.timestamp_us
-            events.append(event)
-        idx = idx + size + 1
-    return events
+            yield event
+
+
+def get_trace_events(databases, raw_trace_data, ticks_per_second):
+    """Handles the decoding traces."""
+    return list(
+        iter_trace_events(databases, columnar.iter_raw_events(raw_trace_data),
+                          ticks_per_second))
 
 
 def get_trace_data_from_file(input_file_name):
@@ -184,9 +190,18 @@ def save_trace_file(trace_lines, file_name):
 
 
 def get_trace_events_from_file(databases, input_file_name, ticks_per_second):
-    """Get trace events from a file."""
+    """Get trace events from a binary trace file or columnar capture.
+
+    Columnar captures record their own clock rate, which overrides
+    ticks_per_second.
+    """
     raw_trace_data = get_trace_data_from_file(input_file_name)
-    return get_trace_events(databases, raw_trace_data, ticks_per_second)
+    if columnar.is_capture(raw_trace_data):
+        capture = columnar.Capture(raw_trace_data)
+        return iter_trace_events(databases, capture, capture.ticks_per_second)
+    return iter_trace_events(databases,
+                             columnar.iter_raw_events(raw_trace_data),
+                             ticks_per_second)
 
 
 def _parse_args():
@@ -204,11 +219,18 @@ def _parse_args():
         '-i',
         '--input',
         dest='input_file',
-        help='The binary trace input file, generated using trace_to_file.h.')
+        help=('The binary trace input file, generated using trace_to_file.h, '
+              'or a columnar capture.'))
     parser.add_argument('-o',
                         '--output',
                         dest='output_file',
-                        help=('The json file to which to write the output.'))
+                        help=('The file to which to write the output.'))
+    parser.add_argument('-f',
+                        '--format',
+                        dest='output_format',
+                        choices=('json', 'perfetto'),
+                        default='json',
+                        help=('The output format (Default json).'))
     parser.add_argument(
         '-t',
         '--ticks_per_second',
@@ -223,6 +245,11 @@ def _parse_args():
 def _main(args):
     events = get_trace_events_from_file(args.databases, args.input_file,
                                         args.ticks_per_second)
+    if args.output_format == 'perfetto':
+        with open(args.output_file, 'wb') as output_file:
+            perfetto.write_perfetto_trace(events, output_file)
+        return
+
     json_lines = trace.generate_trace_json(events)
     save_trace_file(json_lines, args.output_file)
 
@@ -16,6 +16,8 @@
 
 #include "pw_trace/trace.h"
 
+#include <cstring>
+
 #include "pw_preprocessor/util.h"
 #include "pw_trace_tokenized/trace_callback.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
@@ -34,9 +36,53 @@ void TokenizedTraceImpl::HandleTraceEvent(uint32_t trace_token,
                                           uint8_t flags,
                                           const void* data_buffer,
                                           size_t data_size) {
-  // Early exit if disabled and no callbacks are register to receive events
-  // while disabled.
-  if (!enabled_ && Callbacks::Instance().GetCalledOnEveryEventCount() == 0) {
+  const CallbacksImpl& callbacks = Callbacks::Instance();
+
+  // Early exit if disabled and no callbacks or filters are register to receive
+  // events while disabled.
+  if (!enabled_ && callbacks.GetCalledOnEveryEventCount() == 0 &&
+      callbacks.GetCalledOnEveryEventFilterCount() == 0) {
+    return;
+  }
+
+  // Early exit if there is nothing registered to receive the event.
+  if (callbacks.GetEventCallbackCount() == 0 &&
+      callbacks.GetEventFilterCount() == 0 && callbacks.GetSinkCount() == 0) {
+    return;
+  }
+
+  // Events from contexts with their own buffer, such as interrupt handlers, are
+  // captured without a lock and handled later.
+  if (CaptureContextEvent(trace_token,
+                          event_type,
+                          module,
+                          trace_id,
+                          flags,
+                          data_buffer,
+                          data_size)) {
+    return;
+  }
+
+  // If no other events are waiting and the trace lock is free, handle the event
+  // directly rather than copying it into and back out of the queue.
+  if (data_size <= PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES &&
+      event_queue_.IsEmpty() && PW_TRACE_TRY_LOCK()) {
+    // Captured events are older than this one, so handle them first.
+    HandleContextEvents();
+    HandleEvent(PW_TRACE_GET_TIME(),
+                trace_token,
+                event_type,
+                module,
+                trace_id,
+                flags,
+                static_cast<const std::byte*>(data_buffer),
+                data_size);
+    // Handle any events queued by other tasks in the meantime.
+    while (!event_queue_.IsEmpty()) {
+      HandleNextItemInQueue(event_queue_.PeekFront());
+      event_queue_.PopFront();
+    }
+    PW_TRACE_UNLOCK();
     return;
   }
 
@@ -60,6 +106,7 @@ void TokenizedTraceImpl::HandleTraceEvent(uint32_t trace_token,
   // Sample is now in queue (if not dropped), try to empty the queue if not
   // already being emptied.
   if (PW_TRACE_TRY_LOCK()) {
+    HandleContextEvents();
     while (!event_queue_.IsEmpty()) {
       HandleNextItemInQueue(event_queue_.PeekFront());
       event_queue_.PopFront();
@@ -70,76 +117,204 @@ void TokenizedTraceImpl::HandleTraceEvent(uint32_t trace_token,
 
 void TokenizedTraceImpl::HandleNextItemInQueue(
     const volatile TraceQueue::QueueEventBlock* event_block) {
-  // Get next item in queue
-  uint32_t trace_token = event_block->trace_token;
-  EventType event_type = event_block->event_type;
-  const char* module = event_block->module;
-  uint32_t trace_id = event_block->trace_id;
-  uint8_t flags = event_block->flags;
-  const std::byte* data_buffer =
-      const_cast<const std::byte*>(event_block->data_buffer);
-  size_t data_size = event_block->data_size;
-
-  // Call any event callback which is registered to receive every event.
+  HandleEvent(PW_TRACE_GET_TIME(),
+              event_block->trace_token,
+              event_block->event_type,
+              event_block->module,
+              event_block->trace_id,
+              event_block->flags,
+              const_cast<const std::byte*>(event_block->data_buffer),
+              event_block->data_size);
+}
+
+bool TokenizedTraceImpl::CaptureContextEvent(uint32_t trace_token,
+                                             EventType event_type,
+                                             const char* module,
+                                             uint32_t trace_id,
+                                             uint8_t flags,
+                                             const void* data_buffer,
+                                             size_t data_size) {
+  if (context_buffers_.empty()) {
+    return false;
+  }
+  const int context = current_context_();
+  if (context < 0 || static_cast<size_t>(context) >= context_buffers_.size()) {
+    return false;
+  }
+
+  if (data_size > PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES) {
+    context_events_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  const ContextEventHeader header = {
+      .trace_time = PW_TRACE_GET_TIME(),
+      .trace_token = trace_token,
+      .trace_id = trace_id,
+      .module = module,
+      .event_type = event_type,
+      .flags = flags,
+  };
+  std::byte entry[sizeof(header) + PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES];
+  std::memcpy(entry, &header, sizeof(header));
+  if (data_size != 0) {
+    std::memcpy(&entry[sizeof(header)], data_buffer, data_size);
+  }
+
+  if (!context_buffers_[context]
+           .TryPushBack(std::span(entry, sizeof(header) + data_size))
+           .ok()) {
+    context_events_dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+size_t TokenizedTraceImpl::MergeContextBuffers() {
+  PW_TRACE_LOCK();
+  const size_t handled = HandleContextEvents();
+  PW_TRACE_UNLOCK();
+  return handled;
+}
+
+size_t TokenizedTraceImpl::HandleContextEvents() {
+  std::byte entry[sizeof(ContextEventHeader) +
+                  PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES];
+  ContextEventHeader header;
+  size_t handled = 0;
+
+  while (true) {
+    // Find the oldest event at the front of the buffers. Every captured event
+    // is newer than the last handled event, since threads handle the captured
+    // events before their own, so measuring from the last trace time orders the
+    // events correctly even if the trace time wraps.
+    ring_buffer::LockFreePrefixedEntryRingBuffer* oldest = nullptr;
+    PW_TRACE_TIME_TYPE oldest_age = 0;
+
+    for (ring_buffer::LockFreePrefixedEntryRingBuffer& buffer :
+         context_buffers_) {
+      size_t bytes_read;
+      const Status status = buffer.PeekFront(
+          std::as_writable_bytes(std::span(&header, 1)), &bytes_read);
+      if (!status.ok() && !status.IsResourceExhausted()) {
+        continue;  // The buffer is empty.
+      }
+      const PW_TRACE_TIME_TYPE age =
+          PW_TRACE_GET_TIME_DELTA(last_trace_time_, header.trace_time);
+      if (oldest == nullptr || age < oldest_age) {
+        oldest = &buffer;
+        oldest_age = age;
+      }
+    }
+
+    if (oldest == nullptr) {
+      return handled;
+    }
+
+    size_t entry_size;
+    oldest->PeekFront(entry, &entry_size).IgnoreError();
+    std::memcpy(&header, entry, sizeof(header));
+    HandleEvent(header.trace_time,
+                header.trace_token,
+                header.event_type,
+                header.module,
+                header.trace_id,
+                header.flags,
+                &entry[sizeof(header)],
+                entry_size - sizeof(header));
+    oldest->PopFront().IgnoreError();
+    handled += 1;
+  }
+}
+
+void TokenizedTraceImpl::HandleEvent(PW_TRACE_TIME_TYPE trace_time,
+                                     uint32_t trace_token,
+                                     EventType event_type,
+                                     const char* module,
+                                     uint32_t trace_id,
+                                     uint8_t flags,
+                                     const std::byte* data_buffer,
+                                     size_t data_size) {
+  CallbacksImpl& callbacks = Callbacks::Instance();
+
+  // Apply any filter and call any event callback which is registered to
+  // receive every event.
   pw_trace_TraceEventReturnFlags ret_flags = 0;
-  ret_flags |=
-      Callbacks::Instance().CallEventCallbacks(CallbacksImpl::kCallOnEveryEvent,
-                                               trace_token,
-                                               event_type,
-                                               module,
-                                               trace_id,
-                                               flags);
+  if (callbacks.GetCalledOnEveryEventFilterCount() != 0) {
+    ret_flags |= callbacks.ApplyEventFilters(
+        CallbacksImpl::kCallOnEveryEvent, trace_token, trace_id);
+  }
+  if (callbacks.GetCalledOnEveryEventCount() != 0) {
+    ret_flags |=
+        callbacks.CallEventCallbacks(CallbacksImpl::kCallOnEveryEvent,
+                                     trace_token,
+                                     event_type,
+                                     module,
+                                     trace_id,
+                                     flags);
+  }
+  // Enable before processing if a filter or callback had set the flag.
+  if (PW_TRACE_EVENT_RETURN_FLAGS_ENABLE_BEFORE_PROCESSING & ret_flags) {
+    enabled_ = true;
+  }
   // Return if disabled.
   if ((PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) || !enabled_) {
     return;
   }
 
-  // Call any event callback not already called.
-  ret_flags |= Callbacks::Instance().CallEventCallbacks(
-      CallbacksImpl::kCallOnlyWhenEnabled,
-      trace_token,
-      event_type,
-      module,
-      trace_id,
-      flags);
+  // Apply any filter and call any event callback not already called.
+  if (callbacks.GetEventFilterCount() >
+      callbacks.GetCalledOnEveryEventFilterCount()) {
+    ret_flags |= callbacks.ApplyEventFilters(
+        CallbacksImpl::kCallOnlyWhenEnabled, trace_token, trace_id);
+  }
+  if (callbacks.GetEventCallbackCount() >
+      callbacks.GetCalledOnEveryEventCount()) {
+    ret_flags |=
+        callbacks.CallEventCallbacks(CallbacksImpl::kCallOnlyWhenEnabled,
+                                     trace_token,
+                                     event_type,
+                                     module,
+                                     trace_id,
+                                     flags);
+  }
   // Return if disabled (from a callback) or if a callback has indicated the
   // sample should be skipped.
   if ((PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) || !enabled_) {
     return;
   }
 
-  // Create header to store trace info
-  static constexpr size_t kMaxHeaderSize =
-      sizeof(trace_token) + pw::varint::kMaxVarint64SizeBytes +  // time
-      pw::varint::kMaxVarint64SizeBytes;                         // trace_id
-  std::byte header[kMaxHeaderSize];
-  memcpy(header, &trace_token, sizeof(trace_token));
-  size_t header_size = sizeof(trace_token);
-
-  // Compute delta of time elapsed since last trace entry.
-  PW_TRACE_TIME_TYPE trace_time = pw_trace_GetTraceTime();
-  PW_TRACE_TIME_TYPE delta =
-      (last_trace_time_ == 0)
-          ? 0
-          : PW_TRACE_GET_TIME_DELTA(last_trace_time_, trace_time);
-  header_size += pw::varint::Encode(
-      delta,
-      std::span<std::byte>(&header[header_size], kMaxHeaderSize - header_size));
-  last_trace_time_ = trace_time;
-
-  // Calculate packet id if needed.
-  if (PW_TRACE_HAS_TRACE_ID(event_type)) {
-    header_size +=
-        pw::varint::Encode(trace_id,
-                           std::span<std::byte>(&header[header_size],
-                                                kMaxHeaderSize - header_size));
-  }
-
-  // Send encoded output to any registered trace sinks.
-  Callbacks::Instance().CallSinks(
-      std::span<const std::byte>(header, header_size),
-      std::span<const std::byte>(
-          reinterpret_cast<const std::byte*>(data_buffer), data_size));
+  if (callbacks.GetSinkCount() != 0) {
+    // Create header to store trace info
+    static constexpr size_t kMaxHeaderSize =
+        sizeof(trace_token) + pw::varint::kMaxVarint64SizeBytes +  // time
+        pw::varint::kMaxVarint64SizeBytes;                         // trace_id
+    std::byte header[kMaxHeaderSize];
+    memcpy(header, &trace_token, sizeof(trace_token));
+    size_t header_size = sizeof(trace_token);
+
+    // Compute delta of time elapsed since last trace entry.
+    PW_TRACE_TIME_TYPE delta =
+        (last_trace_time_ == 0)
+            ? 0
+            : PW_TRACE_GET_TIME_DELTA(last_trace_time_, trace_time);
+    header_size += pw::varint::Encode(
+        delta,
+        std::span<std::byte>(&header[header_size],
+                             kMaxHeaderSize - header_size));
+    last_trace_time_ = trace_time;
+
+    // Calculate packet id if needed.
+    if (PW_TRACE_HAS_TRACE_ID(event_type)) {
+      header_size +=
+          pw::varint::Encode(trace_id,
+                             std::span<std::byte>(&header[header_size],
+                                                  kMaxHeaderSize - header_size));
+    }
+
+    // Send encoded output to any registered trace sinks.
+    callbacks.CallSinks(std::span<const std::byte>(header, header_size),
+                        std::span<const std::byte>(data_buffer, data_size));
+  }
   // Disable after processing if an event callback had set the flag.
   if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
     enabled_ = false;
@@ -204,6 +379,7 @@ pw::Status CallbacksImpl::RegisterSink(SinkStartBlock start_func,
       sink_callbacks_[sink_idx].add_bytes = add_bytes_func;
       sink_callbacks_[sink_idx].end_block = end_block_func;
       sink_callbacks_[sink_idx].user_data = user_data;
+      sink_count_ += 1;
       if (handle) {
         *handle = sink_idx;
       }
@@ -216,10 +392,13 @@ pw::Status CallbacksImpl::RegisterSink(SinkStartBlock start_func,
 }
 
 pw::Status CallbacksImpl::UnregisterSink(SinkHandle handle) {
-  PW_TRACE_LOCK();
   if (handle >= PW_TRACE_CONFIG_MAX_SINKS) {
     return PW_STATUS_INVALID_ARGUMENT;
   }
+  PW_TRACE_LOCK();
+  if (!IsSinkFree(handle)) {
+    sink_count_ -= 1;
+  }
   sink_callbacks_[handle].start_block = nullptr;
   sink_callbacks_[handle].add_bytes = nullptr;
   sink_callbacks_[handle].end_block = nullptr;
@@ -255,6 +434,7 @@ pw::Status CallbacksImpl::RegisterEventCallback(
       event_callbacks_[i].user_data = user_data;
       event_callbacks_[i].called_on_every_event = called_on_every_event;
       called_on_every_event_count_ += called_on_every_event ? 1 : 0;
+      event_callback_count_ += 1;
       if (handle) {
         *handle = i;
       }
@@ -267,14 +447,17 @@ pw::Status CallbacksImpl::RegisterEventCallback(
 }
 
 pw::Status CallbacksImpl::UnregisterEventCallback(EventCallbackHandle handle) {
-  PW_TRACE_LOCK();
   if (handle >= PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS) {
     return PW_STATUS_INVALID_ARGUMENT;
   }
+  PW_TRACE_LOCK();
+  if (event_callbacks_[handle].callback != nullptr) {
+    event_callback_count_ -= 1;
+    called_on_every_event_count_ -=
+        event_callbacks_[handle].called_on_every_event ? 1 : 0;
+  }
   event_callbacks_[handle].callback = nullptr;
   event_callbacks_[handle].user_data = nullptr;
-  called_on_every_event_count_ +=
-      event_callbacks_[handle].called_on_every_event ? 1 : 0;
   event_callbacks_[handle].called_on_every_event = kCallOnlyWhenEnabled;
   PW_TRACE_UNLOCK();
   return PW_STATUS_OK;
@@ -296,6 +479,94 @@ CallbacksImpl::EventCallbacks* CallbacksImpl::GetEventCallback(
   return &event_callbacks_[handle];
 }
 
+pw::Status CallbacksImpl::RegisterEventFilter(
+    uint32_t trace_ref,
+    bool match_trace_id,
+    uint32_t trace_id,
+    pw_trace_TraceEventReturnFlags flags,
+    CallOnEveryEvent called_on_every_event,
+    EventFilterHandle* handle) {
+  if (flags == PW_TRACE_EVENT_RETURN_FLAGS_NONE) {
+    return PW_STATUS_INVALID_ARGUMENT;
+  }
+  pw_Status status = PW_STATUS_RESOURCE_EXHAUSTED;
+  PW_TRACE_LOCK();
+  for (size_t i = 0; i < PW_TRACE_CONFIG_MAX_EVENT_FILTERS; i++) {
+    if (event_filters_[i].flags == PW_TRACE_EVENT_RETURN_FLAGS_NONE) {
+      event_filters_[i].trace_ref = trace_ref;
+      event_filters_[i].trace_id = trace_id;
+      event_filters_[i].match_trace_id = match_trace_id;
+      event_filters_[i].flags = flags;
+      event_filters_[i].called_on_every_event = called_on_every_event;
+      called_on_every_event_filter_count_ += called_on_every_event ? 1 : 0;
+      event_filter_count_ += 1;
+      RebuildEventFilterBitmaps();
+      if (handle) {
+        *handle = i;
+      }
+      status = PW_STATUS_OK;
+      break;
+    }
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+pw::Status CallbacksImpl::UnregisterEventFilter(EventFilterHandle handle) {
+  if (handle >= PW_TRACE_CONFIG_MAX_EVENT_FILTERS) {
+    return PW_STATUS_INVALID_ARGUMENT;
+  }
+  PW_TRACE_LOCK();
+  if (event_filters_[handle].flags != PW_TRACE_EVENT_RETURN_FLAGS_NONE) {
+    event_filter_count_ -= 1;
+    called_on_every_event_filter_count_ -=
+        event_filters_[handle].called_on_every_event ? 1 : 0;
+  }
+  event_filters_[handle] = {};
+  RebuildEventFilterBitmaps();
+  PW_TRACE_UNLOCK();
+  return PW_STATUS_OK;
+}
+
+pw::Status CallbacksImpl::UnregisterAllEventFilters() {
+  for (size_t i = 0; i < PW_TRACE_CONFIG_MAX_EVENT_FILTERS; i++) {
+    UnregisterEventFilter(i).IgnoreError();
+  }
+  return PW_STATUS_OK;
+}
+
+pw_trace_TraceEventReturnFlags CallbacksImpl::ApplyEventFilters(
+    CallOnEveryEvent called_on_every_event,
+    uint32_t trace_ref,
+    uint32_t trace_id) const {
+  const size_t bit = trace_ref % kFilterBitmapBits;
+  if ((filter_bitmaps_[called_on_every_event][bit / 32] &
+       (1u << (bit % 32))) == 0u) {
+    return PW_TRACE_EVENT_RETURN_FLAGS_NONE;
+  }
+
+  pw_trace_TraceEventReturnFlags ret_flags = PW_TRACE_EVENT_RETURN_FLAGS_NONE;
+  for (const EventFilter& filter : event_filters_) {
+    if (filter.trace_ref == trace_ref &&
+        filter.called_on_every_event == called_on_every_event &&
+        (!filter.match_trace_id || filter.trace_id == trace_id)) {
+      ret_flags |= filter.flags;
+    }
+  }
+  return ret_flags;
+}
+
+void CallbacksImpl::RebuildEventFilterBitmaps() {
+  std::memset(filter_bitmaps_, 0, sizeof(filter_bitmaps_));
+  for (const EventFilter& filter : event_filters_) {
+    if (filter.flags != PW_TRACE_EVENT_RETURN_FLAGS_NONE) {
+      const size_t bit = filter.trace_ref % kFilterBitmapBits;
+      filter_bitmaps_[filter.called_on_every_event][bit / 32] |=
+          1u << (bit % 32);
+    }
+  }
+}
+
 // C functions
 
 PW_EXTERN_C_START
@@ -349,6 +620,28 @@ pw_Status pw_trace_UnregisterEventCallback(
   return Callbacks::Instance().UnregisterEventCallback(handle).code();
 }
 
+pw_Status pw_trace_RegisterEventFilter(
+    uint32_t trace_ref,
+    bool match_trace_id,
+    uint32_t trace_id,
+    pw_trace_TraceEventReturnFlags flags,
+    pw_trace_ShouldCallOnEveryEvent called_on_every_event,
+    pw_trace_EventFilterHandle* handle) {
+  return Callbacks::Instance()
+      .RegisterEventFilter(
+          trace_ref,
+          match_trace_id,
+          trace_id,
+          flags,
+          static_cast<CallbacksImpl::CallOnEveryEvent>(called_on_every_event),
+          handle)
+      .code();
+}
+
+pw_Status pw_trace_UnregisterEventFilter(pw_trace_EventFilterHandle handle) {
+  return Callbacks::Instance().UnregisterEventFilter(handle).code();
+}
+
 PW_EXTERN_C_END
 
 }  // namespace trace
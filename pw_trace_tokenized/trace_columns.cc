@@ -0,0 +1,253 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/trace_columns.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "pw_bytes/endian.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace {
+
+constexpr size_t kTokenSizeBytes = sizeof(uint32_t);
+constexpr size_t kHeaderSizeBytes = sizeof(kColumnarTraceMagic) + 1;
+
+// Decodes a varint at offset and advances offset past it. Returns false if the
+// varint is truncated.
+bool ReadVarint(ConstByteSpan data, size_t& offset, uint64_t& value) {
+  const size_t bytes = varint::Decode(data.subspan(offset), &value);
+  offset += bytes;
+  return bytes != 0u;
+}
+
+// Reads a column prefixed with its length in bytes.
+bool ReadColumn(ConstByteSpan data, size_t& offset, ConstByteSpan& column) {
+  uint64_t length;
+  if (!ReadVarint(data, offset, length) || length > data.size() - offset) {
+    return false;
+  }
+  column = data.subspan(offset, static_cast<size_t>(length));
+  offset += column.size();
+  return true;
+}
+
+// Checks that a column holds exactly count varints, and returns their sum.
+bool CheckVarintColumn(ConstByteSpan column, size_t count, uint64_t& sum) {
+  size_t offset = 0;
+  sum = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t value;
+    if (!ReadVarint(column, offset, value)) {
+      return false;
+    }
+    sum += value;
+  }
+  return offset == column.size();
+}
+
+struct RawEvent {
+  uint32_t token;
+  uint64_t delta;
+  ConstByteSpan payload;
+};
+
+// Parses the size-prefixed event at offset and advances offset past it.
+bool ReadRawEvent(ConstByteSpan raw_trace, size_t& offset, RawEvent& event) {
+  const size_t size = static_cast<size_t>(raw_trace[offset]);
+  if (size < kTokenSizeBytes + 1 || size > raw_trace.size() - offset - 1) {
+    return false;
+  }
+  const ConstByteSpan block = raw_trace.subspan(offset + 1, size);
+  event.token = bytes::ReadInOrder<uint32_t>(std::endian::little, block.data());
+  const size_t delta_bytes =
+      varint::Decode(block.subspan(kTokenSizeBytes), &event.delta);
+  if (delta_bytes == 0u) {
+    return false;
+  }
+  event.payload = block.subspan(kTokenSizeBytes + delta_bytes);
+  offset += 1 + size;
+  return true;
+}
+
+struct ColumnSizes {
+  size_t event_count = 0;
+  size_t deltas = 0;
+  size_t payload_sizes = 0;
+  size_t payloads = 0;
+
+  size_t total(uint32_t ticks_per_second) const {
+    return kHeaderSizeBytes + varint::EncodedSize(ticks_per_second) +
+           varint::EncodedSize(event_count) + event_count * kTokenSizeBytes +
+           varint::EncodedSize(deltas) + deltas +
+           varint::EncodedSize(payload_sizes) + payload_sizes +
+           varint::EncodedSize(payloads) + payloads;
+  }
+};
+
+bool MeasureColumns(ConstByteSpan raw_trace, ColumnSizes& sizes) {
+  size_t offset = 0;
+  RawEvent event;
+  while (offset < raw_trace.size()) {
+    if (!ReadRawEvent(raw_trace, offset, event)) {
+      return false;
+    }
+    sizes.event_count += 1;
+    sizes.deltas += varint::EncodedSize(event.delta);
+    sizes.payload_sizes += varint::EncodedSize(event.payload.size());
+    sizes.payloads += event.payload.size();
+  }
+  return true;
+}
+
+}  // namespace
+
+ColumnarTraceReader::iterator::iterator(const ColumnarTraceReader& reader,
+                                        size_t index)
+    : reader_(&reader), index_(index), event_{} {
+  Read();
+}
+
+ColumnarTraceReader::iterator& ColumnarTraceReader::iterator::operator++() {
+  index_ += 1;
+  Read();
+  return *this;
+}
+
+void ColumnarTraceReader::iterator::Read() {
+  if (index_ >= reader_->event_count_) {
+    return;
+  }
+
+  // Create() checked every column, so these reads cannot fail.
+  event_.token = bytes::ReadInOrder<uint32_t>(
+      std::endian::little, &reader_->tokens_[index_ * kTokenSizeBytes]);
+
+  uint64_t delta;
+  ReadVarint(reader_->deltas_, delta_offset_, delta);
+  event_.timestamp += delta;
+
+  uint64_t payload_size;
+  ReadVarint(reader_->payload_sizes_, size_offset_, payload_size);
+  event_.payload = reader_->payloads_.subspan(
+      payload_offset_, static_cast<size_t>(payload_size));
+  payload_offset_ += event_.payload.size();
+}
+
+Result<ColumnarTraceReader> ColumnarTraceReader::Create(ConstByteSpan capture) {
+  if (capture.size() < kHeaderSizeBytes ||
+      std::memcmp(capture.data(),
+                  kColumnarTraceMagic,
+                  sizeof(kColumnarTraceMagic)) != 0) {
+    return Status::DataLoss();
+  }
+  if (static_cast<uint8_t>(capture[sizeof(kColumnarTraceMagic)]) !=
+      kColumnarTraceVersion) {
+    return Status::Unimplemented();
+  }
+
+  ColumnarTraceReader reader;
+  size_t offset = kHeaderSizeBytes;
+  uint64_t ticks_per_second;
+  uint64_t event_count;
+  if (!ReadVarint(capture, offset, ticks_per_second) ||
+      ticks_per_second > std::numeric_limits<uint32_t>::max() ||
+      !ReadVarint(capture, offset, event_count) ||
+      event_count > (capture.size() - offset) / kTokenSizeBytes) {
+    return Status::DataLoss();
+  }
+  reader.ticks_per_second_ = static_cast<uint32_t>(ticks_per_second);
+  reader.event_count_ = static_cast<size_t>(event_count);
+
+  reader.tokens_ =
+      capture.subspan(offset, reader.event_count_ * kTokenSizeBytes);
+  offset += reader.tokens_.size();
+
+  uint64_t unused_time;
+  uint64_t payload_bytes;
+  if (!ReadColumn(capture, offset, reader.deltas_) ||
+      !ReadColumn(capture, offset, reader.payload_sizes_) ||
+      !ReadColumn(capture, offset, reader.payloads_) ||
+      offset != capture.size() ||
+      !CheckVarintColumn(reader.deltas_, reader.event_count_, unused_time) ||
+      !CheckVarintColumn(
+          reader.payload_sizes_, reader.event_count_, payload_bytes) ||
+      payload_bytes != reader.payloads_.size()) {
+    return Status::DataLoss();
+  }
+  return reader;
+}
+
+Result<size_t> ColumnarTraceSize(ConstByteSpan raw_trace,
+                                 uint32_t ticks_per_second) {
+  ColumnSizes sizes;
+  if (!MeasureColumns(raw_trace, sizes)) {
+    return Status::DataLoss();
+  }
+  return sizes.total(ticks_per_second);
+}
+
+Result<size_t> WriteColumnarTrace(ConstByteSpan raw_trace,
+                                  uint32_t ticks_per_second,
+                                  ByteSpan capture) {
+  ColumnSizes sizes;
+  if (!MeasureColumns(raw_trace, sizes)) {
+    return Status::DataLoss();
+  }
+  const size_t total_size = sizes.total(ticks_per_second);
+  if (total_size > capture.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  // The column sizes are known, so each column is filled in a single pass over
+  // the raw trace.
+  std::byte* out = capture.data();
+  std::memcpy(out, kColumnarTraceMagic, sizeof(kColumnarTraceMagic));
+  out += sizeof(kColumnarTraceMagic);
+  *out++ = std::byte{kColumnarTraceVersion};
+  out += varint::internal::EncodeUnchecked(ticks_per_second, out);
+  out += varint::internal::EncodeUnchecked(sizes.event_count, out);
+
+  std::byte* tokens = out;
+  out += sizes.event_count * kTokenSizeBytes;
+  out += varint::internal::EncodeUnchecked(sizes.deltas, out);
+  std::byte* deltas = out;
+  out += sizes.deltas;
+  out += varint::internal::EncodeUnchecked(sizes.payload_sizes, out);
+  std::byte* payload_sizes = out;
+  out += sizes.payload_sizes;
+  out += varint::internal::EncodeUnchecked(sizes.payloads, out);
+  std::byte* payloads = out;
+
+  size_t offset = 0;
+  RawEvent event;
+  while (offset < raw_trace.size()) {
+    ReadRawEvent(raw_trace, offset, event);
+    const auto token = bytes::CopyInOrder(std::endian::little, event.token);
+    tokens = std::copy(token.begin(), token.end(), tokens);
+    deltas += varint::internal::EncodeUnchecked(event.delta, deltas);
+    payload_sizes +=
+        varint::internal::EncodeUnchecked(event.payload.size(), payload_sizes);
+    payloads = std::copy(event.payload.begin(), event.payload.end(), payloads);
+  }
+  return total_size;
+}
+
+}  // namespace trace
+}  // namespace pw
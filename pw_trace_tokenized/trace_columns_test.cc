@@ -0,0 +1,136 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/trace_columns.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::trace {
+namespace {
+
+// Three size-prefixed events: one with a payload, one with a two-byte time
+// delta, and one with neither.
+constexpr auto kRawTrace = bytes::Array<
+    // token 0x11223344, delta 5, payload 0xAA
+    6, 0x44, 0x33, 0x22, 0x11, 0x05, 0xAA,
+    // token 0x01020304, delta 128
+    6, 0x04, 0x03, 0x02, 0x01, 0x80, 0x01,
+    // token 0x0A0B0C0D, delta 0
+    5, 0x0D, 0x0C, 0x0B, 0x0A, 0x00>();
+
+constexpr auto kCapture = bytes::Concat(
+    bytes::String("PWTC"),
+    bytes::Array<kColumnarTraceVersion,
+                 0xE8, 0x07,  // 1000 ticks per second
+                 3,           // event count
+                 0x44, 0x33, 0x22, 0x11,
+                 0x04, 0x03, 0x02, 0x01,
+                 0x0D, 0x0C, 0x0B, 0x0A,
+                 4, 0x05, 0x80, 0x01, 0x00,  // deltas
+                 3, 1, 0, 0,                 // payload sizes
+                 1, 0xAA>());                // payloads
+
+TEST(ColumnarTrace, Write) {
+  std::array<std::byte, 64> capture = {};
+  Result<size_t> size = ColumnarTraceSize(kRawTrace, 1000);
+  ASSERT_EQ(OkStatus(), size.status());
+  EXPECT_EQ(kCapture.size(), size.value());
+
+  Result<size_t> written = WriteColumnarTrace(kRawTrace, 1000, capture);
+  ASSERT_EQ(OkStatus(), written.status());
+  ASSERT_EQ(kCapture.size(), written.value());
+  EXPECT_EQ(0, std::memcmp(kCapture.data(), capture.data(), kCapture.size()));
+}
+
+TEST(ColumnarTrace, Write_BufferTooSmall) {
+  std::array<std::byte, kCapture.size() - 1> capture = {};
+  EXPECT_EQ(Status::ResourceExhausted(),
+            WriteColumnarTrace(kRawTrace, 1000, capture).status());
+}
+
+TEST(ColumnarTrace, Write_TruncatedEvent) {
+  std::array<std::byte, 64> capture = {};
+  const ConstByteSpan truncated =
+      std::span(kRawTrace).first(kRawTrace.size() - 1);
+  EXPECT_EQ(Status::DataLoss(), ColumnarTraceSize(truncated, 1000).status());
+  EXPECT_EQ(Status::DataLoss(),
+            WriteColumnarTrace(truncated, 1000, capture).status());
+}
+
+TEST(ColumnarTrace, Read) {
+  Result<ColumnarTraceReader> reader = ColumnarTraceReader::Create(kCapture);
+  ASSERT_EQ(OkStatus(), reader.status());
+  EXPECT_EQ(1000u, reader->ticks_per_second());
+  ASSERT_EQ(3u, reader->size());
+
+  auto it = reader->begin();
+  EXPECT_EQ(0x11223344u, it->token);
+  EXPECT_EQ(5u, it->timestamp);
+  ASSERT_EQ(1u, it->payload.size());
+  EXPECT_EQ(std::byte{0xAA}, it->payload[0]);
+
+  ++it;
+  EXPECT_EQ(0x01020304u, it->token);
+  EXPECT_EQ(133u, it->timestamp);
+  EXPECT_TRUE(it->payload.empty());
+
+  ++it;
+  EXPECT_EQ(0x0A0B0C0Du, it->token);
+  EXPECT_EQ(133u, it->timestamp);
+  EXPECT_TRUE(it->payload.empty());
+
+  ++it;
+  EXPECT_EQ(reader->end(), it);
+}
+
+TEST(ColumnarTrace, Read_Empty) {
+  std::array<std::byte, 16> capture = {};
+  Result<size_t> written = WriteColumnarTrace({}, 1000, capture);
+  ASSERT_EQ(OkStatus(), written.status());
+
+  Result<ColumnarTraceReader> reader =
+      ColumnarTraceReader::Create(std::span(capture).first(written.value()));
+  ASSERT_EQ(OkStatus(), reader.status());
+  EXPECT_TRUE(reader->empty());
+  EXPECT_EQ(reader->begin(), reader->end());
+}
+
+TEST(ColumnarTrace, Read_Invalid) {
+  EXPECT_EQ(Status::DataLoss(),
+            ColumnarTraceReader::Create(bytes::String("PWTX\1")).status());
+
+  auto future_version = kCapture;
+  future_version[4] = std::byte{kColumnarTraceVersion + 1};
+  EXPECT_EQ(Status::Unimplemented(),
+            ColumnarTraceReader::Create(future_version).status());
+
+  // Every prefix of the capture is truncated.
+  for (size_t size = 0; size < kCapture.size(); ++size) {
+    EXPECT_EQ(Status::DataLoss(),
+              ColumnarTraceReader::Create(std::span(kCapture).first(size))
+                  .status());
+  }
+
+  // A payload size that disagrees with the payload column.
+  auto bad_size = kCapture;
+  bad_size[kCapture.size() - 4] = std::byte{2};
+  EXPECT_EQ(Status::DataLoss(), ColumnarTraceReader::Create(bad_size).status());
+}
+
+}  // namespace
+}  // namespace pw::trace
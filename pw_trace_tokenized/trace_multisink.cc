@@ -0,0 +1,73 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/trace_multisink.h"
+
+#include <cstring>
+#include <span>
+
+namespace pw {
+namespace trace {
+
+Status MultiSinkTraceSink::Register() {
+  if (registered_) {
+    return Status::AlreadyExists();
+  }
+  Status status = Callbacks::Instance().RegisterSink(
+      StartBlock, AddBytes, EndBlock, this, &handle_);
+  registered_ = status.ok();
+  return status;
+}
+
+Status MultiSinkTraceSink::Unregister() {
+  if (!registered_) {
+    return OkStatus();
+  }
+  registered_ = false;
+  return Callbacks::Instance().UnregisterSink(handle_);
+}
+
+void MultiSinkTraceSink::StartBlock(void* user_data, size_t size) {
+  MultiSinkTraceSink* sink = static_cast<MultiSinkTraceSink*>(user_data);
+  sink->block_size_ = size;
+  sink->block_idx_ = 0;
+}
+
+void MultiSinkTraceSink::AddBytes(void* user_data,
+                                  const void* bytes,
+                                  size_t size) {
+  MultiSinkTraceSink* sink = static_cast<MultiSinkTraceSink*>(user_data);
+  if (sink->block_idx_ + size > sizeof(sink->current_block_)) {
+    // Track the size so EndBlock() can tell the block was too large.
+    sink->block_idx_ += size;
+    return;
+  }
+  std::memcpy(&sink->current_block_[sink->block_idx_], bytes, size);
+  sink->block_idx_ += size;
+}
+
+void MultiSinkTraceSink::EndBlock(void* user_data) {
+  MultiSinkTraceSink* sink = static_cast<MultiSinkTraceSink*>(user_data);
+  if (sink->block_idx_ != sink->block_size_ ||
+      sink->block_size_ > sizeof(sink->current_block_)) {
+    sink->multisink_.HandleDropped();
+    return;
+  }
+  sink->multisink_.HandleEntry(
+      std::span<const std::byte>(sink->current_block_, sink->block_size_));
+}
+
+}  // namespace trace
+}  // namespace pw
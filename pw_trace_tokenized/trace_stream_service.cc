@@ -0,0 +1,127 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/trace_stream_service.h"
+
+#include <mutex>
+
+#include "pw_log/log.h"
+#include "pw_protobuf/encoder.h"
+
+namespace pw {
+namespace trace {
+
+Status TraceStreamDrain::Open(rpc::RawServerWriter& writer) {
+  if (!writer.active()) {
+    return Status::FailedPrecondition();
+  }
+  std::lock_guard lock(mutex_);
+  if (writer_.active()) {
+    return Status::AlreadyExists();
+  }
+  writer_ = std::move(writer);
+  return OkStatus();
+}
+
+Status TraceStreamDrain::Close() {
+  std::lock_guard lock(mutex_);
+  return writer_.Finish();
+}
+
+Status TraceStreamDrain::Flush(ByteSpan encoding_buffer) {
+  std::lock_guard lock(mutex_);
+  if (!writer_.active()) {
+    return Status::FailedPrecondition();
+  }
+
+  bool drained = false;
+  while (!drained) {
+    protobuf::MemoryEncoder encoder(encoding_buffer);
+    uint32_t packed = 0;
+
+    while (true) {
+      uint32_t drop_count = 0;
+      uint32_t ingress_drop_count = 0;
+      Result<PeekedEntry> entry =
+          PeekEntry(entry_buffer_, drop_count, ingress_drop_count);
+      drop_count_ += drop_count + ingress_drop_count;
+
+      if (entry.status().IsResourceExhausted()) {
+        drop_count_ += 1;  // The MultiSink discarded an oversized event.
+        continue;
+      }
+      if (!entry.ok()) {
+        drained = true;  // No more events.
+        break;
+      }
+
+      const ConstByteSpan event = entry.value().entry();
+      if (protobuf::SizeOfDelimitedField(TraceEntries::Fields::ENTRIES,
+                                         event.size()) +
+              protobuf::SizeOfFieldUint32(TraceEntries::Fields::DROP_COUNT) >
+          encoder.ConservativeWriteLimit()) {
+        if (packed != 0u) {
+          break;  // Send this message; the event goes in the next one.
+        }
+        // The event does not fit in an empty message.
+        PopEntry(entry.value())
+            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+        drop_count_ += 1;
+        continue;
+      }
+
+      encoder
+          .WriteBytes(static_cast<uint32_t>(TraceEntries::Fields::ENTRIES),
+                      event)
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+      PopEntry(entry.value())
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+      packed += 1;
+    }
+
+    if (packed == 0u && drop_count_ == 0u) {
+      break;
+    }
+    if (drop_count_ != 0u) {
+      encoder
+          .WriteUint32(
+              static_cast<uint32_t>(TraceEntries::Fields::DROP_COUNT),
+              drop_count_)
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+
+    if (const Status status = writer_.Write(encoder); !status.ok()) {
+      // The packed events are lost. Report them with the next message.
+      drop_count_ += packed;
+      return status;
+    }
+    drop_count_ = 0;
+  }
+  return OkStatus();
+}
+
+uint32_t TraceStreamDrain::pending_drop_count() {
+  std::lock_guard lock(mutex_);
+  return drop_count_;
+}
+
+void TraceStreamService::Listen(ConstByteSpan, rpc::RawServerWriter& writer) {
+  if (const Status status = drain_.Open(writer); !status.ok()) {
+    PW_LOG_DEBUG("Could not start trace stream: %s", status.str());
+  }
+}
+
+}  // namespace trace
+}  // namespace pw
@@ -0,0 +1,154 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_TRACE_MODULE_NAME "TST"
+
+#include "pw_trace_tokenized/trace_stream_service.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_multisink/multisink.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+#include "pw_trace/trace.h"
+#include "pw_trace_tokenized/trace_multisink.h"
+
+namespace pw::trace {
+namespace {
+
+#define TraceStreamContext \
+  PW_RAW_TEST_METHOD_CONTEXT(TraceStreamService, Listen, 8)
+
+// The entries and drop count of all the messages sent.
+struct Stream {
+  size_t messages = 0;
+  size_t entries = 0;
+  uint32_t drop_count = 0;
+};
+
+template <typename Responses>
+Stream DecodeStream(const Responses& responses) {
+  Stream stream;
+  for (const ConstByteSpan& response : responses) {
+    stream.messages += 1;
+    protobuf::Decoder decoder(response);
+    while (decoder.Next().ok()) {
+      switch (static_cast<TraceEntries::Fields>(decoder.FieldNumber())) {
+        case TraceEntries::Fields::ENTRIES:
+          stream.entries += 1;
+          break;
+        case TraceEntries::Fields::DROP_COUNT: {
+          uint32_t drop_count;
+          EXPECT_EQ(OkStatus(), decoder.ReadUint32(&drop_count));
+          stream.drop_count += drop_count;
+          break;
+        }
+      }
+    }
+  }
+  return stream;
+}
+
+class TraceStreamTest : public ::testing::Test {
+ protected:
+  TraceStreamTest()
+      : multisink_(multisink_buffer_),
+        trace_sink_(multisink_),
+        drain_(entry_buffer_),
+        context_(drain_) {
+    multisink_.AttachDrain(drain_);
+    EXPECT_EQ(OkStatus(), trace_sink_.Register());
+    PW_TRACE_SET_ENABLED(true);
+  }
+
+  ~TraceStreamTest() {
+    PW_TRACE_SET_ENABLED(false);
+    multisink_.DetachDrain(drain_);
+  }
+
+  std::array<std::byte, 128> multisink_buffer_ = {};
+  std::array<std::byte, PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES> entry_buffer_ = {};
+  std::array<std::byte, 64> encoding_buffer_ = {};
+  multisink::MultiSink multisink_;
+  MultiSinkTraceSink trace_sink_;
+  TraceStreamDrain drain_;
+  TraceStreamContext context_;
+};
+
+TEST_F(TraceStreamTest, FlushWithoutStream) {
+  PW_TRACE_INSTANT("Test");
+  EXPECT_EQ(Status::FailedPrecondition(), drain_.Flush(encoding_buffer_));
+}
+
+TEST_F(TraceStreamTest, StreamsEvents) {
+  context_.call({});
+  EXPECT_FALSE(context_.done());
+
+  PW_TRACE_INSTANT("Test");
+  PW_TRACE_INSTANT("Test2", "group");
+  PW_TRACE_INSTANT("Test3", "group", 2);
+  ASSERT_EQ(OkStatus(), drain_.Flush(encoding_buffer_));
+
+  Stream stream = DecodeStream(context_.responses());
+  EXPECT_EQ(1u, stream.messages);
+  EXPECT_EQ(3u, stream.entries);
+  EXPECT_EQ(0u, stream.drop_count);
+
+  // Nothing new to send.
+  ASSERT_EQ(OkStatus(), drain_.Flush(encoding_buffer_));
+  EXPECT_EQ(1u, context_.responses().size());
+}
+
+TEST_F(TraceStreamTest, SplitsEventsIntoMessages) {
+  context_.call({});
+
+  for (int i = 0; i < 20; ++i) {
+    PW_TRACE_INSTANT("Test");
+  }
+  ASSERT_EQ(OkStatus(), drain_.Flush(encoding_buffer_));
+
+  Stream stream = DecodeStream(context_.responses());
+  EXPECT_GT(stream.messages, 1u);
+  EXPECT_EQ(20u, stream.entries + stream.drop_count);
+}
+
+TEST_F(TraceStreamTest, ReportsDroppedEvents) {
+  context_.call({});
+
+  // Overflow the MultiSink before flushing.
+  for (int i = 0; i < 100; ++i) {
+    PW_TRACE_INSTANT("Test");
+  }
+  ASSERT_EQ(OkStatus(), drain_.Flush(encoding_buffer_));
+
+  Stream stream = DecodeStream(context_.responses());
+  EXPECT_GT(stream.drop_count, 0u);
+  EXPECT_EQ(100u, stream.entries + stream.drop_count);
+  EXPECT_EQ(0u, drain_.pending_drop_count());
+}
+
+TEST_F(TraceStreamTest, SecondListenerRejected) {
+  context_.call({});
+  TraceStreamContext other_context(drain_);
+  other_context.call({});
+
+  PW_TRACE_INSTANT("Test");
+  ASSERT_EQ(OkStatus(), drain_.Flush(encoding_buffer_));
+  EXPECT_EQ(1u, context_.responses().size());
+  EXPECT_EQ(0u, other_context.responses().size());
+}
+
+}  // namespace
+}  // namespace pw::trace
@@ -570,6 +570,193 @@ constexpr std::byte kTestData[] = {
               result->data_size) == 0) &&                                      \
       (result->data_size == (num) % PW_ARRAY_SIZE(kTestData))
 
+pw_trace_TraceEventReturnFlags NoopEventCallback(void* /* user_data */,
+                                                 uint32_t /* trace_ref */,
+                                                 pw_trace_EventType,
+                                                 const char* /* module */,
+                                                 uint32_t /* trace_id */,
+                                                 uint8_t /* flags */) {
+  return PW_TRACE_EVENT_RETURN_FLAGS_NONE;
+}
+
+TEST(TokenizedTrace, CallbackAndSinkCounts) {
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+  {
+    TraceTestInterface test_interface;
+    EXPECT_EQ(1u, callbacks.GetEventCallbackCount());
+    EXPECT_EQ(0u, callbacks.GetCalledOnEveryEventCount());
+    EXPECT_EQ(1u, callbacks.GetSinkCount());
+  }
+  EXPECT_EQ(0u, callbacks.GetEventCallbackCount());
+  EXPECT_EQ(0u, callbacks.GetSinkCount());
+
+  pw::trace::CallbacksImpl::EventCallbackHandle handle;
+  ASSERT_EQ(pw::OkStatus(),
+            callbacks.RegisterEventCallback(
+                NoopEventCallback,
+                pw::trace::CallbacksImpl::kCallOnEveryEvent,
+                nullptr,
+                &handle));
+  EXPECT_EQ(1u, callbacks.GetCalledOnEveryEventCount());
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterEventCallback(handle));
+  EXPECT_EQ(0u, callbacks.GetEventCallbackCount());
+  EXPECT_EQ(0u, callbacks.GetCalledOnEveryEventCount());
+
+  // Unregistering again does not change the counts.
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterEventCallback(handle));
+  EXPECT_EQ(0u, callbacks.GetEventCallbackCount());
+}
+
+TEST(TokenizedTrace, SinkWithoutCallbacks) {
+  size_t sink_blocks = 0;
+  pw::trace::CallbacksImpl::SinkHandle handle;
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::Callbacks::Instance().RegisterSink(
+                nullptr,
+                nullptr,
+                [](void* user_data) { *static_cast<size_t*>(user_data) += 1; },
+                &sink_blocks,
+                &handle));
+  PW_TRACE_SET_ENABLED(true);
+
+  PW_TRACE_INSTANT("Test");
+  PW_TRACE_INSTANT_DATA("Test2", "uint32", &sink_blocks, sizeof(uint32_t));
+  EXPECT_EQ(2u, sink_blocks);
+
+  PW_TRACE_SET_ENABLED(false);
+  PW_TRACE_INSTANT("Test3");
+  EXPECT_EQ(2u, sink_blocks);
+
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::Callbacks::Instance().UnregisterSink(handle));
+}
+
+TEST(TokenizedTrace, FilterSkipsMatchingEvents) {
+  TraceTestInterface test_interface;
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+  const uint32_t test2_ref = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                          "TST",
+                                          "Test2",
+                                          PW_TRACE_FLAGS_DEFAULT,
+                                          PW_TRACE_GROUP_LABEL_DEFAULT);
+
+  pw::trace::CallbacksImpl::EventFilterHandle handle;
+  ASSERT_EQ(pw::OkStatus(),
+            callbacks.RegisterEventFilter(
+                test2_ref,
+                PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT,
+                pw::trace::CallbacksImpl::kCallOnlyWhenEnabled,
+                &handle));
+  EXPECT_EQ(1u, callbacks.GetEventFilterCount());
+  EXPECT_EQ(0u, callbacks.GetCalledOnEveryEventFilterCount());
+
+  PW_TRACE_INSTANT("Test");
+  PW_TRACE_INSTANT("Test2");
+  PW_TRACE_INSTANT("Test3");
+
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test3");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterEventFilter(handle));
+  EXPECT_EQ(0u, callbacks.GetEventFilterCount());
+
+  PW_TRACE_INSTANT("Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+}
+
+TEST(TokenizedTrace, FilterMatchesTraceId) {
+  TraceTestInterface test_interface;
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+  const uint32_t step_ref = PW_TRACE_REF(PW_TRACE_TYPE_ASYNC_INSTANT,
+                                         "TST",
+                                         "Step",
+                                         PW_TRACE_FLAGS_DEFAULT,
+                                         "group");
+
+  ASSERT_EQ(pw::OkStatus(),
+            callbacks.RegisterEventFilter(
+                step_ref,
+                true,
+                2,
+                PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT,
+                pw::trace::CallbacksImpl::kCallOnlyWhenEnabled));
+
+  PW_TRACE_INSTANT("Step", "group", 1);
+  PW_TRACE_INSTANT("Step", "group", 2);
+  PW_TRACE_INSTANT("Step", "group", 3);
+
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_ASYNC_INSTANT, "Step", "group", 1);
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_ASYNC_INSTANT, "Step", "group", 3);
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterAllEventFilters());
+  EXPECT_EQ(0u, callbacks.GetEventFilterCount());
+}
+
+TEST(TokenizedTrace, FilterTriggersCapture) {
+  TraceTestInterface test_interface;
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+  const uint32_t start_ref = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                          "TST",
+                                          "Start",
+                                          PW_TRACE_FLAGS_DEFAULT,
+                                          PW_TRACE_GROUP_LABEL_DEFAULT);
+  const uint32_t stop_ref = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                         "TST",
+                                         "Stop",
+                                         PW_TRACE_FLAGS_DEFAULT,
+                                         PW_TRACE_GROUP_LABEL_DEFAULT);
+
+  ASSERT_EQ(pw::OkStatus(),
+            callbacks.RegisterEventFilter(
+                start_ref,
+                PW_TRACE_EVENT_RETURN_FLAGS_ENABLE_BEFORE_PROCESSING,
+                pw::trace::CallbacksImpl::kCallOnEveryEvent));
+  ASSERT_EQ(pw::OkStatus(),
+            callbacks.RegisterEventFilter(
+                stop_ref,
+                PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING,
+                pw::trace::CallbacksImpl::kCallOnEveryEvent));
+  EXPECT_EQ(2u, callbacks.GetCalledOnEveryEventFilterCount());
+  PW_TRACE_SET_ENABLED(false);
+
+  PW_TRACE_INSTANT("Before");
+  PW_TRACE_INSTANT("Start");
+  PW_TRACE_INSTANT("During");
+  PW_TRACE_INSTANT("Stop");
+  PW_TRACE_INSTANT("After");
+
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Start");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "During");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Stop");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+  EXPECT_FALSE(pw_trace_IsEnabled());
+
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterAllEventFilters());
+  EXPECT_EQ(0u, callbacks.GetCalledOnEveryEventFilterCount());
+}
+
+TEST(TokenizedTrace, FilterRegistrationErrors) {
+  pw::trace::CallbacksImpl& callbacks = pw::trace::Callbacks::Instance();
+
+  EXPECT_EQ(pw::Status::InvalidArgument(),
+            callbacks.RegisterEventFilter(1, PW_TRACE_EVENT_RETURN_FLAGS_NONE));
+  for (size_t i = 0; i < PW_TRACE_CONFIG_MAX_EVENT_FILTERS; ++i) {
+    ASSERT_EQ(pw::OkStatus(),
+              callbacks.RegisterEventFilter(
+                  i, PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT));
+  }
+  EXPECT_EQ(pw::Status::ResourceExhausted(),
+            callbacks.RegisterEventFilter(
+                0, PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT));
+  EXPECT_EQ(pw::Status::InvalidArgument(),
+            callbacks.UnregisterEventFilter(PW_TRACE_CONFIG_MAX_EVENT_FILTERS));
+
+  ASSERT_EQ(pw::OkStatus(), callbacks.UnregisterAllEventFilters());
+  EXPECT_EQ(0u, callbacks.GetEventFilterCount());
+}
+
 TEST(TokenizedTrace, QueueSimple) {
   constexpr size_t kQueueSize = 5;
   pw::trace::internal::TraceQueue<kQueueSize> queue;
@@ -618,3 +805,83 @@ TEST(TokenizedTrace, Clear) {
   EXPECT_TRUE(queue.PeekFront() == nullptr);
   EXPECT_FALSE(queue.IsFull());
 }
+
+namespace {
+
+int current_test_context = -1;
+
+int CurrentTestContext() { return current_test_context; }
+
+class ContextBuffers : public ::testing::Test {
+ protected:
+  ContextBuffers() {
+    for (size_t i = 0; i < PW_ARRAY_SIZE(buffers_); ++i) {
+      EXPECT_EQ(pw::OkStatus(), buffers_[i].SetBuffer(storage_[i]));
+    }
+    pw::trace::TokenizedTrace::Instance().SetContextBuffers(buffers_,
+                                                            CurrentTestContext);
+  }
+
+  ~ContextBuffers() {
+    current_test_context = -1;
+    pw::trace::TokenizedTrace::Instance().SetContextBuffers({}, nullptr);
+  }
+
+  std::byte storage_[2][128];
+  pw::ring_buffer::LockFreePrefixedEntryRingBuffer buffers_[2];
+};
+
+}  // namespace
+
+TEST_F(ContextBuffers, MergeHandlesEventsInTimestampOrder) {
+  TraceTestInterface test_interface;
+
+  current_test_context = 1;
+  PW_TRACE_INSTANT("First");
+  current_test_context = 0;
+  PW_TRACE_INSTANT("Second");
+  current_test_context = 1;
+  PW_TRACE_INSTANT("Third");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+
+  current_test_context = -1;
+  EXPECT_EQ(3u, pw::trace::TokenizedTrace::Instance().MergeContextBuffers());
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "First");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Second");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Third");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+  EXPECT_EQ(0u, pw::trace::TokenizedTrace::Instance().MergeContextBuffers());
+}
+
+TEST_F(ContextBuffers, ThreadEventHandlesCapturedEventsFirst) {
+  TraceTestInterface test_interface;
+
+  current_test_context = 0;
+  PW_TRACE_INSTANT("Captured");
+  current_test_context = -1;
+  PW_TRACE_INSTANT("Thread");
+
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Captured");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Thread");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+
+TEST_F(ContextBuffers, FullBufferDropsEvents) {
+  TraceTestInterface test_interface;
+  const uint32_t dropped =
+      pw::trace::TokenizedTrace::Instance().context_events_dropped();
+
+  current_test_context = 0;
+  for (int i = 0; i < 10; ++i) {
+    PW_TRACE_INSTANT("Captured");
+  }
+  current_test_context = -1;
+
+  const size_t handled =
+      pw::trace::TokenizedTrace::Instance().MergeContextBuffers();
+  EXPECT_GT(handled, 0u);
+  EXPECT_LT(handled, 10u);
+  EXPECT_EQ(10u - handled,
+            pw::trace::TokenizedTrace::Instance().context_events_dropped() -
+                dropped);
+}
@@ -105,6 +105,11 @@ Status DecodeChunk(ConstByteSpan message, Chunk& chunk) {
         chunk.type = static_cast<Chunk::Type>(type);
         break;
       }
+
+      case ProtoChunk::Fields::COMPRESSION:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.compression = value;
+        break;
     }
   }
 
@@ -149,6 +154,10 @@ Result<ConstByteSpan> EncodeChunk(const Chunk& chunk, ByteSpan buffer) {
         .IgnoreError();
   }
 
+  if (chunk.compression.has_value()) {
+    encoder.WriteCompression(chunk.compression.value()).IgnoreError();
+  }
+
   PW_TRY(encoder.status());
   return ConstByteSpan(encoder);
 }
@@ -224,6 +224,65 @@ TEST_F(ReadTransferMaxBytes32, SetsPendingBytesFromWriterLimit) {
   ASSERT_EQ(c0.pending_bytes.value(), 16u);
 }
 
+class ReadTransferAdaptiveWindow : public ReadTransfer {
+ protected:
+  ReadTransferAdaptiveWindow() : ReadTransfer(/*max_bytes_to_receive=*/256) {
+    client_.set_adaptive_window(true);
+  }
+};
+
+TEST_F(ReadTransferAdaptiveWindow, GrowsAndShrinksWindow) {
+  stream::MemoryWriterBuffer<512> writer;
+  ASSERT_EQ(OkStatus(), client_.Read(7, writer, [](Status) {}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+
+  // The first window is one chunk.
+  Chunk chunk = DecodeChunk(payloads[0]);
+  EXPECT_EQ(chunk.offset, 0u);
+  EXPECT_EQ(chunk.pending_bytes.value(), 64u);
+
+  constexpr ConstByteSpan data(kData32);
+  auto send_data = [&](uint32_t offset) {
+    context_.server().SendServerStream<Transfer::Read>(
+        EncodeChunk({.transfer_id = 7u, .offset = offset, .data = data}));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  };
+
+  // Slow start: the window grows by the amount of data received.
+  send_data(0);
+  ASSERT_EQ(payloads.size(), 2u);
+  chunk = DecodeChunk(payloads[1]);
+  EXPECT_EQ(chunk.offset, 32u);
+  EXPECT_EQ(chunk.pending_bytes.value(), 96u);
+
+  send_data(32);
+  send_data(64);
+  ASSERT_EQ(payloads.size(), 3u);
+  chunk = DecodeChunk(payloads[2]);
+  EXPECT_EQ(chunk.offset, 96u);
+  EXPECT_EQ(chunk.pending_bytes.value(), 160u);
+
+  // Dropping the chunk at offset 96 halves the window.
+  send_data(128);
+  ASSERT_EQ(payloads.size(), 4u);
+  chunk = DecodeChunk(payloads[3]);
+  EXPECT_EQ(chunk.type, Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset, 96u);
+  EXPECT_EQ(chunk.pending_bytes.value(), 80u);
+
+  // After a drop, the window grows by about one chunk per window.
+  send_data(96);
+  send_data(128);
+  ASSERT_EQ(payloads.size(), 5u);
+  chunk = DecodeChunk(payloads[4]);
+  EXPECT_EQ(chunk.offset, 160u);
+  EXPECT_EQ(chunk.pending_bytes.value(), 80u + 64u * 64u / 80u);
+}
+
 TEST_F(ReadTransferMaxBytes32, MultiParameters) {
   stream::MemoryWriterBuffer<64> writer;
   Status transfer_status = Status::Unknown();
@@ -741,6 +800,53 @@ TEST_F(ReadTransfer, Timeout_EndsTransferAfterMaxRetries) {
   ASSERT_EQ(payloads.size(), 5u);
 }
 
+TEST_F(ReadTransfer, AdaptiveTimeout_RetriesSoonAfterFastRoundTrip) {
+  ASSERT_EQ(OkStatus(),
+            client_.set_adaptive_timeout(std::chrono::milliseconds(1),
+                                         std::chrono::milliseconds(20)));
+
+  stream::MemoryWriterBuffer<64> writer;
+  Status transfer_status = Status::Unknown();
+
+  // Use a chunk timeout far longer than the test runs.
+  ASSERT_EQ(OkStatus(),
+            client_.Read(
+                15,
+                writer,
+                [&transfer_status](Status status) { transfer_status = status; },
+                std::chrono::minutes(1)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+
+  // Respond right away, then go silent. The timeout is now based on the short
+  // round trip, so the client retries and gives up in well under a second.
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk({.transfer_id = 15u,
+                   .offset = 0,
+                   .data = std::span(kData32).first(8)}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  ASSERT_EQ(payloads.size(), 5u);
+  Chunk c4 = DecodeChunk(payloads.back());
+  ASSERT_TRUE(c4.status.has_value());
+  EXPECT_EQ(c4.status.value(), Status::DeadlineExceeded());
+  EXPECT_EQ(transfer_status, Status::DeadlineExceeded());
+}
+
+TEST_F(ReadTransfer, AdaptiveTimeout_InvalidBounds) {
+  EXPECT_EQ(Status::InvalidArgument(),
+            client_.set_adaptive_timeout(std::chrono::milliseconds(0),
+                                         std::chrono::milliseconds(20)));
+  EXPECT_EQ(Status::InvalidArgument(),
+            client_.set_adaptive_timeout(std::chrono::milliseconds(20),
+                                         std::chrono::milliseconds(10)));
+}
+
 TEST_F(ReadTransfer, Timeout_ReceivingDataResetsRetryCount) {
   stream::MemoryWriterBuffer<64> writer;
   Status transfer_status = Status::Unknown();
@@ -16,12 +16,16 @@
 
 #include "pw_transfer/internal/context.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
 #include <mutex>
 
 #include "pw_assert/check.h"
 #include "pw_chrono/system_clock.h"
 #include "pw_log/log.h"
+#include "pw_protobuf/wire_format.h"
 #include "pw_status/try.h"
 #include "pw_transfer/transfer.pwpb.h"
 #include "pw_transfer/transfer_thread.h"
@@ -31,6 +35,61 @@ PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 
 namespace pw::transfer::internal {
+namespace {
+
+// Completes a data chunk whose other fields were encoded at the start of
+// buffer and whose data was read directly into buffer at data_offset. The
+// fields are moved up to the data, with the data field's key and length
+// between them, so the data itself is never moved. Returns the encoded chunk.
+ConstByteSpan FinishDataChunk(ByteSpan buffer,
+                              size_t fields_size,
+                              size_t data_offset,
+                              size_t data_size) {
+  std::array<std::byte, 2 * varint::kMaxVarint32SizeBytes> data_prefix;
+  size_t prefix_size = varint::Encode(
+      uint32_t(protobuf::FieldKey(
+          static_cast<uint32_t>(transfer::Chunk::Fields::DATA),
+          protobuf::WireType::kDelimited)),
+      data_prefix);
+  prefix_size += varint::Encode(
+      data_size, std::span(data_prefix).subspan(prefix_size));
+
+  PW_DCHECK_UINT_LE(fields_size + prefix_size, data_offset);
+  const size_t prefix_offset = data_offset - prefix_size;
+  const size_t chunk_offset = prefix_offset - fields_size;
+
+  std::memmove(&buffer[chunk_offset], buffer.data(), fields_size);
+  std::memcpy(&buffer[prefix_offset], data_prefix.data(), prefix_size);
+  return buffer.subspan(chunk_offset, fields_size + prefix_size + data_size);
+}
+
+// Compresses a data chunk's data into codec_buffer if that makes the chunk
+// smaller, and adds the compression field to the chunk's other fields. Returns
+// the data to send: either the compressed data or the original data.
+ConstByteSpan CompressChunkData(Codec& codec,
+                                ByteSpan codec_buffer,
+                                transfer::Chunk::MemoryEncoder& encoder,
+                                ConstByteSpan data) {
+  // The compression field must not make the chunk larger than the receiver's
+  // maximum chunk size, which applies to the uncompressed chunk.
+  const size_t field_size = 1 /* key */ + varint::EncodedSize(codec.id());
+  if (data.size() <= field_size + 1) {
+    return data;
+  }
+
+  const size_t max_compressed_size =
+      std::min(codec_buffer.size(), data.size() - field_size - 1);
+  const StatusWithSize compressed =
+      codec.Compress(data, codec_buffer.first(max_compressed_size));
+  if (!compressed.ok()) {
+    return data;  // The data does not compress; send it as is.
+  }
+
+  encoder.WriteCompression(codec.id()).IgnoreError();
+  return codec_buffer.first(compressed.size());
+}
+
+}  // namespace
 
 void Context::HandleEvent(const Event& event) {
   switch (event.type) {
@@ -65,6 +124,7 @@ void Context::HandleEvent(const Event& event) {
     case EventType::kSetTransferStream:
     case EventType::kAddTransferHandler:
     case EventType::kRemoveTransferHandler:
+    case EventType::kNoOp:
     case EventType::kTerminate:
       // These events are intended for the transfer thread and should never be
       // forwarded through to a context.
@@ -112,6 +172,9 @@ void Context::StartTransferAsServer(const NewTransferEvent& new_transfer) {
   // Server transfers use the stream provided by the handler rather than the
   // stream included in the NewTransferEvent.
   stream_ = &new_transfer.handler->stream();
+  if (type() == TransferType::kTransmit) {
+    memory_mapped_data_ = new_transfer.handler->memory_mapped_data();
+  }
 }
 
 void Context::SendInitialTransmitChunk() {
@@ -120,6 +183,7 @@ void Context::SendInitialTransmitChunk() {
   chunk.transfer_id = transfer_id_;
   chunk.type = Chunk::Type::kTransferStart;
 
+  StartRoundTripTime();
   EncodeAndSendChunk(chunk);
 }
 
@@ -133,6 +197,10 @@ void Context::SendTransferParameters(TransmitAction action) {
       .offset = offset_,
   };
 
+  if (thread_->codec() != nullptr) {
+    parameters.compression = thread_->codec()->id();
+  }
+
   switch (action) {
     case TransmitAction::kBegin:
       parameters.type = internal::Chunk::Type::kTransferStart;
@@ -143,6 +211,10 @@ void Context::SendTransferParameters(TransmitAction action) {
     case TransmitAction::kExtend:
       parameters.type = internal::Chunk::Type::kParametersContinue;
       break;
+    case TransmitAction::kSelectiveRetransmit:
+      parameters.type = internal::Chunk::Type::kParametersSelectiveRetransmit;
+      parameters.pending_bytes = hole_end_offset_ - offset_;
+      break;
   }
 
   PW_LOG_DEBUG(
@@ -154,6 +226,12 @@ void Context::SendTransferParameters(TransmitAction action) {
       static_cast<unsigned>(pending_bytes_),
       static_cast<unsigned>(max_chunk_size_bytes_));
 
+  // After an extension, the transmitter is still sending the previous window,
+  // so the next chunk is not a response to these parameters.
+  if (action != TransmitAction::kExtend) {
+    StartRoundTripTime();
+  }
+
   EncodeAndSendChunk(parameters);
 }
 
@@ -182,8 +260,13 @@ void Context::EncodeAndSendChunk(const Chunk& chunk) {
 }
 
 void Context::UpdateAndSendTransferParameters(TransmitAction action) {
+  uint32_t max_pending_bytes = max_parameters_->pending_bytes();
+  if (max_parameters_->adaptive_window()) {
+    max_pending_bytes = std::min(max_pending_bytes, congestion_window_);
+  }
+
   size_t pending_bytes =
-      std::min(max_parameters_->pending_bytes(),
+      std::min(max_pending_bytes,
                static_cast<uint32_t>(writer().ConservativeWriteLimit()));
 
   window_size_ = pending_bytes;
@@ -210,10 +293,15 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
 
   rpc_writer_ = new_transfer.rpc_writer;
   stream_ = new_transfer.stream;
+  memory_mapped_data_ = {};
 
   offset_ = 0;
   window_size_ = 0;
+  congestion_window_ = new_transfer.max_parameters->max_chunk_size_bytes();
+  slow_start_threshold_ = new_transfer.max_parameters->pending_bytes();
   window_end_offset_ = 0;
+  hole_end_offset_ = 0;
+  resume_offset_ = 0;
   pending_bytes_ = 0;
   max_chunk_size_bytes_ = new_transfer.max_parameters->max_chunk_size_bytes();
 
@@ -226,6 +314,10 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
       std::chrono::microseconds(kDefaultChunkDelayMicroseconds));
   next_timeout_ = kNoTimeout;
 
+  round_trip_start_ = kNoTimeout;
+  smoothed_rtt_ = chrono::SystemClock::duration::zero();
+  rtt_variation_ = chrono::SystemClock::duration::zero();
+
   transfer_rate_.Reset();
 }
 
@@ -295,10 +387,24 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
     return;
   }
 
+  EndRoundTripTime();
+
   bool retransmit = true;
+  bool selective = false;
   if (chunk.type.has_value()) {
+    selective = chunk.type == Chunk::Type::kParametersSelectiveRetransmit;
     retransmit = chunk.type == Chunk::Type::kParametersRetransmit ||
-                 chunk.type == Chunk::Type::kTransferStart;
+                 chunk.type == Chunk::Type::kTransferStart || selective;
+  }
+
+  // A selective retransmit resumes from where the transmitter is now, or from
+  // where it was before an earlier range was requested.
+  const uint32_t resume_offset = has_hole() ? resume_offset_ : offset_;
+  if (selective &&
+      chunk.offset + chunk.pending_bytes.value() > resume_offset) {
+    // The requested range includes data that has not been sent yet, so send
+    // everything from the offset.
+    selective = false;
   }
 
   if (retransmit) {
@@ -333,8 +439,17 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
     // protocol. The window_end_offset field is not guaranteed to be set in
     // these versions, so it must be calculated.
     offset_ = chunk.offset;
-    window_end_offset_ = offset_ + chunk.pending_bytes.value();
     pending_bytes_ = chunk.pending_bytes.value();
+
+    if (selective) {
+      flags_ |= kFlagsHole;
+      hole_end_offset_ = offset_ + pending_bytes_;
+      resume_offset_ = resume_offset;
+      window_end_offset_ = std::max(chunk.window_end_offset, resume_offset_);
+    } else {
+      flags_ &= ~kFlagsHole;
+      window_end_offset_ = offset_ + pending_bytes_;
+    }
   } else {
     window_end_offset_ = chunk.window_end_offset;
   }
@@ -349,10 +464,19 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
         std::chrono::microseconds(chunk.min_delay_microseconds.value()));
   }
 
+  if (thread_->codec() != nullptr &&
+      chunk.compression == thread_->codec()->id()) {
+    flags_ |= kFlagsCompress;
+  } else {
+    flags_ &= ~kFlagsCompress;
+  }
+
   PW_LOG_DEBUG(
       "Transfer %u received parameters type=%s offset=%u window_end_offset=%u",
       static_cast<unsigned>(transfer_id_),
-      retransmit ? "RETRANSMIT" : "CONTINUE",
+      selective    ? "SELECTIVE_RETRANSMIT"
+      : retransmit ? "RETRANSMIT"
+                   : "CONTINUE",
       static_cast<unsigned>(chunk.offset),
       static_cast<unsigned>(window_end_offset_));
 
@@ -378,18 +502,42 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   encoder.WriteType(transfer::Chunk::Type::TRANSFER_DATA).IgnoreError();
 
   // Reserve space for the data proto field overhead and use the remainder of
-  // the buffer for the chunk data.
-  size_t reserved_size = encoder.size() + 1 /* data key */ + 5 /* data size */;
+  // the buffer for the chunk data. The data is read directly into this space,
+  // and the other fields are moved up to it once its size is known. If the
+  // data is compressed, the compression field is added to the other fields.
+  size_t reserved_size =
+      encoder.size() + 1 /* data key */ + 5 /* data size */;
+  if (compress_data()) {
+    reserved_size += 1 /* compression key */ + 5 /* compression value */;
+  }
+
+  // While retransmitting missing data, stop at the end of the missing range.
+  const uint32_t end_offset =
+      has_hole() ? hole_end_offset_ : window_end_offset_;
 
   ByteSpan data_buffer = buffer.subspan(reserved_size);
   size_t max_bytes_to_send =
-      std::min(window_end_offset_ - offset_, max_chunk_size_bytes_);
+      std::min(end_offset - offset_, max_chunk_size_bytes_);
 
   if (max_bytes_to_send < data_buffer.size()) {
     data_buffer = data_buffer.first(max_bytes_to_send);
   }
 
-  Result<ByteSpan> data = reader().Read(data_buffer);
+  // Fill, but do not exceed, the largest packet the RPC channel can send. This
+  // accounts for the channel's MTU and any framing overhead its output adds.
+  const size_t max_payload_size = rpc_writer_->MaxWritePayloadSize();
+  if (max_payload_size > reserved_size &&
+      max_payload_size - reserved_size < data_buffer.size()) {
+    data_buffer = data_buffer.first(max_payload_size - reserved_size);
+  }
+
+  // Memory-mapped data is copied straight into the chunk after its other
+  // fields, rather than read into the buffer and moved.
+  const bool memory_mapped = !memory_mapped_data_.empty();
+  Result<ConstByteSpan> data =
+      memory_mapped ? ReadMemoryMappedData(data_buffer.size())
+                    : Result<ConstByteSpan>(reader().Read(data_buffer));
+  size_t data_size = 0;
   if (data.status().IsOutOfRange()) {
     // No more data to read.
     encoder.WriteRemainingBytes(0).IgnoreError();
@@ -399,7 +547,7 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
     PW_LOG_DEBUG("Transfer %u sending final chunk with remaining_bytes=0",
                  static_cast<unsigned>(transfer_id_));
   } else if (data.ok()) {
-    if (offset_ == window_end_offset_) {
+    if (offset_ == end_offset) {
       if (retransmit_requested) {
         PW_LOG_DEBUG(
             "Transfer %u: received an empty retransmit request, but there is "
@@ -421,7 +569,23 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
                  static_cast<unsigned>(offset_),
                  static_cast<unsigned>(data.value().size()));
 
-    encoder.WriteData(data.value()).IgnoreError();
+    ConstByteSpan chunk_data = data.value();
+    if (compress_data()) {
+      chunk_data = CompressChunkData(*thread_->codec(),
+                                     thread_->codec_buffer(),
+                                     encoder,
+                                     chunk_data);
+    }
+
+    if (memory_mapped) {
+      encoder.WriteData(chunk_data).IgnoreError();
+    } else {
+      if (chunk_data.data() != data_buffer.data()) {
+        std::memcpy(data_buffer.data(), chunk_data.data(), chunk_data.size());
+      }
+      data_size = chunk_data.size();
+    }
+
     last_chunk_offset_ = offset_;
     offset_ += data.value().size();
     pending_bytes_ -= data.value().size();
@@ -440,7 +604,13 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
     return;
   }
 
-  if (const Status status = rpc_writer_->Write(encoder); !status.ok()) {
+  // Memory-mapped data, if any, was encoded directly after the other fields.
+  const ConstByteSpan chunk =
+      data_size == 0u
+          ? ConstByteSpan(encoder)
+          : FinishDataChunk(buffer, encoder.size(), reserved_size, data_size);
+
+  if (const Status status = rpc_writer_->Write(chunk); !status.ok()) {
     PW_LOG_ERROR("Transfer %u failed to send transmit chunk, status %u",
                  static_cast<unsigned>(transfer_id_),
                  status.code());
@@ -450,10 +620,27 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
 
   flags_ |= kFlagsDataSent;
 
+  if (has_hole() && offset_ == hole_end_offset_) {
+    // Sent the missing data. Continue from where the transmitter left off.
+    if (!reader().Seek(resume_offset_).ok()) {
+      PW_LOG_ERROR("Transfer %u failed to seek back to offset %u",
+                   id_for_log(),
+                   static_cast<unsigned>(resume_offset_));
+      Finish(Status::DataLoss());
+      return;
+    }
+
+    flags_ &= ~kFlagsHole;
+    offset_ = resume_offset_;
+    last_chunk_offset_ = offset_;
+    pending_bytes_ = window_end_offset_ - offset_;
+  }
+
   if (offset_ == window_end_offset_) {
     // Sent all requested data. Must now wait for next parameters from the
     // receiver.
     set_transfer_state(TransferState::kWaiting);
+    StartRoundTripTime();
     SetTimeout(chunk_timeout_);
   } else {
     // More data is to be sent. Set a timeout to send the next chunk following
@@ -523,6 +710,25 @@ void Context::HandleReceiveChunk(const Chunk& chunk) {
 }
 
 void Context::HandleReceivedData(const Chunk& chunk) {
+  if (chunk.compression.has_value() && chunk.compression != 0u) {
+    Chunk decompressed = chunk;
+    if (DecompressData(decompressed)) {
+      HandleReceivedData(decompressed);
+    }
+    return;
+  }
+
+  if (has_hole()) {
+    HandleReceivedDataWithHole(chunk);
+    return;
+  }
+
+  if (chunk.offset > offset_ &&
+      chunk.offset + chunk.data.size() <= window_end_offset_ &&
+      StartSelectiveRetransmit(chunk)) {
+    return;
+  }
+
   if (chunk.data.size() > pending_bytes_) {
     // End the transfer, as this indicates a bug with the client implementation
     // where it doesn't respect pending_bytes. Trying to recover from here
@@ -548,27 +754,19 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     set_transfer_state(TransferState::kRecovery);
     SetTimeout(chunk_timeout_);
 
+    ShrinkWindow(/*timed_out=*/false);
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
 
+  EndRoundTripTime();
+
   // Update the last offset seen so that retries can be detected.
   last_chunk_offset_ = chunk.offset;
 
   // Write staged data from the buffer to the stream.
-  if (!chunk.data.empty()) {
-    if (Status status = writer().Write(chunk.data); !status.ok()) {
-      PW_LOG_ERROR(
-          "Transfer %u write of %u B chunk failed with status %u; aborting "
-          "with DATA_LOSS",
-          static_cast<unsigned>(transfer_id_),
-          static_cast<unsigned>(chunk.data.size()),
-          status.code());
-      Finish(Status::DataLoss());
-      return;
-    }
-
-    transfer_rate_.Update(chunk.data.size());
+  if (!WriteReceivedData(chunk)) {
+    return;
   }
 
   // When the client sets remaining_bytes to 0, it indicates completion of the
@@ -611,10 +809,201 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     pending_bytes_ = chunk.window_end_offset - offset_;
   }
 
+  UpdateWindow();
+}
+
+bool Context::StartSelectiveRetransmit(const Chunk& chunk) {
+  if (!max_parameters_->selective_retransmit() ||
+      !writer().seekable(stream::Stream::kCurrent)) {
+    return false;
+  }
+
+  // Leave room for the missing data and write this chunk where it belongs.
+  if (!writer().Seek(chunk.offset - offset_, stream::Stream::kCurrent).ok()) {
+    return false;
+  }
+
+  PW_LOG_DEBUG(
+      "Transfer %u expected offset %u, received %u; requesting missing data",
+      id_for_log(),
+      static_cast<unsigned>(offset_),
+      static_cast<unsigned>(chunk.offset));
+
+  if (!WriteReceivedData(chunk)) {
+    return true;
+  }
+
+  flags_ |= kFlagsHole;
+  if (chunk.IsFinalTransmitChunk()) {
+    flags_ |= kFlagsFinalChunkReceived;
+  }
+  hole_end_offset_ = chunk.offset;
+  resume_offset_ = chunk.offset + chunk.data.size();
+  last_chunk_offset_ = chunk.offset;
+
+  ShrinkWindow(/*timed_out=*/false);
+  SetTimeout(chunk_timeout_);
+  SendTransferParameters(TransmitAction::kSelectiveRetransmit);
+  return true;
+}
+
+void Context::HandleReceivedDataWithHole(const Chunk& chunk) {
+  const uint32_t chunk_end_offset = chunk.offset + chunk.data.size();
+  last_chunk_offset_ = chunk.offset;
+
+  if (chunk.offset == resume_offset_ &&
+      chunk_end_offset <= window_end_offset_) {
+    // The transmitter is still sending the data following the missing range.
+    if (!WriteReceivedData(chunk)) {
+      return;
+    }
+    if (chunk.IsFinalTransmitChunk()) {
+      flags_ |= kFlagsFinalChunkReceived;
+    }
+    resume_offset_ = chunk_end_offset;
+    SetTimeout(chunk_timeout_);
+    return;
+  }
+
+  if (chunk.offset == offset_ && chunk_end_offset <= hole_end_offset_) {
+    EndRoundTripTime();
+
+    // Missing data. Write it in place, then return to the end of the data.
+    if (!SeekWriter(-static_cast<ptrdiff_t>(resume_offset_ - offset_)) ||
+        !WriteReceivedData(chunk) ||
+        !SeekWriter(resume_offset_ - chunk_end_offset)) {
+      return;
+    }
+
+    offset_ = chunk_end_offset;
+    if (offset_ != hole_end_offset_) {
+      SetTimeout(chunk_timeout_);
+      return;
+    }
+
+    PW_LOG_DEBUG("Transfer %u received missing data; resuming at offset %u",
+                 id_for_log(),
+                 static_cast<unsigned>(resume_offset_));
+
+    flags_ &= ~kFlagsHole;
+    offset_ = resume_offset_;
+
+    if ((flags_ & kFlagsFinalChunkReceived) != 0) {
+      Finish(OkStatus());
+      return;
+    }
+
+    pending_bytes_ = window_end_offset_ - offset_;
+    UpdateWindow();
+    return;
+  }
+
+  if (chunk_end_offset <= offset_) {
+    // Data that was already received, such as a retried chunk.
+    SetTimeout(chunk_timeout_);
+    return;
+  }
+
+  // Only one missing range is tracked. Discard the data after it and
+  // retransmit everything from the missing range.
+  PW_LOG_DEBUG(
+      "Transfer %u missing data at offset %u, received %u; entering recovery "
+      "state",
+      id_for_log(),
+      static_cast<unsigned>(offset_),
+      static_cast<unsigned>(chunk.offset));
+
+  if (!SeekWriter(-static_cast<ptrdiff_t>(resume_offset_ - offset_))) {
+    return;
+  }
+  flags_ &= ~(kFlagsHole | kFlagsFinalChunkReceived);
+
+  // The first drop already shrank the window, so leave it.
+  set_transfer_state(TransferState::kRecovery);
+  SetTimeout(chunk_timeout_);
+  UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
+}
+
+bool Context::DecompressData(Chunk& chunk) {
+  Codec* codec = thread_->codec();
+  if (codec == nullptr || chunk.compression != codec->id()) {
+    PW_LOG_ERROR("Transfer %u received data with unsupported codec %u",
+                 id_for_log(),
+                 static_cast<unsigned>(chunk.compression.value()));
+    Finish(Status::Unimplemented());
+    return false;
+  }
+
+  const StatusWithSize result =
+      codec->Decompress(chunk.data, thread_->codec_buffer());
+  if (!result.ok()) {
+    PW_LOG_ERROR("Transfer %u failed to decompress chunk at offset %u: %d",
+                 id_for_log(),
+                 static_cast<unsigned>(chunk.offset),
+                 result.status().code());
+    Finish(Status::DataLoss());
+    return false;
+  }
+
+  chunk.data = thread_->codec_buffer().first(result.size());
+  chunk.compression.reset();
+  return true;
+}
+
+bool Context::WriteReceivedData(const Chunk& chunk) {
+  if (chunk.data.empty()) {
+    return true;
+  }
+
+  if (Status status = writer().Write(chunk.data); !status.ok()) {
+    PW_LOG_ERROR(
+        "Transfer %u write of %u B chunk failed with status %u; aborting "
+        "with DATA_LOSS",
+        static_cast<unsigned>(transfer_id_),
+        static_cast<unsigned>(chunk.data.size()),
+        status.code());
+    Finish(Status::DataLoss());
+    return false;
+  }
+
+  transfer_rate_.Update(chunk.data.size());
+  return true;
+}
+
+Result<ConstByteSpan> Context::ReadMemoryMappedData(size_t max_size) {
+  // The reader is a stream over the same data, so its position tracks seeks
+  // made for retransmissions.
+  const size_t position = reader().Tell();
+  if (position >= memory_mapped_data_.size()) {
+    return Status::OutOfRange();
+  }
+
+  const ConstByteSpan data = memory_mapped_data_.subspan(
+      position, std::min(max_size, memory_mapped_data_.size() - position));
+  PW_TRY(reader().Seek(data.size(), stream::Stream::kCurrent));
+  return data;
+}
+
+bool Context::SeekWriter(ptrdiff_t offset) {
+  if (Status status = writer().Seek(offset, stream::Stream::kCurrent);
+      !status.ok()) {
+    PW_LOG_ERROR(
+        "Transfer %u writer seek failed with status %u; aborting with "
+        "DATA_LOSS",
+        id_for_log(),
+        status.code());
+    Finish(Status::DataLoss());
+    return false;
+  }
+  return true;
+}
+
+void Context::UpdateWindow() {
   SetTimeout(chunk_timeout_);
 
   if (pending_bytes_ == 0u) {
     // Received all pending data. Advance the transfer parameters.
+    GrowWindow();
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
@@ -626,11 +1015,50 @@ void Context::HandleReceivedData(const Chunk& chunk) {
                        window_size_ / max_parameters_->extend_window_divisor();
 
   if (extend_window) {
+    GrowWindow();
     UpdateAndSendTransferParameters(TransmitAction::kExtend);
     return;
   }
 }
 
+void Context::GrowWindow() {
+  if (!max_parameters_->adaptive_window()) {
+    return;
+  }
+
+  // Data received since the last transfer parameters were sent.
+  const uint32_t received = window_size_ - (window_end_offset_ - offset_);
+
+  if (congestion_window_ < slow_start_threshold_) {
+    // Slow start: the window doubles each time a full window is received.
+    congestion_window_ += received;
+  } else {
+    // Congestion avoidance: the window grows by one chunk per full window.
+    const uint64_t growth =
+        uint64_t(max_parameters_->max_chunk_size_bytes()) * received /
+        congestion_window_;
+    congestion_window_ += std::max(static_cast<uint32_t>(growth), 1u);
+  }
+
+  congestion_window_ =
+      std::min(congestion_window_, max_parameters_->pending_bytes());
+}
+
+void Context::ShrinkWindow(bool timed_out) {
+  if (!max_parameters_->adaptive_window()) {
+    return;
+  }
+
+  const uint32_t chunk_size = max_parameters_->max_chunk_size_bytes();
+  slow_start_threshold_ = std::max(congestion_window_ / 2, chunk_size);
+  congestion_window_ = timed_out ? chunk_size : slow_start_threshold_;
+
+  PW_LOG_DEBUG("Transfer %u %s; reducing window to %u B",
+               id_for_log(),
+               timed_out ? "timed out" : "dropped a chunk",
+               static_cast<unsigned>(congestion_window_));
+}
+
 void Context::SendFinalStatusChunk() {
   PW_DCHECK(transfer_state_ == TransferState::kCompleted);
 
@@ -663,6 +1091,51 @@ void Context::SetTimeout(chrono::SystemClock::duration timeout) {
   next_timeout_ = chrono::SystemClock::TimePointAfterAtLeast(timeout);
 }
 
+void Context::StartRoundTripTime() {
+  if (!max_parameters_->adaptive_timeout()) {
+    return;
+  }
+
+  round_trip_start_ =
+      retries_ == 0u ? chrono::SystemClock::now() : kNoTimeout;
+}
+
+void Context::EndRoundTripTime() {
+  if (round_trip_start_ == kNoTimeout) {
+    return;
+  }
+
+  const chrono::SystemClock::duration rtt =
+      chrono::SystemClock::now() - round_trip_start_;
+  round_trip_start_ = kNoTimeout;
+
+  if (smoothed_rtt_ == chrono::SystemClock::duration::zero()) {
+    smoothed_rtt_ = rtt;
+    rtt_variation_ = rtt / 2;
+  } else {
+    const chrono::SystemClock::duration error =
+        smoothed_rtt_ > rtt ? smoothed_rtt_ - rtt : rtt - smoothed_rtt_;
+    rtt_variation_ = (3 * rtt_variation_ + error) / 4;
+    smoothed_rtt_ = (7 * smoothed_rtt_ + rtt) / 8;
+  }
+
+  // Allow at least one clock tick of variation.
+  chunk_timeout_ = std::clamp(
+      smoothed_rtt_ + std::max(4 * rtt_variation_,
+                              chrono::SystemClock::duration(1)),
+      max_parameters_->min_chunk_timeout(),
+      max_parameters_->max_chunk_timeout());
+}
+
+void Context::BackOffTimeout() {
+  if (!max_parameters_->adaptive_timeout()) {
+    return;
+  }
+
+  chunk_timeout_ =
+      std::min(2 * chunk_timeout_, max_parameters_->max_chunk_timeout());
+}
+
 void Context::HandleTimeout() {
   ClearTimeout();
 
@@ -685,6 +1158,7 @@ void Context::HandleTimeout() {
       // A timeout occurring in a WAITING or RECOVERY state indicates that no
       // chunk has been received from the other side. The transfer should retry
       // its previous operation.
+      BackOffTimeout();
       SetTimeout(chunk_timeout_);  // Finish() clears the timeout if retry fails
       Retry();
       break;
@@ -717,7 +1191,14 @@ void Context::Retry() {
         "Receive transfer %u timed out waiting for chunk; resending parameters",
         static_cast<unsigned>(transfer_id_));
 
-    SendTransferParameters(TransmitAction::kRetransmit);
+    if (has_hole()) {
+      SendTransferParameters(TransmitAction::kSelectiveRetransmit);
+    } else if (max_parameters_->adaptive_window()) {
+      ShrinkWindow(/*timed_out=*/true);
+      UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
+    } else {
+      SendTransferParameters(TransmitAction::kRetransmit);
+    }
     return;
   }
 
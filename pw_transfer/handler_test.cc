@@ -37,5 +37,12 @@ TEST(Handlers, ReadWrite) {
   EXPECT_EQ(OkStatus(), handler.PrepareWrite());
 }
 
+TEST(Handlers, MemoryMappedRead) {
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}};
+  MemoryMappedReadHandler handler(123, kData);
+  EXPECT_EQ(OkStatus(), handler.PrepareRead());
+  EXPECT_EQ(Status::PermissionDenied(), handler.PrepareWrite());
+}
+
 }  // namespace
 }  // namespace pw::transfer
@@ -0,0 +1,143 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/lz_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::transfer {
+namespace {
+
+constexpr std::byte kMatchFlag{0x80};
+
+// Appends a run of literal bytes to the output, splitting it into tokens of at
+// most kMaxLiteralRun bytes.
+bool WriteLiterals(ConstByteSpan literals, ByteSpan output, size_t& written) {
+  while (!literals.empty()) {
+    const size_t run = std::min(literals.size(), LzCodec::kMaxLiteralRun);
+    if (output.size() - written < run + 1) {
+      return false;
+    }
+
+    output[written++] = static_cast<std::byte>(run - 1);
+    std::memcpy(&output[written], literals.data(), run);
+    written += run;
+    literals = literals.subspan(run);
+  }
+  return true;
+}
+
+}  // namespace
+
+StatusWithSize LzCodec::Compress(ConstByteSpan data, ByteSpan output) {
+  size_t written = 0;
+  size_t literal_start = 0;
+  size_t position = 0;
+
+  while (position < data.size()) {
+    const size_t max_length = std::min(data.size() - position, kMaxMatch);
+    const size_t window_start =
+        position > kMaxDistance ? position - kMaxDistance : 0;
+
+    // Find the longest match, preferring the closest one. A match may overlap
+    // the data it copies, which encodes runs of repeated bytes.
+    size_t match_length = 0;
+    size_t match_distance = 0;
+    for (size_t candidate = position; candidate-- > window_start;) {
+      size_t length = 0;
+      while (length < max_length &&
+             data[candidate + length] == data[position + length]) {
+        length += 1;
+      }
+      if (length > match_length) {
+        match_length = length;
+        match_distance = position - candidate;
+        if (length == max_length) {
+          break;
+        }
+      }
+    }
+
+    if (match_length < kMinMatch) {
+      position += 1;
+      continue;
+    }
+
+    if (!WriteLiterals(data.subspan(literal_start, position - literal_start),
+                       output,
+                       written) ||
+        output.size() - written < 2) {
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    output[written++] =
+        kMatchFlag | static_cast<std::byte>(match_length - kMinMatch);
+    output[written++] = static_cast<std::byte>(match_distance - 1);
+    position += match_length;
+    literal_start = position;
+  }
+
+  if (!WriteLiterals(data.subspan(literal_start), output, written)) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  return StatusWithSize(written);
+}
+
+StatusWithSize LzCodec::Decompress(ConstByteSpan data, ByteSpan output) {
+  size_t written = 0;
+
+  while (!data.empty()) {
+    const std::byte token = data[0];
+
+    if ((token & kMatchFlag) == std::byte{0}) {
+      const size_t run = static_cast<size_t>(token) + 1;
+      if (data.size() < run + 1) {
+        return StatusWithSize::DataLoss();
+      }
+      if (output.size() - written < run) {
+        return StatusWithSize::ResourceExhausted();
+      }
+
+      std::memcpy(&output[written], &data[1], run);
+      written += run;
+      data = data.subspan(run + 1);
+      continue;
+    }
+
+    if (data.size() < 2) {
+      return StatusWithSize::DataLoss();
+    }
+
+    const size_t length = static_cast<size_t>(token & ~kMatchFlag) + kMinMatch;
+    const size_t distance = static_cast<size_t>(data[1]) + 1;
+    if (distance > written) {
+      return StatusWithSize::DataLoss();
+    }
+    if (output.size() - written < length) {
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    // Copy byte by byte, since the source may overlap the destination.
+    for (size_t i = 0; i < length; ++i) {
+      output[written] = output[written - distance];
+      written += 1;
+    }
+    data = data.subspan(2);
+  }
+
+  return StatusWithSize(written);
+}
+
+}  // namespace pw::transfer
@@ -0,0 +1,107 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/lz_codec.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::transfer {
+namespace {
+
+constexpr char kLogText[] =
+    "INF sensor: temperature=21 humidity=40\n"
+    "INF sensor: temperature=22 humidity=41\n"
+    "INF sensor: temperature=22 humidity=40\n"
+    "WRN sensor: temperature=23 humidity=39\n";
+
+ConstByteSpan LogText() {
+  return std::as_bytes(std::span(kLogText, sizeof(kLogText) - 1));
+}
+
+// Compresses and decompresses data, returning the compressed size.
+size_t RoundTrip(ConstByteSpan data) {
+  LzCodec codec;
+  std::array<std::byte, 512> compressed;
+  std::array<std::byte, 512> decompressed;
+
+  StatusWithSize result = codec.Compress(data, compressed);
+  EXPECT_EQ(OkStatus(), result.status());
+
+  const size_t compressed_size = result.size();
+  result = codec.Decompress(std::span(compressed).first(compressed_size),
+                            decompressed);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.size(), data.size());
+  EXPECT_EQ(std::memcmp(decompressed.data(), data.data(), data.size()), 0);
+  return compressed_size;
+}
+
+TEST(LzCodec, RoundTrip_Empty) { EXPECT_EQ(RoundTrip({}), 0u); }
+
+TEST(LzCodec, RoundTrip_RepetitiveText) {
+  EXPECT_LT(RoundTrip(LogText()), LogText().size() / 2);
+}
+
+TEST(LzCodec, RoundTrip_RunOfOneByte) {
+  constexpr auto kZeros = bytes::Initialized<300>(0);
+  EXPECT_LT(RoundTrip(kZeros), 10u);
+}
+
+TEST(LzCodec, RoundTrip_IncompressibleData) {
+  // Each byte differs from every other byte, so only literals are written.
+  constexpr auto kData = bytes::Initialized<200>([](size_t i) { return i; });
+  EXPECT_EQ(RoundTrip(kData), kData.size() + 2);
+}
+
+TEST(LzCodec, Compress_OutputTooSmall) {
+  LzCodec codec;
+  std::array<std::byte, 16> compressed;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            codec.Compress(LogText(), compressed).status());
+}
+
+TEST(LzCodec, Decompress_OutputTooSmall) {
+  LzCodec codec;
+  std::array<std::byte, 256> compressed;
+  StatusWithSize result = codec.Compress(LogText(), compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+
+  std::array<std::byte, 64> decompressed;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            codec.Decompress(std::span(compressed).first(result.size()),
+                             decompressed)
+                .status());
+}
+
+TEST(LzCodec, Decompress_MalformedData) {
+  LzCodec codec;
+  std::array<std::byte, 64> decompressed;
+
+  // A literal run longer than the remaining data.
+  constexpr auto kTruncated = bytes::Array<0x03, 'a', 'b'>();
+  EXPECT_EQ(Status::DataLoss(),
+            codec.Decompress(kTruncated, decompressed).status());
+
+  // A copy from before the start of the output.
+  constexpr auto kBadDistance = bytes::Array<0x00, 'a', 0x80, 0x01>();
+  EXPECT_EQ(Status::DataLoss(),
+            codec.Decompress(kBadDistance, decompressed).status());
+}
+
+}  // namespace
+}  // namespace pw::transfer
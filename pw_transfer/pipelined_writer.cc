@@ -0,0 +1,118 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/pipelined_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::transfer {
+
+PipelinedWriter::PipelinedWriter(ByteSpan buffer)
+    : buffer_(buffer),
+      output_(nullptr),
+      write_limit_(0),
+      active_half_(0),
+      buffered_bytes_(0),
+      terminate_(false) {
+  PW_CHECK_UINT_GE(buffer.size(), 2u);
+  idle_.release();
+}
+
+void PipelinedWriter::set_output(stream::Writer& output) {
+  idle_.acquire();
+  output_ = &output;
+  status_ = OkStatus();
+  write_limit_ = output.ConservativeWriteLimit();
+  buffered_bytes_ = 0;
+  idle_.release();
+}
+
+Status PipelinedWriter::Flush() {
+  if (buffered_bytes_ != 0u) {
+    PW_TRY(SubmitBuffer());
+  }
+
+  idle_.acquire();
+  const Status status = status_;
+  status_ = OkStatus();
+  idle_.release();
+  return status;
+}
+
+void PipelinedWriter::Terminate() {
+  idle_.acquire();
+  terminate_ = true;
+  write_requested_.release();
+}
+
+Status PipelinedWriter::DoWrite(ConstByteSpan data) {
+  if (data.size() > write_limit_) {
+    return Status::OutOfRange();
+  }
+  if (write_limit_ != kUnlimited) {
+    write_limit_ -= data.size();
+  }
+
+  while (!data.empty()) {
+    const size_t size =
+        std::min(data.size(), half_size() - buffered_bytes_);
+    std::memcpy(half(active_half_).data() + buffered_bytes_, data.data(), size);
+    buffered_bytes_ += size;
+    data = data.subspan(size);
+
+    if (buffered_bytes_ == half_size()) {
+      PW_TRY(SubmitBuffer());
+    }
+  }
+  return OkStatus();
+}
+
+Status PipelinedWriter::SubmitBuffer() {
+  // Wait for the thread to finish writing the other half.
+  idle_.acquire();
+
+  if (!status_.ok() || output_ == nullptr) {
+    const Status status = output_ == nullptr ? Status::FailedPrecondition()
+                                             : status_;
+    buffered_bytes_ = 0;
+    idle_.release();
+    return status;
+  }
+
+  pending_data_ = half(active_half_).first(buffered_bytes_);
+  active_half_ ^= 1;
+  buffered_bytes_ = 0;
+
+  // The thread releases idle_ when it has written the data.
+  write_requested_.release();
+  return OkStatus();
+}
+
+void PipelinedWriter::Run() {
+  while (true) {
+    write_requested_.acquire();
+    if (terminate_) {
+      return;
+    }
+
+    status_.Update(output_->Write(pending_data_));
+    idle_.release();
+  }
+}
+
+}  // namespace pw::transfer
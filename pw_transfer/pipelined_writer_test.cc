@@ -0,0 +1,156 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/pipelined_writer.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::transfer {
+namespace {
+
+thread::Options& WriterThreadOptions() {
+  static thread::stl::Options options;
+  return options;
+}
+
+constexpr auto kData = bytes::Initialized<40>([](size_t i) { return i; });
+
+// Writes to a memory buffer, optionally waiting for the test before each write.
+class BlockingWriter final : public stream::NonSeekableWriter {
+ public:
+  BlockingWriter() : writer_(buffer_), block_(false), writes_(0) {}
+
+  void set_block(bool block) { block_ = block; }
+  void set_status(Status status) { status_ = status; }
+
+  // Waits until the PipelinedWriter's thread is in a Write() call.
+  void WaitForWrite() { write_started_.acquire(); }
+
+  // Lets a blocked Write() call finish.
+  void Unblock() { unblock_.release(); }
+
+  ConstByteSpan written() const { return writer_.WrittenData(); }
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    if (block_) {
+      write_started_.release();
+      unblock_.acquire();
+    }
+    PW_TRY(status_);
+    return writer_.Write(data);
+  }
+
+  std::array<std::byte, 64> buffer_;
+  stream::MemoryWriter writer_;
+  bool block_;
+  size_t writes_;
+  Status status_;
+  sync::BinarySemaphore write_started_;
+  sync::BinarySemaphore unblock_;
+};
+
+class PipelinedWriterTest : public ::testing::Test {
+ protected:
+  PipelinedWriterTest() : thread_(WriterThreadOptions(), writer_) {
+    writer_.set_output(output_);
+  }
+
+  ~PipelinedWriterTest() {
+    writer_.Terminate();
+    thread_.join();
+  }
+
+  BlockingWriter output_;
+  PipelinedWriterBuffer<16> writer_;
+  thread::Thread thread_;
+};
+
+TEST_F(PipelinedWriterTest, BuffersDataUntilFlush) {
+  ASSERT_EQ(OkStatus(), writer_.Write(std::span(kData).first(5)));
+  EXPECT_EQ(output_.writes(), 0u);
+
+  ASSERT_EQ(OkStatus(), writer_.Flush());
+  ASSERT_EQ(output_.written().size(), 5u);
+  EXPECT_EQ(std::memcmp(output_.written().data(), kData.data(), 5), 0);
+}
+
+TEST_F(PipelinedWriterTest, WritesEachHalfOfTheBufferOnce) {
+  ASSERT_EQ(OkStatus(), writer_.Write(kData));
+  ASSERT_EQ(OkStatus(), writer_.Flush());
+
+  // 40 bytes are five full 8-byte halves.
+  EXPECT_EQ(output_.writes(), 5u);
+  ASSERT_EQ(output_.written().size(), kData.size());
+  EXPECT_EQ(
+      std::memcmp(output_.written().data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(PipelinedWriterTest, AcceptsDataWhileOutputIsWriting) {
+  output_.set_block(true);
+
+  // Fill the first half, which the thread then starts writing.
+  ASSERT_EQ(OkStatus(), writer_.Write(std::span(kData).first(8)));
+  output_.WaitForWrite();
+
+  // The second half is still available while the first is being written.
+  ASSERT_EQ(OkStatus(), writer_.Write(std::span(kData).subspan(8, 7)));
+  EXPECT_EQ(output_.written().size(), 0u);
+
+  output_.set_block(false);
+  output_.Unblock();
+  ASSERT_EQ(OkStatus(), writer_.Flush());
+
+  ASSERT_EQ(output_.written().size(), 15u);
+  EXPECT_EQ(std::memcmp(output_.written().data(), kData.data(), 15), 0);
+}
+
+TEST_F(PipelinedWriterTest, ReportsOutputErrors) {
+  output_.set_status(Status::DataLoss());
+
+  ASSERT_EQ(OkStatus(), writer_.Write(std::span(kData).first(8)));
+  EXPECT_EQ(Status::DataLoss(), writer_.Flush());
+
+  // Flushing clears the error.
+  output_.set_status(OkStatus());
+  EXPECT_EQ(OkStatus(), writer_.Flush());
+}
+
+TEST_F(PipelinedWriterTest, LimitsWritesToOutputLimit) {
+  EXPECT_EQ(writer_.ConservativeWriteLimit(), stream::Stream::kUnlimited);
+
+  stream::MemoryWriterBuffer<12> small_output;
+  writer_.set_output(small_output);
+  EXPECT_EQ(writer_.ConservativeWriteLimit(), 12u);
+
+  ASSERT_EQ(OkStatus(), writer_.Write(std::span(kData).first(10)));
+  EXPECT_EQ(writer_.ConservativeWriteLimit(), 2u);
+  EXPECT_EQ(Status::OutOfRange(), writer_.Write(std::span(kData).first(3)));
+
+  ASSERT_EQ(OkStatus(), writer_.Flush());
+  EXPECT_EQ(small_output.bytes_written(), 10u);
+}
+
+}  // namespace
+}  // namespace pw::transfer
@@ -96,6 +96,40 @@ class Client {
     return OkStatus();
   }
 
+  // When a chunk is dropped, asks the transmitter for only the missing data
+  // instead of all data from the dropped chunk onward. Only write streams that
+  // can seek relative to their current position support this; others always
+  // retransmit everything. Transmitters must support
+  // PARAMETERS_SELECTIVE_RETRANSMIT chunks.
+  void set_selective_retransmit(bool selective_retransmit) {
+    max_parameters_.set_selective_retransmit(selective_retransmit);
+  }
+
+  // Starts each receive transfer with a window of one chunk, then adjusts the
+  // window with slow start and additive increase / multiplicative decrease,
+  // up to the maximum pending bytes. Transfers then use fast links fully and
+  // back off on lossy ones without tuning the maximum pending bytes.
+  void set_adaptive_window(bool adaptive_window) {
+    max_parameters_.set_adaptive_window(adaptive_window);
+  }
+
+  // Adjusts each transfer's chunk timeout to the measured round-trip time
+  // between chunks and their responses, as TCP does for its retransmission
+  // timeout, so that lost chunks on fast links are retried quickly. The
+  // configured chunk timeout is used until a round trip has been measured, and
+  // is doubled after each timeout. The timeout always stays within
+  // [min_chunk_timeout, max_chunk_timeout].
+  Status set_adaptive_timeout(chrono::SystemClock::duration min_chunk_timeout,
+                              chrono::SystemClock::duration max_chunk_timeout) {
+    if (min_chunk_timeout <= chrono::SystemClock::duration(0) ||
+        min_chunk_timeout > max_chunk_timeout) {
+      return Status::InvalidArgument();
+    }
+
+    max_parameters_.set_adaptive_timeout(min_chunk_timeout, max_chunk_timeout);
+    return OkStatus();
+  }
+
  private:
   using Transfer = pw_rpc::raw::Transfer;
 
@@ -0,0 +1,53 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::transfer {
+
+// A compression codec for transfer data. Each chunk's data is compressed as an
+// independent stream, so a chunk can be decompressed without any of the chunks
+// before it. Transfer offsets continue to refer to the uncompressed data, which
+// lets transfers be retried and resumed exactly as if they were uncompressed.
+//
+// Codecs are used from a transfer thread, one chunk at a time.
+class Codec {
+ public:
+  virtual ~Codec() = default;
+
+  // Identifies the codec in the transfer protocol. Both ends of a transfer must
+  // use the same ID for the same compressed format. The ID must not be 0.
+  constexpr uint32_t id() const { return id_; }
+
+  // Compresses data into output. Returns RESOURCE_EXHAUSTED if the compressed
+  // data does not fit in output, in which case the chunk is sent uncompressed.
+  virtual StatusWithSize Compress(ConstByteSpan data, ByteSpan output) = 0;
+
+  // Decompresses data compressed by Compress() into output. Returns
+  // RESOURCE_EXHAUSTED if output is too small, or DATA_LOSS if the data is
+  // malformed.
+  virtual StatusWithSize Decompress(ConstByteSpan data, ByteSpan output) = 0;
+
+ protected:
+  explicit constexpr Codec(uint32_t id) : id_(id) {}
+
+ private:
+  uint32_t id_;
+};
+
+}  // namespace pw::transfer
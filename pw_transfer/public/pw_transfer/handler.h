@@ -14,8 +14,10 @@
 #pragma once
 
 #include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
 #include "pw_transfer/internal/event.h"
 
@@ -84,6 +86,12 @@ class Handler : public IntrusiveList<Handler>::Item {
     return *reader_;
   }
 
+  // Returns the data of a handler whose reads are backed by memory, such as
+  // memory-mapped flash. A transfer slices its chunks from this data directly
+  // instead of reading them through the stream. The stream's position is still
+  // used and must be kept in sync with the data.
+  virtual ConstByteSpan memory_mapped_data() const { return {}; }
+
   uint32_t transfer_id_;
 
   // Use a union to support constexpr construction.
@@ -116,6 +124,31 @@ class ReadOnlyHandler : public internal::Handler {
   using internal::Handler::set_writer;
 };
 
+// A ReadOnlyHandler that serves data directly from memory, such as a firmware
+// image or snapshot in memory-mapped (XIP) flash. Transfers copy each chunk's
+// data straight from the span into the outgoing packet, without going through
+// a stream::Reader and the transfer's chunk buffer.
+class MemoryMappedReadHandler : public ReadOnlyHandler {
+ public:
+  MemoryMappedReadHandler(uint32_t transfer_id, ConstByteSpan data)
+      : ReadOnlyHandler(transfer_id), data_(data), reader_(data) {
+    set_reader(reader_);
+  }
+
+  virtual ~MemoryMappedReadHandler() = default;
+
+  // Each read transfer starts from the beginning of the data.
+  Status PrepareRead() override { return reader_.Seek(0); }
+
+ private:
+  ConstByteSpan memory_mapped_data() const final { return data_; }
+
+  using ReadOnlyHandler::set_reader;
+
+  ConstByteSpan data_;
+  stream::MemoryReader reader_;
+};
+
 class WriteOnlyHandler : public internal::Handler {
  public:
   constexpr WriteOnlyHandler(uint32_t transfer_id)
@@ -30,6 +30,7 @@ struct Chunk {
     kParametersContinue = 3,
     kTransferCompletion = 4,
     kTransferCompletionAck = 5,  // Currently unused.
+    kParametersSelectiveRetransmit = 6,
   };
 
   // The initial chunk always has an offset of 0 and no data or status.
@@ -55,6 +56,7 @@ struct Chunk {
   std::optional<uint64_t> remaining_bytes;
   std::optional<Status> status;
   std::optional<Type> type;
+  std::optional<uint32_t> compression;
 };
 
 // Partially decodes a transfer chunk to find its transfer ID field.
@@ -19,7 +19,9 @@
 #include <optional>
 
 #include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
 #include "pw_rpc/writer.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
@@ -38,7 +40,11 @@ class TransferParameters {
                                uint32_t extend_window_divisor)
       : pending_bytes_(pending_bytes),
         max_chunk_size_bytes_(max_chunk_size_bytes),
-        extend_window_divisor_(extend_window_divisor) {
+        extend_window_divisor_(extend_window_divisor),
+        selective_retransmit_(false),
+        adaptive_window_(false),
+        min_chunk_timeout_(0),
+        max_chunk_timeout_(0) {
     PW_ASSERT(pending_bytes > 0);
     PW_ASSERT(max_chunk_size_bytes > 0);
     PW_ASSERT(extend_window_divisor > 1);
@@ -60,10 +66,46 @@ class TransferParameters {
     extend_window_divisor_ = extend_window_divisor;
   }
 
+  // Whether a receiver asks for only the data it is missing after a dropped
+  // chunk, rather than for everything from the dropped chunk onward.
+  bool selective_retransmit() const { return selective_retransmit_; }
+  void set_selective_retransmit(bool selective_retransmit) {
+    selective_retransmit_ = selective_retransmit;
+  }
+
+  // Whether a receiver starts with a window of one chunk and adjusts it as
+  // data is received and lost, using pending_bytes only as the upper limit.
+  bool adaptive_window() const { return adaptive_window_; }
+  void set_adaptive_window(bool adaptive_window) {
+    adaptive_window_ = adaptive_window;
+  }
+
+  // Whether transfers adjust their chunk timeout to the measured round-trip
+  // time, within [min_chunk_timeout, max_chunk_timeout].
+  bool adaptive_timeout() const {
+    return max_chunk_timeout_ > chrono::SystemClock::duration(0);
+  }
+  chrono::SystemClock::duration min_chunk_timeout() const {
+    return min_chunk_timeout_;
+  }
+  chrono::SystemClock::duration max_chunk_timeout() const {
+    return max_chunk_timeout_;
+  }
+  void set_adaptive_timeout(chrono::SystemClock::duration min_chunk_timeout,
+                            chrono::SystemClock::duration max_chunk_timeout) {
+    PW_DASSERT(min_chunk_timeout <= max_chunk_timeout);
+    min_chunk_timeout_ = min_chunk_timeout;
+    max_chunk_timeout_ = max_chunk_timeout;
+  }
+
  private:
   uint32_t pending_bytes_;
   uint32_t max_chunk_size_bytes_;
   uint32_t extend_window_divisor_;
+  bool selective_retransmit_;
+  bool adaptive_window_;
+  chrono::SystemClock::duration min_chunk_timeout_;
+  chrono::SystemClock::duration max_chunk_timeout_;
 };
 
 // Information about a single transfer.
@@ -110,10 +152,15 @@ class Context {
         retries_(0),
         max_retries_(0),
         stream_(nullptr),
+        memory_mapped_data_{},
         rpc_writer_(nullptr),
         offset_(0),
         window_size_(0),
+        congestion_window_(0),
+        slow_start_threshold_(0),
         window_end_offset_(0),
+        hole_end_offset_(0),
+        resume_offset_(0),
         pending_bytes_(0),
         max_chunk_size_bytes_(std::numeric_limits<uint32_t>::max()),
         max_parameters_(nullptr),
@@ -122,7 +169,10 @@ class Context {
         chunk_timeout_(chrono::SystemClock::duration::zero()),
         interchunk_delay_(chrono::SystemClock::for_at_least(
             std::chrono::microseconds(kDefaultChunkDelayMicroseconds))),
-        next_timeout_(kNoTimeout) {}
+        next_timeout_(kNoTimeout),
+        round_trip_start_(kNoTimeout),
+        smoothed_rtt_(chrono::SystemClock::duration::zero()),
+        rtt_variation_(chrono::SystemClock::duration::zero()) {}
 
   constexpr TransferType type() const {
     return static_cast<TransferType>(flags_ & kFlagsType);
@@ -156,6 +206,8 @@ class Context {
     kExtend,
     // Retransmit from a specified offset.
     kRetransmit,
+    // Retransmit only the missing range [offset_, hole_end_offset_).
+    kSelectiveRetransmit,
   };
 
   void set_transfer_state(TransferState state) { transfer_state_ = state; }
@@ -176,6 +228,11 @@ class Context {
     return static_cast<stream::Writer&>(*stream_);
   }
 
+  // Returns up to max_size bytes of memory-mapped data from the reader's
+  // position and advances the reader past them. Returns OUT_OF_RANGE at the
+  // end of the data.
+  Result<ConstByteSpan> ReadMemoryMappedData(size_t max_size);
+
   // Calculates the maximum size of actual data that can be sent within a
   // single client write transfer chunk, accounting for the overhead of the
   // transfer protocol and RPC system.
@@ -231,6 +288,49 @@ class Context {
   // Processes a data chunk in a received while in the kWaiting state.
   void HandleReceivedData(const Chunk& chunk);
 
+  // In a receive transfer, writes a chunk that arrived past offset_ to its
+  // place in the stream and requests only the missing data. Returns false if
+  // the writer cannot seek there, in which case nothing was done.
+  bool StartSelectiveRetransmit(const Chunk& chunk);
+
+  // Processes a data chunk received while data is missing before
+  // resume_offset_.
+  void HandleReceivedDataWithHole(const Chunk& chunk);
+
+  // Replaces a data chunk's compressed data with the decompressed data, which
+  // is stored in the thread's codec buffer. Calls Finish() and returns false if
+  // the data cannot be decompressed.
+  bool DecompressData(Chunk& chunk);
+
+  // Writes a data chunk's data to the writer at its current position. Calls
+  // Finish() and returns false if the write fails.
+  bool WriteReceivedData(const Chunk& chunk);
+
+  // Seeks the writer relative to its current position. Calls Finish() and
+  // returns false if the seek fails.
+  bool SeekWriter(ptrdiff_t offset);
+
+  // Requests more data from the transmitter if the current window is used up
+  // or is small enough to extend.
+  void UpdateWindow();
+
+  // With an adaptive window, grows the receive window after data is received:
+  // by the amount of data received until slow_start_threshold_ is reached,
+  // and by about one chunk per window after that.
+  void GrowWindow();
+
+  // With an adaptive window, shrinks the receive window after data is lost.
+  // A dropped chunk halves the window; a timeout returns it to one chunk.
+  void ShrinkWindow(bool timed_out);
+
+  // True if data is missing before resume_offset_: a receiver is waiting for
+  // it, or a transmitter is retransmitting it.
+  bool has_hole() const { return (flags_ & kFlagsHole) != 0; }
+
+  // True if a transmitter may compress data, as the receiver supports its
+  // codec.
+  bool compress_data() const { return (flags_ & kFlagsCompress) != 0; }
+
   // Sends the first chunk in a transmit transfer.
   void SendInitialTransmitChunk();
 
@@ -259,6 +359,18 @@ class Context {
   void SetTimeout(chrono::SystemClock::duration timeout);
   void ClearTimeout() { next_timeout_ = kNoTimeout; }
 
+  // Starts timing a round trip after sending a chunk that the other end must
+  // respond to. Chunks sent by a retry are not timed, since it is unknown
+  // which one a response answers.
+  void StartRoundTripTime();
+
+  // Ends the current round-trip measurement, if any, and updates the chunk
+  // timeout from it as TCP does (RFC 6298).
+  void EndRoundTripTime();
+
+  // Doubles the chunk timeout after a timeout, up to the maximum.
+  void BackOffTimeout();
+
   // Called when the transfer's timeout expires.
   void HandleTimeout();
 
@@ -268,6 +380,9 @@ class Context {
 
   static constexpr uint8_t kFlagsType = 1 << 0;
   static constexpr uint8_t kFlagsDataSent = 1 << 1;
+  static constexpr uint8_t kFlagsHole = 1 << 2;
+  static constexpr uint8_t kFlagsFinalChunkReceived = 1 << 3;
+  static constexpr uint8_t kFlagsCompress = 1 << 4;
 
   static constexpr uint32_t kDefaultChunkDelayMicroseconds = 2000;
 
@@ -289,11 +404,27 @@ class Context {
 
   // The stream from which to read or to which to write data.
   stream::Stream* stream_;
+
+  // If a transmitter's handler is backed by memory, its data. Chunk data is
+  // sliced from it at the stream's position instead of read from the stream.
+  ConstByteSpan memory_mapped_data_;
   rpc::Writer* rpc_writer_;
 
   uint32_t offset_;
   uint32_t window_size_;
+
+  // The largest window a receiver with an adaptive window requests, and the
+  // window size at which it switches from slow start to linear growth.
+  uint32_t congestion_window_;
+  uint32_t slow_start_threshold_;
   uint32_t window_end_offset_;
+
+  // While has_hole(), the data in [offset_, hole_end_offset_) is missing and
+  // the data in [hole_end_offset_, resume_offset_) has been received or sent.
+  // A receiver's writer is always at resume_offset_.
+  uint32_t hole_end_offset_;
+  uint32_t resume_offset_;
+
   // TODO(pwbug/584): Remove pending_bytes in favor of window_end_offset.
   uint32_t pending_bytes_;
   uint32_t max_chunk_size_bytes_;
@@ -316,6 +447,13 @@ class Context {
   // Timestamp at which the transfer will next time out, or kNoTimeout.
   chrono::SystemClock::time_point next_timeout_;
 
+  // With an adaptive timeout, when the current round trip started, or
+  // kNoTimeout, and the smoothed round-trip time and its variation. A zero
+  // smoothed_rtt_ means no round trip has been measured.
+  chrono::SystemClock::time_point round_trip_start_;
+  chrono::SystemClock::duration smoothed_rtt_;
+  chrono::SystemClock::duration rtt_variation_;
+
   RateEstimate transfer_rate_;
 };
 
@@ -52,6 +52,9 @@ enum class EventType {
   kAddTransferHandler,
   kRemoveTransferHandler,
 
+  // Does nothing. Used to wait for all earlier events to be processed.
+  kNoOp,
+
   // For testing only: aborts the transfer thread.
   kTerminate,
 };
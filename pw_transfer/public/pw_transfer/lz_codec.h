@@ -0,0 +1,49 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_transfer/codec.h"
+
+namespace pw::transfer {
+
+// A small LZ77 codec suited to text such as logs. It uses no memory other than
+// the input and output buffers, and searches for repeated data within the
+// previous 256 bytes of a chunk.
+//
+// Compressed data is a sequence of tokens, each starting with a byte T:
+//
+//   T < 0x80: A run of T + 1 literal bytes, which follow T.
+//   T >= 0x80: A copy of (T & 0x7f) + 3 bytes, starting D + 1 bytes back in the
+//              output, where D is the byte after T.
+//
+class LzCodec final : public Codec {
+ public:
+  static constexpr uint32_t kId = 1;
+
+  static constexpr size_t kMaxLiteralRun = 128;
+  static constexpr size_t kMinMatch = 3;
+  static constexpr size_t kMaxMatch = 0x7f + kMinMatch;
+  static constexpr size_t kMaxDistance = 256;
+
+  constexpr LzCodec() : Codec(kId) {}
+
+  StatusWithSize Compress(ConstByteSpan data, ByteSpan output) override;
+
+  StatusWithSize Decompress(ConstByteSpan data, ByteSpan output) override;
+};
+
+}  // namespace pw::transfer
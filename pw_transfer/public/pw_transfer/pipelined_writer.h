@@ -0,0 +1,112 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::transfer {
+
+// A stream::Writer that writes to another writer from its own thread. Writing
+// a transfer's data to slow storage, such as flash, then overlaps with
+// receiving the next window of data, instead of stalling the transfer thread.
+//
+// Data is copied into one half of a buffer. When that half is full, the
+// PipelinedWriter's thread writes it to the output while Write() calls fill the
+// other half. Write() blocks only when both halves are full.
+//
+// An error from the output is returned by the Write() or Flush() call that
+// follows it. Flush() must be called to write the data that is still buffered,
+// typically from a write handler's FinalizeWrite().
+//
+// The PipelinedWriter must be run in its own thread.
+class PipelinedWriter : public stream::NonSeekableWriter,
+                        public thread::ThreadCore {
+ public:
+  // Splits the buffer into two halves, each of which is written to the output
+  // with a single Write() call. The buffer size should be a multiple of twice
+  // the output's preferred write size, such as a flash page.
+  explicit PipelinedWriter(ByteSpan buffer);
+
+  PipelinedWriter(const PipelinedWriter&) = delete;
+  PipelinedWriter& operator=(const PipelinedWriter&) = delete;
+
+  // Sets the writer to which data is written and discards any data and errors
+  // from a previous output. Waits for a write in progress to finish.
+  void set_output(stream::Writer& output);
+
+  // Writes all buffered data to the output and waits for the writes to finish.
+  // Returns the first error from the output since it was set or last flushed.
+  Status Flush();
+
+  // Stops the thread once the write in progress, if any, finishes. Buffered
+  // data that was not flushed is discarded.
+  void Terminate();
+
+ private:
+  Status DoWrite(ConstByteSpan data) final;
+
+  // The output's write limit when it was set, less the data written since.
+  size_t ConservativeLimit(LimitType type) const final {
+    return type == LimitType::kWrite ? write_limit_ : 0;
+  }
+
+  void Run() final;
+
+  ByteSpan half(size_t index) const {
+    return buffer_.subspan(index * half_size(), half_size());
+  }
+  size_t half_size() const { return buffer_.size() / 2; }
+
+  // Hands the buffered data to the thread once it finishes the previous write,
+  // and switches Write() calls to the other half of the buffer.
+  Status SubmitBuffer();
+
+  ByteSpan buffer_;
+  stream::Writer* output_;
+  size_t write_limit_;
+
+  // The half of the buffer that Write() copies into, and how much it holds.
+  size_t active_half_;
+  size_t buffered_bytes_;
+
+  // Data for the thread to write. These, status_, and output_ may only be
+  // accessed while holding idle_, which the thread holds while writing.
+  ConstByteSpan pending_data_;
+  Status status_;
+  bool terminate_;
+
+  sync::BinarySemaphore write_requested_;
+  sync::BinarySemaphore idle_;
+};
+
+template <size_t kBufferSizeBytes>
+class PipelinedWriterBuffer : public PipelinedWriter {
+ public:
+  static_assert(kBufferSizeBytes >= 2 && kBufferSizeBytes % 2 == 0,
+                "The buffer is split into two halves");
+
+  PipelinedWriterBuffer() : PipelinedWriter(buffer_) {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+}  // namespace pw::transfer
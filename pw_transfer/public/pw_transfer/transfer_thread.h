@@ -13,18 +13,20 @@
 // the License.
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <span>
 
 #include "pw_assert/assert.h"
 #include "pw_chrono/system_clock.h"
+#include "pw_containers/blocking_mpmc_queue.h"
 #include "pw_function/function.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_rpc/raw/client_reader_writer.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_sync/binary_semaphore.h"
-#include "pw_sync/timed_thread_notification.h"
 #include "pw_thread/thread_core.h"
+#include "pw_transfer/codec.h"
 #include "pw_transfer/handler.h"
 #include "pw_transfer/internal/client_context.h"
 #include "pw_transfer/internal/context.h"
@@ -36,6 +38,11 @@ namespace internal {
 
 class TransferThread : public thread::ThreadCore {
  public:
+  // Maximum number of events waiting for the transfer thread. Chunks use all
+  // but one of them; the last is for other events.
+  static constexpr size_t kMaxQueuedEvents = 8;
+  static constexpr size_t kMaxQueuedChunks = kMaxQueuedEvents - 1;
+
   TransferThread(std::span<ClientContext> client_transfers,
                  std::span<ServerContext> server_transfers,
                  ByteSpan chunk_buffer,
@@ -43,7 +50,10 @@ class TransferThread : public thread::ThreadCore {
       : client_transfers_(client_transfers),
         server_transfers_(server_transfers),
         chunk_buffer_(chunk_buffer),
-        encode_buffer_(encode_buffer) {}
+        chunk_slot_count_(1),
+        encode_buffer_(encode_buffer),
+        codec_(nullptr),
+        stream_owner_(this) {}
 
   void StartClientTransfer(TransferType type,
                            uint32_t transfer_id,
@@ -113,15 +123,50 @@ class TransferThread : public thread::ThreadCore {
 
   size_t max_chunk_size() const { return chunk_buffer_.size(); }
 
+  // Shards transfers by transfer ID across this thread and the provided worker
+  // threads, so that independent transfers are processed in parallel. Each
+  // worker has its own transfer contexts and chunk and encode buffers, and runs
+  // in its own thread. Workers' chunk buffers must be at least as large as this
+  // thread's.
+  //
+  // Workers are not used directly: chunks, transfers, streams, and handlers are
+  // all passed to this thread, which routes them to the right worker. Must be
+  // called before the transfer threads are started.
+  void set_worker_threads(std::span<TransferThread* const> workers) {
+    workers_ = workers;
+    for (TransferThread* worker : workers_) {
+      worker->stream_owner_ = this;
+    }
+  }
+
+  // Compresses the data of this thread's transfers with the codec when the
+  // other end of a transfer supports it, and accepts data compressed with it.
+  // Chunk data is compressed and decompressed in codec_buffer, which must be at
+  // least as large as the chunk buffer. Worker threads each need their own
+  // codec and buffer. Must be called before any transfers are started.
+  void set_codec(Codec& codec, ByteSpan codec_buffer) {
+    codec_ = &codec;
+    codec_buffer_ = codec_buffer;
+  }
+
+  // Lets chunks queue up for the transfer thread. Without a chunk queue,
+  // receiving a chunk blocks the RPC thread until the transfer thread has
+  // processed the previous one. The buffer is split into max_chunk_size()
+  // slots, up to kMaxQueuedChunks - 1 of them; the chunk buffer is always the
+  // first slot. Worker threads each need their own buffer. Must be called
+  // before the transfer thread is started.
+  void set_chunk_queue_buffer(ByteSpan buffer) {
+    chunk_queue_buffer_ = buffer;
+    chunk_slot_count_ =
+        std::min(1 + buffer.size() / max_chunk_size(), kMaxQueuedChunks);
+  }
+
   // For testing only: terminates the transfer thread with a kTerminate event.
   void Terminate();
 
-  // For testing only: blocks until the next event can be acquired, which means
-  // a previously enqueued event has been processed.
-  void WaitUntilEventIsProcessed() {
-    next_event_ownership_.acquire();
-    next_event_ownership_.release();
-  }
+  // For testing only: blocks until all previously enqueued events have been
+  // processed.
+  void WaitUntilEventIsProcessed();
 
   // For testing only: simulates a timeout event for a client transfer.
   void SimulateClientTimeout(uint32_t transfer_id) {
@@ -175,8 +220,17 @@ class TransferThread : public thread::ThreadCore {
     return new_transfer;
   }
 
+  // Returns the thread that processes the transfer with the given ID.
+  TransferThread& thread_for_transfer(uint32_t transfer_id) {
+    const size_t index = transfer_id % (workers_.size() + 1);
+    return index == 0u ? *this : *workers_[index - 1];
+  }
+
   const ByteSpan& encode_buffer() const { return encode_buffer_; }
 
+  Codec* codec() const { return codec_; }
+  const ByteSpan& codec_buffer() const { return codec_buffer_; }
+
   void Run() final;
 
   void HandleTimeouts();
@@ -184,19 +238,44 @@ class TransferThread : public thread::ThreadCore {
   rpc::Writer& stream_for(TransferStream stream) {
     switch (stream) {
       case TransferStream::kClientRead:
-        return client_read_stream_;
+        return stream_owner_->client_read_stream_;
       case TransferStream::kClientWrite:
-        return client_write_stream_;
+        return stream_owner_->client_write_stream_;
       case TransferStream::kServerRead:
-        return server_read_stream_;
+        return stream_owner_->server_read_stream_;
       case TransferStream::kServerWrite:
-        return server_write_stream_;
+        return stream_owner_->server_write_stream_;
     }
     // An unknown TransferStream value was passed, which means this function
     // was passed an invalid enum value.
     PW_ASSERT(false);
   }
 
+  // Blocks until the staged control event, if any, has been processed.
+  void WaitForStagedEvent() {
+    staged_event_ownership_.acquire();
+    staged_event_ownership_.release();
+  }
+
+  // Queues an event that is not a chunk. These share one set of staging
+  // members, so only one can be queued at a time. The caller must hold
+  // staged_event_ownership_, which the transfer thread releases once the event
+  // has been processed.
+  void PostStagedEvent(const Event& event);
+
+  std::byte* chunk_slot(size_t index) const {
+    return index == 0u ? chunk_buffer_.data()
+                       : chunk_queue_buffer_.data() +
+                             (index - 1) * max_chunk_size();
+  }
+
+  size_t chunk_slot_index(const std::byte* data) const {
+    return data == chunk_buffer_.data()
+               ? 0u
+               : 1u + static_cast<size_t>(data - chunk_queue_buffer_.data()) /
+                          max_chunk_size();
+  }
+
   // Returns the earliest timeout among all active transfers, up to kMaxTimeout.
   chrono::SystemClock::time_point GetNextTransferTimeout() const;
 
@@ -221,10 +300,15 @@ class TransferThread : public thread::ThreadCore {
 
   void SendStatusChunk(const SendStatusChunkEvent& event);
 
-  sync::TimedThreadNotification event_notification_;
-  sync::BinarySemaphore next_event_ownership_;
+  // Events waiting for the transfer thread, in the order they were posted.
+  containers::BlockingMpmcQueue<Event, kMaxQueuedEvents> events_;
+
+  // Indices of chunk slots that are not holding a queued chunk.
+  containers::BlockingMpmcQueue<uint8_t, kMaxQueuedEvents> free_chunk_slots_;
+
+  // Held while a non-chunk event and its staged members below are in use.
+  sync::BinarySemaphore staged_event_ownership_;
 
-  Event next_event_;
   Function<void(Status)> staged_on_completion_;
   rpc::RawClientReaderWriter staged_client_stream_;
   rpc::RawServerReaderWriter staged_server_stream_;
@@ -240,12 +324,26 @@ class TransferThread : public thread::ThreadCore {
   // All registered transfer handlers.
   IntrusiveList<Handler> handlers_;
 
-  // Buffer in which chunk data is staged for CHUNK events.
+  // Buffers in which chunk data is staged for CHUNK events. The chunk buffer
+  // is the first slot; the optional chunk queue buffer holds the rest.
   ByteSpan chunk_buffer_;
+  ByteSpan chunk_queue_buffer_;
+  size_t chunk_slot_count_;
 
   // Buffer into which responses are encoded. Only ever used from within the
   // transfer thread, so no locking is required.
   ByteSpan encode_buffer_;
+
+  // Optional codec for transfer data, and the buffer it compresses into.
+  Codec* codec_;
+  ByteSpan codec_buffer_;
+
+  // Worker threads that transfers are sharded across, if any.
+  std::span<TransferThread* const> workers_;
+
+  // The thread that owns the RPC streams and transfer handlers. Workers write
+  // chunks to their owner's streams, which pw_rpc synchronizes.
+  TransferThread* stream_owner_;
 };
 
 }  // namespace internal
@@ -0,0 +1,439 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+// Measures read and write transfers between a client and a server, each with
+// its own transfer thread, connected by a simulated link. The link has a
+// configurable bandwidth, latency, MTU, and packet loss rate. For each
+// transfer, logs the time to complete, the goodput, and the fraction of the
+// data that was retransmitted.
+//
+// With no arguments, a set of typical links is measured. Otherwise, a single
+// link is measured:
+//
+//   transfer_benchmark BYTES_PER_SECOND LATENCY_MS MTU LOSS_PERCENT
+//
+// A bandwidth of 0 is unlimited.
+
+#define PW_LOG_MODULE_NAME "TRANSFER"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_function/function.h"
+#include "pw_log/log.h"
+#include "pw_random/xor_shift.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/client.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/thread_core.h"
+#include "pw_thread_stl/options.h"
+#include "pw_transfer/client.h"
+#include "pw_transfer/handler.h"
+#include "pw_transfer/transfer.h"
+#include "pw_transfer/transfer_thread.h"
+
+namespace pw::transfer {
+namespace {
+
+using chrono::SystemClock;
+using namespace std::chrono_literals;
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kTransferId = 7;
+
+constexpr size_t kTransferSizeBytes = 8192;
+constexpr size_t kChunkBufferSizeBytes = 1024;
+constexpr uint32_t kMaxPendingBytes = 2048;
+constexpr auto kChunkTimeout = 250ms;
+constexpr auto kTransferTimeout = 60s;
+
+struct LinkConfig {
+  const char* name;
+  uint32_t bytes_per_second;  // 0 is unlimited
+  std::chrono::microseconds latency;
+  size_t mtu;
+  uint32_t loss_percent;
+};
+
+constexpr LinkConfig kLinks[] = {
+    {"loopback", 0, 0ms, 1024, 0},
+    {"uart", 11520, 1ms, 256, 0},
+    {"uart_lossy", 11520, 1ms, 256, 2},
+    {"radio", 32000, 20ms, 128, 5},
+};
+
+// One direction of a simulated link. A packet arrives after the time it takes
+// to send it and the packets ahead of it at the link's bandwidth, plus the
+// link's latency. The link's thread then passes it to the receiver. Packets
+// are dropped at random at the link's loss rate.
+class SimulatedLink final : public rpc::ChannelOutput,
+                            public thread::ThreadCore {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  SimulatedLink(const char* name, const LinkConfig& config, uint64_t seed)
+      : rpc::ChannelOutput(name),
+        config_(config),
+        rng_(seed),
+        link_free_(Clock::now()),
+        stopped_(false),
+        packets_(0),
+        dropped_packets_(0) {}
+
+  void set_receiver(Function<void(ConstByteSpan)>&& receiver) {
+    receiver_ = std::move(receiver);
+  }
+
+  size_t MaximumTransmissionUnit() override { return config_.mtu; }
+
+  Status Send(std::span<const std::byte> buffer) override {
+    std::lock_guard lock(mutex_);
+    packets_ += 1;
+
+    // A lost packet still takes up the link while it is sent.
+    Clock::time_point sent = std::max(Clock::now(), link_free_);
+    if (config_.bytes_per_second != 0u) {
+      sent += std::chrono::microseconds(uint64_t(buffer.size()) * 1'000'000u /
+                                        config_.bytes_per_second);
+    }
+    link_free_ = sent;
+
+    uint32_t random = 0;
+    rng_.GetInt(random).IgnoreError();
+    if (buffer.size() > config_.mtu || random % 100 < config_.loss_percent) {
+      dropped_packets_ += 1;
+      return OkStatus();
+    }
+
+    in_flight_.push_back(
+        Packet{sent + config_.latency,
+               std::vector<std::byte>(buffer.begin(), buffer.end())});
+    ready_.notify_one();
+    return OkStatus();
+  }
+
+  void Stop() {
+    std::lock_guard lock(mutex_);
+    stopped_ = true;
+    ready_.notify_one();
+  }
+
+  size_t packets() const { return packets_; }
+  size_t dropped_packets() const { return dropped_packets_; }
+
+ private:
+  struct Packet {
+    Clock::time_point arrival;
+    std::vector<std::byte> data;
+  };
+
+  void Run() override {
+    std::unique_lock lock(mutex_);
+    while (!stopped_) {
+      if (in_flight_.empty()) {
+        ready_.wait(lock);
+        continue;
+      }
+      if (Clock::now() < in_flight_.front().arrival) {
+        ready_.wait_until(lock, in_flight_.front().arrival);
+        continue;
+      }
+
+      Packet packet = std::move(in_flight_.front());
+      in_flight_.pop_front();
+
+      // The receiver sends packets on the other link, or on this one, so it
+      // must not be called with the lock held.
+      lock.unlock();
+      receiver_(std::as_bytes(std::span(packet.data)));
+      lock.lock();
+    }
+  }
+
+  const LinkConfig config_;
+  random::XorShiftStarRng64 rng_;
+  Function<void(ConstByteSpan)> receiver_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<Packet> in_flight_;
+  Clock::time_point link_free_;
+  bool stopped_;
+
+  size_t packets_;
+  size_t dropped_packets_;
+};
+
+// Reads from a buffer and counts every byte read, including bytes that are
+// read again after seeking back to retransmit them.
+class CountingReader final : public stream::SeekableReader {
+ public:
+  CountingReader(ConstByteSpan data) : reader_(data), bytes_read_(0) {}
+
+  size_t bytes_read() const { return bytes_read_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    Result<ByteSpan> result = reader_.Read(destination);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    bytes_read_ += result.value().size();
+    return StatusWithSize(result.value().size());
+  }
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return reader_.Seek(offset, origin);
+  }
+
+  size_t DoTell() const override { return reader_.Tell(); }
+
+  size_t ConservativeLimit(LimitType limit_type) const override {
+    return limit_type == LimitType::kRead ? reader_.ConservativeReadLimit()
+                                          : 0;
+  }
+
+  stream::MemoryReader reader_;
+  size_t bytes_read_;
+};
+
+std::array<std::byte, kTransferSizeBytes> source_data;
+std::array<std::byte, kTransferSizeBytes> destination_data;
+
+// A client and a server, each with a transfer thread, connected by a pair of
+// simulated links.
+class Benchmark {
+ public:
+  Benchmark(const LinkConfig& link)
+      : link_(link),
+        client_to_server_("client_to_server", link, 1),
+        server_to_client_("server_to_client", link, 2),
+        client_channels_{
+            rpc::Channel::Create<kChannelId>(&client_to_server_)},
+        server_channels_{
+            rpc::Channel::Create<kChannelId>(&server_to_client_)},
+        rpc_client_(client_channels_),
+        rpc_server_(server_channels_),
+        client_transfer_thread_(client_chunk_buffer_, client_encode_buffer_),
+        server_transfer_thread_(server_chunk_buffer_, server_encode_buffer_),
+        service_(server_transfer_thread_,
+                 kMaxPendingBytes,
+                 SystemClock::for_at_least(kChunkTimeout)),
+        client_(rpc_client_,
+                kChannelId,
+                client_transfer_thread_,
+                kMaxPendingBytes) {
+    rpc_server_.RegisterService(service_);
+    client_to_server_.set_receiver([this](ConstByteSpan packet) {
+      rpc_server_.ProcessPacket(packet).IgnoreError();
+    });
+    server_to_client_.set_receiver([this](ConstByteSpan packet) {
+      rpc_client_.ProcessPacket(packet).IgnoreError();
+    });
+
+    threads_[0] = thread::Thread(options_, client_to_server_);
+    threads_[1] = thread::Thread(options_, server_to_client_);
+    threads_[2] = thread::Thread(options_, client_transfer_thread_);
+    threads_[3] = thread::Thread(options_, server_transfer_thread_);
+  }
+
+  ~Benchmark() {
+    client_transfer_thread_.Terminate();
+    server_transfer_thread_.Terminate();
+    client_to_server_.Stop();
+    server_to_client_.Stop();
+    for (thread::Thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Reads from the server to the client.
+  void Read() {
+    destination_data = {};
+    CountingReader source(source_data);
+    ReadOnlyHandler handler(kTransferId, source);
+    service_.RegisterHandler(handler);
+
+    stream::MemoryWriter destination(destination_data);
+    const SystemClock::time_point start = SystemClock::now();
+    const Status started =
+        client_.Read(kTransferId,
+                     destination,
+                     OnCompletion(),
+                     SystemClock::for_at_least(kChunkTimeout));
+    Finish("read", started, start, source);
+
+    service_.UnregisterHandler(handler);
+  }
+
+  // Writes from the client to the server.
+  void Write() {
+    destination_data = {};
+    stream::MemoryWriter destination(destination_data);
+    WriteOnlyHandler handler(kTransferId, destination);
+    service_.RegisterHandler(handler);
+
+    CountingReader source(source_data);
+    const SystemClock::time_point start = SystemClock::now();
+    const Status started =
+        client_.Write(kTransferId,
+                      source,
+                      OnCompletion(),
+                      SystemClock::for_at_least(kChunkTimeout));
+    Finish("write", started, start, source);
+
+    service_.UnregisterHandler(handler);
+  }
+
+ private:
+  Client::CompletionFunc OnCompletion() {
+    return [this](Status status) {
+      status_ = status;
+      completed_.release();
+    };
+  }
+
+  void Finish(const char* direction,
+              Status started,
+              SystemClock::time_point start,
+              const CountingReader& source) {
+    if (!started.ok()) {
+      PW_LOG_ERROR("%s %s: failed to start with %s",
+                   link_.name,
+                   direction,
+                   started.str());
+      return;
+    }
+    if (!completed_.try_acquire_for(
+            SystemClock::for_at_least(kTransferTimeout))) {
+      PW_LOG_ERROR("%s %s: timed out", link_.name, direction);
+      return;
+    }
+    const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                            SystemClock::now() - start)
+                            .count();
+    if (!status_.ok()) {
+      PW_LOG_ERROR("%s %s: failed with %s after %u ms",
+                   link_.name,
+                   direction,
+                   status_.str(),
+                   static_cast<unsigned>(us / 1000));
+      return;
+    }
+
+    if (!std::equal(
+            source_data.begin(), source_data.end(), destination_data.begin())) {
+      PW_LOG_ERROR("%s %s: the data does not match", link_.name, direction);
+      return;
+    }
+
+    const size_t bytes_transmitted = source.bytes_read();
+    const uint64_t goodput =
+        us == 0u ? 0u : uint64_t(kTransferSizeBytes) * 1'000'000u / us;
+    const uint64_t retransmitted =
+        bytes_transmitted > kTransferSizeBytes
+            ? (bytes_transmitted - kTransferSizeBytes) * 10'000u /
+                  kTransferSizeBytes
+            : 0u;
+    PW_LOG_INFO(
+        "%-10s %-5s %6u ms %8u B/s goodput %3u.%02u%% retransmitted "
+        "%4u/%4u packets dropped",
+        link_.name,
+        direction,
+        static_cast<unsigned>(us / 1000),
+        static_cast<unsigned>(goodput),
+        static_cast<unsigned>(retransmitted / 100),
+        static_cast<unsigned>(retransmitted % 100),
+        static_cast<unsigned>(client_to_server_.dropped_packets() +
+                              server_to_client_.dropped_packets()),
+        static_cast<unsigned>(client_to_server_.packets() +
+                              server_to_client_.packets()));
+  }
+
+  const LinkConfig& link_;
+
+  SimulatedLink client_to_server_;
+  SimulatedLink server_to_client_;
+  rpc::Channel client_channels_[1];
+  rpc::Channel server_channels_[1];
+  rpc::Client rpc_client_;
+  rpc::Server rpc_server_;
+
+  std::array<std::byte, kChunkBufferSizeBytes> client_chunk_buffer_;
+  std::array<std::byte, kChunkBufferSizeBytes> client_encode_buffer_;
+  std::array<std::byte, kChunkBufferSizeBytes> server_chunk_buffer_;
+  std::array<std::byte, kChunkBufferSizeBytes> server_encode_buffer_;
+  transfer::Thread<1, 1> client_transfer_thread_;
+  transfer::Thread<1, 1> server_transfer_thread_;
+
+  TransferService service_;
+  Client client_;
+
+  Status status_;
+  sync::BinarySemaphore completed_;
+
+  thread::stl::Options options_;
+  thread::Thread threads_[4];
+};
+
+void Measure(const LinkConfig& link) {
+  // Use a new client and server for each transfer, so that one transfer's
+  // packet counts and lingering retries do not affect the next.
+  Benchmark(link).Read();
+  Benchmark(link).Write();
+}
+
+}  // namespace
+}  // namespace pw::transfer
+
+int main(int argc, char* argv[]) {
+  for (size_t i = 0; i < pw::transfer::source_data.size(); ++i) {
+    pw::transfer::source_data[i] = std::byte(i * 7 + (i >> 8));
+  }
+
+  if (argc == 1) {
+    for (const pw::transfer::LinkConfig& link : pw::transfer::kLinks) {
+      pw::transfer::Measure(link);
+    }
+    return 0;
+  }
+
+  if (argc != 5) {
+    PW_LOG_ERROR("Usage: %s [BYTES_PER_SECOND LATENCY_MS MTU LOSS_PERCENT]",
+                 argv[0]);
+    return 1;
+  }
+
+  const pw::transfer::LinkConfig link = {
+      "custom",
+      static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)),
+      std::chrono::milliseconds(std::strtoul(argv[2], nullptr, 10)),
+      std::strtoul(argv[3], nullptr, 10),
+      static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)),
+  };
+  pw::transfer::Measure(link);
+  return 0;
+}
@@ -20,6 +20,7 @@
 #include "pw_rpc/thread_testing.h"
 #include "pw_thread/thread.h"
 #include "pw_thread_stl/options.h"
+#include "pw_transfer/lz_codec.h"
 #include "pw_transfer/transfer.pwpb.h"
 #include "pw_transfer_private/chunk_testing.h"
 
@@ -397,6 +398,41 @@ TEST_F(ReadTransfer, OutOfOrder_SeekingNotSupported_EndsWithUnimplemented) {
   EXPECT_EQ(chunk.status, Status::Unimplemented());
 }
 
+TEST_F(ReadTransfer, SelectiveRetransmit_SendsMissingDataThenResumes) {
+  rpc::test::WaitForPackets(ctx_.output(), 3, [this] {
+    ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                       .window_end_offset = 24,
+                                       .pending_bytes = 24,
+                                       .max_chunk_size_bytes = 8,
+                                       .offset = 0,
+                                       .type = Chunk::Type::kTransferStart}));
+  });
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  // The receiver is missing [8, 16) and has room for data up to offset 32.
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk(
+        {.transfer_id = 3,
+         .window_end_offset = 32,
+         .pending_bytes = 8,
+         .max_chunk_size_bytes = 8,
+         .offset = 8,
+         .type = Chunk::Type::kParametersSelectiveRetransmit}));
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 5u);
+  Chunk c3 = DecodeChunk(ctx_.responses()[3]);
+  Chunk c4 = DecodeChunk(ctx_.responses()[4]);
+
+  EXPECT_EQ(c3.offset, 8u);
+  ASSERT_EQ(c3.data.size(), 8u);
+  EXPECT_EQ(std::memcmp(c3.data.data(), kData.data() + 8, c3.data.size()), 0);
+
+  EXPECT_EQ(c4.offset, 24u);
+  ASSERT_EQ(c4.data.size(), 8u);
+  EXPECT_EQ(std::memcmp(c4.data.data(), kData.data() + 24, c4.data.size()), 0);
+}
+
 TEST_F(ReadTransfer, MaxChunkSize_Client) {
   rpc::test::WaitForPackets(ctx_.output(), 5, [this] {
     ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
@@ -1240,6 +1276,90 @@ TEST_F(WriteTransfer, UnexpectedOffset) {
   EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
 }
 
+TEST_F(WriteTransfer, SelectiveRetransmit_RequestsOnlyMissingData) {
+  ctx_.service().set_selective_retransmit(true);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+
+  ctx_.SendClientStream<64>(EncodeChunk(
+      {.transfer_id = 7, .offset = 0, .data = std::span(kData).first(8)}));
+  ctx_.SendClientStream<64>(
+      EncodeChunk({.transfer_id = 7,
+                   .offset = 16,
+                   .data = std::span(kData).subspan(16, 8)}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(chunk.type, Chunk::Type::kParametersSelectiveRetransmit);
+  EXPECT_EQ(chunk.offset, 8u);
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), 8u);
+  EXPECT_EQ(chunk.window_end_offset, 32u);
+
+  // Data after the missing range is still accepted.
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 24,
+                                         .data = std::span(kData).subspan(24),
+                                         .remaining_bytes = 0}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  EXPECT_FALSE(handler_.finalize_write_called);
+
+  ctx_.SendClientStream<64>(EncodeChunk(
+      {.transfer_id = 7, .offset = 8, .data = std::span(kData).subspan(8, 8)}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  chunk = DecodeChunk(ctx_.responses()[2]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), OkStatus());
+
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(handler_.finalize_write_status, OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(WriteTransfer, SelectiveRetransmit_SecondGapRetransmitsEverything) {
+  ctx_.service().set_selective_retransmit(true);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ctx_.SendClientStream<64>(EncodeChunk(
+      {.transfer_id = 7, .offset = 0, .data = std::span(kData).first(8)}));
+  ctx_.SendClientStream<64>(
+      EncodeChunk({.transfer_id = 7,
+                   .offset = 16,
+                   .data = std::span(kData).subspan(16, 8)}));
+  ctx_.SendClientStream<64>(EncodeChunk(
+      {.transfer_id = 7, .offset = 28, .data = std::span(kData).subspan(28)}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[2]);
+  EXPECT_EQ(chunk.type, Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset, 8u);
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), 24u);
+
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 8,
+                                         .data = std::span(kData).subspan(8),
+                                         .remaining_bytes = 0}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  chunk = DecodeChunk(ctx_.responses()[3]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
 TEST_F(WriteTransferMaxBytes16, TooMuchData) {
   ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
   transfer_thread_.WaitUntilEventIsProcessed();
@@ -1541,6 +1661,340 @@ TEST_F(WriteTransferMaxBytes16, Service_SetMaxPendingBytes) {
   EXPECT_EQ(chunk.pending_bytes.value(), 12u);
 }
 
+constexpr auto kCompressibleData =
+    bytes::Initialized<32>([](size_t i) { return i % 4; });
+
+class CompressedReadTransfer : public ::testing::Test {
+ protected:
+  CompressedReadTransfer()
+      : handler_(3, kCompressibleData),
+        transfer_thread_(data_buffer_, encode_buffer_),
+        ctx_(transfer_thread_, 64),
+        system_thread_(TransferThreadOptions(), transfer_thread_) {
+    transfer_thread_.set_codec(codec_, codec_buffer_);
+    ctx_.service().RegisterHandler(handler_);
+
+    ctx_.call();  // Open the read stream
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  ~CompressedReadTransfer() {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+  SimpleReadTransfer handler_;
+  LzCodec codec_;
+  Thread<1, 1> transfer_thread_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+  thread::Thread system_thread_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 64> codec_buffer_;
+};
+
+TEST_F(CompressedReadTransfer, CompressesDataIfClientSupportsCodec) {
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                       .window_end_offset = 64,
+                                       .pending_bytes = 64,
+                                       .offset = 0,
+                                       .type = Chunk::Type::kTransferStart,
+                                       .compression = LzCodec::kId}));
+
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+
+  EXPECT_EQ(c0.offset, 0u);
+  ASSERT_TRUE(c0.compression.has_value());
+  EXPECT_EQ(c0.compression.value(), LzCodec::kId);
+  EXPECT_LT(c0.data.size(), kCompressibleData.size());
+
+  std::array<std::byte, 64> decompressed;
+  StatusWithSize result = codec_.Decompress(c0.data, decompressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(result.size(), kCompressibleData.size());
+  EXPECT_EQ(std::memcmp(decompressed.data(),
+                        kCompressibleData.data(),
+                        kCompressibleData.size()),
+            0);
+
+  // Offsets refer to the uncompressed data.
+  EXPECT_EQ(c1.offset, kCompressibleData.size());
+  ASSERT_TRUE(c1.remaining_bytes.has_value());
+  EXPECT_EQ(c1.remaining_bytes.value(), 0u);
+}
+
+TEST_F(CompressedReadTransfer, SendsUncompressedDataIfClientDoesNotSupportIt) {
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                       .window_end_offset = 64,
+                                       .pending_bytes = 64,
+                                       .offset = 0,
+                                       .type = Chunk::Type::kTransferStart}));
+
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_FALSE(c0.compression.has_value());
+  ASSERT_EQ(c0.data.size(), kCompressibleData.size());
+  EXPECT_EQ(std::memcmp(c0.data.data(),
+                        kCompressibleData.data(),
+                        kCompressibleData.size()),
+            0);
+}
+
+class MemoryMappedReadTransfer : public ::testing::Test {
+ protected:
+  MemoryMappedReadTransfer()
+      : handler_(3, kData),
+        compressible_handler_(4, kCompressibleData),
+        transfer_thread_(data_buffer_, encode_buffer_),
+        ctx_(transfer_thread_, 64),
+        system_thread_(TransferThreadOptions(), transfer_thread_) {
+    transfer_thread_.set_codec(codec_, codec_buffer_);
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.service().RegisterHandler(compressible_handler_);
+
+    ctx_.call();  // Open the read stream
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  ~MemoryMappedReadTransfer() {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+  MemoryMappedReadHandler handler_;
+  MemoryMappedReadHandler compressible_handler_;
+  LzCodec codec_;
+  Thread<1, 1> transfer_thread_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+  thread::Thread system_thread_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 64> codec_buffer_;
+};
+
+TEST_F(MemoryMappedReadTransfer, MultiChunk) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .window_end_offset = 16,
+                                     .pending_bytes = 16,
+                                     .offset = 0,
+                                     .type = Chunk::Type::kTransferStart}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(c0.offset, 0u);
+  ASSERT_EQ(c0.data.size(), 16u);
+  EXPECT_EQ(std::memcmp(c0.data.data(), kData.data(), c0.data.size()), 0);
+
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(
+        EncodeChunk({.transfer_id = 3,
+                     .window_end_offset = 64,
+                     .pending_bytes = 48,
+                     .offset = 16,
+                     .type = Chunk::Type::kParametersContinue}));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(c1.offset, 16u);
+  ASSERT_EQ(c1.data.size(), 16u);
+  EXPECT_EQ(std::memcmp(c1.data.data(), kData.data() + 16, c1.data.size()), 0);
+
+  Chunk c2 = DecodeChunk(ctx_.responses()[2]);
+  EXPECT_EQ(c2.data.size(), 0u);
+  ASSERT_TRUE(c2.remaining_bytes.has_value());
+  EXPECT_EQ(c2.remaining_bytes.value(), 0u);
+}
+
+TEST_F(MemoryMappedReadTransfer, OutOfOrder_SeeksWithinData) {
+  rpc::test::WaitForPackets(ctx_.output(), 3, [this] {
+    ctx_.SendClientStream(
+        EncodeChunk({.transfer_id = 3, .pending_bytes = 16, .offset = 0}));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    ctx_.SendClientStream(
+        EncodeChunk({.transfer_id = 3, .pending_bytes = 8, .offset = 2}));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    ctx_.SendClientStream(
+        EncodeChunk({.transfer_id = 3, .pending_bytes = 8, .offset = 20}));
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(chunk.offset, 2u);
+  EXPECT_TRUE(std::equal(
+      &kData[2], &kData[10], chunk.data.begin(), chunk.data.end()));
+
+  chunk = DecodeChunk(ctx_.responses()[2]);
+  EXPECT_EQ(chunk.offset, 20u);
+  EXPECT_TRUE(std::equal(
+      &kData[20], &kData[28], chunk.data.begin(), chunk.data.end()));
+}
+
+TEST_F(MemoryMappedReadTransfer, RestartedTransferStartsFromBeginning) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 8,
+                                     .offset = 0,
+                                     .type = Chunk::Type::kTransferStart}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 8,
+                                     .offset = 0,
+                                     .type = Chunk::Type::kTransferStart}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(chunk.offset, 0u);
+  EXPECT_TRUE(
+      std::equal(&kData[0], &kData[8], chunk.data.begin(), chunk.data.end()));
+}
+
+TEST_F(MemoryMappedReadTransfer, CompressesData) {
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk({.transfer_id = 4,
+                                       .window_end_offset = 64,
+                                       .pending_bytes = 64,
+                                       .offset = 0,
+                                       .type = Chunk::Type::kTransferStart,
+                                       .compression = LzCodec::kId}));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  ASSERT_TRUE(c0.compression.has_value());
+  EXPECT_LT(c0.data.size(), kCompressibleData.size());
+
+  std::array<std::byte, 64> decompressed;
+  StatusWithSize result = codec_.Decompress(c0.data, decompressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(result.size(), kCompressibleData.size());
+  EXPECT_EQ(std::memcmp(decompressed.data(),
+                        kCompressibleData.data(),
+                        kCompressibleData.size()),
+            0);
+}
+
+class CompressedWriteTransfer : public ::testing::Test {
+ protected:
+  CompressedWriteTransfer()
+      : buffer{},
+        handler_(7, buffer),
+        transfer_thread_(data_buffer_, encode_buffer_),
+        system_thread_(TransferThreadOptions(), transfer_thread_),
+        ctx_(transfer_thread_, 64, std::chrono::minutes(1)) {
+    transfer_thread_.set_codec(codec_, codec_buffer_);
+    ctx_.service().RegisterHandler(handler_);
+
+    ctx_.call();  // Open the write stream
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  ~CompressedWriteTransfer() {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+  std::array<std::byte, kCompressibleData.size()> buffer;
+  SimpleWriteTransfer handler_;
+  LzCodec codec_;
+
+  Thread<1, 1> transfer_thread_;
+  thread::Thread system_thread_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 64> codec_buffer_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Write) ctx_;
+};
+
+TEST_F(CompressedWriteTransfer, DecompressesData) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  ASSERT_TRUE(chunk.compression.has_value());
+  EXPECT_EQ(chunk.compression.value(), LzCodec::kId);
+
+  std::array<std::byte, 64> compressed;
+  StatusWithSize result = codec_.Compress(kCompressibleData, compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk({.transfer_id = 7,
+                   .offset = 0,
+                   .data = std::span(compressed).first(result.size()),
+                   .remaining_bytes = 0,
+                   .compression = LzCodec::kId}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), OkStatus());
+
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(handler_.finalize_write_status, OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(),
+                        kCompressibleData.data(),
+                        kCompressibleData.size()),
+            0);
+}
+
+TEST_F(CompressedWriteTransfer, MalformedCompressedData_AbortsWithDataLoss) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // A copy from before the start of the data.
+  constexpr auto kMalformed = bytes::Array<0x80, 0x10>();
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 0,
+                                         .data = kMalformed,
+                                         .compression = LzCodec::kId}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), Status::DataLoss());
+  EXPECT_TRUE(handler_.finalize_write_called);
+}
+
+TEST_F(WriteTransfer, CompressedDataWithoutCodec_AbortsWithUnimplemented) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The server does not advertise a codec.
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  EXPECT_FALSE(DecodeChunk(ctx_.responses()[0]).compression.has_value());
+
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 0,
+                                         .data = std::span(kData).first(8),
+                                         .compression = LzCodec::kId}));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), Status::Unimplemented());
+}
+
 PW_MODIFY_DIAGNOSTICS_POP();
 
 }  // namespace
@@ -26,38 +26,62 @@ PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 namespace pw::transfer::internal {
 
 void TransferThread::Terminate() {
-  next_event_ownership_.acquire();
-  next_event_.type = EventType::kTerminate;
-  event_notification_.release();
+  staged_event_ownership_.acquire();
+  PostStagedEvent({.type = EventType::kTerminate});
+}
+
+void TransferThread::WaitUntilEventIsProcessed() {
+  // Events are processed in order, so once a no-op event posted now has been
+  // processed, so has everything before it.
+  staged_event_ownership_.acquire();
+  PostStagedEvent({.type = EventType::kNoOp});
+  WaitForStagedEvent();
 }
 
 void TransferThread::SimulateTimeout(EventType type, uint32_t transfer_id) {
-  next_event_ownership_.acquire();
+  TransferThread& thread = thread_for_transfer(transfer_id);
+  thread.staged_event_ownership_.acquire();
 
-  next_event_.type = type;
-  next_event_.chunk = {};
-  next_event_.chunk.transfer_id = transfer_id;
+  Event event = {.type = type};
+  event.chunk = {};
+  event.chunk.transfer_id = transfer_id;
+  thread.PostStagedEvent(event);
 
-  event_notification_.release();
+  thread.WaitUntilEventIsProcessed();
+}
 
-  WaitUntilEventIsProcessed();
+void TransferThread::PostStagedEvent(const Event& event) {
+  // At most one staged event and kMaxQueuedChunks chunks are queued at once,
+  // so the queue cannot be full.
+  PW_CHECK(events_.try_push(event));
 }
 
 void TransferThread::Run() {
-  // Next event starts freed.
-  next_event_ownership_.release();
+  // The staging members and all chunk slots start freed.
+  staged_event_ownership_.release();
+  for (size_t i = 0; i < chunk_slot_count_; ++i) {
+    PW_CHECK(free_chunk_slots_.try_push(static_cast<uint8_t>(i)));
+  }
 
   while (true) {
-    if (event_notification_.try_acquire_until(GetNextTransferTimeout())) {
-      if (next_event_.type == EventType::kTerminate) {
+    if (std::optional<Event> event =
+            events_.try_pop_until(GetNextTransferTimeout());
+        event.has_value()) {
+      if (event->type == EventType::kTerminate) {
         return;
       }
 
-      HandleEvent(next_event_);
+      HandleEvent(*event);
 
-      // Finished processing the event. Allow the next_event struct to be
-      // overwritten.
-      next_event_ownership_.release();
+      // Finished processing the event. Free the chunk slot or staging members
+      // it used so they can be reused.
+      if (event->type == EventType::kClientChunk ||
+          event->type == EventType::kServerChunk) {
+        PW_CHECK(free_chunk_slots_.try_push(
+            static_cast<uint8_t>(chunk_slot_index(event->chunk.data))));
+      } else {
+        staged_event_ownership_.release();
+      }
     }
 
     // Regardless of whether an event was received or not, check for any
@@ -103,31 +127,40 @@ void TransferThread::StartTransfer(TransferType type,
                                    Function<void(Status)>&& on_completion,
                                    chrono::SystemClock::duration timeout,
                                    uint8_t max_retries) {
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  TransferThread& thread = thread_for_transfer(transfer_id);
+
+  // Handlers and streams are updated by this thread. Finish any pending update
+  // before a worker starts a transfer that uses them.
+  if (&thread != this) {
+    WaitForStagedEvent();
+  }
+
+  // Block until the last staged event has been processed.
+  thread.staged_event_ownership_.acquire();
 
   bool is_client_transfer = stream != nullptr;
+  Event event;
 
-  next_event_.type = is_client_transfer ? EventType::kNewClientTransfer
-                                        : EventType::kNewServerTransfer;
-  next_event_.new_transfer = {
+  event.type = is_client_transfer ? EventType::kNewClientTransfer
+                                  : EventType::kNewServerTransfer;
+  event.new_transfer = {
       .type = type,
       .transfer_id = transfer_id,
       .handler_id = handler_id,
       .max_parameters = &max_parameters,
       .timeout = timeout,
       .max_retries = max_retries,
-      .transfer_thread = this,
+      .transfer_thread = &thread,
   };
 
-  staged_on_completion_ = std::move(on_completion);
+  thread.staged_on_completion_ = std::move(on_completion);
 
   // The transfer is initialized with either a stream (client-side) or a handler
   // (server-side). If no stream is provided, try to find a registered handler
   // with the specified ID.
   if (is_client_transfer) {
-    next_event_.new_transfer.stream = stream;
-    next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
+    event.new_transfer.stream = stream;
+    event.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
         type == TransferType::kTransmit ? client_write_stream_
                                         : client_read_stream_);
   } else {
@@ -135,14 +168,14 @@ void TransferThread::StartTransfer(TransferType type,
                                 handlers_.end(),
                                 [&](auto& h) { return h.id() == handler_id; });
     if (handler != handlers_.end()) {
-      next_event_.new_transfer.handler = &*handler;
-      next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
+      event.new_transfer.handler = &*handler;
+      event.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
           type == TransferType::kTransmit ? server_read_stream_
                                           : server_write_stream_);
     } else {
       // No handler exists for the transfer: return a NOT_FOUND.
-      next_event_.type = EventType::kSendStatusChunk;
-      next_event_.send_status_chunk = {
+      event.type = EventType::kSendStatusChunk;
+      event.send_status_chunk = {
           .transfer_id = transfer_id,
           .status = Status::NotFound().code(),
           .stream = type == TransferType::kTransmit
@@ -152,74 +185,78 @@ void TransferThread::StartTransfer(TransferType type,
     }
   }
 
-  event_notification_.release();
+  thread.PostStagedEvent(event);
 }
 
 void TransferThread::ProcessChunk(EventType type, ConstByteSpan chunk) {
-  // If this assert is hit, there is a bug in the transfer implementation.
-  // Contexts' max_chunk_size_bytes fields should be set based on the size of
-  // chunk_buffer_.
-  PW_CHECK(chunk.size() <= chunk_buffer_.size(),
-           "Transfer received a larger chunk than it can handle.");
-
   Result<uint32_t> transfer_id = ExtractTransferId(chunk);
   if (!transfer_id.ok()) {
     PW_LOG_ERROR("Received a malformed chunk without a transfer ID");
     return;
   }
 
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  TransferThread& thread = thread_for_transfer(*transfer_id);
+
+  // If this assert is hit, there is a bug in the transfer implementation.
+  // Contexts' max_chunk_size_bytes fields should be set based on the size of
+  // chunk_buffer_.
+  PW_CHECK(chunk.size() <= thread.chunk_buffer_.size(),
+           "Transfer received a larger chunk than it can handle.");
 
-  std::memcpy(chunk_buffer_.data(), chunk.data(), chunk.size());
+  // Block until a chunk slot is free. With a chunk queue, several chunks can
+  // be handed off before the transfer thread gets to them.
+  std::byte* const slot = thread.chunk_slot(thread.free_chunk_slots_.pop());
+  std::memcpy(slot, chunk.data(), chunk.size());
 
-  next_event_.type = type;
-  next_event_.chunk = {
+  Event event = {.type = type};
+  event.chunk = {
       .transfer_id = *transfer_id,
-      .data = chunk_buffer_.data(),
+      .data = slot,
       .size = chunk.size(),
   };
 
-  event_notification_.release();
+  // Chunk events don't count against the staged event, and the free slots
+  // guarantee room in the queue.
+  PW_CHECK(thread.events_.try_push(event));
 }
 
 void TransferThread::SetClientStream(TransferStream type,
                                      rpc::RawClientReaderWriter& stream) {
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  // Block until the last staged event has been processed.
+  staged_event_ownership_.acquire();
 
-  next_event_.type = EventType::kSetTransferStream;
-  next_event_.set_transfer_stream = type;
+  Event event = {.type = EventType::kSetTransferStream};
+  event.set_transfer_stream = type;
   staged_client_stream_ = std::move(stream);
 
-  event_notification_.release();
+  PostStagedEvent(event);
 }
 
 void TransferThread::SetServerStream(TransferStream type,
                                      rpc::RawServerReaderWriter& stream) {
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  // Block until the last staged event has been processed.
+  staged_event_ownership_.acquire();
 
-  next_event_.type = EventType::kSetTransferStream;
-  next_event_.set_transfer_stream = type;
+  Event event = {.type = EventType::kSetTransferStream};
+  event.set_transfer_stream = type;
   staged_server_stream_ = std::move(stream);
 
-  event_notification_.release();
+  PostStagedEvent(event);
 }
 
 void TransferThread::TransferHandlerEvent(EventType type,
                                           internal::Handler& handler) {
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  // Block until the last staged event has been processed.
+  staged_event_ownership_.acquire();
 
-  next_event_.type = type;
+  Event event = {.type = type};
   if (type == EventType::kAddTransferHandler) {
-    next_event_.add_transfer_handler = &handler;
+    event.add_transfer_handler = &handler;
   } else {
-    next_event_.remove_transfer_handler = &handler;
+    event.remove_transfer_handler = &handler;
   }
 
-  event_notification_.release();
+  PostStagedEvent(event);
 }
 
 void TransferThread::HandleEvent(const internal::Event& event) {
@@ -256,6 +293,9 @@ void TransferThread::HandleEvent(const internal::Event& event) {
       handlers_.remove(*event.remove_transfer_handler);
       return;
 
+    case EventType::kNoOp:
+      return;
+
     default:
       // Other events are handled by individual transfer contexts.
       break;
@@ -300,7 +340,8 @@ void TransferThread::SendStatusChunk(
   chunk.transfer_id = event.transfer_id;
   chunk.status = event.status;
 
-  Result<ConstByteSpan> result = internal::EncodeChunk(chunk, chunk_buffer_);
+  // Queued chunks may occupy the chunk buffer, so encode into the encode buffer.
+  Result<ConstByteSpan> result = internal::EncodeChunk(chunk, encode_buffer_);
 
   if (!result.ok()) {
     PW_LOG_ERROR("Failed to encode final chunk for transfer %u",
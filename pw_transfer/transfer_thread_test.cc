@@ -212,6 +212,93 @@ TEST_F(TransferThreadTest, ProcessChunk_Malformed) {
   EXPECT_EQ(chunk.status.value(), Status::InvalidArgument());
 }
 
+class ShardedTransferThreadTest : public ::testing::Test {
+ public:
+  ShardedTransferThreadTest()
+      : ctx_(transfer_thread_, 512),
+        max_parameters_(chunk_buffer_.size(),
+                        chunk_buffer_.size(),
+                        cfg::kDefaultExtendWindowDivisor),
+        transfer_thread_(chunk_buffer_, encode_buffer_),
+        worker_thread_(worker_chunk_buffer_, worker_encode_buffer_),
+        workers_{&worker_thread_} {
+    transfer_thread_.set_worker_threads(workers_);
+    system_thread_ = thread::Thread(TransferThreadOptions(), transfer_thread_);
+    worker_system_thread_ =
+        thread::Thread(TransferThreadOptions(), worker_thread_);
+  }
+
+  ~ShardedTransferThreadTest() {
+    transfer_thread_.Terminate();
+    worker_thread_.Terminate();
+    system_thread_.join();
+    worker_system_thread_.join();
+  }
+
+ protected:
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+
+  std::array<std::byte, 64> chunk_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 64> worker_chunk_buffer_;
+  std::array<std::byte, 64> worker_encode_buffer_;
+
+  internal::TransferParameters max_parameters_;
+
+  // Each thread has one server context, so two transfers can only be active
+  // at once if they are processed by different threads.
+  transfer::Thread<1, 1> transfer_thread_;
+  transfer::Thread<1, 1> worker_thread_;
+  std::array<TransferThread*, 1> workers_;
+
+  thread::Thread system_thread_;
+  thread::Thread worker_system_thread_;
+};
+
+TEST_F(ShardedTransferThreadTest, ConcurrentTransfersOnDifferentThreads) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer);
+
+  // Transfer 2 is processed by the primary thread and 3 by the worker.
+  SimpleReadTransfer handler_2(2, kData);
+  SimpleReadTransfer handler_3(3, kData);
+  transfer_thread_.AddTransferHandler(handler_2);
+  transfer_thread_.AddTransferHandler(handler_3);
+
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    for (uint32_t id : {2u, 3u}) {
+      transfer_thread_.StartServerTransfer(internal::TransferType::kTransmit,
+                                           id,
+                                           id,
+                                           max_parameters_,
+                                           std::chrono::seconds(2),
+                                           0);
+      transfer_thread_.ProcessServerChunk(
+          EncodeChunk({.transfer_id = id,
+                       .window_end_offset = 8,
+                       .pending_bytes = 8,
+                       .max_chunk_size_bytes = 8,
+                       .offset = 0,
+                       .type = Chunk::Type::kParametersRetransmit}));
+    }
+  });
+
+  EXPECT_TRUE(handler_2.prepare_read_called);
+  EXPECT_TRUE(handler_3.prepare_read_called);
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  bool sent[2] = {};
+  for (ConstByteSpan response : ctx_.responses()) {
+    Chunk chunk = DecodeChunk(response);
+    ASSERT_TRUE(chunk.transfer_id == 2u || chunk.transfer_id == 3u);
+    sent[chunk.transfer_id - 2] = true;
+    EXPECT_EQ(chunk.offset, 0u);
+    EXPECT_EQ(chunk.data.size(), 8u);
+  }
+  EXPECT_TRUE(sent[0]);
+  EXPECT_TRUE(sent[1]);
+}
+
 PW_MODIFY_DIAGNOSTICS_POP();
 
 }  // namespace
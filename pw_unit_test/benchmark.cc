@@ -0,0 +1,72 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/benchmark.h"
+
+#include <algorithm>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::unit_test {
+namespace {
+
+SystemClockBenchmarkTimer default_timer;
+BenchmarkTimer* benchmark_timer = &default_timer;
+
+}  // namespace
+
+uint64_t SystemClockBenchmarkTimer::Now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          chrono::SystemClock::now().time_since_epoch())
+          .count());
+}
+
+void SetBenchmarkTimer(BenchmarkTimer* timer) {
+  benchmark_timer = timer != nullptr ? timer : &default_timer;
+}
+
+namespace internal {
+
+BenchmarkState::BenchmarkState(const char* name)
+    : name_(name),
+      timer_(*benchmark_timer),
+      min_duration_(timer_.TicksPerSecond() * config::kBenchmarkMinDurationUs /
+                    1'000'000),
+      iterations_(1),
+      start_(0) {}
+
+void BenchmarkState::StartBatch() { start_ = timer_.Now(); }
+
+bool BenchmarkState::FinishBatch() {
+  const uint64_t elapsed = timer_.Now() - start_;
+
+  if (elapsed >= min_duration_ ||
+      iterations_ >= config::kBenchmarkMaxIterations) {
+    Framework::Get().CurrentTestBenchmark(
+        BenchmarkResult{name_, iterations_, elapsed, timer_.units()});
+    return false;
+  }
+
+  // Grow quickly while far from the target duration, then double.
+  const uint32_t multiplier = elapsed * 10 <= min_duration_ ? 10 : 2;
+  iterations_ = static_cast<uint32_t>(
+      std::min<uint64_t>(uint64_t{iterations_} * multiplier,
+                         config::kBenchmarkMaxIterations));
+  return true;
+}
+
+}  // namespace internal
+}  // namespace pw::unit_test
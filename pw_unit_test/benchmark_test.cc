@@ -0,0 +1,84 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/benchmark.h"
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::unit_test {
+namespace {
+
+// Timer that only advances when a benchmark body advances it.
+class FakeTimer final : public BenchmarkTimer {
+ public:
+  uint64_t Now() override { return ticks; }
+  uint64_t TicksPerSecond() const override { return 1'000'000; }
+  const char* units() const override { return "ticks"; }
+
+  uint64_t ticks = 0;
+};
+
+class Benchmark : public ::testing::Test {
+ protected:
+  Benchmark() { SetBenchmarkTimer(&timer_); }
+  ~Benchmark() { SetBenchmarkTimer(nullptr); }
+
+  FakeTimer timer_;
+};
+
+constexpr uint64_t kMinDurationTicks = config::kBenchmarkMinDurationUs;
+
+TEST_F(Benchmark, ScalesIterationsUntilMinDuration) {
+  uint32_t calls = 0;
+  PW_BENCHMARK("one tick per iteration", {
+    calls += 1;
+    timer_.ticks += 1;
+  });
+
+  // Each batch is 10x larger until one takes the minimum duration.
+  uint32_t expected_calls = 0;
+  for (uint64_t batch = 1; batch < kMinDurationTicks; batch *= 10) {
+    expected_calls += static_cast<uint32_t>(batch);
+  }
+  EXPECT_GE(calls, expected_calls + kMinDurationTicks);
+  EXPECT_LT(calls, expected_calls + 2 * kMinDurationTicks);
+}
+
+TEST_F(Benchmark, SlowBodyRunsOnce) {
+  uint32_t calls = 0;
+  PW_BENCHMARK("slow", {
+    calls += 1;
+    timer_.ticks += kMinDurationTicks;
+  });
+  EXPECT_EQ(calls, 1u);
+}
+
+TEST_F(Benchmark, StopsAtMaxIterations) {
+  uint32_t calls = 0;
+  PW_BENCHMARK("free", { calls += 1; });
+
+  // The timer never advances, so batches grow until the maximum.
+  EXPECT_GE(calls, config::kBenchmarkMaxIterations);
+  EXPECT_LT(calls, 2 * config::kBenchmarkMaxIterations);
+}
+
+TEST(DoNotOptimize, AcceptsValues) {
+  int value = 123;
+  DoNotOptimize(value);
+  DoNotOptimize(value + 1);
+  EXPECT_EQ(value, 123);
+}
+
+}  // namespace
+}  // namespace pw::unit_test
@@ -0,0 +1,49 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/cortex_m_cycle_counter.h"
+
+namespace pw::unit_test {
+namespace {
+
+// Memory mapped registers. (ARMv7-M Section C1.6.5 and C1.8.7)
+volatile uint32_t& cortex_m_demcr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+volatile uint32_t& cortex_m_dwt_ctrl =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+volatile uint32_t& cortex_m_dwt_cyccnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+
+constexpr uint32_t kDemcrTraceEnable = 1u << 24;
+constexpr uint32_t kDwtCtrlCycleCounterEnable = 1u << 0;
+
+}  // namespace
+
+CortexMCycleCounterTimer::CortexMCycleCounterTimer(uint32_t cpu_frequency_hz)
+    : cpu_frequency_hz_(cpu_frequency_hz), last_count_(0), wraps_(0) {
+  cortex_m_demcr = cortex_m_demcr | kDemcrTraceEnable;
+  cortex_m_dwt_cyccnt = 0;
+  cortex_m_dwt_ctrl = cortex_m_dwt_ctrl | kDwtCtrlCycleCounterEnable;
+}
+
+uint64_t CortexMCycleCounterTimer::Now() {
+  const uint32_t count = cortex_m_dwt_cyccnt;
+  if (count < last_count_) {
+    wraps_ += 1;
+  }
+  last_count_ = count;
+  return (uint64_t{wraps_} << 32) | count;
+}
+
+}  // namespace pw::unit_test
@@ -56,8 +56,20 @@ int Framework::RunAllTests() {
   if (event_handler_ != nullptr) {
     event_handler_->RunAllTestsStart();
   }
+  // Test suites are numbered in registration order for sharding.
+  const char* previous_suite = nullptr;
+  uint32_t suite_index = 0;
+
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
-    if (ShouldRunTest(*test)) {
+    const char* suite = test->test_case().suite_name;
+    if (previous_suite != nullptr && std::strcmp(previous_suite, suite) != 0) {
+      suite_index += 1;
+    }
+    previous_suite = suite;
+
+    if (!InShard(suite_index)) {
+      run_tests_summary_.skipped_tests++;
+    } else if (ShouldRunTest(*test)) {
       test->run();
     } else if (!test->enabled()) {
       run_tests_summary_.disabled_tests++;
@@ -135,6 +147,12 @@ void Framework::CurrentTestExpectSimple(const char* expression,
   event_handler_->TestCaseExpect(current_test_->test_case(), expectation);
 }
 
+void Framework::CurrentTestBenchmark(const BenchmarkResult& result) {
+  if (event_handler_ != nullptr) {
+    event_handler_->TestCaseBenchmark(current_test_->test_case(), result);
+  }
+}
+
 bool Framework::ShouldRunTest(const TestInfo& test_info) const {
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
   // Test suite filtering is only supported if using C++17.
@@ -155,6 +173,10 @@ bool Framework::ShouldRunTest(const TestInfo& test_info) const {
   return test_info.enabled();
 }
 
+bool Framework::InShard(uint32_t suite_index) const {
+  return shard_count_ <= 1u || suite_index % shard_count_ == shard_index_;
+}
+
 bool TestInfo::enabled() const {
   constexpr size_t kStringSize = sizeof("DISABLED_") - 1;
   return std::strncmp("DISABLED_", test_case().test_name, kStringSize) != 0 &&
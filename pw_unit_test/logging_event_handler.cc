@@ -87,4 +87,14 @@ void LoggingEventHandler::TestCaseDisabled(const TestCase& test) {
   PW_LOG_DEBUG("Skipping disabled test %s.%s", test.suite_name, test.test_name);
 }
 
+void LoggingEventHandler::TestCaseBenchmark(const TestCase&,
+                                            const BenchmarkResult& result) {
+  PW_LOG_INFO("[ BENCHMARK] %s: %llu %s/iteration (%u iterations)",
+              result.name,
+              static_cast<unsigned long long>(result.total_duration /
+                                              result.iterations),
+              result.units,
+              static_cast<unsigned>(result.iterations));
+}
+
 }  // namespace pw::unit_test
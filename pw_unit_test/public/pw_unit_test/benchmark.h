@@ -0,0 +1,112 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Microbenchmarks that run within pw_unit_test test cases.
+//
+//   TEST(Crc32, Calculate1KiB) {
+//     std::array<std::byte, 1024> data = {};
+//     PW_BENCHMARK("Crc32::Calculate 1 KiB", {
+//       pw::unit_test::DoNotOptimize(pw::checksum::Crc32::Calculate(data));
+//     });
+//   }
+//
+// The benchmarked code runs repeatedly, with the iteration count scaled up
+// until the run takes at least PW_UNIT_TEST_CONFIG_BENCHMARK_MIN_DURATION_US.
+// The result is reported through EventHandler::TestCaseBenchmark(), so
+// benchmarks run with the same test runners as the rest of the tests.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_unit_test/config.h"
+#include "pw_unit_test/event_handler.h"
+
+#define PW_BENCHMARK(name, ...) \
+  ::pw::unit_test::RunBenchmark(name, [&]() __VA_ARGS__)
+
+namespace pw::unit_test {
+
+// Source of time for benchmarks.
+class BenchmarkTimer {
+ public:
+  virtual ~BenchmarkTimer() = default;
+
+  // Returns the current time. Only differences between calls are used.
+  virtual uint64_t Now() = 0;
+
+  // The number of Now() ticks per second.
+  virtual uint64_t TicksPerSecond() const = 0;
+
+  // The units of a tick, such as "ns" or "cycles".
+  virtual const char* units() const = 0;
+};
+
+// Times benchmarks with pw_chrono's SystemClock, in nanoseconds. This is the
+// default timer.
+class SystemClockBenchmarkTimer final : public BenchmarkTimer {
+ public:
+  uint64_t Now() override;
+  uint64_t TicksPerSecond() const override { return 1'000'000'000; }
+  const char* units() const override { return "ns"; }
+};
+
+// Sets the timer for subsequent benchmarks. Passing nullptr restores the
+// default SystemClockBenchmarkTimer.
+void SetBenchmarkTimer(BenchmarkTimer* timer);
+
+// Prevents the compiler from optimizing out the computation of value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+namespace internal {
+
+// Tracks the iteration count and timing of one benchmark.
+class BenchmarkState {
+ public:
+  explicit BenchmarkState(const char* name);
+
+  uint32_t iterations() const { return iterations_; }
+
+  void StartBatch();
+
+  // Ends a batch of iterations(). Returns true if the batch was too short to
+  // time accurately and a larger batch should run. Otherwise, reports the
+  // result and returns false.
+  bool FinishBatch();
+
+ private:
+  const char* const name_;
+  BenchmarkTimer& timer_;
+  const uint64_t min_duration_;
+  uint32_t iterations_;
+  uint64_t start_;
+};
+
+}  // namespace internal
+
+// Runs function repeatedly and reports its timing for the current test.
+template <typename Function>
+void RunBenchmark(const char* name, Function&& function) {
+  internal::BenchmarkState state(name);
+  do {
+    state.StartBatch();
+    for (uint32_t i = 0; i < state.iterations(); ++i) {
+      function();
+    }
+  } while (state.FinishBatch());
+}
+
+}  // namespace pw::unit_test
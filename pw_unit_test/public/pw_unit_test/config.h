@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "pw_polyfill/language_feature_macros.h"
 
@@ -27,6 +28,16 @@
 #define PW_UNIT_TEST_CONFIG_MEMORY_POOL_SIZE 16384
 #endif  // PW_UNIT_TEST_CONFIG_MEMORY_POOL_SIZE
 
+// Benchmarks run more iterations until they take at least this long.
+#ifndef PW_UNIT_TEST_CONFIG_BENCHMARK_MIN_DURATION_US
+#define PW_UNIT_TEST_CONFIG_BENCHMARK_MIN_DURATION_US 10000
+#endif  // PW_UNIT_TEST_CONFIG_BENCHMARK_MIN_DURATION_US
+
+// Upper bound on the number of iterations a benchmark runs.
+#ifndef PW_UNIT_TEST_CONFIG_BENCHMARK_MAX_ITERATIONS
+#define PW_UNIT_TEST_CONFIG_BENCHMARK_MAX_ITERATIONS 1000000
+#endif  // PW_UNIT_TEST_CONFIG_BENCHMARK_MAX_ITERATIONS
+
 namespace pw {
 namespace unit_test {
 namespace config {
@@ -37,6 +48,12 @@ PW_INLINE_VARIABLE constexpr size_t kEventBufferSize =
 PW_INLINE_VARIABLE constexpr size_t kMemoryPoolSize =
     PW_UNIT_TEST_CONFIG_MEMORY_POOL_SIZE;
 
+PW_INLINE_VARIABLE constexpr uint32_t kBenchmarkMinDurationUs =
+    PW_UNIT_TEST_CONFIG_BENCHMARK_MIN_DURATION_US;
+
+PW_INLINE_VARIABLE constexpr uint32_t kBenchmarkMaxIterations =
+    PW_UNIT_TEST_CONFIG_BENCHMARK_MAX_ITERATIONS;
+
 }  // namespace config
 }  // namespace unit_test
 }  // namespace pw
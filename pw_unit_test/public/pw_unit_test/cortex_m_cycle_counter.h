@@ -0,0 +1,45 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::unit_test {
+
+// Times benchmarks in CPU cycles with the DWT cycle counter of ARMv7-M and
+// ARMv8-M Mainline cores. The 32-bit counter is extended to 64 bits, which is
+// accurate as long as Now() is called at least once per counter wrap. The
+// benchmark runner ensures this for batches shorter than the wrap period.
+//
+//   pw::unit_test::CortexMCycleCounterTimer cycle_timer(kCpuFrequencyHz);
+//   pw::unit_test::SetBenchmarkTimer(&cycle_timer);
+class CortexMCycleCounterTimer final : public BenchmarkTimer {
+ public:
+  // Enables the cycle counter.
+  explicit CortexMCycleCounterTimer(uint32_t cpu_frequency_hz);
+
+  uint64_t Now() override;
+  uint64_t TicksPerSecond() const override { return cpu_frequency_hz_; }
+  const char* units() const override { return "cycles"; }
+
+ private:
+  const uint32_t cpu_frequency_hz_;
+  uint32_t last_count_;
+  uint32_t wraps_;
+};
+
+}  // namespace pw::unit_test
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 namespace pw {
 namespace unit_test {
 
@@ -46,6 +48,9 @@ namespace unit_test {
 // sequence of events dispatched is the same, except that this TestCaseExpect
 // event is marked as a failure. The result passed alongside the TestCaseEnd
 // event also indicates that the test case did not complete successfully.
+//
+// Benchmarks run within a test case (see pw_unit_test/benchmark.h) dispatch a
+// TestCaseBenchmark event with their timing once they finish.
 
 // The result of a complete test run.
 enum class TestResult {
@@ -80,6 +85,20 @@ struct TestExpectation {
   bool success;
 };
 
+struct BenchmarkResult {
+  // Name of the benchmark.
+  const char* name;
+
+  // Number of times the benchmarked code ran.
+  uint32_t iterations;
+
+  // Total duration of all iterations, in the benchmark timer's units.
+  uint64_t total_duration;
+
+  // Units of total_duration (e.g. "ns" or "cycles").
+  const char* units;
+};
+
 struct RunTestsSummary {
   // The number of passed tests among the run tests.
   int passed_tests;
@@ -121,6 +140,9 @@ class EventHandler {
   // result of the expectation.
   virtual void TestCaseExpect(const TestCase& test_case,
                               const TestExpectation& expectation) = 0;
+
+  // Called when a benchmark within a test case completes.
+  virtual void TestCaseBenchmark(const TestCase&, const BenchmarkResult&) {}
 };
 
 // Sets the event handler for a test run. Must be called before RUN_ALL_TESTS()
@@ -188,6 +188,8 @@ class Framework {
                            .disabled_tests = 0},
         exit_status_(0),
         event_handler_(nullptr),
+        shard_index_(0),
+        shard_count_(0),
         memory_pool_() {}
 
   static Framework& Get() { return framework_; }
@@ -216,6 +218,15 @@ class Framework {
   }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+  // Only run the test suites assigned to the given shard during the next test
+  // run. Test suites are distributed round-robin across shard_count shards in
+  // registration order, so running every shard index from 0 to shard_count - 1
+  // runs each test exactly once. A shard_count of 0 or 1 runs all tests.
+  void SetTestShard(uint32_t shard_index, uint32_t shard_count) {
+    shard_index_ = shard_index;
+    shard_count_ = shard_count;
+  }
+
   bool ShouldRunTest(const TestInfo& test_info) const;
 
   // Whether the current test is skipped.
@@ -298,7 +309,14 @@ class Framework {
                                int line,
                                bool success);
 
+  // Dispatches an event with the result of a benchmark in the current test.
+  void CurrentTestBenchmark(const BenchmarkResult& result);
+
  private:
+  // Whether the test suite with the given registration index is in the shard
+  // selected by SetTestShard().
+  bool InShard(uint32_t suite_index) const;
+
   // Convert char* to void* so that they are printed as pointers instead of
   // strings in EXPECT_EQ and other macros. EXPECT_STREQ wraps its pointers in a
   // CStringArg so its pointers are treated like C strings.
@@ -349,6 +367,11 @@ class Framework {
   std::span<const char*> test_suites_to_run_;  // Always empty in C++14.
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+  // The shard of test suites to run. Sharding is disabled if shard_count_ is
+  // 0 or 1.
+  uint32_t shard_index_;
+  uint32_t shard_count_;
+
   std::aligned_storage_t<config::kMemoryPoolSize, alignof(std::max_align_t)>
       memory_pool_;
 };
@@ -462,6 +485,12 @@ constexpr bool HasNoUnderscores(const char* suite) {
 
 }  // namespace internal
 
+// Runs only the test suites in shard shard_index of shard_count in the next
+// test run. See Framework::SetTestShard().
+inline void SetTestShard(uint32_t shard_index, uint32_t shard_count) {
+  internal::Framework::Get().SetTestShard(shard_index, shard_count);
+}
+
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
 inline void SetTestSuitesToRun(std::span<std::string_view> test_suites) {
   internal::Framework::Get().SetTestSuitesToRun(test_suites);
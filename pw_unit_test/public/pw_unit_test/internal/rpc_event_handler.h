@@ -33,6 +33,8 @@ class RpcEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseBenchmark(const TestCase& test_case,
+                         const BenchmarkResult& result) override;
 
  private:
   UnitTestService& service_;
@@ -57,6 +57,21 @@ class TestExpectation:
         return f'TestExpectation({str(self)})'
 
 
+@dataclass(frozen=True)
+class BenchmarkResult:
+    name: str
+    iterations: int
+    total_duration: int
+    units: str
+
+    def duration_per_iteration(self) -> float:
+        return self.total_duration / self.iterations if self.iterations else 0
+
+    def __str__(self) -> str:
+        return (f'{self.name}: {self.duration_per_iteration():.1f} '
+                f'{self.units}/iteration ({self.iterations} iterations)')
+
+
 class EventHandler(abc.ABC):
     @abc.abstractmethod
     def run_all_tests_start(self):
@@ -83,6 +98,10 @@ class EventHandler(abc.ABC):
                          expectation: TestExpectation):
         """Called after each expect/assert statement within a test case."""
 
+    def test_case_benchmark(self, test_case: TestCase,
+                            result: BenchmarkResult):
+        """Called when a benchmark within a test case completes."""
+
 
 class LoggingEventHandler(EventHandler):
     """Event handler that logs test events using Google Test format."""
@@ -115,10 +134,16 @@ class LoggingEventHandler(EventHandler):
         log('      Expected: %s', expectation.expression)
         log('        Actual: %s', expectation.evaluated_expression)
 
+    def test_case_benchmark(self, test_case: TestCase,
+                            result: BenchmarkResult):
+        _LOG.info('[ BENCHMARK] %s', result)
+
 
 def run_tests(rpcs: pw_rpc.client.Services,
               report_passed_expectations: bool = False,
               test_suites: Iterable[str] = (),
+              shard_index: int = 0,
+              shard_count: int = 0,
               event_handlers: Iterable[EventHandler] = (
                   LoggingEventHandler(), ),
               timeout_s: OptionalTimeout = UseDefault.VALUE) -> bool:
@@ -126,11 +151,17 @@ def run_tests(rpcs: pw_rpc.client.Services,
 
     Calls each of the provided event handlers as test events occur, and returns
     True if all tests pass.
+
+    If shard_count is greater than 1, only the test suites in shard shard_index
+    run. Running each shard index on a different device splits a test binary
+    across the devices.
     """
     unit_test_service = rpcs.pw.unit_test.UnitTest  # type: ignore[attr-defined]
     request = unit_test_service.Run.request(
         report_passed_expectations=report_passed_expectations,
-        test_suite=test_suites)
+        test_suite=test_suites,
+        shard_index=shard_index,
+        shard_count=shard_count)
     call = unit_test_service.Run.invoke(request, timeout_s=timeout_s)
     test_responses = iter(call)
 
@@ -184,5 +215,13 @@ def run_tests(rpcs: pw_rpc.client.Services,
                     raw_expectation.success,
                 )
                 event_handler.test_case_expect(current_test_case, expectation)
+            elif response.HasField('test_case_benchmark'):
+                raw_benchmark = response.test_case_benchmark
+                event_handler.test_case_benchmark(
+                    current_test_case,
+                    BenchmarkResult(raw_benchmark.name,
+                                    raw_benchmark.iterations,
+                                    raw_benchmark.total_duration,
+                                    raw_benchmark.units))
 
     return all_tests_passed
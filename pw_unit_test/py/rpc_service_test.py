@@ -116,6 +116,30 @@ class RpcIntegrationTest(unittest.TestCase):
         calls = [mock.call(case, unit_test_pb2.FAILURE) for case in FAILING]
         self.handler.test_case_end.assert_has_calls(calls, any_order=True)
 
+    def test_shards_run_each_suite_once(self) -> None:
+        # Suites are sharded in registration order: Passing, Failing, then
+        # DISABLED_Disabled.
+        self.assertTrue(
+            run_tests(self.rpcs,
+                      shard_index=0,
+                      shard_count=2,
+                      event_handlers=[self.handler]))
+        self.handler.test_case_start.assert_has_calls(
+            [mock.call(case) for case in PASSING], any_order=True)
+        self.assertEqual(self.handler.test_case_start.call_count,
+                         len(PASSING))
+
+        self.handler.reset_mock()
+        self.assertFalse(
+            run_tests(self.rpcs,
+                      shard_index=1,
+                      shard_count=2,
+                      event_handlers=[self.handler]))
+        self.handler.test_case_start.assert_has_calls(
+            [mock.call(case) for case in FAILING], any_order=True)
+        self.assertEqual(self.handler.test_case_start.call_count,
+                         len(FAILING))
+
 
 def _main(test_server_command: List[str], port: int,
           unittest_args: List[str]) -> None:
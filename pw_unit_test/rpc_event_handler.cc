@@ -41,4 +41,9 @@ void RpcEventHandler::TestCaseDisabled(const TestCase& test_case) {
   service_.WriteTestCaseDisabled(test_case);
 }
 
+void RpcEventHandler::TestCaseBenchmark(const TestCase&,
+                                        const BenchmarkResult& result) {
+  service_.WriteTestCaseBenchmark(result);
+}
+
 }  // namespace pw::unit_test::internal
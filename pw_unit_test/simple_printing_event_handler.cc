@@ -89,4 +89,14 @@ void SimplePrintingEventHandler::TestCaseDisabled(const TestCase& test) {
   }
 }
 
+void SimplePrintingEventHandler::TestCaseBenchmark(
+    const TestCase&, const BenchmarkResult& result) {
+  WriteLine("[ BENCHMARK] %s: %llu %s/iteration (%u iterations)",
+            result.name,
+            static_cast<unsigned long long>(result.total_duration /
+                                            result.iterations),
+            result.units,
+            static_cast<unsigned>(result.iterations));
+}
+
 }  // namespace pw::unit_test
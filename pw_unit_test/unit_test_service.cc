@@ -30,6 +30,10 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
   // duration of this function.
   pw::Vector<std::string_view, 16> suites_to_run;
 
+  // Shard of the test suites to run. Sharding is disabled by default.
+  uint32_t shard_index = 0;
+  uint32_t shard_count = 0;
+
   protobuf::Decoder decoder(request);
 
   Status status;
@@ -58,6 +62,16 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
 
         break;
       }
+
+      case TestRunRequest::Fields::SHARD_INDEX:
+        decoder.ReadUint32(&shard_index)
+            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+        break;
+
+      case TestRunRequest::Fields::SHARD_COUNT:
+        decoder.ReadUint32(&shard_count)
+            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+        break;
     }
   }
 
@@ -67,10 +81,20 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
     return;
   }
 
+  if (shard_count > 1u && shard_index >= shard_count) {
+    PW_LOG_ERROR("Invalid test shard %u of %u",
+                 static_cast<unsigned>(shard_index),
+                 static_cast<unsigned>(shard_count));
+    writer_.Finish(Status::InvalidArgument())
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    return;
+  }
+
   PW_LOG_INFO("Starting unit test run");
 
   RegisterEventHandler(&handler_);
   SetTestSuitesToRun(suites_to_run);
+  SetTestShard(shard_index, shard_count);
   PW_LOG_DEBUG("%u test suite filters applied",
                static_cast<unsigned>(suites_to_run.size()));
 
@@ -78,6 +102,7 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
 
   RegisterEventHandler(nullptr);
   SetTestSuitesToRun({});
+  SetTestShard(0, 0);
 
   PW_LOG_INFO("Unit test run complete");
 
@@ -158,4 +183,19 @@ void UnitTestService::WriteTestCaseExpectation(
   });
 }
 
+void UnitTestService::WriteTestCaseBenchmark(const BenchmarkResult& result) {
+  WriteEvent([&](Event::StreamEncoder& event) {
+    TestCaseBenchmark::StreamEncoder benchmark =
+        event.GetTestCaseBenchmarkEncoder();
+    benchmark.WriteName(result.name)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    benchmark.WriteIterations(result.iterations)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    benchmark.WriteTotalDuration(result.total_duration)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    benchmark.WriteUnits(result.units)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  });
+}
+
 }  // namespace pw::unit_test
@@ -40,6 +40,17 @@ size_t pw_varint_DecodeCustom(const void* input,
                               uint64_t* output,
                               pw_varint_Format format);
 
+// The implementations of pw_varint_DecodeCustom. The word-at-a-time decoder
+// only supports PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT, the default format.
+// Do not call them directly.
+size_t _pw_varint_InternalDecodeBytewise(const void* input,
+                                         size_t input_size,
+                                         uint64_t* output,
+                                         pw_varint_Format format);
+size_t _pw_varint_InternalDecodeWordwise(const void* input,
+                                         size_t input_size,
+                                         uint64_t* output);
+
 static inline size_t pw_varint_Encode(uint64_t integer,
                                       void* output,
                                       size_t output_size) {
@@ -198,6 +209,65 @@ constexpr size_t ZigZagEncodedSize(int64_t integer) {
   return EncodedSize(ZigZagEncode(integer));
 }
 
+namespace internal {
+
+// Converts an integer to the value that Encode() writes as LEB128: signed
+// integers are ZigZag encoded, unsigned integers are used as is.
+template <typename T>
+constexpr uint64_t ToEncodedValue(T integer) {
+  return std::is_signed<T>()
+             ? ZigZagEncode(static_cast<int64_t>(integer))
+             : static_cast<uint64_t>(integer);
+}
+
+// Encodes a varint to a buffer that is known to have room for it.
+inline size_t EncodeUnchecked(uint64_t integer, std::byte* output) {
+  size_t written = 0;
+  while (integer >= 0x80u) {
+    output[written++] = static_cast<std::byte>(integer | 0x80u);
+    integer >>= 7;
+  }
+  output[written++] = static_cast<std::byte>(integer);
+  return written;
+}
+
+}  // namespace internal
+
+// Returns the total number of bytes that Encode() writes for a span of
+// integers. Signed integers are ZigZag encoded, as in the single-integer
+// Encode().
+template <typename T, size_t kExtent>
+constexpr size_t EncodedSize(std::span<const T, kExtent> integers) {
+  size_t size = 0;
+  for (T integer : integers) {
+    size += EncodedSize(internal::ToEncodedValue(integer));
+  }
+  return size;
+}
+
+// Encodes a span of integers as consecutive varints in a single pass, such as
+// for a packed repeated protobuf field. Signed integers are ZigZag encoded, as
+// in the single-integer Encode(). Use EncodedSize() to size the output.
+//
+// Returns the number of bytes written or 0 if the result didn't fit in the
+// encoding buffer.
+template <typename T, size_t kExtent>
+size_t Encode(std::span<const T, kExtent> integers,
+              std::span<std::byte> output) {
+  size_t written = 0;
+  for (T integer : integers) {
+    const uint64_t value = internal::ToEncodedValue(integer);
+
+    // Only check the exact size when close to the end of the buffer.
+    if (output.size() - written < kMaxVarint64SizeBytes &&
+        output.size() - written < EncodedSize(value)) {
+      return 0;
+    }
+    written += internal::EncodeUnchecked(value, output.data() + written);
+  }
+  return written;
+}
+
 // Returns the maximum integer value that can be encoded in a varint of the
 // specified number of bytes.
 //
@@ -14,10 +14,15 @@
 
 #include "pw_varint/stream.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <span>
 
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 #include "pw_stream/stream.h"
 #include "pw_varint/varint.h"
@@ -36,7 +41,50 @@ StatusWithSize Read(stream::Reader& reader, int64_t* output) {
   return count;
 }
 
+namespace {
+
+// Reads the longest possible varint in one call, decodes it, and seeks back
+// over the bytes after it. Returns NOT_FOUND if this cannot be done, such as
+// when the stream returns fewer bytes than the varint's length, in which case
+// the stream is left where it was.
+StatusWithSize ReadWithLookahead(stream::Reader& reader, uint64_t* output) {
+  const size_t limit =
+      std::min(varint::kMaxVarint64SizeBytes, reader.ConservativeReadLimit());
+  if (limit == 0u) {
+    return StatusWithSize::NotFound();
+  }
+
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const Result<ByteSpan> bytes = reader.Read(std::span(buffer).first(limit));
+  if (!bytes.ok()) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t count = Decode(bytes.value(), output);
+  const ptrdiff_t unread = static_cast<ptrdiff_t>(bytes.value().size()) -
+                           static_cast<ptrdiff_t>(count);
+  if (unread != 0) {
+    if (Status status = reader.Seek(-unread, stream::Stream::kCurrent);
+        !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+  }
+
+  return count == 0u ? StatusWithSize::NotFound() : StatusWithSize(count);
+}
+
+}  // namespace
+
 StatusWithSize Read(stream::Reader& reader, uint64_t* output) {
+  // Each Read() call is a virtual call, and often a copy, so avoid reading a
+  // byte at a time when the stream can seek back over extra bytes.
+  if (reader.seekable(stream::Stream::kCurrent)) {
+    if (StatusWithSize result = ReadWithLookahead(reader, output);
+        !result.IsNotFound()) {
+      return result;
+    }
+  }
+
   uint64_t value = 0;
   size_t count = 0;
 
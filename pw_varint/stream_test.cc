@@ -241,4 +241,112 @@ TEST(VarintRead, Unsigned64_MultiByte) {
   }
 }
 
+TEST(VarintRead, ConsecutiveVarints_LeavesReaderAfterEachVarint) {
+  const auto buffer = MakeBuffer("\x01\x80\x01\xff\xff\x03\x7f");
+  stream::MemoryReader reader(buffer);
+
+  uint64_t value = 0;
+  EXPECT_EQ(Read(reader, &value).size(), 1u);
+  EXPECT_EQ(value, 1u);
+  EXPECT_EQ(reader.Tell(), 1u);
+
+  EXPECT_EQ(Read(reader, &value).size(), 2u);
+  EXPECT_EQ(value, 128u);
+  EXPECT_EQ(reader.Tell(), 3u);
+
+  EXPECT_EQ(Read(reader, &value).size(), 3u);
+  EXPECT_EQ(value, 0xffffu);
+  EXPECT_EQ(reader.Tell(), 6u);
+
+  EXPECT_EQ(Read(reader, &value).size(), 1u);
+  EXPECT_EQ(value, 127u);
+  EXPECT_EQ(reader.Tell(), 7u);
+
+  EXPECT_EQ(Read(reader, &value).status(), Status::OutOfRange());
+}
+
+TEST(VarintRead, Truncated_ReturnsOutOfRange) {
+  const auto buffer = MakeBuffer("\x80\x80");
+  stream::MemoryReader reader(buffer);
+
+  uint64_t value = 0;
+  EXPECT_EQ(Read(reader, &value).status(), Status::OutOfRange());
+}
+
+TEST(VarintRead, TooLong_ReturnsOutOfRange) {
+  const auto buffer = MakeBuffer("\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff");
+  stream::MemoryReader reader(buffer);
+
+  uint64_t value = 0;
+  EXPECT_EQ(Read(reader, &value).status(), Status::OutOfRange());
+}
+
+// Counts the calls to Read() on a MemoryReader.
+class CountingReader : public stream::RelativeSeekableReader {
+ public:
+  CountingReader(ConstByteSpan data) : reader_(data), reads_(0) {}
+
+  size_t reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    reads_ += 1;
+    Result<ByteSpan> result = reader_.Read(destination);
+    return result.ok() ? StatusWithSize(result.value().size())
+                       : StatusWithSize(result.status(), 0);
+  }
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return reader_.Seek(offset, origin);
+  }
+
+  stream::MemoryReader reader_;
+  size_t reads_;
+};
+
+// Reads a byte at a time, and cannot seek.
+class ByteReader : public stream::NonSeekableReader {
+ public:
+  ByteReader(ConstByteSpan data) : data_(data) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    if (data_.empty()) {
+      return StatusWithSize::OutOfRange();
+    }
+    destination[0] = data_[0];
+    data_ = data_.subspan(1);
+    return StatusWithSize(1);
+  }
+
+  ConstByteSpan data_;
+};
+
+TEST(VarintRead, SeekableReader_ReadsOnce) {
+  const auto buffer = MakeBuffer("\xff\xff\xff\xff\x0f\x05");
+  CountingReader reader(buffer);
+
+  uint64_t value = 0;
+  const StatusWithSize sws = Read(reader, &value);
+  EXPECT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(sws.size(), 5u);
+  EXPECT_EQ(value, std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(reader.reads(), 1u);
+
+  EXPECT_EQ(Read(reader, &value).size(), 1u);
+  EXPECT_EQ(value, 5u);
+}
+
+TEST(VarintRead, NonSeekableReader) {
+  const auto buffer = MakeBuffer("\x80\x01\x05");
+  ByteReader reader(buffer);
+
+  uint64_t value = 0;
+  EXPECT_EQ(Read(reader, &value).size(), 2u);
+  EXPECT_EQ(value, 128u);
+  EXPECT_EQ(Read(reader, &value).size(), 1u);
+  EXPECT_EQ(value, 5u);
+  EXPECT_EQ(Read(reader, &value).status(), Status::OutOfRange());
+}
+
 }  // namespace pw::varint
@@ -15,6 +15,7 @@
 #include "pw_varint/varint.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace pw {
 namespace varint {
@@ -77,6 +78,60 @@ extern "C" size_t pw_varint_DecodeCustom(const void* input,
                                          size_t input_size,
                                          uint64_t* output,
                                          pw_varint_Format format) {
+  if (format == PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT) {
+    return _pw_varint_InternalDecodeWordwise(input, input_size, output);
+  }
+  return _pw_varint_InternalDecodeBytewise(input, input_size, output, format);
+}
+
+extern "C" size_t _pw_varint_InternalDecodeWordwise(const void* input,
+                                                    size_t input_size,
+                                                    uint64_t* output) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(input);
+
+  // Load up to 8 bytes as a little-endian word. Missing bytes are zero, which
+  // marks them as the last byte of a varint.
+  uint64_t word = 0;
+  if (input_size >= sizeof(word)) {
+    std::memcpy(&word, bytes, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif  // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  } else {
+    for (size_t i = 0; i < input_size; ++i) {
+      word |= uint64_t{bytes[i]} << (8 * i);
+    }
+  }
+
+  // The first byte with a clear high bit is the last byte of the varint.
+  const uint64_t last_bytes = ~word & 0x8080808080808080u;
+  if (last_bytes == 0u) {
+    // Varints of 9 or 10 bytes are rare; decode them a byte at a time.
+    return _pw_varint_InternalDecodeBytewise(
+        input, input_size, output, PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT);
+  }
+
+  const size_t size = static_cast<size_t>(__builtin_ctzll(last_bytes) / 8) + 1;
+  if (size > input_size) {
+    return 0;
+  }
+
+  // Keep the varint's bytes, drop their high bits, and pack the 7-bit groups
+  // together: first into 14-bit, then 28-bit, then 56-bit groups.
+  const uint64_t varint_bits = last_bytes ^ (last_bytes - 1);
+  word &= varint_bits & 0x7f7f7f7f7f7f7f7fu;
+  word = (word & 0x007f007f007f007fu) | ((word & 0x7f007f007f007f00u) >> 1);
+  word = (word & 0x00003fff00003fffu) | ((word & 0x3fff00003fff0000u) >> 2);
+  word = (word & 0x000000000fffffffu) | ((word & 0x0fffffff00000000u) >> 4);
+
+  *output = word;
+  return size;
+}
+
+extern "C" size_t _pw_varint_InternalDecodeBytewise(const void* input,
+                                                    size_t input_size,
+                                                    uint64_t* output,
+                                                    pw_varint_Format format) {
   uint64_t decoded_value = 0;
   uint_fast8_t count = 0;
   const std::byte* buffer = static_cast<const std::byte*>(input);
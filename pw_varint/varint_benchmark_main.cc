@@ -0,0 +1,102 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how fast each varint decoder decodes a buffer of varints and logs
+// the results. The varints are mostly short, as in typical protobufs.
+
+#define PW_LOG_MODULE_NAME "VARINT"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_varint/varint.h"
+
+namespace {
+
+using pw::chrono::SystemClock;
+
+constexpr size_t kBufferSizeBytes = 4096;
+constexpr size_t kIterations = 256;
+
+std::array<std::byte, kBufferSizeBytes> buffer;
+size_t encoded_size = 0;
+size_t varint_count = 0;
+
+// Keeps the compiler from discarding the decoded values.
+volatile uint64_t result_sink;
+
+template <typename Function>
+void Run(const char* name, Function&& decode) {
+  const SystemClock::time_point start = SystemClock::now();
+  for (size_t i = 0; i < kIterations; ++i) {
+    uint64_t sum = 0;
+    for (size_t offset = 0; offset < encoded_size;) {
+      uint64_t value;
+      offset += decode(&buffer[offset], encoded_size - offset, &value);
+      sum += value;
+    }
+    result_sink = sum;
+  }
+  const SystemClock::duration elapsed = SystemClock::now() - start;
+
+  const uint64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (ns == 0u) {
+    PW_LOG_ERROR("%s: the system clock is too coarse to time one run", name);
+    return;
+  }
+
+  const uint64_t varints = uint64_t(varint_count) * kIterations;
+  PW_LOG_INFO("%-10s %8u K varints/s",
+              name,
+              static_cast<unsigned>(varints * 1'000'000u / ns));
+}
+
+}  // namespace
+
+int main() {
+  // Mostly 1 and 2 byte varints, with some of every other size.
+  uint64_t value = 1;
+  while (true) {
+    const uint64_t encoded =
+        varint_count % 4 == 3 ? value : value % (uint64_t{1} << 14);
+    const size_t size = pw::varint::Encode(
+        encoded, std::span(buffer).subspan(encoded_size));
+    if (size == 0u) {
+      break;
+    }
+    encoded_size += size;
+    varint_count += 1;
+    value = value * 6364136223846793005u + 1442695040888963407u;
+  }
+
+  PW_LOG_INFO("Decoding %u varints in %u B, %u times",
+              static_cast<unsigned>(varint_count),
+              static_cast<unsigned>(encoded_size),
+              static_cast<unsigned>(kIterations));
+
+  Run("Bytewise", [](const void* input, size_t size, uint64_t* output) {
+    return _pw_varint_InternalDecodeBytewise(
+        input, size, output, PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT);
+  });
+  Run("Wordwise", [](const void* input, size_t size, uint64_t* output) {
+    return _pw_varint_InternalDecodeWordwise(input, size, output);
+  });
+
+  return 0;
+}
@@ -14,6 +14,7 @@
 
 #include "pw_varint/varint.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
@@ -1075,5 +1076,109 @@ TEST(Varint, MaxValueInBytes) {
   static_assert(MaxValueInBytes(100) == std::numeric_limits<uint64_t>::max());
 }
 
+// Decodes with both implementations and checks that they agree.
+size_t DecodeBothWays(std::span<const std::byte> input, uint64_t* value) {
+  uint64_t bytewise = 0;
+  const size_t bytewise_size = _pw_varint_InternalDecodeBytewise(
+      input.data(),
+      input.size(),
+      &bytewise,
+      PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT);
+
+  uint64_t wordwise = 0;
+  const size_t wordwise_size =
+      _pw_varint_InternalDecodeWordwise(input.data(), input.size(), &wordwise);
+
+  EXPECT_EQ(bytewise_size, wordwise_size);
+  if (bytewise_size != 0u) {
+    EXPECT_EQ(bytewise, wordwise);
+  }
+  *value = wordwise;
+  return wordwise_size;
+}
+
+TEST(Varint, DecodeWordwise_MatchesBytewiseForEachSize) {
+  for (size_t bytes = 1; bytes <= kMaxVarint64SizeBytes; ++bytes) {
+    for (uint64_t value :
+         {MaxValueInBytes(bytes), MaxValueInBytes(bytes - 1) + 1}) {
+      // Pad the buffer, so that both in-word and trailing varints are tested.
+      std::array<std::byte, 16> buffer;
+      buffer.fill(std::byte{0xff});
+      ASSERT_EQ(Encode(value, buffer), bytes);
+
+      uint64_t decoded = 0;
+      EXPECT_EQ(DecodeBothWays(buffer, &decoded), bytes);
+      EXPECT_EQ(decoded, value);
+
+      // Decode it at the end of the buffer, with no bytes after it.
+      EXPECT_EQ(DecodeBothWays(std::span(buffer).first(bytes), &decoded),
+                bytes);
+      EXPECT_EQ(decoded, value);
+    }
+  }
+}
+
+TEST(Varint, DecodeWordwise_Truncated) {
+  std::array<std::byte, 16> buffer;
+  ASSERT_EQ(Encode(std::numeric_limits<uint64_t>::max(), buffer), 10u);
+
+  for (size_t size = 0; size < 10u; ++size) {
+    uint64_t decoded = 0;
+    EXPECT_EQ(DecodeBothWays(std::span(buffer).first(size), &decoded), 0u);
+  }
+}
+
+TEST(Varint, DecodeWordwise_TooLong) {
+  std::array<std::byte, 16> buffer;
+  buffer.fill(std::byte{0x80});
+
+  uint64_t decoded = 0;
+  EXPECT_EQ(DecodeBothWays(buffer, &decoded), 0u);
+}
+
+TEST(Varint, EncodeSpan_MatchesEncodingEachInteger) {
+  constexpr uint32_t kValues[] = {0, 1, 127, 128, 16384, 0xffffffff};
+  static_assert(EncodedSize(std::span(kValues)) == 1 + 1 + 1 + 2 + 3 + 5);
+
+  std::array<std::byte, 16> expected;
+  size_t expected_size = 0;
+  for (uint32_t value : kValues) {
+    expected_size +=
+        Encode(value, std::span(expected).subspan(expected_size));
+  }
+
+  std::array<std::byte, 16> buffer;
+  ASSERT_EQ(Encode(std::span(kValues), buffer), expected_size);
+  EXPECT_EQ(std::memcmp(buffer.data(), expected.data(), expected_size), 0);
+}
+
+TEST(Varint, EncodeSpan_ZigZagEncodesSignedIntegers) {
+  constexpr int64_t kValues[] = {
+      0, -1, 1, -65, std::numeric_limits<int64_t>::min()};
+  static_assert(EncodedSize(std::span(kValues)) == 1 + 1 + 1 + 2 + 10);
+
+  std::array<std::byte, 16> buffer;
+  ASSERT_EQ(Encode(std::span(kValues), buffer), 15u);
+
+  std::span<const std::byte> encoded(buffer);
+  for (int64_t value : kValues) {
+    int64_t decoded = 0;
+    const size_t size = Decode(encoded, &decoded);
+    ASSERT_NE(size, 0u);
+    EXPECT_EQ(decoded, value);
+    encoded = encoded.subspan(size);
+  }
+}
+
+TEST(Varint, EncodeSpan_InsufficientSpace) {
+  constexpr uint64_t kValues[] = {1, 300, 70000};
+  std::array<std::byte, 16> buffer;
+
+  EXPECT_EQ(Encode(std::span(kValues), std::span(buffer).first(6)), 6u);
+  EXPECT_EQ(Encode(std::span(kValues), std::span(buffer).first(5)), 0u);
+  EXPECT_EQ(Encode(std::span(kValues), std::span<std::byte>()), 0u);
+  EXPECT_EQ(Encode(std::span<const uint64_t>(), std::span<std::byte>()), 0u);
+}
+
 }  // namespace
 }  // namespace pw::varint
@@ -16,14 +16,16 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
 #include <span>
 
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_metric/metric.h"
 #include "pw_status/status.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
-#include "pw_sync/thread_notification.h"
+#include "pw_sync/timed_thread_notification.h"
 #include "pw_thread/thread_core.h"
 #include "pw_work_queue/internal/circular_buffer.h"
 
@@ -31,6 +33,24 @@ namespace pw::work_queue {
 
 using WorkItem = Function<void()>;
 
+// Work queue priority lanes. Work in a higher lane runs before work in lower
+// lanes, subject to the queue's lane weights.
+enum class WorkPriority : uint8_t {
+  kHigh = 0,
+  kNormal = 1,
+  kLow = 2,
+};
+
+inline constexpr size_t kWorkPriorityCount = 3;
+
+// Storage for work scheduled with PushWorkAt() or PushWorkEvery(). The members
+// are managed by the WorkQueue.
+struct ScheduledWorkItem {
+  chrono::SystemClock::time_point deadline;
+  chrono::SystemClock::duration period;  // Zero for work that runs once.
+  WorkItem work_item;
+};
+
 // The WorkQueue class enables threads and interrupts to enqueue work as a
 // pw::work_queue::WorkItem for execution by the work queue.
 //
@@ -39,7 +59,31 @@ class WorkQueue : public thread::ThreadCore {
  public:
   // Note: the ThreadNotification prevents this from being constexpr.
   explicit WorkQueue(std::span<WorkItem> queue_storage)
-      : stop_requested_(false), circular_buffer_(queue_storage) {}
+      : WorkQueue(queue_storage, std::span<ScheduledWorkItem>()) {}
+
+  // Work queue that can also hold scheduled_storage.size() scheduled work
+  // items.
+  WorkQueue(std::span<WorkItem> queue_storage,
+            std::span<ScheduledWorkItem> scheduled_storage)
+      : WorkQueue({}, queue_storage, {}, scheduled_storage) {}
+
+  // Work queue with a separate queue for each priority lane. Work pushed to a
+  // lane without storage goes to the normal lane.
+  WorkQueue(std::span<WorkItem> high_storage,
+            std::span<WorkItem> normal_storage,
+            std::span<WorkItem> low_storage,
+            std::span<ScheduledWorkItem> scheduled_storage = {})
+      : stop_requested_(false),
+        lanes_{internal::CircularBuffer<WorkItem>(high_storage),
+               internal::CircularBuffer<WorkItem>(normal_storage),
+               internal::CircularBuffer<WorkItem>(low_storage)},
+        lane_weights_{},
+        lane_credits_{},
+        scheduled_(scheduled_storage),
+        scheduled_count_(0),
+        running_periodic_work_(false) {
+    min_queue_remaining_.Set(static_cast<uint32_t>(capacity()));
+  }
 
   // Enqueues a work_item for execution by the work queue thread.
   //
@@ -49,7 +93,13 @@ class WorkQueue : public thread::ThreadCore {
   //     longer permitted.
   // ResourceExhausted - internal work queue is full, entry was not enqueued.
   Status PushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_) {
-    return InternalPushWork(std::move(work_item));
+    return InternalPushWork(WorkPriority::kNormal, std::move(work_item));
+  }
+
+  // Enqueues a work_item in the given priority lane.
+  Status PushWork(WorkPriority priority, WorkItem&& work_item)
+      PW_LOCKS_EXCLUDED(lock_) {
+    return InternalPushWork(priority, std::move(work_item));
   }
 
   // Queue work for execution. Crash if the work cannot be queued due to a
@@ -62,10 +112,48 @@ class WorkQueue : public thread::ThreadCore {
   // Precondition: The queue must not overflow, i.e. be full.
   // Precondition: The queue must not have been requested to stop, i.e. it must
   //     not be in the process of shutting down.
-  void CheckPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+  void CheckPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_) {
+    CheckPushWork(WorkPriority::kNormal, std::move(work_item));
+  }
+  void CheckPushWork(WorkPriority priority, WorkItem&& work_item)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // By default, lanes are scheduled strictly: work only runs when no higher
+  // lane has work queued. With weights, each lane with queued work may run up
+  // to its weight in work items per round before lower lanes get their turn,
+  // so bulk work in lower lanes is not starved. Weights must be nonzero.
+  void SetLaneWeights(uint8_t high, uint8_t normal, uint8_t low)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Schedules a work_item to run on the work queue thread once the system
+  // clock reaches deadline. Work that is already due runs before the queued
+  // immediate work.
+  //
+  // Returns:
+  // Ok - Success, entry was scheduled.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - no scheduled work storage is free.
+  Status PushWorkAt(chrono::SystemClock::time_point deadline,
+                    WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Schedules a work_item to run on the work queue thread every period,
+  // starting one period from now, until the work queue is stopped. If the
+  // work queue falls behind, missed runs are skipped rather than run back to
+  // back.
+  //
+  // Returns:
+  // Ok - Success, entry was scheduled.
+  // InvalidArgument - the period is not positive.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - no scheduled work storage is free.
+  Status PushWorkEvery(chrono::SystemClock::duration period,
+                       WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
 
   // Locks the queue to prevent further work enqueing, finishes outstanding
-  // work, then shuts down the worker thread.
+  // work, then shuts down the worker thread. Scheduled work that is not yet
+  // due is discarded.
   //
   // The WorkQueue cannot be resumed after stopping as the ThreadCore thread
   // returns and may be joined. It must be reconstructed for re-use after
@@ -74,12 +162,45 @@ class WorkQueue : public thread::ThreadCore {
 
  private:
   void Run() override PW_LOCKS_EXCLUDED(lock_);
-  Status InternalPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+  Status InternalPushWork(WorkPriority priority, WorkItem&& work_item)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Removes the next work item to run according to the lane scheduling.
+  std::optional<WorkItem> PopWork() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  bool empty() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  size_t capacity() const PW_NO_LOCK_SAFETY_ANALYSIS;
+  Status InternalPushScheduledWork(chrono::SystemClock::time_point deadline,
+                                   chrono::SystemClock::duration period,
+                                   WorkItem&& work_item)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Runs scheduled work that is due. Returns the deadline of the next
+  // scheduled work item, if any.
+  std::optional<chrono::SystemClock::time_point> RunDueScheduledWork()
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Scheduled work is kept in a min-heap ordered by deadline.
+  void PushScheduled(ScheduledWorkItem&& item)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  ScheduledWorkItem PopScheduled() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   sync::InterruptSpinLock lock_;
   bool stop_requested_ PW_GUARDED_BY(lock_);
-  internal::CircularBuffer<WorkItem> circular_buffer_ PW_GUARDED_BY(lock_);
-  sync::ThreadNotification work_notification_;
+  std::array<internal::CircularBuffer<WorkItem>, kWorkPriorityCount> lanes_
+      PW_GUARDED_BY(lock_);
+
+  // Zero weights mean strict priority scheduling.
+  std::array<uint8_t, kWorkPriorityCount> lane_weights_ PW_GUARDED_BY(lock_);
+  std::array<uint8_t, kWorkPriorityCount> lane_credits_ PW_GUARDED_BY(lock_);
+
+  std::span<ScheduledWorkItem> scheduled_ PW_GUARDED_BY(lock_);
+  size_t scheduled_count_ PW_GUARDED_BY(lock_);
+
+  // A periodic work item keeps its storage while it runs outside the heap.
+  bool running_periodic_work_ PW_GUARDED_BY(lock_);
+
+  sync::TimedThreadNotification work_notification_;
 
   // TODO(ewout): The group and/or its name token should be passed as a ctor
   // arg instead. Depending on the approach here the group should be exposed
@@ -90,19 +211,41 @@ class WorkQueue : public thread::ThreadCore {
   // metrics work as intended.
   PW_METRIC_GROUP(metrics_, "pw::work_queue::WorkQueue");
   PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
-  PW_METRIC(metrics_,
-            min_queue_remaining_,
-            "min_queue_remaining",
-            static_cast<uint32_t>(circular_buffer_.capacity()));
+  // Set to the total capacity of the lanes by the constructor.
+  PW_METRIC(metrics_, min_queue_remaining_, "min_queue_remaining", 0u);
+
+  // The most work items queued in each lane at once.
+  PW_METRIC(metrics_, high_lane_max_used_, "high_lane_max_used", 0u);
+  PW_METRIC(metrics_, normal_lane_max_used_, "normal_lane_max_used", 0u);
+  PW_METRIC(metrics_, low_lane_max_used_, "low_lane_max_used", 0u);
+};
+
+template <size_t kHighEntries,
+          size_t kNormalEntries,
+          size_t kLowEntries,
+          size_t kScheduledWorkEntries = 0>
+class PriorityWorkQueueWithBuffer : public WorkQueue {
+ public:
+  PriorityWorkQueueWithBuffer()
+      : WorkQueue(
+            high_storage_, normal_storage_, low_storage_, scheduled_storage_) {}
+
+ private:
+  std::array<WorkItem, kHighEntries> high_storage_;
+  std::array<WorkItem, kNormalEntries> normal_storage_;
+  std::array<WorkItem, kLowEntries> low_storage_;
+  std::array<ScheduledWorkItem, kScheduledWorkEntries> scheduled_storage_;
 };
 
-template <size_t kWorkQueueEntries>
+template <size_t kWorkQueueEntries, size_t kScheduledWorkEntries = 0>
 class WorkQueueWithBuffer : public WorkQueue {
  public:
-  constexpr WorkQueueWithBuffer() : WorkQueue(queue_storage_) {}
+  constexpr WorkQueueWithBuffer()
+      : WorkQueue(queue_storage_, scheduled_storage_) {}
 
  private:
   std::array<WorkItem, kWorkQueueEntries> queue_storage_;
+  std::array<ScheduledWorkItem, kScheduledWorkEntries> scheduled_storage_;
 };
 
 }  // namespace pw::work_queue
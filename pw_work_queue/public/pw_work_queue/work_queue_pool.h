@@ -0,0 +1,141 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "pw_status/status.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/internal/circular_buffer.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+// The WorkQueuePool class runs pw::work_queue::WorkItems on several worker
+// threads, so independent work can run in parallel.
+//
+// Each worker has its own queue. New work is spread across the queues in turn,
+// and a worker whose queue is empty steals work from the others, so one long
+// work item does not hold up the items queued behind it.
+//
+// Work items may run concurrently and in any order. Use a WorkQueue for work
+// that must run in series.
+//
+// The entire API is thread and interrupt safe.
+class WorkQueuePool {
+ public:
+  // One of the pool's worker threads. Run each worker in its own thread.
+  class Worker : public thread::ThreadCore {
+   public:
+    Worker() : pool_(nullptr), queue_({}) {}
+
+   private:
+    friend class WorkQueuePool;
+
+    void Run() override;
+
+    // Removes the oldest work item from this worker's queue, if any.
+    std::optional<WorkItem> Pop() PW_LOCKS_EXCLUDED(lock_);
+
+    WorkQueuePool* pool_;
+    sync::InterruptSpinLock lock_;
+    internal::CircularBuffer<WorkItem> queue_ PW_GUARDED_BY(lock_);
+  };
+
+  // Splits queue_storage evenly between the workers. Any remainder is unused.
+  WorkQueuePool(std::span<Worker> workers, std::span<WorkItem> queue_storage);
+
+  WorkQueuePool(const WorkQueuePool&) = delete;
+  WorkQueuePool& operator=(const WorkQueuePool&) = delete;
+
+  size_t worker_count() const { return workers_.size(); }
+
+  // Returns the worker to run in a thread.
+  thread::ThreadCore& worker(size_t index) { return workers_[index]; }
+
+  // Enqueues a work_item for execution by one of the worker threads.
+  //
+  // Returns:
+  // Ok - Success, entry was enqueued for execution.
+  // FailedPrecondition - the pool is shutting down, entries are no longer
+  //     permitted.
+  // ResourceExhausted - all of the workers' queues are full, entry was not
+  //     enqueued.
+  Status PushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Queue work for execution. Crash if the work cannot be queued due to full
+  // queues or stopped worker threads.
+  //
+  // Precondition: The queues must not overflow, i.e. be full.
+  // Precondition: The pool must not have been requested to stop, i.e. it must
+  //     not be in the process of shutting down.
+  void CheckPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Locks the pool to prevent further work enqueing, finishes outstanding
+  // work, then shuts down all of the worker threads.
+  //
+  // The WorkQueuePool cannot be resumed after stopping as the workers' threads
+  // return and may be joined.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  // Takes a work item from the given worker's queue, or steals one from
+  // another worker. Returns std::nullopt once the pool has been stopped and all
+  // work is done.
+  std::optional<WorkItem> TakeWork(Worker& worker) PW_LOCKS_EXCLUDED(lock_);
+
+  // Pops from the given worker's queue first, then from the others in turn.
+  std::optional<WorkItem> PopFromAnyQueue(Worker& worker);
+
+  std::span<Worker> workers_;
+
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_);
+  size_t next_worker_ PW_GUARDED_BY(lock_);
+
+  // Released once for each work item pushed, and once for each worker when
+  // stopping.
+  sync::CountingSemaphore work_available_;
+};
+
+namespace internal {
+
+// The pool sets up its workers when it is constructed, so their storage must be
+// constructed first.
+template <size_t kWorkers, size_t kWorkQueueEntriesPerWorker>
+struct WorkQueuePoolStorage {
+  std::array<WorkQueuePool::Worker, kWorkers> workers;
+  std::array<WorkItem, kWorkers * kWorkQueueEntriesPerWorker> queue_storage;
+};
+
+}  // namespace internal
+
+template <size_t kWorkers, size_t kWorkQueueEntriesPerWorker>
+class WorkQueuePoolWithBuffer
+    : private internal::WorkQueuePoolStorage<kWorkers,
+                                             kWorkQueueEntriesPerWorker>,
+      public WorkQueuePool {
+ public:
+  WorkQueuePoolWithBuffer()
+      : WorkQueuePool(this->workers, this->queue_storage) {}
+};
+
+}  // namespace pw::work_queue
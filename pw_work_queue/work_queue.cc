@@ -14,11 +14,20 @@
 
 #include "pw_work_queue/work_queue.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "pw_assert/check.h"
 
 namespace pw::work_queue {
+namespace {
+
+// Orders the scheduled work heap so the earliest deadline is at the front.
+bool LaterDeadline(const ScheduledWorkItem& lhs, const ScheduledWorkItem& rhs) {
+  return lhs.deadline > rhs.deadline;
+}
+
+}  // namespace
 
 void WorkQueue::RequestStop() {
   std::lock_guard lock(lock_);
@@ -27,8 +36,18 @@ void WorkQueue::RequestStop() {
 }
 
 void WorkQueue::Run() {
+  std::optional<chrono::SystemClock::time_point> next_deadline;
+
   while (true) {
-    work_notification_.acquire();
+    // Wait for new work, or until scheduled work is due. Either way, check
+    // for both below.
+    if (next_deadline.has_value()) {
+      work_notification_.try_acquire_until(*next_deadline);
+    } else {
+      work_notification_.acquire();
+    }
+
+    next_deadline = RunDueScheduledWork();
 
     // Drain the work queue.
     bool stop_requested;
@@ -37,8 +56,8 @@ void WorkQueue::Run() {
       std::optional<WorkItem> possible_work_item;
       {
         std::lock_guard lock(lock_);
-        possible_work_item = circular_buffer_.Pop();
-        work_remaining = !circular_buffer_.empty();
+        possible_work_item = PopWork();
+        work_remaining = !empty();
         stop_requested = stop_requested_;
       }
       if (!possible_work_item.has_value()) {
@@ -56,12 +75,61 @@ void WorkQueue::Run() {
   }
 }
 
-void WorkQueue::CheckPushWork(WorkItem&& work_item) {
-  PW_CHECK_OK(InternalPushWork(std::move(work_item)),
+std::optional<chrono::SystemClock::time_point>
+WorkQueue::RunDueScheduledWork() {
+  while (true) {
+    ScheduledWorkItem item;
+    {
+      std::lock_guard lock(lock_);
+      if (scheduled_count_ == 0u) {
+        return std::nullopt;
+      }
+      const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+      if (scheduled_.front().deadline > now) {
+        return scheduled_.front().deadline;
+      }
+      item = PopScheduled();
+      running_periodic_work_ = item.period > chrono::SystemClock::duration(0);
+    }
+
+    PW_CHECK(item.work_item != nullptr);
+    item.work_item();
+
+    if (item.period > chrono::SystemClock::duration(0)) {
+      std::lock_guard lock(lock_);
+      running_periodic_work_ = false;
+
+      // Reschedule relative to the last deadline so the period does not drift.
+      // If the queue has fallen behind, skip the missed runs by advancing
+      // whole periods, which keeps the item in phase.
+      item.deadline += item.period;
+      const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+      if (item.deadline < now) {
+        const auto missed_periods = (now - item.deadline + item.period -
+                                     chrono::SystemClock::duration(1)) /
+                                    item.period;
+        item.deadline += item.period * missed_periods;
+      }
+      PushScheduled(std::move(item));
+    }
+  }
+}
+
+void WorkQueue::CheckPushWork(WorkPriority priority, WorkItem&& work_item) {
+  PW_CHECK_OK(InternalPushWork(priority, std::move(work_item)),
               "Failed to push work item into the work queue");
 }
 
-Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
+void WorkQueue::SetLaneWeights(uint8_t high, uint8_t normal, uint8_t low) {
+  PW_CHECK(high != 0u && normal != 0u && low != 0u,
+           "Work queue lane weights must be nonzero");
+  std::lock_guard lock(lock_);
+  lane_weights_ = {high, normal, low};
+  lane_credits_ = lane_weights_;
+}
+
+Status WorkQueue::InternalPushWork(WorkPriority priority,
+                                   WorkItem&& work_item) {
   std::lock_guard lock(lock_);
 
   if (stop_requested_) {
@@ -69,24 +137,143 @@ Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
     return Status::FailedPrecondition();
   }
 
-  if (circular_buffer_.full()) {
+  size_t lane = static_cast<size_t>(priority);
+  if (lanes_[lane].capacity() == 0u) {
+    lane = static_cast<size_t>(WorkPriority::kNormal);
+  }
+  internal::CircularBuffer<WorkItem>& queue = lanes_[lane];
+
+  if (queue.full()) {
     return Status::ResourceExhausted();
   }
 
-  circular_buffer_.Push(std::move(work_item));
+  queue.Push(std::move(work_item));
+
+  // Update the watermarks for the lane and for the queue as a whole.
+  const uint32_t lane_entries = queue.size();
+  metric::TypedMetric<uint32_t>& lane_max_used =
+      lane == 0u   ? high_lane_max_used_
+      : lane == 1u ? normal_lane_max_used_
+                   : low_lane_max_used_;
+  if (lane_entries > lane_max_used.value()) {
+    lane_max_used.Set(lane_entries);
+  }
 
-  // Update the watermarks for the queue.
-  const uint32_t queue_entries = circular_buffer_.size();
+  uint32_t queue_entries = 0;
+  for (const internal::CircularBuffer<WorkItem>& lane_queue : lanes_) {
+    queue_entries += lane_queue.size();
+  }
   if (queue_entries > max_queue_used_.value()) {
     max_queue_used_.Set(queue_entries);
   }
-  const uint32_t queue_remaining = circular_buffer_.capacity() - queue_entries;
+  const uint32_t queue_remaining = capacity() - queue_entries;
   if (queue_remaining < min_queue_remaining_.value()) {
-    min_queue_remaining_.Set(queue_entries);
+    min_queue_remaining_.Set(queue_remaining);
+  }
+
+  work_notification_.release();
+  return OkStatus();
+}
+
+std::optional<WorkItem> WorkQueue::PopWork() {
+  // With strict scheduling, the highest lane with work always goes first.
+  if (lane_weights_[0] == 0u) {
+    for (internal::CircularBuffer<WorkItem>& queue : lanes_) {
+      if (!queue.empty()) {
+        return queue.Pop();
+      }
+    }
+    return std::nullopt;
   }
 
+  // With weights, the highest lane with work and credits left goes first. Once
+  // no lane with work has credits left, a new round starts.
+  for (int round = 0; round < 2; ++round) {
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+      if (!lanes_[lane].empty() && lane_credits_[lane] != 0u) {
+        lane_credits_[lane] -= 1;
+        return lanes_[lane].Pop();
+      }
+    }
+    lane_credits_ = lane_weights_;
+  }
+  return std::nullopt;
+}
+
+bool WorkQueue::empty() const {
+  for (const internal::CircularBuffer<WorkItem>& queue : lanes_) {
+    if (!queue.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t WorkQueue::capacity() const {
+  size_t capacity = 0;
+  for (const internal::CircularBuffer<WorkItem>& queue : lanes_) {
+    capacity += queue.capacity();
+  }
+  return capacity;
+}
+
+Status WorkQueue::PushWorkAt(chrono::SystemClock::time_point deadline,
+                             WorkItem&& work_item) {
+  return InternalPushScheduledWork(
+      deadline, chrono::SystemClock::duration(0), std::move(work_item));
+}
+
+Status WorkQueue::PushWorkEvery(chrono::SystemClock::duration period,
+                                WorkItem&& work_item) {
+  if (period <= chrono::SystemClock::duration(0)) {
+    return Status::InvalidArgument();
+  }
+  return InternalPushScheduledWork(
+      chrono::SystemClock::TimePointAfterAtLeast(period),
+      period,
+      std::move(work_item));
+}
+
+Status WorkQueue::InternalPushScheduledWork(
+    chrono::SystemClock::time_point deadline,
+    chrono::SystemClock::duration period,
+    WorkItem&& work_item) {
+  std::lock_guard lock(lock_);
+
+  if (stop_requested_) {
+    // Entries are not permitted to be enqueued once stop has been requested.
+    return Status::FailedPrecondition();
+  }
+
+  if (scheduled_count_ + (running_periodic_work_ ? 1 : 0) >=
+      scheduled_.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  PushScheduled({
+      .deadline = deadline,
+      .period = period,
+      .work_item = std::move(work_item),
+  });
+
+  // Wake the work queue thread so it waits for the new deadline if it is
+  // earlier than the one it is waiting for.
   work_notification_.release();
   return OkStatus();
 }
 
+void WorkQueue::PushScheduled(ScheduledWorkItem&& item) {
+  scheduled_[scheduled_count_] = std::move(item);
+  scheduled_count_ += 1;
+  std::push_heap(
+      scheduled_.begin(), scheduled_.begin() + scheduled_count_, LaterDeadline);
+}
+
+ScheduledWorkItem WorkQueue::PopScheduled() {
+  std::pop_heap(
+      scheduled_.begin(), scheduled_.begin() + scheduled_count_, LaterDeadline);
+  scheduled_count_ -= 1;
+  return std::move(scheduled_[scheduled_count_]);
+}
+
 }  // namespace pw::work_queue
@@ -0,0 +1,149 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_thread/yield.h"
+
+namespace pw::work_queue {
+
+WorkQueuePool::WorkQueuePool(std::span<Worker> workers,
+                             std::span<WorkItem> queue_storage)
+    : workers_(workers), stop_requested_(false), next_worker_(0) {
+  PW_CHECK(!workers.empty());
+  const size_t entries_per_worker = queue_storage.size() / workers.size();
+
+  for (size_t i = 0; i < workers.size(); ++i) {
+    Worker& worker = workers[i];
+    std::lock_guard lock(worker.lock_);
+    worker.pool_ = this;
+    worker.queue_ = internal::CircularBuffer<WorkItem>(
+        queue_storage.subspan(i * entries_per_worker, entries_per_worker));
+  }
+}
+
+void WorkQueuePool::RequestStop() {
+  {
+    std::lock_guard lock(lock_);
+    if (stop_requested_) {
+      return;
+    }
+    stop_requested_ = true;
+  }
+
+  // Wake every worker so each one sees that it should stop. Release once per
+  // worker so that every waiting worker is woken.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    work_available_.release();
+  }
+}
+
+void WorkQueuePool::CheckPushWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(std::move(work_item)),
+              "Failed to push work item into the work queue pool");
+}
+
+Status WorkQueuePool::PushWork(WorkItem&& work_item) {
+  {
+    std::lock_guard lock(lock_);
+
+    if (stop_requested_) {
+      // Entries are not permitted to be enqueued once stop has been requested.
+      return Status::FailedPrecondition();
+    }
+
+    // Start with the next worker in turn, and fall back to the others if its
+    // queue is full.
+    bool pushed = false;
+    for (size_t i = 0; i < workers_.size() && !pushed; ++i) {
+      Worker& worker = workers_[next_worker_];
+      next_worker_ = next_worker_ + 1 == workers_.size() ? 0 : next_worker_ + 1;
+
+      std::lock_guard worker_lock(worker.lock_);
+      pushed = worker.queue_.Push(std::move(work_item));
+    }
+
+    if (!pushed) {
+      return Status::ResourceExhausted();
+    }
+  }
+
+  work_available_.release();
+  return OkStatus();
+}
+
+std::optional<WorkItem> WorkQueuePool::TakeWork(Worker& worker) {
+  work_available_.acquire();
+
+  while (true) {
+    if (std::optional<WorkItem> work_item = PopFromAnyQueue(worker);
+        work_item.has_value()) {
+      return work_item;
+    }
+
+    // Work is pushed under lock_, so once stop has been requested no more
+    // work can arrive. If none is left, this worker is done.
+    bool stop_requested;
+    {
+      std::lock_guard lock(lock_);
+      stop_requested = stop_requested_;
+    }
+    if (stop_requested) {
+      if (std::optional<WorkItem> work_item = PopFromAnyQueue(worker);
+          work_item.has_value()) {
+        return work_item;
+      }
+      return std::nullopt;
+    }
+
+    // The semaphore guarantees a work item is queued, but another worker that
+    // woke earlier may have taken the one this scan looked for first. Scan
+    // again; there are always at least as many items as waiting workers.
+    this_thread::yield();
+  }
+}
+
+std::optional<WorkItem> WorkQueuePool::PopFromAnyQueue(Worker& worker) {
+  if (std::optional<WorkItem> work_item = worker.Pop(); work_item.has_value()) {
+    return work_item;
+  }
+
+  // Steal the oldest item from the next worker with queued work.
+  const size_t index = static_cast<size_t>(&worker - workers_.data());
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = workers_[(index + i) % workers_.size()];
+    if (std::optional<WorkItem> work_item = victim.Pop();
+        work_item.has_value()) {
+      return work_item;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<WorkItem> WorkQueuePool::Worker::Pop() {
+  std::lock_guard lock(lock_);
+  return queue_.Pop();
+}
+
+void WorkQueuePool::Worker::Run() {
+  while (std::optional<WorkItem> work_item = pool_->TakeWork(*this)) {
+    PW_CHECK(*work_item != nullptr);
+    (*work_item)();
+  }
+}
+
+}  // namespace pw::work_queue
@@ -0,0 +1,115 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::work_queue {
+namespace {
+
+constexpr size_t kWorkers = 3;
+
+class WorkQueuePoolTest : public ::testing::Test {
+ protected:
+  void StartWorkers() {
+    for (size_t i = 0; i < kWorkers; ++i) {
+      threads_[i] =
+          thread::Thread(test::WorkQueueThreadOptions(), pool_.worker(i));
+    }
+  }
+
+  void StopWorkers() {
+    pool_.RequestStop();
+    for (thread::Thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  WorkQueuePoolWithBuffer<kWorkers, 4> pool_;
+  std::array<thread::Thread, kWorkers> threads_;
+};
+
+TEST_F(WorkQueuePoolTest, RunsAllWork) {
+  std::atomic<int> counter = 0;
+  StartWorkers();
+
+  // Push more work than fits in the queues at once.
+  const int kWorkItems = 300;
+  for (int i = 0; i < kWorkItems; ++i) {
+    while (!pool_.PushWork([&counter] { counter++; }).ok()) {
+    }
+  }
+
+  StopWorkers();
+  EXPECT_EQ(counter.load(), kWorkItems);
+}
+
+TEST_F(WorkQueuePoolTest, StealsWorkBehindBlockedItem) {
+  struct {
+    sync::ThreadNotification blocked_started;
+    sync::ThreadNotification unblock;
+    sync::ThreadNotification others_done;
+    std::atomic<int> counter = 0;
+  } context;
+  StartWorkers();
+
+  ASSERT_EQ(OkStatus(), pool_.PushWork([&context] {
+    context.blocked_started.release();
+    context.unblock.acquire();
+  }));
+  context.blocked_started.acquire();
+
+  // Work pushed now is spread across all queues, including the blocked
+  // worker's. The other workers must steal it for all of it to finish.
+  static constexpr int kWorkItems = 2 * static_cast<int>(kWorkers);
+  for (int i = 0; i < kWorkItems; ++i) {
+    ASSERT_EQ(OkStatus(), pool_.PushWork([&context] {
+      if (++context.counter == kWorkItems) {
+        context.others_done.release();
+      }
+    }));
+  }
+
+  context.others_done.acquire();
+  EXPECT_EQ(context.counter.load(), kWorkItems);
+
+  context.unblock.release();
+  StopWorkers();
+}
+
+TEST_F(WorkQueuePoolTest, Full_ReturnsResourceExhausted) {
+  // Without running workers, the queues fill up.
+  for (size_t i = 0; i < kWorkers * 4; ++i) {
+    ASSERT_EQ(OkStatus(), pool_.PushWork([] {}));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), pool_.PushWork([] {}));
+
+  StartWorkers();
+  StopWorkers();
+}
+
+TEST_F(WorkQueuePoolTest, Stopped_ReturnsFailedPrecondition) {
+  StartWorkers();
+  StopWorkers();
+  EXPECT_EQ(Status::FailedPrecondition(), pool_.PushWork([] {}));
+}
+
+}  // namespace
+}  // namespace pw::work_queue
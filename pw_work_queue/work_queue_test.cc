@@ -15,9 +15,11 @@
 #include "pw_work_queue/work_queue.h"
 
 #include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_log/log.h"
 #include "pw_sync/thread_notification.h"
+#include "pw_thread/sleep.h"
 #include "pw_thread/thread.h"
 #include "pw_work_queue/test_thread.h"
 
@@ -126,6 +128,188 @@ TEST(WorkQueue, PingPongTwoRequestTypesWithExtraRequests) {
   EXPECT_EQ(context_b.counter, kPingPongs);
 }
 
+TEST(WorkQueue, PushWorkAt_RunsInDeadlineOrder) {
+  struct {
+    int order[3] = {};
+    int runs = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueueWithBuffer<4, 4> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  const auto now = chrono::SystemClock::now();
+  const auto step =
+      chrono::SystemClock::for_at_least(std::chrono::milliseconds(5));
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAt(now + 3 * step, [&context] {
+    context.order[context.runs++] = 3;
+    context.done.release();
+  }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAt(now + step, [&context] {
+    context.order[context.runs++] = 1;
+  }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAt(now + 2 * step, [&context] {
+    context.order[context.runs++] = 2;
+  }));
+
+  context.done.acquire();
+  EXPECT_GE(chrono::SystemClock::now(), now + 3 * step);
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_EQ(context.runs, 3);
+  EXPECT_EQ(context.order[0], 1);
+  EXPECT_EQ(context.order[1], 2);
+  EXPECT_EQ(context.order[2], 3);
+}
+
+TEST(WorkQueue, PushWorkEvery_RunsRepeatedly) {
+  struct {
+    int runs = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueueWithBuffer<4, 1> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  ASSERT_EQ(OkStatus(),
+            work_queue.PushWorkEvery(
+                chrono::SystemClock::for_at_least(std::chrono::milliseconds(1)),
+                [&context] {
+                  if (++context.runs == 5) {
+                    context.done.release();
+                  }
+                }));
+
+  // The periodic work keeps its storage while it is scheduled.
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWorkAt(chrono::SystemClock::now(), [] {}));
+
+  context.done.acquire();
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_GE(context.runs, 5);
+}
+
+constexpr chrono::SystemClock::duration kPeriod =
+    chrono::SystemClock::for_at_least(std::chrono::milliseconds(50));
+
+TEST(WorkQueue, PushWorkEvery_FallsBehind_StaysInPhase) {
+  struct {
+    int runs = 0;
+    chrono::SystemClock::time_point first_run;
+    chrono::SystemClock::time_point second_run;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueueWithBuffer<4, 1> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  ASSERT_EQ(OkStatus(),
+            work_queue.PushWorkEvery(kPeriod, [&context] {
+              if (++context.runs == 1) {
+                context.first_run = chrono::SystemClock::now();
+                // Overrun three and a half periods.
+                this_thread::sleep_for(kPeriod * 7 / 2);
+              } else if (context.runs == 2) {
+                context.second_run = chrono::SystemClock::now();
+                context.done.release();
+              }
+            }));
+
+  context.done.acquire();
+  work_queue.RequestStop();
+  work_thread.join();
+
+  // The missed runs are skipped and the next run is four periods after the
+  // first deadline, not a full period after the overrun ended.
+  EXPECT_GE(context.second_run - context.first_run, kPeriod * 7 / 2);
+  EXPECT_LT(context.second_run - context.first_run, kPeriod * 9 / 2);
+}
+
+TEST(WorkQueue, PushWorkEvery_InvalidPeriod) {
+  WorkQueueWithBuffer<4, 1> work_queue;
+  EXPECT_EQ(Status::InvalidArgument(),
+            work_queue.PushWorkEvery(chrono::SystemClock::duration(0), [] {}));
+}
+
+TEST(WorkQueue, PushWorkAt_NoScheduledStorage) {
+  WorkQueueWithBuffer<4> work_queue;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWorkAt(chrono::SystemClock::now(), [] {}));
+}
+
+struct PriorityContext {
+  char order[8] = {};
+  int runs = 0;
+  sync::ThreadNotification done;
+
+  void Record(char lane) {
+    order[runs++] = lane;
+    if (runs == 7) {
+      done.release();
+    }
+  }
+};
+
+// Pushes work that records its lane in the run order, then runs it.
+void RunLaneWork(WorkQueue& work_queue, PriorityContext& context) {
+  const WorkPriority lanes[] = {WorkPriority::kLow,
+                                WorkPriority::kLow,
+                                WorkPriority::kNormal,
+                                WorkPriority::kLow,
+                                WorkPriority::kHigh,
+                                WorkPriority::kNormal,
+                                WorkPriority::kHigh};
+  for (WorkPriority lane : lanes) {
+    WorkItem work_item;
+    switch (lane) {
+      case WorkPriority::kHigh:
+        work_item = [&context] { context.Record('H'); };
+        break;
+      case WorkPriority::kNormal:
+        work_item = [&context] { context.Record('N'); };
+        break;
+      case WorkPriority::kLow:
+        work_item = [&context] { context.Record('L'); };
+        break;
+    }
+    ASSERT_EQ(OkStatus(), work_queue.PushWork(lane, std::move(work_item)));
+  }
+
+  // Start the worker thread after all work is queued.
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  context.done.acquire();
+  work_queue.RequestStop();
+  work_thread.join();
+}
+
+TEST(WorkQueue, PriorityLanes_Strict) {
+  PriorityContext context;
+  PriorityWorkQueueWithBuffer<4, 4, 4> work_queue;
+
+  RunLaneWork(work_queue, context);
+  EXPECT_STREQ(context.order, "HHNNLLL");
+}
+
+TEST(WorkQueue, PriorityLanes_Weighted) {
+  PriorityContext context;
+  PriorityWorkQueueWithBuffer<4, 4, 4> work_queue;
+  work_queue.SetLaneWeights(1, 1, 1);
+
+  RunLaneWork(work_queue, context);
+  EXPECT_STREQ(context.order, "HNLHNLL");
+}
+
+TEST(WorkQueue, PriorityLanes_LaneWithoutStorageUsesNormalLane) {
+  WorkQueueWithBuffer<1> work_queue;
+  EXPECT_EQ(OkStatus(), work_queue.PushWork(WorkPriority::kHigh, [] {}));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWork(WorkPriority::kLow, [] {}));
+}
+
 // TODO(ewout): Add unit tests for the metrics once they have been restructured.
 
 }  // namespace